@@ -0,0 +1,421 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Convert archive files to another format or file size.
+
+#include "ArchiveBlock.hpp"
+#include "AsyncSink.hpp"
+#include "MicrosliceInputArchive.hpp"
+#include "MicrosliceMappedArchive.hpp"
+#include "DescriptorColumnOutputArchive.hpp"
+#include "MicrosliceOutputArchive.hpp"
+#include "MicrosliceRawOutputArchive.hpp"
+#include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include "TimesliceRawOutputArchive.hpp"
+#include "Utility.hpp"
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+namespace filesys = boost::filesystem;
+
+namespace {
+
+struct Options {
+  std::vector<std::string> inputs;
+  std::string output_dir;
+  std::string output_template;
+  std::string format;
+  std::size_t jobs = 1;
+  std::size_t queue = 64;
+  std::size_t items_per_file = SIZE_MAX;
+  std::size_t bytes_per_file = SIZE_MAX;
+  fles::ArchiveCompression compression = fles::ArchiveCompression::None;
+  std::string dictionary;
+  std::string catalog;
+  bool dedup_overlap = false;
+  bool encode_descriptors = false;
+  bool overwrite = false;
+
+  /// Re-chunk all inputs into one sequence of output files.
+  [[nodiscard]] bool rechunk() const { return !output_template.empty(); }
+};
+
+bool is_timeslice_format(const std::string& filename) {
+  return boost::algorithm::ends_with(filename, ".tsa") ||
+         boost::algorithm::ends_with(filename, ".tsr");
+}
+
+bool is_microslice_format(const std::string& filename) {
+  return boost::algorithm::ends_with(filename, ".msa") ||
+         boost::algorithm::ends_with(filename, ".msr");
+}
+
+/// Open an input archive file, mapping raw archives.
+template <class Item>
+std::unique_ptr<fles::Source<Item>> open_input(const std::string& filename);
+
+template <>
+std::unique_ptr<fles::TimesliceSource>
+open_input<fles::Timeslice>(const std::string& filename) {
+  if (boost::algorithm::ends_with(filename, ".tsr")) {
+    return std::make_unique<fles::TimesliceMappedArchive>(filename);
+  }
+  return std::make_unique<fles::TimesliceInputArchive>(filename);
+}
+
+template <>
+std::unique_ptr<fles::MicrosliceSource>
+open_input<fles::Microslice>(const std::string& filename) {
+  if (boost::algorithm::ends_with(filename, ".msr")) {
+    return std::make_unique<fles::MicrosliceMappedArchive>(filename);
+  }
+  return std::make_unique<fles::MicrosliceInputArchive>(filename);
+}
+
+/// Create an output archive file (or file sequence in re-chunk mode).
+template <class Item>
+std::unique_ptr<fles::Sink<Item>> create_output(const Options& opt,
+                                                const std::string& filename);
+
+template <>
+std::unique_ptr<fles::TimesliceSink>
+create_output<fles::Timeslice>(const Options& opt,
+                               const std::string& filename) {
+  if (opt.format == "tsr") {
+    return std::make_unique<fles::TimesliceRawOutputArchive>(
+        filename, opt.dedup_overlap);
+  }
+  if (opt.format == "tsc") {
+    return std::make_unique<fles::DescriptorColumnOutputArchive>(filename);
+  }
+  if (opt.rechunk()) {
+    return std::make_unique<fles::TimesliceOutputArchiveSequence>(
+        filename, opt.items_per_file, opt.bytes_per_file, opt.compression,
+        false, opt.dictionary, opt.catalog);
+  }
+  return std::make_unique<fles::TimesliceOutputArchive>(
+      filename, opt.compression, opt.dictionary);
+}
+
+template <>
+std::unique_ptr<fles::MicrosliceSink>
+create_output<fles::Microslice>(const Options& opt,
+                                const std::string& filename) {
+  if (opt.format == "msr") {
+    return std::make_unique<fles::MicrosliceRawOutputArchive>(
+        filename,
+        fles::MicrosliceRawOutputArchive::default_microslices_per_block,
+        fles::MicrosliceRawOutputArchive::default_max_block_content_size,
+        opt.encode_descriptors);
+  }
+  if (opt.rechunk()) {
+    return std::make_unique<fles::MicrosliceOutputArchiveSequence>(
+        filename, opt.items_per_file, opt.bytes_per_file, opt.compression,
+        false, opt.dictionary, opt.catalog);
+  }
+  return std::make_unique<fles::MicrosliceOutputArchive>(
+      filename, opt.compression, opt.dictionary);
+}
+
+/// Copy all items of the given input files to an output sink.
+/** The output is written on a background thread, so that reading and
+    deserializing the input overlaps with serializing, compressing and
+    writing the output. Items of mapped inputs keep their mapping alive
+    until they are written. */
+template <class Item>
+uint64_t convert(const Options& opt,
+                 const std::vector<std::string>& inputs,
+                 const std::string& output) {
+  fles::AsyncSink<Item> sink(create_output<Item>(opt, output), opt.queue,
+                             fles::OverflowPolicy::Block);
+  uint64_t count = 0;
+  for (const auto& input : inputs) {
+    auto source = open_input<Item>(input);
+    while (auto item = source->get()) {
+      sink.put(std::shared_ptr<const Item>(std::move(item)));
+      ++count;
+    }
+  }
+  sink.end_stream();
+  return count;
+}
+
+uint64_t convert(const Options& opt,
+                 const std::vector<std::string>& inputs,
+                 const std::string& output) {
+  if (is_timeslice_format(inputs.front())) {
+    return convert<fles::Timeslice>(opt, inputs, output);
+  }
+  return convert<fles::Microslice>(opt, inputs, output);
+}
+
+uint64_t file_size(const std::string& filename) {
+  boost::system::error_code ec;
+  auto size = filesys::file_size(filename, ec);
+  return ec ? 0 : size;
+}
+
+std::string rate(uint64_t bytes, double seconds) {
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(1)
+    << (seconds > 0 ? static_cast<double>(bytes) / seconds / 1e6 : 0)
+    << " MB/s";
+  return s.str();
+}
+
+/// Convert one input file to one output file.
+/** The output is written to a temporary file, which is renamed when
+    complete. An existing output file thus marks a completed conversion, so
+    an interrupted run can be resumed by running it again. */
+bool convert_file(const Options& opt, const std::string& input) {
+  filesys::path output = filesys::path(opt.output_dir) /
+                         filesys::path(input).stem();
+  output += "." + opt.format;
+  try {
+    if (!opt.overwrite && filesys::exists(output)) {
+      print_line(input + ": skipped, " + output.string() + " exists");
+      return true;
+    }
+    std::string part = output.string() + ".part";
+    std::string index = fles::ArchiveIndex::index_filename(part);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t count = convert(opt, {input}, part);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    if (filesys::exists(index)) {
+      filesys::rename(index,
+                      fles::ArchiveIndex::index_filename(output.string()));
+    }
+    filesys::rename(part, output);
+
+    uint64_t in_bytes = file_size(input);
+    uint64_t out_bytes = file_size(output.string());
+    std::ostringstream s;
+    s << input << " -> " << output.string() << ": " << count << " items, "
+      << in_bytes << " -> " << out_bytes << " bytes ("
+      << rate(in_bytes, elapsed.count()) << ")";
+    print_line(s.str());
+    return true;
+  } catch (std::exception& e) {
+    print_line(input + ": " + e.what(), std::cerr);
+    return false;
+  }
+}
+
+/// Convert each input file to an output file, several files in parallel.
+bool convert_files(const Options& opt) {
+  try {
+    filesys::create_directories(opt.output_dir);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> ok{true};
+  auto worker = [&opt, &next, &ok] {
+    for (std::size_t i = next++; i < opt.inputs.size(); i = next++) {
+      if (!convert_file(opt, opt.inputs[i])) {
+        ok = false;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  std::size_t jobs = std::min(opt.jobs, opt.inputs.size());
+  for (std::size_t j = 1; j < jobs; ++j) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return ok;
+}
+
+/// Convert all input files, in the given order, to one file sequence.
+bool convert_sequence(const Options& opt) {
+  try {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t count = convert(opt, opt.inputs, opt.output_template);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    uint64_t in_bytes = 0;
+    for (const auto& input : opt.inputs) {
+      in_bytes += file_size(input);
+    }
+    print_line(std::to_string(opt.inputs.size()) + " files -> " +
+               opt.output_template + ": " + std::to_string(count) +
+               " items (" + rate(in_bytes, elapsed.count()) + ")");
+    return true;
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+}
+
+void check_options(Options& opt) {
+  if (opt.rechunk() == !opt.output_dir.empty()) {
+    throw std::invalid_argument(
+        "either output-dir or output (re-chunking) is required");
+  }
+  if (opt.rechunk()) {
+    opt.format = filesys::path(opt.output_template).extension().string();
+    if (!opt.format.empty()) {
+      opt.format.erase(0, 1);
+    }
+  }
+  if (opt.format != "tsa" && opt.format != "tsr" && opt.format != "tsc" &&
+      opt.format != "msa" && opt.format != "msr") {
+    throw std::invalid_argument("unknown output format: " + opt.format);
+  }
+  bool timeslices = opt.format[0] == 't';
+  for (const auto& input : opt.inputs) {
+    if (!(timeslices ? is_timeslice_format(input)
+                     : is_microslice_format(input))) {
+      throw std::invalid_argument("input does not match output format: " +
+                                  input);
+    }
+  }
+  bool raw = opt.format.back() == 'r' || opt.format == "tsc";
+  if (raw && (opt.compression != fles::ArchiveCompression::None ||
+              !opt.dictionary.empty() || opt.items_per_file != SIZE_MAX ||
+              opt.bytes_per_file != SIZE_MAX || !opt.catalog.empty())) {
+    throw std::invalid_argument("raw output archives do not support "
+                                "compression or file sequences");
+  }
+  if (opt.dedup_overlap && opt.format != "tsr") {
+    throw std::invalid_argument("dedup-overlap requires tsr output");
+  }
+  if (opt.encode_descriptors && opt.format != "msr") {
+    throw std::invalid_argument("encode-descriptors requires msr output");
+  }
+  if (!opt.catalog.empty() && !opt.rechunk()) {
+    throw std::invalid_argument("catalog requires re-chunking (output)");
+  }
+  if (opt.compression != fles::ArchiveCompression::None &&
+      !fles::archive_compression_supported(opt.compression)) {
+    throw std::invalid_argument("compression not supported by this build");
+  }
+  if (opt.jobs == 0 || opt.queue == 0) {
+    throw std::invalid_argument("jobs and queue must be greater than zero");
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  Options opt;
+  std::string compression = "none";
+  std::string dictionary_file;
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("input,i",
+           po::value<std::vector<std::string>>(&opt.inputs)
+               ->value_name("<file>")
+               ->required(),
+           "archive file to convert (.tsa/.tsr/.msa/.msr)");
+  desc_add("output-dir,d",
+           po::value<std::string>(&opt.output_dir)->value_name("<dir>"),
+           "convert each input file to a file of the same name in this "
+           "directory");
+  desc_add("format,f",
+           po::value<std::string>(&opt.format)->value_name("<ext>"),
+           "output format of output-dir: tsa, tsr, msa, msr, or tsc "
+           "(microslice descriptors only)");
+  desc_add("output,o",
+           po::value<std::string>(&opt.output_template)->value_name("<file>"),
+           "re-chunk all input files, in order, into this file (or file "
+           "sequence, use placeholder %n)");
+  desc_add("output-items",
+           po::value<std::size_t>(&opt.items_per_file)->value_name("<n>"),
+           "limit number of items per output file (re-chunking)");
+  desc_add("output-bytes",
+           po::value<std::size_t>(&opt.bytes_per_file)->value_name("<n>"),
+           "limit number of bytes per output file (re-chunking)");
+  desc_add("catalog",
+           po::value<std::string>(&opt.catalog)->value_name("<file>"),
+           "append an entry for each output file to this catalog "
+           "(re-chunking)");
+  desc_add("compression",
+           po::value<std::string>(&compression)
+               ->value_name("<id>")
+               ->default_value(compression),
+           "output archive compression: none, zstd");
+  desc_add("dictionary",
+           po::value<std::string>(&dictionary_file)->value_name("<file>"),
+           "compress using the dictionary in this file (see tsdict)");
+  desc_add("dedup-overlap", po::bool_switch(&opt.dedup_overlap),
+           "store overlap microslices only once (tsr output)");
+  desc_add("encode-descriptors", po::bool_switch(&opt.encode_descriptors),
+           "store microslice descriptors encoded (msr output)");
+  desc_add("jobs,j",
+           po::value<std::size_t>(&opt.jobs)
+               ->value_name("<n>")
+               ->default_value(opt.jobs),
+           "number of files converted in parallel (output-dir)");
+  desc_add("queue",
+           po::value<std::size_t>(&opt.queue)
+               ->value_name("<n>")
+               ->default_value(opt.queue),
+           "number of items read ahead of the output of each file");
+  desc_add("overwrite", po::bool_switch(&opt.overwrite),
+           "convert files even if their output exists");
+  po::positional_options_description pos;
+  pos.add("input", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(pos)
+                  .run(),
+              vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Converts archive files to another format, or re-chunks "
+                   "them into a file\nsequence. Completed output files are "
+                   "not converted again, so an\ninterrupted run is resumed "
+                   "by repeating it.\n\nUsage: "
+                << argv[0] << " [options] <file>...\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+
+    if (compression == "zstd") {
+      opt.compression = fles::ArchiveCompression::Zstd;
+    } else if (compression != "none") {
+      throw std::invalid_argument("unknown compression: " + compression);
+    }
+    if (!dictionary_file.empty()) {
+      std::ifstream ifs(dictionary_file, std::ios::binary);
+      if (!ifs) {
+        throw std::runtime_error("cannot read " + dictionary_file);
+      }
+      opt.dictionary.assign(std::istreambuf_iterator<char>(ifs),
+                            std::istreambuf_iterator<char>());
+    }
+    check_options(opt);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool ok = opt.rechunk() ? convert_sequence(opt) : convert_files(opt);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,89 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Check the block digests of archive files.
+
+#include "ArchiveBlock.hpp"
+#include "MicrosliceMappedArchive.hpp"
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> files;
+  std::size_t threads = std::max(1U, std::thread::hardware_concurrency());
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("threads,j",
+           po::value<std::size_t>(&threads)
+               ->value_name("<n>")
+               ->default_value(threads),
+           "number of blocks checked concurrently");
+  desc_add("input,i",
+           po::value<std::vector<std::string>>(&files)
+               ->value_name("<file>")
+               ->required(),
+           "archive file to check (compressed .tsa/.msa or .msr)");
+  po::positional_options_description pos;
+  pos.add("input", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(pos)
+                  .run(),
+              vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Checks the block digests of archive files without "
+                   "decoding their contents.\n\nUsage: "
+                << argv[0] << " [options] <file>...\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool ok = true;
+  for (const auto& file : files) {
+    try {
+      auto start = std::chrono::steady_clock::now();
+      fles::BlockVerification result;
+      if (boost::algorithm::ends_with(file, ".msr")) {
+        result = fles::MicrosliceMappedArchive(file).verify(threads);
+      } else {
+        result = fles::verify_archive_blocks(file, threads);
+      }
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+      std::cout << file << ": " << result.blocks << " blocks, "
+                << result.corrupt << " corrupt";
+      if (result.unchecked != 0) {
+        std::cout << ", " << result.unchecked << " without digest";
+      }
+      std::cout << " (" << std::fixed << std::setprecision(1)
+                << static_cast<double>(result.bytes) / elapsed.count() / 1e6
+                << " MB/s)" << std::endl;
+      if (result.corrupt != 0) {
+        ok = false;
+      }
+    } catch (std::exception& e) {
+      std::cerr << file << ": " << e.what() << std::endl;
+      ok = false;
+    }
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
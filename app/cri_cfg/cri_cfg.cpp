@@ -4,6 +4,7 @@
  *
  */
 
+#include <chrono>
 #include <memory>
 
 #include "log.hpp"
@@ -14,6 +15,9 @@ int main(int argc, char* argv[]) {
 
     parameters par(argc, argv);
 
+    using ms = std::chrono::duration<double, std::milli>;
+    auto start = std::chrono::steady_clock::now();
+
     std::unique_ptr<cri::cri_device> cri;
     // create CRI
     if (par.dev_autodetect()) {
@@ -23,6 +27,7 @@ int main(int argc, char* argv[]) {
           par.dev_addr().bus, par.dev_addr().dev, par.dev_addr().func);
     }
     std::vector<cri::cri_channel*> channels = cri->channels();
+    auto opened = std::chrono::steady_clock::now();
 
     L_(debug) << "Configuring CRI " << cri->print_devinfo();
 
@@ -54,7 +59,10 @@ int main(int argc, char* argv[]) {
       }
     }
 
-    L_(info) << "CRI " << cri->print_devinfo() << " configured";
+    L_(info) << "CRI " << cri->print_devinfo() << " configured (open "
+             << ms(opened - start).count() << " ms, configuration "
+             << ms(std::chrono::steady_clock::now() - opened).count()
+             << " ms)";
 
   } catch (std::exception const& e) {
     L_(fatal) << "exception: " << e.what();
@@ -0,0 +1,115 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#pragma once
+
+#include "Monitor.hpp"
+#include "System.hpp"
+#include "cri_channel.hpp"
+#include "cri_device.hpp"
+#include "log.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// A thread that periodically samples the hardware performance counters of
+/// all enabled CRI channels and publishes them to a monitor.
+/** Each sample captures and resets the counters of all channels together,
+    so the reported values are rates over the preceding sampling
+    interval. */
+class cri_perf_sampler {
+
+public:
+  cri_perf_sampler(cri::cri_device* cri,
+                   cbm::Monitor* monitor,
+                   std::string shm_identifier,
+                   std::chrono::milliseconds interval)
+      : m_cri(cri), m_monitor(monitor),
+        m_shm_identifier(std::move(shm_identifier)),
+        m_hostname(fles::system::current_hostname()), m_interval(interval) {
+    for (cri::cri_channel* channel : cri->channels()) {
+      if (channel->data_source() != cri::cri_channel::rx_disable) {
+        m_channels.push_back(channel);
+      }
+    }
+    L_(info) << "sampling perf counters of " << m_channels.size()
+             << " channel(s) every " << m_interval.count() << " ms";
+    m_thread = std::thread(&cri_perf_sampler::run, this);
+  }
+
+  cri_perf_sampler(const cri_perf_sampler&) = delete;
+  void operator=(const cri_perf_sampler&) = delete;
+
+  ~cri_perf_sampler() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+  }
+
+private:
+  void run() {
+    // start the first interval with fresh counters
+    for (cri::cri_channel* channel : m_channels) {
+      channel->set_perf_cnt(false, true);
+      channel->set_perf_gtx_cnt(false, true);
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_cond.wait_for(lock, m_interval, [this] { return m_stop; })) {
+      cri::cri_device::perf_snapshot_t snapshot = m_cri->get_perf_snapshot();
+      for (cri::cri_channel* channel : m_channels) {
+        size_t i = channel->channel_index();
+        sample(channel, snapshot.ch.at(i), snapshot.ch_gtx.at(i));
+      }
+    }
+  }
+
+  void sample(cri::cri_channel* channel,
+              const cri::cri_channel::ch_perf_t& perf,
+              const cri::cri_channel::ch_perf_gtx_t& perf_gtx) {
+    // saturated cycle counters, interval too long to be measured
+    if (perf.cycles == 0xFFFFFFFF || perf_gtx.cycles == 0xFFFFFFFF ||
+        perf.cycles == 0 || perf_gtx.cycles == 0) {
+      L_(debug) << "perf counter overflow on channel "
+                << channel->channel_index();
+      return;
+    }
+
+    auto cycles = static_cast<double>(perf.cycles);
+    auto cycles_gtx = static_cast<double>(perf_gtx.cycles);
+    double mc_trans = static_cast<double>(perf_gtx.mc_trans) / cycles_gtx;
+
+    m_monitor->QueueMetric(
+        "cri_channel_perf",
+        {{"host", m_hostname},
+         {"shm", m_shm_identifier},
+         {"channel", std::to_string(channel->channel_index())}},
+        {{"dma_trans", static_cast<double>(perf.dma_trans) / cycles},
+         {"dma_stall", static_cast<double>(perf.dma_stall) / cycles},
+         {"dma_busy", static_cast<double>(perf.dma_busy) / cycles},
+         {"data_buf_stall", static_cast<double>(perf.data_buf_stall) / cycles},
+         {"desc_buf_stall", static_cast<double>(perf.desc_buf_stall) / cycles},
+         {"microslice_rate",
+          static_cast<double>(perf.microslice_cnt) / (cycles / cri::pkt_clk)},
+         {"mc_trans", mc_trans},
+         {"mc_stall", static_cast<double>(perf_gtx.mc_stall) / cycles_gtx},
+         {"mc_busy", static_cast<double>(perf_gtx.mc_busy) / cycles_gtx},
+         {"mc_throughput", mc_trans * cri::gtx_clk * 8}});
+  }
+
+  cri::cri_device* m_cri;
+  cbm::Monitor* m_monitor;
+  std::string m_shm_identifier;
+  std::string m_hostname;
+  std::chrono::milliseconds m_interval;
+  std::vector<cri::cri_channel*> m_channels;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_stop = false;
+  std::thread m_thread;
+};
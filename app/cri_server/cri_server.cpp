@@ -1,6 +1,7 @@
 // Copyright 2015 Dirk Hutter
 
 #include "ChildProcessManager.hpp"
+#include "cri_perf_sampler.hpp"
 #include "log.hpp"
 #include "parameters.hpp"
 #include "shm_device_server.hpp"
@@ -52,10 +53,35 @@ int main(int argc, char* argv[]) {
       }
     }
 
+    std::vector<MemoryPlacement> placement = par.buffer_placement();
+    if (par.buffer_numa_auto()) {
+      int node = cri->numa_node();
+      if (node >= 0) {
+        L_(info) << "binding buffers to NUMA node " << node;
+      } else {
+        L_(warning) << "NUMA node of CRI unknown, buffers not bound";
+      }
+      for (auto& p : placement) {
+        p.numa_node = node;
+      }
+    }
+
     // create server
-    cri_shm_device_server server(cri.get(), par.shm(),
-                                 par.data_buffer_size_exp(),
-                                 par.desc_buffer_size_exp(), &signal_status);
+    cri_shm_device_server server(
+        cri.get(), par.shm(), par.data_buffer_size_exp(),
+        par.desc_buffer_size_exp(), &signal_status, par.lockfree_channels(),
+        par.poll_config(), placement, par.coalescing(), par.init_threads(),
+        par.persistent_buffers());
+    std::unique_ptr<cbm::Monitor> monitor;
+    std::unique_ptr<cri_perf_sampler> perf_sampler;
+    if (!par.monitor_uri().empty()) {
+      monitor = std::make_unique<cbm::Monitor>(par.monitor_uri());
+      server.set_monitor(monitor.get());
+      if (par.perf_interval().count() > 0) {
+        perf_sampler = std::make_unique<cri_perf_sampler>(
+            cri.get(), monitor.get(), par.shm(), par.perf_interval());
+      }
+    }
     if (!par.exec().empty()) {
       start_exec(par.exec(), par.shm());
       ChildProcessManager::get().allow_stop_processes(nullptr);
@@ -2,20 +2,27 @@
 
 #pragma once
 
+#include "MemoryPlacement.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "Utility.hpp"
 #include "cri.hpp"
 #include "log.hpp"
+#include "shm_channel_poller.hpp"
+#include "shm_channel_server.hpp"
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/program_options.hpp>
 #include <boost/regex.hpp>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace po = boost::program_options;
 
+static const size_t _num_max_channels = 8;
+
 /// Run parameters exception class.
 class ParametersException : public std::runtime_error {
 public:
@@ -73,6 +80,23 @@ public:
   size_t desc_buffer_size_exp() { return _desc_buffer_size_exp; }
   std::string exec() const { return _exec; }
   bool archivable_data() const { return _archivable_data; }
+  bool lockfree_channels() const { return _lockfree_channels; }
+  shm_poll_config poll_config() const { return _poll_config; }
+  std::string monitor_uri() const { return _monitor_uri; }
+  // sampling interval of the channel perf counters (zero: disabled)
+  std::chrono::milliseconds perf_interval() const { return _perf_interval; }
+  // buffer placement per hardware channel index
+  std::vector<MemoryPlacement> buffer_placement() const {
+    return _buffer_placement;
+  }
+  // bind the buffers to the NUMA node of the CRI
+  bool buffer_numa_auto() const { return _buffer_numa_auto; }
+  // coalescing of the DMA read pointer updates
+  read_pointer_coalescing coalescing() const { return _coalescing; }
+  // number of channels initialized in parallel
+  size_t init_threads() const { return _init_threads; }
+  // keep the DMA buffers registered across restarts
+  bool persistent_buffers() const { return _persistent_buffers; }
 
   std::string print_buffer_info() {
     std::stringstream ss;
@@ -90,6 +114,14 @@ private:
     unsigned log_level = 2;
     unsigned log_syslog = 2;
     std::string log_file;
+    int64_t poll_interval = _poll_config.interval.count();
+    int64_t poll_spin = _poll_config.spin.count();
+    int64_t poll_max_sleep = _poll_config.max_sleep.count();
+    std::string buffer_numa_node;
+    int64_t perf_interval = _perf_interval.count();
+    double coalescing_release = _coalescing.min_release * 100;
+    int64_t coalescing_delay = _coalescing.max_delay.count();
+    double coalescing_watermark = _coalescing.high_watermark * 100;
 
     po::options_description generic("Generic options");
     auto generic_add = generic.add_options();
@@ -131,6 +163,95 @@ private:
                    ->value_name("<bool>")
                    ->default_value(false),
                "enforce traceable CRI hardware");
+    config_add("lockfree-channels",
+               po::value<bool>(&_lockfree_channels)
+                   ->value_name("<bool>")
+                   ->default_value(false),
+               "exchange shm channel indices via lock-free atomics "
+               "(busy-polls the hardware while clients are active)");
+    config_add("poll-threads",
+               po::value<size_t>(&_poll_config.threads)
+                   ->value_name("<n>")
+                   ->default_value(0),
+               "number of dedicated threads polling the DMA write pointers "
+               "of the channels (implies lock-free channels)");
+    config_add("poll-interval",
+               po::value<int64_t>(&poll_interval)
+                   ->value_name("<us>")
+                   ->default_value(poll_interval),
+               "interval between two polling rounds of a polling thread in "
+               "microseconds (0: busy-poll)");
+    config_add("poll-cpu",
+               po::value<std::vector<unsigned>>(&_poll_config.cpus)
+                   ->multitoken()
+                   ->value_name("<n> ..."),
+               "CPU to pin the n-th polling thread to (may be repeated)");
+    config_add("poll-spin",
+               po::value<int64_t>(&poll_spin)
+                   ->value_name("<us>")
+                   ->default_value(poll_spin),
+               "time a polling thread keeps polling without activity before "
+               "it sleeps until woken by a client (0: never sleep)");
+    config_add("poll-max-sleep",
+               po::value<int64_t>(&poll_max_sleep)
+                   ->value_name("<us>")
+                   ->default_value(poll_max_sleep),
+               "longest sleep of an idle polling thread in microseconds");
+    config_add("monitor,m",
+               po::value<std::string>(&_monitor_uri)
+                   ->value_name("<uri>")
+                   ->implicit_value("influx1:login:8086:cri_server"),
+               "publish polling and perf counter statistics to InfluxDB (or "
+               "\"file:cout\" for console output)");
+    config_add("perf-interval",
+               po::value<int64_t>(&perf_interval)
+                   ->value_name("<ms>")
+                   ->default_value(perf_interval),
+               "interval for publishing the channel performance counters to "
+               "the monitor in milliseconds (0: disabled)");
+    config_add("read-pointer-coalescing",
+               po::value<double>(&coalescing_release)
+                   ->value_name("<percent>")
+                   ->default_value(coalescing_release),
+               "buffer space to be released before the read pointers of a "
+               "DMA channel are written to the CRI, in percent of the buffer "
+               "size (0: write every update)");
+    config_add("read-pointer-max-delay",
+               po::value<int64_t>(&coalescing_delay)
+                   ->value_name("<us>")
+                   ->default_value(coalescing_delay),
+               "longest delay of a coalesced read pointer update in "
+               "microseconds");
+    config_add("read-pointer-watermark",
+               po::value<double>(&coalescing_watermark)
+                   ->value_name("<percent>")
+                   ->default_value(coalescing_watermark),
+               "DMA buffer fill level in percent above which read pointer "
+               "updates are written without coalescing");
+    config_add("init-threads",
+               po::value<size_t>(&_init_threads)
+                   ->value_name("<n>")
+                   ->default_value(_init_threads),
+               "number of channels whose buffers and DMA engines are "
+               "initialized in parallel");
+    config_add("persistent-buffers",
+               po::value<bool>(&_persistent_buffers)
+                   ->value_name("<bool>")
+                   ->default_value(_persistent_buffers),
+               "keep the shared memory and its DMA registration on exit and "
+               "reuse them on restart, skipping allocation and pinning");
+    config_add("buffer-numa-node",
+               po::value<std::string>(&buffer_numa_node)
+                   ->value_name("<n|auto>"),
+               "bind the channel buffers to a NUMA node (auto: the node of "
+               "the CRI)");
+    for (size_t i = 0; i < _num_max_channels; ++i) {
+      config_add(("c" + std::to_string(i) + "_hugepages").c_str(),
+                 po::value<bool>()->value_name("<bool>"),
+                 ("allocate the channel " + std::to_string(i) +
+                  " buffers from transparent huge pages")
+                     .c_str());
+    }
 
     po::options_description cmdline_options("Allowed options");
     cmdline_options.add(generic).add(config);
@@ -182,6 +303,55 @@ private:
       L_(debug) << "CRI address: autodetect";
     }
 
+    _buffer_placement.resize(_num_max_channels);
+    for (size_t i = 0; i < _num_max_channels; ++i) {
+      std::string key = "c" + std::to_string(i) + "_hugepages";
+      if (vm.count(key) != 0u && vm[key].as<bool>()) {
+        _buffer_placement.at(i).hugepages = true;
+        L_(info) << "Channel " << i << ": huge page buffers";
+      }
+    }
+    if (buffer_numa_node == "auto") {
+      _buffer_numa_auto = true;
+    } else if (!buffer_numa_node.empty()) {
+      int node = std::stoi(buffer_numa_node);
+      L_(info) << "Buffer NUMA node: " << node;
+      for (auto& placement : _buffer_placement) {
+        placement.numa_node = node;
+      }
+    }
+
+    if (poll_interval < 0 || poll_spin < 0 || poll_max_sleep <= 0) {
+      throw ParametersException("invalid polling thread timing");
+    }
+    _poll_config.interval = std::chrono::microseconds(poll_interval);
+    _poll_config.spin = std::chrono::microseconds(poll_spin);
+    _poll_config.max_sleep = std::chrono::microseconds(poll_max_sleep);
+    if (perf_interval < 0) {
+      throw ParametersException("invalid perf counter interval");
+    }
+    _perf_interval = std::chrono::milliseconds(perf_interval);
+    if (coalescing_release < 0 || coalescing_release > 100 ||
+        coalescing_delay < 0 || coalescing_watermark < 0 ||
+        coalescing_watermark > 100) {
+      throw ParametersException("invalid read pointer coalescing");
+    }
+    _coalescing.min_release = coalescing_release / 100;
+    _coalescing.max_delay = std::chrono::microseconds(coalescing_delay);
+    _coalescing.high_watermark = coalescing_watermark / 100;
+    if (_coalescing.min_release > 0) {
+      L_(info) << "Read pointer coalescing: " << coalescing_release << " % ("
+               << coalescing_delay << " us max. delay)";
+    }
+    if (_poll_config.threads > 0) {
+      if (!_lockfree_channels) {
+        L_(info) << "poll threads enabled, using lock-free channels";
+        _lockfree_channels = true;
+      }
+      L_(info) << "Polling threads: " << _poll_config.threads << " ("
+               << poll_interval << " us interval)";
+    }
+
     L_(info) << "Shared memory file: " << _shm;
     L_(info) << print_buffer_info();
   }
@@ -193,4 +363,13 @@ private:
   size_t _desc_buffer_size_exp;
   std::string _exec;
   bool _archivable_data;
+  bool _lockfree_channels;
+  shm_poll_config _poll_config;
+  std::string _monitor_uri;
+  std::chrono::milliseconds _perf_interval{1000};
+  std::vector<MemoryPlacement> _buffer_placement;
+  bool _buffer_numa_auto = false;
+  read_pointer_coalescing _coalescing;
+  size_t _init_threads = 1;
+  bool _persistent_buffers = false;
 };
@@ -0,0 +1,173 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#pragma once
+
+#include "ThreadContainer.hpp"
+#include "log.hpp"
+#include "shm_channel_server.hpp"
+#include "shm_device.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Configuration of dedicated DMA completion polling threads.
+struct shm_poll_config {
+  /// Number of polling threads (zero: poll from the request loop)
+  size_t threads = 0;
+  /// Interval between two polling rounds of a thread (zero: busy-poll)
+  std::chrono::microseconds interval{10};
+  /// CPU to pin the n-th polling thread to (none if not given)
+  std::vector<unsigned> cpus;
+  /// Time a thread keeps polling after the last activity before it backs
+  /// off to sleeping (zero: never back off)
+  std::chrono::microseconds spin{0};
+  /// Longest sleep of an idle thread, client requests wake it up earlier
+  std::chrono::microseconds max_sleep{10000};
+};
+
+/// A thread that polls and publishes the indices of a subset of
+/// lock-free channels, independent of the other channels of the device.
+template <typename T_DESC, typename T_DATA>
+class shm_channel_poller : public ThreadContainer {
+
+public:
+  using shm_channel_server_type = shm_channel_server<T_DESC, T_DATA>;
+
+  shm_channel_poller(shm_device* shm_dev,
+                     size_t index,
+                     const shm_poll_config& config,
+                     int cpu = -1)
+      : m_shm_dev(shm_dev), m_index(index), m_interval(config.interval),
+        m_spin(config.spin), m_max_sleep(config.max_sleep), m_cpu(cpu) {}
+
+  shm_channel_poller(const shm_channel_poller&) = delete;
+  void operator=(const shm_channel_poller&) = delete;
+
+  ~shm_channel_poller() { stop(); }
+
+  /// Add a channel to be served by this thread (before start()).
+  void add_channel(shm_channel_server_type* shm_ch) {
+    assert(shm_ch->lockfree());
+    m_channels.push_back(shm_ch);
+  }
+
+  void start() { m_thread = std::thread(&shm_channel_poller::run, this); }
+
+  void stop() {
+    m_stop = true;
+    m_shm_dev->m_poll_event.notify();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  std::string description() const {
+    std::string s = "poll thread " + std::to_string(m_index) + ": " +
+                    std::to_string(m_channels.size()) + " channel(s), " +
+                    std::to_string(m_interval.count()) + " us interval";
+    if (m_spin.count() > 0) {
+      s += ", adaptive (" + std::to_string(m_spin.count()) + " us spin, " +
+           std::to_string(m_max_sleep.count()) + " us max. sleep)";
+    }
+    if (m_cpu >= 0) {
+      s += ", cpu " + std::to_string(m_cpu);
+    }
+    return s;
+  }
+
+  size_t index() const { return m_index; }
+
+  /// Total time spent polling (spinning), in microseconds.
+  uint64_t spin_time() const { return m_spin_time_us.load(); }
+
+  /// Total time spent sleeping in adaptive mode, in microseconds.
+  uint64_t sleep_time() const { return m_sleep_time_us.load(); }
+
+  /// Number of transitions from sleeping back to spinning.
+  uint64_t wakeups() const { return m_wakeups.load(); }
+
+private:
+  void run() {
+    if (m_cpu >= 0) {
+      set_cpu(m_cpu);
+    }
+    using clock = std::chrono::steady_clock;
+    auto last_active = clock::now();
+    auto backoff = initial_backoff();
+    bool sleeping = false;
+    while (!m_stop) {
+      auto round_start = clock::now();
+      // only index changes count as activity, not requests of waiting
+      // clients
+      bool active = false;
+      for (shm_channel_server_type* shm_ch : m_channels) {
+        shm_ch->poll_lockfree(active);
+      }
+      if (active) {
+        last_active = round_start;
+        backoff = initial_backoff();
+        if (sleeping) {
+          sleeping = false;
+          ++m_wakeups;
+        }
+      }
+
+      if (m_spin.count() == 0 || round_start - last_active < m_spin) {
+        if (m_interval.count() > 0) {
+          std::this_thread::sleep_for(m_interval);
+        } else {
+          std::this_thread::yield();
+        }
+        m_spin_time_us += elapsed_us(round_start);
+      } else {
+        // no activity for a while, sleep until a client asks for data
+        sleeping = true;
+        m_shm_dev->m_poll_event.wait([this] { return requested(); },
+                                     backoff);
+        backoff = std::min(2 * backoff, m_max_sleep);
+        m_sleep_time_us += elapsed_us(round_start);
+      }
+    }
+  }
+
+  // Whether a client of any channel of this thread waits for new data
+  bool requested() const {
+    if (m_stop) {
+      return true;
+    }
+    return std::any_of(m_channels.begin(), m_channels.end(),
+                       [](shm_channel_server_type* shm_ch) {
+                         return shm_ch->write_index_requested();
+                       });
+  }
+
+  std::chrono::microseconds initial_backoff() const {
+    return std::max(m_interval, std::chrono::microseconds(1));
+  }
+
+  static uint64_t
+  elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  shm_device* m_shm_dev;
+  size_t m_index;
+  std::chrono::microseconds m_interval;
+  std::chrono::microseconds m_spin;
+  std::chrono::microseconds m_max_sleep;
+  int m_cpu;
+  std::vector<shm_channel_server_type*> m_channels;
+  std::atomic<bool> m_stop{false};
+  std::atomic<uint64_t> m_spin_time_us{0};
+  std::atomic<uint64_t> m_sleep_time_us{0};
+  std::atomic<uint64_t> m_wakeups{0};
+  std::thread m_thread;
+};
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "MemoryPlacement.hpp"
 #include "cri_channel.hpp"
 #include "log.hpp"
 #include "shm_channel.hpp"
@@ -9,11 +10,27 @@
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <string>
 
 namespace ip = boost::interprocess;
 
+/// Coalescing of the read pointer updates written to the DMA engine.
+/** A pending update is written once enough buffer space has been released,
+    once it has been delayed for long enough, or once the DMA buffer is
+    filled beyond the high watermark. */
+struct read_pointer_coalescing {
+  /// Buffer fraction to be released per written update (zero: write every
+  /// update)
+  double min_release = 0;
+  /// Longest delay of a pending update while the read index advances
+  std::chrono::microseconds max_delay{100};
+  /// Buffer fill level at which pending updates are written immediately
+  double high_watermark = 0.5;
+};
+
 template <typename T_DESC, typename T_DATA> class shm_channel_server {
 
 public:
@@ -22,21 +39,37 @@ public:
                      size_t index,
                      cri::cri_channel* cri_channel,
                      size_t data_buffer_size_exp,
-                     size_t desc_buffer_size_exp)
+                     size_t desc_buffer_size_exp,
+                     bool lockfree = false,
+                     const MemoryPlacement& placement = {},
+                     const read_pointer_coalescing& coalescing = {},
+                     bool persistent_buffers = false,
+                     void* kept_data_buffer = nullptr,
+                     void* kept_desc_buffer = nullptr)
       : m_shm(shm), m_shm_dev(shm_dev), m_index(index),
         m_cri_channel(cri_channel),
         m_data_buffer_size_exp(data_buffer_size_exp),
-        m_desc_buffer_size_exp(desc_buffer_size_exp) {
+        m_desc_buffer_size_exp(desc_buffer_size_exp),
+        m_coalescing(coalescing) {
+
+    auto start = std::chrono::steady_clock::now();
 
-    // allocate buffers
-    void* data_buffer_raw = alloc_buffer(data_buffer_size_exp, data_item_size);
-    void* desc_buffer_raw = alloc_buffer(desc_buffer_size_exp, desc_item_size);
+    // allocate buffers, placement must be applied before DMA registration;
+    // buffers kept from a previous run are still registered
+    void* data_buffer_raw =
+        kept_data_buffer != nullptr
+            ? kept_data_buffer
+            : alloc_buffer(data_buffer_size_exp, data_item_size, placement);
+    void* desc_buffer_raw =
+        kept_desc_buffer != nullptr
+            ? kept_desc_buffer
+            : alloc_buffer(desc_buffer_size_exp, desc_item_size, placement);
 
     // constuct channel exchange object in shared memory
     std::string channel_name = "shm_channel_" + std::to_string(m_index);
     m_shm_ch = m_shm->construct<shm_channel>(channel_name.c_str())(
         m_shm, data_buffer_raw, data_buffer_size_exp, sizeof(T_DATA),
-        desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC));
+        desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC), lockfree);
 
     // initialize buffer info
     T_DATA* data_buffer = reinterpret_cast<T_DATA*>(data_buffer_raw);
@@ -46,6 +79,7 @@ public:
         new RingBufferView<T_DATA>(data_buffer, data_buffer_size_exp));
     m_desc_buffer_view = std::unique_ptr<RingBufferView<T_DESC>>(
         new RingBufferView<T_DESC>(desc_buffer, desc_buffer_size_exp));
+    auto allocated = std::chrono::steady_clock::now();
 
     // initialize cri DMA engine
     static_assert(desc_item_size == (UINT64_C(1) << 5),
@@ -54,20 +88,31 @@ public:
                   "incompatible data_item_size in shm_channel_server");
 
     m_cri_channel->init_dma(data_buffer_raw, data_buffer_size_exp + 0,
-                            desc_buffer_raw, desc_buffer_size_exp + 5);
+                            desc_buffer_raw, desc_buffer_size_exp + 5,
+                            persistent_buffers);
     m_dma_transfer_size = m_cri_channel->dma()->dma_transfer_size();
 
     m_cri_channel->enable_readout();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    L_(info) << "channel " << m_index << " initialized: buffers "
+             << ms(allocated - start).count() << " ms, DMA engine "
+             << ms(std::chrono::steady_clock::now() - allocated).count()
+             << " ms";
   }
 
   ~shm_channel_server() {
     try {
       ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
       update_write_index(lock);
+      if (m_shm_ch->lockfree()) {
+        m_shm_ch->publish_write_index(fetch_write_index().index);
+      }
       m_shm_ch->set_eof(lock, true);
     } catch (ip::interprocess_exception const& e) {
       L_(error) << "Failed to shut down channel: " << e.what();
     }
+    flush_read_pointers();
     m_cri_channel->disable_readout();
     m_cri_channel->deinit_dma();
     // TODO destroy channel object and deallocate buffers if it is worth to do
@@ -75,7 +120,52 @@ public:
 
   bool check_pending_req(ip::scoped_lock<ip::interprocess_mutex>& lock) {
     assert(lock); // ensure mutex is really owned
-    return m_shm_ch->req_read_index(lock) || m_shm_ch->req_write_index(lock);
+    return m_shm_ch->req_read_index(lock) || m_shm_ch->req_write_index(lock) ||
+           (m_shm_ch->lockfree() && m_shm_ch->write_index_requested()) ||
+           m_read_pointers_pending;
+  }
+
+  bool lockfree() const { return m_shm_ch->lockfree(); }
+
+  // Whether a client of a lock-free channel waits for a new write index
+  bool write_index_requested() const {
+    return m_shm_ch->write_index_requested();
+  }
+
+  // Lock-free mode: pass a new read index to the hardware and publish the
+  // current write index. Returns whether the channel is active, i.e., any
+  // index has changed or a client has requested an update.
+  bool poll_lockfree() {
+    bool progress = false;
+    return poll_lockfree(progress);
+  }
+
+  // As above, additionally sets progress if any index has changed
+  bool poll_lockfree(bool& progress) {
+    assert(m_shm_ch->lockfree());
+    bool requested = m_shm_ch->take_write_index_request();
+    bool active = false;
+
+    // release buffer space up to the minimum of all critical cursors
+    auto read_index = m_shm_ch->published_min_read_index();
+    if (read_index && !(*read_index == m_applied_read_index)) {
+      set_sw_read_pointers(*read_index);
+      m_shm_ch->publish_read_index(*read_index);
+      m_applied_read_index = *read_index;
+      active = true;
+    } else if (m_read_pointers_pending && !coalesce()) {
+      flush_read_pointers();
+      active = true;
+    }
+
+    DualIndex write_index = fetch_write_index().index;
+    if (!(write_index == m_published_write_index)) {
+      m_shm_ch->publish_write_index(write_index);
+      m_published_write_index = write_index;
+      active = true;
+    }
+    progress |= active;
+    return active || requested;
   }
 
   void try_handle_req(ip::scoped_lock<ip::interprocess_mutex>& lock) {
@@ -86,13 +176,11 @@ public:
       // reset req before releasing lock ensures not to miss last req
       m_shm_ch->set_req_read_index(lock, false);
       lock.unlock();
-      L_(trace) << "updating read_index: data " << read_index.data << " desc "
-                << read_index.desc;
-
-      m_cri_channel->dma()->set_sw_read_pointers(
-          hw_pointer(read_index.data, m_data_buffer_size_exp, data_item_size,
-                     m_dma_transfer_size),
-          hw_pointer(read_index.desc, m_desc_buffer_size_exp, desc_item_size));
+      set_sw_read_pointers(read_index);
+      lock.lock();
+    } else if (m_read_pointers_pending && !coalesce()) {
+      lock.unlock();
+      flush_read_pointers();
       lock.lock();
     }
 
@@ -105,17 +193,77 @@ private:
   void update_write_index(ip::scoped_lock<ip::interprocess_mutex>& lock) {
     m_shm_ch->set_req_write_index(lock, false);
     lock.unlock();
-    // fill write indices
+    TimedDualIndex write_index = fetch_write_index();
+    L_(trace) << "fetching write_index: data " << write_index.index.data
+              << " desc " << write_index.index.desc;
+    lock.lock();
+    m_shm_ch->set_write_index(lock, write_index);
+  }
+
+  // Read the current write indices from the hardware
+  TimedDualIndex fetch_write_index() {
     TimedDualIndex write_index;
     write_index.index.desc = m_cri_channel->dma()->get_desc_index();
     write_index.index.data =
         m_desc_buffer_view->at(write_index.index.desc - 1).offset +
         m_desc_buffer_view->at(write_index.index.desc - 1).size;
     write_index.updated = boost::posix_time::microsec_clock::universal_time();
-    L_(trace) << "fetching write_index: data " << write_index.index.data
-              << " desc " << write_index.index.desc;
-    lock.lock();
-    m_shm_ch->set_write_index(lock, write_index);
+    m_known_write_index = write_index.index;
+    return write_index;
+  }
+
+  // Pass a new read index to the hardware, possibly coalesced with later
+  // ones (see read_pointer_coalescing)
+  void set_sw_read_pointers(const DualIndex read_index) {
+    m_pending_read_index = read_index;
+    m_read_pointers_pending = true;
+    if (!coalesce()) {
+      flush_read_pointers();
+    }
+  }
+
+  // Write a pending read index to the hardware, returns whether there was
+  // one
+  bool flush_read_pointers() {
+    if (!m_read_pointers_pending) {
+      return false;
+    }
+    const DualIndex& read_index = m_pending_read_index;
+    L_(trace) << "updating read_index: data " << read_index.data << " desc "
+              << read_index.desc;
+    m_cri_channel->dma()->set_sw_read_pointers(
+        hw_pointer(read_index.data, m_data_buffer_size_exp, data_item_size,
+                   m_dma_transfer_size),
+        hw_pointer(read_index.desc, m_desc_buffer_size_exp, desc_item_size));
+    m_hw_read_index = read_index;
+    m_hw_read_index_time = std::chrono::steady_clock::now();
+    m_read_pointers_pending = false;
+    return true;
+  }
+
+  // Whether the pending read index may be held back
+  bool coalesce() const {
+    if (m_coalescing.min_release <= 0) {
+      return false;
+    }
+    auto fraction = [this](const DualIndex& end, const DualIndex& begin) {
+      return std::max(
+          static_cast<double>(end.data - begin.data) /
+              static_cast<double>(UINT64_C(1) << m_data_buffer_size_exp),
+          static_cast<double>(end.desc - begin.desc) /
+              static_cast<double>(UINT64_C(1) << m_desc_buffer_size_exp));
+    };
+    // fill level as of the latest write index read from the hardware
+    DualIndex write_index{std::max(m_known_write_index.desc,
+                                   m_pending_read_index.desc),
+                          std::max(m_known_write_index.data,
+                                   m_pending_read_index.data)};
+    return fraction(m_pending_read_index, m_hw_read_index) <
+               m_coalescing.min_release &&
+           fraction(write_index, m_hw_read_index) <
+               m_coalescing.high_watermark &&
+           std::chrono::steady_clock::now() - m_hw_read_index_time <
+               m_coalescing.max_delay;
   }
 
   // Convert index into byte pointer for hardware
@@ -135,10 +283,23 @@ private:
     return byte_index & ~(dma_size - 1);
   }
 
-  void* alloc_buffer(size_t size_exp, size_t item_size) {
+  void* alloc_buffer(size_t size_exp,
+                     size_t item_size,
+                     const MemoryPlacement& placement) {
     size_t bytes = (UINT64_C(1) << size_exp) * item_size;
     L_(trace) << "allocating shm buffer of " << bytes << " bytes";
-    return m_shm->allocate_aligned(bytes, sysconf(_SC_PAGESIZE));
+    if (!placement.hugepages && placement.numa_node < 0) {
+      return m_shm->allocate_aligned(bytes, sysconf(_SC_PAGESIZE));
+    }
+    // huge pages are located relative to the start of the shared memory
+    // object, so that contiguous regions yield a short scatter-gather list
+    size_t alignment = placement.hugepages
+                           ? huge_page_size
+                           : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* buffer = m_shm->get_address_from_handle(
+        allocate_region(*m_shm, bytes, alignment));
+    place_memory(buffer, bytes, placement);
+    return buffer;
   }
 
   ip::managed_shared_memory* m_shm;
@@ -152,6 +313,16 @@ private:
   std::unique_ptr<RingBufferView<T_DESC>> m_desc_buffer_view;
   size_t m_data_buffer_size_exp;
   size_t m_desc_buffer_size_exp;
+  DualIndex m_applied_read_index{0, 0};
+  DualIndex m_published_write_index{0, 0};
+
+  // read pointer update coalescing
+  read_pointer_coalescing m_coalescing;
+  DualIndex m_pending_read_index{0, 0};
+  bool m_read_pointers_pending = false;
+  DualIndex m_hw_read_index{0, 0};
+  std::chrono::steady_clock::time_point m_hw_read_index_time;
+  DualIndex m_known_write_index{0, 0};
   constexpr static size_t data_item_size = sizeof(T_DATA);
   constexpr static size_t desc_item_size = sizeof(T_DESC);
 };
@@ -4,7 +4,10 @@
 
 #include "cri_channel.hpp"
 #include "cri_device.hpp"
+#include "Monitor.hpp"
+#include "System.hpp"
 #include "log.hpp"
+#include "shm_channel_poller.hpp"
 #include "shm_channel_server.hpp"
 #include "shm_device.hpp"
 #include <boost/date_time/posix_time/posix_time_types.hpp>
@@ -12,12 +15,18 @@
 #include <boost/interprocess/sync/interprocess_condition.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <algorithm>
+#include <chrono>
 #include <csignal>
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace ip = boost::interprocess;
 
@@ -25,14 +34,22 @@ template <typename T_DESC, typename T_DATA> class shm_device_server {
 
 public:
   using shm_channel_server_type = shm_channel_server<T_DESC, T_DATA>;
+  using shm_channel_poller_type = shm_channel_poller<T_DESC, T_DATA>;
 
   shm_device_server(cri::cri_device* cri,
                     std::string shm_identifier,
                     size_t data_buffer_size_exp,
                     size_t desc_buffer_size_exp,
-                    volatile std::sig_atomic_t* signal_status)
+                    volatile std::sig_atomic_t* signal_status,
+                    bool lockfree = false,
+                    const shm_poll_config& poll = {},
+                    const std::vector<MemoryPlacement>& placement = {},
+                    const read_pointer_coalescing& coalescing = {},
+                    size_t init_threads = 1,
+                    bool persistent_buffers = false)
       : m_cri(cri), m_shm_identifier(std::move(shm_identifier)),
-        m_signal_status(signal_status) {
+        m_signal_status(signal_status),
+        m_persistent_buffers(persistent_buffers) {
 
     std::vector<cri::cri_channel*> cri_channels = m_cri->channels();
 
@@ -46,50 +63,137 @@ public:
                        std::end(cri_channels));
     L_(info) << "enabled cri channels detected: " << cri_channels.size();
 
+    // buffer placement per hardware channel index
+    auto channel_placement = [&placement](cri::cri_channel* channel) {
+      size_t i = channel->channel_index();
+      return i < placement.size() ? placement[i] : MemoryPlacement();
+    };
+
     // create a big enough shared memory segment
-    size_t shm_size = ((UINT64_C(1) << data_buffer_size_exp) * sizeof(T_DATA) +
-                       (UINT64_C(1) << desc_buffer_size_exp) * sizeof(T_DESC) +
-                       2 * sysconf(_SC_PAGESIZE) + sizeof(shm_channel)) *
-                          cri_channels.size() +
-                      sizeof(shm_device) + 1000;
-    m_shm = std::make_unique<ip::managed_shared_memory>(
-        ip::create_only, m_shm_identifier.c_str(), shm_size);
+    size_t shm_size = sizeof(shm_device) + 1000;
+    for (cri::cri_channel* channel : cri_channels) {
+      size_t alignment = channel_placement(channel).hugepages
+                             ? huge_page_size
+                             : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      shm_size += (UINT64_C(1) << data_buffer_size_exp) * sizeof(T_DATA) +
+                  (UINT64_C(1) << desc_buffer_size_exp) * sizeof(T_DESC) +
+                  2 * alignment + sizeof(shm_channel);
+    }
+    std::vector<std::pair<void*, void*>> kept_buffers;
+    if (m_persistent_buffers) {
+      m_cri->keep_dma_buffers(true);
+      kept_buffers = open_kept_segment(shm_size, cri_channels,
+                                       data_buffer_size_exp,
+                                       desc_buffer_size_exp);
+    }
+    if (!m_shm) {
+      m_shm = std::make_unique<ip::managed_shared_memory>(
+          ip::create_only, m_shm_identifier.c_str(), shm_size);
+      if (m_persistent_buffers) {
+        store_channel_indices(cri_channels);
+      }
+    }
 
     // constuct device exchange object in sharde memory
     std::string device_name = "shm_device";
     m_shm_dev = m_shm->construct<shm_device>(device_name.c_str())();
 
-    // create channels for active cri channels
-    size_t idx = 0;
-    for (cri::cri_channel* channel : cri_channels) {
-      m_shm_ch_vec.push_back(std::make_unique<shm_channel_server_type>(
+    // create channels for active cri channels, initializing up to
+    // init_threads of them in parallel
+    auto start = std::chrono::steady_clock::now();
+    auto create_channel = [&](size_t idx, cri::cri_channel* channel) {
+      std::pair<void*, void*> kept = idx < kept_buffers.size()
+                                         ? kept_buffers[idx]
+                                         : std::pair<void*, void*>();
+      return std::make_unique<shm_channel_server_type>(
           m_shm.get(), m_shm_dev, idx, channel, data_buffer_size_exp,
-          desc_buffer_size_exp));
-      ++idx;
+          desc_buffer_size_exp, lockfree, channel_placement(channel),
+          coalescing, m_persistent_buffers, kept.first, kept.second);
+    };
+    auto policy =
+        init_threads > 1 ? std::launch::async : std::launch::deferred;
+    std::deque<std::future<std::unique_ptr<shm_channel_server_type>>> pending;
+    auto finish_channel = [&] {
+      m_shm_ch_vec.push_back(pending.front().get());
+      pending.pop_front();
       m_shm_dev->inc_num_channels();
+    };
+    for (size_t idx = 0; idx < cri_channels.size(); ++idx) {
+      if (pending.size() >= std::max<size_t>(init_threads, 1)) {
+        finish_channel();
+      }
+      pending.push_back(
+          std::async(policy, create_channel, idx, cri_channels[idx]));
+    }
+    while (!pending.empty()) {
+      finish_channel();
+    }
+    L_(info) << m_shm_ch_vec.size() << " channels initialized in "
+             << std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count()
+             << " ms";
+
+    // distribute the channels over the polling threads
+    if (poll.threads > 0 && lockfree) {
+      size_t num_threads = std::min(poll.threads, m_shm_ch_vec.size());
+      for (size_t i = 0; i < num_threads; ++i) {
+        int cpu = i < poll.cpus.size() ? static_cast<int>(poll.cpus[i]) : -1;
+        m_pollers.push_back(std::make_unique<shm_channel_poller_type>(
+            m_shm_dev, i, poll, cpu));
+      }
+      for (size_t i = 0; i < m_shm_ch_vec.size(); ++i) {
+        m_pollers[i % num_threads]->add_channel(m_shm_ch_vec[i].get());
+      }
+    } else if (poll.threads > 0) {
+      L_(warning) << "polling threads require lock-free channels, ignored";
     }
   }
 
   ~shm_device_server() {
-    ip::shared_memory_object::remove(m_shm_identifier.c_str());
+    stop_pollers();
+    if (!m_persistent_buffers) {
+      ip::shared_memory_object::remove(m_shm_identifier.c_str());
+    }
   }
 
   void run() {
     if (!m_run) { // don't start twice
       m_run = true;
+      if (!m_pollers.empty()) {
+        run_pollers();
+        return;
+      }
       L_(info) << "cri server started and running";
       while (m_run) {
+        // serve lock-free channels without taking the lock
+        bool pending_req = false;
+        for (const std::unique_ptr<shm_channel_server_type>& shm_ch :
+             m_shm_ch_vec) {
+          if (shm_ch->lockfree()) {
+            pending_req |= shm_ch->poll_lockfree();
+          }
+        }
+
         // claim lock at start-up
         ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
 
         // check nothing is pending everytime before sleeping
         // INFO: need to loop over all individual requests,
         // alternative would be global request cue.
-        bool pending_req = false;
         for (const std::unique_ptr<shm_channel_server_type>& shm_ch :
              m_shm_ch_vec) {
           pending_req |= shm_ch->check_pending_req(lock);
         }
+        if (!pending_req) {
+          // announce idleness, then check again for lock-free requests
+          // that may have missed it
+          m_shm_dev->set_server_idle(true);
+          for (const std::unique_ptr<shm_channel_server_type>& shm_ch :
+               m_shm_ch_vec) {
+            pending_req |= shm_ch->check_pending_req(lock);
+          }
+        }
         if (!pending_req) {
           // sleep if nothing is pending
           auto const abs_time =
@@ -97,6 +201,7 @@ public:
               boost::posix_time::milliseconds(100);
           m_shm_dev->m_cond_req.timed_wait(lock, abs_time);
         }
+        m_shm_dev->set_server_idle(false);
         if (*m_signal_status != 0) {
           stop();
         }
@@ -112,7 +217,117 @@ public:
 
   void stop() { m_run = false; }
 
+  // Publish polling thread statistics to the given monitor
+  void set_monitor(cbm::Monitor* monitor) { m_monitor = monitor; }
+
 private:
+  // Name of the hardware channel index array in a kept segment
+  static constexpr const char* channel_indices_name = "cri_channel_indices";
+
+  // Record which hardware channel (and thus DMA buffer id) each shm channel
+  // belongs to, so that a restart can tell whether the buffers still match
+  void store_channel_indices(const std::vector<cri::cri_channel*>& channels) {
+    size_t* indices =
+        m_shm->construct<size_t>(channel_indices_name)[channels.size()]();
+    for (size_t i = 0; i < channels.size(); ++i) {
+      indices[i] = channels[i]->channel_index();
+    }
+  }
+
+  // Open the segment of a previous run and return the buffers of its
+  // channels, whose DMA registrations are still in place. Returns an empty
+  // vector and removes the segment if it does not match this configuration.
+  std::vector<std::pair<void*, void*>>
+  open_kept_segment(size_t shm_size,
+                    const std::vector<cri::cri_channel*>& channels,
+                    size_t data_buffer_size_exp,
+                    size_t desc_buffer_size_exp) {
+    try {
+      m_shm = std::make_unique<ip::managed_shared_memory>(
+          ip::open_only, m_shm_identifier.c_str());
+    } catch (ip::interprocess_exception const&) {
+      return {}; // no previous run
+    }
+
+    std::vector<std::pair<void*, void*>> buffers;
+    auto indices = m_shm->find<size_t>(channel_indices_name);
+    if (m_shm->get_size() == shm_size && indices.first != nullptr &&
+        indices.second == channels.size()) {
+      for (size_t idx = 0; idx < channels.size(); ++idx) {
+        std::string channel_name = "shm_channel_" + std::to_string(idx);
+        shm_channel* ch = m_shm->find<shm_channel>(channel_name.c_str()).first;
+        if (ch == nullptr ||
+            indices.first[idx] != channels[idx]->channel_index() ||
+            ch->data_buffer_size_exp() != data_buffer_size_exp ||
+            ch->desc_buffer_size_exp() != desc_buffer_size_exp) {
+          break;
+        }
+        buffers.emplace_back(ch->data_buffer_ptr(m_shm.get()),
+                             ch->desc_buffer_ptr(m_shm.get()));
+      }
+    }
+    if (buffers.size() != channels.size()) {
+      L_(info) << "shared memory " << m_shm_identifier
+               << " does not match the configuration, recreating";
+      m_shm = nullptr;
+      ip::shared_memory_object::remove(m_shm_identifier.c_str());
+      return {};
+    }
+
+    // replace the exchange objects, the buffers stay in place
+    for (size_t idx = 0; idx < channels.size(); ++idx) {
+      std::string channel_name = "shm_channel_" + std::to_string(idx);
+      m_shm->destroy<shm_channel>(channel_name.c_str());
+    }
+    m_shm->destroy<shm_device>("shm_device");
+    L_(info) << "reusing shared memory " << m_shm_identifier << " and the "
+             << "DMA buffers of " << buffers.size() << " channels";
+    return buffers;
+  }
+
+  // All channels are served by the polling threads, which never go idle, so
+  // there are no requests left for this thread to wait for
+  void run_pollers() {
+    for (auto& poller : m_pollers) {
+      L_(info) << poller->description();
+      poller->start();
+    }
+    L_(info) << "cri server started and running";
+    auto report_time = std::chrono::steady_clock::now();
+    while (m_run) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      if (*m_signal_status != 0) {
+        stop();
+      }
+      auto now = std::chrono::steady_clock::now();
+      if (m_monitor != nullptr && now > report_time + std::chrono::seconds(1)) {
+        report_time = now;
+        report_pollers();
+      }
+    }
+    stop_pollers();
+  }
+
+  void report_pollers() {
+    auto hostname = fles::system::current_hostname();
+    for (auto& poller : m_pollers) {
+      m_monitor->QueueMetric(
+          "cri_server_poll",
+          {{"host", hostname},
+           {"shm", m_shm_identifier},
+           {"thread", std::to_string(poller->index())}},
+          {{"spin_time_us", poller->spin_time()},
+           {"sleep_time_us", poller->sleep_time()},
+           {"wakeups", poller->wakeups()}});
+    }
+  }
+
+  void stop_pollers() {
+    for (auto& poller : m_pollers) {
+      poller->stop();
+    }
+  }
+
   std::string print_shm_info() {
     std::stringstream ss;
     ss << "SHM INFO" << std::endl
@@ -130,9 +345,14 @@ private:
   cri::cri_device* m_cri;
   std::string m_shm_identifier;
   volatile std::sig_atomic_t* m_signal_status;
+  bool m_persistent_buffers;
   std::unique_ptr<ip::managed_shared_memory> m_shm;
   shm_device* m_shm_dev = nullptr;
   std::vector<std::unique_ptr<shm_channel_server_type>> m_shm_ch_vec;
+  // declared after the channels, so that the threads are stopped first
+  std::vector<std::unique_ptr<shm_channel_poller_type>> m_pollers;
+
+  cbm::Monitor* m_monitor = nullptr;
 
   bool m_run = false;
 };
@@ -0,0 +1,161 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Drive the pattern generators of all CRIs along a load profile.
+
+#include "LoadProfile.hpp"
+#include "cri.hpp"
+#include "device_operator.hpp"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace po = boost::program_options;
+
+namespace {
+volatile std::sig_atomic_t s_interrupted = 0;
+}
+
+static void s_signal_handler(int /* signal_value */) { s_interrupted = 1; }
+
+int main(int argc, char* argv[]) {
+  std::string profile_file;
+  uint32_t interval_ms = 100;
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("profile,p",
+           po::value<std::string>(&profile_file)
+               ->value_name("<file>")
+               ->required(),
+           "load profile to apply (lines of \"<time/s> <rate> [<mc_size>] "
+           "[ramp]\", optionally \"period <time/s>\")");
+  desc_add("interval,i",
+           po::value<uint32_t>(&interval_ms)
+               ->value_name("<ms>")
+               ->default_value(interval_ms),
+           "interval between two rate updates and measurements");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Applies a load profile to the pattern generators of all "
+                   "channels of all CRIs\nwith data source pgen and logs the "
+                   "achieved rates.\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::signal(SIGINT, s_signal_handler);
+  std::signal(SIGTERM, s_signal_handler);
+
+  try {
+    std::ifstream ifs(profile_file);
+    if (!ifs) {
+      throw std::runtime_error("cannot open profile " + profile_file);
+    }
+    LoadProfile profile = LoadProfile::parse(ifs);
+
+    std::unique_ptr<pda::device_operator> dev_op(new pda::device_operator);
+    std::vector<std::unique_ptr<cri::cri_device>> cris;
+    uint64_t num_dev = dev_op->device_count();
+    for (size_t i = 0; i < num_dev; ++i) {
+      cris.push_back(std::make_unique<cri::cri_device>(i));
+    }
+    if (cris.empty()) {
+      throw std::runtime_error("no CRI found");
+    }
+
+    // all settings are written to all boards back to back
+    LoadProfile::Setting applied{-1, 0};
+    auto apply = [&cris, &applied](const LoadProfile::Setting& s) {
+      if (s == applied) {
+        return;
+      }
+      for (auto& cri : cris) {
+        if (s.mc_size != 0 && s.mc_size != applied.mc_size) {
+          cri->set_pgen_mc_size(s.mc_size);
+        }
+        for (cri::cri_channel* channel : cri->channels()) {
+          if (channel->data_source() == cri::cri_channel::rx_pgen) {
+            channel->set_pgen_rate(static_cast<float>(s.rate));
+          }
+        }
+      }
+      applied = s;
+    };
+
+    // the profile follows the PCIe clock of the first board, as counted by
+    // its perf cycle counter, which is reset at each measurement
+    for (auto& cri : cris) {
+      cri->get_perf_snapshot();
+    }
+    apply(profile.at(0));
+
+    std::cout << "time_s,cri,channel,target_rate,mc_size,ms_rate_hz,"
+                 "mc_throughput_bytes_s\n";
+    double device_time = 0;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t loop_cnt = 0;
+    while (s_interrupted == 0 && !profile.finished(device_time)) {
+      ++loop_cnt;
+      std::this_thread::sleep_until(
+          start + loop_cnt * std::chrono::milliseconds(interval_ms));
+
+      std::vector<cri::cri_device::perf_snapshot_t> snapshots;
+      for (auto& cri : cris) {
+        snapshots.push_back(cri->get_perf_snapshot());
+      }
+      uint64_t cycles = snapshots.front().dev.cycles;
+      if (cycles == 0xFFFFFFFF || cycles == 0) {
+        // saturated, fall back to the host clock
+        device_time += interval_ms * 1E-3;
+      } else {
+        device_time += static_cast<double>(cycles) / cri::pci_clk;
+      }
+
+      // rates achieved with the setting applied during the interval
+      for (size_t j = 0; j < cris.size(); ++j) {
+        std::vector<cri::cri_channel*> channels = cris[j]->channels();
+        for (size_t i = 0; i < channels.size(); ++i) {
+          if (channels[i]->data_source() != cri::cri_channel::rx_pgen) {
+            continue;
+          }
+          const auto& perf = snapshots[j].ch.at(i);
+          const auto& perf_gtx = snapshots[j].ch_gtx.at(i);
+          if (perf.cycles == 0 || perf.cycles == 0xFFFFFFFF ||
+              perf_gtx.cycles == 0 || perf_gtx.cycles == 0xFFFFFFFF) {
+            continue;
+          }
+          double ms_rate = static_cast<double>(perf.microslice_cnt) /
+                           (static_cast<double>(perf.cycles) / cri::pkt_clk);
+          double throughput = static_cast<double>(perf_gtx.mc_trans) /
+                              static_cast<double>(perf_gtx.cycles) *
+                              cri::gtx_clk * 8;
+          std::cout << std::fixed << std::setprecision(3) << device_time
+                    << "," << j << "," << i << "," << applied.rate << ","
+                    << applied.mc_size << "," << std::setprecision(0)
+                    << ms_rate << "," << throughput << "\n";
+        }
+      }
+      std::cout << std::flush;
+
+      apply(profile.at(device_time));
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
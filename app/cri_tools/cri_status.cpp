@@ -138,9 +138,14 @@ int main(int argc, char* argv[]) {
         std::cout << "Measurement " << loop_cnt << ":" << std::endl;
       }
       std::string measurement;
+      // capture all counters of a device together
+      std::vector<cri::cri_device::perf_snapshot_t> snapshots;
+      for (auto& cri : cris) {
+        snapshots.push_back(cri->get_perf_snapshot());
+      }
       size_t j = 0;
       for (auto& cri : cris) {
-        cri::cri_device::dev_perf_t dev_perf = cri->get_perf();
+        const cri::cri_device::dev_perf_t& dev_perf = snapshots.at(j).dev;
 
         // check overflow
         if (dev_perf.cycles == 0xFFFFFFFF) {
@@ -149,6 +154,7 @@ int main(int argc, char* argv[]) {
                       << std::endl;
             std::cout << "PCIe stats counter overflow" << std::endl;
           }
+          ++j;
           continue;
         }
 
@@ -194,9 +200,9 @@ int main(int argc, char* argv[]) {
 
         std::stringstream ss;
         for (size_t i = 0; i < num_channels; ++i) {
-          cri::cri_channel::ch_perf_t perf = channels.at(i)->get_perf();
-          cri::cri_channel::ch_perf_gtx_t perf_gtx =
-              channels.at(i)->get_perf_gtx();
+          const cri::cri_channel::ch_perf_t& perf = snapshots.at(j).ch.at(i);
+          const cri::cri_channel::ch_perf_gtx_t& perf_gtx =
+              snapshots.at(j).ch_gtx.at(i);
           bool ready_for_data = channels.at(i)->get_ready_for_data();
 
           // check overflow
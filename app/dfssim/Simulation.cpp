@@ -0,0 +1,343 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "Simulation.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace tl_libfabric;
+
+namespace {
+
+constexpr char record_log_magic[8] = {'F', 'L', 'E', 'S',
+                                      'R', 'L', 'O', 'G'};
+constexpr std::size_t record_log_column_size = 32;
+
+// Read the named unsigned columns of a record log (see RecordLog.hpp).
+std::vector<std::vector<uint64_t>>
+read_record_log(const std::string& path,
+                const std::vector<std::string>& names) {
+  std::ifstream ifs(path, std::ios::binary);
+  char magic[8];
+  uint32_t version = 0;
+  uint32_t column_count = 0;
+  uint64_t record_count = 0;
+  uint64_t dropped = 0;
+  ifs.read(magic, sizeof(magic));
+  ifs.read(reinterpret_cast<char*>(&version), sizeof(version));
+  ifs.read(reinterpret_cast<char*>(&column_count), sizeof(column_count));
+  ifs.read(reinterpret_cast<char*>(&record_count), sizeof(record_count));
+  ifs.read(reinterpret_cast<char*>(&dropped), sizeof(dropped));
+  if (!ifs || std::memcmp(magic, record_log_magic, sizeof(magic)) != 0 ||
+      version != 1) {
+    throw std::runtime_error("not a record log file: " + path);
+  }
+
+  std::vector<std::size_t> column_of(names.size(), column_count);
+  for (uint32_t c = 0; c < column_count; ++c) {
+    char desc[record_log_column_size];
+    ifs.read(desc, sizeof(desc));
+    std::string name(desc, strnlen(desc, sizeof(desc) - 1));
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end()) {
+      column_of[it - names.begin()] = c;
+    }
+  }
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    if (column_of[i] == column_count) {
+      throw std::runtime_error("column \"" + names[i] + "\" missing in " +
+                               path);
+    }
+  }
+
+  std::vector<std::vector<uint64_t>> records;
+  std::vector<uint64_t> words(column_count);
+  for (uint64_t r = 0; r < record_count; ++r) {
+    ifs.read(reinterpret_cast<char*>(words.data()),
+             static_cast<std::streamsize>(words.size() * sizeof(uint64_t)));
+    if (!ifs) {
+      break;
+    }
+    std::vector<uint64_t> record;
+    for (std::size_t column : column_of) {
+      record.push_back(words[column]);
+    }
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+double median(std::vector<double> values) {
+  auto mid = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+  std::nth_element(values.begin(), mid, values.end());
+  return *mid;
+}
+
+} // namespace
+
+void SimulationModel::fit_to_log(const std::string& path) {
+  auto records =
+      read_record_log(path, {"Min duration", "Max duration", "Rounds"});
+  std::vector<double> component_times;
+  std::vector<double> spreads;
+  for (const auto& r : records) {
+    uint64_t min_duration = r[0];
+    uint64_t max_duration = r[1];
+    uint64_t rounds = r[2];
+    // entries of proposed intervals without actual info have no durations
+    if (min_duration == 0 || rounds == 0) {
+      continue;
+    }
+    component_times.push_back(static_cast<double>(min_duration) /
+                              static_cast<double>(rounds * computes));
+    spreads.push_back(static_cast<double>(max_duration - min_duration) /
+                      static_cast<double>(min_duration));
+  }
+  if (component_times.empty()) {
+    throw std::runtime_error("no completed intervals in " + path);
+  }
+  link_bandwidth =
+      static_cast<double>(component_size) / (median(component_times) * 1e-6);
+  jitter = median(spreads);
+}
+
+Simulation::Simulation(const SimulationModel& model,
+                       SimulationSchedulerParameters parameters)
+    : model_(model), parameters_(parameters),
+      transfer_time_(static_cast<int64_t>(
+          static_cast<double>(model.component_size) / model.link_bandwidth *
+          1e9)),
+      random_(model.seed), jitter_(0.0, model.jitter) {
+  if (model_.inputs == 0 || model_.computes == 0) {
+    throw std::runtime_error("at least one input and compute node required");
+  }
+  if (parameters_.interval_length < model_.computes) {
+    throw std::runtime_error(
+        "interval length must not be less than the compute node count");
+  }
+}
+
+SimulationResult Simulation::run() {
+  // start at an arbitrary time, so that no scheduler time point is zero
+  now_ = 1000000000;
+  SchedulerClock::set_source([this] { return time_point(); });
+
+  compute_scheduler_ = DDScheduler::create(
+      0, model_.inputs, parameters_.history_size, parameters_.interval_length,
+      parameters_.speedup_difference_percentage,
+      parameters_.speedup_percentage, parameters_.speedup_interval_count,
+      parameters_.ewma_weight, ".", false);
+  compute_scheduler_->set_begin_time(time_point());
+
+  inputs_.resize(model_.inputs);
+  for (uint32_t i = 0; i < model_.inputs; ++i) {
+    Input& in = inputs_[i];
+    in.scheduler = InputIntervalScheduler::create(
+        i, model_.computes, parameters_.interval_length, ".", false);
+    in.scheduler->set_staggered_rounds(parameters_.staggered_rounds);
+    in.scheduler->update_input_begin_time(time_point());
+    for (uint32_t c = 0; c < model_.computes; ++c) {
+      in.next_ts.push_back(c);
+    }
+    in.in_flight.resize(model_.computes, 0);
+    in.to_send = model_.timeslices;
+    in.link_free = now_;
+    schedule_fire(i, now_);
+  }
+  compute_link_free_.assign(model_.computes, now_);
+  compute_processing_free_.assign(model_.computes, now_);
+  arrived_components_.assign(model_.timeslices, 0);
+
+  const int64_t begin = now_;
+  while (!events_.empty() && completed_ < model_.timeslices) {
+    Event e = events_.top();
+    events_.pop();
+    now_ = e.time;
+    switch (e.type) {
+    case EventType::Fire:
+      if (e.value == inputs_[e.node].fire_generation) {
+        on_fire(e.node);
+      }
+      break;
+    case EventType::Arrival:
+      on_arrival(e.node, e.value);
+      break;
+    case EventType::Ack:
+      on_ack(e.node, e.value);
+      break;
+    case EventType::ActualMetaData:
+      on_actual_meta_data(e.node, e.value);
+      break;
+    case EventType::ProposedMetaData:
+      on_proposed_meta_data(e.node, e.value);
+      break;
+    }
+  }
+  SchedulerClock::set_source({});
+
+  SimulationResult result;
+  result.timeslices = completed_;
+  result.deadlock = completed_ < model_.timeslices;
+  uint64_t last_interval = compute_scheduler_->get_last_completed_interval();
+  result.intervals =
+      last_interval == ConstVariables::MINUS_ONE ? 0 : last_interval + 1;
+  result.duration = static_cast<double>(last_completion_ - begin) * 1e-9;
+  if (result.duration > 0) {
+    result.throughput = static_cast<double>(completed_ * model_.inputs *
+                                            model_.component_size) /
+                        result.duration;
+    double idle = 0;
+    for (const Input& in : inputs_) {
+      idle += static_cast<double>(in.idle) /
+              static_cast<double>(std::max(in.link_free - begin, int64_t(1)));
+    }
+    result.stall_fraction = idle / model_.inputs;
+  }
+  return result;
+}
+
+void Simulation::push(int64_t time,
+                      EventType type,
+                      uint32_t node,
+                      uint64_t value) {
+  events_.push({time, seq_++, type, node, value});
+}
+
+void Simulation::schedule_fire(uint32_t input, int64_t time) {
+  Input& in = inputs_[input];
+  in.fire_scheduled = true;
+  push(time, EventType::Fire, input, ++in.fire_generation);
+}
+
+// Let an input that waits for an acknowledgment or meta-data continue.
+void Simulation::wake(uint32_t input) {
+  Input& in = inputs_[input];
+  if (!in.fire_scheduled && in.to_send > 0) {
+    schedule_fire(input, now_);
+  }
+}
+
+// Mirrors InputChannelSender::send_timeslices().
+void Simulation::on_fire(uint32_t input) {
+  Input& in = inputs_[input];
+  in.fire_scheduled = false;
+  uint64_t up_to_timeslice = in.scheduler->get_last_timeslice_to_send();
+
+  bool sent = false;
+  uint32_t first = input % model_.computes;
+  uint32_t c = first;
+  do {
+    uint64_t ts = in.next_ts[c];
+    if (ts < model_.timeslices && ts <= up_to_timeslice &&
+        in.scheduler->is_connection_turn(c, ts) &&
+        in.in_flight[c] < model_.buffer_size) {
+      send(input, c, ts);
+      in.next_ts[c] += model_.computes;
+      sent = true;
+    }
+    c = (c + 1) % model_.computes;
+  } while (c != first);
+
+  if (in.to_send == 0) {
+    return;
+  }
+  int64_t delay = in.scheduler->get_next_fire_time();
+  // the real sender polls, an idle input is woken by the next message instead
+  if (delay > 0 || sent) {
+    schedule_fire(input, now_ + delay * 1000);
+  }
+}
+
+void Simulation::send(uint32_t input, uint32_t compute, uint64_t timeslice) {
+  Input& in = inputs_[input];
+  int64_t duration = static_cast<int64_t>(
+      static_cast<double>(transfer_time_) * (1.0 + jitter_(random_)));
+  int64_t start = std::max(now_, in.link_free);
+  in.idle += start - in.link_free;
+  in.link_free = start + duration;
+  // the compute node link receives from all inputs, one at a time
+  int64_t arrival =
+      std::max(in.link_free, compute_link_free_[compute] + transfer_time_);
+  compute_link_free_[compute] = arrival;
+
+  ++in.in_flight[compute];
+  --in.to_send;
+  in.scheduler->increament_sent_timeslices(timeslice);
+  push(arrival, EventType::Arrival, compute, timeslice);
+}
+
+void Simulation::on_arrival(uint32_t compute, uint64_t timeslice) {
+  if (++arrived_components_[timeslice] < model_.inputs) {
+    return;
+  }
+  int64_t done = std::max(now_, compute_processing_free_[compute]) +
+                 static_cast<int64_t>(model_.processing_time) * 1000;
+  compute_processing_free_[compute] = done;
+  ++completed_;
+  last_completion_ = std::max(last_completion_, done);
+  for (uint32_t i = 0; i < model_.inputs; ++i) {
+    push(done + static_cast<int64_t>(model_.latency) * 1000, EventType::Ack, i,
+         timeslice);
+  }
+}
+
+void Simulation::on_ack(uint32_t input, uint64_t timeslice) {
+  Input& in = inputs_[input];
+  --in.in_flight[timeslice % model_.computes];
+  in.scheduler->increament_acked_timeslices(timeslice);
+
+  // Mirrors InputChannelConnection::ack_complete_interval_info().
+  while (const IntervalMetaData* meta_data =
+             in.scheduler->get_actual_meta_data(in.next_actual)) {
+    payloads_.push_back(*meta_data);
+    push(now_ + static_cast<int64_t>(model_.latency) * 1000,
+         EventType::ActualMetaData, input, payloads_.size() - 1);
+    ++in.next_actual;
+  }
+  wake(input);
+}
+
+// Mirrors ComputeNodeConnection::on_complete_recv().
+void Simulation::on_actual_meta_data(uint32_t input, uint64_t payload) {
+  const IntervalMetaData meta_data = payloads_[payload];
+  compute_scheduler_->add_actual_meta_data(input, meta_data);
+  inputs_[input].required = meta_data.interval_index + 2;
+  for (uint32_t i = 0; i < model_.inputs; ++i) {
+    try_propose(i);
+  }
+}
+
+// Mirrors ComputeNodeConnection::try_sync_buffer_positions().
+void Simulation::try_propose(uint32_t input) {
+  Input& in = inputs_[input];
+  uint64_t last_completed = compute_scheduler_->get_last_completed_interval();
+  if (in.required == ConstVariables::MINUS_ONE || in.proposed == in.required ||
+      last_completed == ConstVariables::MINUS_ONE ||
+      last_completed + 2 < in.required) {
+    return;
+  }
+  const IntervalMetaData* meta_data =
+      compute_scheduler_->get_proposed_meta_data(input, in.required);
+  if (meta_data == nullptr) {
+    return;
+  }
+  payloads_.push_back(*meta_data);
+  delete meta_data;
+  in.proposed = in.required;
+  push(now_ + static_cast<int64_t>(model_.latency) * 1000,
+       EventType::ProposedMetaData, input, payloads_.size() - 1);
+}
+
+void Simulation::on_proposed_meta_data(uint32_t input, uint64_t payload) {
+  inputs_[input].scheduler->add_proposed_meta_data(payloads_[payload]);
+  wake(input);
+}
+
+// The schedulers compute their delays in whole microseconds. Rounding the
+// time up ensures that they have elapsed when the input is woken.
+SchedulerClock::time_point Simulation::time_point() const {
+  return SchedulerClock::time_point(
+      std::chrono::ceil<std::chrono::microseconds>(
+          std::chrono::nanoseconds(now_)));
+}
@@ -0,0 +1,140 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "DDScheduler.hpp"
+#include "InputIntervalScheduler.hpp"
+#include "IntervalMetaData.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Model of the fabric and the compute nodes of a simulation.
+struct SimulationModel {
+  uint32_t inputs = 16;              ///< Number of input nodes
+  uint32_t computes = 16;            ///< Number of compute nodes
+  uint64_t timeslices = 20000;       ///< Number of timeslices to transmit
+  uint64_t component_size = 1 << 20; ///< Size of a timeslice component
+  double link_bandwidth = 5e9;       ///< Bandwidth of each node link (B/s)
+  double jitter = 0.1;               ///< Maximum relative transfer slowdown
+  uint64_t processing_time = 0;      ///< Time per timeslice on a compute node
+  uint32_t buffer_size = 16;         ///< Components in flight per connection
+  uint64_t latency = 5;              ///< One-way latency of status messages
+  uint32_t seed = 1;                 ///< Seed of the jitter
+
+  /// Derive the link bandwidth and jitter from a compute scheduler log.
+  /** The log is the interval record log written by the DDScheduler
+      (*.compute.min_max_interval_info.bin) of a run with the same number of
+      compute nodes and component size. The fastest input of an interval is
+      assumed to be limited by its link, the spread to the slowest input is
+      taken as jitter. */
+  void fit_to_log(const std::string& path);
+};
+
+/// Parameters of the interval schedulers of a simulation.
+struct SimulationSchedulerParameters {
+  uint32_t history_size = 100;
+  uint32_t interval_length = 10000;
+  uint32_t speedup_difference_percentage = 0;
+  uint32_t speedup_percentage = 0;
+  uint32_t speedup_interval_count = 0;
+  uint32_t ewma_weight = 0;
+  bool staggered_rounds = false;
+};
+
+/// Outcome of a simulation.
+struct SimulationResult {
+  uint64_t timeslices = 0;   ///< Number of completed timeslices
+  uint64_t intervals = 0;    ///< Number of completed intervals
+  double duration = 0;       ///< Simulated time (s)
+  double throughput = 0;     ///< Aggregate throughput (B/s)
+  double stall_fraction = 0; ///< Mean fraction of idle input link time
+  bool deadlock = false;     ///< No progress possible before completion
+};
+
+/// Discrete-event simulation of the DFS interval schedulers.
+/** A Simulation object runs the real InputIntervalScheduler of each input
+    node in virtual time against a simple model of the fabric: each node
+    link transmits one component at a time, status messages take a fixed
+    latency, and the compute nodes process complete timeslices in order.
+    As the DDScheduler is deterministic and receives the same meta-data on
+    every compute node, a single instance stands in for all of them. */
+class Simulation {
+public:
+  /// The Simulation constructor.
+  Simulation(const SimulationModel& model,
+             SimulationSchedulerParameters parameters);
+
+  Simulation(const Simulation&) = delete;
+  void operator=(const Simulation&) = delete;
+
+  /// Run the simulation to completion.
+  SimulationResult run();
+
+private:
+  enum class EventType { Fire, Arrival, Ack, ActualMetaData, ProposedMetaData };
+
+  struct Event {
+    int64_t time; ///< Virtual time (ns)
+    uint64_t seq; ///< Insertion order, to break ties
+    EventType type;
+    uint32_t node;  ///< Input or compute node index
+    uint64_t value; ///< Timeslice, generation or meta-data index
+
+    bool operator>(const Event& other) const {
+      return time != other.time ? time > other.time : seq > other.seq;
+    }
+  };
+
+  struct Input {
+    std::unique_ptr<tl_libfabric::InputIntervalScheduler> scheduler;
+    std::vector<uint64_t> next_ts;   ///< Next timeslice per connection
+    std::vector<uint32_t> in_flight; ///< Unacknowledged per connection
+    uint64_t to_send = 0;            ///< Components not yet sent
+    int64_t link_free = 0;           ///< End of the last transfer
+    int64_t idle = 0;                ///< Time the link was idle
+    uint64_t fire_generation = 0;
+    bool fire_scheduled = false;
+    uint64_t next_actual = 0; ///< Next actual interval to report
+    uint64_t required = tl_libfabric::ConstVariables::MINUS_ONE;
+    uint64_t proposed = tl_libfabric::ConstVariables::MINUS_ONE;
+  };
+
+  void push(int64_t time, EventType type, uint32_t node, uint64_t value);
+  void schedule_fire(uint32_t input, int64_t time);
+  void wake(uint32_t input);
+
+  void on_fire(uint32_t input);
+  void send(uint32_t input, uint32_t compute, uint64_t timeslice);
+  void on_arrival(uint32_t compute, uint64_t timeslice);
+  void on_ack(uint32_t input, uint64_t timeslice);
+  void on_actual_meta_data(uint32_t input, uint64_t payload);
+  void on_proposed_meta_data(uint32_t input, uint64_t payload);
+  void try_propose(uint32_t input);
+
+  [[nodiscard]] tl_libfabric::SchedulerClock::time_point time_point() const;
+
+  SimulationModel model_;
+  SimulationSchedulerParameters parameters_;
+
+  std::priority_queue<Event, std::vector<Event>, std::greater<>> events_;
+  uint64_t seq_ = 0;
+  int64_t now_ = 0;
+
+  std::unique_ptr<tl_libfabric::DDScheduler> compute_scheduler_;
+  std::vector<Input> inputs_;
+  std::vector<int64_t> compute_link_free_;
+  std::vector<int64_t> compute_processing_free_;
+  std::vector<uint32_t> arrived_components_;
+  std::vector<tl_libfabric::IntervalMetaData> payloads_;
+
+  uint64_t completed_ = 0;
+  int64_t last_completion_ = 0;
+  int64_t transfer_time_;
+  std::mt19937_64 random_;
+  std::uniform_real_distribution<double> jitter_;
+};
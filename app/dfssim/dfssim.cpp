@@ -0,0 +1,185 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Simulate the DFS interval schedulers for a sweep of parameters.
+
+#include "Simulation.hpp"
+#include "log.hpp"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+
+int main(int argc, char* argv[]) {
+  SimulationModel model;
+  std::string log_file;
+  std::vector<uint32_t> history_sizes{100};
+  std::vector<uint32_t> interval_lengths{10000};
+  std::vector<uint32_t> speedup_differences{0};
+  std::vector<uint32_t> speedups{0};
+  std::vector<uint32_t> speedup_counts{0};
+  std::vector<uint32_t> ewma_weights{0};
+  std::vector<bool> staggered{false};
+  double bandwidth = model.link_bandwidth * 1e-9;
+  unsigned log_level = 4;
+
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("log-level,l",
+           po::value<unsigned>(&log_level)->default_value(log_level),
+           "set the console log level (all:0)");
+  desc_add("inputs,i",
+           po::value<uint32_t>(&model.inputs)->default_value(model.inputs),
+           "number of input nodes");
+  desc_add(
+      "computes,c",
+      po::value<uint32_t>(&model.computes)->default_value(model.computes),
+      "number of compute nodes");
+  desc_add("timeslices,n",
+           po::value<uint64_t>(&model.timeslices)
+               ->default_value(model.timeslices),
+           "number of timeslices to transmit");
+  desc_add("component-size",
+           po::value<uint64_t>(&model.component_size)
+               ->default_value(model.component_size),
+           "size of a timeslice component in bytes");
+  desc_add("bandwidth", po::value<double>(&bandwidth)->default_value(bandwidth),
+           "bandwidth of each node link in GB/s");
+  desc_add("jitter",
+           po::value<double>(&model.jitter)->default_value(model.jitter),
+           "maximum relative slowdown of a component transfer");
+  desc_add("processing-time",
+           po::value<uint64_t>(&model.processing_time)
+               ->default_value(model.processing_time),
+           "processing time of a timeslice on a compute node in us");
+  desc_add("buffer-size",
+           po::value<uint32_t>(&model.buffer_size)
+               ->default_value(model.buffer_size),
+           "number of components in flight per connection");
+  desc_add("latency",
+           po::value<uint64_t>(&model.latency)->default_value(model.latency),
+           "one-way latency of status messages in us");
+  desc_add("seed", po::value<uint32_t>(&model.seed)->default_value(model.seed),
+           "seed of the transfer jitter");
+  desc_add("from-log", po::value<std::string>(&log_file)->value_name("<file>"),
+           "derive bandwidth and jitter from a compute scheduler log "
+           "(*.compute.min_max_interval_info.bin)");
+  desc_add("scheduler-history-size",
+           po::value<std::vector<uint32_t>>(&history_sizes)
+               ->multitoken()
+               ->default_value(history_sizes, "100"),
+           "scheduler history sizes to simulate");
+  desc_add("scheduler-interval-length",
+           po::value<std::vector<uint32_t>>(&interval_lengths)
+               ->multitoken()
+               ->default_value(interval_lengths, "10000"),
+           "scheduler interval lengths to simulate");
+  desc_add("scheduler-speedup-difference-percentage",
+           po::value<std::vector<uint32_t>>(&speedup_differences)
+               ->multitoken()
+               ->default_value(speedup_differences, "0"),
+           "scheduler speedup difference percentages to simulate");
+  desc_add("scheduler-speedup-percentage",
+           po::value<std::vector<uint32_t>>(&speedups)
+               ->multitoken()
+               ->default_value(speedups, "0"),
+           "scheduler speedup percentages to simulate");
+  desc_add("scheduler-speedup-interval-count",
+           po::value<std::vector<uint32_t>>(&speedup_counts)
+               ->multitoken()
+               ->default_value(speedup_counts, "0"),
+           "scheduler speedup interval counts to simulate");
+  desc_add("scheduler-ewma-weight",
+           po::value<std::vector<uint32_t>>(&ewma_weights)
+               ->multitoken()
+               ->default_value(ewma_weights, "0"),
+           "scheduler EWMA weights to simulate");
+  desc_add("scheduler-staggered-rounds",
+           po::value<std::vector<bool>>(&staggered)
+               ->multitoken()
+               ->default_value(staggered, "false"),
+           "scheduler round staggering settings to simulate");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Simulates the DFS interval schedulers on a model of the "
+                   "fabric and compute\nnodes for each combination of the "
+                   "given scheduler parameters.\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  logging::add_console(static_cast<severity_level>(log_level));
+  model.link_bandwidth = bandwidth * 1e9;
+
+  try {
+    if (!log_file.empty()) {
+      model.fit_to_log(log_file);
+      std::cout << "model from " << log_file << ": bandwidth "
+                << model.link_bandwidth * 1e-9 << " GB/s, jitter "
+                << model.jitter << std::endl;
+    }
+
+    std::cout << std::setw(8) << "history" << std::setw(10) << "interval"
+              << std::setw(8) << "sp_diff" << std::setw(8) << "speedup"
+              << std::setw(8) << "sp_cnt" << std::setw(6) << "ewma"
+              << std::setw(6) << "stag" << std::setw(11) << "intervals"
+              << std::setw(12) << "GB/s" << std::setw(10) << "stall_%"
+              << std::setw(10) << "wall_ms" << std::endl;
+
+    SimulationSchedulerParameters p;
+    for (uint32_t h : history_sizes) {
+      p.history_size = h;
+      for (uint32_t il : interval_lengths) {
+        p.interval_length = il;
+        for (uint32_t sd : speedup_differences) {
+          p.speedup_difference_percentage = sd;
+          for (uint32_t sp : speedups) {
+            p.speedup_percentage = sp;
+            for (uint32_t sc : speedup_counts) {
+              p.speedup_interval_count = sc;
+              for (uint32_t ew : ewma_weights) {
+                p.ewma_weight = ew;
+                for (bool st : staggered) {
+                  p.staggered_rounds = st;
+                  auto start = std::chrono::steady_clock::now();
+                  Simulation simulation(model, p);
+                  SimulationResult r = simulation.run();
+                  auto wall =
+                      std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start);
+                  std::cout << std::setw(8) << h << std::setw(10) << il
+                            << std::setw(8) << sd << std::setw(8) << sp
+                            << std::setw(8) << sc << std::setw(6) << ew
+                            << std::setw(6) << st << std::setw(11)
+                            << r.intervals << std::setw(12) << std::fixed
+                            << std::setprecision(3) << r.throughput * 1e-9
+                            << std::setw(10) << std::setprecision(2)
+                            << r.stall_fraction * 100 << std::setw(10)
+                            << wall.count()
+                            << (r.deadlock ? "  deadlock" : "") << std::endl;
+                  std::cout.unsetf(std::ios::fixed);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
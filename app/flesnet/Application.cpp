@@ -1,32 +1,154 @@
 // Copyright 2012-2016 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Application.hpp"
+#include "BufferSizing.hpp"
 #include "ChildProcessManager.hpp"
 #include "FlesnetPatternGenerator.hpp"
+#include "InputFanIn.hpp"
 #include "ItemDistributor.hpp"
+#include "MemoryAccounting.hpp"
+#include "MemoryPlacement.hpp"
+#include "ProcessorScaler.hpp"
+#include "RailSelection.hpp"
+#include "SizeRecord.hpp"
+#include "System.hpp"
+#include "TimesliceBufferPool.hpp"
+#include "TimesliceBufferStatus.hpp"
+#include "TimesliceShmWorkItem.hpp"
 #include "Utility.hpp"
+#include "WorkerGroup.hpp"
 #include "log.hpp"
 #include "shm_channel_client.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/future.hpp>
 #include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
 #include <random>
+#include <sstream>
 #include <string>
 
+namespace {
+
+// Parse the memory placement parameters of an input or output buffer
+void parse_placement(const std::map<std::string, std::string>& param,
+                     const std::string& host,
+                     const std::string& name,
+                     MemoryPlacement& placement) {
+  if (param.count("hugepages") != 0u) {
+    placement.hugepages = stou(param.at("hugepages")) != 0;
+  }
+  if (param.count("hugetlb") != 0u) {
+    placement.reserved_page_size = UINT64_C(1) << stou(param.at("hugetlb"));
+  }
+  if (param.count("prefault") != 0u) {
+    placement.prefault = stou(param.at("prefault")) != 0;
+  }
+  if (param.count("lock") != 0u) {
+    placement.lock = stou(param.at("lock")) != 0;
+  }
+  if (param.count("numa") != 0u) {
+    if (param.at("numa") == "auto") {
+      // use the NUMA node of the network device of the given host
+      placement.numa_node = fles::system::numa_node_of_host(host);
+      if (placement.numa_node < 0) {
+        L_(warning) << name << ": NUMA node of host " << host << " unknown";
+      }
+    } else {
+      placement.numa_node = std::stoi(param.at("numa"));
+    }
+  }
+}
+
+// Whether a buffer is sized from the available memory ("datasize=auto")
+bool auto_size(const std::map<std::string, std::string>& param) {
+  return param.count("datasize") != 0u && param.at("datasize") == "auto";
+}
+
+// Number of local buffers of automatic size, which share the available memory
+unsigned count_auto_buffers(const Parameters& par) {
+  unsigned count = 0;
+  for (unsigned i : par.input_indexes()) {
+    count += auto_size(par.inputs().at(i).param) ? 1 : 0;
+  }
+  for (unsigned i : par.output_indexes()) {
+    count += auto_size(par.outputs().at(i).param) ? 1 : 0;
+  }
+  return count;
+}
+
+// Size and memory parameters of a timeslice buffer
+struct TimesliceBufferConfig {
+  uint32_t datasize = 27; // 128 MiB
+  uint32_t descsize = 19; // 16 MiB
+  bool auto_size = false;
+  TimesliceBufferMemory memory;
+};
+
+// Parse the size and memory parameters of an output's timeslice buffer
+TimesliceBufferConfig parse_buffer_config(const InterfaceSpecification& output,
+                                          unsigned index) {
+  TimesliceBufferConfig config;
+  const auto& param = output.param;
+  config.auto_size = auto_size(param);
+  if (param.count("datasize") != 0u && !config.auto_size) {
+    config.datasize = stou(param.at("datasize"));
+  }
+  if (param.count("descsize") != 0u) {
+    config.descsize = stou(param.at("descsize"));
+  }
+  // "auto" uses the NUMA node of the network device the builder listens on
+  parse_placement(param, output.host,
+                  "timeslice buffer " + std::to_string(index), config.memory);
+  if (param.count("gpu") != 0u) {
+    config.memory.device = std::stoi(param.at("gpu"));
+  }
+  if (param.count("overflowsize") != 0u) {
+    config.memory.overflow_size = UINT64_C(1)
+                                  << stou(param.at("overflowsize"));
+  }
+  return config;
+}
+
+} // namespace
+
 Application::Application(Parameters const& par,
                          volatile sig_atomic_t* signal_status)
     : par_(par), signal_status_(signal_status) {
+#ifdef HAVE_LIBFABRIC
+  tl_libfabric::Provider::set_requested_name(par_.libfabric_provider());
+#endif
+
   // start up monitoring
   if (!par.monitor_uri().empty()) {
     monitor_ = std::make_unique<cbm::Monitor>(par_.monitor_uri());
+    if (par_.buffer_sample_rate() > 0) {
+      buffer_status_sampler_ = std::make_unique<BufferStatusSampler>(
+          *monitor_, std::chrono::microseconds(std::chrono::seconds(1)) /
+                         par_.buffer_sample_rate());
+    }
+    MemoryAccounting::attach(*monitor_,
+                             {{"host", fles::system::current_hostname()}});
+  }
+
+  // the transport objects publish their status to it when created
+  if (!par_.status_endpoint().empty()) {
+    status_server_ = std::make_unique<StatusServer>(par_.status_endpoint(),
+                                                    par_.status_interval());
+    L_(info) << "serving status at port " << status_server_->port();
   }
 
   create_input_channel_senders();
   create_timeslice_buffers();
-  set_node();
+  MemoryAccounting::log_report();
+  if (par_.thread_placement() == ThreadPlacement::None) {
+    set_node();
+  }
 }
 
 Application::~Application() {
+  MemoryAccounting::detach();
   // delay to allow monitor to process pending messages
   constexpr auto destruct_delay = std::chrono::milliseconds(200);
   std::this_thread::sleep_for(destruct_delay);
@@ -37,6 +159,7 @@ void Application::create_timeslice_buffers() {
   unsigned output_size = static_cast<unsigned>(par_.outputs().size());
 
   std::vector<std::string> input_server_addresses;
+  std::vector<std::string> data_server_addresses;
   for (unsigned i = 0; i < input_size; ++i) {
     if (par_.local_only()) {
       input_server_addresses.push_back("inproc://input" + std::to_string(i));
@@ -44,45 +167,241 @@ void Application::create_timeslice_buffers() {
       input_server_addresses.push_back("tcp://" + par_.inputs().at(i).host +
                                        ":" +
                                        std::to_string(par_.base_port() + i));
+      if (par_.zeromq_raw_data()) {
+        data_server_addresses.push_back(
+            par_.inputs().at(i).host + ":" +
+            std::to_string(par_.base_port() + input_size + i));
+      }
     }
   }
 
-  for (unsigned i : par_.output_indexes()) {
-    auto shm_identifier = par_.outputs().at(i).path.at(0);
-    auto param = par_.outputs().at(i).param;
+  TimesliceStatistics::Schedule schedule;
+  if (!par_.benchmark_report().empty()) {
+    schedule = input_schedule();
+    if (!schedule) {
+      L_(info) << "benchmark: latency not measured, as not all inputs are "
+                  "rate-limited pattern generators in this process";
+    }
+  }
 
-    uint32_t datasize = 27; // 128 MiB
-    if (param.count("datasize") != 0u) {
-      datasize = stou(param.at("datasize"));
+  std::map<unsigned, TimesliceBufferConfig> configs;
+  unsigned auto_buffers = count_auto_buffers(par_);
+  std::map<std::string, double> record;
+  if (!par_.buffer_sizing_file().empty()) {
+    record = BufferSizing::read_record(par_.buffer_sizing_file());
+  }
+  for (unsigned i : par_.output_indexes()) {
+    TimesliceBufferConfig config = parse_buffer_config(par_.outputs().at(i), i);
+    if (config.auto_size) {
+      // the component size observed in a previous run, if recorded
+      std::string name = "output" + std::to_string(i);
+      double mean_size = record.count(name) != 0u ? record.at(name) : 0;
+      BufferSize size = BufferSizing::fit(
+          BufferSizing::budget(config.memory.numa_node,
+                               par_.buffer_auto_memory(), auto_buffers) /
+              input_size,
+          mean_size, sizeof(fles::TimesliceComponentDescriptor));
+      config.datasize = size.datasize;
+      if (par_.outputs().at(i).param.count("descsize") == 0u) {
+        config.descsize = size.descsize;
+      }
+      L_(info) << "timeslice buffer " << i << ": automatic size, "
+               << (mean_size > 0 ? "recorded mean component size " +
+                                       human_readable_count(
+                                           static_cast<uint64_t>(mean_size))
+                                 : std::string("no recorded component size"));
     }
-    uint32_t descsize = 19; // 16 MiB
-    if (param.count("descsize") != 0u) {
-      descsize = stou(param.at("descsize"));
+    configs[i] = config;
+  }
+
+  // optionally, the local timeslice buffers share a single segment
+  std::shared_ptr<TimesliceBufferPool> pool;
+  if (!par_.timeslice_buffer_pool().empty()) {
+    constexpr std::size_t overhead_size = 65536;
+    std::size_t pool_size = overhead_size;
+    for (const auto& [i, config] : configs) {
+      pool_size += TimesliceBuffer::region_size(
+          config.datasize, config.descsize, input_size, config.memory);
     }
+    pool = std::make_shared<TimesliceBufferPool>(par_.timeslice_buffer_pool(),
+                                                 pool_size);
+    L_(info) << "timeslice buffer pool: " << pool->description();
+  }
+
+  for (unsigned i : par_.output_indexes()) {
+    auto shm_identifier = par_.outputs().at(i).path.at(0);
+    auto param = par_.outputs().at(i).param;
+    const TimesliceBufferConfig& config = configs.at(i);
+    const TimesliceBufferMemory& memory = config.memory;
 
     const std::string producer_address = "inproc://" + shm_identifier;
     const std::string worker_address = "ipc://@" + shm_identifier;
 
     auto item_distributor = std::make_unique<ItemDistributor>(
         zmq_context_, producer_address, worker_address);
+    // optional limit of held timeslices for the lower priority consumers
+    if (param.count("priolimit") != 0u) {
+      item_distributor->set_priority_limit(stou(param.at("priolimit")));
+    }
+    // optional latency from the arrival of a timeslice item to its dispatch
+    if (monitor_ && par_.timeslice_lifecycle()) {
+      cbm::MetricHistogram dispatch_latency = monitor_->RegisterHistogram(
+          "timeslice_lifecycle",
+          {{"host", fles::system::current_hostname()},
+           {"output_index", std::to_string(i)}},
+          "dispatch_us");
+      item_distributor->set_dispatch_observer(
+          [dispatch_latency](std::chrono::steady_clock::duration d) mutable {
+            dispatch_latency.Record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(d)
+                    .count()));
+          });
+    }
+    // time usage reported by the consumers (see WorkerParameters::usage)
+    if (monitor_) {
+      item_distributor->set_usage_observer(
+          [monitor = monitor_.get(), i](const std::string& client,
+                                        const WorkerUsage& usage) {
+            monitor->QueueMetric(
+                "consumer_usage",
+                {{"host", fles::system::current_hostname()},
+                 {"output_index", std::to_string(i)},
+                 {"client", client}},
+                {{"utilization", usage.utilization()},
+                 {"items", static_cast<uint64_t>(usage.items)},
+                 {"wait_us", static_cast<int64_t>(usage.wait.count())},
+                 {"hold_us", static_cast<int64_t>(usage.hold.count())},
+                 {"idle_us", static_cast<int64_t>(usage.idle.count())}});
+          });
+    }
+    ItemDistributor* distributor = item_distributor.get();
     item_distributors_.push_back(std::move(item_distributor));
 
     std::unique_ptr<TimesliceBuffer> tsb(
         new TimesliceBuffer(zmq_context_, producer_address, shm_identifier,
-                            datasize, descsize, input_size));
+                            config.datasize, config.descsize, input_size,
+                            memory, pool));
 
     L_(info) << "timeslice buffer " << i << ": " << tsb->description();
 
-    start_processes(shm_identifier);
-    ChildProcessManager::get().allow_stop_processes(this);
+    // worker status for inspection (see tsbinspect)
+    distributor->set_status(&tsb->status().distributor(),
+                            std::chrono::milliseconds(100));
+    if (status_server_) {
+      status_server_->add_section(
+          "distributor_" + std::to_string(i), [distributor](DumpBuffer& out) {
+            ItemDistributor::Load load = distributor->load();
+            out.append("{\"held\":")
+                .dec(load.held_items)
+                .append(",\"waiting\":")
+                .dec(load.waiting_items)
+                .append(",\"outstanding\":")
+                .dec(load.outstanding_items)
+                .append(",\"utilization\":")
+                .real(load.utilization)
+                .append('}');
+          });
+    }
+
+    // optional work items of the individual components
+    const bool component_items =
+        param.count("components") != 0u && param.at("components") == "1";
+    if (component_items) {
+      const std::string component_producer_address =
+          producer_address + fles::component_items_suffix;
+      item_distributors_.push_back(std::make_unique<ItemDistributor>(
+          zmq_context_, component_producer_address,
+          worker_address + fles::component_items_suffix));
+      tsb->enable_component_items(zmq_context_, component_producer_address);
+    }
+
+    // optional validation of the microslice CRCs on helper threads
+    if (param.count("crccheck") != 0u) {
+      tsb->enable_crc_validation(stou(param.at("crccheck")));
+    }
+
+    // optional eviction of long-held timeslices to the overflow region
+    if (param.count("evict") != 0u) {
+      tsb->enable_eviction(std::chrono::milliseconds(stou(param.at("evict"))));
+    }
+
+    // optional service for consumers on other hosts
+    if (param.count("remote") != 0u) {
+#ifdef HAVE_RDMA
+      const unsigned int max_consumers =
+          param.count("remoteconsumers") != 0u
+              ? stou(param.at("remoteconsumers"))
+              : 8;
+      remote_consumer_servers_.push_back(
+          std::make_unique<RemoteConsumerServer>(
+              i, *tsb, worker_address,
+              static_cast<unsigned short>(stou(param.at("remote"))),
+              max_consumers));
+#else
+      L_(fatal) << "flesnet built without RDMA support";
+#endif
+    }
+
+    int node = -1;
+    if (par_.thread_placement() == ThreadPlacement::NUMA) {
+      // the buffer memory or the network device the builder listens on
+      node = memory.numa_node >= 0
+                 ? memory.numa_node
+                 : fles::system::numa_node_of_host(par_.outputs().at(i).host);
+      L_(info) << "timeslice buffer " << i << ": threads on NUMA node "
+               << node;
+    }
+    output_nodes_.push_back(node);
+    distributor_nodes_.push_back(node);
+    if (component_items) {
+      distributor_nodes_.push_back(node);
+    }
+
+    if (!par_.benchmark_report().empty()) {
+      auto statistics = std::make_unique<TimesliceStatistics>();
+      statistics->set_schedule(schedule);
+      tsb->set_statistics(statistics.get());
+      timeslice_statistics_.push_back(std::move(statistics));
+    }
+
+    if (par_.processor_instances_max() != 0) {
+      ProcessorScaler::Config scaler_config;
+      scaler_config.min_instances = par_.processor_instances();
+      scaler_config.max_instances = par_.processor_instances_max();
+      auto pool = std::make_unique<ProcessorPool>(
+          ProcessorPool{shm_identifier, distributor,
+                        std::size_t{1} << config.descsize,
+                        ProcessorScaler(scaler_config), 0});
+      ChildProcessManager::get().reserve(par_.processor_instances_max());
+      for (; pool->next_index < pool->scaler.instances(); ++pool->next_index) {
+        start_process(shm_identifier, pool->next_index, pool.get());
+      }
+      ChildProcessManager::get().allow_stop_processes(pool.get());
+      processor_pools_.push_back(std::move(pool));
+    } else {
+      start_processes(shm_identifier);
+      ChildProcessManager::get().allow_stop_processes(this);
+    }
 
     if (par_.transport() == Transport::ZeroMQ) {
       std::unique_ptr<TimesliceBuilderZeromq> builder(
           new TimesliceBuilderZeromq(
               i, *tsb, input_server_addresses, output_size,
               par_.timeslice_size(), par_.max_timeslice_number(),
-              signal_status_, static_cast<void*>(zmq_context_)));
+              signal_status_, static_cast<void*>(zmq_context_),
+              data_server_addresses, par_.zeromq_request_window()));
       timeslice_builders_zeromq_.push_back(std::move(builder));
+    } else if (par_.transport() == Transport::Local) {
+      // all inputs are in this process (see Parameters)
+      std::vector<ComponentSenderLocal*> senders;
+      for (auto& sender : component_senders_local_) {
+        senders.push_back(sender.get());
+      }
+      timeslice_builders_local_.push_back(
+          std::make_unique<TimesliceBuilderLocal>(
+              i, *tsb, std::move(senders), output_size,
+              par_.timeslice_size(), par_.max_timeslice_number(),
+              signal_status_));
     } else if (par_.transport() == Transport::LibFabric) {
 #ifdef HAVE_LIBFABRIC
       std::unique_ptr<tl_libfabric::TimesliceBuilder> builder(
@@ -93,7 +412,12 @@ void Application::create_timeslice_buffers() {
               par_.scheduler_speedup_difference_percentage(),
               par_.scheduler_speedup_percentage(),
               par_.scheduler_speedup_interval_count(),
-              par_.scheduler_log_directory(), par_.scheduler_enable_logging()));
+              par_.scheduler_ewma_weight(),
+              par_.scheduler_log_directory(), par_.scheduler_enable_logging(),
+              par_.libfabric_remote_cq_data()));
+      builder->set_completion_wait(par_.completion_wait());
+      builder->set_hot_standby(par_.scheduler_replication_modulo() != 0 &&
+                               par_.outputs().size() > 1);
       timeslice_builders_.push_back(std::move(builder));
 #else
       L_(fatal) << "flesnet built without LIBFABRIC support";
@@ -101,8 +425,36 @@ void Application::create_timeslice_buffers() {
     } else {
 #ifdef HAVE_RDMA
       std::unique_ptr<TimesliceBuilder> builder(new TimesliceBuilder(
-          i, *tsb, par_.base_port() + i, input_size, par_.timeslice_size(),
-          signal_status_, false, monitor_.get()));
+          i, *tsb, par_.base_port() + i, input_size, par_.timeslice_schedule(),
+          signal_status_, false, par_.placement_policy(),
+          par_.placement_epoch(), monitor_.get(), par_.rdma_stripes(),
+          par_.rdma_srq(),
+          MemoryRegistration{par_.rdma_odp(), par_.rdma_register_threads()},
+          par_.timeslice_deadline(), par_.timeslice_bytes(),
+          par_.max_timeslice_size(), par_.rdma_pull_reads(),
+          par_.timeslice_lifecycle()));
+      builder->set_completion_wait(par_.completion_wait());
+      // resize of the timeslice buffer by the operator, e.g.,
+      // POST /resize_buffer_0?data_exp=30&desc_exp=18
+      if (status_server_ && tsb->resizable() && param.count("remote") == 0u) {
+        status_server_->add_command(
+            "resize_buffer_" + std::to_string(i),
+            [builder = builder.get(), i](const StatusServer::CommandArguments&
+                                             args) {
+              uint32_t data_exp = 0;
+              uint32_t desc_exp = 0;
+              try {
+                data_exp = stou(args.at("data_exp"));
+                desc_exp = stou(args.at("desc_exp"));
+              } catch (std::logic_error const&) {
+                throw std::invalid_argument(
+                    "arguments data_exp and desc_exp required");
+              }
+              builder->request_resize(data_exp, desc_exp);
+              return "resize of timeslice buffer " + std::to_string(i) +
+                     " requested";
+            });
+      }
       timeslice_builders_.push_back(std::move(builder));
 #else
       L_(fatal) << "flesnet built without RDMA support";
@@ -124,12 +476,24 @@ void Application::create_input_channel_senders() {
     output_services.push_back(std::to_string(par_.base_port() + i));
   }
 
+  // the network interfaces to distribute the input channels on
+  std::vector<int> rail_numa_nodes;
+  for (const auto& rail : par_.libfabric_rails()) {
+    rail_numa_nodes.push_back(fles::system::numa_node_of_host(rail));
+  }
+  RailSelection rails(par_.libfabric_rails(), rail_numa_nodes);
+
+  unsigned auto_buffers = count_auto_buffers(par_);
+
   for (size_t c = 0; c < par_.input_indexes().size(); ++c) {
     unsigned index = par_.input_indexes().at(c);
 
     auto scheme = par_.inputs().at(index).scheme;
     auto param = par_.inputs().at(index).param;
 
+    // number of merged channels per microslice index of this input
+    uint32_t fan_in = 1;
+
     if (scheme == "shm") {
       auto shm_identifier = par_.inputs().at(index).path.at(0);
       auto channel = std::stoul(par_.inputs().at(index).path.at(1));
@@ -146,22 +510,83 @@ void Application::create_input_channel_senders() {
         }
       }
 
-      data_sources_.push_back(
-          std::unique_ptr<InputBufferReadInterface>(new flib_shm_channel_client(
-              shm_devices_.at(shm_identifier), channel)));
+      std::unique_ptr<InputBufferReadInterface> source(
+          new flib_shm_channel_client(shm_devices_.at(shm_identifier),
+                                      channel));
+
+      // further channels of the same shm merged into this input
+      if (param.count("fanin") != 0u) {
+        if (par_.timeslice_bytes() != 0) {
+          throw std::runtime_error(
+              "input fan-in requires a fixed timeslice size");
+        }
+        std::vector<std::unique_ptr<InputBufferReadInterface>> sources;
+        std::size_t datasize = source->data_buffer().size_exponent();
+        std::size_t descsize = source->desc_buffer().size_exponent();
+        sources.push_back(std::move(source));
+        for (const auto& ch : split(param.at("fanin"), ",")) {
+          auto merged = std::make_unique<flib_shm_channel_client>(
+              shm_devices_.at(shm_identifier), std::stoul(ch));
+          datasize = std::max(datasize, merged->data_buffer().size_exponent());
+          descsize = std::max(descsize, merged->desc_buffer().size_exponent());
+          sources.push_back(std::move(merged));
+        }
+        fan_in = static_cast<uint32_t>(sources.size());
+        // room for the largest source buffer times the number of sources
+        std::size_t extra = 0;
+        while ((UINT64_C(1) << extra) < sources.size()) {
+          ++extra;
+        }
+        datasize += extra;
+        descsize += extra;
+        if (param.count("datasize") != 0u) {
+          datasize = stou(param.at("datasize"));
+        }
+        if (param.count("descsize") != 0u) {
+          descsize = stou(param.at("descsize"));
+        }
+        MemoryPlacement placement;
+        parse_placement(param, par_.inputs().at(index).host,
+                        "input buffer " + std::to_string(index), placement);
+
+        L_(info) << "input channel " << index << ": fan-in of " << fan_in
+                 << " channels, buffer size: "
+                 << human_readable_count(UINT64_C(1) << datasize) << " + "
+                 << human_readable_count((UINT64_C(1) << descsize) *
+                                         sizeof(fles::MicrosliceDescriptor));
+        source = std::make_unique<InputFanIn>(std::move(sources), datasize,
+                                              descsize, placement);
+      }
+      data_sources_.push_back(std::move(source));
     } else if (scheme == "pgen") {
+      uint32_t size_mean = 1024; // 1 kiB
+      if (param.count("mean") != 0u) {
+        size_mean = stou(param.at("mean"));
+      }
+      std::shared_ptr<const SizeRecord> size_record;
+      if (param.count("sizes") != 0u) {
+        size_record = std::make_shared<const SizeRecord>(
+            SizeRecord::read(param.at("sizes")));
+        size_mean = static_cast<uint32_t>(size_record->mean_size());
+      }
+      MemoryPlacement placement;
+      parse_placement(param, par_.inputs().at(index).host,
+                      "input buffer " + std::to_string(index), placement);
       uint32_t datasize = 27; // 128 MiB
-      if (param.count("datasize") != 0u) {
+      uint32_t descsize = 19; // 16 MiB
+      if (auto_size(param)) {
+        BufferSize size = BufferSizing::fit(
+            BufferSizing::budget(placement.numa_node,
+                                 par_.buffer_auto_memory(), auto_buffers),
+            size_mean, sizeof(fles::MicrosliceDescriptor));
+        datasize = size.datasize;
+        descsize = size.descsize;
+      } else if (param.count("datasize") != 0u) {
         datasize = stou(param.at("datasize"));
       }
-      uint32_t descsize = 19; // 16 MiB
       if (param.count("descsize") != 0u) {
         descsize = stou(param.at("descsize"));
       }
-      uint32_t size_mean = 1024; // 1 kiB
-      if (param.count("mean") != 0u) {
-        size_mean = stou(param.at("mean"));
-      }
       uint32_t size_var = 0;
       if (param.count("var") != 0u) {
         size_var = stou(param.at("var"));
@@ -178,6 +603,9 @@ void Application::create_input_channel_senders() {
       if (param.count("initial") != 0u) {
         initial_ns = stoul(param.at("initial"));
       }
+      if (param.count("mirror") != 0u) {
+        placement.mirrored = stou(param.at("mirror")) != 0;
+      }
 
       L_(info) << "input buffer " << index
                << " size: " << human_readable_count(UINT64_C(1) << datasize)
@@ -187,10 +615,25 @@ void Application::create_input_channel_senders() {
       L_(info) << "microslice size: " << human_readable_count(size_mean)
                << " +/- " << human_readable_count(size_var);
 
-      data_sources_.push_back(std::unique_ptr<InputBufferReadInterface>(
-          new FlesnetPatternGenerator(datasize, descsize, index, size_mean,
-                                      (pattern != 0), (size_var != 0), delay_ns,
-                                      initial_ns)));
+      auto generator = std::make_unique<FlesnetPatternGenerator>(
+          datasize, descsize, index, size_mean, (pattern != 0),
+          (size_var != 0), delay_ns, initial_ns, placement);
+      if (size_record) {
+        double speed = 0;
+        if (param.count("speed") != 0u) {
+          speed = std::stod(param.at("speed"));
+        }
+        double correlation = 0;
+        if (param.count("correlation") != 0u) {
+          correlation = std::stod(param.at("correlation"));
+        }
+        L_(info) << "microslice sizes replayed from "
+                 << (size_record->series() ? "time series " : "histogram ")
+                 << param.at("sizes") << " (" << size_record->entries()
+                 << " entries)";
+        generator->set_size_record(size_record, speed, correlation);
+      }
+      data_sources_.push_back(std::move(generator));
     } else {
       L_(fatal) << "unknown input scheme: " << scheme;
     }
@@ -199,27 +642,65 @@ void Application::create_input_channel_senders() {
     if (param.count("overlap") != 0u) {
       overlap_size = stou(param.at("overlap"));
     }
+    // a fan-in input carries fan_in microslices per microslice index
+    overlap_size *= fan_in;
+    uint32_t timeslice_size = par_.timeslice_size() * fan_in;
+
+    int node = -1;
+    if (par_.thread_placement() == ThreadPlacement::NUMA) {
+      // the buffer memory (e.g., of a CRI board) or the network device
+      node = numa_node_of_memory(data_sources_.at(c)->data_buffer().ptr());
+      if (node < 0) {
+        node = fles::system::numa_node_of_host(par_.inputs().at(index).host);
+      }
+      L_(info) << "input channel " << index << ": thread on NUMA node "
+               << node;
+    }
+    input_nodes_.push_back(node);
 
     if (par_.transport() == Transport::ZeroMQ) {
       std::string listen_address =
           "tcp://*:" + std::to_string(par_.base_port() + index);
+      uint16_t data_port = 0;
       if (par_.local_only()) {
         listen_address = "inproc://input" + std::to_string(index);
+      } else if (par_.zeromq_raw_data()) {
+        data_port = static_cast<uint16_t>(par_.base_port() +
+                                          par_.inputs().size() + index);
       }
       std::unique_ptr<ComponentSenderZeromq> sender(new ComponentSenderZeromq(
           index, *(data_sources_.at(c).get()), listen_address,
-          par_.timeslice_size(), overlap_size, par_.max_timeslice_number(),
-          signal_status_, static_cast<void*>(zmq_context_)));
+          timeslice_size, overlap_size, par_.max_timeslice_number(),
+          signal_status_, static_cast<void*>(zmq_context_), data_port,
+          par_.zeromq_request_window() > 1, par_.zeromq_compression(),
+          par_.zeromq_zerocopy()));
       component_senders_zeromq_.push_back(std::move(sender));
+    } else if (par_.transport() == Transport::Local) {
+      component_senders_local_.push_back(
+          std::make_unique<ComponentSenderLocal>(
+              index, *(data_sources_.at(c).get()), timeslice_size,
+              overlap_size, par_.max_timeslice_number(), signal_status_));
     } else if (par_.transport() == Transport::LibFabric) {
 #ifdef HAVE_LIBFABRIC
+      std::string local_host = par_.inputs().at(index).host;
+      if (!rails.empty()) {
+        int numa_node = numa_node_of_memory(
+            data_sources_.at(c)->data_buffer().ptr());
+        local_host = rails.select(numa_node);
+        L_(info) << "input channel " << index << ": rail " << local_host
+                 << " (buffer on NUMA node " << numa_node << ")";
+      }
       std::unique_ptr<tl_libfabric::InputChannelSender> sender(
           new tl_libfabric::InputChannelSender(
               index, *(data_sources_.at(c).get()), output_hosts,
-              output_services, par_.timeslice_size(), overlap_size,
-              par_.max_timeslice_number(), par_.inputs().at(index).host,
+              output_services, timeslice_size, overlap_size,
+              par_.max_timeslice_number(), local_host,
               par_.scheduler_interval_length(), par_.scheduler_log_directory(),
-              par_.scheduler_enable_logging()));
+              par_.scheduler_enable_logging(),
+              par_.libfabric_remote_cq_data(),
+              par_.scheduler_staggered_rounds()));
+      sender->set_completion_wait(par_.completion_wait());
+      sender->set_replication_modulo(par_.scheduler_replication_modulo());
       input_channel_senders_.push_back(std::move(sender));
 #else
       L_(fatal) << "flesnet built without LIBFABRIC support";
@@ -228,8 +709,18 @@ void Application::create_input_channel_senders() {
 #ifdef HAVE_RDMA
       std::unique_ptr<InputChannelSender> sender(new InputChannelSender(
           index, *(data_sources_.at(c).get()), output_hosts, output_services,
-          par_.timeslice_size(), overlap_size, par_.max_timeslice_number(),
-          monitor_.get()));
+          par_.timeslice_schedule().scaled(fan_in), overlap_size,
+          par_.max_timeslice_number(), par_.placement_policy(),
+          par_.placement_epoch(), monitor_.get(), par_.rdma_signal_interval(),
+          par_.rdma_post_batch(), par_.rdma_stripes(),
+          par_.rdma_status_interval(), par_.connect_quorum(),
+          MemoryRegistration{par_.rdma_odp(), par_.rdma_register_threads()},
+          par_.timeslice_bytes() != 0, par_.rdma_pull_reads(),
+          par_.rdma_control_tos(), par_.rdma_adaptive_window(),
+          par_.rdma_lookahead(), par_.rdma_pacing_rate(),
+          static_cast<double>(par_.rdma_pacing_burst()),
+          par_.timeslice_lifecycle()));
+      sender->set_completion_wait(par_.completion_wait());
       input_channel_senders_.push_back(std::move(sender));
 #else
       L_(fatal) << "flesnet built without RDMA support";
@@ -241,11 +732,39 @@ void Application::create_input_channel_senders() {
 void Application::run() {
   std::vector<std::thread> distributor_threads;
 
-  for (auto& distributor : item_distributors_) {
-    distributor_threads.emplace_back(std::ref(*distributor));
+  std::atomic<bool> scaling_stopped{false};
+  std::thread scaler_thread;
+  if (!processor_pools_.empty()) {
+    scaler_thread = std::thread(
+        [this, &scaling_stopped] { scale_processors(scaling_stopped); });
   }
 
+  for (size_t i = 0; i < item_distributors_.size(); ++i) {
+    distributor_threads.emplace_back(
+        [&distributor = *item_distributors_[i],
+         node = distributor_nodes_.at(i)] {
+          set_node(node);
+          distributor();
+        });
+  }
+
+#ifdef HAVE_RDMA
+  // the remote consumers register with the distributors started above
+  for (auto& server : remote_consumer_servers_) {
+    distributor_threads.emplace_back([&server = *server] { server(); });
+  }
+#endif
+
   auto cleanup_distributor_threads = [&]() {
+    scaling_stopped = true;
+    if (scaler_thread.joinable()) {
+      scaler_thread.join();
+    }
+#ifdef HAVE_RDMA
+    for (auto& server : remote_consumer_servers_) {
+      server->stop();
+    }
+#endif
     for (auto& distributor : item_distributors_) {
       distributor->stop();
     }
@@ -259,11 +778,13 @@ void Application::run() {
 #if defined(HAVE_RDMA) || defined(HAVE_LIBFABRIC)
   if (timeslice_builders_.size() == 1 && input_channel_senders_.empty()) {
     L_(debug) << "using existing thread for single timeslice builder";
+    set_node(output_nodes_.at(0));
     (*timeslice_builders_[0])();
     cleanup_distributor_threads();
   }
   if (input_channel_senders_.size() == 1 && timeslice_builders_.empty()) {
     L_(debug) << "using existing thread for single input channel sender";
+    set_node(input_nodes_.at(0));
     (*input_channel_senders_[0])();
     return;
   }
@@ -274,46 +795,82 @@ void Application::run() {
   std::vector<boost::unique_future<void>> futures;
   bool stop = false;
 
-#if defined(HAVE_RDMA) || defined(HAVE_LIBFABRIC)
-  for (auto& buffer : timeslice_builders_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
+  // start a worker thread on a given NUMA node
+  auto start = [&](auto& worker, int node) {
+    boost::packaged_task<void> task([&worker, node] {
+      set_node(node);
+      worker();
+    });
     futures.push_back(task.get_future());
     auto* thread = new boost::thread(std::move(task)); // NOLINT
 #if defined(HAVE_PTHREAD_SETNAME_NP)
-    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
+    pthread_setname_np(thread->native_handle(), worker.thread_name().c_str());
 #endif
     threads.add_thread(thread);
+  };
+
+#if defined(HAVE_RDMA) || defined(HAVE_LIBFABRIC)
+  // the workers with their NUMA nodes
+  std::vector<std::pair<ConnectionGroupWorker*, int>> workers;
+  for (size_t i = 0; i < timeslice_builders_.size(); ++i) {
+    workers.emplace_back(timeslice_builders_[i].get(), output_nodes_.at(i));
+  }
+  for (size_t i = 0; i < input_channel_senders_.size(); ++i) {
+    workers.emplace_back(input_channel_senders_[i].get(), input_nodes_.at(i));
   }
 
-  for (auto& buffer : input_channel_senders_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
-    futures.push_back(task.get_future());
-    auto* thread = new boost::thread(std::move(task)); // NOLINT
-#if defined(HAVE_PTHREAD_SETNAME_NP)
-    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
-#endif
-    threads.add_thread(thread);
+  std::vector<std::unique_ptr<WorkerGroup>> worker_groups;
+  if (par_.transport_threads() > 0) {
+    // share threads among the cooperative workers, keeping NUMA nodes apart
+    auto split = std::stable_partition(
+        workers.begin(), workers.end(),
+        [](const auto& worker) { return !worker.first->cooperative(); });
+    std::stable_sort(split, workers.end(), [](const auto& a, const auto& b) {
+      return a.second < b.second;
+    });
+    std::vector<std::pair<ConnectionGroupWorker*, int>> cooperative(
+        split, workers.end());
+    workers.erase(split, workers.end());
+
+    const size_t group_count =
+        std::min<size_t>(par_.transport_threads(), cooperative.size());
+    for (size_t g = 0; g < group_count; ++g) {
+      auto begin = cooperative.begin() + g * cooperative.size() / group_count;
+      auto end =
+          cooperative.begin() + (g + 1) * cooperative.size() / group_count;
+      std::vector<ConnectionGroupWorker*> members;
+      int node = begin->second;
+      for (auto it = begin; it != end; ++it) {
+        members.push_back(it->first);
+        if (it->second != node) {
+          node = -1;
+        }
+      }
+      worker_groups.push_back(std::make_unique<WorkerGroup>(
+          std::move(members), "CGGroup/" + std::to_string(g)));
+      workers.emplace_back(worker_groups.back().get(), node);
+    }
   }
-#endif
 
-  for (auto& buffer : timeslice_builders_zeromq_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
-    futures.push_back(task.get_future());
-    auto* thread = new boost::thread(std::move(task)); // NOLINT
-#if defined(HAVE_PTHREAD_SETNAME_NP)
-    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
+  for (auto& [worker, node] : workers) {
+    start(*worker, node);
+  }
 #endif
-    threads.add_thread(thread);
+
+  for (size_t i = 0; i < timeslice_builders_zeromq_.size(); ++i) {
+    start(*timeslice_builders_zeromq_[i], output_nodes_.at(i));
   }
 
-  for (auto& buffer : component_senders_zeromq_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
-    futures.push_back(task.get_future());
-    auto* thread = new boost::thread(std::move(task)); // NOLINT
-#if defined(HAVE_PTHREAD_SETNAME_NP)
-    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
-#endif
-    threads.add_thread(thread);
+  for (size_t i = 0; i < component_senders_zeromq_.size(); ++i) {
+    start(*component_senders_zeromq_[i], input_nodes_.at(i));
+  }
+
+  for (size_t i = 0; i < timeslice_builders_local_.size(); ++i) {
+    start(*timeslice_builders_local_[i], output_nodes_.at(i));
+  }
+
+  for (size_t i = 0; i < component_senders_local_.size(); ++i) {
+    start(*component_senders_local_[i], input_nodes_.at(i));
   }
 
   L_(debug) << "threads started: " << threads.size();
@@ -335,23 +892,153 @@ void Application::run() {
   threads.join_all();
 
   cleanup_distributor_threads();
+
+  if (!timeslice_statistics_.empty()) {
+    write_benchmark_report();
+  }
+
+  if (!par_.buffer_sizing_file().empty()) {
+    write_buffer_sizing_record();
+  }
+}
+
+/// Return the times the timeslice contents are complete at the inputs.
+/** This is only known if all inputs are rate-limited pattern generators in
+    the same process. Otherwise, an empty schedule is returned. */
+TimesliceStatistics::Schedule Application::input_schedule() const {
+  if (!par_.local_only() || data_sources_.empty()) {
+    return {};
+  }
+  // the generators and the overlap of their timeslice components
+  std::vector<std::pair<const FlesnetPatternGenerator*, uint64_t>> generators;
+  for (size_t c = 0; c < data_sources_.size(); ++c) {
+    const auto* generator =
+        dynamic_cast<const FlesnetPatternGenerator*>(data_sources_[c].get());
+    if (generator == nullptr || !generator->rate_limited()) {
+      return {};
+    }
+    auto param = par_.inputs().at(par_.input_indexes().at(c)).param;
+    uint64_t overlap_size = 1;
+    if (param.count("overlap") != 0u) {
+      overlap_size = stou(param.at("overlap"));
+    }
+    generators.emplace_back(generator, overlap_size);
+  }
+
+  TimesliceSchedule timeslice_schedule = par_.timeslice_schedule();
+  return [generators, timeslice_schedule](uint64_t index) {
+    auto due = TimesliceStatistics::clock::time_point::min();
+    for (const auto& [generator, overlap_size] : generators) {
+      uint64_t last = timeslice_schedule.start(index + 1) + overlap_size - 1;
+      due = std::max(due, generator->due_time(last));
+    }
+    return due;
+  };
+}
+
+void Application::write_benchmark_report() const {
+  TimesliceStatistics total;
+  for (const auto& statistics : timeslice_statistics_) {
+    total.merge(*statistics);
+  }
+
+  std::ostringstream transport;
+  transport << par_.transport();
+  std::map<std::string, std::string> labels{
+      {"transport", transport.str()},
+      {"inputs", std::to_string(par_.inputs().size())},
+      {"outputs", std::to_string(par_.outputs().size())},
+      {"local", par_.local_only() ? "true" : "false"}};
+
+  L_(info) << "benchmark: " << total.timeslice_count() << " timeslices in "
+           << total.seconds() << " s, "
+           << human_readable_count(
+                  static_cast<uint64_t>(total.data_rate()), true)
+           << "/s";
+
+  if (par_.benchmark_report() == "-") {
+    total.write_json(std::cout, labels);
+    return;
+  }
+  std::ofstream out(par_.benchmark_report(), std::ios::app);
+  if (!out) {
+    L_(error) << "cannot open benchmark report file: "
+              << par_.benchmark_report();
+    return;
+  }
+  total.write_json(out, labels);
+}
+
+void Application::write_buffer_sizing_record() const {
+  std::map<std::string, double> sizes;
+  for (size_t c = 0; c < timeslice_buffers_.size(); ++c) {
+    double mean_size = timeslice_buffers_[c]->mean_component_size();
+    if (mean_size > 0) {
+      sizes["output" + std::to_string(par_.output_indexes().at(c))] =
+          mean_size;
+    }
+  }
+  if (sizes.empty()) {
+    return;
+  }
+  try {
+    BufferSizing::update_record(par_.buffer_sizing_file(), sizes);
+  } catch (const std::exception& e) {
+    L_(error) << e.what();
+  }
 }
 
 void Application::start_processes(const std::string& shared_memory_identifier) {
+  for (uint32_t i = 0; i < par_.processor_instances(); ++i) {
+    start_process(shared_memory_identifier, i, this);
+  }
+}
+
+void Application::start_process(const std::string& shared_memory_identifier,
+                                uint32_t index,
+                                void* owner) {
   const std::string processor_executable = par_.processor_executable();
   assert(!processor_executable.empty());
-  for (uint_fast32_t i = 0; i < par_.processor_instances(); ++i) {
-    std::stringstream index;
-    index << i;
-    ChildProcess cp = ChildProcess();
-    cp.owner = this;
-    boost::split(cp.arg, processor_executable, boost::is_any_of(" \t"),
-                 boost::token_compress_on);
-    cp.path = cp.arg.at(0);
-    for (auto& arg : cp.arg) {
-      boost::replace_all(arg, "%s", shared_memory_identifier);
-      boost::replace_all(arg, "%i", index.str());
-    }
-    ChildProcessManager::get().start_process(cp);
+  ChildProcess cp = ChildProcess();
+  cp.owner = owner;
+  boost::split(cp.arg, processor_executable, boost::is_any_of(" \t"),
+               boost::token_compress_on);
+  cp.path = cp.arg.at(0);
+  for (auto& arg : cp.arg) {
+    boost::replace_all(arg, "%s", shared_memory_identifier);
+    boost::replace_all(arg, "%i", std::to_string(index));
+  }
+  ChildProcessManager::get().start_process(cp);
+}
+
+void Application::scale_processors(const std::atomic<bool>& stopped) {
+  constexpr auto poll_interval = std::chrono::milliseconds(100);
+  auto next_sample = std::chrono::steady_clock::now();
+  while (!stopped) {
+    if (std::chrono::steady_clock::now() < next_sample) {
+      std::this_thread::sleep_for(poll_interval);
+      continue;
+    }
+    next_sample += par_.processor_scale_interval();
+
+    for (auto& pool : processor_pools_) {
+      ItemDistributor::Load load = pool->distributor->load();
+      ProcessorLoad sample{load.waiting_items, load.outstanding_items,
+                           static_cast<double>(load.held_items) /
+                               static_cast<double>(pool->capacity)};
+      uint32_t previous = pool->scaler.instances();
+      uint32_t instances = pool->scaler.update(sample);
+      if (instances > previous) {
+        L_(info) << pool->shm_identifier << ": " << load.waiting_items
+                 << " items waiting, starting processor instance "
+                 << pool->next_index;
+        start_process(pool->shm_identifier, pool->next_index++, pool.get());
+        ChildProcessManager::get().allow_stop_processes(pool.get());
+      } else if (instances < previous) {
+        L_(info) << pool->shm_identifier
+                 << ": processors idle, retiring an instance";
+        ChildProcessManager::get().stop_last_process(pool.get());
+      }
+    }
   }
 }
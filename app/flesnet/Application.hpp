@@ -1,23 +1,31 @@
 // Copyright 2012-2016 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "BufferStatusSampler.hpp"
+#include "ComponentSenderLocal.hpp"
 #include "ComponentSenderZeromq.hpp"
 #include "ConnectionGroupWorker.hpp"
 #include "ItemDistributor.hpp"
 #include "Monitor.hpp"
 #include "Parameters.hpp"
+#include "ProcessorScaler.hpp"
+#include "StatusServer.hpp"
 #include "ThreadContainer.hpp"
 #include "TimesliceBuffer.hpp"
+#include "TimesliceBuilderLocal.hpp"
 #include "TimesliceBuilderZeromq.hpp"
+#include "TimesliceStatistics.hpp"
 #include "shm_device_client.hpp"
 #if defined(HAVE_RDMA)
 #include "fles_rdma/InputChannelSender.hpp"
+#include "fles_rdma/RemoteConsumerServer.hpp"
 #include "fles_rdma/TimesliceBuilder.hpp"
 #endif
 #if defined(HAVE_LIBFABRIC)
 #include "fles_libfabric/InputChannelSender.hpp"
 #include "fles_libfabric/TimesliceBuilder.hpp"
 #endif
+#include <atomic>
 #include <csignal>
 #include <map>
 #include <memory>
@@ -45,6 +53,12 @@ public:
 private:
   void create_timeslice_buffers();
   void create_input_channel_senders();
+  [[nodiscard]] TimesliceStatistics::Schedule input_schedule() const;
+  void write_benchmark_report() const;
+
+  /// Record the mean component size of the local outputs for the automatic
+  /// buffer sizing of the next run.
+  void write_buffer_sizing_record() const;
 
   /// The run parameters object.
   Parameters const& par_;
@@ -53,6 +67,9 @@ private:
   /// The application's monitoring object
   std::unique_ptr<cbm::Monitor> monitor_;
 
+  /// The application's sampler of the transport buffer fill levels
+  std::unique_ptr<BufferStatusSampler> buffer_status_sampler_;
+
   /// The application's ZeroMQ context
   zmq::context_t zmq_context_{1};
 
@@ -63,6 +80,10 @@ private:
   std::vector<std::unique_ptr<InputBufferReadInterface>> data_sources_;
   std::vector<std::unique_ptr<TimesliceBuffer>> timeslice_buffers_;
 
+  /// The statistics of the timeslices received by the output buffers
+  /// (only if a benchmark report is requested)
+  std::vector<std::unique_ptr<TimesliceStatistics>> timeslice_statistics_;
+
   // The application's output item distributor objects
   std::vector<std::unique_ptr<ItemDistributor>> item_distributors_;
 
@@ -72,10 +93,52 @@ private:
   std::vector<std::unique_ptr<ConnectionGroupWorker>> input_channel_senders_;
 #endif
 
+#if defined(HAVE_RDMA)
+  /// The application's services for remote consumers of timeslice buffers
+  std::vector<std::unique_ptr<RemoteConsumerServer>> remote_consumer_servers_;
+#endif
+
   /// The application's ZeroMQ transport objects
   std::vector<std::unique_ptr<TimesliceBuilderZeromq>>
       timeslice_builders_zeromq_;
   std::vector<std::unique_ptr<ComponentSenderZeromq>> component_senders_zeromq_;
 
+  /// The application's Local transport objects
+  std::vector<std::unique_ptr<TimesliceBuilderLocal>> timeslice_builders_local_;
+  std::vector<std::unique_ptr<ComponentSenderLocal>> component_senders_local_;
+
+  /// The NUMA nodes to run the threads of each output and input on
+  /// (-1: unknown, or no thread placement)
+  std::vector<int> output_nodes_;
+  std::vector<int> input_nodes_;
+
+  /// The NUMA nodes to run the item distributor threads on
+  std::vector<int> distributor_nodes_;
+
+  /// The autoscaled timeslice processors of an output
+  struct ProcessorPool {
+    std::string shm_identifier;
+    ItemDistributor* distributor;
+    /// The number of timeslices the buffer can hold
+    std::size_t capacity;
+    ProcessorScaler scaler;
+    /// The instance index of the next processor to start
+    uint32_t next_index;
+  };
+
+  /// The autoscaled processors of each output (if enabled)
+  std::vector<std::unique_ptr<ProcessorPool>> processor_pools_;
+
+  /// The application's status endpoint (declared last, so that it is
+  /// stopped before the objects it reads are destroyed)
+  std::unique_ptr<StatusServer> status_server_;
+
   void start_processes(const std::string& shared_memory_identifier);
+  void start_process(const std::string& shared_memory_identifier,
+                     uint32_t index,
+                     void* owner);
+
+  /// Sample the backlog of the outputs and start or retire processors
+  /// until stopped.
+  void scale_processors(const std::atomic<bool>& stopped);
 };
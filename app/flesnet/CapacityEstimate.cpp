@@ -0,0 +1,441 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "CapacityEstimate.hpp"
+#include "BufferSizing.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "SizeRecord.hpp"
+#include "System.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+// Pathnames matching a pattern (none if there is no match)
+std::vector<std::string> glob_paths(const std::string& pattern) {
+  try {
+    return fles::system::glob(pattern, fles::system::glob_flags::none);
+  } catch (const std::runtime_error&) {
+    return {};
+  }
+}
+
+// Memory of the NUMA nodes (Linux only, none if unavailable)
+std::map<int, fles::system::memory_info> probe_numa_memory() {
+  std::map<int, fles::system::memory_info> memory;
+  const std::string prefix = "/sys/devices/system/node/node";
+  for (const auto& path : glob_paths(prefix + "[0-9]*")) {
+    int node = std::stoi(path.substr(prefix.size()));
+    memory[node] = fles::system::memory_of_numa_node(node);
+  }
+  return memory;
+}
+
+// Rate of the fastest network link in B/s (0: unknown)
+double probe_link_rate(Transport transport) {
+  double rate = 0;
+  if (transport == Transport::RDMA || transport == Transport::LibFabric) {
+    // e.g., "100 Gb/sec (4X EDR)"
+    for (const auto& path :
+         glob_paths("/sys/class/infiniband/*/ports/*/rate")) {
+      std::ifstream file(path);
+      double gbit = 0;
+      if (file >> gbit) {
+        rate = std::max(rate, gbit * 1e9 / 8);
+      }
+    }
+  }
+  if (rate == 0) {
+    // in Mb/s, reading fails for virtual or inactive interfaces
+    for (const auto& path : glob_paths("/sys/class/net/*/speed")) {
+      std::ifstream file(path);
+      int64_t mbit = 0;
+      if (file >> mbit && mbit > 0) {
+        rate = std::max(rate, static_cast<double>(mbit) * 1e6 / 8);
+      }
+    }
+  }
+  return rate;
+}
+
+// Smallest exponent of two not less than the given number
+uint32_t exponent_for(double n) {
+  uint32_t exponent = 0;
+  while (std::ldexp(1.0, static_cast<int>(exponent)) < n) {
+    ++exponent;
+  }
+  return exponent;
+}
+
+std::string format_rate(double rate) {
+  if (std::isinf(rate)) {
+    return "unlimited";
+  }
+  std::ostringstream oss;
+  oss << std::setprecision(4) << rate;
+  return oss.str();
+}
+
+std::string format_bytes(double bytes) {
+  return human_readable_count(static_cast<uint64_t>(bytes));
+}
+
+std::string format_byte_rate(double rate) {
+  if (std::isinf(rate)) {
+    return "unlimited";
+  }
+  return human_readable_count(static_cast<uint64_t>(rate), true, "B/s");
+}
+
+bool contains(const std::vector<unsigned>& indexes, unsigned index) {
+  return std::find(indexes.begin(), indexes.end(), index) != indexes.end();
+}
+
+int parse_numa_node(const std::map<std::string, std::string>& param,
+                    const std::string& host) {
+  if (param.count("numa") == 0u) {
+    return -1;
+  }
+  if (param.at("numa") == "auto") {
+    return fles::system::numa_node_of_host(host);
+  }
+  return std::stoi(param.at("numa"));
+}
+
+} // namespace
+
+CapacityEstimate::CapacityEstimate(const Parameters& par)
+    : processing_time_(par.dry_run_processing_time() * 1e-3),
+      processor_instances_(std::max(par.processor_instances(), 1u)) {
+  auto input_specs = par.inputs();
+  auto output_specs = par.outputs();
+  auto input_indexes = par.input_indexes();
+  auto output_indexes = par.output_indexes();
+
+  // the local buffers of automatic size share the available memory
+  auto auto_size = [](const std::map<std::string, std::string>& param) {
+    return param.count("datasize") != 0u && param.at("datasize") == "auto";
+  };
+  unsigned auto_buffers = 0;
+  for (unsigned i : input_indexes) {
+    auto_buffers += auto_size(input_specs[i].param) ? 1 : 0;
+  }
+  for (unsigned o : output_indexes) {
+    auto_buffers += auto_size(output_specs[o].param) ? 1 : 0;
+  }
+  std::map<std::string, double> record;
+  if (!par.buffer_sizing_file().empty()) {
+    record = BufferSizing::read_record(par.buffer_sizing_file());
+  }
+
+  for (unsigned i = 0; i < input_specs.size(); ++i) {
+    const auto& param = input_specs[i].param;
+    Input in;
+    in.index = i;
+    in.scheme = input_specs[i].scheme;
+    in.local = contains(input_indexes, i);
+    in.numa_node = parse_numa_node(param, input_specs[i].host);
+
+    // a fan-in input carries fan_in microslices per microslice index
+    uint32_t fan_in = 1;
+    if (param.count("fanin") != 0u) {
+      fan_in += static_cast<uint32_t>(split(param.at("fanin"), ",").size());
+    }
+    in.timeslice_size = par.timeslice_size() * fan_in;
+    in.overlap_size =
+        (param.count("overlap") != 0u ? stou(param.at("overlap")) : 1) *
+        fan_in;
+
+    if (in.scheme == "pgen") {
+      in.microslice_size =
+          param.count("mean") != 0u ? stou(param.at("mean")) : 1024;
+      in.datasize = 27; // 128 MiB
+      in.descsize = 19; // 16 MiB
+      if (param.count("delay") != 0u && stoul(param.at("delay")) != 0) {
+        in.rate = in.microslice_size * 1e9 /
+                  static_cast<double>(stoul(param.at("delay")));
+      }
+      if (param.count("sizes") != 0u) {
+        SizeRecord record = SizeRecord::read(param.at("sizes"));
+        in.microslice_size = record.mean_size();
+        double speed =
+            param.count("speed") != 0u ? std::stod(param.at("speed")) : 0;
+        if (record.series() && speed > 0 && record.period() > 0) {
+          in.rate = record.mean_size() *
+                    static_cast<double>(record.entries()) * 1e9 /
+                    static_cast<double>(record.period()) * speed;
+        }
+      }
+    } else {
+      // the buffers of other inputs belong to the readout, unless merged
+      in.microslice_size = par.dry_run_microslice_size();
+    }
+    if (auto_size(param)) {
+      BufferSize size = BufferSizing::fit(
+          BufferSizing::budget(in.numa_node, par.buffer_auto_memory(),
+                               auto_buffers),
+          in.microslice_size, sizeof(fles::MicrosliceDescriptor));
+      in.datasize = size.datasize;
+      in.descsize = size.descsize;
+    } else if (param.count("datasize") != 0u) {
+      in.datasize = stou(param.at("datasize"));
+    }
+    if (param.count("descsize") != 0u) {
+      in.descsize = stou(param.at("descsize"));
+    }
+    if (in.rate == 0) {
+      in.rate = par.dry_run_rate() * 1e6;
+    }
+
+    if (in.local && in.datasize && in.descsize &&
+        (in.scheme == "pgen" || fan_in > 1)) {
+      memory_[in.numa_node].planned +=
+          (UINT64_C(1) << *in.datasize) +
+          (UINT64_C(1) << *in.descsize) * sizeof(fles::MicrosliceDescriptor);
+    }
+    timeslice_bytes_ += in.component_bytes();
+    if (in.rate > 0) {
+      double rate = in.rate / (in.timeslice_size * in.microslice_size);
+      expected_rate_ =
+          expected_rate_ > 0 ? std::min(expected_rate_, rate) : rate;
+    }
+    inputs_.push_back(in);
+  }
+
+  for (unsigned o = 0; o < output_specs.size(); ++o) {
+    const auto& param = output_specs[o].param;
+    Output out;
+    out.index = o;
+    out.numa_node = parse_numa_node(param, output_specs[o].host);
+    out.datasize = 27; // 128 MiB
+    out.descsize = 19; // 16 MiB
+    if (auto_size(param)) {
+      std::string name = "output" + std::to_string(o);
+      BufferSize size = BufferSizing::fit(
+          BufferSizing::budget(out.numa_node, par.buffer_auto_memory(),
+                               auto_buffers) /
+              input_specs.size(),
+          record.count(name) != 0u ? record.at(name) : 0,
+          sizeof(fles::TimesliceComponentDescriptor));
+      out.datasize = size.datasize;
+      out.descsize = size.descsize;
+    } else if (param.count("datasize") != 0u) {
+      out.datasize = stou(param.at("datasize"));
+    }
+    if (param.count("descsize") != 0u) {
+      out.descsize = stou(param.at("descsize"));
+    }
+    out.gpu = param.count("gpu") != 0u;
+    out.local = contains(output_indexes, o);
+    if (out.local && !out.gpu) {
+      memory_[out.numa_node].planned +=
+          input_specs.size() *
+          ((UINT64_C(1) << out.datasize) +
+           (UINT64_C(1) << out.descsize) *
+               sizeof(fles::TimesliceComponentDescriptor));
+    }
+    outputs_.push_back(out);
+  }
+
+  for (const auto& [node, info] : probe_numa_memory()) {
+    memory_[node].total = info.total;
+    memory_[node].free = info.available;
+  }
+  if (par.transport() != Transport::Local) {
+    link_rate_ = probe_link_rate(par.transport());
+  }
+
+  // limits of the timeslice rate
+  auto outputs = static_cast<double>(outputs_.size());
+  if (link_rate_ > 0) {
+    for (const Input& in : inputs_) {
+      add_limit(link_rate_ / in.component_bytes(),
+                "link of input " + std::to_string(in.index));
+    }
+    add_limit(outputs * link_rate_ / timeslice_bytes_, "links of outputs");
+  }
+  if (processing_time_ > 0) {
+    add_limit(outputs * processor_instances_ / processing_time_,
+              "processing");
+  }
+  for (const Input& in : inputs_) {
+    if (!in.datasize || !in.descsize) {
+      continue;
+    }
+    double data_capacity = (std::ldexp(1.0, static_cast<int>(*in.datasize)) -
+                            in.overlap_size * in.microslice_size) /
+                           (in.timeslice_size * in.microslice_size);
+    double desc_capacity = (std::ldexp(1.0, static_cast<int>(*in.descsize)) -
+                            in.overlap_size) /
+                           in.timeslice_size;
+    double capacity = std::floor(std::min(data_capacity, desc_capacity));
+    double slope = input_residency(in, 1) - input_residency(in, 0);
+    std::string cause = "buffer of input " + std::to_string(in.index);
+    if (capacity < input_residency(in, 0)) {
+      add_limit(0, cause);
+    } else if (slope > 0) {
+      add_limit((capacity - input_residency(in, 0)) / slope, cause);
+    }
+  }
+  for (const Output& out : outputs_) {
+    double capacity = std::ldexp(1.0, static_cast<int>(out.descsize));
+    for (const Input& in : inputs_) {
+      capacity = std::min(
+          capacity, std::floor(std::ldexp(1.0, static_cast<int>(out.datasize)) /
+                               in.component_bytes()));
+    }
+    double slope = output_residency(1) - output_residency(0);
+    std::string cause = "buffer of output " + std::to_string(out.index);
+    if (capacity < output_residency(0)) {
+      add_limit(0, cause);
+    } else if (slope > 0) {
+      add_limit((capacity - output_residency(0)) / slope, cause);
+    }
+  }
+
+  max_rate_ = std::numeric_limits<double>::infinity();
+  for (const Limit& limit : limits_) {
+    max_rate_ = std::min(max_rate_, limit.rate);
+  }
+}
+
+void CapacityEstimate::add_limit(double rate, const std::string& cause) {
+  limits_.push_back({rate, cause});
+}
+
+double CapacityEstimate::input_residency(const Input& in, double rate) const {
+  // acquired, transferred and processed, plus the one in acquisition
+  double time = processing_time_;
+  if (link_rate_ > 0) {
+    time += in.component_bytes() / link_rate_;
+  }
+  return 2 + rate * time;
+}
+
+double CapacityEstimate::output_residency(double rate) const {
+  // transferred and processed, plus the one in arrival
+  double time = processing_time_;
+  if (link_rate_ > 0) {
+    time += timeslice_bytes_ / link_rate_;
+  }
+  return 1 + rate / static_cast<double>(outputs_.size()) * time;
+}
+
+void CapacityEstimate::log_report() const {
+  L_(info) << "dry run: " << inputs_.size() << " inputs, " << outputs_.size()
+           << " outputs, " << format_bytes(timeslice_bytes_)
+           << " per timeslice";
+  L_(info) << "network link rate: "
+           << (link_rate_ > 0 ? format_byte_rate(link_rate_) : "unknown");
+  L_(info) << "processing time: " << processing_time_ * 1e3 << " ms per "
+           << "timeslice, " << processor_instances_ << " instance(s)";
+
+  for (const auto& [node, m] : memory_) {
+    std::string name =
+        node >= 0 ? "NUMA node " + std::to_string(node) : "unknown node";
+    if (m.total == 0) {
+      L_(info) << "memory " << name << ": " << format_bytes(m.planned)
+               << " planned";
+      continue;
+    }
+    L_(info) << "memory " << name << ": " << format_bytes(m.total)
+             << " total, " << format_bytes(m.free) << " free, "
+             << format_bytes(m.planned) << " planned";
+    if (m.planned > m.free) {
+      L_(warning) << "memory " << name << ": planned buffers exceed free "
+                  << "memory";
+    }
+  }
+
+  for (const Input& in : inputs_) {
+    std::ostringstream oss;
+    oss << "input " << in.index << " (" << in.scheme << "): microslice "
+        << format_bytes(in.microslice_size) << ", rate "
+        << (in.rate > 0 ? format_byte_rate(in.rate) : "unknown");
+    if (in.datasize && in.descsize) {
+      oss << ", buffer " << format_bytes(std::ldexp(1.0, *in.datasize))
+          << " + "
+          << format_bytes(std::ldexp(1.0, *in.descsize) *
+                          sizeof(fles::MicrosliceDescriptor));
+      if (in.rate > 0) {
+        oss << " (" << format_rate(std::ldexp(1.0, *in.datasize) / in.rate)
+            << " s)";
+      }
+    }
+    L_(info) << oss.str();
+  }
+  for (const Output& out : outputs_) {
+    L_(info) << "output " << out.index << ": buffer " << inputs_.size()
+             << " x " << format_bytes(std::ldexp(1.0, out.datasize)) << " + "
+             << format_bytes(std::ldexp(1.0, out.descsize) *
+                             sizeof(fles::TimesliceComponentDescriptor))
+             << (out.gpu ? " (GPU)" : "");
+  }
+
+  for (const Limit& limit : limits_) {
+    L_(debug) << "limit by " << limit.cause << ": " << format_rate(limit.rate)
+              << " timeslices/s";
+  }
+  std::string cause = "nothing known";
+  for (const Limit& limit : limits_) {
+    if (limit.rate == max_rate_) {
+      cause = limit.cause;
+      break;
+    }
+  }
+  L_(info) << "maximum sustainable rate: " << format_rate(max_rate_)
+           << " timeslices/s, "
+           << format_byte_rate(max_rate_ * timeslice_bytes_) << " (limited by "
+           << cause << ")";
+
+  double rate = expected_rate_;
+  if (rate > 0) {
+    if (rate > max_rate_) {
+      L_(warning) << "expected rate: " << format_rate(rate)
+                  << " timeslices/s, not sustainable";
+    } else {
+      L_(info) << "expected rate: " << format_rate(rate) << " timeslices/s";
+    }
+  } else if (!std::isinf(max_rate_)) {
+    rate = max_rate_;
+  }
+
+  // minimum buffer size exponents for the expected (or maximum) rate
+  L_(info) << "minimum buffer sizes at " << format_rate(rate)
+           << " timeslices/s:";
+  for (const Input& in : inputs_) {
+    double timeslices = std::ceil(input_residency(in, rate));
+    L_(info) << "input " << in.index << ": datasize="
+             << exponent_for(timeslices * in.timeslice_size *
+                                 in.microslice_size +
+                             in.overlap_size * in.microslice_size)
+             << " descsize="
+             << exponent_for(timeslices * in.timeslice_size +
+                             in.overlap_size);
+  }
+  double component_bytes = 0;
+  for (const Input& in : inputs_) {
+    component_bytes = std::max(component_bytes, in.component_bytes());
+  }
+  double timeslices = std::ceil(output_residency(rate));
+  for (const Output& out : outputs_) {
+    L_(info) << "output " << out.index
+             << ": datasize=" << exponent_for(timeslices * component_bytes)
+             << " descsize=" << exponent_for(timeslices);
+  }
+}
+
+bool CapacityEstimate::sufficient() const {
+  for (const auto& [node, m] : memory_) {
+    if (m.total != 0 && m.planned > m.free) {
+      return false;
+    }
+  }
+  return expected_rate_ > 0 ? max_rate_ >= expected_rate_ : max_rate_ > 0;
+}
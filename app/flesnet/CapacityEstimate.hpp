@@ -0,0 +1,95 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Estimate of the buffer use and sustainable rate of a configuration.
+#pragma once
+
+#include "Parameters.hpp"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// Capacity estimate of a flesnet configuration (the "dry run").
+/** A CapacityEstimate object derives, without creating any buffers or
+    connections, how many timeslices the input and timeslice buffers hold,
+    which timeslice rate the configuration can sustain, and which buffer
+    size exponents are needed for the expected rate. The memory of the NUMA
+    nodes and the rate of the network links are probed on the local host.
+
+    By Little's law, a buffer holds the timeslices of its residency time
+    times the timeslice rate. A timeslice resides in an input buffer while
+    its data is acquired, transferred and processed; in a timeslice buffer
+    while it is transferred and processed. */
+class CapacityEstimate {
+public:
+  /// The CapacityEstimate constructor.
+  explicit CapacityEstimate(const Parameters& par);
+
+  /// Log the estimate.
+  void log_report() const;
+
+  /// Check whether the configuration sustains the expected input rate.
+  [[nodiscard]] bool sufficient() const;
+
+  /// Retrieve the predicted maximum sustainable timeslice rate (1/s).
+  [[nodiscard]] double max_timeslice_rate() const { return max_rate_; }
+
+private:
+  struct Input {
+    unsigned index = 0;
+    std::string scheme;
+    double microslice_size = 0;       ///< Mean microslice size (B)
+    double rate = 0;                  ///< Expected data rate (B/s)
+    uint32_t timeslice_size = 0;      ///< Microslices per timeslice
+    uint32_t overlap_size = 0;        ///< Overlapping microslices
+    std::optional<uint32_t> datasize; ///< Data buffer exponent (if known)
+    std::optional<uint32_t> descsize; ///< Descriptor buffer exponent
+    int numa_node = -1;
+    bool local = false;
+
+    [[nodiscard]] double component_bytes() const {
+      return (timeslice_size + overlap_size) * microslice_size;
+    }
+  };
+
+  struct Output {
+    unsigned index = 0;
+    uint32_t datasize = 0;
+    uint32_t descsize = 0;
+    int numa_node = -1;
+    bool gpu = false;
+    bool local = false;
+  };
+
+  struct NumaMemory {
+    uint64_t total = 0;
+    uint64_t free = 0;
+    uint64_t planned = 0; ///< Buffer memory of the local inputs and outputs
+  };
+
+  /// A limit of the timeslice rate and its cause.
+  struct Limit {
+    double rate;
+    std::string cause;
+  };
+
+  void add_limit(double rate, const std::string& cause);
+
+  /// Timeslices resident in an input buffer at the given timeslice rate.
+  [[nodiscard]] double input_residency(const Input& in, double rate) const;
+
+  /// Timeslices resident in each timeslice buffer at the given rate.
+  [[nodiscard]] double output_residency(double rate) const;
+
+  std::vector<Input> inputs_;
+  std::vector<Output> outputs_;
+  std::map<int, NumaMemory> memory_;
+  double link_rate_ = 0;       ///< Rate of the fastest network link (B/s)
+  double processing_time_ = 0; ///< Time per timeslice and instance (s)
+  uint32_t processor_instances_ = 1;
+  double timeslice_bytes_ = 0;  ///< Total data of a timeslice (B)
+  double expected_rate_ = 0;    ///< Expected timeslice rate (1/s, 0: unknown)
+  double max_rate_ = 0;         ///< Maximum sustainable timeslice rate (1/s)
+  std::vector<Limit> limits_;
+};
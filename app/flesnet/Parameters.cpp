@@ -6,9 +6,11 @@
 #include "TimesliceComponentDescriptor.hpp"
 #include "Utility.hpp"
 #include "log.hpp"
+#include "tracing.hpp"
 #include <algorithm>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/program_options.hpp>
+#include <csignal>
 #include <fstream>
 #include <iterator>
 
@@ -26,6 +28,8 @@ std::istream& operator>>(std::istream& in, Transport& transport) {
     transport = Transport::LibFabric;
   } else if (token == "zeromq" || token == "z") {
     transport = Transport::ZeroMQ;
+  } else if (token == "local" || token == "l") {
+    transport = Transport::Local;
   } else {
     throw po::invalid_option_value(token);
   }
@@ -43,6 +47,70 @@ std::ostream& operator<<(std::ostream& out, const Transport& transport) {
   case Transport::ZeroMQ:
     out << "ZeroMQ";
     break;
+  case Transport::Local:
+    out << "Local";
+    break;
+  }
+  return out;
+}
+
+std::istream& operator>>(std::istream& in, ThreadPlacement& placement) {
+  std::string token;
+  in >> token;
+  std::transform(std::begin(token), std::end(token), std::begin(token),
+                 [](const unsigned char i) { return tolower(i); });
+
+  if (token == "none") {
+    placement = ThreadPlacement::None;
+  } else if (token == "numa") {
+    placement = ThreadPlacement::NUMA;
+  } else {
+    throw po::invalid_option_value(token);
+  }
+  return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const ThreadPlacement& placement) {
+  switch (placement) {
+  case ThreadPlacement::None:
+    out << "None";
+    break;
+  case ThreadPlacement::NUMA:
+    out << "NUMA";
+    break;
+  }
+  return out;
+}
+
+std::istream& operator>>(std::istream& in, PlacementPolicy& policy) {
+  std::string token;
+  in >> token;
+  std::transform(std::begin(token), std::end(token), std::begin(token),
+                 [](const unsigned char i) { return tolower(i); });
+
+  if (token == "roundrobin" || token == "r") {
+    policy = PlacementPolicy::RoundRobin;
+  } else if (token == "weighted" || token == "w") {
+    policy = PlacementPolicy::Weighted;
+  } else if (token == "credit" || token == "c") {
+    policy = PlacementPolicy::Credit;
+  } else {
+    throw po::invalid_option_value(token);
+  }
+  return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const PlacementPolicy& policy) {
+  switch (policy) {
+  case PlacementPolicy::RoundRobin:
+    out << "RoundRobin";
+    break;
+  case PlacementPolicy::Weighted:
+    out << "Weighted";
+    break;
+  case PlacementPolicy::Credit:
+    out << "Credit";
+    break;
   }
   return out;
 }
@@ -71,6 +139,10 @@ void Parameters::parse_options(int argc, char* argv[]) {
   unsigned log_level = 2;
   unsigned log_syslog = 2;
   std::string log_file;
+  std::string log_async;
+  constexpr size_t log_queue_size = 4096; // messages per thread and sink
+  std::string trace_file;
+  uint32_t trace_window = 1000;
   std::string config_file;
 
   po::options_description generic("Generic options");
@@ -91,6 +163,21 @@ void Parameters::parse_options(int argc, char* argv[]) {
                   ->implicit_value(log_syslog)
                   ->value_name("<n>"),
               "enable logging to syslog at given log level");
+  generic_add("log-async",
+              po::value<std::string>(&log_async)
+                  ->implicit_value("drop")
+                  ->value_name("<policy>"),
+              "write log output in a background thread, on queue overflow "
+              "\"drop\" messages or \"block\"");
+  generic_add("trace-file",
+              po::value<std::string>(&trace_file)->value_name("<filename>"),
+              "on SIGUSR1, write a timeline trace (Perfetto/Chrome JSON) to "
+              "file");
+  generic_add("trace-window",
+              po::value<uint32_t>(&trace_window)
+                  ->default_value(trace_window)
+                  ->value_name("<ms>"),
+              "length of a timeline trace started by SIGUSR1");
   generic_add("monitor,m",
               po::value<std::string>(&monitor_uri_)
                   ->value_name("<uri>")
@@ -110,6 +197,29 @@ void Parameters::parse_options(int argc, char* argv[]) {
       "output-index,o",
       po::value<std::vector<unsigned>>()->multitoken()->value_name("<n> ..."),
       "set this application's index(es) in the list of outputs");
+  config_add("timeslice-buffer-pool",
+             po::value<std::string>(&timeslice_buffer_pool_)
+                 ->value_name("<id>"),
+             "allocate the timeslice buffers of all local outputs from one "
+             "shared memory segment with this identifier, which consumers "
+             "attach once");
+  config_add("buffer-auto-memory",
+             po::value<uint32_t>(&buffer_auto_memory_)
+                 ->default_value(buffer_auto_memory_)
+                 ->value_name("<percent>"),
+             "share of the available memory of a NUMA node used by the "
+             "local buffers with datasize=auto");
+  config_add("buffer-sizing-file",
+             po::value<std::string>(&buffer_sizing_file_)
+                 ->value_name("<file>"),
+             "record the mean timeslice component size of each output at "
+             "exit, and use it to size the buffers with datasize=auto");
+  config_add("processes", po::value<bool>(&processes_)->default_value(false),
+             "run each of this application's inputs and outputs in a "
+             "separate process instead of a thread, sharing nothing");
+  config_add("process", po::value<int>(&process_)->default_value(process_),
+             "run only the given one of this application's inputs and "
+             "outputs (inputs first, used internally with processes)");
   config_add("input,I",
              po::value<std::vector<InterfaceSpecification>>()
                  ->multitoken()
@@ -125,6 +235,24 @@ void Parameters::parse_options(int argc, char* argv[]) {
                  ->default_value(timeslice_size_)
                  ->value_name("<n>"),
              "set the global timeslice size in number of microslices");
+  config_add("timeslice-size-changes",
+             po::value<std::string>(&timeslice_size_changes_)
+                 ->value_name("<ts>:<n>,..."),
+             "change the timeslice size to <n> microslices from timeslice "
+             "<ts> on, e.g., between run phases (RDMA only)");
+  config_add("timeslice-bytes",
+             po::value<uint64_t>(&timeslice_bytes_)
+                 ->default_value(timeslice_bytes_)
+                 ->value_name("<n>"),
+             "adapt the size of the timeslices of each placement epoch to "
+             "approach this number of bytes, starting with timeslice-size "
+             "(RDMA with Credit placement only, 0: fixed size)");
+  config_add("max-timeslice-size",
+             po::value<uint32_t>(&max_timeslice_size_)
+                 ->default_value(max_timeslice_size_)
+                 ->value_name("<n>"),
+             "limit adapted timeslices to this number of microslices, i.e., "
+             "their duration (0: eight times timeslice-size)");
   config_add("max-timeslice-number,n",
              po::value<uint32_t>(&max_timeslice_number_)->value_name("<n>"),
              "quit after processing given number of timeslices");
@@ -136,7 +264,19 @@ void Parameters::parse_options(int argc, char* argv[]) {
              po::value<uint32_t>(&processor_instances_)
                  ->default_value(processor_instances_)
                  ->value_name("<n>"),
-             "number of instances of the timeslice processor executable");
+             "number of instances of the timeslice processor executable "
+             "(the lower bound if autoscaling)");
+  config_add("processor-instances-max",
+             po::value<uint32_t>(&processor_instances_max_)
+                 ->default_value(processor_instances_max_)
+                 ->value_name("<n>"),
+             "scale the number of processor instances of each output with "
+             "its backlog up to this number (0: fixed number)");
+  config_add("processor-scale-interval",
+             po::value<uint32_t>(&processor_scale_interval_)
+                 ->default_value(processor_scale_interval_)
+                 ->value_name("<ms>"),
+             "interval of the backlog samples for autoscaling");
   config_add("base-port",
              po::value<uint32_t>(&base_port_)
                  ->default_value(base_port_)
@@ -147,7 +287,224 @@ void Parameters::parse_options(int argc, char* argv[]) {
                  ->default_value(transport_)
                  ->value_name("<id>"),
              "select transport implementation; possible values "
-             "(case-insensitive) are: RDMA, LibFabric, ZeroMQ");
+             "(case-insensitive) are: RDMA, LibFabric, ZeroMQ, Local (inputs "
+             "and outputs in a single process)");
+  config_add("zeromq-raw-data",
+             po::value<bool>(&zeromq_raw_data_)->default_value(false),
+             "receive component data into the timeslice buffer in place "
+             "over a raw TCP channel (ZeroMQ only, uses the ports following "
+             "the input ports)");
+  config_add("zeromq-zerocopy",
+             po::value<bool>(&zeromq_zerocopy_)->default_value(false),
+             "send the raw data channel contents with MSG_ZEROCOPY directly "
+             "from the input buffer (ZeroMQ raw data mode only)");
+  config_add("zeromq-request-window",
+             po::value<uint32_t>(&zeromq_request_window_)
+                 ->default_value(zeromq_request_window_)
+                 ->value_name("<n>"),
+             "number of outstanding timeslice requests per connection "
+             "(ZeroMQ only, values > 1 use pipelined DEALER/ROUTER sockets)");
+  config_add("zeromq-compression",
+             po::value<std::string>(&zeromq_compression_)
+                 ->default_value(zeromq_compression_)
+                 ->value_name("<list>"),
+             "compress component data on the wire with zstd for the given "
+             "subsystem identifiers (comma-separated, e.g. 0x10,0x40, or "
+             "'all'; ZeroMQ only, not with raw data)");
+  config_add("zeromq-compression-level",
+             po::value<int>(&zeromq_compression_config_.level)
+                 ->default_value(zeromq_compression_config_.level)
+                 ->value_name("<n>"),
+             "zstd compression level of the ZeroMQ transport");
+  config_add("zeromq-compression-threads",
+             po::value<unsigned int>(&zeromq_compression_config_.threads)
+                 ->default_value(zeromq_compression_config_.threads)
+                 ->value_name("<n>"),
+             "number of compression worker threads per input (0: compress "
+             "in the sender thread)");
+  config_add("placement-policy",
+             po::value<PlacementPolicy>(&placement_policy_)
+                 ->default_value(placement_policy_)
+                 ->value_name("<id>"),
+             "select timeslice-to-compute-node placement (RDMA only); "
+             "possible values (case-insensitive) are: RoundRobin, Weighted "
+             "(by compute node buffer size), Credit (by free buffer space)");
+  config_add("placement-epoch",
+             po::value<uint32_t>(&placement_epoch_)
+                 ->default_value(placement_epoch_)
+                 ->value_name("<n>"),
+             "number of timeslices per placement credit epoch (Credit only, "
+             "at least the number of outputs)");
+  config_add("thread-placement",
+             po::value<ThreadPlacement>(&thread_placement_)
+                 ->default_value(thread_placement_)
+                 ->value_name("<id>"),
+             "select the placement of the transport threads; possible values "
+             "(case-insensitive) are: None, NUMA (run each thread on the NUMA "
+             "node of its buffer or network device)");
+  config_add("rdma-signal-interval",
+             po::value<uint32_t>(&rdma_signal_interval_)
+                 ->default_value(rdma_signal_interval_)
+                 ->value_name("<n>"),
+             "request a completion only for every n-th timeslice written to a "
+             "compute node (RDMA only)");
+  config_add("rdma-post-batch",
+             po::value<uint32_t>(&rdma_post_batch_)
+                 ->default_value(rdma_post_batch_)
+                 ->value_name("<n>"),
+             "maximum number of timeslices posted to the send queue with a "
+             "single call (RDMA only)");
+  config_add("rdma-stripes",
+             po::value<uint32_t>(&rdma_stripes_)
+                 ->default_value(rdma_stripes_)
+                 ->value_name("<n>"),
+             "number of queue pairs per connection to divide the timeslice "
+             "data between (RDMA only, implies rdma-signal-interval=1)");
+  config_add("rdma-control-qp",
+             po::value<bool>(&rdma_control_qp_)->default_value(false),
+             "reserve the primary queue pair of each connection for "
+             "descriptors and status messages and send all data over the "
+             "other stripes (RDMA only, requires rdma-stripes > 1)");
+  config_add("rdma-control-tos",
+             po::value<uint32_t>(&rdma_control_tos_)
+                 ->default_value(rdma_control_tos_)
+                 ->value_name("<n>"),
+             "type of service (IP ToS, mapped to the traffic class or service "
+             "level) of the control queue pairs (RDMA only)");
+  config_add("rdma-adaptive-window",
+             po::value<bool>(&rdma_adaptive_window_)->default_value(false),
+             "adapt the number of outstanding timeslice writes per "
+             "connection to its completion latency (RDMA only)");
+  config_add("rdma-lookahead",
+             po::value<uint32_t>(&rdma_lookahead_)
+                 ->default_value(rdma_lookahead_)
+                 ->value_name("<n>"),
+             "number of timeslices that may be sent to other compute nodes "
+             "while the next one waits for its target (RDMA only, not with "
+             "adaptive timeslice size)");
+  config_add("rdma-pacing-rate",
+             po::value<std::string>(&rdma_pacing_rate_)
+                 ->default_value(rdma_pacing_rate_)
+                 ->value_name("<MB/s>"),
+             "space the writes to each compute node to this rate, reduced "
+             "on rising completion latency (RDMA only, \"auto\": the port "
+             "rate, \"none\": no pacing)");
+  config_add("rdma-pacing-burst",
+             po::value<uint64_t>(&rdma_pacing_burst_)
+                 ->default_value(rdma_pacing_burst_)
+                 ->value_name("<bytes>"),
+             "maximum burst size of the paced writes (RDMA only)");
+  config_add("timeslice-lifecycle",
+             po::value<bool>(&timeslice_lifecycle_)->default_value(false),
+             "record the latencies of each timeslice from the arrival of its "
+             "data on the input nodes until its dispatch to a consumer "
+             "(RDMA only, requires monitoring)");
+  config_add("rdma-srq",
+             po::value<bool>(&rdma_srq_)->default_value(false),
+             "receive the status messages of all input connections through a "
+             "shared receive queue (RDMA only)");
+  config_add("rdma-pull-reads",
+             po::value<uint32_t>(&rdma_pull_reads_)
+                 ->default_value(rdma_pull_reads_)
+                 ->value_name("<n>"),
+             "let the compute nodes read the timeslice data from the input "
+             "nodes, with at most n components being read at the same time "
+             "per compute node (RDMA only, 0: the input nodes write the "
+             "data)");
+  config_add("rdma-odp",
+             po::value<bool>(&rdma_odp_)->default_value(false),
+             "register the input and timeslice buffers with on-demand paging "
+             "where supported by the device, avoiding pinning all pages at "
+             "startup (RDMA only)");
+  config_add("rdma-register-threads",
+             po::value<uint32_t>(&rdma_register_threads_)
+                 ->default_value(rdma_register_threads_)
+                 ->value_name("<n>"),
+             "number of threads populating the page tables of a buffer in "
+             "parallel before its registration (RDMA only, 0: none)");
+  config_add("connect-quorum",
+             po::value<uint32_t>(&connect_quorum_)
+                 ->default_value(connect_quorum_)
+                 ->value_name("<n>"),
+             "start sending once connected to this number of compute nodes, "
+             "setting up the remaining connections meanwhile (RDMA with "
+             "RoundRobin placement only, 0: all)");
+  config_add("timeslice-deadline",
+             po::value<uint32_t>(&timeslice_deadline_)
+                 ->default_value(timeslice_deadline_)
+                 ->value_name("<ms>"),
+             "deliver a timeslice with the components received so far once "
+             "this time has passed since its first component arrived, the "
+             "missing components being empty (RDMA only, 0: wait for all)");
+  config_add("transport-threads",
+             po::value<uint32_t>(&transport_threads_)
+                 ->default_value(transport_threads_)
+                 ->value_name("<n>"),
+             "number of threads to drive the input channel senders and "
+             "timeslice builders cooperatively, trading latency for busy "
+             "cores (RDMA only, 0: one thread per sender or builder)");
+  config_add("completion-wait",
+             po::value<uint32_t>(&completion_wait_)
+                 ->default_value(completion_wait_)
+                 ->value_name("<us>"),
+             "let an idle sender or builder block on its completion queue for "
+             "at most this time instead of busy polling, which bounds the "
+             "delay of new input data (RDMA and LibFabric, 0: always busy "
+             "poll)");
+  config_add("completion-spin",
+             po::value<uint32_t>(&completion_spin_)
+                 ->default_value(completion_spin_)
+                 ->value_name("<us>"),
+             "time a sender or builder keeps busy polling after its last "
+             "activity before blocking (see completion-wait)");
+  config_add("rdma-status-interval",
+             po::value<uint32_t>(&rdma_status_interval_)
+                 ->default_value(rdma_status_interval_)
+                 ->value_name("<us>"),
+             "maximum interval between status messages to a compute node, "
+             "shortened as its buffer fills (RDMA only, 0: no coalescing)");
+  config_add("buffer-sample-rate",
+             po::value<uint32_t>(&buffer_sample_rate_)
+                 ->default_value(buffer_sample_rate_)
+                 ->value_name("<Hz>"),
+             "rate of sampling the transport buffer fill levels into "
+             "histograms for the monitor (RDMA only, 0: disabled)");
+  config_add("status-endpoint",
+             po::value<std::string>(&status_endpoint_)
+                 ->value_name("<[host:]port>"),
+             "serve the current buffer, connection and distributor status "
+             "of this process as JSON at http://<host:port>/status");
+  config_add("status-interval",
+             po::value<uint32_t>(&status_interval_)
+                 ->default_value(status_interval_)
+                 ->value_name("<ms>"),
+             "interval of updating the status served at --status-endpoint");
+  config_add("benchmark-report",
+             po::value<std::string>(&benchmark_report_)->value_name("<file>"),
+             "at exit, append throughput and latency of the timeslices "
+             "received by this application's outputs as a JSON line to the "
+             "given file (\"-\": standard output)");
+  config_add("dry-run", po::value<bool>(&dry_run_)->default_value(false),
+             "estimate the buffer residency and the maximum sustainable rate "
+             "of the configuration and exit without connecting");
+  config_add("dry-run-rate",
+             po::value<double>(&dry_run_rate_)
+                 ->default_value(dry_run_rate_)
+                 ->value_name("<MB/s>"),
+             "recorded data rate of each input without a pattern generator "
+             "delay (dry run only, 0: unknown)");
+  config_add("dry-run-microslice-size",
+             po::value<uint32_t>(&dry_run_microslice_size_)
+                 ->default_value(dry_run_microslice_size_)
+                 ->value_name("<bytes>"),
+             "mean microslice size of each input that is not a pattern "
+             "generator (dry run only)");
+  config_add("dry-run-processing-time",
+             po::value<double>(&dry_run_processing_time_)
+                 ->default_value(dry_run_processing_time_)
+                 ->value_name("<ms>"),
+             "time a processor instance takes for one timeslice (dry run "
+             "only)");
   config_add("discard-all-ts",
              po::value<bool>(&drop_process_ts_)->default_value(false),
              "Discard all timeslices at receiver (debug only)");
@@ -170,6 +527,12 @@ void Parameters::parse_options(int argc, char* argv[]) {
       "scheduler-speedup-interval-count",
       po::value<uint32_t>(&scheduler_speedup_interval_count_)->default_value(0),
       "The scheduler speeding up interval count (LibFabric only)");
+  config_add(
+      "scheduler-ewma-weight",
+      po::value<uint32_t>(&scheduler_ewma_weight_)->default_value(0),
+      "The weight in percent of new round durations in the scheduler's "
+      "prediction of interval durations, replacing the speedup heuristics "
+      "(LibFabric only, 0: disabled)");
   config_add(
       "scheduler-log-directory",
       po::value<std::string>(&scheduler_log_directory_)->default_value("."),
@@ -177,6 +540,36 @@ void Parameters::parse_options(int argc, char* argv[]) {
   config_add("scheduler-enable-logging",
              po::value<bool>(&scheduler_enable_logging_)->default_value(false),
              "Enable generating logging files (LibFabric only)");
+  config_add(
+      "scheduler-staggered-rounds",
+      po::value<bool>(&scheduler_staggered_rounds_)->default_value(false),
+      "stagger the transmissions of each scheduler round, so that the "
+      "inputs send to different compute nodes at a time (LibFabric only)");
+  config_add("scheduler-replication-modulo",
+             po::value<uint32_t>(&scheduler_replication_modulo_)
+                 ->default_value(0),
+             "replicate every n-th timeslice to the next compute node as hot "
+             "standby, which takes it over if the first one fails (0: no "
+             "replication, LibFabric only)");
+  config_add("libfabric-rail",
+             po::value<std::vector<std::string>>(&libfabric_rails_)
+                 ->multitoken()
+                 ->value_name("<address> ..."),
+             "local addresses of the network interfaces to distribute the "
+             "input channels on, preferring the NUMA node of the input "
+             "buffer (LibFabric only, default: the host of each input)");
+  config_add("libfabric-remote-cq-data",
+             po::value<bool>(&libfabric_remote_cq_data_)->default_value(false),
+             "notify the compute nodes of written timeslice components "
+             "through remote CQ data of the data writes, if supported by the "
+             "provider (LibFabric only)");
+  config_add("libfabric-provider",
+             po::value<std::string>(&libfabric_provider_)
+                 ->default_value("auto")
+                 ->value_name("<name>"),
+             "the Libfabric provider to use (psm2, verbs, verbs-rxm, gni, "
+             "gni-rdm, sockets, sockets-rdm; auto: the first one available "
+             "in this order) (LibFabric only)");
 
   po::options_description cmdline_options("Allowed options");
   cmdline_options.add(generic).add(config);
@@ -205,6 +598,15 @@ void Parameters::parse_options(int argc, char* argv[]) {
     exit(EXIT_SUCCESS);
   }
 
+  if (vm.count("log-async") != 0u) {
+    if (log_async == "drop") {
+      logging::set_async(log_queue_size, logging::overflow_policy::drop);
+    } else if (log_async == "block") {
+      logging::set_async(log_queue_size, logging::overflow_policy::block);
+    } else {
+      throw ParametersException("invalid log-async policy: " + log_async);
+    }
+  }
   logging::add_console(static_cast<severity_level>(log_level));
   if (vm.count("log-file") != 0u) {
     L_(info) << "logging output to " << log_file;
@@ -218,11 +620,44 @@ void Parameters::parse_options(int argc, char* argv[]) {
     logging::add_syslog(logging::syslog::local0,
                         static_cast<severity_level>(log_syslog));
   }
+  if (!trace_file.empty()) {
+    tracing::trigger_on_signal(SIGUSR1, trace_file,
+                               std::chrono::milliseconds(trace_window));
+    L_(info) << "timeline trace on SIGUSR1 to " << trace_file;
+  }
 
   if (timeslice_size_ < 1) {
     throw ParametersException("timeslice size cannot be zero");
   }
 
+  if (!timeslice_size_changes_.empty()) {
+    try {
+      (void)timeslice_schedule();
+    } catch (std::invalid_argument& e) {
+      throw ParametersException(e.what());
+    }
+    if (transport_ != Transport::RDMA) {
+      throw ParametersException(
+          "timeslice size changes require the RDMA transport");
+    }
+  }
+
+  if (timeslice_bytes_ != 0) {
+    if (transport_ != Transport::RDMA ||
+        placement_policy_ != PlacementPolicy::Credit) {
+      throw ParametersException("adaptive timeslice size requires the RDMA "
+                                "transport and Credit placement");
+    }
+    if (!timeslice_size_changes_.empty()) {
+      throw ParametersException("adaptive timeslice size cannot be combined "
+                                "with timeslice size changes");
+    }
+  }
+
+  if (!status_endpoint_.empty() && status_interval_ == 0) {
+    throw ParametersException("status interval cannot be zero");
+  }
+
 #ifndef HAVE_RDMA
   if (transport_ == Transport::RDMA) {
     throw ParametersException("flesnet built without RDMA support");
@@ -252,6 +687,12 @@ void Parameters::parse_options(int argc, char* argv[]) {
       throw ParametersException("invalid input specification: " +
                                 input.full_uri);
     }
+    if (input.param.count("datasize") != 0u &&
+        input.param.at("datasize") == "auto" && input.scheme != "pgen") {
+      throw ParametersException("automatic buffer size requires a pattern "
+                                "generator input: " +
+                                input.full_uri);
+    }
   }
 
   for (auto& output : outputs_) {
@@ -261,6 +702,129 @@ void Parameters::parse_options(int argc, char* argv[]) {
       throw ParametersException("invalid output specification: " +
                                 output.full_uri);
     }
+    // the ZeroMQ and Local transports copy the timeslice data on the host
+    if (output.param.count("gpu") != 0u &&
+        (transport_ == Transport::ZeroMQ || transport_ == Transport::Local)) {
+      throw ParametersException("timeslice buffer in GPU memory not "
+                                "supported with host copying transport: " +
+                                output.full_uri);
+    }
+    if (output.param.count("datasize") != 0u &&
+        output.param.at("datasize") == "auto" &&
+        output.param.count("gpu") != 0u) {
+      throw ParametersException("automatic buffer size requires the "
+                                "timeslice buffer in host memory: " +
+                                output.full_uri);
+    }
+    if (output.param.count("crccheck") != 0u &&
+        output.param.count("gpu") != 0u) {
+      throw ParametersException("CRC validation not supported with timeslice "
+                                "buffer in GPU memory: " +
+                                output.full_uri);
+    }
+    // remote consumers read the timeslice data asynchronously
+    if (output.param.count("remote") != 0u &&
+        (output.param.count("gpu") != 0u ||
+         output.param.count("evict") != 0u)) {
+      throw ParametersException("remote consumers require the timeslice "
+                                "buffer in host memory without eviction: " +
+                                output.full_uri);
+    }
+    if (output.param.count("evict") != 0u &&
+        (output.param.count("overflowsize") == 0u ||
+         output.param.count("gpu") != 0u)) {
+      throw ParametersException("eviction requires an overflow region and "
+                                "the timeslice buffer in host memory: " +
+                                output.full_uri);
+    }
+  }
+
+  if (connect_quorum_ != 0 &&
+      placement_policy_ != PlacementPolicy::RoundRobin) {
+    throw ParametersException(
+        "connect quorum requires the RoundRobin placement policy");
+  }
+
+  if (placement_policy_ == PlacementPolicy::Credit &&
+      placement_epoch_ < outputs_.size()) {
+    throw ParametersException(
+        "placement epoch cannot be smaller than the number of outputs");
+  }
+
+  try {
+    auto level = zeromq_compression_config_.level;
+    auto threads = zeromq_compression_config_.threads;
+    zeromq_compression_config_ =
+        WireCompressionConfig::parse(zeromq_compression_);
+    zeromq_compression_config_.level = level;
+    zeromq_compression_config_.threads = threads;
+  } catch (std::invalid_argument& e) {
+    throw ParametersException(e.what());
+  }
+  if (zeromq_zerocopy_ &&
+      (transport_ != Transport::ZeroMQ || !zeromq_raw_data_)) {
+    throw ParametersException(
+        "zero-copy sends require the ZeroMQ transport in raw data mode");
+  }
+
+  if (zeromq_compression_config_.enabled()) {
+    if (transport_ != Transport::ZeroMQ || zeromq_raw_data_) {
+      throw ParametersException("compression requires the ZeroMQ transport "
+                                "without raw data channel");
+    }
+    if (!wire_compression_supported()) {
+      throw ParametersException("flesnet built without zstd support");
+    }
+  }
+
+  if (buffer_auto_memory_ == 0 || buffer_auto_memory_ > 100) {
+    throw ParametersException(
+        "buffer auto memory share must be between 1 and 100 percent");
+  }
+
+  if (rdma_stripes_ == 0) {
+    throw ParametersException("number of RDMA stripes cannot be zero");
+  }
+
+  if (rdma_pull_reads_ != 0 && rdma_stripes_ > 1) {
+    throw ParametersException("RDMA pull reads cannot be used with stripes");
+  }
+
+  if (rdma_lookahead_ != 0 && timeslice_bytes_ != 0) {
+    throw ParametersException(
+        "RDMA lookahead cannot be used with adaptive timeslice size");
+  }
+
+  if (rdma_control_qp_ && rdma_stripes_ < 2) {
+    throw ParametersException(
+        "a control queue pair requires at least two RDMA stripes");
+  }
+
+  if (rdma_control_tos_ > 255) {
+    throw ParametersException("type of service must be less than 256");
+  }
+
+  if (rdma_pacing_rate_ != "none" && rdma_pacing_rate_ != "auto") {
+    std::size_t pos = 0;
+    double rate = 0.0;
+    try {
+      rate = std::stod(rdma_pacing_rate_, &pos);
+    } catch (const std::exception&) {
+      pos = 0;
+    }
+    if (pos == 0 || pos != rdma_pacing_rate_.size() || !(rate > 0.0)) {
+      throw ParametersException("invalid RDMA pacing rate: " +
+                                rdma_pacing_rate_);
+    }
+  }
+
+  if (rdma_pacing_burst_ == 0) {
+    throw ParametersException("RDMA pacing burst size cannot be zero");
+  }
+
+  if (completion_wait_ != 0 && transport_threads_ != 0) {
+    throw ParametersException(
+        "completion wait cannot be used with shared transport threads");
   }
 
   if (vm.count("input-index") != 0u) {
@@ -292,10 +856,53 @@ void Parameters::parse_options(int argc, char* argv[]) {
     }
   }
 
+  if (process_ >= 0) {
+    auto process = static_cast<size_t>(process_);
+    if (process >= input_indexes_.size() + output_indexes_.size()) {
+      throw ParametersException("process (" + std::to_string(process_) +
+                                ") out of range");
+    }
+    if (process < input_indexes_.size()) {
+      input_indexes_ = {input_indexes_.at(process)};
+      output_indexes_.clear();
+    } else {
+      output_indexes_ = {output_indexes_.at(process - input_indexes_.size())};
+      input_indexes_.clear();
+    }
+  }
+
+  if (transport_ == Transport::Local && (!local_only() || processes() != 0)) {
+    throw ParametersException(
+        "Local transport requires all inputs and outputs in this process");
+  }
+
+  if (dry_run_) {
+    if (dry_run_rate_ < 0.0 || dry_run_processing_time_ < 0.0) {
+      throw ParametersException("dry run rate and processing time cannot be "
+                                "negative");
+    }
+    for (const auto& input : inputs_) {
+      if (input.scheme != "pgen" && dry_run_microslice_size_ == 0) {
+        throw ParametersException("dry run requires the microslice size of "
+                                  "input: " +
+                                  input.full_uri);
+      }
+    }
+  }
+
   if (!outputs_.empty() && processor_executable_.empty()) {
     throw ParametersException("processor executable not specified");
   }
 
+  if (processor_instances_max_ != 0 &&
+      (processor_instances_ == 0 ||
+       processor_instances_max_ < processor_instances_ ||
+       processor_scale_interval_ == 0)) {
+    throw ParametersException(
+        "autoscaling requires 0 < processor-instances <= "
+        "processor-instances-max and a non-zero scale interval");
+  }
+
   L_(debug) << "inputs (" << inputs_.size() << "):";
   for (auto input : inputs_) {
     L_(debug) << "  " << input.full_uri;
@@ -315,7 +922,8 @@ void Parameters::parse_options(int argc, char* argv[]) {
 
   for (auto input_index : input_indexes_) {
     if (input_index == 0) {
-      L_(info) << "timeslice size: " << timeslice_size_ << " microslices";
+      L_(info) << "timeslice size: " << timeslice_schedule().description()
+               << " microslices";
       L_(info) << "number of timeslices: " << max_timeslice_number_;
     }
   }
@@ -1,7 +1,13 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "CompletionWait.hpp"
+#include "TimeslicePlacement.hpp"
+#include "TimesliceSchedule.hpp"
+#include "WireCompression.hpp"
+#include <chrono>
 #include <map>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -26,11 +32,24 @@ struct InterfaceSpecification {
 };
 
 /// Transport implementation enum.
-enum class Transport { RDMA, LibFabric, ZeroMQ };
+/** The Local transport copies the timeslice components directly between the
+    buffers of inputs and outputs running in the same process. */
+enum class Transport { RDMA, LibFabric, ZeroMQ, Local };
 
 std::istream& operator>>(std::istream& in, Transport& transport);
 std::ostream& operator<<(std::ostream& out, const Transport& transport);
 
+/// Thread placement policy enum.
+/** With the NUMA policy, each sender, builder and distributor thread is run
+    on the NUMA node of its buffer memory or network device. */
+enum class ThreadPlacement { None, NUMA };
+
+std::istream& operator>>(std::istream& in, ThreadPlacement& placement);
+std::ostream& operator<<(std::ostream& out, const ThreadPlacement& placement);
+
+std::istream& operator>>(std::istream& in, PlacementPolicy& policy);
+std::ostream& operator<<(std::ostream& out, const PlacementPolicy& policy);
+
 /// Global run parameter class.
 /** A Parameters object stores the information given on the command
     line or in a configuration file. */
@@ -48,6 +67,21 @@ public:
   /// Retrieve the global timeslice size in number of microslices.
   [[nodiscard]] uint32_t timeslice_size() const { return timeslice_size_; }
 
+  /// Retrieve the target size of a timeslice in bytes for adapting the
+  /// timeslice size (RDMA with Credit placement only, 0: fixed size).
+  [[nodiscard]] uint64_t timeslice_bytes() const { return timeslice_bytes_; }
+
+  /// Retrieve the maximum adapted timeslice size in number of microslices.
+  [[nodiscard]] uint32_t max_timeslice_size() const {
+    return max_timeslice_size_ != 0 ? max_timeslice_size_
+                                    : 8 * timeslice_size_;
+  }
+
+  /// Retrieve the timeslice sizes including their scheduled changes.
+  [[nodiscard]] TimesliceSchedule timeslice_schedule() const {
+    return TimesliceSchedule::parse(timeslice_size_, timeslice_size_changes_);
+  }
+
   /// Retrieve the global maximum timeslice number.
   [[nodiscard]] uint32_t max_timeslice_number() const {
     return max_timeslice_number_;
@@ -63,12 +97,163 @@ public:
     return processor_instances_;
   }
 
+  /// Retrieve the maximum number of autoscaled processor instances (0: no
+  /// autoscaling).
+  [[nodiscard]] uint32_t processor_instances_max() const {
+    return processor_instances_max_;
+  }
+
+  /// Retrieve the interval of the backlog samples for autoscaling.
+  [[nodiscard]] std::chrono::milliseconds processor_scale_interval() const {
+    return std::chrono::milliseconds(processor_scale_interval_);
+  }
+
   /// Retrieve the global base port.
   [[nodiscard]] uint32_t base_port() const { return base_port_; }
 
   /// Retrieve the selected transport implementation.
   [[nodiscard]] Transport transport() const { return transport_; }
 
+  /// Retrieve whether the ZeroMQ transport uses a raw TCP data channel.
+  [[nodiscard]] bool zeromq_raw_data() const { return zeromq_raw_data_; }
+
+  /// Retrieve whether the raw TCP data channel uses zero-copy sends.
+  [[nodiscard]] bool zeromq_zerocopy() const { return zeromq_zerocopy_; }
+
+  /// Retrieve the number of outstanding requests per ZeroMQ connection.
+  [[nodiscard]] uint32_t zeromq_request_window() const {
+    return zeromq_request_window_;
+  }
+
+  /// Retrieve the compression configuration of the ZeroMQ transport.
+  [[nodiscard]] const WireCompressionConfig& zeromq_compression() const {
+    return zeromq_compression_config_;
+  }
+
+  /// Retrieve the timeslice placement policy (RDMA only).
+  [[nodiscard]] PlacementPolicy placement_policy() const {
+    return placement_policy_;
+  }
+
+  /// Retrieve the number of timeslices per placement credit epoch.
+  [[nodiscard]] uint32_t placement_epoch() const { return placement_epoch_; }
+
+  /// Retrieve the thread placement policy.
+  [[nodiscard]] ThreadPlacement thread_placement() const {
+    return thread_placement_;
+  }
+
+  /// Retrieve the interval of signaled timeslice writes (RDMA only).
+  [[nodiscard]] uint32_t rdma_signal_interval() const {
+    return rdma_signal_interval_;
+  }
+
+  /// Retrieve the maximum number of timeslices per post (RDMA only).
+  [[nodiscard]] uint32_t rdma_post_batch() const { return rdma_post_batch_; }
+
+  /// Retrieve the number of queue pairs per connection (RDMA only).
+  [[nodiscard]] uint32_t rdma_stripes() const { return rdma_stripes_; }
+
+  /// Retrieve the type of service of the control-only queue pairs, if the
+  /// primary queue pair is reserved for control traffic (RDMA only).
+  [[nodiscard]] std::optional<uint8_t> rdma_control_tos() const {
+    if (!rdma_control_qp_) {
+      return std::nullopt;
+    }
+    return static_cast<uint8_t>(rdma_control_tos_);
+  }
+
+  /// Retrieve whether to adapt the outstanding writes per connection to
+  /// its completion latency (RDMA only).
+  [[nodiscard]] bool rdma_adaptive_window() const {
+    return rdma_adaptive_window_;
+  }
+
+  /// Retrieve the number of timeslices that may be sent ahead of a blocked
+  /// one to other compute nodes (RDMA only).
+  [[nodiscard]] uint32_t rdma_lookahead() const { return rdma_lookahead_; }
+
+  /// Retrieve the pacing rate of the writes per compute node in bytes per
+  /// second, if paced (RDMA only, 0: the port rate).
+  [[nodiscard]] std::optional<double> rdma_pacing_rate() const {
+    if (rdma_pacing_rate_ == "none") {
+      return std::nullopt;
+    }
+    if (rdma_pacing_rate_ == "auto") {
+      return 0.0;
+    }
+    return std::stod(rdma_pacing_rate_) * 1e6;
+  }
+
+  /// Retrieve the maximum burst size of the paced writes (RDMA only).
+  [[nodiscard]] uint64_t rdma_pacing_burst() const {
+    return rdma_pacing_burst_;
+  }
+
+  /// Retrieve whether to record the per-timeslice lifecycle latencies.
+  [[nodiscard]] bool timeslice_lifecycle() const {
+    return timeslice_lifecycle_;
+  }
+
+  /// Retrieve whether to use a shared receive queue (RDMA only).
+  [[nodiscard]] bool rdma_srq() const { return rdma_srq_; }
+
+  /// Retrieve the number of threads driving the transport workers
+  /// cooperatively (RDMA only, 0: one thread per worker).
+  [[nodiscard]] uint32_t transport_threads() const {
+    return transport_threads_;
+  }
+
+  /// Retrieve the thresholds for blocking an idle sender or builder on its
+  /// completion queue (RDMA and LibFabric, see CompletionWait).
+  [[nodiscard]] CompletionWait::Config completion_wait() const {
+    return {std::chrono::microseconds(completion_spin_),
+            std::chrono::microseconds(completion_wait_)};
+  }
+
+  /// Retrieve the maximum number of components read by a compute node at
+  /// the same time (RDMA only, 0: the input nodes write the data).
+  [[nodiscard]] uint32_t rdma_pull_reads() const { return rdma_pull_reads_; }
+
+  /// Retrieve whether to register buffers with on-demand paging (RDMA only).
+  [[nodiscard]] bool rdma_odp() const { return rdma_odp_; }
+
+  /// Retrieve the number of threads populating buffers before their
+  /// registration (RDMA only, 0: none).
+  [[nodiscard]] uint32_t rdma_register_threads() const {
+    return rdma_register_threads_;
+  }
+
+  /// Retrieve the number of compute nodes to be connected before sending
+  /// (RDMA only, 0: all).
+  [[nodiscard]] uint32_t connect_quorum() const { return connect_quorum_; }
+
+  /// Retrieve the time after which incomplete timeslices are delivered
+  /// without their missing components (RDMA only, 0: never).
+  [[nodiscard]] std::chrono::milliseconds timeslice_deadline() const {
+    return std::chrono::milliseconds(timeslice_deadline_);
+  }
+
+  /// Retrieve the maximum interval between status messages (RDMA only).
+  [[nodiscard]] std::chrono::microseconds rdma_status_interval() const {
+    return std::chrono::microseconds(rdma_status_interval_);
+  }
+
+  /// Retrieve the rate of sampling the buffer fill levels (0: disabled).
+  [[nodiscard]] uint32_t buffer_sample_rate() const {
+    return buffer_sample_rate_;
+  }
+
+  /// Retrieve the endpoint of the status server (empty: disabled).
+  [[nodiscard]] std::string status_endpoint() const {
+    return status_endpoint_;
+  }
+
+  /// Retrieve the update interval of the status server.
+  [[nodiscard]] std::chrono::milliseconds status_interval() const {
+    return std::chrono::milliseconds(status_interval_);
+  }
+
   /// Retrieve the list of participating inputs.
   [[nodiscard]] std::vector<InterfaceSpecification> inputs() const {
     return inputs_;
@@ -89,11 +274,59 @@ public:
     return output_indexes_;
   }
 
+  /// Retrieve the identifier of the shared memory segment to allocate all
+  /// local timeslice buffers from (empty: one segment per buffer).
+  [[nodiscard]] const std::string& timeslice_buffer_pool() const {
+    return timeslice_buffer_pool_;
+  }
+
+  /// Retrieve the share of the available memory of a NUMA node in percent
+  /// for the local buffers with automatic size.
+  [[nodiscard]] uint32_t buffer_auto_memory() const {
+    return buffer_auto_memory_;
+  }
+
+  /// Retrieve the file recording the mean timeslice component sizes of the
+  /// outputs (empty: none).
+  [[nodiscard]] const std::string& buffer_sizing_file() const {
+    return buffer_sizing_file_;
+  }
+
+  /// Retrieve the number of processes to start for the local inputs and
+  /// outputs (0: run them as threads of this process).
+  [[nodiscard]] size_t processes() const {
+    size_t channels = input_indexes_.size() + output_indexes_.size();
+    return processes_ && process_ < 0 && channels > 1 ? channels : 0;
+  }
+
   [[nodiscard]] bool local_only() const {
     return input_indexes_.size() == inputs_.size() &&
            output_indexes_.size() == outputs_.size();
   }
 
+  /// Retrieve the file to write the benchmark report to (empty: none).
+  [[nodiscard]] const std::string& benchmark_report() const {
+    return benchmark_report_;
+  }
+
+  /// Check whether to estimate the capacity of the configuration only.
+  [[nodiscard]] bool dry_run() const { return dry_run_; }
+
+  /// Retrieve the recorded data rate of inputs without a pattern generator
+  /// delay in MB/s (0: unknown).
+  [[nodiscard]] double dry_run_rate() const { return dry_run_rate_; }
+
+  /// Retrieve the mean microslice size of inputs that are not pattern
+  /// generators.
+  [[nodiscard]] uint32_t dry_run_microslice_size() const {
+    return dry_run_microslice_size_;
+  }
+
+  /// Retrieve the processing time of a timeslice by one processor instance.
+  [[nodiscard]] double dry_run_processing_time() const {
+    return dry_run_processing_time_;
+  }
+
   /// flag to check whether to drop timeslice processing
   [[nodiscard]] bool drop_process_ts() const { return drop_process_ts_; }
 
@@ -125,6 +358,11 @@ public:
     return scheduler_speedup_interval_count_;
   }
 
+  /// Retrieve the weight of new round durations in the scheduler model
+  [[nodiscard]] uint32_t scheduler_ewma_weight() const {
+    return scheduler_ewma_weight_;
+  }
+
   /// Retrieve the directory to store DFS log files
   [[nodiscard]] std::string scheduler_log_directory() const {
     return scheduler_log_directory_;
@@ -135,6 +373,33 @@ public:
     return scheduler_enable_logging_;
   }
 
+  /// Check whether to stagger the scheduler rounds across compute nodes
+  [[nodiscard]] bool scheduler_staggered_rounds() const {
+    return scheduler_staggered_rounds_;
+  }
+
+  /// Retrieve the modulo of the timeslices replicated to a hot-standby
+  /// compute node (0: no replication)
+  [[nodiscard]] uint32_t scheduler_replication_modulo() const {
+    return scheduler_replication_modulo_;
+  }
+
+  /// Retrieve whether to send remote CQ data with the last data write of
+  /// each timeslice component.
+  [[nodiscard]] bool libfabric_remote_cq_data() const {
+    return libfabric_remote_cq_data_;
+  }
+
+  /// Retrieve the name of the Libfabric provider to use.
+  [[nodiscard]] const std::string& libfabric_provider() const {
+    return libfabric_provider_;
+  }
+
+  /// Retrieve the local addresses of the input network rails.
+  [[nodiscard]] const std::vector<std::string>& libfabric_rails() const {
+    return libfabric_rails_;
+  }
+
 private:
   /// Parse command line options.
   void parse_options(int argc, char* argv[]);
@@ -144,6 +409,15 @@ private:
   /// The global timeslice size in number of microslices.
   uint32_t timeslice_size_ = 100;
 
+  /// The scheduled changes of the timeslice size ("<ts>:<size>,...").
+  std::string timeslice_size_changes_;
+
+  /// The target size of a timeslice in bytes (0: fixed size).
+  uint64_t timeslice_bytes_ = 0;
+
+  /// The maximum adapted timeslice size (0: eight times the initial size).
+  uint32_t max_timeslice_size_ = 0;
+
   /// The global maximum timeslice number.
   uint32_t max_timeslice_number_ = UINT32_MAX;
 
@@ -153,12 +427,111 @@ private:
   /// The number of instances of the timeslice processor executable.
   uint32_t processor_instances_ = 1;
 
+  /// The maximum number of autoscaled processor instances.
+  uint32_t processor_instances_max_ = 0;
+
+  /// The interval of the backlog samples for autoscaling in milliseconds.
+  uint32_t processor_scale_interval_ = 1000;
+
   /// The global base port.
   uint32_t base_port_ = 20079;
 
   /// The selected transport implementation.
   Transport transport_ = Transport::RDMA;
 
+  /// Use a raw TCP data channel with the ZeroMQ transport.
+  bool zeromq_raw_data_ = false;
+
+  /// Use zero-copy sends on the raw TCP data channel.
+  bool zeromq_zerocopy_ = false;
+
+  /// The number of outstanding requests per ZeroMQ connection.
+  uint32_t zeromq_request_window_ = 1;
+
+  /// The subsystems whose data is compressed by the ZeroMQ transport.
+  std::string zeromq_compression_ = "none";
+
+  /// The compression configuration of the ZeroMQ transport.
+  WireCompressionConfig zeromq_compression_config_;
+
+  /// The timeslice placement policy.
+  PlacementPolicy placement_policy_ = PlacementPolicy::RoundRobin;
+
+  /// The number of timeslices per placement credit epoch.
+  uint32_t placement_epoch_ = 64;
+
+  /// The thread placement policy.
+  ThreadPlacement thread_placement_ = ThreadPlacement::None;
+
+  /// The interval of signaled timeslice writes.
+  uint32_t rdma_signal_interval_ = 1;
+
+  /// The maximum number of timeslices posted with a single call.
+  uint32_t rdma_post_batch_ = 1;
+
+  /// The number of queue pairs per connection.
+  uint32_t rdma_stripes_ = 1;
+
+  /// Whether to reserve the primary queue pair for control traffic.
+  bool rdma_control_qp_ = false;
+
+  /// The type of service of the control queue pairs.
+  uint32_t rdma_control_tos_ = 0;
+
+  /// Whether to adapt the outstanding writes per connection.
+  bool rdma_adaptive_window_ = false;
+
+  /// The number of timeslices that may be sent ahead of a blocked one.
+  uint32_t rdma_lookahead_ = 0;
+
+  /// The pacing rate of the writes per compute node ("none", "auto", MB/s).
+  std::string rdma_pacing_rate_ = "none";
+
+  /// The maximum burst size of the paced writes.
+  uint64_t rdma_pacing_burst_ = 1 << 20;
+
+  /// Whether to record the per-timeslice lifecycle latencies.
+  bool timeslice_lifecycle_ = false;
+
+  /// Whether to use a shared receive queue on compute nodes.
+  bool rdma_srq_ = false;
+
+  /// The maximum number of components read by a compute node at once.
+  uint32_t rdma_pull_reads_ = 0;
+
+  /// Whether to register buffers with on-demand paging.
+  bool rdma_odp_ = false;
+
+  /// The number of threads populating buffers before their registration.
+  uint32_t rdma_register_threads_ = 0;
+
+  /// The number of compute nodes to be connected before sending.
+  uint32_t connect_quorum_ = 0;
+
+  /// The time (in ms) after which incomplete timeslices are delivered.
+  uint32_t timeslice_deadline_ = 0;
+
+  /// The number of threads driving the transport workers cooperatively.
+  uint32_t transport_threads_ = 0;
+
+  /// The maximum time (in us) an idle transport worker blocks (0: never).
+  uint32_t completion_wait_ = 0;
+
+  /// The time (in us) an idle transport worker busy polls before blocking.
+  uint32_t completion_spin_ = 1000;
+
+  /// The maximum interval between status messages in microseconds.
+  uint32_t rdma_status_interval_ = 0;
+
+  /// The rate of sampling the buffer fill levels in Hz.
+  uint32_t buffer_sample_rate_ = 0;
+
+  /// The endpoint of the status server.
+  std::string status_endpoint_;
+
+  /// The update interval of the status server in milliseconds.
+  uint32_t status_interval_ = 250;
+
   /// The list of participating inputs.
   std::vector<InterfaceSpecification> inputs_;
 
@@ -171,6 +544,37 @@ private:
   /// This applications's indexes in the list of outputs.
   std::vector<unsigned> output_indexes_;
 
+  /// The shared memory segment of the local timeslice buffers (if any).
+  std::string timeslice_buffer_pool_;
+
+  /// The share of the available memory for buffers with automatic size.
+  uint32_t buffer_auto_memory_ = 50;
+
+  /// The file recording the mean component sizes of the outputs.
+  std::string buffer_sizing_file_;
+
+  /// Whether to run each local input and output in a separate process.
+  bool processes_ = false;
+
+  /// The local input or output to run in this process (-1: all).
+  int process_ = -1;
+
+  /// The file to write the benchmark report to.
+  std::string benchmark_report_;
+
+  /// Whether to estimate the capacity of the configuration only.
+  bool dry_run_ = false;
+
+  /// The recorded data rate of inputs without a pattern generator delay
+  /// in MB/s (0: unknown).
+  double dry_run_rate_ = 0.0;
+
+  /// The mean microslice size of inputs that are not pattern generators.
+  uint32_t dry_run_microslice_size_ = 0;
+
+  /// The processing time of a timeslice by one processor instance in ms.
+  double dry_run_processing_time_ = 0.0;
+
   /// flag to check whether to drop timeslice processing
   bool drop_process_ts_ = false;
 
@@ -190,8 +594,26 @@ private:
   /// The speeding up interval count of the scheduler
   uint32_t scheduler_speedup_interval_count_{};
 
+  /// The weight in percent of new round durations in the scheduler model
+  uint32_t scheduler_ewma_weight_{};
+
   /// The directory to store the log files
   std::string scheduler_log_directory_;
 
   bool scheduler_enable_logging_ = false;
+
+  /// Whether to stagger the scheduler rounds across compute nodes
+  bool scheduler_staggered_rounds_ = false;
+
+  /// The modulo of the timeslices replicated to a hot-standby compute node
+  uint32_t scheduler_replication_modulo_ = 0;
+
+  /// The local addresses of the input network rails (LibFabric only).
+  std::vector<std::string> libfabric_rails_;
+
+  /// Whether to notify compute nodes through remote CQ data (LibFabric only).
+  bool libfabric_remote_cq_data_ = false;
+
+  /// The name of the Libfabric provider to use (LibFabric only).
+  std::string libfabric_provider_ = "auto";
 };
@@ -13,9 +13,14 @@
  */
 
 #include "Application.hpp"
+#include "CapacityEstimate.hpp"
+#include "ChildProcessManager.hpp"
 #include "Parameters.hpp"
 #include "log.hpp"
+#include <chrono>
 #include <csignal>
+#include <string>
+#include <thread>
 
 namespace {
 volatile sig_atomic_t signal_status = 0;
@@ -23,12 +28,49 @@ volatile sig_atomic_t signal_status = 0;
 
 static void signal_handler(int sig) { signal_status = sig; }
 
+// Run each local input and output in a separate flesnet process. The
+// processes share nothing but the command line.
+static int run_processes(const Parameters& par, int argc, char* argv[]) {
+  ChildProcessManager& manager = ChildProcessManager::get();
+  for (size_t p = 0; p < par.processes(); ++p) {
+    ChildProcess cp = ChildProcess();
+    cp.path = "/proc/self/exe";
+    cp.arg.assign(argv, argv + argc);
+    cp.arg.push_back("--process=" + std::to_string(p));
+    if (!manager.start_process(cp)) {
+      manager.stop_all_processes();
+      return EXIT_FAILURE;
+    }
+  }
+  manager.allow_stop_processes(nullptr);
+  L_(info) << "started " << par.processes() << " processes";
+
+  bool stopping = false;
+  while (manager.running(nullptr)) {
+    // a failed process stops the others, as a single process would exit
+    if ((signal_status != 0 || manager.failed(nullptr)) && !stopping) {
+      manager.stop_all_processes();
+      stopping = true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  return manager.failed(nullptr) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
 int main(int argc, char* argv[]) {
   std::signal(SIGINT, signal_handler);
   std::signal(SIGTERM, signal_handler);
 
   try {
     Parameters par(argc, argv);
+    if (par.dry_run()) {
+      CapacityEstimate estimate(par);
+      estimate.log_report();
+      return estimate.sufficient() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (par.processes() > 0) {
+      return run_processes(par, argc, argv);
+    }
     Application app(par, &signal_status);
     app.run();
   } catch (std::exception const& e) {
@@ -1,13 +1,18 @@
 // Copyright 2015 Dirk Hutter
 
 #include "DualRingBuffer.hpp"
+#include "Histogram.hpp"
+#include "Monitor.hpp"
+#include "System.hpp"
 #include "shm_channel_client.hpp"
 #include "shm_device_client.hpp"
+#include <boost/program_options.hpp>
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <iomanip>
 #include <iostream>
-#include <numeric>
+#include <memory>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -15,251 +20,409 @@
 using namespace std;
 using namespace std::chrono;
 
+namespace po = boost::program_options;
+
+/**
+ * Throughput and latency probe of the channels of a shared memory device.
+ *
+ * All new microslices of the selected channels are consumed at once. Per
+ * integration window, the data rates, the microslice frequency and size,
+ * and the jitter of the microslice availability are reported for each
+ * channel. The availability delay of a microslice is its arrival time (on
+ * the system clock) minus its descriptor index, which is its start time in
+ * ns. As the clocks are not synchronized, the jitter is the delay relative
+ * to the smallest one in the window. Its resolution is limited by the poll
+ * mode: "sleep" polls at a fixed interval, "adaptive" polls continuously
+ * while data arrives and backs off up to the sleep time when idle, and
+ * "busy" polls continuously.
+ */
+
 namespace {
 volatile std::sig_atomic_t signal_status = 0;
-}
+
+enum class PollMode { Sleep, Adaptive, Busy };
+enum class OutputFormat { Text, Csv, Json };
+
+struct Options {
+  std::string input_shm = "flib_shared_memory";
+  std::vector<size_t> channels; // empty: all
+  PollMode poll = PollMode::Sleep;
+  microseconds sleep_time{1000};
+  duration<double> integration_time{1.0};
+  size_t num_measurements = 0; // 0: infinite run
+  OutputFormat format = OutputFormat::Text;
+  std::string monitor_uri;
+};
+
+/// Measurements of one channel in the current integration window.
+struct ChannelProbe {
+  std::unique_ptr<InputBufferReadInterface> source;
+  size_t index = 0;
+  DualIndex start{};
+  DualIndex read{};
+  DualIndex read_cached{};
+  size_t acc_payload = 0;
+  size_t acc_payload_cached = 0;
+  /// Availability delays in the window (ns, arbitrary offset).
+  std::vector<int64_t> delays;
+  /// Availability jitter over the run (ns).
+  cbm::Histogram jitter;
+};
+
+/// Rates and jitter of a channel in a window.
+struct WindowResult {
+  double t_total = 0;    // MB/s
+  double t_data = 0;     // MB/s
+  double t_payload = 0;  // MB/s
+  double t_desc = 0;     // MB/s
+  double f_desc = 0;     // kHz
+  double s_ms = 0;       // kB
+  double jitter_p50 = 0; // us
+  double jitter_p99 = 0; // us
+  double jitter_max = 0; // us
+};
+} // namespace
 
 static void signal_handler(int sig) { signal_status = sig; }
 
-int main(int argc, char* argv[]) {
-  try {
+static Options parse_options(int argc, char* argv[]) {
+  Options opt;
+  std::vector<std::string> channel_list;
+  std::string poll = "sleep";
+  std::string format = "text";
+  double sleep_us = 1000;
+  double interval = 1.0;
+
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("input-shm,I",
+           po::value<std::string>(&opt.input_shm)
+               ->default_value(opt.input_shm)
+               ->value_name("<id>"),
+           "name of the shared memory to read from");
+  desc_add("channels,c",
+           po::value<std::vector<std::string>>(&channel_list)
+               ->multitoken()
+               ->value_name("<n> ..."),
+           "read the given channels (default: all)");
+  desc_add("poll,p",
+           po::value<std::string>(&poll)->default_value(poll)->value_name(
+               "sleep|adaptive|busy"),
+           "poll mode: at a fixed interval, continuously while data arrives, "
+           "or continuously");
+  desc_add("sleep",
+           po::value<double>(&sleep_us)
+               ->default_value(sleep_us)
+               ->value_name("<us>"),
+           "sleep time between polls (maximum in adaptive mode)");
+  desc_add("interval,t",
+           po::value<double>(&interval)
+               ->default_value(interval)
+               ->value_name("<s>"),
+           "integration window of the measurements");
+  desc_add("measurements,n",
+           po::value<size_t>(&opt.num_measurements)->value_name("<n>"),
+           "stop after the given number of measurements (default: infinite)");
+  desc_add("format,f",
+           po::value<std::string>(&format)->default_value(format)->value_name(
+               "text|csv|json"),
+           "output format");
+  desc_add("monitor,m",
+           po::value<std::string>(&opt.monitor_uri)
+               ->value_name("<uri>")
+               ->implicit_value("influx1:login:8086:msconsumer_status"),
+           "publish the measurements to InfluxDB (or \"file:cout\" for "
+           "console output)");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.count("help") != 0u) {
+    cout << "Measures the throughput and microslice availability jitter of "
+            "the channels\nof a shared memory device.\n\n"
+         << desc << endl;
+    exit(EXIT_SUCCESS);
+  }
 
-    // some const config variables
-    std::string input_shm = "flib_shared_memory";
-    // number of measurements, set to 0 for infinit run
-    constexpr size_t num_measurements = 0;
-    constexpr auto integration_time = seconds(1);
-    constexpr auto sleep_time = milliseconds(1);
-    constexpr bool analyze = true;
-    constexpr bool human_readable = true;
-
-    std::stringstream help;
-    help << "Usage:\n"
-         << argv[0] << "            read all channels\n"
-         << argv[0] << " <num>      read <num> channels\n"
-         << argv[0] << " ch <idx>   read channel <idx>";
-
-    bool mult_channels = true;
-    size_t num_channels = 0;
-    size_t channel_index = 0;
-
-    if (argc == 2) {
-      num_channels = atoi(argv[1]);
-      if (human_readable) {
-        cout << "Using " << num_channels << " channel(s)" << endl;
-      }
-    } else if (argc == 3) {
-      if (std::string(argv[1]) == "ch") {
-        mult_channels = false;
-        channel_index = atoi(argv[2]);
-        if (human_readable) {
-          cout << "Using channel " << channel_index << endl;
-        }
-      } else {
-        cerr << help.str() << endl;
-        return EXIT_FAILURE;
-      }
-    } else if (argc > 3) {
-      cerr << help.str() << endl;
-      return EXIT_FAILURE;
+  for (const auto& channel : channel_list) {
+    opt.channels.push_back(std::stoul(channel));
+  }
+  if (poll == "sleep") {
+    opt.poll = PollMode::Sleep;
+  } else if (poll == "adaptive") {
+    opt.poll = PollMode::Adaptive;
+  } else if (poll == "busy") {
+    opt.poll = PollMode::Busy;
+  } else {
+    throw std::invalid_argument("invalid poll mode: " + poll);
+  }
+  if (format == "text") {
+    opt.format = OutputFormat::Text;
+  } else if (format == "csv") {
+    opt.format = OutputFormat::Csv;
+  } else if (format == "json") {
+    opt.format = OutputFormat::Json;
+  } else {
+    throw std::invalid_argument("invalid output format: " + format);
+  }
+  if (sleep_us < 0 || interval <= 0) {
+    throw std::invalid_argument("sleep time and interval must be positive");
+  }
+  opt.sleep_time = microseconds(static_cast<int64_t>(sleep_us));
+  opt.integration_time = duration<double>(interval);
+  return opt;
+}
+
+/// Consume the new microslices of a channel, return whether there were any.
+static bool poll_channel(ChannelProbe& ch, int64_t now_ns) {
+  auto batch = ch.source->acquire(ch.read, UINT64_MAX);
+  if (batch.empty()) {
+    return false;
+  }
+  for (const auto& span : batch.desc) {
+    for (std::size_t i = 0; i < span.size; ++i) {
+      ch.acc_payload += span.ptr[i].size;
+      ch.delays.push_back(now_ns - static_cast<int64_t>(span.ptr[i].idx));
     }
+  }
+  ch.read = batch.end;
+  ch.source->release(batch);
+  return true;
+}
 
-    std::signal(SIGINT, signal_handler);
-    std::signal(SIGTERM, signal_handler);
+/// Evaluate and reset the window of a channel.
+static WindowResult evaluate(ChannelProbe& ch, duration<double> delta) {
+  WindowResult r;
+  auto index_delta = ch.read - ch.read_cached;
+  auto payload_delta = ch.acc_payload - ch.acc_payload_cached;
 
-    std::vector<std::unique_ptr<InputBufferReadInterface>> data_sources;
-    std::shared_ptr<flib_shm_device_client> shm_device;
+  r.t_total = (index_delta.data +
+               index_delta.desc * sizeof(fles::MicrosliceDescriptor)) /
+              delta.count() / 1000000.;
+  r.t_data = index_delta.data / delta.count() / 1000000.;
+  r.t_payload = payload_delta / delta.count() / 1000000.;
+  r.t_desc = index_delta.desc * sizeof(fles::MicrosliceDescriptor) /
+             delta.count() / 1000000.;
+  r.f_desc = index_delta.desc / delta.count() / 1000.;
+  r.s_ms = index_delta.desc > 0
+               ? static_cast<double>(index_delta.data) / index_delta.desc /
+                     1000.
+               : 0;
+
+  if (!ch.delays.empty()) {
+    int64_t min_delay = *std::min_element(ch.delays.begin(), ch.delays.end());
+    cbm::Histogram window;
+    for (int64_t delay : ch.delays) {
+      window.Record(static_cast<uint64_t>(delay - min_delay));
+    }
+    ch.jitter.Merge(window);
+    r.jitter_p50 = static_cast<double>(window.Percentile(50)) / 1000.;
+    r.jitter_p99 = static_cast<double>(window.Percentile(99)) / 1000.;
+    r.jitter_max = static_cast<double>(window.Max()) / 1000.;
+    ch.delays.clear();
+  }
 
-    shm_device = std::make_shared<flib_shm_device_client>(input_shm);
+  ch.read_cached = ch.read;
+  ch.acc_payload_cached = ch.acc_payload;
+  return r;
+}
 
-    if (mult_channels && num_channels == 0) {
-      // set num to all channels
-      num_channels = shm_device->num_channels();
-    }
-    if (num_channels > shm_device->num_channels()) {
-      throw std::runtime_error("too many channels requested");
+static void print_text(std::ostream& os, const std::string& name,
+                       const WindowResult& r) {
+  os << name;
+  os << " Throughput total: " << r.t_total << " MB/s";
+  os << ", data: " << r.t_data << " MB/s";
+  os << ", payload: " << r.t_payload << " MB/s";
+  os << ", desc: " << r.t_desc << " MB/s";
+  os << " Freq. desc: " << r.f_desc << " kHz";
+  os << " Avg. ms size: " << r.s_ms << " kB";
+  os << " Jitter p50/p99/max: " << r.jitter_p50 << "/" << r.jitter_p99 << "/"
+     << r.jitter_max << " us" << std::endl;
+}
+
+static void print_csv(std::ostream& os, size_t measurement,
+                      const std::string& name, const WindowResult& r) {
+  os << measurement << "," << name << "," << r.t_total << "," << r.t_data
+     << "," << r.t_payload << "," << r.t_desc << "," << r.f_desc << ","
+     << r.s_ms << "," << r.jitter_p50 << "," << r.jitter_p99 << ","
+     << r.jitter_max << std::endl;
+}
+
+static void print_json(std::ostream& os, const WindowResult& r) {
+  os << "{";
+  os << "\"total\": " << r.t_total << ", ";
+  os << "\"data\": " << r.t_data << ", ";
+  os << "\"payload\": " << r.t_payload << ", ";
+  os << "\"desc\": " << r.t_desc << ", ";
+  os << "\"freq_desc\": " << r.f_desc << ", ";
+  os << "\"avg_size\": " << r.s_ms << ", ";
+  os << "\"jitter_p50\": " << r.jitter_p50 << ", ";
+  os << "\"jitter_p99\": " << r.jitter_p99 << ", ";
+  os << "\"jitter_max\": " << r.jitter_max << "}";
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    Options opt = parse_options(argc, argv);
+    const bool human_readable = opt.format == OutputFormat::Text;
+
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    std::unique_ptr<cbm::Monitor> monitor;
+    if (!opt.monitor_uri.empty()) {
+      monitor = std::make_unique<cbm::Monitor>(opt.monitor_uri);
     }
+    const std::string hostname = fles::system::current_hostname();
 
-    if (!mult_channels) {
-      if (channel_index < shm_device->num_channels()) {
-        data_sources.push_back(std::unique_ptr<InputBufferReadInterface>(
-            new flib_shm_channel_client(shm_device, channel_index)));
-      } else {
-        throw std::runtime_error("shared memory channel not available");
-      }
-    } else {
-      for (size_t i = 0; i < num_channels; ++i) {
-        data_sources.push_back(std::unique_ptr<InputBufferReadInterface>(
-            new flib_shm_channel_client(shm_device, i)));
+    auto shm_device = std::make_shared<flib_shm_device_client>(opt.input_shm);
+    if (opt.channels.empty()) {
+      for (size_t i = 0; i < shm_device->num_channels(); ++i) {
+        opt.channels.push_back(i);
       }
     }
 
-    std::vector<DualIndex> write_indexs;
-    std::vector<DualIndex> read_indexs;
-    std::vector<DualIndex> read_indexs_cached;
-    std::vector<DualIndex> start_indexs;
-    std::vector<size_t> acc_payloads(data_sources.size(), 0);
-    std::vector<size_t> acc_payloads_cached(data_sources.size(), 0);
-
-    for (auto& data_source : data_sources) {
-      // initialize indices
-      write_indexs.push_back(data_source->get_write_index());
-      read_indexs.push_back(data_source->get_read_index());
-      read_indexs_cached.push_back(read_indexs.back());
-      start_indexs.push_back(read_indexs.back());
+    std::vector<ChannelProbe> channels;
+    for (size_t index : opt.channels) {
+      if (index >= shm_device->num_channels()) {
+        throw std::runtime_error("shared memory channel " +
+                                 std::to_string(index) + " not available");
+      }
+      ChannelProbe ch;
+      ch.index = index;
+      ch.source = std::make_unique<flib_shm_channel_client>(shm_device, index);
+      ch.read = ch.source->get_read_index();
+      ch.read_cached = ch.read;
+      ch.start = ch.read;
       if (human_readable) {
-        std::cout << "Channel " << start_indexs.size() - 1
-                  << " is starting with microslice index: "
-                  << start_indexs.back().desc << std::endl;
+        std::cout << "Channel " << index
+                  << " is starting with microslice index: " << ch.start.desc
+                  << std::endl;
       }
+      channels.push_back(std::move(ch));
     }
 
-    if (!human_readable) {
+    if (opt.format == OutputFormat::Csv) {
+      std::cout << "measurement,channel,total_mbps,data_mbps,payload_mbps,"
+                   "desc_mbps,freq_desc_khz,avg_size_kb,jitter_p50_us,"
+                   "jitter_p99_us,jitter_max_us"
+                << std::endl;
+    } else if (opt.format == OutputFormat::Json) {
       std::cout << "[";
     }
 
     bool running = true;
-    time_point<high_resolution_clock> start;
-    time_point<high_resolution_clock> end;
-    time_point<high_resolution_clock> now;
-
-    std::vector<double> t_total(data_sources.size(), 0);
-    std::vector<double> t_data(data_sources.size(), 0);
-    std::vector<double> t_payload(data_sources.size(), 0);
-    std::vector<double> t_desc(data_sources.size(), 0);
-    std::vector<double> f_desc(data_sources.size(), 0);
-    std::vector<double> s_ms(data_sources.size(), 0);
-
+    auto start = high_resolution_clock::now();
+    auto tp = start;
     size_t measurement = 1;
-    start = high_resolution_clock::now();
-    time_point<high_resolution_clock> tp(start);
+    microseconds backoff{0};
 
     // main loop
     while (signal_status == 0 && running) {
-
-      // channel loop
-      for (size_t i = 0; i < data_sources.size(); ++i) {
-        write_indexs.at(i) = data_sources.at(i)->get_write_index();
-        if (write_indexs.at(i).desc > read_indexs.at(i).desc) {
-          if (analyze) { // loop over ms
-            while (write_indexs.at(i).desc > read_indexs.at(i).desc) {
-              acc_payloads.at(i) += data_sources.at(i)
-                                        ->desc_buffer()
-                                        .at(read_indexs.at(i).desc)
-                                        .size;
-              read_indexs.at(i).desc += 1;
-            }
-          }
-          read_indexs.at(i) = write_indexs.at(i);
-          data_sources.at(i)->set_read_index(read_indexs.at(i));
-        }
-      } // channel loop
+      int64_t now_ns = duration_cast<nanoseconds>(
+                           system_clock::now().time_since_epoch())
+                           .count();
+      bool data = false;
+      for (auto& ch : channels) {
+        data = poll_channel(ch, now_ns) || data;
+      }
 
       // report all channels en block
-      now = high_resolution_clock::now();
-      if (now > (tp + integration_time)) {
-        for (size_t i = 0; i < data_sources.size(); ++i) {
-
-          duration<double> delta = (now - tp);
-          auto index_delta = read_indexs.at(i) - read_indexs_cached.at(i);
-          auto payload_delta = acc_payloads.at(i) - acc_payloads_cached.at(i);
-
-          t_total.at(i) =
-              (index_delta.data +
-               index_delta.desc * sizeof(fles::MicrosliceDescriptor)) /
-              delta.count() / 1000000.;
-          t_data.at(i) = index_delta.data / delta.count() / 1000000.;
-          t_payload.at(i) = payload_delta / delta.count() / 1000000.;
-          t_desc.at(i) = index_delta.desc * sizeof(fles::MicrosliceDescriptor) /
-                         delta.count() / 1000000.;
-          f_desc.at(i) = index_delta.desc / delta.count() / 1000.;
-          s_ms.at(i) =
-              static_cast<double>(index_delta.data) / index_delta.desc / 1000.;
-
-          std::stringstream ss;
-          if (human_readable) {
-            ss << "Channel: " << i;
-            ss << " Throughput total: " << t_total.at(i) << " MB/s";
-            ss << ", data: " << t_data.at(i) << " MB/s";
-            ss << ", payload: " << t_payload.at(i) << " MB/s";
-            ss << ", desc: " << t_desc.at(i) << " MB/s";
-            ss << " Freq. desc: " << f_desc.at(i) << " kHz";
-            ss << " Avg. ms size: " << s_ms.at(i) << " kB" << std::endl;
+      auto now = high_resolution_clock::now();
+      if (now > tp + opt.integration_time) {
+        duration<double> delta = now - tp;
+        WindowResult sum;
+        std::stringstream ss;
+        for (size_t i = 0; i < channels.size(); ++i) {
+          WindowResult r = evaluate(channels[i], delta);
+          std::string name = std::to_string(channels[i].index);
+          if (opt.format == OutputFormat::Text) {
+            print_text(ss, "Channel: " + name, r);
+          } else if (opt.format == OutputFormat::Csv) {
+            print_csv(ss, measurement, name, r);
           } else {
-            if (i == 0) {
-              ss << "{\"Measurement\": " << measurement << ", \"Links\": [";
-            } else {
-              ss << ", ";
-            }
-            ss << "{";
-            ss << "\"total\": " << t_total.at(i) << ", ";
-            ss << "\"data\": " << t_data.at(i) << ", ";
-            ss << "\"payload\": " << t_payload.at(i) << ", ";
-            ss << "\"desc\": " << t_desc.at(i) << ", ";
-            ss << "\"freq_desc\": " << f_desc.at(i) << ", ";
-            ss << "\"avg_size\": " << s_ms.at(i) << "}";
+            ss << (i == 0 ? "{\"Measurement\": " +
+                                std::to_string(measurement) + ", \"Links\": ["
+                          : ", ");
+            print_json(ss, r);
           }
-          std::cout << ss.str();
-          read_indexs_cached.at(i) = read_indexs.at(i);
-          acc_payloads_cached.at(i) = acc_payloads.at(i);
-        } // channel report loop
-
-        if (mult_channels || !human_readable) {
-          // report channel summery
-          double sum_t_total =
-              std::accumulate(t_total.begin(), t_total.end(), 0.0);
-          double sum_t_data =
-              std::accumulate(t_data.begin(), t_data.end(), 0.0);
-          double sum_t_payload =
-              std::accumulate(t_payload.begin(), t_payload.end(), 0.0);
-          double sum_t_desc =
-              std::accumulate(t_desc.begin(), t_desc.end(), 0.0);
-          double avg_f_desc =
-              std::accumulate(f_desc.begin(), f_desc.end(), 0.0) /
-              f_desc.size();
-          double avg_s_ms =
-              std::accumulate(s_ms.begin(), s_ms.end(), 0.0) / s_ms.size();
-
-          std::stringstream ss;
-          if (human_readable) {
-            ss << "Summery:  ";
-            ss << " Throughput total: " << sum_t_total << " MB/s";
-            ss << ", data: " << sum_t_data << " MB/s";
-            ss << ", payload: " << sum_t_payload << " MB/s";
-            ss << ", desc: " << sum_t_desc << " MB/s";
-            ss << " Freq. desc: " << avg_f_desc << " kHz";
-            ss << " Avg. ms size: " << avg_s_ms << " kB" << std::endl;
-          } else {
-            ss << "], \"Sum\": { ";
-            ss << "\"total\": " << sum_t_total << ", ";
-            ss << "\"data\": " << sum_t_data << ", ";
-            ss << "\"payload\": " << sum_t_payload << ", ";
-            ss << "\"desc\": " << sum_t_desc << ", ";
-            ss << "\"freq_desc\": " << avg_f_desc << ", ";
-            ss << "\"avg_size\": " << avg_s_ms << "}}";
+          if (monitor) {
+            monitor->QueueMetric(
+                "msconsumer_status",
+                {{"host", hostname}, {"channel", name}},
+                {{"total", r.t_total},
+                 {"data", r.t_data},
+                 {"payload", r.t_payload},
+                 {"desc", r.t_desc},
+                 {"freq_desc", r.f_desc},
+                 {"avg_size", r.s_ms},
+                 {"jitter_p50_us", r.jitter_p50},
+                 {"jitter_p99_us", r.jitter_p99},
+                 {"jitter_max_us", r.jitter_max}});
           }
-          std::cout << ss.str();
+          sum.t_total += r.t_total;
+          sum.t_data += r.t_data;
+          sum.t_payload += r.t_payload;
+          sum.t_desc += r.t_desc;
+          sum.f_desc += r.f_desc / static_cast<double>(channels.size());
+          sum.s_ms += r.s_ms / static_cast<double>(channels.size());
+          sum.jitter_p50 = std::max(sum.jitter_p50, r.jitter_p50);
+          sum.jitter_p99 = std::max(sum.jitter_p99, r.jitter_p99);
+          sum.jitter_max = std::max(sum.jitter_max, r.jitter_max);
         }
+
+        // report channel summary (worst jitter of all channels)
+        if (opt.format == OutputFormat::Text) {
+          if (channels.size() > 1) {
+            print_text(ss, "Summery:  ", sum);
+          }
+        } else if (opt.format == OutputFormat::Csv) {
+          print_csv(ss, measurement, "sum", sum);
+        } else {
+          ss << "], \"Sum\": ";
+          print_json(ss, sum);
+          ss << "}";
+        }
+        std::cout << ss.str();
+
         tp = now;
-        if (measurement == num_measurements) {
+        if (measurement == opt.num_measurements) {
           running = false;
-        } else if (!human_readable) {
+        } else if (opt.format == OutputFormat::Json) {
           std::cout << "," << std::endl;
         }
         ++measurement;
       } // report
 
-      std::this_thread::sleep_for(sleep_time);
+      switch (opt.poll) {
+      case PollMode::Sleep:
+        std::this_thread::sleep_for(opt.sleep_time);
+        break;
+      case PollMode::Adaptive:
+        // poll again at once while data arrives, then back off
+        if (data) {
+          backoff = microseconds(0);
+        } else {
+          backoff = std::min(std::max(backoff * 2, microseconds(1)),
+                             opt.sleep_time);
+          std::this_thread::sleep_for(backoff);
+        }
+        break;
+      case PollMode::Busy:
+        break;
+      }
     } // main loop
 
-    end = high_resolution_clock::now();
+    auto end = high_resolution_clock::now();
 
-    // run summery
+    // run summary
     if (human_readable) {
       duration<double> delta = end - start;
       DualIndex index_delta = {0, 0};
-      for (size_t i = 0; i < data_sources.size(); ++i) {
-        index_delta += read_indexs.at(i) - start_indexs.at(i);
+      for (const auto& ch : channels) {
+        index_delta += ch.read - ch.start;
       }
       std::cout << "Run Summery: ";
       std::cout << "Total runtime: " << delta.count() << " s";
@@ -270,7 +433,15 @@ int main(int argc, char* argv[]) {
                     index_delta.desc * sizeof(fles::MicrosliceDescriptor)) /
                        delta.count() / 1000000.
                 << " MB/s" << std::endl;
-    } else {
+      for (const auto& ch : channels) {
+        std::cout << "Channel " << ch.index << " jitter p50/p90/p99/p99.9/max: "
+                  << ch.jitter.Percentile(50) / 1000. << "/"
+                  << ch.jitter.Percentile(90) / 1000. << "/"
+                  << ch.jitter.Percentile(99) / 1000. << "/"
+                  << ch.jitter.Percentile(99.9) / 1000. << "/"
+                  << ch.jitter.Max() / 1000. << " us" << std::endl;
+      }
+    } else if (opt.format == OutputFormat::Json) {
       std::cout << "]" << std::endl;
     }
 
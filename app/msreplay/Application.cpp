@@ -0,0 +1,92 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "Application.hpp"
+#include "MicrosliceInputArchive.hpp"
+#include "MicrosliceMappedArchive.hpp"
+#include "StorableMicroslice.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+
+Application::Application(Parameters const& par) : par_(par) {
+  // the archives are decoded once, in parallel
+  std::vector<std::future<std::unique_ptr<MicrosliceReplay>>> loading;
+  for (const auto& filename : par_.input_archives) {
+    loading.push_back(std::async(std::launch::async, [this, filename]() {
+      std::unique_ptr<fles::MicrosliceSource> archive;
+      if (boost::algorithm::ends_with(filename, ".msr")) {
+        archive = std::make_unique<fles::MicrosliceMappedArchive>(filename);
+      } else {
+        archive = std::make_unique<fles::MicrosliceInputArchive>(filename);
+      }
+      return std::make_unique<MicrosliceReplay>(*archive,
+                                                par_.maximum_number);
+    }));
+  }
+  for (size_t i = 0; i < loading.size(); ++i) {
+    replays_.push_back(loading[i].get());
+    L_(info) << "channel " << i << ": " << par_.input_archives[i] << ", "
+             << replays_.back()->size() << " microslices, "
+             << human_readable_count(replays_.back()->bytes());
+  }
+
+  L_(info) << "providing output in shared memory: " << par_.output_shm;
+  shm_device_ = std::make_unique<flib_shm_device_provider>(
+      par_.output_shm, replays_.size(), par_.data_buffer_size_exp,
+      par_.desc_buffer_size_exp, par_.lockfree);
+}
+
+Application::~Application() {
+  L_(info) << "total microslices played back: " << count_;
+}
+
+void Application::run() {
+  // common time base and index offset of the passes of all channels
+  MicrosliceReplay::Playback playback;
+  playback.speed = par_.speed;
+  playback.passes = par_.passes;
+  playback.origin = UINT64_MAX;
+  for (const auto& replay : replays_) {
+    if (replay->size() != 0) {
+      playback.origin = std::min(playback.origin, replay->first_index());
+    }
+    playback.period = std::max(playback.period, replay->period());
+  }
+  playback.start = std::chrono::steady_clock::now();
+
+  std::vector<uint64_t> counts(replays_.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < replays_.size(); ++i) {
+    threads.emplace_back([this, i, &playback, &counts]() {
+      try {
+        counts[i] = replays_[i]->play(*shm_device_->channels().at(i),
+                                      playback, stop_);
+      } catch (std::exception const& e) {
+        L_(error) << "channel " << i << ": " << e.what();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - playback.start;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    count_ += counts[i];
+  }
+  L_(info) << "played back " << count_ << " microslices in "
+           << seconds.count() << " s";
+
+  L_(info) << "waiting until output shared memory is empty";
+  for (auto* channel : shm_device_->channels()) {
+    while (!stop_ && !channel->empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    channel->set_eof(true);
+  }
+}
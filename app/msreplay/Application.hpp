@@ -0,0 +1,36 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "MicrosliceReplay.hpp"
+#include "Parameters.hpp"
+#include "shm_device_provider.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// %Application class of the microslice archive replay.
+/** Plays back each given archive into a channel of a shared memory
+    device, one thread per channel, sharing a common time base. */
+class Application {
+public:
+  explicit Application(Parameters const& par);
+
+  Application(const Application&) = delete;
+  void operator=(const Application&) = delete;
+
+  ~Application();
+
+  void run();
+
+  /// Stop the playback of all channels.
+  void stop() { stop_ = true; }
+
+private:
+  Parameters const& par_;
+
+  std::vector<std::unique_ptr<MicrosliceReplay>> replays_;
+  std::unique_ptr<flib_shm_device_provider> shm_device_;
+
+  std::atomic<bool> stop_{false};
+  uint64_t count_ = 0;
+};
@@ -0,0 +1,115 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "Parameters.hpp"
+#include "GitRevision.hpp"
+#include "log.hpp"
+#include <boost/program_options.hpp>
+#include <iostream>
+
+namespace po = boost::program_options;
+
+void Parameters::parse_options(int argc, char* argv[]) {
+  unsigned log_level = 2;
+  unsigned log_syslog = 2;
+  std::string log_file;
+
+  po::options_description general("General options");
+  auto general_add = general.add_options();
+  general_add("version,V", "print version string");
+  general_add("help,h", "produce help message");
+  general_add("log-level,l",
+              po::value<unsigned>(&log_level)
+                  ->default_value(log_level)
+                  ->value_name("<n>"),
+              "set the file log level (all:0)");
+  general_add("log-file,L", po::value<std::string>(&log_file),
+              "name of target log file");
+  general_add("log-syslog,S",
+              po::value<unsigned>(&log_syslog)
+                  ->implicit_value(log_syslog)
+                  ->value_name("<n>"),
+              "enable logging to syslog at given log level");
+  general_add("maximum-number,n", po::value<uint64_t>(&maximum_number),
+              "set the maximum number of microslices to read from each "
+              "archive (default: unlimited)");
+  general_add("exec,e", po::value<std::string>(&exec)->value_name("<string>"),
+              "name of an executable to run after startup");
+
+  po::options_description replay("Replay options");
+  auto replay_add = replay.add_options();
+  replay_add("input-archive,i",
+             po::value<std::vector<std::string>>(&input_archives)
+                 ->multitoken()
+                 ->value_name("<file> ..."),
+             "names of the microslice archives to play back, one per "
+             "channel of the shared memory");
+  replay_add("output-shm,O", po::value<std::string>(&output_shm),
+             "name of the shared memory to provide");
+  replay_add("data-buffer-size-exp",
+             po::value<std::size_t>(&data_buffer_size_exp)
+                 ->default_value(data_buffer_size_exp)
+                 ->value_name("<n>"),
+             "set the exponent of the data buffer size of each channel");
+  replay_add("desc-buffer-size-exp",
+             po::value<std::size_t>(&desc_buffer_size_exp)
+                 ->default_value(desc_buffer_size_exp)
+                 ->value_name("<n>"),
+             "set the exponent of the descriptor buffer size of each channel");
+  replay_add("lockfree", po::value<bool>(&lockfree)->implicit_value(true),
+             "publish the buffer indexes without locking (for readers "
+             "attaching directly, without a server)");
+  replay_add("speed", po::value<double>(&speed)->value_name("<factor>"),
+             "play back at the given factor of the original speed "
+             "(default: 0, as fast as possible)");
+  replay_add("passes",
+             po::value<uint64_t>(&passes)
+                 ->default_value(passes)
+                 ->value_name("<n>"),
+             "play the archives repeatedly, with continued microslice "
+             "indexes (0: until interrupted)");
+
+  po::options_description desc;
+  desc.add(general).add(replay);
+
+  po::positional_options_description positional;
+  positional.add("input-archive", -1);
+
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv)
+                .options(desc)
+                .positional(positional)
+                .run(),
+            vm);
+  po::notify(vm);
+
+  if (vm.count("help") != 0u) {
+    std::cout << "msreplay, git revision " << g_GIT_REVISION << std::endl;
+    std::cout << desc << std::endl;
+    exit(EXIT_SUCCESS);
+  }
+
+  if (vm.count("version") != 0u) {
+    std::cout << "msreplay, git revision " << g_GIT_REVISION << std::endl;
+    exit(EXIT_SUCCESS);
+  }
+
+  logging::add_console(static_cast<severity_level>(log_level));
+  if (vm.count("log-file") != 0u) {
+    L_(info) << "Logging output to " << log_file;
+    logging::add_file(log_file, static_cast<severity_level>(log_level));
+  }
+  if (vm.count("log-syslog") != 0u) {
+    logging::add_syslog(logging::syslog::local0,
+                        static_cast<severity_level>(log_syslog));
+  }
+
+  if (input_archives.empty()) {
+    throw ParametersException("no input archive specified");
+  }
+  if (output_shm.empty()) {
+    throw ParametersException("no output shared memory specified");
+  }
+  if (speed < 0) {
+    throw ParametersException("speed must not be negative");
+  }
+}
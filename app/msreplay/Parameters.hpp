@@ -0,0 +1,35 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Run parameters exception class.
+class ParametersException : public std::runtime_error {
+public:
+  explicit ParametersException(const std::string& what_arg = "")
+      : std::runtime_error(what_arg) {}
+};
+
+/// Global run parameters.
+struct Parameters {
+  Parameters(int argc, char* argv[]) { parse_options(argc, argv); }
+  void parse_options(int argc, char* argv[]);
+
+  // general options
+  uint64_t maximum_number = UINT64_MAX;
+  std::string exec;
+
+  // source and sink
+  std::vector<std::string> input_archives;
+  std::string output_shm;
+  std::size_t data_buffer_size_exp = 27; // 128 MiB
+  std::size_t desc_buffer_size_exp = 19; // 512 ki entries
+  bool lockfree = false;
+
+  // playback
+  double speed = 0;
+  uint64_t passes = 1;
+};
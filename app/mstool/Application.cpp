@@ -4,13 +4,18 @@
 #include "FlesnetPatternGenerator.hpp"
 #include "MicrosliceAnalyzer.hpp"
 #include "MicrosliceInputArchive.hpp"
+#include "MicrosliceMappedArchive.hpp"
 #include "MicrosliceOutputArchive.hpp"
+#include "MicrosliceRawOutputArchive.hpp"
 #include "MicrosliceReceiver.hpp"
 #include "MicrosliceTransmitter.hpp"
 #include "TimesliceDebugger.hpp"
+#include "Utility.hpp"
 #include "log.hpp"
 #include "shm_channel_client.hpp"
+#include <boost/algorithm/string/predicate.hpp>
 #include <chrono>
+#include <exception>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -18,6 +23,30 @@
 Application::Application(Parameters const& par) : par_(par) {
 
   // Source setup
+  if (par_.multi_channel()) {
+    L_(info) << "using shared memory as data source: " << par_.input_shm;
+
+    shm_device_ = std::make_shared<flib_shm_device_client>(par_.input_shm);
+
+    std::vector<size_t> channels = par_.channels;
+    if (par_.all_channels) {
+      channels.clear();
+      for (size_t c = 0; c < shm_device_->num_channels(); ++c) {
+        channels.push_back(c);
+      }
+    }
+    for (size_t channel : channels) {
+      if (channel >= shm_device_->num_channels()) {
+        throw std::runtime_error("shared memory channel " +
+                                 std::to_string(channel) + " not available");
+      }
+      channel_readers_.push_back(
+          std::make_unique<ChannelReader>(par_, shm_device_, channel));
+    }
+    L_(info) << "reading " << channel_readers_.size() << " channels";
+    return;
+  }
+
   if (!par_.input_shm.empty()) {
     L_(info) << "using shared memory as data source: " << par_.input_shm;
 
@@ -25,7 +54,7 @@ Application::Application(Parameters const& par) : par_(par) {
 
     if (par_.channel_idx < shm_device_->num_channels()) {
       data_source_ = std::make_unique<flib_shm_channel_client>(
-          shm_device_, par_.channel_idx);
+          shm_device_, par_.channel_idx, !par_.shm_monitor);
 
     } else {
       throw std::runtime_error("shared memory channel not available");
@@ -44,25 +73,41 @@ Application::Application(Parameters const& par) : par_(par) {
 
   if (data_source_) {
     source_ = std::make_unique<fles::MicrosliceReceiver>(*data_source_);
+  } else if (boost::algorithm::ends_with(par_.input_archive, ".msr")) {
+    source_ =
+        std::make_unique<fles::MicrosliceMappedArchive>(par_.input_archive);
   } else if (!par_.input_archive.empty()) {
     source_ =
         std::make_unique<fles::MicrosliceInputArchive>(par_.input_archive);
   }
 
   // Sink setup
-  if (par_.analyze) {
-    sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
-        new MicrosliceAnalyzer(100000, 3, std::cout, "", par_.channel_idx)));
+  if (par_.analyze || !par_.size_record.empty()) {
+    auto analyzer = std::make_unique<MicrosliceAnalyzer>(100000, 3, std::cout,
+                                                         "", par_.channel_idx);
+    if (!par_.size_record.empty()) {
+      analyzer->record_sizes(par_.size_record);
+    }
+    add_sink("analyzer", std::move(analyzer));
   }
 
   if (par_.dump_verbosity > 0) {
-    sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
-        new MicrosliceDumper(std::cout, par_.dump_verbosity)));
+    add_sink("dumper", std::make_unique<MicrosliceDumper>(
+                           std::cout, par_.dump_verbosity,
+                           parse_dump_format(par_.dump_format)));
   }
 
-  if (!par_.output_archive.empty()) {
-    sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
-        new fles::MicrosliceOutputArchive(par_.output_archive)));
+  if (boost::algorithm::ends_with(par_.output_archive, ".msr")) {
+    add_sink("archive", std::make_unique<fles::MicrosliceRawOutputArchive>(
+                            par_.output_archive,
+                            fles::MicrosliceRawOutputArchive::
+                                default_microslices_per_block,
+                            fles::MicrosliceRawOutputArchive::
+                                default_max_block_content_size,
+                            par_.output_archive_encode_descriptors));
+  } else if (!par_.output_archive.empty()) {
+    add_sink("archive", std::make_unique<fles::MicrosliceOutputArchive>(
+                            par_.output_archive));
   }
 
   if (!par_.output_shm.empty()) {
@@ -74,20 +119,97 @@ Application::Application(Parameters const& par) : par_(par) {
     output_shm_device_ = std::make_unique<flib_shm_device_provider>(
         par_.output_shm, 1, data_buffer_size_exp, desc_buffer_size_exp);
     InputBufferWriteInterface* data_sink = output_shm_device_->channels().at(0);
-    sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
-        new fles::MicrosliceTransmitter(*data_sink)));
+    add_sink("shm", std::make_unique<fles::MicrosliceTransmitter>(*data_sink));
   }
 }
 
+void Application::add_sink(std::string name,
+                           std::unique_ptr<fles::MicrosliceSink> sink) {
+  if (!par_.pipeline) {
+    sinks_.push_back(std::move(sink));
+    return;
+  }
+  size_t stage = pipeline_stages_.size();
+  int cpu = stage < par_.pipeline_cpus.size() ? par_.pipeline_cpus[stage] : -1;
+  auto pipelined = std::make_unique<PipelinedSink<fles::Microslice>>(
+      std::move(sink), std::move(name), par_.pipeline_queue, cpu);
+  pipeline_stages_.push_back(pipelined.get());
+  sinks_.push_back(std::move(pipelined));
+}
+
 Application::~Application() {
   L_(info) << "total microslices processed: " << count_;
+  auto* receiver = dynamic_cast<fles::MicrosliceReceiver*>(source_.get());
+  if (receiver != nullptr && receiver->skipped() > 0) {
+    L_(info) << "microslices skipped: " << receiver->skipped();
+  }
+}
+
+void Application::run_channels() {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> exceptions(channel_readers_.size());
+  for (size_t i = 0; i < channel_readers_.size(); ++i) {
+    int cpu = i < par_.channel_cpus.size() ? par_.channel_cpus[i] : -1;
+    threads.emplace_back([this, i, cpu, &exceptions] {
+      try {
+        channel_readers_[i]->run(par_.maximum_number, cpu);
+      } catch (...) {
+        exceptions[i] = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& exception : exceptions) {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+  uint64_t content_bytes = 0;
+  uint64_t errors = 0;
+  uint64_t skipped = 0;
+  for (const auto& reader : channel_readers_) {
+    L_(info) << reader->summary();
+    count_ += reader->count();
+    content_bytes += reader->content_bytes();
+    errors += reader->errors();
+    skipped += reader->skipped();
+  }
+  L_(info) << "all " << channel_readers_.size() << " channels: " << count_
+           << " microslices (" << human_readable_count(content_bytes, true)
+           << ") in " << seconds.count() << " s, "
+           << human_readable_count(
+                  static_cast<uint64_t>(static_cast<double>(content_bytes) /
+                                        seconds.count()),
+                  true, "B/s")
+           << ", " << errors << " errors, " << skipped << " skipped";
 }
 
 void Application::run() {
+  if (!channel_readers_.empty()) {
+    run_channels();
+    return;
+  }
+
   uint64_t limit = par_.maximum_number;
+  auto start = std::chrono::steady_clock::now();
 
-  while (auto microslice = source_->get()) {
-    std::shared_ptr<const fles::Microslice> ms(std::move(microslice));
+  // microslices from a data source are passed on without a copy
+  auto* receiver = dynamic_cast<fles::MicrosliceReceiver*>(source_.get());
+
+  auto next = [&]() -> std::shared_ptr<const fles::Microslice> {
+    if (receiver != nullptr) {
+      return receiver->get_view();
+    }
+    return source_->get();
+  };
+
+  while (auto ms = next()) {
     for (auto& sink : sinks_) {
       sink->put(ms);
     }
@@ -99,6 +221,15 @@ void Application::run() {
   for (auto& sink : sinks_) {
     sink->end_stream();
   }
+  if (!pipeline_stages_.empty()) {
+    std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+    L_(info) << "source: " << count_ << " microslices in " << seconds.count()
+             << " s";
+    for (const auto* stage : pipeline_stages_) {
+      L_(info) << stage->statistics_summary();
+    }
+  }
   if (output_shm_device_) {
     L_(info) << "waiting until output shared memory is empty";
     while (!output_shm_device_->channels().at(0)->empty()) {
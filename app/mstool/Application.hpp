@@ -1,13 +1,17 @@
 // Copyright 2012-2015 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "ChannelReader.hpp"
 #include "DualRingBuffer.hpp"
 #include "MicrosliceSource.hpp"
+#include "Microslice.hpp"
 #include "Parameters.hpp"
+#include "PipelinedSink.hpp"
 #include "Sink.hpp"
 #include "shm_device_client.hpp"
 #include "shm_device_provider.hpp"
 #include <memory>
+#include <string>
 #include <vector>
 
 /// %Application base class.
@@ -23,6 +27,12 @@ public:
   void run();
 
 private:
+  /// Add a sink, running in a thread of its own in pipeline mode.
+  void add_sink(std::string name, std::unique_ptr<fles::MicrosliceSink> sink);
+
+  /// Read several channels in parallel and log an aggregated summary.
+  void run_channels();
+
   Parameters const& par_;
 
   std::shared_ptr<flib_shm_device_client> shm_device_;
@@ -31,6 +41,8 @@ private:
 
   std::unique_ptr<fles::MicrosliceSource> source_;
   std::vector<std::unique_ptr<fles::MicrosliceSink>> sinks_;
+  std::vector<PipelinedSink<fles::Microslice>*> pipeline_stages_;
+  std::vector<std::unique_ptr<ChannelReader>> channel_readers_;
 
   uint64_t count_ = 0;
 };
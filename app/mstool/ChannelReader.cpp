@@ -0,0 +1,105 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ChannelReader.hpp"
+#include "MicrosliceOutputArchive.hpp"
+#include "MicrosliceRawOutputArchive.hpp"
+#include "PipelinedSink.hpp"
+#include "Utility.hpp"
+#include <boost/algorithm/string.hpp>
+#include <chrono>
+#include <iostream>
+
+std::mutex ChannelReader::LineBuffer::mutex_;
+
+int ChannelReader::LineBuffer::sync() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::cout << str() << std::flush;
+  str("");
+  return 0;
+}
+
+ChannelReader::ChannelReader(Parameters const& par,
+                             std::shared_ptr<flib_shm_device_client> device,
+                             size_t channel)
+    : channel_(channel) {
+  data_source_ = std::make_unique<flib_shm_channel_client>(
+      std::move(device), channel, !par.shm_monitor);
+  receiver_ = std::make_unique<fles::MicrosliceReceiver>(*data_source_);
+
+  auto channel_name = [channel](const std::string& name) {
+    return boost::algorithm::replace_all_copy(name, "%c",
+                                              std::to_string(channel));
+  };
+
+  if (par.analyze || !par.size_record.empty()) {
+    auto analyzer = std::make_unique<MicrosliceAnalyzer>(
+        100000, 3, out_, "channel " + std::to_string(channel) + ": ",
+        channel);
+    if (!par.size_record.empty()) {
+      analyzer->record_sizes(channel_name(par.size_record));
+    }
+    analyzer_ = analyzer.get();
+    sinks_.push_back(std::move(analyzer));
+  }
+
+  std::unique_ptr<fles::MicrosliceSink> archive;
+  std::string output_archive = channel_name(par.output_archive);
+  if (boost::algorithm::ends_with(output_archive, ".msr")) {
+    archive = std::make_unique<fles::MicrosliceRawOutputArchive>(
+        output_archive,
+        fles::MicrosliceRawOutputArchive::default_microslices_per_block,
+        fles::MicrosliceRawOutputArchive::default_max_block_content_size,
+        par.output_archive_encode_descriptors);
+  } else if (!output_archive.empty()) {
+    archive = std::make_unique<fles::MicrosliceOutputArchive>(output_archive);
+  }
+  if (archive) {
+    // the archive is written in the background to keep up with the readout
+    sinks_.push_back(std::make_unique<PipelinedSink<fles::Microslice>>(
+        std::move(archive), "archive " + std::to_string(channel),
+        par.pipeline_queue));
+  }
+}
+
+void ChannelReader::run(uint64_t limit, int cpu) {
+  if (cpu >= 0) {
+    set_cpu(cpu);
+  }
+  auto start = std::chrono::steady_clock::now();
+  while (auto ms = receiver_->get_view()) {
+    for (auto& sink : sinks_) {
+      sink->put(ms);
+    }
+    content_bytes_ += ms->desc().size;
+    ++count_;
+    if (count_ == limit) {
+      break;
+    }
+  }
+  for (auto& sink : sinks_) {
+    sink->end_stream();
+  }
+  seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count();
+}
+
+std::string ChannelReader::summary() const {
+  std::ostringstream s;
+  s << "channel " << channel_ << ": " << count_ << " microslices ("
+    << human_readable_count(content_bytes_, true) << ")";
+  if (seconds_ > 0) {
+    s << ", "
+      << human_readable_count(
+             static_cast<uint64_t>(static_cast<double>(content_bytes_) /
+                                   seconds_),
+             true, "B/s");
+  }
+  if (errors() > 0) {
+    s << ", " << errors() << " errors";
+  }
+  if (skipped() > 0) {
+    s << ", " << skipped() << " skipped";
+  }
+  return s.str();
+}
@@ -0,0 +1,83 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "MicrosliceAnalyzer.hpp"
+#include "MicrosliceReceiver.hpp"
+#include "Parameters.hpp"
+#include "Sink.hpp"
+#include "ThreadContainer.hpp"
+#include "shm_channel_client.hpp"
+#include "shm_device_client.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Reader of one channel of a shared memory device.
+/** A ChannelReader object passes the microslices of one channel of a
+    shared device to sinks of its own: an analyzer, a size record and an
+    output archive, as given by the parameters. The output archive is
+    written by a background thread. Several readers run in parallel, each
+    on a thread of its own, to read out a full device in one process. */
+class ChannelReader : public ThreadContainer {
+public:
+  ChannelReader(Parameters const& par,
+                std::shared_ptr<flib_shm_device_client> device,
+                size_t channel);
+
+  ChannelReader(const ChannelReader&) = delete;
+  void operator=(const ChannelReader&) = delete;
+
+  /// Read the channel on the calling thread, pinned to a CPU (if >= 0).
+  void run(uint64_t limit, int cpu);
+
+  [[nodiscard]] size_t channel() const { return channel_; }
+
+  /// Retrieve the number of microslices read.
+  [[nodiscard]] uint64_t count() const { return count_; }
+
+  /// Retrieve the total microslice content size read (bytes).
+  [[nodiscard]] uint64_t content_bytes() const { return content_bytes_; }
+
+  /// Retrieve the number of microslices failing the analysis.
+  [[nodiscard]] uint64_t errors() const {
+    return analyzer_ != nullptr ? analyzer_->error_count() : 0;
+  }
+
+  /// Retrieve the number of microslices skipped (monitor only).
+  [[nodiscard]] uint64_t skipped() const { return receiver_->skipped(); }
+
+  /// Retrieve the time spent reading (s).
+  [[nodiscard]] double seconds() const { return seconds_; }
+
+  /// Retrieve a one-line summary of the channel.
+  [[nodiscard]] std::string summary() const;
+
+private:
+  /// Stream buffer writing complete lines to std::cout.
+  /** The analyzers of all channels share the console, so each flushed
+      line is written at once. */
+  class LineBuffer : public std::stringbuf {
+  protected:
+    int sync() override;
+
+  private:
+    static std::mutex mutex_;
+  };
+
+  size_t channel_;
+  LineBuffer line_buffer_;
+  std::ostream out_{&line_buffer_};
+
+  std::unique_ptr<flib_shm_channel_client> data_source_;
+  std::unique_ptr<fles::MicrosliceReceiver> receiver_;
+  std::vector<std::unique_ptr<fles::MicrosliceSink>> sinks_;
+  MicrosliceAnalyzer* analyzer_ = nullptr;
+
+  uint64_t count_ = 0;
+  uint64_t content_bytes_ = 0;
+  double seconds_ = 0;
+};
@@ -3,6 +3,7 @@
 #include "Parameters.hpp"
 #include "GitRevision.hpp"
 #include "log.hpp"
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/program_options.hpp>
 #include <iostream>
 
@@ -12,6 +13,7 @@ void Parameters::parse_options(int argc, char* argv[]) {
   unsigned log_level = 2;
   unsigned log_syslog = 2;
   std::string log_file;
+  std::vector<std::string> channel_list;
 
   po::options_description general("General options");
   auto general_add = general.add_options();
@@ -43,22 +45,68 @@ void Parameters::parse_options(int argc, char* argv[]) {
              "use given channel/component index for source/sink");
   source_add("input-shm,I", po::value<std::string>(&input_shm),
              "name of a shared memory to use as data source");
+  source_add("channels",
+             po::value<std::vector<std::string>>(&channel_list)
+                 ->multitoken()
+                 ->value_name("<n> ...|all"),
+             "read the given (or all) channels of the shared memory in "
+             "parallel, each on a thread of its own with its own sinks (use "
+             "%c in output file names for the channel index)");
+  source_add("channel-cpus",
+             po::value<std::vector<int>>(&channel_cpus)
+                 ->multitoken()
+                 ->value_name("<n> ..."),
+             "pin the channel threads to the given CPUs (in order of the "
+             "channels)");
+  source_add("shm-monitor",
+             po::value<bool>(&shm_monitor)->implicit_value(true),
+             "read the shared memory as a non-critical monitor that does not "
+             "hold back buffer space and may skip microslices");
   source_add("input-archive,i", po::value<std::string>(&input_archive),
-             "name of an input file archive to read");
+             "name of an input file archive to read (use extension .msr "
+             "for the raw, directly mappable format)");
 
   po::options_description sink("Sink options");
   auto sink_add = sink.add_options();
   sink_add("analyze,a", po::value<bool>(&analyze)->implicit_value(true),
            "enable/disable pattern check");
+  sink_add("size-record", po::value<std::string>(&size_record),
+           "analyze and write the index and size of each microslice to the "
+           "given file, e.g., for replay by the flesnet pattern generator");
   sink_add("dump_verbosity,v", po::value<size_t>(&dump_verbosity),
            "set output debug dump verbosity");
+  sink_add("dump-format", po::value<std::string>(&dump_format),
+           "format of the debug dump: text (default), json (one object per "
+           "line)");
   sink_add("output-shm,O", po::value<std::string>(&output_shm),
            "name of a shared memory to write to");
   sink_add("output-archive,o", po::value<std::string>(&output_archive),
-           "name of an output file archive to write");
+           "name of an output file archive to write (use extension .msr "
+           "for the raw, directly mappable format)");
+  sink_add("output-archive-encode-descriptors",
+           po::value<bool>(&output_archive_encode_descriptors)
+               ->implicit_value(true),
+           "store the microslice descriptors of a raw output archive (.msr) "
+           "in a compact columnar encoding");
+
+  po::options_description execution("Execution options");
+  auto execution_add = execution.add_options();
+  execution_add("pipeline,P", po::value<bool>(&pipeline)->implicit_value(true),
+                "run each sink in a thread of its own, fed by a queue");
+  execution_add("pipeline-queue",
+                po::value<size_t>(&pipeline_queue)
+                    ->default_value(pipeline_queue)
+                    ->value_name("<n>"),
+                "set the number of queued microslices per sink thread");
+  execution_add(
+      "pipeline-cpus",
+      po::value<std::vector<int>>(&pipeline_cpus)
+          ->multitoken()
+          ->value_name("<n> ..."),
+      "pin the sink threads to the given CPUs (in order of the sinks)");
 
   po::options_description desc;
-  desc.add(general).add(source).add(sink);
+  desc.add(general).add(source).add(sink).add(execution);
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -95,4 +143,45 @@ void Parameters::parse_options(int argc, char* argv[]) {
   if (input_sources > 1) {
     throw ParametersException("more than one input source specified");
   }
+
+  for (const auto& channel : channel_list) {
+    if (channel == "all") {
+      all_channels = true;
+    } else {
+      try {
+        channels.push_back(std::stoul(channel));
+      } catch (std::logic_error&) {
+        throw ParametersException("invalid channel: " + channel);
+      }
+    }
+  }
+  if (dump_format != "text" && dump_format != "json") {
+    throw ParametersException("invalid dump format: " + dump_format);
+  }
+  if (multi_channel()) {
+    if (input_shm.empty()) {
+      throw ParametersException("several channels require input-shm");
+    }
+    if (!output_shm.empty() || dump_verbosity > 0) {
+      throw ParametersException(
+          "output-shm and dump_verbosity require a single channel");
+    }
+    for (const auto* name : {&output_archive, &size_record}) {
+      if (!name->empty() && name->find("%c") == std::string::npos) {
+        throw ParametersException("output file name must contain %c for "
+                                  "several channels: " +
+                                  *name);
+      }
+    }
+  }
+
+  if (output_archive_encode_descriptors &&
+      !boost::algorithm::ends_with(output_archive, ".msr")) {
+    throw ParametersException(
+        "descriptor encoding requires a raw output archive (.msr)");
+  }
+
+  if (pipeline_queue == 0) {
+    throw ParametersException("pipeline queue size must be positive");
+  }
 }
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 /// Run parameters exception class.
 class ParametersException : public std::runtime_error {
@@ -17,6 +18,11 @@ struct Parameters {
   Parameters(int argc, char* argv[]) { parse_options(argc, argv); }
   void parse_options(int argc, char* argv[]);
 
+  /// Whether several channels of the shared memory are read in parallel.
+  [[nodiscard]] bool multi_channel() const {
+    return all_channels || !channels.empty();
+  }
+
   // general options
   uint64_t maximum_number = UINT64_MAX;
   std::string exec;
@@ -25,12 +31,24 @@ struct Parameters {
   uint32_t pattern_generator = 0;
   bool use_pattern_generator = false;
   size_t channel_idx = 0;
+  std::vector<size_t> channels; // several channels read in parallel
+  bool all_channels = false;
+  std::vector<int> channel_cpus;
   std::string input_shm;
+  bool shm_monitor = false;
   std::string input_archive;
 
   // sink selection
   bool analyze = false;
+  std::string size_record;
   size_t dump_verbosity = 0;
+  std::string dump_format = "text";
   std::string output_shm;
   std::string output_archive;
+  bool output_archive_encode_descriptors = false;
+
+  // execution
+  bool pipeline = false;
+  size_t pipeline_queue = 1024;
+  std::vector<int> pipeline_cpus;
 };
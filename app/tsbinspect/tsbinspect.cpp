@@ -0,0 +1,271 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Show the live status of the timeslice buffers of a compute node.
+
+#include "TimesliceBufferStatus.hpp"
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/program_options.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+namespace bi = boost::interprocess;
+
+namespace {
+
+/// A consistent copy of the published status of a distributor worker.
+struct WorkerSnapshot {
+  std::string name;
+  uint64_t outstanding = 0;
+  uint64_t waiting = 0;
+  int64_t oldest_arrival_ns = 0;
+  int32_t utilization_pm = -1;
+  uint64_t wait_us = 0;
+  uint64_t hold_us = 0;
+};
+
+/// Read a worker slot, retrying while it is being updated.
+/** Returns false if the slot is unused. The writer is never delayed. */
+bool read_worker(const DistributorWorkerStatus& s, WorkerSnapshot& w) {
+  while (true) {
+    uint64_t seq = s.sequence.load(std::memory_order_acquire);
+    if ((seq & 1) != 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    w.name.clear();
+    for (const auto& c : s.name) {
+      char value = c.load(std::memory_order_relaxed);
+      if (value == '\0') {
+        break;
+      }
+      w.name += value;
+    }
+    w.outstanding = s.outstanding.load(std::memory_order_relaxed);
+    w.waiting = s.waiting.load(std::memory_order_relaxed);
+    w.oldest_arrival_ns = s.oldest_arrival_ns.load(std::memory_order_relaxed);
+    w.utilization_pm = s.utilization_pm.load(std::memory_order_relaxed);
+    w.wait_us = s.wait_us.load(std::memory_order_relaxed);
+    w.hold_us = s.hold_us.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.sequence.load(std::memory_order_relaxed) == seq) {
+      return !w.name.empty();
+    }
+  }
+}
+
+std::string percent(uint64_t value, uint64_t size) {
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(1) << std::setw(5)
+    << (size != 0 ? 100.0 * static_cast<double>(value) /
+                        static_cast<double>(size)
+                  : 0)
+    << "%";
+  return s.str();
+}
+
+/// Write the positions and fill level of one ring buffer of an input.
+void write_positions(std::ostream& out,
+                     const BufferPositionCounters& counters,
+                     uint64_t size) {
+  // read the lower positions first, see BufferStatusSampler
+  uint64_t cached_acked = counters.cached_acked.load(std::memory_order_acquire);
+  uint64_t acked = counters.acked.load(std::memory_order_relaxed);
+  uint64_t written = counters.written.load(std::memory_order_relaxed);
+  out << std::setw(14) << written << std::setw(14) << acked << " "
+      << percent(written - acked, size) << " "
+      << percent(size - (written - cached_acked), size);
+}
+
+/// An attached timeslice buffer status segment.
+class Inspector {
+public:
+  explicit Inspector(const std::string& shm_identifier)
+      : shm_identifier_(shm_identifier),
+        status_shm_(bi::open_read_only,
+                    TimesliceBufferStatus::segment_name(shm_identifier)
+                        .c_str()) {
+    auto inputs = status_shm_.find<BufferStatusSource>("inputs");
+    inputs_ = inputs.first;
+    num_inputs_ = inputs.second;
+    distributor_ = status_shm_.find<DistributorStatus>("distributor").first;
+    if (inputs_ == nullptr || distributor_ == nullptr) {
+      throw std::runtime_error("invalid status segment for " +
+                               shm_identifier);
+    }
+    // the buffer segment identifies the run (optional)
+    try {
+      bi::managed_shared_memory shm(bi::open_read_only,
+                                    shm_identifier.c_str());
+      auto* uuid = shm.find<boost::uuids::uuid>(bi::unique_instance).first;
+      if (uuid != nullptr) {
+        uuid_ = boost::uuids::to_string(*uuid);
+      }
+    } catch (bi::interprocess_exception&) {
+    }
+  }
+
+  void write(std::ostream& out) const {
+    auto now = std::chrono::steady_clock::now();
+    int64_t now_ns = status_time_ns(now);
+    int64_t updated_ns =
+        distributor_->updated_ns.load(std::memory_order_acquire);
+
+    out << "timeslice buffer " << shm_identifier_;
+    if (!uuid_.empty()) {
+      out << " (" << uuid_ << ")";
+    }
+    out << "\n\n" << std::setw(5) << "input";
+    for (const char* buffer : {"desc", "data"}) {
+      out << " " << std::setw(14) << std::string(buffer) + " written"
+          << std::setw(14) << "acked" << std::setw(7) << "used"
+          << std::setw(7) << "free";
+    }
+    out << "\n";
+    for (std::size_t i = 0; i < num_inputs_; ++i) {
+      const BufferStatusSource& input = inputs_[i];
+      out << std::setw(5) << i << " ";
+      write_positions(out, input.desc,
+                      input.desc_size.load(std::memory_order_relaxed));
+      out << " ";
+      write_positions(out, input.data,
+                      input.data_size.load(std::memory_order_relaxed));
+      out << "\n";
+    }
+
+    out << "\ndistributor: ";
+    if (updated_ns == 0) {
+      out << "no status published\n";
+      return;
+    }
+    out << distributor_->held_items.load(std::memory_order_relaxed)
+        << " items held, "
+        << distributor_->num_workers.load(std::memory_order_relaxed)
+        << " workers, updated " << std::fixed << std::setprecision(1)
+        << static_cast<double>(now_ns - updated_ns) / 1e6 << " ms ago\n";
+    out << "  outstanding  waiting  oldest (ms)    busy  wait (ms)  hold (ms)"
+           "  worker\n";
+    WorkerSnapshot w;
+    for (const auto& slot : distributor_->workers) {
+      if (!read_worker(slot, w)) {
+        break;
+      }
+      out << std::setw(13) << w.outstanding << std::setw(9) << w.waiting
+          << std::setw(13);
+      if (w.oldest_arrival_ns != 0) {
+        out << std::fixed << std::setprecision(1)
+            << static_cast<double>(now_ns - w.oldest_arrival_ns) / 1e6;
+      } else {
+        out << "-";
+      }
+      if (w.utilization_pm >= 0) {
+        out << std::setw(7) << std::setprecision(1)
+            << static_cast<double>(w.utilization_pm) / 10 << "%"
+            << std::setw(11) << std::setprecision(2)
+            << static_cast<double>(w.wait_us) / 1e3 << std::setw(11)
+            << static_cast<double>(w.hold_us) / 1e3;
+      } else {
+        out << std::setw(8) << "-" << std::setw(11) << "-" << std::setw(11)
+            << "-";
+      }
+      out << "  " << w.name << "\n";
+    }
+  }
+
+private:
+  std::string shm_identifier_;
+  bi::managed_shared_memory status_shm_;
+  const BufferStatusSource* inputs_ = nullptr;
+  std::size_t num_inputs_ = 0;
+  const DistributorStatus* distributor_ = nullptr;
+  std::string uuid_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> identifiers;
+  unsigned interval_ms = 1000;
+  uint64_t count = 0;
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("shm,s",
+           po::value<std::vector<std::string>>(&identifiers)
+               ->value_name("<id>")
+               ->required(),
+           "shared memory identifier of the timeslice buffer");
+  desc_add("interval,t",
+           po::value<unsigned>(&interval_ms)
+               ->value_name("<ms>")
+               ->default_value(interval_ms),
+           "refresh interval");
+  desc_add("count,n",
+           po::value<uint64_t>(&count)->value_name("<n>")->default_value(0),
+           "number of refreshes (0: until interrupted)");
+  po::positional_options_description pos;
+  pos.add("shm", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(pos)
+                  .run(),
+              vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Shows the buffer positions of each input and the "
+                   "outstanding work items of\neach worker of running "
+                   "timeslice buffers. The status segments are only\nread, "
+                   "so that the inspected flesnet process is not "
+                   "affected.\n\nUsage: "
+                << argv[0] << " [options] <id>...\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    std::vector<std::unique_ptr<Inspector>> inspectors;
+    for (const auto& id : identifiers) {
+      try {
+        inspectors.push_back(std::make_unique<Inspector>(id));
+      } catch (bi::interprocess_exception& e) {
+        throw std::runtime_error("cannot open status of timeslice buffer " +
+                                 id + ": " + e.what());
+      }
+    }
+    for (uint64_t n = 0; count == 0 || n < count; ++n) {
+      if (n != 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+      }
+      std::ostringstream out;
+      if (count != 1) {
+        // clear the terminal for a continuous display
+        out << "\033[H\033[2J";
+      }
+      for (const auto& inspector : inspectors) {
+        inspector->write(out);
+        out << "\n";
+      }
+      std::cout << out.str() << std::flush;
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
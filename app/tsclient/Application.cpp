@@ -1,12 +1,19 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Application.hpp"
+#include "DescriptorColumnOutputArchive.hpp"
+#include "SourceBenchmark.hpp"
+#include "System.hpp"
 #include "TimesliceAnalyzer.hpp"
 #include "TimesliceAutoSource.hpp"
 #include "TimesliceDebugger.hpp"
+#include "TimesliceMulticastPublisher.hpp"
 #include "TimesliceOutputArchive.hpp"
 #include "TimeslicePublisher.hpp"
+#include "TimesliceRawOutputArchive.hpp"
+#include "TimesliceVerifier.hpp"
 #include "Utility.hpp"
+#include <boost/algorithm/string/predicate.hpp>
 #include <memory>
 #include <thread>
 
@@ -22,40 +29,85 @@ Application::Application(Parameters const& par) : par_(par) {
 
   source_ = std::make_unique<fles::TimesliceAutoSource>(par_.input_uri());
 
-  if (par_.analyze()) {
-    if (par_.histograms()) {
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new TimesliceAnalyzer(1000, status_log_.stream, output_prefix_,
-                                &std::cout, monitor_.get())));
-    } else {
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new TimesliceAnalyzer(1000, status_log_.stream, output_prefix_,
-                                nullptr, monitor_.get())));
-    }
+  if (par_.analyze() || par_.analyze_descriptors()) {
+    std::ostream* hist = par_.histograms() ? &std::cout : nullptr;
+    add_sink("analyzer",
+             std::make_unique<TimesliceAnalyzer>(
+                 1000, status_log_.stream, output_prefix_, hist,
+                 monitor_.get(), par_.analyze_threads(), !par_.analyze()),
+             par_.sink_queue());
+  }
+
+  if (par_.verify()) {
+    auto verifier = std::make_unique<TimesliceVerifier>(
+        [this](const TimesliceVerifier::Result& r) {
+          if (r.crc_errors != 0 || r.pattern_errors != 0) {
+            L_(error) << output_prefix_ << "timeslice " << r.index << ": "
+                      << r.crc_errors << " CRC errors, " << r.pattern_errors
+                      << " pattern errors in " << r.microslices
+                      << " microslices";
+          }
+        },
+        par_.verify_device(), par_.analyze_threads());
+    L_(info) << output_prefix_ << "verifying microslices on "
+             << verifier->engine_name();
+    add_sink("verifier", std::move(verifier), par_.sink_queue());
   }
 
   if (par_.verbosity() > 0) {
-    sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-        new TimesliceDumper(debug_log_.stream, par_.verbosity())));
+    add_sink("dumper",
+             std::make_unique<TimesliceDumper>(
+                 debug_log_.stream, par_.verbosity(),
+                 parse_dump_format(par_.dump_format()), par_.dump_threads()),
+             par_.sink_queue());
   }
 
   if (!par_.output_archive().empty()) {
-    if (par_.output_archive_items() == SIZE_MAX &&
-        par_.output_archive_bytes() == SIZE_MAX) {
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new fles::TimesliceOutputArchive(par_.output_archive())));
+    std::unique_ptr<fles::TimesliceSink> archive;
+    if (boost::algorithm::ends_with(par_.output_archive(), ".tsr")) {
+      archive = std::make_unique<fles::TimesliceRawOutputArchive>(
+          par_.output_archive(), par_.output_archive_dedup_overlap(),
+          par_.output_archive_direct_io());
+    } else if (boost::algorithm::ends_with(par_.output_archive(), ".tsc")) {
+      archive = std::make_unique<fles::DescriptorColumnOutputArchive>(
+          par_.output_archive());
+    } else if (!par_.output_archive_stripes().empty()) {
+      archive = std::make_unique<fles::TimesliceStripedOutputArchive>(
+          par_.output_archive(), par_.output_archive_stripes(),
+          par_.output_archive_compression(), par_.output_archive_direct_io(),
+          par_.output_archive_dictionary());
+    } else if (par_.output_archive_items() == SIZE_MAX &&
+               par_.output_archive_bytes() == SIZE_MAX &&
+               !par_.output_archive_direct_io() &&
+               par_.output_archive_catalog().empty()) {
+      archive = std::make_unique<fles::TimesliceOutputArchive>(
+          par_.output_archive(), par_.output_archive_compression(),
+          par_.output_archive_dictionary());
     } else {
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new fles::TimesliceOutputArchiveSequence(
-              par_.output_archive(), par_.output_archive_items(),
-              par_.output_archive_bytes())));
+      archive = std::make_unique<fles::TimesliceOutputArchiveSequence>(
+          par_.output_archive(), par_.output_archive_items(),
+          par_.output_archive_bytes(), par_.output_archive_compression(),
+          par_.output_archive_direct_io(), par_.output_archive_dictionary(),
+          par_.output_archive_catalog());
     }
+    add_sink("archive", std::move(archive),
+             par_.output_archive_queue() > 0 ? par_.output_archive_queue()
+                                             : par_.sink_queue());
   }
 
-  if (!par_.publish_address().empty()) {
-    sinks_.push_back(
-        std::unique_ptr<fles::TimesliceSink>(new fles::TimeslicePublisher(
-            par_.publish_address(), par_.publish_hwm())));
+  if (par_.publish_address().rfind("udp://", 0) == 0) {
+    // best-effort multicast to any number of subscribers
+    add_sink("publisher",
+             std::make_unique<fles::TimesliceMulticastPublisher>(
+                 par_.publish_address()),
+             par_.sink_queue());
+  } else if (!par_.publish_address().empty()) {
+    add_sink("publisher",
+             std::make_unique<fles::TimeslicePublisher>(
+                 par_.publish_address(), par_.publish_hwm(),
+                 par_.publish_multipart(), fles::ComponentSelection(),
+                 par_.publish_topics()),
+             par_.sink_queue());
   }
 
   if (par_.benchmark()) {
@@ -70,12 +122,66 @@ Application::Application(Parameters const& par) : par_(par) {
 
 Application::~Application() {
   L_(info) << output_prefix_ << "total timeslices processed: " << count_;
+  for (const auto& s : async_sinks_) {
+    if (s.sink->dropped() > 0) {
+      L_(warning) << output_prefix_ << s.name
+                  << ": timeslices dropped: " << s.sink->dropped();
+    }
+  }
 
   // delay to allow monitor to process pending messages
   constexpr auto destruct_delay = std::chrono::milliseconds(200);
   std::this_thread::sleep_for(destruct_delay);
 }
 
+void Application::add_sink(std::string name,
+                           std::unique_ptr<fles::TimesliceSink> sink,
+                           size_t queue) {
+  if (queue == 0) {
+    sinks_.push_back(std::move(sink));
+    return;
+  }
+  auto policy = par_.sink_drop(name) ? fles::OverflowPolicy::Drop
+                                     : fles::OverflowPolicy::Block;
+  auto async = std::make_unique<fles::AsyncSink<fles::Timeslice>>(
+      std::move(sink), queue, policy);
+  async_sinks_.push_back({std::move(name), async.get()});
+  sinks_.push_back(std::move(async));
+}
+
+void Application::report_sink_status() {
+  constexpr auto interval = std::chrono::seconds(1);
+  auto now = std::chrono::steady_clock::now();
+  if (now < sink_status_time_ + interval) {
+    return;
+  }
+  sink_status_time_ = now;
+
+  const std::string prefix = output_prefix_.empty() ? ":" : output_prefix_;
+  for (auto& s : async_sinks_) {
+    auto latency = s.sink->latency();
+    double mean_us =
+        latency.count > 0
+            ? std::chrono::duration<double, std::micro>(latency.sum).count() /
+                  static_cast<double>(latency.count)
+            : 0.0;
+    double max_us =
+        std::chrono::duration<double, std::micro>(latency.max).count();
+    monitor_->QueueMetric(
+        "tsclient_sink_status",
+        {{"host", fles::system::current_hostname()},
+         {"output_prefix", prefix},
+         {"sink", s.name}},
+        {{"queue_depth", s.sink->queue_depth()},
+         {"max_queue_depth", s.sink->max_queue_depth()},
+         {"queue_capacity", s.sink->capacity()},
+         {"dropped", s.sink->dropped()},
+         {"completed", latency.count},
+         {"latency_mean_us", mean_us},
+         {"latency_max_us", max_us}});
+  }
+}
+
 void Application::rate_limit_delay() const {
   auto delta_is = std::chrono::high_resolution_clock::now() - time_begin_;
   auto delta_want = std::chrono::microseconds(
@@ -108,6 +214,14 @@ void Application::run() {
     return;
   }
 
+  if (par_.benchmark_source()) {
+    SourceBenchmark source_benchmark(*source_, par_.maximum_number(),
+                                     monitor_.get(), output_prefix_);
+    source_benchmark.run();
+    count_ = source_benchmark.count();
+    return;
+  }
+
   uint64_t limit = par_.maximum_number();
 
   uint64_t index = 0;
@@ -129,6 +243,9 @@ void Application::run() {
     for (auto& sink : sinks_) {
       sink->put(ts);
     }
+    if (!async_sinks_.empty() && monitor_) {
+      report_sink_status();
+    }
     ++count_;
     if (count_ == limit) {
       break;
@@ -1,6 +1,7 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "AsyncSink.hpp"
 #include "Benchmark.hpp"
 #include "Monitor.hpp"
 #include "Parameters.hpp"
@@ -9,6 +10,7 @@
 #include "log.hpp"
 #include <chrono>
 #include <memory>
+#include <string>
 #include <vector>
 
 /// %Application base class.
@@ -33,6 +35,14 @@ private:
   std::vector<std::unique_ptr<fles::TimesliceSink>> sinks_;
   std::unique_ptr<Benchmark> benchmark_;
 
+  /// A sink running on a background thread (also in sinks_).
+  struct AsyncSinkEntry {
+    std::string name;
+    fles::AsyncSink<fles::Timeslice>* sink;
+  };
+  std::vector<AsyncSinkEntry> async_sinks_;
+  std::chrono::steady_clock::time_point sink_status_time_;
+
   uint64_t count_ = 0;
 
   logging::OstreamLog status_log_{status};
@@ -42,6 +52,11 @@ private:
   std::chrono::high_resolution_clock::time_point time_begin_;
   uint64_t first_ts_start_time_;
 
+  /// Add a sink, on a background thread with the given queue size if not 0.
+  void add_sink(std::string name,
+                std::unique_ptr<fles::TimesliceSink> sink,
+                size_t queue);
+  void report_sink_status();
   void rate_limit_delay() const;
   void native_speed_delay(uint64_t ts_start_time);
 };
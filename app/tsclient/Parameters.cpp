@@ -2,11 +2,45 @@
 
 #include "Parameters.hpp"
 #include "log.hpp"
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 namespace po = boost::program_options;
 
+std::istream& fles::operator>>(std::istream& in,
+                               fles::ArchiveCompression& compression) {
+  std::string token;
+  in >> token;
+  std::transform(std::begin(token), std::end(token), std::begin(token),
+                 [](const unsigned char i) { return tolower(i); });
+
+  if (token == "none") {
+    compression = fles::ArchiveCompression::None;
+  } else if (token == "zstd") {
+    compression = fles::ArchiveCompression::Zstd;
+  } else {
+    throw po::invalid_option_value(token);
+  }
+  return in;
+}
+
+std::ostream& fles::operator<<(std::ostream& out,
+                               const fles::ArchiveCompression& compression) {
+  switch (compression) {
+  case fles::ArchiveCompression::None:
+    out << "none";
+    break;
+  case fles::ArchiveCompression::Zstd:
+    out << "zstd";
+    break;
+  }
+  return out;
+}
+
 void Parameters::parse_options(int argc, char* argv[]) {
   unsigned log_level = 2;
   unsigned log_syslog = 2;
@@ -33,6 +67,23 @@ void Parameters::parse_options(int argc, char* argv[]) {
   desc_add("analyze-pattern,a",
            po::value<bool>(&analyze_)->implicit_value(true),
            "enable/disable pattern check");
+  desc_add("analyze-descriptors",
+           po::value<bool>(&analyze_descriptors_)->implicit_value(true),
+           "enable/disable the check of the microslice descriptors only "
+           "(without content access, implied by analyze-pattern)");
+  desc_add("analyze-threads",
+           po::value<unsigned>(&analyze_threads_)
+               ->default_value(analyze_threads_)
+               ->value_name("<n>"),
+           "number of threads checking timeslice components in parallel");
+  desc_add("verify", po::value<bool>(&verify_)->implicit_value(true),
+           "enable/disable the batched verification of microslice CRCs and "
+           "test patterns (using analyze-threads threads)");
+  desc_add("verify-device",
+           po::value<int>(&verify_device_)
+               ->default_value(verify_device_)
+               ->value_name("<n>"),
+           "CUDA device to offload the verification to (-1: CPU)");
   desc_add("monitor,m",
            po::value<std::string>(&monitor_uri_)
                ->value_name("<uri>")
@@ -41,13 +92,29 @@ void Parameters::parse_options(int argc, char* argv[]) {
            "console output)");
   desc_add("benchmark,b", po::value<bool>(&benchmark_)->implicit_value(true),
            "run benchmark test only");
+  desc_add("benchmark-source",
+           po::value<bool>(&benchmark_source_)->implicit_value(true),
+           "drain the input source without sinks and measure its throughput "
+           "and get() latency");
   desc_add("verbose,v", po::value<size_t>(&verbosity_), "set output verbosity");
+  desc_add("dump-format",
+           po::value<std::string>(&dump_format_)
+               ->default_value(dump_format_)
+               ->value_name("<format>"),
+           "format of the verbose output: text, json (one object per line)");
+  desc_add("dump-threads",
+           po::value<unsigned>(&dump_threads_)
+               ->default_value(dump_threads_)
+               ->value_name("<n>"),
+           "number of threads formatting timeslice components in parallel");
   desc_add("histograms", po::value<bool>(&histograms_)->implicit_value(true),
            "enable microslice histogram data output");
   desc_add("input-uri,i", po::value<std::string>(&input_uri_),
            "uri of a timeslice source");
   desc_add("output-archive,o", po::value<std::string>(&output_archive_),
-           "name of an output file archive to write");
+           "name of an output file archive to write (use extension .tsr "
+           "for the raw, directly mappable format, or .tsc for the "
+           "microslice descriptors only, in columns)");
   desc_add("output-archive-items", po::value<size_t>(&output_archive_items_),
            "limit number of timeslices per file to given number, create "
            "sequence of output archive files (use placeholder %n in "
@@ -56,13 +123,57 @@ void Parameters::parse_options(int argc, char* argv[]) {
            "limit number of bytes per file to given number, create "
            "sequence of output archive files (use placeholder %n in "
            "output-archive parameter)");
+  desc_add("output-archive-compression",
+           po::value<fles::ArchiveCompression>(&output_archive_compression_)
+               ->default_value(output_archive_compression_)
+               ->value_name("<id>"),
+           "select output archive compression; possible values "
+           "(case-insensitive) are: none, zstd");
+  desc_add("output-archive-dictionary",
+           po::value<std::string>(&output_archive_dictionary_file_)
+               ->value_name("<file>"),
+           "compress output archive using the given zstd dictionary (see "
+           "tsdict)");
+  desc_add("output-archive-queue",
+           po::value<size_t>(&output_archive_queue_)->value_name("<n>"),
+           "write output archive on a background thread, queueing up to the "
+           "given number of timeslices");
+  desc_add("output-archive-direct-io",
+           po::value<bool>(&output_archive_direct_io_)->implicit_value(true),
+           "write output archive bypassing the page cache (O_DIRECT), not "
+           "supported for descriptor archives (.tsc)");
+  desc_add("output-archive-dedup-overlap",
+           po::value<bool>(&output_archive_dedup_overlap_)
+               ->implicit_value(true),
+           "store overlap microslices only once in a raw output archive "
+           "(.tsr) if they are repeated in the following timeslice");
+  desc_add("output-archive-catalog",
+           po::value<std::string>(&output_archive_catalog_)
+               ->value_name("<file>"),
+           "append an entry for each completed output archive file to the "
+           "given catalog, to locate time ranges across files and nodes");
+  desc_add("output-archive-stripes",
+           po::value<std::vector<std::string>>(&output_archive_stripes_)
+               ->multitoken()
+               ->value_name("<dir> ..."),
+           "distribute the output archive round-robin across files in the "
+           "given directories, each written on its own thread (requires "
+           "output-archive with extension .tss for the manifest)");
   desc_add(
       "publish,P",
       po::value<std::string>(&publish_address_)->implicit_value("tcp://*:5556"),
-      "enable timeslice publisher on given address");
+      "enable timeslice publisher on given address (udp://group:port for "
+      "best-effort multicast, see TimesliceMulticastPublisher)");
   desc_add("publish-hwm", po::value<uint32_t>(&publish_hwm_),
            "High-water mark for the publisher, in TS, TS drop happens if more "
            "buffered (default: 1)");
+  desc_add("publish-multipart",
+           po::value<bool>(&publish_multipart_)->implicit_value(true),
+           "publish timeslices as zero-copy multipart messages");
+  desc_add("publish-topics",
+           po::value<uint64_t>(&publish_topics_)->value_name("<n>"),
+           "publish timeslices with topics by index modulo n, allowing "
+           "subscribers to receive with a stride dividing n");
   desc_add("maximum-number,n", po::value<uint64_t>(&maximum_number_),
            "set the maximum number of timeslices to process (default: "
            "unlimited)");
@@ -76,6 +187,16 @@ void Parameters::parse_options(int argc, char* argv[]) {
            "limit the item rate to given frequency (in Hz)");
   desc_add("speed", po::value<double>(&native_speed_),
            "limit the item rate to given factor of original speed");
+  desc_add("sink-queue", po::value<size_t>(&sink_queue_)->value_name("<n>"),
+           "run each sink (analyzer, dumper, archive, publisher) on a "
+           "background thread, queueing up to the given number of "
+           "timeslices (default: 0, run sinks on the source thread)");
+  desc_add("sink-drop",
+           po::value<std::vector<std::string>>(&sink_drop_)
+               ->multitoken()
+               ->value_name("<sink> ..."),
+           "discard timeslices instead of waiting if the queue of the given "
+           "sinks is full");
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -108,7 +229,81 @@ void Parameters::parse_options(int argc, char* argv[]) {
   if (input_sources > 1) {
     throw ParametersException("more than one input source specified");
   }
+  if (benchmark_source_ &&
+      (input_sources == 0 || analyze_ || analyze_descriptors_ ||
+       verbosity_ > 0 || !output_archive_.empty() ||
+       !publish_address_.empty())) {
+    throw ParametersException(
+        "benchmark-source requires an input source and no sinks");
+  }
+  if (dump_format_ != "text" && dump_format_ != "json") {
+    throw ParametersException("invalid dump format: " + dump_format_);
+  }
   if (stride_ == 0) {
     throw ParametersException("stride must be greater than zero");
   }
+  const bool raw_archive =
+      boost::algorithm::ends_with(output_archive_, ".tsr") ||
+      boost::algorithm::ends_with(output_archive_, ".tsc");
+  if (raw_archive &&
+      (output_archive_items_ != SIZE_MAX || output_archive_bytes_ != SIZE_MAX ||
+       output_archive_compression_ != fles::ArchiveCompression::None)) {
+    throw ParametersException("raw and descriptor output archives do not "
+                              "support file sequences or compression");
+  }
+  if (!output_archive_stripes_.empty() &&
+      (!boost::algorithm::ends_with(output_archive_, ".tss") ||
+       output_archive_items_ != SIZE_MAX ||
+       output_archive_bytes_ != SIZE_MAX)) {
+    throw ParametersException(
+        "striped output archives require a manifest file name (.tss) and do "
+        "not support file sequences");
+  }
+  if (boost::algorithm::ends_with(output_archive_, ".tss") &&
+      output_archive_stripes_.empty()) {
+    throw ParametersException(
+        "output archive manifest (.tss) requires output-archive-stripes");
+  }
+  if (!output_archive_catalog_.empty() &&
+      (raw_archive || !output_archive_stripes_.empty())) {
+    throw ParametersException("output archive catalog not supported for raw "
+                              "or striped output archives");
+  }
+  if (output_archive_direct_io_ &&
+      boost::algorithm::ends_with(output_archive_, ".tsc")) {
+    throw ParametersException(
+        "direct I/O not supported for descriptor output archives (.tsc)");
+  }
+  if (output_archive_dedup_overlap_ &&
+      !boost::algorithm::ends_with(output_archive_, ".tsr")) {
+    throw ParametersException(
+        "overlap deduplication requires a raw output archive (.tsr)");
+  }
+  if (!output_archive_dictionary_file_.empty()) {
+    if (output_archive_compression_ != fles::ArchiveCompression::Zstd) {
+      throw ParametersException(
+          "output archive dictionary requires zstd compression");
+    }
+    std::ifstream ifs(output_archive_dictionary_file_, std::ios::binary);
+    if (!ifs) {
+      throw ParametersException("cannot open dictionary file " +
+                                output_archive_dictionary_file_);
+    }
+    output_archive_dictionary_.assign(std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>());
+  }
+  for (const auto& sink : sink_drop_) {
+    if (sink != "analyzer" && sink != "verifier" && sink != "dumper" &&
+        sink != "archive" && sink != "publisher") {
+      throw ParametersException("unknown sink: " + sink);
+    }
+  }
+  if (!sink_drop_.empty() && sink_queue_ == 0 && output_archive_queue_ == 0) {
+    throw ParametersException("sink-drop requires a sink queue");
+  }
+}
+
+bool Parameters::sink_drop(const std::string& sink) const {
+  return std::find(sink_drop_.begin(), sink_drop_.end(), sink) !=
+         sink_drop_.end();
 }
@@ -1,9 +1,13 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "ArchiveDescriptor.hpp"
 #include <cstdint>
+#include <istream>
+#include <ostream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 /// Run parameter exception class.
 class ParametersException : public std::runtime_error {
@@ -12,6 +16,12 @@ public:
       : std::runtime_error(what_arg) {}
 };
 
+namespace fles {
+std::istream& operator>>(std::istream& in, ArchiveCompression& compression);
+std::ostream& operator<<(std::ostream& out,
+                         const ArchiveCompression& compression);
+} // namespace fles
+
 /// Global run parameter class.
 class Parameters {
 public:
@@ -36,18 +46,69 @@ public:
     return output_archive_bytes_;
   }
 
+  [[nodiscard]] fles::ArchiveCompression output_archive_compression() const {
+    return output_archive_compression_;
+  }
+
+  /// Retrieve the contents of the output archive compression dictionary.
+  [[nodiscard]] const std::string& output_archive_dictionary() const {
+    return output_archive_dictionary_;
+  }
+
+  [[nodiscard]] size_t output_archive_queue() const {
+    return output_archive_queue_;
+  }
+
+  [[nodiscard]] bool output_archive_direct_io() const {
+    return output_archive_direct_io_;
+  }
+
+  [[nodiscard]] const std::string& output_archive_catalog() const {
+    return output_archive_catalog_;
+  }
+
+  /// Retrieve the directories to stripe the output archive across.
+  [[nodiscard]] const std::vector<std::string>&
+  output_archive_stripes() const {
+    return output_archive_stripes_;
+  }
+
+  [[nodiscard]] bool output_archive_dedup_overlap() const {
+    return output_archive_dedup_overlap_;
+  }
+
   [[nodiscard]] bool analyze() const { return analyze_; }
 
+  [[nodiscard]] bool analyze_descriptors() const {
+    return analyze_descriptors_;
+  }
+
+  [[nodiscard]] unsigned analyze_threads() const { return analyze_threads_; }
+
+  [[nodiscard]] bool verify() const { return verify_; }
+
+  [[nodiscard]] int verify_device() const { return verify_device_; }
+
   [[nodiscard]] bool benchmark() const { return benchmark_; }
 
+  [[nodiscard]] bool benchmark_source() const { return benchmark_source_; }
+
   [[nodiscard]] size_t verbosity() const { return verbosity_; }
 
+  [[nodiscard]] const std::string& dump_format() const { return dump_format_; }
+
+  [[nodiscard]] unsigned dump_threads() const { return dump_threads_; }
+
   [[nodiscard]] bool histograms() const { return histograms_; }
 
   [[nodiscard]] std::string publish_address() const { return publish_address_; }
 
   [[nodiscard]] uint32_t publish_hwm() const { return publish_hwm_; }
 
+  [[nodiscard]] bool publish_multipart() const { return publish_multipart_; }
+
+  [[nodiscard]] uint64_t publish_topics() const { return publish_topics_; }
+
   [[nodiscard]] uint64_t maximum_number() const { return maximum_number_; }
 
   [[nodiscard]] uint64_t offset() const { return offset_; }
@@ -58,6 +119,11 @@ public:
 
   [[nodiscard]] double native_speed() const { return native_speed_; }
 
+  [[nodiscard]] size_t sink_queue() const { return sink_queue_; }
+
+  /// Whether the given sink discards timeslices if its queue is full.
+  [[nodiscard]] bool sink_drop(const std::string& sink) const;
+
 private:
   void parse_options(int argc, char* argv[]);
 
@@ -68,15 +134,35 @@ private:
   std::string output_archive_;
   size_t output_archive_items_ = SIZE_MAX;
   size_t output_archive_bytes_ = SIZE_MAX;
+  fles::ArchiveCompression output_archive_compression_ =
+      fles::ArchiveCompression::None;
+  std::string output_archive_dictionary_file_;
+  std::string output_archive_dictionary_;
+  size_t output_archive_queue_ = 0;
+  bool output_archive_direct_io_ = false;
+  bool output_archive_dedup_overlap_ = false;
+  std::vector<std::string> output_archive_stripes_;
+  std::string output_archive_catalog_;
   bool analyze_ = false;
+  bool analyze_descriptors_ = false;
+  unsigned analyze_threads_ = 1;
+  bool verify_ = false;
+  int verify_device_ = -1;
   bool benchmark_ = false;
+  bool benchmark_source_ = false;
   size_t verbosity_ = 0;
+  std::string dump_format_ = "text";
+  unsigned dump_threads_ = 1;
   bool histograms_ = false;
   std::string publish_address_;
   uint32_t publish_hwm_ = 1;
+  bool publish_multipart_ = false;
+  uint64_t publish_topics_ = 0;
   uint64_t maximum_number_ = UINT64_MAX;
   uint64_t offset_ = 0;
   uint64_t stride_ = 1;
   double rate_limit_ = 0.0;
   double native_speed_ = 0.0;
+  size_t sink_queue_ = 0;
+  std::vector<std::string> sink_drop_;
 };
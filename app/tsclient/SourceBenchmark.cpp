@@ -0,0 +1,116 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "SourceBenchmark.hpp"
+#include "System.hpp"
+#include "log.hpp"
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace {
+double thread_cpu_seconds() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) +
+         static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+} // namespace
+
+void SourceBenchmark::Totals::add(const Totals& other) {
+  count += other.count;
+  bytes += other.bytes;
+  wall_s += other.wall_s;
+  cpu_s += other.cpu_s;
+  latency_ns.Merge(other.latency_ns);
+}
+
+SourceBenchmark::SourceBenchmark(fles::TimesliceSource& source,
+                                 uint64_t limit,
+                                 cbm::Monitor* monitor,
+                                 std::string output_prefix)
+    : source_(source), limit_(limit), monitor_(monitor),
+      output_prefix_(std::move(output_prefix)) {}
+
+void SourceBenchmark::run() {
+  constexpr auto interval = std::chrono::seconds(1);
+  auto begin = std::chrono::steady_clock::now();
+  interval_begin_ = begin;
+
+  while (total_.count + interval_.count < limit_) {
+    auto t0 = std::chrono::steady_clock::now();
+    double cpu0 = thread_cpu_seconds();
+    auto ts = source_.get();
+    double cpu1 = thread_cpu_seconds();
+    auto t1 = std::chrono::steady_clock::now();
+    if (!ts) {
+      break;
+    }
+
+    auto latency =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0);
+    interval_.latency_ns.Record(static_cast<uint64_t>(latency.count()));
+    interval_.wall_s += std::chrono::duration<double>(latency).count();
+    interval_.cpu_s += cpu1 - cpu0;
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      interval_.bytes += ts->size_component(c);
+    }
+    ++interval_.count;
+
+    if (t1 >= interval_begin_ + interval) {
+      report(interval_,
+             std::chrono::duration<double>(t1 - interval_begin_).count(),
+             false);
+      total_.add(interval_);
+      interval_ = Totals();
+      interval_begin_ = t1;
+    }
+  }
+  total_.add(interval_);
+
+  auto end = std::chrono::steady_clock::now();
+  report(total_, std::chrono::duration<double>(end - begin).count(), true);
+}
+
+void SourceBenchmark::report(const Totals& t, double seconds, bool final) {
+  double rate = seconds > 0 ? static_cast<double>(t.count) / seconds : 0;
+  double data_rate =
+      seconds > 0 ? static_cast<double>(t.bytes) / seconds / 1e9 : 0;
+  double wait_s = t.wall_s > t.cpu_s ? t.wall_s - t.cpu_s : 0;
+  auto us = [&t](double percent) {
+    return static_cast<double>(t.latency_ns.Percentile(percent)) / 1e3;
+  };
+
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(1) << output_prefix_
+    << (final ? "source benchmark: " : "source: ") << t.count
+    << " timeslices, " << rate << " ts/s, " << std::setprecision(3)
+    << data_rate << " GB/s, get() us p50/p99/max: " << std::setprecision(1)
+    << us(50) << "/" << us(99) << "/"
+    << static_cast<double>(t.latency_ns.Max()) / 1e3
+    << ", in get(): wait " << wait_s << " s, cpu " << t.cpu_s << " s";
+  if (final) {
+    double loop_s = seconds - t.wall_s;
+    s << ", outside get(): " << (loop_s > 0 ? loop_s : 0) << " s";
+    L_(info) << s.str();
+  } else {
+    L_(status) << s.str();
+  }
+
+  if (monitor_ != nullptr) {
+    const std::string prefix = output_prefix_.empty() ? ":" : output_prefix_;
+    monitor_->QueueMetric(
+        "tsclient_source_benchmark",
+        {{"host", fles::system::current_hostname()},
+         {"output_prefix", prefix}},
+        {{"timeslices", t.count},
+         {"rate", rate},
+         {"gbps", data_rate},
+         {"latency_p50_us", us(50)},
+         {"latency_p99_us", us(99)},
+         {"latency_max_us",
+          static_cast<double>(t.latency_ns.Max()) / 1e3},
+         {"wait_s", wait_s},
+         {"cpu_s", t.cpu_s}});
+  }
+}
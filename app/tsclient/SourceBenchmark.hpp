@@ -0,0 +1,56 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "Histogram.hpp"
+#include "Monitor.hpp"
+#include "TimesliceSource.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/// Throughput benchmark of a timeslice source.
+/** A SourceBenchmark object drains a timeslice source without any sinks
+    and measures the timeslice rate, the data rate and the latency
+    distribution of the get() calls. The time spent in get() is split into
+    CPU time, i.e., mapping or deserializing the timeslices, and the rest,
+    i.e., waiting for items. A slow processing chain can thus be attributed
+    to either its sinks or the transport into it. */
+class SourceBenchmark {
+public:
+  SourceBenchmark(fles::TimesliceSource& source,
+                  uint64_t limit,
+                  cbm::Monitor* monitor,
+                  std::string output_prefix);
+
+  SourceBenchmark(const SourceBenchmark&) = delete;
+  void operator=(const SourceBenchmark&) = delete;
+
+  /// Drain the source and report the results.
+  void run();
+
+  /// Retrieve the number of timeslices read.
+  [[nodiscard]] uint64_t count() const { return total_.count; }
+
+private:
+  /// Measurements over an interval.
+  struct Totals {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    double wall_s = 0; // total time spent in get()
+    double cpu_s = 0;  // CPU time spent in get()
+    cbm::Histogram latency_ns;
+
+    void add(const Totals& other);
+  };
+
+  fles::TimesliceSource& source_;
+  uint64_t limit_;
+  cbm::Monitor* monitor_;
+  std::string output_prefix_;
+
+  Totals total_;
+  Totals interval_;
+  std::chrono::steady_clock::time_point interval_begin_;
+
+  void report(const Totals& t, double seconds, bool final);
+};
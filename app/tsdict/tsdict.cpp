@@ -0,0 +1,119 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Train a zstd compression dictionary on recorded timeslices.
+
+#include "ArchiveBlock.hpp"
+#include "TimesliceAutoSource.hpp"
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+
+int main(int argc, char* argv[]) {
+  std::string input;
+  std::string output;
+  unsigned sys_id = 0;
+  unsigned sys_ver = 0;
+  uint64_t max_timeslices = 100;
+  std::size_t max_sample_bytes = 64 << 20;
+  std::size_t dictionary_size = 112640;
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("input,i",
+           po::value<std::string>(&input)->value_name("<locator>")->required(),
+           "timeslice source to read the samples from");
+  desc_add("output,o",
+           po::value<std::string>(&output)->value_name("<file>")->required(),
+           "file to write the dictionary to");
+  desc_add("sys-id", po::value<unsigned>(&sys_id)->value_name("<id>"),
+           "only use components of the given subsystem identifier");
+  desc_add("sys-ver", po::value<unsigned>(&sys_ver)->value_name("<ver>"),
+           "only use components of the given subsystem format version");
+  desc_add("max-timeslices,n",
+           po::value<uint64_t>(&max_timeslices)
+               ->value_name("<n>")
+               ->default_value(max_timeslices),
+           "maximum number of timeslices to read");
+  desc_add("max-sample-bytes",
+           po::value<std::size_t>(&max_sample_bytes)
+               ->value_name("<n>")
+               ->default_value(max_sample_bytes),
+           "maximum total size of the samples");
+  desc_add("size",
+           po::value<std::size_t>(&dictionary_size)
+               ->value_name("<n>")
+               ->default_value(dictionary_size),
+           "maximum size of the dictionary");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Trains a zstd dictionary on the microslice contents of "
+                   "recorded timeslices\nfor use with compressed timeslice "
+                   "archives.\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  bool filter_id = vm.count("sys-id") != 0u;
+  bool filter_ver = vm.count("sys-ver") != 0u;
+
+  try {
+    // each microslice is a sample, as its content is what recurs between
+    // the data sets of an archive
+    std::vector<std::string> samples;
+    std::size_t sample_bytes = 0;
+    fles::TimesliceAutoSource source(input);
+    uint64_t count = 0;
+    while (count < max_timeslices && sample_bytes < max_sample_bytes) {
+      auto ts = source.get();
+      if (!ts) {
+        break;
+      }
+      ++count;
+      for (uint64_t c = 0; c < ts->num_components(); ++c) {
+        for (uint64_t m = 0; m < ts->num_microslices(c); ++m) {
+          const fles::MicrosliceDescriptor& md = ts->descriptor(c, m);
+          if ((filter_id && md.sys_id != sys_id) ||
+              (filter_ver && md.sys_ver != sys_ver) || md.size == 0) {
+            continue;
+          }
+          const auto* content =
+              reinterpret_cast<const char*>(ts->content(c, m));
+          samples.emplace_back(content, md.size);
+          sample_bytes += md.size;
+        }
+      }
+    }
+    if (samples.empty()) {
+      throw std::runtime_error("no matching microslices found");
+    }
+
+    std::string dictionary =
+        fles::train_compression_dictionary(samples, dictionary_size);
+    std::ofstream ofs(output, std::ios::binary);
+    ofs.write(dictionary.data(),
+              static_cast<std::streamsize>(dictionary.size()));
+    if (!ofs) {
+      throw std::runtime_error("cannot write " + output);
+    }
+    std::cout << "trained dictionary of " << dictionary.size()
+              << " bytes on " << samples.size() << " microslices ("
+              << sample_bytes << " bytes) from " << count << " timeslices"
+              << std::endl;
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Extract a range of timeslices and a subset of their components.
+
+#include "ArchiveCatalog.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include "TimesliceRangeArchive.hpp"
+#include "TimesliceRawOutputArchive.hpp"
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> inputs;
+  std::string output;
+  std::string compression = "none";
+  uint64_t from = 0;
+  uint64_t to = UINT64_MAX;
+  std::string component;
+  std::string sys_id;
+  std::string eq_id;
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("input,i",
+           po::value<std::vector<std::string>>(&inputs)
+               ->value_name("<file>")
+               ->required(),
+           "archive file (.tsa/.tsr) or catalog (.cat) to read");
+  desc_add("output,o",
+           po::value<std::string>(&output)->value_name("<file>")->required(),
+           "archive file to write (.tsa, or .tsr for the raw format)");
+  desc_add("compression",
+           po::value<std::string>(&compression)
+               ->value_name("<id>")
+               ->default_value(compression),
+           "output archive compression (.tsa): none, zstd");
+  desc_add("from", po::value<uint64_t>(&from)->value_name("<time>"),
+           "first timeslice start time (ns) to extract");
+  desc_add("to", po::value<uint64_t>(&to)->value_name("<time>"),
+           "end of the start time range (exclusive)");
+  desc_add("from-index", po::value<uint64_t>(&from)->value_name("<n>"),
+           "first timeslice index to extract");
+  desc_add("to-index", po::value<uint64_t>(&to)->value_name("<n>"),
+           "end of the index range (exclusive)");
+  desc_add("component", po::value<std::string>(&component)->value_name("<n>"),
+           "extract the components with the given indexes (comma-separated)");
+  desc_add("sys-id", po::value<std::string>(&sys_id)->value_name("<id>"),
+           "extract the components with the given subsystem identifiers");
+  desc_add("eq-id", po::value<std::string>(&eq_id)->value_name("<id>"),
+           "extract the components with the given equipment identifiers");
+  po::positional_options_description pos;
+  pos.add("input", -1);
+
+  po::variables_map vm;
+  fles::ComponentSelection selection;
+  fles::ArchiveCompression output_compression = fles::ArchiveCompression::None;
+  fles::RangeKey key = fles::RangeKey::StartTime;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(pos)
+                  .run(),
+              vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Extracts the timeslices of a start time or index range, "
+                   "and optionally\nonly some of their components, from "
+                   "archive files. Indexed and raw\narchives are read only "
+                   "from the start of the range, and catalogs select\nthe "
+                   "files containing it.\n\nUsage: "
+                << argv[0] << " [options] -o <file> <file>...\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+
+    bool by_time = vm.count("from") != 0u || vm.count("to") != 0u;
+    bool by_index = vm.count("from-index") != 0u || vm.count("to-index") != 0u;
+    if (by_time && by_index) {
+      throw std::invalid_argument(
+          "time and index ranges cannot be combined");
+    }
+    if (by_index) {
+      key = fles::RangeKey::Index;
+    }
+    if (!component.empty()) {
+      selection.parse("component", component);
+    }
+    if (!sys_id.empty()) {
+      selection.parse("sys_id", sys_id);
+    }
+    if (!eq_id.empty()) {
+      selection.parse("eq_id", eq_id);
+    }
+    if (compression == "zstd") {
+      output_compression = fles::ArchiveCompression::Zstd;
+    } else if (compression != "none") {
+      throw std::invalid_argument("unknown compression: " + compression);
+    }
+    if (boost::algorithm::ends_with(output, ".tsr") &&
+        output_compression != fles::ArchiveCompression::None) {
+      throw std::invalid_argument("raw output archives do not support "
+                                  "compression");
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    auto start = std::chrono::steady_clock::now();
+
+    // only the files of a catalog containing the range are read
+    std::vector<std::string> files;
+    fles::ArchiveCatalog catalog;
+    for (const auto& input : inputs) {
+      if (boost::algorithm::ends_with(input, ".cat")) {
+        catalog.load(input);
+      } else {
+        files.push_back(input);
+      }
+    }
+    if (!catalog.entries().empty()) {
+      auto entries = key == fles::RangeKey::Index
+                         ? catalog.find_index(from, to)
+                         : catalog.find_time(from, to);
+      for (const auto& entry : entries) {
+        files.push_back(entry.filename);
+      }
+    }
+
+    std::unique_ptr<fles::TimesliceSink> sink;
+    if (boost::algorithm::ends_with(output, ".tsr")) {
+      // the selected data is written directly from the input mapping
+      sink = std::make_unique<fles::TimesliceRawOutputArchive>(output);
+    } else {
+      sink = std::make_unique<fles::TimesliceOutputArchive>(
+          output, output_compression);
+    }
+
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    for (const auto& file : files) {
+      fles::TimesliceRangeArchive source(file, from, to, selection, key);
+      while (auto timeslice = source.get()) {
+        for (uint64_t c = 0; c < timeslice->num_components(); ++c) {
+          bytes += timeslice->size_component(c);
+        }
+        sink->put(std::shared_ptr<const fles::Timeslice>(std::move(timeslice)));
+        ++count;
+      }
+    }
+    sink->end_stream();
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "extracted " << count << " timeslices (" << bytes
+              << " bytes of components) from " << files.size()
+              << " files to " << output << " in " << std::fixed
+              << std::setprecision(2) << elapsed.count() << " s" << std::endl;
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
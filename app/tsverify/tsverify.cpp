@@ -0,0 +1,464 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Verify the integrity of timeslice archive files in parallel.
+
+#include "ArchiveBlock.hpp"
+#include "ArchiveCatalog.hpp"
+#include "PatternChecker.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
+#include "Utility.hpp"
+#include "interface.h" // crcutil_interface
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+
+namespace {
+
+struct Options {
+  std::vector<std::string> inputs;
+  /// Index of the sequence (input argument) of each input file.
+  std::vector<std::size_t> sequences;
+  /// Number of timeslices listed in a catalog for each input file, if any.
+  std::vector<uint64_t> counts;
+  std::size_t jobs = 1;
+  uint64_t stride = 1;
+  bool crc = true;
+  bool pattern = false;
+  std::string report;
+};
+
+/// The result of verifying one archive file.
+struct FileResult {
+  std::string filename;
+  std::string error; ///< read error (broken framing), empty if none
+  uint64_t expected = UINT64_MAX; ///< timeslices listed in index or catalog
+  uint64_t timeslices = 0;
+  uint64_t microslices = 0;
+  uint64_t bytes = 0; ///< content bytes
+  uint64_t first_index = 0;
+  uint64_t last_index = 0;
+  uint64_t index_gaps = 0;   ///< discontinuities of the timeslice index
+  uint64_t missing = 0;      ///< timeslices missing in the gaps
+  bool boundary_gap = false; ///< discontinuity to the previous file
+  uint64_t blocks = 0;       ///< compressed blocks checked
+  uint64_t corrupt_blocks = 0;
+  uint64_t crc_checked = 0;
+  uint64_t crc_errors = 0;
+  uint64_t pattern_errors = 0;
+  double seconds = 0;
+
+  [[nodiscard]] bool ok() const {
+    return error.empty() && index_gaps == 0 && !boundary_gap &&
+           corrupt_blocks == 0 && crc_errors == 0 && pattern_errors == 0;
+  }
+};
+
+/// Expand the inputs to the list of archive files, in sequence order.
+/** Catalogs (.cat) are replaced by their files in ascending order of the
+    first index, and templates containing "%n" by the existing files of the
+    sequence, as read by InputArchiveSequence. */
+void expand_inputs(Options& opt) {
+  std::vector<std::string> files;
+  std::vector<std::size_t> sequences;
+  std::vector<uint64_t> counts;
+  for (std::size_t i = 0; i < opt.inputs.size(); ++i) {
+    const std::string& input = opt.inputs[i];
+    if (boost::algorithm::ends_with(input, ".cat")) {
+      fles::ArchiveCatalog catalog;
+      catalog.load(input);
+      for (const auto& entry : catalog.find_index(0, UINT64_MAX)) {
+        files.push_back(entry.filename);
+        counts.push_back(entry.count);
+      }
+    } else if (input.find("%n") != std::string::npos) {
+      std::size_t count = 0;
+      for (std::size_t n = 0;; ++n) {
+        std::ostringstream number;
+        number << std::setw(4) << std::setfill('0') << n;
+        auto file = boost::replace_all_copy(input, "%n", number.str());
+        if (!boost::filesystem::exists(file)) {
+          break;
+        }
+        files.push_back(file);
+        ++count;
+      }
+      if (count == 0) {
+        throw std::invalid_argument("no files found for " + input);
+      }
+    } else {
+      files.push_back(input);
+    }
+    sequences.resize(files.size(), i);
+    counts.resize(files.size(), UINT64_MAX);
+  }
+  opt.inputs = std::move(files);
+  opt.sequences = std::move(sequences);
+  opt.counts = std::move(counts);
+}
+
+/// The state of a verification thread.
+class Verifier {
+public:
+  explicit Verifier(const Options& opt) : opt_(opt) {
+    // create CRC-32C engine (Castagnoli polynomial)
+    crc32_engine_ = crcutil_interface::CRC::Create(
+        0x82f63b78, 0, 32, true, 0, 0, 0,
+        crcutil_interface::CRC::IsSSE42Available(), nullptr);
+  }
+
+  Verifier(const Verifier&) = delete;
+  void operator=(const Verifier&) = delete;
+
+  ~Verifier() { crc32_engine_->Delete(); }
+
+  /// Verify an archive file, reading it from start to end.
+  void verify(FileResult& r) {
+    auto start = std::chrono::steady_clock::now();
+    checkers_.clear();
+    try {
+      std::unique_ptr<fles::TimesliceSource> source;
+      if (boost::algorithm::ends_with(r.filename, ".tsr")) {
+        source = std::make_unique<fles::TimesliceMappedArchive>(r.filename);
+      } else {
+        auto archive =
+            std::make_unique<fles::TimesliceInputArchive>(r.filename);
+        if (archive->descriptor().archive_compression() !=
+            fles::ArchiveCompression::None) {
+          auto blocks = fles::verify_archive_blocks(r.filename, 1);
+          r.blocks = blocks.blocks;
+          r.corrupt_blocks = blocks.corrupt;
+        }
+        if (archive->has_index()) {
+          r.expected = archive->index().size();
+        }
+        source = std::move(archive);
+      }
+      while (auto ts = source->get()) {
+        check_timeslice(*ts, r);
+      }
+      // a truncated archive ends like a complete one
+      if (r.expected != UINT64_MAX && r.timeslices != r.expected) {
+        r.error = "archive truncated, " + std::to_string(r.expected) +
+                  " timeslices expected";
+      }
+    } catch (std::exception& e) {
+      r.error = e.what();
+    }
+    r.seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+  }
+
+private:
+  void check_timeslice(const fles::Timeslice& ts, FileResult& r) {
+    if (r.timeslices == 0) {
+      r.first_index = ts.index();
+    } else if (ts.index() != r.last_index + opt_.stride) {
+      ++r.index_gaps;
+      if (ts.index() > r.last_index) {
+        r.missing += (ts.index() - r.last_index) / opt_.stride - 1;
+      }
+    }
+    r.last_index = ts.index();
+    ++r.timeslices;
+
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      uint64_t count = ts.num_microslices(c);
+      r.microslices += count;
+      for (uint64_t m = 0; m < count; ++m) {
+        r.bytes += ts.descriptor(c, m).size;
+      }
+      if (opt_.crc) {
+        check_crcs(ts, c, r);
+      }
+      if (opt_.pattern) {
+        check_pattern(ts, c, r);
+      }
+    }
+  }
+
+  /// Check the content CRCs of all microslices of a component in one batch.
+  void check_crcs(const fles::Timeslice& ts, uint64_t c, FileResult& r) {
+    constexpr auto crc_valid =
+        static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+    std::size_t count = ts.num_microslices(c);
+    crc_data_.resize(count);
+    crc_bytes_.resize(count);
+    crcs_.assign(count, 0);
+    for (std::size_t m = 0; m < count; ++m) {
+      const fles::MicrosliceDescriptor& desc = ts.descriptor(c, m);
+      crc_data_[m] = ts.content(c, m);
+      crc_bytes_[m] = (desc.flags & crc_valid) != 0 ? desc.size : 0;
+    }
+    crc32_engine_->ComputeBatch(crc_data_.data(), crc_bytes_.data(), count,
+                                crcs_.data());
+    for (std::size_t m = 0; m < count; ++m) {
+      const fles::MicrosliceDescriptor& desc = ts.descriptor(c, m);
+      if ((desc.flags & crc_valid) == 0) {
+        continue;
+      }
+      ++r.crc_checked;
+      if (static_cast<uint32_t>(crcs_[m]) != desc.crc) {
+        ++r.crc_errors;
+      }
+    }
+  }
+
+  /// Check the content pattern of all microslices of a component.
+  void check_pattern(const fles::Timeslice& ts, uint64_t c, FileResult& r) {
+    if (ts.num_microslices(c) == 0) {
+      return;
+    }
+    if (checkers_.size() <= c) {
+      checkers_.resize(c + 1);
+    }
+    if (!checkers_[c]) {
+      const auto& desc = ts.descriptor(c, 0);
+      checkers_[c] = PatternChecker::create(desc.sys_id, desc.sys_ver, c);
+    }
+    for (uint64_t m = 0; m < ts.num_microslices(c); ++m) {
+      if (!checkers_[c]->check(ts.get_microslice(c, m))) {
+        ++r.pattern_errors;
+      }
+    }
+  }
+
+  const Options& opt_;
+  crcutil_interface::CRC* crc32_engine_ = nullptr;
+  std::vector<const void*> crc_data_;
+  std::vector<std::size_t> crc_bytes_;
+  std::vector<crcutil_interface::UINT64> crcs_;
+  std::vector<std::unique_ptr<PatternChecker>> checkers_;
+};
+
+std::string summary(const FileResult& r) {
+  std::ostringstream s;
+  s << r.filename << ": ";
+  if (r.timeslices != 0) {
+    s << "timeslices " << r.first_index << ".." << r.last_index << ", ";
+  }
+  s << r.timeslices << " timeslices, " << r.microslices << " microslices";
+  if (r.index_gaps != 0) {
+    s << ", " << r.index_gaps << " index gaps (" << r.missing << " missing)";
+  }
+  if (r.blocks != 0) {
+    s << ", " << r.corrupt_blocks << "/" << r.blocks << " blocks corrupt";
+  }
+  if (r.crc_checked != 0) {
+    s << ", " << r.crc_errors << "/" << r.crc_checked << " crc errors";
+  }
+  if (r.pattern_errors != 0) {
+    s << ", " << r.pattern_errors << " pattern errors";
+  }
+  s << " (" << std::fixed << std::setprecision(1)
+    << (r.seconds > 0 ? static_cast<double>(r.bytes) / r.seconds / 1e6 : 0)
+    << " MB/s)";
+  if (!r.error.empty()) {
+    s << ", read error: " << r.error;
+  }
+  return s.str();
+}
+
+std::string json_string(const std::string& s) {
+  std::string r = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      r += '\\';
+    }
+    if (static_cast<unsigned char>(c) >= 0x20) {
+      r += c;
+    }
+  }
+  return r + "\"";
+}
+
+/// Write the results as a JSON document.
+void write_report(std::ostream& s,
+                  const std::vector<FileResult>& results,
+                  bool ok,
+                  double seconds) {
+  FileResult total;
+  s << "{\"files\":[";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const FileResult& r = results[i];
+    s << (i == 0 ? "" : ",") << "\n {\"filename\":" << json_string(r.filename)
+      << ",\"ok\":" << (r.ok() ? "true" : "false")
+      << ",\"timeslices\":" << r.timeslices
+      << ",\"microslices\":" << r.microslices << ",\"bytes\":" << r.bytes;
+    if (r.timeslices != 0) {
+      s << ",\"first_index\":" << r.first_index
+        << ",\"last_index\":" << r.last_index;
+    }
+    s << ",\"index_gaps\":" << r.index_gaps << ",\"missing\":" << r.missing
+      << ",\"boundary_gap\":" << (r.boundary_gap ? "true" : "false")
+      << ",\"blocks\":" << r.blocks
+      << ",\"corrupt_blocks\":" << r.corrupt_blocks
+      << ",\"crc_checked\":" << r.crc_checked
+      << ",\"crc_errors\":" << r.crc_errors
+      << ",\"pattern_errors\":" << r.pattern_errors
+      << ",\"seconds\":" << r.seconds;
+    if (!r.error.empty()) {
+      s << ",\"error\":" << json_string(r.error);
+    }
+    s << "}";
+    total.timeslices += r.timeslices;
+    total.microslices += r.microslices;
+    total.bytes += r.bytes;
+    total.crc_errors += r.crc_errors;
+    total.pattern_errors += r.pattern_errors;
+  }
+  s << "],\n \"ok\":" << (ok ? "true" : "false")
+    << ",\"timeslices\":" << total.timeslices
+    << ",\"microslices\":" << total.microslices
+    << ",\"bytes\":" << total.bytes << ",\"crc_errors\":" << total.crc_errors
+    << ",\"pattern_errors\":" << total.pattern_errors
+    << ",\"seconds\":" << seconds << "}\n";
+}
+
+/// Verify all files, several files in parallel.
+bool verify_files(const Options& opt) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<FileResult> results(opt.inputs.size());
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    results[i].filename = opt.inputs[i];
+    results[i].expected = opt.counts[i];
+  }
+
+  std::atomic<std::size_t> next{0};
+  auto worker = [&opt, &next, &results] {
+    Verifier verifier(opt);
+    for (std::size_t i = next++; i < results.size(); i = next++) {
+      verifier.verify(results[i]);
+      print_line(summary(results[i]));
+    }
+  };
+  std::vector<std::thread> threads;
+  std::size_t jobs = std::min(opt.jobs, results.size());
+  for (std::size_t j = 1; j < jobs; ++j) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // continuity across the files of a sequence (or catalog)
+  for (std::size_t i = 1; i < results.size(); ++i) {
+    const FileResult& previous = results[i - 1];
+    FileResult& r = results[i];
+    if (opt.sequences[i] == opt.sequences[i - 1] &&
+        previous.timeslices != 0 && r.timeslices != 0 &&
+        r.first_index != previous.last_index + opt.stride) {
+      r.boundary_gap = true;
+      print_line(r.filename + ": index gap to previous file (" +
+                 std::to_string(previous.last_index) + " -> " +
+                 std::to_string(r.first_index) + ")");
+    }
+  }
+
+  std::size_t failed = static_cast<std::size_t>(
+      std::count_if(results.begin(), results.end(),
+                    [](const FileResult& r) { return !r.ok(); }));
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  print_line(std::to_string(results.size()) + " files verified, " +
+             std::to_string(failed) + " with errors");
+
+  if (!opt.report.empty()) {
+    std::ofstream report(opt.report);
+    write_report(report, results, failed == 0, elapsed.count());
+    if (!report) {
+      std::cerr << "cannot write report: " << opt.report << std::endl;
+      return false;
+    }
+  }
+  return failed == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  Options opt;
+  opt.jobs = std::max(1U, std::thread::hardware_concurrency());
+  bool no_crc = false;
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("input,i",
+           po::value<std::vector<std::string>>(&opt.inputs)
+               ->value_name("<file>")
+               ->required(),
+           "archive file (.tsa/.tsr), file sequence (containing %n) or "
+           "catalog (.cat) to verify");
+  desc_add("jobs,j",
+           po::value<std::size_t>(&opt.jobs)
+               ->value_name("<n>")
+               ->default_value(opt.jobs),
+           "number of files verified in parallel");
+  desc_add("stride",
+           po::value<uint64_t>(&opt.stride)
+               ->value_name("<n>")
+               ->default_value(opt.stride),
+           "expected difference of consecutive timeslice indexes");
+  desc_add("no-crc", po::bool_switch(&no_crc),
+           "do not check the microslice content CRCs");
+  desc_add("pattern", po::bool_switch(&opt.pattern),
+           "check the content of test pattern microslices");
+  desc_add("report,r",
+           po::value<std::string>(&opt.report)->value_name("<file>"),
+           "write a report of the results in JSON format");
+  po::positional_options_description pos;
+  pos.add("input", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(pos)
+                  .run(),
+              vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Verifies timeslice archive files: the archive framing "
+                   "and block digests,\nthe continuity of the timeslice "
+                   "indexes (also across the files of a\nsequence), the "
+                   "microslice content CRCs and, optionally, test patterns.\n"
+                   "Several files are verified in parallel.\n\nUsage: "
+                << argv[0] << " [options] <file>...\n\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+    opt.crc = !no_crc;
+    if (opt.stride == 0) {
+      throw std::invalid_argument("stride must be greater than zero");
+    }
+    expand_inputs(opt);
+    for (const auto& input : opt.inputs) {
+      if (!boost::algorithm::ends_with(input, ".tsa") &&
+          !boost::algorithm::ends_with(input, ".tsr")) {
+        throw std::invalid_argument("not a timeslice archive: " + input);
+      }
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return verify_files(opt) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
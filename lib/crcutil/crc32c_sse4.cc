@@ -275,6 +275,44 @@ size_t Crc32cSSE4::Crc32c(const void *data, size_t bytes, Crc crc0) const {
   return (crc0 ^ Base().Canonize());
 }
 
+void Crc32cSSE4::CrcDefaultBatch(const void *const *data,
+                                 const size_t *bytes,
+                                 size_t count,
+                                 uint64 *crcs) const {
+  size_t i = 0;
+  for (; i + 3 <= count; i += 3) {
+    const uint8 *src0 = static_cast<const uint8 *>(data[i]);
+    const uint8 *src1 = static_cast<const uint8 *>(data[i + 1]);
+    const uint8 *src2 = static_cast<const uint8 *>(data[i + 2]);
+
+    // Process the words common to all three buffers in lockstep.
+    size_t common = bytes[i];
+    if (bytes[i + 1] < common) common = bytes[i + 1];
+    if (bytes[i + 2] < common) common = bytes[i + 2];
+    common &= ~(sizeof(size_t) - 1);
+
+    Crc crc0 = static_cast<Crc>(crcs[i]) ^ Base().Canonize();
+    Crc crc1 = static_cast<Crc>(crcs[i + 1]) ^ Base().Canonize();
+    Crc crc2 = static_cast<Crc>(crcs[i + 2]) ^ Base().Canonize();
+    for (size_t offset = 0; offset < common; offset += sizeof(size_t)) {
+      CRC_UPDATE_WORD(crc0, *reinterpret_cast<const size_t *>(src0 + offset));
+      CRC_UPDATE_WORD(crc1, *reinterpret_cast<const size_t *>(src1 + offset));
+      CRC_UPDATE_WORD(crc2, *reinterpret_cast<const size_t *>(src2 + offset));
+    }
+
+    // Finish the remainder of each buffer on its own.
+    crcs[i] = Crc32c(src0 + common, bytes[i] - common,
+                     crc0 ^ Base().Canonize());
+    crcs[i + 1] = Crc32c(src1 + common, bytes[i + 1] - common,
+                         crc1 ^ Base().Canonize());
+    crcs[i + 2] = Crc32c(src2 + common, bytes[i + 2] - common,
+                         crc2 ^ Base().Canonize());
+  }
+  for (; i < count; ++i) {
+    crcs[i] = Crc32c(data[i], bytes[i], static_cast<Crc>(crcs[i]));
+  }
+}
+
 
 void Crc32cSSE4::Init(bool constant) {
   base_.Init(FixedGeneratingPolynomial(), FixedDegree(), constant);
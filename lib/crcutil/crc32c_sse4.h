@@ -153,6 +153,15 @@ class Crc32cSSE4 {
     return Crc32c(data, bytes, crc);
   }
 
+  // Computes CRC32 of "count" independent buffers: crcs[i] is updated
+  // with CRC of "bytes[i]" bytes at "data[i]". Buffers are processed
+  // three at a time, interleaving their crc32 instructions to hide
+  // instruction latency as Crc32c() does with stripes of large inputs.
+  void CrcDefaultBatch(const void *const *data,
+                       const size_t *bytes,
+                       size_t count,
+                       uint64 *crcs) const;
+
   // Returns true iff crc32 instruction is available.
   static bool IsSSE42Available();
 
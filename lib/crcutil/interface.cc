@@ -115,6 +115,13 @@ template<typename CrcImplementation, typename RollingCrcImplementation>
     SetValue(crc_.CrcDefault(data, bytes, GetValue(lo, hi)), lo, hi);
   }
 
+  virtual void ComputeBatch(const void *const *data,
+                            const size_t *bytes,
+                            size_t count,
+                            /* INOUT */ UINT64 *crcs) const {
+    BatchCompute(crc_, data, bytes, count, crcs);
+  }
+
   virtual void RollStart(const void *data,
                          /* INOUT */ UINT64 *lo,
                          /* INOUT */ UINT64 *hi = NULL) const {
@@ -182,6 +189,31 @@ template<typename CrcImplementation, typename RollingCrcImplementation>
   }
 
  private:
+  // Computes CRC of each chunk separately.
+  template<typename AnyCrcImplementation>
+  void BatchCompute(const AnyCrcImplementation &,
+                    const void *const *data,
+                    const size_t *bytes,
+                    size_t count,
+                    UINT64 *crcs) const {
+    for (size_t i = 0; i < count; ++i) {
+      UINT64 hi = 0;
+      Compute(data[i], bytes[i], &crcs[i], &hi);
+    }
+  }
+
+#if HAVE_I386 || HAVE_AMD64
+  // Interleaves the computation of several chunks.
+  static void BatchCompute(const Crc32cSSE4 &crc,
+                           const void *const *data,
+                           const size_t *bytes,
+                           size_t count,
+                           UINT64 *crcs) {
+    crc.CrcDefaultBatch(data, bytes, count,
+                        reinterpret_cast<crcutil::uint64 *>(crcs));
+  }
+#endif  // HAVE_I386 || HAVE_AMD64
+
   static Crc GetValue(UINT64 *lo, UINT64 *hi) {
     if (sizeof(Crc) <= sizeof(*lo)) {
       return CrcFromUint64<Crc>(*lo);
@@ -110,6 +110,17 @@ class CRC {
                        /* INOUT */ UINT64 *lo,
                        /* INOUT */ UINT64 *hi = NULL) const = 0;
 
+  // Extends CRC values of "count" independent chunks of data at once:
+  // same as calling Compute(data[i], bytes[i], &crcs[i]) for each chunk,
+  // but implementations may interleave the computation of several chunks.
+  //
+  // Only CRC values of up to 64 bits are supported; for polynomials of
+  // higher degree, the upper halves are assumed to start as zero.
+  virtual void ComputeBatch(const void *const *data,
+                            const size_t *bytes,
+                            size_t count,
+                            /* INOUT */ UINT64 *crcs) const = 0;
+
   // Starts rolling CRC by computing CRC of first
   // "roll_length" bytes of "data", using "roll_start_value"
   // as starting value (see Create()).
@@ -9,6 +9,7 @@
 
 #include "cri_channel.hpp"
 #include <arpa/inet.h> // ntohl
+#include <array>
 #include <cassert>
 #include <memory>
 
@@ -30,11 +31,12 @@ cri_channel::~cri_channel() { deinit_dma(); }
 void cri_channel::init_dma(void* data_buffer,
                            size_t data_buffer_log_size,
                            void* desc_buffer,
-                           size_t desc_buffer_log_size) {
+                           size_t desc_buffer_log_size,
+                           bool persistent_buffers) {
 
   m_dma_channel = std::make_unique<dma_channel>(
       this, data_buffer, data_buffer_log_size, desc_buffer,
-                      desc_buffer_log_size, DMA_TRANSFER_SIZE);
+      desc_buffer_log_size, DMA_TRANSFER_SIZE, persistent_buffers);
 }
 
 void cri_channel::deinit_dma() { m_dma_channel = nullptr; }
@@ -177,17 +179,25 @@ uint32_t cri_channel::get_microslice_cnt() {
 }
 
 cri_channel::ch_perf_t cri_channel::get_perf() {
-  ch_perf_t perf;
   // capture and rest perf counters
   set_perf_cnt(true, true);
-  // return shadowed counters
-  perf.cycles = get_perf_cycles();
-  perf.dma_trans = get_dma_trans();
-  perf.dma_stall = get_dma_stall();
-  perf.dma_busy = get_dma_busy();
-  perf.data_buf_stall = get_data_buf_stall();
-  perf.desc_buf_stall = get_desc_buf_stall();
-  perf.microslice_cnt = get_microslice_cnt();
+  return read_perf();
+}
+
+// read the counters captured last, in one batch
+cri_channel::ch_perf_t cri_channel::read_perf() {
+  ch_perf_t perf;
+  static_assert(CRI_REG_PKT_PERF_N_EVENTS - CRI_REG_PKT_PERF_CYCLE == 6,
+                "packetizer perf registers not contiguous");
+  std::array<uint32_t, 7> reg{};
+  m_rfpkt->get_mem(CRI_REG_PKT_PERF_CYCLE, reg.data(), reg.size());
+  perf.cycles = reg[0];
+  perf.dma_trans = reg[1];
+  perf.dma_stall = reg[2];
+  perf.dma_busy = reg[3];
+  perf.data_buf_stall = reg[4];
+  perf.desc_buf_stall = reg[5];
+  perf.microslice_cnt = reg[6];
   return perf;
 }
 
@@ -221,14 +231,22 @@ uint32_t cri_channel::get_mc_busy() {
 }
 
 cri_channel::ch_perf_gtx_t cri_channel::get_perf_gtx() {
-  ch_perf_gtx_t perf;
   // capture and rest perf counters
   set_perf_gtx_cnt(true, true);
-  // return shadowed counters
-  perf.cycles = get_perf_gtx_cycles();
-  perf.mc_trans = get_mc_trans();
-  perf.mc_stall = get_mc_stall();
-  perf.mc_busy = get_mc_busy();
+  return read_perf_gtx();
+}
+
+// read the counters captured last, in one batch
+cri_channel::ch_perf_gtx_t cri_channel::read_perf_gtx() {
+  ch_perf_gtx_t perf;
+  static_assert(CRI_REG_GTX_PERF_MC_BUSY - CRI_REG_GTX_PERF_CYCLE == 3,
+                "gtx perf registers not contiguous");
+  std::array<uint32_t, 4> reg{};
+  m_rfgtx->get_mem(CRI_REG_GTX_PERF_CYCLE, reg.data(), reg.size());
+  perf.cycles = reg[0];
+  perf.mc_trans = reg[1];
+  perf.mc_stall = reg[2];
+  perf.mc_busy = reg[3];
   return perf;
 }
 
@@ -35,7 +35,8 @@ public:
   void init_dma(void* data_buffer,
                 size_t data_buffer_log_size,
                 void* desc_buffer,
-                size_t desc_buffer_log_size);
+                size_t desc_buffer_log_size,
+                bool persistent_buffers = false);
 
   void deinit_dma();
 
@@ -73,6 +74,7 @@ public:
   };
 
   ch_perf_t get_perf();
+  ch_perf_t read_perf();
 
   void set_perf_cnt(bool capture, bool reset);
   uint32_t get_perf_cycles();
@@ -92,6 +94,7 @@ public:
   };
 
   ch_perf_gtx_t get_perf_gtx();
+  ch_perf_gtx_t read_perf_gtx();
 
   void set_perf_gtx_cnt(bool capture, bool reset);
   uint32_t get_perf_gtx_cycles();
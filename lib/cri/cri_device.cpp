@@ -14,8 +14,10 @@
 #include "register_file_bar.hpp"
 #include <arpa/inet.h> // ntohl
 #include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <memory>
+#include <sstream>
 
 namespace cri {
 
@@ -36,6 +38,13 @@ cri_device::cri_device(uint8_t bus, uint8_t device, uint8_t function) {
 
 cri_device::~cri_device() = default;
 
+void cri_device::keep_dma_buffers(bool keep) {
+  if (m_device_op) {
+    m_device_op->keep_persistent_buffers(keep);
+  }
+  m_device->keep_persistent_buffers(keep);
+}
+
 void cri_device::init() {
   m_bar = std::make_unique<pda::pci_bar>(m_device.get(), 0);
   // register file access
@@ -187,6 +196,22 @@ std::string cri_device::print_devinfo() {
   return ss.str();
 }
 
+// NUMA node the device is attached to, -1 if unknown
+int cri_device::numa_node() {
+  std::stringstream path;
+  path << "/sys/bus/pci/devices/" << std::hex << std::setfill('0')
+       << std::setw(4) << m_device->domain() << ":" << std::setw(2)
+       << static_cast<unsigned>(m_device->bus()) << ":" << std::setw(2)
+       << static_cast<unsigned>(m_device->slot()) << "."
+       << static_cast<unsigned>(m_device->func()) << "/numa_node";
+  std::ifstream ifs(path.str());
+  int node = -1;
+  if (!(ifs >> node)) {
+    return -1;
+  }
+  return node;
+}
+
 std::chrono::seconds cri_device::uptime() {
   std::chrono::duration<double, std::ratio<1, pci_clk>> uptime(
       static_cast<uint64_t>(m_register_file->get_reg(CRI_REG_UPTIME)) << 24);
@@ -285,18 +310,48 @@ float cri_device::get_pci_max_stall() {
 }
 
 cri_device::dev_perf_t cri_device::get_perf() {
-  dev_perf_t perf;
   // capture and rest perf counters
   set_perf_cnt(true, true);
-  // return shadowed counters
-  perf.cycles = get_perf_cycles();
-  perf.pci_trans = get_pci_trans();
-  perf.pci_stall = get_pci_stall();
-  perf.pci_busy = get_pci_busy();
-  perf.pci_max_stall = get_pci_max_stall();
+  return read_perf();
+}
+
+// read the counters captured last, in one batch
+cri_device::dev_perf_t cri_device::read_perf() {
+  dev_perf_t perf;
+  static_assert(CRI_REG_PCI_PERF_DMA_MAX_NRDY - CRI_REG_PCI_PERF_CYCLE == 4,
+                "pci perf registers not contiguous");
+  std::array<uint32_t, 5> reg{};
+  m_register_file->get_mem(CRI_REG_PCI_PERF_CYCLE, reg.data(), reg.size());
+  perf.cycles = reg[0];
+  perf.pci_trans = reg[1];
+  perf.pci_stall = reg[2];
+  perf.pci_busy = reg[3];
+  perf.pci_max_stall = static_cast<uint64_t>(static_cast<float>(reg[4]) *
+                                             (1.0 / pci_clk) * 1E6);
   return perf;
 }
 
+// The hardware has no common capture of all counters. Issuing the capture
+// pulses of all clock domains before reading any counter keeps the skew
+// between them at a few register writes, independent of the (slow) reads.
+cri_device::perf_snapshot_t cri_device::get_perf_snapshot() {
+  set_perf_cnt(true, true);
+  for (auto& channel : m_channel) {
+    channel->set_perf_cnt(true, true);
+    channel->set_perf_gtx_cnt(true, true);
+  }
+
+  perf_snapshot_t snapshot;
+  snapshot.dev = read_perf();
+  snapshot.ch.reserve(m_channel.size());
+  snapshot.ch_gtx.reserve(m_channel.size());
+  for (auto& channel : m_channel) {
+    snapshot.ch.push_back(channel->read_perf());
+    snapshot.ch_gtx.push_back(channel->read_perf_gtx());
+  }
+  return snapshot;
+}
+
 register_file_bar* cri_device::rf() const { return m_register_file.get(); }
 
 bool cri_device::check_magic_number() {
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "cri_channel.hpp"
 #include "pda/device.hpp"
 #include "pda/pci_bar.hpp"
 #include <array>
@@ -56,6 +57,7 @@ public:
   struct build_info_t build_info();
   std::string print_build_info();
   std::string print_devinfo();
+  int numa_node();
   std::chrono::seconds uptime();
   std::string print_uptime();
   std::string print_version_warning();
@@ -71,6 +73,9 @@ public:
 
   void id_led(bool enable);
 
+  // keep persistent DMA buffer registrations on exit
+  void keep_dma_buffers(bool keep);
+
   using dev_perf_t = struct {
     uint64_t cycles;
     uint64_t pci_trans;
@@ -80,6 +85,16 @@ public:
   };
 
   dev_perf_t get_perf();
+  dev_perf_t read_perf();
+
+  // counters of the device and of all its channels, captured back to back
+  using perf_snapshot_t = struct {
+    dev_perf_t dev;
+    std::vector<cri_channel::ch_perf_t> ch;
+    std::vector<cri_channel::ch_perf_gtx_t> ch_gtx;
+  };
+
+  perf_snapshot_t get_perf_snapshot();
 
   void set_perf_cnt(bool capture, bool reset);
   uint32_t get_perf_cycles();
@@ -11,35 +11,49 @@
 #include <cassert>
 #include <cstring>
 #include <memory>
+#include <mutex>
 
 namespace cri {
 
+namespace {
+// channels may be initialized in parallel, but PDA does not guarantee
+// thread safety of the buffer registration
+std::mutex registration_mutex;
+} // namespace
+
 // constructor for using user buffers
 dma_channel::dma_channel(cri_channel* parent_channel,
                          void* data_buffer,
                          size_t data_buffer_log_size,
                          void* desc_buffer,
                          size_t desc_buffer_log_size,
-                         size_t dma_transfer_size)
+                         size_t dma_transfer_size,
+                         bool persistent_buffers)
     : m_parent_channel(parent_channel), m_dma_transfer_size(dma_transfer_size) {
   m_rfpkt = m_parent_channel->register_file_packetizer();
-  m_reg_dmactrl_cached = m_rfpkt->get_reg(CRI_REG_DMA_CTRL);
+  // the sync pointers bit is pulse only, never cache it
+  m_rfpkt->shadow_reg(CRI_REG_DMA_CTRL, 1 << BIT_DMACTRL_SYNC_SWRDPTRS);
   // ensure HW is disabled
   // TODO: add global lock, otherwise this gives a race condition
   if (is_enabled()) {
     throw CriException("DMA Engine already enabled");
   }
-  m_data_buffer = std::make_unique<pda::dma_buffer>(
-      m_parent_channel->parent_device(), data_buffer,
-                          (UINT64_C(1) << data_buffer_log_size),
-                          (2 * m_parent_channel->channel_index() + 0));
-
-  m_desc_buffer = std::make_unique<pda::dma_buffer>(
-      m_parent_channel->parent_device(), desc_buffer,
-                          (UINT64_C(1) << desc_buffer_log_size),
-                          (2 * m_parent_channel->channel_index() + 1));
-  // clear eb for debugging
-  memset(m_data_buffer->mem(), 0, m_data_buffer->size());
+  {
+    std::lock_guard<std::mutex> lock(registration_mutex);
+    m_data_buffer = std::make_unique<pda::dma_buffer>(
+        m_parent_channel->parent_device(), data_buffer,
+        (UINT64_C(1) << data_buffer_log_size),
+        (2 * m_parent_channel->channel_index() + 0), persistent_buffers);
+
+    m_desc_buffer = std::make_unique<pda::dma_buffer>(
+        m_parent_channel->parent_device(), desc_buffer,
+        (UINT64_C(1) << desc_buffer_log_size),
+        (2 * m_parent_channel->channel_index() + 1), persistent_buffers);
+  }
+  // clear eb for debugging, a reused buffer is left untouched
+  if (!m_data_buffer->reused()) {
+    memset(m_data_buffer->mem(), 0, m_data_buffer->size());
+  }
   // clear rb for polling
   memset(m_desc_buffer->mem(), 0, m_desc_buffer->size());
 
@@ -47,7 +61,12 @@ dma_channel::dma_channel(cri_channel* parent_channel,
   enable();
 }
 
-dma_channel::~dma_channel() { disable(); }
+dma_channel::~dma_channel() {
+  disable();
+  std::lock_guard<std::mutex> lock(registration_mutex);
+  m_desc_buffer = nullptr;
+  m_data_buffer = nullptr;
+}
 
 // The DMA engine uses the following read/write pointer logic:
 // - Pointers show the next element to be read or written
@@ -80,7 +99,8 @@ void dma_channel::set_sw_read_pointers(uint64_t data_offset,
   // TODO: hack to save read-modify-write on dma_ctrl register
   // move sync pointers to exclusive HW register to avoid this
   // no need to chache sync pointers bit because it is pulse only
-  offsets.dma_ctrl = m_reg_dmactrl_cached | (1 << BIT_DMACTRL_SYNC_SWRDPTRS);
+  offsets.dma_ctrl = m_rfpkt->shadowed_reg(CRI_REG_DMA_CTRL) |
+                     (1 << BIT_DMACTRL_SYNC_SWRDPTRS);
 
   m_rfpkt->set_mem(CRI_REG_EBDM_SW_READ_POINTER_L, &offsets,
                    sizeof(offsets) >> 2);
@@ -167,14 +187,20 @@ dma_channel::convert_sg_list(const std::vector<pda::sg_entry>& sg_list) {
 
 void dma_channel::write_sg_list_to_device(
     const std::vector<sg_entry_hw_t>& sg_list, sg_bram_t buf_sel) {
+  // queue all mailbox writes and push them in a single burst
+  std::vector<reg_write> writes;
+  writes.reserve((sg_list.size() + 1) * 4);
   uint32_t buf_addr = 0;
   for (const auto& entry : sg_list) {
-    write_sg_entry_to_device(entry, buf_sel, buf_addr);
+    append_sg_entry_writes(writes, entry, buf_sel, buf_addr);
     ++buf_addr;
   }
   // clear trailing sg entry in bram
   sg_entry_hw_t clear = sg_entry_hw_t();
-  write_sg_entry_to_device(clear, buf_sel, buf_addr);
+  append_sg_entry_writes(writes, clear, buf_sel, buf_addr);
+  if (m_rfpkt->set_regs(writes) != 0) {
+    throw CriException("Writing SG list to device failed");
+  }
 
   // set number of configured sg entries
   // this HW register does not influence the dma engine
@@ -182,17 +208,20 @@ void dma_channel::write_sg_list_to_device(
   set_configured_sg_entries(buf_sel, sg_list.size());
 }
 
-void dma_channel::write_sg_entry_to_device(sg_entry_hw_t entry,
-                                           sg_bram_t buf_sel,
-                                           uint32_t buf_addr) {
+void dma_channel::append_sg_entry_writes(std::vector<reg_write>& writes,
+                                         sg_entry_hw_t entry,
+                                         sg_bram_t buf_sel,
+                                         uint32_t buf_addr) {
 
   uint32_t sg_ctrl = (1 << BIT_SGENTRY_CTRL_WRITE_EN) | buf_addr;
   sg_ctrl |= (buf_sel << BIT_SGENTRY_CTRL_TARGET);
 
   // write entry en block to mailbox register
-  m_rfpkt->set_mem(CRI_REG_SGENTRY_ADDR_LOW, &entry, sizeof(entry) >> 2);
+  writes.push_back({CRI_REG_SGENTRY_ADDR_LOW, entry.addr_low});
+  writes.push_back({CRI_REG_SGENTRY_ADDR_HIGH, entry.addr_high});
+  writes.push_back({CRI_REG_SGENTRY_LEN, entry.length});
   // push mailbox to bram
-  m_rfpkt->set_reg(CRI_REG_SGENTRY_CTRL, sg_ctrl);
+  writes.push_back({CRI_REG_SGENTRY_CTRL, sg_ctrl});
 }
 
 size_t dma_channel::get_max_sg_entries(sg_bram_t buf_sel) {
@@ -283,7 +312,7 @@ void dma_channel::reset_datapath(bool enable) {
 inline bool dma_channel::is_enabled() {
   uint32_t mask = 1 << BIT_DMACTRL_EBDM_EN | 1 << BIT_DMACTRL_RBDM_EN |
                   1 << BIT_DMACTRL_DMA_EN;
-  return (m_reg_dmactrl_cached & mask) != 0u;
+  return (m_rfpkt->shadowed_reg(CRI_REG_DMA_CTRL) & mask) != 0u;
 }
 
 inline bool dma_channel::is_busy() {
@@ -292,21 +321,10 @@ inline bool dma_channel::is_busy() {
 
 void dma_channel::set_dmactrl(uint32_t reg, uint32_t mask) {
   // acces to dma_ctrl register
-  // ensures proper caching of register value
-  // never cache BIT_DMACTRL_SYNC_SWRDPTRS
+  // the register file keeps the shadow copy of the register value
+  // never set BIT_DMACTRL_SYNC_SWRDPTRS here
   mask &= ~(1 << BIT_DMACTRL_SYNC_SWRDPTRS);
-  m_reg_dmactrl_cached = set_bits(m_reg_dmactrl_cached, reg, mask);
-  m_rfpkt->set_reg(CRI_REG_DMA_CTRL, m_reg_dmactrl_cached);
-}
-
-inline uint32_t
-dma_channel::set_bits(uint32_t old_val, uint32_t new_val, uint32_t mask) {
-  // clear all unselected bits in new_val
-  new_val &= mask;
-  // clear all selects bits and set according to new_val
-  old_val &= ~mask;
-  old_val |= new_val;
-  return old_val;
+  m_rfpkt->set_reg(CRI_REG_DMA_CTRL, reg, mask);
 }
 
 inline uint32_t dma_channel::get_lo_32(uint64_t val) { return val; }
@@ -38,7 +38,8 @@ public:
               size_t data_buffer_log_size,
               void* desc_buffer,
               size_t desc_buffer_log_size,
-              size_t dma_transfer_size);
+              size_t dma_transfer_size,
+              bool persistent_buffers = false);
 
   ~dma_channel();
 
@@ -89,9 +90,10 @@ private:
   void write_sg_list_to_device(const std::vector<sg_entry_hw_t>& sg_list,
                                sg_bram_t buf_sel);
 
-  void write_sg_entry_to_device(sg_entry_hw_t entry,
-                                sg_bram_t buf_sel,
-                                uint32_t buf_addr);
+  static void append_sg_entry_writes(std::vector<reg_write>& writes,
+                                     sg_entry_hw_t entry,
+                                     sg_bram_t buf_sel,
+                                     uint32_t buf_addr);
 
   size_t get_max_sg_entries(sg_bram_t buf_sel);
 
@@ -113,9 +115,6 @@ private:
 
   void set_dmactrl(uint32_t reg, uint32_t mask);
 
-  static inline uint32_t
-  set_bits(uint32_t old_val, uint32_t new_val, uint32_t mask);
-
   static inline uint32_t get_lo_32(uint64_t val);
 
   static inline uint32_t get_hi_32(uint64_t val);
@@ -125,7 +124,6 @@ private:
   std::unique_ptr<pda::dma_buffer> m_data_buffer;
   std::unique_ptr<pda::dma_buffer> m_desc_buffer;
   size_t m_dma_transfer_size;
-  uint32_t m_reg_dmactrl_cached;
 };
 
 } // namespace cri
@@ -6,10 +6,21 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
 namespace cri {
 
 using sys_bus_addr = uint64_t;
 
+// single register write of a burst
+struct reg_write {
+  sys_bus_addr addr;
+  uint32_t data;
+};
+
 class register_file {
 public:
   virtual ~register_file() = default;
@@ -18,6 +29,15 @@ public:
 
   virtual int set_mem(sys_bus_addr addr, const void* source, size_t dwords) = 0;
 
+  // write a sequence of registers in the given order
+  // implementations may defer flushing until the last write
+  virtual int set_regs(const std::vector<reg_write>& writes) {
+    for (const auto& w : writes) {
+      set_reg(w.addr, w.data);
+    }
+    return 0;
+  }
+
   virtual uint32_t get_reg(sys_bus_addr addr) {
     uint32_t val = 0;
     get_mem(addr, static_cast<void*>(&val), 1);
@@ -25,11 +45,12 @@ public:
   }
 
   virtual void set_reg(sys_bus_addr addr, uint32_t data) {
+    update_shadow(addr, data);
     set_mem(addr, static_cast<const void*>(&data), 1);
   }
 
   virtual void set_reg(sys_bus_addr addr, uint32_t data, uint32_t mask) {
-    uint32_t reg = get_reg(addr);
+    uint32_t reg = read_for_update(addr);
     // clear all unselected bits in input data
     data &= mask;
     // clear all selects bits in reg and set according to input data
@@ -44,12 +65,45 @@ public:
   }
 
   virtual void set_bit(sys_bus_addr addr, int pos, bool enable) {
-    uint32_t reg = get_reg(addr);
+    uint32_t reg = read_for_update(addr);
     if (enable) {
       set_reg(addr, (reg | (1 << pos)));
     } else {
       set_reg(addr, (reg & ~(1 << pos)));
     }
   }
+
+  // keep a shadow copy of a register that is only modified through this
+  // register file, so that field updates need no read from the device
+  // bits in pulse_mask are never stored in the shadow copy
+  void shadow_reg(sys_bus_addr addr, uint32_t pulse_mask = 0) {
+    m_shadow[addr] = {get_reg(addr) & ~pulse_mask, pulse_mask};
+  }
+
+  // retrieve the shadow copy of a register (see shadow_reg)
+  uint32_t shadowed_reg(sys_bus_addr addr) const {
+    return m_shadow.at(addr).value;
+  }
+
+protected:
+  void update_shadow(sys_bus_addr addr, uint32_t data) {
+    auto it = m_shadow.find(addr);
+    if (it != m_shadow.end()) {
+      it->second.value = data & ~it->second.pulse_mask;
+    }
+  }
+
+private:
+  struct shadow_t {
+    uint32_t value;
+    uint32_t pulse_mask;
+  };
+
+  uint32_t read_for_update(sys_bus_addr addr) {
+    auto it = m_shadow.find(addr);
+    return it != m_shadow.end() ? it->second.value : get_reg(addr);
+  }
+
+  std::map<sys_bus_addr, shadow_t> m_shadow;
 };
 } // namespace cri
@@ -6,6 +6,7 @@
 
 #include "register_file_bar.hpp"
 #include "pda/data_structures.hpp"
+#include <algorithm>
 #include <iostream>
 #include <sys/mman.h>
 
@@ -37,17 +38,48 @@ __attribute__((__target__("no-sse"))) int register_file_bar::set_mem(
   if (((sys_addr + dwords) << 2) < m_bar_size) {
     for (size_t i = 0; i < dwords; i++) {
       m_bar[sys_addr + i] = *(static_cast<const uint32_t*>(source) + i);
-      err += msync(
-          (reinterpret_cast<uint8_t*>(m_bar) + ((sys_addr << 2) & PAGE_MASK)),
-          PAGE_SIZE, MS_SYNC);
       if (false) {
         std::cout << "BAR write addr " << sys_addr + i << " data "
                   << static_cast<const uint32_t*>(source)[i] << std::endl;
       }
     }
+    // writes to the BAR are not reordered, one flush suffices
+    if (dwords > 0) {
+      err = sync(sys_addr, sys_addr + dwords - 1);
+    }
     return err;
   }
   return -1;
 }
 
+__attribute__((__target__("no-sse"))) int
+register_file_bar::set_regs(const std::vector<reg_write>& writes) {
+  // sys_bus hw only supports single 32 bit writes
+  if (writes.empty()) {
+    return 0;
+  }
+  sys_bus_addr first = UINT64_MAX;
+  sys_bus_addr last = 0;
+  for (const auto& w : writes) {
+    sys_bus_addr sys_addr = m_base_addr + w.addr;
+    if (((sys_addr + 1) << 2) >= m_bar_size) {
+      return -1;
+    }
+    first = std::min(first, sys_addr);
+    last = std::max(last, sys_addr);
+  }
+  for (const auto& w : writes) {
+    update_shadow(w.addr, w.data);
+    m_bar[m_base_addr + w.addr] = w.data;
+  }
+  return sync(first, last);
+}
+
+int register_file_bar::sync(sys_bus_addr first, sys_bus_addr last) {
+  uint8_t* begin =
+      reinterpret_cast<uint8_t*>(m_bar) + ((first << 2) & PAGE_MASK);
+  uint8_t* end = reinterpret_cast<uint8_t*>(m_bar) + (last << 2) + 4;
+  return msync(begin, end - begin, MS_SYNC);
+}
+
 } // namespace cri
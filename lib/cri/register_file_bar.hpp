@@ -17,8 +17,12 @@ public:
 
   int get_mem(sys_bus_addr addr, void* dest, size_t dwords) override;
   int set_mem(sys_bus_addr addr, const void* source, size_t dwords) override;
+  int set_regs(const std::vector<reg_write>& writes) override;
 
 protected:
+  // flush writes to the pages covering the given dword range
+  int sync(sys_bus_addr first, sys_bus_addr last);
+
   uint32_t* m_bar; // 32 bit addressing
   size_t m_bar_size;
   sys_bus_addr m_base_addr;
@@ -0,0 +1,49 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/// Adaptive acknowledgment coalescing class.
+/** An AckCoalescing object decides when acknowledged buffer positions are
+    passed on to the producer. While the buffer has headroom, updates are
+    coalesced up to a maximum amount. The amount shrinks linearly with the
+    fill level, so that a nearly full buffer is released with every
+    single acknowledgment. */
+
+class AckCoalescing {
+public:
+  /// The AckCoalescing constructor.
+  /**
+     \param max_desc Maximum number of descriptors to coalesce
+     \param max_data Maximum number of data bytes to coalesce
+  */
+  AckCoalescing(uint64_t max_desc, uint64_t max_data)
+      : max_desc_(max_desc), max_data_(max_data) {}
+
+  /// Retrieve the amount to coalesce at a given fill level (0 to 1).
+  [[nodiscard]] static uint64_t threshold(uint64_t max_amount, double fill) {
+    double headroom = 1.0 - std::clamp(fill, 0.0, 1.0);
+    return static_cast<uint64_t>(static_cast<double>(max_amount) * headroom);
+  }
+
+  /// Check whether pending acknowledgments are to be passed on.
+  /**
+     \param pending_desc Number of acknowledged, not yet passed descriptors
+     \param pending_data Number of acknowledged, not yet passed data bytes
+     \param fill         Current fill level of the buffer (0 to 1)
+  */
+  [[nodiscard]] bool due(uint64_t pending_desc,
+                         uint64_t pending_data,
+                         double fill) const {
+    if (pending_desc == 0 && pending_data == 0) {
+      return false;
+    }
+    return pending_desc >= threshold(max_desc_, fill) ||
+           pending_data >= threshold(max_data_, fill);
+  }
+
+private:
+  uint64_t max_desc_;
+  uint64_t max_data_;
+};
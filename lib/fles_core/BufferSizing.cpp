@@ -0,0 +1,82 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "BufferSizing.hpp"
+#include "System.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+uint64_t
+BufferSizing::budget(int numa_node, uint32_t percent, unsigned buffers) {
+  uint64_t available =
+      fles::system::memory_of_numa_node(numa_node).available;
+  if (available == 0) {
+    throw std::runtime_error("available memory of NUMA node " +
+                             std::to_string(numa_node) + " unknown");
+  }
+  return available / 100 * percent / std::max(buffers, 1u);
+}
+
+BufferSize BufferSizing::fit(uint64_t budget,
+                             double mean_entry_size,
+                             std::size_t desc_entry_size) {
+  constexpr uint32_t max_datasize = 48;
+  for (uint32_t datasize = max_datasize; datasize >= min_datasize;
+       --datasize) {
+    uint32_t descsize = datasize - default_ratio_exp;
+    if (mean_entry_size > 0) {
+      // twice the entries of mean size, as the actual sizes vary
+      double entries = 2 * std::ldexp(1.0, static_cast<int>(datasize)) /
+                       mean_entry_size;
+      descsize = 1;
+      while (std::ldexp(1.0, static_cast<int>(descsize)) < entries &&
+             descsize < datasize) {
+        ++descsize;
+      }
+    }
+    uint64_t size = (UINT64_C(1) << datasize) +
+                    (UINT64_C(1) << descsize) * desc_entry_size;
+    if (size <= budget) {
+      return {datasize, descsize};
+    }
+  }
+  throw std::runtime_error("insufficient memory for automatic buffer size: " +
+                           human_readable_count(budget));
+}
+
+std::map<std::string, double>
+BufferSizing::read_record(const std::string& path) {
+  std::map<std::string, double> sizes;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    std::string name;
+    double size = 0;
+    if (iss >> name >> size && size > 0) {
+      sizes[name] = size;
+    }
+  }
+  return sizes;
+}
+
+void BufferSizing::update_record(const std::string& path,
+                                 const std::map<std::string, double>& sizes) {
+  std::map<std::string, double> record = read_record(path);
+  for (const auto& [name, size] : sizes) {
+    record[name] = size;
+  }
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("cannot write buffer sizing record: " + path);
+  }
+  file << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (const auto& [name, size] : record) {
+    file << name << " " << size << "\n";
+  }
+}
@@ -0,0 +1,58 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Automatic sizing of ring buffers from the available memory.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/// Size exponents of a pair of data and descriptor ring buffers.
+struct BufferSize {
+  uint32_t datasize = 0; ///< Data buffer size exponent (bytes)
+  uint32_t descsize = 0; ///< Descriptor buffer size exponent (entries)
+};
+
+/// Automatic sizing of ring buffers.
+/** A buffer with automatic size is the largest one that fits into its share
+    of the available memory. The number of descriptors follows from the mean
+    size of the data of a descriptor entry, e.g., of a timeslice component,
+    which is known in advance or has been observed in a previous run. The
+    sizing only depends on its arguments, so that a buffer can be sized
+    again, e.g., at an interval boundary. */
+class BufferSizing {
+public:
+  /// The smallest data buffer size exponent chosen.
+  static constexpr uint32_t min_datasize = 20; // 1 MiB
+
+  /// The ratio of data bytes to descriptors if the mean entry size is
+  /// unknown, as with the default sizes (27 and 19).
+  static constexpr uint32_t default_ratio_exp = 8;
+
+  /// Retrieve the memory budget of a buffer sharing a percentage of the
+  /// available memory of a NUMA node (-1: of the system) equally with the
+  /// given number of buffers. Throws if the available memory is unknown.
+  static uint64_t budget(int numa_node, uint32_t percent, unsigned buffers);
+
+  /// Choose the largest buffer fitting into a memory budget.
+  /** The descriptor buffer holds twice the number of entries of mean size
+      that fit into the data buffer. Throws if the budget is too small.
+
+      \param budget           memory available for the buffer (bytes)
+      \param mean_entry_size  mean data size of an entry (0: unknown)
+      \param desc_entry_size  size of a descriptor (bytes) */
+  static BufferSize fit(uint64_t budget,
+                        double mean_entry_size,
+                        std::size_t desc_entry_size);
+
+  /// Read the mean entry sizes recorded in a previous run.
+  /** The record is a text file with one "<name> <mean entry size>" line per
+      buffer. Returns an empty map if the file does not exist. */
+  static std::map<std::string, double> read_record(const std::string& path);
+
+  /// Update the mean entry sizes of the given buffers in a record.
+  /** The entries of other buffers (e.g., of other processes) are kept. */
+  static void update_record(const std::string& path,
+                            const std::map<std::string, double>& sizes);
+};
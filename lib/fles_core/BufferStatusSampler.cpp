@@ -0,0 +1,110 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "BufferStatusSampler.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+BufferStatusSampler* BufferStatusSampler::instance_ = nullptr;
+
+BufferStatusSampler::BufferStatusSampler(cbm::Monitor& monitor,
+                                         std::chrono::microseconds interval)
+    : monitor_(monitor), interval_(interval) {
+  if (instance_ != nullptr) {
+    throw std::runtime_error("BufferStatusSampler: already instantiated");
+  }
+  instance_ = this;
+  thread_ = std::thread(&BufferStatusSampler::run, this);
+}
+
+BufferStatusSampler::~BufferStatusSampler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  thread_.join();
+  instance_ = nullptr;
+}
+
+std::shared_ptr<BufferStatusSource>
+BufferStatusSampler::add_source(const std::string& measurement,
+                                const cbm::MetricTagSet& tags,
+                                uint64_t desc_size,
+                                uint64_t data_size,
+                                bool sending) {
+  auto source = std::make_shared<BufferStatusSource>(desc_size, data_size);
+  add_source(measurement, tags, source, sending);
+  return source;
+}
+
+void BufferStatusSampler::add_source(
+    const std::string& measurement,
+    const cbm::MetricTagSet& tags,
+    std::shared_ptr<BufferStatusSource> source,
+    bool sending) {
+  static const std::array<const char*, 4> fill_classes = {
+      "used_pct", "sending_pct", "freeing_pct", "free_pct"};
+
+  Entry entry;
+  entry.source = std::move(source);
+  for (size_t i = 0; i < fill_classes.size(); ++i) {
+    if (i == 1 && !sending) {
+      continue;
+    }
+    std::string fill_class = fill_classes[i];
+    entry.desc[i] =
+        monitor_.RegisterHistogram(measurement, tags, "desc_" + fill_class);
+    entry.data[i] =
+        monitor_.RegisterHistogram(measurement, tags, "data_" + fill_class);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.push_back(std::move(entry));
+}
+
+void BufferStatusSampler::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cond_.wait_for(lock, interval_, [this] { return stop_; })) {
+    // drop the sources no longer referenced by their endpoint
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [](const Entry& e) {
+                                    return e.source.use_count() == 1;
+                                  }),
+                   entries_.end());
+    for (auto& entry : entries_) {
+      sample(entry.source->desc,
+             entry.source->desc_size.load(std::memory_order_relaxed),
+             entry.desc);
+      sample(entry.source->data,
+             entry.source->data_size.load(std::memory_order_relaxed),
+             entry.data);
+    }
+    samples_ += entries_.size();
+  }
+}
+
+void BufferStatusSampler::sample(const BufferPositionCounters& counters,
+                                 uint64_t size,
+                                 FillHistograms& histograms) {
+  // read the lower positions first, so that the invariant holds even if
+  // the positions are updated concurrently
+  uint64_t cached_acked = counters.cached_acked.load(std::memory_order_acquire);
+  uint64_t acked = counters.acked.load(std::memory_order_relaxed);
+  uint64_t sent = counters.sent.load(std::memory_order_relaxed);
+  uint64_t written = counters.written.load(std::memory_order_relaxed);
+  uint64_t end = cached_acked + size;
+  acked = std::min(std::max(acked, cached_acked), end);
+  sent = std::min(std::max(sent, acked), end);
+  written = std::min(std::max(written, sent), end);
+
+  auto percent = [size](uint64_t value) {
+    return size != 0 ? (value * 100 + size / 2) / size : 0;
+  };
+  std::array<uint64_t, 4> fill = {written - sent, sent - acked,
+                                  acked - cached_acked, end - written};
+  for (size_t i = 0; i < fill.size(); ++i) {
+    if (histograms[i]) {
+      histograms[i].Record(percent(fill[i]));
+    }
+  }
+}
@@ -0,0 +1,115 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "Monitor.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Positions in a ring buffer, published by the thread owning the buffer.
+/** The positions never decrease and are ordered as cached_acked <= acked <=
+    sent <= written. */
+struct BufferPositionCounters {
+  std::atomic<uint64_t> cached_acked{0};
+  std::atomic<uint64_t> acked{0};
+  std::atomic<uint64_t> sent{0};
+  std::atomic<uint64_t> written{0};
+
+  void publish(uint64_t new_cached_acked,
+               uint64_t new_acked,
+               uint64_t new_sent,
+               uint64_t new_written) {
+    written.store(new_written, std::memory_order_relaxed);
+    sent.store(new_sent, std::memory_order_relaxed);
+    acked.store(new_acked, std::memory_order_relaxed);
+    cached_acked.store(new_cached_acked, std::memory_order_release);
+  }
+};
+
+/// The published buffer positions of a transport endpoint.
+/** Aligned to keep the counters apart from data of the publishing thread.
+    The buffer sizes change only if the buffer is resized while drained. */
+struct alignas(64) BufferStatusSource {
+  BufferStatusSource(uint64_t desc_buffer_size, uint64_t data_buffer_size)
+      : desc_size(desc_buffer_size), data_size(data_buffer_size) {}
+
+  std::atomic<uint64_t> desc_size;
+  std::atomic<uint64_t> data_size;
+  BufferPositionCounters desc;
+  BufferPositionCounters data;
+};
+
+/// Sampler of the fill levels of the transport buffers in a process.
+/** A thread reads the published positions of all sources at a fixed rate
+    and records the fill levels (in percent of the buffer size) in histograms
+    reported by the monitor. The transport threads only publish their
+    positions and do not spend any time on the sampling. */
+class BufferStatusSampler {
+public:
+  BufferStatusSampler(cbm::Monitor& monitor,
+                      std::chrono::microseconds interval);
+
+  BufferStatusSampler(const BufferStatusSampler&) = delete;
+  void operator=(const BufferStatusSampler&) = delete;
+
+  ~BufferStatusSampler();
+
+  /// The sampler of this process (nullptr if none exists).
+  static BufferStatusSampler* instance() { return instance_; }
+
+  /// Add a transport endpoint to be sampled.
+  /** The endpoint is sampled for as long as the returned source is
+      referenced elsewhere. The "sending" fill class (sent, but not yet
+      acknowledged) is only reported if \p sending is set. */
+  std::shared_ptr<BufferStatusSource>
+  add_source(const std::string& measurement,
+             const cbm::MetricTagSet& tags,
+             uint64_t desc_size,
+             uint64_t data_size,
+             bool sending = true);
+
+  /// Add a transport endpoint publishing to an existing source, e.g., one
+  /// located in shared memory (see TimesliceBufferStatus).
+  void add_source(const std::string& measurement,
+                  const cbm::MetricTagSet& tags,
+                  std::shared_ptr<BufferStatusSource> source,
+                  bool sending = true);
+
+  /// Number of samples taken of all sources.
+  [[nodiscard]] uint64_t samples() const { return samples_.load(); }
+
+private:
+  /// Histograms of the fill classes used, sending, freeing and free.
+  using FillHistograms = std::array<cbm::MetricHistogram, 4>;
+
+  struct Entry {
+    std::shared_ptr<BufferStatusSource> source;
+    FillHistograms desc;
+    FillHistograms data;
+  };
+
+  void run();
+
+  static void sample(const BufferPositionCounters& counters,
+                     uint64_t size,
+                     FillHistograms& histograms);
+
+  cbm::Monitor& monitor_;
+  std::chrono::microseconds interval_;
+
+  std::vector<Entry> entries_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ = false;
+  std::atomic<uint64_t> samples_{0};
+  std::thread thread_;
+
+  static BufferStatusSampler* instance_;
+};
@@ -2,13 +2,14 @@
 #pragma once
 
 #include "log.hpp"
+#include <algorithm>
 #include <csignal>
 #include <cstring>
 #include <sstream>
 #include <sys/wait.h>
 #include <vector>
 
-enum ProcessStatus { None, Running, Terminating };
+enum ProcessStatus { None, Running, Terminating, Exited, Failed };
 
 struct ChildProcess {
   pid_t pid{};
@@ -16,6 +17,7 @@ struct ChildProcess {
   std::vector<std::string> arg;
   void* owner{};
   ProcessStatus status{};
+  bool signalled{};
 };
 
 class ChildProcessManager {
@@ -54,9 +56,27 @@ public:
     } else {
       // parent
       if (pid > 0) {
-        child_process.pid = pid;
-        child_process.status = Running;
-        child_processes_.push_back(child_process);
+        // Reuse the entry of a stopped process of the same owner, so that
+        // the list does not grow if processes are started and stopped
+        // repeatedly. The pid is set last, as the SIGCHLD handler looks up
+        // entries by pid.
+        auto reusable = std::find_if(
+            child_processes_.begin(), child_processes_.end(),
+            [&child_process](const ChildProcess& c) {
+              return c.owner == child_process.owner && c.signalled &&
+                     exited(c);
+            });
+        if (reusable != child_processes_.end()) {
+          reusable->path = child_process.path;
+          reusable->arg = child_process.arg;
+          reusable->signalled = false;
+          reusable->status = Running;
+          reusable->pid = pid;
+        } else {
+          child_process.pid = pid;
+          child_process.status = Running;
+          child_processes_.push_back(child_process);
+        }
         L_(debug) << "child process started";
         return true;
       }
@@ -67,14 +87,35 @@ public:
 
   bool stop_process(std::vector<ChildProcess>::iterator child_process) {
     if (child_process >= child_processes_.begin() &&
-        child_process < child_processes_.end()) {
+        child_process < child_processes_.end() && !exited(*child_process)) {
       child_process->status = Terminating;
+      child_process->signalled = true;
       kill(child_process->pid, SIGTERM);
       return true;
     }
     return false;
   }
 
+  /// Stop the most recently started process of a given owner that has not
+  /// been stopped yet.
+  bool stop_last_process(void* owner) {
+    for (auto it = child_processes_.end(); it != child_processes_.begin();) {
+      --it;
+      if (it->owner == owner && !it->signalled && !exited(*it)) {
+        return stop_process(it);
+      }
+    }
+    return false;
+  }
+
+  /// Reserve space for additional processes.
+  /** Processes started from a thread other than the main thread must not
+      reallocate the process list, as the SIGCHLD handler may access it at
+      any time. Entries of stopped processes are reused. */
+  void reserve(std::size_t additional_processes) {
+    child_processes_.reserve(child_processes_.size() + additional_processes);
+  }
+
   void stop_processes(void* owner) {
     for (auto it = child_processes_.begin(); it < child_processes_.end();
          ++it) {
@@ -86,7 +127,7 @@ public:
 
   bool allow_stop_process(std::vector<ChildProcess>::iterator child_process) {
     if (child_process >= child_processes_.begin() &&
-        child_process < child_processes_.end()) {
+        child_process < child_processes_.end() && !exited(*child_process)) {
       child_process->status = Terminating;
       return true;
     }
@@ -109,9 +150,29 @@ public:
     }
   }
 
+  /// Check whether any child process of a given owner is still running.
+  [[nodiscard]] bool running(void* owner) const {
+    return std::any_of(child_processes_.begin(), child_processes_.end(),
+                       [owner](const ChildProcess& c) {
+                         return c.owner == owner && !exited(c);
+                       });
+  }
+
+  /// Check whether any child process of a given owner died unexpectedly.
+  [[nodiscard]] bool failed(void* owner) const {
+    return std::any_of(child_processes_.begin(), child_processes_.end(),
+                       [owner](const ChildProcess& c) {
+                         return c.owner == owner && c.status == Failed;
+                       });
+  }
+
 private:
   using sigaction_struct = struct sigaction;
 
+  static bool exited(const ChildProcess& c) {
+    return c.status == Exited || c.status == Failed;
+  }
+
   ChildProcessManager() { install_sigchld_handler(); }
 
   ~ChildProcessManager() {
@@ -152,15 +213,32 @@ private:
       if (!pid_found) {
         L_(error) << "unknown child process died";
       } else {
-        switch (child_processes.at(idx).status) {
+        ChildProcess& child_process = child_processes.at(idx);
+        switch (child_process.status) {
         case Terminating:
-          L_(debug) << "child process successfully terminated";
+          if ((WIFEXITED(status) && WEXITSTATUS(status) != 0) ||
+              (WIFSIGNALED(status) && WTERMSIG(status) != SIGTERM)) {
+            L_(error) << "child process failed";
+            child_process.status = Failed;
+          } else {
+            L_(debug) << "child process successfully terminated";
+            child_process.status = Exited;
+          }
           break;
         case Running:
         case None:
+          if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            L_(debug) << "child process exited";
+            child_process.status = Exited;
+            break;
+          }
           L_(error) << "child process died unexpectedly";
           L_(error) << "TODO: restart not yet implemented";
           // TODO(Jan): Implement child process restarting
+          child_process.status = Failed;
+          break;
+        case Exited:
+        case Failed:
           break;
         }
       }
@@ -0,0 +1,73 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/// Clock offset estimation class.
+/** A ClockOffset object estimates the offset of a remote clock from the
+    local one from timestamp exchanges, like NTP: a message sent at local
+    time t1 is received at remote time t2, and a reply sent at remote time
+    t3 is received at local time t4. The offset is taken from the sample
+    with the smallest round-trip delay, whose one-way delays are the most
+    symmetric. Samples older than two periods are discarded, so that the
+    estimate follows clock drift. All times are in nanoseconds. */
+
+class ClockOffset {
+public:
+  /// The ClockOffset constructor.
+  /**
+     \param period Period after which the best sample is selected anew
+  */
+  explicit ClockOffset(int64_t period) : period_(period) {}
+
+  /// Add a sample of a timestamp exchange.
+  void add(int64_t t1, int64_t t2, int64_t t3, int64_t t4) {
+    Sample sample{((t2 - t1) + (t3 - t4)) / 2,
+                  std::max((t4 - t1) - (t3 - t2), INT64_C(0))};
+    if (!current_valid_ || t4 - period_begin_ > period_) {
+      previous_ = current_;
+      previous_valid_ = current_valid_;
+      current_valid_ = false;
+      period_begin_ = t4;
+    }
+    if (!current_valid_ || sample.delay < current_.delay) {
+      current_ = sample;
+      current_valid_ = true;
+    }
+  }
+
+  /// Check whether an estimate is available.
+  [[nodiscard]] bool valid() const { return current_valid_; }
+
+  /// Retrieve the estimated offset of the remote clock (remote - local).
+  [[nodiscard]] int64_t offset() const { return best().offset; }
+
+  /// Retrieve the round-trip delay of the sample used for the estimate.
+  [[nodiscard]] int64_t delay() const { return best().delay; }
+
+  /// Convert a remote time to the local clock.
+  [[nodiscard]] int64_t to_local(int64_t remote_time) const {
+    return remote_time - offset();
+  }
+
+private:
+  struct Sample {
+    int64_t offset = 0;
+    int64_t delay = 0;
+  };
+
+  [[nodiscard]] const Sample& best() const {
+    if (previous_valid_ && previous_.delay < current_.delay) {
+      return previous_;
+    }
+    return current_;
+  }
+
+  int64_t period_;
+  int64_t period_begin_ = 0;
+  Sample current_;
+  Sample previous_;
+  bool current_valid_ = false;
+  bool previous_valid_ = false;
+};
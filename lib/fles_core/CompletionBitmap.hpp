@@ -0,0 +1,62 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Out-of-order completion tracking class.
+/** A CompletionBitmap object records the completion of buffer positions
+    that may complete in any order, and advances the position up to which
+    all have completed. The bitmap is indexed by the position modulo the
+    buffer size, so at most that many positions may be outstanding. */
+
+class CompletionBitmap {
+public:
+  /// The CompletionBitmap constructor.
+  /** Positions before the given position are considered completed. */
+  explicit CompletionBitmap(uint32_t size_exp, uint64_t completed = 0)
+      : size_mask_((UINT64_C(1) << size_exp) - 1),
+        words_(std::max<std::size_t>((UINT64_C(1) << size_exp) / 64, 1)),
+        completed_(completed) {}
+
+  /// Record the completion of a position.
+  void set(uint64_t pos) {
+    pos &= size_mask_;
+    words_[pos / 64] |= UINT64_C(1) << (pos % 64);
+  }
+
+  /// Advance the position over all consecutive completed positions.
+  /**
+     \return Whether the position has advanced
+  */
+  bool advance() {
+    const uint64_t begin = completed_;
+    for (;;) {
+      const uint64_t index = completed_ & size_mask_;
+      const unsigned bit = index % 64;
+      const uint64_t bits = words_[index / 64] >> bit;
+      if ((bits & 1) == 0) {
+        break;
+      }
+      // length of the run of completed positions up to the end of the word
+      const unsigned run = ~bits == 0
+                               ? 64 - bit
+                               : static_cast<unsigned>(__builtin_ctzll(~bits));
+      const uint64_t run_mask =
+          run == 64 ? ~UINT64_C(0) : ((UINT64_C(1) << run) - 1) << bit;
+      words_[index / 64] &= ~run_mask;
+      completed_ += run;
+    }
+    return completed_ != begin;
+  }
+
+  /// Retrieve the position up to which all positions have completed.
+  [[nodiscard]] uint64_t completed() const { return completed_; }
+
+private:
+  uint64_t size_mask_;
+  std::vector<uint64_t> words_;
+  uint64_t completed_;
+};
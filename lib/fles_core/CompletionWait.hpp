@@ -0,0 +1,144 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <poll.h>
+#include <system_error>
+
+/// Adaptive completion waiting class.
+/** A CompletionWait object decides when a busy-polling transport event loop
+    may block instead. The loop keeps spinning while it has work and for a
+    configurable time after that. Once idle for longer, it blocks on the
+    notification file descriptors of its completion queues for at most a
+    maximum time, which bounds the delay of events that are polled without a
+    notification (e.g., new data in the input buffer or timers). After each
+    wakeup, the loop spins again. */
+
+class CompletionWait {
+public:
+  /// The thresholds of the adaptive waiting.
+  struct Config {
+    /// Idle time of the event loop before it blocks
+    std::chrono::microseconds spin{0};
+    /// Maximum duration of a single blocking wait (0: never block)
+    std::chrono::microseconds max_wait{0};
+  };
+
+  /// The statistics of the blocking waits.
+  struct Stats {
+    /// Number of blocking waits
+    uint64_t waits = 0;
+    /// Number of waits ended by a notification
+    uint64_t wakeups = 0;
+    /// Total time spent blocking
+    std::chrono::nanoseconds blocked{0};
+    /// Time covered by the statistics (see take_stats())
+    std::chrono::nanoseconds period{0};
+
+    /// The fraction of the period spent blocking.
+    [[nodiscard]] double blocked_ratio() const {
+      return period.count() > 0 ? static_cast<double>(blocked.count()) /
+                                      static_cast<double>(period.count())
+                                : 0.;
+    }
+
+    /// The mean duration of a blocking wait in microseconds.
+    [[nodiscard]] double mean_wait_us() const {
+      return waits != 0 ? static_cast<double>(blocked.count()) / 1e3 /
+                              static_cast<double>(waits)
+                        : 0.;
+    }
+  };
+
+  using clock = std::chrono::steady_clock;
+
+  /// Set the thresholds (before the event loop is started).
+  void configure(Config config) {
+    config_ = config;
+    stats_begin_ = clock::now();
+  }
+
+  /// Check whether the event loop may block at all.
+  [[nodiscard]] bool enabled() const { return config_.max_wait.count() > 0; }
+
+  /// Account an iteration of the event loop.
+  /**
+     \param active Whether the iteration did any work
+     \return Whether the event loop has been idle for the spin time and
+     should block now (see wait())
+  */
+  bool idle(bool active) {
+    if (!enabled()) {
+      return false;
+    }
+    if (active) {
+      idle_ = false;
+      return false;
+    }
+    auto now = clock::now();
+    if (!idle_) {
+      idle_ = true;
+      idle_since_ = now;
+    }
+    return now - idle_since_ >= config_.spin;
+  }
+
+  /// Block until one of the file descriptors is readable or the maximum
+  /// wait time has passed.
+  /**
+     \return Whether a file descriptor is readable
+  */
+  bool wait(pollfd* fds, std::size_t count) {
+    auto max_wait =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(config_.max_wait);
+    timespec timeout{static_cast<time_t>(max_wait.count() / 1000000000),
+                     static_cast<long>(max_wait.count() % 1000000000)};
+    auto begin = clock::now();
+    int n = ppoll(fds, count, &timeout, nullptr);
+    auto blocked = clock::now() - begin;
+    if (n < 0 && errno != EINTR) {
+      throw std::system_error(errno, std::generic_category(), "ppoll failed");
+    }
+    ++stats_.waits;
+    stats_.blocked += blocked;
+    if (n > 0) {
+      ++stats_.wakeups;
+    }
+    // spin again after each wait
+    idle_ = false;
+    return n > 0;
+  }
+
+  /// Retrieve and reset the statistics since the previous call.
+  Stats take_stats() {
+    auto now = clock::now();
+    Stats stats = stats_;
+    stats.period = now - stats_begin_;
+    stats_ = {};
+    stats_begin_ = now;
+    total_.waits += stats.waits;
+    total_.wakeups += stats.wakeups;
+    total_.blocked += stats.blocked;
+    return stats;
+  }
+
+  /// Retrieve the statistics since the start of the event loop.
+  [[nodiscard]] Stats total_stats() const {
+    Stats total = total_;
+    total.waits += stats_.waits;
+    total.wakeups += stats_.wakeups;
+    total.blocked += stats_.blocked;
+    return total;
+  }
+
+private:
+  Config config_;
+  bool idle_ = false;
+  clock::time_point idle_since_;
+  Stats stats_;
+  clock::time_point stats_begin_ = clock::now();
+  Stats total_;
+};
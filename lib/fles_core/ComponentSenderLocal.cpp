@@ -0,0 +1,132 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ComponentSenderLocal.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+ComponentSenderLocal::ComponentSenderLocal(
+    uint64_t input_index,
+    InputBufferReadInterface& data_source,
+    uint32_t timeslice_size,
+    uint32_t overlap_size,
+    uint32_t max_timeslice_number,
+    volatile sig_atomic_t* signal_status)
+    : input_index_(input_index), data_source_(data_source),
+      timeslice_size_(timeslice_size), overlap_size_(overlap_size),
+      max_timeslice_number_(max_timeslice_number),
+      signal_status_(signal_status),
+      ack_coalescing_(data_source.desc_buffer().size() / 4,
+                      data_source.data_buffer().size() / 4) {
+  start_index_ = acked_ = cached_acked_ = write_index_ =
+      data_source.get_read_index();
+
+  // at most one buffer size of components is unreleased
+  size_t min_release_buffer_size =
+      data_source_.desc_buffer().size() / timeslice_size_ + 1;
+  released_.alloc_with_size(min_release_buffer_size);
+}
+
+void ComponentSenderLocal::operator()() {
+  data_source_.proceed();
+  report_status();
+  scheduler_.add_repeating([this] { report_status(); },
+                           std::chrono::seconds(1));
+
+  while (released_ts_ < max_timeslice_number_ && *signal_status_ == 0) {
+    bool released = process_releases();
+    uint64_t available = available_.load(std::memory_order_relaxed);
+    data_source_.proceed();
+    update_available();
+    if (!released &&
+        available == available_.load(std::memory_order_relaxed)) {
+      // wait for the builders or for more data to arrive in the input buffer
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    scheduler_.timer();
+  }
+
+  sync_data_source();
+}
+
+ComponentSenderLocal::Component
+ComponentSenderLocal::component(uint64_t ts) const {
+  assert(available(ts));
+  auto& desc = data_source_.desc_buffer();
+  uint64_t desc_offset = ts * timeslice_size_ + start_index_.desc;
+  uint64_t desc_length = timeslice_size_ + overlap_size_;
+  uint64_t data_offset = desc.at(desc_offset).offset;
+  uint64_t data_end = desc.at(desc_offset + desc_length - 1).offset +
+                      desc.at(desc_offset + desc_length - 1).size;
+  assert(data_end >= data_offset);
+  return {desc_offset, desc_length, data_offset, data_end - data_offset};
+}
+
+void ComponentSenderLocal::release(uint64_t ts) {
+  assert(available(ts));
+  released_.at(ts).store(ts + 1, std::memory_order_release);
+}
+
+void ComponentSenderLocal::update_available() {
+  write_index_ = data_source_.get_write_index();
+  uint64_t complete_desc = start_index_.desc + overlap_size_;
+  if (write_index_.desc < complete_desc) {
+    return;
+  }
+  uint64_t available = std::min<uint64_t>(
+      (write_index_.desc - complete_desc) / timeslice_size_,
+      max_timeslice_number_);
+  // the buffer contents up to here are visible to the builders
+  available_.store(available, std::memory_order_release);
+}
+
+bool ComponentSenderLocal::process_releases() {
+  // releases of later timeslices are kept until the earliest pending
+  // timeslice is released
+  uint64_t ts = released_ts_;
+  while (released_.at(ts).load(std::memory_order_acquire) == ts + 1) {
+    ++ts;
+  }
+  if (ts == released_ts_) {
+    return false;
+  }
+  released_ts_ = ts;
+  acked_.desc = released_ts_ * timeslice_size_ + start_index_.desc;
+  acked_.data = data_source_.desc_buffer().at(acked_.desc - 1).offset +
+                data_source_.desc_buffer().at(acked_.desc - 1).size;
+  // release buffer space the sooner the fuller the buffer is
+  if (ack_coalescing_.due(acked_.desc - cached_acked_.desc,
+                          acked_.data - cached_acked_.data, buffer_fill())) {
+    cached_acked_ = acked_;
+    data_source_.set_read_index(cached_acked_);
+  }
+  return true;
+}
+
+void ComponentSenderLocal::sync_data_source() {
+  if (acked_.data > cached_acked_.data || acked_.desc > cached_acked_.desc) {
+    cached_acked_ = acked_;
+    data_source_.set_read_index(cached_acked_);
+  }
+}
+
+double ComponentSenderLocal::buffer_fill() const {
+  double fill_desc =
+      static_cast<double>(write_index_.desc - cached_acked_.desc) /
+      static_cast<double>(data_source_.desc_buffer().size());
+  double fill_data =
+      static_cast<double>(write_index_.data - cached_acked_.data) /
+      static_cast<double>(data_source_.data_buffer().size());
+  return std::max(fill_desc, fill_data);
+}
+
+void ComponentSenderLocal::report_status() {
+  L_(debug) << "[i" << input_index_ << "] local: "
+            << human_readable_count(released_ts_, true, "") << " timeslices, "
+            << human_readable_count(acked_.data - start_index_.data, true)
+            << " released, buffer "
+            << static_cast<int>(buffer_fill() * 100) << "% full";
+}
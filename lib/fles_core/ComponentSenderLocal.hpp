@@ -0,0 +1,145 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "AckCoalescing.hpp"
+#include "DualRingBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "Scheduler.hpp"
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <string>
+
+/// Input buffer class for co-located timeslice building.
+/** A ComponentSenderLocal object makes the timeslice components of an input
+    buffer available to the TimesliceBuilderLocal objects of the same
+    process. Instead of sending the data, the builders copy it directly
+    from the input buffer into their timeslice buffers and release it
+    afterwards.
+
+    The object's own thread is the only one to access the data source
+    object (e.g., to generate data). It publishes the number of complete
+    timeslice components and collects the releases in order to update the
+    read index. The builders only read the buffer contents below the
+    published write index. */
+
+class ComponentSenderLocal {
+public:
+  /// The extent of a timeslice component in the input buffer.
+  struct Component {
+    uint64_t desc_offset;
+    uint64_t desc_length;
+    uint64_t data_offset;
+    uint64_t data_length;
+  };
+
+  /// The ComponentSenderLocal constructor.
+  ComponentSenderLocal(uint64_t input_index,
+                       InputBufferReadInterface& data_source,
+                       uint32_t timeslice_size,
+                       uint32_t overlap_size,
+                       uint32_t max_timeslice_number,
+                       volatile sig_atomic_t* signal_status);
+
+  ComponentSenderLocal(const ComponentSenderLocal&) = delete;
+  void operator=(const ComponentSenderLocal&) = delete;
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "CS/Local/i" + std::to_string(input_index_);
+  };
+
+  /// Check whether a timeslice component is available (thread-safe).
+  [[nodiscard]] bool available(uint64_t ts) const {
+    return ts < available_.load(std::memory_order_acquire);
+  }
+
+  /// Retrieve the extent of an available timeslice component.
+  [[nodiscard]] Component component(uint64_t ts) const;
+
+  /// Retrieve the microslice descriptor buffer of the input.
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() {
+    return data_source_.desc_buffer();
+  }
+
+  /// Retrieve the microslice data buffer of the input.
+  RingBufferView<uint8_t>& data_buffer() {
+    return data_source_.data_buffer();
+  }
+
+  /// Release a timeslice component after it has been copied (thread-safe).
+  /** Each available component is released exactly once. */
+  void release(uint64_t ts);
+
+private:
+  /// This component's index in the list of input components.
+  uint64_t input_index_;
+
+  /// Data source (e.g., FLIB via shared memory).
+  InputBufferReadInterface& data_source_;
+
+  /// Constant size (in microslices) of a timeslice component.
+  const uint32_t timeslice_size_;
+
+  /// Constant overlap size (in microslices) of a timeslice component.
+  const uint32_t overlap_size_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// Number of complete timeslice components in the input buffer.
+  std::atomic<uint64_t> available_{0};
+
+  /// Release status of timeslice components, indexed by timeslice.
+  /** A builder stores the timeslice number plus one, the entries are
+      collected in order by the sender thread. */
+  RingBuffer<std::atomic<uint64_t>, true> released_;
+
+  /// Number of released timeslices.
+  uint64_t released_ts_ = 0;
+
+  /// Indexes of released microslices (i.e., read indexes).
+  DualIndex acked_{};
+
+  /// Hysteresis for writing read indexes to data source.
+  const AckCoalescing ack_coalescing_;
+
+  /// Read indexes last written to data source.
+  DualIndex cached_acked_{};
+
+  /// Read indexes at start of operation.
+  DualIndex start_index_{};
+
+  /// Write index received from data source.
+  DualIndex write_index_{};
+
+  /// Scheduler for periodic events.
+  Scheduler scheduler_;
+
+  /// Publish the timeslice components completed in the input buffer.
+  void update_available();
+
+  /// Collect the released components, updating the read indexes.
+  /** Returns true if any component has been released. */
+  bool process_releases();
+
+  /// Force writing read indexes to data source.
+  void sync_data_source();
+
+  /// Fill level of the input buffer (maximum of desc and data, 0 to 1).
+  [[nodiscard]] double buffer_fill() const;
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+};
@@ -21,5 +21,23 @@ public:
    */
   [[nodiscard]] virtual std::string thread_name() const { return "CGWorker"; };
 
+  /**
+   * @brief Perform a single non-blocking progress step.
+   *
+   * Workers supporting cooperative scheduling (see cooperative()) may be
+   * driven by repeated calls to step() instead of operator()(), so that
+   * several of them share a thread (see WorkerGroup). The default
+   * implementation runs the worker to completion.
+   *
+   * @return Whether the worker has work left.
+   */
+  virtual bool step() {
+    (*this)();
+    return false;
+  }
+
+  /// Check whether the worker supports cooperative scheduling.
+  [[nodiscard]] virtual bool cooperative() const { return false; }
+
   virtual ~ConnectionGroupWorker() = default;
 };
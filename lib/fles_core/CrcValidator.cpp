@@ -0,0 +1,121 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "CrcValidator.hpp"
+#include <stdexcept>
+
+CrcValidator::CrcValidator(unsigned num_threads) {
+  if (num_threads == 0) {
+    throw std::invalid_argument("CrcValidator: no threads given");
+  }
+
+  // create CRC-32C engine (Castagnoli polynomial)
+  crc32_engine_ = crcutil_interface::CRC::Create(
+      0x82f63b78, 0, 32, true, 0, 0, 0,
+      crcutil_interface::CRC::IsSSE42Available(), nullptr);
+
+  for (unsigned i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this] { work(); });
+  }
+}
+
+CrcValidator::~CrcValidator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+  crc32_engine_->Delete();
+}
+
+void CrcValidator::submit(uint64_t id, std::vector<Component> components) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::make_unique<Job>(Job{id, std::move(components)}));
+  }
+  cv_.notify_one();
+}
+
+bool CrcValidator::try_get(uint64_t& id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (jobs_.empty() || !jobs_.front()->done) {
+    return false;
+  }
+  id = jobs_.front()->id;
+  jobs_.pop_front();
+  --started_;
+  return true;
+}
+
+std::size_t CrcValidator::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return jobs_.size();
+}
+
+void CrcValidator::work() {
+  // buffers of the batch computation, reused for all components
+  std::vector<const void*> data;
+  std::vector<std::size_t> bytes;
+  std::vector<crcutil_interface::UINT64> crcs;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stopped_ || started_ < jobs_.size(); });
+    if (stopped_) {
+      return;
+    }
+    // jobs are only removed once done, so the pointer stays valid
+    Job* job = jobs_[started_++].get();
+    lock.unlock();
+    validate(*job, data, bytes, crcs);
+    lock.lock();
+    job->done = true;
+  }
+}
+
+void CrcValidator::validate(Job& job,
+                            std::vector<const void*>& data,
+                            std::vector<std::size_t>& bytes,
+                            std::vector<crcutil_interface::UINT64>& crcs) {
+  constexpr auto crc_valid =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+  constexpr auto crc_checked =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked);
+  constexpr auto crc_error =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcError);
+
+  uint64_t checked = 0;
+  uint64_t errors = 0;
+  for (const Component& component : job.components) {
+    fles::MicrosliceDescriptor* desc = component.desc;
+    const std::size_t count = component.num_microslices;
+    if (count == 0) {
+      continue;
+    }
+    const auto* contents = reinterpret_cast<const uint8_t*>(desc + count);
+    data.resize(count);
+    bytes.resize(count);
+    crcs.assign(count, 0);
+    for (std::size_t m = 0; m < count; ++m) {
+      data[m] = contents + (desc[m].offset - desc[0].offset);
+      bytes[m] = (desc[m].flags & crc_valid) != 0 ? desc[m].size : 0;
+    }
+    crc32_engine_->ComputeBatch(data.data(), bytes.data(), count,
+                                crcs.data());
+    for (std::size_t m = 0; m < count; ++m) {
+      if ((desc[m].flags & crc_valid) == 0) {
+        continue;
+      }
+      ++checked;
+      desc[m].flags |= crc_checked;
+      if (static_cast<uint32_t>(crcs[m]) != desc[m].crc) {
+        ++errors;
+        desc[m].flags |= crc_error;
+      }
+    }
+  }
+  checked_ += checked;
+  errors_ += errors;
+}
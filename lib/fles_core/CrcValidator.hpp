@@ -0,0 +1,81 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include "interface.h" // crcutil_interface
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Validation of microslice CRCs on helper threads.
+/** A CrcValidator checks the content CRC of all microslices of submitted
+    timeslices that carry a valid CRC (MicrosliceFlags::CrcValid) and marks
+    each of them in place as checked (MicrosliceFlags::CrcChecked) and, on
+    mismatch, as erroneous (MicrosliceFlags::CrcError), so that consumers
+    need not compute the CRCs again. The CRCs of a component are computed
+    in one batch. Timeslices are validated in parallel and retrieved in
+    order of submission. */
+class CrcValidator {
+public:
+  /// The microslices of a timeslice component, laid out as in
+  /// fles::Timeslice (descriptors followed by contents).
+  struct Component {
+    fles::MicrosliceDescriptor* desc;
+    uint64_t num_microslices;
+  };
+
+  /// The CrcValidator constructor, starting the given number of threads.
+  explicit CrcValidator(unsigned num_threads);
+
+  CrcValidator(const CrcValidator&) = delete;
+  void operator=(const CrcValidator&) = delete;
+
+  /// The CrcValidator destructor, discarding pending timeslices.
+  ~CrcValidator();
+
+  /// Submit the components of a timeslice for validation.
+  void submit(uint64_t id, std::vector<Component> components);
+
+  /// Retrieve the next validated timeslice (in order of submission).
+  bool try_get(uint64_t& id);
+
+  /// Retrieve the number of submitted timeslices not yet retrieved.
+  [[nodiscard]] std::size_t pending() const;
+
+  /// Retrieve the number of microslices checked so far.
+  [[nodiscard]] uint64_t checked() const { return checked_; }
+
+  /// Retrieve the number of microslices found with a CRC mismatch.
+  [[nodiscard]] uint64_t errors() const { return errors_; }
+
+private:
+  struct Job {
+    uint64_t id;
+    std::vector<Component> components;
+    bool done = false;
+  };
+
+  void work();
+  void validate(Job& job, std::vector<const void*>& data,
+                std::vector<std::size_t>& bytes,
+                std::vector<crcutil_interface::UINT64>& crcs);
+
+  crcutil_interface::CRC* crc32_engine_ = nullptr;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  /// Submitted jobs in order, the first `started_` of them are (being) done.
+  std::deque<std::unique_ptr<Job>> jobs_;
+  std::size_t started_ = 0;
+  bool stopped_ = false;
+  std::vector<std::thread> threads_;
+
+  std::atomic<uint64_t> checked_{0};
+  std::atomic<uint64_t> errors_{0};
+};
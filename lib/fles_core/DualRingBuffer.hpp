@@ -3,6 +3,12 @@
 
 #include "MicrosliceDescriptor.hpp"
 #include "RingBufferView.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <thread>
 
 struct DualIndex {
   uint64_t desc;
@@ -62,6 +68,45 @@ inline bool operator==(const DualIndex& lhs, const DualIndex& rhs) {
   return lhs.desc == rhs.desc && lhs.data == rhs.data;
 }
 
+/// A contiguous range of ring buffer entries.
+template <typename T> struct RingBufferSpan {
+  T* ptr = nullptr;
+  std::size_t size = 0;
+};
+
+/// Split the entries [begin, end) of a ring buffer into at most two spans.
+/** The second span is empty unless the range wraps around the end of a
+    buffer that is not mirrored. */
+template <typename T>
+std::array<RingBufferSpan<T>, 2>
+ring_buffer_spans(RingBufferView<T>& buffer, uint64_t begin, uint64_t end) {
+  assert(end - begin <= buffer.size());
+  const std::size_t count = end - begin;
+  const std::size_t pos = begin & buffer.size_mask();
+  if (buffer.mirrored() || pos + count <= buffer.size()) {
+    return {{{&buffer.at(begin), count}, {}}};
+  }
+  const std::size_t first = buffer.size() - pos;
+  return {{{&buffer.at(begin), first}, {buffer.ptr(), count - first}}};
+}
+
+/// A batch of consecutive entries of a dual ring buffer.
+/** The descriptors and the data of the batch are each given as at most two
+    contiguous spans, so that consumers need no wrap handling of their
+    own. */
+template <typename T_DESC, typename T_DATA> struct DualRingBufferBatch {
+  DualIndex begin{0, 0};
+  DualIndex end{0, 0};
+  std::array<RingBufferSpan<T_DESC>, 2> desc{};
+  std::array<RingBufferSpan<T_DATA>, 2> data{};
+
+  /// Retrieve the number of descriptors in the batch.
+  [[nodiscard]] uint64_t size() const { return end.desc - begin.desc; }
+
+  /// Check whether the batch contains no descriptors.
+  [[nodiscard]] bool empty() const { return end.desc == begin.desc; }
+};
+
 /// Abstract FLES data source class.
 template <typename T_DESC, typename T_DATA> class DualRingBufferReadInterface {
 public:
@@ -76,8 +121,54 @@ public:
   virtual void set_read_index(DualIndex new_read_index) = 0;
   virtual DualIndex get_read_index() = 0;
 
+  /// Return whether the writer may overwrite unread items of this reader.
+  /** Such a reader does not hold back buffer space. Items before the current
+      get_read_index() are no longer valid and have to be skipped, also if
+      this happened while reading them. */
+  virtual bool may_be_overtaken() { return false; }
+
+  /// Wait for the descriptor write index to advance beyond a given value.
+  /** Returns early if the writer signals new data or end of stream. Readers
+      without a notification mechanism just sleep for the given time. */
+  virtual void wait_write_index(uint64_t /* desc */,
+                                std::chrono::microseconds timeout) {
+    std::this_thread::sleep_for(timeout);
+  }
+
   virtual RingBufferView<T_DATA>& data_buffer() = 0;
   virtual RingBufferView<T_DESC>& desc_buffer() = 0;
+
+  using Batch = DualRingBufferBatch<T_DESC, T_DATA>;
+
+  /// Acquire a batch of up to max_count written entries starting at begin.
+  /** The write index is fetched once per call. The data range of the batch
+      is given by its descriptors (begin.data is only used if the batch is
+      empty). The entries stay valid until released. */
+  virtual Batch acquire(DualIndex begin, uint64_t max_count) {
+    return make_batch(begin, get_write_index().desc, max_count);
+  }
+
+  /// Release the buffer space of all entries up to the end of a batch.
+  void release(const Batch& batch) { set_read_index(batch.end); }
+
+protected:
+  /// Create a batch of up to max_count entries from begin to write_desc.
+  Batch make_batch(DualIndex begin, uint64_t write_desc, uint64_t max_count) {
+    Batch batch;
+    batch.begin = batch.end = begin;
+    if (write_desc <= begin.desc || max_count == 0) {
+      return batch;
+    }
+    const uint64_t count = std::min(write_desc - begin.desc, max_count);
+    RingBufferView<T_DESC>& desc = desc_buffer();
+    const T_DESC& last = desc.at(begin.desc + count - 1);
+    batch.begin.data = desc.at(begin.desc).offset;
+    batch.end = {begin.desc + count, last.offset + last.size};
+    batch.desc = ring_buffer_spans(desc, batch.begin.desc, batch.end.desc);
+    batch.data =
+        ring_buffer_spans(data_buffer(), batch.begin.data, batch.end.data);
+    return batch;
+  }
 };
 
 template <typename T_DESC, typename T_DATA> class DualRingBufferWriteInterface {
@@ -92,6 +183,33 @@ public:
 
   virtual RingBufferView<T_DATA>& data_buffer() = 0;
   virtual RingBufferView<T_DESC>& desc_buffer() = 0;
+
+  using Batch = DualRingBufferBatch<T_DESC, T_DATA>;
+
+  /// Reserve buffer space for a batch of the given size at begin.
+  /** The read index is fetched only if the space is not available with the
+      given cached read index, which is updated then. Returns an empty batch
+      if the space is not available. */
+  Batch reserve(DualIndex begin, DualIndex size, DualIndex& read_index) {
+    const DualIndex buffer_size = {desc_buffer().size(),
+                                   data_buffer().size()};
+    Batch batch;
+    batch.begin = batch.end = begin;
+    // DualIndex comparison means both components have to fulfill condition
+    if (!(buffer_size - begin + read_index >= size)) {
+      read_index = get_read_index();
+      if (!(buffer_size - begin + read_index >= size)) {
+        return batch;
+      }
+    }
+    batch.end = begin + size;
+    batch.desc = ring_buffer_spans(desc_buffer(), begin.desc, batch.end.desc);
+    batch.data = ring_buffer_spans(data_buffer(), begin.data, batch.end.data);
+    return batch;
+  }
+
+  /// Make all entries up to the end of a batch visible to the reader.
+  void commit(const Batch& batch) { set_write_index(batch.end); }
 };
 
 using InputBufferReadInterface =
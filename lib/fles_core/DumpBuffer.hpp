@@ -0,0 +1,82 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the DumpBuffer class.
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// Text buffer with fast number formatting for debug dumps.
+/** Numbers are formatted directly into the buffer, without the per-field
+    stream state changes of iomanip or boost::format. A complete dump is
+    then written to its output stream at once. The buffer keeps its
+    capacity when cleared, so that a buffer reused for each data set does
+    not allocate. */
+class DumpBuffer {
+public:
+  /// Append a string.
+  DumpBuffer& append(std::string_view s) {
+    buf_.append(s);
+    return *this;
+  }
+
+  /// Append a single character.
+  DumpBuffer& append(char c) {
+    buf_.push_back(c);
+    return *this;
+  }
+
+  /// Append an unsigned integer in decimal notation.
+  DumpBuffer& dec(uint64_t value) {
+    char digits[20];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buf_.append(digits, static_cast<std::size_t>(result.ptr - digits));
+    return *this;
+  }
+
+  /// Append an unsigned integer in hexadecimal notation, zero-padded to
+  /// (at least) the given number of digits.
+  DumpBuffer& hex(uint64_t value, int width) {
+    static constexpr char hex_digits[] = "0123456789abcdef";
+    char digits[16];
+    int n = 0;
+    do {
+      digits[15 - n++] = hex_digits[value & 0xf];
+      value >>= 4;
+    } while (value != 0);
+    for (; n < width && n < 16; ++n) {
+      digits[15 - n] = '0';
+    }
+    buf_.append(digits + 16 - n, static_cast<std::size_t>(n));
+    return *this;
+  }
+
+  /// Append a floating point number as a default-formatted stream would.
+  DumpBuffer& real(double value) {
+    char digits[32];
+    int n = std::snprintf(digits, sizeof(digits), "%g", value);
+    buf_.append(digits, static_cast<std::size_t>(n));
+    return *this;
+  }
+
+  /// Write the contents to an output stream and clear the buffer.
+  void write_to(std::ostream& s) {
+    s.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    buf_.clear();
+  }
+
+  /// Discard the contents.
+  void clear() { buf_.clear(); }
+
+  [[nodiscard]] const std::string& str() const { return buf_; }
+
+  [[nodiscard]] std::size_t size() const { return buf_.size(); }
+
+private:
+  std::string buf_;
+};
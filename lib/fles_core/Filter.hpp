@@ -69,6 +69,7 @@ private:
   source_t& source;
   filter_t& filter;
   bool more = false;
+  bool source_eos = false;
   bool eos_flag = false;
 
   using filter_output_t = typename Filter<Input, Output>::filter_output_t;
@@ -79,22 +80,25 @@ private:
     }
 
     filter_output_t filter_output;
-    if (more) {
+    if (more || source_eos) {
       filter_output = filter.exchange_item();
-    } else {
-      do {
-        auto item = source.get();
-        if (!item) {
-          eos_flag = true;
-          return nullptr;
-        }
+    }
+    while (!filter_output.first && !source_eos) {
+      auto item = source.get();
+      if (item) {
         filter_output = filter.exchange_item(std::move(item));
-      } while (!filter_output.first);
+      } else {
+        // drain items still held by the filter
+        source_eos = true;
+        filter_output = filter.exchange_item();
+      }
+    }
+    if (!filter_output.first) {
+      eos_flag = true;
+      return nullptr;
     }
     more = filter_output.second;
-    // NOLINTNEXTLINE
-    return new Output(*filter_output.first);
-    // TODO(Jan): Solve this without the additional alloc/copy operation
+    return filter_output.first.release();
   }
 };
 
@@ -122,6 +126,18 @@ public:
     }
   }
 
+  /// Pass on the items still held by the filter, then end the sink stream.
+  void end_stream() override {
+    typename Filter<Input, Output>::filter_output_t filter_output;
+    do {
+      filter_output = filter.exchange_item();
+      if (filter_output.first) {
+        sink.put(std::move(filter_output.first));
+      }
+    } while (filter_output.second);
+    sink.end_stream();
+  }
+
 private:
   sink_t& sink;
   filter_t& filter;
@@ -133,4 +149,10 @@ using MicrosliceFilter = Filter<Microslice, StorableMicroslice>;
 using FilteredMicrosliceSource = FilteredSource<Microslice, StorableMicroslice>;
 using FilteringMicrosliceSink = FilteringSink<Microslice, StorableMicroslice>;
 
+class Timeslice;
+class StorableTimeslice;
+using TimesliceFilter = Filter<Timeslice, StorableTimeslice>;
+using FilteredTimesliceSource = FilteredSource<Timeslice, StorableTimeslice>;
+using FilteringTimesliceSink = FilteringSink<Timeslice, StorableTimeslice>;
+
 } // namespace fles
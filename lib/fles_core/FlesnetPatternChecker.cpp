@@ -4,15 +4,9 @@
 
 bool FlesnetPatternChecker::check(const fles::Microslice& m) {
   const auto* content = reinterpret_cast<const uint64_t*>(m.content());
-  uint32_t crc = 0x00000000;
-  for (size_t pos = 0; pos < m.desc().size / sizeof(uint64_t); ++pos) {
-    uint64_t data_word = content[pos];
-    crc ^= (data_word & 0xffffffff) ^ (data_word >> 32);
-    uint64_t expected =
-        (static_cast<uint64_t>(component) << 48) | (pos * sizeof(uint64_t));
-    if (data_word != expected) {
-      return false;
-    }
-  }
-  return crc == m.desc().crc;
+  auto r = ramp_pattern::check(content, m.desc().size / sizeof(uint64_t),
+                               static_cast<uint64_t>(component) << 48,
+                               sizeof(uint64_t), level);
+  set_errors(r.errors, r.first_error * sizeof(uint64_t));
+  return r.errors == 0 && ramp_pattern::crc(r.xor_value) == m.desc().crc;
 }
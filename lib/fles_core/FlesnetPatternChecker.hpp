@@ -2,14 +2,18 @@
 #pragma once
 
 #include "PatternChecker.hpp"
+#include "RampPattern.hpp"
 
 class FlesnetPatternChecker : public PatternChecker {
 public:
-  explicit FlesnetPatternChecker(std::size_t arg_component)
-      : component(arg_component){};
+  explicit FlesnetPatternChecker(
+      std::size_t arg_component,
+      ramp_pattern::SimdLevel arg_level = ramp_pattern::supported_level())
+      : component(arg_component), level(arg_level){};
 
   bool check(const fles::Microslice& m) override;
 
 private:
   std::size_t component = 0;
+  ramp_pattern::SimdLevel level;
 };
@@ -1,41 +1,99 @@
 // Copyright 2012-2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "FlesnetPatternGenerator.hpp"
+#include "RampPattern.hpp"
+#include <type_traits>
 
-void FlesnetPatternGenerator::proceed() {
+namespace {
+
+// Quantile of a microslice shared by all generators (splitmix64 hash)
+double common_quantile(uint64_t microslice) {
+  uint64_t z = microslice + UINT64_C(0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+  z ^= z >> 31;
+  return static_cast<double>(z >> 11) * 0x1.0p-53;
+}
+
+} // namespace
+
+void FlesnetPatternGenerator::set_size_record(
+    std::shared_ptr<const SizeRecord> record,
+    double speed,
+    double correlation) {
+  size_record_ = std::move(record);
+  speed_ = speed;
+  correlation_ = correlation;
+  quantile_generator_.seed(input_index_);
+}
+
+uint32_t FlesnetPatternGenerator::content_size(uint64_t microslice) {
+  if (size_record_) {
+    double quantile = quantile_distribution_(quantile_generator_);
+    if (correlation_ > 0 &&
+        quantile_distribution_(quantile_generator_) < correlation_) {
+      quantile = common_quantile(microslice);
+    }
+    return size_record_->size(microslice, quantile);
+  }
+  if (randomize_sizes_) {
+    return random_distribution_(random_generator_);
+  }
+  return typical_content_size_;
+}
+
+void FlesnetPatternGenerator::select_proceed() {
+  with_fixed_size(data_buffer_view_, common_data_size_exponents(),
+                  [this](auto& data) {
+                    using DataView = std::remove_reference_t<decltype(data)>;
+                    proceed_ = &FlesnetPatternGenerator::proceed_with<DataView>;
+                  });
+}
+
+template <typename DataView> void FlesnetPatternGenerator::proceed_with() {
+  DataView data_buffer(data_buffer_view_);
   const DualIndex min_avail = {desc_buffer_.size() / 4,
-                               data_buffer_.size() / 4};
+                               data_buffer.size() / 4};
 
   // break unless significant space is available
   if ((write_index_.data - read_index_.data + min_avail.data >
-       data_buffer_.size()) ||
+       data_buffer.size()) ||
       (write_index_.desc - read_index_.desc + min_avail.desc >
        desc_buffer_.size())) {
     return;
   }
 
-  while (true) {
-    // check for current time (rate limiting)
-    if (delay_ns_ != UINT64_C(0)) {
-      auto delta = std::chrono::high_resolution_clock::now() - begin_;
-      auto delta_ns =
-          std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count();
-      auto required_ns =
-          static_cast<int64_t>(delay_ns_ * write_index_.desc + initial_ns_);
-      if (delta_ns < required_ns) {
-        return;
-      }
+  // check for current time (rate limiting), generate all microslices due
+  uint64_t batch = UINT64_MAX;
+  uint64_t elapsed_ns = 0;
+  if (rate_limited()) {
+    auto delta = std::chrono::high_resolution_clock::now() - begin_;
+    auto delta_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count();
+    if (delta_ns < static_cast<int64_t>(initial_ns_)) {
+      return;
     }
+    elapsed_ns = static_cast<uint64_t>(delta_ns) - initial_ns_;
+  }
+  if (delay_ns_ != UINT64_C(0) && !record_paced()) {
+    uint64_t due = elapsed_ns / delay_ns_ + 1;
+    if (due <= write_index_.desc) {
+      return;
+    }
+    batch = due - write_index_.desc;
+  }
 
-    unsigned int content_bytes = typical_content_size_;
-    if (randomize_sizes_) {
-      content_bytes = random_distribution_(random_generator_);
+  for (; batch != 0; --batch) {
+    // a recorded time series is paced microslice by microslice
+    if (record_paced() && due_ns(write_index_.desc) > elapsed_ns) {
+      return;
     }
+    unsigned int content_bytes = content_size(write_index_.desc);
     content_bytes &= ~0x7u; // round down to multiple of sizeof(uint64_t)
 
     // check for space in data and descriptor buffers
     if ((write_index_.data - read_index_.data + content_bytes >
-         data_buffer_.bytes()) ||
+         data_buffer.bytes()) ||
         (write_index_.desc - read_index_.desc + 1 > desc_buffer_.size())) {
       return;
     }
@@ -55,15 +113,22 @@ void FlesnetPatternGenerator::proceed() {
     uint32_t size = content_bytes;
     uint64_t offset = write_index_.data;
 
-    // write to data buffer
+    // write to data buffer, in contiguous runs between ring wrap points
     if (generate_pattern_) {
-      for (uint64_t i = 0; i < content_bytes; i += sizeof(uint64_t)) {
-        uint64_t data_word = (input_index_ << 48L) | i;
-        reinterpret_cast<uint64_t&>(data_buffer_.at(write_index_.data)) =
-            data_word;
-        write_index_.data += sizeof(uint64_t);
-        crc ^= (data_word & 0xffffffff) ^ (data_word >> 32L);
+      uint64_t xor_value = 0;
+      uint64_t word = input_index_ << 48L;
+      uint64_t remaining = content_bytes;
+      while (remaining != 0) {
+        uint64_t pos = write_index_.data & data_buffer.size_mask();
+        uint64_t run = std::min(remaining, data_buffer.bytes() - pos);
+        xor_value ^= ramp_pattern::fill(
+            reinterpret_cast<uint64_t*>(&data_buffer.at(pos)),
+            run / sizeof(uint64_t), word);
+        word += run;
+        write_index_.data += run;
+        remaining -= run;
       }
+      crc = ramp_pattern::crc(xor_value);
     } else {
       write_index_.data += content_bytes;
     }
@@ -2,12 +2,15 @@
 #pragma once
 
 #include "DualRingBuffer.hpp"
+#include "MemoryAccounting.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "RingBuffer.hpp"
 #include "RingBufferView.hpp"
+#include "SizeRecord.hpp"
 #include "log.hpp"
 #include <algorithm>
 #include <chrono>
+#include <memory>
 #include <random>
 
 /// Simple embedded software pattern generator.
@@ -21,16 +24,24 @@ public:
                           bool generate_pattern = false,
                           bool randomize_sizes = false,
                           uint64_t delay_ns = 0,
-                          uint64_t initial_ns = 0)
-      : data_buffer_(data_buffer_size_exp), desc_buffer_(desc_buffer_size_exp),
-        data_buffer_view_(data_buffer_.ptr(), data_buffer_size_exp),
-        desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_size_exp),
+                          uint64_t initial_ns = 0,
+                          const MemoryPlacement& placement = {})
+      : data_buffer_(data_buffer_size_exp, placement),
+        desc_buffer_(desc_buffer_size_exp, placement),
+        data_buffer_view_(data_buffer_.ptr(), data_buffer_size_exp,
+                          data_buffer_.mirrored()),
+        desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_size_exp,
+                          desc_buffer_.mirrored()),
         input_index_(input_index), generate_pattern_(generate_pattern),
         typical_content_size_(typical_content_size),
         randomize_sizes_(randomize_sizes),
         random_distribution_(typical_content_size), delay_ns_(delay_ns),
-        initial_ns_(initial_ns) {
+        initial_ns_(initial_ns),
+        account_("pattern_generator", MemoryUse::Committed,
+                 data_buffer_.bytes() + desc_buffer_.bytes(),
+                 placement.numa_node) {
     begin_ = std::chrono::high_resolution_clock::now();
+    select_proceed();
   }
 
   FlesnetPatternGenerator(const FlesnetPatternGenerator&) = delete;
@@ -42,7 +53,33 @@ public:
     return desc_buffer_view_;
   }
 
-  void proceed() override;
+  void proceed() override { (this->*proceed_)(); }
+
+  /// Generate the microslice sizes from a recorded data source.
+  /** With a speed above 0, the microslices of a time series are due at
+      their recorded times divided by the speed instead of at a fixed
+      delay. A size drawn from a histogram uses, with the probability
+      given by the correlation, a quantile shared by all generators
+      instead of its own, so that the inputs see large microslices at the
+      same time.
+
+      \param record      Recorded microslice sizes
+      \param speed       Factor of the recorded speed (0: not paced)
+      \param correlation Inter-input correlation of the sizes (0 to 1) */
+  void set_size_record(std::shared_ptr<const SizeRecord> record,
+                       double speed = 0,
+                       double correlation = 0);
+
+  /// Retrieve whether the generation is rate-limited.
+  [[nodiscard]] bool rate_limited() const {
+    return delay_ns_ != 0 || record_paced();
+  }
+
+  /// Retrieve the time at which a microslice is due (if rate-limited).
+  [[nodiscard]] std::chrono::high_resolution_clock::time_point
+  due_time(uint64_t microslice) const {
+    return begin_ + std::chrono::nanoseconds(initial_ns_ + due_ns(microslice));
+  }
 
   DualIndex get_write_index() override { return write_index_; }
 
@@ -81,10 +118,49 @@ private:
   uint64_t initial_ns_;
   std::chrono::high_resolution_clock::time_point begin_;
 
+  /// Recorded microslice sizes (if any).
+  std::shared_ptr<const SizeRecord> size_record_;
+  double speed_ = 0;
+  double correlation_ = 0;
+
+  /// Generator of the quantiles of this input's sizes.
+  std::mt19937_64 quantile_generator_;
+  std::uniform_real_distribution<double> quantile_distribution_;
+
+  /// Whether the microslices are paced by the times of a time series.
+  [[nodiscard]] bool record_paced() const {
+    return size_record_ && size_record_->series() && speed_ > 0;
+  }
+
+  /// Retrieve the time a microslice is due after the initial delay (ns).
+  [[nodiscard]] uint64_t due_ns(uint64_t microslice) const {
+    if (record_paced()) {
+      return static_cast<uint64_t>(
+          static_cast<double>(size_record_->time(microslice)) / speed_);
+    }
+    return microslice * delay_ns_;
+  }
+
+  /// Determine the content size of a microslice.
+  uint32_t content_size(uint64_t microslice);
+
+  /// Select the implementation of proceed() for the data buffer size.
+  void select_proceed();
+
+  /// Generate due microslices, accessing the data buffer through a view
+  /// of type DataView (a RingBufferView or FixedRingBufferView).
+  template <typename DataView> void proceed_with();
+
+  /// The implementation of proceed() specialized for the buffer size.
+  void (FlesnetPatternGenerator::*proceed_)() = nullptr;
+
   /// Number of acknowledged data bytes and microslices. Updated by input
   /// node.
   DualIndex read_index_{0, 0};
 
   /// FLIB-internal number of written microslices and data bytes.
   DualIndex write_index_{0, 0};
+
+  /// The accounting of the buffer memory.
+  MemoryAccount account_;
 };
@@ -15,6 +15,7 @@
 
 bool FlibPatternChecker::check(const fles::Microslice& m) {
   uint8_t last_word_size = 0;
+  set_errors(0, 0);
 
   // increment packte number if initialized
   if (flib_pgen_packet_number_ != 0) {
@@ -30,6 +31,7 @@ bool FlibPatternChecker::check(const fles::Microslice& m) {
       std::cerr << "last word " << static_cast<uint32_t>(last_word_size)
                 << std::endl;
       last_word_size = 0;
+      set_errors(1, 0);
       return false;
     }
     // Do not check last word size consistency and last word content if ms was
@@ -43,6 +45,7 @@ bool FlibPatternChecker::check(const fles::Microslice& m) {
         std::cerr << "desc.size " << m.desc().size << std::endl;
         std::cerr << "last word " << static_cast<uint32_t>(last_word_size)
                   << std::endl;
+        set_errors(1, 0);
         return false;
       }
     } else {
@@ -55,6 +58,7 @@ bool FlibPatternChecker::check(const fles::Microslice& m) {
     const uint16_t word = reinterpret_cast<const uint16_t*>(m.content())[1];
     if (word != 0xBBFF) {
       std::cerr << "Flib pgen: error in hdr word" << std::endl;
+      set_errors(1, 2);
       return false;
     }
   }
@@ -66,6 +70,7 @@ bool FlibPatternChecker::check(const fles::Microslice& m) {
     if (flib_pgen_packet_number_ != 0 &&
         flib_pgen_packet_number_ != flib_pgen_packet_number) {
       std::cerr << "Flib pgen: error in packet number" << std::endl;
+      set_errors(1, 4);
       return false;
     }
     // initialize if uninitialized
@@ -83,27 +88,27 @@ bool FlibPatternChecker::check(const fles::Microslice& m) {
     } else {
       ramp_limit = 9;
     }
-    size_t pos = 1;
-    uint64_t ramp = 0xABCD000000000000;
+    const uint64_t ramp = 0xABCD000000000000;
     const uint64_t* content =
-        reinterpret_cast<const uint64_t*>(m.content()) + 0;
+        reinterpret_cast<const uint64_t*>(m.content()) + 1;
+    size_t words = (m.desc().size - ramp_limit) / sizeof(uint64_t);
 
-    while (pos <= ((m.desc().size - ramp_limit) / sizeof(uint64_t))) {
-      if (content[pos] != ramp) {
-        std::cerr << "Flib pgen: error in ramp word "
-                  << " exp " << std::hex << ramp << " seen " << content[pos]
-                  << std::endl;
-        return false;
-      }
-      ++ramp;
-      ++pos;
+    auto r = ramp_pattern::check(content, words, ramp, 1, level_);
+    if (r.errors != 0) {
+      std::cerr << "Flib pgen: error in ramp word "
+                << " exp " << std::hex << ramp + r.first_error << " seen "
+                << content[r.first_error] << std::dec << " (" << r.errors
+                << " errors)" << std::endl;
+      set_errors(r.errors, (r.first_error + 1) * sizeof(uint64_t));
+      return false;
     }
 
     // check last word if any
-    size_t last_word_start = pos * sizeof(uint64_t);
+    size_t last_word_start = (words + 1) * sizeof(uint64_t);
     for (size_t i = 0; i < last_word_size; ++i) {
       if (m.content()[last_word_start + i] != 0xFA) {
         std::cerr << "Flib pgen: error in last word" << std::endl;
+        set_errors(1, last_word_start + i);
         return false;
       }
     }
@@ -2,12 +2,18 @@
 #pragma once
 
 #include "PatternChecker.hpp"
+#include "RampPattern.hpp"
 
 class FlibPatternChecker : public PatternChecker {
 public:
+  explicit FlibPatternChecker(
+      ramp_pattern::SimdLevel arg_level = ramp_pattern::supported_level())
+      : level_(arg_level){};
+
   bool check(const fles::Microslice& m) override;
   void reset() override { flib_pgen_packet_number_ = 0; };
 
 private:
   uint32_t flib_pgen_packet_number_ = 0;
+  ramp_pattern::SimdLevel level_;
 };
@@ -0,0 +1,139 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "InputFanIn.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+InputFanIn::InputFanIn(
+    std::vector<std::unique_ptr<InputBufferReadInterface>> sources,
+    std::size_t data_buffer_size_exp,
+    std::size_t desc_buffer_size_exp,
+    const MemoryPlacement& placement)
+    : sources_(std::move(sources)),
+      data_buffer_(data_buffer_size_exp, placement),
+      desc_buffer_(desc_buffer_size_exp, placement),
+      data_buffer_view_(data_buffer_.ptr(), data_buffer_size_exp,
+                        data_buffer_.mirrored()),
+      desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_size_exp,
+                        desc_buffer_.mirrored()) {
+  if (sources_.empty()) {
+    throw std::invalid_argument("InputFanIn: no sources given");
+  }
+  for (auto& source : sources_) {
+    DualIndex read = source->get_read_index();
+    heads_.push_back({read, read.desc});
+  }
+}
+
+void InputFanIn::proceed() {
+  for (auto& source : sources_) {
+    source->proceed();
+  }
+
+  std::vector<DualIndex> released(heads_.size());
+  for (std::size_t s = 0; s < heads_.size(); ++s) {
+    released[s] = heads_[s].read;
+  }
+
+  while (!eof_) {
+    // the next microslice index is complete once all sources provide it
+    bool complete = true;
+    for (std::size_t s = 0; s < sources_.size(); ++s) {
+      if (!available(s)) {
+        complete = false;
+        // check again, the source may have ended after writing
+        if (sources_[s]->get_eof() && !available(s)) {
+          eof_ = true;
+        }
+      }
+    }
+    if (!complete) {
+      break;
+    }
+
+    // discard microslices lacking a counterpart in another source
+    uint64_t idx = 0;
+    for (std::size_t s = 0; s < sources_.size(); ++s) {
+      idx = std::max(idx, next(s).idx);
+    }
+    bool aligned = true;
+    for (std::size_t s = 0; s < sources_.size(); ++s) {
+      if (next(s).idx < idx) {
+        skip(s);
+        aligned = false;
+      }
+    }
+    if (!aligned) {
+      continue;
+    }
+
+    // space for the microslices of all sources
+    uint64_t bytes = 0;
+    for (std::size_t s = 0; s < sources_.size(); ++s) {
+      bytes += next(s).size;
+    }
+    if (write_index_.desc - read_index_.desc + sources_.size() >
+            desc_buffer_.size() ||
+        write_index_.data - read_index_.data + bytes > data_buffer_.bytes()) {
+      break;
+    }
+
+    for (std::size_t s = 0; s < sources_.size(); ++s) {
+      copy(s);
+    }
+  }
+
+  for (std::size_t s = 0; s < heads_.size(); ++s) {
+    if (!(heads_[s].read == released[s])) {
+      sources_[s]->set_read_index(heads_[s].read);
+    }
+  }
+}
+
+bool InputFanIn::available(std::size_t s) {
+  Head& head = heads_[s];
+  if (head.read.desc >= head.write_desc) {
+    head.write_desc = sources_[s]->get_write_index().desc;
+  }
+  return head.read.desc < head.write_desc;
+}
+
+void InputFanIn::skip(std::size_t s) {
+  Head& head = heads_[s];
+  const fles::MicrosliceDescriptor& desc = next(s);
+  head.read.data = desc.offset + desc.size;
+  ++head.read.desc;
+  ++discarded_;
+}
+
+void InputFanIn::copy(std::size_t s) {
+  Head& head = heads_[s];
+  RingBufferView<uint8_t>& src = sources_[s]->data_buffer();
+  fles::MicrosliceDescriptor desc = next(s);
+
+  // copy the content in contiguous runs between the wrap points of both
+  // buffers
+  uint64_t from = desc.offset;
+  uint64_t to = write_index_.data;
+  uint64_t remaining = desc.size;
+  while (remaining != 0) {
+    uint64_t src_pos = from & src.size_mask();
+    uint64_t dst_pos = to & data_buffer_.size_mask();
+    uint64_t run = std::min({remaining, src.bytes() - src_pos,
+                             data_buffer_.bytes() - dst_pos});
+    std::memcpy(&data_buffer_.at(dst_pos), &src.at(src_pos), run);
+    from += run;
+    to += run;
+    remaining -= run;
+  }
+
+  head.read.data = desc.offset + desc.size;
+  ++head.read.desc;
+
+  desc.offset = write_index_.data;
+  desc_buffer_.at(write_index_.desc) = desc;
+  write_index_.data += desc.size;
+  ++write_index_.desc;
+}
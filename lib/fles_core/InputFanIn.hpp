@@ -0,0 +1,100 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "MemoryPlacement.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "RingBuffer.hpp"
+#include "RingBufferView.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Input data source merging several low-rate sources.
+/** An InputFanIn object combines the microslice streams of several data
+    sources (e.g., CRI channels of small detector links) into a single
+    stream, so that they form one timeslice component. The microslices are
+    copied into a ring buffer of the fan-in in lockstep: each microslice
+    index is taken from every source once, in the order of the sources. A
+    microslice for which not all sources provide the same index is
+    discarded and counted. Hence, a timeslice of n microslices per source
+    comprises n * num_sources() microslices of the merged stream.
+
+    The stream ends when any of the sources has ended. */
+class InputFanIn : public InputBufferReadInterface {
+public:
+  /// The InputFanIn constructor.
+  /**
+     \param sources              The data sources to merge (at least one)
+     \param data_buffer_size_exp Size exponent of the merged data buffer
+     \param desc_buffer_size_exp Size exponent of the merged desc buffer
+     \param placement            Memory placement of the merged buffers
+  */
+  InputFanIn(std::vector<std::unique_ptr<InputBufferReadInterface>> sources,
+             std::size_t data_buffer_size_exp,
+             std::size_t desc_buffer_size_exp,
+             const MemoryPlacement& placement = {});
+
+  InputFanIn(const InputFanIn&) = delete;
+  void operator=(const InputFanIn&) = delete;
+
+  void proceed() override;
+
+  DualIndex get_write_index() override { return write_index_; }
+
+  bool get_eof() override { return eof_; }
+
+  void set_read_index(DualIndex new_read_index) override {
+    read_index_ = new_read_index;
+  }
+
+  DualIndex get_read_index() override { return read_index_; }
+
+  RingBufferView<uint8_t>& data_buffer() override { return data_buffer_view_; }
+
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() override {
+    return desc_buffer_view_;
+  }
+
+  /// Retrieve the number of merged sources.
+  [[nodiscard]] std::size_t num_sources() const { return sources_.size(); }
+
+  /// Retrieve the number of microslices discarded for lack of a matching
+  /// microslice in another source.
+  [[nodiscard]] uint64_t discarded() const { return discarded_; }
+
+private:
+  /// Read position and known write index of a source.
+  struct Head {
+    DualIndex read;
+    uint64_t write_desc;
+  };
+
+  /// Whether the next microslice of a source is available.
+  bool available(std::size_t s);
+
+  /// Retrieve the descriptor of the next microslice of a source.
+  const fles::MicrosliceDescriptor& next(std::size_t s) {
+    return sources_[s]->desc_buffer().at(heads_[s].read.desc);
+  }
+
+  /// Drop the next microslice of a source.
+  void skip(std::size_t s);
+
+  /// Copy the next microslice of a source to the merged buffers.
+  void copy(std::size_t s);
+
+  std::vector<std::unique_ptr<InputBufferReadInterface>> sources_;
+  std::vector<Head> heads_;
+
+  RingBuffer<uint8_t> data_buffer_;
+  RingBuffer<fles::MicrosliceDescriptor, true> desc_buffer_;
+  RingBufferView<uint8_t> data_buffer_view_;
+  RingBufferView<fles::MicrosliceDescriptor> desc_buffer_view_;
+
+  DualIndex read_index_{0, 0};
+  DualIndex write_index_{0, 0};
+  bool eof_ = false;
+  uint64_t discarded_ = 0;
+};
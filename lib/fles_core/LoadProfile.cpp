@@ -0,0 +1,106 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "LoadProfile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+LoadProfile::LoadProfile(std::vector<Point> points, double period)
+    : points_(std::move(points)), period_(period) {
+  if (points_.empty()) {
+    throw std::invalid_argument("LoadProfile: no points given");
+  }
+  if (period_ < 0 || (period_ > 0 && points_.back().time > period_)) {
+    throw std::invalid_argument("LoadProfile: invalid period");
+  }
+  uint32_t mc_size = 0;
+  double time = 0;
+  for (const Point& p : points_) {
+    if (p.time < time || p.rate < 0 || p.rate > 1) {
+      throw std::invalid_argument("LoadProfile: invalid point at " +
+                                  std::to_string(p.time) + " s");
+    }
+    time = p.time;
+    if (p.mc_size != 0) {
+      mc_size = p.mc_size;
+    }
+    mc_size_.push_back(mc_size);
+  }
+}
+
+LoadProfile LoadProfile::parse(std::istream& is) {
+  std::vector<Point> points;
+  double period = 0;
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(is, line)) {
+    ++line_number;
+    std::istringstream ls(line.substr(0, line.find('#')));
+    std::string token;
+    if (!(ls >> token)) {
+      continue;
+    }
+    auto fail = [line_number]() {
+      return std::invalid_argument("LoadProfile: syntax error in line " +
+                                   std::to_string(line_number));
+    };
+    try {
+      if (token == "period") {
+        if (!(ls >> token)) {
+          throw fail();
+        }
+        period = std::stod(token);
+      } else {
+        Point p;
+        p.time = std::stod(token);
+        if (!(ls >> token)) {
+          throw fail();
+        }
+        p.rate = std::stod(token);
+        while (ls >> token) {
+          if (token == "ramp") {
+            p.ramp = true;
+          } else {
+            p.mc_size = static_cast<uint32_t>(std::stoul(token));
+          }
+        }
+        points.push_back(p);
+      }
+    } catch (const std::logic_error&) {
+      throw fail();
+    }
+  }
+  return LoadProfile(std::move(points), period);
+}
+
+LoadProfile::Setting LoadProfile::at(double time) const {
+  if (period_ > 0) {
+    time = std::fmod(time, period_);
+  }
+  // last point at or before the given time
+  auto next = std::upper_bound(
+      points_.begin(), points_.end(), time,
+      [](double t, const Point& p) { return t < p.time; });
+  if (next == points_.begin()) {
+    // before the first point, a ramp starts from zero at time zero
+    const Point& first = points_.front();
+    double rate = first.ramp && first.time > 0
+                      ? first.rate * std::max(time, 0.0) / first.time
+                      : 0.0;
+    return {rate, 0};
+  }
+  auto k = static_cast<size_t>(next - points_.begin()) - 1;
+  Setting s{points_[k].rate, mc_size_[k]};
+  if (next != points_.end() && next->ramp && next->time > points_[k].time) {
+    double f = (time - points_[k].time) / (next->time - points_[k].time);
+    s.rate += f * (next->rate - points_[k].rate);
+  }
+  return s;
+}
+
+bool LoadProfile::finished(double time) const {
+  return period_ == 0 && time >= points_.back().time;
+}
@@ -0,0 +1,71 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+/// Scripted load profile of a data source.
+/** A LoadProfile object describes the microslice rate of a pattern
+    generator over time, e.g. for ramps, bursts or a beam-like spill
+    structure. It consists of points at which the rate (as a fraction of
+    the maximum rate) and optionally the microslice size change. A point
+    reached by a ramp is approached linearly from the previous one,
+    otherwise the change is a step. A profile with a period repeats
+    itself.
+
+    In text form, each line holds a point as `<time/s> <rate>`, followed
+    by an optional microslice size and the optional keyword `ramp`. A line
+    `period <time/s>` makes the profile cyclic. Empty lines and text
+    following a `#` are ignored. */
+
+class LoadProfile {
+public:
+  /// A point of the profile.
+  struct Point {
+    double time = 0;      ///< time since the start of the profile (s)
+    double rate = 0;      ///< rate as a fraction of the maximum (0 to 1)
+    uint32_t mc_size = 0; ///< microslice size (0: unchanged)
+    bool ramp = false;    ///< approach the point linearly
+  };
+
+  /// Setting of the data source at a given time.
+  struct Setting {
+    double rate = 0;      ///< rate as a fraction of the maximum
+    uint32_t mc_size = 0; ///< microslice size (0: not specified yet)
+
+    bool operator==(const Setting& other) const {
+      return rate == other.rate && mc_size == other.mc_size;
+    }
+    bool operator!=(const Setting& other) const { return !(*this == other); }
+  };
+
+  /// Construct a profile from its points (in order of time).
+  /**
+     \param points Points of the profile
+     \param period Period of a cyclic profile in seconds (0: no repetition)
+  */
+  explicit LoadProfile(std::vector<Point> points, double period = 0);
+
+  /// Parse a profile in text form.
+  static LoadProfile parse(std::istream& is);
+
+  /// Retrieve the setting at a given time since the start (s).
+  [[nodiscard]] Setting at(double time) const;
+
+  /// Whether the profile has been completed at a given time (never if
+  /// cyclic).
+  [[nodiscard]] bool finished(double time) const;
+
+  /// Retrieve the points of the profile.
+  [[nodiscard]] const std::vector<Point>& points() const { return points_; }
+
+  /// Retrieve the period of the profile (0: not cyclic).
+  [[nodiscard]] double period() const { return period_; }
+
+private:
+  std::vector<Point> points_;
+  double period_;
+  /// Microslice size in effect from each point on.
+  std::vector<uint32_t> mc_size_;
+};
@@ -57,6 +57,16 @@ public:
     write_index_ += n;
   }
 
+  /// Retrieve a pointer to the next entry to be written, e.g., to fill the
+  /// buffer in place. Use skip_buffer_wrap() first to ensure contiguity.
+  T* write_ptr() { return &this->at(write_index_); }
+
+  /// Mark n entries written in place (see write_ptr()) as used.
+  void commit(std::size_t n) {
+    assert(size_available() >= n);
+    write_index_ += n;
+  }
+
   // skip remaining entries in ring buffer so that n entries can be stored
   // without fragmentation
   void skip_buffer_wrap(std::size_t n) {
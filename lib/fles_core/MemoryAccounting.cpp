@@ -0,0 +1,152 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MemoryAccounting.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <array>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+struct Totals {
+  std::array<uint64_t, 3> bytes{};
+  std::array<cbm::MetricGauge, 3> gauges;
+};
+
+const std::array<const char*, 3> use_fields = {
+    "reserved_bytes", "committed_bytes", "registered_bytes"};
+
+struct Registry {
+  std::mutex mutex;
+  std::map<std::pair<std::string, int>, Totals> totals;
+  cbm::Monitor* monitor = nullptr;
+  cbm::MetricTagSet tags;
+
+  // Register the gauges of a site (with the mutex held).
+  void register_gauges(const std::pair<std::string, int>& key,
+                       Totals& t) const {
+    cbm::MetricTagSet site_tags = tags;
+    site_tags.emplace_back("site", key.first);
+    site_tags.emplace_back("numa_node", std::to_string(key.second));
+    for (size_t i = 0; i < use_fields.size(); ++i) {
+      t.gauges[i] = monitor->RegisterGauge("memory", site_tags, use_fields[i]);
+      t.gauges[i].Set(static_cast<double>(t.bytes[i]));
+    }
+  }
+};
+
+Registry& registry() {
+  static Registry r;
+  return r;
+}
+
+} // namespace
+
+void MemoryAccounting::add(const std::string& site,
+                           int numa_node,
+                           MemoryUse use,
+                           int64_t bytes) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  auto key = std::make_pair(site, numa_node);
+  auto [it, inserted] = r.totals.try_emplace(key);
+  Totals& t = it->second;
+  auto i = static_cast<size_t>(use);
+  t.bytes[i] += static_cast<uint64_t>(bytes);
+  if (r.monitor != nullptr) {
+    if (inserted) {
+      r.register_gauges(key, t);
+    } else {
+      t.gauges[i].Set(static_cast<double>(t.bytes[i]));
+    }
+  }
+}
+
+std::vector<MemoryAccounting::Entry> MemoryAccounting::entries() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  std::vector<Entry> result;
+  for (const auto& [key, t] : r.totals) {
+    result.push_back({key.first, key.second, t.bytes[0], t.bytes[1],
+                      t.bytes[2]});
+  }
+  return result;
+}
+
+void MemoryAccounting::log_report() {
+  Entry total{"total", -1, 0, 0, 0};
+  for (const Entry& e : entries()) {
+    L_(info) << "memory " << e.site << " (NUMA node "
+             << (e.numa_node >= 0 ? std::to_string(e.numa_node) : "unknown")
+             << "): " << human_readable_count(e.reserved) << " reserved, "
+             << human_readable_count(e.committed) << " committed, "
+             << human_readable_count(e.registered) << " registered";
+    total.reserved += e.reserved;
+    total.committed += e.committed;
+    total.registered += e.registered;
+  }
+  L_(info) << "memory total: " << human_readable_count(total.reserved)
+           << " reserved, " << human_readable_count(total.committed)
+           << " committed, " << human_readable_count(total.registered)
+           << " registered";
+}
+
+void MemoryAccounting::attach(cbm::Monitor& monitor,
+                              const cbm::MetricTagSet& tags) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.monitor = &monitor;
+  r.tags = tags;
+  for (auto& [key, t] : r.totals) {
+    r.register_gauges(key, t);
+  }
+}
+
+void MemoryAccounting::detach() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.monitor = nullptr;
+  for (auto& [key, t] : r.totals) {
+    t.gauges = {};
+  }
+}
+
+MemoryAccount::MemoryAccount(std::string site,
+                             MemoryUse use,
+                             std::size_t bytes,
+                             int numa_node)
+    : site_(std::move(site)), use_(use), bytes_(bytes),
+      numa_node_(numa_node) {
+  MemoryAccounting::add(site_, numa_node_, use_,
+                        static_cast<int64_t>(bytes_));
+}
+
+MemoryAccount::MemoryAccount(MemoryAccount&& other) noexcept
+    : site_(std::move(other.site_)), use_(other.use_), bytes_(other.bytes_),
+      numa_node_(other.numa_node_) {
+  other.bytes_ = 0;
+}
+
+MemoryAccount& MemoryAccount::operator=(MemoryAccount&& other) noexcept {
+  if (this != &other) {
+    release();
+    site_ = std::move(other.site_);
+    use_ = other.use_;
+    bytes_ = other.bytes_;
+    numa_node_ = other.numa_node_;
+    other.bytes_ = 0;
+  }
+  return *this;
+}
+
+MemoryAccount::~MemoryAccount() { release(); }
+
+void MemoryAccount::release() {
+  if (bytes_ != 0) {
+    MemoryAccounting::add(site_, numa_node_, use_,
+                          -static_cast<int64_t>(bytes_));
+    bytes_ = 0;
+  }
+}
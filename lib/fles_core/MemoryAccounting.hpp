@@ -0,0 +1,87 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Process-wide accounting of the large memory allocations.
+#pragma once
+
+#include "Monitor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Use of an accounted memory allocation.
+enum class MemoryUse {
+  Reserved,  ///< Address space mapped, e.g., a shared memory region
+  Committed, ///< Memory backed by pages, e.g., a heap or prefaulted region
+  Registered ///< Memory registered (pinned) with a network device
+};
+
+/// Process-wide registry of the large memory allocations.
+/** The allocation sites report their memory through MemoryAccount objects.
+    The bytes are totaled per site, NUMA node and use. The totals can be
+    logged and are exported as gauges of the "memory" measurement once a
+    monitor is attached. All functions may be called from any thread. */
+class MemoryAccounting {
+public:
+  /// The accounted bytes of a site on a NUMA node.
+  struct Entry {
+    std::string site;
+    int numa_node = -1; ///< NUMA node (-1: unknown)
+    uint64_t reserved = 0;
+    uint64_t committed = 0;
+    uint64_t registered = 0;
+  };
+
+  /// Add (or, if negative, remove) a number of bytes to the totals.
+  static void add(const std::string& site,
+                  int numa_node,
+                  MemoryUse use,
+                  int64_t bytes);
+
+  /// Retrieve the current totals, ordered by site and NUMA node.
+  static std::vector<Entry> entries();
+
+  /// Log the current totals, one line per site and NUMA node.
+  static void log_report();
+
+  /// Export the totals as gauges to a monitor, tagged additionally by site
+  /// and NUMA node.
+  static void attach(cbm::Monitor& monitor, const cbm::MetricTagSet& tags);
+
+  /// Stop exporting the totals (before the monitor is destroyed).
+  static void detach();
+};
+
+/// Accounting of a memory allocation, removed on destruction.
+class MemoryAccount {
+public:
+  MemoryAccount() = default;
+
+  /// The MemoryAccount constructor.
+  /**
+     \param site      Name of the allocation site
+     \param use       Use of the memory
+     \param bytes     Size of the allocation
+     \param numa_node NUMA node of the memory (-1: unknown)
+  */
+  MemoryAccount(std::string site,
+                MemoryUse use,
+                std::size_t bytes,
+                int numa_node = -1);
+
+  MemoryAccount(const MemoryAccount&) = delete;
+  MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+  MemoryAccount(MemoryAccount&& other) noexcept;
+  MemoryAccount& operator=(MemoryAccount&& other) noexcept;
+
+  ~MemoryAccount();
+
+private:
+  void release();
+
+  std::string site_;
+  MemoryUse use_ = MemoryUse::Reserved;
+  std::size_t bytes_ = 0;
+  int numa_node_ = -1;
+};
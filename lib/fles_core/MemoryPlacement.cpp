@@ -0,0 +1,212 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MemoryPlacement.hpp"
+#include "System.hpp"
+#include "log.hpp"
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef HAVE_NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+
+void place_memory(void* addr,
+                  std::size_t size,
+                  const MemoryPlacement& placement) {
+  if (placement.hugepages && madvise(addr, size, MADV_HUGEPAGE) != 0) {
+    L_(warning) << "place_memory: madvise(MADV_HUGEPAGE) failed: "
+                << fles::system::stringerror(errno);
+  }
+  if (placement.numa_node >= 0) {
+#ifdef HAVE_NUMA
+    if (numa_available() == -1) {
+      L_(error) << "numa_available() failed";
+    } else {
+      // binds the shared memory object, also for consumer mappings
+      numa_tonode_memory(addr, size, placement.numa_node);
+    }
+#else
+    L_(warning) << "place_memory: built without libnuma, ignoring NUMA node "
+                << placement.numa_node;
+#endif
+  }
+  if (placement.prefault) {
+    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto* p = static_cast<volatile uint8_t*>(addr);
+    for (std::size_t offset = 0; offset < size; offset += page_size) {
+      p[offset] = 0;
+    }
+  }
+  if (placement.lock && mlock(addr, size) != 0) {
+    L_(warning) << "place_memory: mlock failed: "
+                << fles::system::stringerror(errno);
+  }
+}
+
+namespace {
+
+std::size_t round_up(std::size_t n, std::size_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+// Retrieve the flags value of a given (power of two) huge page size.
+int huge_page_flags(std::size_t page_size) {
+  if ((page_size & (page_size - 1)) != 0) {
+    throw std::invalid_argument("allocate_memory: invalid page size");
+  }
+  int shift = 0;
+  while ((std::size_t{1} << shift) < page_size) {
+    ++shift;
+  }
+  return shift << MAP_HUGE_SHIFT;
+}
+
+// Map private anonymous memory aligned by trimming a larger mapping.
+void* map_aligned(std::size_t size, std::size_t alignment, int prot) {
+  const std::size_t map_size = size + alignment;
+  void* addr = mmap(nullptr, map_size, prot,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("allocate_memory: mmap failed: " +
+                             fles::system::stringerror(errno));
+  }
+  auto begin = reinterpret_cast<std::uintptr_t>(addr);
+  auto aligned = round_up(begin, alignment);
+  if (aligned > begin) {
+    munmap(addr, aligned - begin);
+  }
+  auto end = begin + map_size;
+  if (end > aligned + size) {
+    munmap(reinterpret_cast<void*>(aligned + size), end - aligned - size);
+  }
+  return reinterpret_cast<void*>(aligned);
+}
+
+// Map a memory file twice back to back.
+MemoryRegion map_mirrored(std::size_t size,
+                          const MemoryPlacement& placement) {
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  // reserved pages are only used if the size is a multiple of their size
+  std::size_t reserved = placement.reserved_page_size;
+  if (reserved != 0 && size % reserved != 0) {
+    reserved = 0;
+  }
+  int fd = -1;
+  if (reserved != 0) {
+    fd = memfd_create("RingBuffer",
+                      MFD_CLOEXEC | MFD_HUGETLB | huge_page_flags(reserved));
+    if (fd == -1) {
+      int err = errno;
+      L_(warning) << "allocate_memory: no reserved pages of size " << reserved
+                  << " available: " << fles::system::stringerror(err);
+      reserved = 0;
+    }
+  }
+  if (fd == -1) {
+    if (size % page_size != 0) {
+      throw std::invalid_argument(
+          "allocate_memory: mirrored size must be a multiple of the page size");
+    }
+    fd = memfd_create("RingBuffer", MFD_CLOEXEC);
+  }
+  if (fd == -1 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    int err = errno;
+    if (fd != -1) {
+      close(fd);
+    }
+    throw std::runtime_error("allocate_memory: memory file: " +
+                             fles::system::stringerror(err));
+  }
+
+  const std::size_t alignment =
+      std::max(placement.hugepages ? huge_page_size : page_size, reserved);
+  auto* addr = static_cast<uint8_t*>(map_aligned(2 * size, alignment, 0));
+  bool mapped = true;
+  for (std::size_t offset : {std::size_t{0}, size}) {
+    mapped = mapped && mmap(addr + offset, size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+  }
+  int err = errno;
+  close(fd);
+  MemoryRegion region{addr, 2 * size};
+  if (!mapped) {
+    free_memory(region);
+    throw std::runtime_error("allocate_memory: mmap failed: " +
+                             fles::system::stringerror(err));
+  }
+  place_memory(addr, region.size, placement);
+  return region;
+}
+
+} // namespace
+
+MemoryRegion allocate_memory(std::size_t size,
+                             const MemoryPlacement& placement) {
+  MemoryRegion region;
+  if (size == 0) {
+    return region;
+  }
+  if (placement.mirrored) {
+    return map_mirrored(size, placement);
+  }
+
+  const std::size_t reserved = placement.reserved_page_size;
+  if (reserved != 0) {
+    region.size = round_up(size, reserved);
+    void* addr = mmap(nullptr, region.size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                          huge_page_flags(reserved),
+                      -1, 0);
+    if (addr != MAP_FAILED) {
+      region.addr = addr;
+      place_memory(region.addr, region.size, placement);
+      return region;
+    }
+    int err = errno;
+    L_(warning) << "allocate_memory: no reserved pages of size " << reserved
+                << " available: " << fles::system::stringerror(err);
+  }
+
+  // align to the transparent huge page size
+  const std::size_t alignment =
+      placement.hugepages ? huge_page_size
+                          : static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  region.size = round_up(size, alignment);
+  region.addr = map_aligned(region.size, alignment, PROT_READ | PROT_WRITE);
+  place_memory(region.addr, region.size, placement);
+  return region;
+}
+
+void free_memory(const MemoryRegion& region) {
+  if (region.addr != nullptr) {
+    munmap(region.addr, region.size);
+  }
+}
+
+int numa_node_of_memory(const void* addr) {
+#ifdef HAVE_NUMA
+  int node = -1;
+  if (numa_available() != -1 &&
+      get_mempolicy(&node, nullptr, 0, const_cast<void*>(addr),
+                    MPOL_F_NODE | MPOL_F_ADDR) == 0) {
+    return node;
+  }
+#else
+  (void)addr;
+#endif
+  return -1;
+}
+
+std::ptrdiff_t
+allocate_region(boost::interprocess::managed_shared_memory& managed_shm,
+                std::size_t size,
+                std::size_t alignment) {
+  auto handle = managed_shm.get_handle_from_address(
+      managed_shm.allocate(size + alignment));
+  auto a = static_cast<std::ptrdiff_t>(alignment);
+  return (handle + a - 1) / a * a;
+}
@@ -0,0 +1,72 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the MemoryPlacement struct and related functions.
+#pragma once
+
+#include <boost/interprocess/interprocess_fwd.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/// Placement options of large shared memory buffer regions.
+struct MemoryPlacement {
+  /// Request transparent huge pages for the regions
+  bool hugepages = false;
+  /// NUMA node to bind the regions to (-1: no binding)
+  int numa_node = -1;
+  /// Fault in all pages of the regions at startup
+  bool prefault = false;
+  /// Lock the regions in memory
+  bool lock = false;
+  /// Size of reserved (hugetlbfs) pages for private regions (0: none)
+  std::size_t reserved_page_size = 0;
+  /// Map private regions twice back to back (see allocate_memory())
+  bool mirrored = false;
+};
+
+/// Size of a transparent huge page.
+constexpr std::size_t huge_page_size = UINT64_C(1) << 21;
+
+/// Apply the placement options to a page-aligned region.
+void place_memory(void* addr,
+                  std::size_t size,
+                  const MemoryPlacement& placement);
+
+/// A private memory region (see allocate_memory()).
+struct MemoryRegion {
+  void* addr = nullptr;  ///< Start address of the region
+  std::size_t size = 0; ///< Size of the mapping (at least as requested)
+};
+
+/**
+ * \brief Allocate a private memory region with given placement options.
+ *
+ * The region is aligned to the page size used. If reserved pages are
+ * requested but not available, regular pages are used instead.
+ *
+ * A mirrored region consists of two consecutive mappings of the same
+ * memory, so that any range of up to \p size bytes starting in the first
+ * half is contiguous. Its size must be a multiple of the page size used.
+ *
+ * @return the allocated region, to be released with free_memory()
+ */
+MemoryRegion allocate_memory(std::size_t size,
+                             const MemoryPlacement& placement);
+
+/// Release a region allocated with allocate_memory().
+void free_memory(const MemoryRegion& region);
+
+/// Retrieve the NUMA node a page of memory is located on (-1: unknown).
+int numa_node_of_memory(const void* addr);
+
+/**
+ * \brief Allocate a region in a managed shared memory segment.
+ *
+ * The region is aligned relative to the start of the segment, i.e., within
+ * the shared memory object, where huge pages are located.
+ *
+ * @return the handle of the region
+ */
+std::ptrdiff_t
+allocate_region(boost::interprocess::managed_shared_memory& managed_shm,
+                std::size_t size,
+                std::size_t alignment);
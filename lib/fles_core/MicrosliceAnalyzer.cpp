@@ -2,10 +2,12 @@
 
 #include "MicrosliceAnalyzer.hpp"
 #include "PatternChecker.hpp"
+#include "SizeRecord.hpp"
 #include "TimesliceDebugger.hpp"
 #include "Utility.hpp"
 #include <cassert>
 #include <sstream>
+#include <stdexcept>
 
 MicrosliceAnalyzer::MicrosliceAnalyzer(uint64_t arg_output_interval,
                                        size_t arg_out_verbosity,
@@ -27,6 +29,14 @@ MicrosliceAnalyzer::~MicrosliceAnalyzer() {
   }
 }
 
+void MicrosliceAnalyzer::record_sizes(const std::string& path) {
+  size_record_ = std::make_unique<std::ofstream>(path, std::ios::trunc);
+  if (!*size_record_) {
+    throw std::runtime_error("cannot write size record: " + path);
+  }
+  *size_record_ << "# index size (component " << component_ << ")\n";
+}
+
 uint32_t MicrosliceAnalyzer::compute_crc(const fles::Microslice& ms) const {
   assert(crc32_engine_);
 
@@ -116,6 +126,10 @@ bool MicrosliceAnalyzer::check_microslice(const fles::Microslice& ms) {
     ++microslice_error_count_;
   }
 
+  descriptor_statistics_.add(ms.desc());
+  if (size_record_) {
+    SizeRecord::write(*size_record_, ms.desc().idx, ms.desc().size);
+  }
   ++microslice_count_;
   content_bytes_ += ms.desc().size;
   previous_start_ = ms.desc().idx;
@@ -143,5 +157,17 @@ void MicrosliceAnalyzer::put(std::shared_ptr<const fles::Microslice> ms) {
   }
   if ((microslice_count_ % output_interval_) == 0) {
     out_ << output_prefix_ << statistics() << std::endl;
+    if (out_verbosity_ >= 2) {
+      descriptor_statistics_.write(out_, output_prefix_);
+    }
+  }
+}
+
+void MicrosliceAnalyzer::end_stream() {
+  if (microslice_count_ > 0 && (microslice_count_ % output_interval_) != 0) {
+    out_ << output_prefix_ << statistics() << std::endl;
+    if (out_verbosity_ >= 2) {
+      descriptor_statistics_.write(out_, output_prefix_);
+    }
   }
 }
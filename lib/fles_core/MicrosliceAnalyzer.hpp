@@ -3,8 +3,10 @@
 
 #include "Microslice.hpp"
 #include "MicrosliceDescriptor.hpp"
+#include "MicrosliceStatistics.hpp"
 #include "Sink.hpp"
 #include "interface.h" // crcutil_interface
+#include <fstream>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -22,6 +24,21 @@ public:
 
   void put(std::shared_ptr<const fles::Microslice> ms) override;
 
+  void end_stream() override;
+
+  /// Per-equipment statistics of all analyzed microslice descriptors.
+  [[nodiscard]] const MicrosliceStatistics& descriptor_statistics() const {
+    return descriptor_statistics_;
+  }
+
+  /// Record the index and size of each analyzed microslice to a file.
+  /** The file is a SizeRecord time series that a pattern generator can
+      replay. */
+  void record_sizes(const std::string& path);
+
+  /// Retrieve the number of microslices that failed a check.
+  [[nodiscard]] size_t error_count() const { return microslice_error_count_; }
+
 private:
   bool check_microslice(const fles::Microslice& ms);
 
@@ -37,6 +54,8 @@ private:
 
   fles::MicrosliceDescriptor reference_descriptor_{};
   std::unique_ptr<PatternChecker> pattern_checker_;
+  MicrosliceStatistics descriptor_statistics_;
+  std::unique_ptr<std::ofstream> size_record_;
 
   uint64_t output_interval_ = UINT64_MAX;
   size_t out_verbosity_;
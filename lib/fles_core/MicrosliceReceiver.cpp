@@ -1,66 +1,344 @@
 // Copyright 2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "MicrosliceReceiver.hpp"
+#include "MicrosliceView.hpp"
+#include <algorithm>
+#include <cassert>
 #include <chrono>
-#include <thread>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
 
 namespace fles {
 
-MicrosliceReceiver::MicrosliceReceiver(InputBufferReadInterface& data_source)
+/// Release state of the microslices handed out by a MicrosliceReceiver.
+/** Microslices may be released in any order and in any thread. The
+    released position advances over the longest prefix of released
+    microslices. The tracker also provides the memory of the views
+    returned by get_view(), so that no heap allocation is needed per view.
+    It is owned jointly by the receiver and the views. */
+class MicrosliceReceiver::ReleaseTracker {
+public:
+  /// Allocator providing fixed-size blocks of the tracker's pool.
+  template <class U> struct Allocator {
+    using value_type = U;
+
+    explicit Allocator(std::shared_ptr<ReleaseTracker> t)
+        : tracker(std::move(t)) {}
+    template <class V>
+    Allocator(const Allocator<V>& other) // NOLINT
+        : tracker(other.tracker) {}
+
+    U* allocate(size_t n) {
+      return static_cast<U*>(tracker->allocate(n * sizeof(U)));
+    }
+    void deallocate(U* p, size_t /* n */) { tracker->deallocate(p); }
+
+    template <class V> bool operator==(const Allocator<V>& other) const {
+      return tracker == other.tracker;
+    }
+    template <class V> bool operator!=(const Allocator<V>& other) const {
+      return tracker != other.tracker;
+    }
+
+    std::shared_ptr<ReleaseTracker> tracker;
+  };
+
+  /// View into the data source buffer, released on destruction.
+  class View : public MicrosliceView {
+  public:
+    View(MicrosliceDescriptor& d,
+         uint8_t* content,
+         ReleaseTracker& tracker,
+         uint64_t desc_index)
+        : MicrosliceView(d, content), tracker_(tracker),
+          desc_index_(desc_index) {}
+
+    View(const View&) = delete;
+    void operator=(const View&) = delete;
+
+    ~View() override { tracker_.release(desc_index_); }
+
+  private:
+    // kept alive by the allocator of the owning control block
+    ReleaseTracker& tracker_;
+    uint64_t desc_index_;
+  };
+
+  ReleaseTracker(DualIndex start, size_t capacity)
+      : released_(start), handed_out_(start.desc), data_end_(capacity),
+        done_(capacity) {
+    free_.reserve(capacity);
+  }
+
+  /// Wait until the microslice with the given index may be handed out.
+  /** If \p view is set, a pool block for a view must be available, too.
+      \return whether the microslice may be handed out */
+  bool wait_for_slot(uint64_t desc_index,
+                     std::chrono::milliseconds timeout,
+                     bool view) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, timeout, [&] {
+      return desc_index - released_.desc < done_.size() &&
+             (!view || block_size_ == 0 || !free_.empty());
+    });
+  }
+
+  /// Record a microslice as handed out.
+  void hand_out(uint64_t desc_index, uint64_t data_end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(desc_index == handed_out_);
+    assert(desc_index - released_.desc < done_.size());
+    size_t slot = desc_index % done_.size();
+    data_end_[slot] = data_end;
+    done_[slot] = false;
+    handed_out_ = desc_index + 1;
+  }
+
+  /// Record a microslice as released.
+  void release(uint64_t desc_index) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_[desc_index % done_.size()] = true;
+      while (released_.desc < handed_out_ &&
+             done_[released_.desc % done_.size()]) {
+        released_.data = data_end_[released_.desc % done_.size()];
+        ++released_.desc;
+      }
+    }
+    cond_.notify_all();
+  }
+
+  /// Continue after skipped microslices (none may be outstanding).
+  void skip_to(uint64_t desc_index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(released_.desc == handed_out_);
+    released_.desc = desc_index;
+    handed_out_ = desc_index;
+  }
+
+  /// Position up to which all microslices have been released.
+  [[nodiscard]] DualIndex released() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return released_;
+  }
+
+private:
+  void* allocate(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (block_size_ == 0) {
+      // block size is that of the first (and only) allocated type
+      constexpr size_t align = alignof(std::max_align_t);
+      block_size_ = (bytes + align - 1) / align;
+      arena_.resize(block_size_ * done_.size());
+      for (size_t i = done_.size(); i > 0; --i) {
+        free_.push_back(&arena_[(i - 1) * block_size_]);
+      }
+    }
+    if (bytes > block_size_ * sizeof(std::max_align_t) || free_.empty()) {
+      throw std::bad_alloc();
+    }
+    void* p = free_.back();
+    free_.pop_back();
+    return p;
+  }
+
+  void deallocate(void* p) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(p);
+    }
+    cond_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+  DualIndex released_;
+  uint64_t handed_out_;
+  /// Data end offset and release state per handed-out microslice.
+  std::vector<uint64_t> data_end_;
+  std::vector<bool> done_;
+
+  /// Pool of view memory blocks (in units of std::max_align_t).
+  size_t block_size_ = 0;
+  std::vector<std::max_align_t> arena_;
+  std::vector<void*> free_;
+};
+
+MicrosliceReceiver::MicrosliceReceiver(InputBufferReadInterface& data_source,
+                                       size_t max_views)
     : data_source_(data_source),
       write_index_desc_(data_source_.get_write_index().desc),
-      read_index_desc_(data_source_.get_read_index().desc) {}
+      read_index_desc_(data_source_.get_read_index().desc),
+      tracker_(std::make_shared<ReleaseTracker>(
+          data_source_.get_read_index(), std::max<size_t>(max_views, 1))),
+      applied_read_index_desc_(read_index_desc_) {}
+
+StorableMicroslice*
+MicrosliceReceiver::copy_microslice(const MicrosliceDescriptor& desc) const {
+  const uint8_t* data_begin = &data_source_.data_buffer().at(desc.offset);
+
+  const uint8_t* data_end =
+      &data_source_.data_buffer().at(desc.offset + desc.size);
+
+  if (data_begin <= data_end || data_source_.data_buffer().mirrored()) {
+    return new StorableMicroslice(desc, data_begin); // NOLINT
+  }
+
+  const uint8_t* buffer_begin = data_source_.data_buffer().ptr();
+
+  const uint8_t* buffer_end = buffer_begin + data_source_.data_buffer().bytes();
+
+  // copy two segments to vector
+  MicrosliceStoragePool* pool = MicrosliceStoragePool::local();
+  std::vector<uint8_t> data;
+  if (pool != nullptr) {
+    data = pool->acquire(desc.size);
+  } else {
+    data.reserve(desc.size);
+  }
+  data.assign(data_begin, buffer_end);
+  data.insert(data.end(), buffer_begin, data_end);
+  assert(data.size() == desc.size);
+
+  return new StorableMicroslice(desc, data); // NOLINT
+}
+
+void MicrosliceReceiver::update_write_index() {
+  write_index_desc_ = data_source_.get_write_index().desc;
+  // the descriptors have just been written by the DMA engine (or another
+  // core), so fetch the first of them while the current one is processed
+  data_source_.desc_buffer().prefetch(
+      read_index_desc_,
+      std::min<uint64_t>(write_index_desc_ - read_index_desc_,
+                         prefetch_descriptors));
+}
 
 StorableMicroslice* MicrosliceReceiver::try_get() {
   // update write_index if needed
   if (write_index_desc_ <= read_index_desc_) {
-    write_index_desc_ = data_source_.get_write_index().desc;
+    update_write_index();
+  }
+  if (data_source_.may_be_overtaken()) {
+    skip_overwritten();
   }
   if (write_index_desc_ > read_index_desc_) {
+    // the buffer space may still be held by views
+    if (!tracker_->wait_for_slot(read_index_desc_,
+                                 std::chrono::milliseconds(0), false)) {
+      return nullptr;
+    }
 
     const MicrosliceDescriptor& desc =
         data_source_.desc_buffer().at(read_index_desc_);
 
-    const uint8_t* data_begin = &data_source_.data_buffer().at(desc.offset);
-
     const uint64_t offset_end = desc.offset + desc.size;
 
-    const uint8_t* data_end = &data_source_.data_buffer().at(offset_end);
-
-    StorableMicroslice* sms;
-
-    if (data_begin <= data_end) {
-      // NOLINTNEXTLINE
-      sms = new StorableMicroslice(
-          const_cast<const fles::MicrosliceDescriptor&>(desc),
-          const_cast<const uint8_t*>(data_begin));
-    } else {
-      const uint8_t* buffer_begin = data_source_.data_buffer().ptr();
-
-      const uint8_t* buffer_end =
-          buffer_begin + data_source_.data_buffer().bytes();
+    StorableMicroslice* sms = copy_microslice(desc);
 
-      // copy two segments to vector
-      std::vector<uint8_t> data;
-      data.reserve(desc.size);
-      data.assign(data_begin, buffer_end);
-      data.insert(data.end(), buffer_begin, data_end);
-      assert(data.size() == desc.size);
-
-      // NOLINTNEXTLINE
-      sms = new StorableMicroslice(
-          const_cast<const fles::MicrosliceDescriptor&>(desc), data);
+    // discard the copy if the item has been overwritten while reading
+    if (data_source_.may_be_overtaken() && skip_overwritten()) {
+      delete sms; // NOLINT
+      return nullptr;
     }
 
+    tracker_->hand_out(read_index_desc_, offset_end);
+    tracker_->release(read_index_desc_);
     ++read_index_desc_;
 
-    data_source_.set_read_index({read_index_desc_, offset_end});
+    update_read_index();
 
     return sms;
   }
   return nullptr;
 }
 
+std::shared_ptr<const Microslice> MicrosliceReceiver::try_get_view() {
+  if (data_source_.may_be_overtaken()) {
+    // content may be overwritten at any time, so always copy
+    return std::shared_ptr<const Microslice>(try_get());
+  }
+
+  // update write_index if needed
+  if (write_index_desc_ <= read_index_desc_) {
+    update_write_index();
+  }
+  if (write_index_desc_ <= read_index_desc_) {
+    return nullptr;
+  }
+
+  MicrosliceDescriptor& desc = data_source_.desc_buffer().at(read_index_desc_);
+
+  uint8_t* data_begin = &data_source_.data_buffer().at(desc.offset);
+
+  const uint64_t offset_end = desc.offset + desc.size;
+
+  const uint8_t* data_end = &data_source_.data_buffer().at(offset_end);
+
+  if (data_begin > data_end && !data_source_.data_buffer().mirrored()) {
+    // wrapping content is copied
+    return std::shared_ptr<const Microslice>(try_get());
+  }
+
+  if (!tracker_->wait_for_slot(read_index_desc_, std::chrono::milliseconds(0),
+                               true)) {
+    return nullptr;
+  }
+
+  tracker_->hand_out(read_index_desc_, offset_end);
+  auto view = std::allocate_shared<ReleaseTracker::View>(
+      ReleaseTracker::Allocator<ReleaseTracker::View>(tracker_), desc,
+      data_begin, *tracker_, read_index_desc_);
+  ++read_index_desc_;
+
+  update_read_index();
+
+  return view;
+}
+
+void MicrosliceReceiver::update_read_index() {
+  DualIndex released = tracker_->released();
+  if (released.desc != applied_read_index_desc_) {
+    data_source_.set_read_index(released);
+    applied_read_index_desc_ = released.desc;
+  }
+}
+
+bool MicrosliceReceiver::skip_overwritten() {
+  const uint64_t valid_desc = data_source_.get_read_index().desc;
+  if (read_index_desc_ >= valid_desc) {
+    return false;
+  }
+  skipped_ += valid_desc - read_index_desc_;
+  read_index_desc_ = valid_desc;
+  if (write_index_desc_ < read_index_desc_) {
+    write_index_desc_ = read_index_desc_;
+  }
+  tracker_->skip_to(read_index_desc_);
+  applied_read_index_desc_ = read_index_desc_;
+  return true;
+}
+
+bool MicrosliceReceiver::wait_for_data() {
+  // views may have been released in other threads
+  update_read_index();
+  if (data_source_.get_eof() &&
+      read_index_desc_ == data_source_.get_write_index().desc) {
+    eos_ = true;
+    return false;
+  }
+  constexpr auto timeout = std::chrono::milliseconds(10);
+  if (write_index_desc_ > read_index_desc_) {
+    tracker_->wait_for_slot(read_index_desc_, timeout, true);
+  } else {
+    data_source_.wait_write_index(read_index_desc_, timeout);
+  }
+  return true;
+}
+
 StorableMicroslice* MicrosliceReceiver::do_get() {
   if (eos_) {
     return nullptr;
@@ -71,16 +349,29 @@ StorableMicroslice* MicrosliceReceiver::do_get() {
   while (sms == nullptr) {
     data_source_.proceed();
     sms = try_get();
-    if (sms == nullptr) {
-      if (data_source_.get_eof() &&
-          read_index_desc_ == data_source_.get_write_index().desc) {
-        eos_ = true;
-        return nullptr;
-      }
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (sms == nullptr && !wait_for_data()) {
+      return nullptr;
     }
   }
 
   return sms;
 }
+
+std::shared_ptr<const Microslice> MicrosliceReceiver::get_view() {
+  if (eos_) {
+    return nullptr;
+  }
+
+  // wait until a microslice is available in the input buffer
+  std::shared_ptr<const Microslice> ms;
+  while (!ms) {
+    data_source_.proceed();
+    ms = try_get_view();
+    if (!ms && !wait_for_data()) {
+      return nullptr;
+    }
+  }
+
+  return ms;
+}
 } // namespace fles
@@ -7,6 +7,7 @@
 #include "MicrosliceSource.hpp"
 #include "RingBuffer.hpp"
 #include "StorableMicroslice.hpp"
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -19,7 +20,10 @@ namespace fles {
 class MicrosliceReceiver : public MicrosliceSource {
 public:
   /// Construct Microslice receiver connected to a given data source.
-  explicit MicrosliceReceiver(InputBufferReadInterface& data_source);
+  /** At most max_views microslices returned by get_view() can be held at
+      a time. */
+  explicit MicrosliceReceiver(InputBufferReadInterface& data_source,
+                              size_t max_views = 1024);
 
   /// Delete copy constructor (non-copyable).
   MicrosliceReceiver(const MicrosliceReceiver&) = delete;
@@ -39,19 +43,68 @@ public:
     return std::unique_ptr<StorableMicroslice>(do_get());
   };
 
+  /**
+   * \brief Retrieve the next item without copying its content if possible.
+   *
+   * Microslices which do not wrap around the end of the data buffer are
+   * returned as views into the buffer of the data source. The buffer space
+   * of a microslice is released to the data source once its view and the
+   * views of all microslices before it have been destroyed. This function
+   * blocks while max_views views are held. Wrapping microslices and those
+   * of data sources that may overtake the receiver are copied. The views
+   * may be destroyed in any thread, but must not outlive the data source.
+   *
+   * \return pointer to the item, or nullptr if end-of-file
+   */
+  std::shared_ptr<const Microslice> get_view();
+
   [[nodiscard]] bool eos() const override { return eos_; }
 
+  /// Retrieve the number of microslices skipped because the data source
+  /// has overtaken this receiver.
+  [[nodiscard]] uint64_t skipped() const { return skipped_; }
+
 private:
+  class ReleaseTracker;
+
   StorableMicroslice* do_get() override;
 
   StorableMicroslice* try_get();
 
+  /// Retrieve the next microslice, as a view if possible (see get_view()).
+  std::shared_ptr<const Microslice> try_get_view();
+
+  /// Wait for a microslice or end-of-stream, return false at end-of-stream.
+  bool wait_for_data();
+
+  /// Copy the microslice at the read index, including wrapping content.
+  StorableMicroslice* copy_microslice(const MicrosliceDescriptor& desc) const;
+
+  /// Fetch the write index, prefetching the new descriptors.
+  void update_write_index();
+
+  /// Propagate the released buffer space to the data source.
+  void update_read_index();
+
+  /// Number of new descriptors prefetched at a write index update.
+  static constexpr uint64_t prefetch_descriptors = 64;
+
+  /// Skip items overwritten by the data source (see
+  /// InputBufferReadInterface::may_be_overtaken()), return whether any.
+  bool skip_overwritten();
+
   /// Data source (e.g., FLIB).
   InputBufferReadInterface& data_source_;
 
   uint64_t write_index_desc_;
   uint64_t read_index_desc_;
 
+  uint64_t skipped_ = 0;
+
+  /// Order of release of the microslices handed out.
+  std::shared_ptr<ReleaseTracker> tracker_;
+  uint64_t applied_read_index_desc_;
+
   bool eos_ = false;
 };
 } // namespace fles
@@ -0,0 +1,114 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MicrosliceReplay.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+MicrosliceReplay::MicrosliceReplay(fles::MicrosliceSource& source,
+                                   uint64_t max_number) {
+  while (desc_.size() < max_number) {
+    auto ms = source.get();
+    if (!ms) {
+      break;
+    }
+    fles::MicrosliceDescriptor desc = ms->desc();
+    desc.offset = content_.size();
+    content_.insert(content_.end(), ms->content(),
+                    ms->content() + desc.size);
+    desc_.push_back(desc);
+  }
+}
+
+uint64_t MicrosliceReplay::first_index() const {
+  return desc_.empty() ? 0 : desc_.front().idx;
+}
+
+uint64_t MicrosliceReplay::period() const {
+  if (desc_.size() < 2) {
+    return 1;
+  }
+  uint64_t span = desc_.back().idx - desc_.front().idx;
+  return span + span / (desc_.size() - 1);
+}
+
+uint64_t MicrosliceReplay::play(InputBufferWriteInterface& sink,
+                                const Playback& playback,
+                                const std::atomic<bool>& stop) {
+  if (desc_.empty()) {
+    return 0;
+  }
+  RingBufferView<uint8_t>& data = sink.data_buffer();
+  const DualIndex buffer_size = {sink.desc_buffer().size(), data.size()};
+  for (const auto& desc : desc_) {
+    if (desc.size > buffer_size.data) {
+      throw std::runtime_error("microslice exceeds replay data buffer");
+    }
+  }
+
+  DualIndex write_index = {0, 0};
+  DualIndex read_index_cached = sink.get_read_index();
+  uint64_t published = 0;
+  auto publish = [&]() {
+    if (write_index.desc != published) {
+      sink.set_write_index(write_index);
+      published = write_index.desc;
+    }
+  };
+
+  uint64_t count = 0;
+  for (uint64_t pass = 0; playback.passes == 0 || pass < playback.passes;
+       ++pass) {
+    const uint64_t shift = pass * playback.period;
+    for (const auto& recorded : desc_) {
+      if (stop) {
+        publish();
+        return count;
+      }
+      fles::MicrosliceDescriptor desc = recorded;
+      desc.idx += shift;
+
+      if (playback.speed > 0 && desc.idx > playback.origin) {
+        auto due = playback.start +
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::duration<double, std::nano>(
+                           static_cast<double>(desc.idx - playback.origin) /
+                           playback.speed));
+        if (std::chrono::steady_clock::now() < due) {
+          publish();
+          std::this_thread::sleep_until(due);
+        }
+      }
+
+      const DualIndex item_size = {1, desc.size};
+      while (!(buffer_size - write_index + read_index_cached >= item_size)) {
+        publish();
+        read_index_cached = sink.get_read_index();
+        if (!(buffer_size - write_index + read_index_cached >= item_size)) {
+          if (stop) {
+            return count;
+          }
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+      }
+
+      // copy the content in up to two segments
+      const uint8_t* content = content_.data() + recorded.offset;
+      uint64_t pos = write_index.data & data.size_mask();
+      uint64_t part1 = std::min<uint64_t>(desc.size, data.bytes() - pos);
+      std::memcpy(&data.at(pos), content, part1);
+      std::memcpy(data.ptr(), content + part1, desc.size - part1);
+
+      desc.offset = write_index.data;
+      sink.desc_buffer().at(write_index.desc) = desc;
+      write_index += item_size;
+      ++count;
+      if (write_index.desc - published >= publish_interval) {
+        publish();
+      }
+    }
+  }
+  publish();
+  return count;
+}
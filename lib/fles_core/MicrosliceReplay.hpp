@@ -0,0 +1,68 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "MicrosliceSource.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Microslice recording to be played back into an input buffer.
+/** A MicrosliceReplay object holds the microslices of a source (e.g., a
+    microslice archive) in memory, packed as an array of descriptors and
+    the concatenated contents. Playing it back fills a data sink (e.g., a
+    channel of a shared memory device) with plain copies, so the rate is
+    not limited by decoding the source. The recording is paced by its
+    microslice indexes (in ns) at the original or a scaled speed, or
+    played as fast as the sink accepts it. Further passes continue the
+    microslice indexes by the period of the recording. */
+class MicrosliceReplay {
+public:
+  /// Playback parameters, to be shared by the channels of a device.
+  struct Playback {
+    /// Factor of the original speed (0: as fast as possible)
+    double speed = 0;
+    /// Number of passes (0: until stopped)
+    uint64_t passes = 1;
+    /// Microslice index played at the start time
+    uint64_t origin = 0;
+    /// Offset of the microslice indexes of subsequent passes
+    uint64_t period = 0;
+    /// Start time of the playback
+    std::chrono::steady_clock::time_point start;
+  };
+
+  /// Read up to a maximum number of microslices from a source.
+  explicit MicrosliceReplay(fles::MicrosliceSource& source,
+                            uint64_t max_number = UINT64_MAX);
+
+  /// Retrieve the number of recorded microslices.
+  [[nodiscard]] std::size_t size() const { return desc_.size(); }
+
+  /// Retrieve the total content size of the recording.
+  [[nodiscard]] std::size_t bytes() const { return content_.size(); }
+
+  /// Retrieve the index of the first microslice (0 if empty).
+  [[nodiscard]] uint64_t first_index() const;
+
+  /// Retrieve the index range covered by one pass, including the average
+  /// index step to the first microslice of the next pass.
+  [[nodiscard]] uint64_t period() const;
+
+  /// Write the recording to a data sink.
+  /** Blocks while the sink is full. Returns the number of microslices
+      written, which is less than requested if stopped. */
+  uint64_t play(InputBufferWriteInterface& sink,
+                const Playback& playback,
+                const std::atomic<bool>& stop);
+
+  /// Number of microslices written before the sink is updated.
+  static constexpr std::size_t publish_interval = 64;
+
+private:
+  std::vector<fles::MicrosliceDescriptor> desc_;
+  std::vector<uint8_t> content_;
+};
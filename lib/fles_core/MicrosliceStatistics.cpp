@@ -0,0 +1,167 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MicrosliceStatistics.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <ios>
+
+double MicrosliceStatistics::Stream::rate() const {
+  if (count < 2 || last_idx <= first_idx) {
+    return 0;
+  }
+  return static_cast<double>(count - 1) * 1e9 /
+         static_cast<double>(last_idx - first_idx);
+}
+
+double MicrosliceStatistics::Stream::data_rate() const {
+  if (count < 2) {
+    return 0;
+  }
+  // content of the last microslice is not within the measured interval
+  return static_cast<double>(bytes) * rate() / static_cast<double>(count);
+}
+
+uint64_t
+MicrosliceStatistics::Stream::flag_count(fles::MicrosliceFlags flag) const {
+  auto f = static_cast<uint16_t>(flag);
+  return f == 0 ? 0 : flags.at(__builtin_ctz(f));
+}
+
+MicrosliceStatistics::MicrosliceStatistics(size_t max_streams)
+    : max_streams_(max_streams) {
+  streams_.reserve(max_streams_);
+  stream_index_.reserve(max_streams_);
+}
+
+void MicrosliceStatistics::reset() {
+  streams_.clear();
+  stream_index_.clear();
+  untracked_ = 0;
+}
+
+MicrosliceStatistics::Stream*
+MicrosliceStatistics::find_stream(const fles::MicrosliceDescriptor& desc) {
+  auto it = stream_index_.find(key(desc));
+  if (it != stream_index_.end()) {
+    return &streams_[it->second];
+  }
+  if (streams_.size() == max_streams_) {
+    return nullptr;
+  }
+  stream_index_.emplace(key(desc), streams_.size());
+  Stream& s = streams_.emplace_back();
+  s.eq_id = desc.eq_id;
+  s.sys_id = desc.sys_id;
+  s.sys_ver = desc.sys_ver;
+  return &s;
+}
+
+void MicrosliceStatistics::add(const fles::MicrosliceDescriptor* desc,
+                               size_t count) {
+  size_t begin = 0;
+  while (begin < count) {
+    // run of consecutive descriptors of the same equipment
+    const uint32_t k = key(desc[begin]);
+    size_t end = begin + 1;
+    while (end < count && key(desc[end]) == k) {
+      ++end;
+    }
+    Stream* s = find_stream(desc[begin]);
+    if (s != nullptr) {
+      add_run(*s, desc + begin, end - begin);
+    } else {
+      untracked_ += end - begin;
+    }
+    begin = end;
+  }
+}
+
+void MicrosliceStatistics::add_run(Stream& s,
+                                   const fles::MicrosliceDescriptor* desc,
+                                   size_t count) {
+  // sizes and flags: simple reductions without dependencies on the order
+  uint64_t bytes = 0;
+  uint32_t min_size = s.min_size;
+  uint32_t max_size = s.max_size;
+  uint16_t any_flags = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t size = desc[i].size;
+    bytes += size;
+    min_size = std::min(min_size, size);
+    max_size = std::max(max_size, size);
+    any_flags |= desc[i].flags;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t size = desc[i].size;
+    ++s.size_histogram[size == 0 ? 0 : 32 - __builtin_clz(size)];
+  }
+  if (any_flags != 0) {
+    for (size_t i = 0; i < count; ++i) {
+      const unsigned f = desc[i].flags;
+      for (size_t b = 0; b < flag_bits; ++b) {
+        s.flags[b] += (f >> b) & 1u;
+      }
+    }
+  }
+  s.bytes += bytes;
+  s.min_size = min_size;
+  s.max_size = max_size;
+
+  // index sequence: gaps against the reference difference, and disorder
+  size_t i = 0;
+  if (s.count == 0) {
+    s.first_idx = desc[0].idx;
+    s.last_idx = desc[0].idx;
+    i = 1;
+  }
+  uint64_t prev = s.last_idx;
+  for (; i < count && s.delta_t == 0; ++i) {
+    const uint64_t idx = desc[i].idx;
+    if (idx <= prev) {
+      ++s.disorder;
+    } else {
+      s.delta_t = idx - prev;
+    }
+    prev = idx;
+  }
+  uint64_t gaps = 0;
+  uint64_t disorder = 0;
+  for (; i < count; ++i) {
+    const uint64_t idx = desc[i].idx;
+    disorder += static_cast<uint64_t>(idx <= prev);
+    gaps += static_cast<uint64_t>(idx > prev && idx - prev != s.delta_t);
+    prev = idx;
+  }
+  s.gaps += gaps;
+  s.disorder += disorder;
+  s.last_idx = prev;
+  s.count += count;
+}
+
+void MicrosliceStatistics::write(std::ostream& out,
+                                 const std::string& prefix) const {
+  for (const auto& s : streams_) {
+    std::ios_base::fmtflags f(out.flags());
+    out << prefix << "eq_id=" << std::hex << std::showbase << s.eq_id
+        << " sys_id=" << static_cast<uint32_t>(s.sys_id)
+        << " sys_ver=" << static_cast<uint32_t>(s.sys_ver);
+    out.flags(f);
+    out << ": " << s.count << " microslices ("
+        << human_readable_count(s.bytes, true) << "), "
+        << human_readable_count(static_cast<uint64_t>(s.rate()), true, "Hz")
+        << ", "
+        << human_readable_count(static_cast<uint64_t>(s.data_rate()), true,
+                                "B/s")
+        << ", size " << (s.count > 0 ? s.min_size : 0) << ".." << s.max_size
+        << ", gaps " << s.gaps << ", disorder " << s.disorder << ", flags "
+        << s.flag_count(fles::MicrosliceFlags::CrcValid) << " crc/"
+        << s.flag_count(fles::MicrosliceFlags::OverflowFlim) << " flim/"
+        << s.flag_count(fles::MicrosliceFlags::OverflowUser) << " user/"
+        << s.flag_count(fles::MicrosliceFlags::DataError) << " error/"
+        << s.flag_count(fles::MicrosliceFlags::CrcError) << " bad crc"
+        << std::endl;
+  }
+  if (untracked_ > 0) {
+    out << prefix << "untracked microslices: " << untracked_ << std::endl;
+  }
+}
@@ -0,0 +1,90 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Streaming statistics of microslice descriptors per equipment.
+/** Descriptors are accumulated separately for each (eq_id, sys_id) pair in
+    fixed memory, without accessing the microslice content. Consecutive
+    descriptors of the same equipment are processed as a run, so contiguous
+    descriptor arrays of a single channel are handled in tight loops. At
+    most max_streams equipments are tracked; descriptors of further
+    equipments are only counted as untracked. */
+class MicrosliceStatistics {
+public:
+  /// Number of size histogram bins (bin n: sizes in [2^(n-1), 2^n)).
+  static constexpr size_t size_bins = 33;
+
+  /// Number of counted descriptor flag bits.
+  static constexpr size_t flag_bits = 16;
+
+  /// Accumulated statistics of a single equipment.
+  struct Stream {
+    uint16_t eq_id = 0;
+    uint8_t sys_id = 0;
+    uint8_t sys_ver = 0;
+    uint64_t count = 0;    ///< number of microslices
+    uint64_t bytes = 0;    ///< total content size
+    uint32_t min_size = UINT32_MAX;
+    uint32_t max_size = 0;
+    uint64_t first_idx = 0; ///< index of the first microslice
+    uint64_t last_idx = 0;  ///< index of the most recent microslice
+    uint64_t delta_t = 0;   ///< reference index difference (first pair)
+    uint64_t gaps = 0;      ///< index differences deviating from delta_t
+    uint64_t disorder = 0;  ///< indices not larger than their predecessor
+    std::array<uint64_t, flag_bits> flags{};        ///< count per flag bit
+    std::array<uint64_t, size_bins> size_histogram{}; ///< log2 size bins
+
+    /// Rate of microslices per second of index time (index in ns).
+    [[nodiscard]] double rate() const;
+    /// Rate of content bytes per second of index time (index in ns).
+    [[nodiscard]] double data_rate() const;
+    /// Number of microslices with the given flag set.
+    [[nodiscard]] uint64_t flag_count(fles::MicrosliceFlags flag) const;
+  };
+
+  explicit MicrosliceStatistics(size_t max_streams = 1024);
+
+  /// Accumulate an array of descriptors.
+  void add(const fles::MicrosliceDescriptor* desc, size_t count);
+
+  /// Accumulate a single descriptor.
+  void add(const fles::MicrosliceDescriptor& desc) { add(&desc, 1); }
+
+  /// Discard all accumulated statistics.
+  void reset();
+
+  /// Statistics of all tracked equipments, in order of appearance.
+  [[nodiscard]] const std::vector<Stream>& streams() const {
+    return streams_;
+  }
+
+  /// Number of descriptors of equipments beyond max_streams.
+  [[nodiscard]] uint64_t untracked() const { return untracked_; }
+
+  /// Write a one-line summary per equipment.
+  void write(std::ostream& out, const std::string& prefix = "") const;
+
+private:
+  static uint32_t key(const fles::MicrosliceDescriptor& desc) {
+    return (static_cast<uint32_t>(desc.sys_id) << 16) | desc.eq_id;
+  }
+
+  Stream* find_stream(const fles::MicrosliceDescriptor& desc);
+
+  static void add_run(Stream& s,
+                      const fles::MicrosliceDescriptor* desc,
+                      size_t count);
+
+  size_t max_streams_;
+  std::vector<Stream> streams_;
+  std::unordered_map<uint32_t, size_t> stream_index_;
+  uint64_t untracked_ = 0;
+};
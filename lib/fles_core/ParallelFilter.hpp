@@ -0,0 +1,191 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ParallelFilter template class.
+#pragma once
+
+#include "Filter.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The ParallelFilter class applies a per-item transformation on a pool
+ * of worker threads.
+ *
+ * Items are processed concurrently, but passed on in input order. At most
+ * max_pending items are in flight; exchanging a further item waits for the
+ * oldest one. Exchanging without an item (at end-of-stream) waits for the
+ * next outstanding item. The transformation may return nullptr to drop an
+ * item. It is called concurrently and must be thread-safe. An exception
+ * thrown by the transformation is rethrown when the item is due.
+ */
+template <class Input, class Output = Input>
+class ParallelFilter : public Filter<Input, Output> {
+public:
+  using filter_output_t = typename Filter<Input, Output>::filter_output_t;
+  using transform_t =
+      std::function<std::unique_ptr<Output>(std::shared_ptr<const Input>)>;
+
+  /**
+   * \brief Construct and start the worker threads.
+   *
+   * \param transform   the per-item transformation
+   * \param num_threads number of worker threads (0: one per core)
+   * \param max_pending maximum number of items in flight (0: two per thread)
+   */
+  explicit ParallelFilter(transform_t transform,
+                          size_t num_threads = 0,
+                          size_t max_pending = 0)
+      : transform_(std::move(transform)) {
+    if (!transform_) {
+      throw std::invalid_argument("ParallelFilter: no transform given");
+    }
+    if (num_threads == 0) {
+      num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    max_pending_ = max_pending > 0 ? max_pending : 2 * num_threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+      workers_.emplace_back([this] { work(); });
+    }
+  }
+
+  /// Delete copy constructor (non-copyable).
+  ParallelFilter(const ParallelFilter&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ParallelFilter&) = delete;
+
+  /// Stop the worker threads, discarding outstanding items.
+  ~ParallelFilter() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    work_cond_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  filter_output_t
+  exchange_item(std::shared_ptr<const Input> item = nullptr) override {
+    const bool flush = !item;
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::unique_ptr<Output> output = take_done();
+    if (!flush) {
+      // the window is only full if no output has been taken above
+      while (results_.size() >= max_pending_) {
+        done_cond_.wait(lock, [this] { return results_.front().done; });
+        output = take_done();
+      }
+      results_.emplace_back();
+      tasks_.push_back({next_index_++, std::move(item)});
+      work_cond_.notify_one();
+    } else {
+      while (!output && !results_.empty()) {
+        done_cond_.wait(lock, [this] { return results_.front().done; });
+        output = take_done();
+      }
+    }
+    bool more = flush ? !results_.empty()
+                      : !results_.empty() && results_.front().done &&
+                            (results_.front().output || results_.front().error);
+    return std::make_pair(std::move(output), more);
+  }
+
+  /// Retrieve the number of worker threads.
+  [[nodiscard]] size_t num_threads() const { return workers_.size(); }
+
+private:
+  struct Task {
+    uint64_t index;
+    std::shared_ptr<const Input> item;
+  };
+
+  struct Result {
+    bool done = false;
+    std::unique_ptr<Output> output;
+    std::exception_ptr error;
+  };
+
+  /// Remove the leading completed items up to the first with output.
+  std::unique_ptr<Output> take_done() {
+    while (!results_.empty() && results_.front().done) {
+      Result result = std::move(results_.front());
+      results_.pop_front();
+      ++first_index_;
+      if (result.error) {
+        std::rethrow_exception(result.error);
+      }
+      if (result.output) {
+        return std::move(result.output);
+      }
+    }
+    return nullptr;
+  }
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_cond_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+      if (stopped_) {
+        return;
+      }
+      Task task = std::move(tasks_.front());
+      tasks_.pop_front();
+
+      lock.unlock();
+      Result result;
+      try {
+        result.output = transform_(std::move(task.item));
+      } catch (...) {
+        result.error = std::current_exception();
+      }
+      result.done = true;
+      lock.lock();
+
+      // an item is only removed from the results once it is done
+      results_[task.index - first_index_] = std::move(result);
+      if (task.index == first_index_) {
+        done_cond_.notify_one();
+      }
+    }
+  }
+
+  transform_t transform_;
+  size_t max_pending_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable work_cond_;
+  std::condition_variable done_cond_;
+  bool stopped_ = false;
+
+  /// Items waiting for a worker thread.
+  std::deque<Task> tasks_;
+  /// Results of the items in flight, starting at first_index_.
+  std::deque<Result> results_;
+  uint64_t first_index_ = 0;
+  uint64_t next_index_ = 0;
+
+  std::vector<std::thread> workers_;
+};
+
+class Microslice;
+class StorableMicroslice;
+class Timeslice;
+class StorableTimeslice;
+using ParallelMicrosliceFilter = ParallelFilter<Microslice, StorableMicroslice>;
+using ParallelTimesliceFilter = ParallelFilter<Timeslice, StorableTimeslice>;
+
+} // namespace fles
@@ -11,8 +11,26 @@ public:
   virtual bool check(const fles::Microslice& m) = 0;
   virtual void reset(){};
 
+  /// Number of content errors found by the last check.
+  [[nodiscard]] size_t error_count() const { return error_count_; }
+
+  /// Byte offset of the first content error found by the last check.
+  [[nodiscard]] size_t first_error_offset() const {
+    return first_error_offset_;
+  }
+
   static std::unique_ptr<PatternChecker>
   create(uint8_t arg_sys_id, uint8_t arg_sys_ver, size_t component);
+
+protected:
+  void set_errors(size_t count, size_t first_offset) {
+    error_count_ = count;
+    first_error_offset_ = first_offset;
+  }
+
+private:
+  size_t error_count_ = 0;
+  size_t first_error_offset_ = 0;
 };
 
 class GenericPatternChecker : public PatternChecker {
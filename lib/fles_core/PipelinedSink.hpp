@@ -0,0 +1,187 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "Sink.hpp"
+#include "ThreadContainer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Sink running another sink in a thread of its own.
+/** Items are passed to the thread through a bounded single-producer,
+    single-consumer queue, so a slow sink only delays the producer once its
+    queue is full. The worker thread can be pinned to a CPU. Items must be
+    put from a single thread. */
+template <class T>
+class PipelinedSink : public fles::Sink<T>, public ThreadContainer {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /// Throughput and queue statistics of the pipeline stage.
+  struct Statistics {
+    uint64_t items = 0;       ///< number of items passed to the sink
+    double seconds = 0;       ///< time from the first item to the end
+    double busy_seconds = 0;  ///< time spent in the sink
+    size_t max_depth = 0;     ///< maximum queue depth seen by the producer
+    double mean_depth = 0;    ///< mean queue depth seen by the producer
+    uint64_t full_waits = 0;  ///< number of puts waiting for a full queue
+  };
+
+  /// Construct and start the worker thread.
+  /** \param sink      the sink to run in the worker thread
+      \param name      name of the stage in the statistics
+      \param capacity  queue capacity (rounded up to a power of two)
+      \param cpu       CPU to pin the worker thread to (negative: none) */
+  PipelinedSink(std::unique_ptr<fles::Sink<T>> sink,
+                std::string name,
+                size_t capacity,
+                int cpu = -1)
+      : sink_(std::move(sink)), name_(std::move(name)) {
+    if (!sink_) {
+      throw std::invalid_argument("PipelinedSink: no sink given");
+    }
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    slots_.resize(size);
+    thread_ = std::thread([this, cpu] { work(cpu); });
+  }
+
+  PipelinedSink(const PipelinedSink&) = delete;
+  void operator=(const PipelinedSink&) = delete;
+
+  ~PipelinedSink() override { stop(); }
+
+  void put(std::shared_ptr<const T> item) override {
+    const size_t w = write_.load(std::memory_order_relaxed);
+    size_t depth = w - read_.load(std::memory_order_acquire);
+    if (depth == slots_.size()) {
+      ++full_waits_;
+      do {
+        std::this_thread::yield();
+        depth = w - read_.load(std::memory_order_acquire);
+      } while (depth == slots_.size());
+    }
+    slots_[w & (slots_.size() - 1)] = std::move(item);
+    write_.store(w + 1, std::memory_order_release);
+    ++put_count_;
+    depth_sum_ += depth + 1;
+    if (depth + 1 > max_depth_) {
+      max_depth_ = depth + 1;
+    }
+  }
+
+  /// Wait until all queued items are processed, then end the sink stream.
+  void end_stream() override {
+    stop();
+    sink_->end_stream();
+  }
+
+  /// Retrieve the statistics (complete after end_stream()).
+  [[nodiscard]] Statistics statistics() const {
+    Statistics s;
+    s.items = items_.load();
+    s.seconds = std::chrono::duration<double>(end_.load() - first_.load())
+                    .count();
+    s.busy_seconds = std::chrono::duration<double>(busy_.load()).count();
+    s.max_depth = max_depth_;
+    s.mean_depth = put_count_ > 0 ? static_cast<double>(depth_sum_) /
+                                        static_cast<double>(put_count_)
+                                  : 0;
+    s.full_waits = full_waits_;
+    return s;
+  }
+
+  /// Retrieve a one-line statistics summary.
+  [[nodiscard]] std::string statistics_summary() const {
+    Statistics s = statistics();
+    std::ostringstream out;
+    out.precision(3);
+    out << name_ << ": " << s.items << " items";
+    if (s.seconds > 0) {
+      out << ", " << static_cast<double>(s.items) / s.seconds << " items/s, "
+          << 100 * s.busy_seconds / s.seconds << "% busy";
+    }
+    out << ", queue depth mean " << s.mean_depth << " max " << s.max_depth
+        << "/" << slots_.size() << ", " << s.full_waits << " waits";
+    return out.str();
+  }
+
+  [[nodiscard]] const std::string& name() const { return name_; }
+
+private:
+  void stop() {
+    if (thread_.joinable()) {
+      stopped_.store(true, std::memory_order_release);
+      thread_.join();
+    }
+  }
+
+  void work(int cpu) {
+    if (cpu >= 0) {
+      set_cpu(cpu);
+    }
+    // back off from polling while the queue stays empty
+    constexpr unsigned spins_before_sleep = 1000;
+    constexpr auto idle_sleep = std::chrono::microseconds(50);
+    unsigned idle = 0;
+    while (true) {
+      const size_t r = read_.load(std::memory_order_relaxed);
+      if (r == write_.load(std::memory_order_acquire)) {
+        if (stopped_.load(std::memory_order_acquire) &&
+            r == write_.load(std::memory_order_acquire)) {
+          break;
+        }
+        if (++idle < spins_before_sleep) {
+          std::this_thread::yield();
+        } else {
+          std::this_thread::sleep_for(idle_sleep);
+        }
+        continue;
+      }
+      idle = 0;
+      auto item = std::move(slots_[r & (slots_.size() - 1)]);
+      read_.store(r + 1, std::memory_order_release);
+      auto start = clock::now();
+      if (items_.load(std::memory_order_relaxed) == 0) {
+        first_.store(start);
+      }
+      sink_->put(std::move(item));
+      auto end = clock::now();
+      busy_.store(busy_.load(std::memory_order_relaxed) + (end - start),
+                  std::memory_order_relaxed);
+      end_.store(end);
+      items_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  std::unique_ptr<fles::Sink<T>> sink_;
+  std::string name_;
+
+  std::vector<std::shared_ptr<const T>> slots_;
+  alignas(64) std::atomic<size_t> write_{0};
+  alignas(64) std::atomic<size_t> read_{0};
+  alignas(64) std::atomic<bool> stopped_{false};
+
+  // producer side statistics
+  uint64_t put_count_ = 0;
+  uint64_t depth_sum_ = 0;
+  size_t max_depth_ = 0;
+  uint64_t full_waits_ = 0;
+
+  // consumer side statistics
+  std::atomic<uint64_t> items_{0};
+  std::atomic<clock::time_point> first_{};
+  std::atomic<clock::time_point> end_{};
+  std::atomic<clock::duration> busy_{clock::duration::zero()};
+
+  std::thread thread_;
+};
@@ -0,0 +1,39 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ProcessorScaler.hpp"
+#include <stdexcept>
+
+ProcessorScaler::ProcessorScaler(const Config& config)
+    : config_(config), instances_(config.min_instances) {
+  if (config_.min_instances == 0 ||
+      config_.max_instances < config_.min_instances) {
+    throw std::invalid_argument("invalid processor instance bounds");
+  }
+  if (config_.scale_down_fill >= config_.scale_up_fill) {
+    throw std::invalid_argument(
+        "scale-down fill must be below the scale-up fill");
+  }
+}
+
+uint32_t ProcessorScaler::update(const ProcessorLoad& load) {
+  const bool busy =
+      load.waiting_items > 0 || load.fill >= config_.scale_up_fill;
+  // two instances without work, so that one remains after retiring one
+  const bool idle = load.waiting_items == 0 &&
+                    load.fill <= config_.scale_down_fill &&
+                    load.outstanding_items + 2 <= instances_;
+
+  busy_samples_ = busy ? busy_samples_ + 1 : 0;
+  idle_samples_ = idle ? idle_samples_ + 1 : 0;
+
+  if (busy_samples_ >= config_.scale_up_samples &&
+      instances_ < config_.max_instances) {
+    ++instances_;
+    busy_samples_ = 0;
+  } else if (idle_samples_ >= config_.scale_down_samples &&
+             instances_ > config_.min_instances) {
+    --instances_;
+    idle_samples_ = 0;
+  }
+  return instances_;
+}
@@ -0,0 +1,60 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// The load of the timeslice processors of a timeslice buffer.
+struct ProcessorLoad {
+  /// Work items queued because all processors are busy
+  std::size_t waiting_items = 0;
+  /// Work items being processed
+  std::size_t outstanding_items = 0;
+  /// Fraction of the timeslice buffer held by the processors (0..1)
+  double fill = 0.0;
+};
+
+/// Autoscaling policy for the timeslice processors of a timeslice buffer.
+/** A ProcessorScaler object decides how many processor instances should be
+    running, based on load samples taken at a fixed interval. An instance
+    is added if the processors fall behind (items are waiting or the buffer
+    fill exceeds the scale-up threshold) in a number of consecutive
+    samples, and an instance is retired if more than one instance is idle
+    and the buffer fill is below the scale-down threshold for a larger
+    number of consecutive samples. The number of instances changes by one
+    at a time and stays within the configured bounds. */
+
+class ProcessorScaler {
+public:
+  /// The configuration of the autoscaling policy.
+  struct Config {
+    /// Lower bound of the number of instances (at least 1)
+    uint32_t min_instances = 1;
+    /// Upper bound of the number of instances
+    uint32_t max_instances = 1;
+    /// Buffer fill from which an instance is added
+    double scale_up_fill = 0.5;
+    /// Buffer fill below which an instance may be retired
+    double scale_down_fill = 0.1;
+    /// Consecutive busy samples to add an instance
+    uint32_t scale_up_samples = 3;
+    /// Consecutive idle samples to retire an instance
+    uint32_t scale_down_samples = 30;
+  };
+
+  /// The ProcessorScaler constructor, starting at the lower bound.
+  explicit ProcessorScaler(const Config& config);
+
+  /// Record a load sample.
+  /** \return The number of instances that should be running */
+  uint32_t update(const ProcessorLoad& load);
+
+  /// Retrieve the number of instances that should be running.
+  [[nodiscard]] uint32_t instances() const { return instances_; }
+
+private:
+  Config config_;
+  uint32_t instances_;
+  uint32_t busy_samples_ = 0;
+  uint32_t idle_samples_ = 0;
+};
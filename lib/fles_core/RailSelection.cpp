@@ -0,0 +1,35 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RailSelection.hpp"
+#include <stdexcept>
+#include <utility>
+
+RailSelection::RailSelection(std::vector<std::string> rails,
+                             std::vector<int> numa_nodes)
+    : rails_(std::move(rails)), numa_nodes_(std::move(numa_nodes)),
+      load_(rails_.size(), 0) {
+  if (numa_nodes_.size() != rails_.size()) {
+    throw std::invalid_argument("RailSelection: number of rails and NUMA "
+                                "nodes differ");
+  }
+}
+
+std::string RailSelection::select(int numa_node) {
+  if (rails_.empty()) {
+    throw std::logic_error("RailSelection: no rails available");
+  }
+
+  // prefer a rail on the NUMA node of the buffer
+  size_t best = rails_.size();
+  bool best_local = false;
+  for (size_t r = 0; r < rails_.size(); ++r) {
+    bool local = numa_node >= 0 && numa_nodes_[r] == numa_node;
+    if (best == rails_.size() || (local && !best_local) ||
+        (local == best_local && load_[r] < load_[best])) {
+      best = r;
+      best_local = local;
+    }
+  }
+  ++load_[best];
+  return rails_[best];
+}
@@ -0,0 +1,39 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Network rail selection class.
+/** A RailSelection object assigns the channels of a node to its network
+    interfaces (rails), given by their local addresses. A channel is
+    assigned to the least used rail on the NUMA node of its buffer, or to
+    the least used rail overall if there is none. */
+
+class RailSelection {
+public:
+  /// The RailSelection constructor.
+  /**
+     \param rails      Local addresses of the available rails
+     \param numa_nodes NUMA node of each rail (-1: unknown)
+  */
+  RailSelection(std::vector<std::string> rails, std::vector<int> numa_nodes);
+
+  /// Select a rail for a channel with a buffer on a given NUMA node.
+  /**
+     \param numa_node NUMA node of the channel buffer (-1: unknown)
+     \return the local address of the selected rail
+  */
+  std::string select(int numa_node);
+
+  /// Retrieve the number of channels assigned to each rail.
+  [[nodiscard]] const std::vector<uint32_t>& load() const { return load_; }
+
+  [[nodiscard]] bool empty() const { return rails_.empty(); }
+
+private:
+  std::vector<std::string> rails_;
+  std::vector<int> numa_nodes_;
+  std::vector<uint32_t> load_;
+};
@@ -0,0 +1,194 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RampPattern.hpp"
+#include <immintrin.h>
+
+namespace ramp_pattern {
+
+namespace {
+
+constexpr uint64_t step = sizeof(uint64_t);
+
+uint64_t fill_scalar(uint64_t* dst, size_t words, uint64_t first) {
+  uint64_t x = 0;
+  for (size_t i = 0; i < words; ++i) {
+    uint64_t word = first + i * step;
+    dst[i] = word;
+    x ^= word;
+  }
+  return x;
+}
+
+__attribute__((target("avx2"))) uint64_t
+fill_avx2(uint64_t* dst, size_t words, uint64_t first) {
+  __m256i v = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<int64_t>(first)),
+                               _mm256_set_epi64x(3 * step, 2 * step, step, 0));
+  const __m256i inc = _mm256_set1_epi64x(4 * step);
+  __m256i x = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= words; i += 4) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    x = _mm256_xor_si256(x, v);
+    v = _mm256_add_epi64(v, inc);
+  }
+  alignas(32) uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), x);
+  return lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3] ^
+         fill_scalar(dst + i, words - i, first + i * step);
+}
+
+__attribute__((target("avx512f"))) uint64_t
+fill_avx512(uint64_t* dst, size_t words, uint64_t first) {
+  __m512i v = _mm512_add_epi64(
+      _mm512_set1_epi64(static_cast<int64_t>(first)),
+      _mm512_set_epi64(7 * step, 6 * step, 5 * step, 4 * step, 3 * step,
+                       2 * step, step, 0));
+  const __m512i inc = _mm512_set1_epi64(8 * step);
+  __m512i x = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + 8 <= words; i += 8) {
+    _mm512_storeu_si512(dst + i, v);
+    x = _mm512_xor_si512(x, v);
+    v = _mm512_add_epi64(v, inc);
+  }
+  auto rest = static_cast<__mmask8>((1u << (words - i)) - 1);
+  _mm512_mask_storeu_epi64(dst + i, rest, v);
+  x = _mm512_mask_xor_epi64(x, rest, x, v);
+  alignas(64) uint64_t lanes[8];
+  _mm512_store_si512(lanes, x);
+  uint64_t r = 0;
+  for (uint64_t lane : lanes) {
+    r ^= lane;
+  }
+  return r;
+}
+
+CheckResult check_scalar(const uint64_t* src,
+                         size_t words,
+                         uint64_t first,
+                         uint64_t step) {
+  CheckResult r;
+  for (size_t i = 0; i < words; ++i) {
+    uint64_t word = src[i];
+    r.xor_value ^= word;
+    if (word != first + i * step) {
+      if (r.errors++ == 0) {
+        r.first_error = i;
+      }
+    }
+  }
+  return r;
+}
+
+__attribute__((target("avx2"))) CheckResult check_avx2(const uint64_t* src,
+                                                       size_t words,
+                                                       uint64_t first,
+                                                       uint64_t step) {
+  __m256i e = _mm256_add_epi64(
+      _mm256_set1_epi64x(static_cast<int64_t>(first)),
+      _mm256_set_epi64x(3 * step, 2 * step, step, 0));
+  const __m256i inc = _mm256_set1_epi64x(static_cast<int64_t>(4 * step));
+  __m256i x = _mm256_setzero_si256();
+  CheckResult r;
+  size_t i = 0;
+  for (; i + 4 <= words; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    x = _mm256_xor_si256(x, v);
+    auto mismatch = static_cast<unsigned>(
+        ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, e))) &
+        0xf);
+    if (mismatch != 0) {
+      if (r.errors == 0) {
+        r.first_error = i + __builtin_ctz(mismatch);
+      }
+      r.errors += __builtin_popcount(mismatch);
+    }
+    e = _mm256_add_epi64(e, inc);
+  }
+  alignas(32) uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), x);
+  CheckResult tail = check_scalar(src + i, words - i, first + i * step, step);
+  if (r.errors == 0 && tail.errors != 0) {
+    r.first_error = i + tail.first_error;
+  }
+  r.errors += tail.errors;
+  r.xor_value = lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3] ^ tail.xor_value;
+  return r;
+}
+
+__attribute__((target("avx512f"))) CheckResult check_avx512(
+    const uint64_t* src, size_t words, uint64_t first, uint64_t step) {
+  __m512i e = _mm512_add_epi64(
+      _mm512_set1_epi64(static_cast<int64_t>(first)),
+      _mm512_set_epi64(7 * step, 6 * step, 5 * step, 4 * step, 3 * step,
+                       2 * step, step, 0));
+  const __m512i inc = _mm512_set1_epi64(static_cast<int64_t>(8 * step));
+  __m512i x = _mm512_setzero_si512();
+  CheckResult r;
+  for (size_t i = 0; i < words; i += 8) {
+    // the last, partial vector is loaded masked
+    __mmask8 valid = words - i >= 8
+                         ? __mmask8(0xff)
+                         : static_cast<__mmask8>((1u << (words - i)) - 1);
+    __m512i v = _mm512_maskz_loadu_epi64(valid, src + i);
+    x = _mm512_xor_si512(x, v);
+    unsigned mismatch = _mm512_mask_cmpneq_epi64_mask(valid, v, e);
+    if (mismatch != 0) {
+      if (r.errors == 0) {
+        r.first_error = i + __builtin_ctz(mismatch);
+      }
+      r.errors += __builtin_popcount(mismatch);
+    }
+    e = _mm512_add_epi64(e, inc);
+  }
+  alignas(64) uint64_t lanes[8];
+  _mm512_store_si512(lanes, x);
+  for (uint64_t lane : lanes) {
+    r.xor_value ^= lane;
+  }
+  return r;
+}
+
+} // namespace
+
+SimdLevel supported_level() {
+  static const SimdLevel level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return SimdLevel::avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdLevel::avx2;
+    }
+    return SimdLevel::scalar;
+  }();
+  return level;
+}
+
+uint64_t fill(uint64_t* dst, size_t words, uint64_t first, SimdLevel level) {
+  switch (level) {
+  case SimdLevel::avx512:
+    return fill_avx512(dst, words, first);
+  case SimdLevel::avx2:
+    return fill_avx2(dst, words, first);
+  default:
+    return fill_scalar(dst, words, first);
+  }
+}
+
+CheckResult check(const uint64_t* src,
+                  size_t words,
+                  uint64_t first,
+                  uint64_t step,
+                  SimdLevel level) {
+  switch (level) {
+  case SimdLevel::avx512:
+    return check_avx512(src, words, first, step);
+  case SimdLevel::avx2:
+    return check_avx2(src, words, first, step);
+  default:
+    return check_scalar(src, words, first, step);
+  }
+}
+
+} // namespace ramp_pattern
@@ -0,0 +1,48 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Vectorized kernels for the flesnet ramp test pattern.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Namespace for the flesnet ramp test pattern.
+/** Microslice content of the BasicRampPattern format consists of 64-bit
+    words `(component << 48) | offset`, where offset is the byte offset of
+    the word in the microslice. The CRC field of the descriptor holds the
+    XOR of the lower and upper 32-bit halves of all words. */
+namespace ramp_pattern {
+
+/// Instruction set level of the pattern kernels.
+enum class SimdLevel { scalar, avx2, avx512 };
+
+/// Highest level supported by the CPU (determined once at run time).
+SimdLevel supported_level();
+
+/// Fold the XOR of all content words into the descriptor CRC value.
+inline uint32_t crc(uint64_t xor_value) {
+  return static_cast<uint32_t>(xor_value ^ (xor_value >> 32));
+}
+
+/// Result of a pattern check.
+struct CheckResult {
+  uint64_t xor_value = 0;  ///< XOR of all checked words
+  size_t errors = 0;       ///< number of words not matching the ramp
+  size_t first_error = 0;  ///< index of the first such word (if any)
+};
+
+/// Fill words with a ramp starting at first, incremented by 8 per word.
+/** \return XOR of all written words */
+uint64_t fill(uint64_t* dst,
+              size_t words,
+              uint64_t first,
+              SimdLevel level = supported_level());
+
+/// Compare words against a ramp starting at first, incremented by step.
+CheckResult check(const uint64_t* src,
+                  size_t words,
+                  uint64_t first,
+                  uint64_t step,
+                  SimdLevel level = supported_level());
+
+} // namespace ramp_pattern
@@ -0,0 +1,168 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RecordLog.hpp"
+#include "System.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+// Header layout: magic, version (u32), column count (u32), record count
+// (u64), dropped record count (u64), then one descriptor per column
+constexpr uint32_t version = 1;
+constexpr std::size_t record_count_offset = 16;
+constexpr std::size_t dropped_offset = 24;
+constexpr std::size_t columns_offset = 32;
+constexpr std::size_t column_size = RecordLog::max_name_length + 1;
+
+constexpr std::size_t min_map_size = std::size_t{1} << 20;
+
+} // namespace
+
+RecordLog::RecordLog(const std::string& path,
+                     std::vector<Column> columns,
+                     std::size_t max_pending)
+    : columns_(columns.size()),
+      header_size_(columns_offset + columns.size() * column_size),
+      max_pending_(std::max<std::size_t>(max_pending, 1)) {
+  if (columns.empty()) {
+    throw std::invalid_argument("RecordLog: no columns given");
+  }
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ == -1) {
+    throw std::runtime_error("RecordLog: cannot open " + path + ": " +
+                             fles::system::stringerror(errno));
+  }
+  try {
+    reserve(0);
+  } catch (...) {
+    close(fd_);
+    throw;
+  }
+
+  std::memcpy(map_, magic, sizeof(magic));
+  const auto column_count = static_cast<uint32_t>(columns_);
+  std::memcpy(map_ + sizeof(magic), &version, sizeof(version));
+  std::memcpy(map_ + sizeof(magic) + sizeof(version), &column_count,
+              sizeof(column_count));
+  for (std::size_t i = 0; i < columns_; ++i) {
+    uint8_t* desc = map_ + columns_offset + i * column_size;
+    std::size_t length =
+        std::min(columns[i].name.size(), max_name_length - 1);
+    std::memcpy(desc, columns[i].name.data(), length);
+    desc[max_name_length] = static_cast<uint8_t>(columns[i].type);
+  }
+
+  pending_.reserve(columns_ * std::min<std::size_t>(max_pending_, 1024));
+  worker_ = std::thread([this] { work(); });
+}
+
+RecordLog::~RecordLog() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cond_.notify_one();
+  worker_.join();
+
+  std::size_t size = header_size_ + written_ * columns_ * sizeof(uint64_t);
+  if (map_ != nullptr) {
+    std::memcpy(map_ + dropped_offset, &dropped_, sizeof(dropped_));
+    munmap(map_, map_size_);
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    L_(error) << "RecordLog: cannot truncate file: "
+              << fles::system::stringerror(errno);
+  }
+  close(fd_);
+}
+
+void RecordLog::append_words(const uint64_t* words, std::size_t count) {
+  if (count != columns_) {
+    throw std::invalid_argument("RecordLog: wrong number of values");
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.size() >= max_pending_ * columns_ || failed_) {
+      ++dropped_;
+      return;
+    }
+    pending_.insert(pending_.end(), words, words + count);
+  }
+  cond_.notify_one();
+}
+
+uint64_t RecordLog::dropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+void RecordLog::work() {
+  std::vector<uint64_t> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cond_.wait(lock, [this] { return stopped_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      return;
+    }
+    std::swap(batch, pending_);
+    const uint64_t dropped = dropped_;
+    lock.unlock();
+
+    const uint64_t records = batch.size() / columns_;
+    try {
+      reserve(written_ + records);
+      std::memcpy(map_ + header_size_ +
+                      written_ * columns_ * sizeof(uint64_t),
+                  batch.data(), batch.size() * sizeof(uint64_t));
+      // the record count is updated last, so that it never covers
+      // incompletely written records
+      written_ += records;
+      std::memcpy(map_ + record_count_offset, &written_, sizeof(written_));
+      std::memcpy(map_ + dropped_offset, &dropped, sizeof(dropped));
+    } catch (const std::exception& e) {
+      L_(error) << e.what() << ", further records are dropped";
+      lock.lock();
+      dropped_ += records;
+      failed_ = true;
+      batch.clear();
+      continue;
+    }
+    batch.clear();
+    lock.lock();
+  }
+}
+
+void RecordLog::reserve(uint64_t records) {
+  const std::size_t needed =
+      header_size_ + records * columns_ * sizeof(uint64_t);
+  if (map_ != nullptr && needed <= map_size_) {
+    return;
+  }
+  std::size_t size = std::max(map_size_, min_map_size);
+  while (size < needed) {
+    size *= 2;
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    throw std::runtime_error("RecordLog: cannot extend file: " +
+                             fles::system::stringerror(errno));
+  }
+  if (map_ != nullptr) {
+    munmap(map_, map_size_);
+    map_ = nullptr;
+  }
+  void* addr =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("RecordLog: mmap failed: " +
+                             fles::system::stringerror(errno));
+  }
+  map_ = static_cast<uint8_t*>(addr);
+  map_size_ = size;
+}
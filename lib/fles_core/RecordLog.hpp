@@ -0,0 +1,106 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// Streaming binary record log class.
+/** A RecordLog object appends fixed-size records to a memory-mapped file.
+    Each record consists of one 64-bit word per column, holding either an
+    unsigned integer or a double. Records are copied into a bounded queue
+    and written by a background thread, so that logging does neither block
+    the caller nor accumulate in memory. If the queue is full, records are
+    dropped and counted. The file starts with a self-describing header, see
+    contrib/record-log-convert for the conversion to text. */
+
+class RecordLog {
+public:
+  /// Data type of a column.
+  enum class Type : char { Unsigned = 'u', Double = 'd' };
+
+  /// Description of a column.
+  struct Column {
+    std::string name;
+    Type type = Type::Unsigned;
+  };
+
+  /// Magic number at the beginning of a record log file.
+  static constexpr char magic[8] = {'F', 'L', 'E', 'S', 'R', 'L', 'O', 'G'};
+
+  /// Maximum length of a column name (including termination).
+  static constexpr std::size_t max_name_length = 31;
+
+  /// The RecordLog constructor.
+  /**
+     \param path        Output file (truncated if it exists)
+     \param columns     Columns of the records
+     \param max_pending Maximum number of records waiting to be written
+  */
+  RecordLog(const std::string& path,
+            std::vector<Column> columns,
+            std::size_t max_pending = 65536);
+
+  /// Delete copy constructor (non-copyable).
+  RecordLog(const RecordLog&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const RecordLog&) = delete;
+
+  /// The RecordLog destructor, writes all pending records.
+  ~RecordLog();
+
+  /// Append a record given as one value per column.
+  template <typename... Values> void append(Values... values) {
+    static_assert((std::is_arithmetic_v<Values> && ...),
+                  "RecordLog values must be arithmetic");
+    const uint64_t words[] = {word(values)...};
+    append_words(words, sizeof...(values));
+  }
+
+  /// Append a record given as one word per column.
+  void append_words(const uint64_t* words, std::size_t count);
+
+  /// Retrieve the number of records dropped due to a full queue.
+  [[nodiscard]] uint64_t dropped() const;
+
+private:
+  template <typename T> static uint64_t word(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      auto d = static_cast<double>(value);
+      uint64_t w = 0;
+      std::memcpy(&w, &d, sizeof(w));
+      return w;
+    } else {
+      return static_cast<uint64_t>(value);
+    }
+  }
+
+  void work();
+
+  /// Make room for a given number of records in the mapped file.
+  void reserve(uint64_t records);
+
+  std::size_t columns_;
+  std::size_t header_size_;
+  std::size_t max_pending_;
+
+  int fd_ = -1;
+  uint8_t* map_ = nullptr;
+  std::size_t map_size_ = 0;
+  uint64_t written_ = 0;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<uint64_t> pending_;
+  uint64_t dropped_ = 0;
+  bool failed_ = false;
+  bool stopped_ = false;
+
+  std::thread worker_;
+};
@@ -1,6 +1,7 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "MemoryPlacement.hpp"
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
@@ -12,6 +13,10 @@
 #include <unistd.h>
 
 /// Simple generic ring buffer class.
+/** If memory placement options are given, the buffer is allocated as a
+    page-aligned private memory region (see allocate_memory()). A mirrored
+    buffer is followed by a second mapping of its memory, so that any range
+    of up to size() entries starting in the buffer is contiguous. */
 template <typename T, bool CLEARED = false, bool PAGE_ALIGNED = false>
 class RingBuffer {
 public:
@@ -33,24 +38,56 @@ public:
     alloc_with_size_exponent(new_size_exponent);
   }
 
+  /// The RingBuffer initializing constructor with memory placement options.
+  RingBuffer(size_t new_size_exponent, const MemoryPlacement& placement) {
+    alloc_with_size_exponent(new_size_exponent, placement);
+  }
+
   RingBuffer(const RingBuffer&) = delete;
   void operator=(const RingBuffer&) = delete;
 
   /// Create and initialize buffer with given minimum size.
   void alloc_with_size(size_t minimum_size) {
-    size_t new_size_exponent = 0;
-    if (minimum_size > 1) {
-      minimum_size--;
-      ++new_size_exponent;
-      while ((minimum_size >>= 1) != 0u) {
-        ++new_size_exponent;
+    alloc_with_size_exponent(size_exponent_for(minimum_size));
+  }
+
+  /// Create and initialize buffer with given minimum size and placement.
+  void alloc_with_size(size_t minimum_size,
+                       const MemoryPlacement& placement) {
+    alloc_with_size_exponent(size_exponent_for(minimum_size), placement);
+  }
+
+  /// Create and initialize buffer with given size exponent and placement.
+  void alloc_with_size_exponent(size_t new_size_exponent,
+                                const MemoryPlacement& placement) {
+    buf_.reset();
+    mirrored_ = placement.mirrored;
+    size_exponent_ = new_size_exponent;
+    size_ = UINT64_C(1) << size_exponent_;
+    size_mask_ = size_ - 1;
+    MemoryRegion region = allocate_memory(sizeof(T) * size_, placement);
+    T* ptr = static_cast<T*>(region.addr);
+    try {
+      if (CLEARED) {
+        std::uninitialized_value_construct_n(ptr, size_);
+      } else {
+        std::uninitialized_default_construct_n(ptr, size_);
       }
+    } catch (...) {
+      free_memory(region);
+      throw;
     }
-    alloc_with_size_exponent(new_size_exponent);
+    buf_ = buf_t(ptr, [size = size_, region](T* p) {
+      for (size_t i = size; i != 0u; --i) {
+        p[i - 1].~T();
+      }
+      free_memory(region);
+    });
   }
 
   /// Create and initialize buffer with given size exponent.
   void alloc_with_size_exponent(size_t new_size_exponent) {
+    mirrored_ = false;
     size_exponent_ = new_size_exponent;
     size_ = UINT64_C(1) << size_exponent_;
     size_mask_ = size_ - 1;
@@ -113,9 +150,24 @@ public:
   /// Retrieve buffer size in bytes.
   [[nodiscard]] size_t bytes() const { return size_ * sizeof(T); }
 
+  /// Check whether the buffer is followed by a mirror of its memory.
+  [[nodiscard]] bool mirrored() const { return mirrored_; }
+
   void clear() { std::fill_n(buf_, size_, T()); }
 
 private:
+  static size_t size_exponent_for(size_t minimum_size) {
+    size_t new_size_exponent = 0;
+    if (minimum_size > 1) {
+      minimum_size--;
+      ++new_size_exponent;
+      while ((minimum_size >>= 1) != 0u) {
+        ++new_size_exponent;
+      }
+    }
+    return new_size_exponent;
+  }
+
   /// Buffer size (maximum number of entries).
   size_t size_ = 0;
 
@@ -125,6 +177,9 @@ private:
   /// Buffer addressing bit mask.
   size_t size_mask_ = 0;
 
+  /// Whether the buffer is followed by a mirror of its memory.
+  bool mirrored_ = false;
+
   /// The data buffer.
   buf_t buf_;
 };
@@ -1,17 +1,22 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 
 /// Simple generic ring buffer view class.
 template <typename T> class RingBufferView {
 public:
   /// The RingBufferView constructor.
-  RingBufferView(T* buffer, std::size_t new_size_exponent)
+  /** A mirrored buffer is followed by a second mapping of its memory (see
+      RingBuffer). */
+  RingBufferView(T* buffer, std::size_t new_size_exponent,
+                 bool mirrored = false)
       : buf_(buffer), size_exponent_(new_size_exponent),
         size_(UINT64_C(1) << size_exponent_),
-        size_mask_((UINT64_C(1) << size_exponent_) - 1) {}
+        size_mask_((UINT64_C(1) << size_exponent_) - 1), mirrored_(mirrored) {}
 
   /// The element accessor operator.
   T& at(std::size_t n) { return buf_[n & size_mask_]; }
@@ -21,6 +26,19 @@ public:
     return buf_[n & size_mask_];
   }
 
+  /// Prefetch a range of entries into the cache.
+  void prefetch(std::size_t begin, std::size_t count) const {
+    constexpr std::size_t cache_line = 64;
+    constexpr std::size_t step =
+        sizeof(T) < cache_line ? cache_line / sizeof(T) : 1;
+    for (std::size_t i = 0; i < count; i += step) {
+      __builtin_prefetch(&at(begin + i));
+    }
+    if (count > 0) {
+      __builtin_prefetch(&at(begin + count - 1));
+    }
+  }
+
   /// Retrieve pointer to memory buffer.
   T* ptr() { return buf_; }
 
@@ -39,6 +57,14 @@ public:
   /// Retrieve buffer size in bytes.
   [[nodiscard]] std::size_t bytes() const { return size_ * sizeof(T); }
 
+  /// Check whether any range of up to size() entries is contiguous.
+  [[nodiscard]] bool mirrored() const { return mirrored_; }
+
+  /// Retrieve size of the mapped memory (including a mirror) in bytes.
+  [[nodiscard]] std::size_t mapped_bytes() const {
+    return mirrored_ ? 2 * bytes() : bytes();
+  }
+
 private:
   /// The data buffer.
   T* buf_;
@@ -51,4 +77,116 @@ private:
 
   /// Buffer addressing bit mask.
   const std::size_t size_mask_;
+
+  /// Whether the buffer is followed by a mirror of its memory.
+  const bool mirrored_;
 };
+
+/// Ring buffer view class with the size exponent fixed at compile time.
+/** Provides the interface of RingBufferView, but with size and addressing
+    mask as constants, so that the index computations of hot loops are
+    folded into the accesses. Use with_fixed_size() to select the
+    specialization matching a RingBufferView at run time. */
+template <typename T, std::size_t SIZE_EXPONENT> class FixedRingBufferView {
+public:
+  /// The FixedRingBufferView constructor.
+  explicit FixedRingBufferView(T* buffer, bool mirrored = false)
+      : buf_(buffer), mirrored_(mirrored) {}
+
+  /// Construct a view of the buffer of a RingBufferView of the same size.
+  explicit FixedRingBufferView(RingBufferView<T>& view)
+      : buf_(view.ptr()), mirrored_(view.mirrored()) {
+    assert(view.size_exponent() == SIZE_EXPONENT);
+  }
+
+  /// The element accessor operator.
+  T& at(std::size_t n) { return buf_[n & size_mask()]; }
+
+  /// The const element accessor operator.
+  [[nodiscard]] const T& at(std::size_t n) const {
+    return buf_[n & size_mask()];
+  }
+
+  /// Prefetch a range of entries into the cache.
+  void prefetch(std::size_t begin, std::size_t count) const {
+    constexpr std::size_t cache_line = 64;
+    constexpr std::size_t step =
+        sizeof(T) < cache_line ? cache_line / sizeof(T) : 1;
+    for (std::size_t i = 0; i < count; i += step) {
+      __builtin_prefetch(&at(begin + i));
+    }
+    if (count > 0) {
+      __builtin_prefetch(&at(begin + count - 1));
+    }
+  }
+
+  /// Retrieve pointer to memory buffer.
+  T* ptr() { return buf_; }
+
+  /// Retrieve const pointer to memory buffer.
+  [[nodiscard]] const T* ptr() const { return buf_; }
+
+  /// Retrieve buffer size in maximum number of entries.
+  [[nodiscard]] static constexpr std::size_t size() {
+    return UINT64_C(1) << SIZE_EXPONENT;
+  }
+
+  /// Retrieve buffer size in maximum number of entries as two's exponent.
+  [[nodiscard]] static constexpr std::size_t size_exponent() {
+    return SIZE_EXPONENT;
+  }
+
+  /// Retrieve buffer size bit mask.
+  [[nodiscard]] static constexpr std::size_t size_mask() {
+    return size() - 1;
+  }
+
+  /// Retrieve buffer size in bytes.
+  [[nodiscard]] static constexpr std::size_t bytes() {
+    return size() * sizeof(T);
+  }
+
+  /// Check whether any range of up to size() entries is contiguous.
+  [[nodiscard]] bool mirrored() const { return mirrored_; }
+
+  /// Retrieve size of the mapped memory (including a mirror) in bytes.
+  [[nodiscard]] std::size_t mapped_bytes() const {
+    return mirrored_ ? 2 * bytes() : bytes();
+  }
+
+private:
+  /// The data buffer.
+  T* buf_;
+
+  /// Whether the buffer is followed by a mirror of its memory.
+  bool mirrored_;
+};
+
+/// The size exponents of data buffers to specialize hot loops for.
+using common_data_size_exponents =
+    std::index_sequence<20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30>;
+
+/// The size exponents of descriptor buffers to specialize hot loops for.
+using common_desc_size_exponents =
+    std::index_sequence<14, 15, 16, 17, 18, 19, 20, 21>;
+
+/// Call a function with the view specialized for its size exponent.
+/** If the size exponent of the view is one of EXPONENTS, f is called with
+    a FixedRingBufferView of this exponent, otherwise with the view itself.
+    f is typically a generic lambda, instantiated for each exponent. */
+template <typename T, typename F, std::size_t E, std::size_t... EXPONENTS>
+decltype(auto) with_fixed_size(RingBufferView<T>& view,
+                               std::index_sequence<E, EXPONENTS...> /*unused*/,
+                               F&& f) {
+  if (view.size_exponent() == E) {
+    FixedRingBufferView<T, E> fixed(view);
+    return f(fixed);
+  }
+  if constexpr (sizeof...(EXPONENTS) == 0) {
+    return f(view);
+  } else {
+    return with_fixed_size(view, std::index_sequence<EXPONENTS...>(),
+                           std::forward<F>(f));
+  }
+}
+
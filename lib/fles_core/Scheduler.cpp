@@ -0,0 +1,210 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "Scheduler.hpp"
+#include <algorithm>
+#include <utility>
+
+Scheduler::Scheduler() : epoch_(clock::now()), epoch_tsc_(__rdtsc()) {
+  wheel_[0].resize(level0_slots, nullptr);
+  for (int level = 1; level < levels; ++level) {
+    wheel_[level].resize(level_slots, nullptr);
+  }
+  last_check_tsc_ = epoch_tsc_;
+}
+
+void Scheduler::add(const callback_type& cb, const time_t& when) {
+  add(cb, std::chrono::system_clock::from_time_t(when));
+}
+
+void Scheduler::add(const callback_type& cb, const timeval& when) {
+  add(cb, std::chrono::system_clock::from_time_t(when.tv_sec) +
+              std::chrono::microseconds(when.tv_usec));
+}
+
+void Scheduler::add(
+    const callback_type& cb,
+    const std::chrono::time_point<std::chrono::system_clock>& when) {
+  add_after(cb, std::chrono::duration_cast<clock::duration>(
+                    when - std::chrono::system_clock::now()));
+}
+
+void Scheduler::add_after(callback_type cb, clock::duration delay) {
+  Timer* t = new_timer(std::move(cb), deadline_tick(clock::now() + delay), 0);
+  insert(t, current_tick_ + 1);
+}
+
+void Scheduler::add_repeating(callback_type cb, clock::duration period) {
+  if (period <= clock::duration::zero()) {
+    pollers_.push_back(std::move(cb));
+    return;
+  }
+  Timer* t = new_timer(std::move(cb), deadline_tick(clock::now() + period),
+                       to_ticks(period));
+  insert(t, current_tick_ + 1);
+}
+
+void Scheduler::timer(clock::time_point now) {
+  if (now < epoch_) {
+    return;
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch_);
+  uint64_t tick = static_cast<uint64_t>(ns.count()) >> tick_bits;
+  if (tick <= current_tick_) {
+    return;
+  }
+  if (size_ == 0) {
+    current_tick_ = tick;
+  } else if (tick - current_tick_ > level0_slots) {
+    rebuild(tick);
+  } else {
+    while (current_tick_ < tick) {
+      ++current_tick_;
+      cascade(current_tick_);
+      Timer* list = std::exchange(
+          wheel_[0][current_tick_ & (level0_slots - 1)], nullptr);
+      expire(list);
+    }
+  }
+}
+
+uint64_t Scheduler::to_ticks(clock::duration d) {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+  if (ns <= 0) {
+    return 0;
+  }
+  constexpr uint64_t tick_mask = (uint64_t(1) << tick_bits) - 1;
+  return (static_cast<uint64_t>(ns) + tick_mask) >> tick_bits;
+}
+
+uint64_t Scheduler::deadline_tick(clock::time_point when) const {
+  return to_ticks(when - epoch_);
+}
+
+Scheduler::Timer*
+Scheduler::new_timer(callback_type cb, uint64_t deadline, uint64_t period) {
+  Timer* t = free_;
+  if (t != nullptr) {
+    free_ = t->next;
+  } else {
+    timers_.push_back(std::make_unique<Timer>());
+    t = timers_.back().get();
+  }
+  t->callback = std::move(cb);
+  t->deadline = deadline;
+  t->period = period;
+  t->next = nullptr;
+  ++size_;
+  return t;
+}
+
+void Scheduler::release(Timer* t) {
+  t->callback = nullptr;
+  t->next = free_;
+  free_ = t;
+  --size_;
+}
+
+/// Insert a timer into the slot of its deadline, but not before min_tick.
+void Scheduler::insert(Timer* t, uint64_t min_tick) {
+  uint64_t pos = std::max(t->deadline, min_tick);
+  if (pos - current_tick_ < level0_slots) {
+    Timer*& head = wheel_[0][pos & (level0_slots - 1)];
+    t->next = head;
+    head = t;
+    return;
+  }
+  // beyond the range of the wheel: re-inserted on cascading
+  pos = std::min(pos, current_tick_ + max_delta - 1);
+  uint64_t delta = pos - current_tick_;
+  int level = 1;
+  int shift = level0_bits;
+  while (level < levels - 1 && delta >= (uint64_t(1) << (shift + level_bits))) {
+    ++level;
+    shift += level_bits;
+  }
+  Timer*& head = wheel_[level][(pos >> shift) & (level_slots - 1)];
+  t->next = head;
+  head = t;
+}
+
+/// Move the timers of the higher-level slots starting at tick downwards.
+void Scheduler::cascade(uint64_t tick) {
+  if ((tick & (level0_slots - 1)) != 0) {
+    return;
+  }
+  // find the highest level whose slot boundary is reached
+  int top = 1;
+  int shift = level0_bits;
+  while (top < levels - 1 &&
+         ((tick >> shift) & (level_slots - 1)) == 0) {
+    ++top;
+    shift += level_bits;
+  }
+  // cascade from the top, as higher levels fill lower-level slots
+  for (int level = top; level >= 1; --level) {
+    Timer* list =
+        std::exchange(wheel_[level][(tick >> shift) & (level_slots - 1)],
+                      nullptr);
+    while (list != nullptr) {
+      Timer* t = list;
+      list = t->next;
+      insert(t, current_tick_);
+    }
+    shift -= level_bits;
+  }
+}
+
+/// Run the due timers of a list and re-insert the others.
+void Scheduler::expire(Timer* list) {
+  while (list != nullptr) {
+    Timer* t = list;
+    list = t->next;
+    if (t->deadline > current_tick_) {
+      insert(t, current_tick_ + 1);
+    } else if (t->period == 0) {
+      // the callback may add timers, so release this one before
+      callback_type cb = std::move(t->callback);
+      release(t);
+      cb();
+    } else {
+      t->deadline += t->period;
+      if (t->deadline <= current_tick_) {
+        t->deadline = current_tick_ + t->period;
+      }
+      t->callback();
+      insert(t, current_tick_ + 1);
+    }
+  }
+}
+
+/// Jump to a tick far ahead, collecting all timers instead of stepping.
+void Scheduler::rebuild(uint64_t tick) {
+  Timer* list = nullptr;
+  for (auto& level : wheel_) {
+    for (auto& head : level) {
+      while (head != nullptr) {
+        Timer* t = head;
+        head = t->next;
+        t->next = list;
+        list = t;
+      }
+    }
+  }
+  current_tick_ = tick;
+  expire(list);
+}
+
+/// Read the clock, refine the TSC calibration and run the due timers.
+void Scheduler::check(uint64_t tsc) {
+  last_check_tsc_ = tsc;
+  clock::time_point now = clock::now();
+  if (tsc > epoch_tsc_ && now - epoch_ >= calibration_time) {
+    auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch_);
+    double tsc_per_ns = static_cast<double>(tsc - epoch_tsc_) /
+                        static_cast<double>(ns.count());
+    tsc_per_tick_ = static_cast<uint64_t>(
+        tsc_per_ns * static_cast<double>(uint64_t(1) << tick_bits));
+  }
+  timer(now);
+}
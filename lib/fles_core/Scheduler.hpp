@@ -1,60 +1,121 @@
-// Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
+// Copyright 2012-2013, 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Timer wheel for deferred and periodic callbacks in polling loops.
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <functional>
-#include <queue>
+#include <memory>
 #include <sys/time.h> // for `time_t` and `struct timeval`
-#include <utility>
+#include <vector>
+#include <x86intrin.h>
 
+/// Hierarchical timer wheel driven from a polling loop.
+/** Deadlines are kept on the monotonic steady clock with a tick of about one
+    millisecond (2^20 ns). A timer never fires early; it fires on the first
+    call of timer() after its tick has elapsed. To keep timer() cheap enough
+    to be called in every iteration of a busy polling loop, the clock is read
+    at most once per tick, using the TSC (calibrated against the steady
+    clock) to decide when the next tick is due. Repeating timers are
+    re-inserted in place and do not allocate after their creation. */
 class Scheduler {
 public:
-  struct event {
-    using callback_type = std::function<void()>;
-    using time_type = std::chrono::time_point<std::chrono::system_clock>;
+  using clock = std::chrono::steady_clock;
+  using callback_type = std::function<void()>;
 
-    event(callback_type cb, const time_type& when)
-        : callback_(std::move(cb)), when_(when) {}
+  Scheduler();
 
-    void operator()() const { callback_(); }
+  Scheduler(const Scheduler&) = delete;
+  void operator=(const Scheduler&) = delete;
 
-    callback_type callback_;
-    time_type when_;
-  };
+  /// Run a callback once at a given time of the system clock.
+  void add(const callback_type& cb, const time_t& when);
+
+  /// Run a callback once at a given time of the system clock.
+  void add(const callback_type& cb, const timeval& when);
+
+  /// Run a callback once at a given time of the system clock.
+  void add(const callback_type& cb,
+           const std::chrono::time_point<std::chrono::system_clock>& when);
+
+  /// Run a callback once after a delay.
+  void add_after(callback_type cb, clock::duration delay);
+
+  /// Run a callback periodically, first after one period.
+  /** A zero period runs the callback on every call of timer(); such timers
+      must not be added from within a callback. Periods missed because
+      timer() was not called in time are skipped. */
+  void add_repeating(callback_type cb, clock::duration period);
 
-  struct event_less : public std::less<event> {
-    bool operator()(const event& e1, const event& e2) const {
-      return (e2.when_ < e1.when_);
+  /// Run all callbacks that are due (to be called from the polling loop).
+  void timer() {
+    for (auto& cb : pollers_) {
+      cb();
+    }
+    uint64_t tsc = __rdtsc();
+    // unsigned difference: a TSC going backwards forces a check as well
+    if (tsc - last_check_tsc_ >= tsc_per_tick_) {
+      check(tsc);
     }
+  }
+
+  /// Run all callbacks that are due at a given time.
+  /** Reads the current time from the caller instead of the clock. Times
+      must be non-decreasing between calls. */
+  void timer(clock::time_point now);
+
+  /// Number of pending timers (excluding zero-period repeating timers).
+  [[nodiscard]] size_t size() const { return size_; }
+
+private:
+  struct Timer {
+    callback_type callback;
+    uint64_t deadline = 0; ///< in ticks since epoch_
+    uint64_t period = 0;   ///< in ticks, zero for one-shot timers
+    Timer* next = nullptr;
   };
 
-  void add(const event::callback_type& cb, const time_t& when) {
-    auto real_when = std::chrono::system_clock::from_time_t(when);
+  static constexpr int tick_bits = 20; // tick of 2^20 ns
+  static constexpr int level0_bits = 8;
+  static constexpr int level_bits = 6;
+  static constexpr int levels = 4;
+  static constexpr uint64_t level0_slots = uint64_t(1) << level0_bits;
+  static constexpr uint64_t level_slots = uint64_t(1) << level_bits;
+  static constexpr uint64_t max_delta = uint64_t(1)
+                                        << (level0_bits +
+                                            (levels - 1) * level_bits);
+  static constexpr auto calibration_time = std::chrono::milliseconds(10);
 
-    event_queue_.emplace(cb, real_when);
-  }
+  /// Convert a duration to ticks, rounding up.
+  static uint64_t to_ticks(clock::duration d);
 
-  void add(const event::callback_type& cb, const timeval& when) {
-    auto real_when = std::chrono::system_clock::from_time_t(when.tv_sec) +
-                     std::chrono::microseconds(when.tv_usec);
+  /// Tick corresponding to a (monotonic) time point, rounded up.
+  [[nodiscard]] uint64_t deadline_tick(clock::time_point when) const;
 
-    event_queue_.emplace(cb, real_when);
-  }
+  Timer* new_timer(callback_type cb, uint64_t deadline, uint64_t period);
+  void insert(Timer* t, uint64_t min_tick);
+  void cascade(uint64_t tick);
+  void expire(Timer* list);
+  void release(Timer* t);
+  void rebuild(uint64_t tick);
+  void check(uint64_t tsc);
 
-  void add(const event::callback_type& cb,
-           const std::chrono::time_point<std::chrono::system_clock>& when) {
-    event_queue_.emplace(cb, when);
-  }
+  // slot lists of all levels; level 0 has level0_slots, others level_slots
+  std::array<std::vector<Timer*>, levels> wheel_;
 
-  void timer() {
-    event::time_type now = std::chrono::system_clock::now();
+  // owned timer objects and the list of unused ones
+  std::vector<std::unique_ptr<Timer>> timers_;
+  Timer* free_ = nullptr;
+  size_t size_ = 0;
 
-    while (!event_queue_.empty() && (event_queue_.top().when_ <= now)) {
-      event_queue_.top()();
-      event_queue_.pop();
-    }
-  }
+  std::vector<callback_type> pollers_;
 
-private:
-  std::priority_queue<event, std::vector<event>, event_less> event_queue_;
+  clock::time_point epoch_;
+  uint64_t current_tick_ = 0;
+
+  uint64_t epoch_tsc_;
+  uint64_t last_check_tsc_ = 0;
+  uint64_t tsc_per_tick_ = 0; // zero until calibrated: check on every call
 };
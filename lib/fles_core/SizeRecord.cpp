@@ -0,0 +1,108 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "SizeRecord.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+SizeRecord SizeRecord::parse(std::istream& is) {
+  SizeRecord record;
+  uint64_t total = 0;
+  uint64_t first = 0;
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(is, line)) {
+    ++line_number;
+    std::istringstream ls(line.substr(0, line.find('#')));
+    std::string token;
+    if (!(ls >> token)) {
+      continue;
+    }
+    auto fail = [line_number]() {
+      return std::invalid_argument("SizeRecord: syntax error in line " +
+                                   std::to_string(line_number));
+    };
+    try {
+      std::string value;
+      if (token == "histogram") {
+        std::string count;
+        if (!(ls >> value >> count) || !record.index_.empty()) {
+          throw fail();
+        }
+        record.size_.push_back(static_cast<uint32_t>(std::stoul(value)));
+        total += std::stoull(count);
+        record.cumulative_.push_back(total);
+      } else {
+        if (!(ls >> value) || !record.cumulative_.empty()) {
+          throw fail();
+        }
+        uint64_t index = std::stoull(token);
+        if (record.index_.empty()) {
+          first = index;
+        } else if (index < first + record.index_.back()) {
+          throw fail();
+        }
+        record.index_.push_back(index - first);
+        record.size_.push_back(static_cast<uint32_t>(std::stoul(value)));
+      }
+    } catch (const std::logic_error&) {
+      throw fail();
+    }
+  }
+  if (record.size_.empty() ||
+      (!record.cumulative_.empty() && record.cumulative_.back() == 0)) {
+    throw std::invalid_argument("SizeRecord: no entries given");
+  }
+  if (!record.index_.empty()) {
+    uint64_t last = record.index_.back();
+    record.period_ = last + (record.index_.size() > 1
+                                 ? last / (record.index_.size() - 1)
+                                 : 0);
+  }
+  return record;
+}
+
+SizeRecord SizeRecord::read(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("cannot read size record: " + path);
+  }
+  return parse(file);
+}
+
+uint32_t SizeRecord::size(uint64_t n, double quantile) const {
+  if (series()) {
+    return size_[n % size_.size()];
+  }
+  auto target = static_cast<uint64_t>(
+      std::clamp(quantile, 0.0, 1.0) *
+      static_cast<double>(cumulative_.back()));
+  auto it = std::upper_bound(cumulative_.begin(), cumulative_.end(), target);
+  if (it == cumulative_.end()) {
+    --it;
+  }
+  return size_[static_cast<size_t>(it - cumulative_.begin())];
+}
+
+uint64_t SizeRecord::time(uint64_t n) const {
+  if (!series()) {
+    return 0;
+  }
+  return (n / index_.size()) * period_ + index_[n % index_.size()];
+}
+
+double SizeRecord::mean_size() const {
+  double sum = 0;
+  double count = 0;
+  for (size_t i = 0; i < size_.size(); ++i) {
+    double weight =
+        series() ? 1.0
+                 : static_cast<double>(cumulative_[i] -
+                                       (i > 0 ? cumulative_[i - 1] : 0));
+    sum += weight * size_[i];
+    count += weight;
+  }
+  return sum / count;
+}
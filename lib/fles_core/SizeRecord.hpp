@@ -0,0 +1,73 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Recorded microslice sizes of a data source.
+/** A SizeRecord object describes the sizes of the microslices of a
+    recorded data source (e.g., extracted from an archive by the
+    MicrosliceAnalyzer) to be reproduced by a pattern generator. It is
+    either a time series or a histogram.
+
+    A time series holds the index (in ns) and the size of each recorded
+    microslice. It is replayed in order, including its rate and spill
+    structure, and repeats itself with a period of its index range plus
+    the mean index step. A histogram holds the relative frequency of
+    sizes, from which the sizes are drawn by quantile.
+
+    In text form, each line of a time series holds a microslice as
+    `<index> <size>`. Each line of a histogram holds a bin as `histogram
+    <size> <count>`. Empty lines and text following a `#` are ignored. */
+
+class SizeRecord {
+public:
+  /// Parse a record in text form.
+  static SizeRecord parse(std::istream& is);
+
+  /// Read a record in text form from a file.
+  static SizeRecord read(const std::string& path);
+
+  /// Write a microslice of a time series in text form.
+  static void write(std::ostream& os, uint64_t index, uint32_t size) {
+    os << index << ' ' << size << '\n';
+  }
+
+  /// Whether the record is a time series.
+  [[nodiscard]] bool series() const { return !index_.empty(); }
+
+  /// Retrieve the size of a microslice of the generated sequence.
+  /**
+     \param n        Number of the microslice in the generated sequence
+     \param quantile Quantile (0 to 1) to draw a size from a histogram
+  */
+  [[nodiscard]] uint32_t size(uint64_t n, double quantile) const;
+
+  /// Retrieve the time of a microslice of a time series relative to the
+  /// first one (ns).
+  [[nodiscard]] uint64_t time(uint64_t n) const;
+
+  /// Retrieve the period of a time series (ns, 0: histogram).
+  [[nodiscard]] uint64_t period() const { return period_; }
+
+  /// Retrieve the mean microslice size.
+  [[nodiscard]] double mean_size() const;
+
+  /// Retrieve the number of recorded microslices (or histogram bins).
+  [[nodiscard]] std::size_t entries() const { return size_.size(); }
+
+private:
+  SizeRecord() = default;
+
+  /// Microslice sizes (series) or bin sizes (histogram).
+  std::vector<uint32_t> size_;
+  /// Microslice indexes relative to the first one (series only).
+  std::vector<uint64_t> index_;
+  /// Cumulative bin counts (histogram only).
+  std::vector<uint64_t> cumulative_;
+  /// Index offset of each repetition of the series.
+  uint64_t period_ = 0;
+};
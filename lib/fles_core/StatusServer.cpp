@@ -0,0 +1,377 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "StatusServer.hpp"
+#include "System.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <regex>
+#include <stdexcept>
+
+// see MonitorSinkHttp.cpp
+#define BOOST_ERROR_CODE_HEADER_ONLY
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+namespace {
+using tcp = boost::asio::ip::tcp;
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+
+constexpr auto request_timeout = std::chrono::seconds(5);
+
+/// Append a string as a JSON string literal.
+void json_string(DumpBuffer& out, const std::string& s) {
+  out.append('"');
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out.append('\\').append(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out.append("\\u").hex(static_cast<unsigned char>(c), 4);
+    } else {
+      out.append(c);
+    }
+  }
+  out.append('"');
+}
+
+/// Append the name and tags of an entry as JSON members.
+void json_name_tags(DumpBuffer& out,
+                    const std::string& name,
+                    const cbm::MetricTagSet& tags) {
+  out.append("{\"name\":");
+  json_string(out, name);
+  out.append(",\"tags\":{");
+  for (size_t i = 0; i < tags.size(); ++i) {
+    if (i != 0) {
+      out.append(',');
+    }
+    json_string(out, tags[i].first);
+    out.append(':');
+    json_string(out, tags[i].second);
+  }
+  out.append('}');
+}
+
+} // namespace
+
+StatusServer* StatusServer::instance_ = nullptr;
+
+/// HTTP listener state, used by the server thread.
+struct StatusServer::Server {
+  boost::asio::io_context ioc;
+  tcp::acceptor acceptor{ioc};
+  boost::asio::steady_timer timer{ioc};
+  void accept(StatusServer& status);
+};
+
+/// A single status request, answered with a `Connection: close`.
+struct StatusServer::Session : public std::enable_shared_from_this<Session> {
+  Session(StatusServer& status, tcp::socket&& socket)
+      : status_(status), stream_(std::move(socket)) {}
+
+  void read();
+  void respond();
+
+  StatusServer& status_;
+  beast::tcp_stream stream_;
+  beast::flat_buffer buffer_;
+  http::request<http::empty_body> request_;
+  std::shared_ptr<const std::string> body_;
+  http::response<http::span_body<const char>> response_;
+};
+
+void StatusServer::Server::accept(StatusServer& status) {
+  acceptor.async_accept(
+      [this, &status](beast::error_code ec, tcp::socket socket) {
+        if (!ec) {
+          std::make_shared<Session>(status, std::move(socket))->read();
+        }
+        if (acceptor.is_open()) {
+          accept(status);
+        }
+      });
+}
+
+void StatusServer::Session::read() {
+  stream_.expires_after(request_timeout);
+  http::async_read(
+      stream_, buffer_, request_,
+      [self = shared_from_this()](beast::error_code ec, std::size_t) {
+        if (!ec) {
+          self->respond();
+        }
+      });
+}
+
+void StatusServer::Session::respond() {
+  std::string target(request_.target());
+  target = target.substr(0, target.find('?'));
+
+  response_.version(request_.version());
+  response_.keep_alive(false);
+  response_.set(http::field::server, "flesnet");
+  if (request_.method() == http::verb::post) {
+    std::string query(request_.target().substr(target.size()));
+    if (!query.empty()) {
+      query.erase(0, 1);
+    }
+    auto [status, text] = status_.run_command(target.substr(1), query);
+    body_ = std::make_shared<const std::string>(std::move(text));
+    response_.result(status);
+    response_.set(http::field::content_type, "text/plain");
+    response_.body() = {body_->data(), body_->size()};
+  } else if (request_.method() != http::verb::get) {
+    response_.result(http::status::method_not_allowed);
+  } else if (target != "/status") {
+    response_.result(http::status::not_found);
+  } else {
+    body_ = status_.snapshot();
+    response_.result(http::status::ok);
+    response_.set(http::field::content_type, "application/json");
+    response_.set(http::field::access_control_allow_origin, "*");
+    response_.body() = {body_->data(), body_->size()};
+  }
+  response_.prepare_payload();
+
+  http::async_write(
+      stream_, response_,
+      [self = shared_from_this()](beast::error_code, std::size_t) {
+        beast::error_code ec;
+        self->stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
+      });
+}
+
+StatusServer::StatusServer(const std::string& endpoint,
+                           std::chrono::milliseconds interval)
+    : interval_(interval), start_(std::chrono::steady_clock::now()),
+      previous_render_(start_),
+      hostname_(fles::system::current_hostname()),
+      snapshot_(std::make_shared<const std::string>("{}")),
+      server_(std::make_unique<Server>()) {
+  if (instance_ != nullptr) {
+    throw std::runtime_error("StatusServer: already instantiated");
+  }
+
+  std::regex re_endpoint(R"(^(?:(.+):)?([0-9]+)$)");
+  std::smatch match;
+  if (!std::regex_search(endpoint, match, re_endpoint)) {
+    throw std::runtime_error("StatusServer: endpoint not [host:]port: " +
+                             endpoint);
+  }
+  std::string host = match[1].matched ? match[1].str() : "0.0.0.0";
+  try {
+    tcp::resolver resolver(server_->ioc);
+    tcp::endpoint ep =
+        *resolver.resolve(host, match[2].str(), tcp::resolver::passive)
+             .begin();
+    auto& acceptor = server_->acceptor;
+    acceptor.open(ep.protocol());
+    acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor.bind(ep);
+    acceptor.listen();
+  } catch (std::exception const& e) {
+    throw std::runtime_error("StatusServer: listen on " + endpoint +
+                             " failed: " + e.what());
+  }
+
+  instance_ = this;
+  server_->accept(*this);
+  schedule_render();
+  thread_ = std::thread([this] { server_->ioc.run(); });
+}
+
+StatusServer::~StatusServer() {
+  server_->ioc.stop();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  instance_ = nullptr;
+}
+
+void StatusServer::add_buffer(const std::string& name,
+                              const cbm::MetricTagSet& tags,
+                              std::shared_ptr<BufferStatusSource> source) {
+  Buffer buffer{name, tags, std::move(source), {}, {}};
+  buffer.desc.acked = buffer.source->desc.acked.load(std::memory_order_relaxed);
+  buffer.data.acked = buffer.source->data.acked.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_.push_back(std::move(buffer));
+}
+
+void StatusServer::add_connections(const std::string& name,
+                                   const cbm::MetricTagSet& tags,
+                                   std::shared_ptr<ConnectionStatus> status) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  connections_.push_back({name, tags, std::move(status)});
+}
+
+void StatusServer::add_section(const std::string& name,
+                               std::function<void(DumpBuffer&)> render) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sections_.push_back({name, std::move(render)});
+}
+
+void StatusServer::add_command(
+    const std::string& name,
+    std::function<std::string(const CommandArguments&)> handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  commands_.push_back({name, std::move(handler)});
+}
+
+std::pair<unsigned, std::string>
+StatusServer::run_command(const std::string& name, const std::string& query) {
+  std::function<std::string(const CommandArguments&)> handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(commands_.begin(), commands_.end(),
+                           [&name](const Command& c) { return c.name == name; });
+    if (it == commands_.end()) {
+      return {404, "unknown command: " + name + "\n"};
+    }
+    handler = it->handler;
+  }
+  CommandArguments arguments;
+  for (const auto& argument : split(query, "&")) {
+    auto pos = argument.find('=');
+    if (pos == std::string::npos) {
+      arguments[argument] = "";
+    } else {
+      arguments[argument.substr(0, pos)] = argument.substr(pos + 1);
+    }
+  }
+  try {
+    return {200, handler(arguments) + "\n"};
+  } catch (std::invalid_argument const& e) {
+    return {400, std::string(e.what()) + "\n"};
+  }
+}
+
+uint16_t StatusServer::port() const {
+  return server_->acceptor.local_endpoint().port();
+}
+
+std::shared_ptr<const std::string> StatusServer::snapshot() {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  return snapshot_;
+}
+
+void StatusServer::schedule_render() {
+  server_->timer.expires_after(interval_);
+  server_->timer.async_wait([this](beast::error_code ec) {
+    if (!ec) {
+      render();
+      schedule_render();
+    }
+  });
+}
+
+void StatusServer::render() {
+  auto now = std::chrono::steady_clock::now();
+  double delta_t =
+      std::chrono::duration<double>(now - previous_render_).count();
+  previous_render_ = now;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // drop the entries no longer referenced by their publisher
+  buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                [](const Buffer& b) {
+                                  return b.source.use_count() == 1;
+                                }),
+                 buffers_.end());
+  connections_.erase(std::remove_if(connections_.begin(), connections_.end(),
+                                    [](const Connections& c) {
+                                      return c.status.use_count() == 1;
+                                    }),
+                     connections_.end());
+
+  out_.clear();
+  out_.append("{\"host\":");
+  json_string(out_, hostname_);
+  out_.append(",\"uptime_s\":")
+      .real(std::chrono::duration<double>(now - start_).count());
+
+  out_.append(",\"buffers\":[");
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    Buffer& b = buffers_[i];
+    out_.append(i != 0 ? "," : "");
+    json_name_tags(out_, b.name, b.tags);
+    out_.append(",\"desc\":");
+    render_positions(out_, b.source->desc,
+                     b.source->desc_size.load(std::memory_order_relaxed),
+                     b.desc, delta_t);
+    out_.append(",\"data\":");
+    render_positions(out_, b.source->data,
+                     b.source->data_size.load(std::memory_order_relaxed),
+                     b.data, delta_t);
+    out_.append('}');
+  }
+
+  out_.append("],\"connections\":[");
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    const ConnectionStatus& s = *connections_[i].status;
+    out_.append(i != 0 ? "," : "");
+    json_name_tags(out_, connections_[i].name, connections_[i].tags);
+    out_.append(",\"phase\":");
+    json_string(out_, s.phase.load(std::memory_order_relaxed));
+    out_.append(",\"connected\":")
+        .dec(s.connected.load(std::memory_order_relaxed))
+        .append(",\"timewait\":")
+        .dec(s.timewait.load(std::memory_order_relaxed))
+        .append(",\"expected\":")
+        .dec(s.expected.load(std::memory_order_relaxed))
+        .append('}');
+  }
+  out_.append(']');
+
+  for (const auto& section : sections_) {
+    out_.append(',');
+    json_string(out_, section.name);
+    out_.append(':');
+    section.render(out_);
+  }
+  out_.append("}\n");
+
+  auto snapshot = std::make_shared<const std::string>(out_.str());
+  std::lock_guard<std::mutex> snapshot_lock(snapshot_mutex_);
+  snapshot_ = std::move(snapshot);
+}
+
+void StatusServer::render_positions(DumpBuffer& out,
+                                    const BufferPositionCounters& counters,
+                                    uint64_t size,
+                                    Previous& previous,
+                                    double delta_t) {
+  // read the lower positions first, see BufferStatusSampler::sample()
+  uint64_t cached_acked = counters.cached_acked.load(std::memory_order_acquire);
+  uint64_t acked = counters.acked.load(std::memory_order_relaxed);
+  uint64_t sent = counters.sent.load(std::memory_order_relaxed);
+  uint64_t written = counters.written.load(std::memory_order_relaxed);
+  uint64_t end = cached_acked + size;
+  acked = std::min(std::max(acked, cached_acked), end);
+  sent = std::min(std::max(sent, acked), end);
+  written = std::min(std::max(written, sent), end);
+
+  auto percent = [size](uint64_t value) {
+    return size != 0 ? static_cast<double>(value) * 100 /
+                           static_cast<double>(size)
+                     : 0.;
+  };
+  double rate = delta_t > 0 && acked >= previous.acked
+                    ? static_cast<double>(acked - previous.acked) / delta_t
+                    : 0.;
+  previous.acked = acked;
+
+  out.append("{\"size\":").dec(size);
+  out.append(",\"written\":").dec(written);
+  out.append(",\"sent\":").dec(sent);
+  out.append(",\"acked\":").dec(acked);
+  out.append(",\"cached_acked\":").dec(cached_acked);
+  out.append(",\"used_pct\":").real(percent(written - sent));
+  out.append(",\"sending_pct\":").real(percent(sent - acked));
+  out.append(",\"freeing_pct\":").real(percent(acked - cached_acked));
+  out.append(",\"free_pct\":").real(percent(end - written));
+  out.append(",\"rate\":").real(rate);
+  out.append('}');
+}
@@ -0,0 +1,156 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the StatusServer class.
+#pragma once
+
+#include "BufferStatusSampler.hpp"
+#include "DumpBuffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// The published connection state of a transport worker.
+/** Written by the worker thread with relaxed stores only. The phase points
+    to a string literal. */
+struct ConnectionStatus {
+  std::atomic<const char*> phase{"init"};
+  std::atomic<uint32_t> connected{0};
+  std::atomic<uint32_t> timewait{0};
+  /// Number of connections of the complete setup
+  std::atomic<uint32_t> expected{0};
+};
+
+/// HTTP endpoint serving the current status of a process as JSON.
+/** A thread renders the status document at a fixed rate from the positions,
+    connection states and sections published by the other threads, and
+    answers each `GET /status` with the latest document. The publishing
+    threads only do relaxed atomic stores and never wait for the server, and
+    nothing is sent to the monitor, so that the status can be refreshed
+    several times per second without affecting the transport. Buffer rates
+    are derived from the acknowledged positions between two renders. A few
+    operator commands are accepted as `POST /<command>?<arguments>`. */
+class StatusServer {
+public:
+  /// The StatusServer constructor, listening on `[host:]port`.
+  /** Throws std::runtime_error if the endpoint is malformed or can't be
+      bound. Port 0 selects a free port, see port(). */
+  StatusServer(const std::string& endpoint,
+               std::chrono::milliseconds interval);
+
+  StatusServer(const StatusServer&) = delete;
+  void operator=(const StatusServer&) = delete;
+
+  ~StatusServer();
+
+  /// The status server of this process (nullptr if none exists).
+  static StatusServer* instance() { return instance_; }
+
+  /// Add a transport buffer.
+  /** The buffer is served for as long as the source is referenced
+      elsewhere, like in BufferStatusSampler. */
+  void add_buffer(const std::string& name,
+                  const cbm::MetricTagSet& tags,
+                  std::shared_ptr<BufferStatusSource> source);
+
+  /// Add the connection state of a transport worker.
+  /** Served for as long as the state is referenced elsewhere. */
+  void add_connections(const std::string& name,
+                       const cbm::MetricTagSet& tags,
+                       std::shared_ptr<ConnectionStatus> status);
+
+  /// Add a section rendered as a JSON value by the given function.
+  /** The function is called on the server thread and must only read data
+      that may be accessed concurrently, e.g., atomics. */
+  void add_section(const std::string& name,
+                   std::function<void(DumpBuffer&)> render);
+
+  /// The arguments of a command, from the query string of the request.
+  using CommandArguments = std::map<std::string, std::string>;
+
+  /// Add a command, invoked by a `POST /<name>` request.
+  /** The handler is called on the server thread and returns the response
+      text. Like a section, it must only access data that may be accessed
+      concurrently. If it throws std::invalid_argument, the request is
+      answered with status 400 and the message of the exception. */
+  void add_command(const std::string& name,
+                   std::function<std::string(const CommandArguments&)> handler);
+
+  /// Retrieve the port the server listens on.
+  [[nodiscard]] uint16_t port() const;
+
+  /// Retrieve the latest status document.
+  [[nodiscard]] std::shared_ptr<const std::string> snapshot();
+
+private:
+  struct Server;
+  struct Session;
+
+  /// The positions of a ring buffer at the previous render.
+  struct Previous {
+    uint64_t acked = 0;
+  };
+
+  struct Buffer {
+    std::string name;
+    cbm::MetricTagSet tags;
+    std::shared_ptr<BufferStatusSource> source;
+    Previous desc;
+    Previous data;
+  };
+
+  struct Connections {
+    std::string name;
+    cbm::MetricTagSet tags;
+    std::shared_ptr<ConnectionStatus> status;
+  };
+
+  struct Section {
+    std::string name;
+    std::function<void(DumpBuffer&)> render;
+  };
+
+  struct Command {
+    std::string name;
+    std::function<std::string(const CommandArguments&)> handler;
+  };
+
+  /// Run a command, returns the status code and the response text.
+  std::pair<unsigned, std::string> run_command(const std::string& name,
+                                               const std::string& query);
+
+  void schedule_render();
+  void render();
+
+  static void render_positions(DumpBuffer& out,
+                               const BufferPositionCounters& counters,
+                               uint64_t size,
+                               Previous& previous,
+                               double delta_t);
+
+  std::chrono::milliseconds interval_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point previous_render_;
+  std::string hostname_;
+
+  std::vector<Buffer> buffers_;
+  std::vector<Connections> connections_;
+  std::vector<Section> sections_;
+  std::vector<Command> commands_;
+  std::mutex mutex_;
+
+  DumpBuffer out_;
+  std::shared_ptr<const std::string> snapshot_;
+  std::mutex snapshot_mutex_;
+
+  std::unique_ptr<Server> server_;
+  std::thread thread_;
+
+  static StatusServer* instance_;
+};
@@ -0,0 +1,134 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Streaming quantile estimator class.
+/** A StreamingQuantile object estimates a quantile of a stream of values
+    in constant time and space per value, using the P-square algorithm
+    (Jain and Chlamtac, 1985). Five markers track the minimum, the maximum,
+    the quantile and the halfway quantiles on both sides. Their heights are
+    adjusted by piecewise-parabolic interpolation. */
+
+class StreamingQuantile {
+public:
+  /// The StreamingQuantile constructor.
+  /**
+     \param p Quantile to estimate (0 to 1)
+  */
+  explicit StreamingQuantile(double p)
+      : increment_{0.0, p / 2, p, (1 + p) / 2, 1.0} {
+    reset();
+  }
+
+  /// Discard all values.
+  void reset() {
+    count_ = 0;
+    for (std::size_t i = 0; i < markers; ++i) {
+      position_[i] = static_cast<int64_t>(i);
+      desired_[i] = 4 * increment_[i];
+    }
+  }
+
+  /// Add a value to the stream.
+  void add(double x) {
+    if (count_ < markers) {
+      height_[count_++] = x;
+      if (count_ == markers) {
+        std::sort(height_.begin(), height_.end());
+      }
+      return;
+    }
+    ++count_;
+
+    // find the cell of the value, extending the range if needed
+    std::size_t k = 0;
+    if (x < height_[0]) {
+      height_[0] = x;
+    } else if (x >= height_[markers - 1]) {
+      height_[markers - 1] = x;
+      k = markers - 2;
+    } else {
+      while (x >= height_[k + 1]) {
+        ++k;
+      }
+    }
+    for (std::size_t i = k + 1; i < markers; ++i) {
+      ++position_[i];
+    }
+    for (std::size_t i = 0; i < markers; ++i) {
+      desired_[i] += increment_[i];
+    }
+
+    // move the inner markers towards their desired positions
+    for (std::size_t i = 1; i < markers - 1; ++i) {
+      double d = desired_[i] - static_cast<double>(position_[i]);
+      if ((d >= 1 && position_[i + 1] - position_[i] > 1) ||
+          (d <= -1 && position_[i - 1] - position_[i] < -1)) {
+        int64_t s = d >= 0 ? 1 : -1;
+        double h = parabolic(i, s);
+        if (height_[i - 1] < h && h < height_[i + 1]) {
+          height_[i] = h;
+        } else {
+          height_[i] = linear(i, s);
+        }
+        position_[i] += s;
+      }
+    }
+  }
+
+  /// Retrieve the estimated quantile (0 if there are no values).
+  [[nodiscard]] double value() const {
+    if (count_ >= markers) {
+      return height_[2];
+    }
+    if (count_ == 0) {
+      return 0.0;
+    }
+    // few values are kept exactly, select the nearest rank
+    std::array<double, markers> sorted = height_;
+    std::sort(sorted.begin(), sorted.begin() + count_);
+    auto rank = static_cast<std::size_t>(
+        increment_[2] * static_cast<double>(count_ - 1) + 0.5);
+    return sorted[rank];
+  }
+
+  /// Retrieve the number of values added since the last reset.
+  [[nodiscard]] uint64_t count() const { return count_; }
+
+private:
+  static constexpr std::size_t markers = 5;
+
+  [[nodiscard]] double parabolic(std::size_t i, int64_t s) const {
+    auto n = [this](std::size_t j) {
+      return static_cast<double>(position_[j]);
+    };
+    auto ds = static_cast<double>(s);
+    return height_[i] +
+           ds / (n(i + 1) - n(i - 1)) *
+               ((n(i) - n(i - 1) + ds) * (height_[i + 1] - height_[i]) /
+                    (n(i + 1) - n(i)) +
+                (n(i + 1) - n(i) - ds) * (height_[i] - height_[i - 1]) /
+                    (n(i) - n(i - 1)));
+  }
+
+  [[nodiscard]] double linear(std::size_t i, int64_t s) const {
+    std::size_t j = s > 0 ? i + 1 : i - 1;
+    return height_[i] + static_cast<double>(s) * (height_[j] - height_[i]) /
+                            static_cast<double>(position_[j] - position_[i]);
+  }
+
+  /// Number of values added.
+  uint64_t count_ = 0;
+  /// Marker heights (the first values until there are enough of them).
+  std::array<double, markers> height_{};
+  /// Actual marker positions.
+  std::array<int64_t, markers> position_{};
+  /// Desired marker positions.
+  std::array<double, markers> desired_{};
+  /// Increments of the desired marker positions per value.
+  std::array<double, markers> increment_;
+};
@@ -13,13 +13,32 @@ void ThreadContainer::set_node() {
     return;
   }
 
-  struct bitmask* nodemask = numa_allocate_nodemask();
-  numa_bitmask_setbit(nodemask, 0);
-  if (numa_max_node() > 0) {
-    numa_bitmask_setbit(nodemask, 1);
+  numa_bind(numa_all_nodes_ptr);
+#else
+  L_(debug) << "set_node: built without libnuma";
+#endif
+}
+
+void ThreadContainer::set_node(int node) {
+  if (node < 0) {
+    return;
+  }
+#ifdef HAVE_NUMA
+  if (numa_available() == -1) {
+    L_(error) << "numa_available() failed";
+    return;
+  }
+  if (node > numa_max_node()) {
+    L_(debug) << "set_node: node " << node << " is not in range 0.."
+              << numa_max_node();
+    return;
+  }
+
+  if (numa_run_on_node(node) != 0) {
+    L_(error) << "set_node: could not run on node " << node;
+    return;
   }
-  numa_bind(nodemask);
-  numa_free_nodemask(nodemask);
+  numa_set_preferred(node);
 #else
   L_(debug) << "set_node: built without libnuma";
 #endif
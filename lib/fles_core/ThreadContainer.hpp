@@ -3,6 +3,10 @@
 
 class ThreadContainer {
 protected:
+  /// Bind the calling thread and its memory to all available NUMA nodes.
   static void set_node();
+  /// Run the calling thread on a NUMA node, preferring its memory.
+  /** A negative node number leaves the thread unchanged. */
+  static void set_node(int node);
   static void set_cpu(int n);
 };
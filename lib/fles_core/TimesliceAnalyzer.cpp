@@ -5,6 +5,7 @@
 #include "System.hpp"
 #include "TimesliceDebugger.hpp"
 #include "Utility.hpp"
+#include "WorkerPool.hpp"
 #include "log.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
@@ -46,11 +47,18 @@ TimesliceAnalyzer::TimesliceAnalyzer(uint64_t arg_output_interval,
                                      std::ostream& arg_out,
                                      std::string arg_output_prefix,
                                      std::ostream* arg_hist,
-                                     cbm::Monitor* monitor)
-    : output_interval_(arg_output_interval), out_(arg_out),
+                                     cbm::Monitor* monitor,
+                                     unsigned arg_num_threads,
+                                     bool arg_descriptors_only)
+    : descriptors_only_(arg_descriptors_only),
+      output_interval_(arg_output_interval), out_(arg_out),
       output_prefix_(std::move(arg_output_prefix)), hist_(arg_hist),
       previous_output_time_(std::chrono::system_clock::now()),
       monitor_(monitor) {
+  if (arg_num_threads > 1) {
+    worker_pool_ = std::make_unique<WorkerPool>(arg_num_threads);
+  }
+
   // create CRC-32C engine (Castagnoli polynomial)
   crc32_engine_ = crcutil_interface::CRC::Create(
       0x82f63b78, 0, 32, true, 0, 0, 0,
@@ -59,9 +67,18 @@ TimesliceAnalyzer::TimesliceAnalyzer(uint64_t arg_output_interval,
   hostname_ = fles::system::current_hostname();
 
   report_status();
+  scheduler_.add_repeating([this] { report_status(); },
+                           std::chrono::seconds(1));
 }
 
 TimesliceAnalyzer::~TimesliceAnalyzer() {
+  if (descriptors_only_ && !component_statistics_.empty()) {
+    print("microslice descriptor statistics:");
+    for (size_t c = 0; c < component_statistics_.size(); ++c) {
+      component_statistics_[c].write(out_, output_prefix_ + "  c" +
+                                               std::to_string(c) + ": ");
+    }
+  }
   if (crc32_engine_ != nullptr) {
     crc32_engine_->Delete();
   }
@@ -87,13 +104,18 @@ void TimesliceAnalyzer::put(std::shared_ptr<const fles::Timeslice> timeslice) {
 void TimesliceAnalyzer::initialize(const fles::Timeslice& ts) {
   start_index_ = ts.index();
   reference_descriptors_.clear();
+  reference_overlaps_.clear();
   pattern_checkers_.clear();
   for (size_t c = 0; c < ts.num_components(); ++c) {
     assert(ts.num_microslices(c) > 0);
-    fles::MicrosliceDescriptor desc = ts.get_microslice(c, 0).desc();
+    fles::MicrosliceDescriptor desc = ts.descriptor(c, 0);
     reference_descriptors_.push_back(desc);
-    pattern_checkers_.push_back(
-        PatternChecker::create(desc.sys_id, desc.sys_ver, c));
+    reference_overlaps_.push_back(ts.num_microslices(c) -
+                                  ts.num_core_microslices());
+    if (!descriptors_only_) {
+      pattern_checkers_.push_back(
+          PatternChecker::create(desc.sys_id, desc.sys_ver, c));
+    }
   }
 }
 
@@ -136,7 +158,7 @@ bool TimesliceAnalyzer::check_timeslice(const fles::Timeslice& ts) {
   std::optional<uint64_t> reference_start_time;
   for (size_t c = 0; c < ts.num_components(); ++c) {
     if (ts.num_microslices(c) > 0) {
-      const uint64_t component_start_time = ts.get_microslice(c, 0).desc().idx;
+      const uint64_t component_start_time = ts.descriptor(c, 0).idx;
       if (reference_start_time) {
         if (*reference_start_time != component_start_time) {
           start_time_mismatch = true;
@@ -159,36 +181,78 @@ bool TimesliceAnalyzer::check_timeslice(const fles::Timeslice& ts) {
     ts_success = false;
   }
 
-  // check the individual timeslice components
-  for (size_t c = 0; c < ts.num_components(); ++c) {
-    bool component_success = check_component(ts, c);
-    if (!component_success) {
-      ++component_error_count_;
-      ts_success = false;
+  // check the individual timeslice components, merge results in order
+  component_results_.resize(ts.num_components());
+  if (descriptors_only_) {
+    constexpr size_t max_streams_per_component = 16;
+    component_statistics_.resize(
+        ts.num_components(), MicrosliceStatistics(max_streams_per_component));
+  }
+  if (worker_pool_ && ts.num_components() > 1) {
+    // output is limited based on the error counts before this timeslice
+    worker_pool_->run(ts.num_components(), [&](size_t c) {
+      check_component(ts, c, component_results_[c]);
+    });
+    for (size_t c = 0; c < ts.num_components(); ++c) {
+      ts_success &= component_results_[c].success;
+      merge(component_results_[c]);
+    }
+  } else {
+    for (size_t c = 0; c < ts.num_components(); ++c) {
+      check_component(ts, c, component_results_[c]);
+      ts_success &= component_results_[c].success;
+      merge(component_results_[c]);
     }
   }
 
   return ts_success;
 }
 
-bool TimesliceAnalyzer::check_component(const fles::Timeslice& ts, size_t c) {
+void TimesliceAnalyzer::merge(ComponentResult& r) {
   ++component_count_;
+  if (!r.success) {
+    ++component_error_count_;
+  }
+  microslice_count_ += r.microslice_count;
+  microslice_error_count_ += r.microslice_error_count;
+  content_bytes_ += r.content_bytes;
+  out_ << r.out.str() << std::flush;
+  if (hist_ != nullptr) {
+    *hist_ << r.hist.str();
+  }
+  r.success = true;
+  r.microslice_count = 0;
+  r.microslice_error_count = 0;
+  r.content_bytes = 0;
+  r.out.str("");
+  r.hist.str("");
+}
+
+void TimesliceAnalyzer::check_component(const fles::Timeslice& ts,
+                                        size_t c,
+                                        ComponentResult& r) {
+  if (descriptors_only_) {
+    check_component_descriptors(ts, c, r);
+    return;
+  }
+
   bool component_success = true;
 
   if (ts.num_microslices(c) == 0) {
-    if (output_active()) {
+    if (output_active(r)) {
       auto location = location_string(ts.index(), c);
-      print("error in " + location + ": no microslices in component");
+      print(r, "error in " + location + ": no microslices in component");
     }
     component_success = false;
   }
 
   // check the individual microslices of the component
+  compute_crcs(ts, c, r);
   pattern_checkers_.at(c)->reset();
   for (size_t m = 0; m < ts.num_microslices(c); ++m) {
-    bool microslice_success = check_microslice(ts, c, m);
+    bool microslice_success = check_microslice(ts, c, m, r);
     if (!microslice_success) {
-      ++microslice_error_count_;
+      ++r.microslice_error_count;
       component_success = false;
     }
   }
@@ -198,12 +262,12 @@ bool TimesliceAnalyzer::check_component(const fles::Timeslice& ts, size_t c) {
     uint64_t first = ts.get_microslice(c, 0).desc().idx;
     uint64_t second = ts.get_microslice(c, 1).desc().idx;
     if (second <= first) {
-      if (output_active()) {
+      if (output_active(r)) {
         auto location = location_string(ts.index(), c);
-        print("error in " + location +
-              ": start time not increasing in first two microslices");
-        print_microslice_descriptor(ts, c, 0);
-        print_microslice_descriptor(ts, c, 1);
+        print(r, "error in " + location +
+                 ": start time not increasing in first two microslices");
+        print_microslice_descriptor(r, ts, c, 0);
+        print_microslice_descriptor(r, ts, c, 1);
       }
       component_success = false;
     } else {
@@ -212,13 +276,13 @@ bool TimesliceAnalyzer::check_component(const fles::Timeslice& ts, size_t c) {
         uint64_t this_start_time = ts.get_microslice(c, m).desc().idx;
         uint64_t expected_start_time = first + m * reference_delta;
         if (this_start_time != expected_start_time) {
-          if (output_active()) {
+          if (output_active(r)) {
             auto location = location_string(ts.index(), c, m);
-            print("error in " + location +
-                  ": unexpected microslice start time");
-            print_microslice_descriptor(ts, c, 0);
-            print_microslice_descriptor(ts, c, 1);
-            print_microslice_descriptor(ts, c, m);
+            print(r, "error in " + location +
+                     ": unexpected microslice start time");
+            print_microslice_descriptor(r, ts, c, 0);
+            print_microslice_descriptor(r, ts, c, 1);
+            print_microslice_descriptor(r, ts, c, m);
           }
           component_success = false;
         }
@@ -226,76 +290,206 @@ bool TimesliceAnalyzer::check_component(const fles::Timeslice& ts, size_t c) {
     }
   }
 
-  return component_success;
+  r.success = component_success;
+}
+
+/// Check a component using its microslice descriptors only.
+/** The contiguous descriptor array is checked in a single pass, and only
+    components found to contain errors are inspected again to report the
+    details. The same conditions as in check_component() are reported,
+    except for those requiring access to the content. */
+void TimesliceAnalyzer::check_component_descriptors(const fles::Timeslice& ts,
+                                                    size_t c,
+                                                    ComponentResult& r) {
+  const size_t n = ts.num_microslices(c);
+  if (n == 0) {
+    if (output_active(r)) {
+      auto location = location_string(ts.index(), c);
+      print(r, "error in " + location + ": no microslices in component");
+    }
+    r.success = false;
+    return;
+  }
+
+  bool component_success = true;
+  const fles::MicrosliceDescriptor* d = ts.descriptors(c);
+  const fles::MicrosliceDescriptor& ref = reference_descriptors_.at(c);
+
+  // number of microslices consistent with core size and overlap
+  const uint64_t core = ts.num_core_microslices();
+  if (n < core || n - core != reference_overlaps_.at(c)) {
+    if (output_active(r)) {
+      auto location = location_string(ts.index(), c);
+      print(r, "error in " + location + ": " + std::to_string(n) +
+                   " microslices, expected " + std::to_string(core) +
+                   " core and " + std::to_string(reference_overlaps_.at(c)) +
+                   " overlap microslices");
+    }
+    component_success = false;
+  }
+
+  const uint64_t first = d[0].idx;
+  const bool increasing = n < 2 || d[1].idx > first;
+  const uint64_t delta = increasing && n >= 2 ? d[1].idx - first : 0;
+  constexpr auto flim =
+      static_cast<uint16_t>(fles::MicrosliceFlags::OverflowFlim);
+
+  uint64_t bytes = 0;
+  size_t errors = 0;
+  size_t start_time_errors = 0;
+  for (size_t m = 0; m < n; ++m) {
+    const fles::MicrosliceDescriptor& dm = d[m];
+    bytes += dm.size;
+    bool error = (dm.hdr_id != 0xdd) | (dm.hdr_ver != 0x01) |
+                 (dm.eq_id != ref.eq_id) | (dm.sys_id != ref.sys_id) |
+                 (dm.sys_ver != ref.sys_ver) | ((dm.flags & flim) != 0);
+    errors += static_cast<size_t>(error);
+    start_time_errors += static_cast<size_t>(dm.idx != first + m * delta);
+  }
+  component_statistics_[c].add(d, n);
+
+  r.microslice_count += n;
+  r.content_bytes += bytes;
+
+  if (!increasing) {
+    if (output_active(r)) {
+      auto location = location_string(ts.index(), c);
+      print(r, "error in " + location +
+                   ": start time not increasing in first two microslices");
+      print_microslice_descriptor(r, ts, c, 0);
+      print_microslice_descriptor(r, ts, c, 1);
+    }
+    component_success = false;
+  } else if (start_time_errors != 0) {
+    component_success = false;
+  }
+
+  if (errors != 0 || (increasing && start_time_errors != 0)) {
+    for (size_t m = 0; m < n; ++m) {
+      const fles::MicrosliceDescriptor& dm = d[m];
+      bool header = dm.hdr_id != 0xdd || dm.hdr_ver != 0x01;
+      bool changed = dm.eq_id != ref.eq_id || dm.sys_id != ref.sys_id ||
+                     dm.sys_ver != ref.sys_ver;
+      bool truncated = (dm.flags & flim) != 0;
+      bool start_time = increasing && dm.idx != first + m * delta;
+      if (output_active(r)) {
+        auto location = location_string(ts.index(), c, m);
+        std::string message;
+        if (header) {
+          message = "unknown header format in microslice descriptor";
+        } else if (changed) {
+          message = "unexpected change in microslice descriptor";
+        } else if (truncated) {
+          message = "microslice truncated by FLIM";
+        } else if (start_time) {
+          message = "unexpected microslice start time";
+        }
+        if (!message.empty()) {
+          print(r, "error in " + location + ": " + message);
+          print_microslice_descriptor(r, ts, c, m);
+        }
+      }
+      if (header || changed || truncated) {
+        ++r.microslice_error_count;
+      }
+    }
+    component_success &= errors == 0;
+  }
+
+  if (hist_ != nullptr) {
+    for (size_t m = 0; m < n; ++m) {
+      const fles::MicrosliceDescriptor& dm = d[m];
+      bool truncated = (dm.flags & flim) != 0;
+      r.hist << c << " " << m << " " << dm.eq_id << " " << dm.flags << " "
+             << uint16_t(dm.sys_id) << " " << uint16_t(dm.sys_ver) << " "
+             << dm.idx << " " << dm.size << " " << truncated << " 0 0\n";
+    }
+  }
+
+  r.success = component_success;
 }
 
 bool TimesliceAnalyzer::check_microslice(const fles::Timeslice& ts,
                                          size_t c,
-                                         size_t m) {
+                                         size_t m,
+                                         ComponentResult& r) {
   auto mv = ts.get_microslice(c, m);
   auto& d = mv.desc();
 
-  ++microslice_count_;
-  content_bytes_ += d.size;
+  ++r.microslice_count;
+  r.content_bytes += d.size;
   bool error = false;
 
   // static descriptor checks
   if (d.hdr_id != 0xdd || d.hdr_ver != 0x01) {
     error = true;
-    if (output_active()) {
+    if (output_active(r)) {
       auto location = location_string(ts.index(), c, m);
-      print("error in " + location +
-            ": unknown header format in microslice descriptor");
-      print_microslice_descriptor(ts, c, m);
+      print(r, "error in " + location +
+               ": unknown header format in microslice descriptor");
+      print_microslice_descriptor(r, ts, c, m);
     }
   }
 
   // check descriptor consistency
-  auto r = reference_descriptors_.at(c);
-  if (d.eq_id != r.eq_id || d.sys_id != r.sys_id || d.sys_ver != r.sys_ver) {
+  const auto& ref = reference_descriptors_.at(c);
+  if (d.eq_id != ref.eq_id || d.sys_id != ref.sys_id ||
+      d.sys_ver != ref.sys_ver) {
     error = true;
-    if (output_active()) {
+    if (output_active(r)) {
       auto location = location_string(ts.index(), c, m);
-      print("error in " + location +
-            ": unexpected change in microslice descriptor");
-      print_microslice_descriptor(ts, c, m);
+      print(r, "error in " + location +
+               ": unexpected change in microslice descriptor");
+      print_microslice_descriptor(r, ts, c, m);
     }
   }
 
   bool truncated =
       (d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::OverflowFlim)) !=
       0;
-  if (truncated && output_active()) {
+  if (truncated && output_active(r)) {
     auto location = location_string(ts.index(), c, m);
-    print("error in " + location + ": microslice truncated by FLIM");
-    print_microslice_descriptor(ts, c, m);
-    print_microslice_content(ts, c, m);
+    print(r, "error in " + location + ": microslice truncated by FLIM");
+    print_microslice_descriptor(r, ts, c, m);
+    print_microslice_content(r, ts, c, m);
   }
 
-  bool pattern_error = !pattern_checkers_.at(c)->check(mv);
-  if (pattern_error && output_active()) {
+  const auto& checker = pattern_checkers_.at(c);
+  bool pattern_error = !checker->check(mv);
+  if (pattern_error && output_active(r)) {
     auto location = location_string(ts.index(), c, m);
-    print("error in " + location + ": pattern error");
-    print_microslice_descriptor(ts, c, m);
-    print_microslice_content(ts, c, m);
+    std::string details;
+    if (checker->error_count() != 0) {
+      details = " (" + std::to_string(checker->error_count()) +
+                " errors, first at offset " +
+                std::to_string(checker->first_error_offset()) + ")";
+    }
+    print(r, "error in " + location + ": pattern error" + details);
+    print_microslice_descriptor(r, ts, c, m);
+    print_microslice_content(r, ts, c, m);
   }
 
-  bool crc_error =
-      ((d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) !=
-       0) &&
-      !check_crc(mv);
-  if (crc_error && output_active()) {
+  bool crc_error = false;
+  if ((d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked)) !=
+      0) {
+    crc_error =
+        (d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::CrcError)) != 0;
+  } else if ((d.flags &
+              static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) != 0) {
+    crc_error = static_cast<uint32_t>(r.crcs[m]) != d.crc;
+  }
+  if (crc_error && output_active(r)) {
     auto location = location_string(ts.index(), c, m);
-    print("error in " + location + ": crc failure");
-    print_microslice_descriptor(ts, c, m);
-    print_microslice_content(ts, c, m);
+    print(r, "error in " + location + ": crc failure");
+    print_microslice_descriptor(r, ts, c, m);
+    print_microslice_content(r, ts, c, m);
   }
 
   error |= truncated || pattern_error || crc_error;
 
   // output ms stats
   if (hist_ != nullptr) {
-    *hist_ << c << " " << m << " " << d.eq_id << " " << d.flags << " "
+    r.hist << c << " " << m << " " << d.eq_id << " " << d.flags << " "
            << uint16_t(d.sys_id) << " " << uint16_t(d.sys_ver) << " " << d.idx
            << " " << d.size << " " << truncated << " " << pattern_error << " "
            << crc_error << "\n";
@@ -304,17 +498,32 @@ bool TimesliceAnalyzer::check_microslice(const fles::Timeslice& ts,
   return !error;
 }
 
-uint32_t TimesliceAnalyzer::compute_crc(const fles::MicrosliceView& m) const {
+/// Compute the content CRCs of all microslices of a component in one batch.
+/** The CRCs of independent microslices are computed interleaved, which is
+    considerably faster than one after the other for small microslices. */
+void TimesliceAnalyzer::compute_crcs(const fles::Timeslice& ts,
+                                     size_t c,
+                                     ComponentResult& r) const {
   assert(crc32_engine_);
 
-  crcutil_interface::UINT64 crc64 = 0;
-  crc32_engine_->Compute(m.content(), m.desc().size, &crc64);
-
-  return static_cast<uint32_t>(crc64);
-}
-
-bool TimesliceAnalyzer::check_crc(const fles::MicrosliceView& m) const {
-  return compute_crc(m) == m.desc().crc;
+  fles::ComponentView component = ts.component(c);
+  size_t count = component.size();
+  r.crc_data.resize(count);
+  r.crc_bytes.resize(count);
+  r.crcs.assign(count, 0);
+  for (size_t m = 0; m < count; ++m) {
+    const fles::MicrosliceDescriptor& desc = component.descriptor(m);
+    // CRCs already checked on the compute node are not computed again
+    bool crc_needed =
+        (desc.flags &
+         static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) != 0 &&
+        (desc.flags &
+         static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked)) == 0;
+    r.crc_data[m] = component.content(m);
+    r.crc_bytes[m] = crc_needed ? desc.size : 0;
+  }
+  crc32_engine_->ComputeBatch(r.crc_data.data(), r.crc_bytes.data(), count,
+                              r.crcs.data());
 }
 
 void TimesliceAnalyzer::print(std::string text, std::string prefix) {
@@ -328,6 +537,19 @@ void TimesliceAnalyzer::print(std::string text, std::string prefix) {
   }
 }
 
+void TimesliceAnalyzer::print(ComponentResult& r,
+                              std::string text,
+                              std::string prefix) {
+  if (text.back() == '\n') {
+    text.erase(text.end() - 1);
+  }
+  std::vector<std::string> lines;
+  boost::split(lines, text, [](char c) { return c == '\n'; });
+  for (auto const& line : lines) {
+    r.out << output_prefix_ << prefix << line << '\n';
+  }
+}
+
 void TimesliceAnalyzer::print_reference() {
   print("timeslice analyzer initialized with " +
         std::to_string(reference_descriptors_.size()) + " components");
@@ -343,22 +565,26 @@ void TimesliceAnalyzer::print_reference() {
   }
 }
 
-void TimesliceAnalyzer::print_microslice_descriptor(const fles::Timeslice& ts,
+void TimesliceAnalyzer::print_microslice_descriptor(ComponentResult& r,
+                                                    const fles::Timeslice& ts,
                                                     size_t c,
                                                     size_t m) {
   auto location = location_string(ts.index(), c, m);
-  print("microslice descriptor of " + location + ":");
-  print(boost::str(boost::format("%s") %
+  print(r, "microslice descriptor of " + location + ":");
+  print(r,
+        boost::str(boost::format("%s") %
                    MicrosliceDescriptorDump(ts.get_microslice(c, m).desc())),
         "  ");
 }
 
-void TimesliceAnalyzer::print_microslice_content(const fles::Timeslice& ts,
+void TimesliceAnalyzer::print_microslice_content(ComponentResult& r,
+                                                 const fles::Timeslice& ts,
                                                  size_t c,
                                                  size_t m) {
   auto location = location_string(ts.index(), c, m);
-  print("microslice content of " + location + ":");
-  print(boost::str(boost::format("%s") %
+  print(r, "microslice content of " + location + ":");
+  print(r,
+        boost::str(boost::format("%s") %
                    BufferDump(ts.get_microslice(c, m).content(),
                               ts.get_microslice(c, m).desc().size)),
         "  ");
@@ -396,10 +622,13 @@ bool TimesliceAnalyzer::output_active() const {
          microslice_error_count_ < limit;
 }
 
-void TimesliceAnalyzer::report_status() {
-  constexpr auto interval = std::chrono::seconds(1);
-  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+bool TimesliceAnalyzer::output_active(const ComponentResult& r) const {
+  constexpr size_t limit = 10;
+  return timeslice_error_count_ < limit && component_error_count_ < limit &&
+         microslice_error_count_ + r.microslice_error_count < limit;
+}
 
+void TimesliceAnalyzer::report_status() {
   if (monitor_) {
     const std::string prefix = output_prefix_.empty() ? ":" : output_prefix_;
     monitor_->QueueMetric(
@@ -413,6 +642,4 @@ void TimesliceAnalyzer::report_status() {
          {"component_error_count", component_error_count_},
          {"microslice_error_count", microslice_error_count_}});
   }
-
-  scheduler_.add([this] { report_status(); }, now + interval);
 }
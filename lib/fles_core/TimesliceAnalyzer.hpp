@@ -2,6 +2,7 @@
 #pragma once
 
 #include "MicrosliceDescriptor.hpp"
+#include "MicrosliceStatistics.hpp"
 #include "Monitor.hpp"
 #include "Scheduler.hpp"
 #include "Sink.hpp"
@@ -11,22 +12,50 @@
 #include <memory>
 #include <optional>
 #include <ostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 class PatternChecker;
+class WorkerPool;
 
+/// Consistency checker for timeslices.
+/** In descriptor-only mode, the microslice content is not accessed at all
+    (no pattern and CRC checks). The descriptor arrays of the components
+    are checked in a single pass each, and per-component size and flag
+    statistics are reported at the end. */
 class TimesliceAnalyzer : public fles::TimesliceSink {
 public:
   TimesliceAnalyzer(uint64_t arg_output_interval,
                     std::ostream& arg_out,
                     std::string arg_output_prefix,
                     std::ostream* arg_hist,
-                    cbm::Monitor* monitor);
+                    cbm::Monitor* monitor,
+                    unsigned arg_num_threads = 1,
+                    bool arg_descriptors_only = false);
   ~TimesliceAnalyzer() override;
 
   void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
 
 private:
+
+  /// Statistics and buffered output of the check of a single component.
+  /** Components are checked independently, possibly in parallel, and their
+      results merged in component order afterwards. */
+  struct ComponentResult {
+    bool success = true;
+    size_t microslice_count = 0;
+    size_t microslice_error_count = 0;
+    size_t content_bytes = 0;
+    std::ostringstream out;
+    std::ostringstream hist;
+    /// Content CRCs of the microslices (zero-size input if not CrcValid or
+    /// already CrcChecked)
+    std::vector<const void*> crc_data;
+    std::vector<size_t> crc_bytes;
+    std::vector<crcutil_interface::UINT64> crcs;
+  };
+
   void initialize(const fles::Timeslice& ts);
   void reset() {
     microslice_count_ = 0;
@@ -34,18 +63,31 @@ private:
   }
 
   [[nodiscard]] bool check_timeslice(const fles::Timeslice& ts);
-  [[nodiscard]] bool check_component(const fles::Timeslice& ts, size_t c);
-  [[nodiscard]] bool
-  check_microslice(const fles::Timeslice& ts, size_t c, size_t m);
+  void
+  check_component(const fles::Timeslice& ts, size_t c, ComponentResult& r);
+  void check_component_descriptors(const fles::Timeslice& ts,
+                                   size_t c,
+                                   ComponentResult& r);
+  [[nodiscard]] bool check_microslice(const fles::Timeslice& ts,
+                                      size_t c,
+                                      size_t m,
+                                      ComponentResult& r);
+  void merge(ComponentResult& r);
 
-  [[nodiscard]] uint32_t compute_crc(const fles::MicrosliceView& m) const;
-  [[nodiscard]] bool check_crc(const fles::MicrosliceView& m) const;
+  void
+  compute_crcs(const fles::Timeslice& ts, size_t c, ComponentResult& r) const;
 
   void print(std::string text, std::string prefix = "");
+  void print(ComponentResult& r, std::string text, std::string prefix = "");
   void print_reference();
-  void
-  print_microslice_descriptor(const fles::Timeslice& ts, size_t c, size_t m);
-  void print_microslice_content(const fles::Timeslice& ts, size_t c, size_t m);
+  void print_microslice_descriptor(ComponentResult& r,
+                                   const fles::Timeslice& ts,
+                                   size_t c,
+                                   size_t m);
+  void print_microslice_content(ComponentResult& r,
+                                const fles::Timeslice& ts,
+                                size_t c,
+                                size_t m);
 
   [[nodiscard]] std::string statistics() const;
 
@@ -55,12 +97,22 @@ private:
                   std::optional<size_t> m = std::nullopt) const;
 
   [[nodiscard]] bool output_active() const;
+  [[nodiscard]] bool output_active(const ComponentResult& r) const;
 
   crcutil_interface::CRC* crc32_engine_ = nullptr;
 
   uint64_t start_index_ = 0;
   std::vector<fles::MicrosliceDescriptor> reference_descriptors_;
+  std::vector<uint64_t> reference_overlaps_;
   std::vector<std::unique_ptr<PatternChecker>> pattern_checkers_;
+  std::vector<ComponentResult> component_results_;
+
+  /// Threads for checking components in parallel (if more than one).
+  std::unique_ptr<WorkerPool> worker_pool_;
+
+  bool descriptors_only_ = false;
+  /// Descriptor statistics per component (descriptor-only mode)
+  std::vector<MicrosliceStatistics> component_statistics_;
 
   uint64_t output_interval_ = UINT64_MAX;
   std::ostream& out_;
@@ -1,36 +1,122 @@
 // Copyright 2016-2020 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceBuffer.hpp"
+#include "CrcValidator.hpp"
+#include "ShmAttachmentCache.hpp"
+#include "TimesliceBufferPool.hpp"
+#include "TimesliceBufferStatus.hpp"
 #include "TimesliceDescriptor.hpp"
+#include "TimesliceEviction.hpp"
 #include "TimesliceShmWorkItem.hpp"
+#include "TimesliceStatistics.hpp"
 #include "TimesliceWorkItem.hpp"
 #include "Utility.hpp"
+#include "log.hpp"
+#include "probes.hpp"
+#include "tracing.hpp"
 #include <algorithm>
-#include <boost/archive/binary_oarchive.hpp>
+#include <boost/interprocess/managed_external_buffer.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <cassert>
+#include <cstring>
+#include <deque>
 #include <memory>
 
 namespace zmq {
 class context_t;
 }
 
+namespace {
+
+constexpr std::size_t page_size = 4096;
+
+// Size of the management data of a segment (upper bound)
+constexpr std::size_t overhead_size = 65536;
+
+} // namespace
+
+struct TimesliceBuffer::Validation {
+  explicit Validation(unsigned num_threads) : validator(num_threads) {}
+
+  CrcValidator validator;
+  /// Work items of the timeslices being validated, in order.
+  std::deque<fles::TimesliceWorkItem> items;
+};
+
+struct TimesliceBuffer::Eviction {
+  /// An evicted timeslice.
+  struct Evicted {
+    std::size_t entry;
+    std::chrono::steady_clock::time_point time;
+    /// Whether its buffer space has been released.
+    bool released = false;
+  };
+
+  Eviction(std::chrono::milliseconds timeout,
+           void* overflow_region,
+           std::size_t overflow_size,
+           fles::EvictionTable& table)
+      : timeout(timeout),
+        overflow(boost::interprocess::create_only, overflow_region,
+                 overflow_size),
+        table(table) {}
+
+  std::chrono::milliseconds timeout;
+  /// Allocator of the copies in the overflow region.
+  boost::interprocess::managed_external_buffer overflow;
+  fles::EvictionTable& table;
+  std::map<ItemID, Evicted> items;
+  uint64_t count = 0;
+  /// Whether an eviction has failed for lack of space.
+  bool full = false;
+};
+
+std::size_t TimesliceBuffer::region_size(uint32_t data_buffer_size_exp,
+                                         uint32_t desc_buffer_size_exp,
+                                         uint32_t num_input_nodes,
+                                         const TimesliceBufferMemory& memory) {
+  std::size_t data_size = (UINT64_C(1) << data_buffer_size_exp) *
+                          num_input_nodes;
+  std::size_t desc_size = (UINT64_C(1) << desc_buffer_size_exp) *
+                          num_input_nodes *
+                          sizeof(fles::TimesliceComponentDescriptor);
+  const std::size_t alignment = memory.hugepages ? huge_page_size : page_size;
+  // A data region in GPU memory is not part of the shared memory segment
+  const std::size_t shm_data_size = memory.device >= 0 ? 0 : data_size;
+  std::size_t size = shm_data_size + desc_size + 2 * alignment;
+  if (memory.overflow_size != 0) {
+    size += memory.overflow_size + alignment + sizeof(fles::EvictionTable);
+  }
+  return size;
+}
+
 TimesliceBuffer::TimesliceBuffer(zmq::context_t& context,
                                  const std::string& distributor_address,
                                  std::string shm_identifier,
                                  uint32_t data_buffer_size_exp,
                                  uint32_t desc_buffer_size_exp,
-                                 uint32_t num_input_nodes)
+                                 uint32_t num_input_nodes,
+                                 TimesliceBufferMemory memory,
+                                 std::shared_ptr<TimesliceBufferPool> pool)
     : ItemProducer(context, distributor_address),
       shm_identifier_(std::move(shm_identifier)),
       data_buffer_size_exp_(data_buffer_size_exp),
       desc_buffer_size_exp_(desc_buffer_size_exp),
-      num_input_nodes_(num_input_nodes) {
+      num_input_nodes_(num_input_nodes), memory_(memory),
+      pool_(std::move(pool)), completed_(desc_buffer_size_exp) {
   boost::uuids::random_generator uuid_gen;
-  shm_uuid_ = uuid_gen();
+  shm_uuid_ = pool_ ? pool_->uuid() : uuid_gen();
+
+  create_regions();
 
+  status_ = std::make_unique<TimesliceBufferStatus>(
+      shm_identifier_, num_input_nodes_, UINT64_C(1) << desc_buffer_size_exp_,
+      UINT64_C(1) << data_buffer_size_exp_);
+}
+
+void TimesliceBuffer::create_regions() {
   boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
 
   std::size_t data_size =
@@ -42,8 +128,22 @@ TimesliceBuffer::TimesliceBuffer(zmq::context_t& context,
                           sizeof(fles::TimesliceComponentDescriptor);
   assert(desc_size != 0);
 
-  constexpr size_t overhead_size = 4096; // Wild guess, let's hope it's enough
-  size_t managed_shm_size = data_size + desc_size + overhead_size;
+  // Both regions are page-aligned (huge page-aligned if requested), so that
+  // placement options can be applied to them
+  const std::size_t alignment = memory_.hugepages ? huge_page_size : page_size;
+
+  const bool on_device = memory_.device >= 0;
+  if (on_device) {
+    device_data_ =
+        std::make_unique<fles::DeviceMemory>(memory_.device, data_size);
+  }
+
+  // Upper bound for the managed segment size, trimmed after allocation
+  size_t managed_shm_size =
+      (pool_ ? 0
+             : region_size(data_buffer_size_exp_, desc_buffer_size_exp_,
+                           num_input_nodes_, memory_)) +
+      overhead_size;
 
   managed_shm_ = std::make_unique<boost::interprocess::managed_shared_memory>(
       boost::interprocess::create_only, shm_identifier_.c_str(),
@@ -52,40 +152,403 @@ TimesliceBuffer::TimesliceBuffer(zmq::context_t& context,
   managed_shm_->construct<boost::uuids::uuid>(
       boost::interprocess::unique_instance)(shm_uuid_);
 
-  data_ptr_ = static_cast<uint8_t*>(managed_shm_->allocate(data_size));
-  desc_ptr_ = reinterpret_cast<fles::TimesliceComponentDescriptor*>(
-      managed_shm_->allocate(desc_size));
+  // The regions of a pooled buffer are located in the pool segment
+  boost::interprocess::managed_shared_memory& region_shm =
+      pool_ ? pool_->shm() : *managed_shm_;
+  if (pool_) {
+    const std::string& pool_identifier = pool_->identifier();
+    const std::size_t length = pool_identifier.size();
+    managed_shm_->construct_it<char>(fles::shm_pool_reference)[length](
+        pool_identifier.data());
+  }
+
+  if (!on_device) {
+    data_handle_ = allocate_region(region_shm, data_size, alignment);
+  }
+  desc_handle_ = allocate_region(region_shm, desc_size, alignment);
+  if (memory_.overflow_size != 0) {
+    overflow_handle_ =
+        allocate_region(region_shm, memory_.overflow_size, alignment);
+    region_shm.construct<fles::EvictionTable>(
+        fles::eviction_table_name(shm_identifier_).c_str())();
+  }
+
+  // Trim the segment to the size actually used, which requires remapping it
+  managed_shm_ = nullptr;
+  boost::interprocess::managed_shared_memory::shrink_to_fit(
+      shm_identifier_.c_str());
+  managed_shm_ = std::make_unique<boost::interprocess::managed_shared_memory>(
+      boost::interprocess::open_only, shm_identifier_.c_str());
+  boost::interprocess::managed_shared_memory& shm =
+      pool_ ? pool_->shm() : *managed_shm_;
+
+  desc_ptr_ = static_cast<fles::TimesliceComponentDescriptor*>(
+      shm.get_address_from_handle(desc_handle_));
+  place_memory(desc_ptr_, desc_size, memory_);
+
+  if (on_device) {
+    data_ptr_ = device_data_->ptr();
+  } else {
+    data_ptr_ = static_cast<uint8_t*>(
+        shm.get_address_from_handle(data_handle_));
+    place_memory(data_ptr_, data_size, memory_);
+  }
+
+  const std::size_t host_size =
+      desc_size + (on_device ? 0 : data_size) + memory_.overflow_size;
+  const int numa_node = memory_.numa_node >= 0
+                            ? memory_.numa_node
+                            : numa_node_of_memory(desc_ptr_);
+  reserved_account_ = MemoryAccount("timeslice_buffer", MemoryUse::Reserved,
+                                    host_size, numa_node);
+  if (memory_.prefault || memory_.lock) {
+    committed_account_ = MemoryAccount(
+        "timeslice_buffer", MemoryUse::Committed, host_size, numa_node);
+  }
+}
+
+void TimesliceBuffer::resize(uint32_t data_buffer_size_exp,
+                             uint32_t desc_buffer_size_exp) {
+  if (!resizable()) {
+    throw std::runtime_error("timeslice buffer " + shm_identifier_ +
+                             ": resizing requires a buffer in its own host "
+                             "shared memory without overflow region");
+  }
+  if (!outstanding_.empty()) {
+    throw std::runtime_error("timeslice buffer " + shm_identifier_ +
+                             ": resizing requires a drained buffer");
+  }
+
+  // the consumers keep the previous segment mapped until they switch to
+  // the new one, identified by its uuid in the work items
+  managed_shm_ = nullptr;
+  reserved_account_ = MemoryAccount();
+  committed_account_ = MemoryAccount();
+  data_buffer_size_exp_ = data_buffer_size_exp;
+  desc_buffer_size_exp_ = desc_buffer_size_exp;
+  boost::uuids::random_generator uuid_gen;
+  shm_uuid_ = uuid_gen();
+  create_regions();
+
+  completed_ = CompletionBitmap(desc_buffer_size_exp_, completed_.completed());
+  status_->resize(UINT64_C(1) << desc_buffer_size_exp_,
+                  UINT64_C(1) << data_buffer_size_exp_);
+  L_(info) << "timeslice buffer resized: " << description();
 }
 
 TimesliceBuffer::~TimesliceBuffer() {
+  if (validation_) {
+    L_(info) << "timeslice buffer " << shm_identifier_ << ": "
+             << validation_->validator.checked()
+             << " microslice CRCs checked, "
+             << validation_->validator.errors() << " errors";
+  }
+  if (eviction_) {
+    L_(info) << "timeslice buffer " << shm_identifier_ << ": "
+             << eviction_->count << " timeslices evicted";
+  }
   boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
 }
 
+void TimesliceBuffer::enable_crc_validation(unsigned num_threads) {
+  if (device_data_) {
+    throw std::runtime_error(
+        "CRC validation requires the data buffer in host memory");
+  }
+  validation_ = std::make_unique<Validation>(num_threads);
+}
+
+uint64_t TimesliceBuffer::crc_checked() const {
+  return validation_ ? validation_->validator.checked() : 0;
+}
+
+uint64_t TimesliceBuffer::crc_errors() const {
+  return validation_ ? validation_->validator.errors() : 0;
+}
+
+void TimesliceBuffer::enable_eviction(std::chrono::milliseconds timeout) {
+  if (memory_.overflow_size == 0) {
+    throw std::runtime_error("eviction requires an overflow region");
+  }
+  if (device_data_) {
+    throw std::runtime_error(
+        "eviction requires the data buffer in host memory");
+  }
+  auto* table = region_shm()
+                    .find<fles::EvictionTable>(
+                        fles::eviction_table_name(shm_identifier_).c_str())
+                    .first;
+  assert(table != nullptr);
+  eviction_ = std::make_unique<Eviction>(
+      timeout, region_shm().get_address_from_handle(overflow_handle_),
+      memory_.overflow_size, *table);
+}
+
+uint64_t TimesliceBuffer::evicted() const {
+  return eviction_ ? eviction_->count : 0;
+}
+
 void TimesliceBuffer::send_work_item(fles::TimesliceWorkItem wi) {
+  if (!validation_) {
+    dispatch_work_item(wi);
+    return;
+  }
+
+  const auto ts_pos = wi.ts_desc.ts_pos;
+  std::vector<CrcValidator::Component> components;
+  for (uint32_t c = 0; c < wi.ts_desc.num_components; ++c) {
+    const fles::TimesliceComponentDescriptor& tsc_desc = get_desc(c, ts_pos);
+    components.push_back(
+        {reinterpret_cast<fles::MicrosliceDescriptor*>(
+             &get_data(c, tsc_desc.offset)),
+         tsc_desc.num_microslices});
+  }
+  // counted as outstanding while being validated
+  outstanding_[ts_pos];
+  validation_->items.push_back(wi);
+  validation_->validator.submit(ts_pos, std::move(components));
+}
+
+void TimesliceBuffer::send_validated() {
+  ItemID id = 0;
+  while (validation_->validator.try_get(id)) {
+    fles::TimesliceWorkItem wi = validation_->items.front();
+    validation_->items.pop_front();
+    assert(wi.ts_desc.ts_pos == id);
+    dispatch_work_item(wi);
+  }
+}
+
+void TimesliceBuffer::dispatch_work_item(const fles::TimesliceWorkItem& wi) {
+  tracing::Scope trace_scope("send_work_item", wi.ts_desc.ts_pos);
   // Create and fill new TimesliceShmWorkItem to be sent via zmq
   fles::TimesliceShmWorkItem item;
-  item.shm_uuid = shm_uuid_;
-  item.shm_identifier = shm_identifier_;
   item.ts_desc = wi.ts_desc;
   const auto num_components = item.ts_desc.num_components;
   const auto ts_pos = item.ts_desc.ts_pos;
-  item.data.resize(num_components);
-  item.desc.resize(num_components);
+  uint64_t bytes = 0;
   for (uint32_t c = 0; c < num_components; ++c) {
-    fles::TimesliceComponentDescriptor* tsc_desc = &get_desc(c, ts_pos);
-    uint8_t* tsc_data = &get_data(c, tsc_desc->offset);
-    item.data[c] = managed_shm_->get_handle_from_address(tsc_data);
-    item.desc[c] = managed_shm_->get_handle_from_address(tsc_desc);
+    add_component(item, c, ts_pos);
+    bytes += get_desc(c, ts_pos).size;
   }
+  sent_components_ += num_components;
+  sent_bytes_ += bytes;
+  if (statistics_ != nullptr) {
+    statistics_->add(item.ts_desc.index, bytes);
+  }
+  FLES_PROBE(send_work_item, item.ts_desc.index, ts_pos, bytes);
 
-  std::ostringstream ostream;
-  {
-    boost::archive::binary_oarchive oarchive(ostream);
-    oarchive << item;
+  item.encode(work_item_buffer_);
+  Outstanding& outstanding = outstanding_[ts_pos];
+  ++outstanding.items;
+  outstanding.complete = true;
+  outstanding.num_components = num_components;
+  if (eviction_) {
+    outstanding.sent = std::chrono::steady_clock::now();
   }
+  ItemProducer::send_work_item(ts_pos, work_item_buffer_);
+}
 
-  outstanding_.insert(ts_pos);
-  ItemProducer::send_work_item(ts_pos, ostream.str());
+void TimesliceBuffer::enable_component_items(
+    zmq::context_t& context, const std::string& distributor_address) {
+  component_producer_ =
+      std::make_unique<ItemProducer>(context, distributor_address);
+}
+
+void TimesliceBuffer::send_component_item(uint_fast16_t component,
+                                          uint64_t ts_pos,
+                                          uint32_t num_core_microslices) {
+  assert(component_producer_);
+  fles::TimesliceShmWorkItem item;
+  item.ts_desc = {get_desc(component, ts_pos).ts_num, ts_pos,
+                  num_core_microslices, 1};
+  add_component(item, component, ts_pos);
+
+  item.encode(work_item_buffer_);
+  ++outstanding_[ts_pos].items;
+  component_producer_->send_work_item(ts_pos * num_input_nodes_ + component,
+                                      work_item_buffer_);
+}
+
+void TimesliceBuffer::add_component(fles::TimesliceShmWorkItem& item,
+                                    uint_fast16_t component,
+                                    uint64_t ts_pos) {
+  item.shm_uuid = shm_uuid_;
+  item.data_base = data_handle_;
+  item.desc_base = desc_handle_;
+  if (device_data_) {
+    item.data_device = device_data_->device();
+    item.data_device_handle = device_data_->handle();
+  }
+  // the data region is not accessed, it may be located on a device
+  const uint64_t data_buffer_size = UINT64_C(1) << data_buffer_size_exp_;
+  fles::TimesliceComponentDescriptor* tsc_desc = &get_desc(component, ts_pos);
+  item.data.push_back(component * data_buffer_size +
+                      (tsc_desc->offset & (data_buffer_size - 1)));
+  item.desc.push_back(static_cast<uint64_t>(tsc_desc - desc_ptr_));
+}
+
+std::size_t TimesliceBuffer::receive_completions(
+    const std::function<void(uint64_t ts_pos)>& on_completion) {
+  if (validation_) {
+    send_validated();
+  }
+  std::size_t count = 0;
+  uint64_t ts_pos = 0;
+  while (receive_completion(ts_pos)) {
+    completed_.set(ts_pos);
+    if (on_completion) {
+      on_completion(ts_pos);
+    }
+    ++count;
+  }
+  if (count != 0) {
+    completed_.advance();
+  }
+  return count;
+}
+
+bool TimesliceBuffer::receive_completion(uint64_t& ts_pos) {
+  ItemID id;
+  while (ItemProducer::try_receive_completion(&id)) {
+    if (release_item(id)) {
+      ts_pos = id;
+      return true;
+    }
+  }
+  while (component_producer_ &&
+         component_producer_->try_receive_completion(&id)) {
+    if (release_item(id / num_input_nodes_)) {
+      ts_pos = id / num_input_nodes_;
+      return true;
+    }
+  }
+  return eviction_ && evict(ts_pos);
+}
+
+bool TimesliceBuffer::release_item(uint64_t ts_pos) {
+  auto it = outstanding_.find(ts_pos);
+  if (it == outstanding_.end()) {
+    std::cerr << "Error: invalid item " << ts_pos << std::endl;
+    return false;
+  }
+  if (--it->second.items > 0 || !it->second.complete) {
+    return false;
+  }
+  outstanding_.erase(it);
+  return !eviction_ || !release_copy(ts_pos);
+}
+
+boost::interprocess::managed_shared_memory& TimesliceBuffer::region_shm() {
+  return pool_ ? pool_->shm() : *managed_shm_;
+}
+
+bool TimesliceBuffer::evict(uint64_t& ts_pos) {
+  Eviction& eviction = *eviction_;
+  const auto now = std::chrono::steady_clock::now();
+
+  // the work items have been sent in order of their position
+  for (const auto& [pos, outstanding] : outstanding_) {
+    if (!outstanding.complete) {
+      continue;
+    }
+    if (now - outstanding.sent < eviction.timeout) {
+      break;
+    }
+    // the components of the timeslice may be in use on their own
+    if (outstanding.items != 1 || eviction.items.count(pos) != 0) {
+      continue;
+    }
+    if (!copy_out(pos, outstanding.num_components)) {
+      if (!eviction.full) {
+        L_(warning) << "timeslice buffer " << shm_identifier_
+                    << ": overflow region full, eviction postponed";
+        eviction.full = true;
+      }
+      break;
+    }
+    eviction.full = false;
+  }
+
+  for (auto& [pos, evicted] : eviction.items) {
+    if (evicted.released) {
+      continue;
+    }
+    const fles::EvictionEntry& entry = eviction.table[evicted.entry];
+    if (entry.state.load(std::memory_order_acquire) ==
+            fles::EvictionState::Switched ||
+        now - evicted.time >= eviction.timeout) {
+      evicted.released = true;
+      ts_pos = pos;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TimesliceBuffer::copy_out(uint64_t ts_pos, uint32_t num_components) {
+  Eviction& eviction = *eviction_;
+  auto free_entry = std::find_if(
+      eviction.table.begin(), eviction.table.end(),
+      [](const fles::EvictionEntry& e) {
+        return e.ts_pos_plus_one.load(std::memory_order_relaxed) == 0;
+      });
+  if (free_entry == eviction.table.end()) {
+    return false;
+  }
+
+  // the data of each component is 8-byte aligned in the copy
+  auto aligned = [](uint64_t size) { return (size + 7) & ~UINT64_C(7); };
+  std::size_t size = fles::EvictedTimeslice::header_size(num_components);
+  for (uint32_t c = 0; c < num_components; ++c) {
+    size += aligned(get_desc(c, ts_pos).size);
+  }
+  auto* copy = static_cast<uint8_t*>(
+      eviction.overflow.allocate(size, std::nothrow));
+  if (copy == nullptr) {
+    return false;
+  }
+
+  tracing::Scope trace_scope("evict", ts_pos);
+  fles::TimesliceComponentDescriptor* descs =
+      fles::EvictedTimeslice::descriptors(copy);
+  uint64_t* offsets =
+      fles::EvictedTimeslice::data_offsets(copy, num_components);
+  uint64_t offset = fles::EvictedTimeslice::header_size(num_components);
+  for (uint32_t c = 0; c < num_components; ++c) {
+    const fles::TimesliceComponentDescriptor& desc = get_desc(c, ts_pos);
+    descs[c] = desc;
+    offsets[c] = offset;
+    std::memcpy(copy + offset, &get_data(c, desc.offset), desc.size);
+    offset += aligned(desc.size);
+  }
+
+  free_entry->copy = region_shm().get_handle_from_address(copy);
+  free_entry->state.store(fles::EvictionState::Published,
+                          std::memory_order_relaxed);
+  free_entry->ts_pos_plus_one.store(ts_pos + 1, std::memory_order_release);
+
+  const auto entry =
+      static_cast<std::size_t>(free_entry - eviction.table.begin());
+  eviction.items[ts_pos] = {entry, std::chrono::steady_clock::now()};
+  ++eviction.count;
+  return true;
+}
+
+bool TimesliceBuffer::release_copy(uint64_t ts_pos) {
+  Eviction& eviction = *eviction_;
+  auto it = eviction.items.find(ts_pos);
+  if (it == eviction.items.end()) {
+    return false;
+  }
+  fles::EvictionEntry& entry = eviction.table[it->second.entry];
+  eviction.overflow.deallocate(
+      region_shm().get_address_from_handle(entry.copy));
+  entry.state.store(fles::EvictionState::Free, std::memory_order_relaxed);
+  entry.ts_pos_plus_one.store(0, std::memory_order_release);
+  const bool released = it->second.released;
+  eviction.items.erase(it);
+  return released;
 }
 
 std::string TimesliceBuffer::description() const {
@@ -101,5 +564,25 @@ std::string TimesliceBuffer::description() const {
                      human_readable_count(data_buffer_size) + " + " +
                      human_readable_count(desc_buffer_size) +
                      ") = " + human_readable_count(overall_size);
+  if (pool_) {
+    desc += ", pool: " + pool_->identifier();
+  } else {
+    desc += ", segment: " + human_readable_count(managed_shm_->get_size());
+  }
+  if (memory_.hugepages) {
+    desc += ", huge pages";
+  }
+  if (memory_.numa_node >= 0) {
+    desc += ", NUMA node " + std::to_string(memory_.numa_node);
+  }
+  if (memory_.prefault) {
+    desc += ", prefaulted";
+  }
+  if (device_data_) {
+    desc += ", data on GPU " + std::to_string(memory_.device);
+    if (device_data_->dmabuf_fd() >= 0) {
+      desc += " (dma-buf)";
+    }
+  }
   return desc;
 }
@@ -1,25 +1,44 @@
 // Copyright 2016-2020 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "CompletionBitmap.hpp"
+#include "DeviceMemory.hpp"
 #include "ItemProducer.hpp"
+#include "MemoryAccounting.hpp"
+#include "MemoryPlacement.hpp"
 #include "TimesliceCompletion.hpp"
 #include "TimesliceComponentDescriptor.hpp"
 #include <boost/interprocess/interprocess_fwd.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
-#include <set>
 #include <stdexcept>
 #include <string>
 
 namespace fles {
+struct TimesliceShmWorkItem;
 struct TimesliceWorkItem;
-}
+} // namespace fles
+class TimesliceBufferPool;
+class TimesliceBufferStatus;
+class TimesliceStatistics;
 namespace zmq {
 class context_t;
 }
 
+/// Memory placement options of a timeslice buffer.
+struct TimesliceBufferMemory : MemoryPlacement {
+  /// GPU to allocate the data region on (-1: host shared memory)
+  int device = -1;
+  /// Size of the overflow region for evicted timeslices (0: none)
+  std::size_t overflow_size = 0;
+};
+
 /// Timeslice buffer container class.
 /** A TimesliceBuffer object represents the compute node's timeslice buffer
    (filled by the input nodes). */
@@ -27,12 +46,16 @@ class context_t;
 class TimesliceBuffer : public ItemProducer {
 public:
   /// The TimesliceBuffer constructor.
+  /** If a pool is given, the regions are allocated from the pool segment,
+      and the shared memory of the buffer only refers to the pool. */
   TimesliceBuffer(zmq::context_t& context,
                   const std::string& distributor_address,
                   std::string shm_identifier,
                   uint32_t data_buffer_size_exp,
                   uint32_t desc_buffer_size_exp,
-                  uint32_t num_input_nodes);
+                  uint32_t num_input_nodes,
+                  TimesliceBufferMemory memory = {},
+                  std::shared_ptr<TimesliceBufferPool> pool = nullptr);
 
   TimesliceBuffer(const TimesliceBuffer&) = delete;
   void operator=(const TimesliceBuffer&) = delete;
@@ -40,6 +63,13 @@ public:
   /// The TimesliceBuffer destructor.
   ~TimesliceBuffer();
 
+  /// Retrieve the size of the regions of a buffer in a managed segment,
+  /// including their alignment.
+  static std::size_t region_size(uint32_t data_buffer_size_exp,
+                                 uint32_t desc_buffer_size_exp,
+                                 uint32_t num_input_nodes,
+                                 const TimesliceBufferMemory& memory);
+
   [[nodiscard]] uint32_t get_data_size_exp() const {
     return data_buffer_size_exp_;
   }
@@ -66,23 +96,97 @@ public:
     return get_desc_ptr(index)[offset];
   }
 
+  /// Check whether the buffer can be resized (see resize()).
+  [[nodiscard]] bool resizable() const {
+    return !pool_ && !device_data_ && memory_.overflow_size == 0;
+  }
+
+  /// Replace the regions by new ones of the given sizes.
+  /** The buffer must be drained, i.e., all timeslices written so far have
+      been completed. The positions continue in the new regions, which are
+      located in a new shared memory segment of the same name with a new
+      uuid. Throws std::runtime_error if not resizable() or not drained. */
+  void resize(uint32_t data_buffer_size_exp, uint32_t desc_buffer_size_exp);
+
+  /// Retrieve the data region if located in GPU memory (or nullptr).
+  [[nodiscard]] const fles::DeviceMemory* get_device_data() const {
+    return device_data_.get();
+  }
+
   [[nodiscard]] uint32_t get_num_input_nodes() const {
     return num_input_nodes_;
   }
 
   void send_work_item(fles::TimesliceWorkItem wi);
 
-  bool try_receive_completion(fles::TimesliceCompletion& c) {
-    ItemID id;
-    if (!ItemProducer::try_receive_completion(&id)) {
-      return false;
-    }
-    if (outstanding_.erase(id) != 1) {
-      std::cerr << "Error: invalid item " << id << std::endl;
-    }
-    c.ts_pos = id;
-    return true;
-  };
+  /// Announce the components of the timeslices as soon as they have been
+  /// written, as single-component work items sent to a second distributor.
+  void enable_component_items(zmq::context_t& context,
+                              const std::string& distributor_address);
+
+  /// Retrieve whether component work items are enabled.
+  [[nodiscard]] bool component_items() const {
+    return component_producer_ != nullptr;
+  }
+
+  /// Send the work item of a single component that has been written. The
+  /// timeslice is completed once this item has been completed, too.
+  void send_component_item(uint_fast16_t component,
+                           uint64_t ts_pos,
+                           uint32_t num_core_microslices);
+
+  /// Validate the microslice CRCs of each timeslice on the given number of
+  /// helper threads before sending its work item (see CrcValidator).
+  /** Early component work items are sent before validation. */
+  void enable_crc_validation(unsigned num_threads);
+
+  /// Retrieve the number of microslices with CRC checked so far.
+  [[nodiscard]] uint64_t crc_checked() const;
+
+  /// Retrieve the number of microslices found with a CRC mismatch.
+  [[nodiscard]] uint64_t crc_errors() const;
+
+  /// Copy timeslices whose work items have been outstanding for longer than
+  /// a given time to the overflow region and release their buffer space.
+  /** The consumer switches to the copy with its next call to
+      TimesliceReceiver::get(). The buffer space is released once it has
+      switched, or when the timeout has passed once more. Requires an
+      overflow region (see TimesliceBufferMemory). */
+  void enable_eviction(std::chrono::milliseconds timeout);
+
+  /// Retrieve the number of timeslices evicted so far.
+  [[nodiscard]] uint64_t evicted() const;
+
+  /// Retrieve the mean size of the timeslice components sent as work items
+  /// so far (0: none).
+  [[nodiscard]] double mean_component_size() const {
+    return sent_components_ != 0 ? static_cast<double>(sent_bytes_) /
+                                       static_cast<double>(sent_components_)
+                                 : 0;
+  }
+
+  /// Retrieve the status of the buffer published for inspection (see
+  /// TimesliceBufferStatus).
+  TimesliceBufferStatus& status() { return *status_; }
+
+  /// Record the timeslices sent as work items (if not nullptr).
+  void set_statistics(TimesliceStatistics* statistics) {
+    statistics_ = statistics;
+  }
+
+  /// Receive all available completions of timeslices, i.e., of their work
+  /// items and of all their component work items, and advance the
+  /// acknowledged position over the timeslices completed in order.
+  /** Sends the work items of validated timeslices (if CRC validation is
+      enabled), and reports the timeslices released by eviction (if
+      enabled) as completed. Calls the handler (if given) for each completed
+      timeslice.
+      \return The number of timeslices completed */
+  std::size_t receive_completions(
+      const std::function<void(uint64_t ts_pos)>& on_completion = {});
+
+  /// Retrieve the position up to which all timeslices have completed.
+  [[nodiscard]] uint64_t acked() const { return completed_.completed(); }
 
   // Remaining member functions are for backwards compatibility only
 
@@ -109,9 +213,87 @@ private:
   uint32_t data_buffer_size_exp_;
   uint32_t desc_buffer_size_exp_;
   uint32_t num_input_nodes_;
+  TimesliceBufferMemory memory_;
 
   std::unique_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
+  /// The pool the regions are allocated from (if any).
+  std::shared_ptr<TimesliceBufferPool> pool_;
+  std::unique_ptr<fles::DeviceMemory> device_data_;
   uint8_t* data_ptr_;
   fles::TimesliceComponentDescriptor* desc_ptr_;
-  std::set<ItemID> outstanding_;
+  std::ptrdiff_t data_handle_ = 0;
+  std::ptrdiff_t desc_handle_ = 0;
+  std::ptrdiff_t overflow_handle_ = 0;
+  /// The accounting of the regions in host memory.
+  MemoryAccount reserved_account_;
+  MemoryAccount committed_account_;
+  /// Work items of a timeslice that have not been completed yet.
+  struct Outstanding {
+    uint32_t items = 0;
+    /// Whether the work item of the whole timeslice has been sent.
+    bool complete = false;
+    /// The number of components of the timeslice.
+    uint32_t num_components = 0;
+    /// The time the work item of the whole timeslice has been sent.
+    std::chrono::steady_clock::time_point sent;
+  };
+  std::map<ItemID, Outstanding> outstanding_;
+  /// Completed timeslices, indexed by their position in the buffer.
+  CompletionBitmap completed_;
+
+  /// Status of the buffer published for inspection.
+  std::unique_ptr<TimesliceBufferStatus> status_;
+
+  /// Producer of the component work items (if enabled).
+  std::unique_ptr<ItemProducer> component_producer_;
+
+  /// CRC validation of the timeslices and their held back work items.
+  struct Validation;
+  std::unique_ptr<Validation> validation_;
+
+  /// Eviction of long-held timeslices to the overflow region.
+  struct Eviction;
+  std::unique_ptr<Eviction> eviction_;
+
+  /// Create the shared memory segment and allocate the regions.
+  void create_regions();
+
+  /// Send the work item of a timeslice.
+  void dispatch_work_item(const fles::TimesliceWorkItem& wi);
+
+  /// Send the work items of all timeslices validated so far, in order.
+  void send_validated();
+
+  /// Set the buffer locations of a work item and add a component.
+  void add_component(fles::TimesliceShmWorkItem& item,
+                     uint_fast16_t component,
+                     uint64_t ts_pos);
+
+  /// Receive the completion of a single timeslice.
+  bool receive_completion(uint64_t& ts_pos);
+
+  /// Release an item of a timeslice, returns whether it is completed.
+  bool release_item(uint64_t ts_pos);
+
+  /// Retrieve the segment holding the regions of the buffer.
+  boost::interprocess::managed_shared_memory& region_shm();
+
+  /// Evict the timeslices outstanding for too long, returns whether the
+  /// buffer space of an evicted timeslice can be released.
+  bool evict(uint64_t& ts_pos);
+
+  /// Copy a timeslice to the overflow region, returns whether successful.
+  bool copy_out(uint64_t ts_pos, uint32_t num_components);
+
+  /// Release the copy of a timeslice, returns whether it has been evicted
+  /// and its buffer space has already been released.
+  bool release_copy(uint64_t ts_pos);
+  TimesliceStatistics* statistics_ = nullptr;
+
+  /// The number and total size of the components sent as work items.
+  uint64_t sent_components_ = 0;
+  uint64_t sent_bytes_ = 0;
+
+  /// Reusable buffer for the encoded work items.
+  std::string work_item_buffer_;
 };
@@ -0,0 +1,30 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceBufferPool.hpp"
+#include "Utility.hpp"
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+TimesliceBufferPool::TimesliceBufferPool(std::string shm_identifier,
+                                         std::size_t size)
+    : shm_identifier_(std::move(shm_identifier)) {
+  boost::uuids::random_generator uuid_gen;
+  shm_uuid_ = uuid_gen();
+
+  boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
+  managed_shm_ = std::make_unique<boost::interprocess::managed_shared_memory>(
+      boost::interprocess::create_only, shm_identifier_.c_str(), size);
+  managed_shm_->construct<boost::uuids::uuid>(
+      boost::interprocess::unique_instance)(shm_uuid_);
+}
+
+TimesliceBufferPool::~TimesliceBufferPool() {
+  boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
+}
+
+std::string TimesliceBufferPool::description() const {
+  return shm_identifier_ + " {" + boost::uuids::to_string(shm_uuid_) +
+         "}, size: " + human_readable_count(managed_shm_->get_size()) +
+         ", free: " + human_readable_count(managed_shm_->get_free_memory());
+}
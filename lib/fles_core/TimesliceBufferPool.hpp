@@ -0,0 +1,45 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <boost/interprocess/interprocess_fwd.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/// Timeslice buffer pool class.
+/** A TimesliceBufferPool object represents a managed shared memory segment
+    from which the timeslice buffers of several outputs of a compute node
+    allocate their per-input regions. The shared memory of each timeslice
+    buffer then only refers to the pool, so consumers of all these buffers
+    attach the pool segment once. */
+
+class TimesliceBufferPool {
+public:
+  /// The TimesliceBufferPool constructor.
+  /** \param shm_identifier Identifier of the shared memory segment
+      \param size           Size of the segment in bytes */
+  TimesliceBufferPool(std::string shm_identifier, std::size_t size);
+
+  TimesliceBufferPool(const TimesliceBufferPool&) = delete;
+  void operator=(const TimesliceBufferPool&) = delete;
+
+  /// The TimesliceBufferPool destructor.
+  ~TimesliceBufferPool();
+
+  [[nodiscard]] const std::string& identifier() const {
+    return shm_identifier_;
+  }
+
+  [[nodiscard]] const boost::uuids::uuid& uuid() const { return shm_uuid_; }
+
+  /// Retrieve the managed shared memory segment.
+  boost::interprocess::managed_shared_memory& shm() { return *managed_shm_; }
+
+  [[nodiscard]] std::string description() const;
+
+private:
+  std::string shm_identifier_;
+  boost::uuids::uuid shm_uuid_{};
+  std::unique_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
+};
@@ -0,0 +1,42 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceBufferStatus.hpp"
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <stdexcept>
+
+TimesliceBufferStatus::TimesliceBufferStatus(const std::string& shm_identifier,
+                                             uint32_t num_inputs,
+                                             uint64_t desc_size,
+                                             uint64_t data_size)
+    : name_(segment_name(shm_identifier)), num_inputs_(num_inputs) {
+  boost::interprocess::shared_memory_object::remove(name_.c_str());
+
+  // management data of the segment and alignment (upper bound)
+  constexpr std::size_t overhead_size = 4096;
+  const std::size_t size = num_inputs * sizeof(BufferStatusSource) +
+                           sizeof(DistributorStatus) + overhead_size;
+  shm_ = std::make_shared<boost::interprocess::managed_shared_memory>(
+      boost::interprocess::create_only, name_.c_str(), size);
+  inputs_ = shm_->construct<BufferStatusSource>("inputs")[num_inputs](
+      desc_size, data_size);
+  distributor_ = shm_->construct<DistributorStatus>("distributor")();
+}
+
+TimesliceBufferStatus::~TimesliceBufferStatus() {
+  boost::interprocess::shared_memory_object::remove(name_.c_str());
+}
+
+void TimesliceBufferStatus::resize(uint64_t desc_size, uint64_t data_size) {
+  for (uint32_t i = 0; i < num_inputs_; ++i) {
+    inputs_[i].desc_size.store(desc_size, std::memory_order_relaxed);
+    inputs_[i].data_size.store(data_size, std::memory_order_relaxed);
+  }
+}
+
+std::shared_ptr<BufferStatusSource>
+TimesliceBufferStatus::input(uint32_t index) {
+  if (index >= num_inputs_) {
+    throw std::out_of_range("TimesliceBufferStatus: invalid input index");
+  }
+  return {shm_, &inputs_[index]};
+}
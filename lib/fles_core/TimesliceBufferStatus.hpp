@@ -0,0 +1,58 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "BufferStatusSampler.hpp"
+#include "DistributorStatus.hpp"
+#include <boost/interprocess/interprocess_fwd.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// Status of a timeslice buffer, published in shared memory for inspection.
+/** The segment (named by the identifier of the buffer plus status_suffix)
+    holds the buffer positions of each input (an array of
+    BufferStatusSource named "inputs"), published by the timeslice builder,
+    and the status of the workers of the distributor (a DistributorStatus
+    named "distributor"). Both are updated with relaxed atomic stores only,
+    and readers attach the segment read-only, so that an inspecting process
+    never delays the publishing threads. */
+class TimesliceBufferStatus {
+public:
+  /// Suffix of the name of the status segment of a timeslice buffer.
+  static constexpr const char* status_suffix = "_status";
+
+  /// The TimesliceBufferStatus constructor, creating the segment.
+  TimesliceBufferStatus(const std::string& shm_identifier,
+                        uint32_t num_inputs,
+                        uint64_t desc_size,
+                        uint64_t data_size);
+
+  TimesliceBufferStatus(const TimesliceBufferStatus&) = delete;
+  void operator=(const TimesliceBufferStatus&) = delete;
+
+  /// The TimesliceBufferStatus destructor, removing the segment.
+  ~TimesliceBufferStatus();
+
+  /// Retrieve the name of the status segment of a timeslice buffer.
+  static std::string segment_name(const std::string& shm_identifier) {
+    return shm_identifier + status_suffix;
+  }
+
+  /// Retrieve the buffer positions of an input for publishing.
+  /** The returned pointer keeps the segment mapped. */
+  std::shared_ptr<BufferStatusSource> input(uint32_t index);
+
+  /// Publish new buffer sizes of all inputs (see TimesliceBuffer::resize()).
+  void resize(uint64_t desc_size, uint64_t data_size);
+
+  /// Retrieve the distributor status for publishing.
+  DistributorStatus& distributor() { return *distributor_; }
+
+private:
+  std::string name_;
+  std::shared_ptr<boost::interprocess::managed_shared_memory> shm_;
+  BufferStatusSource* inputs_ = nullptr;
+  uint32_t num_inputs_;
+  DistributorStatus* distributor_ = nullptr;
+};
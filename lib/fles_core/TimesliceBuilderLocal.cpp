@@ -0,0 +1,145 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceBuilderLocal.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "TimesliceWorkItem.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+TimesliceBuilderLocal::TimesliceBuilderLocal(
+    uint64_t compute_index,
+    TimesliceBuffer& timeslice_buffer,
+    std::vector<ComponentSenderLocal*> senders,
+    uint32_t num_compute_nodes,
+    uint32_t timeslice_size,
+    uint32_t max_timeslice_number,
+    volatile sig_atomic_t* signal_status)
+    : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
+      num_compute_nodes_(num_compute_nodes), timeslice_size_(timeslice_size),
+      max_timeslice_number_(max_timeslice_number),
+      signal_status_(signal_status), ts_index_(compute_index_) {
+  for (size_t i = 0; i < senders.size(); ++i) {
+    connections_.push_back(
+        std::make_unique<Connection>(timeslice_buffer_, i, senders.at(i)));
+  }
+}
+
+void TimesliceBuilderLocal::operator()() {
+  assert(!connections_.empty());
+  report_status();
+  scheduler_.add_repeating([this] { report_status(); },
+                           std::chrono::seconds(1));
+  while (ts_index_ < max_timeslice_number_ && *signal_status_ == 0) {
+    run_cycle();
+    scheduler_.timer();
+  }
+  run_end();
+}
+
+bool TimesliceBuilderLocal::run_cycle() {
+  auto& c = connections_.at(conn_);
+
+  if (!c->sender->available(ts_index_)) {
+    // wait for more data to arrive in the input buffer
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    handle_timeslice_completions();
+    return true;
+  }
+
+  auto component = c->sender->component(ts_index_);
+  uint64_t desc_size =
+      component.desc_length * sizeof(fles::MicrosliceDescriptor);
+  uint64_t size_required = desc_size + component.data_length;
+
+  while (c->data.size_available_contiguous() < size_required ||
+         c->desc.size_available() < 1) {
+    if (*signal_status_ != 0) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    handle_timeslice_completions();
+  }
+
+  // skip remaining bytes in data buffer to avoid fractured entry
+  c->data.skip_buffer_wrap(size_required);
+
+  // generate timeslice component descriptor
+  assert(tpos_ == c->desc.write_index());
+  c->desc.append({ts_index_, c->data.write_index(), size_required,
+                  component.desc_length});
+
+  // copy from the input buffer in place, the space is contiguous (see above)
+  auto* target = c->data.write_ptr();
+  copy_range(c->sender->desc_buffer(), component.desc_offset,
+             component.desc_length,
+             reinterpret_cast<fles::MicrosliceDescriptor*>(target));
+  copy_range(c->sender->data_buffer(), component.data_offset,
+             component.data_length, target + desc_size);
+  c->data.commit(size_required);
+  c->sender->release(ts_index_);
+
+  ++conn_;
+  if (conn_ == connections_.size()) {
+    conn_ = 0;
+
+    handle_timeslice_completions();
+
+    timeslice_buffer_.send_work_item(
+        {{ts_index_, tpos_, timeslice_size_,
+          static_cast<uint32_t>(connections_.size())},
+         timeslice_buffer_.get_data_size_exp(),
+         timeslice_buffer_.get_desc_size_exp()});
+    ++tpos_;
+    // next timeslice: round robin
+    ts_index_ += num_compute_nodes_;
+  }
+
+  return true;
+}
+
+void TimesliceBuilderLocal::run_end() {
+  // wait until all pending timeslices have been acknowledged
+  while (acked_ < tpos_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    handle_timeslice_completions();
+  }
+  assert(timeslice_buffer_.get_num_work_items() == 0);
+  assert(timeslice_buffer_.get_num_completions() == 0);
+  timeslice_buffer_.send_end_work_item();
+  timeslice_buffer_.send_end_completion();
+}
+
+template <typename T_>
+void TimesliceBuilderLocal::copy_range(RingBufferView<T_>& src,
+                                       uint64_t offset,
+                                       uint64_t length,
+                                       T_* dst) {
+  if (length == 0) {
+    return;
+  }
+  uint64_t pos = offset & src.size_mask();
+  uint64_t size1 = std::min<uint64_t>(length, src.size() - pos);
+  std::copy_n(&src.at(offset), size1, dst);
+  std::copy_n(src.ptr(), length - size1, dst + size1);
+}
+
+void TimesliceBuilderLocal::handle_timeslice_completions() {
+  timeslice_buffer_.receive_completions();
+  if (timeslice_buffer_.acked() == acked_) {
+    return;
+  }
+  acked_ = timeslice_buffer_.acked();
+  for (auto& conn : connections_) {
+    conn->desc.set_read_index(acked_);
+    conn->data.set_read_index(conn->desc.at(acked_ - 1).offset +
+                              conn->desc.at(acked_ - 1).size);
+  }
+}
+
+void TimesliceBuilderLocal::report_status() {
+  L_(debug) << "[c" << compute_index_ << "] local: " << tpos_
+            << " timeslices built, " << acked_ << " acknowledged";
+}
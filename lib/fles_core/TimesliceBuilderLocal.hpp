@@ -0,0 +1,123 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "ComponentSenderLocal.hpp"
+#include "ManagedRingBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "Scheduler.hpp"
+#include "TimesliceBuffer.hpp"
+#include <csignal>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The TimesliceBuilderLocal class
+ *
+ * A TimesliceBuilderLocal object builds timeslices from the input buffers of
+ * the same process (see ComponentSenderLocal). The timeslice components are
+ * copied directly from the input buffers into the timeslice buffer, with the
+ * same descriptor and completion handling as the network transports.
+ */
+
+class TimesliceBuilderLocal {
+public:
+  /// The TimesliceBuilderLocal constructor.
+  TimesliceBuilderLocal(uint64_t compute_index,
+                        TimesliceBuffer& timeslice_buffer,
+                        std::vector<ComponentSenderLocal*> senders,
+                        uint32_t num_compute_nodes,
+                        uint32_t timeslice_size,
+                        uint32_t max_timeslice_number,
+                        volatile sig_atomic_t* signal_status);
+
+  TimesliceBuilderLocal(const TimesliceBuilderLocal&) = delete;
+  void operator=(const TimesliceBuilderLocal&) = delete;
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "TSB/Local/o" + std::to_string(compute_index_);
+  };
+
+private:
+  /// This builder's index in the list of compute nodes.
+  const uint64_t compute_index_;
+
+  /// Shared memory buffer to store built timeslices.
+  TimesliceBuffer& timeslice_buffer_;
+
+  /// Number of compute nodes.
+  const uint32_t num_compute_nodes_;
+
+  /// Constant size (in microslices) of a timeslice component.
+  const uint32_t timeslice_size_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// Index of acknowledged timeslices (local index).
+  uint64_t acked_ = 0;
+
+  /// The global index of the timeslice currently being built.
+  uint64_t ts_index_;
+
+  /// The local buffer position of the timeslice currently being built.
+  uint64_t tpos_ = 0;
+
+  /// The index of the connection to copy from next.
+  uint64_t conn_ = 0;
+
+  /// Connection struct, handles data for one input buffer.
+  struct Connection {
+    Connection(TimesliceBuffer& timeslice_buffer,
+               size_t i,
+               ComponentSenderLocal* sender)
+        : desc(timeslice_buffer.get_desc_ptr(i),
+               timeslice_buffer.get_desc_size_exp()),
+          data(timeslice_buffer.get_data_ptr(i),
+               timeslice_buffer.get_data_size_exp()),
+          sender(sender) {}
+
+    ManagedRingBuffer<fles::TimesliceComponentDescriptor> desc;
+    ManagedRingBuffer<uint8_t> data;
+
+    /// The input buffer (not owned).
+    ComponentSenderLocal* sender;
+  };
+
+  /// The vector of connections, one per input buffer.
+  std::vector<std::unique_ptr<Connection>> connections_;
+
+  /// Scheduler for periodic events.
+  Scheduler scheduler_;
+
+  /// A single cycle in the main run loop.
+  bool run_cycle();
+
+  /// Cleanup at end of run.
+  void run_end();
+
+  /// Copy a contiguous range from an input ring buffer.
+  template <typename T_>
+  static void copy_range(RingBufferView<T_>& src,
+                         uint64_t offset,
+                         uint64_t length,
+                         T_* dst);
+
+  /// Handle pending timeslice completions and advance read indexes.
+  void handle_timeslice_completions();
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+};
@@ -1,10 +1,69 @@
 // Copyright 2013-2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceDebugger.hpp"
+#include "WorkerPool.hpp"
 #include <algorithm>
-#include <boost/format.hpp>
+#include <stdexcept>
 
-std::ostream& TimesliceDump::write_to_stream(std::ostream& s) const {
+namespace {
+
+/// Append the text dump of a microslice descriptor (with a header line).
+void dump_descriptor(DumpBuffer& b, const fles::MicrosliceDescriptor& md) {
+  b.append("hi hv eqid flag si sv idx/start        crc      size     offset\n");
+  b.hex(md.hdr_id, 2).append(' ').hex(md.hdr_ver, 2).append(' ');
+  b.hex(md.eq_id, 4).append(' ').hex(md.flags, 4).append(' ');
+  b.hex(md.sys_id, 2).append(' ').hex(md.sys_ver, 2).append(' ');
+  b.hex(md.idx, 16).append(' ').hex(md.crc, 8).append(' ');
+  b.hex(md.size, 8).append(' ').hex(md.offset, 16).append('\n');
+}
+
+/// Append a hex dump of a buffer, 32 bytes per line in descending order.
+void dump_buffer(DumpBuffer& b, const void* buf, std::size_t size) {
+  constexpr std::size_t bytes_per_block = 8;
+  constexpr std::size_t bytes_per_line = 4 * bytes_per_block;
+  const auto* bytes = static_cast<const uint8_t*>(buf);
+
+  for (std::size_t i = 0; i < size; i += bytes_per_line) {
+    for (std::size_t j = bytes_per_line; j-- > 0;) {
+      if (i + j >= size) {
+        b.append("  ");
+      } else {
+        b.hex(bytes[i + j], 2);
+      }
+      if ((j % bytes_per_block) == 0) {
+        b.append("  ");
+      }
+    }
+    b.append(':').hex(i, 4).append('\n');
+  }
+}
+
+/// Append the fields of a microslice descriptor to a JSON object.
+void dump_descriptor_json(DumpBuffer& b, const fles::MicrosliceDescriptor& md) {
+  b.append("\"hdr_id\":").dec(md.hdr_id);
+  b.append(",\"hdr_ver\":").dec(md.hdr_ver);
+  b.append(",\"eq_id\":").dec(md.eq_id);
+  b.append(",\"flags\":").dec(md.flags);
+  b.append(",\"sys_id\":").dec(md.sys_id);
+  b.append(",\"sys_ver\":").dec(md.sys_ver);
+  b.append(",\"idx\":").dec(md.idx);
+  b.append(",\"crc\":").dec(md.crc);
+  b.append(",\"size\":").dec(md.size);
+  b.append(",\"offset\":").dec(md.offset);
+}
+
+/// Append the content of a microslice as a JSON hex string field.
+void dump_content_json(DumpBuffer& b, const void* buf, std::size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(buf);
+  b.append(",\"content\":\"");
+  for (std::size_t i = 0; i < size; ++i) {
+    b.hex(bytes[i], 2);
+  }
+  b.append('"');
+}
+
+/// Append the summary of a timeslice.
+void dump_summary(DumpBuffer& b, const fles::Timeslice& ts, DumpFormat format) {
   uint64_t min_num_microslices = UINT64_MAX;
   uint64_t max_num_microslices = 0;
   uint64_t total_num_microslices = 0;
@@ -27,67 +86,158 @@ std::ostream& TimesliceDump::write_to_stream(std::ostream& s) const {
 
   uint64_t min_overlap = min_num_microslices - ts.num_core_microslices();
   uint64_t max_overlap = max_num_microslices - ts.num_core_microslices();
+  double avg_microslice_size =
+      static_cast<double>(total_microslice_size) / total_num_microslices;
+
+  if (format == DumpFormat::JsonLines) {
+    b.append("{\"timeslice\":").dec(ts.index());
+    b.append(",\"components\":").dec(ts.num_components());
+    b.append(",\"core_microslices\":").dec(ts.num_core_microslices());
+    b.append(",\"microslices\":").dec(total_num_microslices);
+    if (total_num_microslices != 0) {
+      b.append(",\"overlap_min\":").dec(min_overlap);
+      b.append(",\"overlap_max\":").dec(max_overlap);
+      b.append(",\"size_min\":").dec(min_microslice_size);
+      b.append(",\"size_avg\":").real(avg_microslice_size);
+      b.append(",\"size_max\":").dec(max_microslice_size);
+    }
+    b.append("}\n");
+    return;
+  }
 
-  s << "timeslice " << ts.index() << " size: " << ts.num_components() << " x "
-    << ts.num_core_microslices() << " microslices";
+  b.append("timeslice ").dec(ts.index()).append(" size: ");
+  b.dec(ts.num_components()).append(" x ").dec(ts.num_core_microslices());
+  b.append(" microslices");
   if (ts.num_components() != 0) {
-    s << " (+";
+    b.append(" (+");
     if (min_overlap != max_overlap) {
-      s << min_overlap << ".." << max_overlap;
+      b.dec(min_overlap).append("..").dec(max_overlap);
     } else {
-      s << min_overlap;
+      b.dec(min_overlap);
     }
-    s << " overlap) = " << total_num_microslices << "\n";
-    s << "\tmicroslice size min/avg/max: " << min_microslice_size << "/"
-      << (static_cast<double>(total_microslice_size) / total_num_microslices)
-      << "/" << max_microslice_size << "\n";
+    b.append(" overlap) = ").dec(total_num_microslices).append('\n');
+    b.append("\tmicroslice size min/avg/max: ").dec(min_microslice_size);
+    b.append('/').real(avg_microslice_size).append('/');
+    b.dec(max_microslice_size).append('\n');
   }
+}
 
+/// Append the dump of the microslices of a timeslice component.
+void dump_component(DumpBuffer& b,
+                    const fles::Timeslice& ts,
+                    uint64_t c,
+                    DumpFormat format) {
+  uint64_t num_microslices = ts.num_microslices(c);
+  for (uint64_t m = 0; m < num_microslices; ++m) {
+    const fles::MicrosliceDescriptor& md = ts.descriptor(c, m);
+    if (format == DumpFormat::JsonLines) {
+      b.append("{\"timeslice\":").dec(ts.index());
+      b.append(",\"component\":").dec(c);
+      b.append(",\"microslice\":").dec(m).append(',');
+      dump_descriptor_json(b, md);
+      dump_content_json(b, ts.content(c, m), md.size);
+      b.append("}\n");
+    } else {
+      b.append("timeslice ").dec(ts.index()).append(" microslice ").dec(m);
+      b.append(" component ").dec(c).append('\n');
+      dump_descriptor(b, md);
+      b.append('\n');
+      dump_buffer(b, ts.content(c, m), md.size);
+      b.append('\n');
+    }
+  }
+}
+
+} // namespace
+
+DumpFormat parse_dump_format(const std::string& name) {
+  if (name == "text") {
+    return DumpFormat::Text;
+  }
+  if (name == "json") {
+    return DumpFormat::JsonLines;
+  }
+  throw std::invalid_argument("unknown dump format: " + name);
+}
+
+std::ostream& TimesliceDump::write_to_stream(std::ostream& s) const {
+  thread_local DumpBuffer b;
+  dump_summary(b, ts, DumpFormat::Text);
   if (verbosity > 1) {
     for (uint64_t c = 0; c < ts.num_components(); ++c) {
-      uint64_t num_microslices = ts.num_microslices(c);
-      for (uint64_t m = 0; m < num_microslices; ++m) {
-        s << "timeslice " << ts.index() << " microslice " << m << " component "
-          << c << "\n"
-          << ts.get_microslice(c, m) << std::endl;
-      }
+      dump_component(b, ts, c, DumpFormat::Text);
     }
   }
-
+  b.write_to(s);
   return s;
 }
 
 std::ostream& MicrosliceDescriptorDump::write_to_stream(std::ostream& s) const {
-  s << "hi hv eqid flag si sv idx/start        crc      size     offset\n";
-  s << boost::format(
-           "%02x %02x %04x %04x %02x %02x %016lx %08x %08x %016lx\n") %
-           static_cast<unsigned int>(md.hdr_id) %
-           static_cast<unsigned int>(md.hdr_ver) % md.eq_id % md.flags %
-           static_cast<unsigned int>(md.sys_id) %
-           static_cast<unsigned int>(md.sys_ver) % md.idx % md.crc % md.size %
-           md.offset;
-
+  thread_local DumpBuffer b;
+  dump_descriptor(b, md);
+  b.write_to(s);
   return s;
 }
 
 std::ostream& BufferDump::write_to_stream(std::ostream& s) const {
-  constexpr int bytes_per_block = 8;
-  constexpr int bytes_per_line = 4 * bytes_per_block;
+  thread_local DumpBuffer b;
+  dump_buffer(b, buf, size);
+  b.write_to(s);
+  return s;
+}
 
-  for (int i = 0; i < static_cast<int>(size); i += bytes_per_line) {
-    for (int j = bytes_per_line - 1; j >= 0; --j) {
-      if (i + j >= static_cast<int>(size)) {
-        s << "  ";
-      } else {
-        s << boost::format("%02x") %
-                 static_cast<int>(static_cast<const uint8_t*>(buf)[i + j]);
-      }
-      if ((j % bytes_per_block) == 0) {
-        s << "  ";
-      }
+void MicrosliceDumper::put(std::shared_ptr<const fles::Microslice> m) {
+  if (format == DumpFormat::JsonLines) {
+    buffer.append('{');
+    dump_descriptor_json(buffer, m->desc());
+    if (verbosity > 1) {
+      dump_content_json(buffer, m->content(), m->desc().size);
+    }
+    buffer.append("}\n");
+  } else {
+    dump_descriptor(buffer, m->desc());
+    buffer.append('\n');
+    if (verbosity > 1) {
+      dump_buffer(buffer, m->content(), m->desc().size);
     }
-    s << boost::format(":%04x\n") % i;
   }
+  buffer.write_to(out);
+}
 
-  return s;
+TimesliceDumper::TimesliceDumper(std::ostream& arg_out,
+                                 std::size_t arg_verbosity,
+                                 DumpFormat arg_format,
+                                 unsigned arg_num_threads)
+    : out(arg_out), verbosity(arg_verbosity), format(arg_format) {
+  if (arg_num_threads > 1) {
+    worker_pool = std::make_unique<WorkerPool>(arg_num_threads);
+  }
+}
+
+TimesliceDumper::~TimesliceDumper() = default;
+
+void TimesliceDumper::put(std::shared_ptr<const fles::Timeslice> timeslice) {
+  const fles::Timeslice& ts = *timeslice;
+  dump_summary(buffer, ts, format);
+  if (verbosity > 1) {
+    component_buffers.resize(ts.num_components());
+    if (worker_pool && ts.num_components() > 1) {
+      worker_pool->run(ts.num_components(), [&](size_t c) {
+        dump_component(component_buffers[c], ts, c, format);
+      });
+    } else {
+      for (uint64_t c = 0; c < ts.num_components(); ++c) {
+        dump_component(component_buffers[c], ts, c, format);
+      }
+    }
+  }
+  buffer.write_to(out);
+  if (verbosity > 1) {
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      component_buffers[c].write_to(out);
+    }
+  }
+  if (format == DumpFormat::Text) {
+    out << "\n";
+  }
 }
@@ -1,10 +1,25 @@
 // Copyright 2013-2015 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "DumpBuffer.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "Sink.hpp"
 #include "Timeslice.hpp"
+#include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
+
+class WorkerPool;
+
+/// Output format of the dumpers.
+enum class DumpFormat {
+  Text,     ///< human-readable text
+  JsonLines ///< one JSON object per line, numbers in decimal
+};
+
+/// Parse a dump format name ("text" or "json").
+[[nodiscard]] DumpFormat parse_dump_format(const std::string& name);
 
 class BufferDump {
 public:
@@ -49,21 +64,24 @@ inline std::ostream& operator<<(std::ostream& s,
 
 // ----------
 
+/// Sink writing a dump of each microslice.
+/** Each microslice is formatted into a buffer and written to the output
+    stream at once. In JSON-lines mode, the content (verbosity > 1) is a
+    hex string in ascending byte order. */
 class MicrosliceDumper : public fles::MicrosliceSink {
 public:
-  MicrosliceDumper(std::ostream& arg_out, std::size_t arg_verbosity)
-      : out(arg_out), verbosity(arg_verbosity){};
+  MicrosliceDumper(std::ostream& arg_out,
+                   std::size_t arg_verbosity,
+                   DumpFormat arg_format = DumpFormat::Text)
+      : out(arg_out), verbosity(arg_verbosity), format(arg_format){};
 
-  void put(std::shared_ptr<const fles::Microslice> m) override {
-    out << MicrosliceDescriptorDump(m->desc()) << "\n";
-    if (verbosity > 1) {
-      out << BufferDump(m->content(), m->desc().size);
-    }
-  }
+  void put(std::shared_ptr<const fles::Microslice> m) override;
 
 private:
   std::ostream& out;
   std::size_t verbosity;
+  DumpFormat format;
+  DumpBuffer buffer;
 };
 
 // ----------
@@ -86,16 +104,29 @@ inline std::ostream& operator<<(std::ostream& s, const TimesliceDump& dump) {
 
 // ----------
 
+/// Sink writing a dump of each timeslice.
+/** A summary of each timeslice is written, followed by a dump of each
+    microslice if the verbosity is greater than one. The components are
+    formatted into buffers of their own, in parallel if more than one
+    thread is given, and written in order. In JSON-lines mode, there is one
+    line for the summary and one for each microslice. */
 class TimesliceDumper : public fles::TimesliceSink {
 public:
-  TimesliceDumper(std::ostream& arg_out, std::size_t arg_verbosity)
-      : out(arg_out), verbosity(arg_verbosity){};
+  TimesliceDumper(std::ostream& arg_out,
+                  std::size_t arg_verbosity,
+                  DumpFormat arg_format = DumpFormat::Text,
+                  unsigned arg_num_threads = 1);
+  ~TimesliceDumper() override;
 
-  void put(std::shared_ptr<const fles::Timeslice> timeslice) override {
-    out << TimesliceDump(*timeslice, verbosity) << "\n";
-  }
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
 
 private:
   std::ostream& out;
   std::size_t verbosity;
+  DumpFormat format;
+  DumpBuffer buffer;
+  /// Buffers of the components of a timeslice.
+  std::vector<DumpBuffer> component_buffers;
+  /// Threads for formatting components in parallel (if more than one).
+  std::unique_ptr<WorkerPool> worker_pool;
 };
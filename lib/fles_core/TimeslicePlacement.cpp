@@ -0,0 +1,191 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimeslicePlacement.hpp"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <stdexcept>
+
+TimeslicePlacement::TimeslicePlacement(PlacementPolicy policy,
+                                       uint32_t epoch_length)
+    : policy_(policy), epoch_length_(epoch_length) {
+  if (policy_ == PlacementPolicy::Credit && epoch_length_ == 0) {
+    throw std::invalid_argument("placement epoch length cannot be zero");
+  }
+  if (epoch_length_ == 0) {
+    epoch_length_ = 1;
+  }
+}
+
+void TimeslicePlacement::init(const std::vector<uint32_t>& buffer_size_exp) {
+  // cap the ratio between the largest and smallest weight to limit the
+  // length of the static schedule
+  constexpr uint32_t max_weight_exp = 6;
+
+  num_nodes_ = static_cast<uint32_t>(buffer_size_exp.size());
+  if (num_nodes_ == 0) {
+    throw std::invalid_argument("placement requires at least one node");
+  }
+  if (policy_ == PlacementPolicy::Credit && epoch_length_ < num_nodes_) {
+    throw std::invalid_argument(
+        "placement epoch length smaller than number of compute nodes");
+  }
+
+  uint32_t min_exp =
+      *std::min_element(buffer_size_exp.begin(), buffer_size_exp.end());
+  weights_.clear();
+  for (auto exp : buffer_size_exp) {
+    weights_.push_back(UINT32_C(1) << std::min(exp - min_exp, max_weight_exp));
+  }
+
+  schedule_.clear();
+  epoch_schedules_.clear();
+  pending_credits_.clear();
+  pending_sizes_.clear();
+  epoch_sizes_.clear();
+  min_epoch_ = credit_lead;
+  if (policy_ == PlacementPolicy::Weighted) {
+    schedule_ = interleave(weights_);
+  } else if (policy_ == PlacementPolicy::Credit) {
+    schedule_ = interleave(apportion(weights_, epoch_length_));
+  }
+}
+
+bool TimeslicePlacement::ready(uint64_t timeslice) const {
+  if (policy_ != PlacementPolicy::Credit) {
+    return true;
+  }
+  uint64_t ep = epoch(timeslice);
+  return ep < credit_lead || epoch_schedules_.count(ep) != 0;
+}
+
+uint32_t TimeslicePlacement::target(uint64_t timeslice) const {
+  assert(num_nodes_ > 0);
+  switch (policy_) {
+  case PlacementPolicy::RoundRobin:
+    return timeslice % num_nodes_;
+  case PlacementPolicy::Weighted:
+    return schedule_[timeslice % schedule_.size()];
+  case PlacementPolicy::Credit: {
+    uint64_t ep = epoch(timeslice);
+    if (ep < credit_lead) {
+      return schedule_[timeslice % epoch_length_];
+    }
+    return epoch_schedules_.at(ep)[timeslice % epoch_length_];
+  }
+  }
+  return 0;
+}
+
+void TimeslicePlacement::set_credit(uint64_t epoch,
+                                    uint32_t node,
+                                    uint32_t credit,
+                                    uint32_t size) {
+  if (policy_ != PlacementPolicy::Credit || credit == 0 ||
+      node >= num_nodes_ || epoch < min_epoch_ ||
+      epoch_schedules_.count(epoch) != 0) {
+    return;
+  }
+
+  auto& credits = pending_credits_[epoch];
+  if (credits.empty()) {
+    credits.resize(num_nodes_, 0);
+  }
+  credits[node] = std::min(credit, max_credit);
+  auto& sizes = pending_sizes_[epoch];
+  if (sizes.empty()) {
+    sizes.resize(num_nodes_, 0);
+  }
+  sizes[node] = size;
+
+  if (std::find(credits.begin(), credits.end(), 0) == credits.end()) {
+    build_epoch(epoch, credits, sizes);
+    pending_credits_.erase(epoch);
+    pending_sizes_.erase(epoch);
+  }
+}
+
+void TimeslicePlacement::build_epoch(uint64_t epoch,
+                                     const std::vector<uint32_t>& credits,
+                                     const std::vector<uint32_t>& sizes) {
+  epoch_schedules_[epoch] = interleave(apportion(credits, epoch_length_));
+  uint32_t size = 0;
+  for (auto s : sizes) {
+    if (s != 0 && (size == 0 || s < size)) {
+      size = s;
+    }
+  }
+  if (size != 0) {
+    epoch_sizes_[epoch] = size;
+  }
+
+  // All compute nodes have announced this epoch, so each has received a
+  // timeslice from epoch - credit_lead, and earlier epochs are obsolete.
+  if (epoch - credit_lead > min_epoch_) {
+    min_epoch_ = epoch - credit_lead;
+    epoch_schedules_.erase(epoch_schedules_.begin(),
+                           epoch_schedules_.lower_bound(min_epoch_));
+    pending_credits_.erase(pending_credits_.begin(),
+                           pending_credits_.lower_bound(min_epoch_));
+    pending_sizes_.erase(pending_sizes_.begin(),
+                         pending_sizes_.lower_bound(min_epoch_));
+    epoch_sizes_.erase(epoch_sizes_.begin(),
+                       epoch_sizes_.lower_bound(min_epoch_));
+  }
+}
+
+uint32_t TimeslicePlacement::credit_for(double free_fraction) {
+  free_fraction = std::clamp(free_fraction, 0.0, 1.0);
+  return 1 + static_cast<uint32_t>(free_fraction * (max_credit - 1));
+}
+
+std::vector<uint32_t>
+TimeslicePlacement::interleave(const std::vector<uint32_t>& weights) {
+  auto total = std::accumulate(weights.begin(), weights.end(), int64_t{0});
+  std::vector<int64_t> current(weights.size(), 0);
+  std::vector<uint32_t> schedule;
+  schedule.reserve(total);
+
+  for (int64_t slot = 0; slot < total; ++slot) {
+    std::size_t best = 0;
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+      current[i] += weights[i];
+      if (current[i] > current[best]) {
+        best = i;
+      }
+    }
+    current[best] -= total;
+    schedule.push_back(static_cast<uint32_t>(best));
+  }
+
+  return schedule;
+}
+
+std::vector<uint32_t>
+TimeslicePlacement::apportion(const std::vector<uint32_t>& weights,
+                              uint32_t slots) {
+  assert(slots >= weights.size());
+  uint64_t total = std::accumulate(weights.begin(), weights.end(), uint64_t{0});
+  uint64_t extra = slots - weights.size();
+
+  std::vector<uint32_t> count(weights.size());
+  std::vector<uint64_t> remainder(weights.size());
+  uint64_t assigned = 0;
+  for (std::size_t i = 0; i < weights.size(); ++i) {
+    count[i] = 1 + static_cast<uint32_t>(extra * weights[i] / total);
+    remainder[i] = extra * weights[i] % total;
+    assigned += count[i] - 1;
+  }
+
+  std::vector<std::size_t> order(weights.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&remainder](std::size_t a, std::size_t b) {
+                     return remainder[a] > remainder[b];
+                   });
+  for (std::size_t i = 0; assigned < extra; ++i, ++assigned) {
+    ++count[order[i]];
+  }
+
+  return count;
+}
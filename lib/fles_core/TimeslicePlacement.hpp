@@ -0,0 +1,121 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/// Timeslice-to-compute-node placement policy enum.
+enum class PlacementPolicy { RoundRobin, Weighted, Credit };
+
+/// Timeslice-to-compute-node placement class.
+/** A TimeslicePlacement object decides which compute node receives a given
+    timeslice. All input channels must arrive at the same decision for every
+    timeslice, so placement depends only on information that is identical
+    on all inputs:
+
+    - RoundRobin: timeslice modulo the number of compute nodes.
+    - Weighted: a fixed interleaved schedule in which each compute node
+      appears in proportion to its advertised buffer capacity.
+    - Credit: timeslices are grouped into epochs of a fixed length. For each
+      epoch, every compute node announces a credit reflecting its free
+      buffer space, and the epoch's schedule assigns timeslices in
+      proportion to these credits (at least one per node). The first two
+      epochs use the static capacity weights, and the schedule for any later
+      epoch is only available once all credits for it have been received. */
+
+class TimeslicePlacement {
+public:
+  /// Maximum credit a compute node announces for an epoch.
+  static constexpr uint32_t max_credit = 16;
+
+  /// Number of epochs between credit announcement and use.
+  static constexpr uint64_t credit_lead = 2;
+
+  /// The TimeslicePlacement constructor.
+  /**
+     \param policy       Placement policy to use
+     \param epoch_length Number of timeslices per credit epoch (Credit only)
+  */
+  TimeslicePlacement(PlacementPolicy policy, uint32_t epoch_length);
+
+  /// Initialize placement for compute nodes with the given buffer sizes.
+  /**
+     \param buffer_size_exp Data buffer size exponent (log2 of size in bytes)
+                            of each compute node
+  */
+  void init(const std::vector<uint32_t>& buffer_size_exp);
+
+  /// Return whether the target of the given timeslice is already decided.
+  [[nodiscard]] bool ready(uint64_t timeslice) const;
+
+  /// Return the target compute node of the given timeslice.
+  /** Requires ready(timeslice). */
+  [[nodiscard]] uint32_t target(uint64_t timeslice) const;
+
+  /// Record the credit announced by a compute node for an epoch.
+  /** Credits of zero and credits for epochs that are already decided are
+      ignored. A compute node may also propose a timeslice size for the
+      epoch (0: none). */
+  void set_credit(uint64_t epoch,
+                  uint32_t node,
+                  uint32_t credit,
+                  uint32_t size = 0);
+
+  /// Return the timeslice size decided for an epoch (0: none proposed).
+  /** The smallest size proposed by any compute node is used. Requires
+      ready() for the timeslices of the epoch. */
+  [[nodiscard]] uint32_t epoch_size(uint64_t epoch) const {
+    auto it = epoch_sizes_.find(epoch);
+    return it != epoch_sizes_.end() ? it->second : 0;
+  }
+
+  /// Return the credit epoch of a given timeslice.
+  [[nodiscard]] uint64_t epoch(uint64_t timeslice) const {
+    return timeslice / epoch_length_;
+  }
+
+  /// Return the credit for given free buffer fraction (between 0 and 1).
+  static uint32_t credit_for(double free_fraction);
+
+  /// Return an interleaved schedule in which each node i appears weights[i]
+  /// times (smooth weighted round-robin).
+  static std::vector<uint32_t>
+  interleave(const std::vector<uint32_t>& weights);
+
+  /// Distribute a number of slots in proportion to given weights, giving at
+  /// least one slot to each node (largest remainder method).
+  static std::vector<uint32_t>
+  apportion(const std::vector<uint32_t>& weights, uint32_t slots);
+
+private:
+  /// Build the schedule for an epoch from the given credits.
+  void build_epoch(uint64_t epoch,
+                   const std::vector<uint32_t>& credits,
+                   const std::vector<uint32_t>& sizes);
+
+  PlacementPolicy policy_;
+  uint32_t epoch_length_;
+  uint32_t num_nodes_ = 0;
+
+  /// Earliest credit epoch that may still be needed.
+  uint64_t min_epoch_ = credit_lead;
+
+  /// Static weights derived from the compute node buffer sizes.
+  std::vector<uint32_t> weights_;
+
+  /// Static schedule (Weighted) or schedule of the initial epochs (Credit).
+  std::vector<uint32_t> schedule_;
+
+  /// Schedules of decided credit epochs.
+  std::map<uint64_t, std::vector<uint32_t>> epoch_schedules_;
+
+  /// Received credits of undecided credit epochs.
+  std::map<uint64_t, std::vector<uint32_t>> pending_credits_;
+
+  /// Proposed timeslice sizes of undecided credit epochs.
+  std::map<uint64_t, std::vector<uint32_t>> pending_sizes_;
+
+  /// Timeslice sizes of decided credit epochs (if proposed).
+  std::map<uint64_t, uint32_t> epoch_sizes_;
+};
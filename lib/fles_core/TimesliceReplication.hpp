@@ -0,0 +1,89 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "TimesliceComponentDescriptor.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#pragma pack(1)
+
+/// Entry of the replica descriptor buffer of a hot-standby compute node.
+struct ReplicaDescriptor {
+  /// Position of the descriptor at the primary compute node
+  uint64_t position = ~UINT64_C(0);
+  /// The descriptor at the primary compute node
+  fles::TimesliceComponentDescriptor desc{};
+};
+
+#pragma pack()
+
+/// Replication of selected timeslices to a hot-standby compute node.
+/** Each input writes the data of a selected timeslice component to its
+    primary compute node and, at the same offset, to a replica buffer of the
+    standby node, followed by a ReplicaDescriptor at the descriptor position
+    of the primary. If the primary fails, the standby takes over the
+    timeslice and copies the component from its replica buffer instead of
+    receiving it again. */
+
+namespace timeslice_replication {
+
+/// Marker for a descriptor without replica.
+constexpr uint64_t no_replica = ~UINT64_C(0);
+
+/// Check whether a timeslice is replicated (modulo 0: replication disabled).
+inline bool selected(uint64_t timeslice, uint32_t modulo) {
+  return modulo != 0 && timeslice % modulo == 0;
+}
+
+/// Retrieve the standby of a primary compute node.
+inline uint32_t standby(uint32_t primary, uint32_t compute_count) {
+  return (primary + 1) % compute_count;
+}
+
+/// Find the replica of a descriptor in a replica descriptor buffer.
+/**
+   \param ring     The replica descriptor buffer
+   \param size_exp Size exponent of the buffer
+   \param position Descriptor position at the primary compute node
+   \param expected The descriptor of the timeslice component
+   \return the replica descriptor, or nullptr if the slot holds no matching
+   replica
+*/
+inline const fles::TimesliceComponentDescriptor*
+find(const ReplicaDescriptor* ring,
+     uint32_t size_exp,
+     uint64_t position,
+     const fles::TimesliceComponentDescriptor& expected) {
+  const ReplicaDescriptor& entry =
+      ring[position & ((UINT64_C(1) << size_exp) - 1)];
+  if (entry.position != position || entry.desc.ts_num != expected.ts_num ||
+      entry.desc.size != expected.size ||
+      entry.desc.num_microslices != expected.num_microslices) {
+    return nullptr;
+  }
+  return &entry.desc;
+}
+
+/// Copy a component between two ring buffers, wrapping around on both.
+inline void copy(uint8_t* dst,
+                 uint32_t dst_size_exp,
+                 uint64_t dst_offset,
+                 const uint8_t* src,
+                 uint32_t src_size_exp,
+                 uint64_t src_offset,
+                 uint64_t size) {
+  const uint64_t dst_size = UINT64_C(1) << dst_size_exp;
+  const uint64_t src_size = UINT64_C(1) << src_size_exp;
+  while (size > 0) {
+    uint64_t d = dst_offset & (dst_size - 1);
+    uint64_t s = src_offset & (src_size - 1);
+    uint64_t chunk = std::min({size, dst_size - d, src_size - s});
+    std::memcpy(dst + d, src + s, chunk);
+    dst_offset += chunk;
+    src_offset += chunk;
+    size -= chunk;
+  }
+}
+
+} // namespace timeslice_replication
@@ -0,0 +1,104 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceSchedule.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+TimesliceSchedule::TimesliceSchedule(uint32_t timeslice_size) {
+  if (timeslice_size == 0) {
+    throw std::invalid_argument("timeslice size cannot be zero");
+  }
+  phases_.push_back({0, 0, timeslice_size});
+}
+
+TimesliceSchedule TimesliceSchedule::parse(uint32_t timeslice_size,
+                                           const std::string& changes) {
+  TimesliceSchedule schedule(timeslice_size);
+  std::istringstream s(changes);
+  std::string change;
+  while (std::getline(s, change, ',')) {
+    auto colon = change.find(':');
+    if (colon == std::string::npos) {
+      throw std::invalid_argument("invalid timeslice size change: " + change);
+    }
+    try {
+      size_t end = 0;
+      uint64_t timeslice = std::stoull(change.substr(0, colon), &end);
+      bool valid = end == colon;
+      unsigned long size = std::stoul(change.substr(colon + 1), &end);
+      valid = valid && end == change.size() - colon - 1 &&
+              size <= UINT32_MAX;
+      if (!valid) {
+        throw std::invalid_argument(change);
+      }
+      schedule.add_change(timeslice, static_cast<uint32_t>(size));
+    } catch (std::logic_error&) {
+      throw std::invalid_argument("invalid timeslice size change: " + change);
+    }
+  }
+  return schedule;
+}
+
+TimesliceSchedule TimesliceSchedule::scaled(uint32_t factor) const {
+  if (factor == 0) {
+    throw std::invalid_argument("timeslice size cannot be zero");
+  }
+  TimesliceSchedule schedule(*this);
+  for (Phase& p : schedule.phases_) {
+    if (p.size > UINT32_MAX / factor) {
+      throw std::invalid_argument("scaled timeslice size out of range");
+    }
+    p.start *= factor;
+    p.size *= factor;
+  }
+  return schedule;
+}
+
+void TimesliceSchedule::add_change(uint64_t timeslice, uint32_t size) {
+  if (size == 0) {
+    throw std::invalid_argument("timeslice size cannot be zero");
+  }
+  const Phase& last = phases_.back();
+  if (timeslice <= last.timeslice) {
+    throw std::invalid_argument(
+        "timeslice size changes must be in increasing order");
+  }
+  phases_.push_back({timeslice, start(timeslice), size});
+}
+
+void TimesliceSchedule::discard_before(uint64_t timeslice) {
+  auto it = std::upper_bound(phases_.begin(), phases_.end(), timeslice,
+                             [](uint64_t ts, const Phase& p) {
+                               return ts < p.timeslice;
+                             });
+  // keep the phase containing the timeslice
+  if (it - phases_.begin() > 1) {
+    phases_.erase(phases_.begin(), it - 1);
+  }
+}
+
+uint64_t TimesliceSchedule::timeslice_at(uint64_t position) const {
+  auto it = phases_.rbegin();
+  while (it->start > position) {
+    ++it;
+  }
+  return it->timeslice + (position - it->start) / it->size;
+}
+
+uint32_t TimesliceSchedule::min_size() const {
+  return std::min_element(phases_.begin(), phases_.end(),
+                          [](const Phase& a, const Phase& b) {
+                            return a.size < b.size;
+                          })
+      ->size;
+}
+
+std::string TimesliceSchedule::description() const {
+  std::string d = std::to_string(phases_.front().size);
+  for (auto it = phases_.begin() + 1; it != phases_.end(); ++it) {
+    d += ", " + std::to_string(it->size) + " from " +
+         std::to_string(it->timeslice);
+  }
+  return d;
+}
@@ -0,0 +1,84 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Timeslice-size schedule class.
+/** A TimesliceSchedule object maps timeslice indexes to their start
+    position and size (in microslices) in the stream of an input channel.
+    The size may change at given timeslices, e.g., between run phases.
+    All input channels and compute nodes use the same schedule, so the
+    change takes effect at the same timeslice boundary everywhere while data
+    keeps flowing. */
+
+class TimesliceSchedule {
+public:
+  /// The TimesliceSchedule constructor.
+  /** \param timeslice_size Initial number of core microslices per timeslice
+   */
+  explicit TimesliceSchedule(uint32_t timeslice_size);
+
+  /// Parse a schedule given as a list of changes, e.g., "1000:50,4000:200".
+  /** Each change "<timeslice>:<size>" sets the size of the given and all
+      following timeslices. */
+  static TimesliceSchedule parse(uint32_t timeslice_size,
+                                 const std::string& changes);
+
+  /// Return the schedule of a stream with a given number of microslices
+  /// per microslice of this schedule (e.g., of an InputFanIn).
+  [[nodiscard]] TimesliceSchedule scaled(uint32_t factor) const;
+
+  /// Change the size starting with a given timeslice.
+  /** Changes must be added in increasing order of timeslices. */
+  void add_change(uint64_t timeslice, uint32_t size);
+
+  /// Return the number of core microslices of the given timeslice.
+  [[nodiscard]] uint32_t size(uint64_t timeslice) const {
+    return phase(timeslice).size;
+  }
+
+  /// Return the position of the first microslice of the given timeslice.
+  [[nodiscard]] uint64_t start(uint64_t timeslice) const {
+    const Phase& p = phase(timeslice);
+    return p.start + (timeslice - p.timeslice) * p.size;
+  }
+
+  /// Return the index of the timeslice beginning at or before the given
+  /// microslice position.
+  [[nodiscard]] uint64_t timeslice_at(uint64_t position) const;
+
+  /// Forget the changes before the given timeslice, which must not be
+  /// queried afterwards.
+  void discard_before(uint64_t timeslice);
+
+  /// Return the smallest timeslice size of the schedule.
+  [[nodiscard]] uint32_t min_size() const;
+
+  /// Return whether the size never changes.
+  [[nodiscard]] bool constant() const { return phases_.size() == 1; }
+
+  /// Return a description of the schedule, e.g., "100, 50 from 1000".
+  [[nodiscard]] std::string description() const;
+
+private:
+  /// A range of timeslices of the same size.
+  struct Phase {
+    uint64_t timeslice; ///< Index of the first timeslice
+    uint64_t start;     ///< Position of the first microslice
+    uint32_t size;      ///< Number of core microslices per timeslice
+  };
+
+  [[nodiscard]] const Phase& phase(uint64_t timeslice) const {
+    // schedules are short, and the last phase is the common case
+    auto it = phases_.rbegin();
+    while (it->timeslice > timeslice) {
+      ++it;
+    }
+    return *it;
+  }
+
+  /// The phases in increasing order, the first starting at timeslice 0.
+  std::vector<Phase> phases_;
+};
@@ -0,0 +1,97 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceStatistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <utility>
+
+void TimesliceStatistics::add(uint64_t index,
+                              uint64_t bytes,
+                              clock::time_point now) {
+  ++timeslice_count_;
+  bytes_ += bytes;
+  first_ = std::min(first_, now);
+  last_ = std::max(last_, now);
+  if (schedule_) {
+    auto latency = now - schedule_(index);
+    latencies_.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+  }
+}
+
+void TimesliceStatistics::merge(const TimesliceStatistics& other) {
+  timeslice_count_ += other.timeslice_count_;
+  bytes_ += other.bytes_;
+  first_ = std::min(first_, other.first_);
+  last_ = std::max(last_, other.last_);
+  latencies_.insert(latencies_.end(), other.latencies_.begin(),
+                    other.latencies_.end());
+}
+
+double TimesliceStatistics::seconds() const {
+  if (timeslice_count_ == 0) {
+    return 0;
+  }
+  return std::chrono::duration<double>(last_ - first_).count();
+}
+
+// The rates are determined over the intervals between completions, so the
+// first completed timeslice only marks the start of the measurement.
+
+double TimesliceStatistics::timeslice_rate() const {
+  double s = seconds();
+  if (s <= 0) {
+    return 0;
+  }
+  return static_cast<double>(timeslice_count_ - 1) / s;
+}
+
+double TimesliceStatistics::data_rate() const {
+  double s = seconds();
+  if (s <= 0) {
+    return 0;
+  }
+  double n = static_cast<double>(timeslice_count_);
+  return static_cast<double>(bytes_) * (n - 1) / n / s;
+}
+
+double TimesliceStatistics::latency_percentile(double percentile) const {
+  if (latencies_.empty()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  std::vector<int64_t> sorted = latencies_;
+  auto rank = static_cast<size_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+  rank = std::clamp<size_t>(rank, 1, sorted.size());
+  std::nth_element(sorted.begin(), sorted.begin() + (rank - 1), sorted.end());
+  return static_cast<double>(sorted[rank - 1]) * 1e-9;
+}
+
+void TimesliceStatistics::write_json(
+    std::ostream& out, const std::map<std::string, std::string>& labels) const {
+  out << "{";
+  for (const auto& [key, value] : labels) {
+    out << "\"" << key << "\":\"" << value << "\",";
+  }
+  out << "\"timeslices\":" << timeslice_count_ << ",\"bytes\":" << bytes_
+      << std::setprecision(6) << ",\"seconds\":" << seconds()
+      << ",\"timeslices_per_second\":" << timeslice_rate()
+      << ",\"gigabytes_per_second\":" << data_rate() * 1e-9
+      << ",\"latency_us\":";
+  if (latencies_.empty()) {
+    out << "null";
+  } else {
+    out << "{";
+    const char* separator = "";
+    const std::pair<const char*, double> percentiles[] = {
+        {"p50", 50}, {"p90", 90}, {"p99", 99}, {"max", 100}};
+    for (const auto& [name, p] : percentiles) {
+      out << separator << "\"" << name << "\":" << latency_percentile(p) * 1e6;
+      separator = ",";
+    }
+    out << "}";
+  }
+  out << "}" << std::endl;
+}
@@ -0,0 +1,69 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Throughput and latency statistics of the timeslices of a buffer.
+/** Used to benchmark the timeslice transport. The builder of a timeslice
+    buffer records each completed timeslice, and the statistics of all
+    buffers of an application are merged and reported at the end of a run.
+    The latency of a timeslice is the time from the moment its last
+    microslice was due at the inputs to its completion, so it is only
+    available if the inputs follow a known (rate-limited) schedule. */
+class TimesliceStatistics {
+public:
+  using clock = std::chrono::high_resolution_clock;
+
+  /// Function returning the time the contents of a timeslice are complete
+  /// at the inputs, given the timeslice index.
+  using Schedule = std::function<clock::time_point(uint64_t)>;
+
+  /// Set the schedule of the inputs to measure latencies against.
+  void set_schedule(Schedule schedule) { schedule_ = std::move(schedule); }
+
+  /// Record a timeslice completed at the given time.
+  void add(uint64_t index, uint64_t bytes, clock::time_point now);
+
+  /// Record a timeslice completed now.
+  void add(uint64_t index, uint64_t bytes) { add(index, bytes, clock::now()); }
+
+  /// Merge the records of another object into this one.
+  void merge(const TimesliceStatistics& other);
+
+  [[nodiscard]] uint64_t timeslice_count() const { return timeslice_count_; }
+  [[nodiscard]] uint64_t bytes() const { return bytes_; }
+
+  /// Time between the first and the last completion, in seconds.
+  [[nodiscard]] double seconds() const;
+
+  /// Rate of completed timeslices per second.
+  [[nodiscard]] double timeslice_rate() const;
+
+  /// Rate of completed data in bytes per second.
+  [[nodiscard]] double data_rate() const;
+
+  /// Retrieve a latency percentile (0..100) in seconds (NaN if none).
+  [[nodiscard]] double latency_percentile(double percentile) const;
+
+  /// Write the statistics as a single-line JSON object.
+  /** The labels are included as string members to identify the run. */
+  void write_json(std::ostream& out,
+                  const std::map<std::string, std::string>& labels) const;
+
+private:
+  Schedule schedule_;
+
+  uint64_t timeslice_count_ = 0;
+  uint64_t bytes_ = 0;
+  clock::time_point first_ = clock::time_point::max();
+  clock::time_point last_ = clock::time_point::min();
+
+  /// Latencies of the timeslices in nanoseconds (negative if early).
+  std::vector<int64_t> latencies_;
+};
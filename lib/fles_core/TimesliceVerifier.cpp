@@ -0,0 +1,150 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceVerifier.hpp"
+#include "log.hpp"
+#include <stdexcept>
+
+TimesliceVerifier::TimesliceVerifier(Callback callback,
+                                     int device,
+                                     unsigned num_threads,
+                                     std::size_t max_pending)
+    : callback_(std::move(callback)),
+      max_pending_(max_pending > 0 ? max_pending : 1) {
+  if (num_threads == 0) {
+    throw std::invalid_argument("TimesliceVerifier: no threads given");
+  }
+
+  if (device >= 0) {
+    try {
+      for (unsigned i = 0; i < num_threads; ++i) {
+        engines_.push_back(make_device_verification_engine(device));
+      }
+    } catch (std::exception& e) {
+      L_(warning) << "verification on device " << device
+                  << " not available, using the CPU: " << e.what();
+      engines_.clear();
+    }
+  }
+  if (engines_.empty()) {
+    for (unsigned i = 0; i < num_threads; ++i) {
+      engines_.push_back(make_cpu_verification_engine());
+    }
+  }
+  engine_name_ = engines_.front()->name();
+
+  for (auto& engine : engines_) {
+    threads_.emplace_back([this, e = engine.get()] { work(*e); });
+  }
+}
+
+TimesliceVerifier::~TimesliceVerifier() {
+  try {
+    end_stream();
+  } catch (std::exception& e) {
+    L_(error) << "timeslice verification: " << e.what();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+void TimesliceVerifier::put(std::shared_ptr<const fles::Timeslice> timeslice) {
+  constexpr auto crc_valid =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+
+  auto job = std::make_unique<Job>();
+  const fles::Timeslice& ts = *timeslice;
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    for (uint64_t m = 0; m < ts.num_microslices(c); ++m) {
+      const fles::MicrosliceDescriptor& desc = ts.descriptor(c, m);
+      uint8_t flags = 0;
+      if ((desc.flags & crc_valid) != 0) {
+        flags |= verification::crc_checked;
+      }
+      if (desc.sys_id == static_cast<uint8_t>(fles::Subsystem::FLES) &&
+          desc.sys_ver == static_cast<uint8_t>(
+                              fles::SubsystemFormatFLES::BasicRampPattern)) {
+        flags |= verification::pattern_checked;
+      }
+      job->items.push_back(
+          {ts.content(c, m), desc.size, c << 48, desc.crc});
+      job->flags.push_back(flags);
+    }
+  }
+  job->timeslice = std::move(timeslice);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  work_cv_.notify_one();
+  deliver(max_pending_);
+}
+
+void TimesliceVerifier::end_stream() { deliver(0); }
+
+void TimesliceVerifier::work(VerificationEngine& engine) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cv_.wait(lock,
+                  [this] { return stopped_ || started_ < jobs_.size(); });
+    if (stopped_) {
+      return;
+    }
+    // jobs are only removed once done, so the pointer stays valid
+    Job* job = jobs_[started_++].get();
+    lock.unlock();
+    engine.verify(job->items.data(), job->items.size(), job->flags.data());
+    lock.lock();
+    job->done = true;
+    done_cv_.notify_all();
+  }
+}
+
+void TimesliceVerifier::deliver(std::size_t wait_count) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!jobs_.empty()) {
+    if (jobs_.size() > wait_count) {
+      done_cv_.wait(lock, [this] { return jobs_.front()->done; });
+    } else if (!jobs_.front()->done) {
+      break;
+    }
+    std::unique_ptr<Job> job = std::move(jobs_.front());
+    jobs_.pop_front();
+    --started_;
+    lock.unlock();
+
+    const fles::Timeslice& ts = *job->timeslice;
+    Result result;
+    result.index = ts.index();
+    result.microslices = job->flags.size();
+    result.flags.resize(ts.num_components());
+    auto it = job->flags.cbegin();
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      auto end = it + static_cast<std::ptrdiff_t>(ts.num_microslices(c));
+      result.flags[c].assign(it, end);
+      it = end;
+    }
+    for (uint8_t flags : job->flags) {
+      if ((flags & verification::crc_error) != 0) {
+        ++result.crc_errors;
+      }
+      if ((flags & verification::pattern_error) != 0) {
+        ++result.pattern_errors;
+      }
+    }
+    microslices_ += result.microslices;
+    crc_errors_ += result.crc_errors;
+    pattern_errors_ += result.pattern_errors;
+    if (callback_) {
+      callback_(result);
+    }
+
+    lock.lock();
+  }
+}
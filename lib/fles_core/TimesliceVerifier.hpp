@@ -0,0 +1,108 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "Sink.hpp"
+#include "Timeslice.hpp"
+#include "VerificationEngine.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Batched verification of microslice CRCs and test patterns.
+/** A TimesliceVerifier checks the content CRC-32C of all microslices that
+    carry a valid CRC (MicrosliceFlags::CrcValid) and the ramp pattern of
+    all microslices in the flesnet BasicRampPattern format. All microslices
+    of a timeslice are verified as one batch, by default on the CPU, or
+    offloaded to a CUDA device if one is given and available. Timeslices
+    are verified in parallel, and their results are passed to the callback
+    in order of submission, on the thread calling put() or end_stream(). */
+class TimesliceVerifier : public fles::TimesliceSink {
+public:
+  /// The verification result of a timeslice.
+  struct Result {
+    uint64_t index = 0;
+    uint64_t microslices = 0;
+    uint64_t crc_errors = 0;
+    uint64_t pattern_errors = 0;
+    /// The verification flags (see VerificationEngine.hpp) of each
+    /// microslice of each component
+    std::vector<std::vector<uint8_t>> flags;
+  };
+
+  using Callback = std::function<void(const Result&)>;
+
+  /// The TimesliceVerifier constructor.
+  /** \param callback    Called with the result of each timeslice
+      \param device      CUDA device to offload to, -1 for the CPU
+      \param num_threads Number of timeslices verified in parallel
+      \param max_pending Number of timeslices after which put() blocks */
+  explicit TimesliceVerifier(Callback callback,
+                             int device = -1,
+                             unsigned num_threads = 1,
+                             std::size_t max_pending = 8);
+
+  TimesliceVerifier(const TimesliceVerifier&) = delete;
+  void operator=(const TimesliceVerifier&) = delete;
+
+  /// The TimesliceVerifier destructor, completing pending timeslices.
+  ~TimesliceVerifier() override;
+
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
+
+  void end_stream() override;
+
+  /// Retrieve the name of the engine in use (e.g., "cpu", "cuda:0").
+  [[nodiscard]] const std::string& engine_name() const {
+    return engine_name_;
+  }
+
+  /// Retrieve the number of microslices verified so far.
+  [[nodiscard]] uint64_t microslices() const { return microslices_; }
+
+  /// Retrieve the number of microslices found with a CRC mismatch.
+  [[nodiscard]] uint64_t crc_errors() const { return crc_errors_; }
+
+  /// Retrieve the number of microslices found with a pattern mismatch.
+  [[nodiscard]] uint64_t pattern_errors() const { return pattern_errors_; }
+
+private:
+  struct Job {
+    std::shared_ptr<const fles::Timeslice> timeslice;
+    std::vector<VerificationItem> items;
+    std::vector<uint8_t> flags;
+    bool done = false;
+  };
+
+  void work(VerificationEngine& engine);
+
+  /// Pass the results of completed jobs to the callback, in order.
+  /** If wait_count is given, wait until at most this number of jobs is
+      left pending. */
+  void deliver(std::size_t wait_count);
+
+  Callback callback_;
+  std::vector<std::unique_ptr<VerificationEngine>> engines_;
+  std::string engine_name_;
+  std::size_t max_pending_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  /// Submitted jobs in order, the first `started_` of them are (being) done.
+  std::deque<std::unique_ptr<Job>> jobs_;
+  std::size_t started_ = 0;
+  bool stopped_ = false;
+  std::vector<std::thread> threads_;
+
+  std::atomic<uint64_t> microslices_{0};
+  std::atomic<uint64_t> crc_errors_{0};
+  std::atomic<uint64_t> pattern_errors_{0};
+};
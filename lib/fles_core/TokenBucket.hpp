@@ -0,0 +1,98 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+/// Token bucket pacing class with congestion response.
+/** A TokenBucket object spaces transfers to an average rate, allowing
+    bursts of up to a given number of bytes. A transfer is admitted while
+    the bucket holds tokens and may overdraw it, so that transfers larger
+    than the burst size are possible and are followed by a corresponding
+    pause. On a congestion signal, the rate is reduced multiplicatively;
+    without congestion, it first recovers towards the rate before the
+    reduction and then increases additively up to the maximum rate (like
+    the rate control of DCQCN). */
+
+class TokenBucket {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /// The TokenBucket constructor.
+  /**
+     \param max_rate Maximum rate in bytes per second
+     \param burst    Maximum burst size in bytes
+     \param now      Current time
+  */
+  TokenBucket(double max_rate, double burst, clock::time_point now)
+      : max_rate_(max_rate), burst_(burst), rate_(max_rate),
+        target_rate_(max_rate), tokens_(burst), last_refill_(now) {}
+
+  /// Check whether a transfer may start at the given time.
+  [[nodiscard]] bool admits(clock::time_point now) {
+    refill(now);
+    return tokens_ > 0.0;
+  }
+
+  /// Account for a transfer of the given size started at the given time.
+  void consume(double bytes, clock::time_point now) {
+    refill(now);
+    tokens_ -= bytes;
+  }
+
+  /// Reduce the rate in response to congestion.
+  void congestion(clock::time_point now) {
+    refill(now);
+    target_rate_ = rate_;
+    rate_ = std::max(rate_ * (1.0 - rate_decrease), max_rate_ * min_rate);
+    recovery_steps_ = 0;
+  }
+
+  /// Recover the rate in the absence of congestion.
+  void no_congestion(clock::time_point now) {
+    refill(now);
+    if (recovery_steps_ < fast_recovery_steps) {
+      ++recovery_steps_;
+    } else {
+      target_rate_ = std::min(target_rate_ + max_rate_ * rate_increase,
+                              max_rate_);
+    }
+    rate_ = (rate_ + target_rate_) / 2.0;
+  }
+
+  /// Retrieve the current rate in bytes per second.
+  [[nodiscard]] double rate() const { return rate_; }
+
+  /// Retrieve the maximum rate in bytes per second.
+  [[nodiscard]] double max_rate() const { return max_rate_; }
+
+  /// Relative rate reduction per congestion signal.
+  static constexpr double rate_decrease = 0.25;
+
+  /// Lower limit of the rate relative to the maximum rate.
+  static constexpr double min_rate = 0.01;
+
+  /// Number of recovery steps towards the rate before the last reduction.
+  static constexpr unsigned int fast_recovery_steps = 5;
+
+  /// Additive rate increase per step after recovery, relative to the
+  /// maximum rate.
+  static constexpr double rate_increase = 0.02;
+
+private:
+  void refill(clock::time_point now) {
+    if (now > last_refill_) {
+      std::chrono::duration<double> elapsed = now - last_refill_;
+      tokens_ = std::min(tokens_ + elapsed.count() * rate_, burst_);
+      last_refill_ = now;
+    }
+  }
+
+  double max_rate_;
+  double burst_;
+  double rate_;
+  double target_rate_;
+  double tokens_;
+  clock::time_point last_refill_;
+  unsigned int recovery_steps_ = 0;
+};
@@ -0,0 +1,235 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "VerificationEngine.hpp"
+#include "RampPattern.hpp"
+#include "interface.h" // crcutil_interface
+#include <stdexcept>
+#include <vector>
+
+#ifdef HAVE_CUDA
+#include "VerificationKernels.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cuda_runtime_api.h>
+#endif
+
+namespace {
+
+/// Verification on the CPU, CRCs computed in one batch.
+class CpuVerificationEngine : public VerificationEngine {
+public:
+  CpuVerificationEngine()
+      : crc32_engine_(crcutil_interface::CRC::Create(
+            0x82f63b78, 0, 32, true, 0, 0, 0,
+            crcutil_interface::CRC::IsSSE42Available(), nullptr)),
+        level_(ramp_pattern::supported_level()) {}
+
+  CpuVerificationEngine(const CpuVerificationEngine&) = delete;
+  void operator=(const CpuVerificationEngine&) = delete;
+
+  ~CpuVerificationEngine() override { crc32_engine_->Delete(); }
+
+  void verify(const VerificationItem* items,
+              std::size_t count,
+              uint8_t* flags) override {
+    data_.resize(count);
+    bytes_.resize(count);
+    crcs_.assign(count, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+      data_[i] = items[i].content;
+      bytes_[i] =
+          (flags[i] & verification::crc_checked) != 0 ? items[i].size : 0;
+    }
+    crc32_engine_->ComputeBatch(data_.data(), bytes_.data(), count,
+                                crcs_.data());
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const VerificationItem& item = items[i];
+      if ((flags[i] & verification::crc_checked) != 0 &&
+          static_cast<uint32_t>(crcs_[i]) != item.crc) {
+        flags[i] |= verification::crc_error;
+      }
+      if ((flags[i] & verification::pattern_checked) != 0) {
+        auto r = ramp_pattern::check(
+            reinterpret_cast<const uint64_t*>(item.content),
+            item.size / sizeof(uint64_t), item.pattern_first,
+            sizeof(uint64_t), level_);
+        if (r.errors != 0 || ramp_pattern::crc(r.xor_value) != item.crc) {
+          flags[i] |= verification::pattern_error;
+        }
+      }
+    }
+  }
+
+  [[nodiscard]] std::string name() const override { return "cpu"; }
+
+private:
+  crcutil_interface::CRC* crc32_engine_;
+  ramp_pattern::SimdLevel level_;
+
+  // buffers of the batch computation, reused for all batches
+  std::vector<const void*> data_;
+  std::vector<std::size_t> bytes_;
+  std::vector<crcutil_interface::UINT64> crcs_;
+};
+
+#ifdef HAVE_CUDA
+
+void check(cudaError_t err, const char* what) {
+  if (err != cudaSuccess) {
+    throw std::runtime_error(std::string("VerificationEngine: ") + what +
+                             ": " + cudaGetErrorString(err));
+  }
+}
+
+/// A growing buffer in pinned host memory or in device memory.
+class CudaBuffer {
+public:
+  explicit CudaBuffer(bool pinned) : pinned_(pinned) {}
+
+  CudaBuffer(const CudaBuffer&) = delete;
+  void operator=(const CudaBuffer&) = delete;
+
+  ~CudaBuffer() { release(); }
+
+  /// Make sure the buffer holds at least the given number of bytes.
+  void reserve(std::size_t size) {
+    if (size <= size_) {
+      return;
+    }
+    release();
+    size = std::max(size, 2 * size_);
+    if (pinned_) {
+      check(cudaHostAlloc(&ptr_, size, cudaHostAllocDefault),
+            "cudaHostAlloc");
+    } else {
+      check(cudaMalloc(&ptr_, size), "cudaMalloc");
+    }
+    size_ = size;
+  }
+
+  template <typename T> [[nodiscard]] T* get() const {
+    return static_cast<T*>(ptr_);
+  }
+
+private:
+  void release() {
+    if (ptr_ != nullptr) {
+      if (pinned_) {
+        cudaFreeHost(ptr_);
+      } else {
+        cudaFree(ptr_);
+      }
+      ptr_ = nullptr;
+    }
+  }
+
+  bool pinned_;
+  void* ptr_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+/// Verification on a CUDA device, one transfer and kernel launch per batch.
+/** The contents are gathered into a pinned staging buffer, so that the
+    host-to-device copy runs at full bandwidth. */
+class DeviceVerificationEngine : public VerificationEngine {
+public:
+  explicit DeviceVerificationEngine(int device) : device_(device) {
+    check(cudaSetDevice(device_), "cudaSetDevice");
+    check(cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking),
+          "cudaStreamCreate");
+  }
+
+  DeviceVerificationEngine(const DeviceVerificationEngine&) = delete;
+  void operator=(const DeviceVerificationEngine&) = delete;
+
+  ~DeviceVerificationEngine() override { cudaStreamDestroy(stream_); }
+
+  void verify(const VerificationItem* items,
+              std::size_t count,
+              uint8_t* flags) override {
+    if (count == 0) {
+      return;
+    }
+    // the device code reads the contents in 64-bit words
+    constexpr uint64_t align = sizeof(uint64_t);
+    uint64_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      total += (items[i].size + align - 1) & ~(align - 1);
+    }
+
+    check(cudaSetDevice(device_), "cudaSetDevice");
+    host_contents_.reserve(total);
+    device_contents_.reserve(total);
+    host_items_.reserve(count * sizeof(DeviceVerificationItem));
+    device_items_.reserve(count * sizeof(DeviceVerificationItem));
+    host_flags_.reserve(count);
+    device_flags_.reserve(count);
+
+    auto* contents = host_contents_.get<uint8_t>();
+    auto* device_items = host_items_.get<DeviceVerificationItem>();
+    uint64_t offset = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      std::memcpy(contents + offset, items[i].content, items[i].size);
+      device_items[i] = {offset, items[i].size, items[i].pattern_first,
+                         items[i].crc, 0};
+      offset += (items[i].size + align - 1) & ~(align - 1);
+    }
+    std::memcpy(host_flags_.get<uint8_t>(), flags, count);
+
+    check(cudaMemcpyAsync(device_contents_.get<uint8_t>(), contents, total,
+                          cudaMemcpyHostToDevice, stream_),
+          "cudaMemcpyAsync");
+    check(cudaMemcpyAsync(device_items_.get<DeviceVerificationItem>(),
+                          device_items,
+                          count * sizeof(DeviceVerificationItem),
+                          cudaMemcpyHostToDevice, stream_),
+          "cudaMemcpyAsync");
+    check(cudaMemcpyAsync(device_flags_.get<uint8_t>(),
+                          host_flags_.get<uint8_t>(), count,
+                          cudaMemcpyHostToDevice, stream_),
+          "cudaMemcpyAsync");
+    launch_verification_kernel(device_items_.get<DeviceVerificationItem>(),
+                               device_contents_.get<uint8_t>(),
+                               device_flags_.get<uint8_t>(), count, stream_);
+    check(cudaGetLastError(), "verification kernel launch");
+    check(cudaMemcpyAsync(host_flags_.get<uint8_t>(),
+                          device_flags_.get<uint8_t>(), count,
+                          cudaMemcpyDeviceToHost, stream_),
+          "cudaMemcpyAsync");
+    check(cudaStreamSynchronize(stream_), "cudaStreamSynchronize");
+    std::memcpy(flags, host_flags_.get<uint8_t>(), count);
+  }
+
+  [[nodiscard]] std::string name() const override {
+    return "cuda:" + std::to_string(device_);
+  }
+
+private:
+  int device_;
+  cudaStream_t stream_ = nullptr;
+
+  CudaBuffer host_contents_{true};
+  CudaBuffer device_contents_{false};
+  CudaBuffer host_items_{true};
+  CudaBuffer device_items_{false};
+  CudaBuffer host_flags_{true};
+  CudaBuffer device_flags_{false};
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<VerificationEngine> make_cpu_verification_engine() {
+  return std::make_unique<CpuVerificationEngine>();
+}
+
+std::unique_ptr<VerificationEngine>
+make_device_verification_engine([[maybe_unused]] int device) {
+#ifdef HAVE_CUDA
+  return std::make_unique<DeviceVerificationEngine>(device);
+#else
+  throw std::runtime_error("VerificationEngine: built without CUDA support");
+#endif
+}
@@ -0,0 +1,52 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// Per-microslice flags of a verification (requested checks and results).
+namespace verification {
+constexpr uint8_t crc_checked = 0x01;     ///< content CRC-32C checked
+constexpr uint8_t crc_error = 0x02;       ///< content CRC-32C mismatch
+constexpr uint8_t pattern_checked = 0x04; ///< ramp pattern checked
+constexpr uint8_t pattern_error = 0x08;   ///< ramp pattern mismatch
+} // namespace verification
+
+/// A microslice to be verified.
+struct VerificationItem {
+  const uint8_t* content;
+  uint64_t size;
+  /// First word of the expected ramp pattern (see RampPattern.hpp)
+  uint64_t pattern_first;
+  /// Expected content CRC-32C or pattern CRC value
+  uint32_t crc;
+};
+
+/// Abstract base class of the engines computing microslice verifications.
+/** An engine is used by a single thread at a time. */
+class VerificationEngine {
+public:
+  virtual ~VerificationEngine() = default;
+
+  /// Verify a batch of microslices.
+  /** On entry, flags[i] holds the requested checks (crc_checked,
+      pattern_checked) of items[i]; the engine adds the corresponding
+      error flags on mismatch. */
+  virtual void
+  verify(const VerificationItem* items, std::size_t count, uint8_t* flags) = 0;
+
+  /// Retrieve a short description of the engine.
+  [[nodiscard]] virtual std::string name() const = 0;
+};
+
+/// Create an engine running on the CPU (SSE4.2 CRC and SIMD pattern check).
+std::unique_ptr<VerificationEngine> make_cpu_verification_engine();
+
+/// Create an engine offloading the verification to a CUDA device.
+/** Each call to verify() copies the contents to the device in one transfer
+    and checks all microslices of the batch in a single kernel launch.
+    \throws std::runtime_error if built without CUDA support or if the
+    device cannot be used */
+std::unique_ptr<VerificationEngine> make_device_verification_engine(int device);
@@ -0,0 +1,73 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "VerificationEngine.hpp"
+#include "VerificationKernels.hpp"
+#include <cuda_runtime.h>
+
+namespace {
+
+/// Check one microslice per thread.
+/** The CRC-32C lookup table is computed per block in shared memory. */
+__global__ void verify_kernel(const DeviceVerificationItem* items,
+                              const uint8_t* contents,
+                              uint8_t* flags,
+                              std::size_t count) {
+  __shared__ uint32_t table[256];
+  for (unsigned i = threadIdx.x; i < 256; i += blockDim.x) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1) != 0 ? (c >> 1) ^ 0x82f63b78 : c >> 1;
+    }
+    table[i] = c;
+  }
+  __syncthreads();
+
+  std::size_t n = static_cast<std::size_t>(blockIdx.x) * blockDim.x +
+                  threadIdx.x;
+  if (n >= count) {
+    return;
+  }
+  const DeviceVerificationItem item = items[n];
+  const uint8_t* content = contents + item.offset;
+  uint8_t f = flags[n];
+
+  if ((f & verification::crc_checked) != 0) {
+    uint32_t crc = 0xffffffff;
+    for (uint64_t i = 0; i < item.size; ++i) {
+      crc = table[(crc ^ content[i]) & 0xff] ^ (crc >> 8);
+    }
+    if (~crc != item.crc) {
+      f |= verification::crc_error;
+    }
+  }
+
+  if ((f & verification::pattern_checked) != 0) {
+    const auto* words = reinterpret_cast<const uint64_t*>(content);
+    const uint64_t num_words = item.size / sizeof(uint64_t);
+    uint64_t xor_value = 0;
+    bool error = false;
+    for (uint64_t i = 0; i < num_words; ++i) {
+      xor_value ^= words[i];
+      error |= words[i] != item.pattern_first + i * sizeof(uint64_t);
+    }
+    if (error ||
+        static_cast<uint32_t>(xor_value ^ (xor_value >> 32)) != item.crc) {
+      f |= verification::pattern_error;
+    }
+  }
+
+  flags[n] = f;
+}
+
+} // namespace
+
+void launch_verification_kernel(const DeviceVerificationItem* items,
+                                const uint8_t* contents,
+                                uint8_t* flags,
+                                std::size_t count,
+                                void* stream) {
+  constexpr unsigned threads = 256;
+  const auto blocks = static_cast<unsigned>((count + threads - 1) / threads);
+  verify_kernel<<<blocks, threads, 0, static_cast<cudaStream_t>(stream)>>>(
+      items, contents, flags, count);
+}
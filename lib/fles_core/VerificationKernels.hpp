@@ -0,0 +1,24 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// A microslice to be verified, with its content in a device buffer.
+struct DeviceVerificationItem {
+  uint64_t offset; ///< byte offset of the content (multiple of 8)
+  uint64_t size;
+  uint64_t pattern_first;
+  uint32_t crc;
+  uint32_t reserved;
+};
+
+/// Launch the verification kernel on the given CUDA stream.
+/** All pointers refer to device memory; the flags are updated as described
+    in VerificationEngine::verify(). The stream is passed as `void*` to keep
+    CUDA types out of the host code. */
+void launch_verification_kernel(const DeviceVerificationItem* items,
+                                const uint8_t* contents,
+                                uint8_t* flags,
+                                std::size_t count,
+                                void* stream);
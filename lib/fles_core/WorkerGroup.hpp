@@ -0,0 +1,50 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the WorkerGroup class.
+#pragma once
+
+#include "ConnectionGroupWorker.hpp"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief The WorkerGroup class drives several connection group workers
+ * cooperatively in a single thread.
+ *
+ * The progress step of each worker is called in turn until all of them
+ * are done. This trades the latency of a dedicated busy-polling thread per
+ * worker for fewer busy cores. All workers must be cooperative.
+ */
+class WorkerGroup : public ConnectionGroupWorker {
+public:
+  /// The WorkerGroup constructor.
+  WorkerGroup(std::vector<ConnectionGroupWorker*> workers, std::string name)
+      : workers_(std::move(workers)), name_(std::move(name)) {}
+
+  WorkerGroup(const WorkerGroup&) = delete;
+  void operator=(const WorkerGroup&) = delete;
+
+  void operator()() override {
+    while (step()) {
+    }
+  }
+
+  bool step() override {
+    workers_.erase(std::remove_if(workers_.begin(), workers_.end(),
+                                  [](ConnectionGroupWorker* worker) {
+                                    return !worker->step();
+                                  }),
+                   workers_.end());
+    return !workers_.empty();
+  }
+
+  [[nodiscard]] bool cooperative() const override { return true; }
+
+  [[nodiscard]] std::string thread_name() const override { return name_; }
+
+private:
+  std::vector<ConnectionGroupWorker*> workers_;
+  std::string name_;
+};
@@ -0,0 +1,98 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the WorkerPool class.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed set of threads running the iterations of a loop in parallel.
+/** The calling thread takes part in the work, so a pool of n threads
+    starts n - 1 additional threads. */
+class WorkerPool {
+public:
+  explicit WorkerPool(unsigned num_threads) {
+    for (unsigned i = 1; i < num_threads; ++i) {
+      threads_.emplace_back([this] { work(); });
+    }
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  void operator=(const WorkerPool&) = delete;
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    start_.notify_all();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  /// Call fn(i) for all i in [0, count), return when all calls are done.
+  void run(size_t count, const std::function<void(size_t)>& fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fn_ = &fn;
+      count_ = count;
+      next_ = 0;
+      ++generation_;
+    }
+    start_.notify_all();
+    drain(fn, count);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    fn_ = nullptr;
+  }
+
+private:
+  void work() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      start_.wait(lock, [&] { return stopped_ || generation_ != seen; });
+      if (stopped_) {
+        return;
+      }
+      seen = generation_;
+      if (fn_ == nullptr) {
+        continue; // woken after the work was done
+      }
+      // the loop stays valid until busy_ drops to zero
+      const auto& fn = *fn_;
+      size_t count = count_;
+      ++busy_;
+      lock.unlock();
+      drain(fn, count);
+      lock.lock();
+      if (--busy_ == 0) {
+        done_.notify_all();
+      }
+    }
+  }
+
+  void drain(const std::function<void(size_t)>& fn, size_t count) {
+    for (size_t i = next_++; i < count; i = next_++) {
+      fn(i);
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const std::function<void(size_t)>* fn_ = nullptr;
+  size_t count_ = 0;
+  std::atomic<size_t> next_{0};
+  uint64_t generation_ = 0;
+  unsigned busy_ = 0;
+  bool stopped_ = false;
+  std::vector<std::thread> threads_;
+};
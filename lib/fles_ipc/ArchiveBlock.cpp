@@ -0,0 +1,435 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ArchiveBlock.hpp"
+#include "log.hpp"
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#ifdef HAVE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+namespace fles {
+
+/// A compression dictionary prepared for compression or decompression.
+class CompressionDictionary {
+public:
+  CompressionDictionary(const std::string& data, bool compress) {
+#ifdef HAVE_ZSTD
+    if (compress) {
+      cdict = ZSTD_createCDict(data.data(), data.size(), ZSTD_CLEVEL_DEFAULT);
+    } else {
+      ddict = ZSTD_createDDict(data.data(), data.size());
+    }
+    if (cdict == nullptr && ddict == nullptr) {
+      throw std::runtime_error("invalid compression dictionary");
+    }
+#else
+    (void)data;
+    (void)compress;
+#endif
+  }
+
+  CompressionDictionary(const CompressionDictionary&) = delete;
+  void operator=(const CompressionDictionary&) = delete;
+
+  ~CompressionDictionary() {
+#ifdef HAVE_ZSTD
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+#endif
+  }
+
+#ifdef HAVE_ZSTD
+  ZSTD_CDict* cdict = nullptr;
+  ZSTD_DDict* ddict = nullptr;
+#endif
+};
+
+namespace {
+
+void check_compression(ArchiveCompression compression) {
+  if (!archive_compression_supported(compression)) {
+    throw std::runtime_error(
+        "archive compression not supported by this build of fles_ipc");
+  }
+}
+
+/// Prepare the compression dictionary of an archive (if any).
+std::shared_ptr<const CompressionDictionary>
+make_dictionary(const ArchiveDescriptor& descriptor, bool compress) {
+  if (descriptor.archive_compression() == ArchiveCompression::None ||
+      descriptor.compression_dictionary().empty()) {
+    return nullptr;
+  }
+  return std::make_shared<const CompressionDictionary>(
+      descriptor.compression_dictionary(), compress);
+}
+
+ArchiveBlock
+compress_block(ArchiveBlock block,
+               ArchiveCompression compression,
+               const std::shared_ptr<const CompressionDictionary>& dictionary) {
+  block.raw_size = block.data.size();
+#ifdef HAVE_ZSTD
+  if (compression == ArchiveCompression::Zstd) {
+    std::string out(ZSTD_compressBound(block.data.size()), '\0');
+    std::size_t size = 0;
+    if (dictionary) {
+      std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx(
+          ZSTD_createCCtx(), ZSTD_freeCCtx);
+      size = ZSTD_compress_usingCDict(cctx.get(), out.data(), out.size(),
+                                      block.data.data(), block.data.size(),
+                                      dictionary->cdict);
+    } else {
+      size = ZSTD_compress(out.data(), out.size(), block.data.data(),
+                           block.data.size(), ZSTD_CLEVEL_DEFAULT);
+    }
+    if (ZSTD_isError(size) != 0u) {
+      throw std::runtime_error(std::string("zstd compression failed: ") +
+                               ZSTD_getErrorName(size));
+    }
+    out.resize(size);
+    block.data = std::move(out);
+  }
+#else
+  (void)compression;
+  (void)dictionary;
+#endif
+  block.digest = block_digest(block.data.data(), block.data.size());
+  return block;
+}
+
+ArchiveBlock decompress_block(
+    ArchiveBlock block,
+    ArchiveCompression compression,
+    const std::shared_ptr<const CompressionDictionary>& dictionary,
+    bool verify) {
+  if (verify &&
+      block_digest(block.data.data(), block.data.size()) != block.digest) {
+    throw std::runtime_error("archive block digest mismatch");
+  }
+#ifdef HAVE_ZSTD
+  if (compression == ArchiveCompression::Zstd) {
+    // the frame records the uncompressed size, check before allocating
+    unsigned long long frame_size =
+        ZSTD_getFrameContentSize(block.data.data(), block.data.size());
+    if (frame_size == ZSTD_CONTENTSIZE_ERROR ||
+        (frame_size != ZSTD_CONTENTSIZE_UNKNOWN &&
+         frame_size != block.raw_size)) {
+      throw std::runtime_error("zstd decompression failed");
+    }
+    std::string out(block.raw_size, '\0');
+    std::size_t size = 0;
+    if (dictionary) {
+      std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(
+          ZSTD_createDCtx(), ZSTD_freeDCtx);
+      size = ZSTD_decompress_usingDDict(dctx.get(), out.data(), out.size(),
+                                        block.data.data(), block.data.size(),
+                                        dictionary->ddict);
+    } else {
+      size = ZSTD_decompress(out.data(), out.size(), block.data.data(),
+                             block.data.size());
+    }
+    if (ZSTD_isError(size) != 0u || size != block.raw_size) {
+      throw std::runtime_error("zstd decompression failed");
+    }
+    block.data = std::move(out);
+  }
+#else
+  (void)compression;
+  (void)dictionary;
+#endif
+  return block;
+}
+
+/// Size of the block header as stored in an archive.
+std::size_t block_header_size(bool digests) {
+  return digests ? sizeof(ArchiveBlockHeader)
+                 : offsetof(ArchiveBlockHeader, digest);
+}
+
+/// Retrieve the size of a stream, or -1 if it is not seekable.
+std::streamoff stream_size(std::istream& is) {
+  std::streampos pos = is.tellg();
+  if (pos == std::streampos(-1)) {
+    is.clear();
+    return -1;
+  }
+  is.seekg(0, std::ios::end);
+  std::streampos end = is.tellg();
+  is.clear();
+  is.seekg(pos);
+  if (!is) {
+    throw std::ios_base::failure("error seeking in archive stream");
+  }
+  return end == std::streampos(-1) ? -1 : std::streamoff(end);
+}
+
+/// Check that the block following a header lies within the stream.
+void check_block_size(const ArchiveBlockHeader& header,
+                      std::istream& is,
+                      std::streamoff end) {
+  if (end < 0) {
+    return;
+  }
+  std::streamoff pos = is.tellg();
+  if (pos < 0 || pos > end ||
+      header.compressed_size > static_cast<uint64_t>(end - pos)) {
+    throw std::runtime_error("archive block exceeds the end of the file");
+  }
+}
+
+} // namespace
+
+bool archive_compression_supported(ArchiveCompression compression) {
+  switch (compression) {
+  case ArchiveCompression::None:
+    return true;
+  case ArchiveCompression::Zstd:
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+std::string
+train_compression_dictionary(const std::vector<std::string>& samples,
+                             std::size_t max_size) {
+#ifdef HAVE_ZSTD
+  std::string buffer;
+  std::vector<std::size_t> sizes;
+  for (const auto& sample : samples) {
+    buffer += sample;
+    sizes.push_back(sample.size());
+  }
+  std::string dictionary(max_size, '\0');
+  std::size_t size = ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), buffer.data(), sizes.data(),
+      static_cast<unsigned>(sizes.size()));
+  if (ZDICT_isError(size) != 0u) {
+    throw std::runtime_error(std::string("dictionary training failed: ") +
+                             ZDICT_getErrorName(size));
+  }
+  dictionary.resize(size);
+  return dictionary;
+#else
+  (void)samples;
+  (void)max_size;
+  throw std::runtime_error(
+      "dictionary training not supported by this build of fles_ipc");
+#endif
+}
+
+BlockVerification verify_archive_blocks(const std::string& filename,
+                                        std::size_t threads) {
+  std::ifstream ifs(filename, std::ios::binary);
+  if (!ifs) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+  ArchiveDescriptor descriptor;
+  {
+    boost::archive::binary_iarchive iarchive(ifs);
+    iarchive >> descriptor;
+  }
+  if (descriptor.archive_compression() == ArchiveCompression::None) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not stored in compressed blocks");
+  }
+
+  BlockVerification result;
+  std::size_t header_size = block_header_size(descriptor.block_digests());
+  std::streamoff end = stream_size(ifs);
+  std::size_t max_pending = threads > 0 ? threads : 1;
+  std::deque<std::future<bool>> pending;
+  auto check_front = [&pending, &result] {
+    std::future<bool> front = std::move(pending.front());
+    pending.pop_front();
+    if (!front.get()) {
+      ++result.corrupt;
+    }
+  };
+
+  while (true) {
+    ArchiveBlockHeader header{};
+    ifs.read(reinterpret_cast<char*>(&header),
+             static_cast<std::streamsize>(header_size));
+    if (ifs.gcount() == 0 && ifs.eof()) {
+      break;
+    }
+    if (!ifs) {
+      throw std::ios_base::failure("truncated archive block header");
+    }
+    check_block_size(header, ifs, end);
+    std::string data(header.compressed_size, '\0');
+    ifs.read(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!ifs) {
+      throw std::ios_base::failure("truncated archive block");
+    }
+    ++result.blocks;
+    result.bytes += data.size();
+    if (!descriptor.block_digests()) {
+      ++result.unchecked;
+      continue;
+    }
+    while (pending.size() >= max_pending) {
+      check_front();
+    }
+    pending.push_back(std::async(
+        std::launch::async,
+        [](const std::string& d, uint64_t digest) {
+          return block_digest(d.data(), d.size()) == digest;
+        },
+        std::move(data), header.digest));
+  }
+  while (!pending.empty()) {
+    check_front();
+  }
+  return result;
+}
+
+ArchiveBlockWriter::ArchiveBlockWriter(std::ostream& os,
+                                       const ArchiveDescriptor& descriptor,
+                                       std::size_t items_per_block,
+                                       std::size_t max_pending)
+    : os_(os), compression_(descriptor.archive_compression()),
+      items_per_block_(items_per_block > 0 ? items_per_block : 1),
+      max_pending_(max_pending > 0 ? max_pending : 1) {
+  check_compression(compression_);
+  dictionary_ = make_dictionary(descriptor, true);
+}
+
+ArchiveBlockWriter::~ArchiveBlockWriter() {
+  try {
+    finish();
+  } catch (std::exception& e) {
+    L_(error) << "error writing archive blocks: " << e.what();
+  }
+}
+
+void ArchiveBlockWriter::finish() {
+  if (oarchive_) {
+    finish_block();
+  }
+  while (!pending_.empty()) {
+    write_front();
+  }
+  os_.flush();
+}
+
+void ArchiveBlockWriter::start_block() {
+  block_.clear();
+  block_stream_ = std::make_unique<BlockStream>(block_);
+  oarchive_ = std::make_unique<boost::archive::binary_oarchive>(*block_stream_);
+  block_items_ = 0;
+}
+
+void ArchiveBlockWriter::finish_block() {
+  oarchive_ = nullptr;
+  block_stream_->flush();
+  block_stream_ = nullptr;
+
+  while (pending_.size() >= max_pending_) {
+    write_front();
+  }
+
+  ArchiveBlock block{std::move(block_), 0, block_items_};
+  block_ = std::string();
+  block_items_ = 0;
+  pending_.push_back(std::async(std::launch::async, compress_block,
+                                std::move(block), compression_,
+                                dictionary_));
+}
+
+void ArchiveBlockWriter::write_front() {
+  std::future<ArchiveBlock> front = std::move(pending_.front());
+  pending_.pop_front();
+  ArchiveBlock block = front.get();
+
+  ArchiveBlockHeader header{block.data.size(), block.raw_size,
+                            block.num_items, block.digest};
+  os_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os_.write(block.data.data(), static_cast<std::streamsize>(block.data.size()));
+  if (!os_) {
+    throw std::ios_base::failure("error writing archive block");
+  }
+}
+
+ArchiveBlockReader::ArchiveBlockReader(std::istream& is,
+                                       const ArchiveDescriptor& descriptor,
+                                       std::size_t read_ahead)
+    : is_(is), compression_(descriptor.archive_compression()),
+      digests_(descriptor.block_digests()),
+      read_ahead_(read_ahead > 0 ? read_ahead : 1) {
+  check_compression(compression_);
+  dictionary_ = make_dictionary(descriptor, false);
+  stream_end_ = stream_size(is_);
+}
+
+ArchiveBlockReader::~ArchiveBlockReader() {
+  // wait for background decompression to finish before destruction
+  for (auto& f : pending_) {
+    f.wait();
+  }
+}
+
+bool ArchiveBlockReader::read_block() {
+  if (stream_eof_) {
+    return false;
+  }
+
+  ArchiveBlockHeader header{};
+  is_.read(reinterpret_cast<char*>(&header),
+           static_cast<std::streamsize>(block_header_size(digests_)));
+  if (is_.gcount() == 0 && is_.eof()) {
+    stream_eof_ = true;
+    return false;
+  }
+  if (!is_) {
+    throw std::ios_base::failure("truncated archive block header");
+  }
+  check_block_size(header, is_, stream_end_);
+
+  ArchiveBlock block{std::string(header.compressed_size, '\0'),
+                     header.uncompressed_size, header.num_items,
+                     header.digest};
+  is_.read(block.data.data(),
+           static_cast<std::streamsize>(header.compressed_size));
+  if (!is_) {
+    throw std::ios_base::failure("truncated archive block");
+  }
+
+  pending_.push_back(std::async(std::launch::async, decompress_block,
+                                std::move(block), compression_, dictionary_,
+                                digests_));
+  return true;
+}
+
+void ArchiveBlockReader::next_block() {
+  iarchive_ = nullptr;
+  block_stream_ = nullptr;
+
+  do {
+    // keep up to read_ahead_ blocks decompressing while this one is consumed
+    while (pending_.size() < read_ahead_ + 1 && read_block()) {
+    }
+    if (pending_.empty()) {
+      throw boost::archive::archive_exception(
+          boost::archive::archive_exception::input_stream_error);
+    }
+    std::future<ArchiveBlock> front = std::move(pending_.front());
+    pending_.pop_front();
+    current_ = front.get();
+  } while (current_.num_items == 0);
+
+  block_stream_ = std::make_unique<BlockStream>(current_.data.data(),
+                                                current_.data.size());
+  iarchive_ = std::make_unique<boost::archive::binary_iarchive>(*block_stream_);
+  current_items_ = current_.num_items;
+}
+
+} // namespace fles
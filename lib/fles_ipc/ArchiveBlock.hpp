@@ -0,0 +1,226 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ArchiveBlockWriter and fles::ArchiveBlockReader
+/// classes.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "BlockDigest.hpp"
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+#pragma pack(1)
+
+/**
+ * \brief The header preceding each compressed block in an archive file.
+ *
+ * The digest field is only present if the archive descriptor indicates
+ * block digests (see ArchiveDescriptor::block_digests()).
+ */
+struct ArchiveBlockHeader {
+  uint64_t compressed_size;   ///< Size (in bytes) of the compressed block
+  uint64_t uncompressed_size; ///< Size (in bytes) after decompression
+  uint64_t num_items;         ///< Number of data sets in the block
+  uint64_t digest;            ///< Digest of the compressed block
+};
+
+#pragma pack()
+
+/// Check if the given archive compression is supported by this build.
+[[nodiscard]] bool
+archive_compression_supported(ArchiveCompression compression);
+
+/**
+ * \brief Train a compression dictionary on samples of archive data.
+ *
+ * The dictionary can be stored in an ArchiveDescriptor to improve the
+ * compression of small blocks of similar data, e.g., of a single subsystem.
+ *
+ * \param samples  The sample data, e.g., timeslice component contents
+ * \param max_size Maximum size (in bytes) of the dictionary
+ *
+ * \throws std::runtime_error if training fails or is not supported
+ */
+[[nodiscard]] std::string
+train_compression_dictionary(const std::vector<std::string>& samples,
+                             std::size_t max_size = 112640);
+
+/**
+ * \brief Check the block digests of a compressed archive file without
+ * decompressing or decoding its contents.
+ *
+ * \param filename File name of the archive file
+ * \param threads  Number of blocks checked concurrently
+ *
+ * \throws std::runtime_error if the archive is not compressed
+ */
+BlockVerification verify_archive_blocks(const std::string& filename,
+                                        std::size_t threads);
+
+/// A compression dictionary prepared for use (defined by the implementation).
+class CompressionDictionary;
+
+/// A serialized (compressed or uncompressed) block of data sets.
+struct ArchiveBlock {
+  std::string data;       ///< The block contents
+  uint64_t raw_size = 0;  ///< Size (in bytes) of the uncompressed contents
+  uint64_t num_items = 0; ///< Number of data sets in the block
+  uint64_t digest = 0;    ///< Digest of the compressed contents
+};
+
+/**
+ * \brief The ArchiveBlockWriter class writes data sets to an output stream
+ * in independently compressed blocks.
+ *
+ * Data sets are serialized into a block on the calling thread. Full blocks
+ * are compressed and their digests computed on background threads, so that
+ * neither stalls the caller, and written to the stream in order. Each block
+ * is a complete boost binary archive of its data sets and can be decoded on
+ * its own, given the compression dictionary of the archive (if any).
+ */
+class ArchiveBlockWriter {
+public:
+  /**
+   * \brief Construct a block writer on the given output stream.
+   *
+   * \param os              Output stream to write the blocks to
+   * \param descriptor      Descriptor of the archive, specifying the
+   *                        compression algorithm and dictionary
+   * \param items_per_block Maximum number of data sets in each block
+   * \param max_pending     Maximum number of blocks compressed concurrently
+   */
+  ArchiveBlockWriter(std::ostream& os,
+                     const ArchiveDescriptor& descriptor,
+                     std::size_t items_per_block = 16,
+                     std::size_t max_pending = 4);
+
+  /// Delete copy constructor (non-copyable).
+  ArchiveBlockWriter(const ArchiveBlockWriter&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ArchiveBlockWriter&) = delete;
+
+  /// Destruct the block writer, writing all remaining data.
+  ~ArchiveBlockWriter();
+
+  /// Serialize a data set into the current block.
+  template <class T> void put(const T& item) {
+    if (!oarchive_) {
+      start_block();
+    }
+    *oarchive_ << item;
+    if (++block_items_ == items_per_block_ ||
+        block_.size() >= max_block_bytes_) {
+      finish_block();
+    }
+  }
+
+  /// Compress and write all pending data sets to the stream.
+  void finish();
+
+private:
+  using BlockStream = boost::iostreams::stream<
+      boost::iostreams::back_insert_device<std::string>>;
+
+  void start_block();
+  void finish_block();
+  void write_front();
+
+  /// Blocks are completed early if they exceed this size.
+  static constexpr std::size_t max_block_bytes_ = 256 * 1024 * 1024;
+
+  std::ostream& os_;
+  ArchiveCompression compression_;
+  std::shared_ptr<const CompressionDictionary> dictionary_;
+  std::size_t items_per_block_;
+  std::size_t max_pending_;
+
+  std::string block_;
+  std::unique_ptr<BlockStream> block_stream_;
+  std::unique_ptr<boost::archive::binary_oarchive> oarchive_;
+  std::size_t block_items_ = 0;
+
+  std::deque<std::future<ArchiveBlock>> pending_;
+};
+
+/**
+ * \brief The ArchiveBlockReader class reads data sets from an input stream
+ * of compressed blocks written by ArchiveBlockWriter.
+ *
+ * Blocks following the current one are read, checked against their digest
+ * (if present) and decompressed on background threads ahead of the
+ * consumer. A corrupt block, or a block size exceeding the stream, raises
+ * a std::runtime_error.
+ */
+class ArchiveBlockReader {
+public:
+  /**
+   * \brief Construct a block reader on the given input stream.
+   *
+   * \param is         Input stream to read the blocks from
+   * \param descriptor Descriptor of the archive, specifying the compression
+   *                   algorithm and dictionary used
+   * \param read_ahead Maximum number of blocks decompressed in advance
+   */
+  ArchiveBlockReader(std::istream& is,
+                     const ArchiveDescriptor& descriptor,
+                     std::size_t read_ahead = 2);
+
+  /// Delete copy constructor (non-copyable).
+  ArchiveBlockReader(const ArchiveBlockReader&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ArchiveBlockReader&) = delete;
+
+  ~ArchiveBlockReader();
+
+  /**
+   * \brief Deserialize the next data set.
+   *
+   * At the end of the stream, a boost::archive::archive_exception with code
+   * input_stream_error is thrown, as with a plain boost archive.
+   */
+  template <class T> void get(T& item) {
+    if (current_items_ == 0) {
+      next_block();
+    }
+    *iarchive_ >> item;
+    --current_items_;
+  }
+
+private:
+  using BlockStream = boost::iostreams::stream<boost::iostreams::array_source>;
+
+  void next_block();
+  bool read_block();
+
+  std::istream& is_;
+  ArchiveCompression compression_;
+  std::shared_ptr<const CompressionDictionary> dictionary_;
+  bool digests_;
+  std::size_t read_ahead_;
+
+  ArchiveBlock current_;
+  std::unique_ptr<BlockStream> block_stream_;
+  std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
+  uint64_t current_items_ = 0;
+
+  std::deque<std::future<ArchiveBlock>> pending_;
+  bool stream_eof_ = false;
+  /// The size of the stream, to check block sizes against (-1 if unknown).
+  std::streamoff stream_end_ = -1;
+};
+
+} // namespace fles
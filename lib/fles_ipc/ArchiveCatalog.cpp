@@ -0,0 +1,86 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ArchiveCatalog.hpp"
+#include <algorithm>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace fles {
+
+void ArchiveCatalog::load(const std::string& catalog_filename) {
+  std::ifstream ifs(catalog_filename);
+  if (!ifs) {
+    throw std::ios_base::failure("error opening file \"" + catalog_filename +
+                                 "\"");
+  }
+  std::string line;
+  std::size_t line_number = 0;
+  while (std::getline(ifs, line)) {
+    ++line_number;
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    std::istringstream iss(line);
+    ArchiveCatalogEntry entry;
+    iss >> entry.first_index >> entry.last_index >> entry.first_time >>
+        entry.last_time >> entry.count >> entry.size >> std::ws;
+    std::getline(iss, entry.filename);
+    if (!iss || entry.filename.empty()) {
+      throw std::runtime_error("invalid entry in catalog \"" +
+                               catalog_filename + "\", line " +
+                               std::to_string(line_number));
+    }
+    entries_.push_back(std::move(entry));
+  }
+}
+
+void ArchiveCatalog::append(const std::string& catalog_filename,
+                            const ArchiveCatalogEntry& entry) {
+  // a single write per entry, so that concurrent writers do not interleave
+  std::ostringstream line;
+  line << entry.first_index << ' ' << entry.last_index << ' '
+       << entry.first_time << ' ' << entry.last_time << ' ' << entry.count
+       << ' ' << entry.size << ' ' << entry.filename << '\n';
+  std::ofstream ofs(catalog_filename, std::ios::app);
+  ofs << line.str() << std::flush;
+  if (!ofs) {
+    throw std::ios_base::failure("error writing file \"" + catalog_filename +
+                                 "\"");
+  }
+}
+
+std::vector<ArchiveCatalogEntry> ArchiveCatalog::find_time(uint64_t from,
+                                                           uint64_t to) const {
+  std::vector<ArchiveCatalogEntry> result;
+  std::copy_if(entries_.begin(), entries_.end(), std::back_inserter(result),
+               [from, to](const ArchiveCatalogEntry& e) {
+                 return e.count > 0 && e.first_time < to && e.last_time >= from;
+               });
+  std::stable_sort(result.begin(), result.end(),
+                   [](const ArchiveCatalogEntry& a,
+                      const ArchiveCatalogEntry& b) {
+                     return a.first_time < b.first_time;
+                   });
+  return result;
+}
+
+std::vector<ArchiveCatalogEntry> ArchiveCatalog::find_index(uint64_t from,
+                                                            uint64_t to) const {
+  std::vector<ArchiveCatalogEntry> result;
+  std::copy_if(entries_.begin(), entries_.end(), std::back_inserter(result),
+               [from, to](const ArchiveCatalogEntry& e) {
+                 return e.count > 0 && e.first_index < to &&
+                        e.last_index >= from;
+               });
+  std::stable_sort(result.begin(), result.end(),
+                   [](const ArchiveCatalogEntry& a,
+                      const ArchiveCatalogEntry& b) {
+                     return a.first_index < b.first_index;
+                   });
+  return result;
+}
+
+} // namespace fles
@@ -0,0 +1,80 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ArchiveCatalog class.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/// A single entry of an archive catalog, describing one archive file.
+struct ArchiveCatalogEntry {
+  std::string filename;  ///< Absolute path of the archive file
+  uint64_t first_index;  ///< Index of the first data set
+  uint64_t last_index;   ///< Index of the last data set
+  uint64_t first_time;   ///< Start time of the first data set
+  uint64_t last_time;    ///< Start time of the last data set
+  uint64_t count;        ///< Number of data sets
+  uint64_t size;         ///< Size of the file in bytes
+};
+
+/**
+ * \brief The ArchiveCatalog class lists archive files together with the
+ * range of data sets they contain.
+ *
+ * A catalog file is a text file with one line per archive file, written
+ * by OutputArchiveSequence when it closes a file. The format is
+ * "<first_index> <last_index> <first_time> <last_time> <count> <size>
+ * <filename>". Catalogs written on different nodes can thus be combined by
+ * loading them together or simply by concatenating them. Combined with the
+ * sidecar index of each file (see ArchiveIndex), the data sets of a time
+ * range can be located without opening unrelated files.
+ */
+class ArchiveCatalog {
+public:
+  /// Construct an empty catalog.
+  ArchiveCatalog() = default;
+
+  /// Read the entries of a catalog file and add them to the catalog.
+  void load(const std::string& catalog_filename);
+
+  /// Append an entry to a catalog file.
+  static void append(const std::string& catalog_filename,
+                     const ArchiveCatalogEntry& entry);
+
+  /// Retrieve all entries in the order they were loaded.
+  [[nodiscard]] const std::vector<ArchiveCatalogEntry>& entries() const {
+    return entries_;
+  }
+
+  /**
+   * \brief Find the archive files containing data sets with a start time in
+   * the given range.
+   *
+   * \param from First start time of the range
+   * \param to   End of the range (exclusive)
+   *
+   * \return The matching entries in ascending order of first start time
+   */
+  [[nodiscard]] std::vector<ArchiveCatalogEntry> find_time(uint64_t from,
+                                                           uint64_t to) const;
+
+  /**
+   * \brief Find the archive files containing data sets with an index in the
+   * given range.
+   *
+   * \param from First index of the range
+   * \param to   End of the range (exclusive)
+   *
+   * \return The matching entries in ascending order of first index
+   */
+  [[nodiscard]] std::vector<ArchiveCatalogEntry> find_index(uint64_t from,
+                                                            uint64_t to) const;
+
+private:
+  std::vector<ArchiveCatalogEntry> entries_;
+};
+
+} // namespace fles
@@ -3,17 +3,22 @@
 /// \brief Defines the fles::ArchiveDescriptor class.
 #pragma once
 
+#include "BlockDigest.hpp"
 #include "System.hpp"
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/version.hpp>
 #include <chrono>
 #include <string>
+#include <utility>
 
 namespace fles {
 
 /// The archive type enum (e.g., timeslice, microslice)
 enum class ArchiveType { TimesliceArchive, MicrosliceArchive };
 
+/// The archive compression enum
+enum class ArchiveCompression { None, Zstd };
+
 template <class Base, class Derived, ArchiveType archive_type>
 class InputArchive;
 
@@ -29,9 +34,16 @@ public:
    * \brief Public constructor.
    *
    * \param archive_type The type of archive (e.g., timeslice, microslice).
+   * \param archive_compression The compression used for the data sets.
+   * \param compression_dictionary The dictionary used for compression
+   * (see train_compression_dictionary()), empty for none.
    */
-  explicit ArchiveDescriptor(ArchiveType archive_type)
-      : archive_type_(archive_type) {
+  explicit ArchiveDescriptor(
+      ArchiveType archive_type,
+      ArchiveCompression archive_compression = ArchiveCompression::None,
+      std::string compression_dictionary = {})
+      : archive_type_(archive_type), archive_compression_(archive_compression),
+        compression_dictionary_(std::move(compression_dictionary)) {
     time_created_ =
         std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     hostname_ = fles::system::current_hostname();
@@ -41,6 +53,20 @@ public:
   /// Retrieve the type of archive.
   [[nodiscard]] ArchiveType archive_type() const { return archive_type_; }
 
+  /// Retrieve the compression used for the data sets in the archive.
+  [[nodiscard]] ArchiveCompression archive_compression() const {
+    return archive_compression_;
+  }
+
+  /// Retrieve the dictionary used for compression (empty for none).
+  [[nodiscard]] const std::string& compression_dictionary() const {
+    return compression_dictionary_;
+  }
+
+  /// Retrieve whether each compressed block carries a digest (see
+  /// ArchiveBlockHeader).
+  [[nodiscard]] bool block_digests() const { return block_digests_; }
+
   /// Retrieve the time of creation of the archive.
   [[nodiscard]] std::time_t time_created() const { return time_created_; }
 
@@ -59,6 +85,8 @@ private:
   friend class InputArchiveLoop;
   template <class Base, class Derived, ArchiveType archive_type>
   friend class InputArchiveSequence;
+  friend BlockVerification verify_archive_blocks(const std::string& filename,
+                                                 std::size_t threads);
 
   ArchiveDescriptor() = default;
 
@@ -72,9 +100,24 @@ private:
     ar& time_created_;
     ar& hostname_;
     ar& username_;
+    if (version > 1) {
+      ar& archive_compression_;
+    } else {
+      archive_compression_ = ArchiveCompression::None;
+    }
+    if (version > 2) {
+      ar& compression_dictionary_;
+    } else {
+      compression_dictionary_.clear();
+    }
+    // blocks are written with digests since version 4
+    block_digests_ = version > 3;
   }
 
   ArchiveType archive_type_{};
+  ArchiveCompression archive_compression_{};
+  std::string compression_dictionary_;
+  bool block_digests_ = true;
   std::time_t time_created_ = std::time_t();
   std::string hostname_;
   std::string username_;
@@ -84,5 +127,5 @@ private:
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
-BOOST_CLASS_VERSION(fles::ArchiveDescriptor, 1)
+BOOST_CLASS_VERSION(fles::ArchiveDescriptor, 4)
 #pragma GCC diagnostic pop
@@ -0,0 +1,136 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ArchiveIndex.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace fles {
+
+bool ArchiveIndex::load(const std::string& archive_filename,
+                        const ArchiveDescriptor& descriptor) {
+  entries_.clear();
+
+  std::ifstream ifs(index_filename(archive_filename), std::ios::binary);
+  if (!ifs) {
+    return false;
+  }
+
+  Header header{};
+  ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!ifs || header.magic != magic_ || header.version != version_) {
+    L_(warning) << "ignoring invalid archive index for \"" << archive_filename
+                << "\"";
+    return false;
+  }
+  if (header.archive_type !=
+          static_cast<uint32_t>(descriptor.archive_type()) ||
+      header.time_created != static_cast<int64_t>(descriptor.time_created())) {
+    L_(warning) << "ignoring stale archive index for \"" << archive_filename
+                << "\"";
+    return false;
+  }
+
+  ifs.seekg(0, std::ios::end);
+  auto data_size = static_cast<uint64_t>(ifs.tellg()) - sizeof(header);
+  ifs.seekg(sizeof(header));
+
+  // a truncated last entry (e.g., from an aborted writer) is ignored
+  entries_.resize(data_size / sizeof(ArchiveIndexEntry));
+  ifs.read(reinterpret_cast<char*>(entries_.data()),
+           static_cast<std::streamsize>(entries_.size() *
+                                        sizeof(ArchiveIndexEntry)));
+  if (!ifs) {
+    entries_.clear();
+    throw std::ios_base::failure("error reading archive index for \"" +
+                                 archive_filename + "\"");
+  }
+
+  consecutive_ = true;
+  ascending_ = true;
+  time_ascending_ = true;
+  for (std::size_t i = 1; i < entries_.size(); ++i) {
+    if (entries_[i].index != entries_[0].index + i) {
+      consecutive_ = false;
+    }
+    if (entries_[i].index < entries_[i - 1].index) {
+      ascending_ = false;
+    }
+    if (entries_[i].start_time < entries_[i - 1].start_time) {
+      time_ascending_ = false;
+    }
+  }
+
+  return true;
+}
+
+std::size_t ArchiveIndex::find_index(uint64_t index) const {
+  if (entries_.empty()) {
+    return SIZE_MAX;
+  }
+
+  if (consecutive_) {
+    if (index < entries_.front().index || index > entries_.back().index) {
+      return SIZE_MAX;
+    }
+    return index - entries_.front().index;
+  }
+
+  if (ascending_) {
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), index,
+        [](const ArchiveIndexEntry& e, uint64_t i) { return e.index < i; });
+    if (it == entries_.end() || it->index != index) {
+      return SIZE_MAX;
+    }
+    return static_cast<std::size_t>(it - entries_.begin());
+  }
+
+  auto it = std::find_if(entries_.begin(), entries_.end(),
+                         [index](const ArchiveIndexEntry& e) {
+                           return e.index == index;
+                         });
+  if (it == entries_.end()) {
+    return SIZE_MAX;
+  }
+  return static_cast<std::size_t>(it - entries_.begin());
+}
+
+std::size_t ArchiveIndex::find_time(uint64_t start_time) const {
+  if (!time_ascending_) {
+    throw std::runtime_error("archive index start times are not ascending");
+  }
+
+  auto it = std::lower_bound(entries_.begin(), entries_.end(), start_time,
+                             [](const ArchiveIndexEntry& e, uint64_t t) {
+                               return e.start_time < t;
+                             });
+  if (it == entries_.end()) {
+    return SIZE_MAX;
+  }
+  return static_cast<std::size_t>(it - entries_.begin());
+}
+
+ArchiveIndexWriter::ArchiveIndexWriter(const std::string& archive_filename,
+                                       const ArchiveDescriptor& descriptor)
+    : filename_(ArchiveIndex::index_filename(archive_filename)) {
+  ofstream_.open(filename_, std::ios::binary | std::ios::trunc);
+  if (!ofstream_) {
+    L_(info) << "cannot create archive index \"" << filename_
+             << "\", random access will be unavailable";
+    return;
+  }
+
+  ArchiveIndex::Header header{
+      ArchiveIndex::magic_, ArchiveIndex::version_,
+      static_cast<uint32_t>(descriptor.archive_type()),
+      static_cast<int64_t>(descriptor.time_created()), 0};
+  ofstream_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void ArchiveIndexWriter::discard() {
+  ofstream_.close();
+  std::remove(filename_.c_str());
+}
+
+} // namespace fles
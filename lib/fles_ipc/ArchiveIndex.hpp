@@ -0,0 +1,185 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ArchiveIndex and fles::ArchiveIndexWriter classes.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "Microslice.hpp"
+#include "Timeslice.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/// A single entry of an archive index, describing one stored data set.
+struct ArchiveIndexEntry {
+  uint64_t offset;     ///< Byte offset of the data set in the archive file
+  uint64_t index;      ///< Index of the data set (e.g., timeslice index)
+  uint64_t start_time; ///< Start time of the data set
+};
+
+/// Retrieve the index key of a timeslice for an archive index.
+inline uint64_t archive_index_of(const Timeslice& ts) { return ts.index(); }
+
+/// Retrieve the start time of a timeslice for an archive index.
+inline uint64_t archive_start_time_of(const Timeslice& ts) {
+  return ts.start_time();
+}
+
+/// Retrieve the (approximate) memory size of a timeslice data set.
+inline uint64_t archive_data_size_of(const Timeslice& ts) {
+  uint64_t size = 0;
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    size += ts.size_component(c);
+  }
+  return size;
+}
+
+/// Retrieve the index key of a microslice for an archive index.
+inline uint64_t archive_index_of(const Microslice& ms) { return ms.desc().idx; }
+
+/// Retrieve the start time of a microslice for an archive index.
+inline uint64_t archive_start_time_of(const Microslice& ms) {
+  return ms.desc().idx;
+}
+
+/// Retrieve the (approximate) memory size of a microslice data set.
+inline uint64_t archive_data_size_of(const Microslice& ms) {
+  return sizeof(MicrosliceDescriptor) + ms.desc().size;
+}
+
+/**
+ * \brief The ArchiveIndex class provides random access information on the
+ * data sets stored in an archive file.
+ *
+ * The index is stored in a sidecar file next to the archive (named by
+ * appending ".idx" to the archive file name). It contains a small header
+ * followed by one fixed-size ArchiveIndexEntry per data set in file order.
+ * The archive file itself is not modified, so archives remain readable by
+ * software unaware of the index.
+ */
+class ArchiveIndex {
+public:
+  /// Construct an empty index.
+  ArchiveIndex() = default;
+
+  /**
+   * \brief Read the index belonging to the given archive file.
+   *
+   * \param archive_filename File name of the archive file
+   * \param descriptor       Descriptor read from the archive file, used to
+   *                         reject stale or unrelated index files
+   *
+   * \return true if a matching index was found and read
+   */
+  bool load(const std::string& archive_filename,
+            const ArchiveDescriptor& descriptor);
+
+  /// Retrieve the name of the index file belonging to an archive file.
+  [[nodiscard]] static std::string
+  index_filename(const std::string& archive_filename) {
+    return archive_filename + ".idx";
+  }
+
+  /// Check if the index contains no entries.
+  [[nodiscard]] bool empty() const { return entries_.empty(); }
+
+  /// Retrieve the number of entries.
+  [[nodiscard]] std::size_t size() const { return entries_.size(); }
+
+  /// Retrieve the entry at a given position in file order.
+  [[nodiscard]] const ArchiveIndexEntry& at(std::size_t pos) const {
+    return entries_.at(pos);
+  }
+
+  /**
+   * \brief Find the position of the data set with the given index.
+   *
+   * Constant time if the indexes are consecutive (the regular case),
+   * logarithmic if they are ascending, linear otherwise.
+   *
+   * \return The position in file order, or SIZE_MAX if not found
+   */
+  [[nodiscard]] std::size_t find_index(uint64_t index) const;
+
+  /**
+   * \brief Find the position of the first data set with a start time not less
+   * than the given time (requires ascending start times).
+   *
+   * \return The position in file order, or SIZE_MAX if there is none
+   */
+  [[nodiscard]] std::size_t find_time(uint64_t start_time) const;
+
+private:
+  friend class ArchiveIndexWriter;
+
+  /// The on-disk header of an index file.
+  struct Header {
+    uint64_t magic;         ///< File format identifier
+    uint32_t version;       ///< File format version
+    uint32_t archive_type;  ///< Type of the indexed archive
+    int64_t time_created;   ///< Creation time of the indexed archive
+    uint64_t reserved;      ///< Reserved, always zero
+  };
+
+  static constexpr uint64_t magic_ = 0x58444941534c4546; // "FLESAIDX"
+  static constexpr uint32_t version_ = 1;
+
+  std::vector<ArchiveIndexEntry> entries_;
+  bool consecutive_ = true;
+  bool ascending_ = true;
+  bool time_ascending_ = true;
+};
+
+/**
+ * \brief The ArchiveIndexWriter class writes the sidecar index file for an
+ * archive file while it is being written.
+ */
+class ArchiveIndexWriter {
+public:
+  /**
+   * \brief Create the index file belonging to the given archive file.
+   *
+   * If the index file cannot be created (e.g., the archive is written to a
+   * device or a read-only directory), the writer is disabled.
+   */
+  ArchiveIndexWriter(const std::string& archive_filename,
+                     const ArchiveDescriptor& descriptor);
+
+  /// Delete copy constructor (non-copyable).
+  ArchiveIndexWriter(const ArchiveIndexWriter&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ArchiveIndexWriter&) = delete;
+
+  /// Append an entry for a data set stored at the given archive offset.
+  void add(std::streamoff offset, uint64_t index, uint64_t start_time) {
+    if (!ofstream_.is_open()) {
+      return;
+    }
+    if (offset < 0) {
+      // archive stream is not seekable (e.g., a pipe), index is useless
+      discard();
+      return;
+    }
+    ArchiveIndexEntry entry{static_cast<uint64_t>(offset), index, start_time};
+    ofstream_.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+  }
+
+  /// Flush and close the index file.
+  void close() {
+    if (ofstream_.is_open()) {
+      ofstream_.close();
+    }
+  }
+
+private:
+  /// Close and remove the index file.
+  void discard();
+
+  std::string filename_;
+  std::ofstream ofstream_;
+};
+
+} // namespace fles
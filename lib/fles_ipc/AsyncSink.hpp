@@ -0,0 +1,198 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::AsyncSink template class.
+#pragma once
+
+#include "Sink.hpp"
+#include "log.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace fles {
+
+/// Behavior of an AsyncSink when its queue is full.
+enum class OverflowPolicy {
+  Block, ///< wait until the queue has space
+  Drop   ///< discard the item
+};
+
+/**
+ * \brief The AsyncSink class forwards items to another sink on a background
+ * thread.
+ *
+ * Items are passed through a bounded queue, so that a slow sink (e.g., an
+ * output archive during file rollover or page cache writeback) does not
+ * stall the caller unless the queue is full (or, with OverflowPolicy::Drop,
+ * does not stall it at all). An exception thrown by the
+ * wrapped sink stops the forwarding and is rethrown to the caller on all
+ * subsequent calls of put() and end_stream().
+ */
+template <class T> class AsyncSink : public Sink<T> {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /// Latency of the items from put() to completion in the wrapped sink.
+  struct Latency {
+    std::size_t count = 0; ///< number of completed items
+    clock::duration sum{}; ///< sum of the latencies
+    clock::duration max{}; ///< maximum latency
+  };
+
+  /**
+   * \brief Construct an asynchronous sink and start its worker thread.
+   *
+   * \param sink     The sink to forward items to
+   * \param capacity Maximum number of queued items
+   * \param policy   Behavior if the queue is full
+   */
+  explicit AsyncSink(std::unique_ptr<Sink<T>> sink,
+                     std::size_t capacity = 16,
+                     OverflowPolicy policy = OverflowPolicy::Block)
+      : sink_(std::move(sink)), capacity_(capacity > 0 ? capacity : 1),
+        policy_(policy), worker_([this] { run(); }) {}
+
+  /// Delete copy constructor (non-copyable).
+  AsyncSink(const AsyncSink&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const AsyncSink&) = delete;
+
+  ~AsyncSink() override {
+    try {
+      end_stream();
+    } catch (std::exception& e) {
+      L_(error) << "asynchronous sink: " << e.what();
+    }
+  }
+
+  /// Queue an item to be forwarded.
+  /** If the queue is full, this blocks or discards the item, depending on
+      the overflow policy. */
+  void put(std::shared_ptr<const T> item) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    rethrow_error();
+    if (policy_ == OverflowPolicy::Drop && queue_.size() >= capacity_) {
+      ++dropped_;
+      return;
+    }
+    not_full_.wait(lock,
+                   [this] { return queue_.size() < capacity_ || error_; });
+    rethrow_error();
+    queue_.push_back({std::move(item), clock::now()});
+    if (queue_.size() > max_depth_) {
+      max_depth_ = queue_.size();
+    }
+    not_empty_.notify_one();
+  }
+
+  /// Forward all queued items, end the wrapped sink's stream, and stop.
+  void end_stream() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_) {
+        return;
+      }
+      stopped_ = true;
+      not_empty_.notify_one();
+    }
+    worker_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrow_error();
+  }
+
+  /// Retrieve the current number of queued items.
+  [[nodiscard]] std::size_t queue_depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+
+  /// Retrieve and reset the maximum queue depth since the last call.
+  std::size_t max_queue_depth() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::exchange(max_depth_, queue_.size());
+  }
+
+  /// Retrieve the capacity of the queue.
+  [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+  /// Retrieve the total number of items discarded because of a full queue.
+  [[nodiscard]] std::size_t dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+
+  /// Retrieve and reset the latency statistics since the last call.
+  Latency latency() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::exchange(latency_, Latency());
+  }
+
+private:
+  void run() {
+    try {
+      while (true) {
+        Entry entry;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          not_empty_.wait(lock, [this] { return !queue_.empty() || stopped_; });
+          if (queue_.empty()) {
+            break;
+          }
+          entry = std::move(queue_.front());
+          queue_.pop_front();
+          not_full_.notify_one();
+        }
+        sink_->put(std::move(entry.item));
+        clock::duration latency = clock::now() - entry.time;
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++latency_.count;
+        latency_.sum += latency;
+        if (latency > latency_.max) {
+          latency_.max = latency;
+        }
+      }
+      sink_->end_stream();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+      queue_.clear();
+      not_full_.notify_all();
+    }
+  }
+
+  void rethrow_error() {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  /// A queued item and the time it was queued.
+  struct Entry {
+    std::shared_ptr<const T> item;
+    clock::time_point time;
+  };
+
+  std::unique_ptr<Sink<T>> sink_;
+  std::size_t capacity_;
+  OverflowPolicy policy_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Entry> queue_;
+  std::size_t max_depth_ = 0;
+  std::size_t dropped_ = 0;
+  Latency latency_;
+  bool stopped_ = false;
+  std::exception_ptr error_;
+
+  std::thread worker_;
+};
+
+} // namespace fles
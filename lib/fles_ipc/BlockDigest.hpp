@@ -0,0 +1,32 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the block digest function used by the archive formats.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fles {
+
+/**
+ * \brief Compute the 64-bit digest of a block of archive data.
+ *
+ * The digest is the XXH64 hash of the data, which is fast enough to be
+ * computed and checked at disk speed.
+ *
+ * \param data Pointer to the data
+ * \param size Size (in bytes) of the data
+ * \param seed Seed value, e.g., the digest of a preceding part of the block
+ */
+[[nodiscard]] uint64_t
+block_digest(const void* data, std::size_t size, uint64_t seed = 0);
+
+/// The result of checking the block digests of an archive.
+struct BlockVerification {
+  uint64_t blocks = 0;    ///< Number of blocks checked
+  uint64_t bytes = 0;     ///< Number of bytes checked
+  uint64_t corrupt = 0;   ///< Number of blocks with a mismatching digest
+  uint64_t unchecked = 0; ///< Number of blocks stored without digest
+};
+
+} // namespace fles
@@ -0,0 +1,33 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ComponentIndex.hpp"
+#include "Timeslice.hpp"
+#include <algorithm>
+
+namespace fles {
+
+ComponentIndex::ComponentIndex(const Timeslice& ts) {
+  // counting sort of the components by subsystem
+  std::array<uint32_t, 256> count{};
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    if (ts.num_microslices(c) != 0) {
+      const MicrosliceDescriptor& desc = ts.descriptor(c, 0);
+      ++count[desc.sys_id];
+      eq_component_.emplace(desc.eq_id, c);
+    }
+  }
+  for (std::size_t s = 0; s < count.size(); ++s) {
+    sys_begin_[s + 1] = sys_begin_[s] + count[s];
+  }
+
+  components_.resize(sys_begin_.back());
+  std::array<uint32_t, 256> next{};
+  std::copy(sys_begin_.begin(), sys_begin_.end() - 1, next.begin());
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    if (ts.num_microslices(c) != 0) {
+      components_[next[ts.descriptor(c, 0).sys_id]++] = c;
+    }
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,68 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ComponentIndex class.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace fles {
+
+class Timeslice;
+
+/**
+ * \brief The ComponentIndex class maps the subsystem and equipment
+ * identifiers of a timeslice to its components.
+ *
+ * The identifiers of a component are taken from its first microslice, so
+ * components without microslices are not indexed. Use
+ * Timeslice::component_index() to obtain the index of a timeslice, which
+ * is built once and then shared by all its consumers.
+ */
+class ComponentIndex {
+public:
+  /// A range of component indices.
+  struct Range {
+    const uint64_t* first; ///< Pointer to the first component index
+    const uint64_t* last;  ///< Pointer past the last component index
+
+    [[nodiscard]] const uint64_t* begin() const { return first; }
+    [[nodiscard]] const uint64_t* end() const { return last; }
+    [[nodiscard]] std::size_t size() const {
+      return static_cast<std::size_t>(last - first);
+    }
+    [[nodiscard]] bool empty() const { return first == last; }
+  };
+
+  /// Build the index of a given timeslice.
+  explicit ComponentIndex(const Timeslice& ts);
+
+  /// Retrieve the components of a given subsystem, in ascending order.
+  [[nodiscard]] Range components(uint8_t sys_id) const {
+    return {components_.data() + sys_begin_[sys_id],
+            components_.data() + sys_begin_[sys_id + 1]};
+  }
+
+  /// Retrieve the first component of a given equipment, if any.
+  [[nodiscard]] std::optional<uint64_t> component(uint16_t eq_id) const {
+    auto it = eq_component_.find(eq_id);
+    if (it == eq_component_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+private:
+  /// Component indices, ordered by subsystem and index.
+  std::vector<uint64_t> components_;
+  /// Start of the components of each subsystem in components_.
+  std::array<uint32_t, 257> sys_begin_{};
+  /// First component of each equipment.
+  std::unordered_map<uint16_t, uint64_t> eq_component_;
+};
+
+} // namespace fles
@@ -0,0 +1,108 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ComponentSelection.hpp"
+#include "Timeslice.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace fles {
+
+namespace {
+
+// Parse a list of numbers, checking the given upper limit.
+std::vector<uint64_t> parse_list(const std::string& key,
+                                 const std::string& value,
+                                 uint64_t max) {
+  std::vector<uint64_t> numbers;
+  for (const auto& item : split(value, ",")) {
+    std::size_t pos = 0;
+    uint64_t number = 0;
+    try {
+      number = std::stoull(item, &pos, 0);
+    } catch (std::logic_error&) {
+      pos = 0;
+    }
+    if (item.empty() || pos != item.size() || number > max) {
+      throw std::runtime_error("invalid value for " + key + ": " + item);
+    }
+    numbers.push_back(number);
+  }
+  if (numbers.empty()) {
+    throw std::runtime_error("missing value for " + key);
+  }
+  return numbers;
+}
+
+} // namespace
+
+bool ComponentSelection::parse(const std::string& key,
+                               const std::string& value) {
+  if (key == "component") {
+    for (auto n :
+         parse_list(key, value, std::numeric_limits<uint64_t>::max())) {
+      add_component(n);
+    }
+  } else if (key == "sys_id") {
+    for (auto n : parse_list(key, value, std::numeric_limits<uint8_t>::max())) {
+      add_sys_id(static_cast<uint8_t>(n));
+    }
+  } else if (key == "eq_id") {
+    for (auto n :
+         parse_list(key, value, std::numeric_limits<uint16_t>::max())) {
+      add_eq_id(static_cast<uint16_t>(n));
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool ComponentSelection::selects(uint64_t component,
+                                 uint64_t num_microslices,
+                                 const MicrosliceDescriptor* first) const {
+  if (!components_.empty() && components_.count(component) == 0) {
+    return false;
+  }
+  if (sys_ids_.empty() && eq_ids_.empty()) {
+    return true;
+  }
+  if (num_microslices == 0) {
+    return false;
+  }
+  return (sys_ids_.empty() || sys_ids_.count(first->sys_id) != 0) &&
+         (eq_ids_.empty() || eq_ids_.count(first->eq_id) != 0);
+}
+
+bool ComponentSelection::selects(const Timeslice& ts,
+                                 uint64_t component) const {
+  return selects(component, ts.num_microslices(component),
+                 ts.descriptors(component));
+}
+
+std::vector<uint64_t>
+ComponentSelection::components(const Timeslice& ts) const {
+  std::vector<uint64_t> selected;
+  if (components_.empty() && !sys_ids_.empty()) {
+    // candidates from the component index instead of a scan
+    const ComponentIndex& index = ts.component_index();
+    for (uint8_t sys_id : sys_ids_) {
+      for (uint64_t c : index.components(sys_id)) {
+        if (selects(ts, c)) {
+          selected.push_back(c);
+        }
+      }
+    }
+    std::sort(selected.begin(), selected.end());
+    return selected;
+  }
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    if (selects(ts, c)) {
+      selected.push_back(c);
+    }
+  }
+  return selected;
+}
+
+} // namespace fles
@@ -0,0 +1,77 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ComponentSelection class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+class Timeslice;
+
+/**
+ * \brief The ComponentSelection class describes the subset of timeslice
+ * components needed by a consumer.
+ *
+ * Components can be selected by index and by the subsystem or equipment
+ * identifier of their microslices. A component is selected if it matches
+ * each of the given criteria (and one of the values given for a criterion).
+ * If a subsystem or equipment identifier is required, components without
+ * microslices are not selected. A default-constructed selection selects all
+ * components.
+ */
+class ComponentSelection {
+public:
+  /// Select components with a given index.
+  void add_component(uint64_t component) { components_.insert(component); }
+
+  /// Select components with a given subsystem identifier.
+  void add_sys_id(uint8_t sys_id) { sys_ids_.insert(sys_id); }
+
+  /// Select components with a given equipment identifier.
+  void add_eq_id(uint16_t eq_id) { eq_ids_.insert(eq_id); }
+
+  /**
+   * \brief Add the criterion given by a locator query parameter.
+   *
+   * The keys "component", "sys_id" and "eq_id" are recognized. The value
+   * is a comma-separated list of numbers (decimal, or hexadecimal with a
+   * "0x" prefix).
+   *
+   * \return false if the key is not a selection criterion
+   */
+  bool parse(const std::string& key, const std::string& value);
+
+  /// Check whether all components are selected.
+  [[nodiscard]] bool selects_all() const {
+    return components_.empty() && sys_ids_.empty() && eq_ids_.empty();
+  }
+
+  /**
+   * \brief Check whether a component is selected.
+   *
+   * \param component       the index of the component
+   * \param num_microslices the number of microslices in the component
+   * \param first           the descriptor of its first microslice
+   */
+  [[nodiscard]] bool selects(uint64_t component,
+                             uint64_t num_microslices,
+                             const MicrosliceDescriptor* first) const;
+
+  /// Check whether a component of a given timeslice is selected.
+  [[nodiscard]] bool selects(const Timeslice& ts, uint64_t component) const;
+
+  /// Retrieve the selected component indices of a given timeslice.
+  [[nodiscard]] std::vector<uint64_t> components(const Timeslice& ts) const;
+
+private:
+  std::set<uint64_t> components_;
+  std::set<uint8_t> sys_ids_;
+  std::set<uint16_t> eq_ids_;
+};
+
+} // namespace fles
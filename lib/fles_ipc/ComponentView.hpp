@@ -0,0 +1,162 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ComponentView class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace fles {
+
+/// The descriptor and content of a microslice in a timeslice component.
+struct MicrosliceRef {
+  const MicrosliceDescriptor& desc; ///< The microslice descriptor
+  const uint8_t* content;           ///< Pointer to the microslice content
+};
+
+/**
+ * \brief The ComponentView class provides fast read access to the
+ * microslices of a timeslice component.
+ *
+ * The location of the contents is computed once on construction, so that
+ * accessing a microslice or iterating over all microslices of the component
+ * is a plain walk through the descriptor array. A view is valid as long as
+ * the timeslice it refers to.
+ *
+ * Sub-views (see subview() and window()) share the content location of the
+ * original view and thus do not copy any data.
+ */
+class ComponentView {
+public:
+  /// Iterator over the microslices of a component.
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = MicrosliceRef;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = MicrosliceRef;
+
+    iterator(const MicrosliceDescriptor* desc,
+             const uint8_t* content,
+             uint64_t first_offset)
+        : desc_(desc), content_(content), first_offset_(first_offset) {}
+
+    MicrosliceRef operator*() const {
+      return {*desc_, content_ + (desc_->offset - first_offset_)};
+    }
+
+    iterator& operator++() {
+      ++desc_;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator it = *this;
+      ++desc_;
+      return it;
+    }
+
+    bool operator==(const iterator& other) const {
+      return desc_ == other.desc_;
+    }
+    bool operator!=(const iterator& other) const {
+      return desc_ != other.desc_;
+    }
+
+  private:
+    const MicrosliceDescriptor* desc_;
+    const uint8_t* content_;
+    uint64_t first_offset_;
+  };
+
+  /// Construct a view on the data of a component (microslice descriptors
+  /// followed by contents) with a given number of microslices.
+  ComponentView(const uint8_t* data, uint64_t num_microslices)
+      : desc_(reinterpret_cast<const MicrosliceDescriptor*>(data)),
+        size_(num_microslices),
+        content_(data + num_microslices * sizeof(MicrosliceDescriptor)),
+        first_offset_(num_microslices != 0 ? desc_[0].offset : 0) {}
+
+  /// Construct a view on a given number of microslice descriptors and
+  /// their contents, which start at a separate location.
+  ComponentView(const uint8_t* data,
+                uint64_t num_microslices,
+                const uint8_t* content)
+      : desc_(reinterpret_cast<const MicrosliceDescriptor*>(data)),
+        size_(num_microslices), content_(content),
+        first_offset_(num_microslices != 0 ? desc_[0].offset : 0) {}
+
+  /// Retrieve the number of microslices.
+  [[nodiscard]] uint64_t size() const { return size_; }
+
+  /// Check whether the component contains no microslices.
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  /// Retrieve the contiguous array of microslice descriptors.
+  [[nodiscard]] const MicrosliceDescriptor* descriptors() const {
+    return desc_;
+  }
+
+  /// Retrieve the descriptor of a given microslice.
+  [[nodiscard]] const MicrosliceDescriptor& descriptor(uint64_t m) const {
+    return desc_[m];
+  }
+
+  /// Retrieve a pointer to the content of a given microslice.
+  [[nodiscard]] const uint8_t* content(uint64_t m) const {
+    return content_ + (desc_[m].offset - first_offset_);
+  }
+
+  /// Retrieve the descriptor and content of a given microslice.
+  MicrosliceRef operator[](uint64_t m) const { return {desc_[m], content(m)}; }
+
+  /// Retrieve a view on a contiguous range of microslices.
+  /** \param first Position of the first microslice in the range
+      \param count Number of microslices in the range */
+  [[nodiscard]] ComponentView subview(uint64_t first, uint64_t count) const {
+    return {desc_ + first, count, content_, first_offset_};
+  }
+
+  /// Retrieve a view on the microslices with an index (start time) in the
+  /// interval [begin_idx, end_idx).
+  /** The microslices of a component are ordered by index, so the range is
+      found by binary search. */
+  [[nodiscard]] ComponentView window(uint64_t begin_idx,
+                                     uint64_t end_idx) const {
+    auto less = [](const MicrosliceDescriptor& d, uint64_t idx) {
+      return d.idx < idx;
+    };
+    const MicrosliceDescriptor* first =
+        std::lower_bound(desc_, desc_ + size_, begin_idx, less);
+    const MicrosliceDescriptor* last =
+        std::lower_bound(first, desc_ + size_, end_idx, less);
+    return {first, static_cast<uint64_t>(last - first), content_,
+            first_offset_};
+  }
+
+  [[nodiscard]] iterator begin() const {
+    return {desc_, content_, first_offset_};
+  }
+  [[nodiscard]] iterator end() const {
+    return {desc_ + size_, content_, first_offset_};
+  }
+
+private:
+  ComponentView(const MicrosliceDescriptor* desc,
+                uint64_t size,
+                const uint8_t* content,
+                uint64_t first_offset)
+      : desc_(desc), size_(size), content_(content),
+        first_offset_(first_offset) {}
+
+  const MicrosliceDescriptor* desc_;
+  uint64_t size_;
+  const uint8_t* content_;
+  uint64_t first_offset_;
+};
+
+} // namespace fles
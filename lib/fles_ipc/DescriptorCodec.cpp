@@ -0,0 +1,220 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "DescriptorCodec.hpp"
+#include <stdexcept>
+
+namespace fles {
+
+namespace {
+
+/// The number of descriptor fields, each stored as a column.
+constexpr std::size_t num_columns = 10;
+
+enum class ColumnMode : uint8_t { RunLength = 0, Plain = 1 };
+
+uint64_t zigzag(uint64_t v) {
+  return (v << 1) ^ (0 - (v >> 63)); // maps small negative values to small
+}
+
+uint64_t unzigzag(uint64_t v) { return (v >> 1) ^ (0 - (v & 1)); }
+
+void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+std::size_t varint_size(uint64_t v) {
+  std::size_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    ++n;
+  }
+  return n;
+}
+
+/// Retrieve the value of a column of descriptor m, relative to its
+/// predecessor where applicable.
+uint64_t column_value(const MicrosliceDescriptor* desc,
+                      std::size_t column,
+                      std::size_t m) {
+  const MicrosliceDescriptor& d = desc[m];
+  switch (column) {
+  case 0:
+    return d.hdr_id;
+  case 1:
+    return d.hdr_ver;
+  case 2:
+    return d.eq_id;
+  case 3:
+    return d.flags;
+  case 4:
+    return d.sys_id;
+  case 5:
+    return d.sys_ver;
+  case 6:
+    return m == 0 ? d.idx : d.idx - desc[m - 1].idx;
+  case 7:
+    return d.crc;
+  case 8:
+    return d.size;
+  default:
+    return m == 0 ? d.offset
+                  : d.offset - (desc[m - 1].offset + desc[m - 1].size);
+  }
+}
+
+/// Set a column of descriptor m from its (relative) value. The preceding
+/// descriptors have to be complete.
+void set_column(MicrosliceDescriptor* desc,
+                std::size_t column,
+                std::size_t m,
+                uint64_t v) {
+  MicrosliceDescriptor& d = desc[m];
+  switch (column) {
+  case 0:
+    d.hdr_id = static_cast<uint8_t>(v);
+    break;
+  case 1:
+    d.hdr_ver = static_cast<uint8_t>(v);
+    break;
+  case 2:
+    d.eq_id = static_cast<uint16_t>(v);
+    break;
+  case 3:
+    d.flags = static_cast<uint16_t>(v);
+    break;
+  case 4:
+    d.sys_id = static_cast<uint8_t>(v);
+    break;
+  case 5:
+    d.sys_ver = static_cast<uint8_t>(v);
+    break;
+  case 6:
+    d.idx = m == 0 ? v : desc[m - 1].idx + v;
+    break;
+  case 7:
+    d.crc = static_cast<uint32_t>(v);
+    break;
+  case 8:
+    d.size = static_cast<uint32_t>(v);
+    break;
+  default:
+    d.offset = m == 0 ? v : desc[m - 1].offset + desc[m - 1].size + v;
+    break;
+  }
+}
+
+/// Reader of variable-length integers with bounds checking.
+class Reader {
+public:
+  Reader(const uint8_t* data, std::size_t size)
+      : pos_(data), end_(data + size) {}
+
+  uint64_t varint() {
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (pos_ == end_) {
+        throw std::runtime_error("truncated descriptor encoding");
+      }
+      uint8_t byte = *pos_++;
+      v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return v;
+      }
+    }
+    throw std::runtime_error("invalid descriptor encoding");
+  }
+
+  uint8_t byte() {
+    if (pos_ == end_) {
+      throw std::runtime_error("truncated descriptor encoding");
+    }
+    return *pos_++;
+  }
+
+  [[nodiscard]] bool at_end() const { return pos_ == end_; }
+
+private:
+  const uint8_t* pos_;
+  const uint8_t* end_;
+};
+
+} // namespace
+
+void encode_descriptors(const MicrosliceDescriptor* desc,
+                        std::size_t num,
+                        std::vector<uint8_t>& out) {
+  std::vector<uint64_t> values(num);
+  for (std::size_t column = 0; column < num_columns; ++column) {
+    std::size_t plain_size = 0;
+    std::size_t rle_size = 0;
+    for (std::size_t m = 0; m < num; ++m) {
+      values[m] = zigzag(column_value(desc, column, m));
+      plain_size += varint_size(values[m]);
+    }
+    for (std::size_t m = 0; m < num;) {
+      std::size_t run = 1;
+      while (m + run < num && values[m + run] == values[m]) {
+        ++run;
+      }
+      rle_size += varint_size(values[m]) + varint_size(run);
+      m += run;
+    }
+
+    if (rle_size < plain_size) {
+      out.push_back(static_cast<uint8_t>(ColumnMode::RunLength));
+      for (std::size_t m = 0; m < num;) {
+        std::size_t run = 1;
+        while (m + run < num && values[m + run] == values[m]) {
+          ++run;
+        }
+        put_varint(out, values[m]);
+        put_varint(out, run);
+        m += run;
+      }
+    } else {
+      out.push_back(static_cast<uint8_t>(ColumnMode::Plain));
+      for (std::size_t m = 0; m < num; ++m) {
+        put_varint(out, values[m]);
+      }
+    }
+  }
+}
+
+void decode_descriptors(const uint8_t* data,
+                        std::size_t size,
+                        MicrosliceDescriptor* desc,
+                        std::size_t num) {
+  Reader in(data, size);
+  // the relative columns refer to preceding descriptors, so the columns
+  // are decoded in order into the array
+  for (std::size_t column = 0; column < num_columns; ++column) {
+    auto mode = static_cast<ColumnMode>(in.byte());
+    if (mode == ColumnMode::RunLength) {
+      for (std::size_t m = 0; m < num;) {
+        uint64_t v = unzigzag(in.varint());
+        uint64_t run = in.varint();
+        if (run == 0 || run > num - m) {
+          throw std::runtime_error("invalid descriptor encoding");
+        }
+        for (uint64_t i = 0; i < run; ++i, ++m) {
+          set_column(desc, column, m, v);
+        }
+      }
+    } else if (mode == ColumnMode::Plain) {
+      for (std::size_t m = 0; m < num; ++m) {
+        set_column(desc, column, m, unzigzag(in.varint()));
+      }
+    } else {
+      throw std::runtime_error("invalid descriptor encoding");
+    }
+  }
+  if (!in.at_end()) {
+    throw std::runtime_error("invalid descriptor encoding");
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,49 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the columnar encoding of microslice descriptor arrays.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief Encode an array of microslice descriptors in a compact, columnar
+ * form.
+ *
+ * The descriptors of a stream of microslices are very regular. Each field
+ * is therefore stored as a separate column of variable-length integers,
+ * either run-length encoded or plain, whichever is smaller. The idx column
+ * stores the difference to the preceding descriptor, and the offset column
+ * the difference to the end of the preceding microslice, so that both are
+ * typically a single run.
+ *
+ * \param desc The descriptors to encode
+ * \param num  The number of descriptors
+ * \param out  The buffer to append the encoded descriptors to
+ */
+void encode_descriptors(const MicrosliceDescriptor* desc,
+                        std::size_t num,
+                        std::vector<uint8_t>& out);
+
+/**
+ * \brief Decode an array of microslice descriptors encoded by
+ * encode_descriptors().
+ *
+ * \param data The encoded descriptors
+ * \param size The size (in bytes) of the encoded descriptors
+ * \param desc The array to decode the descriptors to
+ * \param num  The number of descriptors, as given to encode_descriptors()
+ *
+ * \throws std::runtime_error if the data is not a valid encoding of num
+ * descriptors
+ */
+void decode_descriptors(const uint8_t* data,
+                        std::size_t size,
+                        MicrosliceDescriptor* desc,
+                        std::size_t num);
+
+} // namespace fles
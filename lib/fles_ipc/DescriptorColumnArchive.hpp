@@ -0,0 +1,58 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the on-disk layout of descriptor column files.
+#pragma once
+
+#include "TimesliceRawArchive.hpp"
+#include <cstdint>
+
+namespace fles {
+
+/**
+ * \brief The descriptor column file layout.
+ *
+ * A descriptor column file stores only the microslice descriptors of a
+ * stream of timeslices, for analyses of rates, sizes, flags and timing that
+ * do not need the microslice contents. Only the core microslices of each
+ * timeslice are stored, so that each microslice appears once. A file
+ * consists of a RawArchiveFileHeader (with descriptor_column_magic)
+ * followed by a sequence of blocks, each covering consecutive timeslices
+ * with the same number of components and consisting of
+ *
+ * - a DescriptorColumnBlockHeader,
+ * - for each component, a DescriptorColumnHeader followed by the columnar
+ *   encoding (see encode_descriptors()) of the descriptors of the core
+ *   microslices of all timeslices of the block.
+ *
+ * Within the encoding, the values of each descriptor field form a column,
+ * and the idx and offset columns are stored as differences, so that the
+ * typically constant or few distinct values of fields such as eq_id and
+ * sys_id shrink to a few bytes per block. All values are in host byte
+ * order, and no parts are aligned.
+ */
+
+#pragma pack(1)
+
+/// The header at the beginning of each block in a descriptor column file.
+struct DescriptorColumnBlockHeader {
+  uint64_t block_size;     ///< Size (in bytes) of the block
+  uint64_t first_index;    ///< Index of the first timeslice of the block
+  uint32_t num_timeslices; ///< Number of timeslices in the block
+  uint32_t num_components; ///< Number of components of each timeslice
+};
+
+/// The header of the descriptors of a component in a block.
+struct DescriptorColumnHeader {
+  uint64_t num_microslices; ///< Number of microslice descriptors
+  uint64_t encoded_size;    ///< Size (in bytes) of the encoded descriptors
+};
+
+#pragma pack()
+
+/// Magic number identifying descriptor column files ("FLESTSC\0").
+constexpr uint64_t descriptor_column_magic = 0x0043535453454c46;
+
+/// Current descriptor column file format version.
+constexpr uint32_t descriptor_column_version = 1;
+
+} // namespace fles
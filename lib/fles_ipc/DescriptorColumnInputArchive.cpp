@@ -0,0 +1,60 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "DescriptorColumnInputArchive.hpp"
+#include "DescriptorCodec.hpp"
+#include "DescriptorColumnArchive.hpp"
+#include <stdexcept>
+
+namespace fles {
+
+DescriptorColumnInputArchive::DescriptorColumnInputArchive(
+    const std::string& filename)
+    : filename_(filename), ifstream_(filename, std::ios::binary) {
+  if (!ifstream_) {
+    throw std::ios_base::failure("error opening file \"" + filename_ + "\"");
+  }
+
+  RawArchiveFileHeader header{};
+  ifstream_.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!ifstream_ || header.magic != descriptor_column_magic) {
+    throw std::runtime_error("not a descriptor column file: " + filename_);
+  }
+  if (header.version != descriptor_column_version) {
+    throw std::runtime_error("unsupported descriptor column file version " +
+                             std::to_string(header.version) + ": " +
+                             filename_);
+  }
+}
+
+bool DescriptorColumnInputArchive::read(DescriptorColumnBlock& block) {
+  DescriptorColumnBlockHeader header{};
+  ifstream_.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (ifstream_.gcount() == 0 && ifstream_.eof()) {
+    return false;
+  }
+  if (!ifstream_) {
+    throw std::runtime_error("truncated descriptor column file: " +
+                             filename_);
+  }
+
+  block.first_index = header.first_index;
+  block.num_timeslices = header.num_timeslices;
+  block.components.resize(header.num_components);
+  for (auto& descriptors : block.components) {
+    DescriptorColumnHeader column{};
+    ifstream_.read(reinterpret_cast<char*>(&column), sizeof(column));
+    encoded_.resize(column.encoded_size);
+    ifstream_.read(reinterpret_cast<char*>(encoded_.data()),
+                   static_cast<std::streamsize>(encoded_.size()));
+    if (!ifstream_) {
+      throw std::runtime_error("truncated descriptor column file: " +
+                               filename_);
+    }
+    descriptors.resize(column.num_microslices);
+    decode_descriptors(encoded_.data(), encoded_.size(), descriptors.data(),
+                       descriptors.size());
+  }
+  return true;
+}
+
+} // namespace fles
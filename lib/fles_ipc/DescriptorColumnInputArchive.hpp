@@ -0,0 +1,52 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::DescriptorColumnInputArchive class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/// The decoded microslice descriptors of a block of timeslices.
+struct DescriptorColumnBlock {
+  /// Index of the first timeslice of the block
+  uint64_t first_index = 0;
+  /// Number of timeslices in the block
+  uint32_t num_timeslices = 0;
+  /// The descriptors of the core microslices of each component
+  std::vector<std::vector<MicrosliceDescriptor>> components;
+};
+
+/**
+ * \brief The DescriptorColumnInputArchive class reads the blocks of a
+ * descriptor column file (see DescriptorColumnArchive.hpp).
+ */
+class DescriptorColumnInputArchive {
+public:
+  /// Construct a descriptor column archive object, open the given file for
+  /// reading, and check the file header.
+  explicit DescriptorColumnInputArchive(const std::string& filename);
+
+  /// Delete copy constructor (non-copyable).
+  DescriptorColumnInputArchive(const DescriptorColumnInputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const DescriptorColumnInputArchive&) = delete;
+
+  /// Read and decode the next block.
+  /**
+     \return Whether a block has been read (false at the end of the file)
+     \throws std::runtime_error if the file is truncated or corrupt
+  */
+  bool read(DescriptorColumnBlock& block);
+
+private:
+  std::string filename_;
+  std::ifstream ifstream_;
+  std::vector<uint8_t> encoded_;
+};
+
+} // namespace fles
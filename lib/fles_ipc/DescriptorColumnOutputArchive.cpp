@@ -0,0 +1,94 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "DescriptorColumnOutputArchive.hpp"
+#include "DescriptorCodec.hpp"
+#include "DescriptorColumnArchive.hpp"
+#include "log.hpp"
+#include <algorithm>
+
+namespace fles {
+
+DescriptorColumnOutputArchive::DescriptorColumnOutputArchive(
+    const std::string& filename, std::size_t timeslices_per_block)
+    : filename_(filename), ofstream_(filename, std::ios::binary),
+      timeslices_per_block_(timeslices_per_block > 0 ? timeslices_per_block
+                                                     : 1) {
+  if (!ofstream_) {
+    throw std::ios_base::failure("error opening file \"" + filename_ + "\"");
+  }
+
+  RawArchiveFileHeader header{descriptor_column_magic,
+                              descriptor_column_version, 0};
+  ofstream_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+DescriptorColumnOutputArchive::~DescriptorColumnOutputArchive() {
+  try {
+    end_stream();
+  } catch (std::exception& e) {
+    L_(error) << "error writing descriptor column file: " << e.what();
+  }
+}
+
+void DescriptorColumnOutputArchive::put(
+    std::shared_ptr<const Timeslice> item) {
+  const Timeslice& ts = *item;
+  if (num_timeslices_ != 0 && ts.num_components() != desc_.size()) {
+    write_block();
+  }
+  if (num_timeslices_ == 0) {
+    first_index_ = ts.index();
+    desc_.resize(ts.num_components());
+  }
+
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    const MicrosliceDescriptor* descriptors = ts.descriptors(c);
+    uint64_t core =
+        std::min(ts.num_microslices(c), ts.num_core_microslices());
+    desc_[c].insert(desc_[c].end(), descriptors, descriptors + core);
+  }
+
+  if (++num_timeslices_ == timeslices_per_block_) {
+    write_block();
+  }
+}
+
+void DescriptorColumnOutputArchive::end_stream() {
+  if (!ofstream_.is_open()) {
+    return;
+  }
+  if (num_timeslices_ != 0) {
+    write_block();
+  }
+  ofstream_.close();
+}
+
+void DescriptorColumnOutputArchive::write_block() {
+  const auto num_components = static_cast<uint32_t>(desc_.size());
+
+  // encode all components first to know the block size
+  std::vector<std::vector<uint8_t>> encoded(num_components);
+  uint64_t block_size = sizeof(DescriptorColumnBlockHeader);
+  for (uint32_t c = 0; c < num_components; ++c) {
+    encode_descriptors(desc_[c].data(), desc_[c].size(), encoded[c]);
+    block_size += sizeof(DescriptorColumnHeader) + encoded[c].size();
+  }
+
+  DescriptorColumnBlockHeader header{block_size, first_index_,
+                                     num_timeslices_, num_components};
+  ofstream_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (uint32_t c = 0; c < num_components; ++c) {
+    DescriptorColumnHeader column{desc_[c].size(), encoded[c].size()};
+    ofstream_.write(reinterpret_cast<const char*>(&column), sizeof(column));
+    ofstream_.write(reinterpret_cast<const char*>(encoded[c].data()),
+                    static_cast<std::streamsize>(encoded[c].size()));
+    desc_[c].clear();
+  }
+  num_timeslices_ = 0;
+
+  if (!ofstream_) {
+    throw std::ios_base::failure("error writing file \"" + filename_ + "\"");
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,72 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::DescriptorColumnOutputArchive class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include "Sink.hpp"
+#include "Timeslice.hpp"
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The DescriptorColumnOutputArchive class writes the microslice
+ * descriptors of timeslices to a descriptor column file (see
+ * DescriptorColumnArchive.hpp).
+ *
+ * The descriptors of the core microslices are collected per component
+ * until a block of timeslices is complete and then written in columnar
+ * encoding. The microslice contents are not stored.
+ */
+class DescriptorColumnOutputArchive : public Sink<Timeslice> {
+public:
+  /// Default maximum number of timeslices per block.
+  static constexpr std::size_t default_timeslices_per_block = 256;
+
+  /**
+   * \brief Construct a descriptor column archive object, open the given
+   * file for writing, and write the file header.
+   *
+   * \param filename             File name of the archive file
+   * \param timeslices_per_block Maximum number of timeslices per block
+   */
+  explicit DescriptorColumnOutputArchive(
+      const std::string& filename,
+      std::size_t timeslices_per_block = default_timeslices_per_block);
+
+  /// Delete copy constructor (non-copyable).
+  DescriptorColumnOutputArchive(const DescriptorColumnOutputArchive&) =
+      delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const DescriptorColumnOutputArchive&) = delete;
+
+  /// Destruct the archive object, writing the last block.
+  ~DescriptorColumnOutputArchive() override;
+
+  /// Store the descriptors of a timeslice.
+  void put(std::shared_ptr<const Timeslice> item) override;
+
+  void end_stream() override;
+
+private:
+  /// Write the collected descriptors as a block.
+  void write_block();
+
+  std::string filename_;
+  std::ofstream ofstream_;
+  std::size_t timeslices_per_block_;
+
+  /// Index of the first timeslice of the current block.
+  uint64_t first_index_ = 0;
+  /// Number of timeslices in the current block.
+  uint32_t num_timeslices_ = 0;
+  /// The collected descriptors of each component.
+  std::vector<std::vector<MicrosliceDescriptor>> desc_;
+};
+
+} // namespace fles
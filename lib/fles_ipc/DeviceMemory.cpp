@@ -0,0 +1,98 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "DeviceMemory.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+#include <unistd.h>
+#endif
+
+namespace fles {
+
+#ifdef HAVE_CUDA
+
+namespace {
+
+static_assert(sizeof(cudaIpcMemHandle_t) <= sizeof(DeviceMemoryHandle),
+              "CUDA IPC handle does not fit into DeviceMemoryHandle");
+
+void check(cudaError_t err, const char* what) {
+  if (err != cudaSuccess) {
+    throw std::runtime_error(std::string("DeviceMemory: ") + what + ": " +
+                             cudaGetErrorString(err));
+  }
+}
+
+} // namespace
+
+DeviceMemory::DeviceMemory(int device, std::size_t size)
+    : device_(device), size_(size) {
+  check(cudaSetDevice(device_), "cudaSetDevice");
+  void* ptr = nullptr;
+  check(cudaMalloc(&ptr, size_), "cudaMalloc");
+  ptr_ = static_cast<uint8_t*>(ptr);
+
+  // remote writes must be visible to all subsequent memory operations
+  unsigned int flag = 1;
+  cuPointerSetAttribute(&flag, CU_POINTER_ATTRIBUTE_SYNC_MEMOPS,
+                        reinterpret_cast<CUdeviceptr>(ptr_));
+
+  cudaIpcMemHandle_t handle;
+  check(cudaIpcGetMemHandle(&handle, ptr_), "cudaIpcGetMemHandle");
+  std::memcpy(handle_.data(), &handle, sizeof(handle));
+
+#if CUDA_VERSION >= 11070
+  int fd = -1;
+  if (cuMemGetHandleForAddressRange(&fd, reinterpret_cast<CUdeviceptr>(ptr_),
+                                    size_,
+                                    CU_MEM_RANGE_HANDLE_TYPE_DMA_BUF_FD,
+                                    0) == CUDA_SUCCESS) {
+    dmabuf_fd_ = fd;
+  }
+#endif
+}
+
+DeviceMemory::DeviceMemory(int device, const DeviceMemoryHandle& handle)
+    : device_(device), handle_(handle), mapped_(true) {
+  check(cudaSetDevice(device_), "cudaSetDevice");
+  cudaIpcMemHandle_t ipc_handle;
+  std::memcpy(&ipc_handle, handle_.data(), sizeof(ipc_handle));
+  void* ptr = nullptr;
+  check(cudaIpcOpenMemHandle(&ptr, ipc_handle,
+                             cudaIpcMemLazyEnablePeerAccess),
+        "cudaIpcOpenMemHandle");
+  ptr_ = static_cast<uint8_t*>(ptr);
+}
+
+DeviceMemory::~DeviceMemory() {
+  if (dmabuf_fd_ >= 0) {
+    close(dmabuf_fd_);
+  }
+  if (mapped_) {
+    cudaIpcCloseMemHandle(ptr_);
+  } else {
+    cudaFree(ptr_);
+  }
+}
+
+#else
+
+DeviceMemory::DeviceMemory(int device, std::size_t size)
+    : device_(device), size_(size) {
+  throw std::runtime_error("DeviceMemory: built without CUDA support");
+}
+
+DeviceMemory::DeviceMemory(int device, const DeviceMemoryHandle& handle)
+    : device_(device), handle_(handle), mapped_(true) {
+  throw std::runtime_error("DeviceMemory: built without CUDA support");
+}
+
+DeviceMemory::~DeviceMemory() = default;
+
+#endif
+
+} // namespace fles
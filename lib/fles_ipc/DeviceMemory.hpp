@@ -0,0 +1,69 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::DeviceMemory class.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace fles {
+
+/// Opaque handle to share a device memory region between processes.
+using DeviceMemoryHandle = std::array<uint8_t, 64>;
+
+/**
+ * \brief The DeviceMemory class represents a region of GPU memory.
+ *
+ * The region is either allocated by this process, in which case it can be
+ * exported to other processes through its handle and registered with a
+ * network adapter for direct remote access, or it is mapped from the
+ * handle of another process. Without CUDA support, the constructors throw
+ * std::runtime_error.
+ */
+class DeviceMemory {
+public:
+  /// Allocate a region of a given size on a given device.
+  DeviceMemory(int device, std::size_t size);
+
+  /// Map a region of another process from its handle.
+  DeviceMemory(int device, const DeviceMemoryHandle& handle);
+
+  /// Delete copy constructor (non-copyable).
+  DeviceMemory(const DeviceMemory&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const DeviceMemory&) = delete;
+
+  ~DeviceMemory();
+
+  /// Retrieve the device address of the region.
+  [[nodiscard]] uint8_t* ptr() const { return ptr_; }
+
+  /// Retrieve the size of an allocated region (zero if mapped).
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  /// Retrieve the device the region is located on.
+  [[nodiscard]] int device() const { return device_; }
+
+  /// Retrieve the handle to map an allocated region in another process.
+  [[nodiscard]] const DeviceMemoryHandle& handle() const { return handle_; }
+
+  /**
+   * \brief Retrieve a dma-buf file descriptor of an allocated region.
+   *
+   * \return the file descriptor, or -1 if the driver does not support
+   * exporting device memory as dma-buf (registration then relies on a
+   * peer memory kernel module, e.g., nvidia-peermem)
+   */
+  [[nodiscard]] int dmabuf_fd() const { return dmabuf_fd_; }
+
+private:
+  int device_;
+  std::size_t size_ = 0;
+  uint8_t* ptr_ = nullptr;
+  DeviceMemoryHandle handle_{};
+  int dmabuf_fd_ = -1;
+  bool mapped_ = false;
+};
+
+} // namespace fles
@@ -3,10 +3,14 @@
 /// \brief Defines the fles::InputArchive template class.
 #pragma once
 
+#include "ArchiveBlock.hpp"
 #include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
+#include "InputFileBuffer.hpp"
 #include "Source.hpp"
 #include <boost/archive/binary_iarchive.hpp>
-#include <fstream>
+#include <cstdint>
+#include <istream>
 #include <memory>
 #include <string>
 
@@ -14,30 +18,24 @@ namespace fles {
 
 /**
  * \brief The InputArchive class deserializes data sets from an input file.
+ *
+ * The file is read ahead of deserialization on a background thread (see
+ * InputFileBuffer).
  */
 template <class Base, class Derived, ArchiveType archive_type>
 class InputArchive : public Source<Base> {
 public:
   /**
    * \brief Construct an input archive object, open the given archive file for
-   * reading, and read the archive descriptor.
+   * reading, and read the archive descriptor. If a matching sidecar index
+   * file exists (see ArchiveIndex), it is read to enable random access.
    *
    * \param filename File name of the archive file
    */
-  InputArchive(const std::string& filename) {
-    ifstream_ =
-        std::make_unique<std::ifstream>(filename.c_str(), std::ios::binary);
-    if (!*ifstream_) {
-      throw std::ios_base::failure("error opening file \"" + filename + "\"");
-    }
-
-    iarchive_ = std::make_unique<boost::archive::binary_iarchive>(*ifstream_);
-
-    *iarchive_ >> descriptor_;
-
-    if (descriptor_.archive_type() != archive_type) {
-      throw std::runtime_error("File \"" + filename +
-                               "\" is not of correct archive type");
+  InputArchive(const std::string& filename) : filename_(filename) {
+    open();
+    if (descriptor_.archive_compression() == ArchiveCompression::None) {
+      index_.load(filename_, descriptor_);
     }
   }
 
@@ -58,7 +56,91 @@ public:
 
   [[nodiscard]] bool eos() const override { return eos_; }
 
+  /// Check if an index for random access is available.
+  [[nodiscard]] bool has_index() const { return !index_.empty(); }
+
+  /// Retrieve the archive index.
+  [[nodiscard]] const ArchiveIndex& index() const { return index_; }
+
+  /**
+   * \brief Position the archive so that the next call of get() returns the
+   * data set with the given index (e.g., timeslice index).
+   *
+   * \return false if no data set with this index is contained in the archive
+   */
+  bool seek(uint64_t index) { return seek_position(index_.find_index(index)); }
+
+  /**
+   * \brief Position the archive so that the next call of get() returns the
+   * first data set with a start time not less than the given time.
+   *
+   * \return false if there is no such data set in the archive
+   */
+  bool seek_time(uint64_t start_time) {
+    return seek_position(index_.find_time(start_time));
+  }
+
 private:
+  void open() {
+    block_reader_ = nullptr;
+    iarchive_ = nullptr;
+    istream_ = nullptr;
+    filebuf_ = nullptr;
+    filebuf_ = std::make_unique<InputFileBuffer>(filename_);
+    istream_ = std::make_unique<std::istream>(filebuf_.get());
+
+    iarchive_ = std::make_unique<boost::archive::binary_iarchive>(*istream_);
+
+    *iarchive_ >> descriptor_;
+
+    if (descriptor_.archive_type() != archive_type) {
+      throw std::runtime_error("File \"" + filename_ +
+                               "\" is not of correct archive type");
+    }
+
+    if (descriptor_.archive_compression() != ArchiveCompression::None) {
+      block_reader_ =
+          std::make_unique<ArchiveBlockReader>(*istream_, descriptor_);
+    }
+
+    eos_ = false;
+    primed_ = false;
+  }
+
+  bool seek_position(std::size_t pos) {
+    if (!has_index()) {
+      throw std::runtime_error("no index available for file \"" + filename_ +
+                               "\"");
+    }
+    if (pos >= index_.size()) {
+      return false;
+    }
+
+    if (pos == 0 || eos_) {
+      open();
+      if (pos == 0) {
+        return true;
+      }
+    }
+
+    // The first data set in the stream carries the class information for the
+    // boost archive, so it has to be read once before jumping elsewhere.
+    if (!primed_) {
+      std::unique_ptr<Derived> skipped(do_get());
+      if (!skipped) {
+        return false;
+      }
+    }
+
+    istream_->clear();
+    istream_->seekg(static_cast<std::streamoff>(index_.at(pos).offset));
+    if (!*istream_) {
+      throw std::ios_base::failure("error seeking in file \"" + filename_ +
+                                   "\"");
+    }
+    return true;
+  }
+
   Derived* do_get() override {
     if (eos_) {
       return nullptr;
@@ -67,7 +149,11 @@ private:
     Derived* sts = nullptr;
     try {
       sts = new Derived(); // NOLINT
-      *iarchive_ >> *sts;
+      if (block_reader_) {
+        block_reader_->get(*sts);
+      } else {
+        *iarchive_ >> *sts;
+      }
     } catch (boost::archive::archive_exception& e) {
       if (e.code == boost::archive::archive_exception::input_stream_error) {
         delete sts; // NOLINT
@@ -76,14 +162,20 @@ private:
       }
       throw;
     }
+    primed_ = true;
     return sts;
   }
 
-  std::unique_ptr<std::ifstream> ifstream_;
+  std::string filename_;
+  std::unique_ptr<InputFileBuffer> filebuf_;
+  std::unique_ptr<std::istream> istream_;
   std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
+  std::unique_ptr<ArchiveBlockReader> block_reader_;
   ArchiveDescriptor descriptor_;
+  ArchiveIndex index_;
 
   bool eos_ = false;
+  bool primed_ = false;
 };
 
 } // namespace fles
@@ -3,6 +3,7 @@
 /// \brief Defines the fles::InputArchiveLoop template class.
 #pragma once
 
+#include "ArchiveBlock.hpp"
 #include "ArchiveDescriptor.hpp"
 #include "Source.hpp"
 #include <boost/archive/binary_iarchive.hpp>
@@ -51,6 +52,7 @@ public:
 
 private:
   void init() {
+    block_reader_ = nullptr;
     iarchive_ = nullptr;
     ifstream_ = nullptr;
 
@@ -69,6 +71,11 @@ private:
                                "\" is not of correct archive type");
     }
 
+    if (descriptor_.archive_compression() != ArchiveCompression::None) {
+      block_reader_ =
+          std::make_unique<ArchiveBlockReader>(*ifstream_, descriptor_);
+    }
+
     ++cycle_;
     archive_has_data_ = false;
   }
@@ -81,7 +88,11 @@ private:
     Derived* sts = nullptr;
     try {
       sts = new Derived(); // NOLINT
-      *iarchive_ >> *sts;
+      if (block_reader_) {
+        block_reader_->get(*sts);
+      } else {
+        *iarchive_ >> *sts;
+      }
       archive_has_data_ = true;
     } catch (boost::archive::archive_exception& e) {
       if (e.code == boost::archive::archive_exception::input_stream_error) {
@@ -100,6 +111,7 @@ private:
 
   std::unique_ptr<std::ifstream> ifstream_;
   std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
+  std::unique_ptr<ArchiveBlockReader> block_reader_;
   ArchiveDescriptor descriptor_;
 
   std::string filename_;
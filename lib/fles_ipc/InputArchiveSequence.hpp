@@ -3,15 +3,22 @@
 /// \brief Defines the fles::InputArchiveSequence template class.
 #pragma once
 
+#include "ArchiveBlock.hpp"
 #include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
 #include "Source.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/archive/binary_iarchive.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 
 namespace fles {
@@ -30,26 +37,40 @@ public:
    * number.
    *
    * \param filename_template File name pattern of the archive files
+   * \param prefetch_files    Number of files to read ahead concurrently on
+   *                          background threads (0: read sequentially)
+   * \param prefetch_bytes    Maximum amount of data to hold in memory ahead
+   *                          of the consumer when reading ahead
    */
-  InputArchiveSequence(std::string filename_template)
-      : filename_template_(std::move(filename_template)) {
+  InputArchiveSequence(std::string filename_template,
+                       std::size_t prefetch_files = 0,
+                       std::size_t prefetch_bytes = default_prefetch_bytes)
+      : filename_template_(std::move(filename_template)),
+        prefetch_files_(prefetch_files), prefetch_bytes_(prefetch_bytes) {
     // append sequence number to file name if missing in template
     if (filename_template_.find("%n") == std::string::npos) {
       filename_template_ += ".%n";
     }
 
-    next_file();
+    init();
   }
 
   /**
    * \brief Construct an input archive object, open the first archive file for
    * reading, and read the archive descriptor.
    *
-   * \param filenames File names of the archive files
+   * \param filenames      File names of the archive files
+   * \param prefetch_files Number of files to read ahead concurrently on
+   *                       background threads (0: read sequentially)
+   * \param prefetch_bytes Maximum amount of data to hold in memory ahead of
+   *                       the consumer when reading ahead
    */
-  InputArchiveSequence(std::vector<std::string> filenames)
-      : filenames_(std::move(filenames)) {
-    next_file();
+  InputArchiveSequence(std::vector<std::string> filenames,
+                       std::size_t prefetch_files = 0,
+                       std::size_t prefetch_bytes = default_prefetch_bytes)
+      : filenames_(std::move(filenames)), prefetch_files_(prefetch_files),
+        prefetch_bytes_(prefetch_bytes) {
+    init();
   }
 
   /// Delete copy constructor (non-copyable).
@@ -57,7 +78,10 @@ public:
   /// Delete assignment operator (non-copyable).
   void operator=(const InputArchiveSequence&) = delete;
 
-  ~InputArchiveSequence() override = default;
+  ~InputArchiveSequence() override { stop_prefetch(); }
+
+  /// Default memory budget for reading ahead.
+  static constexpr std::size_t default_prefetch_bytes = 1024 * 1024 * 1024;
 
   /// Read the next data set.
   std::unique_ptr<Derived> get() { return std::unique_ptr<Derived>(do_get()); };
@@ -72,6 +96,7 @@ public:
 private:
   std::unique_ptr<std::ifstream> ifstream_;
   std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
+  std::unique_ptr<ArchiveBlockReader> block_reader_;
   ArchiveDescriptor descriptor_;
 
   std::string filename_template_;
@@ -80,13 +105,219 @@ private:
 
   bool eos_ = false;
 
+  /// A file being read ahead by a background thread.
+  struct PrefetchFile {
+    std::size_t number = 0;
+    std::string filename;
+    ArchiveDescriptor descriptor{archive_type};
+    std::deque<std::pair<std::unique_ptr<Derived>, uint64_t>> items;
+    bool opened = false;  ///< descriptor has been read
+    bool missing = false; ///< file could not be opened
+    bool done = false;    ///< background thread has finished
+    std::exception_ptr error;
+    std::thread thread;
+  };
+
+  std::size_t prefetch_files_ = 0;
+  std::size_t prefetch_bytes_ = default_prefetch_bytes;
+  std::deque<std::unique_ptr<PrefetchFile>> prefetch_;
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_cv_;
+  std::size_t prefetch_used_bytes_ = 0;
+  bool prefetch_stop_ = false;
+
   [[nodiscard]] std::string filename_with_number(std::size_t n) const {
     std::ostringstream number;
     number << std::setw(4) << std::setfill('0') << n;
     return boost::replace_all_copy(filename_template_, "%n", number.str());
   }
 
+  void init() {
+    if (prefetch_files_ == 0) {
+      next_file();
+      return;
+    }
+
+    // Start reading ahead, but check the first file synchronously to report
+    // a missing file or wrong archive type at construction as usual.
+    std::unique_lock<std::mutex> lock(prefetch_mutex_);
+    start_prefetch();
+    if (prefetch_.empty()) {
+      eos_ = true;
+      return;
+    }
+    PrefetchFile& f = *prefetch_.front();
+    prefetch_cv_.wait(lock, [&f] { return f.opened || f.done; });
+    if (!f.opened) {
+      lock.unlock();
+      auto error = f.error;
+      bool missing = f.missing;
+      auto filename = f.filename;
+      stop_prefetch();
+      if (error) {
+        std::rethrow_exception(error);
+      }
+      if (missing) {
+        throw std::ios_base::failure("error opening file \"" + filename +
+                                     "\"");
+      }
+    }
+    descriptor_ = f.descriptor;
+  }
+
+  /// Start background readers up to the configured number of files.
+  /// Requires prefetch_mutex_ to be held.
+  void start_prefetch() {
+    while (prefetch_.size() < prefetch_files_) {
+      if (!filenames_.empty() && file_count_ >= filenames_.size()) {
+        return;
+      }
+      auto f = std::make_unique<PrefetchFile>();
+      f->number = file_count_;
+      f->filename = filenames_.empty() ? filename_with_number(file_count_)
+                                       : filenames_.at(file_count_);
+      PrefetchFile* fp = f.get();
+      prefetch_.push_back(std::move(f));
+      fp->thread = std::thread([this, fp] { prefetch_run(fp); });
+      ++file_count_;
+    }
+  }
+
+  void stop_prefetch() {
+    {
+      std::lock_guard<std::mutex> lock(prefetch_mutex_);
+      prefetch_stop_ = true;
+    }
+    prefetch_cv_.notify_all();
+    for (auto& f : prefetch_) {
+      if (f->thread.joinable()) {
+        f->thread.join();
+      }
+    }
+    prefetch_.clear();
+  }
+
+  /// Read all data sets of a file (executed on a background thread).
+  void prefetch_run(PrefetchFile* f) {
+    try {
+      std::ifstream ifs(f->filename, std::ios::binary);
+      if (!ifs) {
+        std::lock_guard<std::mutex> lock(prefetch_mutex_);
+        f->missing = true;
+        f->done = true;
+        prefetch_cv_.notify_all();
+        return;
+      }
+
+      boost::archive::binary_iarchive iarchive(ifs);
+      ArchiveDescriptor descriptor{archive_type};
+      iarchive >> descriptor;
+      if (descriptor.archive_type() != archive_type) {
+        throw std::runtime_error("File \"" + f->filename +
+                                 "\" is not of correct archive type");
+      }
+      std::unique_ptr<ArchiveBlockReader> block_reader;
+      if (descriptor.archive_compression() != ArchiveCompression::None) {
+        block_reader = std::make_unique<ArchiveBlockReader>(ifs, descriptor);
+      }
+      {
+        std::lock_guard<std::mutex> lock(prefetch_mutex_);
+        f->descriptor = descriptor;
+        f->opened = true;
+      }
+      prefetch_cv_.notify_all();
+
+      while (true) {
+        std::unique_ptr<Derived> item(new Derived()); // NOLINT
+        try {
+          if (block_reader) {
+            block_reader->get(*item);
+          } else {
+            iarchive >> *item;
+          }
+        } catch (boost::archive::archive_exception& e) {
+          if (e.code == boost::archive::archive_exception::input_stream_error) {
+            break;
+          }
+          throw;
+        }
+        uint64_t size = archive_data_size_of(*item);
+
+        std::unique_lock<std::mutex> lock(prefetch_mutex_);
+        // The file currently consumed may always hold one item to avoid
+        // deadlock, further items have to fit into the memory budget.
+        prefetch_cv_.wait(lock, [this, f, size] {
+          return prefetch_stop_ ||
+                 (prefetch_.front().get() == f && f->items.empty()) ||
+                 prefetch_used_bytes_ + size <= prefetch_bytes_;
+        });
+        if (prefetch_stop_) {
+          break;
+        }
+        f->items.emplace_back(std::move(item), size);
+        prefetch_used_bytes_ += size;
+        prefetch_cv_.notify_all();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(prefetch_mutex_);
+      f->error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    f->done = true;
+    prefetch_cv_.notify_all();
+  }
+
+  Derived* do_get_prefetched() {
+    std::unique_lock<std::mutex> lock(prefetch_mutex_);
+    while (true) {
+      start_prefetch();
+      if (prefetch_.empty()) {
+        break;
+      }
+      PrefetchFile& f = *prefetch_.front();
+      prefetch_cv_.wait(lock, [&f] { return !f.items.empty() || f.done; });
+      if (!f.items.empty()) {
+        auto [item, size] = std::move(f.items.front());
+        f.items.pop_front();
+        prefetch_used_bytes_ -= size;
+        descriptor_ = f.descriptor;
+        lock.unlock();
+        prefetch_cv_.notify_all();
+        return item.release();
+      }
+
+      // front file is completely consumed
+      f.thread.join();
+      if (f.error) {
+        auto error = f.error;
+        lock.unlock();
+        stop_prefetch();
+        eos_ = true;
+        std::rethrow_exception(error);
+      }
+      if (f.missing) {
+        // Not finding a file given explicitely is an error, not finding a
+        // later file of a sequence is just the end-of-stream condition
+        auto filename = f.filename;
+        bool is_error = f.number == 0 || !filenames_.empty();
+        lock.unlock();
+        stop_prefetch();
+        eos_ = true;
+        if (is_error) {
+          throw std::ios_base::failure("error opening file \"" + filename +
+                                       "\"");
+        }
+        return nullptr;
+      }
+      prefetch_.pop_front();
+      prefetch_cv_.notify_all();
+    }
+    eos_ = true;
+    return nullptr;
+  }
+
   void next_file() {
+    block_reader_ = nullptr;
     iarchive_ = nullptr;
     ifstream_ = nullptr;
 
@@ -123,6 +354,11 @@ private:
                                "\" is not of correct archive type");
     }
 
+    if (descriptor_.archive_compression() != ArchiveCompression::None) {
+      block_reader_ =
+          std::make_unique<ArchiveBlockReader>(*ifstream_, descriptor_);
+    }
+
     ++file_count_;
   }
 
@@ -130,11 +366,18 @@ private:
     if (eos_) {
       return nullptr;
     }
+    if (prefetch_files_ > 0) {
+      return do_get_prefetched();
+    }
 
     Derived* sts = nullptr;
     try {
       sts = new Derived(); // NOLINT
-      *iarchive_ >> *sts;
+      if (block_reader_) {
+        block_reader_->get(*sts);
+      } else {
+        *iarchive_ >> *sts;
+      }
     } catch (boost::archive::archive_exception& e) {
       if (e.code == boost::archive::archive_exception::input_stream_error) {
         delete sts; // NOLINT
@@ -0,0 +1,221 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "InputFileBuffer.hpp"
+#include "System.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <ios>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fles {
+
+InputFileBuffer::InputFileBuffer(const std::string& filename,
+                                 std::size_t buffer_size,
+                                 std::size_t num_buffers,
+                                 bool drop_cache)
+    : filename_(filename),
+      buffer_size_((buffer_size + alignment_ - 1) / alignment_ * alignment_),
+      drop_cache_(drop_cache) {
+  if (buffer_size_ == 0) {
+    buffer_size_ = alignment_;
+  }
+  // one buffer is consumed while at least one is being read
+  if (num_buffers < 2) {
+    num_buffers = 2;
+  }
+
+  fd_ = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ == -1) {
+    throw std::ios_base::failure("error opening file \"" + filename_ +
+                                 "\": " + system::stringerror(errno));
+  }
+#ifdef POSIX_FADV_SEQUENTIAL
+  // a hint only, failure is ignored
+  ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  for (std::size_t i = 0; i < num_buffers; ++i) {
+    void* buf = nullptr;
+    int ret = posix_memalign(&buf, alignment_, buffer_size_);
+    if (ret != 0) {
+      ::close(fd_);
+      throw std::runtime_error(std::string("posix_memalign: ") +
+                               system::stringerror(ret));
+    }
+    buffers_.emplace_back(static_cast<char*>(buf), free);
+    free_.push_back(buffers_.back().get());
+  }
+  setg(nullptr, nullptr, nullptr);
+
+  thread_ = std::thread([this] { read_run(); });
+}
+
+InputFileBuffer::~InputFileBuffer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  ::close(fd_);
+}
+
+void InputFileBuffer::read_run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || (!read_done_ && !free_.empty()); });
+    if (stop_) {
+      break;
+    }
+    Block block{free_.back(), read_offset_, 0, 0};
+    free_.pop_back();
+    const uint64_t generation = generation_;
+    lock.unlock();
+
+    while (block.size < buffer_size_) {
+      ssize_t n =
+          ::pread(fd_, block.data + block.size, buffer_size_ - block.size,
+                  static_cast<off_t>(block.offset + block.size));
+      if (n == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        block.error = errno;
+        break;
+      }
+      if (n == 0) {
+        break;
+      }
+      block.size += static_cast<std::size_t>(n);
+    }
+
+    lock.lock();
+    if (generation != generation_) {
+      // a seek has invalidated this read
+      free_.push_back(block.data);
+      continue;
+    }
+    read_offset_ += block.size;
+    if (block.size < buffer_size_ || block.error != 0) {
+      read_done_ = true;
+    }
+    ready_.push_back(block);
+    cv_.notify_all();
+  }
+}
+
+void InputFileBuffer::release_current() {
+  if (current_.data == nullptr) {
+    return;
+  }
+#ifdef POSIX_FADV_DONTNEED
+  if (drop_cache_ && current_.size > 0) {
+    ::posix_fadvise(fd_, static_cast<off_t>(current_.offset),
+                    static_cast<off_t>(current_.size), POSIX_FADV_DONTNEED);
+  }
+#endif
+  free_.push_back(current_.data);
+  current_ = Block{};
+  cv_.notify_all();
+}
+
+InputFileBuffer::int_type InputFileBuffer::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  if (last_block_) {
+    return traits_type::eof();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  release_current();
+  cv_.wait(lock, [this] { return !ready_.empty(); });
+  Block block = ready_.front();
+  ready_.pop_front();
+  seek_position_ = block.offset + block.size;
+  if (block.error != 0) {
+    free_.push_back(block.data);
+    cv_.notify_all();
+    last_block_ = true;
+    setg(nullptr, nullptr, nullptr);
+    throw std::ios_base::failure("error reading file \"" + filename_ +
+                                 "\": " + system::stringerror(block.error));
+  }
+  current_ = block;
+  last_block_ = block.size < buffer_size_;
+  std::size_t skip = std::min(skip_, block.size);
+  skip_ = 0;
+  setg(block.data, block.data + skip, block.data + block.size);
+  lock.unlock();
+
+  if (gptr() == egptr()) {
+    return traits_type::eof();
+  }
+  return traits_type::to_int_type(*gptr());
+}
+
+InputFileBuffer::pos_type InputFileBuffer::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  if ((which & std::ios_base::in) == 0) {
+    return {off_type(-1)};
+  }
+  off_type base = 0;
+  if (dir == std::ios_base::cur) {
+    base = current_.data != nullptr
+               ? static_cast<off_type>(current_.offset) + (gptr() - eback())
+               : static_cast<off_type>(seek_position_);
+  } else if (dir == std::ios_base::end) {
+    struct stat st {};
+    if (::fstat(fd_, &st) == -1) {
+      return {off_type(-1)};
+    }
+    base = static_cast<off_type>(st.st_size);
+  }
+  if (base + off < 0) {
+    return {off_type(-1)};
+  }
+  if (dir == std::ios_base::cur && off == 0) {
+    return {base}; // position query (as used by tellg())
+  }
+  return seek_to(static_cast<uint64_t>(base + off));
+}
+
+InputFileBuffer::pos_type
+InputFileBuffer::seekpos(pos_type pos, std::ios_base::openmode which) {
+  if ((which & std::ios_base::in) == 0 || off_type(pos) < 0) {
+    return {off_type(-1)};
+  }
+  return seek_to(static_cast<uint64_t>(off_type(pos)));
+}
+
+InputFileBuffer::pos_type InputFileBuffer::seek_to(uint64_t pos) {
+  // positions within the current block need no I/O
+  if (current_.data != nullptr && pos >= current_.offset &&
+      pos <= current_.offset + current_.size) {
+    setg(current_.data, current_.data + (pos - current_.offset),
+         current_.data + current_.size);
+    return {static_cast<off_type>(pos)};
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  release_current();
+  for (auto& block : ready_) {
+    free_.push_back(block.data);
+  }
+  ready_.clear();
+  ++generation_;
+  read_offset_ = pos / alignment_ * alignment_;
+  skip_ = pos - read_offset_;
+  read_done_ = false;
+  last_block_ = false;
+  seek_position_ = pos;
+  setg(nullptr, nullptr, nullptr);
+  cv_.notify_all();
+  return {static_cast<off_type>(pos)};
+}
+
+} // namespace fles
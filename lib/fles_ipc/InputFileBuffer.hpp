@@ -0,0 +1,106 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::InputFileBuffer class.
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The InputFileBuffer class is a stream buffer reading a file ahead
+ * of the consumer using POSIX I/O.
+ *
+ * In contrast to std::filebuf, a background thread issues large, aligned
+ * reads into a pool of reused buffers, so that I/O overlaps with
+ * deserialization. The kernel is advised of sequential access, and pages
+ * already consumed can optionally be dropped from the page cache to keep
+ * its pollution down on shared nodes. Seeking discards the data read ahead.
+ */
+class InputFileBuffer : public std::streambuf {
+public:
+  /**
+   * \brief Open the given file for reading and start reading ahead.
+   *
+   * \param filename    File name of the input file
+   * \param buffer_size Size of each read (rounded to block size)
+   * \param num_buffers Number of buffers, including the one being consumed
+   * \param drop_cache  Drop consumed data from the page cache
+   */
+  explicit InputFileBuffer(const std::string& filename,
+                           std::size_t buffer_size = 4 * 1024 * 1024,
+                           std::size_t num_buffers = 3,
+                           bool drop_cache = false);
+
+  /// Delete copy constructor (non-copyable).
+  InputFileBuffer(const InputFileBuffer&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const InputFileBuffer&) = delete;
+
+  ~InputFileBuffer() override;
+
+protected:
+  int_type underflow() override;
+  pos_type seekoff(off_type off,
+                   std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+  /// A buffer filled by a single read.
+  struct Block {
+    char* data = nullptr;
+    uint64_t offset = 0;
+    std::size_t size = 0;
+    int error = 0;
+  };
+
+  /// Read blocks ahead of the consumer (executed on a background thread).
+  void read_run();
+
+  /// Return the block being consumed to the pool. Requires mutex_ to be held.
+  void release_current();
+
+  /// Position the buffer at an absolute file offset.
+  pos_type seek_to(uint64_t pos);
+
+  static constexpr std::size_t alignment_ = 4096;
+
+  std::string filename_;
+  int fd_ = -1;
+  std::size_t buffer_size_;
+  bool drop_cache_;
+
+  std::vector<std::unique_ptr<char, void (*)(void*)>> buffers_;
+  std::vector<char*> free_;
+  std::deque<Block> ready_;
+  Block current_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  bool stop_ = false;
+
+  /// Position of the next read and seek generation (background thread).
+  uint64_t read_offset_ = 0;
+  uint64_t generation_ = 0;
+  bool read_done_ = false;
+
+  /// Bytes to skip in the next block after an unaligned seek.
+  std::size_t skip_ = 0;
+  /// The block being consumed is the last one of the file.
+  bool last_block_ = false;
+  /// The stream position if no block is being consumed.
+  uint64_t seek_position_ = 0;
+};
+
+} // namespace fles
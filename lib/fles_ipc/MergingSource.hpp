@@ -4,15 +4,33 @@
 #pragma once
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace fles {
 
+/// The order in which a MergingSource provides the items of its inputs.
+enum class MergeOrder {
+  Index,     ///< ascending item index
+  StartTime, ///< ascending start time
+  RoundRobin ///< one item from each input in turn
+};
+
 /**
  * \brief The MergingSource class merges data sets from a given set of input
  * sources. Because of the way that data is provided by the source, one item
  * from every source has to be kept in memory at all times.
  *
+ * If prefetching is enabled, each input is read by its own background thread
+ * into a queue of the given depth, so that the inputs' I/O overlaps.
+ * Otherwise, the inputs are read on the consumer's thread.
+ *
  * This class is meant to be used for detector debugging and similar special
  * cases, not for regular online operation.
  */
@@ -24,12 +42,23 @@ public:
    * \brief Construct a merging source object, initialize the list of input
    * sources, and start peeking into the item streams
    *
-   * \param sources The input sources to read data from
+   * \param sources  The input sources to read data from
+   * \param order    The order in which to provide the items
+   * \param prefetch Number of items to read ahead per input (0: none)
    */
-  MergingSource(std::vector<std::unique_ptr<SourceType>> sources)
-      : sources_(std::move(sources)) {
+  MergingSource(std::vector<std::unique_ptr<SourceType>> sources,
+                MergeOrder order = MergeOrder::Index,
+                std::size_t prefetch = 0)
+      : sources_(std::move(sources)), order_(order), prefetch_(prefetch) {
     if (sources_.empty()) {
       eos_ = true;
+      return;
+    }
+    if (prefetch_ != 0) {
+      inputs_.resize(sources_.size());
+      for (std::size_t i = 0; i < sources_.size(); ++i) {
+        inputs_[i].thread = std::thread([this, i] { prefetch_run(i); });
+      }
     }
   }
 
@@ -38,40 +67,129 @@ public:
   /// Delete assignment operator (non-copyable).
   void operator=(const MergingSource&) = delete;
 
-  ~MergingSource() override = default;
+  /// Destruct the object, waiting for pending reads of the inputs.
+  ~MergingSource() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& input : inputs_) {
+      if (input.thread.joinable()) {
+        input.thread.join();
+      }
+    }
+  }
 
   [[nodiscard]] bool eos() const override { return eos_; }
 
 private:
+  /// The read-ahead state of an input (if prefetching).
+  struct Input {
+    std::deque<std::unique_ptr<item_type>> items;
+    bool done = false; ///< background thread has finished
+    std::exception_ptr error;
+    std::thread thread;
+  };
+
   std::vector<std::unique_ptr<SourceType>> sources_;
   std::vector<std::unique_ptr<item_type>> prefetched_items_;
+  MergeOrder order_;
+  std::size_t prefetch_;
+
+  std::vector<Input> inputs_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+
+  /// Inputs not yet at end-of-stream (round-robin order).
+  std::vector<bool> active_;
+  std::size_t next_input_ = 0;
 
   bool eos_ = false;
 
-  void init_prefetch() {
-    for (auto& source : sources_) {
-      auto timeslice = source->get();
-      prefetched_items_.push_back(std::move(timeslice));
+  /// Read the items of an input (executed on a background thread).
+  void prefetch_run(std::size_t i) {
+    Input& input = inputs_[i];
+    try {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          cv_.wait(lock, [this, &input] {
+            return stop_ || input.items.size() < prefetch_;
+          });
+          if (stop_) {
+            break;
+          }
+        }
+        auto item = sources_[i]->get();
+        if (!item) {
+          break;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        input.items.push_back(std::move(item));
+        cv_.notify_all();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      input.error = std::current_exception();
     }
+    std::lock_guard<std::mutex> lock(mutex_);
+    input.done = true;
+    cv_.notify_all();
   }
 
-  item_type* do_get() override {
-    if (eos_) {
+  /// Retrieve the next item of an input, or nullptr if end-of-stream.
+  std::unique_ptr<item_type> next_item(std::size_t i) {
+    if (prefetch_ == 0) {
+      return sources_[i]->get();
+    }
+    Input& input = inputs_[i];
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&input] { return !input.items.empty() || input.done; });
+    if (input.items.empty()) {
+      if (input.error) {
+        auto error = input.error;
+        input.error = nullptr;
+        lock.unlock();
+        eos_ = true;
+        std::rethrow_exception(error);
+      }
       return nullptr;
     }
+    auto item = std::move(input.items.front());
+    input.items.pop_front();
+    lock.unlock();
+    cv_.notify_all();
+    return item;
+  }
 
+  void init_prefetch() {
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+      prefetched_items_.push_back(next_item(i));
+    }
+  }
+
+  [[nodiscard]] bool precedes(const item_type& a, const item_type& b) const {
+    if (order_ == MergeOrder::StartTime) {
+      return a.start_time() < b.start_time();
+    }
+    return a.index() < b.index();
+  }
+
+  item_type* do_get_ordered() {
     if (prefetched_items_.empty()) {
       init_prefetch();
     }
 
     auto item_it =
         std::min_element(prefetched_items_.begin(), prefetched_items_.end(),
-                         [](const auto& a, const auto& b) {
+                         [this](const auto& a, const auto& b) {
                            if (!a)
                              return false;
                            if (!b)
                              return true;
-                           return a->index() < b->index();
+                           return precedes(*a, *b);
                          });
     auto item_index = item_it - prefetched_items_.begin();
 
@@ -81,8 +199,37 @@ private:
     }
 
     auto item = item_it->release();
-    prefetched_items_.at(item_index) = sources_.at(item_index)->get();
+    prefetched_items_.at(item_index) = next_item(item_index);
     return item;
+  }
+
+  item_type* do_get_round_robin() {
+    if (active_.empty()) {
+      active_.assign(sources_.size(), true);
+    }
+    for (std::size_t n = 0; n < sources_.size(); ++n) {
+      std::size_t i = next_input_;
+      next_input_ = (next_input_ + 1) % sources_.size();
+      if (!active_[i]) {
+        continue;
+      }
+      if (auto item = next_item(i)) {
+        return item.release();
+      }
+      active_[i] = false;
+    }
+    eos_ = true;
+    return nullptr;
+  }
+
+  item_type* do_get() override {
+    if (eos_) {
+      return nullptr;
+    }
+    if (order_ == MergeOrder::RoundRobin) {
+      return do_get_round_robin();
+    }
+    return do_get_ordered();
   };
 };
 
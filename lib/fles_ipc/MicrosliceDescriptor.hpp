@@ -107,7 +107,9 @@ enum class MicrosliceFlags : uint16_t {
   CrcValid = 0x0001,     // information in CRC field is valid
   OverflowFlim = 0x0002, // truncated by FLIM
   OverflowUser = 0x0004, // truncated by user logic
-  DataError = 0x0008     // data error flag set by user logic
+  DataError = 0x0008,    // data error flag set by user logic
+  CrcChecked = 0x0010,   // CRC verified on the compute node
+  CrcError = 0x0020      // CRC mismatch found on the compute node
 };
 
 #pragma pack(1)
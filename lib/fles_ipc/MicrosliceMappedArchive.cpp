@@ -0,0 +1,204 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MicrosliceMappedArchive.hpp"
+#include "DescriptorCodec.hpp"
+#include "MicrosliceRawArchive.hpp"
+#include <atomic>
+#include <thread>
+
+namespace fles {
+
+MappedMicroslice::MappedMicroslice(
+    std::shared_ptr<const boost::interprocess::mapped_region> region,
+    std::shared_ptr<const std::vector<MicrosliceDescriptor>> decoded,
+    const MicrosliceDescriptor* desc,
+    const uint8_t* content)
+    // const_cast is safe here as Microslice only provides read access
+    : Microslice(const_cast<MicrosliceDescriptor*>(desc),
+                 const_cast<uint8_t*>(content)),
+      region_(std::move(region)), decoded_(std::move(decoded)) {}
+
+MicrosliceMappedArchive::MicrosliceMappedArchive(const std::string& filename)
+    : filename_(filename) {
+  try {
+    boost::interprocess::file_mapping file(filename_.c_str(),
+                                           boost::interprocess::read_only);
+    auto region = std::make_shared<boost::interprocess::mapped_region>(
+        file, boost::interprocess::read_only);
+    region->advise(boost::interprocess::mapped_region::advice_sequential);
+    region_ = std::move(region);
+  } catch (boost::interprocess::interprocess_exception& e) {
+    throw std::ios_base::failure("error mapping file \"" + filename_ +
+                                 "\": " + e.what());
+  }
+
+  begin_ = static_cast<const uint8_t*>(region_->get_address());
+  size_ = region_->get_size();
+
+  const auto* header = reinterpret_cast<const RawArchiveFileHeader*>(begin_);
+  if (size_ < sizeof(RawArchiveFileHeader) ||
+      header->magic != raw_microslice_archive_magic) {
+    throw std::runtime_error("File \"" + filename_ +
+                             "\" is not a raw microslice archive");
+  }
+  if (header->version != raw_microslice_archive_version &&
+      header->version != raw_microslice_archive_version_encoded &&
+      header->version != raw_microslice_archive_version_digest) {
+    throw std::runtime_error("File \"" + filename_ +
+                             "\" has unsupported raw archive version " +
+                             std::to_string(header->version));
+  }
+
+  version_ = header->version;
+  position_ = raw_archive_align(sizeof(RawArchiveFileHeader));
+}
+
+bool MicrosliceMappedArchive::encoded(const uint8_t* block) const {
+  const auto* header = reinterpret_cast<const RawMicrosliceBlockHeader*>(block);
+  if (version_ == raw_microslice_archive_version_digest) {
+    return header->encoded_size != 0;
+  }
+  return version_ == raw_microslice_archive_version_encoded;
+}
+
+uint64_t MicrosliceMappedArchive::stored_desc_size(const uint8_t* block) const {
+  const auto* header = reinterpret_cast<const RawMicrosliceBlockHeader*>(block);
+  return encoded(block)
+             ? header->encoded_size
+             : header->num_microslices * sizeof(MicrosliceDescriptor);
+}
+
+BlockVerification MicrosliceMappedArchive::verify(std::size_t threads) const {
+  BlockVerification result;
+  std::vector<const uint8_t*> blocks;
+  uint64_t position = raw_archive_align(sizeof(RawArchiveFileHeader));
+  while (position + sizeof(RawMicrosliceBlockHeader) <= size_) {
+    const uint8_t* block = begin_ + position;
+    const auto* header =
+        reinterpret_cast<const RawMicrosliceBlockHeader*>(block);
+    uint64_t content_offset =
+        raw_archive_align(raw_archive_align(sizeof(RawMicrosliceBlockHeader)) +
+                          stored_desc_size(block));
+    if (header->block_size < content_offset + header->content_size ||
+        header->block_size > size_ - position) {
+      throw std::runtime_error("File \"" + filename_ +
+                               "\" contains a truncated or corrupt block");
+    }
+    blocks.push_back(block);
+    result.bytes += header->block_size;
+    position += header->block_size;
+  }
+  result.blocks = blocks.size();
+  if (version_ != raw_microslice_archive_version_digest) {
+    result.unchecked = result.blocks;
+    return result;
+  }
+
+  // blocks are handed out one at a time, so that each thread reads ahead
+  // close to the others
+  std::atomic<std::size_t> next{0};
+  std::atomic<uint64_t> corrupt{0};
+  auto check = [this, &blocks, &next, &corrupt] {
+    for (std::size_t i = next++; i < blocks.size(); i = next++) {
+      const uint8_t* block = blocks[i];
+      const auto* header =
+          reinterpret_cast<const RawMicrosliceBlockHeader*>(block);
+      uint64_t desc_offset =
+          raw_archive_align(sizeof(RawMicrosliceBlockHeader));
+      uint64_t desc_size = stored_desc_size(block);
+      uint64_t content_offset = raw_archive_align(desc_offset + desc_size);
+      uint64_t digest =
+          block_digest(block + content_offset, header->content_size,
+                       block_digest(block + desc_offset, desc_size));
+      if (digest != header->digest) {
+        ++corrupt;
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(check);
+  }
+  check();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  result.corrupt = corrupt;
+  return result;
+}
+
+bool MicrosliceMappedArchive::next_block() {
+  if (position_ + sizeof(RawMicrosliceBlockHeader) > size_) {
+    return false;
+  }
+
+  const uint8_t* block = begin_ + position_;
+  const auto* header = reinterpret_cast<const RawMicrosliceBlockHeader*>(block);
+  uint64_t desc_offset = raw_archive_align(sizeof(RawMicrosliceBlockHeader));
+  uint64_t desc_size = stored_desc_size(block);
+  uint64_t content_offset = raw_archive_align(desc_offset + desc_size);
+  if (header->block_size < content_offset + header->content_size ||
+      header->block_size > size_ - position_) {
+    throw std::runtime_error("File \"" + filename_ +
+                             "\" contains a truncated or corrupt block");
+  }
+  position_ += header->block_size;
+
+  block_.num_microslices = header->num_microslices;
+  if (encoded(block)) {
+    // a new buffer, as retrieved microslices may refer to the previous one
+    auto decoded =
+        std::make_shared<std::vector<MicrosliceDescriptor>>(
+            header->num_microslices);
+    try {
+      decode_descriptors(block + desc_offset, desc_size, decoded->data(),
+                         decoded->size());
+    } catch (std::runtime_error& e) {
+      throw std::runtime_error("File \"" + filename_ +
+                               "\" contains a corrupt block: " + e.what());
+    }
+    block_.desc = decoded->data();
+    decoded_ = std::move(decoded);
+  } else {
+    block_.desc = reinterpret_cast<const MicrosliceDescriptor*>(
+        block + desc_offset);
+  }
+  block_.contents = block + content_offset;
+  next_ = 0;
+  return true;
+}
+
+bool MicrosliceMappedArchive::get_block(MicrosliceBlockView& block) {
+  if (eos_) {
+    return false;
+  }
+  while (next_ == block_.num_microslices) {
+    if (!next_block()) {
+      eos_ = true;
+      return false;
+    }
+  }
+  block.num_microslices = block_.num_microslices - next_;
+  block.desc = block_.desc + next_;
+  block.contents = block_.contents;
+  next_ = block_.num_microslices;
+  return true;
+}
+
+MappedMicroslice* MicrosliceMappedArchive::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+  while (next_ == block_.num_microslices) {
+    if (!next_block()) {
+      eos_ = true;
+      return nullptr;
+    }
+  }
+  const MicrosliceDescriptor* desc = &block_.desc[next_];
+  ++next_;
+  return new MappedMicroslice(region_, decoded_, desc, // NOLINT
+                              block_.contents + desc->offset);
+}
+
+} // namespace fles
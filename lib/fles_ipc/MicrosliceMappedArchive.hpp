@@ -0,0 +1,147 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::MicrosliceMappedArchive class.
+#pragma once
+
+#include "BlockDigest.hpp"
+#include "Microslice.hpp"
+#include "MicrosliceSource.hpp"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The MicrosliceBlockView struct refers to a block of microslices in
+ * a memory-mapped raw archive file.
+ */
+struct MicrosliceBlockView {
+  /// Number of microslices in the block
+  std::size_t num_microslices = 0;
+  /// Pointer to the packed array of microslice descriptors
+  const MicrosliceDescriptor* desc = nullptr;
+  /// Pointer to the contents of the block
+  const uint8_t* contents = nullptr;
+
+  /// Retrieve a pointer to the content of a microslice in the block.
+  [[nodiscard]] const uint8_t* content(std::size_t n) const {
+    return contents + desc[n].offset;
+  }
+};
+
+/**
+ * \brief The MappedMicroslice class provides access to the data of a single
+ * microslice in a memory-mapped raw archive file.
+ */
+class MappedMicroslice : public Microslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  MappedMicroslice(const MappedMicroslice&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MappedMicroslice&) = delete;
+
+  ~MappedMicroslice() override = default;
+
+private:
+  friend class MicrosliceMappedArchive;
+
+  MappedMicroslice(
+      std::shared_ptr<const boost::interprocess::mapped_region> region,
+      std::shared_ptr<const std::vector<MicrosliceDescriptor>> decoded,
+      const MicrosliceDescriptor* desc,
+      const uint8_t* content);
+
+  /// The mapping this microslice refers to, kept alive as long as needed.
+  std::shared_ptr<const boost::interprocess::mapped_region> region_;
+  /// The decoded descriptors of an encoded block (if any).
+  std::shared_ptr<const std::vector<MicrosliceDescriptor>> decoded_;
+};
+
+/**
+ * \brief The MicrosliceMappedArchive class provides microslices from a raw
+ * microslice archive file (see MicrosliceRawArchive.hpp) without copying.
+ *
+ * The file is mapped into memory as a whole. Microslices can be retrieved
+ * one by one, each referring directly to the mapped data, or a block at a
+ * time without any allocation. As the descriptors of a block are stored
+ * separately from the contents, a scan of the descriptors only does not
+ * touch the pages of the contents. Encoded descriptors are decoded once
+ * per block, the contents are always accessed in place.
+ */
+class MicrosliceMappedArchive : public MicrosliceSource {
+public:
+  /**
+   * \brief Construct a mapped archive object, map the given raw archive file
+   * and check its file header.
+   *
+   * \param filename File name of the raw archive file
+   */
+  explicit MicrosliceMappedArchive(const std::string& filename);
+
+  /// Delete copy constructor (non-copyable).
+  MicrosliceMappedArchive(const MicrosliceMappedArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MicrosliceMappedArchive&) = delete;
+
+  ~MicrosliceMappedArchive() override = default;
+
+  /// Retrieve the next microslice.
+  std::unique_ptr<MappedMicroslice> get() {
+    return std::unique_ptr<MappedMicroslice>(do_get());
+  };
+
+  /**
+   * \brief Retrieve the microslices of the current block not yet retrieved
+   * by get(), or else the next block.
+   *
+   * The view is valid as long as the archive object exists. For archives
+   * with encoded descriptors, it is valid until the next block is entered.
+   *
+   * \return false at the end of the archive
+   */
+  bool get_block(MicrosliceBlockView& block);
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+  /**
+   * \brief Check the digests of all blocks of the file, independent of the
+   * position of retrieval.
+   *
+   * \param threads Number of threads checking blocks concurrently
+   */
+  [[nodiscard]] BlockVerification verify(std::size_t threads) const;
+
+private:
+  MappedMicroslice* do_get() override;
+
+  /// Advance to the next block of the file.
+  bool next_block();
+
+  /// Retrieve the size of the stored descriptors of a block.
+  [[nodiscard]] uint64_t stored_desc_size(const uint8_t* block) const;
+
+  /// Retrieve whether the descriptors of a block are encoded.
+  [[nodiscard]] bool encoded(const uint8_t* block) const;
+
+  std::string filename_;
+  std::shared_ptr<const boost::interprocess::mapped_region> region_;
+  const uint8_t* begin_ = nullptr;
+  uint64_t size_ = 0;
+  uint64_t position_ = 0;
+
+  uint32_t version_ = 0;
+
+  MicrosliceBlockView block_;
+  /// The decoded descriptors of the current block (if encoded).
+  std::shared_ptr<const std::vector<MicrosliceDescriptor>> decoded_;
+  std::size_t next_ = 0;
+
+  bool eos_ = false;
+};
+
+} // namespace fles
@@ -0,0 +1,66 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the on-disk layout of raw microslice archive files.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include "TimesliceRawArchive.hpp"
+#include <cstdint>
+
+namespace fles {
+
+/**
+ * \brief The raw microslice archive file layout.
+ *
+ * A raw microslice archive stores microslices in blocks, each laid out like
+ * a timeslice component in memory, so that a block can be accessed in place
+ * after mapping the file (see MicrosliceMappedArchive). A file consists of
+ * a RawArchiveFileHeader (with raw_microslice_archive_magic) followed by a
+ * sequence of blocks, each consisting of
+ *
+ * - a RawMicrosliceBlockHeader,
+ * - the packed array of MicrosliceDescriptor objects,
+ * - the concatenated contents of the microslices.
+ *
+ * All parts are aligned to raw_archive_alignment bytes. The offset field of
+ * each stored microslice descriptor is the offset of its content relative
+ * to the start of the block's contents. All values are in host byte order.
+ *
+ * In files of version raw_microslice_archive_version_encoded, the array of
+ * descriptors is replaced by its columnar encoding (see
+ * encode_descriptors()), which has to be decoded before accessing the
+ * block.
+ *
+ * In files of version raw_microslice_archive_version_digest, each block
+ * header carries the digest of the block's stored descriptors and
+ * contents, computed as block_digest() of the contents seeded with the
+ * block_digest() of the descriptors. The descriptors of a block are
+ * encoded if and only if its encoded_size is nonzero.
+ */
+
+#pragma pack(1)
+
+/// The header at the beginning of each block in a raw microslice archive.
+struct RawMicrosliceBlockHeader {
+  uint64_t block_size;      ///< Size (in bytes) of the padded block
+  uint64_t num_microslices; ///< Number of microslices in the block
+  uint64_t content_size;    ///< Size (in bytes) of the contents
+  uint64_t encoded_size;    ///< Size of the encoded descriptors (or zero)
+  uint64_t digest;          ///< Digest of the block (or zero)
+};
+
+#pragma pack()
+
+/// Magic number identifying raw microslice archive files ("FLESMSR\0").
+constexpr uint64_t raw_microslice_archive_magic = 0x0052534d53454c46;
+
+/// Current raw microslice archive format version.
+constexpr uint32_t raw_microslice_archive_version = 1;
+
+/// Raw microslice archive format version with encoded descriptors.
+constexpr uint32_t raw_microslice_archive_version_encoded = 2;
+
+/// Raw microslice archive format version with block digests.
+constexpr uint32_t raw_microslice_archive_version_digest = 3;
+
+} // namespace fles
@@ -0,0 +1,105 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MicrosliceRawOutputArchive.hpp"
+#include "BlockDigest.hpp"
+#include "DescriptorCodec.hpp"
+#include "MicrosliceRawArchive.hpp"
+#include "log.hpp"
+
+namespace fles {
+
+MicrosliceRawOutputArchive::MicrosliceRawOutputArchive(
+    const std::string& filename,
+    std::size_t microslices_per_block,
+    std::size_t max_block_content_size,
+    bool encode_descriptors)
+    : filename_(filename), ofstream_(filename, std::ios::binary),
+      microslices_per_block_(
+          microslices_per_block > 0 ? microslices_per_block : 1),
+      max_block_content_size_(max_block_content_size),
+      encode_descriptors_(encode_descriptors),
+      padding_(raw_archive_alignment, 0) {
+  if (!ofstream_) {
+    throw std::ios_base::failure("error opening file \"" + filename_ + "\"");
+  }
+
+  RawArchiveFileHeader header{raw_microslice_archive_magic,
+                              raw_microslice_archive_version_digest, 0};
+  ofstream_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  ofstream_.write(padding_.data(), static_cast<std::streamsize>(
+                                       raw_archive_align(sizeof(header)) -
+                                       sizeof(header)));
+  desc_.reserve(microslices_per_block_);
+}
+
+MicrosliceRawOutputArchive::~MicrosliceRawOutputArchive() {
+  try {
+    end_stream();
+  } catch (std::exception& e) {
+    L_(error) << "error writing raw microslice archive: " << e.what();
+  }
+}
+
+void MicrosliceRawOutputArchive::put(std::shared_ptr<const Microslice> item) {
+  MicrosliceDescriptor desc = item->desc();
+  desc.offset = content_.size();
+  desc_.push_back(desc);
+  content_.insert(content_.end(), item->content(),
+                  item->content() + desc.size);
+
+  if (desc_.size() == microslices_per_block_ ||
+      content_.size() >= max_block_content_size_) {
+    write_block();
+  }
+}
+
+void MicrosliceRawOutputArchive::end_stream() {
+  if (!ofstream_.is_open()) {
+    return;
+  }
+  write_block();
+  ofstream_.close();
+}
+
+void MicrosliceRawOutputArchive::write_block() {
+  if (desc_.empty()) {
+    return;
+  }
+
+  const void* desc_data = desc_.data();
+  uint64_t desc_size = desc_.size() * sizeof(MicrosliceDescriptor);
+  uint64_t encoded_size = 0;
+  if (encode_descriptors_) {
+    encoded_.clear();
+    encode_descriptors(desc_.data(), desc_.size(), encoded_);
+    desc_data = encoded_.data();
+    desc_size = encoded_size = encoded_.size();
+  }
+
+  RawMicrosliceBlockHeader header{
+      raw_archive_align(sizeof(RawMicrosliceBlockHeader)) +
+          raw_archive_align(desc_size) + raw_archive_align(content_.size()),
+      desc_.size(), content_.size(), encoded_size,
+      block_digest(content_.data(), content_.size(),
+                   block_digest(desc_data, desc_size))};
+
+  auto write_padded = [this](const void* data, uint64_t size) {
+    ofstream_.write(static_cast<const char*>(data),
+                    static_cast<std::streamsize>(size));
+    ofstream_.write(padding_.data(), static_cast<std::streamsize>(
+                                         raw_archive_align(size) - size));
+  };
+
+  write_padded(&header, sizeof(header));
+  write_padded(desc_data, desc_size);
+  write_padded(content_.data(), content_.size());
+
+  if (!ofstream_) {
+    throw std::ios_base::failure("error writing file \"" + filename_ + "\"");
+  }
+
+  desc_.clear();
+  content_.clear();
+}
+
+} // namespace fles
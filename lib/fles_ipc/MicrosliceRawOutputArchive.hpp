@@ -0,0 +1,80 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::MicrosliceRawOutputArchive class.
+#pragma once
+
+#include "Microslice.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "Sink.hpp"
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The MicrosliceRawOutputArchive class writes microslices to an
+ * output file in blocks of the raw, directly mappable layout (see
+ * MicrosliceRawArchive.hpp).
+ *
+ * Microslices are collected until a block is full and then written with a
+ * single write of its descriptors and a single write of its contents.
+ * Optionally, the descriptors are stored in a compact columnar encoding
+ * (see encode_descriptors()), which shrinks archives of small microslices
+ * considerably. Each block carries a digest of its stored data (see
+ * MicrosliceMappedArchive::verify()).
+ */
+class MicrosliceRawOutputArchive : public Sink<Microslice> {
+public:
+  /// Default maximum number of microslices per block.
+  static constexpr std::size_t default_microslices_per_block = 4096;
+  /// Default size of the contents completing a block.
+  static constexpr std::size_t default_max_block_content_size =
+      64 * 1024 * 1024;
+
+  /**
+   * \brief Construct a raw output archive object, open the given file for
+   * writing, and write the file header.
+   *
+   * \param filename               File name of the archive file
+   * \param microslices_per_block  Maximum number of microslices per block
+   * \param max_block_content_size Size of the contents completing a block
+   * \param encode_descriptors     Store the descriptors encoded
+   */
+  explicit MicrosliceRawOutputArchive(
+      const std::string& filename,
+      std::size_t microslices_per_block = default_microslices_per_block,
+      std::size_t max_block_content_size = default_max_block_content_size,
+      bool encode_descriptors = false);
+
+  /// Delete copy constructor (non-copyable).
+  MicrosliceRawOutputArchive(const MicrosliceRawOutputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MicrosliceRawOutputArchive&) = delete;
+
+  /// Destruct the archive object, writing the last block.
+  ~MicrosliceRawOutputArchive() override;
+
+  /// Store a microslice.
+  void put(std::shared_ptr<const Microslice> item) override;
+
+  void end_stream() override;
+
+private:
+  void write_block();
+
+  std::string filename_;
+  std::ofstream ofstream_;
+  std::size_t microslices_per_block_;
+  std::size_t max_block_content_size_;
+  bool encode_descriptors_;
+  std::vector<char> padding_;
+  std::vector<uint8_t> encoded_;
+
+  std::vector<MicrosliceDescriptor> desc_;
+  std::vector<uint8_t> content_;
+};
+
+} // namespace fles
@@ -0,0 +1,132 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MicrosliceStoragePool.hpp"
+#include <new>
+
+namespace fles {
+
+namespace {
+
+// trivially destructible, so that it stays valid during thread exit
+thread_local bool local_pool_destroyed = false;
+
+} // namespace
+
+MicrosliceStoragePool::~MicrosliceStoragePool() {
+  for (auto& blocks : blocks_) {
+    for (BlockHeader* header : blocks) {
+      ::operator delete(header);
+    }
+  }
+}
+
+MicrosliceStoragePool* MicrosliceStoragePool::local() {
+  if (local_pool_destroyed) {
+    return nullptr;
+  }
+  struct LocalPool {
+    MicrosliceStoragePool pool;
+    ~LocalPool() { local_pool_destroyed = true; }
+  };
+  thread_local LocalPool local_pool;
+  return &local_pool.pool;
+}
+
+size_t MicrosliceStoragePool::class_for_size(size_t bytes) {
+  size_t size_class = 0;
+  while (size_class < num_classes && class_bytes(size_class) < bytes) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+std::vector<uint8_t> MicrosliceStoragePool::acquire(size_t capacity) {
+  std::vector<uint8_t> buffer;
+  size_t size_class = class_for_size(capacity);
+  if (size_class == num_classes) {
+    buffer.reserve(capacity);
+    return buffer;
+  }
+  auto& free = buffers_[size_class];
+  if (!free.empty()) {
+    buffer = std::move(free.back());
+    free.pop_back();
+    bytes_ -= class_bytes(size_class);
+    ++reused_;
+    return buffer;
+  }
+  ++allocated_;
+  buffer.reserve(class_bytes(size_class));
+  return buffer;
+}
+
+void MicrosliceStoragePool::release(std::vector<uint8_t>&& buffer) {
+  // only buffers of a class size (as handed out by acquire()) are kept
+  size_t size_class = class_for_size(buffer.capacity());
+  if (size_class == num_classes ||
+      buffer.capacity() != class_bytes(size_class)) {
+    return;
+  }
+  auto& free = buffers_[size_class];
+  if (!may_keep(size_class, free.size())) {
+    return;
+  }
+  buffer.clear();
+  bytes_ += class_bytes(size_class);
+  free.push_back(std::move(buffer));
+}
+
+MicrosliceStoragePool::BlockHeader*
+MicrosliceStoragePool::new_block(size_t bytes, size_t size_class) {
+  void* memory = ::operator new(sizeof(BlockHeader) + bytes);
+  return new (memory) BlockHeader{size_class};
+}
+
+void* MicrosliceStoragePool::allocate(size_t bytes) {
+  size_t size_class = class_for_size(bytes);
+  if (size_class == num_classes) {
+    return allocate_unpooled(bytes);
+  }
+  auto& free = blocks_[size_class];
+  if (!free.empty()) {
+    BlockHeader* header = free.back();
+    free.pop_back();
+    bytes_ -= class_bytes(size_class);
+    ++reused_;
+    return header + 1;
+  }
+  ++allocated_;
+  return new_block(class_bytes(size_class), size_class) + 1;
+}
+
+void MicrosliceStoragePool::deallocate(void* block) {
+  // a block is kept in the class it was allocated for, not in the one
+  // derived from the size of the object released
+  BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+  size_t size_class = header->size_class;
+  if (size_class == num_classes ||
+      !may_keep(size_class, blocks_[size_class].size())) {
+    ::operator delete(header);
+    return;
+  }
+  bytes_ += class_bytes(size_class);
+  blocks_[size_class].push_back(header);
+}
+
+void* MicrosliceStoragePool::allocate_unpooled(size_t bytes) {
+  return new_block(bytes, num_classes) + 1;
+}
+
+void MicrosliceStoragePool::deallocate_unpooled(void* block) {
+  ::operator delete(static_cast<BlockHeader*>(block) - 1);
+}
+
+MicrosliceStoragePool::Statistics MicrosliceStoragePool::statistics() const {
+  Statistics s;
+  s.reused = reused_;
+  s.allocated = allocated_;
+  s.bytes = bytes_;
+  return s;
+}
+
+} // namespace fles
@@ -0,0 +1,120 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::MicrosliceStoragePool class.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The MicrosliceStoragePool class recycles the memory of
+ * StorableMicroslice objects and their contents.
+ *
+ * Memory is kept in power-of-two size classes, up to a given number of
+ * entries per class and a total size, and handed out again. Each thread
+ * has its own pool (see local()), so that no locking is needed: memory
+ * released on a thread is reused by the microslices subsequently created
+ * on the same thread. A steady stream of microslices created and destroyed
+ * on one thread then does no general-purpose heap allocation.
+ */
+class MicrosliceStoragePool {
+public:
+  /// Usage statistics of the pool.
+  struct Statistics {
+    uint64_t reused = 0;    ///< number of buffers and blocks handed out again
+    uint64_t allocated = 0; ///< number of buffers and blocks newly allocated
+    size_t bytes = 0;       ///< size of the buffers and blocks currently kept
+  };
+
+  /// Smallest size class (in bytes).
+  static constexpr size_t min_class_bytes = 64;
+  /// Number of size classes, larger memory is not recycled.
+  static constexpr size_t num_classes = 20;
+
+  /**
+   * \brief Construct an empty pool.
+   *
+   * \param max_per_class maximum number of buffers or blocks kept per class
+   * \param max_bytes     maximum total size of the memory kept
+   */
+  explicit MicrosliceStoragePool(size_t max_per_class = 1024,
+                                 size_t max_bytes = size_t{64} << 20)
+      : max_per_class_(max_per_class), max_bytes_(max_bytes) {}
+
+  /// Delete copy constructor (non-copyable).
+  MicrosliceStoragePool(const MicrosliceStoragePool&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MicrosliceStoragePool&) = delete;
+
+  /// Destruct the pool, freeing the memory kept.
+  ~MicrosliceStoragePool();
+
+  /// Retrieve the pool of the calling thread.
+  /** \return nullptr during destruction of the thread's pool at thread exit */
+  static MicrosliceStoragePool* local();
+
+  /// Retrieve an empty buffer of at least the given capacity.
+  std::vector<uint8_t> acquire(size_t capacity);
+
+  /// Return a buffer to the pool.
+  void release(std::vector<uint8_t>&& buffer);
+
+  /// Retrieve a memory block of the given size.
+  void* allocate(size_t bytes);
+
+  /// Return a memory block to the pool.
+  /** The block may stem from allocate() of any pool or from
+      allocate_unpooled(), it is kept according to its recorded size
+      class. */
+  void deallocate(void* block);
+
+  /// Retrieve a memory block that is not taken from a pool.
+  static void* allocate_unpooled(size_t bytes);
+
+  /// Free a memory block without keeping it in a pool.
+  static void deallocate_unpooled(void* block);
+
+  /// Retrieve the usage statistics.
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  /// Header in front of each memory block.
+  struct alignas(alignof(std::max_align_t)) BlockHeader {
+    /// Size class of the block (num_classes: not of a class size)
+    size_t size_class;
+  };
+
+  /// Allocate a memory block with header.
+  static BlockHeader* new_block(size_t bytes, size_t size_class);
+
+  /// Retrieve the smallest class holding at least the given size.
+  static size_t class_for_size(size_t bytes);
+
+  /// Retrieve the size of a class.
+  static size_t class_bytes(size_t size_class) {
+    return min_class_bytes << size_class;
+  }
+
+  /// Check whether memory of the given size class may be kept.
+  [[nodiscard]] bool may_keep(size_t size_class, size_t count) const {
+    return count < max_per_class_ &&
+           bytes_ + class_bytes(size_class) <= max_bytes_;
+  }
+
+  const size_t max_per_class_;
+  const size_t max_bytes_;
+
+  /// The buffers kept, per size class.
+  std::array<std::vector<std::vector<uint8_t>>, num_classes> buffers_;
+  /// The memory blocks kept, per size class.
+  std::array<std::vector<BlockHeader*>, num_classes> blocks_;
+  size_t bytes_ = 0;
+  uint64_t reused_ = 0;
+  uint64_t allocated_ = 0;
+};
+
+} // namespace fles
@@ -3,11 +3,15 @@
 /// \brief Defines the fles::OutputArchive template class.
 #pragma once
 
+#include "ArchiveBlock.hpp"
 #include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
 #include "Sink.hpp"
 #include <boost/archive/binary_oarchive.hpp>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <utility>
 
 namespace fles {
 
@@ -19,13 +23,29 @@ class OutputArchive : public Sink<Base> {
 public:
   /**
    * \brief Construct an output archive object, open the given archive file
-   * for writing, and write the archive descriptor.
+   * for writing, and write the archive descriptor. For uncompressed
+   * archives, an index of the stored data sets is written to a sidecar file
+   * (see ArchiveIndex). Compressed archives are written in blocks of data
+   * sets (see ArchiveBlockWriter).
    *
-   * \param filename File name of the archive file
+   * \param filename    File name of the archive file
+   * \param compression Compression to use for the data sets
+   * \param compression_dictionary Dictionary to use for compression (see
+   * train_compression_dictionary()), empty for none
    */
-  OutputArchive(const std::string& filename)
-      : ofstream_(filename, std::ios::binary), oarchive_(ofstream_) {
+  OutputArchive(const std::string& filename,
+                ArchiveCompression compression = ArchiveCompression::None,
+                std::string compression_dictionary = {})
+      : ofstream_(filename, std::ios::binary), oarchive_(ofstream_),
+        descriptor_(archive_type, compression,
+                    std::move(compression_dictionary)) {
     oarchive_ << descriptor_;
+    if (compression == ArchiveCompression::None) {
+      index_ = std::make_unique<ArchiveIndexWriter>(filename, descriptor_);
+    } else {
+      block_writer_ =
+          std::make_unique<ArchiveBlockWriter>(ofstream_, descriptor_);
+    }
   }
 
   /// Delete copy constructor (non-copyable).
@@ -36,17 +56,37 @@ public:
   ~OutputArchive() override = default;
 
   /// Store an item.
-  void put(std::shared_ptr<const Base> item) override { do_put(*item); }
+  void put(std::shared_ptr<const Base> item) override {
+    do_put(serializable(*item));
+  }
 
-  void end_stream() override { ofstream_.close(); }
+  void end_stream() override {
+    if (block_writer_) {
+      block_writer_->finish();
+      block_writer_ = nullptr;
+    }
+    ofstream_.close();
+    index_ = nullptr;
+  }
 
 private:
   std::ofstream ofstream_;
   boost::archive::binary_oarchive oarchive_;
-  ArchiveDescriptor descriptor_{archive_type};
+  ArchiveDescriptor descriptor_;
+  std::unique_ptr<ArchiveIndexWriter> index_;
+  std::unique_ptr<ArchiveBlockWriter> block_writer_;
 
-  void do_put(const Derived& item) { oarchive_ << item; }
-  // TODO(Jan): Solve this without the additional alloc/copy operation
+  void do_put(const Derived& item) {
+    if (block_writer_) {
+      block_writer_->put(item);
+      return;
+    }
+    if (index_) {
+      index_->add(ofstream_.tellp(), archive_index_of(item),
+                  archive_start_time_of(item));
+    }
+    oarchive_ << item;
+  }
 };
 
 } // namespace fles
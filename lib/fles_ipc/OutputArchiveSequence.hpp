@@ -3,14 +3,20 @@
 /// \brief Defines the fles::OutputArchiveSequence template class.
 #pragma once
 
+#include "ArchiveBlock.hpp"
+#include "ArchiveCatalog.hpp"
 #include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
+#include "OutputFileBuffer.hpp"
 #include "Sink.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/filesystem.hpp>
 #include <cstdint>
 #include <fstream>
 #include <iomanip>
 #include <memory>
+#include <ostream>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -32,12 +38,30 @@ public:
    *
    * \param filename_template File name pattern of the archive files
    * \param items_per_file    Number of items to store in each file
+   * \param bytes_per_file    Number of bytes after which to start a new file
+   * \param compression       Compression to use for the data sets
+   * \param direct_io         Write files bypassing the page cache (O_DIRECT)
+   * \param compression_dictionary Dictionary to use for compression (see
+   * train_compression_dictionary()), empty for none
+   * \param catalog_filename Catalog file to append an entry to for each
+   * completed file (see ArchiveCatalog), empty for none
+   *
+   * If a byte limit is given, disk space for each file is preallocated when
+   * the file is opened.
    */
-  OutputArchiveSequence(std::string filename_template,
-                        std::size_t items_per_file = SIZE_MAX,
-                        std::size_t bytes_per_file = SIZE_MAX)
-      : filename_template_(std::move(filename_template)),
-        items_per_file_(items_per_file), bytes_per_file_(bytes_per_file) {
+  OutputArchiveSequence(
+      std::string filename_template,
+      std::size_t items_per_file = SIZE_MAX,
+      std::size_t bytes_per_file = SIZE_MAX,
+      ArchiveCompression compression = ArchiveCompression::None,
+      bool direct_io = false,
+      std::string compression_dictionary = {},
+      std::string catalog_filename = {})
+      : descriptor_(archive_type, compression,
+                    std::move(compression_dictionary)),
+        filename_template_(std::move(filename_template)),
+        items_per_file_(items_per_file), bytes_per_file_(bytes_per_file),
+        direct_io_(direct_io), catalog_filename_(std::move(catalog_filename)) {
     if (items_per_file_ == 0) {
       items_per_file_ = SIZE_MAX;
     }
@@ -62,30 +86,50 @@ public:
   ~OutputArchiveSequence() override = default;
 
   /// Store an item.
-  void put(std::shared_ptr<const Base> item) override { do_put(*item); }
-
-  void end_stream() override {
-    oarchive_ = nullptr;
-    ofstream_ = nullptr;
+  void put(std::shared_ptr<const Base> item) override {
+    do_put(serializable(*item));
   }
 
+  void end_stream() override { close_file(); }
+
 private:
-  std::unique_ptr<std::ofstream> ofstream_;
+  std::unique_ptr<OutputFileBuffer> filebuf_;
+  std::unique_ptr<std::ostream> ostream_;
   std::unique_ptr<boost::archive::binary_oarchive> oarchive_;
-  ArchiveDescriptor descriptor_{archive_type};
+  std::unique_ptr<ArchiveIndexWriter> index_;
+  std::unique_ptr<ArchiveBlockWriter> block_writer_;
+  ArchiveDescriptor descriptor_;
 
   std::string filename_template_;
   std::size_t items_per_file_;
   std::size_t bytes_per_file_;
+  bool direct_io_;
+  std::string catalog_filename_;
   std::size_t file_count_ = 0;
   std::size_t file_item_count_ = 0;
 
-  // TODO(Jan): Solve this without the additional alloc/copy operation
+  /// The catalog entry of the current file.
+  ArchiveCatalogEntry catalog_entry_{};
+
   void do_put(const Derived& item) {
     if (file_limit_reached()) {
       next_file();
     }
-    *oarchive_ << item;
+    if (block_writer_) {
+      block_writer_->put(item);
+    } else {
+      if (index_) {
+        index_->add(ostream_->tellp(), archive_index_of(item),
+                    archive_start_time_of(item));
+      }
+      *oarchive_ << item;
+    }
+    if (file_item_count_ == 0) {
+      catalog_entry_.first_index = archive_index_of(item);
+      catalog_entry_.first_time = archive_start_time_of(item);
+    }
+    catalog_entry_.last_index = archive_index_of(item);
+    catalog_entry_.last_time = archive_start_time_of(item);
     ++file_item_count_;
   }
 
@@ -102,7 +146,7 @@ private:
     }
     // check byte limit if set
     if (bytes_per_file_ < SIZE_MAX) {
-      auto pos = ofstream_->tellp();
+      auto pos = ostream_->tellp();
       if (pos > 0 && static_cast<std::size_t>(pos) >= bytes_per_file_) {
         return true;
       }
@@ -110,13 +154,44 @@ private:
     return false;
   }
 
-  void next_file() {
+  void close_file() {
+    if (block_writer_) {
+      block_writer_->finish();
+      block_writer_ = nullptr;
+    }
     oarchive_ = nullptr;
-    ofstream_ = nullptr;
-    ofstream_ = std::make_unique<std::ofstream>(filename(file_count_),
-                                                std::ios::binary);
-    oarchive_ = std::make_unique<boost::archive::binary_oarchive>(*ofstream_);
+    index_ = nullptr;
+    if (filebuf_) {
+      catalog_entry_.size = static_cast<uint64_t>(ostream_->tellp());
+      ostream_ = nullptr;
+      auto filebuf = std::move(filebuf_);
+      filebuf->close();
+      if (!catalog_filename_.empty() && file_item_count_ > 0) {
+        catalog_entry_.filename =
+            boost::filesystem::absolute(filename(file_count_ - 1)).string();
+        catalog_entry_.count = file_item_count_;
+        ArchiveCatalog::append(catalog_filename_, catalog_entry_);
+      }
+    }
+  }
+
+  void next_file() {
+    close_file();
+    filebuf_ =
+        std::make_unique<OutputFileBuffer>(filename(file_count_), direct_io_);
+    if (bytes_per_file_ < SIZE_MAX) {
+      filebuf_->preallocate(bytes_per_file_);
+    }
+    ostream_ = std::make_unique<std::ostream>(filebuf_.get());
+    oarchive_ = std::make_unique<boost::archive::binary_oarchive>(*ostream_);
     *oarchive_ << descriptor_;
+    if (descriptor_.archive_compression() == ArchiveCompression::None) {
+      index_ = std::make_unique<ArchiveIndexWriter>(filename(file_count_),
+                                                    descriptor_);
+    } else {
+      block_writer_ =
+          std::make_unique<ArchiveBlockWriter>(*ostream_, descriptor_);
+    }
 
     ++file_count_;
     file_item_count_ = 0;
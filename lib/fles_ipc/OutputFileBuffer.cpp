@@ -0,0 +1,219 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "OutputFileBuffer.hpp"
+#include "System.hpp"
+#include "log.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <ios>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace fles {
+
+OutputFileBuffer::OutputFileBuffer(const std::string& filename,
+                                   bool direct_io,
+                                   std::size_t buffer_size)
+    : filename_(filename), direct_io_(direct_io),
+      buffer_size_((buffer_size + alignment_ - 1) / alignment_ * alignment_) {
+  if (buffer_size_ == 0) {
+    buffer_size_ = alignment_;
+  }
+
+  constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  constexpr mode_t mode = 0644;
+#ifdef O_DIRECT
+  if (direct_io_) {
+    fd_ = ::open(filename_.c_str(), flags | O_DIRECT, mode);
+    if (fd_ == -1 && errno == EINVAL) {
+      L_(warning) << "direct I/O not supported for file \"" << filename_
+                  << "\", using buffered I/O";
+      direct_io_ = false;
+    }
+  }
+#else
+  direct_io_ = false;
+#endif
+  if (fd_ == -1) {
+    fd_ = ::open(filename_.c_str(), flags, mode);
+  }
+  if (fd_ == -1) {
+    throw std::ios_base::failure("error opening file \"" + filename_ +
+                                 "\": " + system::stringerror(errno));
+  }
+
+  void* buf = nullptr;
+  int ret = posix_memalign(&buf, alignment_, buffer_size_);
+  if (ret != 0) {
+    ::close(fd_);
+    throw std::runtime_error(std::string("posix_memalign: ") +
+                             system::stringerror(ret));
+  }
+  buffer_.reset(static_cast<char*>(buf));
+  setp(buffer_.get(), buffer_.get() + buffer_size_);
+}
+
+OutputFileBuffer::~OutputFileBuffer() {
+  try {
+    close();
+  } catch (std::exception& e) {
+    L_(error) << e.what();
+  }
+}
+
+void OutputFileBuffer::preallocate(uint64_t size) {
+  if (fd_ == -1) {
+    return;
+  }
+#ifdef __linux__
+  // keep the file size, so that the file is complete at any time
+  if (::fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) ==
+      -1) {
+    L_(debug) << "fallocate failed for file \"" << filename_
+              << "\": " << system::stringerror(errno);
+  } else if (size > preallocated_) {
+    preallocated_ = size;
+  }
+#else
+  (void)size;
+#endif
+}
+
+void OutputFileBuffer::close() {
+  if (fd_ == -1) {
+    return;
+  }
+  bool ok = write_out(true);
+  // release the space preallocated beyond the end of the file
+  if (ok && preallocated_ > written_ &&
+      ::ftruncate(fd_, static_cast<off_t>(written_)) == -1) {
+    ok = false;
+  }
+  int fd = fd_;
+  fd_ = -1;
+  if (::close(fd) == -1) {
+    ok = false;
+  }
+  if (!ok) {
+    throw std::ios_base::failure("error writing file \"" + filename_ +
+                                 "\": " + system::stringerror(errno));
+  }
+}
+
+OutputFileBuffer::int_type OutputFileBuffer::overflow(int_type ch) {
+  if (fd_ == -1 || !write_out(false)) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+std::streamsize OutputFileBuffer::xsputn(const char_type* s,
+                                         std::streamsize count) {
+  auto size = static_cast<std::size_t>(count);
+  auto space = static_cast<std::size_t>(epptr() - pptr());
+  // O_DIRECT requires aligned memory, so copy to the buffer in that case
+  if (fd_ == -1 || direct_io_ || size <= space) {
+    return std::streambuf::xsputn(s, count);
+  }
+
+  auto pending = static_cast<std::size_t>(pptr() - pbase());
+  std::array<iovec, 2> iov{{{pbase(), pending},
+                            {const_cast<char_type*>(s), size}}};
+  std::size_t first = pending > 0 ? 0 : 1;
+  while (first < iov.size()) {
+    ssize_t n =
+        ::writev(fd_, &iov[first], static_cast<int>(iov.size() - first));
+    if (n == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return 0;
+    }
+    written_ += static_cast<uint64_t>(n);
+    // skip the completely written parts
+    auto left = static_cast<std::size_t>(n);
+    while (first < iov.size() && left >= iov[first].iov_len) {
+      left -= iov[first].iov_len;
+      ++first;
+    }
+    if (first < iov.size()) {
+      iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+      iov[first].iov_len -= left;
+    }
+  }
+  setp(buffer_.get(), buffer_.get() + buffer_size_);
+  return count;
+}
+
+int OutputFileBuffer::sync() {
+  if (fd_ == -1) {
+    return -1;
+  }
+  return write_out(false) ? 0 : -1;
+}
+
+OutputFileBuffer::pos_type
+OutputFileBuffer::seekoff(off_type off,
+                          std::ios_base::seekdir dir,
+                          std::ios_base::openmode which) {
+  // only position queries (as used by tellp()) are supported
+  if (off != 0 || dir != std::ios_base::cur ||
+      (which & std::ios_base::out) == 0) {
+    return {off_type(-1)};
+  }
+  return {static_cast<off_type>(written_ + (pptr() - pbase()))};
+}
+
+bool OutputFileBuffer::write_out(bool final) {
+  auto pending = static_cast<std::size_t>(pptr() - pbase());
+  std::size_t size = pending;
+  if (direct_io_ && !final) {
+    size = pending / alignment_ * alignment_;
+  }
+
+  const char* p = pbase();
+  std::size_t left = size;
+  while (left > 0) {
+    if (final && direct_io_ && left < alignment_) {
+      // write unaligned tail without O_DIRECT
+      int flags = ::fcntl(fd_, F_GETFL);
+#ifdef O_DIRECT
+      if (flags == -1 || ::fcntl(fd_, F_SETFL, flags & ~O_DIRECT) == -1) {
+        return false;
+      }
+#endif
+      direct_io_ = false;
+    }
+    std::size_t chunk = left;
+    if (direct_io_) {
+      chunk = left / alignment_ * alignment_;
+    }
+    ssize_t n = ::write(fd_, p, chunk);
+    if (n == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    left -= static_cast<std::size_t>(n);
+    written_ += static_cast<uint64_t>(n);
+  }
+
+  // move remaining (unaligned) data to the beginning of the buffer
+  std::size_t rest = pending - size;
+  if (rest > 0) {
+    std::memmove(buffer_.get(), pbase() + size, rest);
+  }
+  setp(buffer_.get(), buffer_.get() + buffer_size_);
+  pbump(static_cast<int>(rest));
+  return true;
+}
+
+} // namespace fles
@@ -0,0 +1,85 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::OutputFileBuffer class.
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace fles {
+
+/**
+ * \brief The OutputFileBuffer class is a stream buffer writing to a file
+ * using POSIX I/O, optionally bypassing the page cache.
+ *
+ * In contrast to std::filebuf, it allows preallocating disk space for the
+ * file and writing with O_DIRECT. In direct I/O mode, data is written in
+ * multiples of the block size from an aligned buffer; the unaligned tail is
+ * written without O_DIRECT when the file is closed. Otherwise, blocks that
+ * do not fit into the buffer are written directly from the caller's memory,
+ * together with the buffered data in a single writev call.
+ */
+class OutputFileBuffer : public std::streambuf {
+public:
+  /**
+   * \brief Create (or truncate) the given file for writing.
+   *
+   * \param filename    File name of the output file
+   * \param direct_io   Bypass the page cache using O_DIRECT (falls back to
+   *                    regular I/O if not supported by the file system)
+   * \param buffer_size Size of the write buffer (rounded to block size)
+   */
+  explicit OutputFileBuffer(const std::string& filename,
+                            bool direct_io = false,
+                            std::size_t buffer_size = 4 * 1024 * 1024);
+
+  /// Delete copy constructor (non-copyable).
+  OutputFileBuffer(const OutputFileBuffer&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const OutputFileBuffer&) = delete;
+
+  ~OutputFileBuffer() override;
+
+  /**
+   * \brief Reserve disk space for the file without changing its size.
+   *
+   * This is a hint only; failure (e.g., if unsupported) is ignored. Space
+   * not used by the time the file is closed is released.
+   */
+  void preallocate(uint64_t size);
+
+  /// Write all buffered data and close the file.
+  void close();
+
+  /// Check if the file is using direct I/O.
+  [[nodiscard]] bool direct_io() const { return direct_io_; }
+
+protected:
+  int_type overflow(int_type ch) override;
+  std::streamsize xsputn(const char_type* s, std::streamsize count) override;
+  int sync() override;
+  pos_type seekoff(off_type off,
+                   std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+
+private:
+  /// Write buffered data to the file, keeping an unaligned tail in direct
+  /// I/O mode unless final is set.
+  bool write_out(bool final);
+
+  static constexpr std::size_t alignment_ = 4096;
+
+  std::string filename_;
+  int fd_ = -1;
+  bool direct_io_;
+  std::unique_ptr<char, void (*)(void*)> buffer_{nullptr, free};
+  std::size_t buffer_size_;
+  uint64_t written_ = 0;
+  /// The size of the disk space reserved by preallocate().
+  uint64_t preallocated_ = 0;
+};
+
+} // namespace fles
@@ -0,0 +1,68 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "SelectedTimeslice.hpp"
+#include <algorithm>
+
+namespace fles {
+
+SelectedTimeslice::SelectedTimeslice(
+    std::shared_ptr<const Timeslice> timeslice,
+    const ComponentSelection& selection)
+    : timeslice_(std::move(timeslice)) {
+  timeslice_descriptor_ = timeslice_->timeslice_descriptor_;
+  for (uint64_t c : selection.components(*timeslice_)) {
+    data_ptr_.push_back(timeslice_->data_ptr_[c]);
+    desc_ptr_.push_back(timeslice_->desc_ptr_[c]);
+    if (!timeslice_->content_ptr_.empty()) {
+      content_ptr_.push_back(timeslice_->content_ptr_[c]);
+    }
+  }
+  timeslice_descriptor_.num_components =
+      static_cast<uint32_t>(data_ptr_.size());
+}
+
+SelectedTimeslice::SelectedTimeslice(
+    std::shared_ptr<const Timeslice> timeslice,
+    uint64_t begin_idx,
+    uint64_t end_idx)
+    : timeslice_(std::move(timeslice)) {
+  timeslice_descriptor_ = timeslice_->timeslice_descriptor_;
+  const uint64_t num_components = timeslice_->num_components();
+  desc_.reserve(num_components);
+  for (uint64_t c = 0; c < num_components; ++c) {
+    const TimesliceComponentDescriptor& ts_desc = *timeslice_->desc_ptr_[c];
+    const MicrosliceDescriptor* descs = timeslice_->descriptors(c);
+    const uint64_t n = ts_desc.num_microslices;
+    auto less = [](const MicrosliceDescriptor& d, uint64_t idx) {
+      return d.idx < idx;
+    };
+    const auto first = static_cast<uint64_t>(
+        std::lower_bound(descs, descs + n, begin_idx, less) - descs);
+    const auto last = static_cast<uint64_t>(
+        std::lower_bound(descs + first, descs + n, end_idx, less) - descs);
+
+    // the contents of the range, including any padding up to the next
+    // microslice
+    uint8_t* content = timeslice_->content_ptr(c);
+    uint64_t content_size = 0;
+    if (first < last) {
+      content += descs[first].offset - descs[0].offset;
+      const uint64_t end_offset =
+          last < n ? descs[last].offset
+                   : descs[0].offset +
+                         (ts_desc.size - timeslice_->descriptors_size(c));
+      content_size = end_offset - descs[first].offset;
+    }
+
+    TimesliceComponentDescriptor& desc = desc_.emplace_back(ts_desc);
+    desc.num_microslices = last - first;
+    desc.size = desc.num_microslices * sizeof(MicrosliceDescriptor) +
+                content_size;
+    data_ptr_.push_back(timeslice_->data_ptr_[c] +
+                        first * sizeof(MicrosliceDescriptor));
+    desc_ptr_.push_back(&desc);
+    content_ptr_.push_back(content);
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,87 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::SelectedTimeslice and
+/// fles::ComponentSelectingSource classes.
+#pragma once
+
+#include "ComponentSelection.hpp"
+#include "Timeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <memory>
+#include <utility>
+
+namespace fles {
+
+/**
+ * \brief The SelectedTimeslice class provides access to a subset of the
+ * components or microslices of another timeslice.
+ *
+ * The timeslice refers directly to the data of the original timeslice, which
+ * is kept alive as long as needed. The selected components are renumbered
+ * consecutively. Constructing it costs O(number of components) regardless of
+ * the amount of data, also when selecting from another SelectedTimeslice.
+ */
+class SelectedTimeslice : public Timeslice {
+public:
+  /// Construct a timeslice with the selected components of a timeslice.
+  SelectedTimeslice(std::shared_ptr<const Timeslice> timeslice,
+                    const ComponentSelection& selection);
+
+  /// Construct a timeslice with the microslices of a timeslice that have an
+  /// index (start time) in the interval [begin_idx, end_idx).
+  /** All components are kept. A component without microslices in the
+      interval is empty, i.e., reported as missing. The number of core
+      microslices is that of the original timeslice. */
+  SelectedTimeslice(std::shared_ptr<const Timeslice> timeslice,
+                    uint64_t begin_idx,
+                    uint64_t end_idx);
+
+  /// Delete copy constructor (non-copyable).
+  SelectedTimeslice(const SelectedTimeslice&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const SelectedTimeslice&) = delete;
+
+  ~SelectedTimeslice() override = default;
+
+private:
+  /// The timeslice this timeslice refers to.
+  std::shared_ptr<const Timeslice> timeslice_;
+
+  /// The component descriptors of the selected microslices.
+  std::vector<TimesliceComponentDescriptor> desc_;
+};
+
+/**
+ * \brief The ComponentSelectingSource class provides the selected components
+ * of the timeslices of another source.
+ */
+class ComponentSelectingSource : public TimesliceSource {
+public:
+  /// Construct a source selecting components from a given source.
+  ComponentSelectingSource(std::unique_ptr<TimesliceSource> source,
+                           ComponentSelection selection)
+      : source_(std::move(source)), selection_(std::move(selection)) {}
+
+  /// Delete copy constructor (non-copyable).
+  ComponentSelectingSource(const ComponentSelectingSource&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ComponentSelectingSource&) = delete;
+
+  ~ComponentSelectingSource() override = default;
+
+  [[nodiscard]] bool eos() const override { return source_->eos(); }
+
+private:
+  std::unique_ptr<TimesliceSource> source_;
+  ComponentSelection selection_;
+
+  Timeslice* do_get() override {
+    std::shared_ptr<const Timeslice> timeslice = source_->get();
+    if (!timeslice) {
+      return nullptr;
+    }
+    return new SelectedTimeslice(std::move(timeslice), selection_); // NOLINT
+  }
+};
+
+} // namespace fles
@@ -0,0 +1,94 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ShmAttachmentCache.hpp"
+#include "log.hpp"
+#include <boost/uuid/uuid_io.hpp>
+#include <iostream>
+#include <stdexcept>
+
+namespace bi = boost::interprocess;
+
+namespace fles {
+
+ShmAttachment::ShmAttachment(const std::string& identifier)
+    : shm_(std::make_unique<bi::managed_shared_memory>(bi::open_only,
+                                                       identifier.c_str())) {
+  auto pool = shm_->find<char>(shm_pool_reference);
+  if (pool.first != nullptr) {
+    const std::string pool_identifier(pool.first, pool.second);
+    shm_ = std::make_unique<bi::managed_shared_memory>(
+        bi::open_only, pool_identifier.c_str());
+  }
+  auto* shm_uuid = shm_->find<boost::uuids::uuid>(bi::unique_instance).first;
+  if (shm_uuid == nullptr) {
+    throw std::runtime_error("ShmAttachment: no uuid in shared memory " +
+                             identifier);
+  }
+  uuid_ = *shm_uuid;
+}
+
+std::shared_ptr<bi::managed_shared_memory>
+ShmAttachment::shm(const std::shared_ptr<ShmAttachment>& self) const {
+  return {self, shm_.get()};
+}
+
+std::shared_ptr<DeviceMemory>
+ShmAttachment::device_data(int device, const DeviceMemoryHandle& handle) {
+  std::lock_guard<std::mutex> lock(device_mutex_);
+  if (!device_data_) {
+    device_data_ = std::make_shared<DeviceMemory>(device, handle);
+    L_(debug) << "ShmAttachment: mapped data buffer on GPU " << device;
+  }
+  return device_data_;
+}
+
+ShmAttachmentCache& ShmAttachmentCache::instance() {
+  static ShmAttachmentCache cache;
+  return cache;
+}
+
+std::shared_ptr<ShmAttachment>
+ShmAttachmentCache::attach(const std::string& identifier,
+                           const boost::uuids::uuid& uuid) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = attachments_.find(uuid);
+  if (it != attachments_.end()) {
+    if (auto attachment = it->second.lock()) {
+      return attachment;
+    }
+  }
+  if (replaced_.count(uuid) != 0) {
+    return nullptr;
+  }
+
+  auto attachment = std::make_shared<ShmAttachment>(identifier);
+  ++open_count_;
+
+  // forget the segments no longer in use
+  for (auto i = attachments_.begin(); i != attachments_.end();) {
+    i = i->second.expired() ? attachments_.erase(i) : std::next(i);
+  }
+  auto& entry = attachments_[attachment->uuid()];
+  if (auto existing = entry.lock()) {
+    attachment = existing;
+  } else {
+    entry = attachment;
+    std::cout << "ShmAttachmentCache: opened shared memory " << identifier
+              << " {" << attachment->uuid() << "}" << std::endl;
+  }
+
+  if (attachment->uuid() != uuid) {
+    // the requested segment has been replaced before it was opened
+    replaced_.insert(uuid);
+    return nullptr;
+  }
+  return attachment;
+}
+
+size_t ShmAttachmentCache::open_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return open_count_;
+}
+
+} // namespace fles
@@ -0,0 +1,101 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::ShmAttachmentCache class.
+#pragma once
+
+#include "DeviceMemory.hpp"
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace fles {
+
+/**
+ * \brief Name of the object referring to the segment of a buffer pool.
+ *
+ * If the regions of a timeslice buffer are located in a shared pool
+ * segment, the shared memory of the buffer contains the identifier of the
+ * pool segment as a character array of this name, and the UUID of the pool.
+ */
+constexpr const char* shm_pool_reference = "fles_shm_pool";
+
+/**
+ * \brief The ShmAttachment class represents a managed shared memory segment
+ * attached to this process.
+ *
+ * The attachment is identified by the UUID of the segment. A reference to a
+ * pool segment is followed, attaching the pool instead. A data buffer in
+ * GPU memory is mapped on first use and shared by all its users.
+ */
+class ShmAttachment {
+public:
+  /// Open the shared memory with a given identifier.
+  explicit ShmAttachment(const std::string& identifier);
+
+  /// Delete copy constructor (non-copyable).
+  ShmAttachment(const ShmAttachment&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ShmAttachment&) = delete;
+
+  /// Retrieve the UUID of the segment.
+  [[nodiscard]] const boost::uuids::uuid& uuid() const { return uuid_; }
+
+  /// Retrieve the mapped segment, sharing ownership of the attachment.
+  [[nodiscard]] std::shared_ptr<boost::interprocess::managed_shared_memory>
+  shm(const std::shared_ptr<ShmAttachment>& self) const;
+
+  /// Retrieve the data buffer on a given device, mapping it if needed.
+  std::shared_ptr<DeviceMemory> device_data(int device,
+                                            const DeviceMemoryHandle& handle);
+
+private:
+  std::unique_ptr<boost::interprocess::managed_shared_memory> shm_;
+  boost::uuids::uuid uuid_{};
+
+  std::mutex device_mutex_;
+  std::shared_ptr<DeviceMemory> device_data_;
+};
+
+/**
+ * \brief The ShmAttachmentCache class keeps the shared memory segments
+ * attached by the timeslice receivers of a process.
+ *
+ * A segment is opened once and shared by all receivers and timeslices that
+ * refer to its UUID. It is unmapped once the last of them has released it.
+ * If a buffer has been recreated (e.g., by a restart of flesnet), the new
+ * segment is opened once for all receivers. The UUIDs of replaced segments
+ * are remembered, so work items still referring to them are discarded
+ * without reopening the shared memory.
+ */
+class ShmAttachmentCache {
+public:
+  /// Retrieve the process-wide instance.
+  static ShmAttachmentCache& instance();
+
+  /**
+   * \brief Retrieve the attachment of a given segment.
+   *
+   * \param identifier the identifier of the shared memory
+   * \param uuid       the UUID of the requested segment
+   * \return the attachment, or nullptr if the segment has been replaced
+   */
+  std::shared_ptr<ShmAttachment> attach(const std::string& identifier,
+                                        const boost::uuids::uuid& uuid);
+
+  /// Retrieve the number of times a shared memory has been opened.
+  [[nodiscard]] size_t open_count() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::map<boost::uuids::uuid, std::weak_ptr<ShmAttachment>> attachments_;
+  std::set<boost::uuids::uuid> replaced_;
+  size_t open_count_ = 0;
+};
+
+} // namespace fles
@@ -6,7 +6,9 @@
 namespace fles {
 
 StorableMicroslice::StorableMicroslice(const StorableMicroslice& ms)
-    : Microslice(), desc_(ms.desc_), content_(ms.content_) {
+    : Microslice(), desc_(ms.desc_),
+      content_(acquire_content(ms.content_.size())) {
+  content_.assign(ms.content_.begin(), ms.content_.end());
   init_pointers();
 }
 
@@ -21,7 +23,8 @@ StorableMicroslice::StorableMicroslice(const Microslice& ms)
 StorableMicroslice::StorableMicroslice(MicrosliceDescriptor d,
                                        const uint8_t* content_p)
     : desc_(d), // cannot use {}, see http://stackoverflow.com/q/19347004
-      content_{content_p, content_p + d.size} {
+      content_(acquire_content(d.size)) {
+  content_.assign(content_p, content_p + d.size);
   init_pointers();
 }
 
@@ -34,6 +37,39 @@ StorableMicroslice::StorableMicroslice(MicrosliceDescriptor d,
 
 StorableMicroslice::StorableMicroslice() = default;
 
+StorableMicroslice::~StorableMicroslice() {
+  release_content(std::move(content_));
+}
+
+void* StorableMicroslice::operator new(std::size_t bytes) {
+  if (MicrosliceStoragePool* pool = MicrosliceStoragePool::local()) {
+    return pool->allocate(bytes);
+  }
+  return MicrosliceStoragePool::allocate_unpooled(bytes);
+}
+
+void StorableMicroslice::operator delete(void* ptr) {
+  if (MicrosliceStoragePool* pool = MicrosliceStoragePool::local()) {
+    pool->deallocate(ptr);
+    return;
+  }
+  MicrosliceStoragePool::deallocate_unpooled(ptr);
+}
+
+std::vector<uint8_t>
+StorableMicroslice::acquire_content(std::size_t capacity) {
+  if (MicrosliceStoragePool* pool = MicrosliceStoragePool::local()) {
+    return pool->acquire(capacity);
+  }
+  return {};
+}
+
+void StorableMicroslice::release_content(std::vector<uint8_t>&& content) {
+  if (MicrosliceStoragePool* pool = MicrosliceStoragePool::local()) {
+    pool->release(std::move(content));
+  }
+}
+
 void StorableMicroslice::initialize_crc() { desc_.crc = compute_crc(); }
 
 } // namespace fles
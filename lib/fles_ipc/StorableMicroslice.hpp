@@ -6,6 +6,8 @@
 #include "ArchiveDescriptor.hpp"
 #include "Microslice.hpp"
 #include "MicrosliceDescriptor.hpp"
+#include "MicrosliceStoragePool.hpp"
+#include <cstddef>
 #include <fstream>
 #include <vector>
 
@@ -27,7 +29,9 @@ class InputArchiveSequence;
 /**
  * \brief The StorableMicroslice class contains the data of a single microslice.
  *
- * Both metadata and content are stored within the object.
+ * Both metadata and content are stored within the object. The memory of
+ * the object and its content is recycled through the
+ * MicrosliceStoragePool of the thread that destroys it.
  */
 class StorableMicroslice : public Microslice {
 public:
@@ -66,6 +70,15 @@ public:
    */
   StorableMicroslice(MicrosliceDescriptor d, std::vector<uint8_t> content_v);
 
+  /// Destructor, returning the content buffer to the thread's pool.
+  ~StorableMicroslice() override;
+
+  /// Allocate the object memory from the thread's pool.
+  static void* operator new(std::size_t bytes);
+
+  /// Return the object memory to the thread's pool.
+  static void operator delete(void* ptr);
+
   /// Retrieve non-const microslice descriptor reference
   MicrosliceDescriptor& desc() { return *desc_ptr_; }
 
@@ -91,11 +104,23 @@ private:
   template <class Archive>
   void serialize(Archive& ar, const unsigned int /* version */) {
     ar& desc_;
+    if constexpr (Archive::is_loading::value) {
+      if (content_.capacity() < desc_.size) {
+        release_content(std::move(content_));
+        content_ = acquire_content(desc_.size);
+      }
+    }
     ar& content_;
 
     init_pointers();
   }
 
+  /// Retrieve an empty content buffer of at least the given capacity.
+  static std::vector<uint8_t> acquire_content(std::size_t capacity);
+
+  /// Return a content buffer to the thread's pool.
+  static void release_content(std::vector<uint8_t>&& content);
+
   void init_pointers() {
     desc_ptr_ = &desc_;
     content_ptr_ = content_.data();
@@ -105,4 +130,9 @@ private:
   std::vector<uint8_t> content_;
 };
 
+/// Retrieve a serializable form of a microslice (a StorableMicroslice copy).
+inline StorableMicroslice serializable(const Microslice& ms) {
+  return StorableMicroslice(ms);
+}
+
 } // namespace fles
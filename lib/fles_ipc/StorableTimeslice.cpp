@@ -6,31 +6,44 @@
 
 namespace fles {
 
-StorableTimeslice::StorableTimeslice(const StorableTimeslice& ts)
-    : Timeslice(ts), data_(ts.data_), desc_(ts.desc_) {
-  init_pointers();
-}
-
 StorableTimeslice::StorableTimeslice(StorableTimeslice&& ts) noexcept
-    : Timeslice(ts), data_(std::move(ts.data_)), desc_(std::move(ts.desc_)) {
-  init_pointers();
+    : Timeslice(ts), data_(std::move(ts.data_)), desc_(std::move(ts.desc_)),
+      pool_(std::move(ts.pool_)), borrowed_(ts.borrowed_) {
+  if (!borrowed_) {
+    init_pointers();
+  }
 }
 
-StorableTimeslice::StorableTimeslice(const Timeslice& ts)
-    : data_(ts.timeslice_descriptor_.num_components),
-      desc_(ts.timeslice_descriptor_.num_components) {
+StorableTimeslice::StorableTimeslice(
+    const Timeslice& ts, std::shared_ptr<TimesliceStoragePool> pool)
+    : desc_(ts.timeslice_descriptor_.num_components), pool_(std::move(pool)) {
   timeslice_descriptor_ = ts.timeslice_descriptor_;
+  data_.reserve(ts.timeslice_descriptor_.num_components);
   for (std::size_t component = 0;
        component < ts.timeslice_descriptor_.num_components; ++component) {
     uint64_t size = ts.desc_ptr_[component]->size;
-    data_[component].resize(size);
-    std::copy_n(ts.data_ptr_[component], size, data_[component].begin());
+    uint64_t desc_size = ts.descriptors_size(component);
+    data_.push_back(acquire(size));
+    // copy without zero-initializing the buffer first
+    const uint8_t* begin = ts.data_ptr_[component];
+    data_.back().assign(begin, begin + desc_size);
+    const uint8_t* content = ts.content_ptr(component);
+    data_.back().insert(data_.back().end(), content,
+                        content + (size - desc_size));
     desc_[component] = *ts.desc_ptr_[component];
   }
 
   init_pointers();
 }
 
+StorableTimeslice::~StorableTimeslice() {
+  if (pool_) {
+    for (auto& data : data_) {
+      pool_->release(std::move(data));
+    }
+  }
+}
+
 StorableTimeslice::StorableTimeslice() = default;
 
 } // namespace fles
@@ -6,13 +6,20 @@
 #include "ArchiveDescriptor.hpp"
 #include "StorableMicroslice.hpp"
 #include "Timeslice.hpp"
+#include "TimesliceStoragePool.hpp"
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <vector>
 
 #include <boost/serialization/access.hpp>
+#include <boost/serialization/array_wrapper.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+#include <boost/serialization/item_version_type.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 // Note: <fstream> has to precede boost/serialization includes for non-obvious
 // reasons to avoid segfault similar to
 // http://lists.debian.org/debian-hppa/2009/11/msg00069.html
@@ -28,51 +35,84 @@ class InputArchiveSequence;
 
 /**
  * \brief The StorableTimeslice class contains the data of a single timeslice.
+ *
+ * The object is move-only; a deep copy is made explicitly by constructing
+ * from a Timeslice reference. The component buffers may be taken from (and
+ * are returned to) a TimesliceStoragePool.
+ *
+ * The object returned by serializable() does not hold any data. It refers
+ * to the data of another timeslice, which is serialized directly.
  */
 class StorableTimeslice : public Timeslice {
 public:
-  /// Copy constructor.
-  StorableTimeslice(const StorableTimeslice& ts);
+  /// Delete copy constructor (move-only, copy from Timeslice explicitly).
+  StorableTimeslice(const StorableTimeslice&) = delete;
   /// Delete assignment operator (not implemented).
   void operator=(const StorableTimeslice&) = delete;
   /// Move constructor.
   StorableTimeslice(StorableTimeslice&& ts) noexcept;
 
   /// Construct by copying from given Timeslice object.
-  StorableTimeslice(const Timeslice& ts);
+  StorableTimeslice(const Timeslice& ts,
+                    std::shared_ptr<TimesliceStoragePool> pool = nullptr);
 
   /// Construct and initialize empty timeslice to fill using append_component.
   explicit StorableTimeslice(uint32_t num_core_microslices,
                              uint64_t index = UINT64_MAX,
-                             uint64_t ts_pos = UINT64_MAX) {
+                             uint64_t ts_pos = UINT64_MAX,
+                             std::shared_ptr<TimesliceStoragePool> pool =
+                                 nullptr)
+      : pool_(std::move(pool)) {
     timeslice_descriptor_.index = index;
     timeslice_descriptor_.ts_pos = ts_pos;
     timeslice_descriptor_.num_core_microslices = num_core_microslices;
     timeslice_descriptor_.num_components = 0;
   }
 
+  ~StorableTimeslice() override;
+
+  /// Reserve storage for a given total number of components.
+  void reserve(uint32_t num_components) {
+    desc_.reserve(num_components);
+    data_.reserve(num_components);
+    desc_ptr_.reserve(num_components);
+    data_ptr_.reserve(num_components);
+  }
+
   /// Append a single component to fill using append_microslice.
+  /**
+   * \param num_microslices the number of microslices in the component
+   * \param content_bytes   the expected total size of the microslice
+   *                        contents, reserved to avoid reallocations
+   */
   uint32_t append_component(uint64_t num_microslices,
-                            uint64_t /* dummy */ = 0) {
+                            uint64_t /* dummy */ = 0,
+                            uint64_t content_bytes = 0) {
     TimesliceComponentDescriptor ts_desc = TimesliceComponentDescriptor();
     ts_desc.ts_num = timeslice_descriptor_.index;
     ts_desc.offset = 0;
     ts_desc.num_microslices = num_microslices;
 
-    std::vector<uint8_t> data;
-    for (uint64_t m = 0; m < num_microslices; ++m) {
-      MicrosliceDescriptor desc = MicrosliceDescriptor();
-      auto* desc_bytes = reinterpret_cast<uint8_t*>(&desc);
-      data.insert(data.end(), desc_bytes,
-                  desc_bytes + sizeof(MicrosliceDescriptor));
-    }
+    // zero-initialized microslice descriptors
+    const uint64_t desc_bytes = num_microslices * sizeof(MicrosliceDescriptor);
+    std::vector<uint8_t> data = acquire(desc_bytes + content_bytes);
+    data.resize(desc_bytes);
 
     ts_desc.size = data.size();
+    const bool relocated = desc_.size() == desc_.capacity();
     desc_.push_back(ts_desc);
-    data_.push_back(data);
+    data_.push_back(std::move(data));
     uint32_t component = timeslice_descriptor_.num_components++;
+    component_index_ = nullptr;
 
-    init_pointers();
+    // pointers to the previous components are still valid unless the
+    // descriptor vector has been reallocated
+    if (relocated) {
+      init_pointers();
+    } else {
+      desc_ptr_.push_back(&desc_.back());
+      data_ptr_.push_back(data_.back().data());
+    }
     return component;
   }
 
@@ -102,8 +142,11 @@ public:
 
     this_data.insert(this_data.end(), content, content + descriptor.size);
     this_desc.size = this_data.size();
+    if (microslice == 0) {
+      component_index_ = nullptr;
+    }
 
-    init_pointers();
+    data_ptr_[component] = this_data.data();
     return microslice;
   }
 
@@ -126,18 +169,95 @@ private:
                                     StorableTimeslice,
                                     ArchiveType::TimesliceArchive>;
   friend class TimesliceSubscriber;
+  friend StorableTimeslice serializable(const Timeslice& ts);
 
   StorableTimeslice();
 
+  /// Construct a timeslice referring to the data of another timeslice.
+  struct Borrow {};
+  StorableTimeslice(const Timeslice& ts, Borrow /* tag */)
+      : Timeslice(ts), borrowed_(true) {}
+
+  /// Serialization proxy writing the component data in the format of
+  /// data_, reading it from the data pointers.
+  struct DataProxy {
+    const StorableTimeslice& ts;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int /* version */) {
+      namespace bs = boost::serialization;
+      const bs::collection_size_type count(ts.num_components());
+      ar << BOOST_SERIALIZATION_NVP(count);
+      const bs::item_version_type item_version(
+          bs::version<std::vector<uint8_t>>::value);
+      ar << BOOST_SERIALIZATION_NVP(item_version);
+      for (size_t c = 0; c < ts.num_components(); ++c) {
+        // as an optimized std::vector<uint8_t> of a binary archive
+        const bs::collection_size_type size(ts.desc_ptr_[c]->size);
+        ar << BOOST_SERIALIZATION_NVP(size);
+        // the contents may not directly follow the descriptors
+        const bs::collection_size_type desc_size(ts.descriptors_size(c));
+        if (desc_size != 0) {
+          ar << bs::make_array<const uint8_t, bs::collection_size_type>(
+              ts.data_ptr_[c], desc_size);
+        }
+        if (size > desc_size) {
+          ar << bs::make_array<const uint8_t, bs::collection_size_type>(
+              ts.content_ptr(c), bs::collection_size_type(size - desc_size));
+        }
+      }
+    }
+  };
+
+  /// Serialization proxy writing the component descriptors in the format
+  /// of desc_, reading them from the descriptor pointers.
+  struct DescProxy {
+    const StorableTimeslice& ts;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int /* version */) {
+      namespace bs = boost::serialization;
+      const bs::collection_size_type count(ts.num_components());
+      ar << BOOST_SERIALIZATION_NVP(count);
+      const bs::item_version_type item_version(
+          bs::version<TimesliceComponentDescriptor>::value);
+      ar << BOOST_SERIALIZATION_NVP(item_version);
+      for (size_t c = 0; c < ts.num_components(); ++c) {
+        ar << boost::serialization::make_nvp("item", *ts.desc_ptr_[c]);
+      }
+    }
+  };
+
+  template <class Archive>
+  void save(Archive& ar, const unsigned int /* version */) const {
+    ar << timeslice_descriptor_;
+    ar << DataProxy{*this};
+    ar << DescProxy{*this};
+  }
+
   template <class Archive>
-  void serialize(Archive& ar, const unsigned int /* version */) {
-    ar& timeslice_descriptor_;
-    ar& data_;
-    ar& desc_;
+  void load(Archive& ar, const unsigned int /* version */) {
+    ar >> timeslice_descriptor_;
+    ar >> data_;
+    ar >> desc_;
 
+    borrowed_ = false;
+    component_index_ = nullptr;
     init_pointers();
   }
 
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+  /// Retrieve an empty buffer of at least the given capacity.
+  std::vector<uint8_t> acquire(size_t capacity) {
+    if (pool_) {
+      return pool_->acquire(capacity);
+    }
+    std::vector<uint8_t> buffer;
+    buffer.reserve(capacity);
+    return buffer;
+  }
+
   void init_pointers() {
     data_ptr_.resize(num_components());
     desc_ptr_.resize(num_components());
@@ -149,6 +269,21 @@ private:
 
   std::vector<std::vector<uint8_t>> data_;
   std::vector<TimesliceComponentDescriptor> desc_;
+  /// The pool to take component buffers from and return them to.
+  std::shared_ptr<TimesliceStoragePool> pool_;
+  /// Whether the data is that of another timeslice.
+  bool borrowed_ = false;
 };
 
+/**
+ * \brief Retrieve a serializable form of a timeslice without copying it.
+ *
+ * Serializing the returned object is equivalent to serializing a
+ * StorableTimeslice copy of \p ts. It refers to the data of \p ts and must
+ * not outlive it.
+ */
+inline StorableTimeslice serializable(const Timeslice& ts) {
+  return {ts, StorableTimeslice::Borrow{}};
+}
+
 } // namespace fles
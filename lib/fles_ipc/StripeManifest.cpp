@@ -0,0 +1,62 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "StripeManifest.hpp"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <ios>
+
+namespace fles {
+
+namespace filesys = boost::filesystem;
+
+std::string stripe_filename(const std::string& directory,
+                            const std::string& manifest,
+                            std::size_t stripe,
+                            const std::string& extension) {
+  const std::string stem = filesys::path(manifest).stem().string();
+  return (filesys::path(directory) /
+          (stem + "_s" + std::to_string(stripe) + extension))
+      .string();
+}
+
+void write_stripe_manifest(const std::string& manifest,
+                           const std::vector<std::string>& stripes) {
+  std::ofstream ofs(manifest);
+  if (!ofs) {
+    throw std::ios_base::failure("error opening file \"" + manifest + "\"");
+  }
+  ofs << "# striped archive, " << stripes.size() << " stripes\n";
+  for (const auto& stripe : stripes) {
+    ofs << filesys::absolute(stripe).lexically_normal().string() << "\n";
+  }
+  ofs.close();
+  if (!ofs) {
+    throw std::ios_base::failure("error writing file \"" + manifest + "\"");
+  }
+}
+
+std::vector<std::string> read_stripe_manifest(const std::string& manifest) {
+  std::ifstream ifs(manifest);
+  if (!ifs) {
+    throw std::ios_base::failure("error opening file \"" + manifest + "\"");
+  }
+  const filesys::path base = filesys::path(manifest).parent_path();
+  std::vector<std::string> stripes;
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    filesys::path path(line);
+    if (path.is_relative()) {
+      path = base / path;
+    }
+    stripes.push_back(path.string());
+  }
+  if (stripes.empty()) {
+    throw std::runtime_error("no stripes in manifest \"" + manifest + "\"");
+  }
+  return stripes;
+}
+
+} // namespace fles
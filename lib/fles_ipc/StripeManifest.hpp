@@ -0,0 +1,43 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines functions to handle manifests of striped archives.
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief Construct the file name of a stripe of a striped archive.
+ *
+ * The name is derived from the manifest file name, e.g., stripe 1 of
+ * "run.tss" in directory "/data1" with extension ".tsa" is
+ * "/data1/run_s1.tsa".
+ */
+std::string stripe_filename(const std::string& directory,
+                            const std::string& manifest,
+                            std::size_t stripe,
+                            const std::string& extension);
+
+/**
+ * \brief Write the manifest of a striped archive.
+ *
+ * The manifest is a text file listing the stripe files (as absolute paths)
+ * in the order in which the data sets are distributed, one per line.
+ */
+void write_stripe_manifest(const std::string& manifest,
+                           const std::vector<std::string>& stripes);
+
+/**
+ * \brief Read the manifest of a striped archive.
+ *
+ * Relative paths are interpreted relative to the directory of the
+ * manifest. Empty lines and lines starting with "#" are ignored.
+ *
+ * \return The stripe files in distribution order
+ */
+std::vector<std::string> read_stripe_manifest(const std::string& manifest);
+
+} // namespace fles
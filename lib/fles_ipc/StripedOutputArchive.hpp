@@ -0,0 +1,97 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::StripedOutputArchive template class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "AsyncSink.hpp"
+#include "OutputArchiveSequence.hpp"
+#include "Sink.hpp"
+#include "StripeManifest.hpp"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The StripedOutputArchive class distributes data sets round-robin
+ * to archive files in several directories, each written by its own thread.
+ *
+ * With the directories on different devices, this adds up their write
+ * bandwidth. A manifest file lists the stripe files in order (see
+ * write_stripe_manifest()), so that the data sets can be read back in
+ * their original order, e.g., by TimesliceAutoSource.
+ */
+template <class Base, class Derived, ArchiveType archive_type>
+class StripedOutputArchive : public Sink<Base> {
+public:
+  /**
+   * \brief Construct a striped output archive object, open an archive file
+   * in each directory, and write the manifest.
+   *
+   * \param manifest       File name of the manifest (e.g., "run.tss")
+   * \param directories    Directories to write the stripe files to
+   * \param compression    Compression to use for the data sets
+   * \param direct_io      Write files bypassing the page cache (O_DIRECT)
+   * \param compression_dictionary Dictionary to use for compression, empty
+   * for none
+   * \param queue_capacity Number of data sets to queue for each stripe
+   */
+  StripedOutputArchive(
+      const std::string& manifest,
+      const std::vector<std::string>& directories,
+      ArchiveCompression compression = ArchiveCompression::None,
+      bool direct_io = false,
+      const std::string& compression_dictionary = {},
+      std::size_t queue_capacity = 4) {
+    if (directories.empty()) {
+      throw std::runtime_error("no directories given for striped archive");
+    }
+    const std::string extension =
+        archive_type == ArchiveType::TimesliceArchive ? ".tsa" : ".msa";
+    std::vector<std::string> filenames;
+    for (std::size_t i = 0; i < directories.size(); ++i) {
+      filenames.push_back(
+          stripe_filename(directories[i], manifest, i, extension));
+      auto archive =
+          std::make_unique<OutputArchiveSequence<Base, Derived, archive_type>>(
+              filenames.back(), SIZE_MAX, SIZE_MAX, compression, direct_io,
+              compression_dictionary);
+      stripes_.push_back(std::make_unique<AsyncSink<Base>>(std::move(archive),
+                                                           queue_capacity));
+    }
+    write_stripe_manifest(manifest, filenames);
+  }
+
+  /// Delete copy constructor (non-copyable).
+  StripedOutputArchive(const StripedOutputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const StripedOutputArchive&) = delete;
+
+  ~StripedOutputArchive() override = default;
+
+  /// Store an item.
+  void put(std::shared_ptr<const Base> item) override {
+    stripes_[next_stripe_]->put(std::move(item));
+    next_stripe_ = (next_stripe_ + 1) % stripes_.size();
+  }
+
+  void end_stream() override {
+    for (auto& stripe : stripes_) {
+      stripe->end_stream();
+    }
+  }
+
+  /// Retrieve the number of stripes.
+  [[nodiscard]] std::size_t size() const { return stripes_.size(); }
+
+private:
+  std::vector<std::unique_ptr<AsyncSink<Base>>> stripes_;
+  std::size_t next_stripe_ = 0;
+};
+
+} // namespace fles
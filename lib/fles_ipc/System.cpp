@@ -3,8 +3,12 @@
 #include "System.hpp"
 #include <cerrno>
 #include <cstring>
+#include <fstream>
+#include <ifaddrs.h>
 #include <netdb.h>
+#include <netinet/in.h>
 #include <pwd.h>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <sys/socket.h>
@@ -91,6 +95,93 @@ std::string current_domainname() {
 
 int current_pid() { return getpid(); }
 
+namespace {
+bool same_address(const sockaddr* a, const sockaddr* b) {
+  if (a == nullptr || b == nullptr || a->sa_family != b->sa_family) {
+    return false;
+  }
+  if (a->sa_family == AF_INET) {
+    const auto* a4 = reinterpret_cast<const sockaddr_in*>(a);
+    const auto* b4 = reinterpret_cast<const sockaddr_in*>(b);
+    return a4->sin_addr.s_addr == b4->sin_addr.s_addr;
+  }
+  if (a->sa_family == AF_INET6) {
+    const auto* a6 = reinterpret_cast<const sockaddr_in6*>(a);
+    const auto* b6 = reinterpret_cast<const sockaddr_in6*>(b);
+    return std::memcmp(&a6->sin6_addr, &b6->sin6_addr,
+                       sizeof(a6->sin6_addr)) == 0;
+  }
+  return false;
+}
+} // namespace
+
+int numa_node_of_host(const std::string& host) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  addrinfo* host_addresses = nullptr;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &host_addresses) != 0) {
+    return -1;
+  }
+  ifaddrs* interfaces = nullptr;
+  if (getifaddrs(&interfaces) != 0) {
+    freeaddrinfo(host_addresses);
+    return -1;
+  }
+
+  std::string interface_name;
+  for (const ifaddrs* i = interfaces; i != nullptr && interface_name.empty();
+       i = i->ifa_next) {
+    for (const addrinfo* a = host_addresses; a != nullptr; a = a->ai_next) {
+      if (same_address(i->ifa_addr, a->ai_addr)) {
+        interface_name = i->ifa_name;
+        break;
+      }
+    }
+  }
+  freeifaddrs(interfaces);
+  freeaddrinfo(host_addresses);
+
+  int node = -1;
+  if (!interface_name.empty()) {
+    std::ifstream numa_file("/sys/class/net/" + interface_name +
+                            "/device/numa_node");
+    if (!(numa_file >> node)) {
+      node = -1;
+    }
+  }
+  return node;
+}
+
+memory_info memory_of_numa_node(int node) {
+  // e.g., "Node 0 MemTotal:       98765432 kB" or "MemTotal:   98765432 kB"
+  std::string path = node >= 0 ? "/sys/devices/system/node/node" +
+                                     std::to_string(node) + "/meminfo"
+                               : "/proc/meminfo";
+  std::string available_key = node >= 0 ? "MemFree:" : "MemAvailable:";
+  memory_info info;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    std::string key;
+    if (node >= 0) {
+      std::string word;
+      int n = 0;
+      iss >> word >> n;
+    }
+    uint64_t kib = 0;
+    if (!(iss >> key >> kib)) {
+      continue;
+    }
+    if (key == "MemTotal:") {
+      info.total = kib * 1024;
+    } else if (key == available_key) {
+      info.available = kib * 1024;
+    }
+  }
+  return info;
+}
+
 std::vector<std::string> glob(const std::string& pattern, glob_flags flags) {
   glob_t glob_result{};
 
@@ -3,6 +3,7 @@
 /// \brief Defines utility functions in the fles::system namespace.
 #pragma once
 
+#include <cstdint>
 #include <glob.h>
 #include <string>
 #include <vector>
@@ -61,6 +62,34 @@ std::string current_domainname();
  */
 int current_pid();
 
+/**
+ * \brief Find the NUMA node of the network device serving a local address.
+ *
+ * The host name is resolved, and the NUMA node of the network interface
+ * holding one of the resulting addresses is read from sysfs (Linux only).
+ *
+ * @param host local host name or address
+ * @return NUMA node number, or -1 if unknown
+ */
+int numa_node_of_host(const std::string& host);
+
+/// Memory size of a NUMA node or of the system, in bytes.
+struct memory_info {
+  uint64_t total = 0;     ///< Installed memory
+  uint64_t available = 0; ///< Memory available for new allocations
+};
+
+/**
+ * \brief Retrieve the memory size of a NUMA node.
+ *
+ * The sizes are read from sysfs, or from /proc/meminfo for the whole system
+ * (Linux only). The available memory of a NUMA node is its free memory.
+ *
+ * @param node NUMA node number, or -1 for the whole system
+ * @return memory sizes, zero if unknown
+ */
+memory_info memory_of_numa_node(int node);
+
 enum class glob_flags : int {
   none = 0,
   // Always available according to POSIX
@@ -0,0 +1,32 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimeOrderedMerge.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace fles {
+
+TimeOrderedMerge::TimeOrderedMerge(std::vector<ComponentView> views)
+    : views_(std::move(views)) {
+  heap_.reserve(views_.size());
+  for (uint64_t c = 0; c < views_.size(); ++c) {
+    if (!views_[c].empty()) {
+      heap_.push_back({views_[c].descriptor(0).idx, c, 0});
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end(), later);
+}
+
+void TimeOrderedMerge::pop() {
+  std::pop_heap(heap_.begin(), heap_.end(), later);
+  Head& head = heap_.back();
+  const ComponentView& view = views_[head.component];
+  if (++head.position < view.size()) {
+    head.idx = view.descriptor(head.position).idx;
+    std::push_heap(heap_.begin(), heap_.end(), later);
+  } else {
+    heap_.pop_back();
+  }
+}
+
+} // namespace fles
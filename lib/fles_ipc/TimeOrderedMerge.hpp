@@ -0,0 +1,98 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimeOrderedMerge class.
+#pragma once
+
+#include "ComponentView.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace fles {
+
+/// A microslice of a timeslice component, as yielded by TimeOrderedMerge.
+struct MergedMicroslice {
+  uint64_t component; ///< Position of the view the microslice belongs to
+  MicrosliceRef microslice; ///< The microslice descriptor and content
+};
+
+/**
+ * \brief The TimeOrderedMerge class iterates over the microslices of several
+ * components in the order of their index (start time).
+ *
+ * The microslices of each component are ordered already, so they are merged
+ * using a binary heap of the next microslice of each component. Microslices
+ * with the same index are yielded in the order of the components.
+ *
+ * Use as, e.g., `for (auto [c, ms] : TimeOrderedMerge(ts.window(t0, t1)))`.
+ */
+class TimeOrderedMerge {
+public:
+  /// Iterator over the merged microslices.
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = MergedMicroslice;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = MergedMicroslice;
+
+    explicit iterator(TimeOrderedMerge* merge) : merge_(merge) {}
+
+    MergedMicroslice operator*() const { return merge_->front(); }
+
+    iterator& operator++() {
+      merge_->pop();
+      return *this;
+    }
+
+    // all iterators are equal except for the end of a non-empty merge
+    bool operator==(const iterator& other) const {
+      return (merge_ == nullptr || merge_->empty()) ==
+             (other.merge_ == nullptr || other.merge_->empty());
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+  private:
+    TimeOrderedMerge* merge_;
+  };
+
+  /// Construct a merge of the microslices of several component views.
+  explicit TimeOrderedMerge(std::vector<ComponentView> views);
+
+  /// Check whether all microslices have been consumed.
+  [[nodiscard]] bool empty() const { return heap_.empty(); }
+
+  /// Retrieve the next microslice in time order.
+  [[nodiscard]] MergedMicroslice front() const {
+    const Head& head = heap_.front();
+    return {head.component, views_[head.component][head.position]};
+  }
+
+  /// Advance to the next microslice in time order.
+  void pop();
+
+  /// Retrieve an iterator to the next microslice (consuming the merge).
+  iterator begin() { return iterator(this); }
+  /// Retrieve the end iterator.
+  iterator end() { return iterator(nullptr); }
+
+private:
+  /// The index and position of the next microslice of a component.
+  struct Head {
+    uint64_t idx;
+    uint64_t component;
+    uint64_t position;
+  };
+
+  /// Heap ordering, the earliest microslice is at the front.
+  static bool later(const Head& a, const Head& b) {
+    return a.idx > b.idx || (a.idx == b.idx && a.component > b.component);
+  }
+
+  std::vector<ComponentView> views_;
+  std::vector<Head> heap_;
+};
+
+} // namespace fles
@@ -6,4 +6,27 @@ namespace fles {
 
 Timeslice::~Timeslice() = default;
 
+const ComponentIndex& Timeslice::component_index() const {
+  auto index = std::atomic_load(&component_index_);
+  if (!index) {
+    // concurrent users may build it at the same time, the first one wins
+    auto built = std::make_shared<const ComponentIndex>(*this);
+    if (std::atomic_compare_exchange_strong(&component_index_, &index,
+                                            built)) {
+      index = std::move(built);
+    }
+  }
+  return *index;
+}
+
+std::vector<ComponentView> Timeslice::window(uint64_t begin_idx,
+                                             uint64_t end_idx) const {
+  std::vector<ComponentView> views;
+  views.reserve(num_components());
+  for (uint64_t c = 0; c < num_components(); ++c) {
+    views.push_back(component(c).window(begin_idx, end_idx));
+  }
+  return views;
+}
+
 } // namespace fles
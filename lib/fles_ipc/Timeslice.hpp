@@ -3,11 +3,14 @@
 /// \brief Defines the fles::Timeslice abstract base class.
 #pragma once
 
+#include "ComponentIndex.hpp"
+#include "ComponentView.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "MicrosliceView.hpp"
 #include "TimesliceComponentDescriptor.hpp"
 #include "TimesliceDescriptor.hpp"
 #include <fstream>
+#include <memory>
 #include <vector>
 
 #include <boost/serialization/access.hpp>
@@ -45,6 +48,11 @@ public:
     return timeslice_descriptor_.num_components;
   }
 
+  /// Retrieve whether a given component is missing (partial timeslice).
+  [[nodiscard]] bool missing_component(uint64_t component) const {
+    return desc_ptr_[component]->missing();
+  }
+
   /// Retrieve the size of a given component.
   [[nodiscard]] uint64_t size_component(uint64_t component) const {
     return desc_ptr_[component]->size;
@@ -53,11 +61,7 @@ public:
   /// Retrieve a pointer to the data content of a given microslice
   [[nodiscard]] const uint8_t* content(uint64_t component,
                                        uint64_t microslice) const {
-    return data_ptr_[component] +
-           desc_ptr_[component]->num_microslices *
-               sizeof(MicrosliceDescriptor) +
-           descriptor(component, microslice).offset -
-           descriptor(component, 0).offset;
+    return this->component(component).content(microslice);
   }
 
   /// Retrieve the descriptor of a given microslice
@@ -67,6 +71,27 @@ public:
         data_ptr_[component])[microslice];
   }
 
+  /// Retrieve the contiguous array of microslice descriptors of a component
+  [[nodiscard]] const MicrosliceDescriptor*
+  descriptors(uint64_t component) const {
+    return reinterpret_cast<const MicrosliceDescriptor*>(data_ptr_[component]);
+  }
+
+  /// Retrieve a view on the microslices of a given component
+  /** Use this to access many microslices of a component, e.g., as
+      `for (auto [desc, content] : ts.component(c))`. */
+  [[nodiscard]] ComponentView component(uint64_t component) const {
+    return {data_ptr_[component], desc_ptr_[component]->num_microslices,
+            content_ptr(component)};
+  }
+
+  /// Retrieve views on the microslices of all components with an index
+  /// (start time) in the interval [begin_idx, end_idx)
+  /** The views refer to the data of the timeslice, use TimeOrderedMerge to
+      iterate over them in the order of their start time. */
+  [[nodiscard]] std::vector<ComponentView> window(uint64_t begin_idx,
+                                                  uint64_t end_idx) const;
+
   /// Retrieve the descriptor and pointer to the data of a given microslice
   [[nodiscard]] MicrosliceView get_microslice(uint64_t component,
                                               uint64_t microslice_index) const {
@@ -78,14 +103,16 @@ public:
     MicrosliceDescriptor& dd0 =
         reinterpret_cast<MicrosliceDescriptor*>(component_data_ptr)[0];
 
-    uint8_t* cc =
-        component_data_ptr +
-        desc_ptr_[component]->num_microslices * sizeof(MicrosliceDescriptor) +
-        dd.offset - dd0.offset;
+    uint8_t* cc = content_ptr(component) + dd.offset - dd0.offset;
 
     return MicrosliceView(dd, cc);
   }
 
+  /// Retrieve the index of the components by subsystem and equipment
+  /** The index is built on first use and then shared by all users of this
+      object, also across threads. */
+  [[nodiscard]] const ComponentIndex& component_index() const;
+
   /// Retrieve the offical start time of the timeslice
   [[nodiscard]] uint64_t start_time() const {
     if (num_components() != 0 && num_microslices(0) != 0) {
@@ -98,6 +125,11 @@ protected:
   Timeslice() = default;
 
   friend class StorableTimeslice;
+  friend class SelectedTimeslice;
+  friend class TimesliceRawOutputArchive;
+  friend class TimeslicePublisher;
+  friend class TimesliceMulticastPublisher;
+  friend class TimesliceReplayArchive;
 
   /// The timeslice descriptor.
   TimesliceDescriptor timeslice_descriptor_{};
@@ -108,6 +140,26 @@ protected:
   /// \brief A vector of pointers to the microslice descriptors, one per
   /// timeslice component.
   std::vector<TimesliceComponentDescriptor*> desc_ptr_;
+
+  /// \brief A vector of pointers to the microslice contents, one per
+  /// timeslice component, if they do not directly follow the microslice
+  /// descriptors (empty otherwise).
+  std::vector<uint8_t*> content_ptr_;
+
+  /// Retrieve the size of the microslice descriptors of a given component.
+  [[nodiscard]] uint64_t descriptors_size(uint64_t component) const {
+    return desc_ptr_[component]->num_microslices * sizeof(MicrosliceDescriptor);
+  }
+
+  /// Retrieve a pointer to the microslice contents of a given component.
+  [[nodiscard]] uint8_t* content_ptr(uint64_t component) const {
+    return content_ptr_.empty()
+               ? data_ptr_[component] + descriptors_size(component)
+               : content_ptr_[component];
+  }
+
+  /// The component index, built on first use (see component_index()).
+  mutable std::shared_ptr<const ComponentIndex> component_index_;
 };
 
 } // namespace fles
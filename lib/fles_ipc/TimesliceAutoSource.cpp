@@ -1,14 +1,22 @@
 // Copyright 2021 Jan de Cuveland <cmail@cuveland.de>
 #include "TimesliceAutoSource.hpp"
 
+#include "ArchiveCatalog.hpp"
 #include "ItemWorkerProtocol.hpp"
 #include "MergingSource.hpp"
+#include "SelectedTimeslice.hpp"
+#include "StripeManifest.hpp"
 #include "System.hpp"
 #include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
+#include "TimesliceMulticastSubscriber.hpp"
+#include "TimesliceRangeArchive.hpp"
 #include "TimesliceReceiver.hpp"
+#include "TimesliceReplayArchive.hpp"
 #include "TimesliceSubscriber.hpp"
 #include "Utility.hpp"
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <memory>
 #include <string>
 
@@ -27,21 +35,70 @@ TimesliceAutoSource::TimesliceAutoSource(
 void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
   std::vector<std::unique_ptr<fles::TimesliceSource>> sources;
 
+  // Add a source, selecting components if it cannot do so itself
+  auto add_source = [&sources](std::unique_ptr<fles::TimesliceSource> source,
+                               const ComponentSelection& selection) {
+    if (!selection.selects_all()) {
+      source = std::make_unique<ComponentSelectingSource>(std::move(source),
+                                                          selection);
+    }
+    sources.emplace_back(std::move(source));
+  };
+
+  MergeOrder merge_order = MergeOrder::Index;
+  std::size_t merge_prefetch = 0;
+
   for (const auto& locator : locators) {
     // If locator has no full URI pattern, everything is in "uri.path"
     UriComponents uri{locator};
+    ComponentSelection selection;
+
+    // Merging parameters apply to all sources, independent of the scheme
+    if (auto it = uri.query_components.find("merge");
+        it != uri.query_components.end()) {
+      static const std::map<std::string, MergeOrder> order_map = {
+          {"index", MergeOrder::Index},
+          {"time", MergeOrder::StartTime},
+          {"round", MergeOrder::RoundRobin}};
+      merge_order = order_map.at(it->second);
+      uri.query_components.erase(it);
+    }
+    if (auto it = uri.query_components.find("merge_prefetch");
+        it != uri.query_components.end()) {
+      merge_prefetch = std::stoull(it->second);
+      uri.query_components.erase(it);
+    }
 
     if (uri.scheme == "file" || uri.scheme.empty()) {
       uint64_t cycles = 1;
+      std::size_t prefetch = 0;
+      bool cache = false;
+      bool continuous = false;
+      uint64_t from = 0;
+      uint64_t to = UINT64_MAX;
       for (auto& [key, value] : uri.query_components) {
-        if (key == "cycles") {
+        if (key == "from") {
+          from = stoull(value);
+        } else if (key == "to") {
+          to = stoull(value);
+        } else if (key == "cycles") {
           cycles = stoull(value);
-        } else {
+        } else if (key == "cache") {
+          cache = (value == "1" || value == "true");
+        } else if (key == "continuous") {
+          continuous = (value == "1" || value == "true");
+        } else if (key == "prefetch") {
+          prefetch = stoull(value);
+        } else if (!selection.parse(key, value)) {
           throw std::runtime_error(
               "query parameter not implemented for scheme file: " + key);
         }
       }
       const auto file_path = uri.authority + uri.path;
+      if (continuous && !cache) {
+        throw std::runtime_error(
+            "query parameter continuous requires cache=1: " + locator);
+      }
 
       // Find pathnames matching a pattern.
       //
@@ -51,38 +108,105 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
       // string "0000". Nonexistant files are caught already at this stage by
       // glob() throwing a runtime_error.
       auto paths = system::glob(replace_all_copy(file_path, "%n", "0000"));
-      if (file_path.find("%n") != std::string::npos) {
+      const bool is_catalog = boost::algorithm::ends_with(file_path, ".cat");
+      const bool is_range = from != 0 || to != UINT64_MAX;
+      if (is_range && !is_catalog &&
+          (paths.size() != 1 || file_path.find("%n") != std::string::npos ||
+           boost::algorithm::ends_with(file_path, ".tss"))) {
+        throw std::runtime_error("query parameters from and to require a "
+                                 "catalog (.cat) or a single file: " +
+                                 locator);
+      }
+      if (is_range && !is_catalog) {
+        if (cycles != 1 || cache) {
+          throw std::runtime_error("query parameters cycles and cache "
+                                   "not supported for time ranges");
+        }
+        sources.emplace_back(std::make_unique<fles::TimesliceRangeArchive>(
+            paths.front(), from, to, selection));
+      } else if (is_catalog) {
+        if (cycles != 1 || cache) {
+          throw std::runtime_error("query parameters cycles and cache "
+                                   "not supported for catalogs");
+        }
+        // read only the files containing the time range, merged later
+        ArchiveCatalog catalog;
+        for (const auto& path : paths) {
+          catalog.load(path);
+        }
+        for (const auto& entry : catalog.find_time(from, to)) {
+          sources.emplace_back(std::make_unique<fles::TimesliceRangeArchive>(
+              entry.filename, from, to, selection));
+        }
+      } else if (file_path.find("%n") != std::string::npos) {
         for (auto& path : paths) {
           replace_all(path, "0000", "%n");
-          std::unique_ptr<fles::TimesliceSource> source =
-              std::make_unique<fles::TimesliceInputArchiveSequence>(path);
-          sources.emplace_back(std::move(source));
+          add_source(std::make_unique<fles::TimesliceInputArchiveSequence>(
+                         path, prefetch),
+                     selection);
         }
       } else {
         if (paths.size() == 1) {
-          if (cycles == 1) {
+          if (boost::algorithm::ends_with(paths.front(), ".tsr")) {
+            if (cycles != 1 || cache) {
+              throw std::runtime_error("query parameters cycles and cache "
+                                       "not supported for raw archives");
+            }
             std::unique_ptr<fles::TimesliceSource> source =
-                std::make_unique<fles::TimesliceInputArchive>(paths.front());
+                std::make_unique<fles::TimesliceMappedArchive>(paths.front(),
+                                                               selection);
             sources.emplace_back(std::move(source));
+          } else if (boost::algorithm::ends_with(paths.front(), ".tss")) {
+            // striped archive, read the stripes in distribution order
+            if (cycles != 1 || cache) {
+              throw std::runtime_error("query parameters cycles and cache "
+                                       "not supported for striped archives");
+            }
+            std::vector<std::unique_ptr<fles::TimesliceSource>> stripes;
+            for (const auto& stripe : read_stripe_manifest(paths.front())) {
+              stripes.emplace_back(
+                  std::make_unique<fles::TimesliceInputArchive>(stripe));
+            }
+            add_source(std::make_unique<MergingSource<fles::TimesliceSource>>(
+                           std::move(stripes), MergeOrder::RoundRobin,
+                           prefetch),
+                       selection);
+          } else if (cache) {
+            // replay from memory, e.g., as a load generator
+            add_source(std::make_unique<fles::TimesliceReplayArchive>(
+                           paths.front(), cycles, continuous),
+                       selection);
+          } else if (cycles == 1) {
+            add_source(
+                std::make_unique<fles::TimesliceInputArchive>(paths.front()),
+                selection);
           } else {
-            std::unique_ptr<fles::TimesliceSource> source =
-                std::make_unique<fles::TimesliceInputArchiveLoop>(paths.front(),
-                                                                  cycles);
-            sources.emplace_back(std::move(source));
+            add_source(std::make_unique<fles::TimesliceInputArchiveLoop>(
+                           paths.front(), cycles),
+                       selection);
           }
         } else if (paths.size() > 1) {
-          std::unique_ptr<fles::TimesliceSource> source =
-              std::make_unique<fles::TimesliceInputArchiveSequence>(paths);
-          sources.emplace_back(std::move(source));
+          add_source(std::make_unique<fles::TimesliceInputArchiveSequence>(
+                         paths, prefetch),
+                     selection);
         }
       }
 
     } else if (uri.scheme == "tcp") {
       uint32_t hwm = 1;
+      uint64_t stride = 1;
+      uint64_t offset = 0;
+      uint64_t modulus = 0;
       for (auto& [key, value] : uri.query_components) {
         if (key == "hwm") {
           hwm = stou(value);
-        } else {
+        } else if (key == "stride") {
+          stride = std::stoull(value);
+        } else if (key == "offset") {
+          offset = std::stoull(value);
+        } else if (key == "modulus") {
+          modulus = std::stoull(value);
+        } else if (!selection.parse(key, value)) {
           throw std::runtime_error(
               "query parameter not implemented for scheme " + uri.scheme +
               ": " + key);
@@ -90,13 +214,41 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
       }
       const auto address = uri.scheme + "://" + uri.authority;
       std::unique_ptr<fles::TimesliceSource> source =
-          std::make_unique<fles::TimesliceSubscriber>(address, hwm);
+          std::make_unique<fles::TimesliceSubscriber>(
+              address, hwm, selection, stride, offset, modulus);
+      sources.emplace_back(std::move(source));
+
+    } else if (uri.scheme == "udp") {
+      std::string interface;
+      uint64_t stride = 1;
+      uint64_t offset = 0;
+      std::size_t buffer_size = 0;
+      for (auto& [key, value] : uri.query_components) {
+        if (key == "interface") {
+          interface = value;
+        } else if (key == "stride") {
+          stride = std::stoull(value);
+        } else if (key == "offset") {
+          offset = std::stoull(value);
+        } else if (key == "rcvbuf") {
+          buffer_size = std::stoull(value);
+        } else if (!selection.parse(key, value)) {
+          throw std::runtime_error(
+              "query parameter not implemented for scheme " + uri.scheme +
+              ": " + key);
+        }
+      }
+      const auto address = uri.scheme + "://" + uri.authority;
+      std::unique_ptr<fles::TimesliceSource> source =
+          std::make_unique<fles::TimesliceMulticastSubscriber>(
+              address, interface, selection, stride, offset, buffer_size);
       sources.emplace_back(std::move(source));
 
     } else if (uri.scheme == "shm") {
       WorkerParameters param{1, 0, WorkerQueuePolicy::QueueAll,
                              "TimesliceAutoSource at PID " +
                                  std::to_string(system::current_pid())};
+      bool component_items = false;
       for (auto& [key, value] : uri.query_components) {
         if (key == "stride") {
           param.stride = std::stoull(value);
@@ -106,18 +258,38 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
           static const std::map<std::string, WorkerQueuePolicy> queue_map = {
               {"all", WorkerQueuePolicy::QueueAll},
               {"one", WorkerQueuePolicy::PrebufferOne},
-              {"skip", WorkerQueuePolicy::Skip}};
+              {"skip", WorkerQueuePolicy::Skip},
+              {"balanced", WorkerQueuePolicy::Balanced}};
           param.queue_policy = queue_map.at(value);
-        } else {
+        } else if (key == "group") {
+          param.group = value;
+        } else if (key == "prefetch") {
+          param.prefetch = std::stoull(value);
+        } else if (key == "batch") {
+          param.batch = (value == "1" || value == "true");
+        } else if (key == "channel") {
+          param.shm = (value == "1" || value == "true");
+        } else if (key == "priority") {
+          param.priority = std::stoul(value);
+        } else if (key == "usage") {
+          param.usage = (value == "1" || value == "true");
+        } else if (key == "components") {
+          component_items = (value == "1" || value == "true");
+        } else if (!selection.parse(key, value)) {
           throw std::runtime_error(
               "query parameter not implemented for scheme " + uri.scheme +
               ": " + key);
         }
       }
+      if (param.queue_policy == WorkerQueuePolicy::Balanced &&
+          param.group.empty()) {
+        param.group = "default";
+      }
       const auto ipc_identifier = uri.authority + uri.path;
-      std::unique_ptr<fles::TimesliceSource> source =
-          std::make_unique<fles::TimesliceReceiver>(ipc_identifier, param);
-      sources.emplace_back(std::move(source));
+      add_source(
+          std::make_unique<fles::TimesliceReceiver>(ipc_identifier, param,
+                                                    component_items),
+          selection);
 
     } else {
       throw std::runtime_error("scheme not implemented: " + uri.scheme);
@@ -126,9 +298,10 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
 
   if (sources.size() == 1) {
     source_ = std::move(sources.front());
-  } else if (sources.size() > 1) {
+  } else {
+    // no sources (e.g., empty catalog range) result in an empty stream
     source_ = std::make_unique<MergingSource<fles::TimesliceSource>>(
-        std::move(sources));
+        std::move(sources), merge_order, merge_prefetch);
   }
 }
 
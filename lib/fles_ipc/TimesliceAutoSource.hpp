@@ -65,7 +65,49 @@ namespace fles {
  *    `"?"` wildcard expands to more than one instance)
  * 6. A MergingSource containing two TimesliceInputArchive objects
  * 7. A single TimesliceInputArchiveSequence
-
+ *
+ * For all schemes, the components to provide can be restricted using the
+ * query parameters `component`, `sys_id` and `eq_id` (see
+ * ComponentSelection), e.g., `"tcp://localhost:5556?sys_id=0x60,0x00"`.
+ * Mapped raw archives and subscribers only access the selected components.
+ * Otherwise, the selected components are provided without copying.
+ *
+ * For `tcp://` locators, the query parameters `stride` and `offset` select
+ * the timeslices to receive on the publisher side, which requires a
+ * publisher with a topic modulus (`modulus`, default: the stride) that is
+ * a multiple of the stride (see TimesliceSubscriber).
+ *
+ * A filepath with the extension `.tss` is read as the manifest of a striped
+ * archive (see StripedOutputArchive), and the stripe files are read back in
+ * their original order. With the query parameter `prefetch`, each stripe is
+ * read ahead by the given number of timeslices on its own thread.
+ *
+ * A filepath with the extension `.cat` is read as an archive catalog (see
+ * ArchiveCatalog), where a glob pattern combines the catalogs of several
+ * nodes. Only the archive files containing timeslices with a start time in
+ * the range given by the query parameters `from` and `to` (exclusive) are
+ * opened, e.g., `"node*.cat?from=1000000000&to=2000000000"`. The same
+ * range can be given for a single archive file (see TimesliceRangeArchive).
+ *
+ * If there is more than one TimesliceSource object, the query parameter
+ * `merge` selects the merge order (`index` (default), `time` for the start
+ * time, or `round` for round-robin), and `merge_prefetch` the number of
+ * timeslices each input reads ahead on its own thread (default: 0, no
+ * prefetching), e.g., `"a.tsa?merge_prefetch=4;b.tsa"`. These parameters
+ * apply to all locators.
+ *
+ * A `udp://group:port` locator receives timeslices published by multicast
+ * (see TimesliceMulticastSubscriber), with the query parameters
+ * `interface` (the local interface address), `rcvbuf` (the socket receive
+ * buffer size), `stride` and `offset`. Timeslices with lost datagrams are
+ * dropped.
+ *
+ * For `shm://` locators, the query parameter `components=1` requests the
+ * individual components as soon as they have been written, each as a
+ * timeslice of a single component. With `stride` set to the number of
+ * components, `offset` selects the component (see component_items_suffix).
+ * With `usage=1`, the time spent on the timeslices is reported to the
+ * distributor (see TimesliceReceiver).
  */
 class TimesliceAutoSource : public TimesliceSource {
 public:
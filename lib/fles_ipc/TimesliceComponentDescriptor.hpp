@@ -12,6 +12,9 @@ namespace fles {
 
 /**
  * \brief %Timeslice component descriptor struct.
+ *
+ * A component missing from a partially delivered timeslice contains no
+ * microslices.
  */
 struct TimesliceComponentDescriptor {
   uint64_t ts_num;          ///< Timeslice index.
@@ -19,6 +22,9 @@ struct TimesliceComponentDescriptor {
   uint64_t size;            ///< Size (in bytes) of corresponding data.
   uint64_t num_microslices; ///< Number of microslices.
 
+  /// Whether the component is missing from a partial timeslice.
+  [[nodiscard]] bool missing() const { return num_microslices == 0; }
+
   friend class boost::serialization::access;
   /// Provide boost serialization access.
   template <class Archive>
@@ -6,6 +6,7 @@
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/version.hpp>
 #include <cstdint>
+#include <ostream>
 
 namespace fles {
 
@@ -21,7 +22,8 @@ struct TimesliceDescriptor {
   uint64_t ts_pos;
   /// Number of core microslices
   uint32_t num_core_microslices;
-  /// Number of components (contributing input channels)
+  /// Number of components (contributing input channels, including missing
+  /// ones of a partial timeslice)
   uint32_t num_components;
 
   friend class boost::serialization::access;
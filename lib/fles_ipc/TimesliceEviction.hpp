@@ -0,0 +1,83 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the shared memory structures of evicted timeslices.
+#pragma once
+
+#include "TimesliceComponentDescriptor.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fles {
+
+/**
+ * \brief Prefix of the name of the eviction table of a timeslice buffer.
+ *
+ * The table is located in the segment holding the buffer regions, and its
+ * name is completed by the shared memory identifier of the buffer.
+ */
+constexpr const char* shm_eviction_table_prefix = "fles_eviction_";
+
+/// Retrieve the name of the eviction table of a given timeslice buffer.
+inline std::string eviction_table_name(const std::string& shm_identifier) {
+  return shm_eviction_table_prefix + shm_identifier;
+}
+
+/// State of an entry of the eviction table.
+enum class EvictionState : uint32_t {
+  Free,      ///< The entry is not in use
+  Published, ///< A copy of the timeslice has been made
+  Switched   ///< The consumer has switched to the copy
+};
+
+/**
+ * \brief Entry of the eviction table.
+ *
+ * The producer fills in the copy and then publishes the entry by setting its
+ * timeslice position (release order). Consumers look up the entry by
+ * position and acknowledge the use of the copy.
+ */
+struct EvictionEntry {
+  /// Position of the evicted timeslice plus one (0: no timeslice).
+  std::atomic<uint64_t> ts_pos_plus_one{0};
+  /// The state of the entry.
+  std::atomic<EvictionState> state{EvictionState::Free};
+  /// Handle of the copy in the segment.
+  std::ptrdiff_t copy = 0;
+};
+
+/// Number of timeslices that can be evicted at the same time.
+constexpr std::size_t eviction_table_size = 256;
+
+/// Table of the evicted timeslices of a timeslice buffer.
+using EvictionTable = std::array<EvictionEntry, eviction_table_size>;
+
+/**
+ * \brief Layout of the copy of an evicted timeslice.
+ *
+ * The copy starts with the component descriptors, followed by the offsets
+ * of the component data relative to the start of the copy and the data of
+ * each component (microslice descriptors followed by contents).
+ */
+struct EvictedTimeslice {
+  /// Retrieve the size of the copy up to the data of the first component.
+  static std::size_t header_size(uint64_t num_components) {
+    return num_components *
+           (sizeof(TimesliceComponentDescriptor) + sizeof(uint64_t));
+  }
+
+  /// Retrieve the component descriptors of a copy.
+  static TimesliceComponentDescriptor* descriptors(uint8_t* copy) {
+    return reinterpret_cast<TimesliceComponentDescriptor*>(copy);
+  }
+
+  /// Retrieve the data offsets of a copy.
+  static uint64_t* data_offsets(uint8_t* copy, uint64_t num_components) {
+    return reinterpret_cast<uint64_t*>(
+        copy + num_components * sizeof(TimesliceComponentDescriptor));
+  }
+};
+
+} // namespace fles
@@ -0,0 +1,254 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceMappedArchive.hpp"
+#include "TimesliceRawArchive.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace fles {
+
+namespace {
+
+// Check that a record of at most the given size fits its component
+// descriptors, and that the data of all components lies within the record.
+bool record_valid(const uint8_t* record, uint64_t available) {
+  const auto* header = reinterpret_cast<const RawArchiveRecordHeader*>(record);
+  uint64_t desc_offset = raw_archive_align(sizeof(RawArchiveRecordHeader));
+  uint64_t min_size =
+      desc_offset +
+      header->ts_desc.num_components * sizeof(TimesliceComponentDescriptor);
+  if (header->record_size < min_size || header->record_size > available) {
+    return false;
+  }
+  const auto* desc =
+      reinterpret_cast<const TimesliceComponentDescriptor*>(record +
+                                                            desc_offset);
+  for (size_t c = 0; c < header->ts_desc.num_components; ++c) {
+    if (desc[c].offset < min_size || desc[c].offset > header->record_size ||
+        desc[c].size > header->record_size - desc[c].offset ||
+        desc[c].num_microslices >
+            desc[c].size / sizeof(MicrosliceDescriptor)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+MappedTimeslice::MappedTimeslice(
+    std::shared_ptr<const boost::interprocess::mapped_region> region,
+    const uint8_t* record,
+    const uint8_t* next_record,
+    const ComponentSelection& selection)
+    : region_(std::move(region)) {
+  const auto* header = reinterpret_cast<const RawArchiveRecordHeader*>(record);
+  timeslice_descriptor_ = header->ts_desc;
+
+  // const_cast is safe here as Timeslice only provides read access
+  auto* desc = reinterpret_cast<TimesliceComponentDescriptor*>(
+      const_cast<uint8_t*>(record) +
+      raw_archive_align(sizeof(RawArchiveRecordHeader)));
+
+  // pointers to reassembled components have to remain valid
+  reassembled_desc_.reserve(header->ts_desc.num_components);
+
+  // no (reassembled) component can be larger than the file
+  const uint64_t max_content_size = region_->get_size();
+
+  for (size_t c = 0; c < header->ts_desc.num_components; ++c) {
+    auto* data = const_cast<uint8_t*>(record) + desc[c].offset;
+    if (!selection.selects(c, desc[c].num_microslices,
+                           reinterpret_cast<MicrosliceDescriptor*>(data))) {
+      continue;
+    }
+    uint64_t full_size = desc[c].size;
+    if (desc[c].num_microslices != 0) {
+      // the content of all microslices has to lie within the component
+      ComponentView view(data, desc[c].num_microslices);
+      uint64_t first_offset = view.descriptor(0).offset;
+      uint64_t content_end = 0;
+      for (size_t m = 0; m < view.size(); ++m) {
+        const MicrosliceDescriptor& d = view.descriptor(m);
+        if (d.offset < first_offset ||
+            d.offset - first_offset > max_content_size ||
+            d.size > max_content_size - (d.offset - first_offset)) {
+          throw std::runtime_error("raw archive contains a component with "
+                                   "invalid microslice offsets");
+        }
+        content_end = std::max(content_end, d.offset - first_offset + d.size);
+      }
+      full_size = view.size() * sizeof(MicrosliceDescriptor) + content_end;
+    }
+    if (desc[c].size < full_size) {
+      reassemble(desc[c], data, full_size, next_record, c);
+    } else {
+      desc_ptr_.push_back(&desc[c]);
+      data_ptr_.push_back(data);
+    }
+  }
+  timeslice_descriptor_.num_components =
+      static_cast<uint32_t>(data_ptr_.size());
+}
+
+void MappedTimeslice::reassemble(const TimesliceComponentDescriptor& desc,
+                                 const uint8_t* data,
+                                 uint64_t full_size,
+                                 const uint8_t* next_record,
+                                 uint64_t component) {
+  auto corrupt = []() {
+    return std::runtime_error("raw archive contains a component with "
+                              "missing overlap microslices");
+  };
+  if (next_record == nullptr) {
+    throw corrupt();
+  }
+  const auto* next_header =
+      reinterpret_cast<const RawArchiveRecordHeader*>(next_record);
+  if (component >= next_header->ts_desc.num_components) {
+    throw corrupt();
+  }
+  const auto* next_desc = reinterpret_cast<const TimesliceComponentDescriptor*>(
+      next_record + raw_archive_align(sizeof(RawArchiveRecordHeader)));
+  const TimesliceComponentDescriptor& nd = next_desc[component];
+  ComponentView next(next_record + nd.offset, nd.num_microslices);
+
+  // the first microslice not stored with this record
+  ComponentView view(data, desc.num_microslices);
+  uint64_t header_size = view.size() * sizeof(MicrosliceDescriptor);
+  uint64_t stored = desc.size - header_size;
+  uint64_t first_offset = view.descriptor(0).offset;
+  uint64_t first = 0;
+  while (first < view.size() &&
+         view.descriptor(first).offset - first_offset < stored) {
+    ++first;
+  }
+  if (first == view.size()) {
+    throw corrupt();
+  }
+  ComponentView rest = next.window(view.descriptor(first).idx,
+                                   std::numeric_limits<uint64_t>::max());
+  if (rest.empty() || rest.descriptor(0).idx != view.descriptor(first).idx ||
+      rest.content(0) < next.content(0)) {
+    throw corrupt();
+  }
+  uint64_t missing = full_size - desc.size;
+  auto rest_offset = static_cast<uint64_t>(rest.content(0) - next.content(0));
+  uint64_t next_stored = nd.size - next.size() * sizeof(MicrosliceDescriptor);
+  if (rest_offset > next_stored || missing > next_stored - rest_offset) {
+    throw corrupt();
+  }
+
+  std::vector<uint8_t> buffer(full_size);
+  std::memcpy(buffer.data(), data, desc.size);
+  std::memcpy(buffer.data() + desc.size, rest.content(0), missing);
+  reassembled_data_.push_back(std::move(buffer));
+
+  reassembled_desc_.push_back(desc);
+  reassembled_desc_.back().size = full_size;
+  desc_ptr_.push_back(&reassembled_desc_.back());
+  data_ptr_.push_back(reassembled_data_.back().data());
+}
+
+TimesliceMappedArchive::TimesliceMappedArchive(const std::string& filename,
+                                               ComponentSelection selection)
+    : filename_(filename), selection_(std::move(selection)) {
+  try {
+    boost::interprocess::file_mapping file(filename_.c_str(),
+                                           boost::interprocess::read_only);
+    auto region = std::make_shared<boost::interprocess::mapped_region>(
+        file, boost::interprocess::read_only);
+    region->advise(boost::interprocess::mapped_region::advice_sequential);
+    region_ = std::move(region);
+  } catch (boost::interprocess::interprocess_exception& e) {
+    throw std::ios_base::failure("error mapping file \"" + filename_ +
+                                 "\": " + e.what());
+  }
+
+  begin_ = static_cast<const uint8_t*>(region_->get_address());
+  size_ = region_->get_size();
+
+  const auto* header = reinterpret_cast<const RawArchiveFileHeader*>(begin_);
+  if (size_ < sizeof(RawArchiveFileHeader) ||
+      header->magic != raw_archive_magic) {
+    throw std::runtime_error("File \"" + filename_ +
+                             "\" is not a raw timeslice archive");
+  }
+  if (header->version != raw_archive_version &&
+      header->version != raw_archive_version_dedup) {
+    throw std::runtime_error("File \"" + filename_ +
+                             "\" has unsupported raw archive version " +
+                             std::to_string(header->version));
+  }
+
+  position_ = raw_archive_align(sizeof(RawArchiveFileHeader));
+}
+
+const uint8_t* TimesliceMappedArchive::current_record() {
+  if (eos_) {
+    return nullptr;
+  }
+
+  if (position_ + sizeof(RawArchiveRecordHeader) > size_) {
+    eos_ = true;
+    return nullptr;
+  }
+
+  const uint8_t* record = begin_ + position_;
+  if (!record_valid(record, size_ - position_)) {
+    throw std::runtime_error("File \"" + filename_ +
+                             "\" contains a truncated or corrupt record");
+  }
+  return record;
+}
+
+bool TimesliceMappedArchive::peek(uint64_t& index, uint64_t& start_time) {
+  const uint8_t* record = current_record();
+  if (record == nullptr) {
+    return false;
+  }
+  const auto* header = reinterpret_cast<const RawArchiveRecordHeader*>(record);
+  const auto* desc = reinterpret_cast<const TimesliceComponentDescriptor*>(
+      record + raw_archive_align(sizeof(RawArchiveRecordHeader)));
+  index = header->ts_desc.index;
+  // as in Timeslice::start_time(), independent of the selection
+  start_time = 0;
+  if (header->ts_desc.num_components != 0 && desc[0].num_microslices != 0) {
+    start_time =
+        reinterpret_cast<const MicrosliceDescriptor*>(record + desc[0].offset)
+            ->idx;
+  }
+  return true;
+}
+
+void TimesliceMappedArchive::skip() {
+  const uint8_t* record = current_record();
+  if (record != nullptr) {
+    position_ += reinterpret_cast<const RawArchiveRecordHeader*>(record)
+                     ->record_size;
+  }
+}
+
+MappedTimeslice* TimesliceMappedArchive::do_get() {
+  const uint8_t* record = current_record();
+  if (record == nullptr) {
+    return nullptr;
+  }
+  position_ +=
+      reinterpret_cast<const RawArchiveRecordHeader*>(record)->record_size;
+
+  // a following record may hold deduplicated overlap microslices
+  const uint8_t* next_record = nullptr;
+  if (position_ + sizeof(RawArchiveRecordHeader) <= size_) {
+    next_record = begin_ + position_;
+    if (!record_valid(next_record, size_ - position_)) {
+      next_record = nullptr;
+    }
+  }
+
+  return new MappedTimeslice(region_, record, next_record, // NOLINT
+                             selection_);
+}
+
+} // namespace fles
@@ -0,0 +1,122 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimesliceMappedArchive class.
+#pragma once
+
+#include "ComponentSelection.hpp"
+#include "Timeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The MappedTimeslice class provides access to the data of a single
+ * timeslice in a memory-mapped raw archive file.
+ *
+ * Components with deduplicated overlap microslices are reassembled in
+ * memory owned by the object, all other components refer to the mapping.
+ */
+class MappedTimeslice : public Timeslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  MappedTimeslice(const MappedTimeslice&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MappedTimeslice&) = delete;
+
+  ~MappedTimeslice() override = default;
+
+private:
+  friend class TimesliceMappedArchive;
+
+  MappedTimeslice(
+      std::shared_ptr<const boost::interprocess::mapped_region> region,
+      const uint8_t* record,
+      const uint8_t* next_record,
+      const ComponentSelection& selection);
+
+  /// Reassemble a component whose overlap is stored in the next record.
+  void reassemble(const TimesliceComponentDescriptor& desc,
+                  const uint8_t* data,
+                  uint64_t full_size,
+                  const uint8_t* next_record,
+                  uint64_t component);
+
+  /// The mapping this timeslice refers to, kept alive as long as needed.
+  std::shared_ptr<const boost::interprocess::mapped_region> region_;
+
+  /// Descriptors and data of reassembled components.
+  std::vector<TimesliceComponentDescriptor> reassembled_desc_;
+  std::vector<std::vector<uint8_t>> reassembled_data_;
+};
+
+/**
+ * \brief The TimesliceMappedArchive class provides timeslices from a raw
+ * timeslice archive file (see TimesliceRawArchive.hpp) without copying.
+ *
+ * The file is mapped into memory as a whole, and the returned timeslices
+ * refer directly to the mapped data. The mapping is kept alive until the
+ * archive object and all timeslices obtained from it are destroyed. If a
+ * component selection is given, the data of the other components is never
+ * accessed.
+ */
+class TimesliceMappedArchive : public TimesliceSource {
+public:
+  /**
+   * \brief Construct a mapped archive object, map the given raw archive file
+   * and check its file header.
+   *
+   * \param filename  File name of the raw archive file
+   * \param selection The components to provide
+   */
+  explicit TimesliceMappedArchive(const std::string& filename,
+                                  ComponentSelection selection = {});
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceMappedArchive(const TimesliceMappedArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceMappedArchive&) = delete;
+
+  ~TimesliceMappedArchive() override = default;
+
+  /// Retrieve the next timeslice.
+  std::unique_ptr<MappedTimeslice> get() {
+    return std::unique_ptr<MappedTimeslice>(do_get());
+  };
+
+  /**
+   * \brief Retrieve the index and start time of the next timeslice without
+   * accessing its component data (apart from its first microslice
+   * descriptor).
+   *
+   * \return false if there is no next timeslice
+   */
+  bool peek(uint64_t& index, uint64_t& start_time);
+
+  /// Skip the next timeslice without accessing its data.
+  void skip();
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  MappedTimeslice* do_get() override;
+
+  /// Retrieve the record at the current position, or nullptr at the end.
+  const uint8_t* current_record();
+
+  std::string filename_;
+  ComponentSelection selection_;
+  std::shared_ptr<const boost::interprocess::mapped_region> region_;
+  const uint8_t* begin_ = nullptr;
+  uint64_t size_ = 0;
+  uint64_t position_ = 0;
+
+  bool eos_ = false;
+};
+
+} // namespace fles
@@ -5,10 +5,17 @@
 #include "StorableTimeslice.hpp"
 #include "TimesliceInputArchive.hpp"
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/regex.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 /*
   Unexpected behaviour (from tests):
@@ -28,8 +35,24 @@ namespace filesys = boost::filesystem;
 
 namespace fles {
 
+struct TimesliceMultiInputArchive::Stream {
+  std::unique_ptr<TimesliceSource> source;
+  std::vector<std::string> files; ///< remaining files of the stream
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::unique_ptr<Timeslice>> queue;
+  bool done = false; ///< reader thread has finished
+  bool stop = false; ///< reader thread should finish
+  std::exception_ptr error;
+  std::thread thread;
+};
+
 TimesliceMultiInputArchive::TimesliceMultiInputArchive(
-    const std::string& inputString, const std::string& inputDirectory) {
+    const std::string& inputString,
+    const std::string& inputDirectory,
+    std::size_t lookahead)
+    : lookahead_(lookahead > 0 ? lookahead : 1) {
 
   std::string newInputString;
   if (!inputDirectory.empty()) {
@@ -50,11 +73,13 @@ TimesliceMultiInputArchive::TimesliceMultiInputArchive(
 
   if (!newInputString.empty()) {
     CreateInputFileList(newInputString);
-    for (auto& stream : InputFileList) {
-      std::string file = stream.at(0);
-      stream.erase(stream.begin());
-      source_.push_back(std::make_unique<TimesliceInputArchive>(file));
+    for (auto& fileList : InputFileList) {
+      auto stream = std::make_unique<Stream>();
+      std::string file = fileList.at(0);
+      stream->files.assign(fileList.begin() + 1, fileList.end());
+      stream->source = std::make_unique<TimesliceInputArchive>(file);
       L_(info) << " Open file: " << file;
+      streams_.push_back(std::move(stream));
     }
   } else {
     L_(fatal) << "No input files defined";
@@ -126,22 +151,117 @@ void TimesliceMultiInputArchive::CreateInputFileList(std::string inputString) {
   }
 }
 
+TimesliceMultiInputArchive::~TimesliceMultiInputArchive() { StopStreams(); }
+
+void TimesliceMultiInputArchive::StopStreams() {
+  for (auto& stream : streams_) {
+    {
+      std::lock_guard<std::mutex> lock(stream->mutex);
+      stream->stop = true;
+    }
+    stream->cv.notify_all();
+  }
+  for (auto& stream : streams_) {
+    if (stream->thread.joinable()) {
+      stream->thread.join();
+    }
+  }
+}
+
 void TimesliceMultiInputArchive::InitTimesliceArchive() {
-  timesliceCont.resize(source_.size());
-
-  int element = 0;
-  for (auto& sourceNr : source_) {
-    if (auto timeslice = sourceNr->get()) {
-      sortedSource_.insert({timeslice->index(), element});
-      timesliceCont.at(element) = std::move(timeslice);
-      element++;
-    } else {
+  for (auto& stream : streams_) {
+    stream->thread = std::thread([this, &stream] { ReadStream(*stream); });
+  }
+
+  timesliceCont.resize(streams_.size());
+
+  for (int element = 0; element < static_cast<int>(streams_.size());
+       ++element) {
+    try {
+      PushNextTimeslice(element);
+    } catch (...) {
+      StopStreams();
+      throw;
+    }
+    if (!timesliceCont.at(element)) {
       L_(fatal) << "Could not read a timeslice from input stream " << element;
       exit(1);
     }
   }
 }
 
+void TimesliceMultiInputArchive::ReadStream(Stream& stream) {
+  try {
+    while (true) {
+      std::unique_ptr<Timeslice> timeslice = stream.source->get();
+      if (!timeslice) {
+        // continue with the next file of the stream, if any
+        stream.source = nullptr;
+        if (stream.files.empty()) {
+          L_(info) << "End of files list reached.";
+          break;
+        }
+        std::string file = stream.files.front();
+        stream.files.erase(stream.files.begin());
+        stream.source = std::make_unique<TimesliceInputArchive>(file);
+        L_(info) << " Open file: " << file;
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(stream.mutex);
+      stream.cv.wait(lock, [this, &stream] {
+        return stream.stop || stream.queue.size() < lookahead_;
+      });
+      if (stream.stop) {
+        break;
+      }
+      stream.queue.push_back(std::move(timeslice));
+      stream.cv.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(stream.mutex);
+    stream.error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(stream.mutex);
+  stream.done = true;
+  stream.cv.notify_all();
+}
+
+std::unique_ptr<Timeslice>
+TimesliceMultiInputArchive::FetchTimeslice(int element) {
+  Stream& stream = *streams_.at(element);
+  std::unique_lock<std::mutex> lock(stream.mutex);
+  stream.cv.wait(lock,
+                 [&stream] { return !stream.queue.empty() || stream.done; });
+  if (stream.queue.empty()) {
+    if (stream.error) {
+      std::rethrow_exception(stream.error);
+    }
+    return nullptr;
+  }
+  std::unique_ptr<Timeslice> timeslice = std::move(stream.queue.front());
+  stream.queue.pop_front();
+  lock.unlock();
+  stream.cv.notify_all();
+  return timeslice;
+}
+
+void TimesliceMultiInputArchive::InsertTimeslice(
+    int element, std::unique_ptr<Timeslice> timeslice) {
+  sortedSource_.emplace_back(timeslice->start_time(), timeslice->index(),
+                             element);
+  std::push_heap(sortedSource_.begin(), sortedSource_.end(),
+                 std::greater<>());
+  timesliceCont.at(element) = std::move(timeslice);
+}
+
+void TimesliceMultiInputArchive::PushNextTimeslice(int element) {
+  std::unique_ptr<Timeslice> timeslice = FetchTimeslice(element);
+  if (timeslice) {
+    InsertTimeslice(element, std::move(timeslice));
+  }
+}
+
 Timeslice* TimesliceMultiInputArchive::do_get() {
   return GetNextTimeslice().release();
 }
@@ -149,30 +269,20 @@ Timeslice* TimesliceMultiInputArchive::do_get() {
 std::unique_ptr<Timeslice> TimesliceMultiInputArchive::GetNextTimeslice() {
 
   if (!sortedSource_.empty()) {
-    // take the first element from the set which is the one with the smallest
-    // ts number
-    // (*(sortedSource_.begin())) dereference the std::set iterator to get
-    // access to the contained pair afterwards erase the first element of the
-    // set
-    int currentSource = (*(sortedSource_.begin())).second;
-    sortedSource_.erase(sortedSource_.begin());
+    // take the top element from the heap, which is the one with the smallest
+    // start time, and replace it with the next timeslice of the same stream
+    int currentSource = std::get<2>(sortedSource_.front());
 
+    // fetch the successor first, so that nothing is lost if this throws
+    std::unique_ptr<Timeslice> next = FetchTimeslice(currentSource);
+
+    std::pop_heap(sortedSource_.begin(), sortedSource_.end(),
+                  std::greater<>());
+    sortedSource_.pop_back();
     std::unique_ptr<Timeslice> retTimeslice =
         std::move(timesliceCont.at(currentSource));
-
-    if (auto timeslice = source_.at(currentSource)->get()) {
-      sortedSource_.insert({timeslice->index(), currentSource});
-      timesliceCont.at(currentSource) = std::move(timeslice);
-    } else {
-      if (!OpenNextFile(currentSource)) {
-        // if the first file reaches the end stop reading
-        // return std::unique_ptr<const Timeslice>(nullptr);
-      } else {
-        if ((timeslice = source_.at(currentSource)->get())) {
-          sortedSource_.insert({timeslice->index(), currentSource});
-          timesliceCont.at(currentSource) = std::move(timeslice);
-        }
-      }
+    if (next) {
+      InsertTimeslice(currentSource, std::move(next));
     }
 
     return retTimeslice;
@@ -180,22 +290,4 @@ std::unique_ptr<Timeslice> TimesliceMultiInputArchive::GetNextTimeslice() {
   return std::unique_ptr<Timeslice>(nullptr);
 }
 
-bool TimesliceMultiInputArchive::OpenNextFile(int element) {
-  // First Close and delete existing source
-  if (nullptr != source_.at(element)) {
-    delete source_.at(element).release(); // NOLINT
-  }
-
-  if (!InputFileList.at(element).empty()) {
-    std::string file = InputFileList.at(element).at(0);
-    InputFileList.at(element).erase(InputFileList.at(element).begin());
-    source_.at(element) = std::make_unique<TimesliceInputArchive>(file);
-    L_(info) << " Open file: " << file;
-  } else {
-    L_(info) << "End of files list reached.";
-    return false;
-  }
-  return true;
-}
-
 } // namespace fles
@@ -7,16 +7,21 @@
 #include "TimesliceSource.hpp"
 #include "log.hpp"
 #include <chrono>
+#include <cstdint>
 #include <memory>
-#include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace fles {
 /**
  * \brief The TimesliceMultiInputArchive class reads timeslice data from
  * several TimesliceInputArchives and returns the timslice with the
- * smallest index.
+ * smallest start time.
+ *
+ * Each input stream is read ahead by its own background thread into a small
+ * queue, so that a slow input does not stall reading of the others. The
+ * streams are merged using a min-heap keyed on start time (and index).
  */
 class TimesliceMultiInputArchive : public TimesliceSource {
 public:
@@ -24,16 +29,19 @@ public:
   // string open the archive files for reading, and read the archive descriptors
   // If a directory is passed as second parameter build first a list of
   // filenames which contains the full path
+  // The lookahead parameter sets the number of timeslices read in advance for
+  // each of the input streams
   explicit TimesliceMultiInputArchive(
       const std::string& /*inputString*/,
-      const std::string& /*inputDirectory*/ = "");
+      const std::string& /*inputDirectory*/ = "",
+      std::size_t lookahead = 4);
 
   /// Delete copy constructor (non-copyable).
   TimesliceMultiInputArchive(const TimesliceMultiInputArchive&) = delete;
   /// Delete assignment operator (non-copyable).
   void operator=(const TimesliceMultiInputArchive&) = delete;
 
-  ~TimesliceMultiInputArchive() override = default;
+  ~TimesliceMultiInputArchive() override;
 
   /**
    * \brief Retrieve the next item.
@@ -46,20 +54,33 @@ public:
   bool eos() const override { return sortedSource_.empty(); }
 
 private:
+  /// The read-ahead state of an input stream.
+  struct Stream;
+
+  /// Heap entry (start time, index, stream number).
+  using HeapEntry = std::tuple<uint64_t, uint64_t, int>;
+
   Timeslice* do_get() override;
 
   void InitTimesliceArchive();
   void CreateInputFileList(std::string /*inputString*/);
-  bool OpenNextFile(int /*element*/);
+  void ReadStream(Stream& /*stream*/);
+  void StopStreams();
+  std::unique_ptr<Timeslice> FetchTimeslice(int /*element*/);
+  void InsertTimeslice(int /*element*/, std::unique_ptr<Timeslice> /*ts*/);
+  void PushNextTimeslice(int /*element*/);
   std::unique_ptr<Timeslice> GetNextTimeslice();
 
-  std::vector<std::unique_ptr<TimesliceSource>> source_;
+  std::size_t lookahead_;
+
+  std::vector<std::unique_ptr<Stream>> streams_;
 
   std::vector<std::vector<std::string>> InputFileList;
 
   std::vector<std::unique_ptr<Timeslice>> timesliceCont;
 
-  std::set<std::pair<uint64_t, int>> sortedSource_;
+  /// Min-heap of the next timeslice of each stream
+  std::vector<HeapEntry> sortedSource_;
 
   logging::OstreamLog status_log_{status};
   logging::OstreamLog debug_log_{debug};
@@ -0,0 +1,74 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the datagram format of multicast timeslices.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace fles {
+
+/**
+ * \brief The multicast timeslice datagram format.
+ *
+ * A timeslice published by UDP multicast (see TimesliceMulticastPublisher)
+ * is laid out as a multipart timeslice message (see TimesliceMultipart.hpp)
+ * without the part boundaries, i.e., the TimesliceMultipartHeader followed
+ * by the TimesliceComponentDescriptor and the data of each component. This
+ * byte sequence is split into datagrams, each starting with a
+ * TimesliceDatagramHeader.
+ *
+ * The datagram sequence number increases by one with each datagram, so that
+ * subscribers can detect lost datagrams. Timeslices with lost datagrams are
+ * dropped as a whole, there is no retransmission. A datagram with the
+ * end-of-stream flag set and without payload marks the end of the stream.
+ *
+ * All values are in host byte order.
+ */
+
+#pragma pack(1)
+
+/// The header of a multicast timeslice datagram.
+struct TimesliceDatagramHeader {
+  uint32_t magic;      ///< Datagram format identifier
+  uint16_t version;    ///< Datagram format version
+  uint16_t flags;      ///< Flags (see timeslice_datagram_eos)
+  uint64_t sequence;   ///< Sequence number of the datagram
+  uint64_t index;      ///< Index of the timeslice
+  uint64_t total_size; ///< Size of the timeslice byte sequence
+  uint64_t offset;     ///< Offset of the payload in the byte sequence
+};
+
+#pragma pack()
+
+/// Magic number identifying multicast timeslice datagrams ("FTSD").
+constexpr uint32_t timeslice_datagram_magic = 0x44535446;
+
+/// Current multicast timeslice datagram format version.
+constexpr uint16_t timeslice_datagram_version = 1;
+
+/// Flag marking the end-of-stream datagram.
+constexpr uint16_t timeslice_datagram_eos = 1;
+
+/// Default datagram size, fitting a standard Ethernet MTU.
+constexpr std::size_t default_timeslice_datagram_size = 1472;
+
+/// Split the authority of a multicast address ("group:port").
+inline std::pair<std::string, uint16_t>
+split_multicast_authority(const std::string& authority) {
+  auto colon = authority.rfind(':');
+  if (colon == std::string::npos || colon == 0 ||
+      colon + 1 == authority.size()) {
+    throw std::invalid_argument("invalid multicast address: " + authority);
+  }
+  unsigned long port = std::stoul(authority.substr(colon + 1));
+  if (port == 0 || port > UINT16_MAX) {
+    throw std::invalid_argument("invalid multicast port: " + authority);
+  }
+  return {authority.substr(0, colon), static_cast<uint16_t>(port)};
+}
+
+} // namespace fles
@@ -0,0 +1,212 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceMulticastPublisher.hpp"
+#include "TimesliceMulticast.hpp"
+#include "TimesliceMultipart.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace fles {
+
+TimesliceMulticastPublisher::TimesliceMulticastPublisher(
+    const std::string& address)
+    : datagram_size_(default_timeslice_datagram_size) {
+  UriComponents uri(address);
+  if (uri.scheme != "udp") {
+    throw std::invalid_argument("multicast address scheme must be udp: " +
+                                address);
+  }
+  auto [group, port] = split_multicast_authority(uri.authority);
+
+  int ttl = 1;
+  std::string interface;
+  for (const auto& [key, value] : uri.query_components) {
+    if (key == "ttl") {
+      ttl = std::stoi(value);
+    } else if (key == "interface") {
+      interface = value;
+    } else if (key == "datagram") {
+      datagram_size_ = std::stoull(value);
+    } else if (key == "rate") {
+      rate_ = std::stod(value);
+    } else {
+      throw std::invalid_argument(
+          "query parameter not implemented for multicast publisher: " + key);
+    }
+  }
+  if (datagram_size_ <= sizeof(TimesliceDatagramHeader) ||
+      datagram_size_ > 65507) {
+    throw std::invalid_argument("invalid multicast datagram size");
+  }
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, group.c_str(), &addr.sin_addr) != 1 ||
+      !IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+    throw std::invalid_argument("invalid multicast group: " + group);
+  }
+
+  socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket_ < 0) {
+    throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+  }
+  auto check = [this](int err, const char* what) {
+    if (err != 0) {
+      std::string message = std::string(what) + ": " + std::strerror(errno);
+      ::close(socket_);
+      throw std::runtime_error(message);
+    }
+  };
+  check(setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)),
+        "IP_MULTICAST_TTL");
+  if (!interface.empty()) {
+    struct in_addr if_addr {};
+    if (inet_pton(AF_INET, interface.c_str(), &if_addr) != 1) {
+      ::close(socket_);
+      throw std::invalid_argument("invalid interface address: " + interface);
+    }
+    check(setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_IF, &if_addr,
+                     sizeof(if_addr)),
+          "IP_MULTICAST_IF");
+  }
+  check(::connect(socket_, reinterpret_cast<struct sockaddr*>(&addr),
+                  sizeof(addr)),
+        "connect");
+  pace_start_ = std::chrono::steady_clock::now();
+}
+
+TimesliceMulticastPublisher::~TimesliceMulticastPublisher() {
+  TimesliceDatagramHeader header{timeslice_datagram_magic,
+                                 timeslice_datagram_version,
+                                 timeslice_datagram_eos,
+                                 sequence_,
+                                 0,
+                                 0,
+                                 0};
+  struct iovec iov {
+    &header, sizeof(header)
+  };
+  try {
+    send_datagram(&iov, 1);
+  } catch (const std::exception&) {
+    // the subscribers miss the end of the stream, which is not fatal
+  }
+  ::close(socket_);
+}
+
+void TimesliceMulticastPublisher::put(
+    std::shared_ptr<const fles::Timeslice> timeslice) {
+  const Timeslice& ts = *timeslice;
+  const auto num_components = ts.timeslice_descriptor_.num_components;
+
+  // the byte sequence of the timeslice, see TimesliceMulticast.hpp
+  TimesliceMultipartHeader ts_header{multipart_timeslice_magic,
+                                     multipart_timeslice_version, 0,
+                                     ts.timeslice_descriptor_};
+  std::vector<struct iovec> parts;
+  parts.push_back({&ts_header, sizeof(ts_header)});
+  for (uint64_t c = 0; c < num_components; ++c) {
+    parts.push_back(
+        {ts.desc_ptr_[c], sizeof(TimesliceComponentDescriptor)});
+    // the contents may not directly follow the descriptors
+    const uint64_t desc_size = ts.descriptors_size(c);
+    if (desc_size > 0) {
+      parts.push_back({ts.data_ptr_[c], desc_size});
+    }
+    if (ts.desc_ptr_[c]->size > desc_size) {
+      parts.push_back({ts.content_ptr(c), ts.desc_ptr_[c]->size - desc_size});
+    }
+  }
+  uint64_t total_size = 0;
+  for (const auto& part : parts) {
+    total_size += part.iov_len;
+  }
+
+  // split it into datagrams, gathering the parts without copying
+  const std::size_t payload_size =
+      datagram_size_ - sizeof(TimesliceDatagramHeader);
+  TimesliceDatagramHeader header{timeslice_datagram_magic,
+                                 timeslice_datagram_version,
+                                 0,
+                                 0,
+                                 ts.index(),
+                                 total_size,
+                                 0};
+  std::vector<struct iovec> iov;
+  std::size_t part = 0;
+  std::size_t part_offset = 0;
+  for (uint64_t offset = 0; offset < total_size; offset += payload_size) {
+    header.sequence = sequence_;
+    header.offset = offset;
+    iov.assign(1, {&header, sizeof(header)});
+    std::size_t remaining = std::min<uint64_t>(payload_size,
+                                               total_size - offset);
+    while (remaining > 0) {
+      std::size_t len =
+          std::min(remaining, parts[part].iov_len - part_offset);
+      iov.push_back(
+          {static_cast<uint8_t*>(parts[part].iov_base) + part_offset, len});
+      remaining -= len;
+      part_offset += len;
+      if (part_offset == parts[part].iov_len) {
+        ++part;
+        part_offset = 0;
+      }
+    }
+    send_datagram(iov.data(), iov.size());
+  }
+}
+
+void TimesliceMulticastPublisher::send_datagram(const struct iovec* iov,
+                                                std::size_t iovcnt) {
+  std::size_t bytes = 0;
+  for (std::size_t i = 0; i < iovcnt; ++i) {
+    bytes += iov[i].iov_len;
+  }
+  pace(bytes);
+
+  struct msghdr msg {};
+  msg.msg_iov = const_cast<struct iovec*>(iov);
+  msg.msg_iovlen = iovcnt;
+  ssize_t sent;
+  do {
+    sent = ::sendmsg(socket_, &msg, 0);
+    // a full local queue is not an error for a best-effort sender
+  } while (sent < 0 && (errno == EINTR || errno == ENOBUFS));
+  if (sent < 0) {
+    throw std::runtime_error(std::string("sendmsg: ") + std::strerror(errno));
+  }
+  ++sequence_;
+}
+
+void TimesliceMulticastPublisher::pace(std::size_t bytes) {
+  if (rate_ <= 0.0) {
+    return;
+  }
+  paced_bytes_ += static_cast<double>(bytes);
+  auto due = pace_start_ + std::chrono::duration_cast<
+                               std::chrono::steady_clock::duration>(
+                               std::chrono::duration<double>(paced_bytes_ /
+                                                             rate_));
+  auto now = std::chrono::steady_clock::now();
+  if (due > now) {
+    std::this_thread::sleep_until(due);
+  } else if (now - due > std::chrono::milliseconds(100)) {
+    // do not catch up after idle periods in a burst
+    pace_start_ = now;
+    paced_bytes_ = 0.0;
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,70 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimesliceMulticastPublisher class.
+#pragma once
+
+#include "Sink.hpp"
+#include "Timeslice.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/uio.h>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceMulticastPublisher class publishes timeslices by UDP
+ * multicast.
+ *
+ * Each timeslice is sent once, in the datagram format described in
+ * TimesliceMulticast.hpp, and reaches any number of subscribers (see
+ * TimesliceMulticastSubscriber) at constant cost. The delivery is best
+ * effort: subscribers that cannot keep up lose timeslices, and report it.
+ * The datagrams refer directly to the timeslice memory.
+ *
+ * The address has the form `udp://group:port`, with optional query
+ * parameters
+ * - `interface`: the address of the local interface to send on,
+ * - `ttl`: the multicast time-to-live (default: 1, the local network),
+ * - `datagram`: the datagram size in bytes (default: 1472),
+ * - `rate`: the maximum send rate in bytes per second (default: 0, no
+ *   limit), to avoid overrunning the receive buffers of the subscribers.
+ */
+class TimesliceMulticastPublisher : public TimesliceSink {
+public:
+  /// Construct multicast publisher sending to given address.
+  explicit TimesliceMulticastPublisher(const std::string& address);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceMulticastPublisher(const TimesliceMulticastPublisher&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceMulticastPublisher&) = delete;
+
+  /// Send the end-of-stream datagram and close the socket.
+  ~TimesliceMulticastPublisher() override;
+
+  /// Send a timeslice to all subscribers.
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
+
+  /// Retrieve the number of datagrams sent.
+  [[nodiscard]] uint64_t datagrams_sent() const { return sequence_; }
+
+private:
+  /// Send a datagram consisting of the given parts.
+  void send_datagram(const struct iovec* iov, std::size_t iovcnt);
+
+  /// Wait as required by the rate limit before sending given bytes.
+  void pace(std::size_t bytes);
+
+  int socket_ = -1;
+  std::size_t datagram_size_ = 0;
+  double rate_ = 0.0;
+  uint64_t sequence_ = 0;
+
+  /// Bytes sent since pacing started.
+  double paced_bytes_ = 0.0;
+  std::chrono::steady_clock::time_point pace_start_;
+};
+
+} // namespace fles
@@ -0,0 +1,209 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceMulticastSubscriber.hpp"
+#include "TimesliceMulticast.hpp"
+#include "TimesliceMultipart.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace fles {
+
+MulticastTimeslice::MulticastTimeslice(std::vector<uint8_t> buffer,
+                                       const ComponentSelection& selection)
+    : buffer_(std::move(buffer)) {
+  if (buffer_.size() < sizeof(TimesliceMultipartHeader)) {
+    throw std::runtime_error("invalid multicast timeslice header");
+  }
+  const auto* header =
+      reinterpret_cast<const TimesliceMultipartHeader*>(buffer_.data());
+  if (header->magic != multipart_timeslice_magic ||
+      header->version != multipart_timeslice_version) {
+    throw std::runtime_error("unsupported multicast timeslice format");
+  }
+  timeslice_descriptor_ = header->ts_desc;
+
+  std::size_t pos = sizeof(TimesliceMultipartHeader);
+  for (size_t c = 0; c < header->ts_desc.num_components; ++c) {
+    if (buffer_.size() - pos < sizeof(TimesliceComponentDescriptor)) {
+      throw std::runtime_error("invalid multicast timeslice component");
+    }
+    auto* tsc_desc =
+        reinterpret_cast<TimesliceComponentDescriptor*>(&buffer_[pos]);
+    pos += sizeof(TimesliceComponentDescriptor);
+    if (buffer_.size() - pos < tsc_desc->size ||
+        tsc_desc->num_microslices * sizeof(MicrosliceDescriptor) >
+            tsc_desc->size) {
+      throw std::runtime_error("invalid multicast timeslice component size");
+    }
+    uint8_t* data = &buffer_[0] + pos;
+    pos += tsc_desc->size;
+    if (selection.selects(
+            c, tsc_desc->num_microslices,
+            reinterpret_cast<const MicrosliceDescriptor*>(data))) {
+      desc_ptr_.push_back(tsc_desc);
+      data_ptr_.push_back(data);
+    }
+  }
+  timeslice_descriptor_.num_components =
+      static_cast<uint32_t>(data_ptr_.size());
+}
+
+TimesliceMulticastSubscriber::TimesliceMulticastSubscriber(
+    const std::string& address,
+    const std::string& interface,
+    ComponentSelection selection,
+    uint64_t stride,
+    uint64_t offset,
+    std::size_t buffer_size)
+    : selection_(std::move(selection)), stride_(stride), offset_(offset),
+      datagram_(65536) {
+  if (stride == 0) {
+    throw std::invalid_argument("stride must be greater than zero");
+  }
+  UriComponents uri(address);
+  if (uri.scheme != "udp") {
+    throw std::invalid_argument("multicast address scheme must be udp: " +
+                                address);
+  }
+  auto [group, port] = split_multicast_authority(uri.authority);
+
+  struct ip_mreq mreq {};
+  if (inet_pton(AF_INET, group.c_str(), &mreq.imr_multiaddr) != 1 ||
+      !IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr))) {
+    throw std::invalid_argument("invalid multicast group: " + group);
+  }
+  mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+  if (!interface.empty() &&
+      inet_pton(AF_INET, interface.c_str(), &mreq.imr_interface) != 1) {
+    throw std::invalid_argument("invalid interface address: " + interface);
+  }
+
+  socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket_ < 0) {
+    throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+  }
+  auto check = [this](int err, const char* what) {
+    if (err != 0) {
+      std::string message = std::string(what) + ": " + std::strerror(errno);
+      ::close(socket_);
+      throw std::runtime_error(message);
+    }
+  };
+  // several subscribers on the same host share the port
+  int reuse = 1;
+  check(setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)),
+        "SO_REUSEADDR");
+  if (buffer_size > 0) {
+    int size = static_cast<int>(buffer_size);
+    check(setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)),
+          "SO_RCVBUF");
+  }
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr = mreq.imr_multiaddr;
+  check(::bind(socket_, reinterpret_cast<struct sockaddr*>(&addr),
+               sizeof(addr)),
+        "bind");
+  check(setsockopt(socket_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq,
+                   sizeof(mreq)),
+        "IP_ADD_MEMBERSHIP");
+}
+
+TimesliceMulticastSubscriber::~TimesliceMulticastSubscriber() {
+  if (lost_timeslices_ > 0) {
+    L_(warning) << "multicast subscriber: " << lost_timeslices_
+                << " timeslices dropped, " << lost_datagrams_
+                << " datagrams lost";
+  }
+  ::close(socket_);
+}
+
+void TimesliceMulticastSubscriber::drop_incomplete() {
+  if (assembling_) {
+    ++lost_timeslices_;
+    assembling_ = false;
+    buffer_.clear();
+  }
+}
+
+Timeslice* TimesliceMulticastSubscriber::do_get() {
+  while (!eos_) {
+    ssize_t size = ::recv(socket_, datagram_.data(), datagram_.size(), 0);
+    if (size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("recv: ") + std::strerror(errno));
+    }
+    TimesliceDatagramHeader header{};
+    if (static_cast<std::size_t>(size) < sizeof(header)) {
+      continue;
+    }
+    std::memcpy(&header, datagram_.data(), sizeof(header));
+    if (header.magic != timeslice_datagram_magic ||
+        header.version != timeslice_datagram_version) {
+      continue;
+    }
+
+    // any gap or reordering breaks the timeslice being reassembled
+    if (synchronized_ && header.sequence != next_sequence_) {
+      if (header.sequence > next_sequence_) {
+        lost_datagrams_ += header.sequence - next_sequence_;
+      }
+      drop_incomplete();
+    }
+    next_sequence_ = header.sequence + 1;
+    synchronized_ = true;
+
+    if ((header.flags & timeslice_datagram_eos) != 0) {
+      drop_incomplete();
+      eos_ = true;
+      break;
+    }
+    if (header.index % stride_ != offset_ % stride_) {
+      continue;
+    }
+
+    if (assembling_ && header.index != index_) {
+      drop_incomplete();
+    }
+    if (!assembling_) {
+      // the rest of a dropped timeslice, or joined in the middle
+      if (header.offset != 0) {
+        continue;
+      }
+      buffer_.resize(header.total_size);
+      index_ = header.index;
+      received_bytes_ = 0;
+      assembling_ = true;
+    }
+
+    const std::size_t payload = size - sizeof(header);
+    if (header.total_size != buffer_.size() ||
+        header.offset > buffer_.size() ||
+        payload > buffer_.size() - header.offset) {
+      drop_incomplete();
+      continue;
+    }
+    std::memcpy(buffer_.data() + header.offset,
+                datagram_.data() + sizeof(header), payload);
+    received_bytes_ += payload;
+
+    if (received_bytes_ == buffer_.size()) {
+      assembling_ = false;
+      return new MulticastTimeslice(std::move(buffer_), // NOLINT
+                                    selection_);
+    }
+  }
+  return nullptr;
+}
+
+} // namespace fles
@@ -0,0 +1,124 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimesliceMulticastSubscriber class.
+#pragma once
+
+#include "ComponentSelection.hpp"
+#include "TimesliceSource.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The MulticastTimeslice class provides access to the data of a
+ * timeslice received by multicast (see TimesliceMulticast.hpp).
+ */
+class MulticastTimeslice : public Timeslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  MulticastTimeslice(const MulticastTimeslice&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MulticastTimeslice&) = delete;
+
+  ~MulticastTimeslice() override = default;
+
+private:
+  friend class TimesliceMulticastSubscriber;
+
+  MulticastTimeslice(std::vector<uint8_t> buffer,
+                     const ComponentSelection& selection);
+
+  /// The reassembled byte sequence this timeslice refers to.
+  std::vector<uint8_t> buffer_;
+};
+
+/**
+ * \brief The TimesliceMulticastSubscriber class receives timeslices
+ * published by UDP multicast (see TimesliceMulticastPublisher).
+ *
+ * The timeslices are reassembled from the datagrams. A timeslice with lost
+ * datagrams is dropped and counted, so that a slow subscriber loses
+ * timeslices without affecting the publisher or other subscribers. If a
+ * stride is given, only the timeslices with index % stride == offset %
+ * stride are reassembled, the others are discarded on arrival.
+ */
+class TimesliceMulticastSubscriber : public TimesliceSource {
+public:
+  /**
+   * \brief Construct multicast subscriber receiving from given group.
+   *
+   * \param address     the multicast address (`udp://group:port`)
+   * \param interface   the address of the local interface to receive on
+   *                    (empty: chosen by the system)
+   * \param selection   the components to provide
+   * \param stride      the stride of the timeslices to receive
+   * \param offset      the offset of the timeslices to receive
+   * \param buffer_size the socket receive buffer size (0: system default)
+   */
+  explicit TimesliceMulticastSubscriber(const std::string& address,
+                                        const std::string& interface = {},
+                                        ComponentSelection selection = {},
+                                        uint64_t stride = 1,
+                                        uint64_t offset = 0,
+                                        std::size_t buffer_size = 0);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceMulticastSubscriber(const TimesliceMulticastSubscriber&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceMulticastSubscriber&) = delete;
+
+  ~TimesliceMulticastSubscriber() override;
+
+  /**
+   * \brief Retrieve the next item.
+   *
+   * This function blocks if the next item is not yet available.
+   *
+   * \return pointer to the item, or nullptr if end-of-stream
+   */
+  std::unique_ptr<Timeslice> get() {
+    return std::unique_ptr<Timeslice>(do_get());
+  };
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+  /// Retrieve the number of datagrams lost.
+  [[nodiscard]] uint64_t lost_datagrams() const { return lost_datagrams_; }
+
+  /// Retrieve the number of timeslices dropped due to lost datagrams.
+  [[nodiscard]] uint64_t lost_timeslices() const { return lost_timeslices_; }
+
+private:
+  Timeslice* do_get() override;
+
+  /// Drop the timeslice being reassembled (if any) as incomplete.
+  void drop_incomplete();
+
+  int socket_ = -1;
+  ComponentSelection selection_;
+  uint64_t stride_;
+  uint64_t offset_;
+
+  bool eos_ = false;
+
+  /// The datagram receive buffer.
+  std::vector<uint8_t> datagram_;
+
+  /// The expected sequence number of the next datagram.
+  uint64_t next_sequence_ = 0;
+  bool synchronized_ = false;
+
+  /// The timeslice being reassembled.
+  std::vector<uint8_t> buffer_;
+  uint64_t index_ = 0;
+  uint64_t received_bytes_ = 0;
+  bool assembling_ = false;
+
+  uint64_t lost_datagrams_ = 0;
+  uint64_t lost_timeslices_ = 0;
+};
+
+} // namespace fles
@@ -0,0 +1,61 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the multipart message format of published timeslices.
+#pragma once
+
+#include "TimesliceDescriptor.hpp"
+#include <cstdint>
+#include <string>
+
+namespace fles {
+
+/**
+ * \brief The multipart timeslice message format.
+ *
+ * As an alternative to a single boost-serialized message, a timeslice can be
+ * published as a multipart ZeroMQ message (see TimeslicePublisher), which
+ * allows both sending and receiving without copying the timeslice data. The
+ * message consists of
+ *
+ * - a TimesliceMultipartHeader part,
+ * - for each component, one part containing its TimesliceComponentDescriptor
+ *   followed by one part containing its data (microslice descriptors followed
+ *   by content, as in Timeslice).
+ *
+ * All values are in host byte order.
+ *
+ * If the publisher is configured with a topic modulus N, each message
+ * (single or multipart) is preceded by a topic part as returned by
+ * timeslice_topic(N, index % N). Subscribers receiving only every n-th
+ * timeslice subscribe to the corresponding topics, so that ZeroMQ does not
+ * send the other timeslices to them at all.
+ */
+
+#pragma pack(1)
+
+/// The header part of a multipart timeslice message.
+struct TimesliceMultipartHeader {
+  uint64_t magic;              ///< Message format identifier
+  uint32_t version;            ///< Message format version
+  uint32_t reserved;           ///< Reserved, always zero
+  TimesliceDescriptor ts_desc; ///< The timeslice descriptor
+};
+
+#pragma pack()
+
+/// Magic number identifying multipart timeslice messages ("FLESTSM\0").
+constexpr uint64_t multipart_timeslice_magic = 0x004d535453454c46;
+
+/// Current multipart timeslice message format version.
+constexpr uint32_t multipart_timeslice_version = 1;
+
+/// Prefix of the topic part of published timeslices.
+constexpr char timeslice_topic_prefix[] = "fles/ts/";
+
+/// Retrieve the topic of the timeslices with index % modulus == remainder.
+inline std::string timeslice_topic(uint64_t modulus, uint64_t remainder) {
+  return timeslice_topic_prefix + std::to_string(modulus) + "/" +
+         std::to_string(remainder) + "/";
+}
+
+} // namespace fles
@@ -6,6 +6,7 @@
 #include "OutputArchive.hpp"
 #include "OutputArchiveSequence.hpp"
 #include "StorableTimeslice.hpp"
+#include "StripedOutputArchive.hpp"
 
 namespace fles {
 
@@ -21,4 +22,9 @@ using TimesliceOutputArchiveSequence =
                           StorableTimeslice,
                           ArchiveType::TimesliceArchive>;
 
+using TimesliceStripedOutputArchive =
+    StripedOutputArchive<Timeslice,
+                         StorableTimeslice,
+                         ArchiveType::TimesliceArchive>;
+
 } // namespace fles
@@ -1,33 +1,116 @@
 // Copyright 2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimeslicePublisher.hpp"
+#include "SelectedTimeslice.hpp"
+#include "TimesliceMultipart.hpp"
 #include <algorithm>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <memory>
 
 namespace fles {
 
+namespace {
+
+/// Release the timeslice reference held by a zero-copy message part.
+void release_timeslice(void* /* data */, void* hint) {
+  delete static_cast<std::shared_ptr<const Timeslice>*>(hint); // NOLINT
+}
+
+/// Release the serialized timeslice owned by a message.
+void release_string(void* /* data */, void* hint) {
+  delete static_cast<std::string*>(hint); // NOLINT
+}
+
+/// Create a message part referring to timeslice memory without copying.
+zmq::message_t zero_copy_message(const void* data,
+                                 std::size_t size,
+                                 const std::shared_ptr<const Timeslice>& ts) {
+  auto* hint = new std::shared_ptr<const Timeslice>(ts); // NOLINT
+  // const_cast is safe here as ZeroMQ only reads from the buffer
+  return {const_cast<void*>(data), size, release_timeslice, hint};
+}
+
+} // namespace
+
 TimeslicePublisher::TimeslicePublisher(const std::string& address,
-                                       uint32_t hwm) {
+                                       uint32_t hwm,
+                                       bool multipart,
+                                       ComponentSelection selection,
+                                       uint64_t topic_modulus)
+    : multipart_(multipart), selection_(std::move(selection)),
+      topic_modulus_(topic_modulus) {
   publisher_.set(zmq::sockopt::sndhwm, int(hwm));
   publisher_.bind(address.c_str());
 }
 
+void TimeslicePublisher::send_topic(uint64_t index) {
+  std::string topic = timeslice_topic(topic_modulus_, index % topic_modulus_);
+  zmq::message_t message(topic.data(), topic.size());
+  publisher_.send(message, zmq::send_flags::sndmore);
+}
+
+std::shared_ptr<const Timeslice> TimeslicePublisher::select(
+    std::shared_ptr<const Timeslice> timeslice) const {
+  return std::make_shared<const SelectedTimeslice>(std::move(timeslice),
+                                                   selection_);
+}
+
 void TimeslicePublisher::do_put(const StorableTimeslice& timeslice) {
-  // serialize timeslice to string
-  serial_str_.clear();
-  boost::iostreams::back_insert_device<std::string> inserter(serial_str_);
-  boost::iostreams::stream<boost::iostreams::back_insert_device<std::string>> s(
-      inserter);
-  boost::archive::binary_oarchive oa(s);
-  oa << timeslice;
-  s.flush();
-
-  zmq::message_t message(serial_str_.size());
-  std::copy_n(static_cast<const char*>(serial_str_.data()), message.size(),
-              static_cast<char*>(message.data()));
+  // serialize timeslice to a string handed over to the message
+  auto serial_str = std::make_unique<std::string>();
+  serial_str->reserve(last_serial_size_);
+  {
+    boost::iostreams::back_insert_device<std::string> inserter(*serial_str);
+    boost::iostreams::stream<boost::iostreams::back_insert_device<std::string>>
+        s(inserter);
+    boost::archive::binary_oarchive oa(s);
+    oa << timeslice;
+    s.flush();
+  }
+  last_serial_size_ = serial_str->size();
+
+  std::string* str = serial_str.release();
+  zmq::message_t message(str->data(), str->size(), release_string, str);
   publisher_.send(message, zmq::send_flags::none);
 }
 
+void TimeslicePublisher::do_put_multipart(
+    std::shared_ptr<const Timeslice> timeslice) {
+  const Timeslice& ts = *timeslice;
+  const auto num_components = ts.timeslice_descriptor_.num_components;
+
+  TimesliceMultipartHeader header{multipart_timeslice_magic,
+                                  multipart_timeslice_version, 0,
+                                  ts.timeslice_descriptor_};
+  zmq::message_t header_message(&header, sizeof(header));
+  publisher_.send(header_message, num_components > 0
+                                      ? zmq::send_flags::sndmore
+                                      : zmq::send_flags::none);
+
+  for (uint64_t c = 0; c < num_components; ++c) {
+    zmq::message_t desc_message = zero_copy_message(
+        ts.desc_ptr_[c], sizeof(TimesliceComponentDescriptor), timeslice);
+    publisher_.send(desc_message, zmq::send_flags::sndmore);
+
+    const uint64_t size = ts.desc_ptr_[c]->size;
+    const uint64_t desc_size = ts.descriptors_size(c);
+    zmq::message_t data_message;
+    if (ts.content_ptr(c) == ts.data_ptr_[c] + desc_size) {
+      data_message = zero_copy_message(ts.data_ptr_[c], size, timeslice);
+    } else {
+      // the contents do not directly follow the descriptors (e.g., in a
+      // SelectedTimeslice of a time window), gather them in a copy
+      data_message.rebuild(size);
+      auto* data = static_cast<uint8_t*>(data_message.data());
+      std::copy_n(ts.data_ptr_[c], desc_size, data);
+      std::copy_n(ts.content_ptr(c), size - desc_size, data + desc_size);
+    }
+    publisher_.send(data_message, c + 1 < num_components
+                                      ? zmq::send_flags::sndmore
+                                      : zmq::send_flags::none);
+  }
+}
+
 } // namespace fles
@@ -3,8 +3,11 @@
 /// \brief Defines the fles::TimeslicePublisher class.
 #pragma once
 
+#include "ComponentSelection.hpp"
 #include "Sink.hpp"
 #include "StorableTimeslice.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <zmq.hpp>
 
@@ -13,11 +16,22 @@ namespace fles {
 /**
  * \brief The TimeslicePublisher class publishes serialized timeslice data sets
  * to a zeromq socket.
+ *
+ * In multipart mode, timeslices are sent in the format described in
+ * TimesliceMultipart.hpp. The data parts refer directly to the timeslice
+ * memory, which is kept alive until ZeroMQ has finished sending. If a
+ * component selection is given, only the selected components are sent.
+ * With a topic modulus, each timeslice is published with a topic part (see
+ * TimesliceMultipart.hpp), allowing subscribers to receive only a subset.
  */
 class TimeslicePublisher : public TimesliceSink {
 public:
   /// Construct timeslice publisher sending at given ZMQ address.
-  TimeslicePublisher(const std::string& address, uint32_t hwm = 1);
+  TimeslicePublisher(const std::string& address,
+                     uint32_t hwm = 1,
+                     bool multipart = false,
+                     ComponentSelection selection = {},
+                     uint64_t topic_modulus = 0);
 
   /// Delete copy constructor (non-copyable).
   TimeslicePublisher(const TimeslicePublisher&) = delete;
@@ -26,15 +40,33 @@ public:
 
   /// Send a timeslice to all connected subscribers.
   void put(std::shared_ptr<const fles::Timeslice> timeslice) override {
-    do_put(*timeslice);
+    if (!selection_.selects_all()) {
+      timeslice = select(std::move(timeslice));
+    }
+    if (topic_modulus_ > 0) {
+      send_topic(timeslice->index());
+    }
+    if (multipart_) {
+      do_put_multipart(std::move(timeslice));
+    } else {
+      do_put(serializable(*timeslice));
+    }
   };
 
 private:
   zmq::context_t context_{1};
   zmq::socket_t publisher_{context_, ZMQ_PUB};
-  std::string serial_str_;
+  /// Size of the previous serialized timeslice (to reserve the buffer).
+  std::size_t last_serial_size_ = 0;
+  bool multipart_;
+  ComponentSelection selection_;
+  uint64_t topic_modulus_;
 
+  void send_topic(uint64_t index);
+  std::shared_ptr<const fles::Timeslice>
+  select(std::shared_ptr<const fles::Timeslice> timeslice) const;
   void do_put(const fles::StorableTimeslice& timeslice);
+  void do_put_multipart(std::shared_ptr<const fles::Timeslice> timeslice);
 };
 
 } // namespace fles
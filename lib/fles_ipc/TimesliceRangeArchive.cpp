@@ -0,0 +1,83 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceRangeArchive.hpp"
+#include "SelectedTimeslice.hpp"
+#include "StorableTimeslice.hpp"
+#include <boost/algorithm/string/predicate.hpp>
+
+namespace fles {
+
+TimesliceRangeArchive::TimesliceRangeArchive(const std::string& filename,
+                                             uint64_t from,
+                                             uint64_t to,
+                                             ComponentSelection selection,
+                                             RangeKey key)
+    : from_(from), to_(to), selection_(std::move(selection)), key_(key) {
+  if (boost::algorithm::ends_with(filename, ".tsr")) {
+    mapped_ = std::make_unique<TimesliceMappedArchive>(filename, selection_);
+  } else {
+    archive_ = std::make_unique<TimesliceInputArchive>(filename);
+  }
+}
+
+Timeslice* TimesliceRangeArchive::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+  Timeslice* ts = mapped_ ? get_mapped() : get_archive();
+  if (ts == nullptr) {
+    eos_ = true;
+  }
+  return ts;
+}
+
+Timeslice* TimesliceRangeArchive::get_archive() {
+  if (!seeked_) {
+    seeked_ = true;
+    if (archive_->has_index()) {
+      if (key_ == RangeKey::StartTime) {
+        if (!archive_->seek_time(from_)) {
+          return nullptr;
+        }
+      } else {
+        // the index lookup is exact, read from the start if not found
+        archive_->seek(from_);
+      }
+    }
+  }
+
+  while (auto ts = archive_->get()) {
+    uint64_t key = key_of(ts->index(), ts->start_time());
+    if (key < from_) {
+      continue; // without index
+    }
+    if (key >= to_) {
+      break;
+    }
+    if (selection_.selects_all()) {
+      return ts.release();
+    }
+    return new SelectedTimeslice( // NOLINT
+        std::shared_ptr<const Timeslice>(std::move(ts)), selection_);
+  }
+  return nullptr;
+}
+
+Timeslice* TimesliceRangeArchive::get_mapped() {
+  uint64_t index = 0;
+  uint64_t start_time = 0;
+  while (mapped_->peek(index, start_time)) {
+    uint64_t key = key_of(index, start_time);
+    if (key < from_) {
+      mapped_->skip();
+      continue;
+    }
+    if (key >= to_) {
+      break;
+    }
+    return mapped_->get().release();
+  }
+  return nullptr;
+}
+
+} // namespace fles
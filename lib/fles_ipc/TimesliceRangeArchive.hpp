@@ -0,0 +1,83 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimesliceRangeArchive class.
+#pragma once
+
+#include "ComponentSelection.hpp"
+#include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
+#include "TimesliceSource.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace fles {
+
+/// The key by which a TimesliceRangeArchive selects its timeslices.
+enum class RangeKey {
+  StartTime, ///< start time of the timeslice
+  Index      ///< index of the timeslice
+};
+
+/**
+ * \brief The TimesliceRangeArchive class reads the timeslices of an archive
+ * file that start (or have an index) within a given range.
+ *
+ * If the archive has an index (see ArchiveIndex), the first timeslice of
+ * the range is located directly. Otherwise, the preceding timeslices are
+ * read and skipped. In raw archives (.tsr), preceding timeslices are
+ * skipped by their record headers, without accessing their data. Reading
+ * stops at the first timeslice at or after the end of the range, so the
+ * keys in the file are expected to be ascending.
+ *
+ * If a component selection is given, only the selected components are
+ * provided. The range refers to the complete timeslices, independent of
+ * the selection.
+ */
+class TimesliceRangeArchive : public TimesliceSource {
+public:
+  /**
+   * \brief Construct a range archive object and open the given archive file.
+   *
+   * \param filename  File name of the archive file
+   * \param from      First start time (or index) of the range
+   * \param to        End of the range (exclusive)
+   * \param selection The components to provide
+   * \param key       Whether the range refers to start times or indexes
+   */
+  TimesliceRangeArchive(const std::string& filename,
+                        uint64_t from,
+                        uint64_t to = UINT64_MAX,
+                        ComponentSelection selection = {},
+                        RangeKey key = RangeKey::StartTime);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceRangeArchive(const TimesliceRangeArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceRangeArchive&) = delete;
+
+  ~TimesliceRangeArchive() override = default;
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  Timeslice* do_get() override;
+  Timeslice* get_archive();
+  Timeslice* get_mapped();
+
+  /// Retrieve the value of the range key of a timeslice.
+  [[nodiscard]] uint64_t key_of(uint64_t index, uint64_t start_time) const {
+    return key_ == RangeKey::Index ? index : start_time;
+  }
+
+  std::unique_ptr<TimesliceInputArchive> archive_;
+  std::unique_ptr<TimesliceMappedArchive> mapped_;
+  uint64_t from_;
+  uint64_t to_;
+  ComponentSelection selection_;
+  RangeKey key_;
+  bool seeked_ = false;
+  bool eos_ = false;
+};
+
+} // namespace fles
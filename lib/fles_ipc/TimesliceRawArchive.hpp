@@ -0,0 +1,73 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the on-disk layout of raw timeslice archive files.
+#pragma once
+
+#include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceDescriptor.hpp"
+#include <cstdint>
+
+namespace fles {
+
+/**
+ * \brief The raw timeslice archive file layout.
+ *
+ * Unlike the boost-serialized archives (see OutputArchive), a raw timeslice
+ * archive stores each timeslice in the same layout as it is kept in memory,
+ * so that it can be accessed in place after mapping the file (see
+ * TimesliceMappedArchive). A file consists of a RawArchiveFileHeader
+ * followed by a sequence of records, each consisting of
+ *
+ * - a RawArchiveRecordHeader,
+ * - one TimesliceComponentDescriptor per component,
+ * - the data of each component (microslice descriptors followed by
+ *   content, as in Timeslice).
+ *
+ * All parts are aligned to raw_archive_alignment bytes. The offset field of
+ * each stored component descriptor is the offset of the component data
+ * relative to the start of its record. All values are in host byte order.
+ *
+ * In files of version raw_archive_version_dedup, the overlap microslices
+ * of a component may be stored only once, as core microslices of the
+ * following record. Such a component is stored with all microslice
+ * descriptors, but its content ends before the first deduplicated
+ * microslice, and the size field of its component descriptor is the
+ * stored size. The missing content is found in the same component of the
+ * following record, starting at the microslice with the same index.
+ */
+
+#pragma pack(1)
+
+/// The header at the beginning of a raw timeslice archive file.
+struct RawArchiveFileHeader {
+  uint64_t magic;    ///< File format identifier
+  uint32_t version;  ///< File format version
+  uint32_t reserved; ///< Reserved, always zero
+};
+
+/// The header at the beginning of each record in a raw timeslice archive.
+struct RawArchiveRecordHeader {
+  uint64_t record_size;          ///< Size (in bytes) of the padded record
+  TimesliceDescriptor ts_desc;   ///< The timeslice descriptor
+};
+
+#pragma pack()
+
+/// Magic number identifying raw timeslice archive files ("FLESTSR\0").
+constexpr uint64_t raw_archive_magic = 0x0052535453454c46;
+
+/// Current raw timeslice archive format version.
+constexpr uint32_t raw_archive_version = 1;
+
+/// Raw timeslice archive format version with deduplicated overlap.
+constexpr uint32_t raw_archive_version_dedup = 2;
+
+/// Alignment (in bytes) of all parts of a raw timeslice archive.
+constexpr uint64_t raw_archive_alignment = 64;
+
+/// Round up a size or offset to the raw archive alignment.
+constexpr uint64_t raw_archive_align(uint64_t n) {
+  return (n + raw_archive_alignment - 1) & ~(raw_archive_alignment - 1);
+}
+
+} // namespace fles
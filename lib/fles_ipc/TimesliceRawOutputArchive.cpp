@@ -0,0 +1,145 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceRawOutputArchive.hpp"
+#include "TimesliceRawArchive.hpp"
+#include "log.hpp"
+#include <cstring>
+
+namespace fles {
+
+TimesliceRawOutputArchive::TimesliceRawOutputArchive(
+    const std::string& filename, bool deduplicate_overlap, bool direct_io)
+    : filename_(filename), deduplicate_overlap_(deduplicate_overlap),
+      filebuf_(std::make_unique<OutputFileBuffer>(filename, direct_io)),
+      ostream_(filebuf_.get()), padding_(raw_archive_alignment, 0) {
+
+  // files without deduplication remain readable by version 1 readers
+  RawArchiveFileHeader header{raw_archive_magic,
+                              deduplicate_overlap_ ? raw_archive_version_dedup
+                                                   : raw_archive_version,
+                              0};
+  ostream_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  ostream_.write(padding_.data(), static_cast<std::streamsize>(
+                                       raw_archive_align(sizeof(header)) -
+                                       sizeof(header)));
+}
+
+TimesliceRawOutputArchive::~TimesliceRawOutputArchive() {
+  try {
+    end_stream();
+  } catch (std::exception& e) {
+    L_(error) << "error writing raw timeslice archive: " << e.what();
+  }
+}
+
+void TimesliceRawOutputArchive::put(std::shared_ptr<const Timeslice> item) {
+  if (!deduplicate_overlap_) {
+    do_put(*item);
+    return;
+  }
+  if (pending_) {
+    do_put(*pending_, item.get());
+  }
+  pending_ = std::move(item);
+}
+
+void TimesliceRawOutputArchive::end_stream() {
+  if (pending_) {
+    auto ts = std::move(pending_);
+    do_put(*ts);
+  }
+  if (filebuf_) {
+    auto filebuf = std::move(filebuf_);
+    ostream_.rdbuf(nullptr);
+    filebuf->close();
+  }
+}
+
+uint64_t TimesliceRawOutputArchive::duplicate_overlap(const Timeslice& ts,
+                                                      const Timeslice& next,
+                                                      uint64_t component) {
+  if (next.index() != ts.index() + 1 ||
+      component >= next.num_components()) {
+    return 0;
+  }
+  uint64_t core = ts.num_core_microslices();
+  uint64_t num = ts.num_microslices(component);
+  if (num <= core) {
+    return 0;
+  }
+  // the overlap has to be stored as core microslices of the next timeslice
+  uint64_t overlap = num - core;
+  if (overlap > next.num_core_microslices() ||
+      overlap > next.num_microslices(component)) {
+    return 0;
+  }
+  ComponentView a = ts.component(component);
+  ComponentView b = next.component(component);
+  for (uint64_t m = 0; m < overlap; ++m) {
+    const MicrosliceDescriptor& da = a.descriptor(core + m);
+    const MicrosliceDescriptor& db = b.descriptor(m);
+    if (da.idx != db.idx || da.size != db.size || da.eq_id != db.eq_id ||
+        da.sys_id != db.sys_id || da.flags != db.flags ||
+        std::memcmp(a.content(core + m), b.content(m), da.size) != 0) {
+      return 0;
+    }
+  }
+  return overlap;
+}
+
+void TimesliceRawOutputArchive::do_put(const Timeslice& ts,
+                                       const Timeslice* next) {
+  const auto num_components = ts.timeslice_descriptor_.num_components;
+
+  // compute layout of this record
+  uint64_t desc_offset = raw_archive_align(sizeof(RawArchiveRecordHeader));
+  uint64_t data_offset = raw_archive_align(
+      desc_offset + num_components * sizeof(TimesliceComponentDescriptor));
+
+  std::vector<TimesliceComponentDescriptor> desc(num_components);
+  uint64_t offset = data_offset;
+  for (std::size_t c = 0; c < num_components; ++c) {
+    desc[c] = *ts.desc_ptr_[c];
+    desc[c].offset = offset;
+    uint64_t duplicates =
+        next != nullptr ? duplicate_overlap(ts, *next, c) : 0;
+    if (duplicates != 0) {
+      // store the content up to the first duplicate microslice only
+      uint64_t first = desc[c].num_microslices - duplicates;
+      desc[c].size =
+          desc[c].num_microslices * sizeof(MicrosliceDescriptor) +
+          (ts.descriptor(c, first).offset - ts.descriptor(c, 0).offset);
+    }
+    offset = raw_archive_align(offset + desc[c].size);
+  }
+
+  RawArchiveRecordHeader header{offset, ts.timeslice_descriptor_};
+
+  auto write_padded = [this](const void* data, uint64_t size) {
+    ostream_.write(static_cast<const char*>(data),
+                    static_cast<std::streamsize>(size));
+    ostream_.write(padding_.data(), static_cast<std::streamsize>(
+                                         raw_archive_align(size) - size));
+  };
+
+  write_padded(&header, sizeof(header));
+  write_padded(desc.data(),
+               num_components * sizeof(TimesliceComponentDescriptor));
+  for (std::size_t c = 0; c < num_components; ++c) {
+    // the contents may not directly follow the descriptors
+    uint64_t desc_size = ts.descriptors_size(c);
+    ostream_.write(reinterpret_cast<const char*>(ts.data_ptr_[c]),
+                    static_cast<std::streamsize>(desc_size));
+    ostream_.write(reinterpret_cast<const char*>(ts.content_ptr(c)),
+                    static_cast<std::streamsize>(desc[c].size - desc_size));
+    ostream_.write(padding_.data(),
+                    static_cast<std::streamsize>(
+                        raw_archive_align(desc[c].size) - desc[c].size));
+  }
+
+  if (!ostream_) {
+    throw std::ios_base::failure("error writing file \"" + filename_ + "\"");
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,71 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimesliceRawOutputArchive class.
+#pragma once
+
+#include "OutputFileBuffer.hpp"
+#include "Sink.hpp"
+#include "Timeslice.hpp"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceRawOutputArchive class writes timeslices to an output
+ * file in the raw, directly mappable layout (see TimesliceRawArchive.hpp).
+ *
+ * With overlap deduplication, the overlap microslices of a timeslice are
+ * not stored if they are identical to the core microslices at the start of
+ * the directly following timeslice. Each timeslice is then written when
+ * the next one arrives or the stream ends.
+ */
+class TimesliceRawOutputArchive : public Sink<Timeslice> {
+public:
+  /**
+   * \brief Construct a raw output archive object, open the given file for
+   * writing, and write the file header.
+   *
+   * \param filename            File name of the archive file
+   * \param deduplicate_overlap Store overlap microslices only once
+   * \param direct_io           Bypass the page cache (see OutputFileBuffer)
+   */
+  explicit TimesliceRawOutputArchive(const std::string& filename,
+                                     bool deduplicate_overlap = false,
+                                     bool direct_io = false);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceRawOutputArchive(const TimesliceRawOutputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceRawOutputArchive&) = delete;
+
+  ~TimesliceRawOutputArchive() override;
+
+  /// Store a timeslice.
+  void put(std::shared_ptr<const Timeslice> item) override;
+
+  void end_stream() override;
+
+private:
+  /// Write the record of a timeslice, deduplicating its overlap with the
+  /// following timeslice (if given).
+  void do_put(const Timeslice& ts, const Timeslice* next = nullptr);
+
+  /// Number of trailing microslices of a component that are identical to
+  /// core microslices at the start of the following timeslice.
+  static uint64_t duplicate_overlap(const Timeslice& ts,
+                                    const Timeslice& next,
+                                    uint64_t component);
+
+  std::string filename_;
+  bool deduplicate_overlap_;
+  /// The timeslice waiting for its successor (with deduplication).
+  std::shared_ptr<const Timeslice> pending_;
+  std::unique_ptr<OutputFileBuffer> filebuf_;
+  std::ostream ostream_;
+  std::vector<char> padding_;
+};
+
+} // namespace fles
@@ -2,65 +2,120 @@
 
 #include "TimesliceReceiver.hpp"
 #include "TimesliceShmWorkItem.hpp"
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/uuid/nil_generator.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <memory>
 
-namespace bi = boost::interprocess;
-
 namespace fles {
 
 TimesliceReceiver::TimesliceReceiver(const std::string& ipc_identifier,
-                                     WorkerParameters parameters)
-    : worker_("ipc://@" + ipc_identifier, parameters) {
-  worker_.set_disconnect_callback([this] { managed_shm_ = nullptr; });
+                                     WorkerParameters parameters,
+                                     bool component_items)
+    : shm_identifier_(ipc_identifier),
+      worker_("ipc://@" + ipc_identifier +
+                  (component_items ? component_items_suffix : ""),
+              parameters) {
+  if (parameters.queue_policy == WorkerQueuePolicy::QueueAll ||
+      parameters.queue_policy == WorkerQueuePolicy::Balanced) {
+    prefetch_depth_ = std::max<size_t>(parameters.prefetch, 1);
+  }
+  usage_ = parameters.usage;
+  worker_.set_disconnect_callback([this] {
+    // the completions of prefetched items are discarded by the worker, the
+    // shared memory stays attached unless replaced
+    prefetched_.clear();
+  });
 }
 
 TimesliceView* TimesliceReceiver::do_get() {
   if (eos_) {
     return nullptr;
   }
+  relocate_views();
 
-  while (true) {
-    auto item = worker_.get();
+  // sends the pending completions, too
+  if (prefetch_depth_ > 1) {
+    fill_prefetch_window();
+  }
 
-    fles::TimesliceShmWorkItem timeslice_item;
-    std::istringstream istream(item->payload());
-    {
-      boost::archive::binary_iarchive iarchive(istream);
-      iarchive >> timeslice_item;
+  while (prefetched_.empty()) {
+    auto item = worker_.get();
+    if (!item) {
+      return nullptr;
     }
-
-    // connect to matching shared memory if not already connected
-    if (managed_shm_uuid() != timeslice_item.shm_uuid) {
-      managed_shm_ =
-          std::make_unique<boost::interprocess::managed_shared_memory>(
-              boost::interprocess::open_only,
-              timeslice_item.shm_identifier.c_str());
-      std::cout << "TimesliceReceiver: opened shared memory "
-                << timeslice_item.shm_identifier << " {" << managed_shm_uuid()
-                << "}" << std::endl;
-      if (managed_shm_uuid() != timeslice_item.shm_uuid) {
-        std::cerr
-            << "TimesliceView: discarding item due to shm uuid mismatch (shm: "
-            << managed_shm_uuid() << ", ts_item: " << timeslice_item.shm_uuid
-            << ")" << std::endl;
-        continue;
-      }
+    if (auto* view = create_view(std::move(item))) {
+      prefetched_.emplace_back(view);
     }
+  }
 
-    return new TimesliceView(managed_shm_, item, timeslice_item);
+  TimesliceView* view = prefetched_.front().release();
+  prefetched_.pop_front();
+  if (usage_) {
+    // a prefetched item counts as waiting until handed out
+    view->work_item_->set_retrieval(std::chrono::steady_clock::now());
+  }
+  // timeslices may have been evicted while waiting
+  relocate_views();
+  return view;
+}
+
+void TimesliceReceiver::relocate_views() {
+  if (eviction_table_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(views_->mutex);
+  for (TimesliceView* view : views_->views) {
+    view->relocate();
   }
 }
 
-boost::uuids::uuid TimesliceReceiver::managed_shm_uuid() const {
-  if (!managed_shm_) {
-    return boost::uuids::nil_uuid();
+void TimesliceReceiver::fill_prefetch_window() {
+  while (prefetched_.size() < prefetch_depth_) {
+    auto item = worker_.try_get();
+    if (!item) {
+      return;
+    }
+    if (auto* view = create_view(std::move(item))) {
+      prefetched_.emplace_back(view);
+    }
+  }
+}
+
+TimesliceView*
+TimesliceReceiver::create_view(std::shared_ptr<const Item> item) {
+  auto timeslice_item = fles::TimesliceShmWorkItem::decode(item->payload());
+
+  // attach the matching shared memory if not already attached
+  if (!attachment_ || attachment_->uuid() != timeslice_item.shm_uuid) {
+    attachment_ = ShmAttachmentCache::instance().attach(
+        shm_identifier_, timeslice_item.shm_uuid);
+    if (!attachment_) {
+      std::cerr << "TimesliceView: discarding item due to shm uuid mismatch "
+                   "(ts_item: "
+                << timeslice_item.shm_uuid << ")" << std::endl;
+      eviction_table_ = nullptr;
+      return nullptr;
+    }
+    eviction_table_ =
+        attachment_->shm(attachment_)
+            ->find<EvictionTable>(eviction_table_name(shm_identifier_).c_str())
+            .first;
+  }
+
+  // the data buffer of the shared memory may be located on a device
+  std::shared_ptr<DeviceMemory> device_data;
+  if (timeslice_item.data_device >= 0) {
+    device_data = attachment_->device_data(timeslice_item.data_device,
+                                           timeslice_item.data_device_handle);
+  }
+  auto* view =
+      new TimesliceView(attachment_->shm(attachment_), std::move(item),
+                        std::move(timeslice_item), std::move(device_data));
+  if (eviction_table_ != nullptr) {
+    view->set_evictable(views_, eviction_table_);
   }
-  auto shm_uuid =
-      managed_shm_->find<boost::uuids::uuid>(bi::unique_instance).first;
-  assert(shm_uuid != nullptr);
-  return *shm_uuid;
+  return view;
 }
 
 } // namespace fles
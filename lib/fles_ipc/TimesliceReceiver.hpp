@@ -5,11 +5,12 @@
 
 #include "ItemWorker.hpp"
 #include "ItemWorkerProtocol.hpp"
+#include "ShmAttachmentCache.hpp"
 #include "System.hpp"
 #include "TimesliceSource.hpp"
 #include "TimesliceView.hpp"
-#include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/uuid/uuid.hpp>
+#include <cstddef>
+#include <deque>
 #include <memory>
 #include <string>
 
@@ -18,12 +19,38 @@ namespace fles {
 /**
  * \brief The TimesliceReceiver class implements the IPC mechanisms to receive a
  * timeslice.
+ *
+ * With a prefetch depth (WorkerParameters::prefetch) greater than one, the
+ * distributor sends up to that many items ahead (QueueAll and Balanced
+ * policies). The receiver decodes the items that have already arrived and
+ * maps their shared memory ahead of use. The completion of an item is
+ * queued when its TimesliceView is destroyed, in any thread, and sent with
+ * the next request, so that the distributor keeps the window filled.
+ *
+ * The shared memory is attached through the process-wide
+ * ShmAttachmentCache, so receivers of the same buffer share its mapping.
+ *
+ * Optionally, the receiver registers for the work items of individual
+ * components, which are announced as soon as they have been written (see
+ * component_items_suffix). Each of them is received as a timeslice with a
+ * single component.
+ *
+ * With WorkerParameters::usage, the time each timeslice waited before it was
+ * handed out by get(), the time it was held until its view was destroyed,
+ * and the time spent blocking in get() are reported to the distributor.
+ *
+ * If the timeslice buffer evicts timeslices held for too long, the views
+ * handed out by the receiver are switched to the copies of their
+ * timeslices on each call to get(). As the buffer space of an evicted
+ * timeslice is released after a second timeout at the latest, a view that
+ * is still accessed then must not be used concurrently with get().
  */
 class TimesliceReceiver : public TimesliceSource {
 public:
   /// Construct timeslice receiver connected to a given shared memory.
   explicit TimesliceReceiver(const std::string& ipc_identifier,
-                             WorkerParameters parameters);
+                             WorkerParameters parameters,
+                             bool component_items = false);
 
   /// Delete copy constructor (non-copyable).
   TimesliceReceiver(const TimesliceReceiver&) = delete;
@@ -48,13 +75,38 @@ public:
 private:
   TimesliceView* do_get() override;
 
-  std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
+  /// Create the view of a received item, or nullptr if discarded.
+  TimesliceView* create_view(std::shared_ptr<const Item> item);
 
-  [[nodiscard]] boost::uuids::uuid managed_shm_uuid() const;
+  /// Decode the items already received up to the prefetch depth.
+  void fill_prefetch_window();
+
+  /// Switch the live views of evicted timeslices to their copies.
+  void relocate_views();
+
+  /// The attachment of the current shared memory segment.
+  std::shared_ptr<ShmAttachment> attachment_;
+
+  /// The eviction table of the current shared memory (if any).
+  EvictionTable* eviction_table_ = nullptr;
+
+  /// The views handed out or prefetched that are still alive.
+  std::shared_ptr<EvictableViews> views_ =
+      std::make_shared<EvictableViews>();
+
+  /// The identifier of the shared memory, identical to the IPC identifier.
+  std::string shm_identifier_;
 
   /// The end-of-stream flag.
   bool eos_ = false;
 
+  /// The maximum number of items decoded ahead.
+  size_t prefetch_depth_ = 1;
+  bool usage_ = false;
+
+  /// The decoded items not yet handed out.
+  std::deque<std::unique_ptr<TimesliceView>> prefetched_;
+
   // The respective item worker object
   ItemWorker worker_;
 };
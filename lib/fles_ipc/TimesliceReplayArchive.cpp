@@ -0,0 +1,221 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceReplayArchive.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceDescriptor.hpp"
+#include "TimesliceInputArchive.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace fles {
+
+namespace {
+
+constexpr uint64_t arena_alignment = 16;
+
+uint64_t arena_align(uint64_t size) {
+  return (size + arena_alignment - 1) & ~(arena_alignment - 1);
+}
+
+/// The part of the archive covered by n equidistant values from first to
+/// last, each extending to the next.
+uint64_t extent(uint64_t first, uint64_t last, uint64_t n) {
+  return n > 1 ? (last - first) + (last - first) / (n - 1) : 0;
+}
+
+// Layout of a record: timeslice descriptor, component descriptors, and the
+// data of each component (microslice descriptors followed by contents). The
+// component descriptor offsets are relative to the start of the record.
+
+TimesliceDescriptor* record_ts_desc(uint8_t* record) {
+  return reinterpret_cast<TimesliceDescriptor*>(record);
+}
+
+TimesliceComponentDescriptor* record_desc(uint8_t* record) {
+  return reinterpret_cast<TimesliceComponentDescriptor*>(
+      record + arena_align(sizeof(TimesliceDescriptor)));
+}
+
+MicrosliceDescriptor* record_ms_desc(uint8_t* record, uint64_t component) {
+  return reinterpret_cast<MicrosliceDescriptor*>(
+      record + record_desc(record)[component].offset);
+}
+
+} // namespace
+
+/// The memory holding the records of all timeslices of an archive.
+struct ReplayedTimeslice::Arena {
+  std::vector<uint8_t> data;
+  /// Offsets of the records in data
+  std::vector<uint64_t> offsets;
+  /// Number of timeslices referring to each record
+  std::unique_ptr<std::atomic<uint32_t>[]> users;
+  /// Number of cycles each record has been shifted by (continuous mode)
+  std::vector<uint64_t> shifted;
+
+  [[nodiscard]] uint8_t* record(uint64_t r) { return data.data() + offsets[r]; }
+
+  [[nodiscard]] uint64_t record_size(uint64_t r) const {
+    return (r + 1 < offsets.size() ? offsets[r + 1] : data.size()) -
+           offsets[r];
+  }
+
+  /// Append a record holding the data of a given timeslice.
+  void append(const TimesliceDescriptor& ts_desc,
+              const std::vector<TimesliceComponentDescriptor*>& desc,
+              const std::vector<uint8_t*>& data_ptr) {
+    uint64_t size = arena_align(sizeof(TimesliceDescriptor)) +
+                    arena_align(ts_desc.num_components *
+                                sizeof(TimesliceComponentDescriptor));
+    const uint64_t header_size = size;
+    for (uint32_t c = 0; c < ts_desc.num_components; ++c) {
+      size += arena_align(desc[c]->size);
+    }
+
+    const uint64_t offset = data.size();
+    offsets.push_back(offset);
+    data.resize(offset + size);
+    uint8_t* record = data.data() + offset;
+    *record_ts_desc(record) = ts_desc;
+    uint64_t pos = header_size;
+    for (uint32_t c = 0; c < ts_desc.num_components; ++c) {
+      TimesliceComponentDescriptor& d = record_desc(record)[c];
+      d = *desc[c];
+      d.offset = pos;
+      std::copy_n(data_ptr[c], d.size, record + pos);
+      pos += arena_align(d.size);
+    }
+  }
+};
+
+ReplayedTimeslice::ReplayedTimeslice(std::shared_ptr<Arena> arena,
+                                     uint64_t record,
+                                     std::vector<uint8_t> copy)
+    : arena_(std::move(arena)), record_(record), copy_(std::move(copy)) {
+  uint8_t* base = arena_->record(record_);
+  if (copy_.empty()) {
+    arena_->users[record_].fetch_add(1, std::memory_order_relaxed);
+  } else {
+    base = copy_.data();
+  }
+  timeslice_descriptor_ = *record_ts_desc(base);
+  TimesliceComponentDescriptor* desc = record_desc(base);
+  for (uint32_t c = 0; c < timeslice_descriptor_.num_components; ++c) {
+    desc_ptr_.push_back(&desc[c]);
+    data_ptr_.push_back(base + desc[c].offset);
+  }
+}
+
+ReplayedTimeslice::~ReplayedTimeslice() {
+  if (copy_.empty()) {
+    // the record may be rewritten once released
+    arena_->users[record_].fetch_sub(1, std::memory_order_release);
+  }
+}
+
+TimesliceReplayArchive::TimesliceReplayArchive(const std::string& filename,
+                                               uint64_t cycles,
+                                               bool continuous)
+    : arena_(std::make_shared<ReplayedTimeslice::Arena>()), cycles_(cycles),
+      continuous_(continuous) {
+  TimesliceInputArchive source(filename);
+  while (auto ts = source.get()) {
+    arena_->append(ts->timeslice_descriptor_, ts->desc_ptr_, ts->data_ptr_);
+  }
+  arena_->data.shrink_to_fit();
+
+  const uint64_t n = arena_->offsets.size();
+  arena_->users = std::make_unique<std::atomic<uint32_t>[]>(n);
+  arena_->shifted.assign(n, 0);
+  if (n == 0) {
+    return;
+  }
+
+  // the extent of the archive, extrapolating the distance between the
+  // timeslices (or between the core microslices of a single timeslice)
+  uint8_t* first = arena_->record(0);
+  uint8_t* last = arena_->record(n - 1);
+  auto start_time = [](uint8_t* record) -> uint64_t {
+    const TimesliceDescriptor* ts_desc = record_ts_desc(record);
+    if (ts_desc->num_components == 0 ||
+        record_desc(record)[0].num_microslices == 0) {
+      return 0;
+    }
+    return record_ms_desc(record, 0)[0].idx;
+  };
+  if (n > 1) {
+    index_span_ = extent(record_ts_desc(first)->index,
+                         record_ts_desc(last)->index, n);
+    ts_pos_span_ = extent(record_ts_desc(first)->ts_pos,
+                          record_ts_desc(last)->ts_pos, n);
+    idx_span_ = extent(start_time(first), start_time(last), n);
+  } else {
+    index_span_ = 1;
+    ts_pos_span_ = 1;
+    const TimesliceDescriptor* ts_desc = record_ts_desc(first);
+    if (ts_desc->num_components != 0) {
+      const uint64_t core = std::min<uint64_t>(
+          ts_desc->num_core_microslices, record_desc(first)[0].num_microslices);
+      if (core != 0) {
+        const MicrosliceDescriptor* ms = record_ms_desc(first, 0);
+        idx_span_ = extent(ms[0].idx, ms[core - 1].idx, core);
+      }
+    }
+  }
+}
+
+uint64_t TimesliceReplayArchive::size() const {
+  return arena_->offsets.size();
+}
+
+uint64_t TimesliceReplayArchive::memory_size() const {
+  return arena_->data.size();
+}
+
+ReplayedTimeslice* TimesliceReplayArchive::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+  if (record_ == arena_->offsets.size()) {
+    record_ = 0;
+    ++cycle_;
+  }
+  if (cycle_ >= cycles_ || arena_->offsets.empty()) {
+    eos_ = true;
+    return nullptr;
+  }
+
+  const uint64_t r = record_++;
+  if (!continuous_ || arena_->shifted[r] == cycle_) {
+    return new ReplayedTimeslice(arena_, r); // NOLINT
+  }
+  uint8_t* record = arena_->record(r);
+  const uint64_t cycles = cycle_ - arena_->shifted[r];
+  if (arena_->users[r].load(std::memory_order_acquire) == 0) {
+    shift(record, cycles);
+    arena_->shifted[r] = cycle_;
+    return new ReplayedTimeslice(arena_, r); // NOLINT
+  }
+  // a timeslice from a previous cycle still refers to the record
+  std::vector<uint8_t> copy(record, record + arena_->record_size(r));
+  shift(copy.data(), cycles);
+  return new ReplayedTimeslice(arena_, r, std::move(copy)); // NOLINT
+}
+
+void TimesliceReplayArchive::shift(uint8_t* record, uint64_t cycles) const {
+  TimesliceDescriptor* ts_desc = record_ts_desc(record);
+  ts_desc->index += cycles * index_span_;
+  ts_desc->ts_pos += cycles * ts_pos_span_;
+  for (uint32_t c = 0; c < ts_desc->num_components; ++c) {
+    TimesliceComponentDescriptor& desc = record_desc(record)[c];
+    desc.ts_num += cycles * index_span_;
+    MicrosliceDescriptor* ms = record_ms_desc(record, c);
+    for (uint64_t m = 0; m < desc.num_microslices; ++m) {
+      ms[m].idx += cycles * idx_span_;
+    }
+  }
+}
+
+} // namespace fles
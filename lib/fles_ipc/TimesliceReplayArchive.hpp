@@ -0,0 +1,118 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimesliceReplayArchive class.
+#pragma once
+
+#include "Timeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The ReplayedTimeslice class provides access to a timeslice held in
+ * the memory of a TimesliceReplayArchive.
+ */
+class ReplayedTimeslice : public Timeslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  ReplayedTimeslice(const ReplayedTimeslice&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ReplayedTimeslice&) = delete;
+
+  ~ReplayedTimeslice() override;
+
+private:
+  friend class TimesliceReplayArchive;
+
+  struct Arena;
+
+  /// Construct a timeslice referring to a record of the arena, or to a
+  /// private copy of it if given.
+  ReplayedTimeslice(std::shared_ptr<Arena> arena,
+                    uint64_t record,
+                    std::vector<uint8_t> copy = {});
+
+  /// The arena this timeslice refers to, kept alive as long as needed.
+  std::shared_ptr<Arena> arena_;
+  uint64_t record_;
+
+  /// A private copy of the record (if the arena could not be rewritten).
+  std::vector<uint8_t> copy_;
+};
+
+/**
+ * \brief The TimesliceReplayArchive class loads a timeslice archive file into
+ * memory once and replays it a given number of times.
+ *
+ * All timeslices are read and deserialized when the object is constructed
+ * and stored back to back in a single memory arena. The returned
+ * timeslices refer to the arena without copying, so the replay rate is not
+ * limited by deserialization.
+ *
+ * In continuous mode, the timeslice index and position, the timeslice
+ * number of the components, and the microslice index (start time) are
+ * shifted in each cycle by the extent of the archive, so that the cycles
+ * appear as a single continuous run. The records are rewritten in place,
+ * or copied if a timeslice from the previous cycle is still in use.
+ */
+class TimesliceReplayArchive : public TimesliceSource {
+public:
+  /**
+   * \brief Construct a replay archive object and load the given timeslice
+   * archive file.
+   *
+   * \param filename   File name of the archive file
+   * \param cycles     Number of times to replay the archive
+   * \param continuous Rewrite the indexes to form a continuous run
+   */
+  explicit TimesliceReplayArchive(const std::string& filename,
+                                  uint64_t cycles = 1,
+                                  bool continuous = false);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceReplayArchive(const TimesliceReplayArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceReplayArchive&) = delete;
+
+  ~TimesliceReplayArchive() override = default;
+
+  /// Retrieve the next timeslice.
+  std::unique_ptr<ReplayedTimeslice> get() {
+    return std::unique_ptr<ReplayedTimeslice>(do_get());
+  };
+
+  /// Retrieve the number of timeslices in the archive.
+  [[nodiscard]] uint64_t size() const;
+
+  /// Retrieve the size of the memory arena in bytes.
+  [[nodiscard]] uint64_t memory_size() const;
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  ReplayedTimeslice* do_get() override;
+
+  /// Shift the indexes of a record by a given number of cycles.
+  void shift(uint8_t* record, uint64_t cycles) const;
+
+  std::shared_ptr<ReplayedTimeslice::Arena> arena_;
+  uint64_t cycles_;
+  bool continuous_;
+
+  /// The extent of the archive in timeslice indexes and positions and in
+  /// microslice indexes.
+  uint64_t index_span_ = 0;
+  uint64_t ts_pos_span_ = 0;
+  uint64_t idx_span_ = 0;
+
+  uint64_t cycle_ = 0;
+  uint64_t record_ = 0;
+  bool eos_ = false;
+};
+
+} // namespace fles
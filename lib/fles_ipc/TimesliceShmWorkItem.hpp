@@ -1,17 +1,16 @@
 // Copyright 2020 Jan de Cuveland <cmail@cuveland.de>
 /// \file
-/// \brief Defines the fles::TimesliceShmWorkItem serializable struct.
+/// \brief Defines the fles::TimesliceShmWorkItem struct.
 #pragma once
 
+#include "DeviceMemory.hpp"
 #include "TimesliceDescriptor.hpp"
-#include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/serialization/access.hpp>
-#include <boost/serialization/string.hpp>
-#include <boost/serialization/vector.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
-#include <boost/uuid/uuid_serialize.hpp>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -19,41 +18,149 @@ namespace fles {
 
 #pragma pack(1)
 
+/// Version of the binary TimesliceShmWorkItem encoding.
+constexpr uint32_t timeslice_shm_work_item_version = 2;
+
+/**
+ * \brief Suffix of the IPC identifier of the component work items.
+ *
+ * If enabled, a timeslice buffer additionally announces each component as
+ * soon as it has been written, as a work item of a single component. Its
+ * item ID is ts_pos * num_components + component, so a worker registering
+ * with stride num_components and offset c receives component c of each
+ * timeslice.
+ */
+constexpr const char* component_items_suffix = "/components";
+
+/// Fixed-size leading part of an encoded TimesliceShmWorkItem.
+struct TimesliceShmWorkItemHeader {
+  /// The encoding version
+  uint32_t version;
+  /// The UUID of the containing managed shared memory
+  boost::uuids::uuid shm_uuid;
+  /// The timeslice descriptor
+  TimesliceDescriptor ts_desc;
+  /// The handle of the data buffer base
+  int64_t data_base;
+  /// The handle of the tsc descriptor buffer base
+  int64_t desc_base;
+  /// The device holding the data buffer (-1: host shared memory)
+  int32_t data_device;
+  /// The handle of the data buffer on the device
+  DeviceMemoryHandle data_device_handle;
+};
+
+/// Per-component part of an encoded TimesliceShmWorkItem.
+struct TimesliceShmWorkItemComponent {
+  /// The offset (in bytes) of the data block relative to the data base
+  uint64_t data;
+  /// The offset (in descriptors) of the tsc descriptor relative to the
+  /// descriptor base
+  uint64_t desc;
+};
+
+#pragma pack()
+
 /**
  * \brief %Timeslice shared memory work item struct.
+ *
+ * The work item is sent as a fixed-layout binary encoding: a
+ * TimesliceShmWorkItemHeader followed by one TimesliceShmWorkItemComponent
+ * per component. The identifier of the shared memory is not part of the
+ * item, it is known to the receiver from its registration address.
+ *
+ * If the data buffer is located in GPU memory, the data offsets are
+ * relative to the device memory region given by data_device_handle
+ * instead of data_base.
  */
 struct TimesliceShmWorkItem {
   /// The UUID of the containing managed shared memory
   boost::uuids::uuid shm_uuid{};
-  /// The identifier string of the containing managed shared memory
-  std::string shm_identifier;
   /// The timeslice descriptor
   TimesliceDescriptor ts_desc{};
-  /// A vector of handles to the data blocks
-  std::vector<std::ptrdiff_t> data;
-  /// A vector of handles to the tsc descriptor blocks
-  std::vector<std::ptrdiff_t> desc;
-
-  friend class boost::serialization::access;
-  /// Provide boost serialization access.
-  template <class Archive>
-  void serialize(Archive& ar, const unsigned int /* version */) {
-    ar& shm_uuid;
-    ar& shm_identifier;
-    ar& ts_desc;
-    ar& data;
-    ar& desc;
+  /// The handle of the data buffer base
+  std::ptrdiff_t data_base = 0;
+  /// The handle of the tsc descriptor buffer base
+  std::ptrdiff_t desc_base = 0;
+  /// The device holding the data buffer (-1: host shared memory)
+  int32_t data_device = -1;
+  /// The handle of the data buffer on the device
+  DeviceMemoryHandle data_device_handle{};
+  /// A vector of data block offsets (in bytes) relative to data_base
+  std::vector<uint64_t> data;
+  /// A vector of tsc descriptor offsets (in descriptors) relative to
+  /// desc_base
+  std::vector<uint64_t> desc;
+
+  /// Encode the work item into a given buffer.
+  void encode(std::string& buffer) const {
+    TimesliceShmWorkItemHeader header{};
+    header.version = timeslice_shm_work_item_version;
+    header.shm_uuid = shm_uuid;
+    header.ts_desc = ts_desc;
+    header.data_base = data_base;
+    header.desc_base = desc_base;
+    header.data_device = data_device;
+    header.data_device_handle = data_device_handle;
+
+    const std::size_t num_components = ts_desc.num_components;
+    buffer.resize(sizeof(header) +
+                  num_components * sizeof(TimesliceShmWorkItemComponent));
+    char* p = buffer.data();
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    for (std::size_t c = 0; c < num_components; ++c) {
+      TimesliceShmWorkItemComponent component{data.at(c), desc.at(c)};
+      std::memcpy(p, &component, sizeof(component));
+      p += sizeof(component);
+    }
+  }
+
+  /// Decode a work item from a given buffer.
+  static TimesliceShmWorkItem decode(const std::string& buffer) {
+    TimesliceShmWorkItemHeader header{};
+    if (buffer.size() < sizeof(header)) {
+      throw std::runtime_error("TimesliceShmWorkItem: truncated item");
+    }
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (header.version != timeslice_shm_work_item_version) {
+      throw std::runtime_error(
+          "TimesliceShmWorkItem: unsupported encoding version " +
+          std::to_string(header.version));
+    }
+    const std::size_t num_components = header.ts_desc.num_components;
+    if (buffer.size() !=
+        sizeof(header) +
+            num_components * sizeof(TimesliceShmWorkItemComponent)) {
+      throw std::runtime_error("TimesliceShmWorkItem: invalid item size");
+    }
+
+    TimesliceShmWorkItem item;
+    item.shm_uuid = header.shm_uuid;
+    item.ts_desc = header.ts_desc;
+    item.data_base = header.data_base;
+    item.desc_base = header.desc_base;
+    item.data_device = header.data_device;
+    item.data_device_handle = header.data_device_handle;
+    item.data.resize(num_components);
+    item.desc.resize(num_components);
+    const char* p = buffer.data() + sizeof(header);
+    for (std::size_t c = 0; c < num_components; ++c) {
+      TimesliceShmWorkItemComponent component{};
+      std::memcpy(&component, p, sizeof(component));
+      p += sizeof(component);
+      item.data[c] = component.data;
+      item.desc[c] = component.desc;
+    }
+    return item;
   }
 
   /// Dump contents (for debugging).
   friend std::ostream& operator<<(std::ostream& os,
                                   const TimesliceShmWorkItem& i) {
     return os << "TimesliceShmWorkItem(shm_uuid=" << i.shm_uuid
-              << ", shm_identifier=" << i.shm_identifier
               << ", ts_desc=" << i.ts_desc << ", data=..., desc=...)";
   }
 };
 
-#pragma pack()
-
 } // namespace fles
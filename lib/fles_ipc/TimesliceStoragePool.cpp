@@ -0,0 +1,65 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "TimesliceStoragePool.hpp"
+#include <algorithm>
+
+namespace fles {
+
+namespace {
+
+bool less_capacity(const std::vector<uint8_t>& a,
+                   const std::vector<uint8_t>& b) {
+  return a.capacity() < b.capacity();
+}
+
+} // namespace
+
+std::vector<uint8_t> TimesliceStoragePool::acquire(size_t capacity) {
+  std::vector<uint8_t> buffer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the smallest buffer that is large enough
+    auto it = std::lower_bound(free_.begin(), free_.end(), capacity,
+                               [](const std::vector<uint8_t>& b, size_t c) {
+                                 return b.capacity() < c;
+                               });
+    if (it != free_.end()) {
+      buffer = std::move(*it);
+      free_.erase(it);
+      free_bytes_ -= buffer.capacity();
+      ++reused_;
+      return buffer;
+    }
+    ++allocated_;
+  }
+  buffer.reserve(capacity);
+  return buffer;
+}
+
+void TimesliceStoragePool::release(std::vector<uint8_t>&& buffer) {
+  if (buffer.capacity() == 0) {
+    return;
+  }
+  buffer.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_.size() >= max_buffers_ ||
+      free_bytes_ + buffer.capacity() > max_bytes_) {
+    return;
+  }
+  free_bytes_ += buffer.capacity();
+  auto it =
+      std::upper_bound(free_.begin(), free_.end(), buffer, less_capacity);
+  free_.insert(it, std::move(buffer));
+}
+
+TimesliceStoragePool::Statistics TimesliceStoragePool::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Statistics s;
+  s.reused = reused_;
+  s.allocated = allocated_;
+  s.buffers = free_.size();
+  s.bytes = free_bytes_;
+  return s;
+}
+
+} // namespace fles
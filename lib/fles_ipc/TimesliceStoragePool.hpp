@@ -0,0 +1,69 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::TimesliceStoragePool class.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceStoragePool class recycles the component buffers of
+ * StorableTimeslice objects.
+ *
+ * The buffers of destroyed timeslices are kept, up to a given number and
+ * total size, and handed out again. Sources and filters building a stream
+ * of timeslices of a similar size then reuse their memory instead of
+ * allocating (and page-faulting) fresh buffers for every timeslice. The
+ * pool may be shared between threads.
+ */
+class TimesliceStoragePool {
+public:
+  /// Usage statistics of the pool.
+  struct Statistics {
+    uint64_t reused = 0;    ///< number of buffers handed out again
+    uint64_t allocated = 0; ///< number of buffers newly allocated
+    size_t buffers = 0;     ///< number of buffers currently kept
+    size_t bytes = 0;       ///< capacity of the buffers currently kept
+  };
+
+  /**
+   * \brief Construct an empty pool.
+   *
+   * \param max_buffers maximum number of buffers kept
+   * \param max_bytes   maximum total capacity of the buffers kept
+   */
+  explicit TimesliceStoragePool(size_t max_buffers = 256,
+                                size_t max_bytes = size_t{1} << 30)
+      : max_buffers_(max_buffers), max_bytes_(max_bytes) {}
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceStoragePool(const TimesliceStoragePool&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceStoragePool&) = delete;
+
+  /// Retrieve an empty buffer of at least the given capacity.
+  std::vector<uint8_t> acquire(size_t capacity);
+
+  /// Return a buffer to the pool.
+  void release(std::vector<uint8_t>&& buffer);
+
+  /// Retrieve the usage statistics.
+  [[nodiscard]] Statistics statistics() const;
+
+private:
+  const size_t max_buffers_;
+  const size_t max_bytes_;
+
+  mutable std::mutex mutex_;
+  /// The buffers kept, ordered by capacity.
+  std::vector<std::vector<uint8_t>> free_;
+  size_t free_bytes_ = 0;
+  uint64_t reused_ = 0;
+  uint64_t allocated_ = 0;
+};
+
+} // namespace fles
@@ -1,17 +1,86 @@
 // Copyright 2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceSubscriber.hpp"
+#include "SelectedTimeslice.hpp"
+#include "TimesliceMultipart.hpp"
+#include <cstring>
+#include <stdexcept>
 
 namespace fles {
 
+MultipartTimeslice::MultipartTimeslice(std::vector<zmq::message_t> parts,
+                                       const ComponentSelection& selection)
+    : parts_(std::move(parts)) {
+  if (parts_.front().size() != sizeof(TimesliceMultipartHeader)) {
+    throw std::runtime_error("invalid multipart timeslice header");
+  }
+  const auto* header =
+      static_cast<const TimesliceMultipartHeader*>(parts_.front().data());
+  if (header->magic != multipart_timeslice_magic ||
+      header->version != multipart_timeslice_version) {
+    throw std::runtime_error("unsupported multipart timeslice format");
+  }
+  timeslice_descriptor_ = header->ts_desc;
+
+  if (parts_.size() != 1 + 2 * num_components()) {
+    throw std::runtime_error("unexpected number of multipart timeslice parts");
+  }
+  for (size_t c = 0; c < header->ts_desc.num_components; ++c) {
+    zmq::message_t& desc = parts_[1 + 2 * c];
+    zmq::message_t& data = parts_[2 + 2 * c];
+    if (desc.size() != sizeof(TimesliceComponentDescriptor)) {
+      throw std::runtime_error("invalid multipart timeslice component");
+    }
+    auto* tsc_desc = static_cast<TimesliceComponentDescriptor*>(desc.data());
+    if (data.size() != tsc_desc->size ||
+        tsc_desc->num_microslices * sizeof(MicrosliceDescriptor) >
+            data.size()) {
+      throw std::runtime_error("invalid multipart timeslice component size");
+    }
+    if (selection.selects(
+            c, tsc_desc->num_microslices,
+            static_cast<const MicrosliceDescriptor*>(data.data()))) {
+      desc_ptr_.push_back(tsc_desc);
+      data_ptr_.push_back(static_cast<uint8_t*>(data.data()));
+    } else {
+      desc.rebuild();
+      data.rebuild();
+    }
+  }
+  timeslice_descriptor_.num_components =
+      static_cast<uint32_t>(data_ptr_.size());
+}
+
 TimesliceSubscriber::TimesliceSubscriber(const std::string& address,
-                                         uint32_t hwm) {
+                                         uint32_t hwm,
+                                         ComponentSelection selection,
+                                         uint64_t stride,
+                                         uint64_t offset,
+                                         uint64_t topic_modulus)
+    : selection_(std::move(selection)) {
+  if (stride == 0) {
+    throw std::invalid_argument("stride must be greater than zero");
+  }
+  if (topic_modulus == 0 && stride > 1) {
+    topic_modulus = stride;
+  }
+  if (topic_modulus % stride != 0) {
+    throw std::invalid_argument("topic modulus must be a multiple of stride");
+  }
+
   subscriber_.set(zmq::sockopt::rcvhwm, int(hwm));
   subscriber_.connect(address.c_str());
-  subscriber_.set(zmq::sockopt::subscribe, "");
+  if (topic_modulus == 0) {
+    subscriber_.set(zmq::sockopt::subscribe, "");
+  } else {
+    for (uint64_t r = offset % stride; r < topic_modulus; r += stride) {
+      subscriber_.set(zmq::sockopt::subscribe,
+                      timeslice_topic(topic_modulus, r));
+    }
+  }
 }
 
-fles::StorableTimeslice* TimesliceSubscriber::do_get() {
+fles::Timeslice* TimesliceSubscriber::do_get() {
   if (eos_flag) {
     return nullptr;
   }
@@ -19,6 +88,25 @@ fles::StorableTimeslice* TimesliceSubscriber::do_get() {
   zmq::message_t message;
   [[maybe_unused]] auto result = subscriber_.recv(message);
 
+  // skip the topic part, if any
+  constexpr std::size_t prefix_size = sizeof(timeslice_topic_prefix) - 1;
+  if (message.more() && message.size() > prefix_size &&
+      std::memcmp(message.data(), timeslice_topic_prefix, prefix_size) == 0) {
+    result = subscriber_.recv(message);
+  }
+
+  if (message.size() == sizeof(TimesliceMultipartHeader) &&
+      static_cast<const TimesliceMultipartHeader*>(message.data())->magic ==
+          multipart_timeslice_magic) {
+    std::vector<zmq::message_t> parts;
+    parts.push_back(std::move(message));
+    while (parts.back().more()) {
+      parts.emplace_back();
+      result = subscriber_.recv(parts.back());
+    }
+    return new MultipartTimeslice(std::move(parts), selection_); // NOLINT
+  }
+
   boost::iostreams::basic_array_source<char> device(
       static_cast<char*>(message.data()), message.size());
   boost::iostreams::stream<boost::iostreams::basic_array_source<char>> s(
@@ -34,6 +122,10 @@ fles::StorableTimeslice* TimesliceSubscriber::do_get() {
     eos_flag = true;
     return nullptr;
   }
+  if (!selection_.selects_all()) {
+    return new SelectedTimeslice( // NOLINT
+        std::shared_ptr<const Timeslice>(sts), selection_);
+  }
   return sts;
 }
 
@@ -3,23 +3,77 @@
 /// \brief Defines the fles::TimesliceSubscriber class.
 #pragma once
 
+#include "ComponentSelection.hpp"
 #include "StorableTimeslice.hpp"
 #include "TimesliceSource.hpp"
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <string>
+#include <vector>
 #include <zmq.hpp>
 
 namespace fles {
+
+/**
+ * \brief The MultipartTimeslice class provides access to the data of a
+ * timeslice received as a multipart message (see TimesliceMultipart.hpp).
+ *
+ * The timeslice refers directly to the received message buffers. The
+ * buffers of components not selected are released immediately.
+ */
+class MultipartTimeslice : public Timeslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  MultipartTimeslice(const MultipartTimeslice&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MultipartTimeslice&) = delete;
+
+  ~MultipartTimeslice() override = default;
+
+private:
+  friend class TimesliceSubscriber;
+
+  MultipartTimeslice(std::vector<zmq::message_t> parts,
+                     const ComponentSelection& selection);
+
+  /// The received message parts this timeslice refers to.
+  std::vector<zmq::message_t> parts_;
+};
+
 /**
  * \brief The TimesliceSubscriber class receives serialized timeslice data sets
  * from a zeromq socket.
+ *
+ * Both single boost-serialized messages and multipart messages (see
+ * TimesliceMultipart.hpp) are accepted. The latter are provided as
+ * MultipartTimeslice objects without copying. If a component selection is
+ * given, only the selected components are provided.
+ *
+ * If a stride is given, only the timeslices with index % stride ==
+ * offset % stride are received. This requires a publisher with a topic
+ * modulus (see TimesliceMultipart.hpp) that is a multiple of the stride.
+ * The selection then happens on the publisher side, so that the other
+ * timeslices are not sent to this subscriber.
  */
 class TimesliceSubscriber : public TimesliceSource {
 public:
-  /// Construct timeslice subscriber receiving from given ZMQ address.
-  explicit TimesliceSubscriber(const std::string& address, uint32_t hwm);
+  /**
+   * \brief Construct timeslice subscriber receiving from given ZMQ address.
+   *
+   * \param address       the ZMQ address of the publisher
+   * \param hwm           the receive high-water mark
+   * \param selection     the components to provide
+   * \param stride        the stride of the timeslices to receive
+   * \param offset        the offset of the timeslices to receive
+   * \param topic_modulus the topic modulus of the publisher (0: stride)
+   */
+  explicit TimesliceSubscriber(const std::string& address,
+                               uint32_t hwm,
+                               ComponentSelection selection = {},
+                               uint64_t stride = 1,
+                               uint64_t offset = 0,
+                               uint64_t topic_modulus = 0);
 
   /// Delete copy constructor (non-copyable).
   TimesliceSubscriber(const TimesliceSubscriber&) = delete;
@@ -35,17 +89,18 @@ public:
    *
    * \return pointer to the item, or nullptr if end-of-file
    */
-  std::unique_ptr<StorableTimeslice> get() {
-    return std::unique_ptr<StorableTimeslice>(do_get());
+  std::unique_ptr<Timeslice> get() {
+    return std::unique_ptr<Timeslice>(do_get());
   };
 
   [[nodiscard]] bool eos() const override { return eos_flag; }
 
 private:
-  StorableTimeslice* do_get() override;
+  Timeslice* do_get() override;
 
   zmq::context_t context_{1};
   zmq::socket_t subscriber_{context_, ZMQ_SUB};
+  ComponentSelection selection_;
 
   bool eos_flag = false;
 };
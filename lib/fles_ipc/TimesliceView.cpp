@@ -4,27 +4,38 @@
 #include <boost/uuid/uuid.hpp>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 namespace fles {
 
 TimesliceView::TimesliceView(
     std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm,
     std::shared_ptr<const Item> work_item,
-    TimesliceShmWorkItem timeslice_item)
-    : managed_shm_(std::move(managed_shm)), work_item_(std::move(work_item)),
-      timeslice_item_(timeslice_item) {
+    TimesliceShmWorkItem timeslice_item,
+    std::shared_ptr<DeviceMemory> device_data)
+    : managed_shm_(std::move(managed_shm)),
+      device_data_(std::move(device_data)), work_item_(std::move(work_item)),
+      timeslice_item_(std::move(timeslice_item)) {
 
-  timeslice_descriptor_ = timeslice_item.ts_desc;
+  timeslice_descriptor_ = timeslice_item_.ts_desc;
 
   // initialize access pointer vectors
   data_ptr_.resize(num_components());
   desc_ptr_.resize(num_components());
 
+  auto* desc_base = static_cast<fles::TimesliceComponentDescriptor*>(
+      managed_shm_->get_address_from_handle(timeslice_item_.desc_base));
+  // a data buffer in GPU memory is not part of the shared memory
+  uint8_t* data_base = nullptr;
+  if (device_data_) {
+    data_base = device_data_->ptr();
+  } else {
+    data_base = static_cast<uint8_t*>(
+        managed_shm_->get_address_from_handle(timeslice_item_.data_base));
+  }
   for (size_t c = 0; c < num_components(); ++c) {
-    desc_ptr_[c] = reinterpret_cast<fles::TimesliceComponentDescriptor*>(
-        managed_shm_->get_address_from_handle(timeslice_item_.desc[c]));
-    data_ptr_[c] = static_cast<uint8_t*>(
-        managed_shm_->get_address_from_handle(timeslice_item_.data[c]));
+    desc_ptr_[c] = desc_base + timeslice_item_.desc[c];
+    data_ptr_[c] = data_base + timeslice_item_.data[c];
   }
 
   // consistency check
@@ -37,4 +48,44 @@ TimesliceView::TimesliceView(
   }
 }
 
+TimesliceView::~TimesliceView() {
+  if (evictable_) {
+    std::lock_guard<std::mutex> lock(evictable_->mutex);
+    evictable_->views.erase(this);
+  }
+}
+
+void TimesliceView::set_evictable(std::shared_ptr<EvictableViews> views,
+                                  EvictionTable* table) {
+  evictable_ = std::move(views);
+  eviction_table_ = table;
+  std::lock_guard<std::mutex> lock(evictable_->mutex);
+  evictable_->views.insert(this);
+}
+
+void TimesliceView::relocate() {
+  if (relocated_ || eviction_table_ == nullptr) {
+    return;
+  }
+  const uint64_t ts_pos_plus_one = timeslice_item_.ts_desc.ts_pos + 1;
+  for (EvictionEntry& entry : *eviction_table_) {
+    if (entry.ts_pos_plus_one.load(std::memory_order_acquire) !=
+        ts_pos_plus_one) {
+      continue;
+    }
+    auto* copy = static_cast<uint8_t*>(
+        managed_shm_->get_address_from_handle(entry.copy));
+    TimesliceComponentDescriptor* descs = EvictedTimeslice::descriptors(copy);
+    const uint64_t* offsets =
+        EvictedTimeslice::data_offsets(copy, num_components());
+    for (size_t c = 0; c < num_components(); ++c) {
+      desc_ptr_[c] = descs + c;
+      data_ptr_[c] = copy + offsets[c];
+    }
+    entry.state.store(EvictionState::Switched, std::memory_order_release);
+    relocated_ = true;
+    return;
+  }
+}
+
 } // namespace fles
@@ -3,18 +3,37 @@
 /// \brief Defines the fles::TimesliceView class.
 #pragma once
 
+#include "DeviceMemory.hpp"
 #include "ItemWorkerProtocol.hpp"
 #include "Timeslice.hpp"
 #include "TimesliceCompletion.hpp"
+#include "TimesliceEviction.hpp"
 #include "TimesliceShmWorkItem.hpp"
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <memory>
+#include <mutex>
+#include <set>
 
 namespace fles {
 
+class TimesliceView;
+
+/// The set of live views of a receiver, which may be switched to the copy
+/// of an evicted timeslice.
+struct EvictableViews {
+  std::mutex mutex;
+  std::set<TimesliceView*> views;
+};
+
 /**
  * \brief The TimesliceView class provides access to the data of a single
  * timeslice in memory.
+ *
+ * If the timeslice buffer is located in GPU memory, the content pointers
+ * are device addresses and cannot be dereferenced on the host.
+ *
+ * If the timeslice buffer evicts long-held timeslices, the view is switched
+ * to the copy of its timeslice by the receiver (see TimesliceReceiver).
  */
 class TimesliceView : public Timeslice {
 public:
@@ -23,7 +42,7 @@ public:
   /// Delete assignment operator (non-copyable).
   void operator=(const TimesliceView&) = delete;
 
-  ~TimesliceView() override = default;
+  ~TimesliceView() override;
 
 private:
   friend class TimesliceReceiver;
@@ -32,11 +51,25 @@ private:
   TimesliceView(
       std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm,
       std::shared_ptr<const Item> work_item,
-      TimesliceShmWorkItem timeslice_item);
+      TimesliceShmWorkItem timeslice_item,
+      std::shared_ptr<DeviceMemory> device_data = nullptr);
+
+  /// Register the view in a set of views that may be switched to the copy
+  /// of an evicted timeslice.
+  void set_evictable(std::shared_ptr<EvictableViews> views,
+                     EvictionTable* table);
+
+  /// Switch to the copy of the timeslice if it has been evicted.
+  void relocate();
 
   std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
+  std::shared_ptr<DeviceMemory> device_data_;
   std::shared_ptr<const Item> work_item_;
   fles::TimesliceShmWorkItem timeslice_item_;
+
+  std::shared_ptr<EvictableViews> evictable_;
+  EvictionTable* eviction_table_ = nullptr;
+  bool relocated_ = false;
 };
 
 } // namespace fles
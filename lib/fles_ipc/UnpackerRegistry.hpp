@@ -0,0 +1,156 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the fles::UnpackerRegistry class template.
+#pragma once
+
+#include "ComponentIndex.hpp"
+#include "ComponentView.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "Timeslice.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace fles {
+
+/// Format version matching all versions of a subsystem.
+inline constexpr int any_sys_ver = -1;
+
+/**
+ * \brief Base class declaring the microslice format handled by an unpacker.
+ *
+ * An unpacker derives from UnpackerFormat and provides a member function
+ * `void unpack(uint64_t component, const ComponentView& view)`, which
+ * processes all microslices of a component of this format at once.
+ */
+template <Subsystem SysId, int SysVer = any_sys_ver> struct UnpackerFormat {
+  static constexpr Subsystem sys_id = SysId; ///< The subsystem identifier
+  static constexpr int sys_ver = SysVer;     ///< The format version (or any)
+
+  /// Check whether the format matches given identifiers.
+  static constexpr bool matches(uint8_t id, uint8_t ver) {
+    return id == static_cast<uint8_t>(sys_id) &&
+           (sys_ver == any_sys_ver || ver == sys_ver);
+  }
+};
+
+/**
+ * \brief The UnpackerRegistry class template dispatches timeslice
+ * components to the unpacker registered for their format.
+ *
+ * The set of unpackers is fixed at compile time by the template arguments.
+ * The format of a component is taken from its first microslice, and the
+ * component is handed to the first unpacker matching it. As this selection
+ * happens once per component and the unpackers are called directly on their
+ * concrete type, the per-microslice loop of an unpacker is free of format
+ * checks and virtual calls and can be fully inlined.
+ *
+ * Example:
+ * \code
+ * struct StsUnpacker : fles::UnpackerFormat<fles::Subsystem::STS> {
+ *   void unpack(uint64_t component, const fles::ComponentView& view);
+ * };
+ * fles::UnpackerRegistry<StsUnpacker, TofUnpacker> unpackers;
+ * unpackers.unpack(ts);
+ * \endcode
+ */
+template <typename... Unpackers> class UnpackerRegistry {
+  static_assert(sizeof...(Unpackers) != 0, "no unpacker given");
+
+public:
+  /// The number of registered unpackers.
+  static constexpr std::size_t size = sizeof...(Unpackers);
+
+  /// Position returned by find() if no unpacker matches.
+  static constexpr std::size_t npos = size;
+
+  UnpackerRegistry() = default;
+
+  /// Construct a registry from given unpacker objects.
+  explicit UnpackerRegistry(Unpackers... unpackers)
+      : unpackers_(std::move(unpackers)...) {}
+
+  /// Retrieve the registered unpacker at a given position.
+  template <std::size_t I> auto& get() { return std::get<I>(unpackers_); }
+
+  /// Find the position of the first unpacker matching given identifiers.
+  static constexpr std::size_t find(uint8_t sys_id, uint8_t sys_ver) {
+    return find_impl(sys_id, sys_ver, std::index_sequence_for<Unpackers...>{});
+  }
+
+  /// Unpack a given component of a timeslice.
+  /** \return Whether an unpacker matched the component */
+  bool unpack(const Timeslice& ts, uint64_t component) {
+    ComponentView view = ts.component(component);
+    if (view.empty()) {
+      return false;
+    }
+    const MicrosliceDescriptor& desc = view.descriptor(0);
+    return dispatch(find(desc.sys_id, desc.sys_ver), component, view,
+                    std::index_sequence_for<Unpackers...>{});
+  }
+
+  /// Unpack all components of a timeslice.
+  /** The components are visited by subsystem using the component index of
+      the timeslice, so that each unpacker processes all of its components
+      back to back.
+      \return The number of components unpacked */
+  uint64_t unpack(const Timeslice& ts) {
+    return unpack_all(ts, ts.component_index(),
+                      std::index_sequence_for<Unpackers...>{});
+  }
+
+private:
+  template <std::size_t... I>
+  static constexpr std::size_t
+  find_impl(uint8_t sys_id, uint8_t sys_ver, std::index_sequence<I...>) {
+    std::size_t pos = npos;
+    // stops at the first match
+    (void)((Unpackers::matches(sys_id, sys_ver) ? (pos = I, true) : false) ||
+           ...);
+    return pos;
+  }
+
+  template <std::size_t... I>
+  bool dispatch(std::size_t pos,
+                uint64_t component,
+                const ComponentView& view,
+                std::index_sequence<I...>) {
+    return ((pos == I ? (std::get<I>(unpackers_).unpack(component, view),
+                         true)
+                      : false) ||
+            ...);
+  }
+
+  template <std::size_t I>
+  uint64_t unpack_subsystem(const Timeslice& ts,
+                            const ComponentIndex& index) {
+    using Unpacker = std::tuple_element_t<I, std::tuple<Unpackers...>>;
+    uint64_t count = 0;
+    for (uint64_t c :
+         index.components(static_cast<uint8_t>(Unpacker::sys_id))) {
+      ComponentView view = ts.component(c);
+      const MicrosliceDescriptor& desc = view.descriptor(0);
+      // skip components claimed by an earlier unpacker
+      if (find(desc.sys_id, desc.sys_ver) == I) {
+        std::get<I>(unpackers_).unpack(c, view);
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  template <std::size_t... I>
+  uint64_t unpack_all(const Timeslice& ts,
+                      const ComponentIndex& index,
+                      std::index_sequence<I...>) {
+    uint64_t count = 0;
+    ((count += unpack_subsystem<I>(ts, index)), ...);
+    return count;
+  }
+
+  std::tuple<Unpackers...> unpackers_;
+};
+
+} // namespace fles
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <limits>
+#include <mutex>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -80,6 +81,12 @@ void replace_all(std::string& str,
 }
 
 /// Split string by any of the separators
+void print_line(const std::string& line, std::ostream& os) {
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  os << line << std::endl;
+}
+
 std::vector<std::string> split(const std::string& str,
                                const std::string& separators) {
   std::vector<std::string> new_vector;
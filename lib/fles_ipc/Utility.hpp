@@ -63,6 +63,10 @@ void replace_all(std::string& str,
                  const std::string& from,
                  const std::string& to);
 
+/// Write a line to a stream (std::cout by default) as a whole, even if
+/// several threads print concurrently.
+void print_line(const std::string& line, std::ostream& os = std::cout);
+
 /// Split string by any of the separators
 std::vector<std::string> split(const std::string& str,
                                const std::string& separators);
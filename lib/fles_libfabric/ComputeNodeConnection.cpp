@@ -2,6 +2,7 @@
 // Copyright 2016 Thorsten Schuett <schuett@zib.de>, Farouk Salem <salem@zib.de>
 
 #include "ComputeNodeConnection.hpp"
+#include "MemoryPlacement.hpp"
 
 namespace tl_libfabric {
 
@@ -88,11 +89,19 @@ void ComputeNodeConnection::post_send_status_message() {
   while (pending_send_requests_ >= 2000 /*qp_cap_.max_send_wr*/) {
     throw LibfabricException("Max number of pending send requests exceeded");
   }
-  if (post_send_msg(&send_wr)) {
+  // the final message is sent with completion, which finalizes the
+  // connection
+  const bool injected =
+      !send_status_message_.final && post_inject_msg(&send_wr);
+  if (injected || post_send_msg(&send_wr)) {
     data_acked_ = false;
     data_changed_ = false;
     send_buffer_available_ = false;
     ++pending_send_requests_;
+    if (injected) {
+      // there is no completion of an injected message
+      on_complete_send();
+    }
   }
 }
 
@@ -117,8 +126,26 @@ void ComputeNodeConnection::setup_mr(struct fid_domain* pd) {
   std::size_t data_bytes = UINT64_C(1) << data_buffer_size_exp_;
   std::size_t desc_bytes = (UINT64_C(1) << desc_buffer_size_exp_) *
                            sizeof(fles::TimesliceComponentDescriptor);
-  int res = fi_mr_reg(pd, data_ptr_, data_bytes, FI_WRITE | FI_REMOTE_WRITE, 0,
-                      Provider::requested_key++, 0, &mr_data_, nullptr);
+  int res = 0;
+  if (data_device_ >= 0) {
+#ifdef FI_HMEM
+    // device memory is registered through the heterogeneous memory interface
+    struct iovec iov = {data_ptr_, data_bytes};
+    struct fi_mr_attr attr = {};
+    attr.mr_iov = &iov;
+    attr.iov_count = 1;
+    attr.access = FI_WRITE | FI_REMOTE_WRITE;
+    attr.requested_key = Provider::requested_key++;
+    attr.iface = FI_HMEM_CUDA;
+    attr.device.cuda = data_device_;
+    res = fi_mr_regattr(pd, &attr, 0, &mr_data_);
+#else
+    throw LibfabricException("libfabric built without FI_HMEM support");
+#endif
+  } else {
+    res = fi_mr_reg(pd, data_ptr_, data_bytes, FI_WRITE | FI_REMOTE_WRITE, 0,
+                    Provider::requested_key++, 0, &mr_data_, nullptr);
+  }
   if (res != 0) {
     L_(fatal) << "fi_mr_reg failed for data_ptr: " << res << "="
               << fi_strerror(-res);
@@ -148,22 +175,59 @@ void ComputeNodeConnection::setup_mr(struct fid_domain* pd) {
     throw LibfabricException("fi_mr_reg failed for recv");
   }
 
+  std::size_t replica_bytes = 0;
+  if (replica_data_ptr_ != nullptr) {
+    std::size_t replica_desc_bytes =
+        (UINT64_C(1) << desc_buffer_size_exp_) * sizeof(ReplicaDescriptor);
+    res = fi_mr_reg(pd, replica_data_ptr_, data_bytes,
+                    FI_WRITE | FI_REMOTE_WRITE, 0, Provider::requested_key++, 0,
+                    &mr_replica_data_, nullptr);
+    if (res == 0) {
+      res = fi_mr_reg(pd, replica_desc_ptr_, replica_desc_bytes,
+                      FI_WRITE | FI_REMOTE_WRITE, 0, Provider::requested_key++,
+                      0, &mr_replica_desc_, nullptr);
+    }
+    if (res != 0) {
+      L_(fatal) << "fi_mr_reg failed for replica: " << res << "="
+                << fi_strerror(-res);
+      throw LibfabricException("fi_mr_reg failed for replica");
+    }
+    replica_bytes = data_bytes + replica_desc_bytes;
+  }
+
   if ((mr_data_ == nullptr) || (mr_desc_ == nullptr) || (mr_recv_ == nullptr) ||
       (mr_send_ == nullptr)) {
     throw LibfabricException(
         "registration of memory region failed in ComputeNodeConnection");
   }
+  registered_account_ = MemoryAccount(
+      "libfabric_timeslice_buffer", MemoryUse::Registered,
+      desc_bytes + replica_bytes + (data_device_ >= 0 ? 0 : data_bytes),
+      numa_node_of_memory(desc_ptr_));
 
-  send_status_message_.info.data.addr = reinterpret_cast<uintptr_t>(data_ptr_);
-  send_status_message_.info.data.rkey = fi_mr_key(mr_data_);
-  send_status_message_.info.desc.addr = reinterpret_cast<uintptr_t>(desc_ptr_);
-  send_status_message_.info.desc.rkey = fi_mr_key(mr_desc_);
-  send_status_message_.info.index = remote_index_;
-  send_status_message_.info.data_buffer_size_exp = data_buffer_size_exp_;
-  send_status_message_.info.desc_buffer_size_exp = desc_buffer_size_exp_;
+  fill_compute_node_info(send_status_message_.info);
   send_status_message_.connect = false;
 }
 
+void ComputeNodeConnection::fill_compute_node_info(
+    ComputeNodeInfo& info) const {
+  info.data.addr = reinterpret_cast<uintptr_t>(data_ptr_);
+  info.data.rkey = fi_mr_key(mr_data_);
+  info.desc.addr = reinterpret_cast<uintptr_t>(desc_ptr_);
+  info.desc.rkey = fi_mr_key(mr_desc_);
+  info.index = remote_index_;
+  info.data_buffer_size_exp = data_buffer_size_exp_;
+  info.desc_buffer_size_exp = desc_buffer_size_exp_;
+  info.replica_data = BufferInfo{0, 0};
+  info.replica_desc = BufferInfo{0, 0};
+  if (mr_replica_data_ != nullptr && mr_replica_desc_ != nullptr) {
+    info.replica_data.addr = reinterpret_cast<uintptr_t>(replica_data_ptr_);
+    info.replica_data.rkey = fi_mr_key(mr_replica_data_);
+    info.replica_desc.addr = reinterpret_cast<uintptr_t>(replica_desc_ptr_);
+    info.replica_desc.rkey = fi_mr_key(mr_replica_desc_);
+  }
+}
+
 void ComputeNodeConnection::setup() {
   L_(info) << "Calling add_endpoint in setup";
   LibfabricBarrier::get_instance()->add_endpoint(
@@ -242,7 +306,18 @@ void ComputeNodeConnection::on_disconnected(struct fi_eq_cm_entry* event) {
     fi_close((struct fid*)mr_data_);
     mr_data_ = nullptr;
   }
+
+  if (mr_replica_desc_ != nullptr) {
+    fi_close((struct fid*)mr_replica_desc_);
+    mr_replica_desc_ = nullptr;
+  }
+
+  if (mr_replica_data_ != nullptr) {
+    fi_close((struct fid*)mr_replica_data_);
+    mr_replica_data_ = nullptr;
+  }
 #pragma GCC diagnostic pop
+  registered_account_ = MemoryAccount();
 
   Connection::on_disconnected(event);
 }
@@ -383,13 +458,7 @@ ComputeNodeConnection::get_private_data() {
 
   ComputeNodeInfo* cn_info =
       reinterpret_cast<ComputeNodeInfo*>(private_data->data());
-  cn_info->data.addr = reinterpret_cast<uintptr_t>(data_ptr_);
-  cn_info->data.rkey = fi_mr_key(mr_data_);
-  cn_info->desc.addr = reinterpret_cast<uintptr_t>(desc_ptr_);
-  cn_info->desc.rkey = fi_mr_key(mr_desc_);
-  cn_info->index = remote_index_;
-  cn_info->data_buffer_size_exp = data_buffer_size_exp_;
-  cn_info->desc_buffer_size_exp = desc_buffer_size_exp_;
+  fill_compute_node_info(*cn_info);
 
   return private_data;
 }
@@ -433,11 +502,43 @@ void ComputeNodeConnection::write_received_descriptors() {
               << descriptor.size << " num mts " << descriptor.num_microslices
               << " local address " << (acked_ts) << " tscdesc_ts " << ts_desc
               << " cur desc " << cn_wp_.desc;
+    uint64_t replica_pos = recv_status_message_.replica_pos[i];
+    if (replica_pos != timeslice_replication::no_replica &&
+        !restore_replica(replica_pos, descriptor)) {
+      L_(error) << "[c" << remote_index_ << "] "
+                << "[" << index_ << "] "
+                << "no replica of ts#" << descriptor.ts_num
+                << " at replica position " << replica_pos;
+      descriptor.num_microslices = 0;
+    }
     std::memcpy(acked_ts, &descriptor, sizeof(descriptor));
     DDSchedulerOrchestrator::log_contribution_arrival(index_, ts_desc);
   }
   acked_ts = nullptr;
 }
+
+bool ComputeNodeConnection::restore_replica(
+    uint64_t replica_pos,
+    const fles::TimesliceComponentDescriptor& descriptor) {
+  if (replica_desc_ptr_ == nullptr) {
+    return false;
+  }
+  const fles::TimesliceComponentDescriptor* replica =
+      timeslice_replication::find(replica_desc_ptr_, desc_buffer_size_exp_,
+                                  replica_pos, descriptor);
+  if (replica == nullptr) {
+    return false;
+  }
+  timeslice_replication::copy(data_ptr_, data_buffer_size_exp_,
+                              descriptor.offset, replica_data_ptr_,
+                              data_buffer_size_exp_, replica->offset,
+                              descriptor.size);
+  L_(debug) << "[c" << remote_index_ << "] "
+            << "[" << index_ << "] "
+            << "restored ts#" << descriptor.ts_num << " from replica position "
+            << replica_pos;
+  return true;
+}
 void ComputeNodeConnection::on_complete_heartbeat_recv() {
   if (final_msg_sent_)
     return;
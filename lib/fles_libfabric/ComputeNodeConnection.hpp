@@ -8,8 +8,10 @@
 #include "Connection.hpp"
 #include "InputChannelStatusMessage.hpp"
 #include "InputNodeInfo.hpp"
+#include "MemoryAccounting.hpp"
 #include "RequestIdentifier.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceReplication.hpp"
 #include "dfs/DDSchedulerOrchestrator.hpp"
 
 #include <boost/format.hpp>
@@ -52,6 +54,17 @@ public:
   ComputeNodeConnection(const ComputeNodeConnection&) = delete;
   void operator=(const ComputeNodeConnection&) = delete;
 
+  /// Set the GPU holding the data buffer (before setup_mr()).
+  void set_data_device(int device) { data_device_ = device; }
+
+  /// Set the replica buffers for the hot standby of the previous compute
+  /// node, of the size of the data and descriptor buffers (before
+  /// setup_mr()).
+  void set_replica_buffers(uint8_t* data_ptr, ReplicaDescriptor* desc_ptr) {
+    replica_data_ptr_ = data_ptr;
+    replica_desc_ptr_ = desc_ptr;
+  }
+
   /// Post a receive work request (WR) to the receive queue
   void post_recv_status_message();
 
@@ -166,6 +179,14 @@ private:
   /// memory (to minimize RDMA Writes)
   void write_received_descriptors();
 
+  /// Copy a timeslice component from the replica buffers into the data
+  /// buffer, return false if the replica does not match the descriptor
+  bool restore_replica(uint64_t replica_pos,
+                       const fles::TimesliceComponentDescriptor& descriptor);
+
+  /// Fill in the access information of the local buffers
+  void fill_compute_node_info(ComputeNodeInfo& info) const;
+
   //
   void sync_after_scheduler_decision_received();
 
@@ -181,16 +202,28 @@ private:
   struct fid_mr* mr_desc_ = nullptr;
   struct fid_mr* mr_send_ = nullptr;
   struct fid_mr* mr_recv_ = nullptr;
+  struct fid_mr* mr_replica_data_ = nullptr;
+  struct fid_mr* mr_replica_desc_ = nullptr;
+
+  /// The accounting of the registered host memory.
+  MemoryAccount registered_account_;
 
   /// Information on remote end.
   InputNodeInfo remote_info_{0};
 
   uint8_t* data_ptr_ = nullptr;
+
+  /// The GPU holding the data buffer (-1: host memory).
+  int data_device_ = -1;
   const std::size_t data_buffer_size_exp_ = 0;
 
   fles::TimesliceComponentDescriptor* desc_ptr_ = nullptr;
   const std::size_t desc_buffer_size_exp_ = 0;
 
+  /// Replica buffers (nullptr: not a hot standby)
+  uint8_t* replica_data_ptr_ = nullptr;
+  ReplicaDescriptor* replica_desc_ptr_ = nullptr;
+
   /// Libfabric receive work request
   struct fi_msg_tagged recv_wr = fi_msg_tagged();
 
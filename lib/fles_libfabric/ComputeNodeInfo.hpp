@@ -20,6 +20,10 @@ struct ComputeNodeInfo {
   uint32_t index;
   uint32_t data_buffer_size_exp;
   uint32_t desc_buffer_size_exp;
+  /// Replica buffers for the hot standby of the previous compute node
+  /// (addr 0: replication disabled)
+  BufferInfo replica_data;
+  BufferInfo replica_desc;
 };
 } // namespace tl_libfabric
 #pragma pack()
@@ -62,6 +62,7 @@ void Connection::connect(const std::string& hostname,
     L_(fatal) << "fi_endpoint failed: " << err << "=" << fi_strerror(-err);
     throw LibfabricException("fi_endpoint failed");
   }
+  inject_size_ = info2->tx_attr->inject_size;
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -148,6 +149,7 @@ void Connection::on_connect_request(struct fi_eq_cm_entry* event,
     L_(fatal) << "fi_endpoint failed: " << err << "=" << fi_strerror(-err);
     throw LibfabricException("fi_endpoint failed");
   }
+  inject_size_ = event->info->tx_attr->inject_size;
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -199,6 +201,7 @@ void Connection::make_endpoint(struct fi_info* info,
     L_(fatal) << "fi_endpoint failed: " << err << "=" << fi_strerror(-err);
     throw LibfabricException("fi_endpoint failed");
   }
+  inject_size_ = info2->tx_attr->inject_size;
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -333,6 +336,11 @@ void Connection::post_send_heartbeat_message() {
              << send_heartbeat_message_.failure_info.timeslice_trigger << ")";
   }
   heartbeat_send_buffer_available_ = false;
+  if (post_inject_msg(&heartbeat_send_wr)) {
+    // there is no completion of an injected message
+    on_complete_heartbeat_send();
+    return;
+  }
   post_send_msg(&heartbeat_send_wr);
 }
 
@@ -358,6 +366,23 @@ bool Connection::post_send_msg(const struct fi_msg_tagged* wr) {
   return true;
 }
 
+bool Connection::post_inject_msg(const struct fi_msg_tagged* wr) {
+  if (wr->iov_count != 1 || wr->msg_iov[0].iov_len > inject_size_) {
+    return false;
+  }
+  int err = fi_tinject(ep_, wr->msg_iov[0].iov_base, wr->msg_iov[0].iov_len,
+                       wr->addr, wr->tag);
+  if (err != 0) {
+    // e.g., -FI_EAGAIN, the message is posted as a regular send instead
+    return false;
+  }
+
+  ++total_send_requests_;
+  total_bytes_sent_ += wr->msg_iov[0].iov_len;
+  total_sync_bytes_sent_ += wr->msg_iov[0].iov_len;
+  return true;
+}
+
 /// Post an Libfabric rdma send work request
 bool Connection::post_send_rdma(struct fi_msg_rma* wr, uint64_t flags) {
   int err = fi_writemsg(ep_, wr, flags);
@@ -155,6 +155,12 @@ protected:
   /// Post an Libfabric message send work request
   bool post_send_msg(const struct fi_msg_tagged* wr);
 
+  /// Post an Libfabric message send work request as an inject operation.
+  /** A message up to the provider's inject size is copied on posting, so
+      its buffer may be reused immediately. No completion is generated.
+      \return whether the message has been injected */
+  bool post_inject_msg(const struct fi_msg_tagged* wr);
+
   /// Post an Libfabric message recveive request.
   bool post_recv_msg(const struct fi_msg_tagged* wr);
 
@@ -187,6 +193,9 @@ protected:
   uint32_t max_recv_sge_;
   uint32_t max_inline_data_;
 
+  /// Maximum size of injected messages (0: no injection)
+  std::size_t inject_size_ = 0;
+
   struct fid_ep* ep_ = nullptr;
 
   bool connection_oriented_ = false;
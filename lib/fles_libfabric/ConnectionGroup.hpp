@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "CompletionWait.hpp"
 #include "ConnectionGroupWorker.hpp"
 #include "RequestIdentifier.hpp"
 #include "dfs/SchedulerOrchestrator.hpp"
@@ -18,9 +19,13 @@
 #include <rdma/fi_errno.h>
 #include <set>
 
+#include <cassert>
 #include <chrono>
+#include <emmintrin.h>
 #include <fstream>
+#include <vector>
 
+#include <poll.h>
 #include <sys/uio.h>
 
 namespace tl_libfabric {
@@ -45,7 +50,11 @@ public:
       L_(fatal) << "fi_eq_open failed: " << res << "=" << fi_strerror(-res);
       throw LibfabricException("fi_eq_open failed");
     }
+    assert(MAX_CQ_INSTANCE <= 64); // see used_cqs_
     cqs_.resize(MAX_CQ_INSTANCE);
+    cq_connections_.resize(MAX_CQ_INSTANCE);
+    cq_wait_fds_.resize(MAX_CQ_INSTANCE, -1);
+    cq_entries_.resize(MAX_CQ_ENTRIES);
   }
 
   ConnectionGroup(const ConnectionGroup&) = delete;
@@ -129,15 +138,16 @@ public:
 
   /// The Libfabric completion notification handler.
   int poll_completion() {
-    struct fi_cq_tagged_entry* wc =
-        new struct fi_cq_tagged_entry[MAX_CQ_ENTRIES];
+    struct fi_cq_tagged_entry* wc = cq_entries_.data();
     int ne;
     int ne_total = 0;
 
     agg_CQ_count_++;
     std::chrono::high_resolution_clock::time_point start, end;
 
-    for (uint16_t i = 0; i < MAX_CQ_INSTANCE; i++) {
+    // only the completion queues of active connections are read
+    for (uint64_t used = used_cqs_; used != 0; used &= used - 1) {
+      auto i = static_cast<uint16_t>(__builtin_ctzll(used));
       start = std::chrono::high_resolution_clock::now();
       ne = fi_cq_read(cqs_[i], wc, MAX_CQ_ENTRIES);
       if (ne != 0) {
@@ -180,19 +190,7 @@ public:
           if (ne > 0) {
             start = std::chrono::high_resolution_clock::now();
           }
-          for (int i = 0; i < ne; ++i) {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-            struct fi_custom_context* context =
-                static_cast<struct fi_custom_context*>(wc[i].op_context);
-            assert(context != nullptr);
-            on_completion((uintptr_t)context->op_context);
-            if (((uintptr_t)context->op_context & 0xFF) == ID_WRITE_DESC ||
-                ((uintptr_t)context->op_context & 0xFF) == ID_WRITE_DATA ||
-                ((uintptr_t)context->op_context & 0xFF) == ID_WRITE_DATA_WRAP)
-              LibfabricContextPool::getInst()->releaseContext(context);
-#pragma GCC diagnostic pop
-          }
+          on_completions(wc, ne);
           if (ne > 0) {
             end = std::chrono::high_resolution_clock::now();
             assert(end >= start);
@@ -205,12 +203,62 @@ public:
       }
     }
 
+    if (ne_total == 0) {
+      // nothing to do, relax the core while busy polling
+      _mm_pause();
+    }
+
     return ne_total;
   }
 
-  /// Retrieve the InfiniBand completion queue.
-  struct fid_cq* completion_queue(uint32_t conn_index) const {
-    return cqs_[conn_index % MAX_CQ_INSTANCE];
+  /// Allow the event loop to block on the completion queues when idle.
+  /** To be called before the connections are set up (see CompletionWait).
+      Requires a provider supporting FI_WAIT_FD. */
+  void set_completion_wait(CompletionWait::Config config) {
+    completion_wait_.configure(config);
+  }
+
+  /// Account an iteration of the event loop and block if idle.
+  /** Blocks until a completion arrives, or for at most the maximum wait
+      time, once the event loop has done no work for the spin time. */
+  void idle_wait(bool active) {
+    if (pd_ == nullptr || !completion_wait_.idle(active)) {
+      return;
+    }
+    std::vector<struct fid*> fids;
+    std::vector<pollfd> fds;
+    for (uint64_t used = used_cqs_; used != 0; used &= used - 1) {
+      auto i = static_cast<uint16_t>(__builtin_ctzll(used));
+      fids.push_back(&cqs_[i]->fid);
+      fds.push_back({cq_wait_fds_[i], POLLIN, 0});
+    }
+    // only block if no completion is pending, see fi_trywait(3)
+    if (fids.empty() ||
+        fi_trywait(Provider::getInst()->get_fabric(), fids.data(),
+                   static_cast<int>(fids.size())) != FI_SUCCESS) {
+      return;
+    }
+    completion_wait_.wait(fds.data(), fds.size());
+  }
+
+  /// Retrieve the completion queue of a connection and mark it as used.
+  /** A queue is shared by every MAX_CQ_INSTANCE-th connection and polled
+      until all of its connections are disconnected. */
+  struct fid_cq* completion_queue(uint32_t conn_index) {
+    uint16_t i = conn_index % MAX_CQ_INSTANCE;
+    cq_connections_[i].insert(conn_index);
+    used_cqs_ |= uint64_t{1} << i;
+    return cqs_[i];
+  }
+
+  /// Stop polling the completion queue of a disconnected connection if it
+  /// has no other connection left.
+  void release_completion_queue(uint32_t conn_index) {
+    uint16_t i = conn_index % MAX_CQ_INSTANCE;
+    cq_connections_[i].erase(conn_index);
+    if (cq_connections_[i].empty()) {
+      used_cqs_ &= ~(uint64_t{1} << i);
+    }
   }
 
   size_t size() const { return conn_.size(); }
@@ -238,6 +286,13 @@ public:
     L_(info) << "summary: Agg. CQ retrieving time " << agg_CQ_time_ / 1000000.
              << " s and processing time " << agg_CQ_COMP_time_ / 1000000.
              << " s in " << agg_CQ_count_ << " calls";
+    if (completion_wait_.enabled()) {
+      CompletionWait::Stats wait = completion_wait_.total_stats();
+      L_(info) << "summary: blocked "
+               << std::chrono::duration<double>(wait.blocked).count()
+               << " s in " << wait.waits << " waits (" << wait.wakeups
+               << " woken by completions)";
+    }
   }
 
   /// The "main" function of an ConnectionGroup decendant.
@@ -279,6 +334,10 @@ protected:
       aggregate_recv_requests_ += conn_[conn_indx]->total_recv_requests();
       conn_[conn_indx]->on_disconnected(event);
     }
+    release_completion_queue(conn_indx == -1
+                                 ? static_cast<CONNECTION*>(event->fid->context)
+                                       ->index()
+                                 : static_cast<uint32_t>(conn_indx));
     --connected_;
   }
 
@@ -302,7 +361,8 @@ protected:
       cq_attr.flags = 0;
       // cq_attr.format = FI_CQ_FORMAT_CONTEXT;
       cq_attr.format = FI_CQ_FORMAT_TAGGED;
-      cq_attr.wait_obj = FI_WAIT_NONE;
+      cq_attr.wait_obj =
+          completion_wait_.enabled() ? FI_WAIT_FD : FI_WAIT_NONE;
       cq_attr.signaling_vector = Provider::vector++; // ??
       cq_attr.wait_cond = FI_CQ_COND_NONE;
       cq_attr.wait_set = nullptr;
@@ -312,6 +372,14 @@ protected:
                   << fi_strerror(-res);
         throw LibfabricException("fi_cq_open failed");
       }
+      if (completion_wait_.enabled()) {
+        res = fi_control(&cqs_[i]->fid, FI_GETWAIT, &cq_wait_fds_[i]);
+        if (res != 0) {
+          L_(fatal) << "fi_control[" << i << "] failed: " << -res << "="
+                    << fi_strerror(-res);
+          throw LibfabricException("fi_control(FI_GETWAIT) failed");
+        }
+      }
     }
 
     if (Provider::getInst()->has_av()) {
@@ -369,6 +437,18 @@ protected:
   /// Libfabric completion queues
   std::vector<struct fid_cq*> cqs_;
 
+  /// Bit mask of the completion queues with an active connection
+  uint64_t used_cqs_ = 0;
+
+  /// Active connections of each completion queue
+  std::vector<std::set<uint32_t>> cq_connections_;
+
+  /// File descriptors to block on per completion queue (if enabled)
+  std::vector<int> cq_wait_fds_;
+
+  /// Decision whether the event loop blocks.
+  CompletionWait completion_wait_;
+
   /// Libfabric address vector.
   struct fid_av* av_ = nullptr;
 
@@ -426,6 +506,34 @@ private:
   /// Completion notification event dispatcher. Called by the event loop.
   virtual void on_completion(uint64_t wc) = 0;
 
+  /// Batch completion handler. Called by the event loop with the entries
+  /// read from a completion queue at once; the default dispatches them one
+  /// by one.
+  virtual void on_completions(const struct fi_cq_tagged_entry* wc,
+                              int count) {
+    for (int i = 0; i < count; ++i) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+      if ((wc[i].flags & FI_REMOTE_CQ_DATA) != 0) {
+        // a remote write with data has no local context
+        on_remote_cq_data(wc[i].data);
+        continue;
+      }
+      struct fi_custom_context* context =
+          static_cast<struct fi_custom_context*>(wc[i].op_context);
+      assert(context != nullptr);
+      on_completion((uintptr_t)context->op_context);
+      if (((uintptr_t)context->op_context & 0xFF) == ID_WRITE_DESC ||
+          ((uintptr_t)context->op_context & 0xFF) == ID_WRITE_DATA ||
+          ((uintptr_t)context->op_context & 0xFF) == ID_WRITE_DATA_WRAP)
+        LibfabricContextPool::getInst()->releaseContext(context);
+#pragma GCC diagnostic pop
+    }
+  }
+
+  /// Remote write notification handler. Called by the event loop.
+  virtual void on_remote_cq_data(uint64_t /* data */) {}
+
   /// Total number of bytes transmitted.
   uint64_t aggregate_bytes_sent_ = 0;
 
@@ -449,5 +557,8 @@ private:
 
   // TODO detect the number of messages that we are waiting for
   const int MAX_CQ_ENTRIES = 1000;
+
+  /// Buffer for the entries read from a completion queue
+  std::vector<struct fi_cq_tagged_entry> cq_entries_;
 };
 } // namespace tl_libfabric
@@ -20,12 +20,15 @@ struct ConstVariables {
   const static uint32_t HEARTBEAT_TIMEOUT_HISTORY_SIZE =
       10000; // high for unstable networks
 
+  const static uint32_t HEARTBEAT_TIMEOUT_PERCENTILE =
+      99; // Percentile of the message gaps used as timeout value
+
   const static uint32_t HEARTBEAT_TIMEOUT_FACTOR =
-      25; // Factor of timeout value before considering a connection timed out
+      10; // Factor of timeout value before considering a connection timed out
 
   const static uint32_t HEARTBEAT_INACTIVE_FACTOR =
-      20; // Factor of timeout value before considering a connection is in
-          // active
+      8; // Factor of timeout value before considering a connection is in
+         // active
 
   const static uint32_t HEARTBEAT_INACTIVE_RETRY_COUNT = 3;
 
@@ -35,6 +38,11 @@ struct ConstVariables {
 
   const static uint64_t TIMESLICE_TIMEOUT = 200000000; // in microseconds
 
+  const static uint32_t COLLECTIVE_TREE_THRESHOLD =
+      64; // Number of participants from which collectives use a tree
+
+  const static uint32_t COLLECTIVE_TREE_FANOUT = 4;
+
   const static uint64_t STATUS_MESSAGE_TAG = 10;
   const static uint64_t HEARTBEAT_MESSAGE_TAG = 20;
   ///-----
@@ -14,6 +14,8 @@ InputChannelConnection::InputChannelConnection(
     : Connection(eq, connection_index, remote_connection_index),
       max_pending_write_requests_(max_pending_write_requests) {
   assert(max_pending_write_requests_ > 0);
+  // each pending replica holds one write request
+  replica_staging_.resize(max_pending_write_requests_);
 
   max_send_wr_ = max_send_wr; // typical hca maximum: 16k
   max_send_sge_ = 4;          // max. two chunks each for descriptors and data
@@ -124,6 +126,21 @@ bool InputChannelConnection::send_data(struct iovec* sge,
   }
   num_sge -= num_sge_cut;
 
+  // the last write of the component may notify the compute node
+  const unsigned position_bits =
+      remote_cq_data_
+          ? remote_cq_data::position_bits(
+                Provider::getInst()->get_info()->domain_attr->cq_data_size,
+                remote_info_.desc_buffer_size_exp)
+          : 0;
+  uint64_t last_write_flags = FI_FENCE | FI_DELIVERY_COMPLETE | FI_COMPLETION;
+  uint64_t last_write_data = 0;
+  if (position_bits != 0) {
+    last_write_flags |= FI_REMOTE_CQ_DATA;
+    last_write_data = remote_cq_data::encode(
+        last_timeslice_info.second, remote_index_, position_bits);
+  }
+
   struct fi_msg_rma send_wr_ts;
   struct fi_msg_rma send_wr_tswrap;
   struct fi_rma_iov rma_iov[1];
@@ -157,8 +174,8 @@ bool InputChannelConnection::send_data(struct iovec* sge,
     if (i + 1 < num_sge || num_sge2 > 0) {
       res = post_send_rdma(&send_wr_ts, FI_MORE);
     } else {
-      res = post_send_rdma(&send_wr_ts,
-                           FI_FENCE | FI_DELIVERY_COMPLETE | FI_COMPLETION);
+      send_wr_ts.data = last_write_data;
+      res = post_send_rdma(&send_wr_ts, last_write_flags);
       ++pending_write_requests_;
     }
   }
@@ -191,8 +208,8 @@ bool InputChannelConnection::send_data(struct iovec* sge,
       if (i + 1 < num_sge2) {
         res = post_send_rdma(&send_wr_tswrap, FI_MORE);
       } else {
-        res = post_send_rdma(&send_wr_tswrap,
-                             FI_FENCE | FI_DELIVERY_COMPLETE | FI_COMPLETION);
+        send_wr_tswrap.data = last_write_data;
+        res = post_send_rdma(&send_wr_tswrap, last_write_flags);
         ++pending_write_requests_;
       }
     }
@@ -224,6 +241,114 @@ bool InputChannelConnection::send_data(struct iovec* sge,
   return true;
 }
 
+bool InputChannelConnection::send_replica(
+    const struct iovec* sge,
+    void** desc,
+    int num_sge,
+    uint64_t timeslice,
+    uint64_t position,
+    const fles::TimesliceComponentDescriptor& tscdesc) {
+  const uint64_t data_size = UINT64_C(1) << remote_info_.data_buffer_size_exp;
+  const uint64_t desc_mask =
+      (UINT64_C(1) << remote_info_.desc_buffer_size_exp) - 1;
+
+  struct fi_msg_rma send_wr_replica;
+  struct fi_rma_iov rma_iov[1];
+  struct iovec iov;
+  struct fi_custom_context* context;
+  bool res = true;
+
+  // the data at the offset of the primary, wrapping around like there
+  uint64_t offset = tscdesc.offset;
+  for (int i = 0; i < num_sge && res; ++i) {
+    uint64_t done = 0;
+    while (done < sge[i].iov_len && res) {
+      uint64_t target = offset & (data_size - 1);
+      uint64_t len = std::min<uint64_t>(sge[i].iov_len - done,
+                                        data_size - target);
+      iov.iov_base = static_cast<uint8_t*>(sge[i].iov_base) + done;
+      iov.iov_len = len;
+      rma_iov[0].addr = remote_info_.replica_data.addr + target;
+      rma_iov[0].len = len;
+      rma_iov[0].key = remote_info_.replica_data.rkey;
+
+      memset(&send_wr_replica, 0, sizeof(send_wr_replica));
+      send_wr_replica.msg_iov = &iov;
+      send_wr_replica.desc = &desc[i];
+      send_wr_replica.iov_count = 1;
+      send_wr_replica.rma_iov = rma_iov;
+      send_wr_replica.rma_iov_count = 1;
+      send_wr_replica.addr = partner_addr_;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+      context = LibfabricContextPool::getInst()->getContext();
+      context->op_context =
+          (ID_WRITE_REPLICA | (timeslice << 24) | (index_ << 8));
+      send_wr_replica.context = context;
+#pragma GCC diagnostic pop
+      res = post_send_rdma(&send_wr_replica, FI_MORE);
+      done += len;
+      offset += len;
+    }
+  }
+  if (!res)
+    return false;
+
+  // the replica descriptor at the descriptor position of the primary, after
+  // the data
+  ReplicaDescriptor& entry =
+      replica_staging_[replica_staging_index_++ % replica_staging_.size()];
+  entry.position = position;
+  entry.desc = tscdesc;
+  iov.iov_base = &entry;
+  iov.iov_len = sizeof(entry);
+  void* entry_desc = fi_mr_desc(mr_replica_staging_);
+  rma_iov[0].addr = remote_info_.replica_desc.addr +
+                    (position & desc_mask) * sizeof(ReplicaDescriptor);
+  rma_iov[0].len = sizeof(entry);
+  rma_iov[0].key = remote_info_.replica_desc.rkey;
+
+  memset(&send_wr_replica, 0, sizeof(send_wr_replica));
+  send_wr_replica.msg_iov = &iov;
+  send_wr_replica.desc = &entry_desc;
+  send_wr_replica.iov_count = 1;
+  send_wr_replica.rma_iov = rma_iov;
+  send_wr_replica.rma_iov_count = 1;
+  send_wr_replica.addr = partner_addr_;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+  context = LibfabricContextPool::getInst()->getContext();
+  context->op_context = (ID_WRITE_REPLICA | (timeslice << 24) | (index_ << 8));
+  send_wr_replica.context = context;
+#pragma GCC diagnostic pop
+  res = post_send_rdma(&send_wr_replica,
+                       FI_FENCE | FI_DELIVERY_COMPLETE | FI_COMPLETION);
+  if (!res)
+    return false;
+  ++pending_write_requests_;
+  assert(pending_write_requests_ <= max_pending_write_requests_);
+  return true;
+}
+
+void InputChannelConnection::send_replica_reference(uint64_t timeslice,
+                                                    uint64_t replica_pos,
+                                                    uint64_t desc_length,
+                                                    uint64_t data_length,
+                                                    uint64_t skip) {
+  std::pair<uint64_t, uint64_t> last_timeslice_info =
+      InputSchedulerOrchestrator::get_data_and_desc_of_last_timeslice(index_);
+  assert(last_timeslice_info.first == cn_wp_.data + cn_wp_pending_.data);
+
+  fles::TimesliceComponentDescriptor tscdesc;
+  tscdesc.ts_num = timeslice;
+  tscdesc.offset = cn_wp_.data + cn_wp_pending_.data + skip;
+  tscdesc.size = data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
+  tscdesc.num_microslices = desc_length;
+
+  pending_descriptors_.add(last_timeslice_info.second, tscdesc);
+  pending_replicas_[last_timeslice_info.second] = replica_pos;
+}
+
 bool InputChannelConnection::write_request_available() {
   return (pending_write_requests_ < max_pending_write_requests_);
 }
@@ -246,6 +371,15 @@ void InputChannelConnection::check_inc_write_pointers() {
     if (!InputSchedulerOrchestrator::is_timeslice_rdma_acked(index_,
                                                              descriptor.ts_num))
       break;
+    auto replica = pending_replicas_.find(timeslice);
+    if (replica != pending_replicas_.end()) {
+      send_status_message_.replica_pos[added_sent_descriptors_] =
+          replica->second;
+      pending_replicas_.erase(replica);
+    } else {
+      send_status_message_.replica_pos[added_sent_descriptors_] =
+          timeslice_replication::no_replica;
+    }
     send_status_message_.tscdesc_msg[added_sent_descriptors_++] =
         std::make_pair(timeslice, descriptor);
     inc_write_pointers(timeslice_data_address_[0], 1);
@@ -395,6 +529,16 @@ void InputChannelConnection::setup_mr(struct fid_domain* pd) {
   if (mr_send_ == nullptr)
     throw LibfabricException(
         "registration of memory region failed in InputChannelConnection2");
+
+  err = fi_mr_reg(pd, replica_staging_.data(),
+                  replica_staging_.size() * sizeof(ReplicaDescriptor),
+                  FI_WRITE, 0, Provider::requested_key++, 0,
+                  &mr_replica_staging_, nullptr);
+  if (err != 0) {
+    L_(fatal) << "fi_mr_reg failed for replica staging: " << err << "="
+              << fi_strerror(-err);
+    throw LibfabricException("fi_mr_reg failed for replica staging");
+  }
 }
 
 void InputChannelConnection::setup() {
@@ -464,6 +608,11 @@ void InputChannelConnection::dereg_mr() {
     fi_close((struct fid*)mr_send_);
     mr_send_ = nullptr;
   }
+
+  if (mr_replica_staging_ != nullptr) {
+    fi_close((struct fid*)mr_replica_staging_);
+    mr_replica_staging_ = nullptr;
+  }
 #pragma GCC diagnostic pop
 }
 
@@ -513,12 +662,17 @@ void InputChannelConnection::post_send_status_message() {
 
   send_status_message_.descriptor_count = added_sent_descriptors_;
 
-  if (post_send_msg(&send_wr)) {
+  const bool injected = post_inject_msg(&send_wr);
+  if (injected || post_send_msg(&send_wr)) {
     data_changed_ = false;
     data_acked_ = false;
     send_buffer_available_ = false;
     added_sent_descriptors_ = 0;
     msg_send_time_ = std::chrono::high_resolution_clock::now();
+    if (injected) {
+      // there is no completion of an injected message
+      on_complete_send();
+    }
   }
 }
 
@@ -581,6 +735,11 @@ void InputChannelConnection::set_remote_info() {
       this->recv_status_message_.info.desc_buffer_size_exp;
 
   this->remote_info_.index = this->recv_status_message_.info.index;
+
+  this->remote_info_.replica_data =
+      this->recv_status_message_.info.replica_data;
+  this->remote_info_.replica_desc =
+      this->recv_status_message_.info.replica_desc;
 }
 
 void InputChannelConnection::set_last_sent_timeslice(uint64_t sent_ts) {
@@ -739,6 +898,9 @@ void InputChannelConnection::update_cn_wp_after_failure_action(
     pending_descriptors_.remove(pending_descriptors_.get_last_key());
     data_acked_ = true;
   }
+  pending_replicas_.erase(
+      pending_replicas_.upper_bound(last_transmitted_timeslice_info.second),
+      pending_replicas_.end());
   sync_after_scheduling_decision_ = true;
   sync_failed_conn_ = failed_connection_id;
   try_sync_buffer_positions();
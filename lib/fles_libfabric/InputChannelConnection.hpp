@@ -9,13 +9,16 @@
 #include "InputChannelStatusMessage.hpp"
 #include "InputNodeInfo.hpp"
 #include "MicrosliceDescriptor.hpp"
+#include "RemoteCqData.hpp"
 #include "RequestIdentifier.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceReplication.hpp"
 #include "dfs/InputIntervalInfo.hpp"
 #include "dfs/InputSchedulerOrchestrator.hpp"
 
 #include <cassert>
 #include <cstring>
+#include <map>
 #include <rdma/fi_cm.h>
 #include <rdma/fi_rma.h>
 
@@ -51,6 +54,51 @@ public:
 
   bool write_request_available();
 
+  /// Write a replica of a timeslice component sent to a primary compute node
+  /// to the replica buffers of this (standby) compute node.
+  /**
+   \param sge      The data of the component, as passed to send_data()
+   \param position Descriptor position at the primary compute node
+   \param tscdesc  The descriptor at the primary compute node
+   */
+  bool send_replica(const struct iovec* sge,
+                    void** desc,
+                    int num_sge,
+                    uint64_t timeslice,
+                    uint64_t position,
+                    const fles::TimesliceComponentDescriptor& tscdesc);
+
+  /// Check whether the compute node holds replica buffers for a primary.
+  bool accepts_replica_of(const ComputeNodeInfo& primary) const {
+    return remote_info_.replica_data.addr != 0 &&
+           remote_info_.replica_desc.addr != 0 &&
+           remote_info_.data_buffer_size_exp == primary.data_buffer_size_exp &&
+           remote_info_.desc_buffer_size_exp == primary.desc_buffer_size_exp;
+  }
+
+  /// Send the descriptor of a timeslice component that the compute node
+  /// copies from its replica buffers instead of receiving the data.
+  void send_replica_reference(uint64_t timeslice,
+                              uint64_t replica_pos,
+                              uint64_t desc_length,
+                              uint64_t data_length,
+                              uint64_t skip);
+
+  /// Retrieve the position and descriptor of the last sent component.
+  std::pair<uint64_t, fles::TimesliceComponentDescriptor>
+  last_sent_descriptor() const {
+    uint64_t position = pending_descriptors_.get_last_key();
+    return {position, pending_descriptors_.get(position)};
+  }
+
+  const ComputeNodeInfo& remote_info() const { return remote_info_; }
+
+  /// Notify the compute node of each written component through the remote
+  /// CQ data of its last data write, if supported.
+  void set_remote_cq_data(bool remote_cq_data) {
+    remote_cq_data_ = remote_cq_data;
+  }
+
   /// Increment target write pointers after data has been sent.
   void inc_write_pointers(uint64_t data_size, uint64_t desc_size);
 
@@ -169,6 +217,9 @@ private:
   /// Access information for memory regions on remote end.
   ComputeNodeInfo remote_info_ = ComputeNodeInfo();
 
+  /// Whether to send remote CQ data with the last write of a component
+  bool remote_cq_data_ = false;
+
   /// Local copy of acknowledged-by-CN pointers
   ComputeNodeBufferPosition cn_ack_ = ComputeNodeBufferPosition();
 
@@ -182,6 +233,15 @@ private:
   /// Local version of CN write pointers
   ComputeNodeBufferPosition cn_wp_ = ComputeNodeBufferPosition();
 
+  /// Source buffers of the replica descriptor writes
+  std::vector<ReplicaDescriptor> replica_staging_;
+  uint64_t replica_staging_index_ = 0;
+  struct fid_mr* mr_replica_staging_ = nullptr;
+
+  /// Replica positions of the pending descriptors sent as replica
+  /// references <desc_ts, replica position>
+  std::map<uint64_t, uint64_t> pending_replicas_;
+
   ///
   ComputeNodeBufferPosition cn_wp_pending_ = ComputeNodeBufferPosition();
 
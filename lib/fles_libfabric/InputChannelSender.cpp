@@ -15,13 +15,16 @@ InputChannelSender::InputChannelSender(
     std::string input_node_name,
     uint32_t scheduler_interval_length,
     std::string log_directory,
-    bool enable_logging)
+    bool enable_logging,
+    bool remote_cq_data,
+    bool staggered_rounds)
     : ConnectionGroup(input_node_name), input_index_(input_index),
       data_source_(data_source), compute_hostnames_(compute_hostnames),
       compute_services_(compute_services), timeslice_size_(timeslice_size),
       overlap_size_(overlap_size), max_timeslice_number_(max_timeslice_number),
-      min_acked_desc_(data_source.desc_buffer().size() / 4),
-      min_acked_data_(data_source.data_buffer().size() / 4) {
+      ack_coalescing_(data_source.desc_buffer().size() / 4,
+                      data_source.data_buffer().size() / 4),
+      remote_cq_data_(remote_cq_data) {
 
   start_index_desc_ = sent_desc_ = acked_desc_ = cached_acked_desc_ =
       data_source.get_read_index().desc;
@@ -47,6 +50,7 @@ InputChannelSender::InputChannelSender(
       ConstVariables::HEARTBEAT_INACTIVE_RETRY_COUNT, scheduler_interval_length,
       data_source.get_write_index().desc, (timeslice_size + overlap_size),
       start_index_desc_, timeslice_size, log_directory, enable_logging);
+  InputSchedulerOrchestrator::set_staggered_rounds(staggered_rounds);
   InputSchedulerOrchestrator::update_data_source_desc(
       data_source.get_write_index().desc);
 }
@@ -182,6 +186,7 @@ void InputChannelSender::send_timeslices() {
 
     if (next_ts != ConstVariables::MINUS_ONE && next_ts <= up_to_timeslice &&
         next_ts <= max_timeslice_number_ &&
+        InputSchedulerOrchestrator::is_connection_turn(conn_index, next_ts) &&
         try_send_timeslice(next_ts, conn_index)) {
       conn_[conn_index]->set_last_sent_timeslice(next_ts);
     }
@@ -268,9 +273,10 @@ void InputChannelSender::operator()() {
                max_timeslice_number_ &&
            !abort_) {
       scheduler_.timer();
-      poll_completion();
+      const int completions = poll_completion();
       update_compute_schedulers();
       data_source_.proceed();
+      idle_wait(completions > 0);
     }
 
     L_(info) << "[i" << input_index_ << "]"
@@ -280,7 +286,7 @@ void InputChannelSender::operator()() {
     while (acked_desc_ <
            timeslice_size_ * InputSchedulerOrchestrator::get_sent_timeslices() +
                start_index_desc_) {
-      poll_completion();
+      idle_wait(poll_completion() > 0);
       scheduler_.timer();
     }
     sync_data_source(false);
@@ -294,7 +300,7 @@ void InputChannelSender::operator()() {
     L_(debug) << "[i" << input_index_ << "] "
               << "SENDER loop done";
     while (!all_done_) {
-      poll_completion();
+      idle_wait(poll_completion() > 0);
       scheduler_.timer();
     }
     time_end_ = std::chrono::high_resolution_clock::now();
@@ -355,7 +361,19 @@ bool InputChannelSender::try_send_timeslice(uint64_t timeslice, uint32_t cn) {
     total_length += skip;
 
     if (conn_[cn]->check_for_buffer_space(total_length, 1)) {
-      if (post_send_data(timeslice, cn, desc_offset, desc_length, data_offset,
+      // a standby taking over from its failed primary holds the data in its
+      // replica buffers already
+      auto replica = replicas_.find(timeslice);
+      bool from_replica = replica != replicas_.end() &&
+                          replica->second.written &&
+                          replica->second.standby == cn;
+      if (from_replica) {
+        conn_[cn]->send_replica_reference(timeslice, replica->second.position,
+                                          desc_length, data_length, skip);
+        replicas_.erase(replica);
+      }
+      if (from_replica ||
+          post_send_data(timeslice, cn, desc_offset, desc_length, data_offset,
                          data_length, skip)) {
         InputSchedulerOrchestrator::log_timeslice_CB_blocked(cn, timeslice,
                                                              true);
@@ -364,6 +382,11 @@ bool InputChannelSender::try_send_timeslice(uint64_t timeslice, uint32_t cn) {
         conn_[cn]->add_timeslice_data_address(total_length, 1);
         InputSchedulerOrchestrator::mark_timeslice_transmitted(cn, timeslice,
                                                                total_length);
+        if (from_replica) {
+          // there is no write to wait for
+          InputSchedulerOrchestrator::mark_timeslice_rdma_write_acked(
+              cn, timeslice);
+        }
         if (data_end > sent_data_) { // This if condition is needed when the
                                      // timeslice transmissions are out of order
           sent_desc_ = desc_offset + desc_length;
@@ -396,6 +419,7 @@ InputChannelSender::create_input_node_connection(uint_fast16_t index) {
 
   std::unique_ptr<InputChannelConnection> connection(new InputChannelConnection(
       eq_, index, input_index_, max_send_wr, max_pending_write_requests));
+  connection->set_remote_cq_data(remote_cq_data_);
   return connection;
 }
 
@@ -423,10 +447,12 @@ void InputChannelSender::connect() {
 
 void InputChannelSender::on_connected(struct fid_domain* pd) {
   if (mr_data_ == nullptr) {
+    auto begin = std::chrono::steady_clock::now();
+
     // Register memory regions.
     int err =
         fi_mr_reg(pd, const_cast<uint8_t*>(data_source_.data_buffer().ptr()),
-                  data_source_.data_buffer().bytes(), FI_WRITE, 0,
+                  data_source_.data_buffer().mapped_bytes(), FI_WRITE, 0,
                   Provider::requested_key++, 0, &mr_data_, nullptr);
     if (err != 0) {
       L_(fatal) << "fi_mr_reg failed for data_send_buffer: " << err << "="
@@ -442,7 +468,7 @@ void InputChannelSender::on_connected(struct fid_domain* pd) {
     err = fi_mr_reg(pd,
                     const_cast<fles::MicrosliceDescriptor*>(
                         data_source_.desc_buffer().ptr()),
-                    data_source_.desc_buffer().bytes(), FI_WRITE, 0,
+                    data_source_.desc_buffer().mapped_bytes(), FI_WRITE, 0,
                     Provider::requested_key++, 0, &mr_desc_, nullptr);
     if (err != 0) {
       L_(fatal) << "fi_mr_reg failed for desc_send_buffer: " << err << "="
@@ -454,6 +480,12 @@ void InputChannelSender::on_connected(struct fid_domain* pd) {
       L_(fatal) << "fi_mr_reg failed for mr_desc: " << strerror(errno);
       throw LibfabricException("registration of memory region failed");
     }
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    L_(info) << "[i" << input_index_ << "] registered input buffer in "
+             << seconds << " s";
   }
 }
 
@@ -508,9 +540,10 @@ bool InputChannelSender::post_send_data(uint64_t timeslice,
   struct iovec sge[4];
   void* descs[4];
   // descriptors
-  if ((desc_offset & data_source_.desc_buffer().size_mask()) <=
-      ((desc_offset + desc_length - 1) &
-       data_source_.desc_buffer().size_mask())) {
+  if (data_source_.desc_buffer().mirrored() ||
+      (desc_offset & data_source_.desc_buffer().size_mask()) <=
+          ((desc_offset + desc_length - 1) &
+           data_source_.desc_buffer().size_mask())) {
     // one chunk
     sge[num_sge].iov_base = &data_source_.desc_buffer().at(desc_offset);
     sge[num_sge].iov_len = sizeof(fles::MicrosliceDescriptor) * desc_length;
@@ -538,9 +571,10 @@ bool InputChannelSender::post_send_data(uint64_t timeslice,
   // data
   if (data_length == 0) {
     // zero chunks
-  } else if ((data_offset & data_source_.data_buffer().size_mask()) <=
-             ((data_offset + data_length - 1) &
-              data_source_.data_buffer().size_mask())) {
+  } else if (data_source_.data_buffer().mirrored() ||
+             (data_offset & data_source_.data_buffer().size_mask()) <=
+                 ((data_offset + data_length - 1) &
+                  data_source_.data_buffer().size_mask())) {
     // one chunk
     sge[num_sge].iov_base = &data_source_.data_buffer().at(data_offset);
     sge[num_sge].iov_len = data_length;
@@ -559,8 +593,46 @@ bool InputChannelSender::post_send_data(uint64_t timeslice,
     descs[num_sge++] = fi_mr_desc(mr_data_);
   }
 
-  return conn_[cn]->send_data(sge, descs, num_sge, timeslice, desc_length,
-                              data_length, skip);
+  // send_data() cuts the list at the end of the target buffer
+  struct iovec replica_sge[4];
+  std::copy(sge, sge + num_sge, replica_sge);
+
+  if (!conn_[cn]->send_data(sge, descs, num_sge, timeslice, desc_length,
+                            data_length, skip)) {
+    return false;
+  }
+  if (timeslice_replication::selected(timeslice, replication_modulo_)) {
+    send_replica(timeslice, cn, replica_sge, descs, num_sge);
+  }
+  return true;
+}
+
+void InputChannelSender::send_replica(uint64_t timeslice,
+                                      uint32_t cn,
+                                      const struct iovec* sge,
+                                      void** descs,
+                                      int num_sge) {
+  replicas_.erase(timeslice);
+  uint32_t standby = timeslice_replication::standby(cn, conn_.size());
+  // the replica is skipped rather than delaying the primary
+  if (standby == cn ||
+      InputSchedulerOrchestrator::is_connection_timed_out(standby) ||
+      conn_[standby]->done() ||
+      !conn_[standby]->accepts_replica_of(conn_[cn]->remote_info()) ||
+      !conn_[standby]->write_request_available()) {
+    return;
+  }
+  std::pair<uint64_t, fles::TimesliceComponentDescriptor> primary =
+      conn_[cn]->last_sent_descriptor();
+  if (conn_[standby]->send_replica(sge, descs, num_sge, timeslice,
+                                   primary.first, primary.second)) {
+    replicas_[timeslice] = Replica{standby, primary.first, false};
+  }
+}
+
+void InputChannelSender::set_replication_modulo(uint32_t modulo) {
+  replication_modulo_ = modulo;
+  InputSchedulerOrchestrator::set_replication_modulo(modulo);
 }
 
 void InputChannelSender::on_completion(uint64_t wr_id) {
@@ -582,6 +654,17 @@ void InputChannelSender::on_completion(uint64_t wr_id) {
     }
   } break;
 
+  case ID_WRITE_REPLICA: {
+    uint64_t ts = wr_id >> 24;
+
+    uint32_t cn = (wr_id >> 8) & 0xFFFF;
+    conn_[cn]->on_complete_write();
+    auto replica = replicas_.find(ts);
+    if (replica != replicas_.end() && replica->second.standby == cn) {
+      replica->second.written = true;
+    }
+  } break;
+
   case ID_RECEIVE_STATUS: {
     int cn = wr_id >> 8;
     uint64_t last_desc = conn_[cn]->cn_ack_desc();
@@ -698,8 +781,11 @@ void InputChannelSender::update_data_source(uint32_t compute_index,
       acked_desc_ = acked_ts * timeslice_size_ + start_index_desc_;
       acked_data_ = data_source_.desc_buffer().at(acked_desc_ - 1).offset +
                     data_source_.desc_buffer().at(acked_desc_ - 1).size;
-      if (acked_data_ >= cached_acked_data_ + min_acked_data_ ||
-          acked_desc_ >= cached_acked_desc_ + min_acked_desc_) {
+      replicas_.erase(replicas_.begin(), replicas_.lower_bound(acked_ts));
+      // release buffer space the sooner the fuller the buffer is
+      if (ack_coalescing_.due(acked_desc_ - cached_acked_desc_,
+                              acked_data_ - cached_acked_data_,
+                              buffer_fill())) {
         cached_acked_data_ = acked_data_;
         cached_acked_desc_ = acked_desc_;
         data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
@@ -708,6 +794,15 @@ void InputChannelSender::update_data_source(uint32_t compute_index,
   }
 }
 
+double InputChannelSender::buffer_fill() const {
+  uint64_t written_desc = std::max(write_index_desc_, sent_desc_);
+  double fill_desc = static_cast<double>(written_desc - cached_acked_desc_) /
+                     static_cast<double>(data_source_.desc_buffer().size());
+  double fill_data = static_cast<double>(sent_data_ - cached_acked_data_) /
+                     static_cast<double>(data_source_.data_buffer().size());
+  return std::max(fill_desc, fill_data);
+}
+
 void InputChannelSender::mark_connection_completed(uint32_t cn) {
   conn_[cn]->mark_done();
   ++connections_done_;
@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include "AckCoalescing.hpp"
 #include "ConnectionGroup.hpp"
 #include "DualRingBuffer.hpp"
 #include "InputChannelConnection.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "RingBuffer.hpp"
+#include "TimesliceReplication.hpp"
 #include "Utility.hpp"
 #include "dfs/InputIntervalInfo.hpp"
 #include "dfs/InputSchedulerOrchestrator.hpp"
@@ -18,6 +20,7 @@
 #include <cassert>
 #include <chrono>
 #include <iomanip>
+#include <map>
 #include <mutex>
 #include <set>
 #include <string>
@@ -43,7 +46,9 @@ public:
                      std::string input_node_name,
                      uint32_t scheduler_interval_length,
                      std::string log_directory,
-                     bool enable_logging);
+                     bool enable_logging,
+                     bool remote_cq_data = false,
+                     bool staggered_rounds = false);
 
   InputChannelSender(const InputChannelSender&) = delete;
   void operator=(const InputChannelSender&) = delete;
@@ -73,6 +78,10 @@ public:
 
   void on_connected(struct fid_domain* pd) override;
 
+  /// Replicate every modulo-th timeslice to the standby of its compute node
+  /// (0: no replication).
+  void set_replication_modulo(uint32_t modulo);
+
 private:
   /// Handle RDMA_CM_REJECTED event.
   void on_rejected(struct fi_eq_err_entry* event) override;
@@ -89,6 +98,13 @@ private:
                       uint64_t data_length,
                       uint64_t skip);
 
+  /// Write a replica of a timeslice sent to a compute node to its standby.
+  void send_replica(uint64_t timeslice,
+                    uint32_t cn,
+                    const struct iovec* sge,
+                    void** descs,
+                    int num_sge);
+
   /// Completion notification event dispatcher. Called by the event loop.
   void on_completion(uint64_t wr_id) override;
 
@@ -106,6 +122,9 @@ private:
                           uint64_t old_desc,
                           uint64_t new_desc);
 
+  /// Retrieve the fill level of the input buffer (0 to 1).
+  double buffer_fill() const;
+
   /// Mark connection as completed in case of normal termination or failure
   void mark_connection_completed(uint32_t conn_id);
 
@@ -142,8 +161,8 @@ private:
   const uint32_t overlap_size_;
   const uint64_t max_timeslice_number_;
 
-  const uint64_t min_acked_desc_;
-  const uint64_t min_acked_data_;
+  /// Coalescing of read index updates to the data source.
+  const AckCoalescing ack_coalescing_;
 
   uint64_t cached_acked_data_ = 0;
   uint64_t cached_acked_desc_ = 0;
@@ -155,6 +174,22 @@ private:
 
   bool abort_ = false;
 
+  /// Whether to notify compute nodes through remote CQ data
+  bool remote_cq_data_;
+
+  /// Replicate every modulo-th timeslice (0: no replication)
+  uint32_t replication_modulo_ = 0;
+
+  /// A replica of a timeslice at the standby of its compute node.
+  struct Replica {
+    uint32_t standby;  ///< Index of the standby compute node
+    uint64_t position; ///< Descriptor position at the primary
+    bool written;      ///< Whether the replica write has completed
+  };
+
+  /// Replicas of the unacknowledged timeslices <timeslice, replica>
+  std::map<uint64_t, Replica> replicas_;
+
   struct SendBufferStatus {
     std::chrono::system_clock::time_point time;
     uint64_t size;
@@ -38,6 +38,11 @@ struct InputChannelStatusMessage {
   std::pair<uint64_t, fles::TimesliceComponentDescriptor>
       tscdesc_msg[ConstVariables::MAX_DESCRIPTOR_ARRAY_SIZE];
 
+  /// Replica positions of the descriptors in the list, the component is
+  /// copied from the replica buffer instead of being written
+  /// (timeslice_replication::no_replica: component written as usual)
+  uint64_t replica_pos[ConstVariables::MAX_DESCRIPTOR_ARRAY_SIZE];
+
   /// Count of the descriptors in the list
   uint16_t descriptor_count = 0;
 
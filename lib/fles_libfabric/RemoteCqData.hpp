@@ -0,0 +1,51 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tl_libfabric {
+
+/// Encoding of the remote CQ data of the last data write of a component.
+/** The data holds the input index in the lower bits and the descriptor
+    position of the timeslice in the upper bits. The upper bits of the
+    position are truncated, so positions are only unique within a window
+    of the size of the compute node's descriptor buffer. */
+namespace remote_cq_data {
+
+/// Number of bits of the input index.
+constexpr unsigned index_bits = 16;
+
+/// Retrieve the number of bits of the descriptor position.
+/** \param cq_data_size         Size of the provider's remote CQ data
+    \param desc_buffer_size_exp Exponent of the descriptor buffer size
+    \return the number of bits, or 0 if remote CQ data is not usable */
+inline unsigned position_bits(std::size_t cq_data_size,
+                              uint32_t desc_buffer_size_exp) {
+  const std::size_t data_bits = cq_data_size < 8 ? 8 * cq_data_size : 64;
+  if (data_bits < index_bits + desc_buffer_size_exp) {
+    return 0;
+  }
+  return static_cast<unsigned>(data_bits - index_bits);
+}
+
+/// Encode a descriptor position and input index.
+inline uint64_t encode(uint64_t ts_pos, uint32_t input, unsigned bits) {
+  const uint64_t mask = bits < 64 ? (UINT64_C(1) << bits) - 1 : ~UINT64_C(0);
+  return ((ts_pos & mask) << index_bits) | input;
+}
+
+/// Retrieve the input index of encoded data.
+inline uint32_t input(uint64_t data) {
+  return static_cast<uint32_t>(data & ((UINT64_C(1) << index_bits) - 1));
+}
+
+/// Retrieve the descriptor position of encoded data, given the first
+/// position of the window of possible positions.
+inline uint64_t position(uint64_t data, uint64_t base, unsigned bits) {
+  const uint64_t mask = bits < 64 ? (UINT64_C(1) << bits) - 1 : ~UINT64_C(0);
+  return base + (((data >> index_bits) - base) & mask);
+}
+
+} // namespace remote_cq_data
+} // namespace tl_libfabric
@@ -0,0 +1,318 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "ConstVariables.hpp"
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tl_libfabric {
+/// A SizedMap replacement for dense, mostly increasing integer keys (e.g.,
+/// timeslice or interval indices). Entries are stored in a ring indexed by
+/// the key, so no node allocation takes place once the ring has grown to the
+/// span of keys in use. A new key beyond the window of max_map_size keys
+/// evicts the oldest entries, keys older than the window are not accepted.
+template <typename KEY, typename VALUE> class SlidingWindowMap {
+  static_assert(std::is_integral<KEY>::value && std::is_unsigned<KEY>::value,
+                "SlidingWindowMap requires an unsigned integer key");
+
+  struct Slot {
+    std::pair<KEY, VALUE> entry;
+    bool used = false;
+  };
+
+public:
+  class iterator {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<KEY, VALUE>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+
+    iterator() = default;
+
+    reference operator*() const { return map_->slot(key_).entry; }
+    pointer operator->() const { return &map_->slot(key_).entry; }
+
+    iterator& operator++() {
+      end_ = !map_->next_used(key_, &key_);
+      return *this;
+    }
+
+    iterator& operator--() {
+      if (end_) {
+        key_ = map_->last_key_;
+        end_ = false;
+      } else {
+        map_->previous_used(key_, &key_);
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    iterator operator--(int) {
+      iterator old = *this;
+      --*this;
+      return old;
+    }
+
+    bool operator==(const iterator& other) const {
+      return end_ == other.end_ && (end_ || key_ == other.key_);
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+  private:
+    friend class SlidingWindowMap;
+    iterator(SlidingWindowMap* map, KEY key, bool end)
+        : map_(map), key_(key), end_(end) {}
+
+    SlidingWindowMap* map_ = nullptr;
+    KEY key_ = 0;
+    bool end_ = true;
+  };
+
+  SlidingWindowMap(uint32_t max_map_size);
+  SlidingWindowMap();
+
+  bool add(const KEY key, const VALUE val);
+
+  bool update(const KEY key, const VALUE val);
+
+  bool remove(const KEY key);
+
+  bool remove(const iterator it);
+
+  bool contains(const KEY key) const;
+
+  bool empty() const;
+
+  uint32_t size() const;
+
+  VALUE get(const KEY key) const;
+
+  KEY get_last_key() const;
+
+  iterator get_begin_iterator();
+
+  iterator get_iterator(const KEY key);
+
+  iterator get_end_iterator();
+
+private:
+  Slot& slot(KEY key) { return slots_[key & (slots_.size() - 1)]; }
+  const Slot& slot(KEY key) const { return slots_[key & (slots_.size() - 1)]; }
+
+  // Grow the ring so that it covers the keys from first_key_ to key
+  void reserve(KEY key);
+
+  // Release the entries with keys older than first_key
+  void evict_before(KEY first_key);
+
+  // Find the closest used key after/before key, false if there is none
+  bool next_used(KEY key, KEY* next) const;
+  bool previous_used(KEY key, KEY* previous) const;
+
+  std::vector<Slot> slots_;
+  KEY first_key_ = 0;
+  KEY last_key_ = 0;
+  uint32_t size_ = 0;
+  const uint32_t MAX_MAP_SIZE_;
+};
+
+template <typename KEY, typename VALUE>
+SlidingWindowMap<KEY, VALUE>::SlidingWindowMap(uint32_t max_map_size)
+    : slots_(1), MAX_MAP_SIZE_(max_map_size) {
+  assert(max_map_size > 0);
+}
+
+template <typename KEY, typename VALUE>
+SlidingWindowMap<KEY, VALUE>::SlidingWindowMap()
+    : SlidingWindowMap(ConstVariables::MAX_HISTORY_SIZE) {}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::add(const KEY key, const VALUE val) {
+  if (contains(key)) {
+    return false;
+  }
+
+  if (empty()) {
+    first_key_ = last_key_ = key;
+  } else if (key < first_key_) {
+    if (last_key_ - key >= MAX_MAP_SIZE_) {
+      return false;
+    }
+    reserve(key);
+    first_key_ = key;
+  } else if (key > last_key_) {
+    if (key - first_key_ >= MAX_MAP_SIZE_) {
+      evict_before(key - MAX_MAP_SIZE_ + 1);
+    }
+    if (empty()) {
+      first_key_ = key;
+    }
+    reserve(key);
+    last_key_ = key;
+  }
+
+  Slot& s = slot(key);
+  s.entry = std::pair<KEY, VALUE>(key, val);
+  s.used = true;
+  ++size_;
+
+  return true;
+}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::update(const KEY key, const VALUE val) {
+  if (!contains(key)) {
+    return false;
+  }
+
+  slot(key).entry.second = val;
+
+  return true;
+}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::remove(const KEY key) {
+  if (!contains(key)) {
+    return false;
+  }
+
+  Slot& s = slot(key);
+  s.used = false;
+  s.entry.second = VALUE();
+  --size_;
+
+  if (!empty()) {
+    if (key == first_key_) {
+      next_used(key, &first_key_);
+    }
+    if (key == last_key_) {
+      previous_used(key, &last_key_);
+    }
+  }
+  return true;
+}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::remove(const iterator it) {
+  if (it != get_end_iterator()) {
+    return remove(it->first);
+  }
+  return false;
+}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::contains(const KEY key) const {
+  if (empty() || key < first_key_ || key > last_key_) {
+    return false;
+  }
+  const Slot& s = slot(key);
+  return s.used && s.entry.first == key;
+}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::empty() const {
+  return size_ == 0;
+}
+
+template <typename KEY, typename VALUE>
+uint32_t SlidingWindowMap<KEY, VALUE>::size() const {
+  return size_;
+}
+
+template <typename KEY, typename VALUE>
+VALUE SlidingWindowMap<KEY, VALUE>::get(const KEY key) const {
+  assert(contains(key));
+  return slot(key).entry.second;
+}
+
+template <typename KEY, typename VALUE>
+KEY SlidingWindowMap<KEY, VALUE>::get_last_key() const {
+  assert(!empty());
+  return last_key_;
+}
+
+template <typename KEY, typename VALUE>
+typename SlidingWindowMap<KEY, VALUE>::iterator
+SlidingWindowMap<KEY, VALUE>::get_begin_iterator() {
+  return iterator(this, first_key_, empty());
+}
+
+template <typename KEY, typename VALUE>
+typename SlidingWindowMap<KEY, VALUE>::iterator
+SlidingWindowMap<KEY, VALUE>::get_iterator(const KEY key) {
+  return contains(key) ? iterator(this, key, false) : get_end_iterator();
+}
+
+template <typename KEY, typename VALUE>
+typename SlidingWindowMap<KEY, VALUE>::iterator
+SlidingWindowMap<KEY, VALUE>::get_end_iterator() {
+  return iterator(this, 0, true);
+}
+
+template <typename KEY, typename VALUE>
+void SlidingWindowMap<KEY, VALUE>::reserve(KEY key) {
+  KEY low = key < first_key_ ? key : first_key_;
+  KEY high = key > last_key_ ? key : last_key_;
+  size_t span = static_cast<size_t>(high - low) + 1;
+  if (span <= slots_.size()) {
+    return;
+  }
+
+  size_t new_size = slots_.size();
+  while (new_size < span) {
+    new_size *= 2;
+  }
+  std::vector<Slot> slots(new_size);
+  for (Slot& s : slots_) {
+    if (s.used) {
+      slots[s.entry.first & (new_size - 1)] = std::move(s);
+    }
+  }
+  slots_.swap(slots);
+}
+
+template <typename KEY, typename VALUE>
+void SlidingWindowMap<KEY, VALUE>::evict_before(KEY first_key) {
+  while (!empty() && first_key_ < first_key) {
+    remove(first_key_);
+  }
+}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::next_used(KEY key, KEY* next) const {
+  while (key < last_key_) {
+    ++key;
+    if (contains(key)) {
+      *next = key;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KEY, typename VALUE>
+bool SlidingWindowMap<KEY, VALUE>::previous_used(KEY key,
+                                                 KEY* previous) const {
+  while (key > first_key_) {
+    --key;
+    if (contains(key)) {
+      *previous = key;
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace tl_libfabric
@@ -19,12 +19,13 @@ TimesliceBuilder::TimesliceBuilder(
     uint32_t scheduler_speedup_difference_percentage,
     uint32_t scheduler_speedup_percentage,
     uint32_t scheduler_speedup_interval_count,
+    uint32_t scheduler_ewma_weight,
     std::string log_directory,
-    bool enable_logging)
+    bool enable_logging,
+    bool remote_cq_data)
     : ConnectionGroup(local_node_name), compute_index_(compute_index),
       timeslice_buffer_(timeslice_buffer), service_(service),
       num_input_nodes_(num_input_nodes), timeslice_size_(timeslice_size),
-      ack_(timeslice_buffer_.get_desc_size_exp()),
       signal_status_(signal_status), local_node_name_(local_node_name),
       drop_(drop), log_directory_(log_directory) {
   listening_cq_ = nullptr;
@@ -35,6 +36,15 @@ TimesliceBuilder::TimesliceBuilder(
   } else {
     connection_oriented_ = false;
   }
+  if (remote_cq_data) {
+    remote_cq_data_bits_ = remote_cq_data::position_bits(
+        Provider::getInst()->get_info()->domain_attr->cq_data_size,
+        timeslice_buffer_.get_desc_size_exp());
+    if (remote_cq_data_bits_ == 0) {
+      L_(warning) << "[c" << compute_index_ << "] "
+                  << "remote CQ data too small, not used";
+    }
+  }
   DDSchedulerOrchestrator::initialize(
       compute_index, num_input_nodes, ConstVariables::INIT_HEARTBEAT_TIMEOUT,
       ConstVariables::HEARTBEAT_TIMEOUT_HISTORY_SIZE,
@@ -43,7 +53,7 @@ TimesliceBuilder::TimesliceBuilder(
       ConstVariables::HEARTBEAT_INACTIVE_RETRY_COUNT, scheduler_history_size,
       scheduler_interval_length, scheduler_speedup_difference_percentage,
       scheduler_speedup_percentage, scheduler_speedup_interval_count,
-      log_directory, enable_logging);
+      scheduler_ewma_weight, log_directory, enable_logging);
 }
 
 TimesliceBuilder::~TimesliceBuilder() {}
@@ -79,11 +89,9 @@ void TimesliceBuilder::report_status() {
     //
   }
   // LOGGING
-  int last_second = -1;
-  if (!buffer_status_.empty())
-    last_second = (--buffer_status_.end())->first;
-  buffer_status_.insert(std::pair<uint64_t, std::vector<double>>(
-      (last_second + 1), buffer_percentage));
+  uint64_t second =
+      buffer_status_.empty() ? 0 : buffer_status_.get_last_key() + 1;
+  buffer_status_.add(second, buffer_percentage);
   //
 
   scheduler_.add(std::bind(&TimesliceBuilder::report_status, this),
@@ -223,6 +231,11 @@ void TimesliceBuilder::bootstrap_wo_connections() {
         eq_, pd_, completion_queue(index), av_, index, compute_index_, data_ptr,
         timeslice_buffer_.get_data_size_exp(), desc_ptr,
         timeslice_buffer_.get_desc_size_exp()));
+    if (const auto* device_data = timeslice_buffer_.get_device_data();
+        device_data != nullptr) {
+      conn->set_data_device(device_data->device());
+    }
+    setup_replica_buffers(*conn, index);
     conn->setup_mr(pd_);
     conn->setup();
     conn_.at(index) = std::move(conn);
@@ -337,9 +350,10 @@ void TimesliceBuilder::operator()() {
     sync_heartbeat();
     while (!all_done_ || connected_ != 0) {
       if (!all_done_) {
-        poll_completion();
+        const int completions = poll_completion();
         process_completed_timeslices();
         poll_ts_completion();
+        idle_wait(completions > 0);
       }
       if (connected_ != 0) {
         poll_cm_events();
@@ -377,9 +391,9 @@ void TimesliceBuilder::build_time_file() {
       log_file << "Conn_" << i << std::setw(25);
     log_file << "\n";
 
-    std::map<uint64_t, std::vector<double>>::iterator it =
-        buffer_status_.begin();
-    while (it != buffer_status_.end()) {
+    SlidingWindowMap<uint64_t, std::vector<double>>::iterator it =
+        buffer_status_.get_begin_iterator();
+    while (it != buffer_status_.get_end_iterator()) {
       log_file << std::setw(25) << it->first << std::setw(25);
       for (uint32_t i = 0; i < it->second.size(); i++)
         log_file << it->second[i] << std::setw(25);
@@ -414,11 +428,40 @@ void TimesliceBuilder::on_connect_request(struct fi_eq_cm_entry* event,
                                 timeslice_buffer_.get_data_size_exp(),
                                 timeslice_buffer_.get_desc_ptr(index),
                                 timeslice_buffer_.get_desc_size_exp()));
+  if (const auto* device_data = timeslice_buffer_.get_device_data();
+      device_data != nullptr) {
+    conn->set_data_device(device_data->device());
+  }
+  setup_replica_buffers(*conn, index);
   conn_.at(index) = std::move(conn);
 
   conn_.at(index)->on_connect_request(event, pd_, completion_queue(index));
 }
 
+void TimesliceBuilder::setup_replica_buffers(ComputeNodeConnection& conn,
+                                             size_t index) {
+  if (!hot_standby_) {
+    return;
+  }
+  if (timeslice_buffer_.get_device_data() != nullptr) {
+    if (index == 0) {
+      L_(warning) << "[c" << compute_index_ << "] "
+                  << "no hot standby with timeslice buffer in GPU memory";
+    }
+    return;
+  }
+  if (replica_data_.empty()) {
+    replica_data_.resize(conn_.size());
+    replica_desc_.resize(conn_.size());
+  }
+  replica_data_.at(index) = std::make_unique<uint8_t[]>(
+      UINT64_C(1) << timeslice_buffer_.get_data_size_exp());
+  replica_desc_.at(index) = std::make_unique<ReplicaDescriptor[]>(
+      UINT64_C(1) << timeslice_buffer_.get_desc_size_exp());
+  conn.set_replica_buffers(replica_data_.at(index).get(),
+                           replica_desc_.at(index).get());
+}
+
 /// Completion notification event dispatcher. Called by the event loop.
 void TimesliceBuilder::on_completion(uint64_t wr_id) {
   size_t in = wr_id >> 8;
@@ -458,26 +501,35 @@ void TimesliceBuilder::on_completion(uint64_t wr_id) {
 }
 
 void TimesliceBuilder::poll_ts_completion() {
-  while (1) {
-    fles::TimesliceCompletion c;
-    if (!timeslice_buffer_.try_receive_completion(c))
-      return;
-    if (c.ts_pos == acked_) {
-      do
-        ++acked_;
-      while (ack_.at(acked_) > c.ts_pos);
-      for (auto& connection : conn_) {
-        // check timed out timeslice
-        if (acked_ > connection->cn_wp().desc)
-          continue;
-        connection->inc_ack_pointers(acked_);
-      }
-    } else
-      ack_.at(c.ts_pos) = c.ts_pos;
+  timeslice_buffer_.receive_completions();
+  if (timeslice_buffer_.acked() == acked_)
+    return;
+  acked_ = timeslice_buffer_.acked();
+  for (auto& connection : conn_) {
+    // check timed out timeslice
+    if (acked_ > connection->cn_wp().desc)
+      continue;
+    connection->inc_ack_pointers(acked_);
   }
 }
 
+void TimesliceBuilder::on_remote_cq_data(uint64_t data) {
+  if (remote_cq_data_bits_ == 0) {
+    return;
+  }
+  uint64_t ts_pos = remote_cq_data::position(data, completely_written_,
+                                             remote_cq_data_bits_);
+  ++written_components_[ts_pos];
+}
+
 bool TimesliceBuilder::check_complete_timeslices(uint64_t ts_pos) {
+  // all components announced as written, no need to scan the descriptors
+  auto written = written_components_.find(ts_pos);
+  if (written != written_components_.end() &&
+      written->second == conn_.size()) {
+    return true;
+  }
+
   bool all_received = true;
   for (uint32_t indx = 0; indx < conn_.size(); indx++) {
     const fles::TimesliceComponentDescriptor& acked_ts =
@@ -535,6 +587,9 @@ void TimesliceBuilder::process_completed_timeslices() {
     }
   }
   completely_written_ = new_completely_written + 1;
+  written_components_.erase(
+      written_components_.begin(),
+      written_components_.lower_bound(completely_written_));
 }
 
 void TimesliceBuilder::sync_heartbeat() {
@@ -5,11 +5,13 @@
 #include "ChildProcessManager.hpp"
 #include "ComputeNodeConnection.hpp"
 #include "ConnectionGroup.hpp"
+#include "RemoteCqData.hpp"
 #include "RequestIdentifier.hpp"
 #include "RingBuffer.hpp"
+#include "SlidingWindowMap.hpp"
 #include "TimesliceBuffer.hpp"
-#include "TimesliceCompletion.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceReplication.hpp"
 #include "TimesliceWorkItem.hpp"
 #include "dfs/DDSchedulerOrchestrator.hpp"
 
@@ -22,6 +24,7 @@
 #include <cstdint>
 #include <iomanip>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -48,8 +51,10 @@ public:
                    uint32_t scheduler_speedup_difference_percentage,
                    uint32_t scheduler_speedup_percentage,
                    uint32_t scheduler_speedup_interval_count,
+                   uint32_t scheduler_ewma_weight,
                    std::string log_directory,
-                   bool enable_logging);
+                   bool enable_logging,
+                   bool remote_cq_data = false);
 
   TimesliceBuilder(const TimesliceBuilder&) = delete;
   void operator=(const TimesliceBuilder&) = delete;
@@ -72,9 +77,19 @@ public:
   /// Completion notification event dispatcher. Called by the event loop.
   void on_completion(uint64_t wr_id) override;
 
+  /// Record a component written as announced by remote CQ data.
+  void on_remote_cq_data(uint64_t data) override;
+
   void poll_ts_completion();
 
+  /// Hold replica buffers as hot standby of the previous compute node
+  /// (before the connections are set up).
+  void set_hot_standby(bool hot_standby) { hot_standby_ = hot_standby; }
+
 private:
+  /// Allocate the replica buffers of a connection if hot standby
+  void setup_replica_buffers(ComputeNodeConnection& conn, size_t index);
+
   /// setup connections between nodes
   void bootstrap_with_connections();
 
@@ -132,8 +147,18 @@ private:
   uint64_t completely_written_ = 0;
   uint64_t acked_ = 0;
 
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
+  /// Number of bits of the positions in remote CQ data (0: not used)
+  unsigned remote_cq_data_bits_ = 0;
+
+  /// Number of components written per timeslice, from remote CQ data
+  std::map<uint64_t, uint32_t> written_components_;
+
+  /// Whether to hold replica buffers for the previous compute node
+  bool hot_standby_ = false;
+
+  /// Replica buffers of each connection
+  std::vector<std::unique_ptr<uint8_t[]>> replica_data_;
+  std::vector<std::unique_ptr<ReplicaDescriptor[]>> replica_desc_;
 
   volatile sig_atomic_t* signal_status_;
 
@@ -142,11 +167,7 @@ private:
   bool drop_;
 
   // LOGGING
-  std::map<uint64_t, double> first_last_arrival_diff_;
-  std::map<uint64_t, std::chrono::high_resolution_clock::time_point>
-      first_arrival_time_;
-  std::map<uint64_t, uint32_t> arrival_count_;
-  std::map<uint64_t, std::vector<double>> buffer_status_;
+  SlidingWindowMap<uint64_t, std::vector<double>> buffer_status_;
   std::string log_directory_;
   // END OF LOGGING
 };
@@ -103,8 +103,8 @@ bool ComputeTimesliceManager::undo_log_contribution_arrival(
 }
 
 void ComputeTimesliceManager::log_timeout_timeslice() {
-  SizedMap<uint64_t, std::chrono::high_resolution_clock::time_point>::iterator
-      it;
+  SlidingWindowMap<uint64_t,
+                   std::chrono::high_resolution_clock::time_point>::iterator it;
   double taken_duration;
   uint64_t timeslice;
   while (!timeslice_first_arrival_time_.empty()) {
@@ -166,7 +166,7 @@ void ComputeTimesliceManager::generate_log_files() {
 
   log_file << std::setw(25) << "Timeslice" << std::setw(25) << "Diff"
            << "\n";
-  SizedMap<uint64_t, double>::iterator it =
+  SlidingWindowMap<uint64_t, double>::iterator it =
       timeslice_completion_duration_.get_begin_iterator();
   while (it != timeslice_completion_duration_.get_end_iterator()) {
     log_file << std::setw(25) << it->first << std::setw(25) << it->second
@@ -3,7 +3,7 @@
 #pragma once
 
 #include "ConstVariables.hpp"
-#include "SizedMap.hpp"
+#include "SlidingWindowMap.hpp"
 
 #include <cassert>
 #include <chrono>
@@ -66,11 +66,11 @@ private:
   void trigger_timeslice_completion(uint64_t timeslice);
 
   // The first arrival time of each timeslice
-  SizedMap<uint64_t, std::chrono::high_resolution_clock::time_point>
+  SlidingWindowMap<uint64_t, std::chrono::high_resolution_clock::time_point>
       timeslice_first_arrival_time_;
 
   // Counts the number of received contributions of each timeslice
-  SizedMap<uint64_t, std::set<uint32_t>*> timeslice_arrived_count_;
+  SlidingWindowMap<uint64_t, std::set<uint32_t>*> timeslice_arrived_count_;
 
   // The singleton instance for this class
   static ComputeTimesliceManager* instance_;
@@ -94,9 +94,9 @@ private:
 
   // LOGGING
   // Time to complete each timeslice
-  SizedMap<uint64_t, double> timeslice_completion_duration_;
+  SlidingWindowMap<uint64_t, double> timeslice_completion_duration_;
 
   // The timed out Timeslices <Timeslice_id, duration since first arrival>
-  SizedMap<uint64_t, double> timeslice_timed_out_;
+  SlidingWindowMap<uint64_t, double> timeslice_timed_out_;
 };
 } // namespace tl_libfabric
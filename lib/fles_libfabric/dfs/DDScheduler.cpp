@@ -2,10 +2,6 @@
 
 #include "DDScheduler.hpp"
 
-// TO BE REMOVED
-#include <fstream>
-#include <iomanip>
-
 namespace tl_libfabric {
 // PUBLIC
 
@@ -16,19 +12,39 @@ DDScheduler* DDScheduler::get_instance(uint32_t scheduler_index,
                                        uint32_t speedup_difference_percentage,
                                        uint32_t speedup_percentage,
                                        uint32_t speedup_interval_count,
+                                       uint32_t ewma_weight_percentage,
                                        std::string log_directory,
                                        bool enable_logging) {
   if (instance_ == nullptr) {
     instance_ = new DDScheduler(
         scheduler_index, input_scheduler_count, history_size, interval_length,
         speedup_difference_percentage, speedup_percentage,
-        speedup_interval_count, log_directory, enable_logging);
+        speedup_interval_count, ewma_weight_percentage, log_directory,
+        enable_logging);
   }
   return instance_;
 }
 
 DDScheduler* DDScheduler::get_instance() { return instance_; }
 
+std::unique_ptr<DDScheduler>
+DDScheduler::create(uint32_t scheduler_index,
+                    uint32_t input_scheduler_count,
+                    uint32_t history_size,
+                    uint32_t interval_length,
+                    uint32_t speedup_difference_percentage,
+                    uint32_t speedup_percentage,
+                    uint32_t speedup_interval_count,
+                    uint32_t ewma_weight_percentage,
+                    std::string log_directory,
+                    bool enable_logging) {
+  return std::unique_ptr<DDScheduler>(new DDScheduler(
+      scheduler_index, input_scheduler_count, history_size, interval_length,
+      speedup_difference_percentage, speedup_percentage,
+      speedup_interval_count, ewma_weight_percentage, log_directory,
+      enable_logging));
+}
+
 void DDScheduler::update_clock_offset(
     uint32_t input_index,
     std::chrono::high_resolution_clock::time_point local_time,
@@ -47,7 +63,7 @@ void DDScheduler::update_clock_offset(
           interval_index)) {
     input_scheduler_info_[input_index]->clock_offset =
         std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::high_resolution_clock::now() - local_time)
+            SchedulerClock::now() - local_time)
             .count() -
         median_latency;
   }
@@ -69,6 +85,7 @@ void DDScheduler::add_actual_meta_data(uint32_t input_index,
       input_scheduler_info_[input_index]->clock_offset);
   input_scheduler_info_[input_index]->interval_info_.add(
       meta_data.interval_index, meta_data);
+  update_round_duration_model(input_index, meta_data);
 
   trigger_complete_interval(meta_data.interval_index);
 }
@@ -98,37 +115,33 @@ uint64_t DDScheduler::get_last_completed_interval() {
   return actual_interval_meta_data_.get_last_key();
 }
 
-// Generate log files of the stored data
+// Write the remaining log entries and close the log files
 void DDScheduler::generate_log_files() {
-  if (!enable_logging_)
+  if (!interval_log_)
     return;
 
-  std::ofstream log_file;
-  log_file.open(log_directory_ + "/" + std::to_string(scheduler_index_) +
-                ".compute.min_max_interval_info.out");
-
-  log_file << std::setw(25) << "Interval" << std::setw(25) << "Min start"
-           << std::setw(25) << "Max start" << std::setw(25) << "Min duration"
-           << std::setw(25) << "Max duration" << std::setw(25)
-           << "Proposed duration" << std::setw(25) << "Enhanced duration"
-           << std::setw(25) << "Speedup Factor" << std::setw(25) << "Rounds"
-           << "\n";
-
-  for (SizedMap<uint64_t, IntervalDataLog*>::iterator it =
-           interval_info_logger_.get_begin_iterator();
-       it != interval_info_logger_.get_end_iterator(); ++it) {
-    log_file << std::setw(25) << it->first << std::setw(25)
-             << it->second->min_start << std::setw(25) << it->second->max_start
-             << std::setw(25) << it->second->min_duration << std::setw(25)
-             << it->second->max_duration << std::setw(25)
-             << it->second->proposed_duration << std::setw(25)
-             << it->second->enhanced_duration << std::setw(25)
-             << it->second->speedup_applied << std::setw(25)
-             << it->second->rounds_count << "\n";
+  // intervals that have been proposed, but not completed
+  while (!interval_info_logger_.empty()) {
+    SlidingWindowMap<uint64_t, IntervalDataLog*>::iterator it =
+        interval_info_logger_.get_begin_iterator();
+    log_interval(it->first, *it->second);
+    delete it->second;
+    interval_info_logger_.remove(it);
   }
 
-  log_file.flush();
-  log_file.close();
+  if (interval_log_->dropped() != 0) {
+    L_(warning) << "[DDScheduler] " << interval_log_->dropped()
+                << " interval log entries dropped";
+  }
+  interval_log_.reset();
+}
+
+void DDScheduler::log_interval(uint64_t interval_index,
+                               const IntervalDataLog& entry) {
+  interval_log_->append(interval_index, entry.min_start, entry.max_start,
+                        entry.min_duration, entry.max_duration,
+                        entry.proposed_duration, entry.enhanced_duration,
+                        entry.speedup_applied ? 1 : 0, entry.rounds_count);
 }
 
 // PRIVATE
@@ -139,6 +152,7 @@ DDScheduler::DDScheduler(uint32_t scheduler_index,
                          uint32_t speedup_difference_percentage,
                          uint32_t speedup_percentage,
                          uint32_t speedup_interval_count,
+                         uint32_t ewma_weight_percentage,
                          std::string log_directory,
                          bool enable_logging)
     : scheduler_index_(scheduler_index),
@@ -147,8 +161,23 @@ DDScheduler::DDScheduler(uint32_t scheduler_index,
       speedup_difference_percentage_(speedup_difference_percentage),
       speedup_percentage_(speedup_percentage),
       speedup_interval_count_(speedup_interval_count),
+      ewma_weight_(std::min(ewma_weight_percentage, 100U) / 100.0),
       log_directory_(log_directory), enable_logging_(enable_logging) {
 
+  if (enable_logging_) {
+    std::vector<RecordLog::Column> columns;
+    for (const char* name :
+         {"Interval", "Min start", "Max start", "Min duration", "Max duration",
+          "Proposed duration", "Enhanced duration", "Speedup Factor",
+          "Rounds"}) {
+      columns.push_back({name, RecordLog::Type::Unsigned});
+    }
+    interval_log_ = std::make_unique<RecordLog>(
+        log_directory_ + "/" + std::to_string(scheduler_index_) +
+            ".compute.min_max_interval_info.bin",
+        columns);
+  }
+
   // TODO check correctness
   compute_node_count_ = input_connection_count;
   for (uint_fast16_t i = 0; i < input_connection_count; i++)
@@ -202,6 +231,9 @@ void DDScheduler::calculate_interval_info(uint64_t interval_index) {
   }
 
   // LOGGING
+  if (!interval_log_) {
+    return;
+  }
   uint64_t min_start_time =
       std::chrono::duration_cast<std::chrono::milliseconds>(
           get_start_time_statistics(interval_index, 0, 1) - begin_time_)
@@ -216,13 +248,15 @@ void DDScheduler::calculate_interval_info(uint64_t interval_index) {
     interval_log->max_start = max_start_time;
     interval_log->min_duration = get_duration_statistics(interval_index, 0, 1);
     interval_log->max_duration = get_duration_statistics(interval_index, 0, 0);
+    log_interval(interval_index, *interval_log);
+    interval_info_logger_.remove(interval_index);
+    delete interval_log;
   } else {
-    interval_info_logger_.add(
-        interval_index,
-        new IntervalDataLog(min_start_time, max_start_time,
-                            get_duration_statistics(interval_index, 0, 1),
-                            get_duration_statistics(interval_index, 0, 0),
-                            average_round_count));
+    log_interval(interval_index,
+                 IntervalDataLog(min_start_time, max_start_time,
+                                 get_duration_statistics(interval_index, 0, 1),
+                                 get_duration_statistics(interval_index, 0, 0),
+                                 average_round_count));
   }
   //
 }
@@ -251,10 +285,22 @@ DDScheduler::calculate_proposed_interval_meta_data(uint64_t interval_index) {
       compute_node_count_ - compute_node_timeout_count_;
 
   uint64_t median_interval_duration = get_median_interval_duration_history();
-  uint64_t new_interval_duration =
-      get_enhanced_interval_duration(interval_index);
   uint32_t round_count = floor(interval_length_ / active_compute_count);
   round_count = round_count == 0 ? 1 : round_count;
+  uint64_t new_interval_duration;
+  uint64_t predicted_round_duration = get_predicted_round_duration();
+  if (predicted_round_duration != 0) {
+    // model-based: intervals take as long as the slowest input predicts
+    median_interval_duration =
+        predicted_round_duration * last_interval_info->round_count;
+    new_interval_duration = predicted_round_duration * round_count;
+    L_(debug) << "[" << scheduler_index_ << "] predicted round duration "
+              << predicted_round_duration << " us ("
+              << active_compute_count * 1000000.0 / predicted_round_duration
+              << " ts/s)";
+  } else {
+    new_interval_duration = get_enhanced_interval_duration(interval_index);
+  }
 
   std::chrono::high_resolution_clock::time_point new_start_time =
       last_interval_info->start_time +
@@ -280,11 +326,14 @@ DDScheduler::calculate_proposed_interval_meta_data(uint64_t interval_index) {
   proposed_interval_meta_data_.add(interval_index, new_interval_metadata);
 
   // LOGGING
-  uint64_t median_duration = get_median_interval_duration_history();
-  interval_info_logger_.add(
-      interval_index,
-      new IntervalDataLog(median_duration, new_interval_duration, round_count,
-                          new_interval_duration != median_duration ? 1 : 0));
+  if (interval_log_) {
+    uint64_t median_duration = get_median_interval_duration_history();
+    interval_info_logger_.add(
+        interval_index,
+        new IntervalDataLog(median_duration, new_interval_duration,
+                            round_count,
+                            new_interval_duration != median_duration ? 1 : 0));
+  }
 
   return new_interval_metadata;
 }
@@ -469,7 +518,7 @@ uint64_t DDScheduler::get_max_round_duration_history() {
   if (actual_interval_meta_data_.size() < required_size)
     required_size = actual_interval_meta_data_.size();
 
-  SizedMap<uint64_t, IntervalMetaData*>::iterator it =
+  SlidingWindowMap<uint64_t, IntervalMetaData*>::iterator it =
       actual_interval_meta_data_.get_end_iterator();
   do {
     --it;
@@ -550,7 +599,7 @@ uint64_t DDScheduler::get_median_interval_duration_history() {
   if (actual_interval_meta_data_.size() < required_size)
     required_size = actual_interval_meta_data_.size();
 
-  SizedMap<uint64_t, IntervalMetaData*>::iterator it =
+  SlidingWindowMap<uint64_t, IntervalMetaData*>::iterator it =
       actual_interval_meta_data_.get_end_iterator();
   do {
     --it;
@@ -566,6 +615,30 @@ uint64_t DDScheduler::get_median_interval_duration_history() {
                                    : durations[durations.size() / 2];
 }
 
+void DDScheduler::update_round_duration_model(
+    uint32_t input_index, const IntervalMetaData& meta_data) {
+  if (ewma_weight_ == 0 || meta_data.round_count == 0)
+    return;
+  double round_duration = static_cast<double>(meta_data.interval_duration) /
+                          meta_data.round_count;
+  double& ewma = input_scheduler_info_[input_index]->round_duration_ewma;
+  ewma = ewma == 0 ? round_duration
+                   : ewma_weight_ * round_duration + (1 - ewma_weight_) * ewma;
+}
+
+uint64_t DDScheduler::get_predicted_round_duration() {
+  if (ewma_weight_ == 0)
+    return 0;
+  double max_ewma = 0;
+  for (const InputSchedulerData* info : input_scheduler_info_) {
+    // no prediction until every input contributed to the model
+    if (info->round_duration_ewma == 0)
+      return 0;
+    max_ewma = std::max(max_ewma, info->round_duration_ewma);
+  }
+  return static_cast<uint64_t>(ceil(max_ewma));
+}
+
 void DDScheduler::update_compute_node_timeout_count(uint32_t timeout_count) {
   assert(timeout_count >= compute_node_timeout_count_);
   if (compute_node_timeout_count_ != timeout_count) {
@@ -4,7 +4,9 @@
 
 #include "ConstVariables.hpp"
 #include "IntervalMetaData.hpp"
-#include "SizedMap.hpp"
+#include "RecordLog.hpp"
+#include "SchedulerClock.hpp"
+#include "SlidingWindowMap.hpp"
 
 #include <cassert>
 #include <chrono>
@@ -13,6 +15,7 @@
 #include <log.hpp>
 #include <map>
 #include <math.h>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -32,12 +35,26 @@ public:
                                    uint32_t speedup_difference_percentage,
                                    uint32_t speedup_percentage,
                                    uint32_t speedup_interval_count,
+                                   uint32_t ewma_weight_percentage,
                                    std::string log_directory,
                                    bool enable_logging);
 
   // Get singleton instance
   static DDScheduler* get_instance();
 
+  // Create an instance independent of the singleton (e.g., for simulation)
+  static std::unique_ptr<DDScheduler>
+  create(uint32_t scheduler_index,
+         uint32_t input_connection_count,
+         uint32_t history_size,
+         uint32_t interval_duration,
+         uint32_t speedup_difference_percentage,
+         uint32_t speedup_percentage,
+         uint32_t speedup_interval_count,
+         uint32_t ewma_weight_percentage,
+         std::string log_directory,
+         bool enable_logging);
+
   // Set the input nodes count
   void
   update_clock_offset(uint32_t input_index,
@@ -63,7 +80,7 @@ public:
   // Update the timeout connection count
   void update_compute_node_timeout_count(uint32_t timeout_count);
 
-  // Generate log files of the stored data
+  // Write the remaining log entries and close the log files
   void generate_log_files();
 
 private:
@@ -71,10 +88,12 @@ private:
     // uint32_t index_;
     // std::chrono::high_resolution_clock::time_point MPI_Barrier_time;
     int64_t clock_offset = 0;
+    /// exponentially weighted moving average of the round duration (us)
+    double round_duration_ewma = 0;
     /// <interval index, <actual_start_time,duration>>. Duration is the
     /// spent time from sending the contribution till getting the
     /// acknowledgement
-    SizedMap<uint64_t, IntervalMetaData> interval_info_;
+    SlidingWindowMap<uint64_t, IntervalMetaData> interval_info_;
   };
 
   // LOGGING
@@ -118,6 +137,7 @@ private:
               uint32_t speedup_difference_percentage,
               uint32_t speedup_percentage,
               uint32_t speedup_interval_count,
+              uint32_t ewma_weight_percentage,
               std::string log_directory,
               bool enable_logging);
 
@@ -177,17 +197,24 @@ private:
   // Get the median duration of last set of durations
   uint64_t get_median_interval_duration_history();
 
+  // Update the round duration model with actual meta-data of an input
+  void update_round_duration_model(uint32_t input_index,
+                                   const IntervalMetaData& meta_data);
+
+  // Get the predicted sustainable round duration (slowest input)
+  uint64_t get_predicted_round_duration();
+
   // Proposed interval meta-data
-  SizedMap<uint64_t, IntervalMetaData*> proposed_interval_meta_data_;
+  SlidingWindowMap<uint64_t, IntervalMetaData*> proposed_interval_meta_data_;
 
   // Unified actual interval meta-data
-  SizedMap<uint64_t, IntervalMetaData*> actual_interval_meta_data_;
+  SlidingWindowMap<uint64_t, IntervalMetaData*> actual_interval_meta_data_;
 
   // Actual interval meta-data
   std::vector<InputSchedulerData*> input_scheduler_info_;
 
   // Trigger the completed collected intervals to calculate the statistics
-  SizedMap<uint64_t, uint32_t> pending_intervals_;
+  SlidingWindowMap<uint64_t, uint32_t> pending_intervals_;
 
   // The singleton instance for this class
   static DDScheduler* instance_;
@@ -217,6 +244,9 @@ private:
   // The number of intervals to keep speeding up
   uint32_t speedup_interval_count_;
 
+  // The weight of new round durations in the model (0: no model)
+  double ewma_weight_;
+
   // The interval number when speeding up is started
   uint64_t speedup_interval_index_ = 0;
 
@@ -240,6 +270,13 @@ private:
 
   bool enable_logging_;
   // LOGGING
-  SizedMap<uint64_t, IntervalDataLog*> interval_info_logger_;
+  // Append an interval entry to the streamed log
+  void log_interval(uint64_t interval_index, const IntervalDataLog& entry);
+
+  // Proposed intervals whose actual info is not yet known
+  SlidingWindowMap<uint64_t, IntervalDataLog*> interval_info_logger_;
+
+  // Streamed interval log (see contrib/record-log-convert)
+  std::unique_ptr<RecordLog> interval_log_;
 };
 } // namespace tl_libfabric
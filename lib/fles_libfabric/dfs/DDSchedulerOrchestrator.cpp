@@ -17,13 +17,14 @@ void DDSchedulerOrchestrator::initialize(uint32_t scheduler_index,
                                          uint32_t speedup_difference_percentage,
                                          uint32_t speedup_percentage,
                                          uint32_t speedup_interval_count,
+                                         uint32_t ewma_weight_percentage,
                                          std::string log_directory,
                                          bool enable_logging) {
 
   interval_scheduler_ = DDScheduler::get_instance(
       scheduler_index, input_scheduler_count, history_size, interval_length,
       speedup_difference_percentage, speedup_percentage, speedup_interval_count,
-      log_directory, enable_logging);
+      ewma_weight_percentage, log_directory, enable_logging);
   timeslice_manager_ = ComputeTimesliceManager::get_instance(
       scheduler_index, input_scheduler_count, log_directory, enable_logging);
   heartbeat_manager_ = ComputeHeartbeatManager::get_instance(
@@ -28,6 +28,7 @@ public:
                          uint32_t speedup_difference_percentage,
                          uint32_t speedup_percentage,
                          uint32_t speedup_interval_count,
+                         uint32_t ewma_weight_percentage,
                          std::string log_directory,
                          bool enable_logging);
 
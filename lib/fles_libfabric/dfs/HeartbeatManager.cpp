@@ -25,10 +25,8 @@ HeartbeatManager::HeartbeatManager(uint32_t index,
   update_latency_log_ = true;
   for (uint32_t i = 0; i < init_connection_count; i++) {
     unacked_sent_messages_.add(i, new std::set<uint64_t>());
-    connection_heartbeat_time_.push_back(new ConnectionHeartbeatInfo(
-        timeout_history_size * init_heartbeat_timeout));
-    connection_heartbeat_time_[i]->latency_history.resize(
-        timeout_history_size, init_heartbeat_timeout);
+    connection_heartbeat_time_.push_back(
+        new ConnectionHeartbeatInfo(init_heartbeat_timeout));
   }
   pending_messages_.resize(init_connection_count);
 
@@ -53,11 +51,9 @@ bool HeartbeatManager::check_whether_connection_inactive(
           std::chrono::high_resolution_clock::now() -
           connection_heartbeat_time_[connection_id]->last_received_message)
           .count();
-  uint64_t avg_latency =
-      connection_heartbeat_time_[connection_id]->sum_latency /
-      timeout_history_size_;
+  uint64_t timeout = connection_heartbeat_time_[connection_id]->timeout;
 
-  if (duration >= (avg_latency * inactive_factor_)) {
+  if (duration >= (timeout * inactive_factor_)) {
     return true;
   }
   return false;
@@ -74,11 +70,9 @@ bool HeartbeatManager::check_whether_connection_timed_out(
           std::chrono::high_resolution_clock::now() -
           connection_heartbeat_time_[connection_id]->last_received_message)
           .count();
-  uint64_t avg_latency =
-      connection_heartbeat_time_[connection_id]->sum_latency /
-      timeout_history_size_;
+  uint64_t timeout = connection_heartbeat_time_[connection_id]->timeout;
 
-  if (duration >= (avg_latency * timeout_factor_))
+  if (duration >= (timeout * timeout_factor_))
     return true;
   return false;
 }
@@ -185,12 +179,14 @@ void HeartbeatManager::log_new_latency(uint32_t connection_id,
   // L_(info) << "Latency of [" << connection_id << "] is " << latency;
   ConnectionHeartbeatInfo* conn_info =
       connection_heartbeat_time_[connection_id];
-  conn_info->sum_latency =
-      conn_info->sum_latency -
-      conn_info->latency_history[conn_info->next_latency_index] + latency;
-  conn_info->latency_history[conn_info->next_latency_index] = latency;
-  conn_info->next_latency_index =
-      (conn_info->next_latency_index + 1) % timeout_history_size_;
+  // A high percentile instead of the mean tolerates bursts of congestion
+  // without loosening the timeout of a steady connection
+  conn_info->latency_quantile.add(static_cast<double>(latency));
+  if (conn_info->latency_quantile.count() >= timeout_history_size_) {
+    conn_info->timeout = std::max<uint64_t>(
+        static_cast<uint64_t>(conn_info->latency_quantile.value()), 1);
+    conn_info->latency_quantile.reset();
+  }
 }
 
 std::vector<uint32_t> HeartbeatManager::retrieve_new_inactive_connections() {
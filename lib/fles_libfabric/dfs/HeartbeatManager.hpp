@@ -6,7 +6,9 @@
 #include "HeartbeatFailedNodeInfo.hpp"
 #include "HeartbeatMessage.hpp"
 #include "SizedMap.hpp"
+#include "StreamingQuantile.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <log.hpp>
@@ -88,12 +90,12 @@ protected:
   struct ConnectionHeartbeatInfo {
     std::chrono::high_resolution_clock::time_point last_received_message =
         std::chrono::high_resolution_clock::now();
-    std::vector<uint64_t> latency_history; // in microseconds
-    uint64_t sum_latency;
-    uint32_t next_latency_index = 0;
-    ConnectionHeartbeatInfo(uint64_t init_sum_latency) {
-      sum_latency = init_sum_latency;
-    }
+    // Percentile of the latencies in the current history window
+    StreamingQuantile latency_quantile{
+        ConstVariables::HEARTBEAT_TIMEOUT_PERCENTILE / 100.0};
+    // Timeout value from the last complete window, in microseconds
+    uint64_t timeout;
+    ConnectionHeartbeatInfo(uint64_t init_timeout) : timeout(init_timeout) {}
   };
 
   HeartbeatManager(uint32_t index,
@@ -145,7 +147,8 @@ protected:
 
   uint64_t init_heartbeat_timeout_;
 
-  // history size of latency to detect timeout connections
+  // history size of latency to detect timeout connections (the timeout
+  // value is updated once per window of this many latencies)
   // high for unstable networks
   uint32_t timeout_history_size_;
 
@@ -26,6 +26,18 @@ InputIntervalScheduler* InputIntervalScheduler::get_instance() {
   return instance_;
 }
 
+std::unique_ptr<InputIntervalScheduler>
+InputIntervalScheduler::create(uint32_t scheduler_index,
+                               uint32_t compute_conn_count,
+                               uint32_t interval_length,
+                               std::string log_directory,
+                               bool enable_logging) {
+  return std::unique_ptr<InputIntervalScheduler>(
+      new InputIntervalScheduler(scheduler_index, compute_conn_count,
+                                 interval_length, log_directory,
+                                 enable_logging));
+}
+
 void InputIntervalScheduler::update_compute_connection_count(
     uint32_t compute_count) {
   compute_count_ = compute_count;
@@ -53,8 +65,7 @@ bool InputIntervalScheduler::add_proposed_meta_data(
              << meta_data.start_timeslice << " to " << meta_data.last_timeslice
              << " is proposed and should start after "
              << std::chrono::duration_cast<std::chrono::microseconds>(
-                    meta_data.start_time -
-                    std::chrono::high_resolution_clock::now())
+                    meta_data.start_time - SchedulerClock::now())
                     .count()
              << " us & take " << meta_data.interval_duration << " us in "
              << meta_data.round_count << " rounds";
@@ -80,8 +91,7 @@ uint64_t InputIntervalScheduler::get_last_timeslice_to_send() {
               << current_interval->start_ts << " end_ts "
               << current_interval->end_ts;
   if (current_interval->count_sent_ts == 0 &&
-      current_interval->proposed_start_time >
-          std::chrono::high_resolution_clock::now())
+      current_interval->proposed_start_time > SchedulerClock::now())
     return current_interval->index > 0 ? current_interval->start_ts - 1 : 0;
   uint64_t next_round =
       get_interval_expected_round_index(current_interval->index) + 1;
@@ -94,8 +104,7 @@ void InputIntervalScheduler::increament_sent_timeslices(uint64_t timeslice) {
   InputIntervalInfo* current_interval = get_interval_of_timeslice(timeslice);
   assert(current_interval != nullptr);
   if (current_interval->count_sent_ts == 0)
-    current_interval->actual_start_time =
-        std::chrono::high_resolution_clock::now();
+    current_interval->actual_start_time = SchedulerClock::now();
   current_interval->count_sent_ts++;
   if (is_interval_sent_completed(current_interval->index) &&
       is_ack_percentage_reached(current_interval->index) &&
@@ -142,8 +151,7 @@ int64_t InputIntervalScheduler::get_next_fire_time() {
   InputIntervalInfo* current_interval = interval_info_.get(interval);
   current_interval->rounds_counter++;
 
-  std::chrono::high_resolution_clock::time_point now =
-      std::chrono::high_resolution_clock::now();
+  std::chrono::high_resolution_clock::time_point now = SchedulerClock::now();
 
   // If  no proposed duration or the proposed finish time is reached, then
   // send as fast as possible.
@@ -170,9 +178,43 @@ int64_t InputIntervalScheduler::get_next_fire_time() {
   if (duration < 0)
     duration = 0;
 
+  // wake up for the turn of each compute node
+  if (staggered_rounds_ && compute_count_ > 1) {
+    int64_t slot_duration =
+        current_interval->duration_per_round / compute_count_;
+    duration = std::min(duration, slot_duration);
+  }
+
   return duration;
 }
 
+bool InputIntervalScheduler::is_connection_turn(uint32_t compute_index,
+                                                uint64_t timeslice) {
+  if (!staggered_rounds_ || compute_count_ < 2)
+    return true;
+  InputIntervalInfo* interval = get_interval_of_timeslice(timeslice);
+  if (interval == nullptr || interval->duration_per_round == 0 ||
+      interval->num_ts_per_round == 0)
+    return true;
+
+  std::chrono::high_resolution_clock::time_point now = SchedulerClock::now();
+  // no staggering while catching up (see get_next_fire_time)
+  if (!is_ack_percentage_reached(interval->index) &&
+      (interval->proposed_start_time +
+       std::chrono::microseconds(interval->proposed_duration)) < now)
+    return true;
+
+  // latin square: input i sends to compute node (i + slot) in each slot
+  uint64_t round =
+      (timeslice - interval->start_ts) / interval->num_ts_per_round;
+  uint64_t slot = (compute_index + compute_count_ -
+                   scheduler_index_ % compute_count_) %
+                  compute_count_;
+  return now >= get_expected_round_sent_time(interval->index, round) +
+                    std::chrono::microseconds(
+                        slot * interval->duration_per_round / compute_count_);
+}
+
 uint32_t InputIntervalScheduler::get_compute_connection_count() {
   return compute_count_;
 }
@@ -239,7 +281,7 @@ void InputIntervalScheduler::create_new_interval_info(uint64_t interval_index) {
       uint32_t round_count = floor(interval_length_ / compute_count_);
       new_interval_info = new InputIntervalInfo(
           interval_index, round_count, 0, (round_count * compute_count_) - 1,
-          std::chrono::high_resolution_clock::now(), 0, compute_count_);
+          SchedulerClock::now(), 0, compute_count_);
 
     } else { // following last proposed meta-data
       // TODO wait for the proposing!!!
@@ -260,7 +302,7 @@ void InputIntervalScheduler::create_new_interval_info(uint64_t interval_index) {
              << new_interval_info->end_ts << "] should start after "
              << std::chrono::duration_cast<std::chrono::microseconds>(
                     new_interval_info->proposed_start_time -
-                    std::chrono::high_resolution_clock::now())
+                    SchedulerClock::now())
                     .count()
              << " us & take " << new_interval_info->proposed_duration << " us";
   }
@@ -274,8 +316,7 @@ void InputIntervalScheduler::create_actual_interval_meta_data(
     return;
   interval_info->actual_duration =
       std::chrono::duration_cast<std::chrono::microseconds>(
-          std::chrono::high_resolution_clock::now() -
-          interval_info->actual_start_time)
+          SchedulerClock::now() - interval_info->actual_start_time)
           .count();
 
   IntervalMetaData* actual_metadata = new IntervalMetaData(
@@ -303,8 +344,7 @@ uint64_t InputIntervalScheduler::get_expected_sent_ts_count(uint64_t interval) {
   InputIntervalInfo* current_interval = interval_info_.get(interval);
   if (current_interval->duration_per_ts == 0)
     return (current_interval->end_ts - current_interval->start_ts + 1);
-  std::chrono::high_resolution_clock::time_point now =
-      std::chrono::high_resolution_clock::now();
+  std::chrono::high_resolution_clock::time_point now = SchedulerClock::now();
   if (now < current_interval->actual_start_time)
     return 0;
   uint64_t max_interval_ts_count =
@@ -312,7 +352,7 @@ uint64_t InputIntervalScheduler::get_expected_sent_ts_count(uint64_t interval) {
   assert(current_interval->duration_per_ts > 0);
   return std::min(max_interval_ts_count,
                   std::chrono::duration_cast<std::chrono::microseconds>(
-                      std::chrono::high_resolution_clock::now() -
+                      SchedulerClock::now() -
                       current_interval->actual_start_time)
                           .count() /
                       current_interval->duration_per_ts);
@@ -332,7 +372,7 @@ InputIntervalInfo InputIntervalScheduler::get_current_interval_info() {
 
 InputIntervalInfo*
 InputIntervalScheduler::get_interval_of_timeslice(uint64_t timeslice) {
-  SizedMap<uint64_t, InputIntervalInfo*>::iterator end_it =
+  SlidingWindowMap<uint64_t, InputIntervalInfo*>::iterator end_it =
       interval_info_.get_end_iterator();
   do {
     --end_it;
@@ -416,7 +456,7 @@ void InputIntervalScheduler::generate_log_files() {
            << "Proposed duration" << std::setw(25) << "Actual duration"
            << "\n";
 
-  SizedMap<uint64_t, IntervalMetaData*>::iterator it_actual =
+  SlidingWindowMap<uint64_t, IntervalMetaData*>::iterator it_actual =
       actual_interval_meta_data_.get_begin_iterator();
   IntervalMetaData* proposed_metadata = nullptr;
   uint64_t proposed_time, actual_time;
@@ -5,7 +5,8 @@
 #include "ConstVariables.hpp"
 #include "InputIntervalInfo.hpp"
 #include "IntervalMetaData.hpp"
-#include "SizedMap.hpp"
+#include "SchedulerClock.hpp"
+#include "SlidingWindowMap.hpp"
 
 #include <cassert>
 #include <chrono>
@@ -14,6 +15,7 @@
 #include <log.hpp>
 #include <map>
 #include <math.h>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -35,6 +37,14 @@ public:
   // Get singleton instance
   static InputIntervalScheduler* get_instance();
 
+  // Create an instance independent of the singleton (e.g., for simulation)
+  static std::unique_ptr<InputIntervalScheduler>
+  create(uint32_t scheduler_index,
+         uint32_t compute_conn_count,
+         uint32_t interval_length,
+         std::string log_directory,
+         bool enable_logging);
+
   // update the compute node count which is needed for the initial interval
   // (#0)
   void update_compute_connection_count(uint32_t);
@@ -64,6 +74,14 @@ public:
   // Get the time to start sending more timeslices
   int64_t get_next_fire_time();
 
+  // Stagger the transmissions of each round across the compute nodes
+  void set_staggered_rounds(bool staggered) { staggered_rounds_ = staggered; }
+
+  // Check whether a timeslice may be sent to a compute node now (with
+  // staggered rounds, each input starts a round at a different compute node
+  // and moves on to the next one every 1/compute_count of the round)
+  bool is_connection_turn(uint32_t compute_index, uint64_t timeslice);
+
   // Get the number of current compute node connections
   uint32_t get_compute_connection_count();
 
@@ -138,13 +156,13 @@ private:
   get_expected_round_sent_time(uint64_t interval, uint64_t round);
 
   // List of all interval infos
-  SizedMap<uint64_t, InputIntervalInfo*> interval_info_;
+  SlidingWindowMap<uint64_t, InputIntervalInfo*> interval_info_;
 
   // Proposed interval meta-data
-  SizedMap<uint64_t, IntervalMetaData*> proposed_interval_meta_data_;
+  SlidingWindowMap<uint64_t, IntervalMetaData*> proposed_interval_meta_data_;
 
   // Actual interval meta-data
-  SizedMap<uint64_t, IntervalMetaData*> actual_interval_meta_data_;
+  SlidingWindowMap<uint64_t, IntervalMetaData*> actual_interval_meta_data_;
 
   // Input Scheduler index
   uint32_t scheduler_index_;
@@ -165,5 +183,8 @@ private:
   bool enable_logging_;
 
   double minimum_ack_percentage_to_start_new_interval_;
+
+  // Check whether the rounds are staggered across the compute nodes
+  bool staggered_rounds_ = false;
 };
 } // namespace tl_libfabric
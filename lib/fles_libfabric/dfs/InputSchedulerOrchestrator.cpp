@@ -73,6 +73,19 @@ int64_t InputSchedulerOrchestrator::get_next_fire_time() {
   return interval_scheduler_->get_next_fire_time();
 }
 
+void InputSchedulerOrchestrator::set_staggered_rounds(bool staggered) {
+  interval_scheduler_->set_staggered_rounds(staggered);
+}
+
+void InputSchedulerOrchestrator::set_replication_modulo(uint32_t modulo) {
+  timeslice_manager_->set_replication_modulo(modulo);
+}
+
+bool InputSchedulerOrchestrator::is_connection_turn(uint32_t compute_index,
+                                                    uint64_t timeslice) {
+  return interval_scheduler_->is_connection_turn(compute_index, timeslice);
+}
+
 //// InputTimesliceManager Methods
 
 uint64_t InputSchedulerOrchestrator::get_connection_next_timeslice(
@@ -65,8 +65,18 @@ public:
   // Get the time to start sending more timeslices
   static int64_t get_next_fire_time();
 
+  // Stagger the transmissions of each round across the compute nodes
+  static void set_staggered_rounds(bool staggered);
+
+  // Check whether a timeslice may be sent to a compute node now
+  static bool is_connection_turn(std::uint32_t compute_index,
+                                 std::uint64_t timeslice);
+
   //// InputTimesliceManager Methods
 
+  // Replicate every modulo-th timeslice to a standby compute node (0: none)
+  static void set_replication_modulo(std::uint32_t modulo);
+
   // Get the timeslice to be sent to specific compute index
   static std::uint64_t
   get_connection_next_timeslice(std::uint32_t compute_index);
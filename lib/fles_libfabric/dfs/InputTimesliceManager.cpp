@@ -607,7 +607,21 @@ void InputTimesliceManager::distribute_failed_timeslices_on_active_connections(
   if (!failed_timeslice->empty()) {
     std::vector<std::set<uint64_t>*> movable_ts(compute_count_, nullptr);
     uint32_t compute_index = 0;
+    // replicated timeslices go to the standby, which holds their data
+    const uint32_t standby = timeslice_replication::standby(
+        failed_node_info.index, compute_count_);
+    const bool standby_active =
+        timeout_connections.find(standby) == timeout_connections.end();
     while (!failed_timeslice->empty()) {
+      uint64_t ts = *failed_timeslice->begin();
+      if (standby_active &&
+          timeslice_replication::selected(ts, replication_modulo_)) {
+        if (movable_ts[standby] == nullptr)
+          movable_ts[standby] = new std::set<uint64_t>();
+        movable_ts[standby]->insert(ts);
+        failed_timeslice->erase(ts);
+        continue;
+      }
       while (timeout_connections.find(compute_index) !=
              timeout_connections.end())
         compute_index = (compute_index + 1) % compute_count_;
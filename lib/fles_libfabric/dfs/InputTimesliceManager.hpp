@@ -5,6 +5,8 @@
 #include "ConstVariables.hpp"
 #include "HeartbeatFailedNodeInfo.hpp"
 #include "SizedMap.hpp"
+#include "SlidingWindowMap.hpp"
+#include "TimesliceReplication.hpp"
 
 #include <cassert>
 #include <chrono>
@@ -58,6 +60,9 @@ public:
   // Check whether a timeslice is acked
   bool is_timeslice_rdma_acked(uint32_t compute_index, uint64_t timeslice);
 
+  // Replicate every modulo-th timeslice to the standby compute node (0: none)
+  void set_replication_modulo(uint32_t modulo) { replication_modulo_ = modulo; }
+
   // Check whether a timeslice belongs to a timeout connection
   bool is_timeslice_belongs_to_timeout_connection(
       uint64_t timeslice, const std::set<uint32_t> timeout_connections);
@@ -197,6 +202,9 @@ private:
   // #virtual compute connections according to scheduler frequency
   uint32_t virtual_compute_count_;
 
+  // Replicated timeslices move to the standby of a failed compute node
+  uint32_t replication_modulo_ = 0;
+
   //
   std::vector<uint32_t> virtual_physical_compute_mapping_;
 
@@ -253,16 +261,16 @@ private:
 
   /// LOGGING
   // Input Buffer blockage
-  SizedMap<uint64_t, std::chrono::high_resolution_clock::time_point>
+  SlidingWindowMap<uint64_t, std::chrono::high_resolution_clock::time_point>
       timeslice_IB_blocked_start_log_;
-  SizedMap<uint64_t, uint64_t> timeslice_IB_blocked_duration_log_;
+  SlidingWindowMap<uint64_t, uint64_t> timeslice_IB_blocked_duration_log_;
   // Compute Buffer blockage
-  SizedMap<uint64_t, std::chrono::high_resolution_clock::time_point>
+  SlidingWindowMap<uint64_t, std::chrono::high_resolution_clock::time_point>
       timeslice_CB_blocked_start_log_;
-  SizedMap<uint64_t, uint64_t> timeslice_CB_blocked_duration_log_;
+  SlidingWindowMap<uint64_t, uint64_t> timeslice_CB_blocked_duration_log_;
   // Max writes limitation blockage
-  SizedMap<uint64_t, std::chrono::high_resolution_clock::time_point>
+  SlidingWindowMap<uint64_t, std::chrono::high_resolution_clock::time_point>
       timeslice_MR_blocked_start_log_;
-  SizedMap<uint64_t, uint64_t> timeslice_MR_blocked_duration_log_;
+  SlidingWindowMap<uint64_t, uint64_t> timeslice_MR_blocked_duration_log_;
 };
 } // namespace tl_libfabric
@@ -0,0 +1,32 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <utility>
+
+namespace tl_libfabric {
+/// Source of the current time for the interval schedulers.
+/** The schedulers read the time only through this class, so that an offline
+    simulation can replace the system clock by its virtual time. */
+class SchedulerClock {
+public:
+  using time_point = std::chrono::high_resolution_clock::time_point;
+
+  /// Retrieve the current time.
+  static time_point now() {
+    return source() ? source()() : std::chrono::high_resolution_clock::now();
+  }
+
+  /// Replace the time source (an empty function restores the system clock).
+  static void set_source(std::function<time_point()> new_source) {
+    source() = std::move(new_source);
+  }
+
+private:
+  static std::function<time_point()>& source() {
+    static std::function<time_point()> s;
+    return s;
+  }
+};
+} // namespace tl_libfabric
@@ -17,64 +17,30 @@ LibfabricBarrier::~LibfabricBarrier() {}
 LibfabricBarrier::LibfabricBarrier(uint32_t remote_index,
                                    struct fid_domain* pd,
                                    bool is_root)
-    : LibfabricCollective(remote_index, pd), root_(is_root) {
+    : LibfabricCollective(remote_index, pd, is_root) {
   // TODO remote_index needed?
 }
 
 size_t LibfabricBarrier::call_barrier() {
-  if (root_) {
-    receive_all();
-    broadcast();
+  if (use_tree()) {
+    tree_allreduce(0, ReduceOp::Sum);
   } else {
-    broadcast(true);
-    receive_all(true);
+    exchange_all(0, ReduceOp::Sum);
   }
   return 0;
 }
 
-void LibfabricBarrier::receive_all(bool only_root_eps) {
-  std::vector<struct LibfabricCollectiveEPInfo*> endpoints =
-      retrieve_endpoint_list();
-  uint32_t count = 0;
-  assert(endpoints.size() >= 1);
-  for (uint32_t i = 0; i < endpoints.size(); i++) {
-    if (!endpoints[i]->active || (only_root_eps && !endpoints[i]->root_ep))
-      continue;
-    recv(endpoints[i]);
-    count++;
+uint64_t LibfabricBarrier::call_allreduce(uint64_t value, ReduceOp op) {
+  if (use_tree()) {
+    return tree_allreduce(value, op);
   }
-  wait_for_recv_cq(count);
+  // a flat exchange only provides the result to the non-root processes
+  value = exchange_all(value, op);
+  return tree_allreduce(root_ ? 0 : value, ReduceOp::Max);
 }
 
-void LibfabricBarrier::broadcast(bool only_root_eps) {
-  std::vector<struct LibfabricCollectiveEPInfo*> endpoints =
-      retrieve_endpoint_list();
-  assert(endpoints.size() > 0);
-  uint32_t count = 0;
-  for (uint32_t i = 0; i < endpoints.size(); i++) {
-    if (!endpoints[i]->active || (only_root_eps && !endpoints[i]->root_ep))
-      continue;
-    send(endpoints[i]);
-    count++;
-  }
-  wait_for_send_cq(count);
-}
-
-void LibfabricBarrier::recv(const struct LibfabricCollectiveEPInfo* ep_info) {
-  int err = fi_trecvmsg(ep_info->ep, &ep_info->recv_msg_wr, FI_COMPLETION);
-  if (err != 0) {
-    L_(fatal) << "fi_recvmsg failed in LibfabricBarrier::recv: "
-              << strerror(err);
-    throw LibfabricException("fi_recvmsg failed");
-  }
-}
-
-void LibfabricBarrier::send(const struct LibfabricCollectiveEPInfo* ep_info) {
-  int err = fi_tsendmsg(ep_info->ep, &ep_info->send_msg_wr, FI_COMPLETION);
-  if (err != 0) {
-    L_(fatal) << "fi_tsendmsg failed in LibfabricBarrier::v: " << strerror(err);
-    throw LibfabricException("fi_tsendmsg failed");
-  }
+uint64_t LibfabricBarrier::call_broadcast(uint64_t value) {
+  return tree_broadcast(value);
 }
 
 LibfabricBarrier* LibfabricBarrier::barrier_ = nullptr;
@@ -15,8 +15,16 @@ public:
   LibfabricBarrier(const LibfabricBarrier&) = delete;
   LibfabricBarrier& operator=(const LibfabricBarrier&) = delete;
 
+  using LibfabricCollective::ReduceOp;
+
   size_t call_barrier();
 
+  /// Reduce a value over all participants (e.g., interval metadata).
+  uint64_t call_allreduce(uint64_t value, ReduceOp op);
+
+  /// Distribute the value of compute process 0 to all participants.
+  uint64_t call_broadcast(uint64_t value);
+
   static void create_barrier_instance(uint32_t remote_index,
                                       struct fid_domain* pd,
                                       bool is_root);
@@ -26,12 +34,7 @@ public:
 private:
   ~LibfabricBarrier();
   LibfabricBarrier(uint32_t remote_index, struct fid_domain* pd, bool is_root);
-  void receive_all(bool only_root_eps = false);
-  void broadcast(bool only_root_eps = false);
-  void recv(const struct LibfabricCollectiveEPInfo* ep_info);
-  void send(const struct LibfabricCollectiveEPInfo* ep_info);
 
   static LibfabricBarrier* barrier_;
-  bool root_;
 };
 } // namespace tl_libfabric
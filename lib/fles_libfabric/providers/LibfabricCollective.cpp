@@ -1,12 +1,15 @@
 // Copyright 2020 Farouk Salem <salem@zib.de>
 
 #include "LibfabricCollective.hpp"
+#include <algorithm>
+#include <limits>
 
 namespace tl_libfabric {
 
 LibfabricCollective::LibfabricCollective(uint32_t remote_index,
-                                         struct fid_domain* pd)
-    : remote_index_(remote_index), pd_(pd) {
+                                         struct fid_domain* pd,
+                                         bool is_root)
+    : root_(is_root), remote_index_(remote_index), pd_(pd) {
 
   initialize_cq(&recv_cq_);
   assert(recv_cq_ != nullptr);
@@ -124,8 +127,9 @@ void LibfabricCollective::create_endpoint(
     L_(fatal) << "fi_enable failed: " << err << "=" << fi_strerror(-err);
     throw LibfabricException("fi_enable failed");
   }
-  size_t addr_len = sizeof(ep_info->send_buffer);
-  err = fi_getname(&ep_info->ep->fid, &ep_info->send_buffer, &addr_len);
+  size_t addr_len = sizeof(ep_info->send_buffer.address);
+  err = fi_getname(&ep_info->ep->fid, &ep_info->send_buffer.address,
+                   &addr_len);
   assert(err == 0);
 }
 
@@ -237,12 +241,12 @@ bool LibfabricCollective::deactive_endpoint(uint32_t index) {
 }
 void LibfabricCollective::wait_for_cq(struct fid_cq* cq, const int32_t events) {
 
-  struct fi_cq_entry* wc = new struct fi_cq_entry[MAX_CQ_ENTRIES];
+  std::vector<struct fi_cq_entry> wc(MAX_CQ_ENTRIES);
   int ne, received = 0, expected = std::min(MAX_CQ_ENTRIES, events),
           remaining = events - MAX_CQ_ENTRIES;
 
   while (received < expected) {
-    ne = fi_cq_read(cq, &wc, (expected - received));
+    ne = fi_cq_read(cq, wc.data(), (expected - received));
     if ((ne < 0) && (ne != -FI_EAGAIN)) {
       L_(fatal) << "wait_for_cq failed: " << ne << "=" << fi_strerror(-ne);
       throw LibfabricException("wait_for_cq failed");
@@ -260,7 +264,7 @@ void LibfabricCollective::wait_for_cq(struct fid_cq* cq, const int32_t events) {
       assert(context != nullptr);
       if (endpoint_list_[context->op_context]->fi_addr == FI_ADDR_UNSPEC) {
         int res = fi_av_insert(
-            av_, &endpoint_list_[context->op_context]->recv_buffer, 1,
+            av_, &endpoint_list_[context->op_context]->recv_buffer.address, 1,
             &endpoint_list_[context->op_context]->fi_addr, 0, NULL);
         assert(res == 1);
         endpoint_list_[context->op_context]->recv_msg_wr.addr =
@@ -287,4 +291,166 @@ LibfabricCollective::retrieve_endpoint_list() {
   return endpoint_list_;
 }
 
+bool LibfabricCollective::use_tree() const {
+  if (group_size_ == 0 || group_size_ + endpoint_list_.size() <
+                              ConstVariables::COLLECTIVE_TREE_THRESHOLD) {
+    return false;
+  }
+  // the flat algorithm skips the endpoints of failed processes
+  return std::all_of(
+      endpoint_list_.begin(), endpoint_list_.end(),
+      [](const LibfabricCollectiveEPInfo* ep_info) { return ep_info->active; });
+}
+
+uint64_t LibfabricCollective::exchange_all(uint64_t value, ReduceOp op) {
+  assert(!endpoint_list_.empty());
+  std::vector<struct LibfabricCollectiveEPInfo*> peers;
+  for (LibfabricCollectiveEPInfo* ep_info : endpoint_list_) {
+    if (ep_info->active && (root_ || ep_info->root_ep)) {
+      peers.push_back(ep_info);
+    }
+  }
+  if (!root_) {
+    for (LibfabricCollectiveEPInfo* ep_info : peers) {
+      send(ep_info, value);
+    }
+    wait_for_send_cq(peers.size());
+  }
+  for (LibfabricCollectiveEPInfo* ep_info : peers) {
+    recv(ep_info);
+  }
+  wait_for_recv_cq(peers.size());
+  for (const LibfabricCollectiveEPInfo* ep_info : peers) {
+    value = reduce(value, ep_info->recv_buffer.value, op);
+    group_size_ = static_cast<uint32_t>(ep_info->recv_buffer.peer_count);
+  }
+  if (root_) {
+    for (LibfabricCollectiveEPInfo* ep_info : peers) {
+      send(ep_info, value);
+    }
+    wait_for_send_cq(peers.size());
+  }
+  return value;
+}
+
+uint64_t LibfabricCollective::tree_allreduce(uint64_t value, ReduceOp op) {
+  if (group_size_ == 0) {
+    // learn the group sizes and addresses needed by the tree
+    exchange_all(0, ReduceOp::Sum);
+  }
+  const std::vector<uint32_t> children = tree_children();
+  for (uint32_t child : children) {
+    recv(endpoint_list_[child]);
+  }
+  wait_for_recv_cq(children.size());
+  for (uint32_t child : children) {
+    value = reduce(value, endpoint_list_[child]->recv_buffer.value, op);
+  }
+
+  const uint32_t parent = tree_parent();
+  if (parent != ConstVariables::MINUS_ONE) {
+    send(endpoint_list_[parent], value);
+    wait_for_send_cq(1);
+    recv(endpoint_list_[parent]);
+    wait_for_recv_cq(1);
+    value = endpoint_list_[parent]->recv_buffer.value;
+  }
+
+  for (uint32_t child : children) {
+    send(endpoint_list_[child], value);
+  }
+  wait_for_send_cq(children.size());
+  return value;
+}
+
+uint64_t LibfabricCollective::tree_broadcast(uint64_t value) {
+  if (group_size_ == 0) {
+    // learn the group sizes and addresses needed by the tree
+    exchange_all(0, ReduceOp::Sum);
+  }
+  const uint32_t parent = tree_parent();
+  if (parent != ConstVariables::MINUS_ONE) {
+    recv(endpoint_list_[parent]);
+    wait_for_recv_cq(1);
+    value = endpoint_list_[parent]->recv_buffer.value;
+  }
+
+  const std::vector<uint32_t> children = tree_children();
+  for (uint32_t child : children) {
+    send(endpoint_list_[child], value);
+  }
+  wait_for_send_cq(children.size());
+  return value;
+}
+
+void LibfabricCollective::recv(struct LibfabricCollectiveEPInfo* ep_info) {
+  int err = fi_trecvmsg(ep_info->ep, &ep_info->recv_msg_wr, FI_COMPLETION);
+  if (err != 0) {
+    L_(fatal) << "fi_trecvmsg failed in LibfabricCollective::recv: "
+              << strerror(err);
+    throw LibfabricException("fi_trecvmsg failed");
+  }
+}
+
+void LibfabricCollective::send(struct LibfabricCollectiveEPInfo* ep_info,
+                               uint64_t value) {
+  ep_info->send_buffer.peer_count = endpoint_list_.size();
+  ep_info->send_buffer.value = value;
+  int err = fi_tsendmsg(ep_info->ep, &ep_info->send_msg_wr, FI_COMPLETION);
+  if (err != 0) {
+    L_(fatal) << "fi_tsendmsg failed in LibfabricCollective::send: "
+              << strerror(err);
+    throw LibfabricException("fi_tsendmsg failed");
+  }
+}
+
+uint64_t LibfabricCollective::reduce(uint64_t a, uint64_t b, ReduceOp op) {
+  switch (op) {
+  case ReduceOp::Sum:
+    return a + b;
+  case ReduceOp::Min:
+    return std::min(a, b);
+  case ReduceOp::Max:
+    return std::max(a, b);
+  }
+  return a;
+}
+
+uint32_t LibfabricCollective::fanout() const {
+  if (!use_tree()) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+  return ConstVariables::COLLECTIVE_TREE_FANOUT;
+}
+
+// The compute process c has the input children i with i / k == c, the input
+// process i has the compute children c > 0 with (c - 1) / k == i (k being
+// the fan-out). If one kind is outnumbered, the parent indexes wrap around.
+// As a parent index never exceeds the own index divided by k, every path
+// leads to compute process 0.
+
+uint32_t LibfabricCollective::tree_parent() const {
+  const uint32_t k = fanout();
+  const auto peers = static_cast<uint32_t>(endpoint_list_.size());
+  if (root_) {
+    if (remote_index_ == 0) {
+      return ConstVariables::MINUS_ONE;
+    }
+    return ((remote_index_ - 1) / k) % peers;
+  }
+  return (remote_index_ / k) % peers;
+}
+
+std::vector<uint32_t> LibfabricCollective::tree_children() const {
+  const uint32_t k = fanout();
+  std::vector<uint32_t> children;
+  for (uint32_t i = root_ ? 0 : 1; i < endpoint_list_.size(); ++i) {
+    uint32_t parent = (root_ ? i / k : (i - 1) / k) % group_size_;
+    if (parent == remote_index_) {
+      children.push_back(i);
+    }
+  }
+  return children;
+}
+
 } // namespace tl_libfabric
@@ -22,6 +22,13 @@
 
 namespace tl_libfabric {
 
+/// Collective operations between the input and the compute processes.
+/** Endpoints exist between each input and each compute process only. The
+    flat algorithm exchanges messages with all endpoints at once. For many
+    participants, a tree spanning both kinds of processes is used instead,
+    rooted at compute process 0, in which the children of a process are of
+    the other kind. It requires the group sizes (and the addresses of
+    connectionless endpoints) learned in a first flat exchange. */
 class LibfabricCollective {
 public:
   bool add_endpoint(uint32_t index,
@@ -32,8 +39,13 @@ public:
   bool deactive_endpoint(uint32_t index);
 
 protected:
+  /// Reduction operations of collective calls.
+  enum class ReduceOp { Sum, Min, Max };
+
   ~LibfabricCollective();
-  LibfabricCollective(uint32_t remote_index, struct fid_domain* pd);
+  LibfabricCollective(uint32_t remote_index,
+                      struct fid_domain* pd,
+                      bool is_root);
 
   LibfabricCollective& operator=(const LibfabricCollective&) = delete;
   LibfabricCollective(const LibfabricCollective&) = delete;
@@ -44,7 +56,40 @@ protected:
 
   std::vector<struct LibfabricCollectiveEPInfo*> retrieve_endpoint_list();
 
+  /// Whether the participants are numerous enough to use the tree.
+  [[nodiscard]] bool use_tree() const;
+
+  /// Flat algorithm: exchange a value with all active endpoints.
+  /** Root processes receive from all endpoints and reply with the
+      reduced value, the others send first. Only the non-root processes
+      obtain the reduction over all participants. */
+  uint64_t exchange_all(uint64_t value, ReduceOp op);
+
+  /// Tree algorithm: reduce a value to the tree root and distribute the
+  /// result to all participants (flat: a tree of depth two).
+  uint64_t tree_allreduce(uint64_t value, ReduceOp op);
+
+  /// Tree algorithm: distribute the value of the tree root.
+  uint64_t tree_broadcast(uint64_t value);
+
+  void recv(struct LibfabricCollectiveEPInfo* ep_info);
+
+  void send(struct LibfabricCollectiveEPInfo* ep_info, uint64_t value);
+
+  static uint64_t reduce(uint64_t a, uint64_t b, ReduceOp op);
+
+  bool root_;
+
 private:
+  /// Fan-out of the tree (flat: all participants below one node).
+  [[nodiscard]] uint32_t fanout() const;
+
+  /// Endpoint index of the parent node in the tree, none for the tree root.
+  [[nodiscard]] uint32_t tree_parent() const;
+
+  /// Endpoint indexes of the child nodes in the tree.
+  [[nodiscard]] std::vector<uint32_t> tree_children() const;
+
   void initialize_cq(struct fid_cq** cq);
 
   void initialize_av();
@@ -70,6 +115,8 @@ private:
   std::vector<LibfabricCollectiveEPInfo*> endpoint_list_;
 
   uint32_t remote_index_;
+  /// Number of participants of the own kind (0: not yet known).
+  uint32_t group_size_ = 0;
   // Libfabric
   struct fid_domain* pd_ = nullptr;
   struct fid_cq* recv_cq_ = nullptr;
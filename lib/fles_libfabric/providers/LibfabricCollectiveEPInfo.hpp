@@ -12,6 +12,16 @@
 
 namespace tl_libfabric {
 
+/// Message of a collective operation.
+struct LibfabricCollectiveMessage {
+  /// Endpoint name of the sender, used to address connectionless replies.
+  unsigned char address[64];
+  /// Number of endpoints of the sender (the group size of the receiver).
+  uint64_t peer_count = 0;
+  /// Operand or result of the operation.
+  uint64_t value = 0;
+};
+
 struct LibfabricCollectiveEPInfo {
   uint64_t index;
   struct fid_ep* ep = nullptr;
@@ -20,12 +30,12 @@ struct LibfabricCollectiveEPInfo {
   struct fi_msg_tagged recv_msg_wr;
   struct iovec recv_sge = iovec();
   struct fid_mr* mr_recv = nullptr;
-  unsigned char recv_buffer[64];
+  LibfabricCollectiveMessage recv_buffer;
 
   struct fi_msg_tagged send_msg_wr;
   struct iovec send_sge = iovec();
   struct fid_mr* mr_send = nullptr;
-  unsigned char send_buffer[64];
+  LibfabricCollectiveMessage send_buffer;
 
   bool root_ep = false;
   bool active = true;
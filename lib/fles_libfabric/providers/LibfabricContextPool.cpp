@@ -4,6 +4,21 @@
 
 namespace tl_libfabric {
 
+namespace {
+/// Per-thread cache of free arena indices (lost when the thread exits).
+struct ContextCache {
+  static constexpr uint32_t size = 32;
+  uint32_t index[size];
+  uint32_t count = 0;
+};
+
+thread_local ContextCache context_cache;
+
+uint64_t make_head(uint64_t tag, uint32_t index) {
+  return (tag << 32) | index;
+}
+} // namespace
+
 std::unique_ptr<LibfabricContextPool>& LibfabricContextPool::getInst() {
   if (LibfabricContextPool::context_pool_ == nullptr)
     LibfabricContextPool::context_pool_ =
@@ -12,62 +27,89 @@ std::unique_ptr<LibfabricContextPool>& LibfabricContextPool::getInst() {
   return LibfabricContextPool::context_pool_;
 }
 
-LibfabricContextPool::LibfabricContextPool() {
-  ///
+LibfabricContextPool::LibfabricContextPool()
+    : arena_(new fi_custom_context[arena_size]()),
+      next_(new std::atomic<uint32_t>[arena_size]),
+      free_head_(make_head(0, 0)) {
+  for (uint32_t i = 0; i < arena_size; ++i) {
+    arena_[i].id = i;
+    next_[i].store(i + 1, std::memory_order_relaxed);
+  }
 }
-LibfabricContextPool::~LibfabricContextPool() {
 
-  for (auto it = available_.begin(); it != available_.end(); it++) {
-    delete (*it);
-  }
+LibfabricContextPool::~LibfabricContextPool() { log(); }
 
-  for (auto it = in_use_.begin(); it != in_use_.end(); it++) {
-    delete (*it);
+uint32_t LibfabricContextPool::pop_free() {
+  uint64_t head = free_head_.load(std::memory_order_acquire);
+  while (true) {
+    auto index = static_cast<uint32_t>(head);
+    if (index == nil_) {
+      return nil_;
+    }
+    uint32_t next = next_[index].load(std::memory_order_relaxed);
+    // the tag prevents a stale head from being swapped in (ABA)
+    uint64_t new_head = make_head((head >> 32) + 1, next);
+    if (free_head_.compare_exchange_weak(head, new_head,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+      return index;
+    }
   }
+}
 
-  available_.clear();
-  in_use_.clear();
-  L_(info) << "LibfabricContextPool deconstructor: Total number of created "
-              "objects "
-           << context_counter_;
+void LibfabricContextPool::push_free(uint32_t index) {
+  uint64_t head = free_head_.load(std::memory_order_relaxed);
+  do {
+    next_[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+  } while (!free_head_.compare_exchange_weak(
+      head, make_head((head >> 32) + 1, index), std::memory_order_release,
+      std::memory_order_relaxed));
 }
 
 struct fi_custom_context* LibfabricContextPool::getContext() {
-  pool_mutex_.lock();
-  if (available_.empty()) {
-    struct fi_custom_context* context = new fi_custom_context();
-    context->id = context_counter_++;
-    in_use_.push_front(context);
-    L_(debug) << "getContext:: New context is created with ID " << context->id;
+  uint64_t used = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+  uint64_t mark = high_water_mark_.load(std::memory_order_relaxed);
+  while (used > mark && !high_water_mark_.compare_exchange_weak(
+                            mark, used, std::memory_order_relaxed)) {
+  }
+
+  uint32_t index = nil_;
+  if (context_cache.count > 0) {
+    index = context_cache.index[--context_cache.count];
   } else {
-    in_use_.push_front(available_.front());
-    available_.pop_front();
+    index = pop_free();
+  }
+  if (index != nil_) {
+    return &arena_[index];
+  }
+
+  if (exhaustion_count_.fetch_add(1, std::memory_order_relaxed) == 0) {
+    L_(warning) << "LibfabricContextPool: arena of " << arena_size
+                << " contexts exhausted, allocating on the heap";
   }
-  pool_mutex_.unlock();
-  return (*in_use_.begin());
+  struct fi_custom_context* context = new fi_custom_context();
+  context->id = nil_;
+  return context;
 }
 
 void LibfabricContextPool::releaseContext(struct fi_custom_context* context) {
-  uint32_t count = 0;
-  for (auto it = in_use_.begin(); it != in_use_.end(); it++) {
-    if (context->id == (*it)->id) {
-      available_.push_back((*it));
-      in_use_.erase(it);
-      break;
-    }
-    ++count;
+  in_use_.fetch_sub(1, std::memory_order_relaxed);
+  if (context->id >= arena_size) {
+    delete context;
+    return;
+  }
+  auto index = static_cast<uint32_t>(context->id);
+  if (context_cache.count < ContextCache::size) {
+    context_cache.index[context_cache.count++] = index;
+  } else {
+    push_free(index);
   }
-  L_(debug) << "LibfabricContextPool: Context released with ID " << context->id;
 }
 
 void LibfabricContextPool::log() {
-  int i = 0;
-  for (auto it = available_.begin(); it != available_.end(); it++, i++)
-    L_(debug) << "Logging:: Available[" << i << "].id = " << (*it)->id;
-
-  i = 0;
-  for (auto it = in_use_.begin(); it != in_use_.end(); it++, i++)
-    L_(debug) << "Logging:: in_use_[" << i << "].id = " << (*it)->id;
+  L_(info) << "LibfabricContextPool: " << in_use() << " of " << arena_size
+           << " contexts in use, high-water mark " << high_water_mark()
+           << ", " << exhaustion_count() << " exhaustion events";
 }
 
 std::unique_ptr<LibfabricContextPool> LibfabricContextPool::context_pool_ =
@@ -3,13 +3,19 @@
 /**
  * An implementation of fi_context object pool based on the Object Pool Design
  * Pattern
+ *
+ * The contexts are preallocated in a fixed arena. Free contexts are kept in
+ * a lock-free list and in a small cache per thread, so that the completion
+ * and heartbeat paths do not contend for a lock. If the arena is exhausted,
+ * contexts are allocated on the heap and the event is counted.
  */
 #pragma once
 
-#include <list>
+#include "MemoryAccounting.hpp"
+#include <atomic>
+#include <cstdint>
 #include <log.hpp>
 #include <memory>
-#include <mutex>
 #include <rdma/fabric.h>
 #include <string.h>
 
@@ -22,6 +28,9 @@ struct fi_custom_context {
 
 class LibfabricContextPool {
 public:
+  /// Number of preallocated contexts.
+  static constexpr uint32_t arena_size = UINT32_C(1) << 16;
+
   ~LibfabricContextPool();
 
   LibfabricContextPool(const LibfabricContextPool&) = delete;
@@ -33,17 +42,46 @@ public:
 
   static std::unique_ptr<LibfabricContextPool>& getInst();
 
+  /// Retrieve the number of contexts currently in use.
+  uint64_t in_use() const { return in_use_.load(std::memory_order_relaxed); }
+
+  /// Retrieve the maximum number of contexts in use at the same time.
+  uint64_t high_water_mark() const {
+    return high_water_mark_.load(std::memory_order_relaxed);
+  }
+
+  /// Retrieve the number of contexts allocated beyond the arena.
+  uint64_t exhaustion_count() const {
+    return exhaustion_count_.load(std::memory_order_relaxed);
+  }
+
 private:
   static std::unique_ptr<LibfabricContextPool> context_pool_;
-  std::list<struct fi_custom_context*> available_;
-  std::list<struct fi_custom_context*> in_use_;
 
-  uint64_t context_counter_ = 0;
+  /// Index marking the end of the free list.
+  static constexpr uint32_t nil_ = arena_size;
+
+  std::unique_ptr<fi_custom_context[]> arena_;
+  std::unique_ptr<std::atomic<uint32_t>[]> next_;
 
-  std::mutex pool_mutex_;
+  /// The accounting of the arena memory.
+  MemoryAccount account_{
+      "libfabric_context_pool", MemoryUse::Committed,
+      arena_size * (sizeof(fi_custom_context) + sizeof(std::atomic<uint32_t>))};
+
+  /// Head of the free list: modification tag (high) and index (low).
+  std::atomic<uint64_t> free_head_;
+
+  std::atomic<uint64_t> in_use_{0};
+  std::atomic<uint64_t> high_water_mark_{0};
+  std::atomic<uint64_t> exhaustion_count_{0};
 
   LibfabricContextPool();
 
+  uint32_t pop_free();
+
+  void push_free(uint32_t index);
+
   void log();
 };
 } // namespace tl_libfabric
@@ -22,51 +22,88 @@
 
 namespace tl_libfabric {
 
-std::unique_ptr<Provider> Provider::get_provider(std::string local_host_name) {
-  // std::cout << "Provider::get_provider()" << std::endl;
-  struct fi_info* fiinfo = RDMOmniPathProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found OmniPath";
-    return std::unique_ptr<Provider>(new RDMOmniPathProvider(fiinfo));
-  }
+namespace {
 
-  fiinfo = MsgVerbsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found Verbs";
-    return std::unique_ptr<Provider>(new MsgVerbsProvider(fiinfo));
-  }
+struct ProviderCandidate {
+  const char* name;
+  struct fi_info* (*exists)(std::string local_host_name);
+  std::unique_ptr<Provider> (*create)(struct fi_info* info);
+};
 
-  fiinfo = RxMVerbsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found RxM Verbs";
-    return std::unique_ptr<Provider>(new RxMVerbsProvider(fiinfo));
-  }
+template <class PROVIDER>
+std::unique_ptr<Provider> create_provider(struct fi_info* info) {
+  return std::unique_ptr<Provider>(new PROVIDER(info));
+}
 
-  fiinfo = MsgGNIProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found MSG GNI";
-    return std::unique_ptr<Provider>(new MsgGNIProvider(fiinfo));
-  }
+// Known providers in the order of preference
+const ProviderCandidate candidates[] = {
+    {"psm2", RDMOmniPathProvider::exists,
+     create_provider<RDMOmniPathProvider>},
+    {"verbs", MsgVerbsProvider::exists, create_provider<MsgVerbsProvider>},
+    {"verbs-rxm", RxMVerbsProvider::exists,
+     create_provider<RxMVerbsProvider>},
+    {"gni", MsgGNIProvider::exists, create_provider<MsgGNIProvider>},
+    {"gni-rdm", RDMGNIProvider::exists, create_provider<RDMGNIProvider>},
+    {"sockets", MsgSocketsProvider::exists,
+     create_provider<MsgSocketsProvider>},
+    {"sockets-rdm", RDMSocketsProvider::exists,
+     create_provider<RDMSocketsProvider>},
+};
+
+} // namespace
 
-  fiinfo = RDMGNIProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found RDM GNI";
-    return std::unique_ptr<Provider>(new RDMGNIProvider(fiinfo));
+std::unique_ptr<Provider> Provider::get_provider(std::string local_host_name) {
+  // all available providers are probed to log their capabilities
+  std::unique_ptr<Provider> provider;
+  for (const ProviderCandidate& candidate : candidates) {
+    if (requested_name != "auto" && requested_name != candidate.name) {
+      continue;
+    }
+    struct fi_info* fiinfo = candidate.exists(local_host_name);
+    if (fiinfo == nullptr) {
+      continue;
+    }
+    log_capabilities(candidate.name, fiinfo, !provider);
+    if (!provider) {
+      provider = candidate.create(fiinfo);
+    } else {
+      fi_freeinfo(fiinfo);
+    }
   }
 
-  fiinfo = MsgSocketsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found Sockets";
-    return std::unique_ptr<Provider>(new MsgSocketsProvider(fiinfo));
+  if (!provider) {
+    if (requested_name != "auto") {
+      throw LibfabricException("Libfabric provider " + requested_name +
+                               " not found");
+    }
+    throw LibfabricException("no known Libfabric provider found");
   }
+  return provider;
+}
 
-  fiinfo = RDMSocketsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found rdm";
-    return std::unique_ptr<Provider>(new RDMSocketsProvider(fiinfo));
+void Provider::log_capabilities(const std::string& name,
+                                const struct fi_info* info,
+                                bool selected) {
+  const struct fi_tx_attr* tx = info->tx_attr;
+  const struct fi_domain_attr* domain = info->domain_attr;
+  std::string order;
+  for (auto flag : {std::make_pair(FI_ORDER_RAW, "RAW"),
+                    std::make_pair(FI_ORDER_WAW, "WAW"),
+                    std::make_pair(FI_ORDER_SAW, "SAW"),
+                    std::make_pair(FI_ORDER_SAS, "SAS")}) {
+    if ((tx->msg_order & flag.first) != 0) {
+      order += order.empty() ? flag.second : std::string(",") + flag.second;
+    }
   }
-
-  throw LibfabricException("no known Libfabric provider found");
+  L_(selected ? info : debug)
+      << (selected ? "using" : "available") << " Libfabric provider " << name
+      << " (" << info->fabric_attr->prov_name << "): inject size "
+      << tx->inject_size << ", max SGE " << tx->iov_limit << ", RMA SGE "
+      << tx->rma_iov_limit << ", max message size "
+      << info->ep_attr->max_msg_size << ", CQ data size "
+      << domain->cq_data_size << ", MR mode 0x" << std::hex
+      << domain->mr_mode << std::dec << ", order "
+      << (order.empty() ? "none" : order);
 }
 
 struct fi_info* Provider::get_hints(enum fi_ep_type ep_type, std::string prov) {
@@ -88,5 +125,7 @@ uint64_t Provider::requested_key = 0;
 
 std::unique_ptr<Provider> Provider::prov;
 
+std::string Provider::requested_name = "auto";
+
 int Provider::vector = 0;
 } // namespace tl_libfabric
@@ -12,7 +12,9 @@
 #include "LibfabricException.hpp"
 
 #include <memory>
+#include <string>
 #include <string.h>
+#include <utility>
 #include <vector>
 
 #ifndef FIVERSION
@@ -55,6 +57,16 @@ public:
     prov = get_provider(local_host_name);
   }
 
+  /// Select the provider to use by name ("auto": the first one found).
+  static void set_requested_name(std::string name) {
+    requested_name = std::move(name);
+  }
+
+  /// Log the capabilities relevant to flesnet of a provider.
+  static void log_capabilities(const std::string& name,
+                               const struct fi_info* info,
+                               bool selected);
+
   virtual void set_hostnames_and_services(
       struct fid_av* /*av*/,
       const std::vector<std::string>& /*compute_hostnames*/,
@@ -74,5 +86,6 @@ public:
 private:
   static std::unique_ptr<Provider> get_provider(std::string local_host_name);
   static std::unique_ptr<Provider> prov;
+  static std::string requested_name;
 };
 } // namespace tl_libfabric
@@ -0,0 +1,401 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Python bindings for timeslice access (module `fles`).
+///
+/// Provides `fles.TimesliceSource(locator)`, an iterable yielding
+/// `fles.Timeslice` objects. The microslice descriptors and contents of
+/// their components are exported through the buffer protocol without
+/// copying, e.g.:
+///
+///     for ts in fles.TimesliceSource("shm://127.0.0.1/fles_out_shared"):
+///         desc = numpy.asarray(ts.descriptors(0))  # structured array
+///         data = ts.contents(0)                    # memoryview
+///
+/// The exported buffers keep the timeslice alive. A timeslice from a shared
+/// memory source is completed when the timeslice object and all buffers
+/// referring to it have been released.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "MicrosliceDescriptor.hpp"
+#include "Timeslice.hpp"
+#include "TimesliceAutoSource.hpp"
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+
+namespace {
+
+/// PEP 3118 format string matching fles::MicrosliceDescriptor.
+char descriptor_format[] = "T{<B:hdr_id:B:hdr_ver:H:eq_id:H:flags:"
+                           "B:sys_id:B:sys_ver:Q:idx:I:crc:I:size:Q:offset:}";
+char byte_format[] = "B";
+
+static_assert(sizeof(fles::MicrosliceDescriptor) == 32,
+              "descriptor format string out of date");
+
+PyTypeObject* timeslice_type = nullptr;
+PyTypeObject* region_type = nullptr;
+
+struct PyTimesliceSource {
+  PyObject_HEAD
+  fles::TimesliceAutoSource* source;
+};
+
+struct PyTimeslice {
+  PyObject_HEAD
+  fles::Timeslice* timeslice;
+  PyObject* source; // the PyTimesliceSource, which has to outlive the data
+};
+
+/// A memory region of a timeslice exported through the buffer protocol.
+struct PyRegion {
+  PyObject_HEAD
+  PyObject* owner; // the PyTimeslice the memory belongs to
+  const void* ptr;
+  Py_ssize_t size;     // number of items
+  Py_ssize_t itemsize; // bytes per item
+  char* format;
+};
+
+int set_error(const std::exception& e) {
+  PyErr_SetString(PyExc_RuntimeError, e.what());
+  return -1;
+}
+
+/// The tp_new slot of types that are created by the module only.
+PyObject* no_new(PyTypeObject* type, PyObject* /* args */,
+                 PyObject* /* kwds */) {
+  PyErr_Format(PyExc_TypeError, "cannot create '%s' instances",
+               type->tp_name);
+  return nullptr;
+}
+
+// --- TimesliceSource -------------------------------------------------------
+
+int source_init(PyObject* self, PyObject* args, PyObject* /* kwds */) {
+  auto* s = reinterpret_cast<PyTimesliceSource*>(self);
+  const char* locator = nullptr;
+  if (PyArg_ParseTuple(args, "s", &locator) == 0) {
+    return -1;
+  }
+  try {
+    delete s->source;
+    s->source = nullptr;
+    s->source = new fles::TimesliceAutoSource(std::string(locator));
+  } catch (const std::exception& e) {
+    return set_error(e);
+  }
+  return 0;
+}
+
+void source_dealloc(PyObject* self) {
+  auto* s = reinterpret_cast<PyTimesliceSource*>(self);
+  delete s->source;
+  PyTypeObject* type = Py_TYPE(self);
+  type->tp_free(self);
+  Py_DECREF(type);
+}
+
+PyObject* source_iter(PyObject* self) {
+  Py_INCREF(self);
+  return self;
+}
+
+PyObject* source_next(PyObject* self) {
+  auto* s = reinterpret_cast<PyTimesliceSource*>(self);
+  if (s->source == nullptr) {
+    PyErr_SetString(PyExc_RuntimeError, "source not initialized");
+    return nullptr;
+  }
+  std::unique_ptr<fles::Timeslice> ts;
+  std::string error;
+  // waiting for the next timeslice must not block other Python threads
+  Py_BEGIN_ALLOW_THREADS;
+  try {
+    ts = s->source->get();
+  } catch (const std::exception& e) {
+    error = e.what();
+  }
+  Py_END_ALLOW_THREADS;
+  if (!error.empty()) {
+    PyErr_SetString(PyExc_RuntimeError, error.c_str());
+    return nullptr;
+  }
+  if (!ts) {
+    return nullptr; // StopIteration
+  }
+  auto* t = PyObject_New(PyTimeslice, timeslice_type);
+  if (t == nullptr) {
+    return nullptr;
+  }
+  t->timeslice = ts.release();
+  Py_INCREF(self);
+  t->source = self;
+  return reinterpret_cast<PyObject*>(t);
+}
+
+PyObject* source_eos(PyObject* self, PyObject* /* args */) {
+  auto* s = reinterpret_cast<PyTimesliceSource*>(self);
+  return PyBool_FromLong(s->source != nullptr && s->source->eos() ? 1 : 0);
+}
+
+PyMethodDef source_methods[] = {
+    {"eos", source_eos, METH_NOARGS, "Return the end-of-stream state."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyType_Slot source_slots[] = {
+    {Py_tp_doc, const_cast<char*>(
+                    "TimesliceSource(locator)\n\nIterable timeslice source "
+                    "using a locator as understood by TimesliceAutoSource.")},
+    {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void*>(source_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(source_dealloc)},
+    {Py_tp_iter, reinterpret_cast<void*>(source_iter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(source_next)},
+    {Py_tp_methods, source_methods},
+    {0, nullptr}};
+
+PyType_Spec source_spec = {"fles.TimesliceSource", sizeof(PyTimesliceSource),
+                           0, Py_TPFLAGS_DEFAULT, source_slots};
+
+// --- Timeslice -------------------------------------------------------------
+
+void timeslice_dealloc(PyObject* self) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  // for shared memory timeslices, this sends the completion
+  delete t->timeslice;
+  Py_DECREF(t->source);
+  PyTypeObject* type = Py_TYPE(self);
+  type->tp_free(self);
+  Py_DECREF(type);
+}
+
+/// Parse and check a component number argument.
+bool parse_component(PyTimeslice* t, PyObject* arg, uint64_t& component) {
+  component = PyLong_AsUnsignedLongLong(arg);
+  if (PyErr_Occurred() != nullptr) {
+    return false;
+  }
+  if (component >= t->timeslice->num_components()) {
+    PyErr_SetString(PyExc_IndexError, "component out of range");
+    return false;
+  }
+  return true;
+}
+
+/// Export a memory region of a timeslice as a memoryview.
+PyObject* make_view(PyObject* owner,
+                    const void* ptr,
+                    uint64_t size,
+                    Py_ssize_t itemsize,
+                    char* format) {
+  auto* region = PyObject_New(PyRegion, region_type);
+  if (region == nullptr) {
+    return nullptr;
+  }
+  Py_INCREF(owner);
+  region->owner = owner;
+  region->ptr = ptr;
+  region->size = static_cast<Py_ssize_t>(size);
+  region->itemsize = itemsize;
+  region->format = format;
+  PyObject* view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(region));
+  Py_DECREF(region);
+  return view;
+}
+
+PyObject* timeslice_num_microslices(PyObject* self, PyObject* arg) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  uint64_t c = 0;
+  if (!parse_component(t, arg, c)) {
+    return nullptr;
+  }
+  return PyLong_FromUnsignedLongLong(t->timeslice->num_microslices(c));
+}
+
+PyObject* timeslice_descriptors(PyObject* self, PyObject* arg) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  uint64_t c = 0;
+  if (!parse_component(t, arg, c)) {
+    return nullptr;
+  }
+  fles::ComponentView view = t->timeslice->component(c);
+  return make_view(self, view.descriptors(), view.size(),
+                   sizeof(fles::MicrosliceDescriptor), descriptor_format);
+}
+
+PyObject* timeslice_contents(PyObject* self, PyObject* arg) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  uint64_t c = 0;
+  if (!parse_component(t, arg, c)) {
+    return nullptr;
+  }
+  fles::ComponentView view = t->timeslice->component(c);
+  if (view.empty()) {
+    return make_view(self, view.descriptors(), 0, 1, byte_format);
+  }
+  const fles::MicrosliceDescriptor& last = view.descriptor(view.size() - 1);
+  uint64_t size = last.offset + last.size - view.descriptor(0).offset;
+  return make_view(self, view.content(0), size, 1, byte_format);
+}
+
+PyObject* timeslice_content(PyObject* self, PyObject* args) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  PyObject* component = nullptr;
+  unsigned long long microslice = 0;
+  if (PyArg_ParseTuple(args, "OK", &component, &microslice) == 0) {
+    return nullptr;
+  }
+  uint64_t c = 0;
+  if (!parse_component(t, component, c)) {
+    return nullptr;
+  }
+  fles::ComponentView view = t->timeslice->component(c);
+  if (microslice >= view.size()) {
+    PyErr_SetString(PyExc_IndexError, "microslice out of range");
+    return nullptr;
+  }
+  return make_view(self, view.content(microslice),
+                   view.descriptor(microslice).size, 1, byte_format);
+}
+
+PyObject* timeslice_index(PyObject* self, void* /* closure */) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  return PyLong_FromUnsignedLongLong(t->timeslice->index());
+}
+
+PyObject* timeslice_num_core_microslices(PyObject* self, void* /* closure */) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  return PyLong_FromUnsignedLongLong(t->timeslice->num_core_microslices());
+}
+
+PyObject* timeslice_num_components(PyObject* self, void* /* closure */) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  return PyLong_FromUnsignedLongLong(t->timeslice->num_components());
+}
+
+PyObject* timeslice_start_time(PyObject* self, void* /* closure */) {
+  auto* t = reinterpret_cast<PyTimeslice*>(self);
+  return PyLong_FromUnsignedLongLong(t->timeslice->start_time());
+}
+
+PyMethodDef timeslice_methods[] = {
+    {"num_microslices", timeslice_num_microslices, METH_O,
+     "num_microslices(c)\n\nReturn the number of microslices of component c."},
+    {"descriptors", timeslice_descriptors, METH_O,
+     "descriptors(c)\n\nReturn the microslice descriptors of component c as "
+     "a memoryview of a structured type (use numpy.asarray())."},
+    {"contents", timeslice_contents, METH_O,
+     "contents(c)\n\nReturn the contiguous microslice contents of component c "
+     "as a memoryview. The content of microslice m starts at descriptor "
+     "offset[m] - offset[0]."},
+    {"content", timeslice_content, METH_VARARGS,
+     "content(c, m)\n\nReturn the content of microslice m of component c as a "
+     "memoryview."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyGetSetDef timeslice_getset[] = {
+    {"index", timeslice_index, nullptr, "timeslice index", nullptr},
+    {"num_core_microslices", timeslice_num_core_microslices, nullptr,
+     "number of core microslices", nullptr},
+    {"num_components", timeslice_num_components, nullptr,
+     "number of components", nullptr},
+    {"start_time", timeslice_start_time, nullptr,
+     "start time (index of the first microslice of component 0)", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyType_Slot timeslice_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Read-only access to a timeslice.")},
+    {Py_tp_new, reinterpret_cast<void*>(no_new)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(timeslice_dealloc)},
+    {Py_tp_methods, timeslice_methods},
+    {Py_tp_getset, timeslice_getset},
+    {0, nullptr}};
+
+PyType_Spec timeslice_spec = {"fles.Timeslice", sizeof(PyTimeslice), 0,
+                              Py_TPFLAGS_DEFAULT, timeslice_slots};
+
+// --- Region ----------------------------------------------------------------
+
+int region_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+  auto* r = reinterpret_cast<PyRegion*>(self);
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "timeslice data is read-only");
+    return -1;
+  }
+  view->buf = const_cast<void*>(r->ptr);
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = r->size * r->itemsize;
+  view->readonly = 1;
+  view->itemsize = r->itemsize;
+  view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? r->format : nullptr;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &r->size : nullptr;
+  view->strides =
+      (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &r->itemsize : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+  return 0;
+}
+
+void region_dealloc(PyObject* self) {
+  auto* r = reinterpret_cast<PyRegion*>(self);
+  Py_DECREF(r->owner);
+  PyTypeObject* type = Py_TYPE(self);
+  type->tp_free(self);
+  Py_DECREF(type);
+}
+
+PyType_Slot region_slots[] = {
+    {Py_tp_new, reinterpret_cast<void*>(no_new)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(region_dealloc)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(region_getbuffer)},
+    {0, nullptr}};
+
+PyType_Spec region_spec = {"fles._Region", sizeof(PyRegion), 0,
+                           Py_TPFLAGS_DEFAULT, region_slots};
+
+// --- Module ----------------------------------------------------------------
+
+PyModuleDef fles_module = {
+    PyModuleDef_HEAD_INIT, "fles",
+    "Zero-copy access to FLES timeslices.", -1, nullptr,
+    nullptr, nullptr, nullptr, nullptr};
+
+/// Create a type from a spec and add it to the module.
+PyTypeObject* add_type(PyObject* module, PyType_Spec* spec, const char* name) {
+  PyObject* type = PyType_FromSpec(spec);
+  if (type == nullptr) {
+    return nullptr;
+  }
+  if (name != nullptr) {
+    Py_INCREF(type);
+    if (PyModule_AddObject(module, name, type) < 0) {
+      Py_DECREF(type);
+      Py_DECREF(type);
+      return nullptr;
+    }
+  }
+  return reinterpret_cast<PyTypeObject*>(type);
+}
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_fles() {
+  PyObject* module = PyModule_Create(&fles_module);
+  if (module == nullptr) {
+    return nullptr;
+  }
+  region_type = add_type(module, &region_spec, nullptr);
+  timeslice_type = add_type(module, &timeslice_spec, "Timeslice");
+  if (region_type == nullptr || timeslice_type == nullptr ||
+      add_type(module, &source_spec, "TimesliceSource") == nullptr) {
+    Py_DECREF(module);
+    return nullptr;
+  }
+  return module;
+}
@@ -2,10 +2,26 @@
 
 #include "ComputeNodeConnection.hpp"
 #include "ComputeNodeInfo.hpp"
+#include "MemoryPlacement.hpp"
 #include "RequestIdentifier.hpp"
 #include "log.hpp"
+#include <algorithm>
+#include <array>
 #include <cassert>
 
+namespace {
+
+// Record the time elapsed since a work request was posted (in us).
+void record_latency(cbm::MetricHistogram& histogram,
+                    std::chrono::steady_clock::time_point posted) {
+  histogram.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - posted)
+          .count()));
+}
+
+} // namespace
+
 ComputeNodeConnection::ComputeNodeConnection(
     struct rdma_event_channel* ec,
     uint_fast16_t connection_index,
@@ -26,6 +42,9 @@ ComputeNodeConnection::ComputeNodeConnection(
   qp_cap_.max_send_sge = 1;
   qp_cap_.max_recv_wr = 1;
   qp_cap_.max_recv_sge = 1;
+
+  // status messages are small enough to be sent inline
+  qp_cap_.max_inline_data = sizeof(ComputeNodeStatusMessage);
 }
 
 void ComputeNodeConnection::post_recv_status_message() {
@@ -48,59 +67,157 @@ void ComputeNodeConnection::post_send_status_message() {
     throw InfinibandException("Max number of pending send requests exceeded");
   }
   ++pending_send_requests_;
+  if (lifecycle()) {
+    send_status_message_.time = lifecycle_now();
+  }
+  if (send_latency_) {
+    send_posted_.push_back(std::chrono::steady_clock::now());
+  }
   post_send(&send_wr);
 }
 
 void ComputeNodeConnection::post_send_final_status_message() {
   send_wr.wr_id = ID_SEND_FINALIZE | (index_ << 8);
-  send_wr.send_flags = IBV_SEND_SIGNALED;
+  send_wr.send_flags =
+      IBV_SEND_SIGNALED | inline_flag(sizeof(ComputeNodeStatusMessage));
   post_send_status_message();
 }
 
-void ComputeNodeConnection::setup(struct ibv_pd* pd) {
-  assert(data_ptr_ && desc_ptr_ && data_buffer_size_exp_ &&
-         desc_buffer_size_exp_);
+void ComputeNodeConnection::set_pull(uint32_t max_reads) {
+  assert(max_reads > 0);
+  pull_requests_.resize(UINT64_C(1) << desc_buffer_size_exp_);
+  read_depth_ = static_cast<uint8_t>(std::min(max_reads, max_read_depth));
+  // a component is read in up to four parts
+  qp_cap_.max_send_wr += 4 * max_reads;
+}
+
+void ComputeNodeConnection::set_lifecycle() {
+  lifecycle_.resize(UINT64_C(1) << desc_buffer_size_exp_);
+}
+
+void ComputeNodeConnection::set_latency_metrics(
+    cbm::MetricHistogram send_latency, cbm::MetricHistogram read_latency) {
+  send_latency_ = std::move(send_latency);
+  read_latency_ = std::move(read_latency);
+}
+
+TimesliceLifecycle ComputeNodeConnection::local_lifecycle(uint64_t pos,
+                                                          uint64_t written) {
+  TimesliceLifecycle record =
+      lifecycle_[pos & ((UINT64_C(1) << desc_buffer_size_exp_) - 1)];
+  if (record.status_sent != 0) {
+    clock_offset_.add(static_cast<int64_t>(record.status_sent),
+                      static_cast<int64_t>(record.status_received),
+                      static_cast<int64_t>(record.posted),
+                      static_cast<int64_t>(written));
+  }
+  // without an estimate yet, the clocks are assumed to be synchronized
+  if (clock_offset_.valid()) {
+    auto offset = static_cast<uint64_t>(clock_offset_.offset());
+    record.first_available -= offset;
+    record.last_available -= offset;
+    record.posted -= offset;
+  }
+  return record;
+}
 
+void ComputeNodeConnection::register_buffers(struct ibv_pd* pd) {
   // register memory regions
   std::size_t data_bytes = UINT64_C(1) << data_buffer_size_exp_;
   std::size_t desc_bytes = (UINT64_C(1) << desc_buffer_size_exp_) *
                            sizeof(fles::TimesliceComponentDescriptor);
-  mr_data_ = ibv_reg_mr(pd, data_ptr_, data_bytes,
-                        IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
-  mr_desc_ = ibv_reg_mr(pd, desc_ptr_, desc_bytes,
-                        IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
-  mr_send_ = ibv_reg_mr(pd, &send_status_message_,
-                        sizeof(ComputeNodeStatusMessage), 0);
-  mr_recv_ =
-      ibv_reg_mr(pd, &recv_status_message_, sizeof(InputChannelStatusMessage),
-                 IBV_ACCESS_LOCAL_WRITE);
-
-  if ((mr_data_ == nullptr) || (mr_desc_ == nullptr) || (mr_recv_ == nullptr) ||
-      (mr_send_ == nullptr)) {
+  // device memory without dma-buf support is registered through a peer
+  // memory kernel module like host memory
+  if (data_dmabuf_fd_ >= 0) {
+    mr_data_ = ibv_reg_dmabuf_mr(
+        pd, data_dmabuf_offset_, data_bytes,
+        reinterpret_cast<uintptr_t>(data_ptr_), data_dmabuf_fd_,
+        IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+  } else {
+    mr_data_ = register_memory(
+        pd, data_ptr_, data_bytes,
+        IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE, registration_,
+        "[" + std::to_string(index_) + "] data buffer");
+  }
+  mr_desc_ = register_memory(
+      pd, desc_ptr_, desc_bytes,
+      IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE, registration_,
+      "[" + std::to_string(index_) + "] desc buffer");
+  if ((mr_data_ == nullptr) || (mr_desc_ == nullptr)) {
     throw InfinibandException("registration of memory region failed");
   }
+  registered_account_ = MemoryAccount(
+      "rdma_timeslice_buffer", MemoryUse::Registered,
+      desc_bytes + (data_dmabuf_fd_ >= 0 ? 0 : data_bytes),
+      numa_node_of_memory(desc_ptr_));
+  if (pull()) {
+    mr_pull_ = ibv_reg_mr(pd, pull_requests_.data(),
+                          pull_requests_.size() * sizeof(PullRequest),
+                          IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+    if (mr_pull_ == nullptr) {
+      throw InfinibandException("registration of memory region failed");
+    }
+  }
+  if (lifecycle()) {
+    mr_lifecycle_ =
+        ibv_reg_mr(pd, lifecycle_.data(),
+                   lifecycle_.size() * sizeof(TimesliceLifecycle),
+                   IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+    if (mr_lifecycle_ == nullptr) {
+      throw InfinibandException("registration of memory region failed");
+    }
+  }
+}
+
+void ComputeNodeConnection::setup(struct ibv_pd* pd) {
+  assert(data_ptr_ && desc_ptr_ && data_buffer_size_exp_ &&
+         desc_buffer_size_exp_);
 
-  // setup send and receive buffers
-  recv_sge.addr = reinterpret_cast<uintptr_t>(&recv_status_message_);
-  recv_sge.length = sizeof(InputChannelStatusMessage);
-  recv_sge.lkey = mr_recv_->lkey;
+  register_buffers(pd);
+
+  // status messages sent inline need no registered buffer, and with a
+  // shared receive queue, the receive buffers belong to the group
+  if (inline_flag(sizeof(ComputeNodeStatusMessage)) == 0) {
+    mr_send_ = ibv_reg_mr(pd, &send_status_message_,
+                          sizeof(ComputeNodeStatusMessage), 0);
+    if (mr_send_ == nullptr) {
+      throw InfinibandException("registration of memory region failed");
+    }
+  }
+  if (srq_ == nullptr) {
+    mr_recv_ = ibv_reg_mr(pd, &recv_status_message_,
+                          sizeof(InputChannelStatusMessage),
+                          IBV_ACCESS_LOCAL_WRITE);
+    if (mr_recv_ == nullptr) {
+      throw InfinibandException("registration of memory region failed");
+    }
 
-  recv_wr.wr_id = ID_RECEIVE_STATUS | (index_ << 8);
-  recv_wr.sg_list = &recv_sge;
-  recv_wr.num_sge = 1;
+    // setup receive buffer
+    recv_sge.addr = reinterpret_cast<uintptr_t>(&recv_status_message_);
+    recv_sge.length = sizeof(InputChannelStatusMessage);
+    recv_sge.lkey = mr_recv_->lkey;
 
+    recv_wr.wr_id = ID_RECEIVE_STATUS | (index_ << 8);
+    recv_wr.sg_list = &recv_sge;
+    recv_wr.num_sge = 1;
+  }
+
+  // setup send buffer
   send_sge.addr = reinterpret_cast<uintptr_t>(&send_status_message_);
   send_sge.length = sizeof(ComputeNodeStatusMessage);
-  send_sge.lkey = mr_send_->lkey;
+  send_sge.lkey = (mr_send_ != nullptr) ? mr_send_->lkey : 0;
 
   send_wr.wr_id = ID_SEND_STATUS | (index_ << 8);
   send_wr.opcode = IBV_WR_SEND;
-  send_wr.send_flags = IBV_SEND_SIGNALED;
+  send_wr.send_flags =
+      IBV_SEND_SIGNALED | inline_flag(sizeof(ComputeNodeStatusMessage));
   send_wr.sg_list = &send_sge;
   send_wr.num_sge = 1;
 
   // post initial receive request
-  post_recv_status_message();
+  if (srq_ == nullptr) {
+    post_recv_status_message();
+  }
 }
 
 void ComputeNodeConnection::on_established(struct rdma_cm_event* event) {
@@ -123,6 +240,22 @@ void ComputeNodeConnection::on_disconnected(struct rdma_cm_event* event) {
     mr_send_ = nullptr;
   }
 
+  deregister_buffers();
+
+  IBConnection::on_disconnected(event);
+}
+
+void ComputeNodeConnection::deregister_buffers() {
+  if (mr_pull_ != nullptr) {
+    ibv_dereg_mr(mr_pull_);
+    mr_pull_ = nullptr;
+  }
+
+  if (mr_lifecycle_ != nullptr) {
+    ibv_dereg_mr(mr_lifecycle_);
+    mr_lifecycle_ = nullptr;
+  }
+
   if (mr_desc_ != nullptr) {
     ibv_dereg_mr(mr_desc_);
     mr_desc_ = nullptr;
@@ -132,17 +265,57 @@ void ComputeNodeConnection::on_disconnected(struct rdma_cm_event* event) {
     ibv_dereg_mr(mr_data_);
     mr_data_ = nullptr;
   }
+  registered_account_ = MemoryAccount();
+}
 
-  IBConnection::on_disconnected(event);
+void ComputeNodeConnection::remap(struct ibv_pd* pd,
+                                  uint8_t* data_ptr,
+                                  uint32_t data_buffer_size_exp,
+                                  fles::TimesliceComponentDescriptor* desc_ptr,
+                                  uint32_t desc_buffer_size_exp) {
+  assert(cn_ack_.desc == cn_wp_.desc && pending_reads_ == 0);
+  deregister_buffers();
+  data_ptr_ = data_ptr;
+  data_buffer_size_exp_ = data_buffer_size_exp;
+  desc_ptr_ = desc_ptr;
+  desc_buffer_size_exp_ = desc_buffer_size_exp;
+  if (pull()) {
+    pull_requests_.assign(UINT64_C(1) << desc_buffer_size_exp_, {});
+  }
+  if (lifecycle()) {
+    lifecycle_.assign(UINT64_C(1) << desc_buffer_size_exp_, {});
+  }
+  register_buffers(pd);
+
+  ComputeNodeResize& resize = send_status_message_.resize;
+  resize.barrier = 0;
+  ++resize.generation;
+  buffer_info(resize.info);
 }
 
 void ComputeNodeConnection::inc_ack_pointers(uint64_t ack_pos) {
+  ack_pos = std::min(ack_pos, cn_wp_.desc);
+  if (ack_pos <= cn_ack_.desc) {
+    return;
+  }
   cn_ack_.desc = ack_pos;
 
   const fles::TimesliceComponentDescriptor& acked_ts =
       desc_ptr_[(ack_pos - 1) & ((UINT64_C(1) << desc_buffer_size_exp_) - 1)];
 
   cn_ack_.data = acked_ts.offset + acked_ts.size;
+  publish_buffer_status();
+}
+
+void ComputeNodeConnection::announce_credit(uint64_t epoch,
+                                            uint32_t credit,
+                                            uint32_t size) {
+  const bool consecutive = cn_credit_.epoch + 1 == epoch;
+  cn_credit_.value[1] = consecutive ? cn_credit_.value[0] : 0;
+  cn_credit_.size[1] = consecutive ? cn_credit_.size[0] : 0;
+  cn_credit_.value[0] = credit;
+  cn_credit_.size[0] = size;
+  cn_credit_.epoch = epoch;
 }
 
 void ComputeNodeConnection::on_complete_recv() {
@@ -161,13 +334,96 @@ void ComputeNodeConnection::on_complete_recv() {
               << "COMPLETE RECEIVE status message"
               << " (wp.desc=" << recv_status_message_.wp.desc << ")";
   }
-  cn_wp_ = recv_status_message_.wp;
-  post_recv_status_message();
+  if (pull()) {
+    // the data is written by ourselves once it has been read
+    pull_wp_ = recv_status_message_.wp;
+  } else {
+    cn_wp_ = recv_status_message_.wp;
+  }
+  if (srq_ == nullptr) {
+    post_recv_status_message();
+  }
   send_status_message_.ack = cn_ack_;
+  send_status_message_.read = cn_wp_;
+  send_status_message_.credit = cn_credit_;
+  publish_buffer_status();
   post_send_status_message();
 }
 
-void ComputeNodeConnection::on_complete_send() { pending_send_requests_--; }
+void ComputeNodeConnection::on_complete_recv(
+    const InputChannelStatusMessage& message) {
+  recv_status_message_ = message;
+  on_complete_recv();
+}
+
+void ComputeNodeConnection::post_reads(uint64_t pos) {
+  const PullRequest& request =
+      pull_requests_[pos & ((UINT64_C(1) << desc_buffer_size_exp_) - 1)];
+  if (request.num_segments == 0 || request.num_segments > 4) {
+    throw InfinibandException("invalid pull request");
+  }
+
+  // the input node skips the end of the buffer instead of wrapping
+  uint64_t target =
+      request.desc.offset & ((UINT64_C(1) << data_buffer_size_exp_) - 1);
+  assert(target + request.desc.size <= (UINT64_C(1) << data_buffer_size_exp_));
+
+  std::array<ibv_sge, 4> sge{};
+  std::array<ibv_send_wr, 4> wr{};
+  for (uint32_t i = 0; i < request.num_segments; ++i) {
+    const PullSegment& segment = request.segment[i];
+    sge[i].addr = reinterpret_cast<uintptr_t>(data_ptr_ + target);
+    sge[i].length = segment.length;
+    sge[i].lkey = mr_data_->lkey;
+    target += segment.length;
+
+    wr[i].wr_id = ID_READ_DATA | (index_ << 8);
+    wr[i].opcode = IBV_WR_RDMA_READ;
+    wr[i].sg_list = &sge[i];
+    wr[i].num_sge = 1;
+    wr[i].wr.rdma.remote_addr = segment.addr;
+    wr[i].wr.rdma.rkey = segment.rkey;
+    if (i > 0) {
+      wr[i - 1].next = &wr[i];
+    }
+  }
+  // reads complete in order, so a single completion covers all of them
+  wr[request.num_segments - 1].send_flags = IBV_SEND_SIGNALED;
+
+  if (false) {
+    L_(trace) << "[c" << remote_index_ << "] "
+              << "[" << index_ << "] "
+              << "POST READ data (timeslice " << request.desc.ts_num << ")";
+  }
+  ++pending_reads_;
+  if (read_latency_) {
+    read_posted_.push_back(std::chrono::steady_clock::now());
+  }
+  post_send(wr.data());
+}
+
+void ComputeNodeConnection::on_complete_read() {
+  assert(cn_wp_.desc < pull_wp_.desc);
+  --pending_reads_;
+  if (!read_posted_.empty()) {
+    record_latency(read_latency_, read_posted_.front());
+    read_posted_.pop_front();
+  }
+  uint64_t slot = cn_wp_.desc & ((UINT64_C(1) << desc_buffer_size_exp_) - 1);
+  const fles::TimesliceComponentDescriptor& desc = pull_requests_[slot].desc;
+  desc_ptr_[slot] = desc;
+  cn_wp_.desc += 1;
+  cn_wp_.data = desc.offset + desc.size;
+  publish_buffer_status();
+}
+
+void ComputeNodeConnection::on_complete_send() {
+  pending_send_requests_--;
+  if (!send_posted_.empty()) {
+    record_latency(send_latency_, send_posted_.front());
+    send_posted_.pop_front();
+  }
+}
 
 void ComputeNodeConnection::on_complete_send_finalize() { done_ = true; }
 
@@ -179,13 +435,25 @@ ComputeNodeConnection::get_private_data() {
       new std::vector<uint8_t>(sizeof(ComputeNodeInfo)));
 
   auto* cn_info = reinterpret_cast<ComputeNodeInfo*>(private_data->data());
-  cn_info->data.addr = reinterpret_cast<uintptr_t>(data_ptr_);
-  cn_info->data.rkey = mr_data_->rkey;
-  cn_info->desc.addr = reinterpret_cast<uintptr_t>(desc_ptr_);
-  cn_info->desc.rkey = mr_desc_->rkey;
-  cn_info->index = remote_index_;
-  cn_info->data_buffer_size_exp = data_buffer_size_exp_;
-  cn_info->desc_buffer_size_exp = desc_buffer_size_exp_;
+  buffer_info(*cn_info);
 
   return private_data;
 }
+
+void ComputeNodeConnection::buffer_info(ComputeNodeInfo& info) const {
+  info.data.addr = reinterpret_cast<uintptr_t>(data_ptr_);
+  info.data.rkey = mr_data_->rkey;
+  info.desc.addr = reinterpret_cast<uintptr_t>(desc_ptr_);
+  info.desc.rkey = mr_desc_->rkey;
+  if (pull()) {
+    info.pull.addr = reinterpret_cast<uintptr_t>(pull_requests_.data());
+    info.pull.rkey = mr_pull_->rkey;
+  }
+  if (lifecycle()) {
+    info.lifecycle.addr = reinterpret_cast<uintptr_t>(lifecycle_.data());
+    info.lifecycle.rkey = mr_lifecycle_->rkey;
+  }
+  info.index = remote_index_;
+  info.data_buffer_size_exp = data_buffer_size_exp_;
+  info.desc_buffer_size_exp = desc_buffer_size_exp_;
+}
@@ -1,13 +1,23 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "BufferStatusSampler.hpp"
+#include "ClockOffset.hpp"
 #include "ComputeNodeStatusMessage.hpp"
 #include "IBConnection.hpp"
 #include "InputChannelStatusMessage.hpp"
 #include "InputNodeInfo.hpp"
+#include "MemoryAccounting.hpp"
+#include "MemoryRegistration.hpp"
+#include "Monitor.hpp"
+#include "PullRequest.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceLifecycle.hpp"
 #include <boost/format.hpp>
 #include <chrono>
+#include <deque>
+#include <memory>
+#include <utility>
 
 /// Compute node connection class.
 /** A ComputeNodeConnection object represents the endpoint of a single
@@ -40,6 +50,91 @@ public:
 
   bool abort_flag() { return recv_status_message_.abort; }
 
+  /// Register the data buffer as part of a dma-buf (e.g., in GPU memory).
+  /**
+     \param fd     File descriptor of the dma-buf
+     \param offset Offset of the data buffer within the dma-buf
+  */
+  void set_data_dmabuf(int fd, uint64_t offset) {
+    data_dmabuf_fd_ = fd;
+    data_dmabuf_offset_ = offset;
+  }
+
+  /// Retrieve the number of overlap microslices sent by the input node.
+  [[nodiscard]] uint32_t overlap_size() const {
+    return remote_info_.overlap_size;
+  }
+
+  /// Set the registration options of the data and descriptor buffers.
+  void set_registration(const MemoryRegistration& registration) {
+    registration_ = registration;
+  }
+
+  /// Read the data announced by pull requests of the input node (pull mode).
+  /** Must be called before the connection is set up. The components of at
+      most max_reads pull requests are read at the same time. */
+  void set_pull(uint32_t max_reads);
+
+  /// Check whether the data is read by the compute node (pull mode).
+  [[nodiscard]] bool pull() const { return !pull_requests_.empty(); }
+
+  /// Retrieve the buffer positions announced by pull requests (pull mode).
+  [[nodiscard]] const ComputeNodeBufferPosition& pull_wp() const {
+    return pull_wp_;
+  }
+
+  /// Receive the lifecycle timestamps of the components from the input node.
+  /** Must be called before the connection is set up. */
+  void set_lifecycle();
+
+  /// Check whether lifecycle records are received.
+  [[nodiscard]] bool lifecycle() const { return !lifecycle_.empty(); }
+
+  /// Retrieve the lifecycle record of the component at a given position.
+  /** The record is used as a clock offset sample, given the local time at
+      which the component was found written. The input node times are
+      returned converted to the local clock. */
+  TimesliceLifecycle local_lifecycle(uint64_t pos, uint64_t written);
+
+  /// Post the RDMA READs of the component of a given pull request.
+  /** Pull requests are to be read in order. Only the last read of a
+      component is signaled. */
+  void post_reads(uint64_t pos);
+
+  /// Handle completion of the reads of the next pull request.
+  /** Stores the component descriptor and advances the write pointers. */
+  void on_complete_read();
+
+  /// Record the post-to-completion latencies of the work requests.
+  /** The latencies (in us) of status message sends and, in pull mode, of
+      the reads of each component are recorded to the given histograms. */
+  void set_latency_metrics(cbm::MetricHistogram send_latency,
+                           cbm::MetricHistogram read_latency);
+
+  /// Retrieve the number of outstanding send and read requests.
+  [[nodiscard]] uint32_t outstanding_requests() const {
+    return pending_send_requests_ + pending_reads_;
+  }
+
+  /// Publish the buffer positions for sampling to the given source.
+  void set_buffer_status(std::shared_ptr<BufferStatusSource> buffer_status) {
+    buffer_status_ = std::move(buffer_status);
+    publish_buffer_status();
+  }
+
+  /// Stop the input node from writing at and beyond a given position.
+  void set_barrier(uint64_t pos) { send_status_message_.resize.barrier = pos; }
+
+  /// Switch to new data and descriptor buffers and announce them to the
+  /// input node with the next status message.
+  /** The previous buffers must have been drained up to the barrier (see
+      set_barrier()), which is lifted. */
+  void remap(struct ibv_pd* pd,
+             uint8_t* data_ptr,
+             uint32_t data_buffer_size_exp,
+             fles::TimesliceComponentDescriptor* desc_ptr,
+             uint32_t desc_buffer_size_exp);
+
   void setup(struct ibv_pd* pd) override;
 
   /// Connection handler function, called on successful connection.
@@ -50,10 +145,20 @@ public:
 
   void on_disconnected(struct rdma_cm_event* event) override;
 
+  /// Acknowledge the timeslices up to a given position. Timeslices that have
+  /// not been written by the input node yet (missing from a partial
+  /// timeslice) are acknowledged once they arrive.
   void inc_ack_pointers(uint64_t ack_pos);
 
+  /// Announce placement credit and optionally a proposed timeslice size
+  /// for an epoch with the next status message.
+  void announce_credit(uint64_t epoch, uint32_t credit, uint32_t size = 0);
+
   void on_complete_recv();
 
+  /// Handle a status message received through a shared receive queue.
+  void on_complete_recv(const InputChannelStatusMessage& message);
+
   void on_complete_send();
 
   void on_complete_send_finalize();
@@ -117,9 +222,32 @@ public:
   }
 
 private:
+  /// Register the data and descriptor buffers and the pull request and
+  /// lifecycle record buffers (if any).
+  void register_buffers(struct ibv_pd* pd);
+
+  /// Deregister the buffers registered by register_buffers().
+  void deregister_buffers();
+
+  /// Fill in the access information of the registered buffers.
+  void buffer_info(ComputeNodeInfo& info) const;
+
+  // received data is used until acknowledged, nothing is being sent
+  void publish_buffer_status() {
+    if (buffer_status_) {
+      buffer_status_->desc.publish(send_status_message_.ack.desc, cn_ack_.desc,
+                                   cn_ack_.desc, cn_wp_.desc);
+      buffer_status_->data.publish(send_status_message_.ack.data, cn_ack_.data,
+                                   cn_ack_.data, cn_wp_.data);
+    }
+  }
+
   ComputeNodeStatusMessage send_status_message_ = ComputeNodeStatusMessage();
   ComputeNodeBufferPosition cn_ack_ = ComputeNodeBufferPosition();
 
+  /// Local version of announced placement credits
+  ComputeNodeCredit cn_credit_ = ComputeNodeCredit();
+
   InputChannelStatusMessage recv_status_message_ = InputChannelStatusMessage();
   ComputeNodeBufferPosition cn_wp_ = ComputeNodeBufferPosition();
 
@@ -128,15 +256,43 @@ private:
   struct ibv_mr* mr_send_ = nullptr;
   struct ibv_mr* mr_recv_ = nullptr;
 
+  /// The accounting of the registered host memory.
+  MemoryAccount registered_account_;
+
+  /// Pull requests written by the input node (pull mode, else empty).
+  std::vector<PullRequest> pull_requests_;
+
+  /// Infiniband memory region descriptor for the pull requests.
+  struct ibv_mr* mr_pull_ = nullptr;
+
+  /// Lifecycle records written by the input node (if enabled, else empty).
+  std::vector<TimesliceLifecycle> lifecycle_;
+
+  /// Infiniband memory region descriptor for the lifecycle records.
+  struct ibv_mr* mr_lifecycle_ = nullptr;
+
+  /// Estimated offset of the input node clock (in ns).
+  ClockOffset clock_offset_{INT64_C(10000000000)};
+
+  /// Buffer positions announced by pull requests.
+  ComputeNodeBufferPosition pull_wp_ = ComputeNodeBufferPosition();
+
   /// Information on remote end.
-  InputNodeInfo remote_info_{0};
+  InputNodeInfo remote_info_{0, 0, 0, 0};
 
   uint8_t* data_ptr_ = nullptr;
   std::size_t data_buffer_size_exp_ = 0;
 
+  /// The dma-buf containing the data buffer (-1: regular registration).
+  int data_dmabuf_fd_ = -1;
+  uint64_t data_dmabuf_offset_ = 0;
+
   fles::TimesliceComponentDescriptor* desc_ptr_ = nullptr;
   std::size_t desc_buffer_size_exp_ = 0;
 
+  /// Registration options of the data and descriptor buffers.
+  MemoryRegistration registration_;
+
   /// InfiniBand receive work request
   ibv_recv_wr recv_wr = ibv_recv_wr();
 
@@ -150,4 +306,21 @@ private:
   ibv_sge send_sge = ibv_sge();
 
   uint32_t pending_send_requests_{0};
+
+  /// Number of pull requests being read.
+  uint32_t pending_reads_{0};
+
+  /// Latency of status message sends (if set).
+  cbm::MetricHistogram send_latency_;
+
+  /// Latency of the reads of a component (if set).
+  cbm::MetricHistogram read_latency_;
+
+  /// Post times of the outstanding sends and reads (if latencies are
+  /// recorded). Both complete in order.
+  std::deque<std::chrono::steady_clock::time_point> send_posted_;
+  std::deque<std::chrono::steady_clock::time_point> read_posted_;
+
+  /// Buffer positions published for sampling (if set).
+  std::shared_ptr<BufferStatusSource> buffer_status_;
 };
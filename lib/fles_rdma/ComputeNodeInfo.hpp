@@ -14,6 +14,8 @@ struct BufferInfo {
 struct ComputeNodeInfo {
   BufferInfo data;
   BufferInfo desc;
+  BufferInfo pull; ///< Pull request buffer (addr 0: push mode)
+  BufferInfo lifecycle; ///< Lifecycle record buffer (addr 0: not tracked)
   uint32_t index;
   uint32_t data_buffer_size_exp;
   uint32_t desc_buffer_size_exp;
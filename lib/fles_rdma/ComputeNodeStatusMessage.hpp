@@ -2,13 +2,39 @@
 #pragma once
 
 #include "ComputeNodeBufferPosition.hpp"
+#include "ComputeNodeInfo.hpp"
 
 #pragma pack(1)
 
+/// Placement credits announced by a compute node (see TimeslicePlacement).
+/** Credits for an epoch are announced two epochs in advance, so an input
+    channel can lag behind by at most one announcement. */
+struct ComputeNodeCredit {
+  uint64_t epoch;    ///< Latest epoch with announced credit (0: none yet)
+  uint32_t value[2]; ///< Credit for epoch and for epoch - 1 (0: none)
+  uint32_t size[2];  ///< Proposed timeslice size for the same (0: none)
+};
+
+/// Switch of a running timeslice buffer to new regions (see
+/// TimesliceBuilder::request_resize()).
+/** The input channel stops writing at the barrier position. Once all
+    timeslices before it have been completed, the compute node replaces the
+    regions and announces them with a new generation. Their positions
+    continue where the previous regions ended. */
+struct ComputeNodeResize {
+  uint64_t barrier;     ///< Position not to be written (0: none)
+  uint32_t generation;  ///< Number of switches so far (0: none yet)
+  ComputeNodeInfo info; ///< The regions of the latest generation
+};
+
 /// Structure representing a status update message sent from compute buffer to
 /// input channel.
 struct ComputeNodeStatusMessage {
   ComputeNodeBufferPosition ack;
+  ComputeNodeBufferPosition read; ///< Positions read (pull mode)
+  ComputeNodeCredit credit;
+  uint64_t time; ///< Send time for lifecycle tracking (in ns, 0: none)
+  ComputeNodeResize resize;
   bool request_abort;
   bool final;
 };
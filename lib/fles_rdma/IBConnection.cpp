@@ -43,20 +43,15 @@ IBConnection::~IBConnection() {
 
 void IBConnection::connect(const std::string& hostname,
                            const std::string& service) {
-  struct addrinfo hints {};
-  hints.ai_family = AF_UNSPEC;
-  hints.ai_socktype = SOCK_STREAM;
-  struct addrinfo* res;
-
-  int err = getaddrinfo(hostname.c_str(), service.c_str(), &hints, &res);
-  if (err != 0) {
-    throw InfinibandException("getaddrinfo failed");
-  }
+  connect(resolve(hostname, service).get());
+}
 
+void IBConnection::connect(const struct addrinfo* address) {
   L_(debug) << "[" << index_ << "] "
             << "resolution of server address and route";
 
-  for (struct addrinfo* t = res; t != nullptr; t = t->ai_next) {
+  int err = -1;
+  for (const struct addrinfo* t = address; t != nullptr; t = t->ai_next) {
     err = rdma_resolve_addr(cm_id_, nullptr, t->ai_addr, RESOLVE_TIMEOUT_MS);
     if (err == 0) {
       break;
@@ -66,8 +61,20 @@ void IBConnection::connect(const std::string& hostname,
     L_(fatal) << "rdma_resolve_addr failed: " << strerror(errno);
     throw InfinibandException("rdma_resolve_addr failed");
   }
+}
+
+std::shared_ptr<struct addrinfo>
+IBConnection::resolve(const std::string& hostname, const std::string& service) {
+  struct addrinfo hints {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* res;
 
-  freeaddrinfo(res);
+  int err = getaddrinfo(hostname.c_str(), service.c_str(), &hints, &res);
+  if (err != 0) {
+    throw InfinibandException("getaddrinfo failed");
+  }
+  return {res, freeaddrinfo};
 }
 
 void IBConnection::disconnect() {
@@ -89,6 +96,7 @@ void IBConnection::on_rejected(struct rdma_cm_event* /* event */) {
 void IBConnection::on_established(struct rdma_cm_event* /* event */) {
   L_(debug) << "[" << index_ << "] "
             << "connection established";
+  established_ = true;
 }
 
 void IBConnection::on_disconnected(struct rdma_cm_event* /* event */) {
@@ -106,17 +114,19 @@ void IBConnection::on_timewait_exit(struct rdma_cm_event* /* event */) {
 void IBConnection::on_addr_resolved(struct ibv_pd* pd, struct ibv_cq* cq) {
   L_(debug) << "address resolved";
 
-  struct ibv_qp_init_attr qp_attr {};
-  qp_attr.cap = qp_cap_;
-  qp_attr.send_cq = cq;
-  qp_attr.recv_cq = cq;
-  qp_attr.qp_type = IBV_QPT_RC;
-  int err = rdma_create_qp(cm_id_, pd, &qp_attr);
-  if (err != 0) {
-    throw InfinibandException("creation of QP failed");
+  create_qp(pd, cq);
+
+  // the route (path record) determines the service level of both directions
+  if (type_of_service_) {
+    uint8_t tos = *type_of_service_;
+    if (rdma_set_option(cm_id_, RDMA_OPTION_ID, RDMA_OPTION_ID_TOS, &tos,
+                        sizeof tos) != 0) {
+      L_(warning) << "[" << index_ << "] "
+                  << "setting type of service failed: " << strerror(errno);
+    }
   }
 
-  err = rdma_resolve_route(cm_id_, RESOLVE_TIMEOUT_MS);
+  int err = rdma_resolve_route(cm_id_, RESOLVE_TIMEOUT_MS);
   if (err != 0) {
     throw InfinibandException("rdma_resolve_route failed");
   }
@@ -129,11 +139,14 @@ void IBConnection::create_qp(struct ibv_pd* pd, struct ibv_cq* cq) {
   qp_attr.cap = qp_cap_;
   qp_attr.send_cq = cq;
   qp_attr.recv_cq = cq;
+  qp_attr.srq = srq_;
   qp_attr.qp_type = IBV_QPT_RC;
   int err = rdma_create_qp(cm_id_, pd, &qp_attr);
   if (err != 0) {
     throw InfinibandException("creation of QP failed");
   }
+  // the device may grant more than requested
+  max_inline_data_ = qp_attr.cap.max_inline_data;
 }
 
 void IBConnection::accept_connect_request() {
@@ -144,7 +157,8 @@ void IBConnection::accept_connect_request() {
   assert(private_data->size() <= 255);
 
   struct rdma_conn_param conn_param = rdma_conn_param();
-  conn_param.responder_resources = 1;
+  conn_param.responder_resources = connector_read_depth_;
+  conn_param.initiator_depth = read_depth_;
   conn_param.private_data = private_data->data();
   conn_param.private_data_len = static_cast<uint8_t>(private_data->size());
   int err = rdma_accept(cm_id_, &conn_param);
@@ -176,7 +190,8 @@ void IBConnection::on_route_resolved() {
   assert(private_data->size() <= 255);
 
   struct rdma_conn_param conn_param = rdma_conn_param();
-  conn_param.initiator_depth = 1;
+  conn_param.initiator_depth = connector_read_depth_;
+  conn_param.responder_resources = read_depth_;
   conn_param.retry_count = 7;
   conn_param.private_data = private_data->data();
   conn_param.private_data_len = static_cast<uint8_t>(private_data->size());
@@ -3,7 +3,10 @@
 
 #include "InfinibandException.hpp"
 #include <memory>
+#include <netdb.h>
+#include <optional>
 #include <rdma/rdma_cma.h>
+#include <string>
 #include <vector>
 
 /// InfiniBand connection base class.
@@ -27,6 +30,11 @@ public:
   /// Retrieve the InfiniBand queue pair associated with the connection.
   [[nodiscard]] struct ibv_qp* qp() const { return cm_id_->qp; }
 
+  /// Set the type of service of the connection (the IP ToS, which is mapped
+  /// to a traffic class or service level). Must be called before
+  /// connecting.
+  void set_type_of_service(uint8_t tos) { type_of_service_ = tos; }
+
   /// Initiate a connection request to target hostname and service.
   /**
      \param hostname The target hostname
@@ -34,6 +42,16 @@ public:
   */
   void connect(const std::string& hostname, const std::string& service);
 
+  /// Initiate a connection request to a previously resolved target address.
+  /**
+     \param address The target address list (see resolve())
+  */
+  void connect(const struct addrinfo* address);
+
+  /// Resolve target hostname and service to an address list.
+  static std::shared_ptr<struct addrinfo> resolve(const std::string& hostname,
+                                                  const std::string& service);
+
   void disconnect();
 
   virtual void on_rejected(struct rdma_cm_event* event);
@@ -56,6 +74,9 @@ public:
 
   virtual void create_qp(struct ibv_pd* pd, struct ibv_cq* cq);
 
+  /// Use a shared receive queue for the queue pair (before its creation).
+  void set_shared_receive_queue(struct ibv_srq* srq) { srq_ = srq; }
+
   virtual void accept_connect_request();
 
   /// Handle RDMA_CM_EVENT_CONNECT_REQUEST event for this connection.
@@ -78,6 +99,9 @@ public:
 
   [[nodiscard]] bool done() const { return done_; }
 
+  /// Check whether the connection has been established.
+  [[nodiscard]] bool established() const { return established_; }
+
   /// Retrieve the total number of bytes transmitted.
   [[nodiscard]] uint64_t total_bytes_sent() const { return total_bytes_sent_; }
 
@@ -100,6 +124,12 @@ protected:
   /// Post an InfiniBand RECV work request (WR) to the receive queue.
   void post_recv(struct ibv_recv_wr* wr);
 
+  /// Retrieve the send flag for a message of given size, IBV_SEND_INLINE
+  /// if it fits the inline data capacity of the queue pair.
+  [[nodiscard]] unsigned int inline_flag(size_t size) const {
+    return size <= max_inline_data_ ? IBV_SEND_INLINE : 0;
+  }
+
   /// Index of this connection in the local group of connections.
   uint_fast16_t index_;
 
@@ -109,9 +139,29 @@ protected:
   /// Flag indicating connection finished state.
   bool done_ = false;
 
+  /// Flag indicating connection established state.
+  bool established_ = false;
+
   /// The queue pair capabilities.
   struct ibv_qp_cap qp_cap_ {};
 
+  /// The inline data capacity granted on creation of the queue pair.
+  uint32_t max_inline_data_ = 0;
+
+  /// The shared receive queue (if any) used by the queue pair.
+  struct ibv_srq* srq_ = nullptr;
+
+  /// Number of RDMA READs that may be outstanding on the connection, issued
+  /// by the accepting end and served by the connecting end (0: none).
+  uint8_t read_depth_ = 0;
+
+  /// Number of RDMA READs that may be outstanding on the connection, issued
+  /// by the connecting end and served by the accepting end.
+  uint8_t connector_read_depth_ = 1;
+
+  /// Upper limit of read_depth_ (a typical device maximum).
+  static constexpr uint32_t max_read_depth = 16;
+
 private:
   /// Low-level communication parameters.
   enum {
@@ -121,6 +171,9 @@ private:
   /// RDMA connection manager ID.
   struct rdma_cm_id* cm_id_ = nullptr;
 
+  /// The type of service requested for the connection (if any).
+  std::optional<uint8_t> type_of_service_;
+
   /// Total number of bytes transmitted.
   uint64_t total_bytes_sent_ = 0;
 
@@ -1,19 +1,26 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "CompletionWait.hpp"
 #include "ConnectionGroupWorker.hpp"
+#include "IBConnection.hpp"
 #include "InfinibandException.hpp"
+#include "StatusServer.hpp"
 #include <array>
 #include <chrono>
 #include <cstring>
 #include <fcntl.h>
+#include <memory>
+#include <poll.h>
 #include <rdma/rdma_cma.h>
 #include <sstream>
 #include <vector>
 
 /// InfiniBand connection group base class.
 /** An IBConnectionGroup object represents a group of InfiniBand
-    connections that use the same completion queue. */
+    connections that use the same completion queue. Besides the
+    connections of type CONNECTION, the group may handle auxiliary
+    connections of other IBConnection types. */
 
 template <typename CONNECTION>
 class IBConnectionGroup : public ConnectionGroupWorker {
@@ -52,6 +59,14 @@ public:
       cq_ = nullptr;
     }
 
+    if (comp_channel_) {
+      int err = ibv_destroy_comp_channel(comp_channel_);
+      if (err != 0) {
+        L_(error) << "ibv_destroy_comp_channel() failed";
+      }
+      comp_channel_ = nullptr;
+    }
+
     if (pd_) {
       int err = ibv_dealloc_pd(pd_);
       if (err != 0) {
@@ -144,7 +159,7 @@ public:
 
   /// The InfiniBand completion notification handler.
   int poll_completion() {
-    constexpr int ne_max = 10;
+    constexpr int ne_max = 64;
 
     std::array<ibv_wc, ne_max> wc{};
     int ne;
@@ -156,6 +171,8 @@ public:
       }
 
       ne_total += ne;
+      // pass on the successful completions as a batch
+      size_t count = 0;
       for (int i = 0; i < ne; ++i) {
         if (wc[i].status != IBV_WC_SUCCESS) {
           std::ostringstream s;
@@ -165,14 +182,52 @@ public:
 
           continue;
         }
-
-        on_completion(wc[i]);
+        wc[count++] = wc[i];
+      }
+      if (count != 0) {
+        on_completions(wc.data(), count);
       }
     }
 
     return ne_total;
   }
 
+  /// Allow the event loop to block on the completion channel when idle.
+  /** To be called before the connections are set up (see CompletionWait). */
+  void set_completion_wait(CompletionWait::Config config) {
+    completion_wait_.configure(config);
+  }
+
+  /// Account an iteration of the event loop and block if idle.
+  /** Blocks until a completion arrives, or for at most the maximum wait
+      time, once the event loop has done no work for the spin time. Must not
+      be called by workers sharing a thread (see WorkerGroup). */
+  void idle_wait(bool active) {
+    if (cq_ == nullptr || !completion_wait_.idle(active)) {
+      return;
+    }
+    // arm the notification, then check again for a completion in between
+    if (ibv_req_notify_cq(cq_, 0) != 0) {
+      throw InfinibandException("ibv_req_notify_cq failed");
+    }
+    if (poll_completion() > 0) {
+      completion_wait_.idle(true);
+      return;
+    }
+    pollfd fd{comp_channel_->fd, POLLIN, 0};
+    if (completion_wait_.wait(&fd, 1)) {
+      struct ibv_cq* ev_cq = nullptr;
+      void* ev_ctx = nullptr;
+      unsigned int events = 0;
+      while (ibv_get_cq_event(comp_channel_, &ev_cq, &ev_ctx) == 0) {
+        ++events;
+      }
+      if (events != 0) {
+        ibv_ack_cq_events(cq_, events);
+      }
+    }
+  }
+
   /// Retrieve the InfiniBand protection domain.
   [[nodiscard]] struct ibv_pd* protection_domain() const { return pd_; }
 
@@ -205,6 +260,13 @@ public:
     double rate = static_cast<double>(aggregate_bytes_sent_) / runtime;
     L_(info) << "summary: " << human_readable_count(aggregate_bytes_sent_)
              << " sent in " << runtime / 1000000. << " s (" << rate << " MB/s)";
+    if (completion_wait_.enabled()) {
+      CompletionWait::Stats wait = completion_wait_.total_stats();
+      L_(info) << "summary: blocked "
+               << std::chrono::duration<double>(wait.blocked).count()
+               << " s in " << wait.waits << " waits (" << wait.wakeups
+               << " woken by events)";
+    }
   }
 
 protected:
@@ -214,14 +276,14 @@ protected:
       init_context(id->verbs);
     }
 
-    auto* conn = static_cast<CONNECTION*>(id->context);
+    auto* conn = static_cast<IBConnection*>(id->context);
 
     conn->on_addr_resolved(pd_, cq_);
   }
 
   /// Handle RDMA_CM_EVENT_ROUTE_RESOLVED event.
   virtual void on_route_resolved(struct rdma_cm_id* id) {
-    auto* conn = static_cast<CONNECTION*>(id->context);
+    auto* conn = static_cast<IBConnection*>(id->context);
 
     conn->on_route_resolved();
   }
@@ -231,10 +293,11 @@ protected:
 
   /// Handle RDMA_CM_EVENT_ESTABLISHED event.
   virtual void on_established(struct rdma_cm_event* event) {
-    auto* conn = static_cast<CONNECTION*>(event->id->context);
+    auto* conn = static_cast<IBConnection*>(event->id->context);
 
     conn->on_established(event);
     ++connected_;
+    publish_connections();
   }
 
   /// Handle RDMA_CM_EVENT_CONNECT_REQUEST event.
@@ -242,7 +305,7 @@ protected:
 
   /// Handle RDMA_CM_EVENT_DISCONNECTED event.
   virtual void on_disconnected(struct rdma_cm_event* event) {
-    auto* conn = static_cast<CONNECTION*>(event->id->context);
+    auto* conn = static_cast<IBConnection*>(event->id->context);
 
     aggregate_bytes_sent_ += conn->total_bytes_sent();
     aggregate_send_requests_ += conn->total_send_requests();
@@ -251,14 +314,25 @@ protected:
     conn->on_disconnected(event);
     --connected_;
     ++timewait_;
+    publish_connections();
   }
 
   /// Handle RDMA_CM_EVENT_TIMEWAIT_EXIT event.
   virtual void on_timewait_exit(struct rdma_cm_event* event) {
-    auto* conn = static_cast<CONNECTION*>(event->id->context);
+    auto* conn = static_cast<IBConnection*>(event->id->context);
 
     conn->on_timewait_exit(event);
     --timewait_;
+    publish_connections();
+  }
+
+  /// Publish the numbers of connections (if a status is published).
+  void publish_connections() {
+    if (connection_status_) {
+      connection_status_->connected.store(connected_,
+                                          std::memory_order_relaxed);
+      connection_status_->timewait.store(timewait_, std::memory_order_relaxed);
+    }
   }
 
   /// Initialize the InfiniBand verbs context.
@@ -272,7 +346,15 @@ protected:
       throw InfinibandException("ibv_alloc_pd failed");
     }
 
-    cq_ = ibv_create_cq(context, num_cqe_, nullptr, nullptr, 0);
+    if (completion_wait_.enabled()) {
+      comp_channel_ = ibv_create_comp_channel(context);
+      if (comp_channel_ == nullptr) {
+        throw InfinibandException("ibv_create_comp_channel failed");
+      }
+      fcntl(comp_channel_->fd, F_SETFL, O_NONBLOCK);
+    }
+
+    cq_ = ibv_create_cq(context, num_cqe_, nullptr, comp_channel_, 0);
     if (cq_ == nullptr) {
       throw InfinibandException("ibv_create_cq failed");
     }
@@ -290,6 +372,12 @@ protected:
   /// InfiniBand completion queue
   struct ibv_cq* cq_ = nullptr;
 
+  /// Completion channel to block on when idle (if enabled).
+  struct ibv_comp_channel* comp_channel_ = nullptr;
+
+  /// Decision whether the event loop blocks.
+  CompletionWait completion_wait_;
+
   /// Vector of associated connection objects.
   std::vector<std::unique_ptr<CONNECTION>> conn_;
 
@@ -299,6 +387,9 @@ protected:
   /// Number of connections in the timewait state.
   unsigned int timewait_ = 0;
 
+  /// Connection state published to the status server (if it exists).
+  std::shared_ptr<ConnectionStatus> connection_status_;
+
   /// Number of connections in the done state.
   unsigned int connections_done_ = 0;
 
@@ -360,6 +451,16 @@ private:
   /// Completion notification event dispatcher. Called by the event loop.
   virtual void on_completion(const struct ibv_wc& wc) = 0;
 
+  /// Batch completion dispatcher, called with the successful completions
+  /// retrieved at once. Handlers may override it to apply the resulting
+  /// state changes once per batch. By default, the completions are passed
+  /// on to on_completion() one by one.
+  virtual void on_completions(const struct ibv_wc* wc, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      on_completion(wc[i]);
+    }
+  }
+
   /// InfiniBand verbs context
   struct ibv_context* context_ = nullptr;
 
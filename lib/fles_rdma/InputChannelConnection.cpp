@@ -1,14 +1,70 @@
 // Copyright 2012-2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "InputChannelConnection.hpp"
+#include "AckCoalescing.hpp"
 #include "InputNodeInfo.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "RequestIdentifier.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include "Utility.hpp"
 #include "log.hpp"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstring>
+#include <string>
+
+namespace {
+/// Retrieve the nominal data rate of a local port (in bytes per second).
+double port_rate(struct ibv_context* context, uint8_t port) {
+  struct ibv_port_attr attr {};
+  if (ibv_query_port(context, port, &attr) != 0) {
+    throw InfinibandException("ibv_query_port failed");
+  }
+  unsigned int lanes = 1;
+  switch (attr.active_width) {
+  case 2:
+    lanes = 4;
+    break;
+  case 4:
+    lanes = 8;
+    break;
+  case 8:
+    lanes = 12;
+    break;
+  case 16:
+    lanes = 2;
+    break;
+  default:
+    break;
+  }
+  double lane_gbps = 2.5;
+  switch (attr.active_speed) {
+  case 2:
+    lane_gbps = 5.0;
+    break;
+  case 4:
+  case 8:
+    lane_gbps = 10.0;
+    break;
+  case 16:
+    lane_gbps = 14.0;
+    break;
+  case 32:
+    lane_gbps = 25.0;
+    break;
+  case 64:
+    lane_gbps = 50.0;
+    break;
+  case 128:
+    lane_gbps = 100.0;
+    break;
+  default:
+    break;
+  }
+  return lanes * lane_gbps * 1e9 / 8;
+}
+} // namespace
 
 InputChannelConnection::InputChannelConnection(
     struct rdma_event_channel* ec,
@@ -16,10 +72,18 @@ InputChannelConnection::InputChannelConnection(
     uint_fast16_t remote_connection_index,
     unsigned int max_send_wr,
     unsigned int max_pending_write_requests,
+    unsigned int signal_interval,
+    unsigned int post_batch,
+    std::chrono::microseconds status_interval,
     struct rdma_cm_id* id)
     : IBConnection(ec, connection_index, remote_connection_index, id),
-      max_pending_write_requests_(max_pending_write_requests) {
+      status_interval_(status_interval),
+      max_pending_write_requests_(max_pending_write_requests),
+      write_window_(max_pending_write_requests),
+      signal_interval_(signal_interval), post_batch_(post_batch) {
   assert(max_pending_write_requests_ > 0);
+  assert(signal_interval_ > 0);
+  assert(post_batch_ > 0);
 
   qp_cap_.max_send_wr = max_send_wr; // typical hca maximum: 16k
   qp_cap_.max_send_sge = 4; // max. two chunks each for descriptors and data
@@ -28,7 +92,11 @@ InputChannelConnection::InputChannelConnection(
       1; // receive only single ComputeNodeStatusMessage struct
   qp_cap_.max_recv_sge = 1;
 
-  qp_cap_.max_inline_data = sizeof(fles::TimesliceComponentDescriptor);
+  // descriptors (and pull requests) are always written inline, status
+  // messages if they fit
+  qp_cap_.max_inline_data =
+      static_cast<uint32_t>(std::max(sizeof(fles::TimesliceComponentDescriptor),
+                                     sizeof(InputChannelStatusMessage)));
 }
 
 bool InputChannelConnection::check_for_buffer_space(uint64_t data_size,
@@ -55,7 +123,79 @@ bool InputChannelConnection::check_for_buffer_space(uint64_t data_size,
           desc_size) { // TODO: extend condition!
     return false;
   }
-  return true;
+  return barrier_ == 0 || cn_wp_.desc + desc_size <= barrier_;
+}
+
+namespace {
+// Split a scatter/gather list after a given number of bytes. The entries
+// beyond are moved to tail, the remaining number of entries is returned.
+int split_sge(ibv_sge* sge,
+              int num_sge,
+              uint64_t bytes,
+              ibv_sge* tail,
+              int& num_tail) {
+  num_tail = 0;
+  int num_sge_cut = 0;
+  for (int i = 0; i < num_sge; ++i) {
+    if (sge[i].length <= bytes) {
+      bytes -= sge[i].length;
+    } else {
+      if (bytes != 0u) {
+        tail[num_tail].addr = sge[i].addr + bytes;
+        tail[num_tail].length = sge[i].length - bytes;
+        tail[num_tail++].lkey = sge[i].lkey;
+        sge[i].length = bytes;
+        bytes = 0;
+      } else {
+        tail[num_tail++] = sge[i];
+        ++num_sge_cut;
+      }
+    }
+  }
+  return num_sge - num_sge_cut;
+}
+} // namespace
+
+ibv_send_wr* InputChannelConnection::prepare_data_writes(ibv_sge* sge,
+                                                         int num_sge,
+                                                         ibv_sge* sge2,
+                                                         uint64_t cn_wp_data,
+                                                         uint64_t length,
+                                                         ibv_send_wr* wr,
+                                                         ibv_send_wr* wr2) {
+  uint64_t cn_data_buffer_mask =
+      (UINT64_C(1) << remote_info_.data_buffer_size_exp) - 1;
+  uint64_t target_bytes_left =
+      (UINT64_C(1) << remote_info_.data_buffer_size_exp) -
+      (cn_wp_data & cn_data_buffer_mask);
+
+  // split sge list at end of target buffer
+  int num_sge2 = 0;
+  if (length > target_bytes_left) {
+    num_sge = split_sge(sge, num_sge, target_bytes_left, sge2, num_sge2);
+  }
+
+  *wr = ibv_send_wr();
+  wr->wr_id = ID_WRITE_DATA;
+  wr->opcode = IBV_WR_RDMA_WRITE;
+  wr->sg_list = sge;
+  wr->num_sge = num_sge;
+  wr->wr.rdma.rkey = remote_info_.data.rkey;
+  wr->wr.rdma.remote_addr = static_cast<uintptr_t>(
+      remote_info_.data.addr + (cn_wp_data & cn_data_buffer_mask));
+
+  if (num_sge2 == 0) {
+    return wr;
+  }
+  *wr2 = ibv_send_wr();
+  wr2->wr_id = ID_WRITE_DATA_WRAP;
+  wr2->opcode = IBV_WR_RDMA_WRITE;
+  wr2->sg_list = sge2;
+  wr2->num_sge = num_sge2;
+  wr2->wr.rdma.rkey = remote_info_.data.rkey;
+  wr2->wr.rdma.remote_addr = static_cast<uintptr_t>(remote_info_.data.addr);
+  wr->next = wr2;
+  return wr2;
 }
 
 void InputChannelConnection::send_data(struct ibv_sge* sge,
@@ -63,90 +203,104 @@ void InputChannelConnection::send_data(struct ibv_sge* sge,
                                        uint64_t timeslice,
                                        uint64_t desc_length,
                                        uint64_t data_length,
-                                       uint64_t skip) {
-  int num_sge2 = 0;
-  std::array<ibv_sge, 4> sge2{};
+                                       uint64_t skip,
+                                       const TimesliceLifecycle& lifecycle) {
+  queued_writes_.emplace_back();
+  QueuedWrite& w = queued_writes_.back();
+  std::copy(sge, sge + num_sge, w.sge.begin());
+  ibv_send_wr* desc_write = prepare_lifecycle_write(w, lifecycle);
 
   uint64_t cn_wp_data = cn_wp_.data;
   cn_wp_data += skip;
 
-  uint64_t cn_data_buffer_mask =
-      (UINT64_C(1) << remote_info_.data_buffer_size_exp) - 1;
-  uint64_t cn_desc_buffer_mask =
-      (UINT64_C(1) << remote_info_.desc_buffer_size_exp) - 1;
-  uint64_t target_bytes_left =
-      (UINT64_C(1) << remote_info_.data_buffer_size_exp) -
-      (cn_wp_data & cn_data_buffer_mask);
-
-  // split sge list if necessary
-  int num_sge_cut = 0;
-  if (data_length + desc_length * sizeof(fles::MicrosliceDescriptor) >
-      target_bytes_left) {
-    for (int i = 0; i < num_sge; ++i) {
-      if (sge[i].length <= target_bytes_left) {
-        target_bytes_left -= sge[i].length;
-      } else {
-        if (target_bytes_left != 0u) {
-          sge2[num_sge2].addr = sge[i].addr + target_bytes_left;
-          sge2[num_sge2].length = sge[i].length - target_bytes_left;
-          sge2[num_sge2++].lkey = sge[i].lkey;
-          sge[i].length = target_bytes_left;
-          target_bytes_left = 0;
-        } else {
-          sge2[num_sge2++] = sge[i];
-          ++num_sge_cut;
-        }
-      }
+  uint64_t size =
+      data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
+
+  // divide into parts for this and the stripe connections, the first part
+  // is written by this connection (unless it is a control connection)
+  assert(!control_only_ || !stripes_.empty());
+  const uint64_t num_parts = stripes_.size() + (control_only_ ? 0 : 1);
+  uint64_t part_size = size;
+  if (num_parts > 1) {
+    part_size = (size + num_parts - 1) / num_parts;
+    part_size = (part_size + stripe_alignment - 1) & ~(stripe_alignment - 1);
+  }
+  std::array<ibv_sge, 4> rest{};
+  int num_rest = 0;
+  uint64_t offset = 0;
+  if (control_only_) {
+    std::copy(w.sge.begin(), w.sge.begin() + num_sge, rest.begin());
+    num_rest = num_sge;
+    w.first = desc_write;
+  } else {
+    if (part_size < size) {
+      num_sge = split_sge(w.sge.data(), num_sge, part_size, rest.data(),
+                          num_rest);
     }
+    ibv_send_wr* last = prepare_data_writes(
+        w.sge.data(), num_sge, w.sge2.data(), cn_wp_data,
+        std::min(part_size, size), &w.wr_ts, &w.wr_tswrap);
+    last->next = desc_write;
+    w.first = &w.wr_ts;
+    offset = part_size;
   }
-  num_sge -= num_sge_cut;
-
-  struct ibv_send_wr send_wr_ts {};
-  struct ibv_send_wr send_wr_tswrap {};
-  struct ibv_send_wr send_wr_tscdesc {};
-  send_wr_ts.wr_id = ID_WRITE_DATA;
-  send_wr_ts.opcode = IBV_WR_RDMA_WRITE;
-  send_wr_ts.sg_list = sge;
-  send_wr_ts.num_sge = num_sge;
-  send_wr_ts.wr.rdma.rkey = remote_info_.data.rkey;
-  send_wr_ts.wr.rdma.remote_addr = static_cast<uintptr_t>(
-      remote_info_.data.addr + (cn_wp_data & cn_data_buffer_mask));
 
-  if (num_sge2 != 0) {
-    send_wr_tswrap.wr_id = ID_WRITE_DATA_WRAP;
-    send_wr_tswrap.opcode = IBV_WR_RDMA_WRITE;
-    send_wr_tswrap.sg_list = sge2.data();
-    send_wr_tswrap.num_sge = num_sge2;
-    send_wr_tswrap.wr.rdma.rkey = remote_info_.data.rkey;
-    send_wr_tswrap.wr.rdma.remote_addr =
-        static_cast<uintptr_t>(remote_info_.data.addr);
-    send_wr_ts.next = &send_wr_tswrap;
-    send_wr_tswrap.next = &send_wr_tscdesc;
-  } else {
-    send_wr_ts.next = &send_wr_tscdesc;
+  // remaining parts, each completion is reported separately
+  for (auto* stripe : stripes_) {
+    if (offset >= size) {
+      break;
+    }
+    uint64_t length = std::min(part_size, size - offset);
+    std::array<ibv_sge, 4> part = rest;
+    int num_part = num_rest;
+    num_part = split_sge(part.data(), num_part, length, rest.data(), num_rest);
+    std::array<ibv_sge, 4> part2{};
+    ibv_send_wr wr{};
+    ibv_send_wr wr2{};
+    ibv_send_wr* stripe_last =
+        prepare_data_writes(part.data(), num_part, part2.data(),
+                            cn_wp_data + offset, length, &wr, &wr2);
+    stripe_last->wr_id = ID_WRITE_STRIPE | (timeslice << 24) | (index_ << 8);
+    stripe_last->send_flags = IBV_SEND_SIGNALED;
+    stripe->post_writes(&wr);
+    ++w.pending_stripes;
+    offset += length;
   }
 
   // timeslice component descriptor
-  fles::TimesliceComponentDescriptor tscdesc{};
-  tscdesc.ts_num = timeslice;
-  tscdesc.offset = cn_wp_data;
-  tscdesc.size = data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
-  tscdesc.num_microslices = desc_length;
-  struct ibv_sge sge3 {};
-  sge3.addr = reinterpret_cast<uintptr_t>(&tscdesc);
-  sge3.length = sizeof(tscdesc);
-  sge3.lkey = 0;
-
-  send_wr_tscdesc.wr_id = ID_WRITE_DESC | (timeslice << 24) | (index_ << 8);
-  send_wr_tscdesc.opcode = IBV_WR_RDMA_WRITE;
-  send_wr_tscdesc.send_flags =
-      IBV_SEND_INLINE | IBV_SEND_FENCE | IBV_SEND_SIGNALED;
-  send_wr_tscdesc.sg_list = &sge3;
-  send_wr_tscdesc.num_sge = 1;
-  send_wr_tscdesc.wr.rdma.rkey = remote_info_.desc.rkey;
-  send_wr_tscdesc.wr.rdma.remote_addr = static_cast<uintptr_t>(
+  w.tscdesc = fles::TimesliceComponentDescriptor();
+  w.tscdesc.ts_num = timeslice;
+  w.tscdesc.offset = cn_wp_data;
+  w.tscdesc.size = size;
+  w.tscdesc.num_microslices = desc_length;
+  w.sge3 = ibv_sge();
+  w.sge3.addr = reinterpret_cast<uintptr_t>(&w.tscdesc);
+  w.sge3.length = sizeof(w.tscdesc);
+  w.sge3.lkey = 0;
+
+  // as the send queue is processed in order, a completion of a later
+  // work request implies completion of all unsignaled ones before it
+  bool signaled = ++unsignaled_writes_ >= signal_interval_;
+  if (signaled) {
+    unsignaled_writes_ = 0;
+  }
+
+  uint64_t cn_desc_buffer_mask =
+      (UINT64_C(1) << remote_info_.desc_buffer_size_exp) - 1;
+  w.wr_tscdesc = ibv_send_wr();
+  w.wr_tscdesc.wr_id = ID_WRITE_DESC | (timeslice << 24) | (index_ << 8);
+  w.wr_tscdesc.opcode = IBV_WR_RDMA_WRITE;
+  w.wr_tscdesc.send_flags = IBV_SEND_INLINE | IBV_SEND_FENCE;
+  if (signaled) {
+    w.wr_tscdesc.send_flags |= IBV_SEND_SIGNALED;
+  }
+  w.wr_tscdesc.sg_list = &w.sge3;
+  w.wr_tscdesc.num_sge = 1;
+  w.wr_tscdesc.wr.rdma.rkey = remote_info_.desc.rkey;
+  w.wr_tscdesc.wr.rdma.remote_addr = static_cast<uintptr_t>(
       remote_info_.desc.addr + (cn_wp_.desc & cn_desc_buffer_mask) *
                                    sizeof(fles::TimesliceComponentDescriptor));
+  w.wp = {cn_wp_data + size, cn_wp_.desc + 1};
 
   if (false) {
     L_(trace) << "[i" << remote_index_ << "] "
@@ -154,14 +308,302 @@ void InputChannelConnection::send_data(struct ibv_sge* sge,
               << "POST SEND data (timeslice " << timeslice << ")";
   }
 
-  // send everything
+  // queue everything
+  assert(pending_write_requests_ < max_pending_write_requests_);
+  ++pending_write_requests_;
+  outstanding_timeslices_.push_back(timeslice);
+  if (adaptive_window_ || pacing_) {
+    outstanding_posted_.push_back(std::chrono::steady_clock::now());
+  }
+  pace(desc_length, data_length);
+  if (queued_writes_.size() >= post_batch_) {
+    post_pending_writes();
+  }
+}
+
+void InputChannelConnection::send_pull_request(
+    const PullSegment* segment,
+    int num_segments,
+    uint64_t timeslice,
+    uint64_t desc_length,
+    uint64_t data_length,
+    uint64_t skip,
+    const TimesliceLifecycle& lifecycle) {
+  assert(pull_ && num_segments <= 4);
+  queued_writes_.emplace_back();
+  QueuedWrite& w = queued_writes_.back();
+  ibv_send_wr* desc_write = prepare_lifecycle_write(w, lifecycle);
+
+  uint64_t cn_wp_data = cn_wp_.data;
+  cn_wp_data += skip;
+
+  uint64_t size =
+      data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
+
+  w.tscdesc = fles::TimesliceComponentDescriptor();
+  w.tscdesc.ts_num = timeslice;
+  w.tscdesc.offset = cn_wp_data;
+  w.tscdesc.size = size;
+  w.tscdesc.num_microslices = desc_length;
+  w.pull = PullRequest();
+  w.pull.desc = w.tscdesc;
+  w.pull.num_segments = static_cast<uint32_t>(num_segments);
+  std::copy(segment, segment + num_segments, w.pull.segment);
+  w.sge3 = ibv_sge();
+  w.sge3.addr = reinterpret_cast<uintptr_t>(&w.pull);
+  w.sge3.length = sizeof(w.pull);
+  w.sge3.lkey = 0;
+
+  // completions only free send queue entries, as the compute node reports
+  // the components read with its status messages
+  bool signaled = ++unsignaled_writes_ >= signal_interval_;
+  if (signaled) {
+    unsignaled_writes_ = 0;
+  }
+
+  uint64_t cn_desc_buffer_mask =
+      (UINT64_C(1) << remote_info_.desc_buffer_size_exp) - 1;
+  w.wr_tscdesc = ibv_send_wr();
+  w.wr_tscdesc.wr_id = ID_WRITE_PULL | (index_ << 8);
+  w.wr_tscdesc.opcode = IBV_WR_RDMA_WRITE;
+  w.wr_tscdesc.send_flags = IBV_SEND_INLINE;
+  if (signaled) {
+    w.wr_tscdesc.send_flags |= IBV_SEND_SIGNALED;
+  }
+  w.wr_tscdesc.sg_list = &w.sge3;
+  w.wr_tscdesc.num_sge = 1;
+  w.wr_tscdesc.wr.rdma.rkey = remote_info_.pull.rkey;
+  w.wr_tscdesc.wr.rdma.remote_addr = static_cast<uintptr_t>(
+      remote_info_.pull.addr +
+      (cn_wp_.desc & cn_desc_buffer_mask) * sizeof(PullRequest));
+  w.first = desc_write;
+  w.wp = {cn_wp_data + size, cn_wp_.desc + 1};
+
+  if (false) {
+    L_(trace) << "[i" << remote_index_ << "] "
+              << "[" << index_ << "] "
+              << "POST SEND pull request (timeslice " << timeslice << ")";
+  }
+
   assert(pending_write_requests_ < max_pending_write_requests_);
   ++pending_write_requests_;
-  post_send(&send_wr_ts);
+  outstanding_timeslices_.push_back(timeslice);
+  if (adaptive_window_ || pacing_) {
+    outstanding_posted_.push_back(std::chrono::steady_clock::now());
+  }
+  pace(desc_length, data_length);
+  if (queued_writes_.size() >= post_batch_) {
+    post_pending_writes();
+  }
+}
+
+void InputChannelConnection::post_pending_writes() {
+  // the descriptor of a timeslice may only be written once all of its
+  // stripes are complete, and descriptors are written in order
+  auto ready = std::find_if(
+      queued_writes_.begin(), queued_writes_.end(),
+      [](const QueuedWrite& w) { return w.pending_stripes != 0; });
+  if (ready == queued_writes_.begin()) {
+    return;
+  }
+  // chain the queued work requests to a single list
+  for (auto it = queued_writes_.begin(); it + 1 != ready; ++it) {
+    it->wr_tscdesc.next = (it + 1)->first;
+  }
+  if (lifecycle_) {
+    uint64_t now = lifecycle_now();
+    for (auto it = queued_writes_.begin(); it != ready; ++it) {
+      it->lifecycle.posted = now;
+    }
+  }
+  (ready - 1)->wr_tscdesc.next = nullptr;
+  posted_wp_ = (ready - 1)->wp;
+  post_send(queued_writes_.front().first);
+  queued_writes_.erase(queued_writes_.begin(), ready);
+}
+
+void InputChannelConnection::request_write_completion() {
+  // in pull mode, write completions do not complete any timeslices
+  if (unsignaled_writes_ == 0 || pull_) {
+    post_pending_writes();
+    return;
+  }
+  // selective signaling is not used together with stripes
+  assert(stripes_.empty());
+  unsignaled_writes_ = 0;
+  if (!queued_writes_.empty()) {
+    // signal the last queued descriptor write instead
+    queued_writes_.back().wr_tscdesc.send_flags |= IBV_SEND_SIGNALED;
+    post_pending_writes();
+    return;
+  }
+  flush_wr_ = ibv_send_wr();
+  flush_wr_.wr_id = ID_WRITE_DESC | (outstanding_timeslices_.back() << 24) |
+                    (index_ << 8);
+  flush_wr_.opcode = IBV_WR_RDMA_WRITE;
+  flush_wr_.send_flags = IBV_SEND_SIGNALED;
+  flush_wr_.num_sge = 0;
+  flush_wr_.wr.rdma.rkey = remote_info_.desc.rkey;
+  flush_wr_.wr.rdma.remote_addr =
+      static_cast<uintptr_t>(remote_info_.desc.addr);
+  post_send(&flush_wr_);
+}
+
+void InputChannelConnection::set_pull(uint32_t max_reads) {
+  assert(max_reads > 0 && stripes_.empty());
+  pull_ = true;
+  read_depth_ = static_cast<uint8_t>(std::min(max_reads, max_read_depth));
+  qp_cap_.max_inline_data =
+      std::max(qp_cap_.max_inline_data,
+               static_cast<uint32_t>(sizeof(PullRequest)));
+}
+
+void InputChannelConnection::set_lifecycle() {
+  lifecycle_ = true;
+  qp_cap_.max_inline_data =
+      std::max(qp_cap_.max_inline_data,
+               static_cast<uint32_t>(sizeof(TimesliceLifecycle)));
+}
+
+ibv_send_wr* InputChannelConnection::prepare_lifecycle_write(
+    QueuedWrite& w, const TimesliceLifecycle& lifecycle) {
+  if (!lifecycle_ || remote_info_.lifecycle.addr == 0) {
+    return &w.wr_tscdesc;
+  }
+  w.lifecycle = lifecycle;
+  w.lifecycle.status_sent = status_sent_;
+  w.lifecycle.status_received = status_received_;
+  w.sge_lifecycle = ibv_sge();
+  w.sge_lifecycle.addr = reinterpret_cast<uintptr_t>(&w.lifecycle);
+  w.sge_lifecycle.length = sizeof(w.lifecycle);
+  w.sge_lifecycle.lkey = 0;
+
+  // written at the position of the descriptor, which follows in order
+  uint64_t cn_desc_buffer_mask =
+      (UINT64_C(1) << remote_info_.desc_buffer_size_exp) - 1;
+  w.wr_lifecycle = ibv_send_wr();
+  w.wr_lifecycle.wr_id = ID_WRITE_LIFECYCLE | (index_ << 8);
+  w.wr_lifecycle.opcode = IBV_WR_RDMA_WRITE;
+  w.wr_lifecycle.send_flags = IBV_SEND_INLINE;
+  w.wr_lifecycle.sg_list = &w.sge_lifecycle;
+  w.wr_lifecycle.num_sge = 1;
+  w.wr_lifecycle.wr.rdma.rkey = remote_info_.lifecycle.rkey;
+  w.wr_lifecycle.wr.rdma.remote_addr = static_cast<uintptr_t>(
+      remote_info_.lifecycle.addr +
+      (cn_wp_.desc & cn_desc_buffer_mask) * sizeof(TimesliceLifecycle));
+  w.wr_lifecycle.next = &w.wr_tscdesc;
+  return &w.wr_lifecycle;
+}
+
+void InputChannelConnection::set_stripes(
+    std::vector<StripeConnection*> stripes) {
+  assert(stripes.empty() || signal_interval_ == 1);
+  stripes_ = std::move(stripes);
+}
+
+void InputChannelConnection::set_control_only(uint8_t tos) {
+  assert(!pull_);
+  control_only_ = true;
+  set_type_of_service(tos);
+}
+
+void InputChannelConnection::on_complete_stripe(uint64_t timeslice) {
+  auto it = std::find_if(queued_writes_.begin(), queued_writes_.end(),
+                         [timeslice](const QueuedWrite& w) {
+                           return w.tscdesc.ts_num == timeslice;
+                         });
+  assert(it != queued_writes_.end() && it->pending_stripes > 0);
+  if (--it->pending_stripes == 0 && it == queued_writes_.begin()) {
+    post_pending_writes();
+  }
 }
 
 bool InputChannelConnection::write_request_available() {
-  return (pending_write_requests_ < max_pending_write_requests_);
+  if (pending_write_requests_ >= write_window_) {
+    return false;
+  }
+  return !pacer_ || pacer_->admits(std::chrono::steady_clock::now());
+}
+
+void InputChannelConnection::set_adaptive_window() {
+  adaptive_window_ = true;
+  write_window_ = std::min(max_pending_write_requests_, min_write_window);
+  min_latency_begin_ = std::chrono::steady_clock::now();
+}
+
+void InputChannelConnection::set_pacing(double rate, double burst) {
+  pacing_ = true;
+  pacing_max_rate_ = rate;
+  pacing_burst_ = burst;
+  min_latency_begin_ = std::chrono::steady_clock::now();
+}
+
+void InputChannelConnection::pace(uint64_t desc_length,
+                                  uint64_t data_length) {
+  if (pacer_) {
+    pacer_->consume(static_cast<double>(
+                        data_length +
+                        desc_length * sizeof(fles::MicrosliceDescriptor)),
+                    std::chrono::steady_clock::now());
+  }
+}
+
+void InputChannelConnection::update_write_window(
+    std::chrono::steady_clock::time_point posted) {
+  auto now = std::chrono::steady_clock::now();
+  double latency = std::chrono::duration<double>(now - posted).count();
+
+  // windowed minimum, as the base latency of the path may change
+  if (period_min_latency_ == 0.0 || latency < period_min_latency_) {
+    period_min_latency_ = latency;
+  }
+  if (min_latency_ == 0.0 || latency < min_latency_) {
+    min_latency_ = latency;
+  }
+  if (now - min_latency_begin_ > min_latency_period) {
+    min_latency_ = period_min_latency_;
+    period_min_latency_ = 0.0;
+    min_latency_begin_ = now;
+  }
+
+  // adapt once per round trip, i.e., per window of completions (or per
+  // outstanding timeslices with a fixed window)
+  unsigned int round =
+      adaptive_window_
+          ? write_window_
+          : std::max(static_cast<unsigned int>(outstanding_posted_.size()),
+                     1U);
+  round_latency_sum_ += latency;
+  if (++round_samples_ < round) {
+    return;
+  }
+  double mean_latency = round_latency_sum_ / round_samples_;
+  round_latency_sum_ = 0.0;
+  round_samples_ = 0;
+
+  // the part of the window exceeding the bandwidth-delay product is
+  // queued, in proportion to the additional latency (Little's law)
+  double queued = round * (1.0 - min_latency_ / mean_latency);
+  if (pacer_) {
+    if (queued > window_shrink_queued) {
+      pacer_->congestion(now);
+    } else if (queued < window_grow_queued) {
+      pacer_->no_congestion(now);
+    }
+  }
+  if (!adaptive_window_) {
+    return;
+  }
+  if (queued < window_grow_queued) {
+    write_window_ = window_slow_start_ ? write_window_ * 2 : write_window_ + 1;
+  } else if (queued > window_shrink_queued) {
+    window_slow_start_ = false;
+    --write_window_;
+  }
+  write_window_ = std::clamp(write_window_,
+                             std::min(min_write_window,
+                                      max_pending_write_requests_),
+                             max_pending_write_requests_);
 }
 
 void InputChannelConnection::inc_write_pointers(uint64_t data_size,
@@ -171,13 +613,34 @@ void InputChannelConnection::inc_write_pointers(uint64_t data_size,
 }
 
 bool InputChannelConnection::try_sync_buffer_positions() {
-  if (our_turn_) {
-    our_turn_ = false;
-    send_status_message_.wp = cn_wp_;
-    post_send_status_message();
-    return true;
+  // the status message must not overtake the announced data
+  post_pending_writes();
+  if (!our_turn_) {
+    return false;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (status_interval_.count() > 0) {
+    auto interval = std::chrono::microseconds(AckCoalescing::threshold(
+        static_cast<uint64_t>(status_interval_.count()), target_fill()));
+    if (now - last_status_time_ < interval) {
+      return false;
+    }
   }
-  return false;
+  our_turn_ = false;
+  last_status_time_ = now;
+  send_status_message_.wp = posted_wp_;
+  post_send_status_message();
+  return true;
+}
+
+double InputChannelConnection::target_fill() const {
+  double fill_data =
+      static_cast<double>(cn_wp_.data - cn_ack_.data) /
+      static_cast<double>(UINT64_C(1) << remote_info_.data_buffer_size_exp);
+  double fill_desc =
+      static_cast<double>(cn_wp_.desc - cn_ack_.desc) /
+      static_cast<double>(UINT64_C(1) << remote_info_.desc_buffer_size_exp);
+  return std::max(fill_data, fill_desc);
 }
 
 uint64_t InputChannelConnection::skip_required(uint64_t data_size) {
@@ -192,21 +655,38 @@ uint64_t InputChannelConnection::skip_required(uint64_t data_size) {
 void InputChannelConnection::finalize(bool abort) {
   finalize_ = true;
   abort_ = abort;
+  post_pending_writes();
   if (our_turn_) {
     our_turn_ = false;
     if (cn_wp_ == cn_ack_ || abort_) {
       send_status_message_.final = true;
       send_status_message_.abort = abort_;
     } else {
-      send_status_message_.wp = cn_wp_;
+      send_status_message_.wp = posted_wp_;
     }
     post_send_status_message();
   }
 }
 
-void InputChannelConnection::on_complete_write() { pending_write_requests_--; }
+void InputChannelConnection::on_complete_write(
+    uint64_t timeslice, std::vector<uint64_t>& completed) {
+  while (!outstanding_timeslices_.empty() &&
+         outstanding_timeslices_.front() <= timeslice) {
+    completed.push_back(outstanding_timeslices_.front());
+    outstanding_timeslices_.pop_front();
+    pending_write_requests_--;
+    if (adaptive_window_ || pacing_) {
+      // only the signaled write reports its own latency
+      if (completed.back() == timeslice) {
+        update_write_window(outstanding_posted_.front());
+      }
+      outstanding_posted_.pop_front();
+    }
+  }
+}
 
 void InputChannelConnection::on_complete_recv() {
+  ++status_messages_received_;
   if (recv_status_message_.final) {
     done_ = true;
     return;
@@ -217,7 +697,26 @@ void InputChannelConnection::on_complete_recv() {
               << "receive completion, new cn_ack_.data="
               << recv_status_message_.ack.data;
   }
+  if (lifecycle_ && recv_status_message_.time != 0) {
+    status_sent_ = recv_status_message_.time;
+    status_received_ = lifecycle_now();
+  }
   cn_ack_ = recv_status_message_.ack;
+  cn_read_ = recv_status_message_.read;
+  cn_credit_ = recv_status_message_.credit;
+  const ComputeNodeResize& resize = recv_status_message_.resize;
+  if (resize.generation != remote_generation_) {
+    // all writes to the previous regions have been acknowledged
+    assert(cn_wp_.desc == cn_ack_.desc);
+    remote_generation_ = resize.generation;
+    remote_info_ = resize.info;
+    L_(info) << "[i" << remote_index_ << "] "
+             << "[" << index_ << "] "
+             << "compute node switched to new buffers (data: 2^"
+             << remote_info_.data_buffer_size_exp << " bytes, desc: 2^"
+             << remote_info_.desc_buffer_size_exp << " entries)";
+  }
+  barrier_ = resize.barrier;
   post_recv_status_message();
 
   if (cn_wp_ == send_status_message_.wp && finalize_) {
@@ -231,6 +730,21 @@ void InputChannelConnection::on_complete_recv() {
   }
 }
 
+void InputChannelConnection::on_complete_read(
+    std::vector<uint64_t>& completed) {
+  // the outstanding timeslices occupy the target positions before cn_wp_
+  while (!outstanding_timeslices_.empty() &&
+         cn_wp_.desc - outstanding_timeslices_.size() < cn_read_.desc) {
+    completed.push_back(outstanding_timeslices_.front());
+    outstanding_timeslices_.pop_front();
+    pending_write_requests_--;
+    if (adaptive_window_ || pacing_) {
+      update_write_window(outstanding_posted_.front());
+      outstanding_posted_.pop_front();
+    }
+  }
+}
+
 void InputChannelConnection::setup(struct ibv_pd* pd) {
   // register memory regions
   mr_recv_ =
@@ -261,7 +775,8 @@ void InputChannelConnection::setup(struct ibv_pd* pd) {
 
   send_wr.wr_id = ID_SEND_STATUS | (index_ << 8);
   send_wr.opcode = IBV_WR_SEND;
-  send_wr.send_flags = IBV_SEND_SIGNALED;
+  send_wr.send_flags =
+      IBV_SEND_SIGNALED | inline_flag(sizeof(InputChannelStatusMessage));
   send_wr.sg_list = &send_sge;
   send_wr.num_sge = 1;
 
@@ -277,6 +792,23 @@ void InputChannelConnection::on_established(struct rdma_cm_event* event) {
   assert(event->param.conn.private_data_len >= sizeof(ComputeNodeInfo));
   memcpy(&remote_info_, event->param.conn.private_data,
          sizeof(ComputeNodeInfo));
+  if ((remote_info_.pull.addr != 0) != pull_) {
+    throw InfinibandException("transfer mode of compute node " +
+                              std::to_string(remote_index_) +
+                              " does not match");
+  }
+  if (pacing_) {
+    double rate = pacing_max_rate_;
+    if (rate == 0.0) {
+      rate = port_rate(event->id->verbs, event->id->port_num);
+    }
+    pacer_.emplace(rate, pacing_burst_, std::chrono::steady_clock::now());
+    L_(debug) << "[i" << remote_index_ << "] "
+              << "[" << index_ << "] "
+              << "pacing at " << human_readable_count(
+                                     static_cast<uint64_t>(rate))
+              << "/s";
+  }
 
   IBConnection::on_established(event);
 }
@@ -310,6 +842,9 @@ InputChannelConnection::get_private_data() {
 
   auto* in_info = reinterpret_cast<InputNodeInfo*>(private_data->data());
   in_info->index = remote_index_;
+  in_info->stripe = 0;
+  in_info->overlap_size = overlap_size_;
+  in_info->pull = pull_ ? 1 : 0;
 
   return private_data;
 }
@@ -5,6 +5,16 @@
 #include "ComputeNodeStatusMessage.hpp"
 #include "IBConnection.hpp"
 #include "InputChannelStatusMessage.hpp"
+#include "PullRequest.hpp"
+#include "StripeConnection.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceLifecycle.hpp"
+#include "TokenBucket.hpp"
+#include <array>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <vector>
 
 /// Input node connection class.
 /** An InputChannelConnection object represents the endpoint of a single
@@ -19,41 +29,165 @@ public:
                          uint_fast16_t remote_connection_index,
                          unsigned int max_send_wr,
                          unsigned int max_pending_write_requests,
+                         unsigned int signal_interval = 1,
+                         unsigned int post_batch = 1,
+                         std::chrono::microseconds status_interval =
+                             std::chrono::microseconds(0),
                          struct rdma_cm_id* id = nullptr);
 
   InputChannelConnection(const InputChannelConnection&) = delete;
   void operator=(const InputChannelConnection&) = delete;
 
   /// Wait until enough space is available at target compute node.
+  /** While the compute node switches its buffer to new regions, no space
+      is available beyond the announced barrier (see ComputeNodeResize). */
   bool check_for_buffer_space(uint64_t data_size, uint64_t desc_size);
 
   /// Send data and descriptors to compute node.
+  /** The work requests are queued and posted by post_pending_writes() (or
+      when post_batch timeslices are queued). Only every signal_interval-th
+      descriptor write is signaled. With stripe connections, the data is
+      divided between them and the descriptor is written once all parts
+      are complete. A control connection leaves all data to the stripes.
+      With lifecycle tracking, the given input buffer timestamps are
+      written along with the descriptor. */
   void send_data(struct ibv_sge* sge,
                  int num_sge,
                  uint64_t timeslice,
                  uint64_t desc_length,
                  uint64_t data_length,
-                 uint64_t skip);
+                 uint64_t skip,
+                 const TimesliceLifecycle& lifecycle = {});
+
+  /// Announce a timeslice component to be read by the compute node.
+  /** In pull mode, a pull request listing the source segments is written
+      instead of the data. The request is queued like a data write (see
+      send_data()), but the component is complete only once the compute
+      node reports it as read (see on_complete_read()). */
+  void send_pull_request(const PullSegment* segment,
+                         int num_segments,
+                         uint64_t timeslice,
+                         uint64_t desc_length,
+                         uint64_t data_length,
+                         uint64_t skip,
+                         const TimesliceLifecycle& lifecycle = {});
 
   bool write_request_available();
 
+  /// Adapt the number of outstanding write requests to the connection.
+  /** The window grows while the completion latency stays close to its
+      minimum (the transfer path is not yet full) and shrinks when it
+      rises (writes queue up), like a delay-based congestion window. It is
+      limited by max_pending_write_requests. Must be called before
+      connecting. */
+  void set_adaptive_window();
+
+  /// Retrieve the current limit of outstanding write requests.
+  [[nodiscard]] unsigned int write_window() const { return write_window_; }
+
+  /// Retrieve the number of outstanding write requests.
+  [[nodiscard]] unsigned int pending_write_requests() const {
+    return pending_write_requests_;
+  }
+
+  /// Space the timeslice writes to a rate (in bytes per second).
+  /** A token bucket admits bursts of up to the given size. Its rate is
+      reduced while the completion latency indicates queued writes (the
+      congestion signal) and recovers otherwise (see TokenBucket). With a
+      rate of zero, the rate of the local port is used. Must be called
+      before connecting. */
+  void set_pacing(double rate, double burst);
+
+  /// Retrieve the current pacing rate (in bytes per second, 0: none).
+  [[nodiscard]] double pacing_rate() const {
+    return pacer_ ? pacer_->rate() : 0.0;
+  }
+
+  /// Post all queued work requests with a single ibv_post_send() call.
+  /** Timeslices still waiting for stripe completions (and all after them)
+      remain queued. */
+  void post_pending_writes();
+
+  /// Make sure that a completion will be generated for all writes so far.
+  /** Posts the queued work requests, adding a signaled zero-length write if
+      the last of them is unsignaled. */
+  void request_write_completion();
+
+  /// Set the number of overlap microslices announced to the compute node.
+  void set_overlap_size(uint32_t overlap_size) {
+    overlap_size_ = overlap_size;
+  }
+
+  /// Let the compute node read the data (pull mode).
+  /** Must be called before connecting. At most max_reads components are
+      read at the same time. */
+  void set_pull(uint32_t max_reads);
+
+  /// Check whether the data is read by the compute node (pull mode).
+  [[nodiscard]] bool pull() const { return pull_; }
+
+  /// Set the stripe connections to divide the data writes between.
+  void set_stripes(std::vector<StripeConnection*> stripes);
+
+  /// Reserve this queue pair for descriptor writes and status messages.
+  /** All data is written by the stripe connections, so that the control
+      traffic does not queue behind bulk data writes. The connection uses
+      the given type of service. Must be called before connecting. */
+  void set_control_only(uint8_t tos);
+
+  /// Write the lifecycle timestamps of each component to the compute node.
+  /** Takes effect if the compute node provides a lifecycle record buffer.
+      Must be called before connecting. */
+  void set_lifecycle();
+
+  /// Handle completion of the stripe writes of a given timeslice.
+  void on_complete_stripe(uint64_t timeslice);
+
   /// Increment target write pointers after data has been sent.
   void inc_write_pointers(uint64_t data_size, uint64_t desc_size);
 
   // Get number of bytes to skip in advance (to avoid buffer wrap)
   uint64_t skip_required(uint64_t data_size);
 
+  /// Send a status message (write pointers) if it is due.
+  /** With a status interval, messages are coalesced while the target
+      buffer has headroom. The interval shrinks linearly with its fill
+      level, down to sending at every opportunity. */
   bool try_sync_buffer_positions();
 
   void finalize(bool abort);
 
   bool request_abort_flag() { return recv_status_message_.request_abort; }
 
-  void on_complete_write();
+  /// Retrieve the placement credits last announced by the compute node.
+  [[nodiscard]] const ComputeNodeCredit& cn_credit() const {
+    return cn_credit_;
+  }
+
+  /// Retrieve the number of status messages received, for statistics.
+  [[nodiscard]] uint64_t status_messages_received() const {
+    return status_messages_received_;
+  }
+
+  /// Retrieve the data buffer size exponent of the compute node.
+  [[nodiscard]] uint32_t data_buffer_size_exp() const {
+    return remote_info_.data_buffer_size_exp;
+  }
+
+  /// Handle completion of the descriptor write of a given timeslice.
+  /** As the send queue is processed in order, this completes all earlier
+      unsignaled writes. Their timeslice numbers are appended to
+      completed. */
+  void on_complete_write(uint64_t timeslice, std::vector<uint64_t>& completed);
 
   /// Handle Infiniband receive completion notification.
   void on_complete_recv();
 
+  /// Handle the components reported as read by the compute node.
+  /** In pull mode, the timeslice numbers of the components read since the
+      last call are appended to completed. */
+  void on_complete_read(std::vector<uint64_t>& completed);
+
   void setup(struct ibv_pd* pd) override;
 
   /// Connection handler function, called on successful connection.
@@ -77,18 +211,62 @@ private:
   /// Post a send work request (WR) to the send queue
   void post_send_status_message();
 
+  /// Retrieve the fill level of the target buffer (0 to 1).
+  [[nodiscard]] double target_fill() const;
+
+  /// Prepare the RDMA writes for a target range of given length.
+  /** A second work request (wr2, using sge2) is added if the range wraps
+      around the end of the target buffer. Returns the last work request. */
+  ibv_send_wr* prepare_data_writes(ibv_sge* sge,
+                                   int num_sge,
+                                   ibv_sge* sge2,
+                                   uint64_t cn_wp_data,
+                                   uint64_t length,
+                                   ibv_send_wr* wr,
+                                   ibv_send_wr* wr2);
+
+  /// Alignment (in bytes) of the data parts written by stripes.
+  static constexpr uint64_t stripe_alignment = 64;
+
   /// Flag, true if it is the input nodes's turn to send a pointer update.
   bool our_turn_ = true;
 
+  /// Maximum interval between status messages (zero: no coalescing).
+  std::chrono::microseconds status_interval_;
+
+  /// Time of the last status message sent.
+  std::chrono::steady_clock::time_point last_status_time_;
+
+  /// Number of status messages received.
+  uint64_t status_messages_received_ = 0;
+
   bool finalize_ = false;
   bool abort_ = false;
 
+  /// Flag, true if the data is read by the compute node.
+  bool pull_ = false;
+
   /// Access information for memory regions on remote end.
   ComputeNodeInfo remote_info_ = ComputeNodeInfo();
 
+  /// Generation of the remote regions (see ComputeNodeResize).
+  uint32_t remote_generation_ = 0;
+
+  /// Position not to be written before the next generation (0: none).
+  uint64_t barrier_ = 0;
+
   /// Local copy of acknowledged-by-CN pointers
   ComputeNodeBufferPosition cn_ack_ = ComputeNodeBufferPosition();
 
+  /// Number of overlap microslices per timeslice.
+  uint32_t overlap_size_ = 0;
+
+  /// Local copy of read-by-CN pointers (pull mode)
+  ComputeNodeBufferPosition cn_read_ = ComputeNodeBufferPosition();
+
+  /// Local copy of placement credits announced by CN
+  ComputeNodeCredit cn_credit_ = ComputeNodeCredit();
+
   /// Receive buffer for CN status (including acknowledged-by-CN pointers)
   ComputeNodeStatusMessage recv_status_message_ = ComputeNodeStatusMessage();
 
@@ -99,6 +277,9 @@ private:
   /// Local version of CN write pointers
   ComputeNodeBufferPosition cn_wp_ = ComputeNodeBufferPosition();
 
+  /// CN write pointers up to the last posted descriptor write
+  ComputeNodeBufferPosition posted_wp_ = ComputeNodeBufferPosition();
+
   /// Send buffer for input channel status (including CN write pointers)
   InputChannelStatusMessage send_status_message_ = InputChannelStatusMessage();
 
@@ -118,7 +299,121 @@ private:
   /// Scatter/gather list entry for send work request
   ibv_sge send_sge = ibv_sge();
 
+  /// Work requests of a queued timeslice transmission.
+  struct QueuedWrite {
+    std::array<ibv_sge, 4> sge;
+    std::array<ibv_sge, 4> sge2;
+    ibv_sge sge3;
+    fles::TimesliceComponentDescriptor tscdesc;
+    PullRequest pull;
+    ibv_sge sge_lifecycle;
+    TimesliceLifecycle lifecycle;
+    ibv_send_wr wr_ts;
+    ibv_send_wr wr_tswrap;
+    ibv_send_wr wr_lifecycle;
+    ibv_send_wr wr_tscdesc;
+    /// First work request (wr_ts, or wr_tscdesc in pull mode).
+    ibv_send_wr* first;
+    /// Number of stripe writes not yet completed.
+    unsigned int pending_stripes;
+    /// CN write pointers after this timeslice.
+    ComputeNodeBufferPosition wp;
+  };
+
   unsigned int pending_write_requests_{0};
 
   unsigned int max_pending_write_requests_{0};
+
+  /// Current limit of outstanding write requests (see
+  /// set_adaptive_window).
+  unsigned int write_window_{0};
+
+  /// Flag, true if the write window is adapted.
+  bool adaptive_window_ = false;
+
+  /// Flag, true while the write window grows exponentially.
+  bool window_slow_start_ = true;
+
+  /// Lower limit of the adaptive write window.
+  static constexpr unsigned int min_write_window = 2;
+
+  /// Estimated number of queued requests below which the window grows.
+  static constexpr double window_grow_queued = 1.0;
+
+  /// Estimated number of queued requests above which the window shrinks.
+  static constexpr double window_shrink_queued = 3.0;
+
+  /// Period after which the minimum latency is measured anew.
+  static constexpr std::chrono::seconds min_latency_period{10};
+
+  /// Minimum completion latency (the base round-trip time, in s).
+  double min_latency_ = 0.0;
+
+  /// Minimum completion latency in the current period (in s).
+  double period_min_latency_ = 0.0;
+
+  /// Begin of the current minimum latency period.
+  std::chrono::steady_clock::time_point min_latency_begin_;
+
+  /// Sum and number of the completion latencies of the current round.
+  double round_latency_sum_ = 0.0;
+  unsigned int round_samples_ = 0;
+
+  /// Flag, true if the timeslice writes are paced (see set_pacing).
+  bool pacing_ = false;
+
+  /// The configured pacing rate and burst size (in bytes [per second]).
+  double pacing_max_rate_ = 0.0;
+  double pacing_burst_ = 0.0;
+
+  /// The pacing token bucket (set up on connection).
+  std::optional<TokenBucket> pacer_;
+
+  /// Update the write window and the pacing rate with the latency of a
+  /// completed timeslice.
+  void update_write_window(std::chrono::steady_clock::time_point posted);
+
+  /// Account for a timeslice write of given size in the pacing.
+  void pace(uint64_t desc_length, uint64_t data_length);
+
+  /// Signal every n-th descriptor write.
+  unsigned int signal_interval_{1};
+
+  /// Number of descriptor writes since the last signaled one.
+  unsigned int unsignaled_writes_{0};
+
+  /// Maximum number of timeslices to post with a single call.
+  size_t post_batch_{1};
+
+  /// Queued, not yet posted timeslice transmissions.
+  std::deque<QueuedWrite> queued_writes_;
+
+  /// The stripe connections (not owned).
+  std::vector<StripeConnection*> stripes_;
+
+  /// Flag, true if this queue pair carries no data (see set_control_only).
+  bool control_only_ = false;
+
+  /// Flag, true if lifecycle records are written (see set_lifecycle).
+  bool lifecycle_ = false;
+
+  /// Send time (compute node clock) and receive time of the latest status
+  /// message, for the clock offset estimation of the compute node.
+  uint64_t status_sent_ = 0;
+  uint64_t status_received_ = 0;
+
+  /// Prepare the lifecycle record write of a queued timeslice (if any).
+  /** Returns the first work request of the descriptor write. */
+  ibv_send_wr* prepare_lifecycle_write(QueuedWrite& w,
+                                       const TimesliceLifecycle& lifecycle);
+
+  /// Timeslices posted or queued, but not yet completed.
+  std::deque<uint64_t> outstanding_timeslices_;
+
+  /// Post times of the outstanding timeslices (with an adaptive window or
+  /// pacing).
+  std::deque<std::chrono::steady_clock::time_point> outstanding_posted_;
+
+  /// Work request for a signaled zero-length write.
+  ibv_send_wr flush_wr_ = ibv_send_wr();
 };
@@ -1,46 +1,150 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 
 #include "InputChannelSender.hpp"
+#include "MemoryPlacement.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "RequestIdentifier.hpp"
 #include "System.hpp"
 #include "Utility.hpp"
 #include "log.hpp"
+#include "probes.hpp"
+#include "tracing.hpp"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
 
+namespace {
+constexpr auto min_connect_backoff = std::chrono::milliseconds(10);
+constexpr auto max_connect_backoff = std::chrono::milliseconds(1000);
+} // namespace
+
 InputChannelSender::InputChannelSender(
     uint64_t input_index,
     InputBufferReadInterface& data_source,
     std::vector<std::string> compute_hostnames,
     std::vector<std::string> compute_services,
-    uint32_t timeslice_size,
+    TimesliceSchedule schedule,
     uint32_t overlap_size,
     uint32_t max_timeslice_number,
-    cbm::Monitor* monitor)
+    PlacementPolicy placement_policy,
+    uint32_t placement_epoch,
+    cbm::Monitor* monitor,
+    uint32_t signal_interval,
+    uint32_t post_batch,
+    uint32_t stripes,
+    std::chrono::microseconds status_interval,
+    uint32_t connect_quorum,
+    MemoryRegistration registration,
+    bool adaptive_timeslice_size,
+    uint32_t pull_reads,
+    std::optional<uint8_t> control_tos,
+    bool adaptive_window,
+    uint32_t lookahead,
+    std::optional<double> pacing_rate,
+    double pacing_burst,
+    bool lifecycle)
     : input_index_(input_index), data_source_(data_source),
       compute_hostnames_(std::move(compute_hostnames)),
       compute_services_(std::move(compute_services)),
-      timeslice_size_(timeslice_size), overlap_size_(overlap_size),
+      schedule_(std::move(schedule)),
+      adaptive_timeslice_size_(adaptive_timeslice_size),
+      overlap_size_(overlap_size),
       max_timeslice_number_(max_timeslice_number),
-      min_acked_desc_(data_source.desc_buffer().size() / 4),
-      min_acked_data_(data_source.data_buffer().size() / 4), monitor_(monitor) {
+      ack_coalescing_(data_source.desc_buffer().size() / 4,
+                      data_source.data_buffer().size() / 4),
+      placement_(placement_policy, placement_epoch),
+      // descriptor writes are delayed by stripes, so signal each of them
+      signal_interval_(stripes > 1 ? 1
+                                   : std::max(signal_interval, UINT32_C(1))),
+      post_batch_(std::max(post_batch, UINT32_C(1))),
+      stripes_(std::max(stripes, UINT32_C(1))),
+      status_interval_(status_interval),
+      connect_quorum_(connect_quorum == 0
+                          ? static_cast<uint32_t>(compute_hostnames_.size())
+                          : std::min(connect_quorum,
+                                     static_cast<uint32_t>(
+                                         compute_hostnames_.size()))),
+      registration_(registration), pull_reads_(pull_reads),
+      control_tos_(stripes > 1 ? control_tos : std::nullopt),
+      adaptive_window_(adaptive_window),
+      // the timeslice size of an epoch is only decided in order
+      lookahead_(adaptive_timeslice_size ? 0 : lookahead),
+      pacing_rate_(pacing_rate), pacing_burst_(pacing_burst),
+      lifecycle_(lifecycle), monitor_(monitor) {
   start_index_desc_ = sent_desc_ = acked_desc_ = cached_acked_desc_ =
       data_source.get_read_index().desc;
   start_index_data_ = sent_data_ = acked_data_ = cached_acked_data_ =
       data_source.get_read_index().data;
 
+  // adaptive timeslices may be as small as a single microslice
   size_t min_ack_buffer_size =
-      data_source_.desc_buffer().size() / timeslice_size_ + 1;
+      data_source_.desc_buffer().size() /
+          (adaptive_timeslice_size_ ? 1 : schedule_.min_size()) +
+      1;
   ack_.alloc_with_size(min_ack_buffer_size);
 
   hostname_ = fles::system::current_hostname();
+
+  conn_metrics_.resize(compute_hostnames_.size());
+  if (monitor_) {
+    for (size_t i = 0; i < conn_metrics_.size(); ++i) {
+      cbm::MetricTagSet tags{{"host", hostname_},
+                             {"input_index", std::to_string(input_index_)},
+                             {"compute_index", std::to_string(i)}};
+      auto& m = conn_metrics_[i];
+      m.timeslices =
+          monitor_->RegisterCounter("send_connection_status", tags, "ts");
+      m.desc_bytes =
+          monitor_->RegisterCounter("send_connection_status", tags, "desc");
+      m.data_bytes =
+          monitor_->RegisterCounter("send_connection_status", tags, "data");
+      m.credit_wait_us = monitor_->RegisterCounter("send_connection_status",
+                                                   tags, "credit_wait_us");
+      m.outstanding_wr = monitor_->RegisterGauge("send_connection_status",
+                                                 tags, "outstanding_wr");
+      m.data_rate =
+          monitor_->RegisterGauge("send_connection_status", tags, "data_rate");
+      m.write_latency = monitor_->RegisterHistogram("send_connection_latency",
+                                                    tags, "write_us");
+    }
+    write_latency_ = monitor_->RegisterHistogram(
+        "send_latency",
+        {{"host", hostname_}, {"input_index", std::to_string(input_index_)}},
+        "write_us");
+    post_time_.alloc_with_size(min_ack_buffer_size);
+  }
+
+  cbm::MetricTagSet tags{{"host", hostname_},
+                         {"input_index", std::to_string(input_index_)}};
+  auto* sampler = BufferStatusSampler::instance();
+  auto* status = StatusServer::instance();
+  if (sampler != nullptr || status != nullptr) {
+    buffer_status_ = std::make_shared<BufferStatusSource>(
+        data_source_.desc_buffer().size(), data_source_.data_buffer().size());
+    if (sampler != nullptr) {
+      sampler->add_source("send_buffer_fill", tags, buffer_status_);
+    }
+    if (status != nullptr) {
+      status->add_buffer("send_buffer", tags, buffer_status_);
+    }
+    publish_buffer_status();
+  }
+  if (status != nullptr) {
+    connection_status_ = std::make_shared<ConnectionStatus>();
+    connection_status_->expected.store(
+        static_cast<uint32_t>(compute_hostnames_.size() * stripes_),
+        std::memory_order_relaxed);
+    publish_phase();
+    status->add_connections("input_channel_sender", tags, connection_status_);
+  }
 }
 
 InputChannelSender::~InputChannelSender() {
@@ -56,8 +160,6 @@ InputChannelSender::~InputChannelSender() {
 }
 
 void InputChannelSender::report_status() {
-  constexpr auto interval = std::chrono::seconds(1);
-
   // if data_source.written pointers are lagging behind due to lazy updates,
   // use sent value instead
   uint64_t written_desc = data_source_.get_write_index().desc;
@@ -96,6 +198,19 @@ void InputChannelSender::report_status() {
                           previous_send_buffer_status_data_.acked) /
       delta_t;
 
+  // rates of acknowledgments received from compute nodes and passed on to
+  // the data source
+  uint64_t status_messages = 0;
+  for (auto& c : conn_) {
+    status_messages += c->status_messages_received();
+  }
+  double ack_rate =
+      static_cast<double>(status_messages - previous_status_messages_) /
+      delta_t;
+  double read_index_rate =
+      static_cast<double>(read_index_updates_ - previous_read_index_updates_) /
+      delta_t;
+
   // retrieve SubsystemIdentifier and EquipmentIdentifier
   // from most current MicrosliceDescriptor
   auto sys_id = static_cast<fles::Subsystem>(0);
@@ -119,6 +234,40 @@ void InputChannelSender::report_status() {
             << human_readable_count(status_data.acked, true) << " ("
             << human_readable_count(rate_data, true, "B/s") << ")";
 
+  L_(debug) << "[i" << input_index_ << "] acks "
+            << human_readable_count(ack_rate, true, "Hz") << " received, "
+            << human_readable_count(read_index_rate, true, "Hz")
+            << " read index updates";
+
+  if (adaptive_window_) {
+    std::ostringstream windows;
+    for (auto& c : conn_) {
+      windows << " " << c->write_window();
+    }
+    L_(debug) << "[i" << input_index_ << "] write windows" << windows.str();
+  }
+
+  if (monitor_) {
+    for (size_t i = 0; i < conn_.size(); ++i) {
+      auto& m = conn_metrics_[i];
+      m.outstanding_wr.Set(conn_[i]->pending_write_requests());
+      m.data_rate.Set(
+          static_cast<double>(m.sent_bytes - m.previous_sent_bytes) /
+          delta_t);
+      m.previous_sent_bytes = m.sent_bytes;
+    }
+  }
+
+  if (pacing_rate_) {
+    std::ostringstream rates;
+    for (auto& c : conn_) {
+      rates << " "
+            << human_readable_count(static_cast<uint64_t>(c->pacing_rate()),
+                                    true, "B/s");
+    }
+    L_(debug) << "[i" << input_index_ << "] pacing rates" << rates.str();
+  }
+
   L_(status) << "[i" << input_index_ << "]   |"
              << bar_graph(status_data.vector(), "#x._", 20) << "|"
              << bar_graph(status_desc.vector(), "#x._", 10) << "| "
@@ -141,159 +290,378 @@ void InputChannelSender::report_status() {
                            {"desc_sending", status_desc.sending()},
                            {"desc_freeing", status_desc.freeing()},
                            {"desc_free", status_desc.unused()},
-                           {"desc_rate", rate_desc}});
+                           {"desc_rate", rate_desc},
+                           {"ack_rate", ack_rate},
+                           {"read_index_rate", read_index_rate}});
+  }
+
+  if (monitor_ && completion_wait_.enabled()) {
+    CompletionWait::Stats wait = completion_wait_.take_stats();
+    monitor_->QueueMetric(
+        "completion_wait",
+        {{"host", hostname_}, {"input_index", std::to_string(input_index_)}},
+        {{"waits", wait.waits},
+         {"wakeups", wait.wakeups},
+         {"blocked_ratio", wait.blocked_ratio()},
+         {"wait_us", wait.mean_wait_us()}});
   }
 
   previous_send_buffer_status_desc_ = status_desc;
   previous_send_buffer_status_data_ = status_data;
-
-  scheduler_.add([this] { report_status(); }, now + interval);
+  previous_status_messages_ = status_messages;
+  previous_read_index_updates_ = read_index_updates_;
 }
 
 void InputChannelSender::sync_buffer_positions() {
   for (auto& c : conn_) {
-    c->try_sync_buffer_positions();
+    if (c->established()) {
+      c->try_sync_buffer_positions();
+    }
   }
-
-  auto now = std::chrono::system_clock::now();
-  scheduler_.add([this] { sync_buffer_positions(); },
-                 now + std::chrono::milliseconds(0));
 }
 
-void InputChannelSender::sync_data_source(bool schedule) {
+void InputChannelSender::sync_data_source() {
   if (acked_data_ > cached_acked_data_ || acked_desc_ > cached_acked_desc_) {
     cached_acked_data_ = acked_data_;
     cached_acked_desc_ = acked_desc_;
     data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
-  }
-
-  if (schedule) {
-    auto now = std::chrono::system_clock::now();
-    scheduler_.add([this] { sync_data_source(true); },
-                   now + std::chrono::milliseconds(100));
+    ++read_index_updates_;
+    publish_buffer_status();
   }
 }
 
 /// The thread main function.
 void InputChannelSender::operator()() {
+  while (step()) {
+  }
+}
+
+bool InputChannelSender::step() {
   try {
+    switch (phase_) {
+    case Phase::Connect:
+      connect();
+      phase_ = Phase::Connecting;
+      break;
 
-    connect();
-    while (connected_ != compute_hostnames_.size()) {
+    case Phase::Connecting: {
       poll_cm_events();
-    }
-    L_(info) << "[i" << input_index_ << "] "
-             << "connection to compute nodes established";
-
-    data_source_.proceed();
-    time_begin_ = std::chrono::high_resolution_clock::now();
-
-    uint64_t timeslice = 0;
-    sync_buffer_positions();
-    sync_data_source(true);
-    report_status();
-    while (timeslice < max_timeslice_number_ && !abort_) {
-      if (try_send_timeslice(timeslice)) {
-        timeslice++;
-        if (timeslice == 1) {
-          L_(info) << "[i" << input_index_ << "] "
-                   << "first timeslice processed";
+      scheduler_.timer();
+      if (established_nodes() < connect_quorum_) {
+        break;
+      }
+      if (connected_ == compute_hostnames_.size() * stripes_) {
+        L_(info) << "[i" << input_index_ << "] "
+                 << "connection to compute nodes established";
+        report_startup("connected");
+      } else {
+        report_startup("quorum");
+      }
+
+      // with a quorum, the buffer sizes of the remaining compute nodes are
+      // not yet known (only used by the weighted placement policy)
+      std::vector<uint32_t> buffer_size_exp;
+      uint32_t known_size_exp = 0;
+      for (uint_fast16_t i = 0; i < conn_.size(); ++i) {
+        if (node_established(i)) {
+          known_size_exp = conn_[i]->data_buffer_size_exp();
         }
       }
-      poll_completion();
+      for (uint_fast16_t i = 0; i < conn_.size(); ++i) {
+        buffer_size_exp.push_back(node_established(i)
+                                      ? conn_[i]->data_buffer_size_exp()
+                                      : known_size_exp);
+      }
+      placement_.init(buffer_size_exp);
+
       data_source_.proceed();
-      scheduler_.timer();
+      time_begin_ = std::chrono::high_resolution_clock::now();
+
+      sync_buffer_positions();
+      sync_data_source();
+      report_status();
+      scheduler_.add_repeating([this] { sync_buffer_positions(); },
+                               std::chrono::milliseconds(0));
+      scheduler_.add_repeating([this] { sync_data_source(); },
+                               std::chrono::milliseconds(100));
+      scheduler_.add_repeating([this] { report_status(); },
+                               std::chrono::seconds(1));
+      phase_ = Phase::Sending;
+      break;
     }
 
-    // wait for pending send completions
-    while (acked_desc_ < timeslice_size_ * timeslice + start_index_desc_) {
-      poll_completion();
+    case Phase::Sending: {
+      const bool all_connected =
+          connected_ == compute_hostnames_.size() * stripes_;
+      if (!all_connected) {
+        // the remaining connections are set up while sending
+        poll_cm_events();
+        if (connected_ == compute_hostnames_.size() * stripes_) {
+          report_startup("connected");
+        }
+      }
+      if ((timeslice_ >= max_timeslice_number_ || abort_) && all_connected) {
+        phase_ = Phase::Draining;
+        break;
+      }
+      bool sent = false;
+      if (lookahead_ > 0) {
+        sent = send_lookahead();
+      } else {
+        for (uint32_t n = 0; n < post_batch_ &&
+                             timeslice_ < max_timeslice_number_ &&
+                             try_send_timeslice(timeslice_);
+             ++n) {
+          sent = true;
+          timeslice_++;
+          if (timeslice_ == 1) {
+            L_(info) << "[i" << input_index_ << "] "
+                     << "first timeslice processed";
+          }
+        }
+      }
+      flush_writes(sent);
+      const int completions = poll_completion();
+      data_source_.proceed();
       scheduler_.timer();
+      idle_wait(sent || completions > 0);
+      break;
     }
-    sync_data_source(false);
 
-    for (auto& c : conn_) {
-      c->finalize(abort_);
-    }
+    case Phase::Draining:
+      // wait for pending send completions
+      if (acked_desc_ < schedule_.start(timeslice_) + start_index_desc_) {
+        flush_writes(false);
+        const int completions = poll_completion();
+        scheduler_.timer();
+        idle_wait(completions > 0);
+        break;
+      }
+      sync_data_source();
 
-    L_(debug) << "[i" << input_index_ << "] "
-              << "SENDER loop done";
+      for (auto& c : conn_) {
+        c->finalize(abort_);
+      }
 
-    while (!all_done_) {
-      poll_completion();
-      scheduler_.timer();
-    }
+      L_(debug) << "[i" << input_index_ << "] "
+                << "SENDER loop done";
+      phase_ = Phase::Finishing;
+      break;
+
+    case Phase::Finishing:
+      if (!all_done_) {
+        idle_wait(poll_completion() > 0);
+        scheduler_.timer();
+        break;
+      }
 
-    time_end_ = std::chrono::high_resolution_clock::now();
+      time_end_ = std::chrono::high_resolution_clock::now();
 
-    // this should not be neccessary
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      // this should not be neccessary
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-    disconnect();
-    while (connected_ != 0 || timewait_ != 0) {
-      poll_cm_events();
-    }
+      disconnect();
+      for (auto& s : stripe_conn_) {
+        s->disconnect();
+      }
+      phase_ = Phase::Disconnecting;
+      break;
 
-    summary();
+    case Phase::Disconnecting:
+      if (connected_ != 0 || timewait_ != 0) {
+        poll_cm_events();
+        break;
+      }
+      summary();
+      phase_ = Phase::Done;
+      break;
+
+    case Phase::Done:
+      break;
+    }
   } catch (std::exception& e) {
     L_(error) << "exception in InputChannelSender: " << e.what();
+    phase_ = Phase::Done;
   }
+  if (connection_status_ && phase_ != published_phase_) {
+    publish_phase();
+  }
+  return phase_ != Phase::Done;
+}
+
+void InputChannelSender::publish_phase() {
+  static constexpr std::array<const char*, 7> names = {
+      "connect",   "connecting",    "sending", "draining",
+      "finishing", "disconnecting", "done"};
+  published_phase_ = phase_;
+  connection_status_->phase.store(names.at(static_cast<size_t>(phase_)),
+                                  std::memory_order_relaxed);
 }
 
 bool InputChannelSender::try_send_timeslice(uint64_t timeslice) {
+  // all inputs start the timeslices of a credit epoch with the same size
+  if (adaptive_timeslice_size_ && timeslice > 0 &&
+      placement_.epoch(timeslice) != placement_.epoch(timeslice - 1)) {
+    if (!placement_.ready(timeslice)) {
+      return false;
+    }
+    uint32_t size = placement_.epoch_size(placement_.epoch(timeslice));
+    if (size != 0 && size != schedule_.size(timeslice)) {
+      schedule_.add_change(timeslice, size);
+      L_(debug) << "[i" << input_index_ << "] "
+                << "timeslice size " << size << " from timeslice "
+                << timeslice;
+    }
+  }
+
+  TimesliceRange range{};
+  if (!assemble_timeslice(timeslice, range)) {
+    return false;
+  }
+
+  // wait until all inputs can agree on the target compute node
+  if (!placement_.ready(timeslice)) {
+    return false;
+  }
+
+  return try_send_range(range, target_cn_index(timeslice));
+}
+
+bool InputChannelSender::assemble_timeslice(uint64_t timeslice,
+                                            TimesliceRange& range) {
   // wait until a complete timeslice is available in the input buffer
-  uint64_t desc_offset = timeslice * timeslice_size_ + start_index_desc_;
-  uint64_t desc_length = timeslice_size_ + overlap_size_;
+  uint64_t desc_offset = schedule_.start(timeslice) + start_index_desc_;
+  uint64_t desc_length = schedule_.size(timeslice) + overlap_size_;
 
   if (write_index_desc_ < desc_offset + desc_length) {
-    write_index_desc_ = data_source_.get_write_index().desc;
+    auto write_index = data_source_.get_write_index();
+    write_index_desc_ = write_index.desc;
+    write_index_data_ = write_index.data;
+    publish_buffer_status();
+    if (lifecycle_ && write_index_desc_ > desc_offset &&
+        first_available_timeslice_ != timeslice) {
+      first_available_ = lifecycle_now();
+      first_available_timeslice_ = timeslice;
+    }
   }
   // check if microslice no. (desc_offset + desc_length - 1) is avail
-  if (write_index_desc_ >= desc_offset + desc_length) {
+  if (write_index_desc_ < desc_offset + desc_length) {
+    return false;
+  }
 
-    uint64_t data_offset = data_source_.desc_buffer().at(desc_offset).offset;
-    uint64_t data_end =
-        data_source_.desc_buffer().at(desc_offset + desc_length - 1).offset +
-        data_source_.desc_buffer().at(desc_offset + desc_length - 1).size;
-    assert(data_end >= data_offset);
+  uint64_t data_offset = data_source_.desc_buffer().at(desc_offset).offset;
+  uint64_t data_end =
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).offset +
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).size;
+  assert(data_end >= data_offset);
+
+  range = {timeslice, desc_offset, desc_length, data_offset, data_end, false,
+           0, 0};
+  if (lifecycle_) {
+    range.last_available = lifecycle_now();
+    // a timeslice found complete at once became available in between
+    range.first_available = first_available_timeslice_ == timeslice
+                                ? first_available_
+                                : range.last_available;
+  }
 
-    uint64_t data_length = data_end - data_offset;
-    uint64_t total_length =
-        data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
+  if (false) {
+    L_(trace) << "SENDER working on timeslice " << timeslice
+              << ", microslices " << desc_offset << ".."
+              << (desc_offset + desc_length - 1) << ", data bytes "
+              << data_offset << ".." << (data_end - 1);
+    L_(trace) << get_state_string();
+  }
+  return true;
+}
 
-    if (false) {
-      L_(trace) << "SENDER working on timeslice " << timeslice
-                << ", microslices " << desc_offset << ".."
-                << (desc_offset + desc_length - 1) << ", data bytes "
-                << data_offset << ".." << (data_offset + data_length - 1);
-      L_(trace) << get_state_string();
-    }
+bool InputChannelSender::try_send_range(const TimesliceRange& range, int cn) {
+  // wait for the connection to be set up (if started with a quorum)
+  if (!node_established(cn)) {
+    return false;
+  }
 
-    int cn = target_cn_index(timeslice);
+  if (!conn_[cn]->write_request_available()) {
+    wait_for_credit(cn);
+    return false;
+  }
 
-    if (!conn_[cn]->write_request_available()) {
-      return false;
-    }
+  uint64_t data_length = range.data_end - range.data_offset;
+  uint64_t total_length =
+      data_length + range.desc_length * sizeof(fles::MicrosliceDescriptor);
+
+  // number of bytes to skip in advance (to avoid buffer wrap)
+  uint64_t skip = conn_[cn]->skip_required(total_length);
+  total_length += skip;
+
+  if (!conn_[cn]->check_for_buffer_space(total_length, 1)) {
+    wait_for_credit(cn);
+    return false;
+  }
+  end_wait_for_credit(cn);
+
+  tracing::Scope trace_scope("try_send_timeslice", range.timeslice);
+  FLES_PROBE(send_timeslice_entry, range.timeslice, cn, total_length);
 
-    // number of bytes to skip in advance (to avoid buffer wrap)
-    uint64_t skip = conn_[cn]->skip_required(total_length);
-    total_length += skip;
+  post_send_data(range.timeslice, cn, range.desc_offset, range.desc_length,
+                 range.data_offset, data_length, skip,
+                 {range.first_available, range.last_available, 0, 0, 0});
 
-    if (conn_[cn]->check_for_buffer_space(total_length, 1)) {
+  conn_[cn]->inc_write_pointers(total_length, 1);
 
-      post_send_data(timeslice, cn, desc_offset, desc_length, data_offset,
-                     data_length, skip);
+  sent_desc_ = std::max(sent_desc_, range.desc_offset + range.desc_length);
+  sent_data_ = std::max(sent_data_, range.data_end);
+  publish_buffer_status();
+  FLES_PROBE(send_timeslice_return, range.timeslice, cn, total_length);
 
-      conn_[cn]->inc_write_pointers(total_length, 1);
+  return true;
+}
 
-      sent_desc_ = desc_offset + desc_length;
-      sent_data_ = data_end;
+bool InputChannelSender::send_lookahead() {
+  // extend the queue as descriptors arrive
+  uint64_t next = timeslice_ + lookahead_queue_.size();
+  while (lookahead_queue_.size() <= lookahead_ &&
+         next < max_timeslice_number_) {
+    TimesliceRange range{};
+    if (!assemble_timeslice(next, range)) {
+      break;
+    }
+    lookahead_queue_.push_back(range);
+    ++next;
+  }
 
-      return true;
+  // send to every ready target, a compute node blocking a timeslice
+  // blocks all its later ones
+  std::vector<bool> blocked(conn_.size(), false);
+  bool sent = false;
+  for (auto& range : lookahead_queue_) {
+    if (range.sent) {
+      continue;
+    }
+    if (!placement_.ready(range.timeslice)) {
+      break;
+    }
+    int cn = target_cn_index(range.timeslice);
+    if (blocked.at(cn)) {
+      continue;
+    }
+    if (try_send_range(range, cn)) {
+      range.sent = true;
+      sent = true;
+    } else {
+      blocked.at(cn) = true;
     }
   }
 
-  return false;
+  while (!lookahead_queue_.empty() && lookahead_queue_.front().sent) {
+    lookahead_queue_.pop_front();
+    ++timeslice_;
+    if (timeslice_ == 1) {
+      L_(info) << "[i" << input_index_ << "] "
+               << "first timeslice processed";
+    }
+  }
+  return sent;
 }
 
 std::unique_ptr<InputChannelConnection>
@@ -301,27 +669,139 @@ InputChannelSender::create_input_node_connection(uint_fast16_t index) {
   unsigned int max_send_wr = 8000;
 
   // limit pending write requests so that send queue and completion queue
-  // do not overflow
-  unsigned int max_pending_write_requests = std::min(
-      static_cast<unsigned int>((max_send_wr - 1) / 3),
-      static_cast<unsigned int>((num_cqe_ - 1) / compute_hostnames_.size()));
+  // do not overflow (with selective signaling, a timeslice may additionally
+  // require a zero-length write to request its completion, and lifecycle
+  // tracking adds a record write; with stripes, each of them generates a
+  // completion)
+  unsigned int wr_per_timeslice =
+      (signal_interval_ > 1 ? 4 : 3) + (lifecycle_ ? 1 : 0);
+  unsigned int max_pending_write_requests =
+      std::min(static_cast<unsigned int>((max_send_wr - 1) / wr_per_timeslice),
+               static_cast<unsigned int>((num_cqe_ - 1) /
+                                         (compute_hostnames_.size() *
+                                          stripes_)));
 
   std::unique_ptr<InputChannelConnection> connection(new InputChannelConnection(
-      ec_, index, input_index_, max_send_wr, max_pending_write_requests));
+      ec_, index, input_index_, max_send_wr, max_pending_write_requests,
+      signal_interval_, post_batch_, status_interval_));
+  connection->set_overlap_size(overlap_size_);
+  if (pull_reads_ > 0) {
+    connection->set_pull(pull_reads_);
+  }
+  if (control_tos_) {
+    connection->set_control_only(*control_tos_);
+  }
+  if (adaptive_window_) {
+    connection->set_adaptive_window();
+  }
+  if (pacing_rate_) {
+    connection->set_pacing(*pacing_rate_, pacing_burst_);
+  }
+  if (lifecycle_) {
+    connection->set_lifecycle();
+  }
+  return connection;
+}
+
+std::unique_ptr<StripeConnection>
+InputChannelSender::create_stripe_connection(uint_fast16_t index,
+                                             uint32_t stripe) {
+  unsigned int max_send_wr = 8000;
+
+  std::unique_ptr<StripeConnection> connection(
+      new StripeConnection(ec_, index, input_index_, stripe, max_send_wr));
   return connection;
 }
 
 void InputChannelSender::connect() {
+  connect_begin_ = std::chrono::steady_clock::now();
+
+  // resolve all addresses in parallel, as name lookups may be slow
+  std::vector<std::future<std::shared_ptr<struct addrinfo>>> addresses;
+  for (unsigned int i = 0; i < compute_hostnames_.size(); ++i) {
+    addresses.push_back(std::async(std::launch::async, IBConnection::resolve,
+                                   compute_hostnames_[i],
+                                   compute_services_[i]));
+  }
+  for (auto& address : addresses) {
+    compute_addresses_.push_back(address.get());
+  }
+  connect_backoff_.assign(compute_hostnames_.size(), min_connect_backoff);
+
+  // the connection requests then proceed concurrently
   for (unsigned int i = 0; i < compute_hostnames_.size(); ++i) {
     std::unique_ptr<InputChannelConnection> connection =
         create_input_node_connection(i);
-    connection->connect(compute_hostnames_[i], compute_services_[i]);
+    connection->connect(compute_addresses_[i].get());
     conn_.push_back(std::move(connection));
+    for (uint32_t s = 1; s < stripes_; ++s) {
+      std::unique_ptr<StripeConnection> stripe =
+          create_stripe_connection(i, s);
+      stripe->connect(compute_addresses_[i].get());
+      stripe_conn_.push_back(std::move(stripe));
+    }
+    attach_stripes(i);
   }
 }
 
+bool InputChannelSender::node_established(uint_fast16_t index) const {
+  if (!conn_.at(index)->established()) {
+    return false;
+  }
+  for (uint32_t s = 1; s < stripes_; ++s) {
+    if (!stripe_conn_.at(index * (stripes_ - 1) + s - 1)->established()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t InputChannelSender::established_nodes() const {
+  uint32_t count = 0;
+  for (uint_fast16_t i = 0; i < conn_.size(); ++i) {
+    if (node_established(i)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void InputChannelSender::report_startup(const char* stage) {
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - connect_begin_)
+                       .count();
+  L_(info) << "[i" << input_index_ << "] " << stage << " after " << seconds
+           << " s (" << connect_retries_ << " retries)";
+  if (monitor_) {
+    monitor_->QueueMetric(
+        "send_startup",
+        {{"host", hostname_},
+         {"input_index", std::to_string(input_index_)},
+         {"stage", stage}},
+        {{"seconds", seconds}, {"retries", connect_retries_}});
+  }
+}
+
+void InputChannelSender::attach_stripes(uint_fast16_t index) {
+  std::vector<StripeConnection*> stripes;
+  for (uint32_t s = 1; s < stripes_; ++s) {
+    stripes.push_back(stripe_conn_.at(index * (stripes_ - 1) + s - 1).get());
+  }
+  conn_.at(index)->set_stripes(std::move(stripes));
+}
+
 int InputChannelSender::target_cn_index(uint64_t timeslice) {
-  return timeslice % conn_.size();
+  return static_cast<int>(placement_.target(timeslice));
+}
+
+void InputChannelSender::update_placement_credit(int cn) {
+  const ComputeNodeCredit& credit = conn_[cn]->cn_credit();
+  if (credit.epoch == 0) {
+    return;
+  }
+  placement_.set_credit(credit.epoch, cn, credit.value[0], credit.size[0]);
+  placement_.set_credit(credit.epoch - 1, cn, credit.value[1],
+                        credit.size[1]);
 }
 
 void InputChannelSender::dump_mr(struct ibv_mr* mr) {
@@ -337,24 +817,32 @@ void InputChannelSender::on_addr_resolved(struct rdma_cm_id* id) {
   IBConnectionGroup<InputChannelConnection>::on_addr_resolved(id);
 
   if (mr_data_ == nullptr) {
-    // Register memory regions.
-    mr_data_ =
-        ibv_reg_mr(pd_, const_cast<uint8_t*>(data_source_.data_buffer().ptr()),
-                   data_source_.data_buffer().bytes(), IBV_ACCESS_LOCAL_WRITE);
+    // Register memory regions, readable by the compute nodes in pull mode.
+    const std::string name = "[i" + std::to_string(input_index_) + "] ";
+    const int access =
+        IBV_ACCESS_LOCAL_WRITE | (pull_reads_ > 0 ? IBV_ACCESS_REMOTE_READ : 0);
+    mr_data_ = register_memory(
+        pd_, const_cast<uint8_t*>(data_source_.data_buffer().ptr()),
+        data_source_.data_buffer().mapped_bytes(), access, registration_,
+        name + "data buffer");
     if (mr_data_ == nullptr) {
       L_(error) << "ibv_reg_mr failed for mr_data: " << strerror(errno);
       throw InfinibandException("registration of memory region failed");
     }
 
-    mr_desc_ =
-        ibv_reg_mr(pd_,
-                   const_cast<fles::MicrosliceDescriptor*>(
-                       data_source_.desc_buffer().ptr()),
-                   data_source_.desc_buffer().bytes(), IBV_ACCESS_LOCAL_WRITE);
+    mr_desc_ = register_memory(pd_,
+                               const_cast<fles::MicrosliceDescriptor*>(
+                                   data_source_.desc_buffer().ptr()),
+                               data_source_.desc_buffer().mapped_bytes(),
+                               access, registration_, name + "desc buffer");
     if (mr_desc_ == nullptr) {
       L_(error) << "ibv_reg_mr failed for mr_desc: " << strerror(errno);
       throw InfinibandException("registration of memory region failed");
     }
+    registered_account_ = MemoryAccount(
+        "rdma_input_buffer", MemoryUse::Registered,
+        mr_data_->length + mr_desc_->length,
+        numa_node_of_memory(data_source_.desc_buffer().ptr()));
 
     if (true) {
       dump_mr(mr_desc_);
@@ -364,17 +852,38 @@ void InputChannelSender::on_addr_resolved(struct rdma_cm_id* id) {
 }
 
 void InputChannelSender::on_rejected(struct rdma_cm_event* event) {
-  auto* conn = static_cast<InputChannelConnection*>(event->id->context);
+  auto* ib_conn = static_cast<IBConnection*>(event->id->context);
+
+  ib_conn->on_rejected(event);
+  uint_fast16_t i = ib_conn->index();
+  uint32_t s = 0;
+  if (auto* stripe_conn = dynamic_cast<StripeConnection*>(ib_conn)) {
+    s = stripe_conn->stripe();
+  }
 
-  conn->on_rejected(event);
-  uint_fast16_t i = conn->index();
-  conn_.at(i) = nullptr;
+  // retry with exponential backoff, as the compute node may not be ready
+  auto& backoff = connect_backoff_.at(i);
+  scheduler_.add_after([this, i, s] { reconnect(i, s); }, backoff);
+  backoff = std::min(2 * backoff, max_connect_backoff);
+  ++connect_retries_;
+}
 
-  // immediately initiate retry
-  std::unique_ptr<InputChannelConnection> connection =
-      create_input_node_connection(i);
-  connection->connect(compute_hostnames_[i], compute_services_[i]);
-  conn_.at(i) = std::move(connection);
+void InputChannelSender::reconnect(uint_fast16_t index, uint32_t stripe) {
+  if (stripe != 0) {
+    auto& slot = stripe_conn_.at(index * (stripes_ - 1) + stripe - 1);
+    slot = nullptr;
+    std::unique_ptr<StripeConnection> connection =
+        create_stripe_connection(index, stripe);
+    connection->connect(compute_addresses_.at(index).get());
+    slot = std::move(connection);
+  } else {
+    conn_.at(index) = nullptr;
+    std::unique_ptr<InputChannelConnection> connection =
+        create_input_node_connection(index);
+    connection->connect(compute_addresses_.at(index).get());
+    conn_.at(index) = std::move(connection);
+  }
+  attach_stripes(index);
 }
 
 std::string InputChannelSender::get_state_string() {
@@ -406,13 +915,16 @@ void InputChannelSender::post_send_data(uint64_t timeslice,
                                         uint64_t desc_length,
                                         uint64_t data_offset,
                                         uint64_t data_length,
-                                        uint64_t skip) {
+                                        uint64_t skip,
+                                        const TimesliceLifecycle& lifecycle) {
+  tracing::Scope trace_scope("post_send_data", timeslice);
   int num_sge = 0;
   std::array<ibv_sge, 4> sge{};
   // descriptors
-  if ((desc_offset & data_source_.desc_buffer().size_mask()) <=
-      ((desc_offset + desc_length - 1) &
-       data_source_.desc_buffer().size_mask())) {
+  if (data_source_.desc_buffer().mirrored() ||
+      (desc_offset & data_source_.desc_buffer().size_mask()) <=
+          ((desc_offset + desc_length - 1) &
+           data_source_.desc_buffer().size_mask())) {
     // one chunk
     sge[num_sge].addr = reinterpret_cast<uintptr_t>(
         &data_source_.desc_buffer().at(desc_offset));
@@ -438,9 +950,10 @@ void InputChannelSender::post_send_data(uint64_t timeslice,
   // data
   if (data_length == 0) {
     // zero chunks
-  } else if ((data_offset & data_source_.data_buffer().size_mask()) <=
-             ((data_offset + data_length - 1) &
-              data_source_.data_buffer().size_mask())) {
+  } else if (data_source_.data_buffer().mirrored() ||
+             (data_offset & data_source_.data_buffer().size_mask()) <=
+                 ((data_offset + data_length - 1) &
+                  data_source_.data_buffer().size_mask())) {
     // one chunk
     sge[num_sge].addr = reinterpret_cast<uintptr_t>(
         &data_source_.data_buffer().at(data_offset));
@@ -462,48 +975,183 @@ void InputChannelSender::post_send_data(uint64_t timeslice,
     sge[num_sge++].lkey = mr_data_->lkey;
   }
 
-  conn_[cn]->send_data(sge.data(), num_sge, timeslice, desc_length, data_length,
-                       skip);
+  if (pull_reads_ > 0) {
+    // the compute node reads the same segments with the remote keys
+    std::array<PullSegment, 4> segment{};
+    for (int i = 0; i < num_sge; ++i) {
+      segment[i].addr = sge[i].addr;
+      segment[i].length = sge[i].length;
+      segment[i].rkey =
+          sge[i].lkey == mr_desc_->lkey ? mr_desc_->rkey : mr_data_->rkey;
+    }
+    conn_[cn]->send_pull_request(segment.data(), num_sge, timeslice,
+                                 desc_length, data_length, skip, lifecycle);
+  } else {
+    conn_[cn]->send_data(sge.data(), num_sge, timeslice, desc_length,
+                         data_length, skip, lifecycle);
+  }
+
+  if (write_latency_) {
+    post_time_.at(timeslice) = std::chrono::steady_clock::now();
+  }
+  auto& m = conn_metrics_[cn];
+  m.timeslices.Add();
+  m.desc_bytes.Add(sizeof(fles::MicrosliceDescriptor) * desc_length);
+  m.data_bytes.Add(data_length);
+  m.sent_bytes += sizeof(fles::MicrosliceDescriptor) * desc_length +
+                  data_length;
+}
+
+void InputChannelSender::wait_for_credit(int cn) {
+  auto& m = conn_metrics_[cn];
+  if (monitor_ && !m.waiting_since) {
+    m.waiting_since = std::chrono::steady_clock::now();
+  }
+}
+
+void InputChannelSender::end_wait_for_credit(int cn) {
+  auto& m = conn_metrics_[cn];
+  if (m.waiting_since) {
+    m.credit_wait_us.Add(static_cast<unsigned long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - *m.waiting_since)
+            .count()));
+    m.waiting_since.reset();
+  }
+}
+
+void InputChannelSender::on_timeslice_complete(uint64_t ts, int cn) {
+  if (write_latency_) {
+    auto latency = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - post_time_.at(ts))
+            .count());
+    write_latency_.Record(latency);
+    conn_metrics_[cn].write_latency.Record(latency);
+  }
+  uint64_t acked_ts = schedule_.timeslice_at(acked_desc_ - start_index_desc_);
+  if (ts != acked_ts) {
+    // transmission has been reordered, store completion information
+    ack_.at(ts) = ts;
+  } else {
+    // completion is for earliest pending timeslice, update indices
+    do {
+      ++acked_ts;
+    } while (ack_.at(acked_ts) > ts);
+    acked_desc_ = schedule_.start(acked_ts) + start_index_desc_;
+    schedule_.discard_before(acked_ts);
+    acked_data_ = data_source_.desc_buffer().at(acked_desc_ - 1).offset +
+                  data_source_.desc_buffer().at(acked_desc_ - 1).size;
+    acked_advanced_ = true;
+  }
+  if (false) {
+    L_(trace) << "[i" << input_index_ << "] "
+              << "write timeslice " << ts
+              << " complete, now: acked_data_=" << acked_data_
+              << " acked_desc_=" << acked_desc_;
+  }
+}
+
+void InputChannelSender::release_acked() {
+  // release buffer space the sooner the fuller the buffer is
+  if (ack_coalescing_.due(acked_desc_ - cached_acked_desc_,
+                          acked_data_ - cached_acked_data_, buffer_fill())) {
+    cached_acked_data_ = acked_data_;
+    cached_acked_desc_ = acked_desc_;
+    data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
+    ++read_index_updates_;
+  }
+  publish_buffer_status();
+}
+
+double InputChannelSender::buffer_fill() const {
+  uint64_t written_desc = std::max(write_index_desc_, sent_desc_);
+  double fill_desc = static_cast<double>(written_desc - cached_acked_desc_) /
+                     static_cast<double>(data_source_.desc_buffer().size());
+  double fill_data = static_cast<double>(sent_data_ - cached_acked_data_) /
+                     static_cast<double>(data_source_.data_buffer().size());
+  return std::max(fill_desc, fill_data);
+}
+
+void InputChannelSender::publish_buffer_status() {
+  if (buffer_status_) {
+    buffer_status_->desc.publish(cached_acked_desc_, acked_desc_, sent_desc_,
+                                 std::max(write_index_desc_, sent_desc_));
+    buffer_status_->data.publish(cached_acked_data_, acked_data_, sent_data_,
+                                 std::max(write_index_data_, sent_data_));
+  }
+}
+
+void InputChannelSender::flush_writes(bool sent) {
+  for (auto& c : conn_) {
+    if (!c->established()) {
+      continue;
+    }
+    if (sent) {
+      c->post_pending_writes();
+    } else {
+      // nothing more to send at the moment, so unsignaled writes need a
+      // completion to be acknowledged
+      c->request_write_completion();
+    }
+  }
+}
+
+void InputChannelSender::on_completions(const struct ibv_wc* wc,
+                                        size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    on_completion(wc[i]);
+  }
+  // only the final state of the batch is passed on
+  for (int cn : credit_updates_) {
+    update_placement_credit(cn);
+  }
+  credit_updates_.clear();
+  if (acked_advanced_) {
+    acked_advanced_ = false;
+    release_acked();
+  }
 }
 
 void InputChannelSender::on_completion(const struct ibv_wc& wc) {
+  tracing::Scope trace_scope("sender_completion", wc.wr_id & 0xFF);
   switch (wc.wr_id & 0xFF) {
   case ID_WRITE_DESC: {
     uint64_t ts = wc.wr_id >> 24;
 
     int cn = (wc.wr_id >> 8) & 0xFFFF;
-    conn_[cn]->on_complete_write();
-
-    uint64_t acked_ts = (acked_desc_ - start_index_desc_) / timeslice_size_;
-    if (ts != acked_ts) {
-      // transmission has been reordered, store completion information
-      ack_.at(ts) = ts;
-    } else {
-      // completion is for earliest pending timeslice, update indices
-      do {
-        ++acked_ts;
-      } while (ack_.at(acked_ts) > ts);
-      acked_desc_ = acked_ts * timeslice_size_ + start_index_desc_;
-      acked_data_ = data_source_.desc_buffer().at(acked_desc_ - 1).offset +
-                    data_source_.desc_buffer().at(acked_desc_ - 1).size;
-      if (acked_data_ >= cached_acked_data_ + min_acked_data_ ||
-          acked_desc_ >= cached_acked_desc_ + min_acked_desc_) {
-        cached_acked_data_ = acked_data_;
-        cached_acked_desc_ = acked_desc_;
-        data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
-      }
-    }
-    if (false) {
-      L_(trace) << "[i" << input_index_ << "] "
-                << "write timeslice " << ts
-                << " complete, now: acked_data_=" << acked_data_
-                << " acked_desc_=" << acked_desc_;
+    FLES_PROBE(write_complete, ts, cn);
+    completed_timeslices_.clear();
+    conn_[cn]->on_complete_write(ts, completed_timeslices_);
+    for (uint64_t completed_ts : completed_timeslices_) {
+      on_timeslice_complete(completed_ts, cn);
     }
   } break;
 
+  case ID_WRITE_STRIPE: {
+    uint64_t ts = wc.wr_id >> 24;
+
+    int cn = (wc.wr_id >> 8) & 0xFFFF;
+    conn_[cn]->on_complete_stripe(ts);
+  } break;
+
+  case ID_WRITE_PULL: {
+  } break;
+
   case ID_RECEIVE_STATUS: {
     int cn = wc.wr_id >> 8;
     conn_[cn]->on_complete_recv();
+    if (conn_[cn]->pull()) {
+      completed_timeslices_.clear();
+      conn_[cn]->on_complete_read(completed_timeslices_);
+      for (uint64_t completed_ts : completed_timeslices_) {
+        on_timeslice_complete(completed_ts, cn);
+      }
+    }
+    if (std::find(credit_updates_.begin(), credit_updates_.end(), cn) ==
+        credit_updates_.end()) {
+      credit_updates_.push_back(cn);
+    }
     if (conn_[cn]->request_abort_flag()) {
       abort_ = true;
     }
@@ -1,13 +1,21 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "AckCoalescing.hpp"
+#include "BufferStatusSampler.hpp"
 #include "DualRingBuffer.hpp"
 #include "IBConnectionGroup.hpp"
 #include "InputChannelConnection.hpp"
+#include "MemoryAccounting.hpp"
+#include "MemoryRegistration.hpp"
 #include "Monitor.hpp"
 #include "RingBuffer.hpp"
+#include "TimeslicePlacement.hpp"
+#include "TimesliceSchedule.hpp"
 #include <boost/format.hpp>
 #include <cassert>
+#include <deque>
+#include <optional>
 
 /// Input buffer and compute node connection container class.
 /** An InputChannelSender object represents an input buffer (filled by a
@@ -17,14 +25,44 @@
 class InputChannelSender : public IBConnectionGroup<InputChannelConnection> {
 public:
   /// The InputChannelSender default constructor.
+  /** If control_tos is set (requires stripes > 1), the primary queue pair
+      of each compute node connection carries only descriptors and status
+      messages, with the given type of service, and the stripes carry all
+      data. If adaptive_window is set, the number of outstanding writes per
+      compute node follows its completion latency (see
+      InputChannelConnection::set_adaptive_window()). A lookahead allows
+      sending up to this number of following timeslices to other compute
+      nodes while the next one is blocked by its target. If pacing_rate is
+      set, the writes to each compute node are spaced to this rate (in
+      bytes per second, 0: the port rate) with bursts of up to pacing_burst
+      bytes (see InputChannelConnection::set_pacing()). If lifecycle is
+      set, the input buffer timestamps of each component are passed to the
+      compute nodes (see TimesliceLifecycle). */
   InputChannelSender(uint64_t input_index,
                      InputBufferReadInterface& data_source,
                      std::vector<std::string> compute_hostnames,
                      std::vector<std::string> compute_services,
-                     uint32_t timeslice_size,
+                     TimesliceSchedule schedule,
                      uint32_t overlap_size,
                      uint32_t max_timeslice_number,
-                     cbm::Monitor* monitor);
+                     PlacementPolicy placement_policy,
+                     uint32_t placement_epoch,
+                     cbm::Monitor* monitor,
+                     uint32_t signal_interval = 1,
+                     uint32_t post_batch = 1,
+                     uint32_t stripes = 1,
+                     std::chrono::microseconds status_interval =
+                         std::chrono::microseconds(0),
+                     uint32_t connect_quorum = 0,
+                     MemoryRegistration registration = {},
+                     bool adaptive_timeslice_size = false,
+                     uint32_t pull_reads = 0,
+                     std::optional<uint8_t> control_tos = {},
+                     bool adaptive_window = false,
+                     uint32_t lookahead = 0,
+                     std::optional<double> pacing_rate = {},
+                     double pacing_burst = 1 << 20,
+                     bool lifecycle = false);
 
   InputChannelSender(const InputChannelSender&) = delete;
   void operator=(const InputChannelSender&) = delete;
@@ -35,10 +73,14 @@ public:
   void report_status();
 
   void sync_buffer_positions();
-  void sync_data_source(bool schedule);
+  void sync_data_source();
 
   void operator()() override;
 
+  bool step() override;
+
+  [[nodiscard]] bool cooperative() const override { return true; }
+
   [[nodiscard]] std::string thread_name() const override {
     return "ICS/RDMA/i" + std::to_string(input_index_);
   };
@@ -46,16 +88,52 @@ public:
   /// The central function for distributing timeslice data.
   bool try_send_timeslice(uint64_t timeslice);
 
+  /// Descriptor and data ranges of a timeslice in the input buffer.
+  struct TimesliceRange {
+    uint64_t timeslice;
+    uint64_t desc_offset;
+    uint64_t desc_length;
+    uint64_t data_offset;
+    uint64_t data_end;
+    bool sent;
+    /// Lifecycle timestamps (with lifecycle tracking, else zero).
+    uint64_t first_available;
+    uint64_t last_available;
+  };
+
+  /// Determine the ranges of a timeslice if it is complete in the buffer.
+  bool assemble_timeslice(uint64_t timeslice, TimesliceRange& range);
+
+  /// Send an assembled timeslice if the target compute node is ready.
+  bool try_send_range(const TimesliceRange& range, int cn);
+
+  /// Assemble the next timeslices as their descriptors arrive and send
+  /// those whose target compute node is ready.
+  /** The timeslices of each compute node are still sent in order. */
+  bool send_lookahead();
+
   std::unique_ptr<InputChannelConnection>
   create_input_node_connection(uint_fast16_t index);
 
+  std::unique_ptr<StripeConnection>
+  create_stripe_connection(uint_fast16_t index, uint32_t stripe);
+
   /// Initiate connection requests to list of target hostnames.
   void connect();
 
+  /// Check whether all connections to a compute node are established.
+  [[nodiscard]] bool node_established(uint_fast16_t index) const;
+
+  /// Retrieve the number of compute nodes with established connections.
+  [[nodiscard]] uint32_t established_nodes() const;
+
 private:
   /// Return target computation node for given timeslice.
   int target_cn_index(uint64_t timeslice);
 
+  /// Pass placement credits received from a compute node to the placement.
+  void update_placement_credit(int cn);
+
   void dump_mr(struct ibv_mr* mr);
 
   void on_addr_resolved(struct rdma_cm_id* id) override;
@@ -73,11 +151,49 @@ private:
                       uint64_t desc_length,
                       uint64_t data_offset,
                       uint64_t data_length,
-                      uint64_t skip);
+                      uint64_t skip,
+                      const TimesliceLifecycle& lifecycle = {});
 
   /// Completion notification event dispatcher. Called by the event loop.
   void on_completion(const struct ibv_wc& wc) override;
 
+  /// Handle a batch of completions, releasing buffer space and applying
+  /// placement credits once for the whole batch.
+  void on_completions(const struct ibv_wc* wc, size_t count) override;
+
+  /// Update the acknowledged indices for a completed timeslice.
+  void on_timeslice_complete(uint64_t ts, int cn);
+
+  /// Pass the acknowledged indices on to the data source if due.
+  void release_acked();
+
+  /// Note that a compute node connection lacks credit to send.
+  /** Credit is a free write request and enough space in the compute node
+      buffer. The time until the next send is reported to the monitor. */
+  void wait_for_credit(int cn);
+
+  /// Note that a compute node connection has credit to send again.
+  void end_wait_for_credit(int cn);
+
+  /// Retrieve the fill level of the input buffer (0 to 1).
+  /** Only data that has already been sent is taken into account. */
+  [[nodiscard]] double buffer_fill() const;
+
+  /// Post queued writes, or request completions if nothing has been sent.
+  void flush_writes(bool sent);
+
+  /// Publish the buffer positions to the buffer status sampler.
+  void publish_buffer_status();
+
+  /// Pass the stripe connections of a compute node to its connection.
+  void attach_stripes(uint_fast16_t index);
+
+  /// Retry the connection to a compute node (after a rejection).
+  void reconnect(uint_fast16_t index, uint32_t stripe);
+
+  /// Report the connection setup time to the log and monitor.
+  void report_startup(const char* stage);
+
   uint64_t input_index_;
 
   /// InfiniBand memory region descriptor for input data buffer.
@@ -86,6 +202,9 @@ private:
   /// InfiniBand memory region descriptor for input descriptor buffer.
   struct ibv_mr* mr_desc_ = nullptr;
 
+  /// The accounting of the registered input buffers.
+  MemoryAccount registered_account_;
+
   /// Buffer to store acknowledged status of timeslices.
   RingBuffer<uint64_t, true> ack_;
 
@@ -107,12 +226,25 @@ private:
   const std::vector<std::string> compute_hostnames_;
   const std::vector<std::string> compute_services_;
 
-  const uint32_t timeslice_size_;
+  /// The timeslice sizes (in core microslices).
+  TimesliceSchedule schedule_;
+
+  /// Whether the timeslice size of each credit epoch is decided by the
+  /// sizes proposed by the compute nodes (see TimeslicePlacement).
+  const bool adaptive_timeslice_size_;
+
   const uint32_t overlap_size_;
   const uint32_t max_timeslice_number_;
 
-  const uint64_t min_acked_desc_;
-  const uint64_t min_acked_data_;
+  /// Coalescing of read index updates to the data source.
+  const AckCoalescing ack_coalescing_;
+
+  /// Number of read index updates, for statistics.
+  uint64_t read_index_updates_ = 0;
+
+  /// Number of status messages received, for statistics.
+  uint64_t previous_status_messages_ = 0;
+  uint64_t previous_read_index_updates_ = 0;
 
   uint64_t cached_acked_desc_;
   uint64_t cached_acked_data_;
@@ -121,12 +253,138 @@ private:
   uint64_t start_index_data_;
 
   uint64_t write_index_desc_ = 0;
+  uint64_t write_index_data_ = 0;
+
+  /// Time at which the first microslice of a timeslice was seen (with
+  /// lifecycle tracking).
+  uint64_t first_available_ = 0;
+  uint64_t first_available_timeslice_ = UINT64_MAX;
+
+  /// Timeslice-to-compute-node placement.
+  TimeslicePlacement placement_;
+
+  /// Signal only every n-th timeslice descriptor write.
+  const uint32_t signal_interval_;
+
+  /// Maximum number of timeslices posted with a single ibv_post_send().
+  const uint32_t post_batch_;
+
+  /// Number of queue pairs per compute node to divide the data between.
+  const uint32_t stripes_;
+
+  /// Maximum interval between status messages to a compute node.
+  const std::chrono::microseconds status_interval_;
+
+  /// Number of connected compute nodes required to start sending.
+  const uint32_t connect_quorum_;
+
+  /// Registration options of the input buffer.
+  const MemoryRegistration registration_;
+
+  /// Maximum number of components read by a compute node at the same time
+  /// (0: the data is written to the compute nodes).
+  const uint32_t pull_reads_;
+
+  /// Type of service of the control-only primary queue pairs (if any).
+  const std::optional<uint8_t> control_tos_;
+
+  /// Adapt the outstanding writes per compute node to its latency.
+  const bool adaptive_window_;
+
+  /// Maximum number of timeslices to send ahead of a blocked one.
+  const uint32_t lookahead_;
+
+  /// Pacing rate of the writes per compute node (if any, 0: port rate).
+  const std::optional<double> pacing_rate_;
+
+  /// Maximum burst size of the paced writes.
+  const double pacing_burst_;
+
+  /// Pass the lifecycle timestamps of the components to the compute nodes.
+  const bool lifecycle_;
+
+  /// Assembled timeslices from timeslice_ on (with a lookahead).
+  std::deque<TimesliceRange> lookahead_queue_;
+
+  /// Resolved addresses of the compute nodes.
+  std::vector<std::shared_ptr<struct addrinfo>> compute_addresses_;
+
+  /// Delay of the next connection retry per compute node.
+  std::vector<std::chrono::milliseconds> connect_backoff_;
+
+  /// Number of connection retries, for statistics.
+  uint64_t connect_retries_ = 0;
+
+  /// Start time of the connection setup.
+  std::chrono::steady_clock::time_point connect_begin_;
+
+  /// Additional connections (stripes - 1 per compute node).
+  std::vector<std::unique_ptr<StripeConnection>> stripe_conn_;
+
+  /// Scratch buffer for timeslices completed by a single completion.
+  std::vector<uint64_t> completed_timeslices_;
+
+  /// Whether the acknowledged indices advanced in the current batch.
+  bool acked_advanced_ = false;
+
+  /// Compute nodes whose placement credit changed in the current batch.
+  std::vector<int> credit_updates_;
 
   bool abort_ = false;
 
+  /// The progress phases of the worker (see step()).
+  enum class Phase {
+    Connect,
+    Connecting,
+    Sending,
+    Draining,
+    Finishing,
+    Disconnecting,
+    Done
+  };
+  Phase phase_ = Phase::Connect;
+
+  /// The phase last published to the status server.
+  Phase published_phase_ = Phase::Connect;
+
+  /// Publish the current phase to the status server.
+  void publish_phase();
+
+  /// The number of the next timeslice to send.
+  uint64_t timeslice_ = 0;
+
   cbm::Monitor* monitor_;
   std::string hostname_;
 
+  /// Per compute node transfer metrics reported to the monitor.
+  struct ConnectionMetrics {
+    cbm::MetricCounter timeslices;
+    cbm::MetricCounter desc_bytes;
+    cbm::MetricCounter data_bytes;
+    /// Time spent waiting for write requests or compute buffer space.
+    cbm::MetricCounter credit_wait_us;
+    /// Outstanding write requests (sampled by report_status()).
+    cbm::MetricGauge outstanding_wr;
+    /// Data rate since the previous report (sampled by report_status()).
+    cbm::MetricGauge data_rate;
+    /// Latency from posting a timeslice to its write completion (in us).
+    cbm::MetricHistogram write_latency;
+    /// Start of the current wait for credit, if any.
+    std::optional<std::chrono::steady_clock::time_point> waiting_since;
+    uint64_t sent_bytes = 0;
+    uint64_t previous_sent_bytes = 0;
+  };
+  std::vector<ConnectionMetrics> conn_metrics_;
+
+  /// Latency from posting a timeslice to its write completion (in us).
+  cbm::MetricHistogram write_latency_;
+
+  /// Post time of timeslices, indexed like ack_ (if write_latency_ is set).
+  RingBuffer<std::chrono::steady_clock::time_point> post_time_;
+
+  /// Buffer positions published for sampling (if a sampler exists).
+  std::shared_ptr<BufferStatusSource> buffer_status_;
+
   struct SendBufferStatus {
     std::chrono::system_clock::time_point time;
     uint64_t size = 0;
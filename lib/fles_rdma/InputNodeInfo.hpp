@@ -5,6 +5,9 @@
 
 struct InputNodeInfo {
   uint32_t index;
+  uint32_t stripe; ///< Stripe index (0: primary connection)
+  uint32_t overlap_size; ///< Number of overlap microslices per timeslice
+  uint32_t pull; ///< Nonzero if the data is read by the compute node
 };
 
 #pragma pack()
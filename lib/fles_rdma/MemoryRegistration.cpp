@@ -0,0 +1,102 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MemoryRegistration.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Check whether the device supports on-demand paging for RC connections.
+bool on_demand_supported(struct ibv_context* context, int access) {
+  struct ibv_device_attr_ex attr {};
+  if (ibv_query_device_ex(context, nullptr, &attr) != 0 ||
+      (attr.odp_caps.general_caps & IBV_ODP_SUPPORT) == 0) {
+    return false;
+  }
+  uint32_t required = IBV_ODP_SUPPORT_SEND | IBV_ODP_SUPPORT_RECV;
+  if ((access & IBV_ACCESS_REMOTE_WRITE) != 0) {
+    required |= IBV_ODP_SUPPORT_WRITE;
+  }
+  if ((access & IBV_ACCESS_REMOTE_READ) != 0) {
+    required |= IBV_ODP_SUPPORT_READ;
+  }
+  return (attr.odp_caps.per_transport_caps.rc_odp_caps & required) ==
+         required;
+}
+
+// Populate the (writable) page tables of a region in parallel chunks.
+void populate(void* addr, std::size_t length, unsigned threads) {
+#ifdef MADV_POPULATE_WRITE
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto begin = reinterpret_cast<std::uintptr_t>(addr) / page_size * page_size;
+  auto end = reinterpret_cast<std::uintptr_t>(addr) + length;
+  std::size_t pages = (end - begin + page_size - 1) / page_size;
+  threads = static_cast<unsigned>(std::min<std::size_t>(threads, pages));
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    std::uintptr_t chunk_begin = begin + pages * t / threads * page_size;
+    std::uintptr_t chunk_end = begin + pages * (t + 1) / threads * page_size;
+    workers.emplace_back([chunk_begin, chunk_end] {
+      // fails for memory that cannot be populated this way (e.g., device
+      // memory), which is then faulted in on registration
+      madvise(reinterpret_cast<void*>(chunk_begin), chunk_end - chunk_begin,
+              MADV_POPULATE_WRITE);
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+#else
+  (void)addr;
+  (void)length;
+  (void)threads;
+  L_(debug) << "register_memory: no MADV_POPULATE_WRITE support";
+#endif
+}
+
+} // namespace
+
+struct ibv_mr* register_memory(struct ibv_pd* pd,
+                               void* addr,
+                               std::size_t length,
+                               int access,
+                               const MemoryRegistration& options,
+                               const std::string& name) {
+  auto begin = std::chrono::steady_clock::now();
+
+  struct ibv_mr* mr = nullptr;
+  bool on_demand = false;
+  if (options.on_demand) {
+    if (on_demand_supported(pd->context, access)) {
+      mr = ibv_reg_mr(pd, addr, length, access | IBV_ACCESS_ON_DEMAND);
+      on_demand = mr != nullptr;
+    }
+    if (!on_demand) {
+      L_(warning) << name << ": on-demand paging not supported, pinning";
+    }
+  }
+  if (mr == nullptr) {
+    if (options.populate_threads > 0) {
+      populate(addr, length, options.populate_threads);
+    }
+    mr = ibv_reg_mr(pd, addr, length, access);
+  }
+
+  if (mr != nullptr) {
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    L_(info) << name << ": registered " << human_readable_count(length)
+             << (on_demand ? " on demand" : "") << " in " << seconds << " s";
+  }
+  return mr;
+}
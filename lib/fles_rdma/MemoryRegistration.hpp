@@ -0,0 +1,35 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the MemoryRegistration struct and register_memory().
+#pragma once
+
+#include <cstddef>
+#include <infiniband/verbs.h>
+#include <string>
+
+/// Registration options of large memory regions.
+struct MemoryRegistration {
+  /// Register with on-demand paging (ODP) where supported
+  bool on_demand = false;
+  /// Number of threads populating the page tables before pinning (0: none)
+  unsigned populate_threads = 0;
+};
+
+/**
+ * \brief Register a large memory region with given registration options.
+ *
+ * With on-demand paging, the pages are not pinned at registration, but
+ * faulted in by the device on access. If the device does not support it
+ * for RC connections, the region is pinned instead. Before pinning, the
+ * page tables of the region may be populated in parallel chunks, which
+ * does not modify its contents. The time taken is logged.
+ *
+ * @param name description of the region for the log
+ * @return the memory region, or nullptr on failure (see errno)
+ */
+struct ibv_mr* register_memory(struct ibv_pd* pd,
+                               void* addr,
+                               std::size_t length,
+                               int access,
+                               const MemoryRegistration& options,
+                               const std::string& name);
@@ -0,0 +1,28 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "TimesliceComponentDescriptor.hpp"
+#include <cstdint>
+
+#pragma pack(1)
+
+/// A contiguous part of a timeslice component in the input buffer.
+struct PullSegment {
+  uint64_t addr;   ///< Source memory address
+  uint32_t length; ///< Number of bytes
+  uint32_t rkey;   ///< Source remote access key
+};
+
+/// Structure announcing a timeslice component to be read by the compute node.
+/** In pull mode, an input channel writes a pull request to the compute node
+    instead of the component data. The segments (microslice descriptors,
+    then content, each in up to two chunks) are read to the target position
+    given by the component descriptor, which the compute node then stores
+    itself. */
+struct PullRequest {
+  fles::TimesliceComponentDescriptor desc;
+  uint32_t num_segments;
+  PullSegment segment[4];
+};
+
+#pragma pack()
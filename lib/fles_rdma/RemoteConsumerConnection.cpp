@@ -0,0 +1,178 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RemoteConsumerConnection.hpp"
+#include "RequestIdentifier.hpp"
+#include "TimesliceShmWorkItem.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+RemoteConsumerConnection::RemoteConsumerConnection(
+    struct rdma_event_channel* ec,
+    uint_fast16_t connection_index,
+    struct rdma_cm_id* id,
+    const std::string& distributor_address,
+    const RemoteConsumerRequest& request,
+    BufferInfo data,
+    const fles::TimesliceComponentDescriptor* desc_ptr,
+    uint32_t num_components)
+    : IBConnection(ec, connection_index, connection_index, id),
+      client_name_(request.client_name,
+                   strnlen(request.client_name, sizeof(request.client_name))),
+      data_(data), desc_ptr_(desc_ptr), num_components_(num_components),
+      window_(std::max<uint32_t>(request.window, 1)),
+      item_size_(remote_work_item_size(num_components)), outstanding_(window_),
+      items_(window_) {
+  assert(request.stride != 0 && request.offset < request.stride);
+
+  // the consumer reads up to one component per item at the same time
+  connector_read_depth_ =
+      static_cast<uint8_t>(std::min(window_, max_read_depth));
+
+  qp_cap_.max_send_wr = window_ + 1;
+  qp_cap_.max_send_sge = 1;
+  qp_cap_.max_recv_wr = window_;
+  qp_cap_.max_recv_sge = 1;
+
+  send_buffer_.resize(window_ * item_size_);
+  recv_buffer_.resize(window_);
+
+  WorkerParameters parameters{request.stride, request.offset,
+                              WorkerQueuePolicy::QueueAll, client_name_};
+  parameters.prefetch = window_;
+  worker_ = std::make_unique<ItemWorker>(distributor_address, parameters);
+  worker_->set_disconnect_callback([this] {
+    L_(warning) << "[r" << index_ << "] " << client_name_
+                << ": connection to item distributor lost";
+  });
+}
+
+RemoteConsumerConnection::~RemoteConsumerConnection() {
+  if (mr_recv_ != nullptr) {
+    ibv_dereg_mr(mr_recv_);
+    mr_recv_ = nullptr;
+  }
+  if (mr_send_ != nullptr) {
+    ibv_dereg_mr(mr_send_);
+    mr_send_ = nullptr;
+  }
+}
+
+bool RemoteConsumerConnection::forward_items() {
+  if (!ready_ || done_) {
+    return false;
+  }
+  bool forwarded = false;
+  // also sends the completions of the items released so far
+  while (!outstanding_.full()) {
+    auto item = worker_->try_get();
+    if (!item) {
+      break;
+    }
+    auto shm_item = fles::TimesliceShmWorkItem::decode(item->payload());
+    assert(shm_item.ts_desc.num_components == shm_item.data.size());
+    if (shm_item.data_device >= 0 ||
+        shm_item.ts_desc.num_components > num_components_) {
+      throw InfinibandException("work item not accessible remotely");
+    }
+
+    std::vector<RemoteComponent> components;
+    for (size_t c = 0; c < shm_item.data.size(); ++c) {
+      components.push_back({shm_item.data[c], desc_ptr_[shm_item.desc[c]]});
+    }
+    uint32_t buffer = outstanding_.acquire(item->id());
+    encode_remote_work_item(&send_buffer_[buffer * item_size_],
+                            {item->id(), shm_item.ts_desc}, components);
+    items_[buffer] = std::move(item);
+    post_send_item(buffer);
+    forwarded = true;
+  }
+  return forwarded;
+}
+
+void RemoteConsumerConnection::on_complete_recv(uint32_t buffer) {
+  uint64_t id = recv_buffer_.at(buffer).id;
+  post_recv_completion(buffer);
+
+  if (id == remote_consumer_ready) {
+    L_(info) << "[r" << index_ << "] remote consumer " << client_name_
+             << " ready";
+    ready_ = true;
+    return;
+  }
+  uint32_t released = 0;
+  if (!outstanding_.release(id, released)) {
+    L_(error) << "[r" << index_ << "] " << client_name_
+              << ": completion of unknown item " << id;
+    return;
+  }
+  // the completion is passed on with the next call of forward_items()
+  items_[released] = nullptr;
+}
+
+void RemoteConsumerConnection::post_recv_completion(uint32_t buffer) {
+  ibv_sge sge{};
+  sge.addr = reinterpret_cast<uintptr_t>(&recv_buffer_.at(buffer));
+  sge.length = sizeof(RemoteCompletion);
+  sge.lkey = mr_recv_->lkey;
+
+  ibv_recv_wr wr{};
+  wr.wr_id = ID_RECEIVE_COMPLETION | (index_ << 8) |
+             (static_cast<uint64_t>(buffer) << 24);
+  wr.sg_list = &sge;
+  wr.num_sge = 1;
+  post_recv(&wr);
+}
+
+void RemoteConsumerConnection::post_send_item(uint32_t buffer) {
+  ibv_sge sge{};
+  sge.addr = reinterpret_cast<uintptr_t>(&send_buffer_[buffer * item_size_]);
+  sge.length = static_cast<uint32_t>(item_size_);
+  sge.lkey = mr_send_->lkey;
+
+  ibv_send_wr wr{};
+  wr.wr_id = ID_SEND_ITEM | (index_ << 8);
+  wr.opcode = IBV_WR_SEND;
+  wr.send_flags = IBV_SEND_SIGNALED;
+  wr.sg_list = &sge;
+  wr.num_sge = 1;
+  post_send(&wr);
+}
+
+void RemoteConsumerConnection::setup(struct ibv_pd* pd) {
+  mr_send_ = ibv_reg_mr(pd, send_buffer_.data(), send_buffer_.size(), 0);
+  mr_recv_ = ibv_reg_mr(pd, recv_buffer_.data(),
+                        recv_buffer_.size() * sizeof(RemoteCompletion),
+                        IBV_ACCESS_LOCAL_WRITE);
+  if (mr_send_ == nullptr || mr_recv_ == nullptr) {
+    throw InfinibandException("registration of memory region failed");
+  }
+
+  // the receives are posted before accepting the connection
+  for (uint32_t i = 0; i < window_; ++i) {
+    post_recv_completion(i);
+  }
+}
+
+void RemoteConsumerConnection::on_disconnected(struct rdma_cm_event* event) {
+  L_(info) << "[r" << index_ << "] remote consumer " << client_name_
+           << " disconnected (" << outstanding_.outstanding()
+           << " items outstanding)";
+  // the distributor releases the outstanding items as the worker
+  // disconnects
+  outstanding_.clear();
+  items_.clear();
+  worker_ = nullptr;
+  done_ = true;
+  IBConnection::on_disconnected(event);
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+RemoteConsumerConnection::get_private_data() {
+  RemoteConsumerInfo info{data_, num_components_, window_};
+  auto private_data = std::make_unique<std::vector<uint8_t>>(
+      reinterpret_cast<uint8_t*>(&info),
+      reinterpret_cast<uint8_t*>(&info) + sizeof(info));
+  return private_data;
+}
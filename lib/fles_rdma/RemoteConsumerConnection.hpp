@@ -0,0 +1,105 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "IBConnection.hpp"
+#include "ItemWorker.hpp"
+#include "RemoteConsumerProtocol.hpp"
+#include "RemoteItemWindow.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Remote consumer connection class.
+/** A RemoteConsumerConnection object represents the endpoint of a
+    connection from a remote consumer to a timeslice buffer. It registers
+    as a worker with the item distributor of the buffer on behalf of the
+    consumer and forwards the work items, along with the component
+    descriptors, over the connection. The consumer reads the components
+    from the data region and sends the completions back. */
+
+class RemoteConsumerConnection : public IBConnection {
+public:
+  /// The RemoteConsumerConnection constructor.
+  /**
+     \param distributor_address Worker address of the item distributor
+     \param request             Registration sent by the consumer
+     \param data                Data region of the timeslice buffer
+     \param desc_ptr            Descriptor region of the timeslice buffer
+     \param num_components      Number of components per timeslice
+  */
+  RemoteConsumerConnection(struct rdma_event_channel* ec,
+                           uint_fast16_t connection_index,
+                           struct rdma_cm_id* id,
+                           const std::string& distributor_address,
+                           const RemoteConsumerRequest& request,
+                           BufferInfo data,
+                           const fles::TimesliceComponentDescriptor* desc_ptr,
+                           uint32_t num_components);
+
+  RemoteConsumerConnection(const RemoteConsumerConnection&) = delete;
+  void operator=(const RemoteConsumerConnection&) = delete;
+
+  ~RemoteConsumerConnection() override;
+
+  /// Forward the available work items while the window is not full.
+  /** Returns true if any item has been forwarded. */
+  bool forward_items();
+
+  /// Handle the receive completion of a given receive buffer.
+  void on_complete_recv(uint32_t buffer);
+
+  void setup(struct ibv_pd* pd) override;
+
+  void on_disconnected(struct rdma_cm_event* event) override;
+
+  std::unique_ptr<std::vector<uint8_t>> get_private_data() override;
+
+  /// Retrieve the name of the consumer.
+  [[nodiscard]] const std::string& client_name() const {
+    return client_name_;
+  }
+
+private:
+  /// Post a receive work request for a given receive buffer.
+  void post_recv_completion(uint32_t buffer);
+
+  /// Send the work item in a given send buffer.
+  void post_send_item(uint32_t buffer);
+
+  std::string client_name_;
+
+  /// Access information for the data region of the timeslice buffer.
+  BufferInfo data_;
+
+  /// The descriptor region of the timeslice buffer.
+  const fles::TimesliceComponentDescriptor* desc_ptr_;
+
+  const uint32_t num_components_;
+
+  /// Maximum number of outstanding items.
+  const uint32_t window_;
+
+  /// Size of a work item message.
+  const std::size_t item_size_;
+
+  /// Flag, true once the consumer has posted its receive buffers.
+  bool ready_ = false;
+
+  /// The worker registered with the item distributor.
+  std::unique_ptr<ItemWorker> worker_;
+
+  /// Send buffers, one work item message per outstanding item.
+  std::vector<uint8_t> send_buffer_;
+
+  /// Receive buffers for completion messages.
+  std::vector<RemoteCompletion> recv_buffer_;
+
+  /// Outstanding items and their send buffers.
+  RemoteItemWindow outstanding_;
+
+  /// Outstanding items, indexed by send buffer.
+  std::vector<std::shared_ptr<const Item>> items_;
+
+  ibv_mr* mr_send_ = nullptr;
+  ibv_mr* mr_recv_ = nullptr;
+};
@@ -0,0 +1,110 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "ComputeNodeInfo.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#pragma pack(1)
+
+/// Registration of a remote consumer, sent with its connection request.
+/** The consumer receives every item with sequence number n for which exists
+    m in N: n = m * stride + offset (see WorkerParameters). At most window
+    items are outstanding at the same time. */
+struct RemoteConsumerRequest {
+  uint32_t stride;
+  uint32_t offset;
+  uint32_t window;
+  char client_name[32];
+};
+
+/// Access information for a timeslice buffer, sent on acceptance.
+struct RemoteConsumerInfo {
+  BufferInfo data;         ///< Data region of all components
+  uint32_t num_components; ///< Number of components per timeslice
+  uint32_t window;         ///< Maximum number of outstanding items
+};
+
+/// A timeslice component announced to a remote consumer.
+struct RemoteComponent {
+  uint64_t offset; ///< Offset of the data block in the data region
+  fles::TimesliceComponentDescriptor desc;
+};
+
+/// A work item announced to a remote consumer.
+/** The item is followed by num_components RemoteComponent structs. */
+struct RemoteWorkItem {
+  uint64_t id;
+  fles::TimesliceDescriptor ts_desc;
+};
+
+/// Completion of a work item, sent by a remote consumer.
+/** The first message after connecting has the id remote_consumer_ready. It
+    announces that the receive buffers for the work items are posted. */
+struct RemoteCompletion {
+  uint64_t id;
+};
+
+#pragma pack()
+
+/// Completion id announcing a ready remote consumer.
+constexpr uint64_t remote_consumer_ready = UINT64_MAX;
+
+/// Retrieve the message size of a work item with given number of components.
+inline std::size_t remote_work_item_size(uint32_t num_components) {
+  return sizeof(RemoteWorkItem) + num_components * sizeof(RemoteComponent);
+}
+
+/// Write a work item message (of remote_work_item_size() bytes) to a buffer.
+inline void encode_remote_work_item(
+    uint8_t* buffer,
+    const RemoteWorkItem& item,
+    const std::vector<RemoteComponent>& components) {
+  std::memcpy(buffer, &item, sizeof(item));
+  buffer += sizeof(item);
+  for (const auto& component : components) {
+    std::memcpy(buffer, &component, sizeof(component));
+    buffer += sizeof(component);
+  }
+}
+
+/// Read a work item message from a buffer.
+/** Throws std::runtime_error if the item has more than max_components
+    components. */
+inline RemoteWorkItem
+decode_remote_work_item(const uint8_t* buffer,
+                        uint32_t max_components,
+                        std::vector<RemoteComponent>& components) {
+  RemoteWorkItem item{};
+  std::memcpy(&item, buffer, sizeof(item));
+  buffer += sizeof(item);
+  if (item.ts_desc.num_components > max_components) {
+    throw std::runtime_error("remote work item has too many components");
+  }
+  components.resize(item.ts_desc.num_components);
+  for (auto& component : components) {
+    std::memcpy(&component, buffer, sizeof(component));
+    buffer += sizeof(component);
+  }
+  return item;
+}
+
+/// Lay out the components of a work item in a local slot.
+/** The components are placed back to back, aligned to 8 bytes.
+    eturn the size of the slot contents (in bytes) */
+inline uint64_t
+remote_slot_layout(const std::vector<RemoteComponent>& components,
+                   std::vector<uint64_t>& offsets) {
+  uint64_t size = 0;
+  offsets.clear();
+  for (const auto& component : components) {
+    offsets.push_back(size);
+    size += (component.desc.size + 7) & ~uint64_t(7);
+  }
+  return size;
+}
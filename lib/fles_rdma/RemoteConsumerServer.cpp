@@ -0,0 +1,144 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RemoteConsumerServer.hpp"
+#include "MemoryPlacement.hpp"
+#include "MemoryRegistration.hpp"
+#include "RequestIdentifier.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+RemoteConsumerServer::RemoteConsumerServer(uint64_t index,
+                                           TimesliceBuffer& timeslice_buffer,
+                                           std::string distributor_address,
+                                           unsigned short port,
+                                           unsigned int max_consumers)
+    : index_(index), timeslice_buffer_(timeslice_buffer),
+      distributor_address_(std::move(distributor_address)), port_(port),
+      max_consumers_(max_consumers) {
+  if (timeslice_buffer_.get_device_data() != nullptr) {
+    throw InfinibandException(
+        "remote consumers require a timeslice buffer in host memory");
+  }
+}
+
+RemoteConsumerServer::~RemoteConsumerServer() {
+  if (mr_data_ != nullptr) {
+    ibv_dereg_mr(mr_data_);
+    mr_data_ = nullptr;
+  }
+}
+
+void RemoteConsumerServer::operator()() {
+  accept(port_, max_consumers_);
+  L_(info) << "[r" << index_ << "] accepting remote consumers on port "
+           << port_;
+  time_begin_ = std::chrono::high_resolution_clock::now();
+
+  while (!stopped_) {
+    poll_cm_events();
+    bool busy = poll_completion() > 0;
+    for (auto& c : conn_) {
+      if (c && c->forward_items()) {
+        busy = true;
+      }
+    }
+    if (!busy) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+
+  for (auto& c : conn_) {
+    if (c && c->established() && !c->done()) {
+      c->disconnect();
+    }
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while ((connected_ > 0 || timewait_ > 0) &&
+         std::chrono::steady_clock::now() < deadline) {
+    poll_cm_events();
+    poll_completion();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  time_end_ = std::chrono::high_resolution_clock::now();
+}
+
+void RemoteConsumerServer::register_data() {
+  const uint32_t num_components = timeslice_buffer_.get_num_input_nodes();
+  std::size_t data_bytes = static_cast<std::size_t>(num_components)
+                           << timeslice_buffer_.get_data_size_exp();
+  mr_data_ = register_memory(pd_, timeslice_buffer_.get_data_ptr(0),
+                             data_bytes, IBV_ACCESS_REMOTE_READ, {},
+                             "[r" + std::to_string(index_) + "] data buffer");
+  if (mr_data_ == nullptr) {
+    throw InfinibandException("registration of memory region failed");
+  }
+  registered_account_ =
+      MemoryAccount("rdma_remote_consumer", MemoryUse::Registered,
+                    data_bytes, numa_node_of_memory(mr_data_->addr));
+}
+
+void RemoteConsumerServer::on_connect_request(struct rdma_cm_event* event) {
+  if (pd_ == nullptr) {
+    init_context(event->id->verbs);
+    register_data();
+  }
+
+  RemoteConsumerRequest request{};
+  auto free_slot = std::find(conn_.begin(), conn_.end(), nullptr);
+  bool valid = event->param.conn.private_data_len >= sizeof(request);
+  if (valid) {
+    std::memcpy(&request, event->param.conn.private_data, sizeof(request));
+    valid = request.stride != 0 && request.offset < request.stride &&
+            request.client_name[0] != '\0';
+  }
+  if (free_slot == conn_.end() || !valid) {
+    L_(warning) << "[r" << index_ << "] remote consumer rejected ("
+                << (valid ? "too many consumers" : "invalid registration")
+                << ")";
+    rdma_reject(event->id, nullptr, 0);
+    rdma_destroy_id(event->id);
+    return;
+  }
+
+  auto index = static_cast<uint_fast16_t>(free_slot - conn_.begin());
+  *free_slot = std::make_unique<RemoteConsumerConnection>(
+      ec_, index, event->id, distributor_address_, request,
+      BufferInfo{reinterpret_cast<uintptr_t>(mr_data_->addr), mr_data_->rkey},
+      timeslice_buffer_.get_desc_ptr(0),
+      timeslice_buffer_.get_num_input_nodes());
+  L_(info) << "[r" << index_ << "] remote consumer "
+           << (*free_slot)->client_name() << " connecting (stride "
+           << request.stride << ", offset " << request.offset << ")";
+  (*free_slot)->on_connect_request(event, pd_, cq_);
+}
+
+void RemoteConsumerServer::on_timewait_exit(struct rdma_cm_event* event) {
+  IBConnectionGroup<RemoteConsumerConnection>::on_timewait_exit(event);
+  // the slot is free for the next consumer
+  auto* conn = static_cast<RemoteConsumerConnection*>(event->id->context);
+  conn_.at(conn->index()) = nullptr;
+}
+
+void RemoteConsumerServer::on_completion(const struct ibv_wc& wc) {
+  size_t in = (wc.wr_id >> 8) & 0xFFFF;
+  auto buffer = static_cast<uint32_t>(wc.wr_id >> 24);
+  switch (wc.wr_id & 0xFF) {
+  case ID_SEND_ITEM:
+    break;
+
+  case ID_RECEIVE_COMPLETION:
+    if (in < conn_.size() && conn_[in]) {
+      conn_[in]->on_complete_recv(buffer);
+    }
+    break;
+
+  default:
+    L_(error) << "[r" << index_ << "] "
+              << "wc for unknown wr_id=" << (wc.wr_id & 0xFF);
+    throw InfinibandException("wc for unknown wr_id");
+  }
+}
@@ -0,0 +1,82 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "IBConnectionGroup.hpp"
+#include "MemoryAccounting.hpp"
+#include "RemoteConsumerConnection.hpp"
+#include "TimesliceBuffer.hpp"
+#include <atomic>
+#include <string>
+
+/// Remote consumer service of a timeslice buffer.
+/** A RemoteConsumerServer object accepts connections from consumers on
+    other hosts (see RemoteTimesliceReceiver). Each of them is registered
+    with the item distributor of the timeslice buffer and reads the
+    timeslice components directly from the registered data region, without
+    involving the CPU of this host in the transfer.
+
+    The timeslice buffer has to be located in host memory. As the consumers
+    read the buffer asynchronously, it should not be combined with the
+    eviction of timeslices. */
+
+class RemoteConsumerServer
+    : public IBConnectionGroup<RemoteConsumerConnection> {
+public:
+  /// The RemoteConsumerServer constructor.
+  /**
+     \param index               Index of the timeslice buffer (for the log)
+     \param timeslice_buffer    The timeslice buffer to serve
+     \param distributor_address Worker address of its item distributor
+     \param port                Port to accept consumer connections on
+     \param max_consumers       Maximum number of connected consumers
+  */
+  RemoteConsumerServer(uint64_t index,
+                       TimesliceBuffer& timeslice_buffer,
+                       std::string distributor_address,
+                       unsigned short port,
+                       unsigned int max_consumers);
+
+  RemoteConsumerServer(const RemoteConsumerServer&) = delete;
+  void operator=(const RemoteConsumerServer&) = delete;
+
+  ~RemoteConsumerServer() override;
+
+  /// The thread main function, runs until stopped.
+  void operator()() override;
+
+  /// Stop the service, disconnecting all consumers (thread-safe).
+  void stop() { stopped_ = true; }
+
+  [[nodiscard]] std::string thread_name() const override {
+    return "RCS/o" + std::to_string(index_);
+  };
+
+private:
+  void on_connect_request(struct rdma_cm_event* event) override;
+
+  void on_timewait_exit(struct rdma_cm_event* event) override;
+
+  /// Completion notification event dispatcher. Called by the event loop.
+  void on_completion(const struct ibv_wc& wc) override;
+
+  /// Register the data region of the timeslice buffer.
+  void register_data();
+
+  uint64_t index_;
+
+  TimesliceBuffer& timeslice_buffer_;
+
+  const std::string distributor_address_;
+
+  const unsigned short port_;
+
+  const unsigned int max_consumers_;
+
+  /// InfiniBand memory region descriptor for the data region.
+  struct ibv_mr* mr_data_ = nullptr;
+
+  /// The accounting of the registered data region.
+  MemoryAccount registered_account_;
+
+  std::atomic<bool> stopped_{false};
+};
@@ -0,0 +1,68 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Window of outstanding items of a remote consumer connection.
+/** Each outstanding item holds one of a fixed number of buffers (a send
+    buffer on the server side, a slot on the consumer side) until its
+    completion. The buffer of a completed item is handed out next. */
+class RemoteItemWindow {
+public:
+  explicit RemoteItemWindow(uint32_t size = 0) : size_(size) {
+    for (uint32_t i = size; i > 0; --i) {
+      free_.push_back(i - 1);
+    }
+  }
+
+  /// Retrieve the maximum number of outstanding items.
+  [[nodiscard]] uint32_t size() const { return size_; }
+
+  /// Retrieve the number of outstanding items.
+  [[nodiscard]] std::size_t outstanding() const {
+    return outstanding_.size();
+  }
+
+  /// Flag, true if no buffer is available.
+  [[nodiscard]] bool full() const { return free_.empty(); }
+
+  /// Assign a free buffer to a new outstanding item.
+  /** \return the index of the buffer */
+  uint32_t acquire(uint64_t id) {
+    assert(!full());
+    uint32_t buffer = free_.back();
+    if (!outstanding_.emplace(id, buffer).second) {
+      throw std::runtime_error("item " + std::to_string(id) +
+                               " already outstanding");
+    }
+    free_.pop_back();
+    return buffer;
+  }
+
+  /// Release the buffer of a completed item.
+  /** \return false if the item is not outstanding */
+  bool release(uint64_t id, uint32_t& buffer) {
+    auto it = outstanding_.find(id);
+    if (it == outstanding_.end()) {
+      return false;
+    }
+    buffer = it->second;
+    free_.push_back(buffer);
+    outstanding_.erase(it);
+    return true;
+  }
+
+  /// Release all outstanding items.
+  void clear() { *this = RemoteItemWindow(size_); }
+
+private:
+  uint32_t size_;
+  std::vector<uint32_t> free_;
+  std::map<uint64_t, uint32_t> outstanding_;
+};
@@ -0,0 +1,240 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RemoteReceiverConnection.hpp"
+#include "RequestIdentifier.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+RemoteReceiverConnection::RemoteReceiverConnection(
+    struct rdma_event_channel* ec,
+    const RemoteConsumerRequest& request,
+    std::size_t slot_size)
+    : IBConnection(ec, 0, 0), request_(request), slot_size_(slot_size),
+      window_(std::max<uint32_t>(request.window, 1)) {
+  request_.window = window_;
+  connector_read_depth_ =
+      static_cast<uint8_t>(std::min(window_, max_read_depth));
+
+  qp_cap_.max_send_wr = send_queue_depth;
+  qp_cap_.max_send_sge = 1;
+  qp_cap_.max_recv_wr = window_;
+  qp_cap_.max_recv_sge = 1;
+
+  slots_.resize(window_ * slot_size_);
+  send_buffer_.resize(window_ + 1);
+}
+
+RemoteReceiverConnection::~RemoteReceiverConnection() {
+  for (auto* mr : {mr_slots_, mr_recv_, mr_send_}) {
+    if (mr != nullptr) {
+      ibv_dereg_mr(mr);
+    }
+  }
+}
+
+std::unique_ptr<RemoteReceiverConnection::Timeslice>
+RemoteReceiverConnection::try_get() {
+  if (ready_.empty()) {
+    return nullptr;
+  }
+  auto ts = std::make_unique<Timeslice>(std::move(ready_.front()));
+  ready_.pop_front();
+  return ts;
+}
+
+void RemoteReceiverConnection::complete(uint64_t id) {
+  uint32_t slot = 0;
+  if (!slot_window_.release(id, slot)) {
+    L_(error) << "completion of unknown item " << id;
+    return;
+  }
+  if (!done_) {
+    post_send_completion(id, slot);
+  }
+  start_reads();
+}
+
+void RemoteReceiverConnection::on_complete_recv(uint32_t buffer) {
+  std::vector<RemoteComponent> components;
+  RemoteWorkItem wi = decode_remote_work_item(
+      &recv_buffer_.at(buffer * item_size_), num_components_, components);
+
+  Timeslice ts{wi.id, 0, wi.ts_desc, {}, {}, {}};
+  for (const auto& rc : components) {
+    ts.desc.push_back(rc.desc);
+    ts.remote_offset.push_back(rc.offset);
+  }
+  uint64_t size = remote_slot_layout(components, ts.offset);
+  if (size > slot_size_) {
+    throw std::runtime_error("timeslice " + std::to_string(ts.ts_desc.index) +
+                             " exceeds the maximum size (" +
+                             std::to_string(size) + " bytes)");
+  }
+  post_recv_item(buffer);
+
+  pending_.push_back(std::move(ts));
+  start_reads();
+}
+
+void RemoteReceiverConnection::start_reads() {
+  while (!pending_.empty() && !slot_window_.full() && !done_) {
+    Timeslice& ts = pending_.front();
+    const auto num_components = static_cast<uint32_t>(ts.desc.size());
+    if (send_queue_used_ + num_components > send_queue_depth) {
+      return;
+    }
+    ts.slot = slot_window_.acquire(ts.id);
+
+    ibv_send_wr* last = nullptr;
+    std::vector<ibv_sge> sge(num_components);
+    std::vector<ibv_send_wr> wr(num_components);
+    for (uint32_t c = 0; c < num_components; ++c) {
+      if (ts.desc[c].size == 0) {
+        continue;
+      }
+      sge[c].addr =
+          reinterpret_cast<uintptr_t>(slot_data(ts.slot) + ts.offset[c]);
+      sge[c].length = static_cast<uint32_t>(ts.desc[c].size);
+      sge[c].lkey = mr_slots_->lkey;
+      wr[c].wr_id = ID_READ_DATA | (static_cast<uint64_t>(ts.slot) << 8);
+      wr[c].opcode = IBV_WR_RDMA_READ;
+      wr[c].sg_list = &sge[c];
+      wr[c].num_sge = 1;
+      wr[c].wr.rdma.remote_addr = data_.addr + ts.remote_offset[c];
+      wr[c].wr.rdma.rkey = data_.rkey;
+      if (last != nullptr) {
+        last->next = &wr[c];
+      }
+      last = &wr[c];
+      ++send_queue_used_;
+    }
+    uint32_t slot = ts.slot;
+    reading_.emplace(slot, std::move(ts));
+    pending_.pop_front();
+
+    if (last == nullptr) {
+      // nothing to read
+      on_complete_read(slot);
+      continue;
+    }
+    // only the last read is signaled, the reads complete in order
+    last->send_flags = IBV_SEND_SIGNALED;
+    auto first = std::find_if(wr.begin(), wr.end(),
+                              [](const ibv_send_wr& w) { return w.num_sge; });
+    post_send(&*first);
+  }
+}
+
+void RemoteReceiverConnection::on_complete_read(uint32_t slot) {
+  auto it = reading_.find(slot);
+  if (it == reading_.end()) {
+    L_(error) << "read completion for unknown slot " << slot;
+    return;
+  }
+  for (const auto& desc : it->second.desc) {
+    if (desc.size != 0) {
+      --send_queue_used_;
+    }
+  }
+  ready_.push_back(std::move(it->second));
+  reading_.erase(it);
+}
+
+void RemoteReceiverConnection::post_recv_item(uint32_t buffer) {
+  ibv_sge sge{};
+  sge.addr = reinterpret_cast<uintptr_t>(&recv_buffer_[buffer * item_size_]);
+  sge.length = static_cast<uint32_t>(item_size_);
+  sge.lkey = mr_recv_->lkey;
+
+  ibv_recv_wr wr{};
+  wr.wr_id = ID_RECEIVE_ITEM | (static_cast<uint64_t>(buffer) << 24);
+  wr.sg_list = &sge;
+  wr.num_sge = 1;
+  post_recv(&wr);
+}
+
+void RemoteReceiverConnection::post_send_completion(uint64_t id,
+                                                    uint32_t buffer) {
+  send_buffer_.at(buffer).id = id;
+
+  ibv_sge sge{};
+  sge.addr = reinterpret_cast<uintptr_t>(&send_buffer_[buffer]);
+  sge.length = sizeof(RemoteCompletion);
+  sge.lkey = mr_send_->lkey;
+
+  ibv_send_wr wr{};
+  wr.wr_id = ID_SEND_COMPLETION;
+  wr.opcode = IBV_WR_SEND;
+  wr.send_flags = IBV_SEND_SIGNALED | inline_flag(sizeof(RemoteCompletion));
+  wr.sg_list = &sge;
+  wr.num_sge = 1;
+  ++send_queue_used_;
+  post_send(&wr);
+}
+
+void RemoteReceiverConnection::on_established(struct rdma_cm_event* event) {
+  RemoteConsumerInfo server_info{};
+  if (event->param.conn.private_data_len < sizeof(server_info)) {
+    throw InfinibandException("invalid private data on connection");
+  }
+  std::memcpy(&server_info, event->param.conn.private_data,
+              sizeof(server_info));
+  data_ = server_info.data;
+  num_components_ = server_info.num_components;
+  window_ = std::min(window_, server_info.window);
+  item_size_ = remote_work_item_size(num_components_);
+
+  slot_window_ = RemoteItemWindow(window_);
+  recv_buffer_.resize(window_ * item_size_);
+  mr_recv_ = ibv_reg_mr(pd_, recv_buffer_.data(), recv_buffer_.size(),
+                        IBV_ACCESS_LOCAL_WRITE);
+  if (mr_recv_ == nullptr) {
+    throw InfinibandException("registration of memory region failed");
+  }
+  for (uint32_t i = 0; i < window_; ++i) {
+    post_recv_item(i);
+  }
+
+  IBConnection::on_established(event);
+  L_(info) << "connected to remote timeslice buffer (" << num_components_
+           << " components, window " << window_ << ")";
+
+  // the server starts sending items on this message
+  post_send_completion(remote_consumer_ready, window_);
+}
+
+void RemoteReceiverConnection::on_disconnected(struct rdma_cm_event* event) {
+  L_(info) << "remote timeslice buffer disconnected";
+  pending_.clear();
+  reading_.clear();
+  done_ = true;
+  IBConnection::on_disconnected(event);
+}
+
+void RemoteReceiverConnection::on_rejected(struct rdma_cm_event* event) {
+  L_(error) << "remote timeslice buffer rejected the connection";
+  rejected_ = true;
+  done_ = true;
+  IBConnection::on_rejected(event);
+}
+
+void RemoteReceiverConnection::setup(struct ibv_pd* pd) {
+  pd_ = pd;
+  mr_slots_ = ibv_reg_mr(pd, slots_.data(), slots_.size(),
+                         IBV_ACCESS_LOCAL_WRITE);
+  mr_send_ = ibv_reg_mr(pd, send_buffer_.data(),
+                        send_buffer_.size() * sizeof(RemoteCompletion), 0);
+  if (mr_slots_ == nullptr || mr_send_ == nullptr) {
+    throw InfinibandException("registration of memory region failed");
+  }
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+RemoteReceiverConnection::get_private_data() {
+  auto private_data = std::make_unique<std::vector<uint8_t>>(
+      reinterpret_cast<uint8_t*>(&request_),
+      reinterpret_cast<uint8_t*>(&request_) + sizeof(request_));
+  return private_data;
+}
@@ -0,0 +1,138 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "IBConnection.hpp"
+#include "RemoteConsumerProtocol.hpp"
+#include "RemoteItemWindow.hpp"
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Remote receiver connection class.
+/** A RemoteReceiverConnection object represents the consumer end of a
+    connection to a RemoteConsumerServer. It receives the announced work
+    items, reads their components into a local slot of fixed size with RDMA
+    READ operations, and sends the completions of the consumed items back.
+*/
+
+class RemoteReceiverConnection : public IBConnection {
+public:
+  /// A timeslice announced by the server.
+  struct Timeslice {
+    uint64_t id;
+    uint32_t slot;
+    fles::TimesliceDescriptor ts_desc;
+    std::vector<fles::TimesliceComponentDescriptor> desc;
+    std::vector<uint64_t> offset;        ///< Data offsets within the slot
+    std::vector<uint64_t> remote_offset; ///< Offsets in the data region
+  };
+
+  /// The RemoteReceiverConnection constructor.
+  /**
+     \param request   Registration to send with the connection request
+     \param slot_size Maximum size of a timeslice (in bytes)
+  */
+  RemoteReceiverConnection(struct rdma_event_channel* ec,
+                           const RemoteConsumerRequest& request,
+                           std::size_t slot_size);
+
+  RemoteReceiverConnection(const RemoteReceiverConnection&) = delete;
+  void operator=(const RemoteReceiverConnection&) = delete;
+
+  ~RemoteReceiverConnection() override;
+
+  /// Retrieve the next timeslice that has been read, if any.
+  std::unique_ptr<Timeslice> try_get();
+
+  /// Retrieve the local data of a given slot.
+  [[nodiscard]] uint8_t* slot_data(uint32_t slot) {
+    return &slots_[static_cast<std::size_t>(slot) * slot_size_];
+  }
+
+  /// Release a timeslice and send its completion.
+  void complete(uint64_t id);
+
+  /// Handle the receive completion of a given receive buffer.
+  void on_complete_recv(uint32_t buffer);
+
+  /// Handle the completion of the reads into a given slot.
+  void on_complete_read(uint32_t slot);
+
+  /// Handle the completion of a completion message.
+  void on_complete_send() { --send_queue_used_; }
+
+  void on_established(struct rdma_cm_event* event) override;
+
+  void on_disconnected(struct rdma_cm_event* event) override;
+
+  void on_rejected(struct rdma_cm_event* event) override;
+
+  void setup(struct ibv_pd* pd) override;
+
+  std::unique_ptr<std::vector<uint8_t>> get_private_data() override;
+
+  /// Flag, true if the server has rejected the registration.
+  [[nodiscard]] bool rejected() const { return rejected_; }
+
+private:
+  /// Post the reads of the received items while slots are available.
+  void start_reads();
+
+  /// Post a receive work request for a given receive buffer.
+  void post_recv_item(uint32_t buffer);
+
+  /// Send a completion message with a given item id.
+  void post_send_completion(uint64_t id, uint32_t buffer);
+
+  /// Number of send work requests that may be outstanding.
+  static constexpr uint32_t send_queue_depth = 1024;
+
+  RemoteConsumerRequest request_;
+
+  const std::size_t slot_size_;
+
+  /// Maximum number of outstanding items (as granted by the server).
+  uint32_t window_;
+
+  uint32_t num_components_ = 0;
+
+  /// Size of a work item message.
+  std::size_t item_size_ = 0;
+
+  /// Access information for the remote data region.
+  BufferInfo data_{};
+
+  bool rejected_ = false;
+
+  /// Local memory for the timeslice data, one slot per outstanding item.
+  std::vector<uint8_t> slots_;
+
+  /// Items being read or consumed and their slots.
+  RemoteItemWindow slot_window_;
+
+  /// Receive buffers for work item messages.
+  std::vector<uint8_t> recv_buffer_;
+
+  /// Send buffers for completion messages (one per slot, plus one).
+  std::vector<RemoteCompletion> send_buffer_;
+
+  /// Received items waiting for a free slot.
+  std::deque<Timeslice> pending_;
+
+  /// Items being read, indexed by slot.
+  std::map<uint32_t, Timeslice> reading_;
+
+  /// Items that have been read completely.
+  std::deque<Timeslice> ready_;
+
+  /// Number of send queue entries in use.
+  uint32_t send_queue_used_ = 0;
+
+  struct ibv_pd* pd_ = nullptr;
+
+  ibv_mr* mr_slots_ = nullptr;
+  ibv_mr* mr_recv_ = nullptr;
+  ibv_mr* mr_send_ = nullptr;
+};
@@ -0,0 +1,148 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RemoteTimesliceReceiver.hpp"
+#include "RequestIdentifier.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+/// A timeslice read into a slot of a RemoteTimesliceReceiver.
+class RemoteTimeslice : public fles::Timeslice {
+public:
+  RemoteTimeslice(RemoteReceiverConnection::Timeslice ts,
+                  uint8_t* slot_data,
+                  std::shared_ptr<RemoteTimesliceReceiver::Completions> sink)
+      : id_(ts.id), desc_(std::move(ts.desc)),
+        completions_(std::move(sink)) {
+    timeslice_descriptor_ = ts.ts_desc;
+    for (std::size_t c = 0; c < desc_.size(); ++c) {
+      data_ptr_.push_back(slot_data + ts.offset[c]);
+      desc_ptr_.push_back(&desc_[c]);
+    }
+  }
+
+  RemoteTimeslice(const RemoteTimeslice&) = delete;
+  void operator=(const RemoteTimeslice&) = delete;
+
+  ~RemoteTimeslice() override {
+    std::lock_guard<std::mutex> lock(completions_->mutex);
+    completions_->items.push_back(id_);
+  }
+
+private:
+  uint64_t id_;
+  std::vector<fles::TimesliceComponentDescriptor> desc_;
+  std::shared_ptr<RemoteTimesliceReceiver::Completions> completions_;
+};
+
+} // namespace
+
+RemoteTimesliceReceiver::RemoteTimesliceReceiver(
+    const std::string& hostname,
+    const std::string& service,
+    const WorkerParameters& parameters,
+    std::size_t max_timeslice_size) {
+  RemoteConsumerRequest request{};
+  request.stride = static_cast<uint32_t>(parameters.stride);
+  request.offset = static_cast<uint32_t>(parameters.offset);
+  request.window =
+      static_cast<uint32_t>(std::max<size_t>(parameters.prefetch, 1));
+  if (parameters.client_name.empty() ||
+      parameters.client_name.size() >= sizeof(request.client_name)) {
+    throw std::invalid_argument("invalid client name for remote receiver");
+  }
+  std::strncpy(request.client_name, parameters.client_name.c_str(),
+               sizeof(request.client_name) - 1);
+
+  conn_.push_back(std::make_unique<RemoteReceiverConnection>(
+      ec_, request, max_timeslice_size));
+  conn_[0]->connect(hostname, service);
+}
+
+RemoteTimesliceReceiver::~RemoteTimesliceReceiver() {
+  if (connected_ > 0 && !conn_[0]->done()) {
+    conn_[0]->disconnect();
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (connected_ > 0 && std::chrono::steady_clock::now() < deadline) {
+      poll_cm_events();
+      poll_completion();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+void RemoteTimesliceReceiver::operator()() {
+  while (!conn_[0]->established() && !conn_[0]->done()) {
+    poll_cm_events();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (conn_[0]->rejected()) {
+    throw InfinibandException("remote consumer registration rejected");
+  }
+}
+
+fles::Timeslice* RemoteTimesliceReceiver::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+  if (!conn_[0]->established()) {
+    (*this)();
+  }
+
+  for (;;) {
+    send_completions();
+    poll_cm_events();
+    bool busy = poll_completion() > 0;
+    if (auto ts = conn_[0]->try_get()) {
+      uint8_t* slot_data = conn_[0]->slot_data(ts->slot);
+      return new RemoteTimeslice(std::move(*ts), slot_data, completions_);
+    }
+    if (conn_[0]->done()) {
+      eos_ = true;
+      return nullptr;
+    }
+    if (!busy) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+}
+
+void RemoteTimesliceReceiver::send_completions() {
+  std::vector<uint64_t> items;
+  {
+    std::lock_guard<std::mutex> lock(completions_->mutex);
+    items.swap(completions_->items);
+  }
+  for (uint64_t id : items) {
+    conn_[0]->complete(id);
+  }
+}
+
+void RemoteTimesliceReceiver::on_completion(const struct ibv_wc& wc) {
+  auto slot = static_cast<uint32_t>((wc.wr_id >> 8) & 0xFFFF);
+  auto buffer = static_cast<uint32_t>(wc.wr_id >> 24);
+  switch (wc.wr_id & 0xFF) {
+  case ID_READ_DATA:
+    conn_[0]->on_complete_read(slot);
+    break;
+
+  case ID_RECEIVE_ITEM:
+    conn_[0]->on_complete_recv(buffer);
+    break;
+
+  case ID_SEND_COMPLETION:
+    conn_[0]->on_complete_send();
+    break;
+
+  default:
+    L_(error) << "wc for unknown wr_id=" << (wc.wr_id & 0xFF);
+    throw InfinibandException("wc for unknown wr_id");
+  }
+}
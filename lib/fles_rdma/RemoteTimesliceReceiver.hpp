@@ -0,0 +1,70 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "IBConnectionGroup.hpp"
+#include "ItemWorkerProtocol.hpp"
+#include "RemoteReceiverConnection.hpp"
+#include "TimesliceSource.hpp"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Receiver of timeslices from a timeslice buffer on another host.
+/** A RemoteTimesliceReceiver object connects to the RemoteConsumerServer of
+    a flesnet timeslice buffer and registers there like a local
+    fles::TimesliceReceiver with the QueueAll policy. The components of each
+    timeslice are read with RDMA READ operations into local memory, so the
+    host of the timeslice buffer is not involved in the data transfer.
+
+    Up to WorkerParameters::prefetch timeslices are read ahead. The
+    completion of a timeslice is sent when it is destroyed, in any thread,
+    which must happen before the destruction of the receiver. */
+
+class RemoteTimesliceReceiver
+    : public fles::TimesliceSource,
+      private IBConnectionGroup<RemoteReceiverConnection> {
+public:
+  /// The RemoteTimesliceReceiver constructor.
+  /**
+     \param hostname   Host of the timeslice buffer
+     \param service    Port of its remote consumer service
+     \param parameters Worker parameters (stride, offset, client name and
+                       prefetch depth, the queue policy is ignored)
+     \param max_timeslice_size Maximum size of a timeslice (in bytes)
+  */
+  RemoteTimesliceReceiver(const std::string& hostname,
+                          const std::string& service,
+                          const WorkerParameters& parameters,
+                          std::size_t max_timeslice_size);
+
+  RemoteTimesliceReceiver(const RemoteTimesliceReceiver&) = delete;
+  void operator=(const RemoteTimesliceReceiver&) = delete;
+
+  ~RemoteTimesliceReceiver() override;
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+  /// Completions of timeslices destroyed since the last call of get().
+  struct Completions {
+    std::mutex mutex;
+    std::vector<uint64_t> items; ///< Item ids
+  };
+
+private:
+  fles::Timeslice* do_get() override;
+
+  /// Wait for the connection to be established.
+  void operator()() override;
+
+  void on_completion(const struct ibv_wc& wc) override;
+
+  /// Send the completions of the timeslices destroyed so far.
+  void send_completions();
+
+  bool eos_ = false;
+
+  std::shared_ptr<Completions> completions_ =
+      std::make_shared<Completions>();
+};
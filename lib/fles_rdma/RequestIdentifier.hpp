@@ -12,7 +12,15 @@ enum RequestIdentifier {
   ID_WRITE_DESC,
   ID_SEND_STATUS,
   ID_RECEIVE_STATUS,
-  ID_SEND_FINALIZE
+  ID_SEND_FINALIZE,
+  ID_WRITE_STRIPE,
+  ID_WRITE_PULL,
+  ID_READ_DATA,
+  ID_SEND_ITEM,
+  ID_RECEIVE_ITEM,
+  ID_SEND_COMPLETION,
+  ID_RECEIVE_COMPLETION,
+  ID_WRITE_LIFECYCLE
 };
 
 #pragma pack()
@@ -32,6 +40,22 @@ inline std::ostream& operator<<(std::ostream& s, RequestIdentifier v) {
     return s << "ID_RECEIVE_STATUS";
   case ID_SEND_FINALIZE:
     return s << "ID_SEND_FINALIZE";
+  case ID_WRITE_STRIPE:
+    return s << "ID_WRITE_STRIPE";
+  case ID_WRITE_PULL:
+    return s << "ID_WRITE_PULL";
+  case ID_READ_DATA:
+    return s << "ID_READ_DATA";
+  case ID_SEND_ITEM:
+    return s << "ID_SEND_ITEM";
+  case ID_RECEIVE_ITEM:
+    return s << "ID_RECEIVE_ITEM";
+  case ID_SEND_COMPLETION:
+    return s << "ID_SEND_COMPLETION";
+  case ID_RECEIVE_COMPLETION:
+    return s << "ID_RECEIVE_COMPLETION";
+  case ID_WRITE_LIFECYCLE:
+    return s << "ID_WRITE_LIFECYCLE";
   default:
     return s << static_cast<int>(v);
   }
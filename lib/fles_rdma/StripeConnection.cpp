@@ -0,0 +1,45 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "StripeConnection.hpp"
+#include "InputNodeInfo.hpp"
+
+StripeConnection::StripeConnection(struct rdma_event_channel* ec,
+                                   uint_fast16_t connection_index,
+                                   uint_fast16_t remote_connection_index,
+                                   uint32_t stripe,
+                                   unsigned int max_send_wr,
+                                   struct rdma_cm_id* id)
+    : IBConnection(ec, connection_index, remote_connection_index, id),
+      stripe_(stripe), passive_(id != nullptr) {
+  // only the input side posts (RDMA write) work requests
+  qp_cap_.max_send_wr = passive_ ? 1 : max_send_wr;
+  qp_cap_.max_send_sge = passive_ ? 1 : 4;
+  qp_cap_.max_recv_wr = 1;
+  qp_cap_.max_recv_sge = 1;
+}
+
+void StripeConnection::setup(struct ibv_pd* /* pd */) {
+  // the memory regions of the primary connection are used
+}
+
+void StripeConnection::on_disconnected(struct rdma_cm_event* event) {
+  if (passive_) {
+    disconnect();
+  }
+  IBConnection::on_disconnected(event);
+}
+
+std::unique_ptr<std::vector<uint8_t>> StripeConnection::get_private_data() {
+  if (passive_) {
+    return IBConnection::get_private_data();
+  }
+
+  std::unique_ptr<std::vector<uint8_t>> private_data(
+      new std::vector<uint8_t>(sizeof(InputNodeInfo)));
+
+  auto* in_info = reinterpret_cast<InputNodeInfo*>(private_data->data());
+  in_info->index = remote_index_;
+  in_info->stripe = stripe_;
+
+  return private_data;
+}
@@ -0,0 +1,48 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include "IBConnection.hpp"
+
+/// Stripe connection class.
+/** A StripeConnection object represents an additional queue pair between an
+    input channel and a compute node. It carries a part of the timeslice data
+    writes of the corresponding primary connection, using the memory regions
+    registered for that connection. */
+
+class StripeConnection : public IBConnection {
+public:
+  /// The StripeConnection constructor.
+  /**
+     \param stripe      Index of this stripe (starting at 1, as 0 denotes
+                        the primary connection)
+     \param max_send_wr Capacity of the send queue (on the input side)
+     \param id          Connection manager ID (on the compute node side)
+  */
+  StripeConnection(struct rdma_event_channel* ec,
+                   uint_fast16_t connection_index,
+                   uint_fast16_t remote_connection_index,
+                   uint32_t stripe,
+                   unsigned int max_send_wr,
+                   struct rdma_cm_id* id = nullptr);
+
+  StripeConnection(const StripeConnection&) = delete;
+  void operator=(const StripeConnection&) = delete;
+
+  /// Retrieve the index of this stripe.
+  [[nodiscard]] uint32_t stripe() const { return stripe_; }
+
+  /// Post a list of RDMA write work requests to the send queue.
+  void post_writes(struct ibv_send_wr* wr) { post_send(wr); }
+
+  void setup(struct ibv_pd* pd) override;
+
+  void on_disconnected(struct rdma_cm_event* event) override;
+
+  std::unique_ptr<std::vector<uint8_t>> get_private_data() override;
+
+private:
+  uint32_t stripe_;
+
+  /// Flag, true if this is the accepting (compute node) end.
+  bool passive_;
+};
@@ -4,43 +4,122 @@
 #include "InputNodeInfo.hpp"
 #include "RequestIdentifier.hpp"
 #include "System.hpp"
-#include "TimesliceCompletion.hpp"
+#include "TimesliceBufferStatus.hpp"
 #include "TimesliceWorkItem.hpp"
 #include "log.hpp"
+#include "probes.hpp"
+#include "tracing.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <limits>
 #include <memory>
 
+namespace {
+uint64_t to_us(std::chrono::steady_clock::duration d) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+/// Retrieve the time between two lifecycle timestamps in us (0 if negative,
+/// as possible after clock offset correction).
+uint64_t lifecycle_us(uint64_t begin, uint64_t end) {
+  return end > begin ? (end - begin) / 1000 : 0;
+}
+} // namespace
+
 TimesliceBuilder::TimesliceBuilder(uint64_t compute_index,
                                    TimesliceBuffer& timeslice_buffer,
                                    unsigned short service,
                                    uint32_t num_input_nodes,
-                                   uint32_t timeslice_size,
+                                   TimesliceSchedule schedule,
                                    volatile sig_atomic_t* signal_status,
                                    bool drop,
-                                   cbm::Monitor* monitor)
+                                   PlacementPolicy placement_policy,
+                                   uint32_t placement_epoch,
+                                   cbm::Monitor* monitor,
+                                   uint32_t stripes,
+                                   bool shared_receive_queue,
+                                   MemoryRegistration registration,
+                                   std::chrono::milliseconds deadline,
+                                   uint64_t timeslice_bytes,
+                                   uint32_t max_timeslice_size,
+                                   uint32_t pull_reads,
+                                   bool lifecycle)
     : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
       service_(service), num_input_nodes_(num_input_nodes),
-      timeslice_size_(timeslice_size),
-      ack_(timeslice_buffer_.get_desc_size_exp()),
-      signal_status_(signal_status), drop_(drop), monitor_(monitor) {
+      schedule_(std::move(schedule)), stripes_(std::max(stripes, UINT32_C(1))),
+      shared_receive_queue_(shared_receive_queue),
+      registration_(registration), deadline_(deadline),
+      timeslice_bytes_(timeslice_bytes),
+      max_timeslice_size_(max_timeslice_size), pull_reads_(pull_reads),
+      lifecycle_(lifecycle && monitor != nullptr),
+      signal_status_(signal_status), drop_(drop),
+      placement_policy_(placement_policy), placement_epoch_(placement_epoch),
+      monitor_(monitor) {
   assert(timeslice_buffer_.get_num_input_nodes() == num_input_nodes);
 
   hostname_ = fles::system::current_hostname();
 
   previous_recv_buffer_status_data_.resize(num_input_nodes);
   previous_recv_buffer_status_desc_.resize(num_input_nodes);
-}
 
-TimesliceBuilder::~TimesliceBuilder() = default;
+  if (monitor_) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"output_index", std::to_string(compute_index_)}};
+    build_latency_ =
+        monitor_->RegisterHistogram("timeslice_latency", tags, "build_us");
+    item_latency_ =
+        monitor_->RegisterHistogram("timeslice_latency", tags, "item_us");
+  }
+  if (lifecycle_) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"output_index", std::to_string(compute_index_)}};
+    lifecycle_available_ = monitor_->RegisterHistogram("timeslice_lifecycle",
+                                                       tags, "available_us");
+    lifecycle_wait_ =
+        monitor_->RegisterHistogram("timeslice_lifecycle", tags, "wait_us");
+    lifecycle_transfer_ = monitor_->RegisterHistogram("timeslice_lifecycle",
+                                                      tags, "transfer_us");
+    lifecycle_total_ =
+        monitor_->RegisterHistogram("timeslice_lifecycle", tags, "total_us");
+    ts_origin_.alloc_with_size_exponent(
+        timeslice_buffer_.get_desc_size_exp());
+  }
+  if (monitor_ || deadline_.count() > 0) {
+    ts_time_.alloc_with_size_exponent(timeslice_buffer_.get_desc_size_exp());
+  }
+  if (auto* status = StatusServer::instance()) {
+    connection_status_ = std::make_shared<ConnectionStatus>();
+    connection_status_->expected.store(num_input_nodes_ * stripes_,
+                                       std::memory_order_relaxed);
+    publish_phase();
+    status->add_connections(
+        "timeslice_builder",
+        {{"host", hostname_}, {"output_index", std::to_string(compute_index_)}},
+        connection_status_);
+  }
+}
 
-void TimesliceBuilder::report_status() {
-  constexpr auto interval = std::chrono::seconds(1);
+TimesliceBuilder::~TimesliceBuilder() {
+  if (mr_srq_ != nullptr) {
+    ibv_dereg_mr(mr_srq_);
+    mr_srq_ = nullptr;
+  }
 
-  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+  if (srq_ != nullptr) {
+    int err = ibv_destroy_srq(srq_);
+    if (err != 0) {
+      L_(error) << "ibv_destroy_srq() failed";
+    }
+    srq_ = nullptr;
+  }
+}
 
+void TimesliceBuilder::report_status() {
   L_(debug) << "[c" << compute_index_ << "] " << completely_written_
-            << " completely written, " << acked_ << " acked";
+            << " completely written, " << acked_ << " acked, "
+            << partial_timeslices_ << " partial";
 
   double total_rate_desc = 0.;
   double total_rate_data = 0.;
@@ -116,7 +195,10 @@ void TimesliceBuilder::report_status() {
                              {"desc_used", status_desc.used()},
                              {"desc_freeing", status_desc.freeing()},
                              {"desc_free", status_desc.unused()},
-                             {"desc_rate", rate_desc}});
+                             {"desc_rate", rate_desc},
+                             {"outstanding_wr",
+                              static_cast<unsigned long>(
+                                  c->outstanding_requests())}});
     }
 
     previous_recv_buffer_status_data_.at(c->index()) = status_data;
@@ -157,10 +239,23 @@ void TimesliceBuilder::report_status() {
          {"desc_freeing", min_freeing_desc},
          {"desc_free", min_free_desc},
          {"desc_rate", total_rate_desc},
-         {"work_items", timeslice_buffer_.get_num_work_items()}});
+         {"work_items", timeslice_buffer_.get_num_work_items()},
+         {"partial_timeslices", partial_timeslices_},
+         {"crc_checked", timeslice_buffer_.crc_checked()},
+         {"crc_errors", timeslice_buffer_.crc_errors()},
+         {"evicted_timeslices", timeslice_buffer_.evicted()}});
   }
 
-  scheduler_.add([this] { report_status(); }, now + interval);
+  if (monitor_ && completion_wait_.enabled()) {
+    CompletionWait::Stats wait = completion_wait_.take_stats();
+    monitor_->QueueMetric(
+        "completion_wait",
+        {{"host", hostname_}, {"output_index", std::to_string(compute_index_)}},
+        {{"waits", wait.waits},
+         {"wakeups", wait.wakeups},
+         {"blocked_ratio", wait.blocked_ratio()},
+         {"wait_us", wait.mean_wait_us()}});
+  }
 }
 
 void TimesliceBuilder::request_abort() {
@@ -172,25 +267,120 @@ void TimesliceBuilder::request_abort() {
   }
 }
 
+void TimesliceBuilder::request_resize(uint32_t data_buffer_size_exp,
+                                      uint32_t desc_buffer_size_exp) {
+  if (!timeslice_buffer_.resizable()) {
+    throw std::invalid_argument("timeslice buffer can't be resized");
+  }
+  if (data_buffer_size_exp < 12 || data_buffer_size_exp > 40 ||
+      desc_buffer_size_exp < 1 || desc_buffer_size_exp > 32) {
+    throw std::invalid_argument("buffer size exponent out of range");
+  }
+  resize_request_.store(
+      static_cast<uint64_t>(data_buffer_size_exp) << 32 | desc_buffer_size_exp,
+      std::memory_order_relaxed);
+}
+
+void TimesliceBuilder::progress_resize() {
+  if (resize_barrier_ == 0) {
+    uint64_t request = resize_request_.exchange(0, std::memory_order_relaxed);
+    if (request == 0) {
+      return;
+    }
+    if (connected_ != conn_.size() * stripes_) {
+      L_(warning) << "[c" << compute_index_ << "] "
+                  << "timeslice buffer resize ignored while not connected";
+      return;
+    }
+    resize_data_exp_ = static_cast<uint32_t>(request >> 32);
+    resize_desc_exp_ = static_cast<uint32_t>(request);
+    // no input node can have written this far with the acknowledgments
+    // sent so far
+    resize_barrier_ =
+        acked_ + (UINT64_C(1) << timeslice_buffer_.get_desc_size_exp());
+    for (auto& c : conn_) {
+      c->set_barrier(resize_barrier_);
+    }
+    L_(info) << "[c" << compute_index_ << "] "
+             << "resizing timeslice buffer at position " << resize_barrier_;
+    return;
+  }
+
+  // the buffer is drained once all timeslices before the barrier have been
+  // written by all input nodes and completed
+  if (acked_ < resize_barrier_ ||
+      std::any_of(conn_.begin(), conn_.end(), [this](const auto& c) {
+        return c->cn_wp().desc < resize_barrier_;
+      })) {
+    return;
+  }
+  timeslice_buffer_.resize(resize_data_exp_, resize_desc_exp_);
+  for (auto& c : conn_) {
+    c->remap(pd_, timeslice_buffer_.get_data_ptr(c->index()),
+             resize_data_exp_, timeslice_buffer_.get_desc_ptr(c->index()),
+             resize_desc_exp_);
+  }
+  if (lifecycle_) {
+    ts_origin_.alloc_with_size_exponent(resize_desc_exp_);
+  }
+  if (monitor_ || deadline_.count() > 0) {
+    ts_time_.alloc_with_size_exponent(resize_desc_exp_);
+  }
+  resize_barrier_ = 0;
+}
+
 /// The thread main function.
 void TimesliceBuilder::operator()() {
-  try {
-    // set_cpu(0);
+  while (step()) {
+  }
+}
 
-    accept(service_, num_input_nodes_);
-    while (connected_ != num_input_nodes_) {
+bool TimesliceBuilder::step() {
+  try {
+    switch (phase_) {
+    case Phase::Accept:
+      // set_cpu(0);
+      accept_begin_ = std::chrono::steady_clock::now();
+      accept(service_, num_input_nodes_ * stripes_);
+      phase_ = Phase::Connecting;
+      break;
+
+    case Phase::Connecting:
       poll_cm_events();
-    }
-    L_(info) << "[c" << compute_index_ << "] "
-             << "connection to input nodes established";
+      if (connected_ != num_input_nodes_ * stripes_) {
+        break;
+      }
+      L_(info) << "[c" << compute_index_ << "] "
+               << "connection to input nodes established";
+      report_startup();
+
+      time_begin_ = std::chrono::high_resolution_clock::now();
+
+      report_status();
+      scheduler_.add_repeating([this] { report_status(); },
+                               std::chrono::seconds(1));
+      phase_ = Phase::Receiving;
+      break;
+
+    case Phase::Receiving:
+      if (all_done_ && connected_ == 0 && timewait_ == 0) {
+        time_end_ = std::chrono::high_resolution_clock::now();
 
-    time_begin_ = std::chrono::high_resolution_clock::now();
+        timeslice_buffer_.send_end_work_item();
+        timeslice_buffer_.send_end_completion();
 
-    report_status();
-    while (!all_done_ || connected_ != 0 || timewait_ != 0) {
+        summary();
+        phase_ = Phase::Done;
+        break;
+      }
       if (!all_done_) {
-        poll_completion();
-        poll_ts_completion();
+        const int completions = poll_completion();
+        const bool released = poll_ts_completion();
+        if (deadline_.count() > 0) {
+          send_overdue_timeslices();
+        }
+        progress_resize();
+        idle_wait(completions > 0 || released);
       }
       if (connected_ != 0 || timewait_ != 0) {
         poll_cm_events();
@@ -200,16 +390,41 @@ void TimesliceBuilder::operator()() {
         *signal_status_ = 0;
         request_abort();
       }
-    }
-
-    time_end_ = std::chrono::high_resolution_clock::now();
-
-    timeslice_buffer_.send_end_work_item();
-    timeslice_buffer_.send_end_completion();
+      break;
 
-    summary();
+    case Phase::Done:
+      break;
+    }
   } catch (std::exception& e) {
     L_(error) << "exception in TimesliceBuilder: " << e.what();
+    phase_ = Phase::Done;
+  }
+  if (connection_status_ && phase_ != published_phase_) {
+    publish_phase();
+  }
+  return phase_ != Phase::Done;
+}
+
+void TimesliceBuilder::publish_phase() {
+  static constexpr std::array<const char*, 4> names = {
+      "accept", "connecting", "receiving", "done"};
+  published_phase_ = phase_;
+  connection_status_->phase.store(names.at(static_cast<size_t>(phase_)),
+                                  std::memory_order_relaxed);
+}
+
+void TimesliceBuilder::report_startup() {
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - accept_begin_)
+                       .count();
+  L_(info) << "[c" << compute_index_ << "] "
+           << "connection setup took " << seconds << " s";
+  if (monitor_) {
+    monitor_->QueueMetric(
+        "build_startup",
+        {{"host", hostname_},
+         {"compute_index", std::to_string(compute_index_)}},
+        {{"seconds", seconds}});
   }
 }
 
@@ -217,13 +432,31 @@ void TimesliceBuilder::on_connect_request(struct rdma_cm_event* event) {
   if (pd_ == nullptr) {
     init_context(event->id->verbs);
   }
+  if (shared_receive_queue_ && srq_ == nullptr) {
+    init_shared_receive_queue();
+  }
 
   assert(event->param.conn.private_data_len >= sizeof(InputNodeInfo));
   InputNodeInfo remote_info =
       *reinterpret_cast<const InputNodeInfo*>(event->param.conn.private_data);
 
   uint_fast16_t index = remote_info.index;
+
+  if (remote_info.stripe != 0) {
+    assert(index < conn_.size() && remote_info.stripe < stripes_);
+    std::unique_ptr<StripeConnection> conn(new StripeConnection(
+        ec_, index, compute_index_, remote_info.stripe, 0, event->id));
+    conn->set_shared_receive_queue(srq_);
+    conn->on_connect_request(event, pd_, cq_);
+    stripe_conn_.push_back(std::move(conn));
+    return;
+  }
+
   assert(index < conn_.size() && conn_.at(index) == nullptr);
+  if ((remote_info.pull != 0) != (pull_reads_ > 0)) {
+    throw InfinibandException("transfer mode of input node " +
+                              std::to_string(index) + " does not match");
+  }
 
   std::unique_ptr<ComputeNodeConnection> conn(new ComputeNodeConnection(
       ec_, index, compute_index_, event->id, remote_info,
@@ -231,14 +464,115 @@ void TimesliceBuilder::on_connect_request(struct rdma_cm_event* event) {
       timeslice_buffer_.get_data_size_exp(),
       timeslice_buffer_.get_desc_ptr(index),
       timeslice_buffer_.get_desc_size_exp()));
+  conn->set_shared_receive_queue(srq_);
+  conn->set_registration(registration_);
+  if (pull_reads_ > 0) {
+    conn->set_pull(pull_reads_);
+  }
+  if (lifecycle_) {
+    conn->set_lifecycle();
+  }
+  if (monitor_) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"output_index", std::to_string(compute_index_)},
+                           {"input_index", std::to_string(index)}};
+    conn->set_latency_metrics(
+        monitor_->RegisterHistogram("recv_connection_latency", tags,
+                                    "status_us"),
+        pull_reads_ > 0 ? monitor_->RegisterHistogram(
+                              "recv_connection_latency", tags, "read_us")
+                        : cbm::MetricHistogram());
+  }
+  if (const auto* device_data = timeslice_buffer_.get_device_data();
+      device_data != nullptr && device_data->dmabuf_fd() >= 0) {
+    conn->set_data_dmabuf(device_data->dmabuf_fd(),
+                          static_cast<uint64_t>(
+                              timeslice_buffer_.get_data_ptr(index) -
+                              device_data->ptr()));
+  }
+  // the positions are published in the status segment of the buffer and
+  // also sampled for monitoring if enabled
+  auto buffer_status = timeslice_buffer_.status().input(index);
+  cbm::MetricTagSet tags{{"host", hostname_},
+                         {"output_index", std::to_string(compute_index_)},
+                         {"input_index", std::to_string(index)}};
+  if (auto* sampler = BufferStatusSampler::instance()) {
+    sampler->add_source("recv_buffer_fill", tags, buffer_status, false);
+  }
+  if (auto* status = StatusServer::instance()) {
+    status->add_buffer("recv_buffer", tags, buffer_status);
+  }
+  conn->set_buffer_status(std::move(buffer_status));
   conn_.at(index) = std::move(conn);
 
   conn_.at(index)->on_connect_request(event, pd_, cq_);
+  if (srq_ != nullptr) {
+    qp_index_[conn_.at(index)->qp()->qp_num] = index;
+  }
+}
+
+void TimesliceBuilder::init_shared_receive_queue() {
+  struct ibv_srq_init_attr srq_attr {};
+  srq_attr.attr.max_wr = num_input_nodes_;
+  srq_attr.attr.max_sge = 1;
+  srq_ = ibv_create_srq(pd_, &srq_attr);
+  if (srq_ == nullptr) {
+    throw InfinibandException("ibv_create_srq failed");
+  }
+
+  // each input node has at most one status message in flight
+  srq_messages_.resize(num_input_nodes_);
+  mr_srq_ = ibv_reg_mr(pd_, srq_messages_.data(),
+                       srq_messages_.size() * sizeof(InputChannelStatusMessage),
+                       IBV_ACCESS_LOCAL_WRITE);
+  if (mr_srq_ == nullptr) {
+    throw InfinibandException("registration of memory region failed");
+  }
+
+  for (size_t slot = 0; slot < srq_messages_.size(); ++slot) {
+    post_srq_recv(slot);
+  }
+}
+
+void TimesliceBuilder::post_srq_recv(size_t slot) {
+  struct ibv_sge sge {};
+  sge.addr = reinterpret_cast<uintptr_t>(&srq_messages_[slot]);
+  sge.length = sizeof(InputChannelStatusMessage);
+  sge.lkey = mr_srq_->lkey;
+
+  struct ibv_recv_wr wr {};
+  wr.wr_id = ID_RECEIVE_STATUS | (slot << 8);
+  wr.sg_list = &sge;
+  wr.num_sge = 1;
+
+  struct ibv_recv_wr* bad_wr;
+  int err = ibv_post_srq_recv(srq_, &wr, &bad_wr);
+  if (err != 0) {
+    L_(fatal) << "ibv_post_srq_recv failed: " << strerror(err);
+    throw InfinibandException("ibv_post_srq_recv failed");
+  }
 }
 
 /// Completion notification event dispatcher. Called by the event loop.
+void TimesliceBuilder::on_completions(const struct ibv_wc* wc, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    on_completion(wc[i]);
+  }
+  if (red_lantern_written_) {
+    red_lantern_written_ = false;
+    on_red_lantern_written();
+  }
+  post_pull_reads();
+}
+
 void TimesliceBuilder::on_completion(const struct ibv_wc& wc) {
+  tracing::Scope trace_scope("builder_completion", wc.wr_id & 0xFF);
   size_t in = wc.wr_id >> 8;
+  if (srq_ != nullptr && (wc.wr_id & 0xFF) == ID_RECEIVE_STATUS) {
+    // the shared receive buffer is identified by wr_id, the connection by
+    // its queue pair
+    in = qp_index_.at(wc.qp_num);
+  }
   assert(in < conn_.size());
   switch (wc.wr_id & 0xFF) {
 
@@ -266,57 +600,276 @@ void TimesliceBuilder::on_completion(const struct ibv_wc& wc) {
   } break;
 
   case ID_RECEIVE_STATUS: {
-    conn_[in]->on_complete_recv();
-    if (connected_ == conn_.size() && in == red_lantern_) {
-      auto new_red_lantern = std::min_element(
-          std::begin(conn_), std::end(conn_),
-          [](const std::unique_ptr<ComputeNodeConnection>& v1,
-             const std::unique_ptr<ComputeNodeConnection>& v2) {
-            return v1->cn_wp().desc < v2->cn_wp().desc;
-          });
-
-      uint64_t new_completely_written = (*new_red_lantern)->cn_wp().desc;
-      red_lantern_ = std::distance(std::begin(conn_), new_red_lantern);
-
-      for (uint64_t tpos = completely_written_; tpos < new_completely_written;
-           ++tpos) {
-        if (!drop_) {
-          uint64_t ts_index = UINT64_MAX;
-          if (!conn_.empty()) {
-            ts_index = timeslice_buffer_.get_desc(0, tpos).ts_num;
-          }
-          timeslice_buffer_.send_work_item(
-              {{ts_index, tpos, timeslice_size_,
-                static_cast<uint32_t>(conn_.size())},
-               timeslice_buffer_.get_data_size_exp(),
-               timeslice_buffer_.get_desc_size_exp()});
-        } else {
-          timeslice_buffer_.send_completion({tpos});
-        }
+    const uint64_t previously_written = conn_[in]->cn_wp().desc;
+    const uint64_t previously_announced = conn_[in]->pull_wp().desc;
+    if (srq_ != nullptr) {
+      // repost the buffer first, as the reply enables the next message
+      size_t slot = wc.wr_id >> 8;
+      InputChannelStatusMessage message = srq_messages_.at(slot);
+      post_srq_recv(slot);
+      conn_[in]->on_complete_recv(message);
+    } else {
+      conn_[in]->on_complete_recv();
+    }
+    if (conn_[in]->pull()) {
+      for (uint64_t pos = previously_announced;
+           pos < conn_[in]->pull_wp().desc; ++pos) {
+        pending_reads_.emplace(pos, in);
       }
-
-      completely_written_ = new_completely_written;
+    } else {
+      on_components_written(in, previously_written);
     }
   } break;
 
+  case ID_READ_DATA: {
+    const uint64_t previously_written = conn_[in]->cn_wp().desc;
+    conn_[in]->on_complete_read();
+    --outstanding_reads_;
+    on_components_written(in, previously_written);
+  } break;
+
   default:
     throw InfinibandException("wc for unknown wr_id");
   }
 }
 
-void TimesliceBuilder::poll_ts_completion() {
-  fles::TimesliceCompletion c{};
-  if (!timeslice_buffer_.try_receive_completion(c)) {
+void TimesliceBuilder::on_components_written(size_t in,
+                                             uint64_t previously_written) {
+  if (timeslice_buffer_.component_items()) {
+    // components of timeslices passed on already are not announced
+    for (uint64_t tpos = std::max(previously_written, completely_written_);
+         tpos < conn_[in]->cn_wp().desc; ++tpos) {
+      uint64_t ts_index = timeslice_buffer_.get_desc(in, tpos).ts_num;
+      timeslice_buffer_.send_component_item(
+          in, tpos, core_microslices(tpos, ts_index));
+    }
+  }
+  if (deadline_.count() > 0) {
+    // late contributions to partial timeslices are discarded
+    conn_[in]->inc_ack_pointers(acked_);
+  }
+  if (lifecycle_) {
+    record_lifecycle(in, previously_written);
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (build_latency_ || deadline_.count() > 0) {
+    for (uint64_t written = conn_[in]->cn_wp().desc;
+         first_written_ < written; ++first_written_) {
+      ts_time_.at(first_written_) = now;
+    }
+  }
+  if (in == red_lantern_) {
+    red_lantern_written_ = true;
+  }
+}
+
+void TimesliceBuilder::on_red_lantern_written() {
+  if (connected_ == conn_.size() * stripes_) {
+    auto now = std::chrono::steady_clock::now();
+    auto new_red_lantern = std::min_element(
+        std::begin(conn_), std::end(conn_),
+        [](const std::unique_ptr<ComputeNodeConnection>& v1,
+           const std::unique_ptr<ComputeNodeConnection>& v2) {
+          return v1->cn_wp().desc < v2->cn_wp().desc;
+        });
+
+    uint64_t new_completely_written = (*new_red_lantern)->cn_wp().desc;
+    red_lantern_ = std::distance(std::begin(conn_), new_red_lantern);
+
+    // partial timeslices may have been passed on already
+    for (; completely_written_ < new_completely_written;
+         ++completely_written_) {
+      send_timeslice(completely_written_, now);
+    }
+  }
+}
+
+void TimesliceBuilder::record_lifecycle(size_t in,
+                                        uint64_t previously_written) {
+  uint64_t now = lifecycle_now();
+  for (uint64_t tpos = previously_written; tpos < conn_[in]->cn_wp().desc;
+       ++tpos) {
+    TimesliceLifecycle record = conn_[in]->local_lifecycle(tpos, now);
+    lifecycle_available_.Record(
+        lifecycle_us(record.first_available, record.last_available));
+    lifecycle_wait_.Record(lifecycle_us(record.last_available, record.posted));
+    lifecycle_transfer_.Record(lifecycle_us(record.posted, now));
+    // the first contribution to a timeslice starts its origin anew
+    if (tpos >= first_written_ ||
+        record.first_available < ts_origin_.at(tpos)) {
+      ts_origin_.at(tpos) = record.first_available;
+    }
+  }
+}
+
+void TimesliceBuilder::post_pull_reads() {
+  // the oldest timeslices are read first, as they hold back the others
+  while (outstanding_reads_ < pull_reads_ && !pending_reads_.empty()) {
+    auto [pos, in] = pending_reads_.top();
+    pending_reads_.pop();
+    conn_[in]->post_reads(pos);
+    ++outstanding_reads_;
+  }
+}
+
+uint64_t TimesliceBuilder::written_ts_index(uint64_t tpos) {
+  for (auto& c : conn_) {
+    if (c->cn_wp().desc > tpos) {
+      return timeslice_buffer_.get_desc(c->index(), tpos).ts_num;
+    }
+  }
+  return UINT64_MAX;
+}
+
+uint32_t TimesliceBuilder::core_microslices(uint64_t tpos,
+                                            uint64_t ts_index) {
+  if (timeslice_bytes_ == 0) {
+    return schedule_.size(ts_index);
+  }
+  // the size is decided by the input nodes, which add their overlap
+  for (auto& c : conn_) {
+    if (c->cn_wp().desc > tpos) {
+      return static_cast<uint32_t>(
+          timeslice_buffer_.get_desc(c->index(), tpos).num_microslices -
+          c->overlap_size());
+    }
+  }
+  return schedule_.size(ts_index);
+}
+
+void TimesliceBuilder::send_timeslice(
+    uint64_t tpos, std::chrono::steady_clock::time_point now) {
+  uint64_t ts_index = written_ts_index(tpos);
+  uint32_t num_core_microslices = core_microslices(tpos, ts_index);
+  if (timeslice_bytes_ != 0 && num_core_microslices != 0) {
+    uint64_t bytes = 0;
+    for (auto& c : conn_) {
+      bytes += timeslice_buffer_.get_desc(c->index(), tpos).size;
+    }
+    // exponential moving average over about ten timeslices
+    constexpr double weight = 0.1;
+    double sample = static_cast<double>(bytes) / num_core_microslices;
+    microslice_bytes_ = microslice_bytes_ == 0
+                            ? sample
+                            : (1 - weight) * microslice_bytes_ +
+                                  weight * sample;
+  }
+  if (placement_policy_ == PlacementPolicy::Credit &&
+      ts_index != UINT64_MAX) {
+    announce_credit(ts_index / placement_epoch_ +
+                    TimeslicePlacement::credit_lead);
+  }
+  if (build_latency_) {
+    build_latency_.Record(to_us(now - ts_time_.at(tpos)));
+    ts_time_.at(tpos) = now;
+  }
+  FLES_PROBE(timeslice_complete, ts_index, tpos, conn_.size());
+  if (!drop_) {
+    timeslice_buffer_.send_work_item(
+        {{ts_index, tpos, num_core_microslices,
+          static_cast<uint32_t>(conn_.size())},
+         timeslice_buffer_.get_data_size_exp(),
+         timeslice_buffer_.get_desc_size_exp()});
+  } else {
+    timeslice_buffer_.send_completion({tpos});
+  }
+}
+
+void TimesliceBuilder::send_overdue_timeslices() {
+  auto now = std::chrono::steady_clock::now();
+  while (completely_written_ < first_written_ &&
+         now - ts_time_.at(completely_written_) >= deadline_) {
+    uint64_t tpos = completely_written_;
+    uint64_t ts_index = written_ts_index(tpos);
+    // mark the missing components as empty; a late contribution replaces
+    // the descriptor, but is only acknowledged and never passed on
+    for (auto& c : conn_) {
+      if (c->cn_wp().desc <= tpos) {
+        fles::TimesliceComponentDescriptor& desc =
+            timeslice_buffer_.get_desc(c->index(), tpos);
+        desc = {ts_index, c->cn_wp().data, 0, 0};
+        L_(debug) << "[c" << compute_index_ << "] "
+                  << "timeslice " << ts_index << " missing component "
+                  << c->index();
+      }
+    }
+    ++partial_timeslices_;
+    send_timeslice(tpos, now);
+    ++completely_written_;
+  }
+}
+
+void TimesliceBuilder::announce_credit(uint64_t epoch) {
+  if (epoch <= credit_epoch_) {
     return;
   }
-  if (c.ts_pos == acked_) {
-    do {
-      ++acked_;
-    } while (ack_.at(acked_) > c.ts_pos);
+
+  // credit reflects the free space of the fullest receive buffer, plus the
+  // space the consumers release until the epoch is used
+  float free = 1.f;
+  float drained = 1.f;
+  bool first = credit_acked_.empty();
+  credit_acked_.resize(conn_.size());
+  for (auto& c : conn_) {
+    auto status_desc = c->buffer_status_desc();
+    auto status_data = c->buffer_status_data();
+    free = std::min(free, 1.f - status_desc.percentage(status_desc.used()));
+    free = std::min(free, 1.f - status_data.percentage(status_data.used()));
+    ComputeNodeBufferPosition& last = credit_acked_.at(c->index());
+    auto drained_desc = static_cast<int64_t>(status_desc.acked - last.desc);
+    auto drained_data = static_cast<int64_t>(status_data.acked - last.data);
+    drained = std::min(drained, status_desc.percentage(drained_desc));
+    drained = std::min(drained, status_data.percentage(drained_data));
+    last = {status_data.acked, status_desc.acked};
+  }
+  if (!first) {
+    // exponential moving average over a few epochs
+    constexpr double weight = 0.3;
+    double sample = drained / static_cast<double>(epoch - credit_epoch_);
+    drain_per_epoch_ = (1 - weight) * drain_per_epoch_ + weight * sample;
+  }
+  uint32_t credit = TimeslicePlacement::credit_for(
+      free + drain_per_epoch_ * TimeslicePlacement::credit_lead);
+
+  // propose the timeslice size closest to the target size in bytes
+  uint32_t size = 0;
+  if (timeslice_bytes_ != 0 && microslice_bytes_ > 0) {
+    double microslices =
+        static_cast<double>(timeslice_bytes_) / microslice_bytes_;
+    size = static_cast<uint32_t>(std::clamp(
+        microslices, 1.0, static_cast<double>(max_timeslice_size_)));
+  }
+
+  if (false) {
+    L_(trace) << "[c" << compute_index_ << "] "
+              << "announce credit " << credit << " for epoch " << epoch;
+  }
+  for (auto& connection : conn_) {
+    connection->announce_credit(epoch, credit, size);
+  }
+  credit_epoch_ = epoch;
+}
+
+bool TimesliceBuilder::poll_ts_completion() {
+  const auto now = std::chrono::steady_clock::now();
+  std::size_t count =
+      timeslice_buffer_.receive_completions([&](uint64_t ts_pos) {
+        tracing::Scope trace_scope("ts_completion", ts_pos);
+        FLES_PROBE(timeslice_release, ts_pos);
+        if (item_latency_) {
+          item_latency_.Record(to_us(now - ts_time_.at(ts_pos)));
+        }
+        if (lifecycle_) {
+          lifecycle_total_.Record(
+              lifecycle_us(ts_origin_.at(ts_pos), lifecycle_now()));
+        }
+      });
+  // a single ack pointer update for the whole batch
+  if (timeslice_buffer_.acked() != acked_) {
+    acked_ = timeslice_buffer_.acked();
     for (auto& connection : conn_) {
       connection->inc_ack_pointers(acked_);
     }
-  } else {
-    ack_.at(c.ts_pos) = c.ts_pos;
   }
+  return count != 0;
 }
@@ -5,9 +5,18 @@
 #include "IBConnectionGroup.hpp"
 #include "Monitor.hpp"
 #include "RingBuffer.hpp"
+#include "StripeConnection.hpp"
 #include "TimesliceBuffer.hpp"
+#include "TimeslicePlacement.hpp"
+#include "TimesliceSchedule.hpp"
+#include <atomic>
+#include <chrono>
 #include <csignal>
+#include <functional>
 #include <memory>
+#include <queue>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 /// Timeslice receiver and input node connection container class.
@@ -17,14 +26,27 @@
 class TimesliceBuilder : public IBConnectionGroup<ComputeNodeConnection> {
 public:
   /// The TimesliceBuilder constructor.
+  /** If lifecycle is set (requires a monitor), the input node timestamps
+      of the components are received and the latencies of the timeslice
+      lifecycle stages are recorded (see TimesliceLifecycle). */
   TimesliceBuilder(uint64_t compute_index,
                    TimesliceBuffer& timeslice_buffer,
                    unsigned short service,
                    uint32_t num_input_nodes,
-                   uint32_t timeslice_size,
+                   TimesliceSchedule schedule,
                    volatile sig_atomic_t* signal_status,
                    bool drop,
-                   cbm::Monitor* monitor);
+                   PlacementPolicy placement_policy,
+                   uint32_t placement_epoch,
+                   cbm::Monitor* monitor,
+                   uint32_t stripes = 1,
+                   bool shared_receive_queue = false,
+                   MemoryRegistration registration = {},
+                   std::chrono::milliseconds deadline = {},
+                   uint64_t timeslice_bytes = 0,
+                   uint32_t max_timeslice_size = 0,
+                   uint32_t pull_reads = 0,
+                   bool lifecycle = false);
 
   TimesliceBuilder(const TimesliceBuilder&) = delete;
   void operator=(const TimesliceBuilder&) = delete;
@@ -36,8 +58,22 @@ public:
 
   void request_abort();
 
+  /// Request to switch the timeslice buffer to new sizes during the run.
+  /** May be called from any thread. The input nodes stop at a barrier one
+      buffer size ahead of the acknowledged timeslices. Once all timeslices
+      before it have been completed, the buffer is replaced (see
+      TimesliceBuffer::resize()) and the new regions are announced to the
+      input nodes. Throws std::invalid_argument if the buffer can't be
+      resized or the sizes are out of range. */
+  void request_resize(uint32_t data_buffer_size_exp,
+                      uint32_t desc_buffer_size_exp);
+
   void operator()() override;
 
+  bool step() override;
+
+  [[nodiscard]] bool cooperative() const override { return true; }
+
   [[nodiscard]] std::string thread_name() const override {
     return "TSB/RDMA/o" + std::to_string(compute_index_);
   };
@@ -48,27 +84,161 @@ public:
   /// Completion notification event dispatcher. Called by the event loop.
   void on_completion(const struct ibv_wc& wc) override;
 
-  void poll_ts_completion();
+  /// Handle a batch of completions, passing on the completely written
+  /// timeslices and posting pull reads once for the whole batch.
+  void on_completions(const struct ibv_wc* wc, size_t count) override;
+
+  /// Handle a timeslice completion, if any (returns whether there was one).
+  bool poll_ts_completion();
 
 private:
+  /// Report the connection setup time to the log and monitor.
+  void report_startup();
+
+  /// Retrieve the index of a timeslice from the first contribution written.
+  uint64_t written_ts_index(uint64_t tpos);
+
+  /// Retrieve the number of core microslices of a written timeslice.
+  uint32_t core_microslices(uint64_t tpos, uint64_t ts_index);
+
+  /// Handle components written by an input node (or read in pull mode).
+  void on_components_written(size_t in, uint64_t previously_written);
+
+  /// Pass on the timeslices written by all input nodes.
+  void on_red_lantern_written();
+
+  /// Post reads of announced components, oldest timeslices first.
+  void post_pull_reads();
+
+  /// Pass on a timeslice that has been written (at least partially).
+  void send_timeslice(uint64_t tpos, std::chrono::steady_clock::time_point now);
+
+  /// Pass on the incomplete timeslices whose deadline has passed.
+  void send_overdue_timeslices();
+
+  /// Announce placement credit for an epoch to all input nodes.
+  void announce_credit(uint64_t epoch);
+
+  /// Start a requested resize of the timeslice buffer, or complete the
+  /// resize in progress once the buffer has been drained.
+  void progress_resize();
+
+  /// Create the shared receive queue and post its receive buffers.
+  void init_shared_receive_queue();
+
+  /// Post a receive work request for a shared receive buffer.
+  void post_srq_recv(size_t slot);
+
+  /// The progress phases of the worker (see step()).
+  enum class Phase { Accept, Connecting, Receiving, Done };
+  Phase phase_ = Phase::Accept;
+
+  /// The phase last published to the status server.
+  Phase published_phase_ = Phase::Accept;
+
+  /// Publish the current phase to the status server.
+  void publish_phase();
+
+  /// Start time of the connection setup.
+  std::chrono::steady_clock::time_point accept_begin_;
+
   uint64_t compute_index_;
   TimesliceBuffer& timeslice_buffer_;
 
   unsigned short service_;
   uint32_t num_input_nodes_;
 
-  uint32_t timeslice_size_;
+  /// The timeslice sizes (in core microslices).
+  TimesliceSchedule schedule_;
+
+  /// Number of connections (queue pairs) per input node.
+  uint32_t stripes_;
+
+  /// Additional connections carrying a part of the data of input nodes.
+  std::vector<std::unique_ptr<StripeConnection>> stripe_conn_;
+
+  /// Receive status messages of all connections through a single queue.
+  bool shared_receive_queue_;
+
+  /// Registration options of the timeslice buffer.
+  MemoryRegistration registration_;
+
+  /// Time after the first contribution at which an incomplete timeslice is
+  /// passed on without its missing components (zero: never).
+  std::chrono::milliseconds deadline_;
+
+  /// Number of timeslices passed on with missing components.
+  uint64_t partial_timeslices_ = 0;
+
+  /// Target size of a timeslice in bytes for the timeslice size proposed
+  /// with the placement credit (0: none, fixed timeslice size).
+  uint64_t timeslice_bytes_;
+
+  /// Maximum proposed timeslice size (in microslices).
+  uint32_t max_timeslice_size_;
+
+  /// Maximum number of components read at the same time (0: push mode).
+  uint32_t pull_reads_;
+
+  /// Receive the lifecycle timestamps of the components.
+  bool lifecycle_;
+
+  /// Number of components currently being read.
+  uint32_t outstanding_reads_ = 0;
+
+  /// Announced components not yet being read, as (position, input node).
+  std::priority_queue<std::pair<uint64_t, uint_fast16_t>,
+                      std::vector<std::pair<uint64_t, uint_fast16_t>>,
+                      std::greater<>>
+      pending_reads_;
+
+  /// Average data size per core microslice of the recent timeslices.
+  double microslice_bytes_ = 0;
+
+  /// The shared receive queue (if enabled).
+  struct ibv_srq* srq_ = nullptr;
+
+  /// Receive buffers of the shared receive queue, one per input node.
+  std::vector<InputChannelStatusMessage> srq_messages_;
+
+  /// Memory region of the shared receive buffers.
+  struct ibv_mr* mr_srq_ = nullptr;
+
+  /// Connection index by queue pair number (with shared receive queue).
+  std::unordered_map<uint32_t, uint_fast16_t> qp_index_;
+
+  /// Requested buffer size exponents, data << 32 | desc (0: none).
+  std::atomic<uint64_t> resize_request_{0};
+
+  /// Buffer size exponents of the resize in progress.
+  uint32_t resize_data_exp_ = 0;
+  uint32_t resize_desc_exp_ = 0;
+
+  /// Position up to which the buffer is drained before the resize in
+  /// progress (0: none).
+  uint64_t resize_barrier_ = 0;
 
   size_t red_lantern_ = 0;
+  /// Whether the slowest input node has written in the current batch.
+  bool red_lantern_written_ = false;
   uint64_t completely_written_ = 0;
   uint64_t acked_ = 0;
 
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
-
   volatile sig_atomic_t* signal_status_;
   bool drop_;
 
+  PlacementPolicy placement_policy_;
+  uint32_t placement_epoch_;
+
+  /// Latest epoch for which placement credit has been announced.
+  uint64_t credit_epoch_ = 0;
+
+  /// Acknowledged buffer positions at the latest credit announcement.
+  std::vector<ComputeNodeBufferPosition> credit_acked_;
+
+  /// Average fraction of the receive buffers released per credit epoch.
+  double drain_per_epoch_ = 0;
+
   std::vector<ComputeNodeConnection::BufferStatus>
       previous_recv_buffer_status_desc_;
   std::vector<ComputeNodeConnection::BufferStatus>
@@ -76,4 +246,33 @@ private:
 
   cbm::Monitor* monitor_;
   std::string hostname_;
+
+  /// Latency from the first to the last contribution of a timeslice (in us).
+  cbm::MetricHistogram build_latency_;
+
+  /// Latency from sending a work item to its completion (in us).
+  cbm::MetricHistogram item_latency_;
+
+  /// Latencies of the lifecycle stages of the timeslice components (in
+  /// us): from the first to the last microslice in the input buffer, from
+  /// then to posting, and from posting to being written.
+  cbm::MetricHistogram lifecycle_available_;
+  cbm::MetricHistogram lifecycle_wait_;
+  cbm::MetricHistogram lifecycle_transfer_;
+
+  /// Latency from the first microslice of a timeslice in any input buffer
+  /// to the completion of its work item (in us).
+  cbm::MetricHistogram lifecycle_total_;
+
+  /// Earliest input buffer time of each timeslice (in ns, local clock).
+  RingBuffer<uint64_t> ts_origin_;
+
+  /// Record the lifecycle latencies of newly written components.
+  void record_lifecycle(size_t in, uint64_t previously_written);
+
+  /// Number of timeslices with a contribution from at least one input node.
+  uint64_t first_written_ = 0;
+
+  /// Time of the first contribution or of the work item of each timeslice.
+  RingBuffer<std::chrono::steady_clock::time_point> ts_time_;
 };
@@ -0,0 +1,31 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#pragma pack(1)
+
+/// Structure carrying the input node timestamps of a timeslice component.
+/** If enabled, an input channel writes this record to the compute node
+    along with each component descriptor, at the same buffer position. All
+    times are in nanoseconds of the system clock of the input node. The
+    timestamps of the latest compute node status message let the compute
+    node estimate the clock offset (see ClockOffset). */
+struct TimesliceLifecycle {
+  uint64_t first_available; ///< First microslice seen in the input buffer
+  uint64_t last_available;  ///< Last microslice seen in the input buffer
+  uint64_t posted;          ///< Component posted to the send queue
+  uint64_t status_sent;     ///< Latest status message sent (compute node)
+  uint64_t status_received; ///< Latest status message received
+};
+
+#pragma pack()
+
+/// Retrieve the current time as used for the lifecycle timestamps.
+inline uint64_t lifecycle_now() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
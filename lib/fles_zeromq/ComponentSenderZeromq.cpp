@@ -2,9 +2,18 @@
 
 #include "ComponentSenderZeromq.hpp"
 #include "MicrosliceDescriptor.hpp"
+#include "RawDataChannel.hpp"
 #include "Utility.hpp"
 #include "log.hpp"
 #include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+void release_buffer(void* /* data */, void* hint) {
+  delete static_cast<std::vector<uint8_t>*>(hint);
+}
+} // namespace
 
 ComponentSenderZeromq::ComponentSenderZeromq(
     uint64_t input_index,
@@ -14,20 +23,25 @@ ComponentSenderZeromq::ComponentSenderZeromq(
     uint32_t overlap_size,
     uint32_t max_timeslice_number,
     volatile sig_atomic_t* signal_status,
-    void* zmq_context)
+    void* zmq_context,
+    uint16_t data_port,
+    bool pipelined,
+    const WireCompressionConfig& compression,
+    bool zerocopy)
     : input_index_(input_index), data_source_(data_source),
       timeslice_size_(timeslice_size), overlap_size_(overlap_size),
       max_timeslice_number_(max_timeslice_number),
-      signal_status_(signal_status),
-      min_acked_({data_source.desc_buffer().size() / 4,
-                  data_source.data_buffer().size() / 4}) {
+      signal_status_(signal_status), pipelined_(pipelined),
+      compression_(compression), zerocopy_(zerocopy),
+      ack_coalescing_(data_source.desc_buffer().size() / 4,
+                      data_source.data_buffer().size() / 4) {
   start_index_ = sent_ = acked_ = cached_acked_ = data_source.get_read_index();
 
   size_t min_ack_buffer_size =
       (data_source_.desc_buffer().size() / timeslice_size_ + 1) * 2;
   ack_.alloc_with_size(min_ack_buffer_size);
 
-  socket_ = zmq_socket(zmq_context, ZMQ_REP);
+  socket_ = zmq_socket(zmq_context, pipelined_ ? ZMQ_ROUTER : ZMQ_REP);
   assert(socket_);
   int timeout_ms = 500;
   [[maybe_unused]] int rc =
@@ -38,6 +52,14 @@ ComponentSenderZeromq::ComponentSenderZeromq(
 
   rc = zmq_bind(socket_, listen_address.c_str());
   assert(rc == 0);
+
+  if (data_port != 0) {
+    data_listen_fd_ = raw_data_listen(data_port);
+  }
+  if (compression_.enabled()) {
+    compressor_ = std::make_unique<WireCompressor>(compression_.level,
+                                                   compression_.threads);
+  }
 }
 
 ComponentSenderZeromq::~ComponentSenderZeromq() {
@@ -45,6 +67,10 @@ ComponentSenderZeromq::~ComponentSenderZeromq() {
     [[maybe_unused]] int rc = zmq_close(socket_);
     assert(rc == 0);
   }
+  for (auto& [compute_index, fd] : data_fds_) {
+    raw_data_close(fd);
+  }
+  raw_data_close(data_listen_fd_);
 }
 
 void ComponentSenderZeromq::operator()() {
@@ -60,10 +86,19 @@ void ComponentSenderZeromq::run_begin() {
   data_source_.proceed();
   time_begin_ = std::chrono::high_resolution_clock::now();
   report_status();
+  scheduler_.add_repeating([this] { report_status(); },
+                           std::chrono::seconds(1));
 }
 
 bool ComponentSenderZeromq::run_cycle() {
   process_pending_acks();
+  process_zerocopy_completions();
+
+  if (pipelined_) {
+    run_cycle_pipelined();
+    data_source_.proceed();
+    return true;
+  }
 
   zmq_msg_t request;
   [[maybe_unused]] int rc = zmq_msg_init(&request);
@@ -76,59 +111,240 @@ bool ComponentSenderZeromq::run_cycle() {
   }
   assert(len != -1);
 
-  assert(len == sizeof(uint64_t));
-  uint64_t timeslice = *static_cast<uint64_t*>(zmq_msg_data(&request));
+  Request r = decode_request(&request);
   zmq_msg_close(&request);
 
-  try_send_timeslice(timeslice);
+  try_send_timeslice(r);
   data_source_.proceed();
 
   return true;
 }
 
+void ComponentSenderZeromq::run_cycle_pipelined() {
+  // receive all queued requests, block (with timeout) only if idle
+  while (true) {
+    int flags = pending_requests_.empty() ? 0 : ZMQ_DONTWAIT;
+    zmq_msg_t identity;
+    zmq_msg_t request;
+    [[maybe_unused]] int rc = zmq_msg_init(&identity);
+    assert(rc == 0);
+    int len = zmq_msg_recv(&identity, socket_, flags);
+    if (len == -1 && errno == EAGAIN) {
+      zmq_msg_close(&identity);
+      break;
+    }
+    assert(len != -1);
+    assert(zmq_msg_more(&identity));
+    rc = zmq_msg_init(&request);
+    assert(rc == 0);
+    len = zmq_msg_recv(&request, socket_, 0);
+    assert(len != -1);
+    pending_requests_.push_back(decode_request(&request));
+    pending_requests_.back().identity =
+        std::string(static_cast<const char*>(zmq_msg_data(&identity)),
+                    zmq_msg_size(&identity));
+    zmq_msg_close(&identity);
+    zmq_msg_close(&request);
+  }
+
+  // Answer all requests that can be served. As requests of each compute
+  // node are increasing and timeslices become available in order, replies
+  // to each node stay in request order.
+  for (auto it = pending_requests_.begin(); it != pending_requests_.end();) {
+    if (*signal_status_ != 0) {
+      return;
+    }
+    if (timeslice_available(it->timeslice)) {
+      send_timeslice(*it, &it->identity);
+      it = pending_requests_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (!pending_requests_.empty()) {
+    // wait for more data to arrive in the input buffer
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+ComponentSenderZeromq::Request
+ComponentSenderZeromq::decode_request(zmq_msg_t* msg) {
+  // request: timeslice index, optionally followed by compute node index
+  // (to request raw data mode) and request flags
+  const std::size_t len = zmq_msg_size(msg);
+  assert(len == sizeof(uint64_t) || len == 2 * sizeof(uint64_t) ||
+         len == 3 * sizeof(uint64_t));
+  const auto* request_data = static_cast<uint64_t*>(zmq_msg_data(msg));
+  uint64_t flags = 0;
+  if (len == 2 * sizeof(uint64_t)) {
+    flags = zeromq_request_raw_data;
+  } else if (len == 3 * sizeof(uint64_t)) {
+    flags = request_data[2];
+  }
+  return {{},
+          request_data[0],
+          (flags & zeromq_request_raw_data) != 0,
+          len > sizeof(uint64_t) ? request_data[1] : 0,
+          (flags & zeromq_request_compression) != 0};
+}
+
 void ComponentSenderZeromq::run_end() {
   sync_data_source();
   time_end_ = std::chrono::high_resolution_clock::now();
+  if (zerocopy_) {
+    RawDataZerocopy total;
+    for (auto& [fd, zc] : zerocopy_channels_) {
+      total.issued += zc.state.issued;
+      total.copied += zc.state.copied;
+    }
+    L_(info) << "[i" << input_index_ << "] zero-copy: " << total.issued
+             << " send calls, " << total.copied << " copied by kernel";
+  }
+  if (compressor_) {
+    L_(info) << "[i" << input_index_ << "] compression: "
+             << compressor_->statistics().summary();
+  }
 }
 
-void enqueue_ack(void* /* data */, void* hint) {
+void release_ack(void* /* data */, void* hint) {
   assert(hint);
-  auto* ack = static_cast<ComponentSenderZeromq::Acknowledgment*>(hint);
-  // enqueue achnowledgment for later processing by the classes own thread
-  std::lock_guard<std::mutex> lock(ack->server->pending_acks_mutex_);
-  ack->server->pending_acks_.emplace(ack);
+  auto* slot = static_cast<ComponentSenderZeromq::AckSlot*>(hint);
+  // mark acknowledgment for later processing by the classes own thread
+  slot->acked.store(slot->ts2 + 1, std::memory_order_release);
 }
 
 void ComponentSenderZeromq::process_pending_acks() {
-  std::lock_guard<std::mutex> lock(pending_acks_mutex_);
-  while (!pending_acks_.empty()) {
-    auto* ack = pending_acks_.front();
-    ack_timeslice(ack->timeslice, ack->is_data);
-    delete ack; // NOLINT
-    pending_acks_.pop();
+  // completions for later timeslices are kept until the earliest pending
+  // timeslice is complete
+  uint64_t acked_ts2 = acked_ts2_;
+  while (ack_.at(acked_ts2).acked.load(std::memory_order_acquire) ==
+         acked_ts2 + 1) {
+    ++acked_ts2;
+  }
+  if (acked_ts2 == acked_ts2_) {
+    return;
+  }
+  acked_ts2_ = acked_ts2;
+  acked_.desc = acked_ts2_ / 2 * timeslice_size_ + start_index_.desc;
+  acked_.data = data_source_.desc_buffer().at(acked_.desc - 1).offset +
+                data_source_.desc_buffer().at(acked_.desc - 1).size;
+  // release buffer space the sooner the fuller the buffer is
+  if (ack_coalescing_.due(acked_.desc - cached_acked_.desc,
+                          acked_.data - cached_acked_.data, buffer_fill())) {
+    cached_acked_ = acked_;
+    data_source_.set_read_index(cached_acked_);
+  }
+}
+
+void ComponentSenderZeromq::process_zerocopy_completions() {
+  for (auto& [fd, zc] : zerocopy_channels_) {
+    if (zc.pending.empty()) {
+      continue;
+    }
+    raw_data_zerocopy_poll(fd, zc.state);
+    while (!zc.pending.empty() &&
+           zc.pending.front().first <= zc.state.completed) {
+      ack_timeslice(zc.pending.front().second, true);
+      zc.pending.pop_front();
+    }
+  }
+}
+
+void ComponentSenderZeromq::accept_data_connections() {
+  int fd;
+  while ((fd = raw_data_accept(data_listen_fd_)) != -1) {
+    // the connecting compute node identifies itself with its index
+    uint64_t compute_index;
+    if (!raw_data_recv(fd, &compute_index, sizeof(compute_index),
+                       signal_status_)) {
+      raw_data_close(fd);
+      return;
+    }
+    auto it = data_fds_.find(compute_index);
+    if (it != data_fds_.end()) {
+      // the data of a replaced connection is not sent anymore
+      auto zc = zerocopy_channels_.find(it->second);
+      if (zc != zerocopy_channels_.end()) {
+        for (const auto& pending : zc->second.pending) {
+          ack_timeslice(pending.second, true);
+        }
+        zerocopy_channels_.erase(zc);
+      }
+      raw_data_close(it->second);
+    }
+    data_fds_[compute_index] = fd;
+    if (zerocopy_) {
+      if (raw_data_enable_zerocopy(fd)) {
+        zerocopy_channels_[fd] = {};
+      } else {
+        L_(warning) << "[i" << input_index_ << "] zero-copy sends to c"
+                    << compute_index << " not supported, copying";
+      }
+    }
+    L_(debug) << "[i" << input_index_ << "] raw data channel to c"
+              << compute_index << " connected";
+  }
+}
+
+int ComponentSenderZeromq::data_fd(uint64_t compute_index) {
+  if (data_listen_fd_ == -1) {
+    throw std::runtime_error("raw data mode requested, but not enabled");
+  }
+  // the data connection is established before the first request is sent
+  accept_data_connections();
+  auto it = data_fds_.find(compute_index);
+  while (it == data_fds_.end() && *signal_status_ == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    accept_data_connections();
+    it = data_fds_.find(compute_index);
+  }
+  return it != data_fds_.end() ? it->second : -1;
+}
+
+bool ComponentSenderZeromq::timeslice_available(uint64_t ts) {
+  uint64_t desc_end =
+      ts * timeslice_size_ + start_index_.desc + timeslice_size_ +
+      overlap_size_;
+  if (write_index_desc_ < desc_end) {
+    data_source_.proceed();
+    write_index_desc_ = data_source_.get_write_index().desc;
   }
+  return write_index_desc_ >= desc_end;
 }
 
-bool ComponentSenderZeromq::try_send_timeslice(uint64_t ts) {
+bool ComponentSenderZeromq::try_send_timeslice(const Request& request) {
+  assert(request.timeslice >= acked_ts2_ / 2);
+
+  // check if complete timeslice is available in the input buffer
+  if (!timeslice_available(request.timeslice)) {
+    // send empty message
+    zmq_msg_t msg;
+    zmq_msg_init_size(&msg, 0);
+    int rc;
+    do {
+      rc = zmq_msg_send(&msg, socket_, 0);
+    } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+    return false;
+  }
+
+  send_timeslice(request);
+  return true;
+}
+
+void ComponentSenderZeromq::send_timeslice(const Request& request,
+                                           const std::string* identity) {
+  const uint64_t ts = request.timeslice;
   assert(ts >= acked_ts2_ / 2);
 
   uint64_t desc_offset = ts * timeslice_size_ + start_index_.desc;
   uint64_t desc_length = timeslice_size_ + overlap_size_;
 
-  // check if complete timeslice is available in the input buffer
-  if (write_index_desc_ < desc_offset + desc_length) {
-    data_source_.proceed();
-    write_index_desc_ = data_source_.get_write_index().desc;
-    if (write_index_desc_ < desc_offset + desc_length) {
-      // send empty message
-      zmq_msg_t msg;
-      zmq_msg_init_size(&msg, 0);
-      int rc;
-      do {
-        rc = zmq_msg_send(&msg, socket_, 0);
-      } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
-      return false;
-    }
+  int rc;
+  if (identity != nullptr) {
+    // part 0: peer identity for ROUTER socket
+    do {
+      rc = zmq_send(socket_, identity->data(), identity->size(), ZMQ_SNDMORE);
+    } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
   }
 
   // part 1: descriptors
@@ -137,7 +353,6 @@ bool ComponentSenderZeromq::try_send_timeslice(uint64_t ts) {
   }
   auto desc_msg = create_message(data_source_.desc_buffer(), desc_offset,
                                  desc_length, ts, false);
-  int rc;
   do {
     rc = zmq_msg_send(&desc_msg, socket_, ZMQ_SNDMORE);
   } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
@@ -153,15 +368,107 @@ bool ComponentSenderZeromq::try_send_timeslice(uint64_t ts) {
   if (data_offset + data_length > sent_.data) {
     sent_.data = data_offset + data_length;
   }
+
+  if (request.raw_data) {
+    // part 2 announces the data size, data follows on raw data channel
+    int fd = data_fd(request.compute_index);
+    if (fd == -1) {
+      return;
+    }
+    zmq_msg_t size_msg;
+    zmq_msg_init_size(&size_msg, sizeof(data_length));
+    std::copy_n(reinterpret_cast<const uint8_t*>(&data_length),
+                sizeof(data_length),
+                static_cast<uint8_t*>(zmq_msg_data(&size_msg)));
+    do {
+      rc = zmq_msg_send(&size_msg, socket_, 0);
+    } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+    send_raw_data(fd, data_offset, data_length, ts);
+    return;
+  }
+
+  // compress the data of selected subsystems, if accepted by the receiver
+  const uint8_t sys_id = data_source_.desc_buffer().at(desc_offset).sys_id;
+  if (request.compression && compressor_ && data_length > 0 &&
+      compression_.selects(sys_id) &&
+      send_compressed(data_offset, data_length, ts)) {
+    return;
+  }
+
   auto data_msg = create_message(data_source_.data_buffer(), data_offset,
                                  data_length, ts, true);
   do {
     rc = zmq_msg_send(&data_msg, socket_, 0);
   } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+}
+
+bool ComponentSenderZeromq::send_compressed(uint64_t offset,
+                                            uint64_t length,
+                                            uint64_t ts) {
+  iovec iov[2];
+  int iovcnt = data_chunks(offset, length, iov);
+  auto compressed = compressor_->compress(iov, iovcnt);
+  if (!compressed) {
+    return false;
+  }
+
+  // part 2: compressed data, owned by the message
+  int rc;
+  zmq_msg_t data_msg;
+  auto* buffer = compressed.release();
+  zmq_msg_init_data(&data_msg, buffer->data(), buffer->size(), release_buffer,
+                    buffer);
+  do {
+    rc = zmq_msg_send(&data_msg, socket_, ZMQ_SNDMORE);
+  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+  // the input data is no longer referenced
+  ack_timeslice(ts, true);
 
+  // part 3: uncompressed size
+  do {
+    rc = zmq_send(socket_, &length, sizeof(length), 0);
+  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
   return true;
 }
 
+int ComponentSenderZeromq::data_chunks(uint64_t offset,
+                                       uint64_t length,
+                                       iovec* iov) {
+  auto& buf = data_source_.data_buffer();
+  int iovcnt = 0;
+  if (length > 0) {
+    uint64_t pos = offset & buf.size_mask();
+    uint64_t size1 = std::min(length, buf.size() - pos);
+    iov[iovcnt++] = {&buf.at(offset), size1};
+    if (size1 < length) {
+      iov[iovcnt++] = {buf.ptr(), length - size1};
+    }
+  }
+  return iovcnt;
+}
+
+void ComponentSenderZeromq::send_raw_data(int fd,
+                                          uint64_t offset,
+                                          uint64_t length,
+                                          uint64_t ts) {
+  iovec iov[2];
+  int iovcnt = data_chunks(offset, length, iov);
+  auto zc = zerocopy_channels_.find(fd);
+  if (zc != zerocopy_channels_.end() && length >= zerocopy_min_size) {
+    // the data is referenced until the kernel reports completion
+    if (raw_data_send_zerocopy(fd, iov, iovcnt, signal_status_,
+                               zc->second.state)) {
+      zc->second.pending.emplace_back(zc->second.state.issued, ts);
+      process_zerocopy_completions();
+    }
+    return;
+  }
+  // sent from the input buffer directly, so data can be released afterwards
+  if (raw_data_send(fd, iov, iovcnt, signal_status_)) {
+    ack_timeslice(ts, true);
+  }
+}
+
 template <typename T_>
 zmq_msg_t ComponentSenderZeromq::create_message(RingBufferView<T_>& buf,
                                                 uint64_t offset,
@@ -179,8 +486,10 @@ zmq_msg_t ComponentSenderZeromq::create_message(RingBufferView<T_>& buf,
     // one chunk
     auto* data = &buf.at(offset);
     size_t bytes = sizeof(T_) * length;
-    auto* hint = new Acknowledgment{this, ts, is_data}; // NOLINT
-    zmq_msg_init_data(&msg, data, bytes, enqueue_ack, hint);
+    const uint64_t ts2 = ts * 2 + (is_data ? 1 : 0);
+    AckSlot& slot = ack_.at(ts2);
+    slot.ts2 = ts2;
+    zmq_msg_init_data(&msg, data, bytes, release_ack, &slot);
   } else {
     // two chunks
     auto* data1 = &buf.at(offset);
@@ -201,22 +510,10 @@ void ComponentSenderZeromq::ack_timeslice(uint64_t ts, bool is_data) {
   // use ts2 and acked_ts2_ to handle desc and data sequentially
   uint64_t ts2 = ts * 2 + (is_data ? 1 : 0);
   assert(ts2 >= acked_ts2_);
-  if (ts2 != acked_ts2_) {
-    // transmission has been reordered, store completion information
-    ack_.at(ts2) = ts2;
-  } else {
-    // completion is for earliest pending timeslice, update indices
-    do {
-      ++acked_ts2_;
-    } while (ack_.at(acked_ts2_) > ts2);
-    acked_.desc = acked_ts2_ / 2 * timeslice_size_ + start_index_.desc;
-    acked_.data = data_source_.desc_buffer().at(acked_.desc - 1).offset +
-                  data_source_.desc_buffer().at(acked_.desc - 1).size;
-    if (acked_.data >= cached_acked_.data + min_acked_.data ||
-        acked_.desc >= cached_acked_.desc + min_acked_.desc) {
-      cached_acked_ = acked_;
-      data_source_.set_read_index(cached_acked_);
-    }
+  // a reordered completion is stored until the earlier ones are complete
+  ack_.at(ts2).acked.store(ts2 + 1, std::memory_order_relaxed);
+  if (ts2 == acked_ts2_) {
+    process_pending_acks();
   }
 }
 
@@ -227,9 +524,16 @@ void ComponentSenderZeromq::sync_data_source() {
   }
 }
 
-void ComponentSenderZeromq::report_status() {
-  constexpr auto interval = std::chrono::seconds(1);
+double ComponentSenderZeromq::buffer_fill() const {
+  uint64_t written_desc = std::max(write_index_desc_, sent_.desc);
+  double fill_desc = static_cast<double>(written_desc - cached_acked_.desc) /
+                     static_cast<double>(data_source_.desc_buffer().size());
+  double fill_data = static_cast<double>(sent_.data - cached_acked_.data) /
+                     static_cast<double>(data_source_.data_buffer().size());
+  return std::max(fill_desc, fill_data);
+}
 
+void ComponentSenderZeromq::report_status() {
   std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
 
   DualIndex written = data_source_.get_write_index();
@@ -270,6 +574,11 @@ void ComponentSenderZeromq::report_status() {
             << human_readable_count(status_data.acked, true) << " ("
             << human_readable_count(rate_data, true, "B/s") << ")";
 
+  if (compressor_) {
+    L_(debug) << "[i" << input_index_ << "] compression "
+              << compressor_->statistics().summary();
+  }
+
   L_(info) << "[i" << input_index_ << "] |"
            << bar_graph(status_data.vector(), "#x._", 20) << "|"
            << bar_graph(status_desc.vector(), "#x._", 10) << "| "
@@ -278,6 +587,4 @@ void ComponentSenderZeromq::report_status() {
 
   previous_send_buffer_status_desc_ = status_desc;
   previous_send_buffer_status_data_ = status_data;
-
-  scheduler_.add([this] { report_status(); }, now + interval);
 }
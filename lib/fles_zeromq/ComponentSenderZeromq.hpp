@@ -1,13 +1,20 @@
 // Copyright 2012-2013, 2016 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "AckCoalescing.hpp"
 #include "DualRingBuffer.hpp"
+#include "RawDataChannel.hpp"
 #include "RingBuffer.hpp"
 #include "Scheduler.hpp"
+#include "WireCompression.hpp"
 #include <boost/format.hpp>
+#include <atomic>
 #include <cassert>
 #include <csignal>
-#include <mutex>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
 #include <zmq.h>
 
 /// Input buffer and compute node connection container class.
@@ -18,6 +25,17 @@
 class ComponentSenderZeromq {
 public:
   /// The ComponentSenderZeromq default constructor.
+  /** If data_port is non-zero, the content of timeslice components requested
+      in raw data mode is sent over a plain TCP connection accepted on this
+      port (see RawDataChannel.hpp). If pipelined is set, a ROUTER socket
+      is used that accepts several outstanding requests per compute node
+      (from a TimesliceBuilderZeromq with a request window) and defers
+      answering requests for timeslices that are not yet available. The data
+      of the components of the subsystems selected in compression is sent
+      compressed to compute nodes that accept it (see WireCompression.hpp).
+      If zerocopy is set, the raw data channel sends large components with
+      MSG_ZEROCOPY directly from the input buffer, which is released only
+      once the kernel has completed the transfer. */
   ComponentSenderZeromq(uint64_t input_index,
                         InputBufferReadInterface& data_source,
                         const std::string& listen_address,
@@ -25,7 +43,11 @@ public:
                         uint32_t overlap_size,
                         uint32_t max_timeslice_number,
                         volatile sig_atomic_t* signal_status,
-                        void* zmq_context);
+                        void* zmq_context,
+                        uint16_t data_port = 0,
+                        bool pipelined = false,
+                        const WireCompressionConfig& compression = {},
+                        bool zerocopy = false);
 
   ComponentSenderZeromq(const ComponentSenderZeromq&) = delete;
   void operator=(const ComponentSenderZeromq&) = delete;
@@ -46,7 +68,7 @@ public:
     return "CS/ZMQ/i" + std::to_string(input_index_);
   };
 
-  friend void enqueue_ack(void* data, void* hint);
+  friend void release_ack(void* data, void* hint);
 
 private:
   /// This component's index in the list of input components.
@@ -70,20 +92,68 @@ private:
   /// ZeroMQ socket.
   void* socket_;
 
-  struct Acknowledgment {
-    ComponentSenderZeromq* server;
+  /// Use a ROUTER socket with deferred replies.
+  const bool pipelined_;
+
+  /// A timeslice request received on the ROUTER socket.
+  struct Request {
+    std::string identity;
     uint64_t timeslice;
-    bool is_data;
+    bool raw_data;
+    uint64_t compute_index;
+    bool compression;
   };
 
-  /// Queue to store pending acknowledgments.
-  std::queue<Acknowledgment*> pending_acks_;
+  /// Decode a timeslice request message.
+  static Request decode_request(zmq_msg_t* msg);
+
+  /// Configuration of the compression on the wire.
+  const WireCompressionConfig compression_;
+
+  /// Compressor (if compression is enabled).
+  std::unique_ptr<WireCompressor> compressor_;
+
+  /// Requests not yet answered (pipelined mode only).
+  std::deque<Request> pending_requests_;
+
+  /// Listening socket of the raw data channel (or -1 if disabled).
+  int data_listen_fd_ = -1;
+
+  /// Raw data channel sockets, indexed by compute node.
+  std::map<uint64_t, int> data_fds_;
 
-  /// Mutex to manage access to the pending_acks_ queue.
-  std::mutex pending_acks_mutex_;
+  /// Use zero-copy sends on the raw data channel.
+  const bool zerocopy_;
+
+  /// Minimum component data size to be sent without copying.
+  /** Below this, the cost of pinning pages and handling the completion
+      exceeds that of copying. */
+  static constexpr uint64_t zerocopy_min_size = 16 * 1024;
+
+  /// Zero-copy state of a raw data channel socket.
+  struct ZerocopyChannel {
+    RawDataZerocopy state;
+    /// Sent timeslices: send calls to be completed before acknowledgment
+    std::deque<std::pair<uint64_t, uint64_t>> pending;
+  };
+
+  /// Zero-copy state of raw data channel sockets, indexed by socket.
+  std::map<int, ZerocopyChannel> zerocopy_channels_;
+
+  /// Acknowledgment status of a timeslice component part.
+  /** The entry of a zero-copy message is passed as the hint of its free
+      function, which is called by a ZeroMQ I/O thread. It marks the entry
+      as acknowledged, and the entries are collected in order by the
+      sender thread, so no allocation or lock is needed per message. */
+  struct AckSlot {
+    /// The index (timeslice times two, plus one for data) of the part
+    uint64_t ts2 = 0;
+    /// The index plus one once acknowledged
+    std::atomic<uint64_t> acked{0};
+  };
 
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
+  /// Buffer to store acknowledged status of timeslices, indexed by ts2.
+  RingBuffer<AckSlot, true> ack_;
 
   /// Number of acknowledged timeslices (times two - desc and data).
   uint64_t acked_ts2_ = 0;
@@ -92,7 +162,7 @@ private:
   DualIndex acked_{};
 
   /// Hysteresis for writing read indexes to data source.
-  const DualIndex min_acked_;
+  const AckCoalescing ack_coalescing_;
 
   /// Read indexes last written to data source.
   DualIndex cached_acked_{};
@@ -179,11 +249,47 @@ private:
   /// Cleanup at end of run.
   void run_end();
 
-  /// Process the pending acknowledgments received from a ZeroMQ thread.
+  /// Process the acknowledgments received from a ZeroMQ thread, updating
+  /// the read indexes.
   void process_pending_acks();
 
+  /// Acknowledge timeslices whose zero-copy sends have completed.
+  void process_zerocopy_completions();
+
+  /// Accept pending raw data channel connections.
+  void accept_data_connections();
+
+  /// Retrieve the raw data channel socket of a compute node.
+  int data_fd(uint64_t compute_index);
+
+  /// Receive requests and answer those that can be served (pipelined mode).
+  void run_cycle_pipelined();
+
+  /// Check if a timeslice is completely available in the input buffer.
+  bool timeslice_available(uint64_t ts);
+
   /// The central function for distributing timeslice data.
-  bool try_send_timeslice(uint64_t ts);
+  /** If raw_data is set, data is sent over the raw data channel of the given
+      compute node. */
+  bool try_send_timeslice(const Request& request);
+
+  /// Send the data of an available timeslice (optionally prefixed by a
+  /// ROUTER identity part).
+  void send_timeslice(const Request& request,
+                      const std::string* identity = nullptr);
+
+  /// Try to send component data compressed, followed by a part holding the
+  /// uncompressed size. Returns false if the data is not compressible.
+  bool send_compressed(uint64_t offset, uint64_t length, uint64_t ts);
+
+  /// Retrieve the (one or two) chunks of component data in the buffer.
+  int data_chunks(uint64_t offset, uint64_t length, iovec* iov);
+
+  /// Send component data over the raw data channel.
+  void send_raw_data(int fd,
+                     uint64_t offset,
+                     uint64_t length,
+                     uint64_t ts);
 
   /// Create zeromq message part with requested data.
   template <typename T_>
@@ -199,6 +305,9 @@ private:
   /// Force writing read indexes to data source.
   void sync_data_source();
 
+  /// Fill level of the input buffer (maximum of desc and data, 0 to 1).
+  [[nodiscard]] double buffer_fill() const;
+
   /// Print a (periodic) buffer status report.
   void report_status();
 };
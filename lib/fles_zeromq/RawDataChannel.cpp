@@ -0,0 +1,277 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "RawDataChannel.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+/// Timeout for blocking socket operations to allow checking signal status.
+constexpr int raw_data_timeout_ms = 500;
+
+std::runtime_error raw_data_error(const std::string& what) {
+  return std::runtime_error("raw data channel: " + what + ": " +
+                            std::strerror(errno));
+}
+
+void set_timeouts(int fd) {
+  timeval tv{raw_data_timeout_ms / 1000, (raw_data_timeout_ms % 1000) * 1000};
+  if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv) != 0 ||
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof tv) != 0) {
+    throw raw_data_error("setsockopt");
+  }
+}
+
+/// Advance iovec array by given number of bytes.
+void consume(struct iovec*& iov, int& iovcnt, std::size_t done) {
+  while (iovcnt > 0 && done >= iov->iov_len) {
+    done -= iov->iov_len;
+    ++iov;
+    --iovcnt;
+  }
+  if (iovcnt > 0) {
+    iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + done;
+    iov->iov_len -= done;
+  }
+}
+
+} // namespace
+
+int raw_data_listen(uint16_t port) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  addrinfo* res = nullptr;
+  int err = getaddrinfo(nullptr, std::to_string(port).c_str(), &hints, &res);
+  if (err != 0) {
+    throw std::runtime_error(std::string("raw data channel: getaddrinfo: ") +
+                             gai_strerror(err));
+  }
+
+  int fd = -1;
+  for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+    if (fd == -1) {
+      continue;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof on);
+    if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, 64) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(res);
+  if (fd == -1) {
+    throw raw_data_error("cannot listen on port " + std::to_string(port));
+  }
+
+  if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+    throw raw_data_error("fcntl");
+  }
+  return fd;
+}
+
+int raw_data_accept(int listen_fd) {
+  int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+  if (fd == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return -1;
+    }
+    throw raw_data_error("accept");
+  }
+  set_timeouts(fd);
+  return fd;
+}
+
+int raw_data_connect(const std::string& address,
+                     volatile sig_atomic_t* signal_status) {
+  auto colon = address.rfind(':');
+  if (colon == std::string::npos) {
+    throw std::runtime_error("raw data channel: invalid address: " + address);
+  }
+  std::string host = address.substr(0, colon);
+  std::string service = address.substr(colon + 1);
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  while (*signal_status == 0) {
+    addrinfo* res = nullptr;
+    int err = getaddrinfo(host.c_str(), service.c_str(), &hints, &res);
+    if (err != 0) {
+      throw std::runtime_error(std::string("raw data channel: getaddrinfo: ") +
+                               gai_strerror(err));
+    }
+    int fd = -1;
+    for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+      fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC,
+                  ai->ai_protocol);
+      if (fd == -1) {
+        continue;
+      }
+      if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+        break;
+      }
+      close(fd);
+      fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd != -1) {
+      set_timeouts(fd);
+      return fd;
+    }
+    // sender may not be listening yet
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  return -1;
+}
+
+bool raw_data_send(int fd,
+                   struct iovec* iov,
+                   int iovcnt,
+                   volatile sig_atomic_t* signal_status) {
+  while (iovcnt > 0) {
+    ssize_t n = writev(fd, iov, iovcnt);
+    if (n == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        if (*signal_status != 0) {
+          return false;
+        }
+        continue;
+      }
+      throw raw_data_error("writev");
+    }
+    consume(iov, iovcnt, static_cast<std::size_t>(n));
+  }
+  return true;
+}
+
+bool raw_data_enable_zerocopy(int fd) {
+#ifdef SO_ZEROCOPY
+  int on = 1;
+  return setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof on) == 0;
+#else
+  (void)fd;
+  return false;
+#endif
+}
+
+bool raw_data_send_zerocopy(int fd,
+                            struct iovec* iov,
+                            int iovcnt,
+                            volatile sig_atomic_t* signal_status,
+                            RawDataZerocopy& zc) {
+#ifdef MSG_ZEROCOPY
+  while (iovcnt > 0) {
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = static_cast<std::size_t>(iovcnt);
+    ssize_t n = sendmsg(fd, &msg, MSG_ZEROCOPY);
+    if (n == -1) {
+      if (errno == ENOBUFS) {
+        // too many pages pinned, wait for completions to unpin them
+        raw_data_zerocopy_poll(fd, zc);
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        if (*signal_status != 0) {
+          return false;
+        }
+        continue;
+      }
+      throw raw_data_error("sendmsg");
+    }
+    // every successful call is reported, even if partially sent
+    ++zc.issued;
+    consume(iov, iovcnt, static_cast<std::size_t>(n));
+  }
+  return true;
+#else
+  (void)zc;
+  return raw_data_send(fd, iov, iovcnt, signal_status);
+#endif
+}
+
+void raw_data_zerocopy_poll(int fd, RawDataZerocopy& zc) {
+#ifdef SO_EE_ORIGIN_ZEROCOPY
+  while (zc.completed < zc.issued) {
+    char control[128];
+    msghdr msg{};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof control;
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return;
+      }
+      throw raw_data_error("recvmsg");
+    }
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+         cm = CMSG_NXTHDR(&msg, cm)) {
+      if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+            (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))) {
+        continue;
+      }
+      sock_extended_err err{};
+      std::memcpy(&err, CMSG_DATA(cm), sizeof err);
+      if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY || err.ee_errno != 0) {
+        continue;
+      }
+      // TCP reports completed ranges [ee_info, ee_data] of 32-bit send call
+      // numbers in order
+      auto end = static_cast<uint32_t>(err.ee_data + 1);
+      zc.completed += static_cast<uint32_t>(
+          end - static_cast<uint32_t>(zc.completed));
+      if ((err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0) {
+        zc.copied += err.ee_data - err.ee_info + 1;
+      }
+    }
+  }
+#else
+  zc.completed = zc.issued;
+#endif
+}
+
+bool raw_data_recv(int fd,
+                   void* buf,
+                   std::size_t size,
+                   volatile sig_atomic_t* signal_status) {
+  auto* p = static_cast<uint8_t*>(buf);
+  while (size > 0) {
+    ssize_t n = recv(fd, p, size, MSG_WAITALL);
+    if (n == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        if (*signal_status != 0) {
+          return false;
+        }
+        continue;
+      }
+      throw raw_data_error("recv");
+    }
+    if (n == 0) {
+      throw std::runtime_error("raw data channel: connection closed by peer");
+    }
+    p += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+void raw_data_close(int fd) {
+  if (fd != -1) {
+    close(fd);
+  }
+}
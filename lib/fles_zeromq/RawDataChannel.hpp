@@ -0,0 +1,69 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/uio.h>
+
+/// Helper functions for the raw TCP data channel of the ZeroMQ transport.
+/** In raw data mode, the ZeroMQ REQ/REP connection is only used to request
+    timeslice components and to transfer the (small) microslice descriptors,
+    while the component contents are sent over a plain TCP connection. This
+    allows the receiver to read the content directly into its timeslice
+    buffer instead of copying it out of a ZeroMQ message. */
+
+/// Create a listening TCP socket on the given port (all interfaces).
+int raw_data_listen(uint16_t port);
+
+/// Accept a pending connection on listening socket, or return -1 if none.
+int raw_data_accept(int listen_fd);
+
+/// Connect to a raw data channel listening at "host:port". Retries until
+/// successful or the signal status is set, in which case -1 is returned.
+int raw_data_connect(const std::string& address,
+                     volatile sig_atomic_t* signal_status);
+
+/// Send all data described by the given iovec array.
+/** Returns false if interrupted by the signal status. */
+bool raw_data_send(int fd,
+                   struct iovec* iov,
+                   int iovcnt,
+                   volatile sig_atomic_t* signal_status);
+
+/// Zero-copy send state of a raw data channel socket.
+/** With MSG_ZEROCOPY, the kernel sends directly from the given memory and
+    reports the completion of each send call later. The memory must not be
+    reused before. */
+struct RawDataZerocopy {
+  uint64_t issued = 0;    ///< Number of zero-copy send calls issued
+  uint64_t completed = 0; ///< Number of send calls completed
+  uint64_t copied = 0;    ///< Number of send calls copied by the kernel
+};
+
+/// Enable zero-copy sends on a socket. Returns false if not supported.
+bool raw_data_enable_zerocopy(int fd);
+
+/// Send all data described by the given iovec array without copying.
+/** The memory is referenced until zc.completed reaches the value of
+    zc.issued after the call. Returns false if interrupted by the signal
+    status. */
+bool raw_data_send_zerocopy(int fd,
+                            struct iovec* iov,
+                            int iovcnt,
+                            volatile sig_atomic_t* signal_status,
+                            RawDataZerocopy& zc);
+
+/// Collect the pending zero-copy completions of a socket (non-blocking).
+void raw_data_zerocopy_poll(int fd, RawDataZerocopy& zc);
+
+/// Receive exactly size bytes into the given buffer.
+/** Returns false if interrupted by the signal status. */
+bool raw_data_recv(int fd,
+                   void* buf,
+                   std::size_t size,
+                   volatile sig_atomic_t* signal_status);
+
+/// Close a raw data channel socket (if valid).
+void raw_data_close(int fd);
@@ -2,10 +2,11 @@
 
 #include "TimesliceBuilderZeromq.hpp"
 #include "MicrosliceDescriptor.hpp"
-#include "TimesliceCompletion.hpp"
+#include "RawDataChannel.hpp"
 #include "TimesliceWorkItem.hpp"
 #include "Utility.hpp"
 #include "log.hpp"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <utility>
@@ -18,19 +19,24 @@ TimesliceBuilderZeromq::TimesliceBuilderZeromq(
     uint32_t timeslice_size,
     uint32_t max_timeslice_number,
     volatile sig_atomic_t* signal_status,
-    void* zmq_context)
+    void* zmq_context,
+    std::vector<std::string> data_server_addresses,
+    uint32_t request_window)
     : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
       input_server_addresses_(std::move(input_server_addresses)),
+      data_server_addresses_(std::move(data_server_addresses)),
+      request_window_(request_window > 0 ? request_window : 1),
       num_compute_nodes_(num_compute_nodes), timeslice_size_(timeslice_size),
       max_timeslice_number_(max_timeslice_number),
-      signal_status_(signal_status), ts_index_(compute_index_),
-      ack_(timeslice_buffer_.get_desc_size_exp()) {
+      signal_status_(signal_status), ts_index_(compute_index_) {
   for (size_t i = 0; i < input_server_addresses_.size(); ++i) {
     auto input_server_address = input_server_addresses_.at(i);
 
     std::unique_ptr<Connection> c(new Connection{timeslice_buffer_, i});
+    c->next_request = ts_index_;
 
-    c->socket = zmq_socket(zmq_context, ZMQ_REQ);
+    c->socket =
+        zmq_socket(zmq_context, request_window_ > 1 ? ZMQ_DEALER : ZMQ_REQ);
     assert(c->socket);
     int timeout_ms = 500;
     [[maybe_unused]] int rc =
@@ -53,6 +59,7 @@ TimesliceBuilderZeromq::~TimesliceBuilderZeromq() {
       [[maybe_unused]] int rc = zmq_close(c->socket);
       assert(rc == 0);
     }
+    raw_data_close(c->data_fd);
   }
 }
 
@@ -67,8 +74,23 @@ void TimesliceBuilderZeromq::operator()() {
 
 void TimesliceBuilderZeromq::run_begin() {
   assert(!connections_.empty());
+  assert(data_server_addresses_.empty() ||
+         data_server_addresses_.size() == connections_.size());
+  for (size_t i = 0; i < data_server_addresses_.size(); ++i) {
+    auto& c = connections_.at(i);
+    c->data_fd =
+        raw_data_connect(data_server_addresses_.at(i), signal_status_);
+    if (c->data_fd == -1) {
+      return;
+    }
+    // identify this compute node to the sender
+    iovec iov{const_cast<uint64_t*>(&compute_index_), sizeof(compute_index_)};
+    raw_data_send(c->data_fd, &iov, 1, signal_status_);
+  }
   time_begin_ = std::chrono::high_resolution_clock::now();
   report_status();
+  scheduler_.add_repeating([this] { report_status(); },
+                           std::chrono::seconds(1));
 }
 
 bool TimesliceBuilderZeromq::run_cycle() {
@@ -76,13 +98,32 @@ bool TimesliceBuilderZeromq::run_cycle() {
 
   std::size_t msg_size;
 
-  // send request for timeslice data
+  // send request(s) for timeslice data (followed by the compute node index
+  // and request flags in raw data mode or if compression is accepted); with
+  // a request window, keep up to request_window_ requests outstanding on
+  // each connection
+  const bool raw_data = (c->data_fd != -1);
+  const bool compression = !raw_data && wire_compression_supported();
   int rc;
-  do {
-    rc = zmq_send(c->socket, &ts_index_, sizeof(ts_index_), 0);
-  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
-  if (*signal_status_ != 0) {
-    return true;
+  const uint64_t window_end = ts_index_ + request_window_ * num_compute_nodes_;
+  while (c->next_request < window_end &&
+         c->next_request < max_timeslice_number_) {
+    const uint64_t request[3] = {c->next_request, compute_index_,
+                                 compression ? zeromq_request_compression
+                                             : zeromq_request_raw_data};
+    std::size_t request_size = sizeof(uint64_t);
+    if (compression) {
+      request_size = 3 * sizeof(uint64_t);
+    } else if (raw_data) {
+      request_size = 2 * sizeof(uint64_t);
+    }
+    do {
+      rc = zmq_send(c->socket, request, request_size, 0);
+    } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+    if (*signal_status_ != 0) {
+      return true;
+    }
+    c->next_request += num_compute_nodes_;
   }
 
   // receive desc answer (part 1), do not release
@@ -97,7 +138,9 @@ bool TimesliceBuilderZeromq::run_cycle() {
   assert(rc != -1);
   msg_size = zmq_msg_size(&c->desc_msg);
   if (msg_size == 0) {
+    // timeslice not yet available, request again (REQ/REP only)
     zmq_msg_close(&c->desc_msg);
+    c->next_request = ts_index_;
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
   }
 
@@ -117,8 +160,33 @@ bool TimesliceBuilderZeromq::run_cycle() {
   }
   assert(rc != -1);
 
-  uint64_t size_required =
-      zmq_msg_size(&c->desc_msg) + zmq_msg_size(&c->data_msg);
+  // in raw data mode, part 2 only announces the size of the data
+  uint64_t data_size = zmq_msg_size(&c->data_msg);
+  if (raw_data) {
+    assert(zmq_msg_size(&c->data_msg) == sizeof(uint64_t));
+    std::copy_n(static_cast<const uint8_t*>(zmq_msg_data(&c->data_msg)),
+                sizeof(data_size), reinterpret_cast<uint8_t*>(&data_size));
+  }
+
+  // compressed data is followed by part 3, the uncompressed size
+  const bool compressed = (zmq_msg_more(&c->data_msg) != 0);
+  if (compressed) {
+    zmq_msg_t size_msg;
+    rc = zmq_msg_init(&size_msg);
+    assert(rc == 0);
+    do {
+      rc = zmq_msg_recv(&size_msg, c->socket, 0);
+    } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+    if (*signal_status_ != 0) {
+      zmq_msg_close(&size_msg);
+      return true;
+    }
+    assert(zmq_msg_size(&size_msg) == sizeof(uint64_t));
+    std::copy_n(static_cast<const uint8_t*>(zmq_msg_data(&size_msg)),
+                sizeof(data_size), reinterpret_cast<uint8_t*>(&data_size));
+    zmq_msg_close(&size_msg);
+  }
+  uint64_t size_required = zmq_msg_size(&c->desc_msg) + data_size;
 
   while (c->data.size_available_contiguous() < size_required ||
          c->desc.size_available() < 1) {
@@ -138,8 +206,25 @@ bool TimesliceBuilderZeromq::run_cycle() {
   // copy into shared memory and release messages
   c->data.append(static_cast<uint8_t*>(zmq_msg_data(&c->desc_msg)),
                  zmq_msg_size(&c->desc_msg));
-  c->data.append(static_cast<uint8_t*>(zmq_msg_data(&c->data_msg)),
-                 zmq_msg_size(&c->data_msg));
+  if (raw_data) {
+    // receive data in place, the space is contiguous (see above)
+    if (!raw_data_recv(c->data_fd, c->data.write_ptr(), data_size,
+                       signal_status_)) {
+      zmq_msg_close(&c->desc_msg);
+      zmq_msg_close(&c->data_msg);
+      return true;
+    }
+    c->data.commit(data_size);
+  } else if (compressed) {
+    // decompress in place, the space is contiguous (see above)
+    decompressor_.decompress(zmq_msg_data(&c->data_msg),
+                             zmq_msg_size(&c->data_msg), c->data.write_ptr(),
+                             data_size);
+    c->data.commit(data_size);
+  } else {
+    c->data.append(static_cast<uint8_t*>(zmq_msg_data(&c->data_msg)),
+                   zmq_msg_size(&c->data_msg));
+  }
   zmq_msg_close(&c->desc_msg);
   zmq_msg_close(&c->data_msg);
 
@@ -164,6 +249,10 @@ bool TimesliceBuilderZeromq::run_cycle() {
 
 void TimesliceBuilderZeromq::run_end() {
   time_end_ = std::chrono::high_resolution_clock::now();
+  if (decompressor_.statistics().components > 0) {
+    L_(info) << "[c" << compute_index_ << "] decompression: "
+             << decompressor_.statistics().summary();
+  }
 
   // wait until all pending timeslices have been acknowledged
   while (acked_ < tpos_) {
@@ -177,26 +266,19 @@ void TimesliceBuilderZeromq::run_end() {
 }
 
 void TimesliceBuilderZeromq::handle_timeslice_completions() {
-  fles::TimesliceCompletion c{};
-  while (timeslice_buffer_.try_receive_completion(c)) {
-    if (c.ts_pos == acked_) {
-      do {
-        ++acked_;
-      } while (ack_.at(acked_) > c.ts_pos);
-      for (auto& conn : connections_) {
-        conn->desc.set_read_index(acked_);
-        conn->data.set_read_index(conn->desc.at(acked_ - 1).offset +
-                                  conn->desc.at(acked_ - 1).size);
-      }
-    } else {
-      ack_.at(c.ts_pos) = c.ts_pos;
-    }
+  timeslice_buffer_.receive_completions();
+  if (timeslice_buffer_.acked() == acked_) {
+    return;
+  }
+  acked_ = timeslice_buffer_.acked();
+  for (auto& conn : connections_) {
+    conn->desc.set_read_index(acked_);
+    conn->data.set_read_index(conn->desc.at(acked_ - 1).offset +
+                              conn->desc.at(acked_ - 1).size);
   }
 }
 
 void TimesliceBuilderZeromq::report_status() {
-  constexpr auto interval = std::chrono::seconds(1);
-
   std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
 
   // FIXME: dummy code here...
@@ -226,12 +308,15 @@ void TimesliceBuilderZeromq::report_status() {
             << " (used..free) | "
             << human_readable_count(status_data.acked, true);
 
+  if (decompressor_.statistics().components > 0) {
+    L_(debug) << "[c" << compute_index_ << "] decompression "
+              << decompressor_.statistics().summary();
+  }
+
   L_(info) << "[c" << compute_index_ << "] |"
            << bar_graph(status_data.vector(), "#._", 20) << "|"
            << bar_graph(status_desc.vector(), "#._", 10) << "| ";
 
   previous_buffer_status_desc_ = status_desc;
   previous_buffer_status_data_ = status_data;
-
-  scheduler_.add([this] { report_status(); }, now + interval);
 }
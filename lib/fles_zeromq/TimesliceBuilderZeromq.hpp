@@ -5,6 +5,7 @@
 #include "RingBuffer.hpp"
 #include "Scheduler.hpp"
 #include "TimesliceBuffer.hpp"
+#include "WireCompression.hpp"
 #include <boost/format.hpp>
 #include <cassert>
 #include <csignal>
@@ -22,6 +23,13 @@
 class TimesliceBuilderZeromq {
 public:
   /// The TimesliceBuilderZeromq constructor.
+  /** If data_server_addresses ("host:port", one per input server) is not
+      empty, component contents are received in raw data mode directly into
+      the timeslice buffer (see RawDataChannel.hpp). A request_window larger
+      than one selects a DEALER socket that keeps this number of requests
+      outstanding on each connection (for a pipelined ComponentSenderZeromq).
+      If supported by the build, compressed component data is accepted and
+      decompressed directly into the timeslice buffer. */
   TimesliceBuilderZeromq(uint64_t compute_index,
                          TimesliceBuffer& timeslice_buffer,
                          std::vector<std::string> input_server_addresses,
@@ -29,7 +37,9 @@ public:
                          uint32_t timeslice_size,
                          uint32_t max_timeslice_number,
                          volatile sig_atomic_t* signal_status,
-                         void* zmq_context);
+                         void* zmq_context,
+                         std::vector<std::string> data_server_addresses = {},
+                         uint32_t request_window = 1);
 
   TimesliceBuilderZeromq(const TimesliceBuilderZeromq&) = delete;
   void operator=(const TimesliceBuilderZeromq&) = delete;
@@ -60,6 +70,12 @@ private:
   /// Vector of all input server addresses to connect to.
   const std::vector<std::string> input_server_addresses_;
 
+  /// Vector of all raw data channel addresses (empty if not used).
+  const std::vector<std::string> data_server_addresses_;
+
+  /// Maximum number of outstanding requests per connection.
+  const uint32_t request_window_;
+
   /// Number of compute nodes.
   const uint32_t num_compute_nodes_;
 
@@ -84,8 +100,8 @@ private:
   /// The index of the connection to receive from next.
   uint64_t conn_ = 0;
 
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
+  /// Decompressor for component data compressed on the wire.
+  WireDecompressor decompressor_;
 
   /// Connection struct, handles data for one input server.
   struct Connection {
@@ -99,6 +115,8 @@ private:
     ManagedRingBuffer<uint8_t> data;
 
     void* socket = nullptr;
+    int data_fd = -1;          ///< raw data channel socket
+    uint64_t next_request = 0; ///< global index of next ts to request
     zmq_msg_t desc_msg{};
     zmq_msg_t data_msg{};
   };
@@ -0,0 +1,199 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "WireCompression.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+WireCompressionConfig
+WireCompressionConfig::parse(const std::string& subsystems) {
+  WireCompressionConfig config;
+  if (subsystems.empty() || subsystems == "none") {
+    return config;
+  }
+  if (subsystems == "all") {
+    config.all = true;
+    return config;
+  }
+  std::istringstream list(subsystems);
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    std::size_t pos = 0;
+    unsigned long sys_id = 0;
+    try {
+      sys_id = std::stoul(item, &pos, 0);
+    } catch (const std::exception&) {
+      pos = 0;
+    }
+    if (pos == 0 || pos != item.size() || sys_id > 0xFF) {
+      throw std::invalid_argument("invalid subsystem identifier: " + item);
+    }
+    config.sys_ids.insert(static_cast<uint8_t>(sys_id));
+  }
+  return config;
+}
+
+std::string WireCompressionStatistics::summary() const {
+  std::ostringstream s;
+  s << components << " components, " << human_readable_count(raw_bytes)
+    << " -> " << human_readable_count(wire_bytes);
+  if (wire_bytes > 0) {
+    s << " (ratio " << std::fixed << std::setprecision(2)
+      << static_cast<double>(raw_bytes) / static_cast<double>(wire_bytes)
+      << ")";
+  }
+  s << ", " << std::fixed << std::setprecision(3) << seconds << " s";
+  if (seconds > 0.0) {
+    s << " ("
+      << human_readable_count(
+             static_cast<uint64_t>(static_cast<double>(raw_bytes) / seconds))
+      << "/s)";
+  }
+  return s.str();
+}
+
+bool wire_compression_supported() {
+#ifdef HAVE_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+WireCompressor::WireCompressor(int level, unsigned int threads) {
+#ifdef HAVE_ZSTD
+  auto* cctx = ZSTD_createCCtx();
+  if (cctx == nullptr) {
+    throw std::runtime_error("cannot create zstd compression context");
+  }
+  context_ = cctx;
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+  if (threads > 0) {
+    std::size_t err = ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers,
+                                             static_cast<int>(threads));
+    if (ZSTD_isError(err) != 0u) {
+      L_(warning) << "zstd library without multithreading support, "
+                  << "compressing in sender thread";
+    }
+  }
+#else
+  (void)level;
+  (void)threads;
+  throw std::runtime_error("wire compression requires zstd support");
+#endif
+}
+
+WireCompressor::~WireCompressor() {
+#ifdef HAVE_ZSTD
+  ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(context_));
+#endif
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+WireCompressor::compress(const iovec* chunks, int count) {
+#ifdef HAVE_ZSTD
+  auto start = std::chrono::steady_clock::now();
+  auto* cctx = static_cast<ZSTD_CCtx*>(context_);
+
+  std::size_t raw_size = 0;
+  for (int i = 0; i < count; ++i) {
+    raw_size += chunks[i].iov_len;
+  }
+  ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only);
+  ZSTD_CCtx_setPledgedSrcSize(cctx, raw_size);
+
+  // the output is useless unless smaller than the input
+  auto out = std::make_unique<std::vector<uint8_t>>(raw_size);
+  ZSTD_outBuffer output{out->data(), out->size(), 0};
+  bool fits = true;
+  for (int i = 0; i < count && fits; ++i) {
+    ZSTD_inBuffer input{chunks[i].iov_base, chunks[i].iov_len, 0};
+    auto mode = (i == count - 1) ? ZSTD_e_end : ZSTD_e_continue;
+    std::size_t remaining = 0;
+    do {
+      remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+      if (ZSTD_isError(remaining) != 0u) {
+        throw std::runtime_error(std::string("zstd compression failed: ") +
+                                 ZSTD_getErrorName(remaining));
+      }
+      if (output.pos == output.size &&
+          (remaining != 0 || input.pos < input.size)) {
+        fits = false;
+        break;
+      }
+    } while (mode == ZSTD_e_end ? remaining != 0 : input.pos < input.size);
+  }
+
+  ++statistics_.components;
+  statistics_.raw_bytes += raw_size;
+  statistics_.seconds += seconds_since(start);
+  if (!fits || output.pos >= raw_size) {
+    statistics_.wire_bytes += raw_size;
+    return nullptr;
+  }
+  statistics_.wire_bytes += output.pos;
+  out->resize(output.pos);
+  return out;
+#else
+  (void)chunks;
+  (void)count;
+  return nullptr;
+#endif
+}
+
+WireDecompressor::WireDecompressor() {
+#ifdef HAVE_ZSTD
+  context_ = ZSTD_createDCtx();
+  if (context_ == nullptr) {
+    throw std::runtime_error("cannot create zstd decompression context");
+  }
+#endif
+}
+
+WireDecompressor::~WireDecompressor() {
+#ifdef HAVE_ZSTD
+  ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(context_));
+#endif
+}
+
+void WireDecompressor::decompress(const void* src,
+                                  std::size_t src_size,
+                                  void* dst,
+                                  std::size_t dst_size) {
+#ifdef HAVE_ZSTD
+  auto start = std::chrono::steady_clock::now();
+  std::size_t size = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx*>(context_),
+                                         dst, dst_size, src, src_size);
+  if (ZSTD_isError(size) != 0u) {
+    throw std::runtime_error(std::string("zstd decompression failed: ") +
+                             ZSTD_getErrorName(size));
+  }
+  if (size != dst_size) {
+    throw std::runtime_error("decompressed component size mismatch");
+  }
+  ++statistics_.components;
+  statistics_.raw_bytes += dst_size;
+  statistics_.wire_bytes += src_size;
+  statistics_.seconds += seconds_since(start);
+#else
+  (void)src;
+  (void)src_size;
+  (void)dst;
+  (void)dst_size;
+  throw std::runtime_error("wire compression requires zstd support");
+#endif
+}
@@ -0,0 +1,110 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+/// Flags of a timeslice request ([timeslice, compute index, flags]).
+/** A request of only one (timeslice) or two words (raw data mode) is
+    answered without compression. */
+enum : uint64_t {
+  zeromq_request_raw_data = 1,   ///< Data is sent on the raw data channel
+  zeromq_request_compression = 2 ///< The requester accepts compressed data
+};
+
+/// Configuration of the component data compression on the wire.
+/** The data of the timeslice components of the selected subsystems is
+    compressed with zstd by a ComponentSenderZeromq if the requesting
+    TimesliceBuilderZeromq supports it. */
+struct WireCompressionConfig {
+  /// Compress the components of all subsystems.
+  bool all = false;
+
+  /// The subsystem identifiers of the components to compress.
+  std::set<uint8_t> sys_ids;
+
+  /// The zstd compression level.
+  int level = 1;
+
+  /// The number of compression worker threads (0: in the sender thread).
+  unsigned int threads = 0;
+
+  /// Parse a subsystem list ("all", "none" or comma-separated ids).
+  static WireCompressionConfig parse(const std::string& subsystems);
+
+  [[nodiscard]] bool enabled() const { return all || !sys_ids.empty(); }
+
+  [[nodiscard]] bool selects(uint8_t sys_id) const {
+    return all || sys_ids.count(sys_id) != 0;
+  }
+};
+
+/// Byte and time counters of the compression on the wire.
+struct WireCompressionStatistics {
+  uint64_t components = 0; ///< Number of (de)compressed components
+  uint64_t raw_bytes = 0;  ///< Uncompressed size
+  uint64_t wire_bytes = 0; ///< Compressed size
+  double seconds = 0.0;    ///< Time spent (de)compressing
+
+  /// Retrieve a one-line summary of ratio and throughput.
+  [[nodiscard]] std::string summary() const;
+};
+
+/// Whether the wire compression is supported by this build.
+bool wire_compression_supported();
+
+/// Compressor of component data for the wire.
+class WireCompressor {
+public:
+  /// Create a compressor, throws if not supported by this build.
+  WireCompressor(int level, unsigned int threads);
+
+  WireCompressor(const WireCompressor&) = delete;
+  void operator=(const WireCompressor&) = delete;
+
+  ~WireCompressor();
+
+  /// Compress the concatenation of the given chunks.
+  /** Returns nullptr if the data does not become smaller. */
+  std::unique_ptr<std::vector<uint8_t>> compress(const iovec* chunks,
+                                                 int count);
+
+  [[nodiscard]] const WireCompressionStatistics& statistics() const {
+    return statistics_;
+  }
+
+private:
+  void* context_ = nullptr;
+  WireCompressionStatistics statistics_;
+};
+
+/// Decompressor of component data received from the wire.
+class WireDecompressor {
+public:
+  WireDecompressor();
+
+  WireDecompressor(const WireDecompressor&) = delete;
+  void operator=(const WireDecompressor&) = delete;
+
+  ~WireDecompressor();
+
+  /// Decompress data of known uncompressed size to a given destination.
+  /** Throws std::runtime_error on corrupt data. */
+  void decompress(const void* src,
+                  std::size_t src_size,
+                  void* dst,
+                  std::size_t dst_size);
+
+  [[nodiscard]] const WireCompressionStatistics& statistics() const {
+    return statistics_;
+  }
+
+private:
+  void* context_ = nullptr;
+  WireCompressionStatistics statistics_;
+};
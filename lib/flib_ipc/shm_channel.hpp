@@ -4,12 +4,18 @@
 #pragma once
 
 #include "DualRingBuffer.hpp"
+#include "probes.hpp"
+#include "shm_event.hpp"
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/interprocess/sync/interprocess_condition.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <optional>
 
 namespace ip = boost::interprocess;
 
@@ -18,19 +24,67 @@ struct TimedDualIndex {
   boost::posix_time::ptime updated;
 };
 
+// DualIndex published by a single writer without locking (sequence lock).
+// Each instance occupies its own cache line.
+class alignas(64) PublishedDualIndex {
+public:
+  void store(const DualIndex index) {
+    uint64_t seq = m_seq.load(std::memory_order_relaxed);
+    m_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_desc.store(index.desc, std::memory_order_relaxed);
+    m_data.store(index.data, std::memory_order_relaxed);
+    m_seq.store(seq + 2, std::memory_order_release);
+  }
+
+  [[nodiscard]] DualIndex load() const {
+    while (true) {
+      uint64_t seq = m_seq.load(std::memory_order_acquire);
+      DualIndex index{m_desc.load(std::memory_order_relaxed),
+                      m_data.load(std::memory_order_relaxed)};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ((seq & 1) == 0 && m_seq.load(std::memory_order_relaxed) == seq) {
+        return index;
+      }
+    }
+  }
+
+private:
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "shared memory requires address-free atomics");
+
+  std::atomic<uint64_t> m_seq{0};
+  std::atomic<uint64_t> m_desc{0};
+  std::atomic<uint64_t> m_data{0};
+};
+
+// Read position of a client connected to a channel. Buffer space is only
+// released up to the minimum position of all critical cursors, while
+// non-critical cursors may lag behind and have to skip.
+struct shm_read_cursor {
+  std::atomic<bool> in_use{false};
+  bool critical = true;
+  DualIndex read_index{0, 0};   // locked mode
+  PublishedDualIndex published; // lock-free mode
+};
+
 class shm_channel {
 
 public:
+  static constexpr size_t max_read_cursors = 8;
+
   shm_channel(ip::managed_shared_memory* shm,
               void* data_buffer,
               size_t data_buffer_size_exp,
               size_t data_item_size,
               void* desc_buffer,
               size_t desc_buffer_size_exp,
-              size_t desc_item_size)
+              size_t desc_item_size,
+              bool lockfree = false)
       : m_data_buffer_size_exp(data_buffer_size_exp),
         m_desc_buffer_size_exp(desc_buffer_size_exp),
-        m_data_item_size(data_item_size), m_desc_item_size(desc_item_size) {
+        m_data_item_size(data_item_size), m_desc_item_size(desc_item_size),
+        m_lockfree(lockfree) {
     set_buffer_handles(shm, data_buffer, desc_buffer);
   }
 
@@ -50,6 +104,40 @@ public:
   size_t data_item_size() { return m_data_item_size; }
   size_t desc_item_size() { return m_desc_item_size; }
 
+  // In lock-free mode, the read and write indices are exchanged through
+  // PublishedDualIndex objects instead of the mutex-protected members
+  bool lockfree() const { return m_lockfree; }
+
+  // lock-free accessors (single writer each)
+  DualIndex published_write_index() const { return m_pub_write_index.load(); }
+
+  void publish_write_index(const DualIndex write_index) {
+    m_pub_write_index.store(write_index);
+    FLES_PROBE(shm_write_index, write_index.desc, write_index.data);
+    m_write_event.notify();
+  }
+
+  DualIndex published_read_index() const { return m_pub_read_index.load(); }
+
+  void publish_read_index(const DualIndex read_index) {
+    m_pub_read_index.store(read_index);
+  }
+
+  bool published_eof() const { return m_eof.load(std::memory_order_acquire); }
+
+  // Ask the server for a fresh write index (lock-free mode)
+  void request_write_index() {
+    m_pub_req_write_index.store(true, std::memory_order_seq_cst);
+  }
+
+  bool take_write_index_request() {
+    return m_pub_req_write_index.exchange(false, std::memory_order_seq_cst);
+  }
+
+  bool write_index_requested() const {
+    return m_pub_req_write_index.load(std::memory_order_seq_cst);
+  }
+
   // getter / setter
   bool req_read_index([
       [maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
@@ -89,6 +177,8 @@ public:
       const TimedDualIndex write_index) {
     assert(lock);
     m_write_index = write_index;
+    FLES_PROBE(shm_write_index, write_index.index.desc,
+               write_index.index.data);
     m_cond_write_index.notify_all();
   }
 
@@ -108,33 +198,111 @@ public:
 
   bool eof([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
     assert(lock);
-    return m_eof;
+    return m_eof.load(std::memory_order_relaxed);
   }
 
   void set_eof([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock,
                bool eof) {
     assert(lock);
-    m_eof = eof;
+    m_eof.store(eof, std::memory_order_release);
+    m_write_event.notify();
   }
 
-  bool connect([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
+  // Register a read cursor, starting at the released read index
+  std::optional<size_t>
+  connect([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock,
+          bool critical) {
     assert(lock);
-    if (m_clients != 0) {
-      return false;
+    for (size_t i = 0; i < m_cursors.size(); ++i) {
+      shm_read_cursor& cursor = m_cursors[i];
+      if (!cursor.in_use.load(std::memory_order_relaxed)) {
+        cursor.critical = critical;
+        cursor.read_index = m_read_index;
+        cursor.published.store(m_pub_read_index.load());
+        cursor.in_use.store(true, std::memory_order_release);
+        ++m_clients;
+        return i;
+      }
     }
-    m_clients = 1;
-    return true;
+    return std::nullopt;
   }
 
-  void disconnect([
-      [maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
+  // Unregister a read cursor, return whether the released read index has
+  // advanced
+  bool disconnect(ip::scoped_lock<ip::interprocess_mutex>& lock,
+                  size_t cursor) {
+    assert(lock);
+    m_cursors.at(cursor).in_use.store(false, std::memory_order_release);
+    --m_clients;
+    return update_released_read_index(lock);
+  }
+
+  DualIndex cursor_read_index(
+      [[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock,
+      size_t cursor) {
     assert(lock);
-    m_clients = 0;
+    return m_cursors.at(cursor).read_index;
+  }
+
+  // Move a read cursor, return whether the released read index has advanced
+  bool set_cursor_read_index(ip::scoped_lock<ip::interprocess_mutex>& lock,
+                             size_t cursor,
+                             const DualIndex read_index) {
+    assert(lock);
+    m_cursors.at(cursor).read_index = read_index;
+    return m_cursors.at(cursor).critical && update_released_read_index(lock);
+  }
+
+  // lock-free cursor accessors (single writer each)
+  DualIndex published_cursor_read_index(size_t cursor) const {
+    return m_cursors.at(cursor).published.load();
+  }
+
+  void publish_cursor_read_index(size_t cursor, const DualIndex read_index) {
+    m_cursors.at(cursor).published.store(read_index);
+  }
+
+  // Minimum published read index of all critical cursors, if any
+  std::optional<DualIndex> published_min_read_index() const {
+    std::optional<DualIndex> min;
+    for (const shm_read_cursor& cursor : m_cursors) {
+      if (cursor.in_use.load(std::memory_order_acquire) && cursor.critical) {
+        min = min_index(min, cursor.published.load());
+      }
+    }
+    return min;
   }
 
   ip::interprocess_condition m_cond_write_index;
+  // signalled when a new write index is published (lock-free mode)
+  shm_event m_write_event;
 
 private:
+  static DualIndex min_index(const std::optional<DualIndex>& a,
+                             const DualIndex b) {
+    if (!a) {
+      return b;
+    }
+    return {std::min(a->desc, b.desc), std::min(a->data, b.data)};
+  }
+
+  // Release buffer space up to the minimum of all critical cursors. Without
+  // critical cursors, the released read index is kept.
+  bool update_released_read_index(
+      [[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
+    std::optional<DualIndex> min;
+    for (const shm_read_cursor& cursor : m_cursors) {
+      if (cursor.in_use.load(std::memory_order_relaxed) && cursor.critical) {
+        min = min_index(min, cursor.read_index);
+      }
+    }
+    if (!min || *min == m_read_index) {
+      return false;
+    }
+    m_read_index = *min;
+    return true;
+  }
+
   void set_buffer_handles(ip::managed_shared_memory* shm,
                           void* data_buffer,
                           void* desc_buffer) {
@@ -155,7 +323,13 @@ private:
   DualIndex m_read_index{0, 0}; // INFO not actual hw value
   TimedDualIndex m_write_index{{0, 0}, boost::posix_time::neg_infin};
 
-  bool m_eof = false;
+  std::atomic<bool> m_eof{false};
 
   size_t m_clients = 0;
+
+  bool m_lockfree;
+  PublishedDualIndex m_pub_write_index;
+  PublishedDualIndex m_pub_read_index;
+  alignas(64) std::atomic<bool> m_pub_req_write_index{false};
+  std::array<shm_read_cursor, max_read_cursors> m_cursors;
 };
@@ -4,12 +4,15 @@
 #include "shm_channel_client.hpp"
 #include "log.hpp"
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <algorithm>
 #include <cassert>
 
 template <typename T_DESC, typename T_DATA>
 shm_channel_client<T_DESC, T_DATA>::shm_channel_client(
-    const std::shared_ptr<flib_shm_device_client>& dev, size_t index)
-    : m_dev(dev), m_shm(dev->shm()) {
+    const std::shared_ptr<flib_shm_device_client>& dev,
+    size_t index,
+    bool critical)
+    : m_dev(dev), m_shm(dev->shm()), m_critical(critical) {
 
   // connect to global exchange object
   std::string device_name = "shm_device";
@@ -27,9 +30,12 @@ shm_channel_client<T_DESC, T_DATA>::shm_channel_client(
 
   {
     ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
-    if (!m_shm_ch->connect(lock)) {
-      throw std::runtime_error("Channel " + channel_name + " already in use");
+    auto cursor = m_shm_ch->connect(lock, m_critical);
+    if (!cursor) {
+      throw std::runtime_error("Channel " + channel_name +
+                               " has no free read cursor");
     }
+    m_cursor = *cursor;
   }
 
   if (m_shm_ch->desc_item_size() != sizeof(T_DESC) ||
@@ -56,7 +62,9 @@ template <typename T_DESC, typename T_DATA>
 shm_channel_client<T_DESC, T_DATA>::~shm_channel_client() {
   try {
     ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
-    m_shm_ch->disconnect(lock);
+    if (m_shm_ch->disconnect(lock, m_cursor) && !m_shm_ch->lockfree()) {
+      request_read_index(lock);
+    }
   } catch (ip::interprocess_exception const& e) {
     L_(error) << "Failed to disconnect client: " << e.what();
   }
@@ -64,20 +72,42 @@ shm_channel_client<T_DESC, T_DATA>::~shm_channel_client() {
 
 template <typename T_DESC, typename T_DATA>
 void shm_channel_client<T_DESC, T_DATA>::set_read_index(DualIndex read_index) {
+  if (m_shm_ch->lockfree()) {
+    m_shm_ch->publish_cursor_read_index(m_cursor, read_index);
+    if (m_critical) {
+      request_write_index();
+    }
+    return;
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
-  m_shm_ch->set_read_index(lock, read_index);
-  m_shm_ch->set_req_read_index(lock, true);
-  m_shm_dev->m_cond_req.notify_one();
+  if (m_shm_ch->set_cursor_read_index(lock, m_cursor, read_index)) {
+    request_read_index(lock);
+  }
 }
 
 template <typename T_DESC, typename T_DATA>
 DualIndex shm_channel_client<T_DESC, T_DATA>::get_read_index() {
-  ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
-  return m_shm_ch->read_index(lock);
+  // Return the cursor position, or the released read index if the cursor
+  // has been overtaken
+  DualIndex cursor;
+  DualIndex released;
+  if (m_shm_ch->lockfree()) {
+    cursor = m_shm_ch->published_cursor_read_index(m_cursor);
+    released = m_shm_ch->published_read_index();
+  } else {
+    ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
+    cursor = m_shm_ch->cursor_read_index(lock, m_cursor);
+    released = m_shm_ch->read_index(lock);
+  }
+  return cursor.desc < released.desc ? released : cursor;
 }
 
 template <typename T_DESC, typename T_DATA>
 void shm_channel_client<T_DESC, T_DATA>::update_write_index() {
+  if (m_shm_ch->lockfree()) {
+    request_write_index();
+    return;
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
   m_shm_ch->set_req_write_index(lock, true);
   m_shm_dev->m_cond_req.notify_one();
@@ -86,6 +116,11 @@ void shm_channel_client<T_DESC, T_DATA>::update_write_index() {
 // get cached write_index
 template <typename T_DESC, typename T_DATA>
 TimedDualIndex shm_channel_client<T_DESC, T_DATA>::get_write_index_cached() {
+  if (m_shm_ch->lockfree()) {
+    // the server publishes continuously while active
+    return {m_shm_ch->published_write_index(),
+            boost::posix_time::microsec_clock::universal_time()};
+  }
   // TODO(Dirk): could be a shared lock
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
   return m_shm_ch->write_index(lock);
@@ -96,6 +131,10 @@ template <typename T_DESC, typename T_DATA>
 std::pair<TimedDualIndex, bool>
 shm_channel_client<T_DESC, T_DATA>::get_write_index_latest(
     const boost::posix_time::ptime& abs_timeout) {
+  if (m_shm_ch->lockfree()) {
+    request_write_index();
+    return std::make_pair(get_write_index_cached(), true);
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
   m_shm_ch->set_req_write_index(lock, true);
   m_shm_dev->m_cond_req.notify_one();
@@ -125,14 +164,73 @@ shm_channel_client<T_DESC, T_DATA>::get_write_index_newer_than(
 
 template <typename T_DESC, typename T_DATA>
 DualIndex shm_channel_client<T_DESC, T_DATA>::get_write_index() {
+  if (m_shm_ch->lockfree()) {
+    DualIndex write_index = m_shm_ch->published_write_index();
+    if (write_index == m_last_write_index) {
+      // no progress observed, make sure the server keeps polling
+      request_write_index();
+    }
+    m_last_write_index = write_index;
+    return write_index;
+  }
   return get_write_index_newer_than(boost::posix_time::microseconds(1))
       .first.index;
 }
 
+template <typename T_DESC, typename T_DATA>
+typename DualRingBufferReadInterface<T_DESC, T_DATA>::Batch
+shm_channel_client<T_DESC, T_DATA>::acquire(DualIndex begin,
+                                            uint64_t max_count) {
+  uint64_t write_desc = get_write_index().desc;
+  uint64_t available = write_desc > begin.desc ? write_desc - begin.desc : 0;
+  desc_buffer_view_->prefetch(
+      begin.desc, std::min<uint64_t>({available, max_count,
+                                      prefetch_descriptors}));
+  return this->make_batch(begin, write_desc, max_count);
+}
+
+template <typename T_DESC, typename T_DATA>
+void shm_channel_client<T_DESC, T_DATA>::wait_write_index(
+    uint64_t desc, std::chrono::microseconds timeout) {
+  if (!m_shm_ch->lockfree()) {
+    DualRingBufferReadInterface<T_DESC, T_DATA>::wait_write_index(desc,
+                                                                  timeout);
+    return;
+  }
+  // the server publishes a new write index after the next hardware poll
+  request_write_index();
+  m_shm_ch->m_write_event.wait(
+      [this, desc] {
+        return m_shm_ch->published_write_index().desc != desc ||
+               m_shm_ch->published_eof();
+      },
+      timeout);
+}
+
 template <typename T_DESC, typename T_DATA>
 bool shm_channel_client<T_DESC, T_DATA>::get_eof() {
+  if (m_shm_ch->lockfree()) {
+    return m_shm_ch->published_eof();
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
   return m_shm_ch->eof(lock);
 }
 
+template <typename T_DESC, typename T_DATA>
+void shm_channel_client<T_DESC, T_DATA>::request_write_index() {
+  m_shm_ch->request_write_index();
+  m_shm_dev->m_poll_event.notify();
+  if (m_shm_dev->server_idle()) {
+    ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
+    m_shm_dev->m_cond_req.notify_one();
+  }
+}
+
+template <typename T_DESC, typename T_DATA>
+void shm_channel_client<T_DESC, T_DATA>::request_read_index(
+    ip::scoped_lock<ip::interprocess_mutex>& lock) {
+  m_shm_ch->set_req_read_index(lock, true);
+  m_shm_dev->m_cond_req.notify_one();
+}
+
 template class shm_channel_client<fles::MicrosliceDescriptor, uint8_t>;
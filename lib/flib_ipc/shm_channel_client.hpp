@@ -20,8 +20,11 @@ template <typename T_DESC, typename T_DATA>
 class shm_channel_client : public DualRingBufferReadInterface<T_DESC, T_DATA> {
 
 public:
+  // A non-critical client does not hold back buffer space. It may be
+  // overtaken by the writer and then skips ahead (see may_be_overtaken()).
   shm_channel_client(const std::shared_ptr<flib_shm_device_client>& dev,
-                     size_t index);
+                     size_t index,
+                     bool critical = true);
   shm_channel_client(const shm_channel_client&) = delete;
   void operator=(const shm_channel_client&) = delete;
 
@@ -48,8 +51,21 @@ public:
 
   DualIndex get_write_index() override;
 
+  // Acquire a batch of written entries, prefetching the first
+  // prefetch_descriptors of its descriptors, so that a pass over the batch
+  // does not stall on each of the freshly DMA-written descriptors.
+  typename DualRingBufferReadInterface<T_DESC, T_DATA>::Batch
+  acquire(DualIndex begin, uint64_t max_count) override;
+
+  static constexpr size_t prefetch_descriptors = 64;
+
   bool get_eof() override;
 
+  bool may_be_overtaken() override { return !m_critical; }
+
+  void wait_write_index(uint64_t desc,
+                        std::chrono::microseconds timeout) override;
+
   size_t data_buffer_size_exp() { return m_data_buffer_size_exp; }
   size_t desc_buffer_size_exp() { return m_desc_buffer_size_exp; }
 
@@ -57,16 +73,27 @@ public:
   RingBufferView<T_DESC>& desc_buffer() override { return *desc_buffer_view_; }
 
 private:
+  // Lock-free mode: request a write index update from the server, waking it
+  // only if it is idle
+  void request_write_index();
+
+  // Notify the server of a new released read index (locked mode)
+  void request_read_index(ip::scoped_lock<ip::interprocess_mutex>& lock);
+
   std::shared_ptr<flib_shm_device_client> m_dev;
   ip::managed_shared_memory* m_shm;
   shm_device* m_shm_dev;
 
   shm_channel* m_shm_ch;
+  size_t m_cursor = 0;
+  bool m_critical;
   void* m_data_buffer;
   void* m_desc_buffer;
   size_t m_data_buffer_size_exp;
   size_t m_desc_buffer_size_exp;
 
+  DualIndex m_last_write_index{0, 0};
+
   std::unique_ptr<RingBufferView<T_DATA>> data_buffer_view_;
   std::unique_ptr<RingBufferView<T_DESC>> desc_buffer_view_;
 };
@@ -12,7 +12,8 @@ shm_channel_provider<T_DESC, T_DATA>::shm_channel_provider(
     shm_device* shm_dev,
     size_t index,
     size_t data_buffer_size_exp,
-    size_t desc_buffer_size_exp)
+    size_t desc_buffer_size_exp,
+    bool lockfree)
     : shm_dev_(shm_dev) {
   // allocate buffers
   void* data_buffer_raw = shm_alloc(shm, data_buffer_size_exp, sizeof(T_DATA));
@@ -22,7 +23,7 @@ shm_channel_provider<T_DESC, T_DATA>::shm_channel_provider(
   std::string channel_name = "shm_channel_" + std::to_string(index);
   shm_ch_ = shm->construct<shm_channel>(channel_name.c_str())(
       shm, data_buffer_raw, data_buffer_size_exp, sizeof(T_DATA),
-      desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC));
+      desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC), lockfree);
   set_write_index({0, 0});
 
   // initialize buffer info
@@ -37,6 +38,14 @@ shm_channel_provider<T_DESC, T_DATA>::shm_channel_provider(
 
 template <typename T_DESC, typename T_DATA>
 DualIndex shm_channel_provider<T_DESC, T_DATA>::get_read_index() {
+  if (shm_ch_->lockfree()) {
+    // there is no server, this provider releases the buffer space itself
+    auto min_read_index = shm_ch_->published_min_read_index();
+    if (min_read_index) {
+      shm_ch_->publish_read_index(*min_read_index);
+    }
+    return shm_ch_->published_read_index();
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(shm_dev_->m_mutex);
   shm_ch_->set_req_read_index(lock, false);
   return shm_ch_->read_index(lock);
@@ -45,6 +54,10 @@ DualIndex shm_channel_provider<T_DESC, T_DATA>::get_read_index() {
 template <typename T_DESC, typename T_DATA>
 void shm_channel_provider<T_DESC, T_DATA>::set_write_index(
     DualIndex new_write_index) {
+  if (shm_ch_->lockfree()) {
+    shm_ch_->publish_write_index(new_write_index);
+    return;
+  }
   TimedDualIndex write_index = {new_write_index, boost::posix_time::pos_infin};
   ip::scoped_lock<ip::interprocess_mutex> lock(shm_dev_->m_mutex);
   shm_ch_->set_req_write_index(lock, false);
@@ -59,6 +72,9 @@ void shm_channel_provider<T_DESC, T_DATA>::set_eof(bool eof) {
 
 template <typename T_DESC, typename T_DATA>
 DualIndex shm_channel_provider<T_DESC, T_DATA>::get_occupied_size() {
+  if (shm_ch_->lockfree()) {
+    return shm_ch_->published_write_index() - get_read_index();
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(shm_dev_->m_mutex);
   DualIndex read_index = shm_ch_->read_index(lock);
   DualIndex write_index = shm_ch_->write_index(lock).index;
@@ -31,7 +31,8 @@ public:
                        shm_device* shm_dev,
                        size_t index,
                        size_t data_buffer_size_exp,
-                       size_t desc_buffer_size_exp);
+                       size_t desc_buffer_size_exp,
+                       bool lockfree = false);
 
   DualIndex get_read_index() override;
 
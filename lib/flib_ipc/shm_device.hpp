@@ -2,9 +2,11 @@
 
 #pragma once
 
+#include "shm_event.hpp"
 #include <boost/interprocess/sync/interprocess_condition.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <atomic>
 #include <cstdint>
 
 namespace ip = boost::interprocess;
@@ -38,10 +40,23 @@ public:
 
   // interprocess_condition& cond_req() { return m_cond_req; }
 
+  // Lock-free channels: the server announces that it is about to sleep on
+  // m_cond_req, so that clients only signal it in this case
+  void set_server_idle(bool idle) {
+    m_server_idle.store(idle, std::memory_order_seq_cst);
+  }
+
+  bool server_idle() const {
+    return m_server_idle.load(std::memory_order_seq_cst);
+  }
+
   ip::interprocess_mutex m_mutex;
   ip::interprocess_condition m_cond_req;
+  // signalled on client requests to wake up sleeping polling threads
+  shm_event m_poll_event;
 
 private:
   size_t m_num_channels = 0;
   size_t m_clients = 0;
+  std::atomic<bool> m_server_idle{false};
 };
@@ -9,7 +9,8 @@ shm_device_provider<T_DESC, T_DATA>::shm_device_provider(
     const std::string& shm_identifier,
     size_t num_channels,
     size_t data_buffer_size_exp,
-    size_t desc_buffer_size_exp)
+    size_t desc_buffer_size_exp,
+    bool lockfree)
     : shm_identifier_(shm_identifier) {
   ip::shared_memory_object::remove(shm_identifier_.c_str());
 
@@ -33,7 +34,7 @@ shm_device_provider<T_DESC, T_DATA>::shm_device_provider(
     shm_ch_vec_.push_back(std::unique_ptr<shm_channel_provider_type>(
         new shm_channel_provider_type(shm_.get(), shm_dev_, i,
                                       data_buffer_size_exp,
-                                      desc_buffer_size_exp)));
+                                      desc_buffer_size_exp, lockfree)));
     shm_dev_->inc_num_channels();
   }
 }
@@ -20,7 +20,8 @@ public:
   shm_device_provider(const std::string& shm_identifier,
                       size_t num_channels,
                       size_t data_buffer_size_exp,
-                      size_t desc_buffer_size_exp);
+                      size_t desc_buffer_size_exp,
+                      bool lockfree = false);
 
   ~shm_device_provider();
 
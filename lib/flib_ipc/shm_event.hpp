@@ -0,0 +1,60 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Wakeup event in shared memory, based on a process-shared futex. Waiters
+// sleep until notified or until a timeout expires, while a notification
+// costs only two atomic operations if nobody is waiting.
+class alignas(64) shm_event {
+public:
+  // Notify all waiters. Call after the state they wait for has changed.
+  void notify() {
+    m_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_seq_cst) != 0) {
+      futex(FUTEX_WAKE, INT_MAX, nullptr);
+    }
+  }
+
+  // Wait until ready() returns true, a notification occurs or the timeout
+  // expires. Returns the final result of ready().
+  template <typename Predicate>
+  bool wait(Predicate ready, std::chrono::microseconds timeout) {
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    uint32_t seq = m_seq.load(std::memory_order_seq_cst);
+    bool result = ready();
+    if (!result) {
+      auto s = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          timeout - s);
+      timespec ts{static_cast<time_t>(s.count()),
+                  static_cast<long>(ns.count())};
+      futex(FUTEX_WAIT, seq, &ts);
+      result = ready();
+    }
+    m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return result;
+  }
+
+private:
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                    std::atomic<uint32_t>::is_always_lock_free,
+                "futex requires a plain 32-bit word");
+
+  long futex(int op, uint32_t val, const timespec* timeout) {
+    // not FUTEX_PRIVATE_FLAG, the word is shared between processes
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_seq), op, val,
+                   timeout, nullptr, 0);
+  }
+
+  std::atomic<uint32_t> m_seq{0};
+  std::atomic<uint32_t> m_waiters{0};
+};
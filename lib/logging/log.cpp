@@ -1,18 +1,32 @@
 // Copyright 2014 Jan de Cuveland <cmail@cuveland.de>
 #include "log.hpp"
+#include "ThreadRings.hpp"
 
+#include <boost/core/null_deleter.hpp>
 #include <boost/log/attributes.hpp>
 #include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/support/date_time.hpp>
 #include <boost/log/utility/setup.hpp>
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unistd.h>
+#include <utility>
+#include <vector>
 
 #define __ansi(code_m) "\033[" code_m "m"
 
@@ -122,9 +136,236 @@ namespace {
 bool cout_is_a_tty() {
   return (isatty(fileno(stdout)) != 0) && (getenv("TERM") != nullptr);
 }
+
+// Configuration of sinks added in the future, see logging::set_async()
+struct AsyncConfig {
+  bool enabled = false;
+  size_t queue_size = 0;
+  logging::overflow_policy policy = logging::overflow_policy::drop;
+};
+AsyncConfig async_config;
+
+std::atomic<uint64_t> dropped_total{0};
+
+// Flush and shutdown functions of the asynchronous sinks
+struct AsyncSinkControl {
+  std::function<void()> flush;
+  std::function<void()> shutdown;
+};
+std::mutex async_sinks_mutex;
+std::vector<AsyncSinkControl> async_sinks;
+
+/// Queueing strategy of asynchronous sinks with a queue per logging thread.
+/** Each logging thread writes to its own single-producer single-consumer
+    ring buffer, so that threads only synchronize on their first message.
+    The feeding thread of the sink merges the rings in the order of a
+    sequence number drawn on enqueue. */
+class ThreadRingQueue {
+public:
+  ThreadRingQueue(const ThreadRingQueue&) = delete;
+  void operator=(const ThreadRingQueue&) = delete;
+
+protected:
+  ThreadRingQueue()
+      : policy_(async_config.policy), rings_(async_config.queue_size) {}
+
+  template <typename ArgsT>
+  explicit ThreadRingQueue(ArgsT const& /*args*/) : ThreadRingQueue() {}
+
+  void enqueue(boost::log::record_view const& rec) {
+    if (!push(rec, policy_ == logging::overflow_policy::block)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      dropped_total.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  bool try_enqueue(boost::log::record_view const& rec) {
+    return push(rec, false);
+  }
+
+  bool try_dequeue_ready(boost::log::record_view& rec) { return pop(rec); }
+
+  bool try_dequeue(boost::log::record_view& rec) { return pop(rec); }
+
+  bool dequeue_ready(boost::log::record_view& rec) {
+    while (true) {
+      if (pop(rec)) {
+        return true;
+      }
+      // A wakeup may be missed in a race with a producer, so the wait is
+      // bounded
+      std::unique_lock<std::mutex> lock(wait_mutex_);
+      waiting_.store(true);
+      wait_cv_.wait_for(lock, wait_timeout, [this] {
+        return interrupted_.load() || has_records();
+      });
+      waiting_.store(false);
+      if (interrupted_.exchange(false)) {
+        return false;
+      }
+    }
+  }
+
+  void interrupt_dequeue() {
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      interrupted_.store(true);
+    }
+    wait_cv_.notify_one();
+  }
+
+private:
+  struct Slot {
+    uint64_t seq = 0;
+    boost::log::record_view rec;
+  };
+
+  using Ring = cbm::ThreadRings<Slot>::ring_t;
+
+  static constexpr auto wait_timeout = std::chrono::milliseconds(50);
+  static constexpr auto drop_report_interval = std::chrono::seconds(1);
+
+  bool push(boost::log::record_view const& rec, bool block) {
+    Ring& ring = rings_.Local();
+    uint64_t seq = seq_.fetch_add(1, std::memory_order_relaxed);
+    while (!ring.Push(Slot{seq, rec})) {
+      if (!block) {
+        return false;
+      }
+      wake();
+      std::this_thread::yield();
+    }
+    if (waiting_.load()) {
+      wake();
+    }
+    return true;
+  }
+
+  void wake() {
+    std::lock_guard<std::mutex> lock(wait_mutex_);
+    wait_cv_.notify_one();
+  }
+
+  bool has_records() {
+    bool found = false;
+    rings_.ForEach([&found](Ring& ring) { found = found || !ring.Empty(); });
+    return found;
+  }
+
+  // Called by the feeding thread only
+  bool pop(boost::log::record_view& rec) {
+    report_drops();
+
+    // rings are only removed once empty, so next stays valid
+    Ring* next = nullptr;
+    rings_.ForEach([&next](Ring& ring) {
+      if (!ring.Empty() &&
+          (next == nullptr || ring.Front().seq < next->Front().seq)) {
+        next = &ring;
+      }
+    });
+    if (next == nullptr) {
+      return false;
+    }
+    // moving out releases the slot's reference to the record
+    rec = std::move(next->Front().rec);
+    next->Pop();
+    return true;
+  }
+
+  // Called by the feeding thread only
+  void report_drops() {
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped == reported_dropped_) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_drop_report_) {
+      return;
+    }
+    L_(warning) << "log queue overflow, " << dropped - reported_dropped_
+                << " messages dropped";
+    reported_dropped_ = dropped;
+    next_drop_report_ = now + drop_report_interval;
+  }
+
+  const logging::overflow_policy policy_;
+
+  std::atomic<uint64_t> seq_{0};
+  std::atomic<uint64_t> dropped_{0};
+  uint64_t reported_dropped_ = 0;
+  std::chrono::steady_clock::time_point next_drop_report_;
+
+  cbm::ThreadRings<Slot> rings_;
+
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+  std::atomic<bool> waiting_{false};
+  std::atomic<bool> interrupted_{false};
+};
+
+void shutdown_async_sinks() {
+  std::lock_guard<std::mutex> lock(async_sinks_mutex);
+  for (auto& sink : async_sinks) {
+    sink.shutdown();
+  }
+  async_sinks.clear();
+}
+
+// Add a sink with the given backend to the logging core, asynchronous if
+// configured by logging::set_async()
+template <typename Backend>
+void add_sink(boost::shared_ptr<Backend> backend,
+              boost::log::formatter const& formatter,
+              severity_level minimum_severity) {
+  if (!async_config.enabled) {
+    auto sink =
+        boost::make_shared<boost::log::sinks::synchronous_sink<Backend>>(
+            backend);
+    sink->set_formatter(formatter);
+    sink->set_filter(severity >= minimum_severity);
+    boost::log::core::get()->add_sink(sink);
+    return;
+  }
+
+  using sink_t = boost::log::sinks::asynchronous_sink<Backend, ThreadRingQueue>;
+  auto sink = boost::make_shared<sink_t>(backend);
+  sink->set_formatter(formatter);
+  sink->set_filter(severity >= minimum_severity);
+  boost::log::core::get()->add_sink(sink);
+
+  std::lock_guard<std::mutex> lock(async_sinks_mutex);
+  if (async_sinks.empty()) {
+    std::atexit(shutdown_async_sinks);
+  }
+  async_sinks.push_back({[sink] { sink->flush(); },
+                         [sink] {
+                           // later messages are discarded instead of queued
+                           boost::log::core::get()->remove_sink(sink);
+                           sink->stop();
+                           sink->flush();
+                         }});
+}
 } // namespace
 
 namespace logging {
+void set_async(std::size_t queue_size, overflow_policy policy) {
+  async_config.enabled = true;
+  async_config.queue_size = queue_size;
+  async_config.policy = policy;
+}
+
+std::uint64_t dropped_messages() {
+  return dropped_total.load(std::memory_order_relaxed);
+}
+
+void flush() {
+  std::lock_guard<std::mutex> lock(async_sinks_mutex);
+  for (auto& sink : async_sinks) {
+    sink.flush();
+  }
+}
+
 void add_console(severity_level minimum_severity) {
   boost::log::formatter console_formatter;
 
@@ -148,9 +389,10 @@ void add_console(severity_level minimum_severity) {
         << ": " << boost::log::expressions::message;
   }
 
-  auto console_sink = boost::log::add_console_log();
-  console_sink->set_formatter(console_formatter);
-  console_sink->set_filter(severity >= minimum_severity);
+  auto backend = boost::make_shared<boost::log::sinks::text_ostream_backend>();
+  backend->add_stream(
+      boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+  add_sink(backend, console_formatter, minimum_severity);
 }
 
 void add_file(std::string filename, severity_level minimum_severity) {
@@ -162,12 +404,11 @@ void add_file(std::string filename, severity_level minimum_severity) {
       << "] " << boost::log::expressions::attr<severity_level>("Severity")
       << ": " << boost::log::expressions::message;
 
-  auto file_sink =
-      boost::log::add_file_log(boost::log::keywords::file_name = filename,
-                               boost::log::keywords::auto_flush = true);
+  auto backend = boost::make_shared<boost::log::sinks::text_file_backend>(
+      boost::log::keywords::file_name = filename,
+      boost::log::keywords::auto_flush = true);
   // default open_mode is (std::ios_base::trunc | std::ios_base::out)
-  file_sink->set_formatter(file_formatter);
-  file_sink->set_filter(severity >= minimum_severity);
+  add_sink(backend, file_formatter, minimum_severity);
 }
 
 void add_syslog(syslog::facility facility, severity_level minimum_severity) {
@@ -176,8 +417,7 @@ void add_syslog(syslog::facility facility, severity_level minimum_severity) {
       << boost::log::expressions::attr<severity_level>("Severity") << ": "
       << boost::log::expressions::message;
 
-  auto syslog_sink = boost::make_shared<
-      boost::log::sinks::synchronous_sink<boost::log::sinks::syslog_backend>>(
+  auto backend = boost::make_shared<boost::log::sinks::syslog_backend>(
       boost::log::keywords::facility = facility,
       boost::log::keywords::use_impl = syslog::native);
 
@@ -189,12 +429,9 @@ void add_syslog(syslog::facility facility, severity_level minimum_severity) {
   mapping[warning] = syslog::warning;
   mapping[error] = syslog::error;
   mapping[fatal] = syslog::critical;
-  syslog_sink->locked_backend()->set_severity_mapper(mapping);
-
-  syslog_sink->set_formatter(syslog_formatter);
-  syslog_sink->set_filter(severity >= minimum_severity);
+  backend->set_severity_mapper(mapping);
 
-  boost::log::core::get()->add_sink(syslog_sink);
+  add_sink(backend, syslog_formatter, minimum_severity);
 }
 
 LogBuffer::LogBuffer(severity_level level) : level_(level) {}
@@ -6,6 +6,8 @@
 #include <boost/log/common.hpp>
 #include <boost/log/sinks/syslog_backend.hpp>
 #include <boost/log/utility/manipulators/to_log.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 #include <iostream>
 
@@ -29,6 +31,20 @@ BOOST_LOG_GLOBAL_LOGGER(g_logger,
 namespace logging {
 namespace syslog = boost::log::sinks::syslog;
 
+/// Behavior of an asynchronous sink if a thread's queue is full.
+enum class overflow_policy { drop, block };
+
+/// Make sinks added afterwards asynchronous.
+/** Each logging thread gets a queue of (at least) queue_size messages per
+    sink, which is processed by a background thread. */
+void set_async(std::size_t queue_size, overflow_policy policy);
+
+/// Number of messages dropped by asynchronous sinks so far.
+std::uint64_t dropped_messages();
+
+/// Write out all messages queued in asynchronous sinks.
+void flush();
+
 void add_console(severity_level minimum_severity);
 void add_file(std::string filename, severity_level minimum_severity);
 void add_syslog(syslog::facility /*facility*/, severity_level minimum_severity);
@@ -55,4 +71,12 @@ public:
 };
 } // namespace logging
 
-#define L_(severity) BOOST_LOG_SEV(g_logger::get(), severity)
+/// Messages below this severity are removed at compile time.
+#ifndef LOG_MIN_SEVERITY
+#define LOG_MIN_SEVERITY trace
+#endif
+
+#define L_(severity)                                                           \
+  for (bool l_enabled_ = (severity) >= LOG_MIN_SEVERITY; l_enabled_;           \
+       l_enabled_ = false)                                                     \
+  BOOST_LOG_SEV(g_logger::get(), severity)
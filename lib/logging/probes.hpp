@@ -0,0 +1,32 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Static user-space probes (USDT) at points of interest.
+#pragma once
+
+/// Mark a static probe point of the "flesnet" provider.
+/** With sys/sdt.h available (built with HAVE_USDT), each probe compiles to
+    a single nop instruction plus an ELF note, so it costs nothing until a
+    tracer like bpftrace or perf attaches to it. The arguments are always
+    evaluated, so they should be plain values at hand. Without sys/sdt.h,
+    probes expand to nothing.
+
+    Example:
+        bpftrace -e 'usdt:./flesnet:flesnet:send_timeslice_entry
+                     { @bytes = hist(arg2); }'
+
+    The probes and their arguments are:
+      - send_timeslice_entry, send_timeslice_return (ts, cn, bytes)
+      - write_complete (ts, cn)
+      - timeslice_complete (ts, ts_pos, num_components)
+      - timeslice_release (ts_pos)
+      - send_work_item (ts, ts_pos, bytes)
+      - item_arrive, item_complete (item id)
+      - item_dispatch (item id, items outstanding at the receiving worker)
+      - shm_write_index (desc index, data index)
+*/
+#ifdef HAVE_USDT
+#include <sys/sdt.h>
+#define FLES_PROBE(name, ...) STAP_PROBEV(flesnet, name, __VA_ARGS__)
+#else
+#define FLES_PROBE(name, ...) ((void)0)
+#endif
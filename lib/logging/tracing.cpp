@@ -0,0 +1,251 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#include "tracing.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace tracing {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+// maximum number of events per thread and session
+constexpr size_t buffer_capacity = 65536;
+
+// time for threads to complete an event begun before the end of a session
+constexpr auto grace_period = std::chrono::milliseconds(10);
+
+// polling interval of the signal trigger thread
+constexpr auto trigger_poll_interval = std::chrono::milliseconds(100);
+
+struct Event {
+  const char* name;
+  uint64_t begin;
+  uint64_t end;
+  uint64_t arg;
+};
+
+// Event buffer of a thread, written by the owning thread only
+struct ThreadBuffer {
+  std::vector<Event> events = std::vector<Event>(buffer_capacity);
+  std::atomic<size_t> count{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<uint64_t> session{0};
+  long tid = 0;
+  std::string name;
+};
+
+std::atomic<uint64_t> current_session{0};
+
+std::mutex registry_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+
+// Session start, guarded by session_mutex
+std::mutex session_mutex;
+uint64_t session_begin_tsc = 0;
+std::chrono::steady_clock::time_point session_begin_time;
+
+std::string current_thread_name() {
+  std::array<char, 16> name{};
+  if (pthread_getname_np(pthread_self(), name.data(), name.size()) != 0) {
+    return {};
+  }
+  return name.data();
+}
+
+ThreadBuffer& local_buffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto b = std::make_shared<ThreadBuffer>();
+    b->tid = syscall(SYS_gettid);
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(b);
+    return b;
+  }();
+  return *buffer;
+}
+
+std::string json_escape(const std::string& s) {
+  std::string r;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      r += '\\';
+    }
+    if (static_cast<unsigned char>(c) >= 0x20) {
+      r += c;
+    }
+  }
+  return r;
+}
+
+// Trigger on signal, see tracing::trigger_on_signal()
+std::atomic<bool> trigger_requested{false};
+static_assert(std::atomic<bool>::is_always_lock_free);
+
+void trigger_signal_handler(int /*sig*/) { trigger_requested.store(true); }
+
+class SignalTrigger {
+public:
+  SignalTrigger(std::string filename, std::chrono::milliseconds window)
+      : filename_(std::move(filename)), window_(window),
+        thread_([this] { run(); }) {}
+
+  SignalTrigger(const SignalTrigger&) = delete;
+  void operator=(const SignalTrigger&) = delete;
+
+  ~SignalTrigger() {
+    stopped_ = true;
+    thread_.join();
+  }
+
+private:
+  void run() {
+    while (!stopped_) {
+      std::this_thread::sleep_for(trigger_poll_interval);
+      if (!trigger_requested.exchange(false)) {
+        continue;
+      }
+      L_(info) << "tracing for " << window_.count() << " ms";
+      start();
+      auto end = std::chrono::steady_clock::now() + window_;
+      while (!stopped_ && std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(trigger_poll_interval);
+      }
+      stop(filename_);
+    }
+  }
+
+  std::string filename_;
+  std::chrono::milliseconds window_;
+  std::atomic<bool> stopped_{false};
+  std::thread thread_;
+};
+
+std::unique_ptr<SignalTrigger> signal_trigger;
+
+} // namespace
+
+void record(const char* name, uint64_t begin, uint64_t end, uint64_t arg) {
+  ThreadBuffer& buffer = local_buffer();
+  uint64_t session = current_session.load(std::memory_order_relaxed);
+  if (buffer.session.load(std::memory_order_relaxed) != session) {
+    // first event of this thread in a new session
+    buffer.count.store(0, std::memory_order_relaxed);
+    buffer.dropped.store(0, std::memory_order_relaxed);
+    buffer.name = current_thread_name();
+    buffer.session.store(session, std::memory_order_release);
+  }
+  size_t n = buffer.count.load(std::memory_order_relaxed);
+  if (n == buffer.events.size()) {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events[n] = {name, begin, end, arg};
+  buffer.count.store(n + 1, std::memory_order_release);
+}
+
+void start() {
+  std::lock_guard<std::mutex> lock(session_mutex);
+  if (g_enabled.load()) {
+    return;
+  }
+  current_session.fetch_add(1);
+  session_begin_time = std::chrono::steady_clock::now();
+  session_begin_tsc = now();
+  g_enabled.store(true);
+}
+
+size_t stop(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(session_mutex);
+  if (!g_enabled.exchange(false)) {
+    return 0;
+  }
+  std::this_thread::sleep_for(grace_period);
+
+  // calibrate the TSC against the steady clock over the session
+  uint64_t end_tsc = now();
+  auto end_time = std::chrono::steady_clock::now();
+  double ticks_per_us =
+      static_cast<double>(end_tsc - session_begin_tsc) /
+      std::chrono::duration<double, std::micro>(end_time - session_begin_time)
+          .count();
+  auto to_us = [&](uint64_t tsc) {
+    return static_cast<double>(static_cast<int64_t>(tsc - session_begin_tsc)) /
+           ticks_per_us;
+  };
+
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> registry_lock(registry_mutex);
+    buffers = registry;
+    // drop the buffers of threads that have exited
+    registry.erase(
+        std::remove_if(registry.begin(), registry.end(),
+                       [](const auto& b) { return b.use_count() == 1; }),
+        registry.end());
+  }
+
+  std::ofstream out(filename);
+  if (!out) {
+    L_(error) << "cannot open trace file " << filename;
+    return 0;
+  }
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+  const pid_t pid = getpid();
+  const uint64_t session = current_session.load();
+  size_t events = 0;
+  uint64_t dropped = 0;
+  bool first = true;
+  for (const auto& buffer : buffers) {
+    if (buffer->session.load(std::memory_order_acquire) != session) {
+      continue;
+    }
+    size_t count = buffer->count.load(std::memory_order_acquire);
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << R"({"name":"thread_name","ph":"M","pid":)" << pid
+        << R"(,"tid":)" << buffer->tid << R"(,"args":{"name":")"
+        << json_escape(buffer->name) << "\"}}";
+    for (size_t i = 0; i < count; ++i) {
+      const Event& e = buffer->events[i];
+      out << ",\n"
+          << R"({"name":")" << e.name << R"(","ph":"X","ts":)"
+          << to_us(e.begin) << R"(,"dur":)"
+          << static_cast<double>(e.end - e.begin) / ticks_per_us
+          << R"(,"pid":)" << pid << R"(,"tid":)" << buffer->tid
+          << R"(,"args":{"arg":)" << e.arg << "}}";
+    }
+    events += count;
+  }
+  out << "\n]}\n";
+
+  L_(info) << "trace of " << events << " events written to " << filename;
+  if (dropped != 0) {
+    L_(warning) << dropped << " trace events dropped, thread buffers full";
+  }
+  return events;
+}
+
+void trigger_on_signal(int signum,
+                       const std::string& filename,
+                       std::chrono::milliseconds window) {
+  signal_trigger = std::make_unique<SignalTrigger>(filename, window);
+  std::signal(signum, trigger_signal_handler);
+}
+
+} // namespace tracing
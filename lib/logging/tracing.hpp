@@ -0,0 +1,68 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Low-overhead timeline tracing in Chrome trace event format.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <x86intrin.h>
+
+/// Namespace for timeline tracing.
+/** Events are recorded with TSC timestamps into a fixed-size buffer per
+    thread while a tracing session is active. At the end of a session, all
+    events are written as a JSON trace that can be loaded in Perfetto
+    (ui.perfetto.dev) or chrome://tracing. */
+namespace tracing {
+
+extern std::atomic<bool> g_enabled;
+
+/// Check whether a tracing session is active.
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+/// Current timestamp in TSC ticks.
+inline uint64_t now() { return __rdtsc(); }
+
+/// Record a complete event (called by Scope).
+void record(const char* name, uint64_t begin, uint64_t end, uint64_t arg);
+
+/// Start a tracing session, discarding events of a previous session.
+void start();
+
+/// Stop the tracing session and write its events to a file.
+/** \return number of events written */
+size_t stop(const std::string& filename);
+
+/// Trace a window of the given length on each receipt of a signal.
+/** Starts a background thread which writes the trace of each window to
+    filename, overwriting the trace of a previous window. */
+void trigger_on_signal(int signum,
+                       const std::string& filename,
+                       std::chrono::milliseconds window);
+
+/// Scoped event, recorded as a complete event on destruction.
+/** The name must be a string literal or otherwise outlive the session. */
+class Scope {
+public:
+  explicit Scope(const char* name, uint64_t arg = 0)
+      : name_(enabled() ? name : nullptr), arg_(arg),
+        begin_(name_ != nullptr ? now() : 0) {}
+
+  Scope(const Scope&) = delete;
+  void operator=(const Scope&) = delete;
+
+  ~Scope() {
+    if (name_ != nullptr) {
+      record(name_, begin_, now(), arg_);
+    }
+  }
+
+private:
+  const char* name_;
+  uint64_t arg_;
+  uint64_t begin_;
+};
+
+} // namespace tracing
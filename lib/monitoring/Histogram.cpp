@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "Histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cbm {
+
+/*! \class Histogram
+  \brief Fixed-bucket log-linear histogram of unsigned integer values
+
+  The bucket layout is fixed, so histograms recorded independently (e.g., by
+  several threads or processes) can be merged bucket by bucket. The full
+  64-bit value range is covered with a relative resolution of 1/kSubBuckets,
+  which makes the histogram suitable for latencies spanning many orders of
+  magnitude.
+*/
+
+//-----------------------------------------------------------------------------
+/*! \brief Add the contents of another histogram
+  \param other  histogram to merge
+ */
+
+void Histogram::Merge(const Histogram& other) {
+  for (size_t i = 0; i < kBuckets; ++i)
+    fBuckets[i] += other.fBuckets[i];
+  fCount += other.fCount;
+  fMax = std::max(fMax, other.fMax);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Remove all recorded values
+
+void Histogram::Clear() {
+  fBuckets.fill(0);
+  fCount = 0;
+  fMax = 0;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns an upper estimate of a percentile
+  \param percent  percentile, in the range [0, 100]
+  \returns the upper bound of the bucket holding the percentile, limited by
+    the largest recorded value (0 if empty)
+ */
+
+uint64_t Histogram::Percentile(double percent) const {
+  if (fCount == 0)
+    return 0;
+  percent = std::clamp(percent, 0., 100.);
+  auto rank = static_cast<uint64_t>(
+      std::ceil(percent / 100. * static_cast<double>(fCount)));
+  rank = std::max(rank, uint64_t(1));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += fBuckets[i];
+    if (seen >= rank)
+      return std::min(BucketHigh(i), fMax);
+  }
+  return fMax;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns a copy of the recorded values
+  \param reset  if true, start over with an empty histogram
+ */
+
+Histogram AtomicHistogram::Snapshot(bool reset) {
+  Histogram res;
+  for (size_t i = 0; i < Histogram::kBuckets; ++i) {
+    uint64_t count = reset ? fBuckets[i].exchange(0, std::memory_order_relaxed)
+                           : fBuckets[i].load(std::memory_order_relaxed);
+    res.fBuckets[i] = count;
+    res.fCount += count;
+  }
+  res.fMax = reset ? fMax.exchange(0, std::memory_order_relaxed)
+                   : fMax.load(std::memory_order_relaxed);
+  return res;
+}
+
+} // end namespace cbm
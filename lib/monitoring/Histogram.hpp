@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#ifndef included_Cbm_Histogram
+#define included_Cbm_Histogram 1
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace cbm {
+
+class Histogram {
+public:
+  static constexpr int kSubBits = 4; //!< log2 of sub-buckets per octave
+  static constexpr size_t kSubBuckets = size_t(1) << kSubBits;
+  static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+  Histogram() = default;
+
+  void Record(uint64_t value, uint64_t count = 1);
+  void Merge(const Histogram& other);
+  void Clear();
+
+  uint64_t Count() const;
+  uint64_t Max() const;
+  uint64_t Percentile(double percent) const;
+  uint64_t BucketCount(size_t index) const;
+
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketLow(size_t index);
+  static uint64_t BucketHigh(size_t index);
+
+private:
+  friend class AtomicHistogram;
+
+  std::array<uint64_t, kBuckets> fBuckets{}; //!< counts per bucket
+  uint64_t fCount{0};                        //!< total count
+  uint64_t fMax{0};                          //!< largest recorded value
+};
+
+class AtomicHistogram {
+public:
+  AtomicHistogram() = default;
+
+  AtomicHistogram(const AtomicHistogram&) = delete;
+  AtomicHistogram& operator=(const AtomicHistogram&) = delete;
+
+  void Record(uint64_t value);
+  Histogram Snapshot(bool reset);
+
+private:
+  std::array<std::atomic<uint64_t>, Histogram::kBuckets> fBuckets{};
+  std::atomic<uint64_t> fMax{0}; //!< largest recorded value
+};
+
+} // end namespace cbm
+
+#include "Histogram.ipp"
+
+#endif
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+namespace cbm {
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns the index of the bucket holding `value`
+
+  Values below kSubBuckets have a bucket each, every following power of two
+  range is split into kSubBuckets linear sub-buckets. The relative bucket
+  width, and thus the error of reported percentiles, is at most
+  1/kSubBuckets.
+ */
+
+inline size_t Histogram::BucketIndex(uint64_t value) {
+  if (value < kSubBuckets)
+    return value;
+  int msb = 63 - __builtin_clzll(value);
+  int shift = msb - kSubBits;
+  return (shift + 1) * kSubBuckets + ((value >> shift) & (kSubBuckets - 1));
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the smallest value mapped to bucket `index`
+
+inline uint64_t Histogram::BucketLow(size_t index) {
+  if (index < kSubBuckets)
+    return index;
+  int shift = static_cast<int>(index / kSubBuckets) - 1;
+  return (kSubBuckets + index % kSubBuckets) << shift;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the largest value mapped to bucket `index`
+
+inline uint64_t Histogram::BucketHigh(size_t index) {
+  if (index < kSubBuckets)
+    return index;
+  int shift = static_cast<int>(index / kSubBuckets) - 1;
+  return BucketLow(index) + ((uint64_t(1) << shift) - 1);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Record a value
+  \param value  value to record
+  \param count  number of occurrences
+ */
+
+inline void Histogram::Record(uint64_t value, uint64_t count) {
+  fBuckets[BucketIndex(value)] += count;
+  fCount += count;
+  if (value > fMax)
+    fMax = value;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the total number of recorded values
+
+inline uint64_t Histogram::Count() const { return fCount; }
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the largest recorded value (0 if empty)
+
+inline uint64_t Histogram::Max() const { return fMax; }
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the number of values recorded in bucket `index`
+
+inline uint64_t Histogram::BucketCount(size_t index) const {
+  return fBuckets[index];
+}
+
+/*! \class AtomicHistogram
+  \brief Log-linear histogram which can be recorded into concurrently
+
+  Record() is lock-free and consists of two relaxed atomic operations in the
+  common case. Snapshot() returns a consistent-enough Histogram copy for
+  periodic reporting; values recorded concurrently with a resetting snapshot
+  are counted in either this or the next snapshot.
+*/
+
+//-----------------------------------------------------------------------------
+/*! \brief Record a value
+  \param value  value to record
+ */
+
+inline void AtomicHistogram::Record(uint64_t value) {
+  fBuckets[Histogram::BucketIndex(value)].fetch_add(1,
+                                                    std::memory_order_relaxed);
+  uint64_t max = fMax.load(std::memory_order_relaxed);
+  while (value > max &&
+         !fMax.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    ;
+}
+
+} // end namespace cbm
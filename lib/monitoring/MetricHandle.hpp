@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#ifndef included_Cbm_MetricHandle
+#define included_Cbm_MetricHandle 1
+
+#include "Histogram.hpp"
+#include "Metric.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace cbm {
+
+class Monitor; // forward declaration
+
+struct MetricCell {
+  enum class Kind { Counter, Gauge, Histogram };
+
+  MetricCell(const std::string& measurement,
+             const MetricTagSet& tagset,
+             const std::string& field,
+             Kind kind);
+
+  std::string fMeasurement;                    //!< measurement name
+  MetricTagSet fTagset;                        //!< set of tags
+  std::string fField;                          //!< field name
+  Kind fKind;                                  //!< kind of metric
+  std::atomic<unsigned long> fCount{0};        //!< counter value
+  std::atomic<double> fValue{0.};              //!< gauge value
+  std::unique_ptr<AtomicHistogram> fHistogram; //!< histogram (if Histogram)
+};
+
+class MetricCounter {
+public:
+  MetricCounter() = default;
+
+  void Add(unsigned long n = 1);
+  unsigned long Value() const;
+  explicit operator bool() const;
+
+private:
+  friend class Monitor;
+  explicit MetricCounter(std::shared_ptr<MetricCell> cell);
+
+  std::shared_ptr<MetricCell> fCell{}; //!< registered cell
+};
+
+class MetricGauge {
+public:
+  MetricGauge() = default;
+
+  void Set(double value);
+  double Value() const;
+  explicit operator bool() const;
+
+private:
+  friend class Monitor;
+  explicit MetricGauge(std::shared_ptr<MetricCell> cell);
+
+  std::shared_ptr<MetricCell> fCell{}; //!< registered cell
+};
+
+class MetricHistogram {
+public:
+  MetricHistogram() = default;
+
+  void Record(uint64_t value);
+  explicit operator bool() const;
+
+private:
+  friend class Monitor;
+  explicit MetricHistogram(std::shared_ptr<MetricCell> cell);
+
+  std::shared_ptr<MetricCell> fCell{}; //!< registered cell
+};
+
+} // end namespace cbm
+
+#include "MetricHandle.ipp"
+
+#endif
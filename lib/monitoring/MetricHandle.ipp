@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+namespace cbm {
+
+/*! \struct MetricCell
+  \brief Storage of a metric field registered with the Monitor
+
+  A cell is shared between the Monitor and the MetricCounter, MetricGauge or
+  MetricHistogram handles referring to it. The Monitor reports the cell a
+  last time and drops it once the last handle is gone.
+*/
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor from components
+  \param measurement  measurement id
+  \param tagset       set of tags
+  \param field        field name
+  \param kind         kind of metric
+ */
+
+inline MetricCell::MetricCell(const std::string& measurement,
+                              const MetricTagSet& tagset,
+                              const std::string& field,
+                              Kind kind)
+    : fMeasurement(measurement), fTagset(tagset), fField(field), fKind(kind) {
+  if (kind == Kind::Histogram)
+    fHistogram = std::make_unique<AtomicHistogram>();
+}
+
+/*! \class MetricCounter
+  \brief Handle of a monotonic counter registered with the Monitor
+
+  Updates are a single relaxed atomic addition and do not allocate, the
+  Monitor work thread emits the current value periodically. A default
+  constructed handle is not registered, updates are silently ignored.
+*/
+
+//-----------------------------------------------------------------------------
+//! \brief Constructor from a registered cell (used by Monitor)
+
+inline MetricCounter::MetricCounter(std::shared_ptr<MetricCell> cell)
+    : fCell(std::move(cell)) {}
+
+//-----------------------------------------------------------------------------
+/*! \brief Increment the counter
+  \param n  increment
+ */
+
+inline void MetricCounter::Add(unsigned long n) {
+  if (fCell)
+    fCell->fCount.fetch_add(n, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the current counter value
+
+inline unsigned long MetricCounter::Value() const {
+  return fCell ? fCell->fCount.load(std::memory_order_relaxed) : 0;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns true if the handle is registered
+
+inline MetricCounter::operator bool() const { return bool(fCell); }
+
+/*! \class MetricGauge
+  \brief Handle of a gauge registered with the Monitor
+
+  Updates are a single relaxed atomic store and do not allocate, the Monitor
+  work thread emits the last value periodically. A default constructed
+  handle is not registered, updates are silently ignored.
+*/
+
+//-----------------------------------------------------------------------------
+//! \brief Constructor from a registered cell (used by Monitor)
+
+inline MetricGauge::MetricGauge(std::shared_ptr<MetricCell> cell)
+    : fCell(std::move(cell)) {}
+
+//-----------------------------------------------------------------------------
+/*! \brief Set the gauge value
+  \param value  new value
+ */
+
+inline void MetricGauge::Set(double value) {
+  if (fCell)
+    fCell->fValue.store(value, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the current gauge value
+
+inline double MetricGauge::Value() const {
+  return fCell ? fCell->fValue.load(std::memory_order_relaxed) : 0.;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns true if the handle is registered
+
+inline MetricGauge::operator bool() const { return bool(fCell); }
+
+/*! \class MetricHistogram
+  \brief Handle of a latency histogram registered with the Monitor
+
+  Values are recorded lock-free into an AtomicHistogram. The Monitor work
+  thread emits the count, some percentiles and the maximum of the values
+  recorded in each reporting period. A default constructed handle is not
+  registered, values are silently ignored.
+*/
+
+//-----------------------------------------------------------------------------
+//! \brief Constructor from a registered cell (used by Monitor)
+
+inline MetricHistogram::MetricHistogram(std::shared_ptr<MetricCell> cell)
+    : fCell(std::move(cell)) {}
+
+//-----------------------------------------------------------------------------
+/*! \brief Record a value
+  \param value  value to record, e.g. a latency in us
+ */
+
+inline void MetricHistogram::Record(uint64_t value) {
+  if (fCell)
+    fCell->fHistogram->Record(value);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns true if the handle is registered
+
+inline MetricHistogram::operator bool() const { return bool(fCell); }
+
+} // end namespace cbm
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MetricQueue.hpp"
+
+#include <utility>
+
+namespace cbm {
+
+/*! \class MetricQueue
+  \brief Multi-producer single-consumer queue of Metric points
+
+  Each producer thread gets a ring buffer of its own, so that producers do
+  not contend with each other or with the consumer. The only lock is taken
+  when a thread queues its first point, and by the consumer to iterate
+  over the rings (see ThreadRings). If the ring of a producer is full, the point is dropped and
+  counted in Drops().
+
+  Points queued by one thread are drained in order, there is no ordering
+  between threads.
+*/
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor
+  \param capacity  minimal number of queued points per producer thread
+ */
+
+MetricQueue::MetricQueue(size_t capacity) : fRings(capacity) {}
+
+//-----------------------------------------------------------------------------
+/*! \brief Moves all queued points to a metric list (consumer only)
+  \param metvec  metric list, points are appended
+  \returns number of points moved
+
+  Rings of producer threads which have terminated are dropped once empty.
+ */
+
+size_t MetricQueue::Drain(std::vector<Metric>& metvec) {
+  size_t n = 0;
+  fRings.ForEach([&metvec, &n](ThreadRings<Metric>::ring_t& ring) {
+    for (; !ring.Empty(); ring.Pop(), ++n)
+      metvec.emplace_back(std::move(ring.Front()));
+  });
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the number of producer threads
+
+size_t MetricQueue::NProducer() { return fRings.Size(); }
+
+} // end namespace cbm
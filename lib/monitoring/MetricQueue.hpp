@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#ifndef included_Cbm_MetricQueue
+#define included_Cbm_MetricQueue 1
+
+#include "Metric.hpp"
+#include "ThreadRings.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace cbm {
+
+class MetricQueue {
+public:
+  explicit MetricQueue(size_t capacity);
+
+  MetricQueue(const MetricQueue&) = delete;
+  MetricQueue& operator=(const MetricQueue&) = delete;
+
+  bool Push(Metric&& point);
+  size_t Drain(std::vector<Metric>& metvec);
+
+  unsigned long Drops() const;
+  size_t NProducer();
+
+private:
+  ThreadRings<Metric> fRings;           //!< rings of all producers
+  std::atomic<unsigned long> fDrops{0}; //!< # of dropped metrics
+};
+
+} // end namespace cbm
+
+#include "MetricQueue.ipp"
+
+#endif
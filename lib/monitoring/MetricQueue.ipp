@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+namespace cbm {
+
+//-----------------------------------------------------------------------------
+/*! \brief Queues a metric point
+  \param point  Metric object, will be `move`ed to the queue
+  \returns false if the ring of the calling thread is full and the point was
+    dropped
+ */
+
+inline bool MetricQueue::Push(Metric&& point) {
+  if (!fRings.Local().Push(std::move(point))) {
+    fDrops.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the total number of dropped metric points
+
+inline unsigned long MetricQueue::Drops() const {
+  return fDrops.load(std::memory_order_relaxed);
+}
+
+} // end namespace cbm
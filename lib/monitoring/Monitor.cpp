@@ -7,7 +7,10 @@
 #include "MonitorSinkFile.hpp"
 #include "MonitorSinkInflux1.hpp"
 #include "MonitorSinkInflux2.hpp"
+#include "MonitorSinkPrometheus.hpp"
 #include "System.hpp"
+#include <algorithm>
+#include <map>
 #include <stdexcept>
 
 #include "fmt/format.h"
@@ -43,25 +46,45 @@ namespace cbm {
 
   See QueueMetric() for a more detailed description the Monitor input interface.
 
+  Metrics updated in hot code paths can be registered once with
+  RegisterCounter() or RegisterGauge(). The returned handles are updated with
+  plain atomic operations, the Monitor emits their values periodically
+  \code{.cpp}
+   auto sent = Monitor::Ref().RegisterCounter("sender",          // measurement
+                                              {{"conn", cname}}, // tags
+                                              "bytes");          // field
+   ...
+   sent.Add(nbyte);
+  \endcode
+
   The Monitor back end is provided by MonitorSink objects and controlled via
   - OpenSink(): creates a new sink
   - CloseSink(): removes a sink
 
-  Currently two sink types are implemented
+  Currently four sink types are implemented
   - MonitorSinkFile: writes to files
   - MonitorSinkInflux1: writes to an InfluxDB V1.x time-series database
   - MonitorSinkInflux2: writes to an InfluxDB V2.x time-series database
+  - MonitorSinkPrometheus: serves a Prometheus scrape endpoint
 
   The Monitor is a \glos{singleton} and accessed via the Monitor::Ref() static
   method.
 
   \note **Implementation notes**
-  - the Monitor uses a worker thread named "cbm:monitor" and a `mutex` to
-    protect the metric queue. The code sequences executed under `mutex` lock
-    use `std::move` and are absolutely minimal, contention when locking the
-    `mutex` is thus very unlikely:
-    - at metrics queueing: just a `vector::push_back(move(...))`
-    - at metrics processing: just a `vector::swap(...)`
+  - the Monitor uses a worker thread named "cbm:monitor" and a lock-free
+    MetricQueue with a ring buffer per producer thread. Queueing a metric is
+    just a `move` into the ring of the calling thread, the worker thread
+    drains all rings every kELoopTimeout. Metrics are dropped if a thread
+    queues more than kQueueSize metrics in this time.
+  - the worker thread reports the queue statistics with each heartbeat as
+    measurement "MonitorQueue" with the fields
+    - `queued`: number of metrics queued in last period
+    - `depth`: maximal number of metrics drained at once in last period
+    - `drops`: number of metrics dropped in last period
+    - `producers`: number of threads which have queued metrics
+  - registered counters and gauges are snapshot by the worker thread every
+    kELoopTimeout, fields with the same measurement and tags are combined
+    into one Metric
 */
 
 //-----------------------------------------------------------------------------
@@ -124,6 +147,7 @@ Monitor::~Monitor() {
   - `file`: will create a MonitorSinkFile sink
   - `influx1`: will create a MonitorSinkInflux1 sink
   - `influx2`: will create a MonitorSinkInflux2 sink
+  - `prometheus`: will create a MonitorSinkPrometheus sink
  */
 
 void Monitor::OpenSink(const std::string& sname) {
@@ -160,6 +184,11 @@ void Monitor::OpenSink(const std::string& sname) {
         std::make_unique<MonitorSinkInflux2>(*this, spath);
     std::lock_guard<std::mutex> lock(fSinkMapMutex);
     fSinkMap.try_emplace(sname, move(uptr));
+  } else if (stype == "prometheus") {
+    std::unique_ptr<MonitorSink> uptr =
+        std::make_unique<MonitorSinkPrometheus>(*this, spath);
+    std::lock_guard<std::mutex> lock(fSinkMapMutex);
+    fSinkMap.try_emplace(sname, move(uptr));
   } else {
     throw std::runtime_error(
         fmt::format("Monitor::OpenSink: invalid sink type '{}'", stype));
@@ -208,14 +237,9 @@ void Monitor::QueueMetric(const Metric& point) {
 void Monitor::QueueMetric(Metric&& point) {
   if (fStopped)
     return; // discard when already stopped
-  auto ts = point.fTimestamp;
-  if (ts == time_point())
-    ts = std::chrono::system_clock::now();
-  {
-    std::lock_guard<std::mutex> lock(fMetVecMutex);
-    fMetVec.emplace_back(std::move(point));
-    fMetVec[fMetVec.size() - 1].fTimestamp = ts;
-  }
+  if (point.fTimestamp == time_point())
+    point.fTimestamp = std::chrono::system_clock::now();
+  fMetQueue.Push(std::move(point));
 }
 
 //-----------------------------------------------------------------------------
@@ -266,6 +290,146 @@ void Monitor::QueueMetric(const std::string& measurement,
   QueueMetric(std::move(point));
 }
 
+//-----------------------------------------------------------------------------
+/*! \brief Registers a counter
+  \param measurement  measurement id
+  \param tagset       set of tags
+  \param field        field name
+  \returns handle of the counter, registered as long as a copy exists
+ */
+
+MetricCounter Monitor::RegisterCounter(const std::string& measurement,
+                                       const MetricTagSet& tagset,
+                                       const std::string& field) {
+  return MetricCounter(
+      RegisterCell(measurement, tagset, field, MetricCell::Kind::Counter));
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Registers a gauge
+  \param measurement  measurement id
+  \param tagset       set of tags
+  \param field        field name
+  \returns handle of the gauge, registered as long as a copy exists
+ */
+
+MetricGauge Monitor::RegisterGauge(const std::string& measurement,
+                                   const MetricTagSet& tagset,
+                                   const std::string& field) {
+  return MetricGauge(
+      RegisterCell(measurement, tagset, field, MetricCell::Kind::Gauge));
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Registers a histogram
+  \param measurement  measurement id
+  \param tagset       set of tags
+  \param field        field name, used as prefix of the reported fields
+  \returns handle of the histogram, registered as long as a copy exists
+
+  Each period the fields `<field>_count` with the number of values recorded
+  in the period and, if not zero, `<field>_p50`, `<field>_p90`,
+  `<field>_p99`, `<field>_p999` and `<field>_max` are reported. The
+  histogram is reset after each report.
+ */
+
+MetricHistogram Monitor::RegisterHistogram(const std::string& measurement,
+                                           const MetricTagSet& tagset,
+                                           const std::string& field) {
+  return MetricHistogram(
+      RegisterCell(measurement, tagset, field, MetricCell::Kind::Histogram));
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Creates and registers a cell for a handle
+
+std::shared_ptr<MetricCell> Monitor::RegisterCell(
+    const std::string& measurement,
+    const MetricTagSet& tagset,
+    const std::string& field,
+    MetricCell::Kind kind) {
+  auto cell = std::make_shared<MetricCell>(measurement, tagset, field, kind);
+  std::lock_guard<std::mutex> lock(fCellVecMutex);
+  fCellVec.push_back(cell);
+  return cell;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Appends the count, percentiles and maximum of a histogram
+
+static void AppendHistogramFields(MetricFieldSet& fields,
+                                  const std::string& field,
+                                  const Histogram& hist) {
+  static const std::pair<const char*, double> kPercentiles[] = {
+      {"_p50", 50.}, {"_p90", 90.}, {"_p99", 99.}, {"_p999", 99.9}};
+
+  fields.emplace_back(field + "_count", hist.Count());
+  if (hist.Count() == 0)
+    return;
+  for (auto& pct : kPercentiles)
+    fields.emplace_back(field + pct.first, hist.Percentile(pct.second));
+  fields.emplace_back(field + "_max", hist.Max());
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Appends the current values of all registered cells to a metric list
+  \param metvec  metric list
+
+  Cells without remaining handles are reported a last time and dropped from
+  the registry.
+ */
+
+void Monitor::SnapshotCells(metvec_t& metvec) {
+  using series_t = std::pair<std::string, MetricTagSet>;
+  std::map<series_t, MetricFieldSet> series;
+  {
+    std::lock_guard<std::mutex> lock(fCellVecMutex);
+    auto it = fCellVec.begin();
+    while (it != fCellVec.end()) {
+      auto& cell = *it;
+      auto& fields = series[{cell->fMeasurement, cell->fTagset}];
+      switch (cell->fKind) {
+      case MetricCell::Kind::Counter:
+        fields.emplace_back(cell->fField,
+                            cell->fCount.load(std::memory_order_relaxed));
+        break;
+      case MetricCell::Kind::Gauge:
+        fields.emplace_back(cell->fField,
+                            cell->fValue.load(std::memory_order_relaxed));
+        break;
+      case MetricCell::Kind::Histogram:
+        AppendHistogramFields(fields, cell->fField,
+                              cell->fHistogram->Snapshot(true));
+        break;
+      }
+      // only the registry holds the cell, no more updates are possible
+      if (cell.use_count() == 1)
+        it = fCellVec.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  auto ts = std::chrono::system_clock::now();
+  for (auto& kv : series)
+    metvec.emplace_back(kv.first.first, kv.first.second, move(kv.second), ts);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Queues the metric queue statistics of the last period
+
+void Monitor::QueueStatistics() {
+  unsigned long drops = fMetQueue.Drops();
+  QueueMetric("MonitorQueue", {{"host", fHostName}},
+              {{"queued", fStatNQueued},
+               {"depth", fStatMaxDepth},
+               {"drops", drops - fStatDrops},
+               {"producers", fMetQueue.NProducer()}});
+  fStatNQueued = 0;
+  fStatMaxDepth = 0;
+  fStatDrops = drops;
+}
+
 //-----------------------------------------------------------------------------
 /*! \brief The event loop of Monitor work thread
  */
@@ -282,22 +446,10 @@ void Monitor::EventLoop() {
     // timeout results in auto flush
 
     metvec_t metvec;
-    {
-      std::lock_guard<std::mutex> lock(fMetVecMutex);
-      if (!fMetVec.empty()) {
-        // move whole vector from protected queue to local environment
-        metvec.swap(fMetVec);
-        // determine sensible capacity to minimize re-allocs
-        size_t ncap = metvec.capacity();
-        if (metvec.size() > metvec.capacity() / 2)
-          ncap += ncap / 2;
-        else
-          ncap = ncap / 2;
-        if (ncap < 4)
-          ncap = 4;
-        fMetVec.reserve(ncap);
-      }
-    }
+    size_t ndrain = fMetQueue.Drain(metvec);
+    fStatNQueued += ndrain;
+    fStatMaxDepth = std::max(fStatMaxDepth, ndrain);
+    SnapshotCells(metvec);
 
     if (metvec.size() > 0) {
       std::lock_guard<std::mutex> lock(fSinkMapMutex);
@@ -307,6 +459,7 @@ void Monitor::EventLoop() {
     if (std::chrono::system_clock::now() > fNextHeartbeat && !stopped) {
       // handle heartbeats
       fNextHeartbeat += kHeartbeat; // schedule next
+      QueueStatistics();
       std::lock_guard<std::mutex> lock(fSinkMapMutex);
       for (auto& kv : fSinkMap)
         (*kv.second).ProcessHeartbeat();
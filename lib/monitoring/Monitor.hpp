@@ -6,6 +6,8 @@
 #define included_Cbm_Monitor 1
 
 #include "Metric.hpp"
+#include "MetricHandle.hpp"
+#include "MetricQueue.hpp"
 #include "MonitorSink.hpp"
 
 #include <chrono>
@@ -49,6 +51,15 @@ public:
                    MetricTagSet&& tagset,
                    MetricFieldSet&& fieldset,
                    time_point timestamp = time_point());
+  MetricCounter RegisterCounter(const std::string& measurement,
+                                const MetricTagSet& tagset,
+                                const std::string& field);
+  MetricGauge RegisterGauge(const std::string& measurement,
+                            const MetricTagSet& tagset,
+                            const std::string& field);
+  MetricHistogram RegisterHistogram(const std::string& measurement,
+                                    const MetricTagSet& tagset,
+                                    const std::string& field);
   const std::string& HostName() const;
 
   static Monitor& Ref();
@@ -60,23 +71,36 @@ public:
       std::chrono::seconds(10); //!< monitor flush time
   static constexpr auto kHeartbeat =
       std::chrono::seconds(60); //!< heartbeat interval
+  static constexpr size_t kQueueSize =
+      4096; //!< metric queue size per producer thread
 
 private:
   void EventLoop();
+  std::shared_ptr<MetricCell> RegisterCell(const std::string& measurement,
+                                           const MetricTagSet& tagset,
+                                           const std::string& field,
+                                           MetricCell::Kind kind);
+  void SnapshotCells(std::vector<Metric>& metvec);
+  void QueueStatistics();
   MonitorSink& SinkRef(const std::string& sname);
 
 private:
   using metvec_t = std::vector<Metric>;
   using sink_uptr_t = std::unique_ptr<MonitorSink>;
   using smap_t = std::unordered_map<std::string, sink_uptr_t>;
+  using cellvec_t = std::vector<std::shared_ptr<MetricCell>>;
 
   std::thread fThread{};              //!< worker thread
   std::condition_variable fControlCV; //!< condition variable for thread control
   std::mutex fControlMutex{};         //!< mutex for thread control
   bool fStopped{false};               //!< signals thread rundown
 
-  metvec_t fMetVec{};          //!< metric list
-  std::mutex fMetVecMutex{};   //!< mutex for fMetVec access
+  MetricQueue fMetQueue{kQueueSize}; //!< metric queue
+  size_t fStatNQueued{0};            //!< # of metrics queued in last period
+  size_t fStatMaxDepth{0};           //!< max # of metrics drained at once
+  unsigned long fStatDrops{0};       //!< # of dropped metrics at last report
+  cellvec_t fCellVec{};        //!< registered handle cells   
+  std::mutex fCellVecMutex{};  //!< mutex for fCellVec access
   std::string fHostName{""};   //!< hostname
   smap_t fSinkMap{};           //!< sink registry
   std::mutex fSinkMapMutex{};  //!< mutex for fSinkMap access
@@ -18,6 +18,8 @@ namespace cbm {
   Concrete implementations are
   - MonitorSinkFile: concrete sink for file output (in InfluxDB line format)
   - MonitorSinkInflux1: concrete sink for InfluxDB V1 output
+  - MonitorSinkInflux2: concrete sink for InfluxDB V2 output
+  - MonitorSinkPrometheus: concrete sink for a Prometheus scrape endpoint
 */
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MonitorSinkHttp.hpp"
+
+#include "Monitor.hpp"
+#include "System.hpp"
+#include <stdexcept>
+
+// define needed for Boost 1.67 in Debian Buster to avoid a missing
+// boost::system::system_category() symbol. That's apparently default since
+// Boost 1.69, so Boost 1.71 (Ub focal) and 1.74 (Debian Bullseye work fine
+// without. See https://stackoverflow.com/questions/9723793/
+#define BOOST_ERROR_CODE_HEADER_ONLY
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/version.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace cbm {
+using tcp = boost::asio::ip::tcp;     // from <boost/asio/ip/tcp.hpp>
+namespace http = boost::beast::http;  // from <boost/beast/http.hpp>
+using namespace std::string_literals; // for ""s
+
+// some constants
+static const size_t kSendChunkSize = 2'000'000ull; // send chunk size
+static const size_t kMaxQueuedChunks = 64;         // send queue limit
+
+/*! \class MonitorSinkHttp
+  \brief Monitor sink - common base for InfluxDB HTTP output
+
+  Converts the queued metrics to InfluxDB line protocol on the Monitor work
+  thread and hands them in chunks of at most `kSendChunkSize` bytes to a
+  sender thread named "cbm:monsink". The sender thread posts the chunks,
+  gzip compressed unless `fCompress` is cleared, over a persistent HTTP/1.1
+  keep-alive connection. A connection found closed by the server is set up
+  again and the request is retried once. If the server falls behind by more
+  than `kMaxQueuedChunks` chunks, the oldest chunks are dropped.
+
+  Concrete sinks set up the endpoint (`fHost`, `fPort`, `fTarget`) and the
+  request header fields in their constructor. It also writes periodically
+  some self-monitoring data as Metric to measurement "Monitor" with the fields
+  - `points`: number of metrics in last period
+  - `tags`: total number of tags in all metrics in last period
+  - `fields`: total number of fields in all metrics in last period
+  - `sends`: number of HTTP post requests in last period
+  - `bytes`: total number bytes written in last period
+  - `sndtime`: total elapsed time spend in HTTP post requests (in s)
+  - `drops`: number of chunks dropped in last period
+  - `connects`: number of connection setups in last period
+*/
+
+//-----------------------------------------------------------------------------
+//! \brief Persistent connection to the server, used by the sender thread
+
+struct MonitorSinkHttp::Connection {
+  boost::asio::io_context ioc;      //!< required for all I/O
+  tcp::resolver resolver{ioc};      //!< resolver for fHost
+  tcp::socket socket{ioc};          //!< the connection
+  boost::beast::flat_buffer buffer; //!< read buffer, persisted across reads
+
+  void Close() {
+    boost::system::error_code ec;
+    socket.shutdown(tcp::socket::shutdown_both, ec);
+    socket.close(ec);
+    buffer.clear();
+  }
+};
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor
+  \param monitor back reference to Monitor
+  \param path    sink path
+ */
+
+MonitorSinkHttp::MonitorSinkHttp(Monitor& monitor, const std::string& path)
+    : MonitorSink(monitor, path), fConn(std::make_unique<Connection>()) {}
+
+//-----------------------------------------------------------------------------
+/*! \brief Destructor
+
+  Sends all still queued chunks and terminates the sender thread.
+ */
+
+MonitorSinkHttp::~MonitorSinkHttp() {
+  {
+    std::lock_guard<std::mutex> lk(fQueueMutex);
+    fStopped = true;
+  }
+  fQueueCV.notify_one();
+
+  if (fThread.joinable())
+    fThread.join();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Process a vector of metrics
+ */
+
+void MonitorSinkHttp::ProcessMetricVec(const std::vector<Metric>& metvec) {
+  std::string msg;
+
+  fStatNPoint += metvec.size();
+  for (auto& met : metvec) {
+    fStatNTag += met.fTagset.size();
+    fStatNField += met.fFieldset.size();
+    msg += InfluxLine(met) + "\n"s;
+    if (msg.size() > kSendChunkSize) { // limit send chunk size
+      QueueData(std::move(msg));
+      msg.clear();
+    }
+  }
+  if (msg.size() > 0)
+    QueueData(std::move(msg));
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Process heartbeat
+ */
+
+void MonitorSinkHttp::ProcessHeartbeat() {
+  std::lock_guard<std::mutex> lock(fStatMutex);
+  Monitor::Ref().QueueMetric("Monitor",                       // measurement
+                             {{"host", fMonitor.HostName()}}, // no extra tags
+                             {{"points", fStatNPoint},        // fields
+                              {"tags", fStatNTag},
+                              {"fields", fStatNField},
+                              {"sends", fStatNSend},
+                              {"bytes", fStatNByte},
+                              {"sndtime", fStatSndTime}, // 'time' not allowed
+                              {"drops", fStatNDrop},
+                              {"connects", fStatNConnect}});
+  fStatNPoint = 0;
+  fStatNTag = 0;
+  fStatNField = 0;
+  fStatNSend = 0;
+  fStatNByte = 0;
+  fStatSndTime = 0.;
+  fStatNDrop = 0;
+  fStatNConnect = 0;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Queue a chunk of points in line format for the sender thread
+
+  The sender thread is started with the first chunk, when the concrete sink
+  is fully constructed.
+ */
+
+void MonitorSinkHttp::QueueData(std::string&& msg) {
+  {
+    std::lock_guard<std::mutex> lk(fQueueMutex);
+    if (!fThread.joinable())
+      fThread = std::thread([this]() { SendLoop(); });
+    if (fQueue.size() >= kMaxQueuedChunks) {
+      fQueue.pop_front();
+      std::lock_guard<std::mutex> lock(fStatMutex);
+      fStatNDrop += 1;
+    }
+    fQueue.push_back(std::move(msg));
+  }
+  fQueueCV.notify_one();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief The loop of the sender thread
+ */
+
+void MonitorSinkHttp::SendLoop() {
+  cbm::system::set_thread_name("cbm:monsink");
+
+  while (true) {
+    std::string msg;
+    {
+      std::unique_lock<std::mutex> lk(fQueueMutex);
+      fQueueCV.wait(lk, [this] { return fStopped || !fQueue.empty(); });
+      if (fQueue.empty())
+        break; // stopped and all chunks sent
+      msg = std::move(fQueue.front());
+      fQueue.pop_front();
+    }
+    SendData(msg);
+  }
+  fConn->Close();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Send a set of points in line format to database
+ */
+
+void MonitorSinkHttp::SendData(const std::string& msg) {
+  // start timer
+  auto tbeg = std::chrono::system_clock::now();
+
+  std::string zmsg;
+  if (fCompress) {
+    boost::iostreams::filtering_ostream os;
+    os.push(boost::iostreams::gzip_compressor());
+    os.push(boost::iostreams::back_inserter(zmsg));
+    os.write(msg.data(), static_cast<std::streamsize>(msg.size()));
+    os.reset(); // flush and finish the gzip stream
+  }
+  const std::string& body = fCompress ? zmsg : msg;
+
+  // a reused connection may have been closed by the server in the meantime,
+  // so retry once on a new connection
+  bool reused = fConn->socket.is_open();
+  while (true) {
+    try {
+      Post(body);
+      break;
+    } catch (std::exception const& e) {
+      fConn->Close();
+      if (!reused) {
+        ReportError("error="s + e.what());
+        return;
+      }
+      reused = false;
+    }
+  }
+
+  // do stats
+  std::chrono::duration<double> dt = std::chrono::system_clock::now() - tbeg;
+  std::lock_guard<std::mutex> lock(fStatMutex);
+  fStatNSend += 1;
+  fStatNByte += body.size();
+  fStatSndTime += dt.count();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Post a request on the persistent connection, connect if needed
+  \param body  request body
+  \throws std::exception in case of I/O errors
+ */
+
+void MonitorSinkHttp::Post(const std::string& body) {
+  auto& conn = *fConn;
+
+  if (!conn.socket.is_open()) {
+    // Look up the domain name and make the connection
+    auto const results = conn.resolver.resolve(fHost, fPort);
+    boost::asio::connect(conn.socket, results.begin(), results.end());
+    std::lock_guard<std::mutex> lock(fStatMutex);
+    fStatNConnect += 1;
+  }
+
+  // Set up an HTTP POST request message
+  int version = 11;
+  http::request<http::string_body> req{http::verb::post, fTarget, version};
+  req.set(http::field::host, fHost);
+  for (auto& hdr : fHeaders)
+    req.set(hdr.first, hdr.second);
+  if (fCompress)
+    req.set(http::field::content_encoding, "gzip");
+  req.keep_alive(true);
+  req.body() = body;
+  req.prepare_payload();
+
+  // Send the HTTP request and receive the response
+  http::write(conn.socket, req);
+  http::response<http::string_body> res;
+  http::read(conn.socket, conn.buffer, res);
+
+  if (!res.keep_alive())
+    conn.Close();
+
+  // Check response
+  // Note on boost::beast::http::response:
+  //   result() does not return the HTTP status, one gets the reason phrase as
+  //   it is also returned by reason(). result_int() return the status as int.
+  // Note on InfluxDB:
+  //   returns a 204 -> "No Content" for successful completion
+  //   returns a 404 -> "Not Found" if data base not existing
+  //   returns a 400 or 422 if request is ill-formed
+  if (res.result_int() != 200 && res.result_int() != 204) { // allow 200 & 204
+    std::string efields = "";
+    for (auto const& field : res) {
+      efields += std::string(field.name_string());       // C++17 string_view
+      efields += "=" + std::string(field.value()) + ";"; // limitation, grrr
+    }
+    std::string ebody = res.body(); // get body, trim \r and trailing \n
+    ebody.erase(std::remove(ebody.begin(), ebody.end(), '\r'), ebody.end());
+    if (!ebody.empty() && ebody[ebody.size() - 1] == '\n')
+      ebody.erase(ebody.size() - 1);
+
+    ReportError("HTTP status="s + std::to_string(res.result_int()) + " " +
+                std::string(res.reason()) + ", HTTP fields=" + efields +
+                ", HTTP body=" + ebody);
+  }
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Report a send error
+ */
+
+void MonitorSinkHttp::ReportError(const std::string& what) {
+#if defined(CBMLOGERR1)
+  CBMLOGERR1("cid=__Monitor", "SendData-err")
+      << "sinkname=" << fSinkPath << ", " << what;
+#else
+  std::cerr << fSinkName << "::SendData error: "
+            << "sinkname=" << fSinkPath << ", " << what << "\n";
+#endif
+}
+
+} // end namespace cbm
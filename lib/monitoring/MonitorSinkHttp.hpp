@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#ifndef included_Cbm_MonitorSinkHttp
+#define included_Cbm_MonitorSinkHttp 1
+
+#include "MonitorSink.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cbm {
+class MonitorSinkHttp : public MonitorSink {
+public:
+  MonitorSinkHttp(Monitor& monitor, const std::string& path);
+  virtual ~MonitorSinkHttp();
+
+  virtual void ProcessMetricVec(const std::vector<Metric>& metvec);
+  virtual void ProcessHeartbeat();
+
+protected:
+  using header_t = std::vector<std::pair<std::string, std::string>>;
+
+  std::string fSinkName; //!< sink class name, for messages
+  std::string fHost;     //!< server host name
+  std::string fPort;     //!< port for InfluxDB
+  std::string fTarget;   //!< target of the HTTP POST request
+  header_t fHeaders;     //!< additional HTTP request header fields
+  bool fCompress{true};  //!< send the line protocol gzip compressed
+
+private:
+  struct Connection;
+
+  void QueueData(std::string&& msg);
+  void SendLoop();
+  void SendData(const std::string& msg);
+  void Post(const std::string& body);
+  void ReportError(const std::string& what);
+
+private:
+  std::unique_ptr<Connection> fConn; //!< persistent server connection
+  std::thread fThread{};             //!< sender thread
+  std::deque<std::string> fQueue{};  //!< queue of chunks to be sent
+  std::mutex fQueueMutex{};          //!< mutex for fQueue and fStopped
+  std::condition_variable fQueueCV;  //!< signals new chunks or rundown
+  bool fStopped{false};              //!< signals thread rundown
+  std::mutex fStatMutex{};           //!< mutex for send statistics
+  long fStatNDrop{0};                //!< # of dropped chunks
+  long fStatNConnect{0};             //!< # of connection setups
+};
+
+} // end namespace cbm
+
+#endif
@@ -5,24 +5,16 @@
 #ifndef included_Cbm_MonitorSinkInflux1
 #define included_Cbm_MonitorSinkInflux1 1
 
-#include "MonitorSink.hpp"
+#include "MonitorSinkHttp.hpp"
 
 namespace cbm {
 
-class MonitorSinkInflux1 : public MonitorSink {
+class MonitorSinkInflux1 : public MonitorSinkHttp {
 public:
   MonitorSinkInflux1(Monitor& monitor, const std::string& path);
 
-  virtual void ProcessMetricVec(const std::vector<Metric>& metvec);
-  virtual void ProcessHeartbeat();
-
-private:
-  void SendData(const std::string& msg);
-
 private:
-  std::string fHost; //!< server host name
-  std::string fPort; //!< port for InfluxDB
-  std::string fDB;   //!< target database
+  std::string fDB; //!< target database
 };
 
 } // end namespace cbm
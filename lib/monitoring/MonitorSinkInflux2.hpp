@@ -5,22 +5,14 @@
 #ifndef included_Cbm_MonitorSinkInflux2
 #define included_Cbm_MonitorSinkInflux2 1
 
-#include "MonitorSink.hpp"
+#include "MonitorSinkHttp.hpp"
 
 namespace cbm {
-class MonitorSinkInflux2 : public MonitorSink {
+class MonitorSinkInflux2 : public MonitorSinkHttp {
 public:
   MonitorSinkInflux2(Monitor& monitor, const std::string& path);
 
-  virtual void ProcessMetricVec(const std::vector<Metric>& metvec);
-  virtual void ProcessHeartbeat();
-
-private:
-  void SendData(const std::string& msg);
-
 private:
-  std::string fHost;   //!< server host name
-  std::string fPort;   //!< port for InfluxDB
   std::string fBucket; //!< target bucket
   std::string fToken;  //!< access token
 };
@@ -0,0 +1,367 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "MonitorSinkPrometheus.hpp"
+
+#include "Monitor.hpp"
+#include "System.hpp"
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+// see MonitorSinkHttp.cpp
+#define BOOST_ERROR_CODE_HEADER_ONLY
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <cctype>
+#include <cmath>
+#include <regex>
+
+namespace cbm {
+using tcp = boost::asio::ip::tcp;     // from <boost/asio/ip/tcp.hpp>
+namespace beast = boost::beast;       // from <boost/beast/core.hpp>
+namespace http = boost::beast::http;  // from <boost/beast/http.hpp>
+using namespace std::string_literals; // for ""s
+
+// some constants
+static const auto kRequestTimeout = std::chrono::seconds(5);
+static const auto kSampleExpiry = std::chrono::minutes(5);
+static const char* kContentType = "text/plain; version=0.0.4; charset=utf-8";
+
+/*! \class MonitorSinkPrometheus
+  \brief Monitor sink - concrete sink serving a Prometheus scrape endpoint
+
+  Keeps the latest value of every field of every series and serves them at
+  `/metrics` in the Prometheus text exposition format. Each field becomes a
+  metric named `<measurement>_<field>` with the tags as labels, string
+  fields are ignored and booleans are exported as 0 or 1. Series not
+  updated for `kSampleExpiry` are dropped.
+
+  The exposition text is rendered once per processed metric vector on the
+  Monitor work thread. A listener thread named "cbm:monprom" answers each
+  scrape with the latest rendered text, without any further work per scrape.
+
+  It also writes periodically some self-monitoring data as Metric to
+  measurement "Monitor" with the fields
+  - `points`: number of metrics in last period
+  - `series`: number of exported samples
+  - `scrapes`: number of scrapes served in last period
+  - `bytes`: total number bytes served in last period
+*/
+
+//-----------------------------------------------------------------------------
+//! \brief HTTP listener state, used by the listener thread
+
+struct MonitorSinkPrometheus::Server {
+  boost::asio::io_context ioc;   //!< required for all I/O
+  tcp::acceptor acceptor{ioc};   //!< listening socket
+  void Accept(MonitorSinkPrometheus& sink);
+};
+
+//-----------------------------------------------------------------------------
+//! \brief A single scrape request, answered with a `Connection: close`
+
+struct MonitorSinkPrometheus::Session
+    : public std::enable_shared_from_this<Session> {
+  Session(MonitorSinkPrometheus& sink, tcp::socket&& socket)
+      : fSink(sink), fStream(std::move(socket)) {}
+
+  void Read();
+  void Respond();
+
+  MonitorSinkPrometheus& fSink;                    //!< back reference
+  beast::tcp_stream fStream;                       //!< the connection
+  beast::flat_buffer fBuffer{};                    //!< read buffer
+  http::request<http::empty_body> fRequest{};      //!< the request
+  std::shared_ptr<const std::string> fBody;        //!< served snapshot
+  http::response<http::span_body<const char>> fResponse{}; //!< the response
+};
+
+//-----------------------------------------------------------------------------
+//! \brief Accepts the next connection
+
+void MonitorSinkPrometheus::Server::Accept(MonitorSinkPrometheus& sink) {
+  acceptor.async_accept([this, &sink](beast::error_code ec,
+                                      tcp::socket socket) {
+    if (!ec)
+      std::make_shared<Session>(sink, std::move(socket))->Read();
+    if (acceptor.is_open())
+      Accept(sink);
+  });
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Reads the request
+
+void MonitorSinkPrometheus::Session::Read() {
+  fStream.expires_after(kRequestTimeout);
+  http::async_read(fStream, fBuffer, fRequest,
+                   [self = shared_from_this()](beast::error_code ec,
+                                               std::size_t) {
+                     if (!ec)
+                       self->Respond();
+                   });
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Writes the response, the latest snapshot for `GET /metrics`
+
+void MonitorSinkPrometheus::Session::Respond() {
+  std::string target(fRequest.target());
+  target = target.substr(0, target.find('?'));
+
+  fResponse.version(fRequest.version());
+  fResponse.keep_alive(false);
+  fResponse.set(http::field::server, "cbm::Monitor");
+  if (fRequest.method() != http::verb::get) {
+    fResponse.result(http::status::method_not_allowed);
+  } else if (target != "/metrics") {
+    fResponse.result(http::status::not_found);
+  } else {
+    fBody = fSink.Snapshot();
+    fResponse.result(http::status::ok);
+    fResponse.set(http::field::content_type, kContentType);
+    fResponse.body() = {fBody->data(), fBody->size()};
+    fSink.fStatNScrape += 1;
+    fSink.fStatNScrapeByte += fBody->size();
+  }
+  fResponse.prepare_payload();
+
+  http::async_write(fStream, fResponse,
+                    [self = shared_from_this()](beast::error_code,
+                                                std::size_t) {
+                      beast::error_code ec;
+                      self->fStream.socket().shutdown(
+                          tcp::socket::shutdown_send, ec);
+                    });
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor
+  \param monitor back reference to Monitor
+  \param path listen endpoint as `[host:]port`
+  \throws std::runtime_error if `path` is malformed or the endpoint can't be
+    bound
+
+  Serves the metrics on the given port, on all interfaces unless `host` is
+  given. Port 0 selects a free port, see Port().
+ */
+
+MonitorSinkPrometheus::MonitorSinkPrometheus(Monitor& monitor,
+                                             const std::string& path)
+    : MonitorSink(monitor, path),
+      fSnapshot(std::make_shared<const std::string>()),
+      fServer(std::make_unique<Server>()) {
+  std::regex re_path(R"(^(?:(.+):)?([0-9]+)$)");
+  std::smatch match;
+  if (!regex_search(path.begin(), path.end(), match, re_path))
+    throw std::runtime_error(fmt::format("MonitorSinkPrometheus::ctor:"
+                                         " path not [host:]port '{}'",
+                                         path));
+  std::string host = match[1].matched ? match[1].str() : "0.0.0.0"s;
+  std::string port = match[2].str();
+
+  try {
+    tcp::resolver resolver(fServer->ioc);
+    tcp::endpoint endpoint =
+        *resolver.resolve(host, port, tcp::resolver::passive).begin();
+    auto& acceptor = fServer->acceptor;
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor.bind(endpoint);
+    acceptor.listen();
+  } catch (std::exception const& e) {
+    throw std::runtime_error(fmt::format("MonitorSinkPrometheus::ctor:"
+                                         " listen on '{}' failed: {}",
+                                         path, e.what()));
+  }
+
+  fServer->Accept(*this);
+  fThread = std::thread([this]() { ServeLoop(); });
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Destructor
+
+  Stops the listener thread, open scrape connections are closed.
+ */
+
+MonitorSinkPrometheus::~MonitorSinkPrometheus() {
+  fServer->ioc.stop();
+  if (fThread.joinable())
+    fThread.join();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Process a vector of metrics
+ */
+
+template <class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
+template <class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+
+void MonitorSinkPrometheus::ProcessMetricVec(
+    const std::vector<Metric>& metvec) {
+  fStatNPoint += metvec.size();
+  for (auto& met : metvec) {
+    std::string labels = LabelSet(met.fTagset);
+    for (auto& field : met.fFieldset) {
+      bool numeric = true;
+      double value =
+          visit(overloaded{[](bool arg) { return arg ? 1. : 0.; },
+                           [](int arg) { return double(arg); },
+                           [](long arg) { return double(arg); },
+                           [](unsigned long arg) { return double(arg); },
+                           [](double arg) { return arg; },
+                           [&numeric](const std::string&) {
+                             numeric = false;
+                             return 0.;
+                           }},
+                field.second);
+      if (numeric)
+        fFamilyMap[MetricName(met.fMeasurement, field.first)][labels] = {
+            value, met.fTimestamp};
+    }
+  }
+  if (metvec.size() > 0)
+    Render();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Process heartbeat
+
+  Drops expired samples and writes the self-monitoring data.
+ */
+
+void MonitorSinkPrometheus::ProcessHeartbeat() {
+  auto expiry = std::chrono::system_clock::now() - kSampleExpiry;
+  long nseries = 0;
+  for (auto it = fFamilyMap.begin(); it != fFamilyMap.end();) {
+    auto& family = it->second;
+    for (auto jt = family.begin(); jt != family.end();) {
+      if (jt->second.fTimestamp < expiry)
+        jt = family.erase(jt);
+      else
+        ++jt;
+    }
+    nseries += family.size();
+    if (family.empty())
+      it = fFamilyMap.erase(it);
+    else
+      ++it;
+  }
+  Render();
+
+  Monitor::Ref().QueueMetric("Monitor",                       // measurement
+                             {{"host", fMonitor.HostName()}}, // no extra tags
+                             {{"points", fStatNPoint},        // fields
+                              {"series", nseries},
+                              {"scrapes", fStatNScrape.exchange(0)},
+                              {"bytes", fStatNScrapeByte.exchange(0)}});
+  fStatNPoint = 0;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the port the sink listens on
+
+unsigned short MonitorSinkPrometheus::Port() const {
+  return fServer->acceptor.local_endpoint().port();
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the latest rendered exposition text
+
+std::shared_ptr<const std::string> MonitorSinkPrometheus::Snapshot() {
+  std::lock_guard<std::mutex> lock(fSnapshotMutex);
+  return fSnapshot;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Renders all samples in text exposition format into a new snapshot
+
+void MonitorSinkPrometheus::Render() {
+  fmt::memory_buffer buf;
+  for (auto& kv : fFamilyMap) {
+    fmt::format_to(std::back_inserter(buf), "# TYPE {} untyped\n", kv.first);
+    for (auto& sample : kv.second) {
+      double value = sample.second.fValue;
+      if (std::isnan(value))
+        fmt::format_to(std::back_inserter(buf), "{}{} NaN\n", kv.first,
+                       sample.first);
+      else if (std::isinf(value))
+        fmt::format_to(std::back_inserter(buf), "{}{} {}Inf\n", kv.first,
+                       sample.first, value > 0 ? '+' : '-');
+      else
+        fmt::format_to(std::back_inserter(buf), "{}{} {}\n", kv.first,
+                       sample.first, value);
+    }
+  }
+  auto snapshot = std::make_shared<const std::string>(to_string(buf));
+  std::lock_guard<std::mutex> lock(fSnapshotMutex);
+  fSnapshot = std::move(snapshot);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief The loop of the listener thread
+ */
+
+void MonitorSinkPrometheus::ServeLoop() {
+  cbm::system::set_thread_name("cbm:monprom");
+  fServer->ioc.run();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns a valid metric name for a field of a measurement
+
+  Characters not allowed in metric names are replaced by '_'.
+ */
+
+std::string MonitorSinkPrometheus::MetricName(const std::string& measurement,
+                                              const std::string& field) {
+  std::string res = measurement + "_" + field;
+  for (char& c : res) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != ':')
+      c = '_';
+  }
+  if (std::isdigit(static_cast<unsigned char>(res[0])))
+    res.insert(0, 1, '_');
+  return res;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns the label set of a tag set, including the braces
+
+  Label names are cleaned like metric names, label values are escaped.
+ */
+
+std::string MonitorSinkPrometheus::LabelSet(const MetricTagSet& tagset) {
+  if (tagset.empty())
+    return {};
+  std::string res = "{";
+  for (auto& tag : tagset) {
+    if (res.size() > 1)
+      res += ',';
+    std::string name = tag.first;
+    for (char& c : name) {
+      if (!std::isalnum(static_cast<unsigned char>(c)))
+        c = '_';
+    }
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+      name.insert(0, 1, '_');
+    res += name + "=\"";
+    for (char c : tag.second) {
+      if (c == '\\' || c == '"')
+        res += '\\';
+      if (c == '\n')
+        res += "\\n";
+      else
+        res += c;
+    }
+    res += '"';
+  }
+  res += '}';
+  return res;
+}
+
+} // end namespace cbm
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#ifndef included_Cbm_MonitorSinkPrometheus
+#define included_Cbm_MonitorSinkPrometheus 1
+
+#include "MonitorSink.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cbm {
+
+class MonitorSinkPrometheus : public MonitorSink {
+public:
+  MonitorSinkPrometheus(Monitor& monitor, const std::string& path);
+  virtual ~MonitorSinkPrometheus();
+
+  virtual void ProcessMetricVec(const std::vector<Metric>& metvec);
+  virtual void ProcessHeartbeat();
+
+  unsigned short Port() const;
+  std::shared_ptr<const std::string> Snapshot();
+
+private:
+  struct Server;
+  struct Session;
+
+  struct Sample {
+    double fValue;                 //!< latest value
+    Metric::time_point fTimestamp; //!< time of last update
+  };
+  using family_t = std::map<std::string, Sample>; //!< samples by label set
+
+  void Render();
+  void ServeLoop();
+  static std::string MetricName(const std::string& measurement,
+                                const std::string& field);
+  static std::string LabelSet(const MetricTagSet& tagset);
+
+private:
+  std::map<std::string, family_t> fFamilyMap{}; //!< metric families by name
+  std::shared_ptr<const std::string> fSnapshot; //!< rendered exposition
+  std::mutex fSnapshotMutex{};                  //!< mutex for fSnapshot
+  std::unique_ptr<Server> fServer;              //!< HTTP listener
+  std::thread fThread{};                        //!< listener thread
+  std::atomic<long> fStatNScrape{0};            //!< # of served scrapes
+  std::atomic<long> fStatNScrapeByte{0};        //!< # of served bytes
+};
+
+} // end namespace cbm
+
+#endif
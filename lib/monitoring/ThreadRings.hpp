@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#ifndef included_Cbm_ThreadRings
+#define included_Cbm_ThreadRings 1
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace cbm {
+
+/*! \class SpscRing
+  \brief Single-producer single-consumer ring buffer with `size` (a power of
+    two) slots
+ */
+
+template <typename T> class SpscRing {
+public:
+  explicit SpscRing(size_t size) : fSlots(size), fMask(size - 1) {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  //! \brief Stores a value, returns false if the ring is full (producer only)
+  template <typename U> bool Push(U&& value) {
+    size_t tail = fTail.load(std::memory_order_relaxed);
+    if (tail - fHeadCache > fMask) {
+      fHeadCache = fHead.load(std::memory_order_acquire);
+      if (tail - fHeadCache > fMask)
+        return false;
+    }
+    fSlots[tail & fMask] = std::forward<U>(value);
+    fTail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  //! \brief Returns true if the ring holds no value (consumer only)
+  bool Empty() const {
+    return fHead.load(std::memory_order_relaxed) ==
+           fTail.load(std::memory_order_acquire);
+  }
+
+  //! \brief Returns the oldest value, the ring must not be empty
+  //! (consumer only)
+  T& Front() { return fSlots[fHead.load(std::memory_order_relaxed) & fMask]; }
+
+  //! \brief Releases the oldest value to the producer (consumer only)
+  void Pop() {
+    fHead.store(fHead.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+private:
+  std::vector<T> fSlots;                     //!< ring buffer slots
+  const size_t fMask;                        //!< index mask
+  alignas(64) std::atomic<size_t> fTail{0};  //!< write index (producer)
+  size_t fHeadCache = 0;                     //!< producer copy of fHead
+  alignas(64) std::atomic<size_t> fHead{0};  //!< read index (consumer)
+};
+
+/*! \class ThreadRings
+  \brief Set of SpscRing buffers, one per producer thread
+
+  Each producer thread gets a ring of its own on first use, found again via
+  a thread-local lookup keyed by the id of the set. The only lock is taken
+  when a thread registers its ring, and by the consumer to iterate over the
+  rings. Rings of producer threads which have terminated are dropped once
+  they are empty.
+*/
+
+template <typename T> class ThreadRings {
+public:
+  using ring_t = SpscRing<T>;
+
+  //! \brief Constructor, rings hold at least `minimum_size` values
+  explicit ThreadRings(size_t minimum_size)
+      : fId(fNextId++), fRingSize(RingSize(minimum_size)) {}
+
+  ThreadRings(const ThreadRings&) = delete;
+  ThreadRings& operator=(const ThreadRings&) = delete;
+
+  //! \brief Returns the ring of the calling thread, creates it on first use
+  ring_t& Local() {
+    thread_local std::vector<std::pair<uint64_t, std::shared_ptr<ring_t>>>
+        rings;
+    for (auto& kv : rings) {
+      if (kv.first == fId)
+        return *kv.second;
+    }
+    auto ring = std::make_shared<ring_t>(fRingSize);
+    {
+      std::lock_guard<std::mutex> lock(fRingVecMutex);
+      fRingVec.push_back(ring);
+    }
+    rings.emplace_back(fId, ring);
+    return *ring;
+  }
+
+  //! \brief Calls `fn` for each ring (consumer only)
+  template <typename Fn> void ForEach(Fn&& fn) {
+    std::lock_guard<std::mutex> lock(fRingVecMutex);
+    for (auto it = fRingVec.begin(); it != fRingVec.end();) {
+      // a ring only referenced here belongs to a terminated thread
+      bool orphaned = it->use_count() == 1;
+      ring_t& ring = **it;
+      fn(ring);
+      if (orphaned && ring.Empty())
+        it = fRingVec.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  //! \brief Returns the number of producer threads
+  size_t Size() {
+    std::lock_guard<std::mutex> lock(fRingVecMutex);
+    return fRingVec.size();
+  }
+
+private:
+  static size_t RingSize(size_t minimum_size) {
+    size_t size = 2;
+    while (size < minimum_size)
+      size <<= 1;
+    return size;
+  }
+
+  static inline std::atomic<uint64_t> fNextId{0}; //!< source of set ids
+  const uint64_t fId;                             //!< id, for thread lookup
+  const size_t fRingSize;                         //!< slots per ring
+  std::vector<std::shared_ptr<ring_t>> fRingVec{}; //!< rings of all threads
+  std::mutex fRingVecMutex{};                      //!< mutex for fRingVec
+};
+
+} // end namespace cbm
+
+#endif
@@ -36,7 +36,9 @@ device::~device() {
   // do not delete PciDevice if it belongs to DeviceOperator
   // DeviceOperator will do the cleanup on deletion
   if (m_parent_dop == nullptr) {
-    if (PciDevice_delete(m_device, PDA_DELETE_PERSISTANT) != PDA_SUCCESS) {
+    if (PciDevice_delete(m_device, m_keep_buffers ? PDA_DELETE
+                                                  : PDA_DELETE_PERSISTANT) !=
+        PDA_SUCCESS) {
       cout << "Deleting device operator failed!" << endl;
     }
   }
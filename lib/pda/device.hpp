@@ -59,8 +59,15 @@ public:
    **/
   PciDevice* PDAPciDevice() { return (m_device); }
 
+  /**
+   * Keep persistent DMA buffers on deletion, so that a later process can
+   * attach them
+   **/
+  void keep_persistent_buffers(bool keep) { m_keep_buffers = keep; }
+
 protected:
   device_operator* m_parent_dop;
   PciDevice* m_device;
+  bool m_keep_buffers = false;
 };
 } // namespace pda
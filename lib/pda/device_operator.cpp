@@ -31,7 +31,9 @@ device_operator::device_operator() {
 }
 
 device_operator::~device_operator() {
-  if (DeviceOperator_delete(m_dop, PDA_DELETE_PERSISTANT) != PDA_SUCCESS) {
+  if (DeviceOperator_delete(m_dop, m_keep_buffers ? PDA_DELETE
+                                                 : PDA_DELETE_PERSISTANT) !=
+      PDA_SUCCESS) {
     cout << "Deleting device operator failed!" << endl;
   }
 }
@@ -23,8 +23,15 @@ public:
 
   DeviceOperator* PDADeviceOperator() { return (m_dop); }
 
+  /**
+   * Keep persistent DMA buffers on deletion, so that a later process can
+   * attach them
+   **/
+  void keep_persistent_buffers(bool keep) { m_keep_buffers = keep; }
+
 private:
   static std::array<const char*, 3> m_pci_ids;
   DeviceOperator* m_dop;
+  bool m_keep_buffers = false;
 };
 } // namespace pda
@@ -33,14 +33,31 @@ dma_buffer::dma_buffer(device* device, uint64_t size, uint64_t id) {
 }
 
 /** Register a malloced or memaligned buffer */
-dma_buffer::dma_buffer(device* device, void* buf, uint64_t size, uint64_t id) {
-  if (PDA_SUCCESS !=
-      PciDevice_registerDMABuffer(device->m_device, id, buf, size, &m_buffer)) {
+dma_buffer::dma_buffer(
+    device* device, void* buf, uint64_t size, uint64_t id, bool persistent)
+    : m_persistent(persistent) {
+  if (persistent && PDA_SUCCESS == PciDevice_getDMABuffer(device->m_device,
+                                                          id, &m_buffer)) {
+    size_t length = 0;
+    if (DMABuffer_getLength(m_buffer, &length) == PDA_SUCCESS &&
+        length == size) {
+      m_reused = true;
+    } else {
+      PciDevice_deleteDMABuffer(device->m_device, m_buffer);
+      m_buffer = nullptr;
+    }
+  }
+  if (!m_reused &&
+      PDA_SUCCESS !=
+          PciDevice_registerDMABuffer(device->m_device, id, buf, size,
+                                      &m_buffer)) {
     throw PdaException("DMA_BUFFER_FAULT_REG");
   }
 
   m_device = device->m_device;
   m_id = id;
+  // the map of a reused registration belongs to the registering process
+  m_mem = buf;
   connect();
 }
 
@@ -55,7 +72,11 @@ dma_buffer::dma_buffer(device* device, uint64_t id) {
   connect();
 }
 
-dma_buffer::~dma_buffer() { deallocate(); }
+dma_buffer::~dma_buffer() {
+  if (!m_persistent) {
+    deallocate();
+  }
+}
 
 std::string dma_buffer::print_buffer_info() {
   std::stringstream ss;
@@ -79,8 +100,9 @@ std::string dma_buffer::print_buffer_info() {
 void dma_buffer::connect() {
 
   // get pointer to memory
-  if (DMABuffer_getMap(m_buffer, reinterpret_cast<void**>(&m_mem)) !=
-      PDA_SUCCESS) {
+  if (m_mem == nullptr &&
+      DMABuffer_getMap(m_buffer, reinterpret_cast<void**>(&m_mem)) !=
+          PDA_SUCCESS) {
     throw PdaException("DMA_BUFFER_FAULT_MAP");
   }
 
@@ -94,11 +116,16 @@ void dma_buffer::connect() {
   if (DMABuffer_getSGList(m_buffer, &sglist) != PDA_SUCCESS) {
     throw PdaException("DMA_BUFFER_FAULT_SGLIST");
   }
-  sg_entry entry{};
+  // merge physically adjacent nodes into maximal contiguous runs
   for (DMABuffer_SGNode* sg = sglist; sg != nullptr; sg = sg->next) {
-    entry.pointer = sg->d_pointer;
-    entry.length = sg->length;
-    m_sglist.push_back(entry);
+    if (!m_sglist.empty() &&
+        static_cast<uint8_t*>(m_sglist.back().pointer) +
+                m_sglist.back().length ==
+            static_cast<uint8_t*>(sg->d_pointer)) {
+      m_sglist.back().length += sg->length;
+    } else {
+      m_sglist.push_back({sg->d_pointer, sg->length});
+    }
   }
 }
 
@@ -43,7 +43,19 @@ public:
    *        be unique within all instances of rorcfs_buffer on a machine.
    */
   dma_buffer(device* device, uint64_t size, uint64_t id);
-  dma_buffer(device* device, void* buf, uint64_t size, uint64_t id);
+
+  /**
+   * Register a malloced or memaligned buffer.
+   * @param persistent Keep the registration beyond the lifetime of this
+   *        object. An existing registration with Buffer-ID [id] and [size]
+   *        bytes is reused instead of registering (and pinning) the buffer
+   *        again. This is only valid if [buf] is the same memory as before,
+   *        i.e., part of a shared memory segment that has been kept.
+   */
+  dma_buffer(
+      device* device, void* buf, uint64_t size, uint64_t id, bool persistent);
+  dma_buffer(device* device, void* buf, uint64_t size, uint64_t id)
+      : dma_buffer(device, buf, size, id, false) {}
   dma_buffer(device* device, uint64_t id);
 
   ~dma_buffer();
@@ -69,13 +81,19 @@ public:
   void* mem() { return m_mem; }
 
   /**
-   * return SG list
+   * return SG list, physically contiguous pages form a single entry
    * @return verctor of scatter gather list entries
    **/
   std::vector<sg_entry> sg_list() { return m_sglist; }
 
   size_t num_sg_entries() { return m_sglist.size(); };
 
+  /**
+   * Whether an existing persistent registration has been reused
+   * @return true if the buffer has not been registered again
+   **/
+  bool reused() { return m_reused; }
+
   std::string print_buffer_info();
 
 private:
@@ -89,5 +107,7 @@ private:
   void* m_mem = nullptr;
   size_t m_size = 0;
   std::vector<sg_entry> m_sglist;
+  bool m_persistent = false;
+  bool m_reused = false;
 };
 } // namespace pda
@@ -0,0 +1,66 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#ifndef SHM_IPC_DISTRIBUTORSTATUS_HPP
+#define SHM_IPC_DISTRIBUTORSTATUS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The status of a worker of an ItemDistributor, published for inspection by
+ * other processes (e.g., in shared memory).
+ *
+ * The distributor thread is the only writer. It makes the sequence number
+ * odd while updating a slot, so that a reader can detect and retry an
+ * inconsistent read without ever blocking the writer.
+ */
+struct DistributorWorkerStatus {
+  static constexpr std::size_t max_name_length = 63;
+
+  std::atomic<uint64_t> sequence{0};
+  /// Description of the worker (zero-terminated, empty: slot unused)
+  std::array<std::atomic<char>, max_name_length + 1> name{};
+  /// Items sent to the worker and not yet completed
+  std::atomic<uint64_t> outstanding{0};
+  /// Items queued for the worker
+  std::atomic<uint64_t> waiting{0};
+  /// Steady clock time (ns) of the arrival of the oldest outstanding item
+  /// (0: none)
+  std::atomic<int64_t> oldest_arrival_ns{0};
+  /// Busy fraction of the last reported period in per mille (-1: no usage
+  /// reported, see WorkerUsage)
+  std::atomic<int32_t> utilization_pm{-1};
+  /// Mean time (us) per item of the last reported period from its arrival
+  /// to its retrieval by the consumer
+  std::atomic<uint64_t> wait_us{0};
+  /// Mean time (us) per item of the last reported period from its retrieval
+  /// to its release
+  std::atomic<uint64_t> hold_us{0};
+};
+
+/**
+ * The status of an ItemDistributor, published for inspection by other
+ * processes (see ItemDistributor::set_status()).
+ */
+struct DistributorStatus {
+  static constexpr std::size_t max_workers = 64;
+
+  /// Steady clock time (ns) of the last update
+  std::atomic<int64_t> updated_ns{0};
+  /// Items received and not yet completed by all workers
+  std::atomic<uint64_t> held_items{0};
+  /// Number of registered workers (may exceed max_workers)
+  std::atomic<uint32_t> num_workers{0};
+  std::array<DistributorWorkerStatus, max_workers> workers;
+};
+
+/// Convert a steady clock time to the representation in a DistributorStatus.
+inline int64_t status_time_ns(std::chrono::steady_clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             t.time_since_epoch())
+      .count();
+}
+
+#endif
@@ -1,52 +1,138 @@
 #include "ItemDistributor.hpp"
+#include "probes.hpp"
+#include "tracing.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 
-// Handle incoming message (work item) from the generator
-void ItemDistributor::on_generator_pollin() {
-  zmq::multipart_t message(generator_socket_);
+void ItemDistributor::publish_status() {
+  auto now = std::chrono::steady_clock::now();
+  if (now < status_time_ + status_interval_) {
+    return;
+  }
+  status_time_ = now;
 
-  // Receive item ID
-  ItemID id = std::stoull(message.popstr());
+  size_t slot = 0;
+  for (const auto& [identity, worker] : workers_) {
+    if (slot == DistributorStatus::max_workers) {
+      break;
+    }
+    DistributorWorkerStatus& s = status_->workers[slot++];
+    auto oldest = worker->oldest_outstanding_arrival();
+    std::string name = worker->description();
+    name.resize(
+        std::min(name.size(), DistributorWorkerStatus::max_name_length));
 
-  // Receive optional item payload
-  std::string payload;
-  if (!message.empty()) {
-    payload = message.popstr();
+    s.sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < s.name.size(); ++i) {
+      s.name[i].store(i < name.size() ? name[i] : '\0',
+                      std::memory_order_relaxed);
+    }
+    s.outstanding.store(worker->num_outstanding(), std::memory_order_relaxed);
+    s.waiting.store(worker->queue_size(), std::memory_order_relaxed);
+    s.oldest_arrival_ns.store(
+        oldest == std::chrono::steady_clock::time_point::max()
+            ? 0
+            : status_time_ns(oldest),
+        std::memory_order_relaxed);
+    const auto& usage = worker->usage();
+    const uint64_t items = usage ? usage->items : 0;
+    s.utilization_pm.store(
+        usage ? static_cast<int32_t>(usage->utilization() * 1000) : -1,
+        std::memory_order_relaxed);
+    s.wait_us.store(items != 0 ? usage->wait.count() / items : 0,
+                    std::memory_order_relaxed);
+    s.hold_us.store(items != 0 ? usage->hold.count() / items : 0,
+                    std::memory_order_relaxed);
+    s.sequence.fetch_add(1, std::memory_order_release);
   }
+  // clear the slots of workers that have left
+  for (; slot < DistributorStatus::max_workers; ++slot) {
+    DistributorWorkerStatus& s = status_->workers[slot];
+    if (s.name[0].load(std::memory_order_relaxed) == '\0') {
+      break;
+    }
+    s.sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.name[0].store('\0', std::memory_order_relaxed);
+    s.sequence.fetch_add(1, std::memory_order_release);
+  }
+  status_->held_items.store(held_items_, std::memory_order_relaxed);
+  status_->num_workers.store(static_cast<uint32_t>(workers_.size()),
+                             std::memory_order_relaxed);
+  status_->updated_ns.store(status_time_ns(now), std::memory_order_release);
+}
 
-  auto new_item = std::make_shared<Item>(&completed_items_, id, payload);
+// Handle incoming messages (work items) from the generator
+void ItemDistributor::on_generator_pollin() {
+  // Receive all available work items, so that the items for each worker can
+  // be sent in a single batch
+  for (size_t n = 0; n < distributor_max_batch_items; ++n) {
+    zmq::multipart_t message;
+    if (!message.recv(generator_socket_, ZMQ_DONTWAIT)) {
+      break;
+    }
 
-  // Distribute the new work item
-  for (auto& [identity, worker] : workers_) {
-    try {
-      if (worker->wants(new_item->id())) {
-        if (worker->queue_policy() == WorkerQueuePolicy::PrebufferOne) {
-          worker->clear_queue();
-        }
-        if (worker->is_idle()) {
-          // The worker is idle, send the item immediately
-          worker->add_outstanding(new_item);
-          send_worker_work_item(identity, *new_item);
-        } else {
-          // The worker is busy, enqueue the item
-          if (worker->queue_policy() != WorkerQueuePolicy::Skip) {
-            worker->push_queue(new_item);
-          }
-        }
-      }
-    } catch (std::exception& e) {
-      L_(error) << e.what();
-      workers_.erase(identity);
+    // Receive item ID
+    ItemID id = std::stoull(message.popstr());
+
+    // Receive optional item payload
+    std::string payload;
+    if (!message.empty()) {
+      payload = message.popstr();
     }
+
+    ++held_items_;
+    distribute_item(std::make_shared<Item>(&completed_items_, id, payload));
   }
-  new_item = nullptr;
-  // A pending completion could occur here if this item is not sent to any
+  flush_work_items();
+  // A pending completion could occur here if an item is not sent to any
   // worker, so...
   send_pending_completions();
 }
 
+void ItemDistributor::distribute_item(const std::shared_ptr<Item>& item) {
+  tracing::Scope trace_scope("distribute_item", item->id());
+  FLES_PROBE(item_arrive, item->id());
+  // Distribute the new work item to the matching workers of each stride
+  for (auto& [stride, offsets] : worker_classes_) {
+    auto match = offsets.find(item->id() % stride);
+    if (match == offsets.end()) {
+      continue;
+    }
+    for (auto& [name, group] : match->second.groups) {
+      if (drops(group_priority(group))) {
+        group.queue.clear();
+        continue;
+      }
+      group.queue.push_back(item);
+      dispatch_group(group);
+    }
+    for (const auto& identity : match->second.workers) {
+      auto& worker = workers_.at(identity);
+      if (drops(worker->priority())) {
+        // Release the buffer for the workers of the highest priority
+        worker->clear_queue();
+        continue;
+      }
+      if (worker->queue_policy() == WorkerQueuePolicy::PrebufferOne) {
+        worker->clear_queue();
+      }
+      if (worker->accepts_item()) {
+        // The worker is idle, send the item immediately
+        assign_item(identity, *worker, item);
+      } else {
+        // The worker is busy, enqueue the item
+        if (worker->queue_policy() != WorkerQueuePolicy::Skip) {
+          worker->push_queue(item);
+        }
+      }
+    }
+  }
+}
+
 // Handle incoming message from a worker
 void ItemDistributor::on_worker_pollin() {
   zmq::multipart_t message(worker_socket_);
@@ -62,7 +148,7 @@ void ItemDistributor::on_worker_pollin() {
       L_(info) << "worker disconnected: "
                << workers_.at(identity)->description();
     }
-    if (workers_.erase(identity) == 0) {
+    if (!remove_worker(identity)) {
       // This could happen if a misbehaving worker did not send a REGISTER
       // message
       L_(error) << "disconnect from unknown worker";
@@ -72,12 +158,41 @@ void ItemDistributor::on_worker_pollin() {
       // Handle general message from a worker
       std::string message_string = message.peekstr(2);
       if (message_string.rfind("REGISTER ", 0) == 0) {
-        // Handle new worker registration
-        auto worker = std::make_unique<ItemDistributorWorker>(message_string);
-        workers_[identity] = std::move(worker);
+        // Handle new worker registration, accept the offered options
+        bool batch = false;
+        size_t prefetch = 0;
+        unsigned priority = 0;
+        std::string channel_name;
+        for (size_t i = 3; i < message.size(); ++i) {
+          std::string option = message.peekstr(i);
+          if (option == "BATCH") {
+            batch = true;
+          } else if (option.rfind("PREFETCH ", 0) == 0) {
+            prefetch = std::stoull(option.substr(9));
+          } else if (option.rfind("SHM ", 0) == 0) {
+            channel_name = option.substr(4);
+          } else if (option.rfind("PRIORITY ", 0) == 0) {
+            priority = std::stoul(option.substr(9));
+          } else {
+            throw std::invalid_argument("Unknown register option: " + option);
+          }
+        }
+        auto worker = std::make_unique<ItemDistributorWorker>(
+            message_string, batch, prefetch, priority);
+        if (!channel_name.empty()) {
+          // A worker on another host falls back to messages
+          try {
+            worker->set_channel(std::make_unique<ShmItemChannel>(channel_name));
+            worker->channel()->accept();
+          } catch (std::exception& e) {
+            L_(warning) << "cannot open worker channel: " << e.what();
+          }
+        }
+        add_worker(identity, std::move(worker));
         L_(info) << "worker connected: "
                  << workers_.at(identity)->description();
-      } else if (message_string.rfind("COMPLETE ", 0) == 0) {
+      } else if (message_string.rfind("COMPLETE ", 0) == 0 ||
+                 message_string.rfind("COMPLETIONS ", 0) == 0) {
         // Handle worker completion message
         auto& worker = workers_.at(identity);
         std::string command;
@@ -87,18 +202,25 @@ void ItemDistributor::on_worker_pollin() {
         if (s.fail()) {
           throw std::invalid_argument("Invalid completion message");
         }
-        // Find the corresponding outstanding item object and delete it
-        worker->delete_outstanding(id);
-        // Send next item if available
-        if (!worker->queue_empty()) {
-          auto item = worker->pop_queue();
-          worker->add_outstanding(item);
-          send_worker_work_item(identity, *item);
-        } else {
-          worker->reset_heartbeat_time();
+        std::vector<ItemID> ids;
+        do {
+          ids.push_back(id);
+        } while (s >> id);
+        if (!s.eof()) {
+          throw std::invalid_argument("Invalid completion message");
+        }
+        if (message.size() > 3) {
+          record_usage(*worker, WorkerUsage::parse(message.peekstr(3)));
         }
-      } else if (message_string.rfind("HEARTBEAT", 0) == 0) {
-        // Ignore heartbeat reply
+        complete_items(identity, *worker, ids);
+      } else if (message_string.rfind("USAGE ", 0) == 0) {
+        // Handle usage report of a worker without pending completions
+        record_usage(*workers_.at(identity),
+                     WorkerUsage::parse(message_string));
+      } else if (message_string.rfind("HEARTBEAT", 0) == 0 ||
+                 message_string.rfind("WAKE", 0) == 0) {
+        // Ignore heartbeat reply, completions in the channel are handled
+        // after polling
       } else {
         throw std::invalid_argument("Unknown message type: " + message_string);
       }
@@ -109,8 +231,289 @@ void ItemDistributor::on_worker_pollin() {
         send_worker_disconnect(identity);
       } catch (std::exception&) {
       };
-      workers_.erase(identity);
+      remove_worker(identity);
     }
   }
+  flush_work_items();
   send_pending_completions();
 }
+
+void ItemDistributor::complete_items(const std::string& identity,
+                                     ItemDistributorWorker& worker,
+                                     const std::vector<ItemID>& ids) {
+  // Find the corresponding outstanding item objects and delete them
+  for (ItemID id : ids) {
+    FLES_PROBE(item_complete, id);
+    worker.delete_outstanding(id);
+  }
+  // Send next items if available
+  refill_worker(identity, worker);
+  if (worker.is_idle()) {
+    worker.reset_heartbeat_time();
+  }
+}
+
+bool ItemDistributor::prepare_channel_wait() {
+  for (const auto& identity : channel_workers_) {
+    if (!workers_.at(identity)->channel()->prepare_distributor_wait()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ItemDistributor::poll_channels() {
+  if (channel_workers_.empty()) {
+    return;
+  }
+  std::vector<std::string> failed;
+  for (const auto& identity : channel_workers_) {
+    auto& worker = workers_.at(identity);
+    ShmItemChannel& channel = *worker->channel();
+    channel.end_distributor_wait();
+    std::vector<ItemID> ids;
+    ItemID id{};
+    while (channel.pop_completion(id)) {
+      ids.push_back(id);
+    }
+    if (ids.empty()) {
+      continue;
+    }
+    try {
+      complete_items(identity, *worker, ids);
+    } catch (std::exception& e) {
+      L_(error) << e.what();
+      L_(error) << "protocol violation, disconnecting worker";
+      failed.push_back(identity);
+    }
+  }
+  for (const auto& identity : failed) {
+    try {
+      send_worker_disconnect(identity);
+    } catch (std::exception&) {
+    };
+    remove_worker(identity);
+  }
+  flush_work_items();
+  send_pending_completions();
+}
+
+void ItemDistributor::send_channel_items(
+    const std::string& identity,
+    ItemDistributorWorker& worker,
+    const std::vector<std::shared_ptr<Item>>& items) {
+  ShmItemChannel& channel = *worker.channel();
+  for (const auto& item : items) {
+    if (!channel.push_item(item->id(), item->payload())) {
+      send_worker_work_item(identity, *item);
+    }
+  }
+  if (channel.wake_worker()) {
+    send_worker_wake(identity);
+  }
+}
+
+void ItemDistributor::assign_item(const std::string& identity,
+                                  ItemDistributorWorker& worker,
+                                  const std::shared_ptr<Item>& item) {
+  if (dispatch_observer_) {
+    dispatch_observer_(std::chrono::steady_clock::now() - item->arrival());
+  }
+  worker.add_outstanding(item);
+  FLES_PROBE(item_dispatch, item->id(), worker.num_outstanding());
+  if (worker.outbox_empty()) {
+    pending_sends_.push_back(identity);
+  }
+  worker.push_outbox(item);
+}
+
+void ItemDistributor::refill_worker(const std::string& identity,
+                                    ItemDistributorWorker& worker) {
+  if (worker.queue_policy() == WorkerQueuePolicy::Balanced) {
+    if (auto* group = find_group(worker)) {
+      dispatch_group(*group);
+    }
+    return;
+  }
+  while (!worker.queue_empty() && worker.accepts_item()) {
+    assign_item(identity, worker, worker.pop_queue());
+  }
+}
+
+void ItemDistributor::flush_work_items() {
+  if (pending_sends_.empty()) {
+    return;
+  }
+  tracing::Scope trace_scope("flush_work_items", pending_sends_.size());
+  while (!pending_sends_.empty()) {
+    std::vector<std::string> pending;
+    pending.swap(pending_sends_);
+    if (top_priority_ != 0) {
+      // Send to the workers of higher priority first
+      std::stable_sort(pending.begin(), pending.end(),
+                       [this](const std::string& a, const std::string& b) {
+                         return priority_of(a) > priority_of(b);
+                       });
+    }
+    for (const auto& identity : pending) {
+      auto it = workers_.find(identity);
+      if (it == workers_.end()) {
+        continue;
+      }
+      auto& worker = it->second;
+      auto items = worker->take_outbox();
+      if (items.empty()) {
+        continue;
+      }
+      try {
+        if (worker->channel() != nullptr) {
+          send_channel_items(identity, *worker, items);
+        } else if (worker->batch()) {
+          send_worker_work_items(identity, items);
+        } else {
+          for (const auto& item : items) {
+            send_worker_work_item(identity, *item);
+          }
+        }
+      } catch (std::exception& e) {
+        L_(error) << e.what();
+        // Keep the items of a Balanced worker for the remaining members; the
+        // group is dispatched again, which may add to pending_sends_
+        WorkerGroup* group = find_group(*worker);
+        if (group == nullptr) {
+          remove_worker(identity);
+          continue;
+        }
+        group->queue.insert(group->queue.begin(), items.begin(), items.end());
+        size_t stride = worker->stride();
+        size_t offset = worker->offset();
+        std::string name = worker->group();
+        remove_worker(identity);
+        group = find_group(stride, offset, name);
+        if (group != nullptr) {
+          dispatch_group(*group);
+        }
+      }
+    }
+  }
+}
+
+void ItemDistributor::add_worker(
+    const std::string& identity,
+    std::unique_ptr<ItemDistributorWorker> worker) {
+  remove_worker(identity);
+  auto& worker_class = worker_classes_[worker->stride()][worker->offset()];
+  if (worker->queue_policy() == WorkerQueuePolicy::Balanced) {
+    auto& group = worker_class.groups[worker->group()];
+    group.members.insert(identity);
+    workers_[identity] = std::move(worker);
+    // The new member may take over items already waiting in the group
+    dispatch_group(group);
+  } else {
+    worker_class.workers.insert(identity);
+    workers_[identity] = std::move(worker);
+  }
+  if (workers_.at(identity)->channel() != nullptr) {
+    channel_workers_.insert(identity);
+  }
+  update_top_priority();
+}
+
+bool ItemDistributor::remove_worker(const std::string& identity) {
+  auto it = workers_.find(identity);
+  if (it == workers_.end()) {
+    return false;
+  }
+
+  auto stride_it = worker_classes_.find(it->second->stride());
+  assert(stride_it != worker_classes_.end());
+  auto& offsets = stride_it->second;
+  auto offset_it = offsets.find(it->second->offset());
+  assert(offset_it != offsets.end());
+  auto& worker_class = offset_it->second;
+  if (it->second->queue_policy() == WorkerQueuePolicy::Balanced) {
+    auto group_it = worker_class.groups.find(it->second->group());
+    assert(group_it != worker_class.groups.end());
+    group_it->second.members.erase(identity);
+    if (group_it->second.members.empty()) {
+      // Release the items still waiting in the group queue
+      worker_class.groups.erase(group_it);
+    }
+  } else {
+    worker_class.workers.erase(identity);
+  }
+  if (worker_class.empty()) {
+    offsets.erase(offset_it);
+    if (offsets.empty()) {
+      worker_classes_.erase(stride_it);
+    }
+  }
+
+  channel_workers_.erase(identity);
+  workers_.erase(it);
+  update_top_priority();
+  return true;
+}
+
+unsigned ItemDistributor::group_priority(const WorkerGroup& group) const {
+  unsigned priority = 0;
+  for (const auto& identity : group.members) {
+    priority = std::max(priority, workers_.at(identity)->priority());
+  }
+  return priority;
+}
+
+void ItemDistributor::update_top_priority() {
+  top_priority_ = 0;
+  for (const auto& [identity, worker] : workers_) {
+    top_priority_ = std::max(top_priority_, worker->priority());
+  }
+}
+
+ItemDistributor::WorkerGroup*
+ItemDistributor::find_group(const ItemDistributorWorker& worker) {
+  if (worker.queue_policy() != WorkerQueuePolicy::Balanced) {
+    return nullptr;
+  }
+  return find_group(worker.stride(), worker.offset(), worker.group());
+}
+
+ItemDistributor::WorkerGroup* ItemDistributor::find_group(
+    size_t stride, size_t offset, const std::string& name) {
+  auto stride_it = worker_classes_.find(stride);
+  if (stride_it == worker_classes_.end()) {
+    return nullptr;
+  }
+  auto offset_it = stride_it->second.find(offset);
+  if (offset_it == stride_it->second.end()) {
+    return nullptr;
+  }
+  auto group_it = offset_it->second.groups.find(name);
+  if (group_it == offset_it->second.groups.end()) {
+    return nullptr;
+  }
+  return &group_it->second;
+}
+
+void ItemDistributor::dispatch_group(WorkerGroup& group) {
+  while (!group.queue.empty()) {
+    // Find the least loaded member with a free prefetch slot
+    const std::string* target = nullptr;
+    size_t target_outstanding = 0;
+    for (const auto& identity : group.members) {
+      const auto& worker = workers_.at(identity);
+      size_t outstanding = worker->num_outstanding();
+      if (outstanding < worker->prefetch() &&
+          (target == nullptr || outstanding < target_outstanding)) {
+        target = &identity;
+        target_outstanding = outstanding;
+      }
+    }
+    if (target == nullptr) {
+      return;
+    }
+
+    assign_item(*target, *workers_.at(*target), group.queue.front());
+    group.queue.pop_front();
+  }
+}
@@ -1,18 +1,24 @@
 #ifndef SHM_IPC_ITEMDISTRIBUTOR_HPP
 #define SHM_IPC_ITEMDISTRIBUTOR_HPP
 
+#include "DistributorStatus.hpp"
 #include "ItemDistributorWorker.hpp"
 #include "ItemWorkerProtocol.hpp"
 #include "log.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <exception>
+#include <functional>
 #include <map>
 #include <memory>
-#include <queue>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <zmq.hpp>
 #include <zmq_addon.hpp>
@@ -23,6 +29,19 @@
  */
 class ItemDistributor {
 public:
+  /// The numbers of items in the distributor.
+  struct Load {
+    /// Items received and not yet completed by all workers
+    size_t held_items = 0;
+    /// Items queued for busy workers (including group queues)
+    size_t waiting_items = 0;
+    /// Items sent to workers and not yet completed
+    size_t outstanding_items = 0;
+    /// Mean busy fraction of the workers reporting their usage (0..1,
+    /// negative if none does, see WorkerUsage)
+    double utilization = -1;
+  };
+
   ItemDistributor(zmq::context_t& context,
                   const std::string& producer_address,
                   const std::string& worker_address)
@@ -50,21 +69,82 @@ public:
                [&](zmq::event_flags /*e*/) { on_worker_pollin(); });
 
     while (!stopped_) {
-      poller.wait(distributor_poll_timeout);
+      // Workers with a channel send a wakeup if needed
+      poller.wait(prepare_channel_wait() ? distributor_poll_timeout
+                                         : std::chrono::milliseconds(0));
+      poll_channels();
       send_heartbeats();
+      publish_load();
+      if (status_ != nullptr) {
+        publish_status();
+      }
     }
   }
 
   void stop() { stopped_ = true; }
 
+  /// Set the number of held items from which only the workers of the
+  /// highest priority class receive new items (0: no limit).
+  void set_priority_limit(size_t held_items) { priority_limit_ = held_items; }
+
+  /// Set a function called (in the distributor thread) with the time an
+  /// item has waited from its arrival until its assignment to a worker.
+  void set_dispatch_observer(
+      std::function<void(std::chrono::steady_clock::duration)> observer) {
+    dispatch_observer_ = std::move(observer);
+  }
+
+  /// Set a function called (in the distributor thread) with each time
+  /// usage report of a worker, identified by its client name.
+  void set_usage_observer(
+      std::function<void(const std::string&, const WorkerUsage&)> observer) {
+    usage_observer_ = std::move(observer);
+  }
+
+  /// Publish the status of the workers to the given structure (e.g., in
+  /// shared memory) at the given interval. The structure is only written
+  /// by the distributor thread and never read by it.
+  void set_status(DistributorStatus* status,
+                  std::chrono::milliseconds interval) {
+    status_ = status;
+    status_interval_ = interval;
+  }
+
+  /// Retrieve the current load (may be called from any thread).
+  [[nodiscard]] Load load() const {
+    return {published_held_.load(std::memory_order_relaxed),
+            published_waiting_.load(std::memory_order_relaxed),
+            published_outstanding_.load(std::memory_order_relaxed),
+            published_utilization_.load(std::memory_order_relaxed)};
+  }
+
   // TODO(cuveland): sensible clean-up
   ~ItemDistributor() = default;
 
 private:
+  // A group of Balanced workers sharing a common item queue
+  struct WorkerGroup {
+    std::set<std::string> members;
+    std::deque<std::shared_ptr<Item>> queue;
+  };
+
+  // The registered workers of one (stride, offset) class
+  struct WorkerClass {
+    // Workers with an individual item queue
+    std::set<std::string> workers;
+    // Groups of Balanced workers by group name
+    std::map<std::string, WorkerGroup> groups;
+
+    [[nodiscard]] bool empty() const {
+      return workers.empty() && groups.empty();
+    }
+  };
+
   // Send heartbeat messages to workers that have been idle for a while
   void send_heartbeats() {
     std::chrono::system_clock::time_point now =
         std::chrono::system_clock::now();
+    std::vector<std::string> failed;
     for (auto& [identity, worker] : workers_) {
       try {
         if (worker->wants_heartbeat(now)) {
@@ -73,25 +153,145 @@ private:
         }
       } catch (std::exception& e) {
         L_(error) << e.what();
-        workers_.erase(identity);
+        failed.push_back(identity);
       }
     }
+    for (const auto& identity : failed) {
+      remove_worker(identity);
+    }
   }
 
+  // Update the load retrieved by load()
+  void publish_load() {
+    size_t waiting = 0;
+    size_t outstanding = 0;
+    double utilization = 0;
+    size_t reporting = 0;
+    for (const auto& [identity, worker] : workers_) {
+      waiting += worker->queue_size();
+      outstanding += worker->num_outstanding();
+      if (worker->usage()) {
+        utilization += worker->usage()->utilization();
+        ++reporting;
+      }
+    }
+    for (const auto& [stride, offsets] : worker_classes_) {
+      for (const auto& [offset, worker_class] : offsets) {
+        for (const auto& [name, group] : worker_class.groups) {
+          waiting += group.queue.size();
+        }
+      }
+    }
+    published_held_.store(held_items_, std::memory_order_relaxed);
+    published_waiting_.store(waiting, std::memory_order_relaxed);
+    published_outstanding_.store(outstanding, std::memory_order_relaxed);
+    published_utilization_.store(
+        reporting != 0 ? utilization / static_cast<double>(reporting) : -1,
+        std::memory_order_relaxed);
+  }
+
+  // Record a time usage report of a worker
+  void record_usage(ItemDistributorWorker& worker, const WorkerUsage& usage) {
+    worker.set_usage(usage);
+    if (usage_observer_) {
+      usage_observer_(worker.client_name(), usage);
+    }
+  }
+
+  // Update the status set by set_status() if the interval has passed
+  void publish_status();
+
+  // Send all pending completions to the generator as a single message of
+  // space-separated item IDs
   void send_pending_completions() {
-    while (!completed_items_.empty()) {
-      auto item = completed_items_.front();
-      generator_socket_.send(zmq::buffer(std::to_string(item)));
-      completed_items_.pop();
+    auto completed = completed_items_.take();
+    if (completed.empty()) {
+      return;
     }
+    held_items_ -= completed.size();
+    std::string ids = std::to_string(completed.front());
+    for (size_t i = 1; i < completed.size(); ++i) {
+      ids += " " + std::to_string(completed[i]);
+    }
+    generator_socket_.send(zmq::buffer(ids));
   }
 
-  // Handle incoming message (work item) from the generator
+  // Handle incoming messages (work items) from the generator
   void on_generator_pollin();
 
+  // Pass a new work item to all workers that want it
+  void distribute_item(const std::shared_ptr<Item>& item);
+
+  // Check whether a worker or group of a given priority is to receive no
+  // new items because the held items have reached the priority limit
+  [[nodiscard]] bool drops(unsigned priority) const {
+    return priority < top_priority_ && priority_limit_ != 0 &&
+           held_items_ >= priority_limit_;
+  }
+
+  // The priority of a worker (0 if it is no longer registered)
+  [[nodiscard]] unsigned priority_of(const std::string& identity) const {
+    auto it = workers_.find(identity);
+    return it != workers_.end() ? it->second->priority() : 0;
+  }
+
+  // The highest priority of the members of a group
+  [[nodiscard]] unsigned group_priority(const WorkerGroup& group) const;
+
+  // Determine the highest priority of all registered workers
+  void update_top_priority();
+
+  // Assign an item to a worker, to be sent by flush_work_items()
+  void assign_item(const std::string& identity,
+                   ItemDistributorWorker& worker,
+                   const std::shared_ptr<Item>& item);
+
+  // Assign queued items to a worker after completions
+  void refill_worker(const std::string& identity,
+                     ItemDistributorWorker& worker);
+
+  // Send the items assigned to workers since the last call, one WORK_ITEMS
+  // message per batching worker
+  void flush_work_items();
+
   // Handle incoming message from a worker
   void on_worker_pollin();
 
+  // Delete the completed items of a worker and send the next items
+  void complete_items(const std::string& identity,
+                      ItemDistributorWorker& worker,
+                      const std::vector<ItemID>& ids);
+
+  // Announce a blocking distributor in the channels of all workers, returns
+  // false if completions have arrived in the meantime
+  bool prepare_channel_wait();
+
+  // Handle the completions written to the channels of the workers
+  void poll_channels();
+
+  // Write items to the channel of a worker, sending those that do not fit
+  // as messages
+  void send_channel_items(const std::string& identity,
+                          ItemDistributorWorker& worker,
+                          const std::vector<std::shared_ptr<Item>>& items);
+
+  // Register a worker, replacing any previous worker with the same identity
+  void add_worker(const std::string& identity,
+                  std::unique_ptr<ItemDistributorWorker> worker);
+
+  // Unregister a worker, returns false if the identity is unknown
+  bool remove_worker(const std::string& identity);
+
+  // Return the group of a Balanced worker, or nullptr if it does not exist
+  WorkerGroup* find_group(const ItemDistributorWorker& worker);
+  WorkerGroup* find_group(size_t stride,
+                          size_t offset,
+                          const std::string& name);
+
+  // Assign queued items of a group to the members with free prefetch slots,
+  // the least loaded member first
+  void dispatch_group(WorkerGroup& group);
+
   void send_worker(const std::string& identity, zmq::multipart_t&& message) {
     assert(!identity.empty());
     // Prepare first two message parts as required for a ROUTER socket
@@ -112,11 +312,29 @@ private:
     send_worker(identity, std::move(message));
   }
 
+  void send_worker_work_items(const std::string& identity,
+                              const std::vector<std::shared_ptr<Item>>& items) {
+    std::string header = "WORK_ITEMS";
+    for (const auto& item : items) {
+      header += " " + std::to_string(item->id());
+    }
+    zmq::multipart_t message(header);
+    for (const auto& item : items) {
+      message.addstr(item->payload());
+    }
+    send_worker(identity, std::move(message));
+  }
+
   void send_worker_heartbeat(const std::string& identity) {
     zmq::multipart_t message("HEARTBEAT");
     send_worker(identity, std::move(message));
   }
 
+  void send_worker_wake(const std::string& identity) {
+    zmq::multipart_t message("WAKE");
+    send_worker(identity, std::move(message));
+  }
+
   void send_worker_disconnect(const std::string& identity) {
     zmq::multipart_t message("DISCONNECT");
     send_worker(identity, std::move(message));
@@ -124,8 +342,29 @@ private:
 
   zmq::socket_t generator_socket_;
   zmq::socket_t worker_socket_;
-  std::queue<ItemID> completed_items_;
-  std::map<std::string, std::unique_ptr<ItemDistributorWorker>> workers_;
+  CompletionQueue completed_items_;
+  std::unordered_map<std::string, std::unique_ptr<ItemDistributorWorker>>
+      workers_;
+  // Identities of the registered workers by stride and offset, so that a
+  // new item only visits the workers that want it
+  std::map<size_t, std::unordered_map<size_t, WorkerClass>> worker_classes_;
+  // Identities of the workers with assigned but unsent items
+  std::vector<std::string> pending_sends_;
+  // Identities of the workers with a shared memory channel
+  std::set<std::string> channel_workers_;
+  // Number of items received from the generator and not yet completed
+  size_t held_items_ = 0;
+  size_t priority_limit_ = 0;
+  std::function<void(std::chrono::steady_clock::duration)> dispatch_observer_;
+  std::function<void(const std::string&, const WorkerUsage&)> usage_observer_;
+  unsigned top_priority_ = 0;
+  std::atomic<size_t> published_held_{0};
+  std::atomic<size_t> published_waiting_{0};
+  std::atomic<size_t> published_outstanding_{0};
+  std::atomic<double> published_utilization_{-1};
+  DistributorStatus* status_ = nullptr;
+  std::chrono::milliseconds status_interval_{};
+  std::chrono::steady_clock::time_point status_time_;
   bool stopped_ = false;
 };
 
@@ -2,15 +2,27 @@
 #define SHM_IPC_ITEMDISTRIBUTORWORKER_HPP
 
 #include "ItemWorkerProtocol.hpp"
+#include "ShmItemChannel.hpp"
 
-#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 class ItemDistributorWorker {
 public:
-  explicit ItemDistributorWorker(const std::string& message) {
+  explicit ItemDistributorWorker(const std::string& message,
+                                 bool batch = false,
+                                 size_t prefetch = 0,
+                                 unsigned priority = 0)
+      : batch_(batch), priority_(priority) {
     initialize_from_string(message);
+    if (prefetch > 0 && queue_policy_ == WorkerQueuePolicy::QueueAll) {
+      prefetch_ = prefetch;
+    }
   }
 
   // ItemDistributorWorker is non-copyable
@@ -22,10 +34,31 @@ public:
 
   [[nodiscard]] bool wants(ItemID id) const { return id % stride_ == offset_; }
 
+  [[nodiscard]] size_t stride() const { return stride_; }
+
+  [[nodiscard]] size_t offset() const { return offset_; }
+
   [[nodiscard]] WorkerQueuePolicy queue_policy() const { return queue_policy_; }
 
+  [[nodiscard]] const std::string& group() const { return group_; }
+
+  [[nodiscard]] size_t prefetch() const { return prefetch_; }
+
+  [[nodiscard]] bool batch() const { return batch_; }
+
+  [[nodiscard]] unsigned priority() const { return priority_; }
+
+  // The shared memory channel of a same-host worker (or nullptr)
+  [[nodiscard]] ShmItemChannel* channel() const { return channel_.get(); }
+
+  void set_channel(std::unique_ptr<ShmItemChannel> channel) {
+    channel_ = std::move(channel);
+  }
+
   [[nodiscard]] bool queue_empty() const { return waiting_items_.empty(); }
 
+  [[nodiscard]] size_t queue_size() const { return waiting_items_.size(); }
+
   void clear_queue() { waiting_items_.clear(); }
 
   void push_queue(const std::shared_ptr<Item>& item) {
@@ -43,19 +76,58 @@ public:
 
   [[nodiscard]] bool is_idle() const { return outstanding_items_.empty(); }
 
+  [[nodiscard]] size_t num_outstanding() const {
+    return outstanding_items_.size();
+  }
+
+  // The arrival time of the oldest outstanding item (max() if none)
+  [[nodiscard]] std::chrono::steady_clock::time_point
+  oldest_outstanding_arrival() const {
+    auto oldest = std::chrono::steady_clock::time_point::max();
+    for (const auto& [id, item] : outstanding_items_) {
+      oldest = std::min(oldest, item->arrival());
+    }
+    return oldest;
+  }
+
+  // Check if an item can be sent now instead of being queued. A QueueAll
+  // worker takes up to "prefetch" outstanding items, a batching one further
+  // items into the batch that is assembled.
+  [[nodiscard]] bool accepts_item() const {
+    if (is_idle()) {
+      return true;
+    }
+    if (queue_policy_ != WorkerQueuePolicy::QueueAll) {
+      return false;
+    }
+    return num_outstanding() < prefetch_ ||
+           (batch_ && !outbox_.empty() &&
+            outbox_.size() < distributor_max_batch_items);
+  }
+
+  // Add an item to the items to be sent
+  void push_outbox(const std::shared_ptr<Item>& item) {
+    outbox_.push_back(item);
+  }
+
+  [[nodiscard]] bool outbox_empty() const { return outbox_.empty(); }
+
+  // Retrieve and clear the items to be sent
+  std::vector<std::shared_ptr<Item>> take_outbox() {
+    std::vector<std::shared_ptr<Item>> items;
+    items.swap(outbox_);
+    return items;
+  }
+
   void add_outstanding(const std::shared_ptr<Item>& item) {
-    outstanding_items_.push_back(item);
+    outstanding_items_.emplace(item->id(), item);
   }
 
   // Find an outstanding item object and delete it
   void delete_outstanding(ItemID id) {
-    auto it = std::find_if(
-        std::begin(outstanding_items_), std::end(outstanding_items_),
-        [id](const std::shared_ptr<Item>& i) { return i->id() == id; });
-    if (it == std::end(outstanding_items_)) {
+    if (outstanding_items_.erase(id) == 0) {
       throw std::invalid_argument("Invalid work completion");
     }
-    outstanding_items_.erase(it);
   }
 
   void reset_heartbeat_time() {
@@ -68,11 +140,33 @@ public:
             last_heartbeat_time_ + distributor_heartbeat_interval < when);
   }
 
+  // The latest time usage reported by the worker (if any)
+  [[nodiscard]] const std::optional<WorkerUsage>& usage() const {
+    return usage_;
+  }
+
+  void set_usage(const WorkerUsage& usage) { usage_ = usage; }
+
   [[nodiscard]] const std::string& client_name() const { return client_name_; }
 
   [[nodiscard]] std::string description() const {
-    return client_name_ + " (s" + std::to_string(stride_) + "/o" +
-           std::to_string(offset_) + "/p" + to_string(queue_policy_) + ")";
+    std::string d = client_name_ + " (s" + std::to_string(stride_) + "/o" +
+                    std::to_string(offset_) + "/p" + to_string(queue_policy_);
+    if (queue_policy_ == WorkerQueuePolicy::Balanced) {
+      d += "/g" + group_ + "/n" + std::to_string(prefetch_);
+    } else if (prefetch_ > 1) {
+      d += "/n" + std::to_string(prefetch_);
+    }
+    if (batch_) {
+      d += "/b";
+    }
+    if (channel_) {
+      d += "/shm";
+    }
+    if (priority_ != 0) {
+      d += "/r" + std::to_string(priority_);
+    }
+    return d + ")";
   }
 
 private:
@@ -80,10 +174,15 @@ private:
     std::string command;
     std::stringstream s(message);
     // Read space-separated string into separate variables
-    s >> command >> stride_ >> offset_ >> queue_policy_ >> client_name_;
+    s >> command >> stride_ >> offset_ >> queue_policy_;
+    if (queue_policy_ == WorkerQueuePolicy::Balanced) {
+      s >> prefetch_ >> group_;
+    }
+    s >> client_name_;
     // Read remainder of string and add contents to client_name_
     client_name_ += std::string(std::istreambuf_iterator<char>(s), {});
-    if (s.fail()) {
+    if (s.fail() || stride_ == 0 || prefetch_ == 0 ||
+        queue_policy_ > WorkerQueuePolicy::Balanced) {
       throw std::invalid_argument("Invalid register message: " + message);
     }
   }
@@ -92,9 +191,16 @@ private:
   size_t offset_{};
   WorkerQueuePolicy queue_policy_{};
   std::string client_name_;
+  std::string group_;
+  size_t prefetch_ = 1;
+  bool batch_ = false;
+  unsigned priority_ = 0;
+  std::unique_ptr<ShmItemChannel> channel_;
+  std::optional<WorkerUsage> usage_;
 
   std::deque<std::shared_ptr<Item>> waiting_items_;
-  std::deque<std::shared_ptr<Item>> outstanding_items_;
+  std::unordered_map<ItemID, std::shared_ptr<Item>> outstanding_items_;
+  std::vector<std::shared_ptr<Item>> outbox_;
   std::chrono::system_clock::time_point last_heartbeat_time_ =
       std::chrono::system_clock::now();
 };
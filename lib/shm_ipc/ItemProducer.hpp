@@ -1,7 +1,9 @@
 #ifndef SHM_IPC_ITEMPRODUCER_HPP
 #define SHM_IPC_ITEMPRODUCER_HPP
 
+#include <queue>
 #include <set>
+#include <sstream>
 
 #include <zmq.hpp>
 
@@ -26,6 +28,17 @@ public:
   }
 
   bool try_receive_completion(ItemID* id) {
+    if (received_completions_.empty() && !receive_completions()) {
+      return false;
+    }
+    *id = received_completions_.front();
+    received_completions_.pop();
+    return true;
+  }
+
+private:
+  // Receive a completion message, which may contain several item IDs
+  bool receive_completions() {
     zmq::message_t message;
     try {
       const auto result =
@@ -40,12 +53,16 @@ public:
         throw;
       }
     }
-    *id = std::stoull(message.to_string());
-    return true;
+    std::stringstream s(message.to_string());
+    ItemID id;
+    while (s >> id) {
+      received_completions_.push(id);
+    }
+    return !received_completions_.empty();
   }
 
-private:
   zmq::socket_t distributor_socket_;
+  std::queue<ItemID> received_completions_;
 };
 
 #endif
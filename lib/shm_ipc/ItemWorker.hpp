@@ -2,16 +2,20 @@
 #define SHM_IPC_ITEMWORKER_HPP
 
 #include "ItemWorkerProtocol.hpp"
+#include "ShmItemChannel.hpp"
 #include "log.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
-#include <queue>
+#include <deque>
 #include <set>
 #include <stdexcept>
 #include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 #include <zmq.hpp>
 
 class ItemWorker {
@@ -25,6 +29,17 @@ public:
       throw std::invalid_argument(
           "WorkerParameters.client_name cannot be empty");
     }
+    if (parameters_.queue_policy == WorkerQueuePolicy::Balanced &&
+        (parameters_.group.empty() ||
+         parameters_.group.find_first_of(" \t\n") != std::string::npos ||
+         parameters_.prefetch == 0)) {
+      throw std::invalid_argument("WorkerParameters.group must be a single "
+                                  "word and prefetch cannot be zero");
+    }
+    // More than one outstanding item or a wakeup by the distributor
+    // requires an asynchronous socket
+    pipelined_ = parameters_.batch || parameters_.shm ||
+                 (prefetches() && parameters_.prefetch > 1);
     connect();
   };
 
@@ -32,8 +47,53 @@ public:
     disconnect_callback_ = callback;
   }
 
+  /// Retrieve the next item, blocking until it is available.
+  /** With usage reports enabled, the blocking time is accounted as idle. */
   std::shared_ptr<const Item> get() {
-    while (!stopped_) {
+    const auto begin = parameters_.usage
+                           ? std::chrono::steady_clock::now()
+                           : std::chrono::steady_clock::time_point{};
+    std::shared_ptr<const Item> item;
+    while (!stopped_ && !item) {
+      item = receive(worker_poll_timeout);
+    }
+    if (parameters_.usage) {
+      const auto now = std::chrono::steady_clock::now();
+      idle_time_ += now - begin;
+      if (item) {
+        item->set_retrieval(now);
+      }
+    }
+    return item;
+  }
+
+  /// Retrieve the next item if already received, without blocking.
+  /** Pending completions are sent in any case. */
+  std::shared_ptr<const Item> try_get() {
+    if (stopped_) {
+      return nullptr;
+    }
+    auto item = receive(std::chrono::milliseconds(0));
+    if (item && parameters_.usage) {
+      item->set_retrieval(std::chrono::steady_clock::now());
+    }
+    return item;
+  }
+
+  [[nodiscard]] WorkerParameters parameters() const { return parameters_; }
+
+  void stop() { stopped_ = true; }
+
+private:
+  // Whether the queue policy allows more than one outstanding item
+  [[nodiscard]] bool prefetches() const {
+    return parameters_.queue_policy == WorkerQueuePolicy::Balanced ||
+           parameters_.queue_policy == WorkerQueuePolicy::QueueAll;
+  }
+
+  // Handle the messages arriving within the timeout until an item is found
+  std::shared_ptr<const Item> receive(std::chrono::milliseconds timeout) {
+    while (true) {
       try {
         if (!distributor_socket_) {
           connect();
@@ -41,15 +101,48 @@ public:
           send_pending_completions();
         }
 
+        // Hand out the items of a previous WORK_ITEMS message first
+        if (!received_items_.empty()) {
+          auto item = received_items_.front();
+          received_items_.pop_front();
+          return item;
+        }
+
+        // Items written to the shared memory channel
+        if (channel_) {
+          ItemID id{};
+          std::string payload;
+          if (channel_->pop_item(id, payload)) {
+            reset_heartbeat_time();
+            return std::make_shared<Item>(&completed_items_, id,
+                                          std::move(payload));
+          }
+        }
+
+        // A blocking worker is woken up when items arrive in the channel
+        const bool waiting = channel_ && timeout.count() > 0;
+        if (waiting && !channel_->prepare_worker_wait()) {
+          continue;
+        }
         zmq::poller_t poller;
         poller.add(*distributor_socket_, zmq::event_flags::pollin);
         std::vector<decltype(poller)::event_type> events(1);
-        size_t num_events = poller.wait_all(events, worker_poll_timeout);
+        size_t num_events = poller.wait_all(events, timeout);
+        if (waiting) {
+          channel_->end_worker_wait();
+        }
 
         if (num_events > 0) {
           // receive message
           zmq::message_t message;
           (void)distributor_socket_->recv(message);
+          if (pipelined_) {
+            // skip the empty delimiter frame
+            if (message.size() != 0 || !message.more()) {
+              throw(WorkerProtocolError("missing delimiter frame"));
+            }
+            (void)distributor_socket_->recv(message);
+          }
           auto message_string = message.to_string();
           reset_heartbeat_time();
 
@@ -69,14 +162,45 @@ public:
             }
             return std::make_shared<Item>(&completed_items_, id, payload);
           }
+          if (is_work_items(message_string)) {
+            // Handle batch of new work items, one payload part per item
+            std::vector<ItemID> ids;
+            std::string command;
+            std::stringstream s(message_string);
+            s >> command;
+            ItemID id{};
+            while (s >> id) {
+              ids.push_back(id);
+            }
+            if (ids.empty() || !s.eof()) {
+              throw(WorkerProtocolError("invalid WORK_ITEMS message"));
+            }
+            for (auto item_id : ids) {
+              if (!message.more()) {
+                throw(WorkerProtocolError("missing WORK_ITEMS payload"));
+              }
+              (void)distributor_socket_->recv(message);
+              received_items_.push_back(std::make_shared<Item>(
+                  &completed_items_, item_id, message.to_string()));
+            }
+            if (message.more()) {
+              throw(WorkerProtocolError("unexpected multipart message"));
+            }
+            batch_active_ = true;
+            auto item = received_items_.front();
+            received_items_.pop_front();
+            return item;
+          }
           if (message.more()) {
             throw(WorkerProtocolError("unexpected multipart message"));
           }
           if (is_heartbeat(message_string)) {
             send_heartbeat();
+          } else if (is_wake(message_string)) {
+            // Items are read from the channel
           } else if (is_disconnect(message_string)) {
-            distributor_socket_ = nullptr;
-            disconnect_callback_();
+            reset_connection();
+            return nullptr;
           } else {
             throw(WorkerProtocolError("invalid message type"));
           }
@@ -84,62 +208,170 @@ public:
           if (heartbeat_is_expired()) {
             throw(WorkerProtocolError("connection heartbeat expired"));
           }
+          return nullptr;
         }
       } catch (WorkerProtocolError& wp_error) {
         L_(error) << "Worker protocol violation: " << wp_error.what();
-        distributor_socket_ = nullptr;
-        disconnect_callback_();
-        std::queue<ItemID>().swap(completed_items_);
+        reset_connection();
+        return nullptr;
       } catch (zmq::error_t& zmq_error) {
         L_(error) << "ZMQ: " << zmq_error.what();
-        distributor_socket_ = nullptr;
-        disconnect_callback_();
-        std::queue<ItemID>().swap(completed_items_);
+        reset_connection();
+        return nullptr;
       }
     }
-    return nullptr;
   }
 
-  [[nodiscard]] WorkerParameters parameters() const { return parameters_; }
-
-  void stop() { stopped_ = true; }
+  // Drop the connection and the items received through it
+  void reset_connection() {
+    distributor_socket_ = nullptr;
+    channel_ = nullptr;
+    disconnect_callback_();
+    received_items_.clear();
+    completed_items_.reset();
+  }
 
-private:
   void connect() {
     assert(!distributor_socket_);
-    distributor_socket_ =
-        std::make_unique<zmq::socket_t>(context_, zmq::socket_type::req);
+    distributor_socket_ = std::make_unique<zmq::socket_t>(
+        context_,
+        pipelined_ ? zmq::socket_type::dealer : zmq::socket_type::req);
     distributor_socket_->connect(distributor_address_);
+    batch_active_ = false;
+    usage_begin_ = std::chrono::steady_clock::now();
+    idle_time_ = {};
+    if (parameters_.shm) {
+      // A new channel per connection, as the items of a previous connection
+      // are discarded
+      static std::atomic<unsigned> channel_count{0};
+      const std::string name = "fles_items_" + std::to_string(::getpid()) +
+                               "_" + std::to_string(channel_count++);
+      try {
+        channel_ = std::make_unique<ShmItemChannel>(
+            name, ShmItemChannel::default_capacity);
+      } catch (std::exception& e) {
+        L_(warning) << "shared memory channel not available: " << e.what();
+        channel_ = nullptr;
+      }
+    }
     send_register();
   }
 
-  void send_register() {
-    const std::string message_str =
-        "REGISTER " + std::to_string(parameters_.stride) + " " +
-        std::to_string(parameters_.offset) + " " +
-        to_string(parameters_.queue_policy) + " " + parameters_.client_name;
-    distributor_socket_->send(zmq::buffer(message_str));
+  void send_message(const std::string& message_str, bool more = false) {
+    if (pipelined_) {
+      // emulate the envelope of a REQ socket
+      distributor_socket_->send(zmq::message_t(), zmq::send_flags::sndmore);
+    }
+    distributor_socket_->send(zmq::buffer(message_str),
+                              more ? zmq::send_flags::sndmore
+                                   : zmq::send_flags::none);
     reset_heartbeat_time();
   }
 
-  void send_heartbeat() {
-    const std::string message_str = "HEARTBEAT";
-    distributor_socket_->send(zmq::buffer(message_str));
-    reset_heartbeat_time();
+  void send_register() {
+    std::string message_str = "REGISTER " +
+                              std::to_string(parameters_.stride) + " " +
+                              std::to_string(parameters_.offset) + " " +
+                              to_string(parameters_.queue_policy) + " ";
+    if (parameters_.queue_policy == WorkerQueuePolicy::Balanced) {
+      message_str += std::to_string(parameters_.prefetch) + " " +
+                     parameters_.group + " ";
+    }
+    message_str += parameters_.client_name;
+    std::vector<std::string> options;
+    if (parameters_.batch) {
+      options.emplace_back("BATCH");
+    }
+    if (parameters_.queue_policy == WorkerQueuePolicy::QueueAll &&
+        parameters_.prefetch > 1) {
+      options.push_back("PREFETCH " + std::to_string(parameters_.prefetch));
+    }
+    if (channel_) {
+      options.push_back("SHM " + channel_->name());
+    }
+    if (parameters_.priority != 0) {
+      options.push_back("PRIORITY " + std::to_string(parameters_.priority));
+    }
+    send_message(message_str, !options.empty());
+    for (size_t i = 0; i < options.size(); ++i) {
+      distributor_socket_->send(zmq::buffer(options[i]),
+                                i + 1 < options.size()
+                                    ? zmq::send_flags::sndmore
+                                    : zmq::send_flags::none);
+    }
   }
 
-  void send_completion(ItemID id) {
-    const std::string message_str = "COMPLETE " + std::to_string(id);
-    distributor_socket_->send(zmq::buffer(message_str));
-    reset_heartbeat_time();
+  void send_heartbeat() { send_message("HEARTBEAT"); }
+
+  // Send a message with the USAGE report appended if not empty
+  void send_message(const std::string& message_str,
+                    const std::string& usage) {
+    send_message(message_str, !usage.empty());
+    if (!usage.empty()) {
+      distributor_socket_->send(zmq::buffer(usage), zmq::send_flags::none);
+    }
+  }
+
+  // Retrieve the USAGE report if enabled and due (empty otherwise)
+  std::string take_usage_report() {
+    if (!parameters_.usage) {
+      return {};
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now < usage_begin_ + worker_usage_interval) {
+      return {};
+    }
+    WorkerUsage usage = completed_items_.take_usage();
+    usage.period =
+        std::chrono::duration_cast<WorkerUsage::duration>(now - usage_begin_);
+    usage.idle = std::chrono::duration_cast<WorkerUsage::duration>(idle_time_);
+    usage_begin_ = now;
+    idle_time_ = {};
+    return usage.to_string();
   }
 
   void send_pending_completions() {
-    while (!completed_items_.empty()) {
-      auto id = completed_items_.front();
-      send_completion(id);
-      completed_items_.pop();
-      items_.erase(id);
+    auto completed = completed_items_.take();
+    // A synchronous socket can only report the usage with a completion
+    std::string usage =
+        pipelined_ || !completed.empty() ? take_usage_report() : "";
+    if (completed.empty()) {
+      if (!usage.empty()) {
+        send_message(usage);
+      }
+      return;
+    }
+    if (channel_ && channel_->accepted()) {
+      // The remaining completions of a full channel are sent as messages
+      auto it = completed.begin();
+      while (it != completed.end() && channel_->push_completion(*it)) {
+        items_.erase(*it);
+        ++it;
+      }
+      if (channel_->wake_distributor()) {
+        send_message("WAKE");
+      }
+      completed.erase(completed.begin(), it);
+      if (completed.empty()) {
+        if (!usage.empty()) {
+          send_message(usage);
+        }
+        return;
+      }
+    }
+    if (batch_active_) {
+      std::string message_str = "COMPLETIONS";
+      for (auto id : completed) {
+        message_str += " " + std::to_string(id);
+        items_.erase(id);
+      }
+      send_message(message_str, usage);
+      return;
+    }
+    for (size_t i = 0; i < completed.size(); ++i) {
+      send_message("COMPLETE " + std::to_string(completed[i]),
+                   i + 1 == completed.size() ? usage : std::string());
+      items_.erase(completed[i]);
     }
   }
 
@@ -149,10 +381,18 @@ private:
     return (message.rfind("WORK_ITEM ", 0) == 0);
   }
 
+  static bool is_work_items(const std::string& message) {
+    return (message.rfind("WORK_ITEMS ", 0) == 0);
+  }
+
   static bool is_heartbeat(const std::string& message) {
     return (message.rfind("HEARTBEAT", 0) == 0);
   }
 
+  static bool is_wake(const std::string& message) {
+    return (message.rfind("WAKE", 0) == 0);
+  }
+
   static bool is_disconnect(const std::string& message) {
     return (message.rfind("DISCONNECT", 0) == 0);
   }
@@ -169,14 +409,21 @@ private:
   const std::string distributor_address_;
   zmq::context_t context_{1};
   std::unique_ptr<zmq::socket_t> distributor_socket_;
+  std::unique_ptr<ShmItemChannel> channel_;
   DisconnectCallback disconnect_callback_;
 
   const WorkerParameters parameters_{1, 0, WorkerQueuePolicy::QueueAll,
                                      "example_client"};
   std::set<ItemID> items_;
-  std::queue<ItemID> completed_items_;
+  CompletionQueue completed_items_;
+  std::deque<std::shared_ptr<Item>> received_items_;
   std::chrono::system_clock::time_point last_heartbeat_time_ =
       std::chrono::system_clock::now();
+  // Start of the current usage reporting period and idle time since
+  std::chrono::steady_clock::time_point usage_begin_;
+  std::chrono::steady_clock::duration idle_time_{};
+  bool pipelined_ = false;
+  bool batch_active_ = false;
   bool stopped_ = false;
 };
 
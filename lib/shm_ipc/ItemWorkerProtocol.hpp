@@ -3,12 +3,16 @@
 
 #include "log.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <mutex>
 #include <ostream>
-#include <queue>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 /**
  * The ItemWorker protocol
@@ -26,7 +30,48 @@
  * outstanding WORK_ITEMs for that worker and stops sending messages to it.
  *
  * The REGISTER message contains a specification of the type of items the worker
- * wants to receive (stride, offset). It also specifies the queueing mode.
+ * wants to receive (stride, offset). It also specifies the queueing mode. For
+ * the Balanced mode, it additionally contains the number of items to prefetch
+ * and the name of the worker group.
+ *
+ * A worker may offer batched messages by appending a "BATCH" part to its
+ * REGISTER message. A distributor that supports them then sends WORK_ITEMS
+ * messages, each carrying several items: "WORK_ITEMS <id> <id> ..." followed
+ * by one (possibly empty) payload part per item. Once it has received a
+ * WORK_ITEMS message, the worker reports completions as a single
+ * "COMPLETIONS <id> <id> ..." message. Batching workers use an asynchronous
+ * (DEALER) socket.
+ *
+ * A QueueAll worker may hold more than one outstanding item by appending a
+ * "PREFETCH <n>" part to its REGISTER message (after the optional "BATCH"
+ * part). The broker then sends up to n items without waiting for their
+ * completions. Prefetching workers use an asynchronous (DEALER) socket.
+ *
+ * A same-host worker may offer a shared memory channel (see ShmItemChannel)
+ * by appending a "SHM <name>" part to its REGISTER message. A distributor
+ * that opens the channel confirms it with a flag in the channel and writes
+ * the work items to it. Once it sees the confirmation, the worker reports
+ * completions through it. A side that has written to the channel
+ * while the other one is blocked sends a "WAKE" message. Such workers use
+ * an asynchronous (DEALER) socket.
+ *
+ * A worker may ask for a priority class other than the default (0) by
+ * appending a "PRIORITY <n>" part to its REGISTER message. The broker sends
+ * the items of workers with a higher priority first. When the number of
+ * items it holds reaches a configured limit (see
+ * ItemDistributor::set_priority_limit()), the broker only delivers new items
+ * to the workers of the highest registered priority and releases the items
+ * queued for all others.
+ *
+ * A worker may report how it spends its time by appending a
+ * "USAGE <period_us> <items> <wait_us> <hold_us> <idle_us>" part to a
+ * COMPLETE or COMPLETIONS message, at most once per worker_usage_interval.
+ * A worker reporting its completions through a shared memory channel sends
+ * it as a message of its own. The values cover the period since the
+ * previous report: the number of items released, the summed time from the
+ * arrival of each item to its retrieval by the consumer, the summed time
+ * from its retrieval to its release, and the time the consumer spent
+ * waiting for the next item (see WorkerUsage).
  */
 
 constexpr static auto distributor_heartbeat_interval =
@@ -35,6 +80,8 @@ constexpr static auto distributor_poll_timeout = std::chrono::milliseconds{100};
 constexpr static auto worker_poll_timeout = std::chrono::milliseconds{500};
 constexpr static auto worker_heartbeat_timeout =
     10 * distributor_heartbeat_interval;
+constexpr static size_t distributor_max_batch_items = 256;
+constexpr static auto worker_usage_interval = std::chrono::seconds{1};
 
 class WorkerProtocolError : public std::runtime_error {
 public:
@@ -44,11 +91,142 @@ public:
 
 using ItemID = size_t;
 
+/**
+ * The time a worker spent on its items in a reporting period (see USAGE).
+ */
+struct WorkerUsage {
+  using duration = std::chrono::microseconds;
+
+  duration period{0};
+  size_t items = 0;
+  /// Summed time from the arrival of the items to their retrieval
+  duration wait{0};
+  /// Summed time from the retrieval of the items to their release
+  duration hold{0};
+  /// Time spent waiting for the next item
+  duration idle{0};
+
+  /// The busy fraction of the period (0..1).
+  [[nodiscard]] double utilization() const {
+    if (period.count() <= 0) {
+      return 0;
+    }
+    double idle_fraction = static_cast<double>(idle.count()) /
+                           static_cast<double>(period.count());
+    return std::min(std::max(1.0 - idle_fraction, 0.0), 1.0);
+  }
+
+  [[nodiscard]] std::string to_string() const {
+    return "USAGE " + std::to_string(period.count()) + " " +
+           std::to_string(items) + " " + std::to_string(wait.count()) + " " +
+           std::to_string(hold.count()) + " " + std::to_string(idle.count());
+  }
+
+  /// Parse a USAGE message (part), throws std::invalid_argument on error.
+  static WorkerUsage parse(const std::string& message) {
+    WorkerUsage usage;
+    std::string command;
+    int64_t period = 0;
+    int64_t wait = 0;
+    int64_t hold = 0;
+    int64_t idle = 0;
+    std::stringstream s(message);
+    s >> command >> period >> usage.items >> wait >> hold >> idle;
+    if (s.fail() || command != "USAGE" || period < 0 || wait < 0 ||
+        hold < 0 || idle < 0) {
+      throw std::invalid_argument("Invalid usage message: " + message);
+    }
+    usage.period = duration(period);
+    usage.wait = duration(wait);
+    usage.hold = duration(hold);
+    usage.idle = duration(idle);
+    return usage;
+  }
+};
+
+/**
+ * Queue of the IDs of completed items, filled by the Item destructor.
+ *
+ * Items may be released in any thread. Completions of items handed out
+ * before the last reset() (i.e., on a previous connection) are discarded.
+ */
+class CompletionQueue {
+public:
+  void push(ItemID id, size_t epoch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (epoch == epoch_) {
+      ids_.push_back(id);
+    }
+  }
+
+  // Queue a completion and account for the time spent on the item
+  void push(ItemID id,
+            size_t epoch,
+            std::chrono::steady_clock::duration wait,
+            std::chrono::steady_clock::duration hold) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (epoch == epoch_) {
+      ids_.push_back(id);
+      ++usage_items_;
+      usage_wait_ += wait;
+      usage_hold_ += hold;
+    }
+  }
+
+  // Retrieve and clear the queued completions
+  std::vector<ItemID> take() {
+    std::vector<ItemID> ids;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ids.swap(ids_);
+    return ids;
+  }
+
+  // Retrieve and clear the accounted items and times (period and idle time
+  // are left to the caller)
+  WorkerUsage take_usage() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    WorkerUsage usage;
+    usage.items = usage_items_;
+    usage.wait =
+        std::chrono::duration_cast<WorkerUsage::duration>(usage_wait_);
+    usage.hold =
+        std::chrono::duration_cast<WorkerUsage::duration>(usage_hold_);
+    usage_items_ = 0;
+    usage_wait_ = {};
+    usage_hold_ = {};
+    return usage;
+  }
+
+  [[nodiscard]] size_t epoch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return epoch_;
+  }
+
+  // Discard the queued and all future completions of the current items
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ids_.clear();
+    ++epoch_;
+    usage_items_ = 0;
+    usage_wait_ = {};
+    usage_hold_ = {};
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<ItemID> ids_;
+  size_t epoch_ = 0;
+  size_t usage_items_ = 0;
+  std::chrono::steady_clock::duration usage_wait_{};
+  std::chrono::steady_clock::duration usage_hold_{};
+};
+
 class Item {
 public:
-  Item(std::queue<ItemID>* completed_items, ItemID id, std::string payload)
-      : completed_items_(completed_items), id_(id),
-        payload_(std::move(payload)) {}
+  Item(CompletionQueue* completed_items, ItemID id, std::string payload)
+      : completed_items_(completed_items), epoch_(completed_items->epoch()),
+        id_(id), payload_(std::move(payload)),
+        arrival_(std::chrono::steady_clock::now()) {}
 
   // Item is non-copyable
   Item(const Item& other) = delete;
@@ -60,12 +238,33 @@ public:
 
   [[nodiscard]] const std::string& payload() const { return payload_; }
 
-  ~Item() { completed_items_->push(id_); }
+  [[nodiscard]] std::chrono::steady_clock::time_point arrival() const {
+    return arrival_;
+  }
+
+  // Record the retrieval by the consumer, so that the time spent on the
+  // item is accounted on its release. This is bookkeeping of the receiving
+  // side only and therefore allowed on a const item.
+  void set_retrieval(std::chrono::steady_clock::time_point retrieval) const {
+    retrieval_ = retrieval;
+  }
+
+  ~Item() {
+    if (retrieval_ == std::chrono::steady_clock::time_point{}) {
+      completed_items_->push(id_, epoch_);
+    } else {
+      completed_items_->push(id_, epoch_, retrieval_ - arrival_,
+                             std::chrono::steady_clock::now() - retrieval_);
+    }
+  }
 
 private:
-  std::queue<ItemID>* completed_items_;
+  CompletionQueue* completed_items_;
+  const size_t epoch_;
   const ItemID id_;
   const std::string payload_;
+  const std::chrono::steady_clock::time_point arrival_;
+  mutable std::chrono::steady_clock::time_point retrieval_{};
 };
 
 /**
@@ -94,7 +293,17 @@ enum class WorkerQueuePolicy {
    * The broker keeps no item queue for this worker. It only sends the item
    * immediately if the worker is idle.
    */
-  Skip
+  Skip,
+  /**
+   * Balanced:
+   *
+   * All workers registering with the same group name, stride, and offset
+   * share a common item queue. Each matching item is delivered to only one
+   * worker of the group, the one with the fewest outstanding items. Each
+   * worker holds at most "prefetch" outstanding items. As with QueueAll, no
+   * items are skipped.
+   */
+  Balanced
 };
 
 // Stream enum as the underlying integer type
@@ -121,6 +330,29 @@ struct WorkerParameters {
   size_t offset;
   WorkerQueuePolicy queue_policy;
   std::string client_name;
+  /**
+   * Balanced only: name of the worker group (non-empty, without whitespace)
+   *
+   * Balanced and QueueAll: maximum number of outstanding items per worker
+   */
+  std::string group{};
+  size_t prefetch = 1;
+  /**
+   * Offer batched WORK_ITEMS and COMPLETIONS messages to the distributor
+   */
+  bool batch = false;
+  /**
+   * Offer a shared memory channel to the distributor (same host only)
+   */
+  bool shm = false;
+  /**
+   * Priority class (higher is served first, see above)
+   */
+  unsigned priority = 0;
+  /**
+   * Report the time spent on the items to the distributor (see USAGE above)
+   */
+  bool usage = false;
 };
 
 #endif
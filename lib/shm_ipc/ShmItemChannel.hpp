@@ -0,0 +1,278 @@
+#ifndef SHM_IPC_SHMITEMCHANNEL_HPP
+#define SHM_IPC_SHMITEMCHANNEL_HPP
+
+#include "ItemWorkerProtocol.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+/**
+ * Shared memory channel between an ItemDistributor and a same-host
+ * ItemWorker
+ *
+ * The channel consists of two single-producer single-consumer rings in a
+ * shared memory segment created by the worker: the work items (ID and
+ * payload) from the distributor to the worker, and the IDs of completed
+ * items in the opposite direction. The ZMQ connection remains in use for
+ * registration, heartbeats, and wakeups: a side that is about to block
+ * announces this in the channel, and the other side then sends a WAKE
+ * message after writing to the channel. As long as both sides are busy,
+ * items and completions are passed without any system call.
+ *
+ * A worker offers its channel by appending a "SHM <name>" part to its
+ * REGISTER message. A distributor that has opened the channel confirms
+ * this by setting the accepted flag; until then, the worker reports its
+ * completions through the ZMQ connection. Items or completions that do not
+ * fit into the channel are sent through the ZMQ connection as well.
+ */
+class ShmItemChannel {
+public:
+  /// Default size of the work item ring in bytes.
+  static constexpr size_t default_capacity = size_t{1} << 20;
+
+  /// Create a channel (worker side), removed on destruction.
+  /** The capacity is the size of the work item ring in bytes, a power of
+      two. */
+  ShmItemChannel(std::string name, size_t capacity)
+      : name_(std::move(name)), owner_(true) {
+    if (capacity < 2 * record_header_size ||
+        (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument(
+          "ShmItemChannel: capacity must be a power of two");
+    }
+    namespace bi = boost::interprocess;
+    bi::shared_memory_object::remove(name_.c_str());
+    bi::shared_memory_object shm(bi::create_only, name_.c_str(),
+                                 bi::read_write);
+    const size_t completion_capacity = capacity / record_header_size;
+    shm.truncate(static_cast<bi::offset_t>(
+        segment_size(capacity, completion_capacity)));
+    region_ = std::make_unique<bi::mapped_region>(shm, bi::read_write);
+    header_ = new (region_->get_address()) Header;
+    header_->item_capacity = capacity;
+    header_->completion_capacity = completion_capacity;
+    header_->magic = magic;
+    map_rings();
+  }
+
+  /// Open the channel of a worker (distributor side).
+  explicit ShmItemChannel(std::string name) : name_(std::move(name)) {
+    namespace bi = boost::interprocess;
+    bi::shared_memory_object shm(bi::open_only, name_.c_str(),
+                                 bi::read_write);
+    region_ = std::make_unique<bi::mapped_region>(shm, bi::read_write);
+    header_ = static_cast<Header*>(region_->get_address());
+    if (region_->get_size() < sizeof(Header) || header_->magic != magic ||
+        region_->get_size() < segment_size(header_->item_capacity,
+                                           header_->completion_capacity)) {
+      throw std::runtime_error("ShmItemChannel: invalid channel " + name_);
+    }
+    map_rings();
+  }
+
+  // ShmItemChannel is non-copyable
+  ShmItemChannel(const ShmItemChannel& other) = delete;
+  ShmItemChannel& operator=(const ShmItemChannel& other) = delete;
+
+  ~ShmItemChannel() {
+    if (owner_) {
+      boost::interprocess::shared_memory_object::remove(name_.c_str());
+    }
+  }
+
+  [[nodiscard]] const std::string& name() const { return name_; }
+
+  /// Confirm that the distributor serves the channel (distributor side).
+  void accept() { header_->accepted.store(1, std::memory_order_release); }
+
+  /// Check whether the distributor serves the channel (worker side).
+  [[nodiscard]] bool accepted() const {
+    return header_->accepted.load(std::memory_order_acquire) != 0;
+  }
+
+  /// Write a work item (distributor side), returns false if it does not fit.
+  bool push_item(ItemID id, const std::string& payload) {
+    const uint64_t capacity = header_->item_capacity;
+    const uint64_t size = record_size(payload.size());
+    const uint64_t write = header_->item_write.load(std::memory_order_relaxed);
+    const uint64_t read = header_->item_read.load(std::memory_order_acquire);
+    uint64_t pos = write & (capacity - 1);
+    // a record does not wrap, the remainder is skipped if too short
+    const uint64_t skip = capacity - pos < size ? capacity - pos : 0;
+    if (write + skip + size - read > capacity) {
+      return false;
+    }
+    if (skip != 0) {
+      record_at(pos)->size = skip_marker;
+      pos = 0;
+    }
+    RecordHeader* record = record_at(pos);
+    record->id = id;
+    record->size = payload.size();
+    std::memcpy(record + 1, payload.data(), payload.size());
+    // sequentially consistent, see wake_worker()
+    header_->item_write.store(write + skip + size);
+    return true;
+  }
+
+  /// Read a work item (worker side), returns false if there is none.
+  bool pop_item(ItemID& id, std::string& payload) {
+    const uint64_t capacity = header_->item_capacity;
+    uint64_t read = header_->item_read.load(std::memory_order_relaxed);
+    if (read == header_->item_write.load(std::memory_order_acquire)) {
+      return false;
+    }
+    uint64_t pos = read & (capacity - 1);
+    if (record_at(pos)->size == skip_marker) {
+      read += capacity - pos;
+      pos = 0;
+    }
+    const RecordHeader* record = record_at(pos);
+    id = record->id;
+    payload.assign(reinterpret_cast<const char*>(record + 1), record->size);
+    header_->item_read.store(read + record_size(record->size),
+                             std::memory_order_release);
+    return true;
+  }
+
+  /// Write a completion (worker side), returns false if the ring is full.
+  bool push_completion(ItemID id) {
+    const uint64_t capacity = header_->completion_capacity;
+    const uint64_t write =
+        header_->completion_write.load(std::memory_order_relaxed);
+    if (write - header_->completion_read.load(std::memory_order_acquire) ==
+        capacity) {
+      return false;
+    }
+    completions_[write & (capacity - 1)] = id;
+    // sequentially consistent, see wake_distributor()
+    header_->completion_write.store(write + 1);
+    return true;
+  }
+
+  /// Read a completion (distributor side), returns false if there is none.
+  bool pop_completion(ItemID& id) {
+    const uint64_t read =
+        header_->completion_read.load(std::memory_order_relaxed);
+    if (read == header_->completion_write.load(std::memory_order_acquire)) {
+      return false;
+    }
+    id = completions_[read & (header_->completion_capacity - 1)];
+    header_->completion_read.store(read + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Announce that the worker is about to block, returns false if items
+  /// have arrived in the meantime.
+  bool prepare_worker_wait() {
+    header_->worker_waiting.store(1);
+    if (has_items()) {
+      header_->worker_waiting.store(0, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  /// Withdraw the announcement of a blocking worker.
+  void end_worker_wait() {
+    header_->worker_waiting.store(0, std::memory_order_relaxed);
+  }
+
+  /// Check whether the worker has to be woken up after writing items.
+  bool wake_worker() { return header_->worker_waiting.exchange(0) != 0; }
+
+  /// Announce that the distributor is about to block, returns false if
+  /// completions have arrived in the meantime.
+  bool prepare_distributor_wait() {
+    header_->distributor_waiting.store(1);
+    if (has_completions()) {
+      header_->distributor_waiting.store(0, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  /// Withdraw the announcement of a blocking distributor.
+  void end_distributor_wait() {
+    header_->distributor_waiting.store(0, std::memory_order_relaxed);
+  }
+
+  /// Check whether the distributor has to be woken up after writing
+  /// completions.
+  bool wake_distributor() {
+    return header_->distributor_waiting.exchange(0) != 0;
+  }
+
+  [[nodiscard]] bool has_items() const {
+    return header_->item_read.load(std::memory_order_relaxed) !=
+           header_->item_write.load();
+  }
+
+  [[nodiscard]] bool has_completions() const {
+    return header_->completion_read.load(std::memory_order_relaxed) !=
+           header_->completion_write.load();
+  }
+
+private:
+  static constexpr uint64_t magic = 0x464c45534954454dULL; // "FLESITEM"
+  static constexpr uint64_t skip_marker = ~uint64_t{0};
+  static constexpr size_t record_header_size = 16;
+  static constexpr size_t cache_line_size = 64;
+
+  struct Header {
+    uint64_t magic = 0;
+    uint64_t item_capacity = 0;
+    uint64_t completion_capacity = 0;
+    alignas(cache_line_size) std::atomic<uint64_t> item_write{0};
+    alignas(cache_line_size) std::atomic<uint64_t> item_read{0};
+    alignas(cache_line_size) std::atomic<uint64_t> completion_write{0};
+    alignas(cache_line_size) std::atomic<uint64_t> completion_read{0};
+    alignas(cache_line_size) std::atomic<uint32_t> worker_waiting{0};
+    alignas(cache_line_size) std::atomic<uint32_t> distributor_waiting{0};
+    std::atomic<uint32_t> accepted{0};
+  };
+
+  struct RecordHeader {
+    uint64_t id;
+    uint64_t size; // payload size, or skip_marker
+  };
+  static_assert(sizeof(RecordHeader) == record_header_size);
+
+  // Size of a record, a multiple of the header size, so that the space
+  // remaining before the end of the ring always holds a header
+  static uint64_t record_size(uint64_t payload_size) {
+    return record_header_size + (payload_size + record_header_size - 1) /
+                                    record_header_size * record_header_size;
+  }
+
+  static size_t segment_size(size_t capacity, size_t completion_capacity) {
+    return sizeof(Header) + capacity + completion_capacity * sizeof(ItemID);
+  }
+
+  void map_rings() {
+    items_ = static_cast<uint8_t*>(region_->get_address()) + sizeof(Header);
+    completions_ = reinterpret_cast<ItemID*>(items_ + header_->item_capacity);
+  }
+
+  RecordHeader* record_at(uint64_t pos) {
+    return reinterpret_cast<RecordHeader*>(items_ + pos);
+  }
+
+  std::string name_;
+  bool owner_ = false;
+  std::unique_ptr<boost::interprocess::mapped_region> region_;
+  Header* header_ = nullptr;
+  uint8_t* items_ = nullptr;
+  ItemID* completions_ = nullptr;
+};
+
+#endif
@@ -0,0 +1,488 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ArchiveBlock.hpp"
+#include "MicrosliceInputArchive.hpp"
+#include "MicrosliceMappedArchive.hpp"
+#include "MicrosliceOutputArchive.hpp"
+#include "MicrosliceRawOutputArchive.hpp"
+#include "StorableMicroslice.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include "TimesliceRawOutputArchive.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Benchmark of the archive formats.
+ *
+ * The timeslices of a reference archive are repeated, with shifted indexes,
+ * until the requested amount of content is reached. For each timeslice and
+ * microslice archive format, the data is written to a file in the given
+ * directory and read back, and the throughput, the CPU time per GB of
+ * content, and the ratio of content to file size are reported. For the
+ * formats with an index, the latency of seeking to a random data set and
+ * reading it is measured as well.
+ *
+ * The written file is synced to disk as part of the write and dropped from
+ * the page cache before it is read, so that the read measures the storage
+ * rather than the memory. All content read is touched, also for the mapped
+ * formats. The formats that are not supported by the build (e.g.,
+ * compression without libzstd) are skipped.
+ *
+ * Usage: archive_benchmark [--csv] [--size <MB>] [--seeks <n>]
+ *                          [--dir <path>] [<reference .tsa archive>]
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// Prevent the compiler from optimizing away a computed value.
+template <typename T> void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Access each cache line of a content and return its size.
+size_t touch(const uint8_t* content, size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; i += 64) {
+    sum += content[i];
+  }
+  do_not_optimize(sum);
+  return size;
+}
+
+size_t touch(const fles::Timeslice& ts) {
+  size_t bytes = 0;
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    for (uint64_t m = 0; m < ts.num_microslices(c); ++m) {
+      bytes += touch(ts.content(c, m), ts.descriptor(c, m).size);
+    }
+  }
+  return bytes;
+}
+
+size_t touch(const fles::Microslice& ms) {
+  return touch(ms.content(), ms.desc().size);
+}
+
+/// The data set written to each archive.
+struct Data {
+  std::vector<std::shared_ptr<const fles::Timeslice>> timeslices;
+  std::vector<std::shared_ptr<const fles::Microslice>> microslices;
+  size_t timeslice_bytes = 0;  // microslice content of the timeslices
+  size_t microslice_bytes = 0; // microslice content of the microslices
+};
+
+/// Copy a timeslice with its timeslice and microslice indexes shifted.
+std::shared_ptr<fles::StorableTimeslice>
+shifted(const fles::Timeslice& ts, uint64_t index, uint64_t idx_offset) {
+  auto copy = std::make_shared<fles::StorableTimeslice>(
+      static_cast<uint32_t>(ts.num_core_microslices()), index);
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    uint64_t num_microslices = ts.num_microslices(c);
+    auto component = copy->append_component(num_microslices, 0,
+                                            ts.size_component(c));
+    for (uint64_t m = 0; m < num_microslices; ++m) {
+      fles::MicrosliceDescriptor desc = ts.descriptor(c, m);
+      desc.idx += idx_offset;
+      copy->append_microslice(component, m, desc, ts.content(c, m));
+    }
+  }
+  return copy;
+}
+
+/// Repeat the timeslices of the reference archive up to the given size.
+Data load(const std::string& reference, size_t size) {
+  std::vector<std::unique_ptr<fles::StorableTimeslice>> ref;
+  fles::TimesliceInputArchive archive(reference);
+  uint64_t min_idx = UINT64_MAX;
+  uint64_t max_idx = 0;
+  size_t ref_bytes = 0;
+  while (auto ts = archive.get()) {
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      for (uint64_t m = 0; m < ts->num_microslices(c); ++m) {
+        min_idx = std::min(min_idx, ts->descriptor(c, m).idx);
+        max_idx = std::max(max_idx, ts->descriptor(c, m).idx);
+      }
+    }
+    ref_bytes += touch(*ts);
+    ref.push_back(std::move(ts));
+  }
+  if (ref.empty() || ref_bytes == 0) {
+    throw std::runtime_error("no content in reference archive " + reference);
+  }
+
+  // the copies follow each other in index and time
+  Data data;
+  const uint64_t idx_span = max_idx - min_idx + 1;
+  for (uint64_t rep = 0; data.timeslice_bytes < size; ++rep) {
+    for (const auto& ts : ref) {
+      auto copy = shifted(*ts, data.timeslices.size(), rep * idx_span);
+      data.timeslice_bytes += touch(*copy);
+      for (uint64_t m = 0; m < copy->num_core_microslices(); ++m) {
+        for (uint64_t c = 0; c < copy->num_components(); ++c) {
+          auto ms = std::make_shared<fles::StorableMicroslice>(
+              copy->descriptor(c, m), copy->content(c, m));
+          data.microslice_bytes += touch(*ms);
+          data.microslices.push_back(std::move(ms));
+        }
+      }
+      data.timeslices.push_back(std::move(copy));
+    }
+  }
+  return data;
+}
+
+/// Train a compression dictionary on the microslice contents.
+std::string train_dictionary(const Data& data) {
+  constexpr size_t max_sample_bytes = 64 << 20;
+  std::vector<std::string> samples;
+  size_t sample_bytes = 0;
+  for (const auto& ms : data.microslices) {
+    if (sample_bytes >= max_sample_bytes) {
+      break;
+    }
+    samples.emplace_back(reinterpret_cast<const char*>(ms->content()),
+                         ms->desc().size);
+    sample_bytes += ms->desc().size;
+  }
+  return fles::train_compression_dictionary(samples);
+}
+
+/// Process CPU time (s), including the helper threads of the archives.
+double cpu_seconds() {
+  timespec ts{};
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) +
+         static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+/// Write a file to disk and drop it from the page cache.
+void sync_and_drop(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+size_t file_size(const std::string& filename) {
+  struct stat st {};
+  return stat(filename.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size)
+                                          : 0;
+}
+
+/// An archive format under test.
+struct Format {
+  std::string name;
+  bool timeslices; // stores timeslices (else microslices)
+  /// Write the data set to the given file.
+  std::function<void(const std::string&, const Data&)> write;
+  /// Read the given file and return the content bytes read.
+  std::function<size_t(const std::string&)> read;
+  /// Seek to the given index and read the data set (if supported).
+  std::function<size_t(const std::string&, const std::vector<uint64_t>&,
+                       std::vector<double>&)>
+      seek;
+};
+
+template <class OutputArchive, class... Args>
+void write_timeslices(const std::string& filename,
+                      const Data& data,
+                      Args&&... args) {
+  OutputArchive archive(filename, std::forward<Args>(args)...);
+  for (const auto& ts : data.timeslices) {
+    archive.put(ts);
+  }
+  archive.end_stream();
+}
+
+template <class OutputArchive, class... Args>
+void write_microslices(const std::string& filename,
+                       const Data& data,
+                       Args&&... args) {
+  OutputArchive archive(filename, std::forward<Args>(args)...);
+  for (const auto& ms : data.microslices) {
+    archive.put(ms);
+  }
+  archive.end_stream();
+}
+
+template <class InputArchive> size_t read_all(const std::string& filename) {
+  InputArchive archive(filename);
+  size_t bytes = 0;
+  while (auto item = archive.get()) {
+    bytes += touch(*item);
+  }
+  return bytes;
+}
+
+template <class InputArchive>
+size_t seek_all(const std::string& filename,
+                const std::vector<uint64_t>& indexes,
+                std::vector<double>& latencies) {
+  InputArchive archive(filename);
+  if (!archive.has_index()) {
+    return 0;
+  }
+  size_t bytes = 0;
+  for (uint64_t index : indexes) {
+    auto start = clock_type::now();
+    if (!archive.seek(index)) {
+      throw std::runtime_error("seek to " + std::to_string(index) +
+                               " failed");
+    }
+    auto item = archive.get();
+    if (!item) {
+      throw std::runtime_error("no data set at " + std::to_string(index));
+    }
+    bytes += touch(*item);
+    latencies.push_back(
+        std::chrono::duration<double>(clock_type::now() - start).count());
+  }
+  return bytes;
+}
+
+std::vector<Format> formats(const std::string& dictionary) {
+  using fles::ArchiveCompression;
+  std::vector<Format> f;
+  f.push_back({"tsa", true,
+               [](const std::string& n, const Data& d) {
+                 write_timeslices<fles::TimesliceOutputArchive>(n, d);
+               },
+               read_all<fles::TimesliceInputArchive>,
+               seek_all<fles::TimesliceInputArchive>});
+  f.push_back({"tsa-zstd", true,
+               [](const std::string& n, const Data& d) {
+                 write_timeslices<fles::TimesliceOutputArchive>(
+                     n, d, ArchiveCompression::Zstd);
+               },
+               read_all<fles::TimesliceInputArchive>, nullptr});
+  if (!dictionary.empty()) {
+    f.push_back({"tsa-zstd-dict", true,
+                 [dictionary](const std::string& n, const Data& d) {
+                   write_timeslices<fles::TimesliceOutputArchive>(
+                       n, d, ArchiveCompression::Zstd, dictionary);
+                 },
+                 read_all<fles::TimesliceInputArchive>, nullptr});
+  }
+  f.push_back({"tsr", true,
+               [](const std::string& n, const Data& d) {
+                 write_timeslices<fles::TimesliceRawOutputArchive>(n, d);
+               },
+               read_all<fles::TimesliceMappedArchive>, nullptr});
+  f.push_back({"tsr-dedup", true,
+               [](const std::string& n, const Data& d) {
+                 write_timeslices<fles::TimesliceRawOutputArchive>(n, d,
+                                                                   true);
+               },
+               read_all<fles::TimesliceMappedArchive>, nullptr});
+  f.push_back({"msa", false,
+               [](const std::string& n, const Data& d) {
+                 write_microslices<fles::MicrosliceOutputArchive>(n, d);
+               },
+               read_all<fles::MicrosliceInputArchive>,
+               seek_all<fles::MicrosliceInputArchive>});
+  f.push_back({"msa-zstd", false,
+               [](const std::string& n, const Data& d) {
+                 write_microslices<fles::MicrosliceOutputArchive>(
+                     n, d, ArchiveCompression::Zstd);
+               },
+               read_all<fles::MicrosliceInputArchive>, nullptr});
+  f.push_back({"msr", false,
+               [](const std::string& n, const Data& d) {
+                 write_microslices<fles::MicrosliceRawOutputArchive>(n, d);
+               },
+               read_all<fles::MicrosliceMappedArchive>, nullptr});
+  f.push_back({"msr-encoded", false,
+               [](const std::string& n, const Data& d) {
+                 write_microslices<fles::MicrosliceRawOutputArchive>(
+                     n, d,
+                     fles::MicrosliceRawOutputArchive::
+                         default_microslices_per_block,
+                     fles::MicrosliceRawOutputArchive::
+                         default_max_block_content_size,
+                     true);
+               },
+               read_all<fles::MicrosliceMappedArchive>, nullptr});
+  return f;
+}
+
+struct Result {
+  size_t content = 0;   // content bytes written
+  size_t file = 0;      // file bytes, including a sidecar index
+  double write_s = 0;   // wall time of the write (s)
+  double write_cpu = 0; // CPU time of the write (s)
+  double read_s = 0;
+  double read_cpu = 0;
+  /// Seek latencies, sorted (s)
+  std::vector<double> seeks;
+
+  [[nodiscard]] double seek(double quantile) const {
+    return seeks[static_cast<size_t>(quantile *
+                                     static_cast<double>(seeks.size() - 1))];
+  }
+};
+
+Result run(const Format& format,
+           const Data& data,
+           const std::string& filename,
+           size_t seek_count) {
+  Result r;
+  r.content = format.timeslices ? data.timeslice_bytes : data.microslice_bytes;
+  const std::string index_filename =
+      fles::ArchiveIndex::index_filename(filename);
+
+  auto wall = clock_type::now();
+  double cpu = cpu_seconds();
+  format.write(filename, data);
+  sync_and_drop(filename);
+  sync_and_drop(index_filename);
+  r.write_s = std::chrono::duration<double>(clock_type::now() - wall).count();
+  r.write_cpu = cpu_seconds() - cpu;
+  r.file = file_size(filename) + file_size(index_filename);
+
+  wall = clock_type::now();
+  cpu = cpu_seconds();
+  size_t bytes = format.read(filename);
+  r.read_s = std::chrono::duration<double>(clock_type::now() - wall).count();
+  r.read_cpu = cpu_seconds() - cpu;
+  if (bytes != r.content) {
+    throw std::runtime_error("read " + std::to_string(bytes) + " of " +
+                             std::to_string(r.content) + " bytes");
+  }
+
+  if (format.seek && seek_count > 0) {
+    size_t items =
+        format.timeslices ? data.timeslices.size() : data.microslices.size();
+    std::mt19937_64 random;
+    std::uniform_int_distribution<size_t> pick(0, items - 1);
+    std::vector<uint64_t> indexes;
+    for (size_t i = 0; i < seek_count; ++i) {
+      size_t n = pick(random);
+      indexes.push_back(format.timeslices ? data.timeslices[n]->index()
+                                          : data.microslices[n]->desc().idx);
+    }
+    sync_and_drop(filename);
+    format.seek(filename, indexes, r.seeks);
+    std::sort(r.seeks.begin(), r.seeks.end());
+  }
+
+  std::remove(filename.c_str());
+  std::remove(index_filename.c_str());
+  return r;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  bool csv = false;
+  size_t size_mb = 256;
+  size_t seek_count = 1000;
+  std::string dir = "/tmp";
+  std::string reference = REFERENCE_ARCHIVE;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--csv") {
+      csv = true;
+    } else if (arg == "--size" && i + 1 < argc) {
+      size_mb = std::stoul(argv[++i]);
+    } else if (arg == "--seeks" && i + 1 < argc) {
+      seek_count = std::stoul(argv[++i]);
+    } else if (arg == "--dir" && i + 1 < argc) {
+      dir = argv[++i];
+    } else if (arg.rfind("--", 0) == 0) {
+      std::cerr << "usage: " << argv[0]
+                << " [--csv] [--size <MB>] [--seeks <n>] [--dir <path>] "
+                   "[<reference .tsa archive>]"
+                << std::endl;
+      return 1;
+    } else {
+      reference = arg;
+    }
+  }
+
+  Data data = load(reference, size_mb << 20);
+  std::string dictionary;
+  try {
+    dictionary = train_dictionary(data);
+  } catch (std::exception& e) {
+    std::cerr << "no compression dictionary: " << e.what() << std::endl;
+  }
+  std::cerr << "content: " << data.timeslices.size() << " timeslices, "
+            << data.microslices.size() << " microslices, "
+            << data.timeslice_bytes / 1e6 << " MB" << std::endl;
+
+  if (csv) {
+    std::cout << "format,content_bytes,file_bytes,write_bytes_per_second,"
+                 "write_cpu_seconds_per_gb,read_bytes_per_second,"
+                 "read_cpu_seconds_per_gb,seek_p50_seconds,seek_p99_seconds\n";
+  } else {
+    std::cout << std::left << std::setw(15) << "format" << std::right
+              << std::setw(12) << "ratio" << std::setw(12) << "write MB/s"
+              << std::setw(12) << "cpu s/GB" << std::setw(12) << "read MB/s"
+              << std::setw(12) << "cpu s/GB" << std::setw(12) << "seek p50/us"
+              << std::setw(12) << "seek p99/us" << "\n";
+  }
+  for (const auto& format : formats(dictionary)) {
+    std::string filename =
+        dir + "/archive_benchmark_" + std::to_string(getpid()) + "." +
+        format.name.substr(0, 3);
+    Result r;
+    try {
+      r = run(format, data, filename, seek_count);
+    } catch (std::exception& e) {
+      std::remove(filename.c_str());
+      std::remove(fles::ArchiveIndex::index_filename(filename).c_str());
+      std::cerr << format.name << ": skipped (" << e.what() << ")"
+                << std::endl;
+      continue;
+    }
+    const double gb = static_cast<double>(r.content) / 1e9;
+    const double ratio =
+        static_cast<double>(r.content) / static_cast<double>(r.file);
+    const double write_rate = static_cast<double>(r.content) / r.write_s;
+    const double read_rate = static_cast<double>(r.content) / r.read_s;
+    if (csv) {
+      std::cout << format.name << "," << r.content << "," << r.file << ","
+                << write_rate << "," << r.write_cpu / gb << "," << read_rate
+                << "," << r.read_cpu / gb << ","
+                << (r.seeks.empty() ? "" : std::to_string(r.seek(0.5)))
+                << ","
+                << (r.seeks.empty() ? "" : std::to_string(r.seek(0.99)))
+                << std::endl;
+    } else {
+      std::cout << std::left << std::setw(15) << format.name << std::right
+                << std::fixed << std::setprecision(2) << std::setw(12) << ratio
+                << std::setprecision(1) << std::setw(12) << write_rate / 1e6
+                << std::setw(12) << r.write_cpu / gb << std::setw(12)
+                << read_rate / 1e6 << std::setw(12) << r.read_cpu / gb;
+      if (r.seeks.empty()) {
+        std::cout << std::setw(12) << "-" << std::setw(12) << "-";
+      } else {
+        std::cout << std::setw(12) << r.seek(0.5) * 1e6 << std::setw(12)
+                  << r.seek(0.99) * 1e6;
+      }
+      std::cout << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,398 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "FlesnetPatternChecker.hpp"
+#include "FlesnetPatternGenerator.hpp"
+#include "MicrosliceView.hpp"
+#include "RampPattern.hpp"
+#include "RingBuffer.hpp"
+#include "RingBufferView.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceInputArchive.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include "TimeslicePublisher.hpp"
+#include "TimesliceSource.hpp"
+#include "interface.h" // crcutil_interface
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/crc.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Microbenchmarks of the flesnet hot paths.
+ *
+ * Each benchmark runs its body repeatedly, doubling the number of
+ * iterations until the minimum run time is reached, and reports the time
+ * per iteration and the data rate. With --csv, the results are printed in
+ * a machine-readable format suitable for tracking performance across
+ * releases. The distribution of items to workers and the archive formats
+ * are measured separately by shm_ipc_benchmark and archive_benchmark.
+ *
+ * Usage: fles_benchmark [--csv] [--min-time <s>] [<name filter>]
+ */
+
+namespace {
+
+/// Prevent the compiler from optimizing away a computed value.
+template <typename T> void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// A benchmark case. The body performs one iteration and returns the number
+/// of bytes processed.
+struct Benchmark {
+  std::string name;
+  std::function<size_t()> body;
+};
+
+struct Result {
+  size_t iterations = 0;
+  double seconds = 0;
+  size_t bytes = 0;
+};
+
+Result run(const Benchmark& benchmark, double min_time) {
+  using clock = std::chrono::steady_clock;
+  Result r;
+  // warm up caches and lazily initialized state
+  benchmark.body();
+  for (size_t iterations = 1;; iterations *= 2) {
+    size_t bytes = 0;
+    auto start = clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+      bytes += benchmark.body();
+    }
+    double seconds =
+        std::chrono::duration<double>(clock::now() - start).count();
+    if (seconds >= min_time || iterations >= (size_t(1) << 40)) {
+      r.iterations = iterations;
+      r.seconds = seconds;
+      r.bytes = bytes;
+      return r;
+    }
+  }
+}
+
+/// Microslice content sizes the benchmarks are run with.
+const std::vector<uint32_t> microslice_sizes{256, 4096, 65536, 1048576};
+
+constexpr uint32_t timeslice_components = 4;
+constexpr uint32_t timeslice_microslices = 16;
+
+std::string sized(const std::string& name, uint32_t size) {
+  return name + "/" + std::to_string(size);
+}
+
+std::string archive_filename(uint32_t size) {
+  return "/tmp/fles_benchmark_" + std::to_string(getpid()) + "_" +
+         std::to_string(size) + ".tsa";
+}
+
+/// Create a timeslice with ramp pattern content.
+std::shared_ptr<fles::StorableTimeslice> make_timeslice(uint32_t size) {
+  auto ts = std::make_shared<fles::StorableTimeslice>(timeslice_microslices);
+  std::vector<uint64_t> content((size + 7) / 8);
+  for (uint32_t c = 0; c < timeslice_components; ++c) {
+    ts->append_component(timeslice_microslices);
+    uint64_t x =
+        ramp_pattern::fill(content.data(), content.size(), uint64_t(c) << 48);
+    for (uint32_t m = 0; m < timeslice_microslices; ++m) {
+      fles::MicrosliceDescriptor desc{};
+      desc.hdr_id = 0xdd;
+      desc.hdr_ver = 0x01;
+      desc.eq_id = static_cast<uint16_t>(c);
+      desc.idx = m;
+      desc.crc = ramp_pattern::crc(x);
+      desc.size = size;
+      ts->append_microslice(c, m, desc,
+                            reinterpret_cast<uint8_t*>(content.data()));
+    }
+  }
+  return ts;
+}
+
+size_t content_bytes(const fles::Timeslice& ts) {
+  size_t bytes = 0;
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    bytes += ts.size_component(c);
+  }
+  return bytes;
+}
+
+void add_ring_buffer_benchmarks(std::vector<Benchmark>& benchmarks) {
+  constexpr size_t size_exp = 20;
+  constexpr size_t accesses = 4096;
+  auto buffer = std::make_shared<RingBuffer<uint64_t>>(size_exp);
+  auto view_memory = std::make_shared<std::vector<uint64_t>>(1 << size_exp);
+  auto view = std::make_shared<RingBufferView<uint64_t>>(view_memory->data(),
+                                                         size_exp);
+
+  // strided accesses wrapping around the buffer several times
+  auto index = std::make_shared<uint64_t>(0);
+  benchmarks.push_back({"RingBuffer/at", [=] {
+                          uint64_t sum = 0;
+                          for (size_t i = 0; i < accesses; ++i) {
+                            buffer->at(*index) = i;
+                            sum += buffer->at(*index + 1);
+                            *index += 4097;
+                          }
+                          do_not_optimize(sum);
+                          return accesses * 2 * sizeof(uint64_t);
+                        }});
+  benchmarks.push_back({"RingBufferView/at", [=] {
+                          uint64_t sum = 0;
+                          for (size_t i = 0; i < accesses; ++i) {
+                            view->at(*index) = i;
+                            sum += view->at(*index + 1);
+                            *index += 4097;
+                          }
+                          do_not_optimize(sum);
+                          return accesses * 2 * sizeof(uint64_t);
+                        }});
+}
+
+void add_pattern_benchmarks(std::vector<Benchmark>& benchmarks) {
+  for (uint32_t size : microslice_sizes) {
+    auto gen =
+        std::make_shared<FlesnetPatternGenerator>(24, 16, 0, size, true);
+    benchmarks.push_back({sized("FlesnetPatternGenerator/proceed", size), [=] {
+                            uint64_t before = gen->get_write_index().data;
+                            gen->proceed();
+                            DualIndex written = gen->get_write_index();
+                            gen->set_read_index(written);
+                            return written.data - before;
+                          }});
+
+    auto content = std::make_shared<std::vector<uint64_t>>(size / 8);
+    uint64_t x = ramp_pattern::fill(content->data(), content->size(), 0);
+    auto desc = std::make_shared<fles::MicrosliceDescriptor>();
+    desc->size = size;
+    desc->crc = ramp_pattern::crc(x);
+    auto ms = std::make_shared<fles::MicrosliceView>(
+        *desc, reinterpret_cast<uint8_t*>(content->data()));
+
+    std::vector<ramp_pattern::SimdLevel> levels{
+        ramp_pattern::SimdLevel::scalar};
+    if (ramp_pattern::supported_level() != ramp_pattern::SimdLevel::scalar) {
+      levels.push_back(ramp_pattern::supported_level());
+    }
+    for (auto level : levels) {
+      bool simd = level != ramp_pattern::SimdLevel::scalar;
+      auto checker = std::make_shared<FlesnetPatternChecker>(0, level);
+      benchmarks.push_back(
+          {sized(simd ? "FlesnetPatternChecker/simd"
+                      : "FlesnetPatternChecker/scalar",
+                 size),
+           [=] {
+             // the view refers to the descriptor and content
+             do_not_optimize(desc->size);
+             do_not_optimize(content->data());
+             bool ok = checker->check(*ms);
+             do_not_optimize(ok);
+             return size_t{size};
+           }});
+    }
+  }
+}
+
+void add_timeslice_benchmarks(std::vector<Benchmark>& benchmarks) {
+  for (uint32_t size : microslice_sizes) {
+    std::shared_ptr<const fles::StorableTimeslice> ts = make_timeslice(size);
+    const size_t bytes = content_bytes(*ts);
+
+    benchmarks.push_back({sized("StorableTimeslice/copy", size), [=] {
+                            const fles::Timeslice& source = *ts;
+                            fles::StorableTimeslice copy(source);
+                            do_not_optimize(copy.num_components());
+                            return bytes;
+                          }});
+
+    auto pool = std::make_shared<fles::TimesliceStoragePool>();
+    benchmarks.push_back(
+        {sized("StorableTimeslice/copy_pooled", size), [=] {
+           const fles::Timeslice& source = *ts;
+           fles::StorableTimeslice copy(source, pool);
+           do_not_optimize(copy.num_components());
+           return bytes;
+         }});
+
+    auto serial = std::make_shared<std::string>();
+    benchmarks.push_back(
+        {sized("StorableTimeslice/serialize", size), [=] {
+           serial->clear();
+           boost::iostreams::back_insert_device<std::string> inserter(*serial);
+           boost::iostreams::stream<
+               boost::iostreams::back_insert_device<std::string>>
+               s(inserter);
+           boost::archive::binary_oarchive oa(s);
+           oa << *ts;
+           s.flush();
+           return bytes;
+         }});
+
+    // sequential reads of an archive, reopened when exhausted
+    std::string archive_name = archive_filename(size);
+    {
+      fles::TimesliceOutputArchive archive(archive_name);
+      for (int i = 0; i < 16; ++i) {
+        archive.put(ts);
+      }
+    }
+    auto source = std::make_shared<std::unique_ptr<fles::TimesliceSource>>();
+    benchmarks.push_back(
+        {sized("TimesliceInputArchive/get", size), [=] {
+           for (int attempt = 0; attempt < 2; ++attempt) {
+             if (!*source) {
+               *source =
+                   std::make_unique<fles::TimesliceInputArchive>(archive_name);
+             }
+             if (auto timeslice = (*source)->get()) {
+               return content_bytes(*timeslice);
+             }
+             source->reset();
+           }
+           return size_t{0};
+         }});
+
+    // without subscribers, the publisher drops the encoded messages
+    for (bool multipart : {false, true}) {
+      auto publisher = std::make_shared<fles::TimeslicePublisher>(
+          "inproc://fles_benchmark" + std::to_string(size) +
+              (multipart ? "m" : ""),
+          1, multipart);
+      benchmarks.push_back(
+          {sized(multipart ? "TimeslicePublisher/put_multipart"
+                           : "TimeslicePublisher/put",
+                 size),
+           [=] {
+             publisher->put(ts);
+             return bytes;
+           }});
+    }
+  }
+}
+
+void add_crc_benchmarks(std::vector<Benchmark>& benchmarks) {
+  std::shared_ptr<crcutil_interface::CRC> engine(
+      crcutil_interface::CRC::Create(
+          0x82f63b78, 0, 32, true, 0, 0, 0,
+          crcutil_interface::CRC::IsSSE42Available(), nullptr),
+      [](crcutil_interface::CRC* crc) { crc->Delete(); });
+
+  for (uint32_t size : microslice_sizes) {
+    // one timeslice component worth of microslices
+    auto data = std::make_shared<std::vector<uint8_t>>(
+        size_t{size} * timeslice_microslices);
+    std::mt19937 engine_random;
+    for (auto& byte : *data) {
+      byte = static_cast<uint8_t>(engine_random());
+    }
+    const size_t bytes = data->size();
+
+    benchmarks.push_back({sized("Crc32c/crcutil", size), [=] {
+                            for (size_t m = 0; m < timeslice_microslices;
+                                 ++m) {
+                              crcutil_interface::UINT64 crc = 0;
+                              engine->Compute(data->data() + m * size, size,
+                                              &crc);
+                              do_not_optimize(crc);
+                            }
+                            return bytes;
+                          }});
+    benchmarks.push_back(
+        {sized("Crc32c/crcutil_batch", size), [=] {
+           const void* ptrs[timeslice_microslices];
+           size_t sizes[timeslice_microslices];
+           crcutil_interface::UINT64 crcs[timeslice_microslices] = {};
+           for (size_t m = 0; m < timeslice_microslices; ++m) {
+             ptrs[m] = data->data() + m * size;
+             sizes[m] = size;
+           }
+           engine->ComputeBatch(ptrs, sizes, timeslice_microslices, crcs);
+           do_not_optimize(crcs);
+           return bytes;
+         }});
+    benchmarks.push_back(
+        {sized("Crc32c/boost", size), [=] {
+           for (size_t m = 0; m < timeslice_microslices; ++m) {
+             boost::crc_optimal<32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true,
+                                true>
+                 crc;
+             crc.process_bytes(data->data() + m * size, size);
+             do_not_optimize(crc.checksum());
+           }
+           return bytes;
+         }});
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  bool csv = false;
+  double min_time = 0.5;
+  std::string filter;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--csv") {
+      csv = true;
+    } else if (arg == "--min-time" && i + 1 < argc) {
+      min_time = std::stod(argv[++i]);
+    } else if (arg.rfind("--", 0) == 0) {
+      std::cerr << "usage: " << argv[0]
+                << " [--csv] [--min-time <s>] [<name filter>]" << std::endl;
+      return 1;
+    } else {
+      filter = arg;
+    }
+  }
+
+  std::vector<Benchmark> benchmarks;
+  add_ring_buffer_benchmarks(benchmarks);
+  add_pattern_benchmarks(benchmarks);
+  add_timeslice_benchmarks(benchmarks);
+  add_crc_benchmarks(benchmarks);
+
+  if (csv) {
+    std::cout << "name,iterations,ns_per_iteration,bytes_per_second\n";
+  } else {
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right
+              << std::setw(14) << "iterations" << std::setw(16) << "ns/iter"
+              << std::setw(12) << "MB/s" << "\n";
+  }
+  for (const auto& benchmark : benchmarks) {
+    if (benchmark.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    Result r = run(benchmark, min_time);
+    double ns = r.seconds * 1e9 / static_cast<double>(r.iterations);
+    double rate = static_cast<double>(r.bytes) / r.seconds;
+    if (csv) {
+      std::cout << benchmark.name << "," << r.iterations << "," << ns << ","
+                << rate << std::endl;
+    } else {
+      std::cout << std::left << std::setw(44) << benchmark.name << std::right
+                << std::setw(14) << r.iterations << std::setw(16)
+                << std::fixed << std::setprecision(1) << ns << std::setw(12)
+                << rate / 1e6 << std::endl;
+    }
+  }
+
+  for (uint32_t size : microslice_sizes) {
+    // the archive writer also creates an index file
+    std::remove(archive_filename(size).c_str());
+    std::remove((archive_filename(size) + ".idx").c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,383 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#include "ItemDistributor.hpp"
+#include "ItemProducer.hpp"
+#include "ItemWorker.hpp"
+#include "ItemWorkerProtocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <zmq.hpp>
+
+/**
+ * Benchmark of the item distribution with many attached workers.
+ *
+ * A producer generates items at a constant rate, and a large number of
+ * workers in different (stride, offset) classes complete each item
+ * immediately. The achieved item rate and the latency between generation
+ * and final release of an item are reported. Optionally, the workers
+ * receive the items through shared memory channels.
+ *
+ * In sweep mode, all workers share one queue policy and request every
+ * item. For each queue policy, number of workers and payload size, the item
+ * rate is doubled until the distribution no longer sustains it, i.e., until
+ * an item is not released or the 99th latency percentile exceeds 10 ms.
+ * Each run reports the latency percentiles and the CPU time of the
+ * distributor and the workers per item, followed by the maximum sustainable
+ * rate of each configuration.
+ *
+ * Usage: shm_ipc_benchmark [workers [items_per_second [seconds [channel]]]]
+ *        shm_ipc_benchmark sweep [seconds [channel]]
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// CPU time consumed by the calling thread (s)
+double thread_cpu_seconds() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) +
+         static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+std::string policy_name(WorkerQueuePolicy policy) {
+  switch (policy) {
+  case WorkerQueuePolicy::QueueAll:
+    return "QueueAll";
+  case WorkerQueuePolicy::PrebufferOne:
+    return "PrebufferOne";
+  case WorkerQueuePolicy::Skip:
+    return "Skip";
+  case WorkerQueuePolicy::Balanced:
+    return "Balanced";
+  }
+  return to_string(policy);
+}
+
+struct RunConfig {
+  size_t workers = 500;
+  double rate = 10000; // items per second
+  double seconds = 5;
+  size_t payload = 0;   // bytes per item
+  bool channel = false; // shared memory channels
+  /// Queue policy of all workers (none: mixed strides and policies)
+  std::optional<WorkerQueuePolicy> policy;
+  std::chrono::seconds settle{1};
+  std::chrono::seconds drain{5};
+};
+
+struct RunResult {
+  size_t sent = 0;
+  size_t completed = 0;
+  size_t delivered = 0; // work items received by all workers
+  double elapsed = 0;   // time to send all items (s)
+  double cpu = 0;       // CPU time of the distributor and workers (s)
+  /// Release latencies, sorted (s)
+  std::vector<double> latencies;
+
+  [[nodiscard]] double latency(double quantile) const {
+    if (latencies.empty()) {
+      return 0;
+    }
+    auto i = static_cast<size_t>(quantile *
+                                 static_cast<double>(latencies.size() - 1));
+    return latencies[i];
+  }
+
+  [[nodiscard]] double rate() const {
+    return elapsed > 0 ? static_cast<double>(sent) / elapsed : 0;
+  }
+
+  [[nodiscard]] bool sustained(double max_latency) const {
+    return sent > 0 && completed == sent && latency(0.99) <= max_latency;
+  }
+};
+
+class BenchmarkWorker : public ItemWorker {
+public:
+  BenchmarkWorker(const std::string& distributor_address,
+                  WorkerParameters parameters)
+      : ItemWorker(distributor_address, std::move(parameters)) {}
+
+  void operator()() {
+    // releasing the item queues its completion for the next get() call
+    while (auto item = get()) {
+      ++items_;
+    }
+    cpu_ = thread_cpu_seconds();
+  }
+
+  [[nodiscard]] size_t items() const { return items_; }
+
+  [[nodiscard]] double cpu() const { return cpu_; }
+
+private:
+  std::atomic<size_t> items_{0};
+  double cpu_ = 0;
+};
+
+class BenchmarkProducer : public ItemProducer {
+public:
+  BenchmarkProducer(zmq::context_t& context,
+                    const std::string& distributor_address,
+                    double rate,
+                    size_t item_count,
+                    size_t payload,
+                    std::chrono::seconds drain_timeout)
+      : ItemProducer(context, distributor_address), rate_(rate),
+        item_count_(item_count), payload_(payload, 'x'),
+        drain_timeout_(drain_timeout) {}
+
+  void operator()(RunResult& result) {
+    const auto interval = std::chrono::duration<double>(1.0 / rate_);
+    const auto start = clock_type::now();
+    auto deadline = clock_type::time_point::max();
+
+    ItemID next = 0;
+    while (next < item_count_ ||
+           (!sent_time_.empty() && clock_type::now() < deadline)) {
+      ItemID id;
+      while (try_receive_completion(&id)) {
+        auto it = sent_time_.find(id);
+        if (it == sent_time_.end()) {
+          std::cerr << "Error: invalid item " << id << std::endl;
+          continue;
+        }
+        auto latency =
+            std::chrono::duration<double>(clock_type::now() - it->second);
+        result.latencies.push_back(latency.count());
+        sent_time_.erase(it);
+      }
+
+      auto now = clock_type::now();
+      if (next < item_count_) {
+        auto due = start + std::chrono::duration_cast<clock_type::duration>(
+                               interval * static_cast<double>(next));
+        if (now >= due) {
+          sent_time_.emplace(next, now);
+          send_work_item(next, payload_);
+          ++next;
+          if (next == item_count_) {
+            result.elapsed =
+                std::chrono::duration<double>(now - start).count();
+            deadline = now + drain_timeout_;
+          }
+          continue;
+        }
+      }
+      std::this_thread::yield();
+    }
+    result.sent = next;
+    result.completed = result.latencies.size();
+    std::sort(result.latencies.begin(), result.latencies.end());
+  }
+
+private:
+  const double rate_;
+  const size_t item_count_;
+  const std::string payload_;
+  const std::chrono::seconds drain_timeout_;
+  std::unordered_map<ItemID, clock_type::time_point> sent_time_;
+};
+
+WorkerParameters worker_parameters(const RunConfig& config, size_t i) {
+  std::string name = "benchmark_" + std::to_string(i);
+  if (config.policy) {
+    WorkerParameters param{1, 0, *config.policy, name};
+    if (*config.policy == WorkerQueuePolicy::Balanced) {
+      param.group = "benchmark";
+    }
+    param.shm = config.channel;
+    return param;
+  }
+
+  // Spread the workers over classes of different strides, cycling through
+  // the queue policies
+  const std::vector<size_t> strides{1, 10, 100};
+  const std::vector<WorkerQueuePolicy> policies{WorkerQueuePolicy::QueueAll,
+                                                WorkerQueuePolicy::PrebufferOne,
+                                                WorkerQueuePolicy::Skip};
+  size_t stride = strides[i % strides.size()];
+  WorkerParameters param{stride, (i / strides.size()) % stride,
+                         policies[i % policies.size()], name};
+  // Let every other worker use batched messages
+  param.batch = (i / policies.size()) % 2 == 1;
+  param.shm = config.channel;
+  return param;
+}
+
+RunResult run(zmq::context_t& zmq_context, const RunConfig& config) {
+  const std::string producer_address = "inproc://BENCHMARK";
+  const std::string worker_address = "ipc:///tmp/BENCHMARK_DELME";
+
+  RunResult result;
+  double distributor_cpu = 0;
+  auto distributor = std::make_unique<ItemDistributor>(
+      zmq_context, producer_address, worker_address);
+  std::thread distributor_thread([&distributor, &distributor_cpu] {
+    (*distributor)();
+    distributor_cpu = thread_cpu_seconds();
+  });
+
+  std::vector<std::unique_ptr<BenchmarkWorker>> workers;
+  std::vector<std::thread> worker_threads;
+  for (size_t i = 0; i < config.workers; ++i) {
+    workers.push_back(std::make_unique<BenchmarkWorker>(
+        worker_address, worker_parameters(config, i)));
+  }
+  for (auto& worker : workers) {
+    worker_threads.emplace_back(std::ref(*worker));
+  }
+
+  // Give the workers time to register
+  std::this_thread::sleep_for(config.settle);
+
+  const auto item_count = static_cast<size_t>(config.rate * config.seconds);
+  auto producer = std::make_unique<BenchmarkProducer>(
+      zmq_context, producer_address, config.rate, item_count, config.payload,
+      config.drain);
+  (*producer)(result);
+
+  distributor->stop();
+  distributor_thread.join();
+
+  for (auto& worker : workers) {
+    worker->stop();
+  }
+  result.cpu = distributor_cpu;
+  for (size_t i = 0; i < workers.size(); ++i) {
+    worker_threads[i].join();
+    result.delivered += workers[i]->items();
+    result.cpu += workers[i]->cpu();
+  }
+  return result;
+}
+
+void report(const RunConfig& config, const RunResult& result) {
+  std::cout << "items sent:      " << result.sent << " in " << result.elapsed
+            << " s (" << result.rate() << " items/s, target " << config.rate
+            << ")\n";
+  std::cout << "items completed: " << result.completed << " ("
+            << result.sent - result.completed << " outstanding)\n";
+  if (result.completed > 0) {
+    std::cout << "release latency: " << result.latency(0.5) * 1e6
+              << " us median, " << result.latency(0.99) * 1e6 << " us p99, "
+              << result.latencies.back() * 1e6 << " us max\n";
+    std::cout << "cpu per item:    "
+              << result.cpu / static_cast<double>(result.completed) * 1e6
+              << " us\n";
+  }
+  std::cout << "work items delivered: " << result.delivered << std::endl;
+}
+
+void sweep(zmq::context_t& zmq_context, double seconds, bool channel) {
+  constexpr double max_latency = 10e-3; // s
+  constexpr double min_rate = 1000;
+  constexpr double max_rate = 1e6;
+  const std::vector<WorkerQueuePolicy> policies{
+      WorkerQueuePolicy::QueueAll, WorkerQueuePolicy::PrebufferOne,
+      WorkerQueuePolicy::Skip, WorkerQueuePolicy::Balanced};
+  const std::vector<size_t> worker_counts{1, 10, 100};
+  const std::vector<size_t> payloads{0, 1024, 65536};
+
+  struct Summary {
+    RunConfig config;
+    double max_rate;
+  };
+  std::vector<Summary> summary;
+
+  std::cout << std::left << std::setw(13) << "policy" << std::right
+            << std::setw(8) << "workers" << std::setw(9) << "payload"
+            << std::setw(10) << "target/s" << std::setw(10) << "sent/s"
+            << std::setw(10) << "p50/us" << std::setw(10) << "p90/us"
+            << std::setw(10) << "p99/us" << std::setw(10) << "max/us"
+            << std::setw(10) << "cpu/us" << "  ok" << std::endl;
+  for (auto policy : policies) {
+    for (auto workers : worker_counts) {
+      for (auto payload : payloads) {
+        RunConfig config;
+        config.workers = workers;
+        config.seconds = seconds;
+        config.payload = payload;
+        config.channel = channel;
+        config.policy = policy;
+        config.drain = std::chrono::seconds(2);
+        double sustained_rate = 0;
+        for (double rate = min_rate; rate <= max_rate; rate *= 2) {
+          config.rate = rate;
+          RunResult result = run(zmq_context, config);
+          bool ok = result.sustained(max_latency);
+          double cpu_per_item =
+              result.completed > 0
+                  ? result.cpu / static_cast<double>(result.completed)
+                  : 0;
+          std::cout << std::left << std::setw(13) << policy_name(policy)
+                    << std::right << std::setw(8) << workers << std::setw(9)
+                    << payload << std::setw(10) << rate << std::setw(10)
+                    << static_cast<uint64_t>(result.rate()) << std::setw(10)
+                    << result.latency(0.5) * 1e6 << std::setw(10)
+                    << result.latency(0.9) * 1e6 << std::setw(10)
+                    << result.latency(0.99) * 1e6 << std::setw(10)
+                    << result.latency(1.0) * 1e6 << std::setw(10)
+                    << cpu_per_item * 1e6 << (ok ? "  yes" : "  no")
+                    << std::endl;
+          if (!ok) {
+            break;
+          }
+          sustained_rate = rate;
+        }
+        summary.push_back({config, sustained_rate});
+      }
+    }
+  }
+
+  std::cout << "\nmaximum sustainable rate (p99 latency <= "
+            << max_latency * 1e3 << " ms):\n";
+  for (const auto& s : summary) {
+    std::cout << std::left << std::setw(13) << policy_name(*s.config.policy)
+              << std::right << std::setw(8) << s.config.workers
+              << std::setw(9) << s.config.payload << std::setw(10)
+              << s.max_rate << " items/s" << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  zmq::context_t zmq_context{1};
+
+  if (argc > 1 && std::string(argv[1]) == "sweep") {
+    const double seconds = argc > 2 ? std::stod(argv[2]) : 1;
+    const bool channel = argc > 3 && std::string(argv[3]) == "1";
+    sweep(zmq_context, seconds, channel);
+    return 0;
+  }
+
+  RunConfig config;
+  config.workers = argc > 1 ? std::stoul(argv[1]) : 500;
+  config.rate = argc > 2 ? std::stod(argv[2]) : 10000;
+  config.seconds = argc > 3 ? std::stod(argv[3]) : 5;
+  config.channel = argc > 4 && std::string(argv[4]) == "1";
+
+  std::cout << "benchmark: " << config.workers << " workers, " << config.rate
+            << " items/s, " << static_cast<size_t>(config.rate * config.seconds)
+            << " items" << (config.channel ? ", shared memory channels" : "")
+            << std::endl;
+  RunResult result = run(zmq_context, config);
+  report(config, result);
+
+  return 0;
+}
@@ -61,6 +61,18 @@ int main() {
   ExampleWorker worker5(worker_address, param5, d0 * 4, d0 * 1);
   std::thread worker5_thread(std::ref(worker5));
 
+  // The two "reconstruction" workers share the load of all items. Each item
+  // is processed by only one of them, and each prefetches up to two items.
+  WorkerParameters param7{1, 0, WorkerQueuePolicy::Balanced, "reco_a"};
+  param7.group = "reconstruction";
+  param7.prefetch = 2;
+  ExampleWorker worker7(worker_address, param7, d0, d0);
+  std::thread worker7_thread(std::ref(worker7));
+  WorkerParameters param8 = param7;
+  param8.client_name = "reco_b";
+  ExampleWorker worker8(worker_address, param8, d0, d0);
+  std::thread worker8_thread(std::ref(worker8));
+
   // Wait until producer has finished
   producer_thread.join();
   distributor->stop();
@@ -94,12 +106,16 @@ int main() {
   worker4.stop();
   worker5.stop();
   worker6.stop();
+  worker7.stop();
+  worker8.stop();
   worker1_thread.join();
   worker2_thread.join();
   worker3_thread.join();
   worker4_thread.join();
   worker5_thread.join();
   worker6_thread.join();
+  worker7_thread.join();
+  worker8_thread.join();
 
   return 0;
 }
@@ -0,0 +1,35 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_AckCoalescing
+#include <boost/test/unit_test.hpp>
+
+#include "AckCoalescing.hpp"
+
+BOOST_AUTO_TEST_CASE(threshold_test) {
+  BOOST_CHECK_EQUAL(AckCoalescing::threshold(1000, 0.0), 1000);
+  BOOST_CHECK_EQUAL(AckCoalescing::threshold(1000, 0.5), 500);
+  BOOST_CHECK_EQUAL(AckCoalescing::threshold(1000, 1.0), 0);
+  // fill levels out of range are clamped
+  BOOST_CHECK_EQUAL(AckCoalescing::threshold(1000, -1.0), 1000);
+  BOOST_CHECK_EQUAL(AckCoalescing::threshold(1000, 2.0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(nothing_pending_test) {
+  AckCoalescing c(16, 1024);
+  BOOST_CHECK(!c.due(0, 0, 0.0));
+  BOOST_CHECK(!c.due(0, 0, 1.0));
+}
+
+BOOST_AUTO_TEST_CASE(coalescing_test) {
+  AckCoalescing c(16, 1024);
+  // an empty buffer coalesces up to the maximum amount
+  BOOST_CHECK(!c.due(15, 1000, 0.0));
+  BOOST_CHECK(c.due(16, 0, 0.0));
+  BOOST_CHECK(c.due(1, 1024, 0.0));
+  // a half full buffer coalesces half as much
+  BOOST_CHECK(!c.due(7, 500, 0.5));
+  BOOST_CHECK(c.due(8, 0, 0.5));
+  BOOST_CHECK(c.due(0, 512, 0.5));
+  // a full buffer is released with every acknowledgment
+  BOOST_CHECK(c.due(1, 0, 1.0));
+  BOOST_CHECK(c.due(0, 1, 1.0));
+}
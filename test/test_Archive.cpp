@@ -2,14 +2,41 @@
 #define BOOST_TEST_MODULE test_Archive
 #include <boost/test/unit_test.hpp>
 
+#include "ArchiveBlock.hpp"
+#include "ArchiveCatalog.hpp"
+#include "AsyncSink.hpp"
+#include "DescriptorColumnInputArchive.hpp"
+#include "DescriptorColumnOutputArchive.hpp"
+#include "InputFileBuffer.hpp"
 #include "MergingSource.hpp"
 #include "MicrosliceInputArchive.hpp"
+#include "MicrosliceMappedArchive.hpp"
 #include "MicrosliceOutputArchive.hpp"
+#include "MicrosliceRawOutputArchive.hpp"
+#include "OutputFileBuffer.hpp"
+#include "SelectedTimeslice.hpp"
+#include "StorableTimeslice.hpp"
+#include "StripeManifest.hpp"
+#include "TimesliceAutoSource.hpp"
 #include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
 #include "TimesliceOutputArchive.hpp"
+#include "TimesliceRangeArchive.hpp"
+#include "TimesliceRawArchive.hpp"
+#include "TimesliceRawOutputArchive.hpp"
+#include "TimesliceReplayArchive.hpp"
 #include "TimesliceSource.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <boost/algorithm/string/predicate.hpp>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(timeslice_output_archive_sequence_test) {
   fles::TimesliceInputArchiveLoop source("example1.tsa", 3);
@@ -54,6 +81,53 @@ BOOST_AUTO_TEST_CASE(timeslice_input_archive_sequence_vector_test2) {
       std::ios_base::failure);
 }
 
+BOOST_AUTO_TEST_CASE(timeslice_prefetch_input_archive_sequence_test) {
+  fles::TimesliceInputArchiveSequence reference("test2_%n.tsa");
+  // tiny memory budget to exercise the back-pressure path
+  fles::TimesliceInputArchiveSequence source("test2_%n.tsa", 2, 1);
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    BOOST_CHECK_EQUAL(timeslice->index(), expected->index());
+    BOOST_CHECK_EQUAL(timeslice->num_components(),
+                      expected->num_components());
+    ++count;
+  }
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, 6);
+
+  fles::TimesliceInputArchiveSequence missing(
+      {"test2_0000.tsa", "test2_0001.tsa", "test2_0002.tsa", "test2_0003.tsa"},
+      3);
+  BOOST_CHECK_THROW(
+      while (auto timeslice = missing.get()) { ++count; },
+      std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_async_output_archive_sequence_test) {
+  {
+    fles::TimesliceInputArchiveLoop source("example1.tsa", 5);
+    fles::AsyncSink<fles::Timeslice> sink(
+        std::make_unique<fles::TimesliceOutputArchiveSequence>(
+            "test5_%n.tsa", 3, SIZE_MAX, fles::ArchiveCompression::None, true),
+        2);
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+    sink.end_stream();
+    BOOST_CHECK_EQUAL(sink.queue_depth(), 0);
+  }
+
+  fles::TimesliceInputArchiveSequence source("test5_%n.tsa");
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 10);
+}
+
 BOOST_AUTO_TEST_CASE(microslice_output_archive_sequence_test) {
   fles::MicrosliceInputArchiveLoop source("example2.msa", 2);
   fles::MicrosliceOutputArchiveSequence sink("test3_%n.msa", 5);
@@ -78,6 +152,138 @@ BOOST_AUTO_TEST_CASE(microslice_input_archive_sequence_test) {
   BOOST_CHECK_EQUAL(count, 8);
 }
 
+BOOST_AUTO_TEST_CASE(microslice_raw_archive_test) {
+  {
+    fles::MicrosliceInputArchiveLoop source("example2.msa", 2);
+    fles::MicrosliceRawOutputArchive sink("test_raw.msr", 3);
+    while (auto microslice = source.get()) {
+      std::shared_ptr<const fles::Microslice> ms(std::move(microslice));
+      sink.put(ms);
+    }
+  }
+
+  fles::MicrosliceInputArchiveLoop reference("example2.msa", 2);
+  fles::MicrosliceMappedArchive source("test_raw.msr");
+  uint64_t count = 0;
+  while (auto ms = source.get()) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_CHECK_EQUAL(ms->desc().idx, ref->desc().idx);
+    BOOST_REQUIRE_EQUAL(ms->desc().size, ref->desc().size);
+    BOOST_CHECK(std::equal(ms->content(), ms->content() + ms->desc().size,
+                           ref->content()));
+    ++count;
+  }
+  BOOST_CHECK(source.eos());
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, 8);
+}
+
+BOOST_AUTO_TEST_CASE(microslice_raw_archive_encoded_test) {
+  {
+    fles::MicrosliceInputArchiveLoop source("example2.msa", 2);
+    fles::MicrosliceRawOutputArchive sink("test_raw_encoded.msr", 3,
+                                          64 * 1024 * 1024, true);
+    while (auto microslice = source.get()) {
+      std::shared_ptr<const fles::Microslice> ms(std::move(microslice));
+      sink.put(ms);
+    }
+  }
+
+  fles::MicrosliceInputArchiveLoop reference("example2.msa", 2);
+  fles::MicrosliceMappedArchive source("test_raw_encoded.msr");
+  // microslices remain valid after their block has been left
+  std::vector<std::unique_ptr<fles::MappedMicroslice>> microslices;
+  while (auto ms = source.get()) {
+    microslices.push_back(std::move(ms));
+  }
+  BOOST_CHECK_EQUAL(microslices.size(), 8);
+  for (const auto& ms : microslices) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_CHECK(std::memcmp(&ms->desc(), &ref->desc(),
+                            sizeof(fles::MicrosliceDescriptor) - 8) == 0);
+    BOOST_REQUIRE_EQUAL(ms->desc().size, ref->desc().size);
+    BOOST_CHECK(std::equal(ms->content(), ms->content() + ms->desc().size,
+                           ref->content()));
+  }
+  BOOST_CHECK(!reference.get());
+}
+
+BOOST_AUTO_TEST_CASE(microslice_raw_archive_verify_test) {
+  {
+    fles::MicrosliceInputArchiveLoop source("example2.msa", 2);
+    fles::MicrosliceRawOutputArchive sink("test_raw_verify.msr", 3);
+    while (auto microslice = source.get()) {
+      std::shared_ptr<const fles::Microslice> ms(std::move(microslice));
+      sink.put(ms);
+    }
+  }
+
+  {
+    fles::MicrosliceMappedArchive archive("test_raw_verify.msr");
+    fles::BlockVerification result = archive.verify(2);
+    BOOST_CHECK_EQUAL(result.blocks, 3);
+    BOOST_CHECK_EQUAL(result.corrupt, 0);
+    BOOST_CHECK_EQUAL(result.unchecked, 0);
+  }
+
+  // flip a byte of the first content (after the file header, the block
+  // header and three descriptors)
+  {
+    std::fstream f("test_raw_verify.msr",
+                   std::ios::in | std::ios::out | std::ios::binary);
+    f.seekg(256);
+    char c = 0;
+    f.get(c);
+    f.seekp(256);
+    f.put(static_cast<char>(c ^ 1));
+  }
+
+  fles::MicrosliceMappedArchive archive("test_raw_verify.msr");
+  fles::BlockVerification result = archive.verify(2);
+  BOOST_CHECK_EQUAL(result.blocks, 3);
+  BOOST_CHECK_EQUAL(result.corrupt, 1);
+}
+
+BOOST_AUTO_TEST_CASE(microslice_raw_archive_block_test) {
+  {
+    fles::MicrosliceInputArchiveLoop source("example2.msa", 2);
+    fles::MicrosliceRawOutputArchive sink("test_raw_block.msr", 3);
+    while (auto microslice = source.get()) {
+      std::shared_ptr<const fles::Microslice> ms(std::move(microslice));
+      sink.put(ms);
+    }
+  }
+
+  fles::MicrosliceInputArchiveLoop reference("example2.msa", 2);
+  fles::MicrosliceMappedArchive source("test_raw_block.msr");
+
+  // the rest of a partially retrieved block comes first
+  auto first = source.get();
+  BOOST_REQUIRE(first);
+  BOOST_CHECK_EQUAL(first->desc().idx, reference.get()->desc().idx);
+
+  std::vector<std::size_t> block_sizes;
+  fles::MicrosliceBlockView block;
+  while (source.get_block(block)) {
+    block_sizes.push_back(block.num_microslices);
+    for (std::size_t i = 0; i < block.num_microslices; ++i) {
+      auto ref = reference.get();
+      BOOST_REQUIRE(ref);
+      BOOST_CHECK_EQUAL(block.desc[i].idx, ref->desc().idx);
+      BOOST_CHECK(std::equal(block.content(i),
+                             block.content(i) + block.desc[i].size,
+                             ref->content()));
+    }
+  }
+  std::vector<std::size_t> expected{2, 3, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(block_sizes.begin(), block_sizes.end(),
+                                expected.begin(), expected.end());
+  BOOST_CHECK(!source.get());
+  BOOST_CHECK(!reference.get());
+}
+
 BOOST_AUTO_TEST_CASE(merging_input_archive_test) {
   std::unique_ptr<fles::TimesliceSource> source0 =
       std::make_unique<fles::TimesliceInputArchiveSequence>("test2_%n.tsa");
@@ -93,3 +299,803 @@ BOOST_AUTO_TEST_CASE(merging_input_archive_test) {
   }
   BOOST_CHECK_EQUAL(count, 8);
 }
+
+BOOST_AUTO_TEST_CASE(merging_prefetch_test) {
+  for (auto order : {fles::MergeOrder::Index, fles::MergeOrder::StartTime}) {
+    std::vector<std::unique_ptr<fles::TimesliceSource>> sources;
+    sources.emplace_back(
+        std::make_unique<fles::TimesliceInputArchiveSequence>("test2_%n.tsa"));
+    sources.emplace_back(
+        std::make_unique<fles::TimesliceInputArchive>("example1.tsa"));
+    fles::MergingSource<fles::TimesliceSource> merging_source{
+        std::move(sources), order, 2};
+    uint64_t count = 0;
+    uint64_t last = 0;
+    while (auto timeslice = merging_source.get()) {
+      uint64_t key = order == fles::MergeOrder::Index ? timeslice->index()
+                                                      : timeslice->start_time();
+      BOOST_CHECK_GE(key, last);
+      last = key;
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 8);
+    BOOST_CHECK(merging_source.eos());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(merging_round_robin_test) {
+  for (std::size_t prefetch : {0, 1}) {
+    std::vector<std::unique_ptr<fles::TimesliceSource>> sources;
+    sources.emplace_back(
+        std::make_unique<fles::TimesliceInputArchiveSequence>("test2_%n.tsa"));
+    sources.emplace_back(
+        std::make_unique<fles::TimesliceInputArchive>("example1.tsa"));
+    fles::MergingSource<fles::TimesliceSource> merging_source{
+        std::move(sources), fles::MergeOrder::RoundRobin, prefetch};
+    std::vector<uint64_t> index;
+    while (auto timeslice = merging_source.get()) {
+      index.push_back(timeslice->index());
+    }
+    BOOST_REQUIRE_EQUAL(index.size(), 8);
+    // the second input is exhausted after two turns
+    fles::TimesliceInputArchive reference("example1.tsa");
+    BOOST_CHECK_EQUAL(index[1], reference.get()->index());
+    BOOST_CHECK_EQUAL(index[3], reference.get()->index());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(merging_prefetch_destruct_test) {
+  std::vector<std::unique_ptr<fles::TimesliceSource>> sources;
+  sources.emplace_back(
+      std::make_unique<fles::TimesliceInputArchiveSequence>("test2_%n.tsa"));
+  sources.emplace_back(
+      std::make_unique<fles::TimesliceInputArchive>("example1.tsa"));
+  fles::MergingSource<fles::TimesliceSource> merging_source{
+      std::move(sources), fles::MergeOrder::Index, 1};
+  BOOST_CHECK(merging_source.get());
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_archive_index_test) {
+  {
+    fles::TimesliceOutputArchive sink("test_index.tsa");
+    for (uint64_t i = 0; i < 5; ++i) {
+      auto ts = std::make_shared<fles::StorableTimeslice>(1, i);
+      uint32_t c = ts->append_component(1);
+      fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+      desc.idx = 100 * i;
+      desc.size = 1;
+      uint8_t content = static_cast<uint8_t>(i);
+      ts->append_microslice(c, 0, desc, &content);
+      sink.put(ts);
+    }
+  }
+
+  fles::TimesliceInputArchive source("test_index.tsa");
+  BOOST_REQUIRE(source.has_index());
+  BOOST_CHECK_EQUAL(source.index().size(), 5);
+
+  BOOST_REQUIRE(source.seek(3));
+  auto ts = source.get();
+  BOOST_REQUIRE(ts);
+  BOOST_CHECK_EQUAL(ts->index(), 3);
+  ts = source.get();
+  BOOST_REQUIRE(ts);
+  BOOST_CHECK_EQUAL(ts->index(), 4);
+
+  BOOST_REQUIRE(source.seek(1));
+  ts = source.get();
+  BOOST_REQUIRE(ts);
+  BOOST_CHECK_EQUAL(ts->index(), 1);
+
+  BOOST_REQUIRE(source.seek_time(250));
+  ts = source.get();
+  BOOST_REQUIRE(ts);
+  BOOST_CHECK_EQUAL(ts->start_time(), 300);
+
+  BOOST_REQUIRE(source.seek(0));
+  ts = source.get();
+  BOOST_REQUIRE(ts);
+  BOOST_CHECK_EQUAL(ts->index(), 0);
+
+  BOOST_CHECK(!source.seek(5));
+  BOOST_CHECK(!source.seek_time(401));
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_raw_archive_test) {
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::TimesliceRawOutputArchive sink("test_raw.tsr");
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+
+  fles::TimesliceInputArchive reference("example1.tsa");
+  fles::TimesliceMappedArchive source("test_raw.tsr");
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_CHECK_EQUAL(ts->index(), ref->index());
+    BOOST_CHECK_EQUAL(ts->num_core_microslices(), ref->num_core_microslices());
+    BOOST_REQUIRE_EQUAL(ts->num_components(), ref->num_components());
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      BOOST_REQUIRE_EQUAL(ts->num_microslices(c), ref->num_microslices(c));
+      BOOST_CHECK_EQUAL(ts->size_component(c), ref->size_component(c));
+      for (uint64_t m = 0; m < ts->num_microslices(c); ++m) {
+        BOOST_CHECK_EQUAL(ts->descriptor(c, m).idx, ref->descriptor(c, m).idx);
+        BOOST_CHECK(std::equal(ts->content(c, m),
+                               ts->content(c, m) + ts->descriptor(c, m).size,
+                               ref->content(c, m)));
+      }
+    }
+    ++count;
+  }
+  BOOST_CHECK(source.eos());
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(output_file_buffer_test) {
+  const std::string data(10000, 'x');
+  {
+    fles::OutputFileBuffer filebuf("test_filebuf.dat");
+    filebuf.preallocate(64 * 1024 * 1024);
+    std::ostream os(&filebuf);
+    os.write(data.data(), static_cast<std::streamsize>(data.size()));
+    BOOST_CHECK_EQUAL(os.tellp(), data.size());
+    filebuf.close();
+  }
+
+  // the preallocated space beyond the data is released on close
+  struct stat st {};
+  BOOST_REQUIRE_EQUAL(::stat("test_filebuf.dat", &st), 0);
+  BOOST_CHECK_EQUAL(st.st_size, data.size());
+  BOOST_CHECK_LT(st.st_blocks * 512, 1024 * 1024);
+
+  // a raw archive written with direct I/O (where supported) is identical
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::TimesliceRawOutputArchive sink("test_raw_direct.tsr", false, true);
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+  std::ifstream a("test_raw.tsr", std::ios::binary);
+  std::ifstream b("test_raw_direct.tsr", std::ios::binary);
+  BOOST_CHECK(std::equal(std::istreambuf_iterator<char>(a),
+                         std::istreambuf_iterator<char>(),
+                         std::istreambuf_iterator<char>(b),
+                         std::istreambuf_iterator<char>()));
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_raw_archive_corrupt_test) {
+  // test_raw.tsr is written by timeslice_raw_archive_test
+  std::ifstream in("test_raw.tsr", std::ios::binary);
+  std::vector<char> file((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  const uint64_t record = fles::raw_archive_align(
+      sizeof(fles::RawArchiveFileHeader));
+  const uint64_t desc =
+      record + fles::raw_archive_align(sizeof(fles::RawArchiveRecordHeader));
+  BOOST_REQUIRE_GT(file.size(),
+                   desc + sizeof(fles::TimesliceComponentDescriptor));
+
+  auto write = [&](const std::vector<char>& data) {
+    std::ofstream out("test_raw_corrupt.tsr", std::ios::binary);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  };
+  auto component = [&](std::vector<char>& data) {
+    return reinterpret_cast<fles::TimesliceComponentDescriptor*>(
+        data.data() + desc);
+  };
+
+  // component data beyond the end of the record
+  std::vector<char> bad_offset = file;
+  component(bad_offset)->offset = file.size();
+  write(bad_offset);
+  {
+    fles::TimesliceMappedArchive source("test_raw_corrupt.tsr");
+    BOOST_CHECK_THROW(source.get(), std::runtime_error);
+  }
+
+  // more microslice descriptors than fit into the component
+  std::vector<char> bad_count = file;
+  component(bad_count)->num_microslices = file.size();
+  write(bad_count);
+  {
+    fles::TimesliceMappedArchive source("test_raw_corrupt.tsr");
+    uint64_t index = 0;
+    uint64_t start_time = 0;
+    BOOST_CHECK_THROW(source.peek(index, start_time), std::runtime_error);
+  }
+
+  // microslice content beyond the end of the file
+  std::vector<char> bad_content = file;
+  auto* ms = reinterpret_cast<fles::MicrosliceDescriptor*>(
+      bad_content.data() + record + component(bad_content)->offset);
+  ms->size = UINT32_MAX;
+  write(bad_content);
+  {
+    fles::TimesliceMappedArchive source("test_raw_corrupt.tsr");
+    BOOST_CHECK_THROW(source.get(), std::runtime_error);
+  }
+
+  // truncated file
+  write(std::vector<char>(file.begin(), file.end() - 1));
+  {
+    fles::TimesliceMappedArchive source("test_raw_corrupt.tsr");
+    BOOST_CHECK_THROW(
+        while (source.get()) {}, std::runtime_error);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(descriptor_column_archive_test) {
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::DescriptorColumnOutputArchive sink("test_columns.tsc", 1);
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+
+  // one block per timeslice with the core microslice descriptors
+  fles::TimesliceInputArchive reference("example1.tsa");
+  fles::DescriptorColumnInputArchive source("test_columns.tsc");
+  fles::DescriptorColumnBlock block;
+  uint64_t count = 0;
+  while (source.read(block)) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_CHECK_EQUAL(block.first_index, ref->index());
+    BOOST_CHECK_EQUAL(block.num_timeslices, 1);
+    BOOST_REQUIRE_EQUAL(block.components.size(), ref->num_components());
+    for (uint64_t c = 0; c < ref->num_components(); ++c) {
+      const auto& desc = block.components[c];
+      BOOST_REQUIRE_EQUAL(desc.size(), std::min(ref->num_microslices(c),
+                                                ref->num_core_microslices()));
+      for (uint64_t m = 0; m < desc.size(); ++m) {
+        BOOST_CHECK(std::memcmp(&desc[m], &ref->descriptor(c, m),
+                                sizeof(fles::MicrosliceDescriptor)) == 0);
+      }
+    }
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 2);
+
+  BOOST_CHECK_THROW(fles::DescriptorColumnInputArchive("example1.tsa"),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_raw_archive_selection_test) {
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::TimesliceRawOutputArchive sink("test_raw_selection.tsr");
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+
+  fles::ComponentSelection selection;
+  selection.add_component(1);
+  fles::ComponentSelectingSource reference(
+      std::make_unique<fles::TimesliceInputArchive>("example1.tsa"),
+      selection);
+  fles::TimesliceMappedArchive source("test_raw_selection.tsr", selection);
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_REQUIRE_EQUAL(ts->num_components(), 1);
+    BOOST_REQUIRE_EQUAL(ref->num_components(), 1);
+    BOOST_CHECK_EQUAL(ts->size_component(0), ref->size_component(0));
+    BOOST_CHECK_EQUAL(ts->descriptor(0, 0).eq_id, ref->descriptor(0, 0).eq_id);
+    ++count;
+  }
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_raw_archive_dedup_test) {
+  // timeslices of 2 core and 1 overlap microslices, index 3 is missing
+  auto make_timeslice = [](uint64_t index) {
+    auto ts = std::make_shared<fles::StorableTimeslice>(2, index);
+    for (uint16_t c = 0; c < 2; ++c) {
+      ts->append_component(3);
+      for (uint64_t m = 0; m < 3; ++m) {
+        uint64_t idx = index * 2 + m;
+        std::vector<uint8_t> content(128, static_cast<uint8_t>(idx + c));
+        fles::MicrosliceDescriptor desc{};
+        desc.eq_id = c;
+        desc.idx = idx;
+        desc.size = static_cast<uint32_t>(content.size());
+        ts->append_microslice(c, m, desc, content.data());
+      }
+    }
+    return ts;
+  };
+  std::vector<std::shared_ptr<fles::StorableTimeslice>> timeslices;
+  for (uint64_t index : {0, 1, 2, 4}) {
+    timeslices.push_back(make_timeslice(index));
+  }
+
+  for (bool dedup : {false, true}) {
+    fles::TimesliceRawOutputArchive sink(dedup ? "test_dedup.tsr"
+                                               : "test_nodedup.tsr",
+                                         dedup);
+    for (const auto& ts : timeslices) {
+      sink.put(ts);
+    }
+  }
+
+  fles::TimesliceMappedArchive source("test_dedup.tsr");
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    BOOST_REQUIRE_LT(count, timeslices.size());
+    const auto& ref = timeslices[count];
+    BOOST_CHECK_EQUAL(ts->index(), ref->index());
+    BOOST_REQUIRE_EQUAL(ts->num_components(), ref->num_components());
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      BOOST_REQUIRE_EQUAL(ts->num_microslices(c), ref->num_microslices(c));
+      BOOST_CHECK_EQUAL(ts->size_component(c), ref->size_component(c));
+      for (uint64_t m = 0; m < ts->num_microslices(c); ++m) {
+        BOOST_CHECK_EQUAL(ts->descriptor(c, m).idx, ref->descriptor(c, m).idx);
+        BOOST_CHECK(std::equal(ts->content(c, m),
+                               ts->content(c, m) + ts->descriptor(c, m).size,
+                               ref->content(c, m)));
+      }
+    }
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, timeslices.size());
+
+  // the overlap of the timeslices 0 and 1 is stored only once
+  std::ifstream plain("test_nodedup.tsr", std::ios::ate);
+  std::ifstream dedup("test_dedup.tsr", std::ios::ate);
+  BOOST_CHECK_EQUAL(plain.tellg() - dedup.tellg(), 2 * 2 * 128);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_compressed_archive_test) {
+  if (!fles::archive_compression_supported(fles::ArchiveCompression::Zstd)) {
+    BOOST_CHECK_THROW(fles::TimesliceOutputArchive(
+                          "test_zstd.tsa", fles::ArchiveCompression::Zstd),
+                      std::runtime_error);
+    return;
+  }
+
+  {
+    fles::TimesliceInputArchiveLoop source("example1.tsa", 20);
+    fles::TimesliceOutputArchive sink("test_zstd.tsa",
+                                      fles::ArchiveCompression::Zstd);
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+
+  fles::TimesliceInputArchiveLoop reference("example1.tsa", 20);
+  fles::TimesliceInputArchive source("test_zstd.tsa");
+  BOOST_CHECK(source.descriptor().archive_compression() ==
+              fles::ArchiveCompression::Zstd);
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_CHECK_EQUAL(ts->index(), ref->index());
+    BOOST_REQUIRE_EQUAL(ts->num_components(), ref->num_components());
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      BOOST_REQUIRE_EQUAL(ts->size_component(c), ref->size_component(c));
+      BOOST_CHECK(std::equal(ts->content(c, 0),
+                             ts->content(c, 0) + ts->size_component(c) -
+                                 ts->num_microslices(c) *
+                                     sizeof(fles::MicrosliceDescriptor),
+                             ref->content(c, 0)));
+    }
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 40);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_compressed_archive_dictionary_test) {
+  // samples of a common structure with varying payload
+  std::vector<std::string> samples;
+  uint32_t x = 1;
+  for (int i = 0; i < 1000; ++i) {
+    std::string sample = "HEADER" + std::to_string(i % 16) + ":";
+    for (int j = 0; j < 64; ++j) {
+      x = x * 1103515245 + 12345;
+      sample += "word" + std::to_string((x >> 16) % 32) + ",";
+    }
+    samples.push_back(sample);
+  }
+
+  if (!fles::archive_compression_supported(fles::ArchiveCompression::Zstd)) {
+    BOOST_CHECK_THROW(fles::train_compression_dictionary(samples),
+                      std::runtime_error);
+    return;
+  }
+
+  std::string dictionary = fles::train_compression_dictionary(samples, 4096);
+  BOOST_CHECK(!dictionary.empty());
+  BOOST_CHECK_LE(dictionary.size(), 4096);
+
+  {
+    fles::TimesliceInputArchiveLoop source("example1.tsa", 4);
+    fles::TimesliceOutputArchive sink(
+        "test_zstd_dict.tsa", fles::ArchiveCompression::Zstd, dictionary);
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+
+  fles::TimesliceInputArchiveLoop reference("example1.tsa", 4);
+  fles::TimesliceInputArchive source("test_zstd_dict.tsa");
+  BOOST_CHECK(source.descriptor().compression_dictionary() == dictionary);
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_CHECK_EQUAL(ts->index(), ref->index());
+    BOOST_REQUIRE_EQUAL(ts->num_components(), ref->num_components());
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      BOOST_REQUIRE_EQUAL(ts->size_component(c), ref->size_component(c));
+      BOOST_CHECK(std::equal(ts->content(c, 0),
+                             ts->content(c, 0) + ts->size_component(c) -
+                                 ts->num_microslices(c) *
+                                     sizeof(fles::MicrosliceDescriptor),
+                             ref->content(c, 0)));
+    }
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 8);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_compressed_archive_verify_test) {
+  if (!fles::archive_compression_supported(fles::ArchiveCompression::Zstd)) {
+    BOOST_CHECK_THROW(fles::verify_archive_blocks("example1.tsa", 2),
+                      std::runtime_error);
+    return;
+  }
+
+  {
+    fles::TimesliceInputArchiveLoop source("example1.tsa", 20);
+    fles::TimesliceOutputArchive sink("test_zstd_verify.tsa",
+                                      fles::ArchiveCompression::Zstd);
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+
+  fles::BlockVerification result =
+      fles::verify_archive_blocks("test_zstd_verify.tsa", 2);
+  BOOST_CHECK_EQUAL(result.blocks, 3);
+  BOOST_CHECK_EQUAL(result.corrupt, 0);
+  BOOST_CHECK_EQUAL(result.unchecked, 0);
+
+  // flip the last byte of the last block
+  {
+    std::fstream f("test_zstd_verify.tsa",
+                   std::ios::in | std::ios::out | std::ios::binary);
+    f.seekg(-1, std::ios::end);
+    char c = 0;
+    f.get(c);
+    f.seekp(-1, std::ios::end);
+    f.put(static_cast<char>(c ^ 1));
+  }
+
+  result = fles::verify_archive_blocks("test_zstd_verify.tsa", 2);
+  BOOST_CHECK_EQUAL(result.blocks, 3);
+  BOOST_CHECK_EQUAL(result.corrupt, 1);
+
+  fles::TimesliceInputArchive source("test_zstd_verify.tsa");
+  BOOST_CHECK_THROW(
+      while (source.get()) {}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_compressed_archive_block_size_test) {
+  if (!fles::archive_compression_supported(fles::ArchiveCompression::Zstd)) {
+    return;
+  }
+
+  {
+    fles::TimesliceInputArchiveLoop source("example1.tsa", 20);
+    fles::TimesliceOutputArchive sink("test_zstd_size.tsa",
+                                      fles::ArchiveCompression::Zstd);
+    while (auto timeslice = source.get()) {
+      std::shared_ptr<const fles::Timeslice> ts(std::move(timeslice));
+      sink.put(ts);
+    }
+  }
+
+  // claim a first block larger than the file
+  {
+    std::fstream f("test_zstd_size.tsa",
+                   std::ios::in | std::ios::out | std::ios::binary);
+    {
+      boost::archive::binary_iarchive ia(f);
+      fles::ArchiveDescriptor descriptor(fles::ArchiveType::TimesliceArchive);
+      ia >> descriptor;
+    }
+    std::streampos block = f.tellg();
+    fles::ArchiveBlockHeader header{};
+    f.read(reinterpret_cast<char*>(&header), sizeof(header));
+    header.compressed_size = uint64_t{1} << 50;
+    f.seekp(block);
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+
+  BOOST_CHECK_THROW(fles::verify_archive_blocks("test_zstd_size.tsa", 2),
+                    std::runtime_error);
+  fles::TimesliceInputArchive source("test_zstd_size.tsa");
+  BOOST_CHECK_THROW(
+      while (source.get()) {}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_replay_archive_test) {
+  fles::TimesliceReplayArchive source("example1.tsa", 3);
+  BOOST_CHECK_EQUAL(source.size(), 2);
+  BOOST_CHECK_GT(source.memory_size(), 0);
+
+  fles::TimesliceInputArchiveLoop reference("example1.tsa", 3);
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    auto ref = reference.get();
+    BOOST_REQUIRE(ref);
+    BOOST_CHECK_EQUAL(ts->index(), ref->index());
+    BOOST_CHECK_EQUAL(ts->num_core_microslices(), ref->num_core_microslices());
+    BOOST_REQUIRE_EQUAL(ts->num_components(), ref->num_components());
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      BOOST_REQUIRE_EQUAL(ts->num_microslices(c), ref->num_microslices(c));
+      BOOST_CHECK_EQUAL(ts->size_component(c), ref->size_component(c));
+      for (uint64_t m = 0; m < ts->num_microslices(c); ++m) {
+        BOOST_CHECK_EQUAL(ts->descriptor(c, m).idx, ref->descriptor(c, m).idx);
+        BOOST_CHECK(std::equal(ts->content(c, m),
+                               ts->content(c, m) + ts->descriptor(c, m).size,
+                               ref->content(c, m)));
+      }
+    }
+    ++count;
+  }
+  BOOST_CHECK(source.eos());
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, 6);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_replay_archive_continuous_test) {
+  std::vector<std::unique_ptr<fles::Timeslice>> reference;
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    while (auto ts = source.get()) {
+      reference.push_back(std::move(ts));
+    }
+  }
+  BOOST_REQUIRE_EQUAL(reference.size(), 2);
+  const uint64_t index_span =
+      2 * (reference[1]->index() - reference[0]->index());
+  const uint64_t idx_span =
+      2 * (reference[1]->start_time() - reference[0]->start_time());
+
+  fles::TimesliceReplayArchive source("example1.tsa", 3, true);
+  // keep a timeslice of the first cycle, its record is copied in the next
+  auto held = source.get();
+  uint64_t count = 1;
+  while (auto ts = source.get()) {
+    const uint64_t cycle = count / 2;
+    const auto& ref = *reference[count % 2];
+    BOOST_CHECK_EQUAL(ts->index(), ref.index() + cycle * index_span);
+    BOOST_CHECK_EQUAL(ts->start_time(), ref.start_time() + cycle * idx_span);
+    BOOST_REQUIRE_EQUAL(ts->num_components(), ref.num_components());
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      BOOST_REQUIRE_EQUAL(ts->num_microslices(c), ref.num_microslices(c));
+      for (uint64_t m = 0; m < ts->num_microslices(c); ++m) {
+        BOOST_CHECK_EQUAL(ts->descriptor(c, m).idx,
+                          ref.descriptor(c, m).idx + cycle * idx_span);
+        BOOST_CHECK(std::equal(ts->content(c, m),
+                               ts->content(c, m) + ts->descriptor(c, m).size,
+                               ref.content(c, m)));
+      }
+    }
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 6);
+  // the held timeslice is unchanged
+  BOOST_CHECK_EQUAL(held->index(), reference[0]->index());
+  BOOST_CHECK_EQUAL(held->start_time(), reference[0]->start_time());
+}
+
+BOOST_AUTO_TEST_CASE(input_file_buffer_test) {
+  std::vector<char> data(3 * 4096 + 123);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i * 7);
+  }
+  {
+    std::ofstream ofs("test_input_buffer.dat", std::ios::binary);
+    ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+
+  // small buffers to cross block boundaries
+  fles::InputFileBuffer buffer("test_input_buffer.dat", 4096, 2, true);
+  std::istream is(&buffer);
+  std::vector<char> read(data.size() + 1);
+  is.read(read.data(), static_cast<std::streamsize>(read.size()));
+  BOOST_CHECK_EQUAL(static_cast<std::size_t>(is.gcount()), data.size());
+  BOOST_CHECK(std::equal(data.begin(), data.end(), read.begin()));
+
+  for (std::size_t pos : {5000, 100, 4096, 12300}) {
+    is.clear();
+    is.seekg(static_cast<std::streamoff>(pos));
+    BOOST_CHECK_EQUAL(static_cast<std::size_t>(is.tellg()), pos);
+    is.read(read.data(), 100);
+    BOOST_CHECK_EQUAL(static_cast<std::size_t>(is.gcount()),
+                      std::min<std::size_t>(100, data.size() - pos));
+    BOOST_CHECK(std::equal(read.begin(), read.begin() + is.gcount(),
+                           data.begin() + static_cast<std::ptrdiff_t>(pos)));
+  }
+
+  BOOST_CHECK_THROW(fles::InputFileBuffer("nonexistent.dat"),
+                    std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_striped_archive_test) {
+  {
+    fles::TimesliceStripedOutputArchive sink("test_striped.tss", {".", "."});
+    BOOST_CHECK_EQUAL(sink.size(), 2);
+    for (uint64_t i = 0; i < 5; ++i) {
+      auto ts = std::make_shared<fles::StorableTimeslice>(1, i);
+      uint32_t c = ts->append_component(1);
+      fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+      desc.idx = 100 * i;
+      desc.size = 1;
+      uint8_t content = static_cast<uint8_t>(i);
+      ts->append_microslice(c, 0, desc, &content);
+      sink.put(ts);
+    }
+    sink.end_stream();
+  }
+
+  auto stripes = fles::read_stripe_manifest("test_striped.tss");
+  BOOST_REQUIRE_EQUAL(stripes.size(), 2);
+  BOOST_CHECK(boost::algorithm::ends_with(stripes[1], "test_striped_s1.tsa"));
+  {
+    // stripe 1 holds every second timeslice
+    fles::TimesliceInputArchive stripe(stripes[1]);
+    BOOST_CHECK_EQUAL(stripe.get()->index(), 1);
+    BOOST_CHECK_EQUAL(stripe.get()->index(), 3);
+    BOOST_CHECK(!stripe.get());
+  }
+
+  fles::TimesliceAutoSource source("test_striped.tss?prefetch=2");
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    BOOST_CHECK_EQUAL(ts->index(), count);
+    BOOST_CHECK_EQUAL(*ts->content(0, 0), count);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 5);
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_archive_catalog_test) {
+  std::remove("test_catalog.cat");
+  {
+    fles::TimesliceOutputArchiveSequence sink(
+        "test_catalog_%n.tsa", 2, SIZE_MAX, fles::ArchiveCompression::None,
+        false, {}, "test_catalog.cat");
+    for (uint64_t i = 0; i < 5; ++i) {
+      auto ts = std::make_shared<fles::StorableTimeslice>(1, i);
+      uint32_t c = ts->append_component(1);
+      fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+      desc.idx = 100 * i;
+      desc.size = 1;
+      uint8_t content = static_cast<uint8_t>(i);
+      ts->append_microslice(c, 0, desc, &content);
+      sink.put(ts);
+    }
+    sink.end_stream();
+  }
+
+  fles::ArchiveCatalog catalog;
+  catalog.load("test_catalog.cat");
+  BOOST_REQUIRE_EQUAL(catalog.entries().size(), 3);
+  const auto& entry = catalog.entries()[1];
+  BOOST_CHECK(boost::algorithm::ends_with(entry.filename,
+                                          "test_catalog_0001.tsa"));
+  BOOST_CHECK_EQUAL(entry.first_index, 2);
+  BOOST_CHECK_EQUAL(entry.last_index, 3);
+  BOOST_CHECK_EQUAL(entry.first_time, 200);
+  BOOST_CHECK_EQUAL(entry.last_time, 300);
+  BOOST_CHECK_EQUAL(entry.count, 2);
+  BOOST_CHECK_GT(entry.size, 0);
+
+  auto found = catalog.find_time(300, 450);
+  BOOST_REQUIRE_EQUAL(found.size(), 2);
+  BOOST_CHECK_EQUAL(found[0].first_index, 2);
+  BOOST_CHECK_EQUAL(found[1].first_index, 4);
+
+  fles::TimesliceRangeArchive range(found[0].filename, 300, 450);
+  auto ts = range.get();
+  BOOST_REQUIRE(ts);
+  BOOST_CHECK_EQUAL(ts->index(), 3);
+  BOOST_CHECK(!range.get());
+
+  fles::TimesliceAutoSource source("test_catalog.cat?from=100&to=400");
+  std::vector<uint64_t> index;
+  while (auto timeslice = source.get()) {
+    index.push_back(timeslice->index());
+  }
+  std::vector<uint64_t> expected{1, 2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.begin(), index.end(), expected.begin(),
+                                expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(timeslice_range_archive_test) {
+  std::remove("test_range.cat");
+  {
+    fles::TimesliceOutputArchiveSequence sink(
+        "test_range_%n.tsa", 3, SIZE_MAX, fles::ArchiveCompression::None,
+        false, {}, "test_range.cat");
+    fles::TimesliceRawOutputArchive raw_sink("test_range.tsr");
+    for (uint64_t i = 0; i < 6; ++i) {
+      auto ts = std::make_shared<fles::StorableTimeslice>(1, i);
+      for (uint16_t eq_id = 0; eq_id < 2; ++eq_id) {
+        uint32_t c = ts->append_component(1);
+        fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+        desc.eq_id = eq_id;
+        desc.idx = 100 * i;
+        desc.size = 1;
+        uint8_t content = static_cast<uint8_t>(i);
+        ts->append_microslice(c, 0, desc, &content);
+      }
+      sink.put(ts);
+      raw_sink.put(ts);
+    }
+    sink.end_stream();
+    raw_sink.end_stream();
+  }
+
+  fles::ArchiveCatalog catalog;
+  catalog.load("test_range.cat");
+  auto found = catalog.find_index(2, 4);
+  BOOST_REQUIRE_EQUAL(found.size(), 2);
+  BOOST_CHECK_EQUAL(found[0].first_index, 0);
+  BOOST_CHECK_EQUAL(found[1].first_index, 3);
+
+  fles::ComponentSelection selection;
+  selection.add_eq_id(1);
+  for (const std::string& filename :
+       {found[0].filename, found[1].filename, std::string("test_range.tsr")}) {
+    fles::TimesliceRangeArchive range(filename, 2, 4, selection,
+                                      fles::RangeKey::Index);
+    while (auto ts = range.get()) {
+      BOOST_CHECK(ts->index() == 2 || ts->index() == 3);
+      BOOST_REQUIRE_EQUAL(ts->num_components(), 1);
+      BOOST_CHECK_EQUAL(ts->descriptor(0, 0).eq_id, 1);
+      BOOST_CHECK_EQUAL(ts->start_time(), 100 * ts->index());
+    }
+    BOOST_CHECK(range.eos());
+  }
+
+  fles::TimesliceRangeArchive range("test_range.tsr", 150, 450);
+  std::vector<uint64_t> index;
+  while (auto ts = range.get()) {
+    BOOST_CHECK_EQUAL(ts->num_components(), 2);
+    index.push_back(ts->index());
+  }
+  std::vector<uint64_t> expected{2, 3, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(index.begin(), index.end(), expected.begin(),
+                                expected.end());
+
+  fles::TimesliceAutoSource source("test_range.tsr?from=150&to=450&eq_id=0");
+  uint64_t count = 0;
+  while (auto ts = source.get()) {
+    BOOST_CHECK_EQUAL(ts->num_components(), 1);
+    BOOST_CHECK_EQUAL(ts->descriptor(0, 0).eq_id, 0);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 3);
+}
@@ -0,0 +1,75 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_AsyncSink
+#include <boost/test/unit_test.hpp>
+
+#include "AsyncSink.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Sink recording its items, held back until opened
+class GateSink : public fles::Sink<int> {
+public:
+  explicit GateSink(std::vector<int>& items) : items_(items) {}
+
+  void put(std::shared_ptr<const int> item) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return open_; });
+    items_.push_back(*item);
+  }
+
+  void open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    cond_.notify_all();
+  }
+
+private:
+  std::vector<int>& items_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool open_ = false;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(drop_test) {
+  std::vector<int> items;
+  auto gate_sink = std::make_unique<GateSink>(items);
+  GateSink& gate = *gate_sink;
+  fles::AsyncSink<int> sink(std::move(gate_sink), 2,
+                            fles::OverflowPolicy::Drop);
+
+  // the worker holds at most one item, the queue two, the rest is dropped
+  for (int i = 0; i < 10; ++i) {
+    sink.put(std::make_shared<const int>(i));
+  }
+  BOOST_CHECK_GE(sink.dropped(), 7);
+  BOOST_CHECK_LE(sink.dropped(), 8);
+
+  gate.open();
+  sink.end_stream();
+  BOOST_CHECK_EQUAL(items.size() + sink.dropped(), 10);
+  BOOST_CHECK_EQUAL(items.front(), 0);
+
+  auto latency = sink.latency();
+  BOOST_CHECK_EQUAL(latency.count, items.size());
+  BOOST_CHECK(latency.max <= latency.sum);
+  BOOST_CHECK_EQUAL(sink.latency().count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(block_test) {
+  std::vector<int> items;
+  auto gate_sink = std::make_unique<GateSink>(items);
+  gate_sink->open();
+  fles::AsyncSink<int> sink(std::move(gate_sink), 1);
+  for (int i = 0; i < 100; ++i) {
+    sink.put(std::make_shared<const int>(i));
+  }
+  sink.end_stream();
+  BOOST_CHECK_EQUAL(items.size(), 100);
+  BOOST_CHECK_EQUAL(sink.dropped(), 0);
+}
@@ -0,0 +1,43 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_BlockDigest
+#include <boost/test/unit_test.hpp>
+
+#include "BlockDigest.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> make_data() {
+  std::vector<uint8_t> data(1024);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  return data;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(reference_test) {
+  // reference values of XXH64
+  BOOST_CHECK_EQUAL(fles::block_digest("", 0), 0xEF46DB3751D8E999);
+  BOOST_CHECK_EQUAL(fles::block_digest("abc", 3), 0x44BC2CF5AD770999);
+
+  std::vector<uint8_t> data = make_data();
+  BOOST_CHECK_EQUAL(fles::block_digest(data.data(), data.size()),
+                    0x6F3914F18FE4DF57);
+  BOOST_CHECK_EQUAL(fles::block_digest(data.data(), data.size(), 42),
+                    0x4CB9B11211D5B1A0);
+  BOOST_CHECK_EQUAL(fles::block_digest(data.data(), 37), 0xD93FA2DFEE5C24C9);
+}
+
+BOOST_AUTO_TEST_CASE(sensitivity_test) {
+  std::vector<uint8_t> data = make_data();
+  uint64_t digest = fles::block_digest(data.data(), data.size());
+  for (std::size_t i : {0, 31, 32, 1000, 1023}) {
+    data[i] ^= 1;
+    BOOST_CHECK_NE(fles::block_digest(data.data(), data.size()), digest);
+    data[i] ^= 1;
+  }
+  BOOST_CHECK_NE(fles::block_digest(data.data(), data.size() - 1), digest);
+}
@@ -0,0 +1,46 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_BufferSizing
+#include <boost/test/unit_test.hpp>
+
+#include "BufferSizing.hpp"
+#include <cstdio>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(default_ratio_test) {
+  // 128 MiB + 2^19 descriptors of 16 bytes = 136 MiB
+  BufferSize s = BufferSizing::fit(UINT64_C(136) << 20, 0, 16);
+  BOOST_CHECK_EQUAL(s.datasize, 27);
+  BOOST_CHECK_EQUAL(s.descsize, 19);
+  s = BufferSizing::fit((UINT64_C(136) << 20) - 1, 0, 16);
+  BOOST_CHECK_EQUAL(s.datasize, 26);
+  BOOST_CHECK_EQUAL(s.descsize, 18);
+}
+
+BOOST_AUTO_TEST_CASE(mean_entry_size_test) {
+  // 1 GiB of 1 MiB components: twice 1024 entries
+  BufferSize s = BufferSizing::fit(UINT64_C(3) << 29, 1 << 20, 32);
+  BOOST_CHECK_EQUAL(s.datasize, 30);
+  BOOST_CHECK_EQUAL(s.descsize, 11);
+  // entries larger than the buffer
+  s = BufferSizing::fit(UINT64_C(1) << 21, 1 << 24, 32);
+  BOOST_CHECK_EQUAL(s.datasize, 20);
+  BOOST_CHECK_EQUAL(s.descsize, 1);
+}
+
+BOOST_AUTO_TEST_CASE(insufficient_budget_test) {
+  BOOST_CHECK_THROW(BufferSizing::fit(UINT64_C(1) << 19, 0, 16),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(record_test) {
+  const std::string path = "test_BufferSizing.record";
+  std::remove(path.c_str());
+  BOOST_CHECK(BufferSizing::read_record(path).empty());
+  BufferSizing::update_record(path, {{"output0", 1048576}, {"output1", 5}});
+  BufferSizing::update_record(path, {{"output1", 2.5}});
+  auto record = BufferSizing::read_record(path);
+  BOOST_REQUIRE_EQUAL(record.size(), 2);
+  BOOST_CHECK_EQUAL(record.at("output0"), 1048576);
+  BOOST_CHECK_EQUAL(record.at("output1"), 2.5);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,86 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_BufferStatusSampler
+#include <boost/test/unit_test.hpp>
+
+#include "BufferStatusSampler.hpp"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(instance_test) {
+  cbm::Monitor monitor;
+  BOOST_CHECK(BufferStatusSampler::instance() == nullptr);
+  {
+    BufferStatusSampler sampler(monitor, 1ms);
+    BOOST_CHECK(BufferStatusSampler::instance() == &sampler);
+    BOOST_CHECK_THROW(BufferStatusSampler(monitor, 1ms), std::runtime_error);
+  }
+  BOOST_CHECK(BufferStatusSampler::instance() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(sample_test) {
+  auto path = boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("test_BSS_%%%%-%%%%.txt");
+  {
+    cbm::Monitor monitor("file:" + path.string());
+    BufferStatusSampler sampler(monitor, 1ms);
+    auto source = sampler.add_source("send_buffer_fill", {{"input", "0"}},
+                                     1000, 100);
+    // desc: 10% free..freeing, 20% sending, 30% used, 40% free
+    source->desc.publish(1000, 1100, 1300, 1600);
+    // data: inconsistent positions are clamped, all free
+    source->data.publish(500, 400, 300, 200);
+    BOOST_CHECK_EQUAL(source.use_count(), 2);
+    while (sampler.samples() < 5) {
+      std::this_thread::sleep_for(1ms);
+    }
+    // removed once released
+    source.reset();
+    std::this_thread::sleep_for(20ms);
+    uint64_t samples = sampler.samples();
+    std::this_thread::sleep_for(20ms);
+    BOOST_CHECK_EQUAL(sampler.samples(), samples);
+  }
+
+  std::ifstream ifs(path.string());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  std::string out = ss.str();
+  boost::filesystem::remove(path);
+
+  BOOST_CHECK(out.find("send_buffer_fill,input=0 ") != std::string::npos);
+  BOOST_CHECK(out.find("desc_used_pct_max=30i") != std::string::npos);
+  BOOST_CHECK(out.find("desc_sending_pct_max=20i") != std::string::npos);
+  BOOST_CHECK(out.find("desc_freeing_pct_max=10i") != std::string::npos);
+  BOOST_CHECK(out.find("desc_free_pct_max=40i") != std::string::npos);
+  BOOST_CHECK(out.find("data_used_pct_count=") != std::string::npos);
+  BOOST_CHECK(out.find("data_free_pct_max=100i") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(receive_buffer_test) {
+  auto path = boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("test_BSS_%%%%-%%%%.txt");
+  {
+    cbm::Monitor monitor("file:" + path.string());
+    BufferStatusSampler sampler(monitor, 1ms);
+    auto source = sampler.add_source("recv_buffer_fill", {{"input", "0"}},
+                                     100, 100, false);
+    source->desc.publish(0, 50, 50, 75);
+    while (sampler.samples() < 1) {
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+
+  std::ifstream ifs(path.string());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  std::string out = ss.str();
+  boost::filesystem::remove(path);
+
+  BOOST_CHECK(out.find("desc_used_pct_max=25i") != std::string::npos);
+  BOOST_CHECK(out.find("sending") == std::string::npos);
+}
@@ -0,0 +1,43 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_ClockOffset
+#include <boost/test/unit_test.hpp>
+
+#include "ClockOffset.hpp"
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  ClockOffset c(1000000);
+  BOOST_CHECK(!c.valid());
+}
+
+BOOST_AUTO_TEST_CASE(symmetric_test) {
+  ClockOffset c(1000000);
+  // remote clock ahead by 500, one-way delay 100, remote holds for 50
+  c.add(1000, 1600, 1650, 1250);
+  BOOST_CHECK(c.valid());
+  BOOST_CHECK_EQUAL(c.offset(), 500);
+  BOOST_CHECK_EQUAL(c.delay(), 200);
+  BOOST_CHECK_EQUAL(c.to_local(1650), 1150);
+}
+
+BOOST_AUTO_TEST_CASE(min_delay_test) {
+  ClockOffset c(1000000);
+  c.add(1000, 1600, 1650, 1250);
+  // a reply queued on the way back yields a wrong offset, but a larger
+  // delay, and is therefore ignored
+  c.add(2000, 2600, 2650, 3250);
+  BOOST_CHECK_EQUAL(c.offset(), 500);
+  // a faster exchange replaces the estimate
+  c.add(4000, 4510, 4520, 4030);
+  BOOST_CHECK_EQUAL(c.offset(), 500);
+  BOOST_CHECK_EQUAL(c.delay(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(period_test) {
+  ClockOffset c(1000);
+  c.add(0, 500, 500, 100);
+  // the remote clock drifts, older samples are kept for one more period
+  c.add(2000, 2700, 2700, 2200);
+  BOOST_CHECK_EQUAL(c.offset(), 450);
+  c.add(4000, 4700, 4700, 4200);
+  BOOST_CHECK_EQUAL(c.offset(), 600);
+}
@@ -0,0 +1,58 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_CompletionBitmap
+#include <boost/test/unit_test.hpp>
+
+#include "CompletionBitmap.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(in_order_test) {
+  CompletionBitmap bitmap(4);
+  BOOST_CHECK(!bitmap.advance());
+  for (uint64_t pos = 0; pos < 100; ++pos) {
+    bitmap.set(pos);
+    BOOST_CHECK(bitmap.advance());
+    BOOST_CHECK_EQUAL(bitmap.completed(), pos + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(out_of_order_test) {
+  CompletionBitmap bitmap(8);
+  bitmap.set(2);
+  bitmap.set(1);
+  BOOST_CHECK(!bitmap.advance());
+  BOOST_CHECK_EQUAL(bitmap.completed(), 0);
+  bitmap.set(0);
+  BOOST_CHECK(bitmap.advance());
+  BOOST_CHECK_EQUAL(bitmap.completed(), 3);
+
+  // a run across a word boundary
+  for (uint64_t pos = 4; pos < 200; ++pos) {
+    bitmap.set(pos);
+  }
+  BOOST_CHECK(!bitmap.advance());
+  bitmap.set(3);
+  BOOST_CHECK(bitmap.advance());
+  BOOST_CHECK_EQUAL(bitmap.completed(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(wrap_around_test) {
+  // random order within a window of at most the buffer size
+  for (uint32_t size_exp : {2, 6, 7, 10}) {
+    const uint64_t size = UINT64_C(1) << size_exp;
+    CompletionBitmap bitmap(size_exp);
+    std::mt19937 rng(size_exp);
+    for (uint64_t begin = 0; begin < 20 * size; begin += size) {
+      std::vector<uint64_t> positions(size);
+      std::iota(positions.begin(), positions.end(), begin);
+      std::shuffle(positions.begin(), positions.end(), rng);
+      for (uint64_t pos : positions) {
+        bitmap.set(pos);
+      }
+      BOOST_CHECK(bitmap.advance());
+      BOOST_CHECK_EQUAL(bitmap.completed(), begin + size);
+    }
+  }
+}
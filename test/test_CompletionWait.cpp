@@ -0,0 +1,57 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_CompletionWait
+#include <boost/test/unit_test.hpp>
+
+#include "CompletionWait.hpp"
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(disabled_test) {
+  CompletionWait w;
+  BOOST_CHECK(!w.enabled());
+  BOOST_CHECK(!w.idle(false));
+  w.configure({0us, 0us});
+  BOOST_CHECK(!w.idle(false));
+}
+
+BOOST_AUTO_TEST_CASE(spin_test) {
+  CompletionWait w;
+  w.configure({2ms, 1ms});
+  BOOST_CHECK(w.enabled());
+  BOOST_CHECK(!w.idle(false));
+  std::this_thread::sleep_for(3ms);
+  BOOST_CHECK(w.idle(false));
+  // activity restarts the spin time
+  BOOST_CHECK(!w.idle(true));
+  BOOST_CHECK(!w.idle(false));
+}
+
+BOOST_AUTO_TEST_CASE(wait_test) {
+  CompletionWait w;
+  w.configure({0us, 2ms});
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+
+  // a timeout is not a wakeup
+  pollfd fd{fds[0], POLLIN, 0};
+  BOOST_CHECK(w.idle(false));
+  BOOST_CHECK(!w.wait(&fd, 1));
+
+  // a readable descriptor ends the wait
+  BOOST_REQUIRE_EQUAL(write(fds[1], "x", 1), 1);
+  BOOST_CHECK(w.wait(&fd, 1));
+
+  CompletionWait::Stats stats = w.take_stats();
+  BOOST_CHECK_EQUAL(stats.waits, 2);
+  BOOST_CHECK_EQUAL(stats.wakeups, 1);
+  BOOST_CHECK(stats.blocked >= 2ms);
+  BOOST_CHECK(stats.period >= stats.blocked);
+  BOOST_CHECK(stats.blocked_ratio() > 0 && stats.blocked_ratio() <= 1);
+  BOOST_CHECK_EQUAL(w.take_stats().waits, 0);
+  BOOST_CHECK_EQUAL(w.total_stats().waits, 2);
+
+  close(fds[0]);
+  close(fds[1]);
+}
@@ -0,0 +1,70 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_CrcBatch
+#include <boost/test/unit_test.hpp>
+
+#include "interface.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+crcutil_interface::CRC* create_crc32c(bool use_sse4_2) {
+  return crcutil_interface::CRC::Create(0x82f63b78, 0, 32, true, 0, 0, 0,
+                                        use_sse4_2, nullptr);
+}
+
+// Compare batch results against individual computation for buffers of
+// various sizes, both equal and unequal, with non-zero start values
+void check_batch(const crcutil_interface::CRC& crc) {
+  std::mt19937 gen(42);
+  std::vector<uint8_t> data(100000);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(gen());
+  }
+  const std::vector<size_t> sizes{0,   1,   7,    8,    9,     63, 64,
+                                  500, 512, 513,  1000, 4099,  40000,
+                                  1,   100, 100,  100,  3333, 3333, 3333};
+  for (size_t count = 0; count <= sizes.size(); ++count) {
+    std::vector<const void*> ptrs;
+    std::vector<size_t> bytes;
+    std::vector<crcutil_interface::UINT64> crcs;
+    std::vector<crcutil_interface::UINT64> expected;
+    for (size_t i = 0; i < count; ++i) {
+      // unaligned, distinct start positions
+      ptrs.push_back(data.data() + (i * 4321 + count) % 50000);
+      bytes.push_back(sizes[i]);
+      crcs.push_back(i * 0x01010101);
+      expected.push_back(i * 0x01010101);
+      crc.Compute(ptrs[i], bytes[i], &expected[i]);
+    }
+    crc.ComputeBatch(ptrs.data(), bytes.data(), count, crcs.data());
+    BOOST_CHECK_EQUAL_COLLECTIONS(crcs.begin(), crcs.end(), expected.begin(),
+                                  expected.end());
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(known_value_test) {
+  const char check[] = "123456789";
+  const void* ptrs[] = {check, check, check, check};
+  size_t bytes[] = {9, 9, 9, 9};
+  crcutil_interface::UINT64 crcs[4] = {};
+  crcutil_interface::CRC* crc = create_crc32c(true);
+  BOOST_REQUIRE(crc != nullptr);
+  crc->ComputeBatch(ptrs, bytes, 4, crcs);
+  for (auto value : crcs) {
+    BOOST_CHECK_EQUAL(value, 0xe3069283);
+  }
+  crc->Delete();
+}
+
+BOOST_AUTO_TEST_CASE(batch_test) {
+  for (bool use_sse4_2 : {false, true}) {
+    crcutil_interface::CRC* crc = create_crc32c(use_sse4_2);
+    BOOST_REQUIRE(crc != nullptr);
+    check_batch(*crc);
+    crc->Delete();
+  }
+}
@@ -0,0 +1,107 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_CrcValidator
+#include <boost/test/unit_test.hpp>
+
+#include "CrcValidator.hpp"
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr auto crc_valid =
+    static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+constexpr auto crc_checked =
+    static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked);
+constexpr auto crc_error =
+    static_cast<uint16_t>(fles::MicrosliceFlags::CrcError);
+
+// CRC-32C of the content "123456789"
+constexpr uint32_t check_crc = 0xe3069283;
+constexpr std::size_t check_size = 9;
+
+/// A component of microslices with content "123456789", laid out as in a
+/// timeslice.
+struct TestComponent {
+  explicit TestComponent(std::size_t num) : num_microslices(num) {
+    data.resize(num * (sizeof(fles::MicrosliceDescriptor) + check_size));
+    uint8_t* contents = data.data() + num * sizeof(fles::MicrosliceDescriptor);
+    for (std::size_t m = 0; m < num; ++m) {
+      fles::MicrosliceDescriptor& d = desc(m);
+      d = fles::MicrosliceDescriptor();
+      d.idx = m;
+      d.offset = 1000 + m * check_size;
+      d.size = check_size;
+      d.crc = check_crc;
+      d.flags = crc_valid;
+      std::memcpy(contents + m * check_size, "123456789", check_size);
+    }
+  }
+
+  fles::MicrosliceDescriptor& desc(std::size_t m) {
+    return reinterpret_cast<fles::MicrosliceDescriptor*>(data.data())[m];
+  }
+
+  CrcValidator::Component component() { return {&desc(0), num_microslices}; }
+
+  std::vector<uint8_t> data;
+  std::size_t num_microslices;
+};
+
+uint64_t wait_get(CrcValidator& validator) {
+  uint64_t id = 0;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!validator.try_get(id)) {
+    BOOST_REQUIRE(std::chrono::steady_clock::now() < deadline);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return id;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(validation_test) {
+  CrcValidator validator(2);
+
+  TestComponent good(5);
+  TestComponent bad(5);
+  bad.desc(2).crc ^= 1;
+  bad.desc(4).flags = 0; // no valid CRC, not checked
+  bad.desc(4).crc = 0;
+  TestComponent empty(0);
+
+  validator.submit(7, {good.component(), bad.component(), empty.component()});
+  BOOST_CHECK_EQUAL(wait_get(validator), 7);
+  BOOST_CHECK_EQUAL(validator.pending(), 0);
+
+  for (std::size_t m = 0; m < 5; ++m) {
+    BOOST_CHECK_EQUAL(good.desc(m).flags, crc_valid | crc_checked);
+  }
+  BOOST_CHECK_EQUAL(bad.desc(0).flags, crc_valid | crc_checked);
+  BOOST_CHECK_EQUAL(bad.desc(2).flags, crc_valid | crc_checked | crc_error);
+  BOOST_CHECK_EQUAL(bad.desc(4).flags, 0);
+  BOOST_CHECK_EQUAL(validator.checked(), 9);
+  BOOST_CHECK_EQUAL(validator.errors(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(order_test) {
+  CrcValidator validator(4);
+
+  // a large timeslice first, followed by small ones
+  std::vector<TestComponent> components;
+  components.emplace_back(100000);
+  for (int i = 0; i < 20; ++i) {
+    components.emplace_back(1);
+  }
+  for (std::size_t i = 0; i < components.size(); ++i) {
+    validator.submit(i, {components[i].component()});
+  }
+  for (std::size_t i = 0; i < components.size(); ++i) {
+    BOOST_CHECK_EQUAL(wait_get(validator), i);
+  }
+  uint64_t id = 0;
+  BOOST_CHECK(!validator.try_get(id));
+  BOOST_CHECK_EQUAL(validator.checked(), 100020);
+  BOOST_CHECK_EQUAL(validator.errors(), 0);
+}
@@ -0,0 +1,96 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_DescriptorCodec
+#include <boost/test/unit_test.hpp>
+
+#include "DescriptorCodec.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::vector<fles::MicrosliceDescriptor> make_descriptors(std::size_t num) {
+  std::vector<fles::MicrosliceDescriptor> desc(num);
+  uint64_t offset = 4096;
+  for (std::size_t m = 0; m < num; ++m) {
+    desc[m].hdr_id = 0xDD;
+    desc[m].hdr_ver = 0x01;
+    desc[m].eq_id = 0xE001;
+    desc[m].sys_id = 0x10;
+    desc[m].sys_ver = 0x04;
+    desc[m].idx = 1000000 + m * 102400;
+    desc[m].size = 64;
+    desc[m].offset = offset;
+    offset += desc[m].size;
+  }
+  return desc;
+}
+
+bool equal(const std::vector<fles::MicrosliceDescriptor>& a,
+           const std::vector<fles::MicrosliceDescriptor>& b) {
+  return a.size() == b.size() &&
+         std::memcmp(a.data(), b.data(),
+                     a.size() * sizeof(fles::MicrosliceDescriptor)) == 0;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(regular_test) {
+  auto desc = make_descriptors(1000);
+  std::vector<uint8_t> encoded;
+  fles::encode_descriptors(desc.data(), desc.size(), encoded);
+  // a few runs for the whole array
+  BOOST_CHECK_LT(encoded.size(), 100);
+
+  std::vector<fles::MicrosliceDescriptor> decoded(desc.size());
+  fles::decode_descriptors(encoded.data(), encoded.size(), decoded.data(),
+                           decoded.size());
+  BOOST_CHECK(equal(decoded, desc));
+}
+
+BOOST_AUTO_TEST_CASE(irregular_test) {
+  auto desc = make_descriptors(100);
+  for (std::size_t m = 0; m < desc.size(); ++m) {
+    desc[m].crc = static_cast<uint32_t>(m * 2654435761U);
+    desc[m].flags = static_cast<uint16_t>(m % 7 == 0 ? 0x1 : 0);
+  }
+  // sizes varying, a gap and a decreasing index
+  desc[10].size = 17;
+  desc[50].offset += 1000;
+  desc[60].idx = 5;
+  desc[99].offset = 0;
+
+  std::vector<uint8_t> encoded;
+  fles::encode_descriptors(desc.data(), desc.size(), encoded);
+  BOOST_CHECK_LT(encoded.size(),
+                 desc.size() * sizeof(fles::MicrosliceDescriptor));
+
+  std::vector<fles::MicrosliceDescriptor> decoded(desc.size());
+  fles::decode_descriptors(encoded.data(), encoded.size(), decoded.data(),
+                           decoded.size());
+  BOOST_CHECK(equal(decoded, desc));
+}
+
+BOOST_AUTO_TEST_CASE(empty_test) {
+  std::vector<uint8_t> encoded;
+  fles::encode_descriptors(nullptr, 0, encoded);
+  fles::decode_descriptors(encoded.data(), encoded.size(), nullptr, 0);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test) {
+  auto desc = make_descriptors(10);
+  std::vector<uint8_t> encoded;
+  fles::encode_descriptors(desc.data(), desc.size(), encoded);
+
+  std::vector<fles::MicrosliceDescriptor> decoded(desc.size() + 1);
+  BOOST_CHECK_THROW(fles::decode_descriptors(encoded.data(),
+                                             encoded.size() - 1,
+                                             decoded.data(), desc.size()),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(fles::decode_descriptors(encoded.data(), encoded.size(),
+                                             decoded.data(), desc.size() + 1),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(fles::decode_descriptors(encoded.data(), encoded.size(),
+                                             decoded.data(), desc.size() - 1),
+                    std::runtime_error);
+}
@@ -6,11 +6,16 @@
 #include "FilterExamples.hpp"
 #include "MicrosliceInputArchive.hpp"
 #include "MicrosliceOutputArchive.hpp"
+#include "ParallelFilter.hpp"
 #include "Source.hpp"
+#include <chrono>
 #include <cstdint>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 // example source: integer counter
 template <typename T> class Counter : public fles::Source<T> {
@@ -104,6 +109,92 @@ BOOST_AUTO_TEST_CASE(int_filter_test) {
   BOOST_CHECK_EQUAL(count, 6);
 }
 
+// example sink: item collector
+template <typename T> class Collector : public fles::Sink<T> {
+public:
+  void put(std::shared_ptr<const T> item) override { items.push_back(*item); }
+  void end_stream() override { ended = true; }
+
+  std::vector<T> items;
+  bool ended = false;
+};
+
+// example transformation: slow integer doubler, dropping multiples of 5
+std::unique_ptr<int> slow_double(std::shared_ptr<const int> item) {
+  // later items tend to finish first
+  std::this_thread::sleep_for(std::chrono::microseconds(50 * (*item % 7)));
+  if (*item % 5 == 0) {
+    return nullptr;
+  }
+  return std::make_unique<int>(*item * 2);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_source_test) {
+  Counter<int> counter(100);
+  fles::ParallelFilter<int> filter(slow_double, 4, 6);
+  BOOST_CHECK_EQUAL(filter.num_threads(), 4);
+
+  fles::FilteredSource<int> source(counter, filter);
+
+  std::vector<int> items;
+  while (auto item = source.get()) {
+    items.push_back(*item);
+  }
+  BOOST_CHECK(source.eos());
+
+  // all remaining items in input order
+  BOOST_REQUIRE_EQUAL(items.size(), 80);
+  int expected = 0;
+  for (int item : items) {
+    ++expected;
+    if (expected % 5 == 0) {
+      ++expected;
+    }
+    BOOST_CHECK_EQUAL(item, expected * 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_sink_test) {
+  Collector<int> sink;
+  fles::ParallelFilter<int> filter(slow_double, 3);
+  fles::FilteringSink<int> filtering(sink, filter);
+
+  for (int i = 1; i <= 50; ++i) {
+    filtering.put(std::make_shared<const int>(i));
+  }
+  filtering.end_stream();
+
+  BOOST_CHECK(sink.ended);
+  BOOST_REQUIRE_EQUAL(sink.items.size(), 40);
+  BOOST_CHECK_EQUAL(sink.items.front(), 2);
+  BOOST_CHECK_EQUAL(sink.items.back(), 98);
+  for (size_t i = 1; i < sink.items.size(); ++i) {
+    BOOST_CHECK_LT(sink.items[i - 1], sink.items[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_exception_test) {
+  fles::ParallelFilter<int> filter(
+      [](std::shared_ptr<const int> item) -> std::unique_ptr<int> {
+        if (*item == 2) {
+          throw std::runtime_error("test");
+        }
+        return std::make_unique<int>(*item);
+      },
+      2);
+
+  auto output = filter.exchange_item(std::make_shared<const int>(1));
+  BOOST_CHECK(!output.first);
+  output = filter.exchange_item(std::make_shared<const int>(2));
+  if (!output.first) {
+    output = filter.exchange_item();
+  }
+  // the exception is rethrown once the failed item is due
+  BOOST_REQUIRE(output.first);
+  BOOST_CHECK_EQUAL(*output.first, 1);
+  BOOST_CHECK_THROW(filter.exchange_item(), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_CASE(filter_example1_test) {
   fles::DescriptorOverrideFilter filter(
       static_cast<uint8_t>(fles::Subsystem::FLES),
@@ -133,6 +224,30 @@ BOOST_AUTO_TEST_CASE(filter_example1_test) {
   BOOST_CHECK_EQUAL(count, 4);
 }
 
+BOOST_AUTO_TEST_CASE(parallel_filter_example1_test) {
+  fles::DescriptorOverrideFilter override_filter(
+      static_cast<uint8_t>(fles::Subsystem::FLES),
+      static_cast<uint8_t>(fles::SubsystemFormatFLES::Uninitialized));
+  fles::ParallelMicrosliceFilter filter(
+      [&override_filter](std::shared_ptr<const fles::Microslice> item) {
+        return override_filter.exchange_item(std::move(item)).first;
+      },
+      2);
+
+  fles::MicrosliceInputArchive source("example2.msa");
+
+  fles::FilteredMicrosliceSource filtered(source, filter);
+
+  std::size_t count = 0;
+  while (auto item = filtered.get()) {
+    BOOST_CHECK_EQUAL(item->desc().sys_id,
+                      static_cast<uint8_t>(fles::Subsystem::FLES));
+    ++count;
+  }
+
+  BOOST_CHECK_EQUAL(count, 4);
+}
+
 BOOST_AUTO_TEST_CASE(filter_example2_test) {
   fles::CombineContentsFilter filter;
 
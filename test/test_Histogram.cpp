@@ -0,0 +1,96 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_Histogram
+#include <boost/test/unit_test.hpp>
+
+#include "Histogram.hpp"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using cbm::AtomicHistogram;
+using cbm::Histogram;
+
+BOOST_AUTO_TEST_CASE(bucket_mapping_test) {
+  // small values have exact buckets
+  for (uint64_t v = 0; v < Histogram::kSubBuckets; ++v) {
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(v), v);
+    BOOST_CHECK_EQUAL(Histogram::BucketHigh(v), v);
+  }
+
+  // buckets are contiguous and cover the full range
+  for (size_t i = 1; i < Histogram::kBuckets; ++i) {
+    BOOST_CHECK_EQUAL(Histogram::BucketLow(i),
+                      Histogram::BucketHigh(i - 1) + 1);
+  }
+  BOOST_CHECK_EQUAL(Histogram::BucketHigh(Histogram::kBuckets - 1), UINT64_MAX);
+  BOOST_CHECK_EQUAL(Histogram::BucketIndex(UINT64_MAX),
+                    Histogram::kBuckets - 1);
+
+  // values map into the bucket bounds
+  for (uint64_t v : {16ul, 17ul, 31ul, 32ul, 1000ul, 123456789ul}) {
+    size_t i = Histogram::BucketIndex(v);
+    BOOST_CHECK_LE(Histogram::BucketLow(i), v);
+    BOOST_CHECK_GE(Histogram::BucketHigh(i), v);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(percentile_test) {
+  Histogram hist;
+  BOOST_CHECK_EQUAL(hist.Percentile(50.), 0);
+
+  for (uint64_t v = 1; v <= 1000; ++v)
+    hist.Record(v);
+  BOOST_CHECK_EQUAL(hist.Count(), 1000);
+  BOOST_CHECK_EQUAL(hist.Max(), 1000);
+  BOOST_CHECK_EQUAL(hist.Percentile(100.), 1000);
+
+  // relative error is bounded by the sub-bucket resolution
+  for (double pct : {50., 90., 99.}) {
+    auto exact = static_cast<double>(pct * 10.);
+    auto est = static_cast<double>(hist.Percentile(pct));
+    BOOST_CHECK_GE(est, exact);
+    BOOST_CHECK_LE(est, exact * (1. + 1. / Histogram::kSubBuckets));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(merge_test) {
+  Histogram a;
+  Histogram b;
+  a.Record(10, 3);
+  b.Record(10);
+  b.Record(5000);
+  a.Merge(b);
+  BOOST_CHECK_EQUAL(a.Count(), 5);
+  BOOST_CHECK_EQUAL(a.Max(), 5000);
+  BOOST_CHECK_EQUAL(a.BucketCount(Histogram::BucketIndex(10)), 4);
+  a.Clear();
+  BOOST_CHECK_EQUAL(a.Count(), 0);
+  BOOST_CHECK_EQUAL(a.Max(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(atomic_record_test) {
+  constexpr uint64_t n_threads = 4;
+  constexpr uint64_t n_values = 100000;
+  AtomicHistogram hist;
+
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&hist, t] {
+      for (uint64_t v = 0; v < n_values; ++v)
+        hist.Record(v * n_threads + t);
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  Histogram snap = hist.Snapshot(false);
+  BOOST_CHECK_EQUAL(snap.Count(), n_threads * n_values);
+  BOOST_CHECK_EQUAL(snap.Max(), n_threads * n_values - 1);
+
+  // a resetting snapshot returns the same and starts over
+  snap = hist.Snapshot(true);
+  BOOST_CHECK_EQUAL(snap.Count(), n_threads * n_values);
+  snap = hist.Snapshot(false);
+  BOOST_CHECK_EQUAL(snap.Count(), 0);
+  BOOST_CHECK_EQUAL(snap.Max(), 0);
+}
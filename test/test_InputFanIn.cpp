@@ -0,0 +1,107 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_InputFanIn
+#include <boost/test/unit_test.hpp>
+
+#include "FlesnetPatternGenerator.hpp"
+#include "InputFanIn.hpp"
+#include "MicrosliceReceiver.hpp"
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Source of microslices with given indexes and input-specific content.
+class TestSource : public InputBufferReadInterface {
+public:
+  TestSource(uint8_t input, std::vector<uint64_t> indexes)
+      : data_buffer_(12), desc_buffer_(6),
+        data_view_(data_buffer_.ptr(), 12), desc_view_(desc_buffer_.ptr(), 6),
+        input_(input), indexes_(std::move(indexes)) {}
+
+  void proceed() override {
+    // one microslice per call, of a size depending on its index
+    if (write_index_.desc == indexes_.size()) {
+      return;
+    }
+    fles::MicrosliceDescriptor d{};
+    d.idx = indexes_[write_index_.desc];
+    d.size = static_cast<uint32_t>(8 + d.idx % 5);
+    if (write_index_.desc - read_index_.desc == desc_view_.size() ||
+        write_index_.data - read_index_.data + d.size > data_view_.bytes()) {
+      return;
+    }
+    d.offset = write_index_.data;
+    d.eq_id = input_;
+    for (uint32_t i = 0; i < d.size; ++i) {
+      data_buffer_.at(write_index_.data + i) = input_;
+    }
+    desc_buffer_.at(write_index_.desc) = d;
+    write_index_.data += d.size;
+    ++write_index_.desc;
+  }
+
+  DualIndex get_write_index() override { return write_index_; }
+  bool get_eof() override { return write_index_.desc == indexes_.size(); }
+  void set_read_index(DualIndex r) override { read_index_ = r; }
+  DualIndex get_read_index() override { return read_index_; }
+  RingBufferView<uint8_t>& data_buffer() override { return data_view_; }
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() override {
+    return desc_view_;
+  }
+
+private:
+  RingBuffer<uint8_t> data_buffer_;
+  RingBuffer<fles::MicrosliceDescriptor> desc_buffer_;
+  RingBufferView<uint8_t> data_view_;
+  RingBufferView<fles::MicrosliceDescriptor> desc_view_;
+  uint8_t input_;
+  std::vector<uint64_t> indexes_;
+  DualIndex read_index_{0, 0};
+  DualIndex write_index_{0, 0};
+};
+
+std::vector<std::unique_ptr<InputBufferReadInterface>>
+make_sources(const std::vector<std::vector<uint64_t>>& indexes) {
+  std::vector<std::unique_ptr<InputBufferReadInterface>> sources;
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    sources.push_back(
+        std::make_unique<TestSource>(static_cast<uint8_t>(i + 1), indexes[i]));
+  }
+  return sources;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(lockstep_test) {
+  std::vector<uint64_t> indexes;
+  for (uint64_t i = 0; i < 200; ++i) {
+    indexes.push_back(i);
+  }
+  InputFanIn fan_in(make_sources({indexes, indexes, indexes}), 11, 7);
+  BOOST_CHECK_EQUAL(fan_in.num_sources(), 3);
+
+  fles::MicrosliceReceiver receiver(fan_in);
+  for (uint64_t n = 0; n < 600; ++n) {
+    auto ms = receiver.get();
+    BOOST_REQUIRE(ms);
+    BOOST_CHECK_EQUAL(ms->desc().idx, n / 3);
+    BOOST_CHECK_EQUAL(ms->desc().eq_id, n % 3 + 1);
+    BOOST_CHECK_EQUAL(ms->desc().size, 8 + (n / 3) % 5);
+    BOOST_CHECK_EQUAL(ms->content()[ms->desc().size - 1], n % 3 + 1);
+  }
+  BOOST_CHECK(!receiver.get());
+  BOOST_CHECK_EQUAL(fan_in.discarded(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(gap_test) {
+  InputFanIn fan_in(make_sources({{0, 1, 2, 3, 4}, {0, 2, 3, 4}}), 10, 5);
+  std::vector<uint64_t> merged;
+  fles::MicrosliceReceiver receiver(fan_in);
+  while (auto ms = receiver.get()) {
+    merged.push_back(ms->desc().idx);
+  }
+  std::vector<uint64_t> expected{0, 0, 2, 2, 3, 3, 4, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(merged.begin(), merged.end(),
+                                expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(fan_in.discarded(), 1);
+}
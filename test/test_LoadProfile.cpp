@@ -0,0 +1,53 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_LoadProfile
+#include <boost/test/unit_test.hpp>
+
+#include "LoadProfile.hpp"
+#include <sstream>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(step_and_ramp_test) {
+  LoadProfile p({{0, 0.2, 100, false}, {2, 0.8, 0, true}, {3, 0, 50, false}});
+  BOOST_CHECK_CLOSE(p.at(0).rate, 0.2, 1e-9);
+  BOOST_CHECK_EQUAL(p.at(0).mc_size, 100);
+  BOOST_CHECK_CLOSE(p.at(1).rate, 0.5, 1e-9);
+  BOOST_CHECK_CLOSE(p.at(2.5).rate, 0.8, 1e-9);
+  BOOST_CHECK_EQUAL(p.at(2.5).mc_size, 100);
+  BOOST_CHECK_EQUAL(p.at(3).rate, 0);
+  BOOST_CHECK_EQUAL(p.at(3).mc_size, 50);
+  BOOST_CHECK(!p.finished(2.9));
+  BOOST_CHECK(p.finished(3));
+}
+
+BOOST_AUTO_TEST_CASE(period_test) {
+  LoadProfile p({{0, 1, 0, false}, {1, 0, 0, false}}, 4);
+  BOOST_CHECK_EQUAL(p.at(4.5).rate, 1);
+  BOOST_CHECK_EQUAL(p.at(6).rate, 0);
+  BOOST_CHECK(!p.finished(100));
+}
+
+BOOST_AUTO_TEST_CASE(parse_test) {
+  std::istringstream is("# spill structure\n"
+                        "period 10\n"
+                        "\n"
+                        "0   0\n"
+                        "1   0.5 200 ramp  # rising edge\n"
+                        "5   0.5\n"
+                        "6   0 ramp\n");
+  LoadProfile p = LoadProfile::parse(is);
+  BOOST_CHECK_EQUAL(p.period(), 10);
+  BOOST_REQUIRE_EQUAL(p.points().size(), 4);
+  BOOST_CHECK(p.points()[1].ramp);
+  BOOST_CHECK_EQUAL(p.points()[1].mc_size, 200);
+  BOOST_CHECK_CLOSE(p.at(10.5).rate, 0.25, 1e-9);
+  BOOST_CHECK_EQUAL(p.at(15.5).mc_size, 200);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test) {
+  std::istringstream syntax("0 x\n");
+  BOOST_CHECK_THROW(LoadProfile::parse(syntax), std::invalid_argument);
+  std::istringstream order("1 0.5\n0 0.2\n");
+  BOOST_CHECK_THROW(LoadProfile::parse(order), std::invalid_argument);
+  BOOST_CHECK_THROW(LoadProfile({{0, 2, 0, false}}), std::invalid_argument);
+  BOOST_CHECK_THROW(LoadProfile({}), std::invalid_argument);
+}
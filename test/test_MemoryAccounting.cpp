@@ -0,0 +1,46 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_MemoryAccounting
+#include <boost/test/unit_test.hpp>
+
+#include "MemoryAccounting.hpp"
+#include <utility>
+
+namespace {
+
+MemoryAccounting::Entry find(const std::string& site, int numa_node) {
+  for (const auto& e : MemoryAccounting::entries()) {
+    if (e.site == site && e.numa_node == numa_node) {
+      return e;
+    }
+  }
+  return {site, numa_node, 0, 0, 0};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(totals_test) {
+  {
+    MemoryAccount a("totals", MemoryUse::Reserved, 1000, 0);
+    MemoryAccount b("totals", MemoryUse::Reserved, 500, 0);
+    MemoryAccount c("totals", MemoryUse::Registered, 200, 0);
+    MemoryAccount d("totals", MemoryUse::Committed, 300, 1);
+    BOOST_CHECK_EQUAL(find("totals", 0).reserved, 1500);
+    BOOST_CHECK_EQUAL(find("totals", 0).registered, 200);
+    BOOST_CHECK_EQUAL(find("totals", 0).committed, 0);
+    BOOST_CHECK_EQUAL(find("totals", 1).committed, 300);
+  }
+  BOOST_CHECK_EQUAL(find("totals", 0).reserved, 0);
+  BOOST_CHECK_EQUAL(find("totals", 1).committed, 0);
+}
+
+BOOST_AUTO_TEST_CASE(move_test) {
+  MemoryAccount a("move", MemoryUse::Committed, 100);
+  MemoryAccount b(std::move(a));
+  BOOST_CHECK_EQUAL(find("move", -1).committed, 100);
+  MemoryAccount c("move", MemoryUse::Committed, 50);
+  // the replaced account is released
+  b = std::move(c);
+  BOOST_CHECK_EQUAL(find("move", -1).committed, 50);
+  b = MemoryAccount();
+  BOOST_CHECK_EQUAL(find("move", -1).committed, 0);
+}
@@ -0,0 +1,86 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+
+#define BOOST_TEST_MODULE test_MetricQueue
+#include <boost/test/unit_test.hpp>
+
+#include "MetricQueue.hpp"
+
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace cbm;
+
+static Metric make_metric(const std::string& source, unsigned long seq) {
+  return Metric("test", {{"source", source}}, {{"seq", seq}});
+}
+
+BOOST_AUTO_TEST_CASE(single_producer_test) {
+  MetricQueue queue(8);
+  for (unsigned long i = 0; i < 5; ++i) {
+    BOOST_CHECK(queue.Push(make_metric("main", i)));
+  }
+  std::vector<Metric> metvec;
+  BOOST_CHECK_EQUAL(queue.Drain(metvec), 5);
+  BOOST_REQUIRE_EQUAL(metvec.size(), 5);
+  for (unsigned long i = 0; i < 5; ++i) {
+    BOOST_CHECK_EQUAL(std::get<unsigned long>(metvec[i].fFieldset[0].second),
+                      i);
+  }
+  BOOST_CHECK_EQUAL(queue.Drain(metvec), 0);
+  BOOST_CHECK_EQUAL(queue.NProducer(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(drop_when_full_test) {
+  MetricQueue queue(4);
+  for (unsigned long i = 0; i < 6; ++i) {
+    queue.Push(make_metric("main", i));
+  }
+  BOOST_CHECK_EQUAL(queue.Drops(), 2);
+  std::vector<Metric> metvec;
+  BOOST_CHECK_EQUAL(queue.Drain(metvec), 4);
+  BOOST_CHECK(queue.Push(make_metric("main", 6)));
+  BOOST_CHECK_EQUAL(queue.Drops(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(multi_producer_test) {
+  constexpr unsigned long n_points = 20000;
+  constexpr int n_threads = 4;
+  MetricQueue queue(256);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&queue, t] {
+      for (unsigned long i = 0; i < n_points;) {
+        if (queue.Push(make_metric(std::to_string(t), i))) {
+          ++i;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // drain concurrently, points of each producer must arrive in order
+  std::map<std::string, unsigned long> next;
+  size_t total = 0;
+  while (total < n_threads * n_points) {
+    std::vector<Metric> metvec;
+    total += queue.Drain(metvec);
+    for (const auto& point : metvec) {
+      auto seq = std::get<unsigned long>(point.fFieldset[0].second);
+      BOOST_REQUIRE_EQUAL(seq, next[point.fTagset[0].second]++);
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  BOOST_CHECK_EQUAL(total, n_threads * n_points);
+  BOOST_CHECK_EQUAL(next.size(), n_threads);
+
+  // rings of terminated threads are released once drained
+  std::vector<Metric> metvec;
+  BOOST_CHECK_EQUAL(queue.Drain(metvec), 0);
+  BOOST_CHECK_EQUAL(queue.NProducer(), 0);
+}
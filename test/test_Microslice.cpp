@@ -7,6 +7,8 @@
 #include "MicrosliceView.hpp"
 #include "StorableMicroslice.hpp"
 #include <array>
+#include <memory>
+#include <thread>
 
 struct F {
   F() {
@@ -62,6 +64,69 @@ BOOST_FIXTURE_TEST_CASE(storable_assignment_test, F) {
   BOOST_CHECK_EQUAL(m2.content()[3], 8);
 }
 
+BOOST_AUTO_TEST_CASE(storage_pool_test) {
+  fles::MicrosliceStoragePool pool(2);
+
+  auto b1 = pool.acquire(100);
+  BOOST_CHECK_EQUAL(b1.capacity(), 128);
+  const uint8_t* p1 = b1.data();
+  pool.release(std::move(b1));
+  auto b2 = pool.acquire(70);
+  BOOST_CHECK_EQUAL(b2.data(), p1);
+  BOOST_CHECK(b2.empty());
+
+  // buffers not of a class size are not kept
+  std::vector<uint8_t> odd(100);
+  pool.release(std::move(odd));
+  BOOST_CHECK_EQUAL(pool.statistics().bytes, 0);
+
+  void* block = pool.allocate(40);
+  pool.deallocate(block);
+  BOOST_CHECK_EQUAL(pool.allocate(64), block);
+  pool.deallocate(block);
+
+  // a block not of a class size is never kept, whatever its size
+  void* unpooled = fles::MicrosliceStoragePool::allocate_unpooled(40);
+  pool.deallocate(unpooled);
+
+  auto s = pool.statistics();
+  BOOST_CHECK_EQUAL(s.allocated, 2);
+  BOOST_CHECK_EQUAL(s.reused, 2);
+  BOOST_CHECK_EQUAL(s.bytes, 64);
+  BOOST_CHECK_EQUAL(pool.allocate(64), block);
+  pool.deallocate(block);
+}
+
+BOOST_FIXTURE_TEST_CASE(storage_pool_microslice_test, F) {
+  // run on a fresh thread to start with an empty local pool, the results
+  // are checked on the main thread
+  bool has_pool = false;
+  std::vector<uint8_t> content;
+  fles::MicrosliceStoragePool::Statistics s;
+  std::thread([&] {
+    fles::MicrosliceStoragePool* pool = fles::MicrosliceStoragePool::local();
+    has_pool = pool != nullptr;
+    if (!has_pool) {
+      return;
+    }
+    for (int i = 0; i < 10; ++i) {
+      std::unique_ptr<fles::StorableMicroslice> m(
+          new fles::StorableMicroslice(desc0, data0.data()));
+      content.push_back(m->content()[3]);
+    }
+    s = pool->statistics();
+  }).join();
+
+  BOOST_REQUIRE(has_pool);
+  BOOST_CHECK_EQUAL(content.size(), 10);
+  for (auto c : content) {
+    BOOST_CHECK_EQUAL(c, 8);
+  }
+  // the object and its content are allocated once and then reused
+  BOOST_CHECK_EQUAL(s.allocated, 2);
+  BOOST_CHECK_EQUAL(s.reused, 18);
+}
+
 BOOST_FIXTURE_TEST_CASE(view_assignment_test, F) {
   fles::MicrosliceView m1(desc0, data0.data());
   fles::MicrosliceView m2 = m1; // NOLINT
@@ -5,7 +5,10 @@
 #include "FlesnetPatternGenerator.hpp"
 #include "MicrosliceOutputArchive.hpp"
 #include "MicrosliceReceiver.hpp"
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(usage_test) {
   uint32_t typical_content_size = 10000;
@@ -34,3 +37,80 @@ BOOST_AUTO_TEST_CASE(usage_test) {
 
   BOOST_CHECK_EQUAL(count, 1000);
 }
+
+BOOST_AUTO_TEST_CASE(view_test) {
+  // 1000-byte microslices wrap around the 4 KiB data buffer regularly
+  FlesnetPatternGenerator copy_source(12, 5, 1, 1000, true);
+  FlesnetPatternGenerator view_source(12, 5, 1, 1000, true);
+  fles::MicrosliceReceiver copy_receiver(copy_source);
+  fles::MicrosliceReceiver view_receiver(view_source, 4);
+
+  std::vector<std::shared_ptr<const fles::Microslice>> held;
+  for (size_t count = 0; count < 100; ++count) {
+    auto copy = copy_receiver.get();
+    auto view = view_receiver.get_view();
+    BOOST_REQUIRE(copy && view);
+    BOOST_REQUIRE_EQUAL(view->desc().idx, copy->desc().idx);
+    BOOST_REQUIRE_EQUAL(view->desc().size, copy->desc().size);
+    BOOST_CHECK_EQUAL(std::memcmp(view->content(), copy->content(),
+                                  copy->desc().size),
+                      0);
+
+    // hold every third view, buffer space must not be released past it
+    if (!held.empty()) {
+      BOOST_CHECK_LE(view_source.get_read_index().desc, held[0]->desc().idx);
+    }
+    const uint8_t* buffer = view_source.data_buffer().ptr();
+    bool is_view = view->content() >= buffer &&
+                   view->content() < buffer + view_source.data_buffer().bytes();
+    if (count % 3 == 0) {
+      held.clear();
+      if (is_view) {
+        held.push_back(view);
+      }
+    }
+  }
+  BOOST_REQUIRE(!held.empty());
+  uint64_t last_held = held[0]->desc().idx;
+  held.clear();
+  BOOST_REQUIRE(view_receiver.get_view());
+  BOOST_CHECK_GT(view_source.get_read_index().desc, last_held);
+}
+
+BOOST_AUTO_TEST_CASE(batch_test) {
+  // 1000-byte microslices wrap around the 4 KiB data buffer regularly
+  FlesnetPatternGenerator source(12, 5, 1, 1000, true);
+  InputBufferReadInterface& input = source;
+
+  DualIndex read = input.get_read_index();
+  bool wrapped = false;
+  uint64_t count = 0;
+  while (count < 100) {
+    source.proceed();
+    auto batch = input.acquire(read, 3);
+    BOOST_REQUIRE(!batch.empty());
+    BOOST_REQUIRE_LE(batch.size(), 3);
+    BOOST_CHECK_EQUAL(batch.begin.desc, read.desc);
+
+    uint64_t desc_count = 0;
+    uint64_t content_bytes = 0;
+    for (const auto& span : batch.desc) {
+      for (std::size_t i = 0; i < span.size; ++i) {
+        BOOST_CHECK_EQUAL(span.ptr[i].idx, batch.begin.desc + desc_count);
+        content_bytes += span.ptr[i].size;
+        ++desc_count;
+      }
+    }
+    BOOST_CHECK_EQUAL(desc_count, batch.size());
+    BOOST_CHECK_EQUAL(batch.data[0].size + batch.data[1].size,
+                      content_bytes);
+    BOOST_CHECK_EQUAL(batch.end.data - batch.begin.data, content_bytes);
+    wrapped |= batch.data[1].size != 0;
+
+    count += batch.size();
+    read = batch.end;
+    input.release(batch);
+    BOOST_CHECK(input.get_read_index() == read);
+  }
+  BOOST_CHECK(wrapped);
+}
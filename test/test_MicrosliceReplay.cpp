@@ -0,0 +1,130 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_MicrosliceReplay
+#include <boost/test/unit_test.hpp>
+
+#include "MicrosliceReplay.hpp"
+#include "RingBuffer.hpp"
+#include "StorableMicroslice.hpp"
+#include <chrono>
+#include <vector>
+
+namespace {
+
+/// Source of microslices with an index step of 1 ms.
+class TestSource : public fles::MicrosliceSource {
+public:
+  explicit TestSource(uint64_t count) : count_(count) {}
+
+  [[nodiscard]] bool eos() const override { return n_ == count_; }
+
+private:
+  fles::Microslice* do_get() override {
+    if (n_ == count_) {
+      return nullptr;
+    }
+    fles::MicrosliceDescriptor desc{};
+    desc.idx = 1000 + n_ * 1000000;
+    desc.size = static_cast<uint32_t>(10 + n_ % 7);
+    desc.offset = 12345;
+    std::vector<uint8_t> content(desc.size, static_cast<uint8_t>(n_));
+    ++n_;
+    return new fles::StorableMicroslice(desc, content);
+  }
+
+  uint64_t count_;
+  uint64_t n_ = 0;
+};
+
+/// Data sink, read by the test itself.
+class TestSink : public InputBufferWriteInterface {
+public:
+  TestSink(std::size_t data_exp, std::size_t desc_exp)
+      : data_buffer_(data_exp), desc_buffer_(desc_exp),
+        data_view_(data_buffer_.ptr(), data_exp),
+        desc_view_(desc_buffer_.ptr(), desc_exp) {}
+
+  DualIndex get_read_index() override { return read_index; }
+  void set_write_index(DualIndex new_write_index) override {
+    write_index = new_write_index;
+    ++updates;
+  }
+  void set_eof(bool /* eof */) override {}
+  RingBufferView<uint8_t>& data_buffer() override { return data_view_; }
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() override {
+    return desc_view_;
+  }
+
+  DualIndex read_index{0, 0};
+  DualIndex write_index{0, 0};
+  uint64_t updates = 0;
+
+private:
+  RingBuffer<uint8_t> data_buffer_;
+  RingBuffer<fles::MicrosliceDescriptor> desc_buffer_;
+  RingBufferView<uint8_t> data_view_;
+  RingBufferView<fles::MicrosliceDescriptor> desc_view_;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(record_test) {
+  TestSource source(100);
+  MicrosliceReplay replay(source, 50);
+  BOOST_CHECK_EQUAL(replay.size(), 50);
+  BOOST_CHECK_EQUAL(replay.first_index(), 1000);
+  BOOST_CHECK_EQUAL(replay.period(), 50 * 1000000);
+}
+
+BOOST_AUTO_TEST_CASE(passes_test) {
+  TestSource source(100);
+  MicrosliceReplay replay(source);
+  TestSink sink(12, 9);
+
+  MicrosliceReplay::Playback playback;
+  playback.passes = 3;
+  playback.period = replay.period();
+  std::atomic<bool> stop{false};
+  BOOST_CHECK_EQUAL(replay.play(sink, playback, stop), 300);
+  BOOST_CHECK_EQUAL(sink.write_index.desc, 300);
+  BOOST_CHECK_LT(sink.updates, 300);
+
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < 300; ++i) {
+    const auto& desc = sink.desc_buffer().at(i);
+    uint64_t n = i % 100;
+    BOOST_CHECK_EQUAL(desc.idx, 1000 + i * 1000000);
+    BOOST_CHECK_EQUAL(desc.size, 10 + n % 7);
+    BOOST_CHECK_EQUAL(desc.offset, offset);
+    BOOST_CHECK_EQUAL(sink.data_buffer().at(offset + desc.size - 1), n);
+    offset += desc.size;
+  }
+  BOOST_CHECK_EQUAL(sink.write_index.data, offset);
+}
+
+BOOST_AUTO_TEST_CASE(speed_test) {
+  TestSource source(21);
+  MicrosliceReplay replay(source);
+  TestSink sink(12, 9);
+
+  // 20 ms of data at twice the original speed
+  MicrosliceReplay::Playback playback;
+  playback.speed = 2;
+  playback.origin = replay.first_index();
+  playback.start = std::chrono::steady_clock::now();
+  std::atomic<bool> stop{false};
+  BOOST_CHECK_EQUAL(replay.play(sink, playback, stop), 21);
+  auto elapsed = std::chrono::steady_clock::now() - playback.start;
+  BOOST_CHECK(elapsed >= std::chrono::milliseconds(10));
+}
+
+BOOST_AUTO_TEST_CASE(stop_test) {
+  TestSource source(10);
+  MicrosliceReplay replay(source);
+  TestSink sink(12, 9);
+
+  MicrosliceReplay::Playback playback;
+  playback.passes = 0;
+  std::atomic<bool> stop{true};
+  BOOST_CHECK_EQUAL(replay.play(sink, playback, stop), 0);
+  BOOST_CHECK_EQUAL(sink.write_index.desc, 0);
+}
@@ -0,0 +1,97 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_MicrosliceStatistics
+#include <boost/test/unit_test.hpp>
+
+#include "MicrosliceStatistics.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+fles::MicrosliceDescriptor
+make_desc(uint16_t eq_id, uint64_t idx, uint32_t size, uint16_t flags = 0) {
+  fles::MicrosliceDescriptor desc{};
+  desc.eq_id = eq_id;
+  desc.sys_id = static_cast<uint8_t>(fles::Subsystem::FLES);
+  desc.idx = idx;
+  desc.size = size;
+  desc.flags = flags;
+  return desc;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(stream_test) {
+  // two interleaved equipments, 1000 ns apart
+  std::vector<fles::MicrosliceDescriptor> desc;
+  for (uint64_t i = 0; i < 100; ++i) {
+    uint64_t idx = i * 1000;
+    if (i >= 50) {
+      idx += 1000; // one missing microslice
+    }
+    desc.push_back(make_desc(1, idx, 100));
+    desc.push_back(make_desc(2, idx, static_cast<uint32_t>(i)));
+  }
+  desc.push_back(make_desc(2, 0, 0)); // out of order
+
+  MicrosliceStatistics stats;
+  // accumulated in independent chunks
+  stats.add(desc.data(), 77);
+  stats.add(desc.data() + 77, desc.size() - 77);
+
+  BOOST_REQUIRE_EQUAL(stats.streams().size(), 2);
+  const auto& s1 = stats.streams()[0];
+  BOOST_CHECK_EQUAL(s1.eq_id, 1);
+  BOOST_CHECK_EQUAL(s1.count, 100);
+  BOOST_CHECK_EQUAL(s1.bytes, 10000);
+  BOOST_CHECK_EQUAL(s1.min_size, 100);
+  BOOST_CHECK_EQUAL(s1.max_size, 100);
+  BOOST_CHECK_EQUAL(s1.size_histogram[7], 100);
+  BOOST_CHECK_EQUAL(s1.delta_t, 1000);
+  BOOST_CHECK_EQUAL(s1.gaps, 1);
+  BOOST_CHECK_EQUAL(s1.disorder, 0);
+  BOOST_CHECK_CLOSE(s1.rate(), 99e9 / 100000, 1e-9);
+
+  const auto& s2 = stats.streams()[1];
+  BOOST_CHECK_EQUAL(s2.count, 101);
+  BOOST_CHECK_EQUAL(s2.min_size, 0);
+  BOOST_CHECK_EQUAL(s2.max_size, 99);
+  BOOST_CHECK_EQUAL(s2.size_histogram[0], 2);
+  BOOST_CHECK_EQUAL(s2.size_histogram[1], 1);
+  BOOST_CHECK_EQUAL(s2.gaps, 1);
+  BOOST_CHECK_EQUAL(s2.disorder, 1);
+  BOOST_CHECK_EQUAL(stats.untracked(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(flags_test) {
+  auto crc = static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+  auto flim = static_cast<uint16_t>(fles::MicrosliceFlags::OverflowFlim);
+  std::vector<fles::MicrosliceDescriptor> desc;
+  for (uint64_t i = 0; i < 10; ++i) {
+    desc.push_back(make_desc(0, i, 8, i < 3 ? crc | flim : crc));
+  }
+  MicrosliceStatistics stats;
+  stats.add(desc.data(), desc.size());
+  const auto& s = stats.streams().at(0);
+  BOOST_CHECK_EQUAL(s.flag_count(fles::MicrosliceFlags::CrcValid), 10);
+  BOOST_CHECK_EQUAL(s.flag_count(fles::MicrosliceFlags::OverflowFlim), 3);
+  BOOST_CHECK_EQUAL(s.flag_count(fles::MicrosliceFlags::DataError), 0);
+
+  std::ostringstream out;
+  stats.write(out, "> ");
+  BOOST_CHECK_EQUAL(out.str().rfind("> eq_id=0 sys_id=0xf0", 0), 0);
+  BOOST_CHECK_NE(out.str().find("flags 10 crc/3 flim/0 user/0 error"),
+                 std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(max_streams_test) {
+  MicrosliceStatistics stats(2);
+  for (uint16_t eq_id = 0; eq_id < 4; ++eq_id) {
+    stats.add(make_desc(eq_id, 0, 1));
+  }
+  BOOST_CHECK_EQUAL(stats.streams().size(), 2);
+  BOOST_CHECK_EQUAL(stats.untracked(), 2);
+  stats.reset();
+  BOOST_CHECK(stats.streams().empty());
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_Monitor
+#include <boost/test/unit_test.hpp>
+
+#include "Monitor.hpp"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(unregistered_handle_test) {
+  cbm::MetricCounter counter;
+  cbm::MetricGauge gauge;
+  BOOST_CHECK(!counter);
+  BOOST_CHECK(!gauge);
+  counter.Add(5);
+  gauge.Set(1.5);
+  BOOST_CHECK_EQUAL(counter.Value(), 0);
+  BOOST_CHECK_EQUAL(gauge.Value(), 0.);
+}
+
+BOOST_AUTO_TEST_CASE(handle_test) {
+  cbm::Monitor monitor;
+  auto counter = monitor.RegisterCounter("test", {{"conn", "0"}}, "count");
+  auto gauge = monitor.RegisterGauge("test", {{"conn", "0"}}, "value");
+  BOOST_CHECK(counter);
+  BOOST_CHECK(gauge);
+  counter.Add();
+  counter.Add(41);
+  gauge.Set(2.5);
+  gauge.Set(1.5);
+  BOOST_CHECK_EQUAL(counter.Value(), 42);
+  BOOST_CHECK_EQUAL(gauge.Value(), 1.5);
+
+  // copies refer to the same registered field
+  auto copy = counter;
+  copy.Add();
+  BOOST_CHECK_EQUAL(counter.Value(), 43);
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_test) {
+  auto path = boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("test_Monitor_%%%%-%%%%.txt");
+  {
+    cbm::Monitor monitor("file:" + path.string());
+    auto counter = monitor.RegisterCounter("test", {{"conn", "0"}}, "count");
+    auto gauge = monitor.RegisterGauge("test", {{"conn", "0"}}, "value");
+    auto other = monitor.RegisterCounter("test", {{"conn", "1"}}, "count");
+    // a released handle is still reported once
+    monitor.RegisterCounter("test", {{"conn", "2"}}, "count").Add(3);
+    counter.Add(7);
+    gauge.Set(0.5);
+    // the final snapshot is written when the monitor is destroyed
+  }
+
+  std::ifstream file(path.string());
+  std::stringstream ss;
+  ss << file.rdbuf();
+  std::string content = ss.str();
+  boost::filesystem::remove(path);
+
+  // fields with equal measurement and tags are combined in one line
+  BOOST_CHECK(content.find("test,conn=0 count=7i,value=0.5 ") !=
+              std::string::npos);
+  BOOST_CHECK(content.find("test,conn=1 count=0i ") != std::string::npos);
+  BOOST_CHECK(content.find("test,conn=2 count=3i ") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_snapshot_test) {
+  auto path = boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("test_Monitor_%%%%-%%%%.txt");
+  {
+    cbm::Monitor monitor("file:" + path.string());
+    auto hist = monitor.RegisterHistogram("test", {{"conn", "0"}}, "lat");
+    auto empty = monitor.RegisterHistogram("test", {{"conn", "1"}}, "lat");
+    BOOST_CHECK(hist);
+    for (unsigned long v = 1; v <= 10; ++v)
+      hist.Record(v);
+  }
+
+  std::ifstream file(path.string());
+  std::stringstream ss;
+  ss << file.rdbuf();
+  std::string content = ss.str();
+  boost::filesystem::remove(path);
+
+  BOOST_CHECK(content.find("test,conn=0 lat_count=10i,lat_p50=5i,lat_p90=9i,"
+                           "lat_p99=10i,lat_p999=10i,lat_max=10i ") !=
+              std::string::npos);
+  // an empty histogram only reports its count
+  BOOST_CHECK(content.find("test,conn=1 lat_count=0i ") != std::string::npos);
+}
@@ -0,0 +1,77 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_MonitorSinkPrometheus
+#include <boost/test/unit_test.hpp>
+
+#include "Monitor.hpp"
+#include "MonitorSinkPrometheus.hpp"
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <limits>
+#include <string>
+
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+using namespace std::string_literals;
+
+static http::response<http::string_body> get(unsigned short port,
+                                             const std::string& target) {
+  boost::asio::io_context ioc;
+  tcp::resolver resolver(ioc);
+  tcp::socket socket(ioc);
+  boost::asio::connect(socket, resolver.resolve("127.0.0.1",
+                                                std::to_string(port)));
+  http::request<http::empty_body> req{http::verb::get, target, 11};
+  req.set(http::field::host, "localhost");
+  http::write(socket, req);
+  boost::beast::flat_buffer buffer;
+  http::response<http::string_body> res;
+  http::read(socket, buffer, res);
+  return res;
+}
+
+BOOST_AUTO_TEST_CASE(scrape_test) {
+  cbm::Monitor monitor;
+  cbm::MonitorSinkPrometheus sink(monitor, "127.0.0.1:0");
+  BOOST_REQUIRE_NE(sink.Port(), 0);
+
+  // nothing processed yet
+  auto res = get(sink.Port(), "/metrics");
+  BOOST_CHECK_EQUAL(res.result_int(), 200);
+  BOOST_CHECK(res.body().empty());
+
+  sink.ProcessMetricVec(
+      {cbm::Metric("sender", {{"conn", "0"}, {"host", "a\"b"}},
+                   {{"bytes", 42ul}, {"up", true}, {"name", "x"s}}),
+       cbm::Metric("sender", {{"conn", "1"}, {"host", "c"}},
+                   {{"bytes", 7ul}}),
+       cbm::Metric("1.rate", {},
+                   {{"value", std::numeric_limits<double>::infinity()}})});
+  // a later value replaces the earlier one
+  sink.ProcessMetricVec(
+      {cbm::Metric("sender", {{"conn", "1"}, {"host", "c"}},
+                   {{"bytes", 8ul}})});
+
+  res = get(sink.Port(), "/metrics?x=1");
+  BOOST_CHECK_EQUAL(res.result_int(), 200);
+  BOOST_CHECK_EQUAL(res[http::field::content_type],
+                    "text/plain; version=0.0.4; charset=utf-8");
+  BOOST_CHECK_EQUAL(res.body(), "# TYPE _1_rate_value untyped\n"
+                                "_1_rate_value +Inf\n"
+                                "# TYPE sender_bytes untyped\n"
+                                "sender_bytes{conn=\"0\",host=\"a\\\"b\"} 42\n"
+                                "sender_bytes{conn=\"1\",host=\"c\"} 8\n"
+                                "# TYPE sender_up untyped\n"
+                                "sender_up{conn=\"0\",host=\"a\\\"b\"} 1\n");
+  BOOST_CHECK_EQUAL(*sink.Snapshot(), res.body());
+
+  BOOST_CHECK_EQUAL(get(sink.Port(), "/").result_int(), 404);
+}
+
+BOOST_AUTO_TEST_CASE(open_sink_test) {
+  cbm::Monitor monitor("prometheus:127.0.0.1:0");
+  BOOST_CHECK_EQUAL(monitor.SinkList().size(), 1);
+  BOOST_CHECK_THROW(monitor.OpenSink("prometheus:nohost:"),
+                    std::runtime_error);
+}
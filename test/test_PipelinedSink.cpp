@@ -0,0 +1,75 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_PipelinedSink
+#include <boost/test/unit_test.hpp>
+
+#include "PipelinedSink.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class RecordingSink : public fles::Sink<int> {
+public:
+  RecordingSink(std::vector<int>& items, bool& ended)
+      : items_(items), ended_(ended) {}
+
+  void put(std::shared_ptr<const int> item) override {
+    items_.push_back(*item);
+    if (std::this_thread::get_id() == creator_) {
+      ++items_in_creator_thread;
+    }
+  }
+
+  void end_stream() override { ended_ = true; }
+
+  size_t items_in_creator_thread = 0;
+
+private:
+  std::vector<int>& items_;
+  bool& ended_;
+  std::thread::id creator_ = std::this_thread::get_id();
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(order_test) {
+  std::vector<int> items;
+  bool ended = false;
+  auto recording_sink = std::make_unique<RecordingSink>(items, ended);
+  const RecordingSink& recording = *recording_sink;
+  // a small queue to make the producer wait for the consumer
+  PipelinedSink<int> sink(std::move(recording_sink), "test", 3);
+  constexpr int count = 10000;
+  for (int i = 0; i < count; ++i) {
+    sink.put(std::make_shared<const int>(i));
+  }
+  sink.end_stream();
+
+  BOOST_CHECK(ended);
+  BOOST_CHECK_EQUAL(recording.items_in_creator_thread, 0);
+  BOOST_REQUIRE_EQUAL(items.size(), count);
+  for (int i = 0; i < count; ++i) {
+    BOOST_CHECK_EQUAL(items[i], i);
+  }
+
+  auto s = sink.statistics();
+  BOOST_CHECK_EQUAL(s.items, count);
+  BOOST_CHECK_LE(s.max_depth, 4);
+  BOOST_CHECK_GE(s.mean_depth, 1);
+  BOOST_CHECK_GE(s.seconds, s.busy_seconds);
+}
+
+BOOST_AUTO_TEST_CASE(destructor_test) {
+  std::vector<int> items;
+  bool ended = false;
+  {
+    PipelinedSink<int> sink(std::make_unique<RecordingSink>(items, ended),
+                            "test", 16);
+    sink.put(std::make_shared<const int>(1));
+    sink.put(std::make_shared<const int>(2));
+  }
+  // queued items are still processed, but the stream is not ended
+  BOOST_CHECK_EQUAL(items.size(), 2);
+  BOOST_CHECK(!ended);
+}
@@ -0,0 +1,105 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_ProcessorScaler
+#include <boost/test/unit_test.hpp>
+
+#include "ProcessorScaler.hpp"
+#include <stdexcept>
+
+namespace {
+
+ProcessorScaler::Config config() {
+  ProcessorScaler::Config c;
+  c.min_instances = 2;
+  c.max_instances = 4;
+  c.scale_up_samples = 3;
+  c.scale_down_samples = 5;
+  return c;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(scale_up_test) {
+  ProcessorScaler s(config());
+  BOOST_CHECK_EQUAL(s.instances(), 2);
+
+  // waiting items in consecutive samples add one instance at a time
+  const ProcessorLoad behind{5, 2, 0.2};
+  BOOST_CHECK_EQUAL(s.update(behind), 2);
+  BOOST_CHECK_EQUAL(s.update(behind), 2);
+  BOOST_CHECK_EQUAL(s.update(behind), 3);
+  BOOST_CHECK_EQUAL(s.update(behind), 3);
+  BOOST_CHECK_EQUAL(s.update(behind), 3);
+  BOOST_CHECK_EQUAL(s.update(behind), 4);
+  // upper bound
+  for (int i = 0; i < 10; ++i) {
+    BOOST_CHECK_EQUAL(s.update(behind), 4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fill_test) {
+  ProcessorScaler s(config());
+  // a high buffer fill counts as falling behind
+  const ProcessorLoad full{0, 2, 0.6};
+  s.update(full);
+  s.update(full);
+  BOOST_CHECK_EQUAL(s.update(full), 3);
+}
+
+BOOST_AUTO_TEST_CASE(hysteresis_test) {
+  ProcessorScaler s(config());
+  const ProcessorLoad behind{1, 2, 0.2};
+  const ProcessorLoad steady{0, 2, 0.2};
+  // an interruption restarts the count
+  s.update(behind);
+  s.update(behind);
+  s.update(steady);
+  s.update(behind);
+  BOOST_CHECK_EQUAL(s.update(behind), 2);
+  BOOST_CHECK_EQUAL(s.update(behind), 3);
+
+  // neither busy nor idle: no change
+  for (int i = 0; i < 20; ++i) {
+    BOOST_CHECK_EQUAL(s.update(steady), 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(scale_down_test) {
+  ProcessorScaler s(config());
+  const ProcessorLoad behind{1, 2, 0.2};
+  for (int i = 0; i < 6; ++i) {
+    s.update(behind);
+  }
+  BOOST_CHECK_EQUAL(s.instances(), 4);
+
+  // one idle instance is kept
+  const ProcessorLoad one_idle{0, 3, 0.05};
+  for (int i = 0; i < 20; ++i) {
+    BOOST_CHECK_EQUAL(s.update(one_idle), 4);
+  }
+
+  const ProcessorLoad idle{0, 0, 0.05};
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK_EQUAL(s.update(idle), 4);
+  }
+  BOOST_CHECK_EQUAL(s.update(idle), 3);
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK_EQUAL(s.update(idle), 3);
+  }
+  BOOST_CHECK_EQUAL(s.update(idle), 2);
+  // lower bound
+  for (int i = 0; i < 20; ++i) {
+    BOOST_CHECK_EQUAL(s.update(idle), 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test) {
+  ProcessorScaler::Config c = config();
+  c.min_instances = 0;
+  BOOST_CHECK_THROW(ProcessorScaler{c}, std::invalid_argument);
+  c = config();
+  c.max_instances = 1;
+  BOOST_CHECK_THROW(ProcessorScaler{c}, std::invalid_argument);
+  c = config();
+  c.scale_down_fill = c.scale_up_fill;
+  BOOST_CHECK_THROW(ProcessorScaler{c}, std::invalid_argument);
+}
@@ -0,0 +1,36 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_RailSelection
+#include <boost/test/unit_test.hpp>
+
+#include "RailSelection.hpp"
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(numa_local_test) {
+  RailSelection s({"10.0.0.1", "10.0.1.1"}, {0, 1});
+  BOOST_CHECK_EQUAL(s.select(1), "10.0.1.1");
+  BOOST_CHECK_EQUAL(s.select(1), "10.0.1.1");
+  BOOST_CHECK_EQUAL(s.select(0), "10.0.0.1");
+}
+
+BOOST_AUTO_TEST_CASE(balance_test) {
+  // channels with unknown or remote buffers are spread over the rails
+  RailSelection s({"10.0.0.1", "10.0.1.1"}, {0, 1});
+  BOOST_CHECK_EQUAL(s.select(-1), "10.0.0.1");
+  BOOST_CHECK_EQUAL(s.select(-1), "10.0.1.1");
+  BOOST_CHECK_EQUAL(s.select(2), "10.0.0.1");
+  BOOST_CHECK_EQUAL(s.load()[0], 2);
+  BOOST_CHECK_EQUAL(s.load()[1], 1);
+
+  // several rails on the same node are balanced as well
+  RailSelection t({"a", "b", "c"}, {0, 0, 1});
+  BOOST_CHECK_EQUAL(t.select(0), "a");
+  BOOST_CHECK_EQUAL(t.select(0), "b");
+  BOOST_CHECK_EQUAL(t.select(0), "a");
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test) {
+  BOOST_CHECK_THROW(RailSelection({"a"}, {}), std::invalid_argument);
+  RailSelection s({}, {});
+  BOOST_CHECK(s.empty());
+  BOOST_CHECK_THROW(s.select(0), std::logic_error);
+}
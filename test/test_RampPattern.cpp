@@ -0,0 +1,172 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_RampPattern
+#include <boost/test/unit_test.hpp>
+
+#include "FlesnetPatternChecker.hpp"
+#include "FlesnetPatternGenerator.hpp"
+#include "FlibPatternChecker.hpp"
+#include "MicrosliceView.hpp"
+#include "RampPattern.hpp"
+#include <vector>
+
+using ramp_pattern::SimdLevel;
+
+namespace {
+
+std::vector<SimdLevel> supported_levels() {
+  std::vector<SimdLevel> levels{SimdLevel::scalar};
+  if (ramp_pattern::supported_level() >= SimdLevel::avx2) {
+    levels.push_back(SimdLevel::avx2);
+  }
+  if (ramp_pattern::supported_level() >= SimdLevel::avx512) {
+    levels.push_back(SimdLevel::avx512);
+  }
+  return levels;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fill_test) {
+  const uint64_t first = UINT64_C(3) << 48;
+  for (SimdLevel level : supported_levels()) {
+    for (size_t words : {0, 1, 3, 4, 7, 8, 9, 31, 100}) {
+      // guard word after the filled range must not be touched
+      std::vector<uint64_t> buf(words + 1, 0xdeadbeef);
+      uint64_t x = ramp_pattern::fill(buf.data(), words, first, level);
+      uint64_t expected_x = 0;
+      for (size_t i = 0; i < words; ++i) {
+        BOOST_CHECK_EQUAL(buf[i], first + i * sizeof(uint64_t));
+        expected_x ^= buf[i];
+      }
+      BOOST_CHECK_EQUAL(buf[words], 0xdeadbeef);
+      BOOST_CHECK_EQUAL(x, expected_x);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(generator_test) {
+  const uint64_t input_index = 5;
+  FlesnetPatternGenerator gen(12, 5, input_index, 1001, true);
+  auto& data = gen.data_buffer();
+  auto& desc = gen.desc_buffer();
+  uint64_t checked = 0;
+
+  // several rounds, so that microslices wrap around the data buffer
+  for (int round = 0; round < 4; ++round) {
+    gen.proceed();
+    DualIndex written = gen.get_write_index();
+    BOOST_REQUIRE_GT(written.desc, checked);
+    for (; checked < written.desc; ++checked) {
+      const auto& d = desc.at(checked);
+      BOOST_CHECK_EQUAL(d.idx, checked);
+      BOOST_CHECK_EQUAL(d.size, 1000);
+      uint32_t crc = 0;
+      for (uint64_t i = 0; i < d.size; i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        for (uint64_t b = 0; b < sizeof(uint64_t); ++b) {
+          word |= static_cast<uint64_t>(data.at(d.offset + i + b)) << (8 * b);
+        }
+        BOOST_CHECK_EQUAL(word, (input_index << 48) | i);
+        crc ^= static_cast<uint32_t>(word ^ (word >> 32));
+      }
+      BOOST_CHECK_EQUAL(d.crc, crc);
+    }
+    gen.set_read_index(written);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(rate_limit_test) {
+  // one microslice is due immediately, the next only after an hour
+  FlesnetPatternGenerator gen(12, 5, 0, 64, true, false, 3600000000000);
+  gen.proceed();
+  BOOST_CHECK_EQUAL(gen.get_write_index().desc, 1);
+  gen.proceed();
+  BOOST_CHECK_EQUAL(gen.get_write_index().desc, 1);
+}
+
+BOOST_AUTO_TEST_CASE(check_test) {
+  const uint64_t first = UINT64_C(0xABCD) << 48;
+  std::vector<uint64_t> buf(37);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = first + i;
+  }
+  for (SimdLevel level : supported_levels()) {
+    auto r = ramp_pattern::check(buf.data(), buf.size(), first, 1, level);
+    BOOST_CHECK_EQUAL(r.errors, 0);
+    auto ref = ramp_pattern::check(buf.data(), buf.size(), first, 1,
+                                   SimdLevel::scalar);
+    BOOST_CHECK_EQUAL(r.xor_value, ref.xor_value);
+
+    // errors in the vector part and in the tail
+    auto bad = buf;
+    bad[13] ^= 1;
+    bad[14] ^= 2;
+    bad[36] = 0;
+    r = ramp_pattern::check(bad.data(), bad.size(), first, 1, level);
+    BOOST_CHECK_EQUAL(r.errors, 3);
+    BOOST_CHECK_EQUAL(r.first_error, 13);
+    bad[13] = buf[13];
+    bad[14] = buf[14];
+    r = ramp_pattern::check(bad.data(), bad.size(), first, 1, level);
+    BOOST_CHECK_EQUAL(r.errors, 1);
+    BOOST_CHECK_EQUAL(r.first_error, 36);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(flesnet_pattern_checker_test) {
+  const size_t component = 2;
+  std::vector<uint64_t> content(100);
+  uint64_t x = ramp_pattern::fill(content.data(), content.size(),
+                                  uint64_t(component) << 48);
+  fles::MicrosliceDescriptor desc{};
+  desc.size = static_cast<uint32_t>(content.size() * sizeof(uint64_t));
+  desc.crc = ramp_pattern::crc(x);
+  fles::MicrosliceView m(desc, reinterpret_cast<uint8_t*>(content.data()));
+
+  for (SimdLevel level : supported_levels()) {
+    FlesnetPatternChecker checker(component, level);
+    BOOST_CHECK(checker.check(m));
+    BOOST_CHECK_EQUAL(checker.error_count(), 0);
+
+    content[42] = 0;
+    content[77] = 0;
+    BOOST_CHECK(!checker.check(m));
+    BOOST_CHECK_EQUAL(checker.error_count(), 2);
+    BOOST_CHECK_EQUAL(checker.first_error_offset(), 42 * sizeof(uint64_t));
+    content[42] = (uint64_t(component) << 48) | (42 * sizeof(uint64_t));
+    content[77] = (uint64_t(component) << 48) | (77 * sizeof(uint64_t));
+
+    // a wrong crc is an error without content errors
+    desc.crc ^= 1;
+    BOOST_CHECK(!checker.check(m));
+    BOOST_CHECK_EQUAL(checker.error_count(), 0);
+    desc.crc ^= 1;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(flib_pattern_checker_test) {
+  // header word, 30 ramp words and a last word of 3 bytes
+  std::vector<uint64_t> content(32);
+  content[0] = (UINT64_C(1000) << 32) | (UINT64_C(0xBBFF) << 16) | 3;
+  for (size_t i = 1; i <= 30; ++i) {
+    content[i] = (UINT64_C(0xABCD) << 48) + i - 1;
+  }
+  content[31] = 0xFAFAFA;
+  fles::MicrosliceDescriptor desc{};
+  desc.size = 31 * sizeof(uint64_t) + 3;
+  fles::MicrosliceView m(desc, reinterpret_cast<uint8_t*>(content.data()));
+
+  for (SimdLevel level : supported_levels()) {
+    FlibPatternChecker checker(level);
+    BOOST_CHECK(checker.check(m));
+    BOOST_CHECK_EQUAL(checker.error_count(), 0);
+
+    checker.reset();
+    content[20] = 0;
+    BOOST_CHECK(!checker.check(m));
+    BOOST_CHECK_EQUAL(checker.error_count(), 1);
+    BOOST_CHECK_EQUAL(checker.first_error_offset(), 20 * sizeof(uint64_t));
+    content[20] = (UINT64_C(0xABCD) << 48) + 19;
+    checker.reset();
+  }
+}
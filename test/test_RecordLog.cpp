@@ -0,0 +1,72 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_RecordLog
+#include <boost/test/unit_test.hpp>
+
+#include "RecordLog.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::string temp_path() {
+  return "/tmp/test_RecordLog." + std::to_string(getpid()) + ".bin";
+}
+
+std::vector<char> read_file(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file),
+          std::istreambuf_iterator<char>()};
+}
+
+uint64_t word_at(const std::vector<char>& data, std::size_t offset) {
+  uint64_t w = 0;
+  std::memcpy(&w, data.data() + offset, sizeof(w));
+  return w;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(write_test) {
+  const std::string path = temp_path();
+  constexpr uint64_t count = 100000;
+  {
+    RecordLog log(path,
+                  {{"Timeslice", RecordLog::Type::Unsigned},
+                   {"Duration", RecordLog::Type::Double}},
+                  count);
+    for (uint64_t i = 0; i < count; ++i) {
+      log.append(i, static_cast<double>(i) / 2);
+    }
+    BOOST_CHECK_THROW(log.append(1), std::invalid_argument);
+    BOOST_CHECK_EQUAL(log.dropped(), 0);
+  }
+
+  std::vector<char> data = read_file(path);
+  std::remove(path.c_str());
+  const std::size_t header_size = 32 + 2 * 32;
+  BOOST_REQUIRE_EQUAL(data.size(), header_size + count * 16);
+  BOOST_CHECK(std::memcmp(data.data(), RecordLog::magic, 8) == 0);
+  BOOST_CHECK_EQUAL(word_at(data, 16), count);
+  BOOST_CHECK_EQUAL(word_at(data, 24), 0);
+  BOOST_CHECK_EQUAL(std::string(data.data() + 32), "Timeslice");
+  BOOST_CHECK_EQUAL(data[32 + 31], 'u');
+  BOOST_CHECK_EQUAL(std::string(data.data() + 64), "Duration");
+  BOOST_CHECK_EQUAL(data[64 + 31], 'd');
+
+  const uint64_t i = count - 1;
+  BOOST_CHECK_EQUAL(word_at(data, header_size + i * 16), i);
+  double d = 0;
+  std::memcpy(&d, data.data() + header_size + i * 16 + 8, sizeof(d));
+  BOOST_CHECK_EQUAL(d, static_cast<double>(i) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(open_failure_test) {
+  BOOST_CHECK_THROW(RecordLog("/nonexistent/log.bin", {{"Column"}}),
+                    std::runtime_error);
+}
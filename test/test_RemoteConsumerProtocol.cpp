@@ -0,0 +1,167 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_RemoteConsumerProtocol
+#include <boost/test/unit_test.hpp>
+
+#include "RemoteConsumerProtocol.hpp"
+#include "RemoteItemWindow.hpp"
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::vector<RemoteComponent> make_components(uint64_t ts, uint32_t n) {
+  std::vector<RemoteComponent> components;
+  for (uint32_t c = 0; c < n; ++c) {
+    components.push_back(
+        {1000 * c + ts, {ts, 100 * c, 8 * c + ts % 8, c + 1}});
+  }
+  return components;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(work_item_test) {
+  const uint32_t num_components = 3;
+  std::vector<uint8_t> buffer(remote_work_item_size(num_components));
+  BOOST_CHECK_EQUAL(buffer.size(),
+                    sizeof(RemoteWorkItem) + 3 * sizeof(RemoteComponent));
+
+  RemoteWorkItem item{17, {5, 500, 10, num_components}};
+  auto components = make_components(5, num_components);
+  encode_remote_work_item(buffer.data(), item, components);
+
+  std::vector<RemoteComponent> decoded;
+  RemoteWorkItem wi =
+      decode_remote_work_item(buffer.data(), num_components, decoded);
+  BOOST_CHECK_EQUAL(wi.id, 17);
+  BOOST_CHECK_EQUAL(wi.ts_desc.index, 5);
+  BOOST_CHECK_EQUAL(wi.ts_desc.ts_pos, 500);
+  BOOST_CHECK_EQUAL(wi.ts_desc.num_components, num_components);
+  BOOST_REQUIRE_EQUAL(decoded.size(), num_components);
+  for (uint32_t c = 0; c < num_components; ++c) {
+    BOOST_CHECK_EQUAL(decoded[c].offset, components[c].offset);
+    BOOST_CHECK_EQUAL(decoded[c].desc.offset, components[c].desc.offset);
+    BOOST_CHECK_EQUAL(decoded[c].desc.size, components[c].desc.size);
+  }
+
+  // a partial item uses the first part of the message
+  item.ts_desc.num_components = 1;
+  encode_remote_work_item(buffer.data(), item, make_components(6, 1));
+  decode_remote_work_item(buffer.data(), num_components, decoded);
+  BOOST_CHECK_EQUAL(decoded.size(), 1);
+
+  // more components than announced on connection
+  BOOST_CHECK_THROW(decode_remote_work_item(buffer.data(), 0, decoded),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(slot_layout_test) {
+  std::vector<RemoteComponent> components(4);
+  components[0].desc.size = 13;
+  components[1].desc.size = 0;
+  components[2].desc.size = 16;
+  components[3].desc.size = 1;
+  std::vector<uint64_t> offsets{99};
+  BOOST_CHECK_EQUAL(remote_slot_layout(components, offsets), 40);
+  const std::vector<uint64_t> expected{0, 16, 16, 32};
+  BOOST_CHECK_EQUAL_COLLECTIONS(offsets.begin(), offsets.end(),
+                                expected.begin(), expected.end());
+  components.clear();
+  BOOST_CHECK_EQUAL(remote_slot_layout(components, offsets), 0);
+  BOOST_CHECK(offsets.empty());
+}
+
+BOOST_AUTO_TEST_CASE(window_test) {
+  RemoteItemWindow window(3);
+  BOOST_CHECK_EQUAL(window.size(), 3);
+  BOOST_CHECK(!window.full());
+
+  BOOST_CHECK_EQUAL(window.acquire(10), 0);
+  BOOST_CHECK_EQUAL(window.acquire(11), 1);
+  BOOST_CHECK_THROW(window.acquire(10), std::runtime_error);
+  BOOST_CHECK_EQUAL(window.acquire(12), 2);
+  BOOST_CHECK(window.full());
+  BOOST_CHECK_EQUAL(window.outstanding(), 3);
+
+  uint32_t buffer = 99;
+  BOOST_CHECK(!window.release(13, buffer));
+  BOOST_CHECK_EQUAL(buffer, 99);
+  BOOST_CHECK(window.release(11, buffer));
+  BOOST_CHECK_EQUAL(buffer, 1);
+  BOOST_CHECK(!window.release(11, buffer));
+  BOOST_CHECK(!window.full());
+  BOOST_CHECK_EQUAL(window.outstanding(), 2);
+
+  // the buffer of a completed item is handed out next
+  BOOST_CHECK_EQUAL(window.acquire(13), 1);
+
+  window.clear();
+  BOOST_CHECK_EQUAL(window.outstanding(), 0);
+  BOOST_CHECK_EQUAL(window.acquire(14), 0);
+}
+
+// Server and consumer connected through in-memory message queues, with the
+// consumer completing the items in a different order
+BOOST_AUTO_TEST_CASE(loopback_test) {
+  const uint32_t num_components = 2;
+  const uint32_t window_size = 4;
+  const std::size_t item_size = remote_work_item_size(num_components);
+
+  RemoteItemWindow server(window_size);
+  std::vector<uint8_t> send_buffer(window_size * item_size);
+  RemoteItemWindow consumer(window_size);
+
+  std::deque<std::vector<uint8_t>> items_sent;
+  std::deque<uint64_t> completions_sent;
+  std::vector<uint64_t> consumed;
+
+  uint64_t next_id = 0;
+  const uint64_t num_items = 25;
+  while (consumed.size() < num_items) {
+    // server: forward items while the window is not full
+    while (!server.full() && next_id < num_items) {
+      uint64_t id = next_id++;
+      uint32_t buffer = server.acquire(id);
+      uint8_t* p = &send_buffer[buffer * item_size];
+      encode_remote_work_item(p, {id, {id, id * 10, 1, num_components}},
+                              make_components(id, num_components));
+      items_sent.emplace_back(p, p + item_size);
+    }
+    BOOST_CHECK_LE(server.outstanding(), window_size);
+
+    // consumer: receive the items into slots
+    std::vector<uint64_t> received;
+    while (!items_sent.empty()) {
+      std::vector<RemoteComponent> components;
+      RemoteWorkItem wi = decode_remote_work_item(
+          items_sent.front().data(), num_components, components);
+      items_sent.pop_front();
+      BOOST_CHECK_EQUAL(wi.ts_desc.index, wi.id);
+      BOOST_CHECK_EQUAL(components.size(), num_components);
+      BOOST_CHECK_EQUAL(components[1].offset, 1000 + wi.id);
+      BOOST_REQUIRE(!consumer.full());
+      BOOST_CHECK_LT(consumer.acquire(wi.id), window_size);
+      received.push_back(wi.id);
+    }
+
+    // consumer: complete the items, newest first
+    for (auto it = received.rbegin(); it != received.rend(); ++it) {
+      uint32_t slot = 0;
+      BOOST_REQUIRE(consumer.release(*it, slot));
+      completions_sent.push_back(*it);
+      consumed.push_back(*it);
+    }
+
+    // server: release the send buffers of the completed items
+    while (!completions_sent.empty()) {
+      uint32_t buffer = 0;
+      BOOST_CHECK(server.release(completions_sent.front(), buffer));
+      BOOST_CHECK_LT(buffer, window_size);
+      completions_sent.pop_front();
+    }
+  }
+  BOOST_CHECK_EQUAL(next_id, num_items);
+  BOOST_CHECK_EQUAL(server.outstanding(), 0);
+  BOOST_CHECK_EQUAL(consumer.outstanding(), 0);
+}
@@ -1,7 +1,12 @@
 // Copyright 2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "RingBuffer.hpp"
+#include "RingBufferView.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <type_traits>
 
 class Simple {
 public:
@@ -15,6 +20,41 @@ int main() {
     RingBuffer<Simple, false, true> s;
     s.alloc_with_size(4);
     std::printf("ptr: %p\n", static_cast<void*>(s.ptr()));
+
+    MemoryPlacement placement;
+    placement.hugepages = true;
+    placement.prefault = true;
+    RingBuffer<Simple> p(2, placement);
+    std::printf("ptr: %p\n", static_cast<void*>(p.ptr()));
+    if (reinterpret_cast<std::uintptr_t>(p.ptr()) % huge_page_size != 0 ||
+        p.at(7).i != 5) {
+      std::cerr << "unexpected placed buffer" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    MemoryPlacement mirror;
+    mirror.mirrored = true;
+    RingBuffer<uint8_t> m(16, mirror);
+    const char text[] = "wrapping";
+    std::copy_n(text, sizeof(text), &m.at(m.size() - 4));
+    if (!m.mirrored() || m.at(0) != 'p' ||
+        std::memcmp(&m.at(m.size() - 4), text, sizeof(text)) != 0) {
+      std::cerr << "unexpected mirrored buffer" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    RingBuffer<uint64_t> f(21);
+    RingBufferView<uint64_t> view(f.ptr(), f.size_exponent());
+    bool fixed = with_fixed_size(
+        view, common_data_size_exponents(), [](auto& v) {
+          v.at(v.size() + 3) = 42;
+          return !std::is_same_v<std::decay_t<decltype(v)>,
+                                 RingBufferView<uint64_t>>;
+        });
+    if (!fixed || f.at(3) != 42) {
+      std::cerr << "unexpected fixed-size view" << std::endl;
+      return EXIT_FAILURE;
+    }
   } catch (std::exception const& e) {
     std::cerr << e.what() << std::endl;
     return EXIT_FAILURE;
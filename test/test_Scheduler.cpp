@@ -0,0 +1,119 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_Scheduler
+#include <boost/test/unit_test.hpp>
+
+#include "Scheduler.hpp"
+#include <vector>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(one_shot_test) {
+  Scheduler s;
+  auto t0 = Scheduler::clock::now();
+  std::vector<int> fired;
+  s.add_after([&] { fired.push_back(2); }, 20ms);
+  s.add_after([&] { fired.push_back(1); }, 10ms);
+  s.add_after([&] { fired.push_back(3); }, 5s);
+  BOOST_CHECK_EQUAL(s.size(), 3);
+
+  s.timer(t0 + 5ms);
+  BOOST_CHECK(fired.empty());
+  s.timer(t0 + 15ms);
+  BOOST_CHECK(fired == std::vector<int>({1}));
+  s.timer(t0 + 4s);
+  BOOST_CHECK(fired == std::vector<int>({1, 2}));
+  s.timer(t0 + 6s);
+  BOOST_CHECK(fired == std::vector<int>({1, 2, 3}));
+  BOOST_CHECK_EQUAL(s.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(never_early_test) {
+  Scheduler s;
+  auto t0 = Scheduler::clock::now();
+  bool fired = false;
+  s.add_after([&] { fired = true; }, 10min);
+  // step through all levels of the wheel
+  for (auto t = t0; t < t0 + 10min - 10ms; t += 100ms) {
+    s.timer(t);
+  }
+  BOOST_CHECK(!fired);
+  s.timer(t0 + 10min + 10ms);
+  BOOST_CHECK(fired);
+}
+
+BOOST_AUTO_TEST_CASE(far_future_test) {
+  Scheduler s;
+  auto t0 = Scheduler::clock::now();
+  int fired = 0;
+  // beyond the range of the wheel
+  s.add_after([&] { ++fired; }, 48h);
+  s.timer(t0 + 47h);
+  BOOST_CHECK_EQUAL(fired, 0);
+  s.timer(t0 + 48h + 1s);
+  BOOST_CHECK_EQUAL(fired, 1);
+}
+
+BOOST_AUTO_TEST_CASE(repeating_test) {
+  Scheduler s;
+  auto t0 = Scheduler::clock::now();
+  int fired = 0;
+  s.add_repeating([&] { ++fired; }, 100ms);
+  for (auto t = t0; t < t0 + 1050ms; t += 1ms) {
+    s.timer(t);
+  }
+  BOOST_CHECK_EQUAL(fired, 10);
+  BOOST_CHECK_EQUAL(s.size(), 1);
+
+  // missed periods are skipped
+  s.timer(t0 + 10s);
+  BOOST_CHECK_EQUAL(fired, 11);
+  s.timer(t0 + 10s + 50ms);
+  BOOST_CHECK_EQUAL(fired, 11);
+  s.timer(t0 + 10s + 110ms);
+  BOOST_CHECK_EQUAL(fired, 12);
+}
+
+BOOST_AUTO_TEST_CASE(reschedule_from_callback_test) {
+  Scheduler s;
+  auto t0 = Scheduler::clock::now();
+  int fired = 0;
+  std::function<void()> cb = [&] {
+    ++fired;
+    s.add_after(cb, 0ms);
+  };
+  s.add_after(cb, 0ms);
+  for (int i = 1; i <= 10; ++i) {
+    // a timer added from a callback is due in the next tick at the earliest
+    s.timer(t0 + i * 10ms);
+    BOOST_CHECK_GE(fired, i);
+    int n = fired;
+    s.timer(t0 + i * 10ms);
+    BOOST_CHECK_EQUAL(fired, n);
+  }
+  BOOST_CHECK_EQUAL(s.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(poller_test) {
+  Scheduler s;
+  int polled = 0;
+  s.add_repeating([&] { ++polled; }, 0ms);
+  for (int i = 0; i < 1000; ++i) {
+    s.timer();
+  }
+  BOOST_CHECK_EQUAL(polled, 1000);
+  BOOST_CHECK_EQUAL(s.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(system_clock_test) {
+  Scheduler s;
+  bool fired = false;
+  s.add([&] { fired = true; },
+        std::chrono::system_clock::now() + std::chrono::milliseconds(20));
+  s.timer();
+  BOOST_CHECK(!fired);
+  auto end = Scheduler::clock::now() + 1s;
+  while (!fired && Scheduler::clock::now() < end) {
+    s.timer();
+  }
+  BOOST_CHECK(fired);
+}
@@ -0,0 +1,104 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_ShmAttachmentCache
+#include <boost/test/unit_test.hpp>
+
+#include "ShmAttachmentCache.hpp"
+#include "System.hpp"
+#include <boost/uuid/uuid_generators.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bi = boost::interprocess;
+
+namespace {
+
+// Shared memory segment as created by a TimesliceBuffer
+class Segment {
+public:
+  explicit Segment(std::string name,
+                   boost::uuids::uuid uuid = boost::uuids::random_generator()())
+      : name_(std::move(name)), uuid_(uuid) {
+    bi::shared_memory_object::remove(name_.c_str());
+    shm_ = std::make_unique<bi::managed_shared_memory>(bi::create_only,
+                                                       name_.c_str(), 65536);
+    shm_->construct<boost::uuids::uuid>(bi::unique_instance)(uuid_);
+  }
+
+  Segment(const Segment&) = delete;
+  void operator=(const Segment&) = delete;
+
+  ~Segment() { bi::shared_memory_object::remove(name_.c_str()); }
+
+  [[nodiscard]] const boost::uuids::uuid& uuid() const { return uuid_; }
+
+private:
+  std::string name_;
+  boost::uuids::uuid uuid_;
+  std::unique_ptr<bi::managed_shared_memory> shm_;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(restart_test) {
+  const std::string name =
+      "test_ShmAttachmentCache_" + std::to_string(fles::system::current_pid());
+  fles::ShmAttachmentCache cache;
+
+  auto first = std::make_unique<Segment>(name);
+  auto a1 = cache.attach(name, first->uuid());
+  BOOST_REQUIRE(a1);
+  BOOST_CHECK(a1->uuid() == first->uuid());
+  // reused by further timeslices and receivers
+  BOOST_CHECK_EQUAL(cache.attach(name, first->uuid()), a1);
+  BOOST_CHECK_EQUAL(cache.open_count(), 1);
+  auto shm = a1->shm(a1);
+  BOOST_CHECK(shm->find<boost::uuids::uuid>(bi::unique_instance).first !=
+              nullptr);
+
+  // buffer recreated while the old segment is still in use
+  const boost::uuids::uuid old_uuid = first->uuid();
+  first = nullptr;
+  Segment second(name);
+  auto a2 = cache.attach(name, second.uuid());
+  BOOST_REQUIRE(a2);
+  BOOST_CHECK(a2->uuid() == second.uuid());
+  BOOST_CHECK_EQUAL(cache.attach(name, old_uuid), a1);
+  BOOST_CHECK_EQUAL(cache.open_count(), 2);
+
+  // items of the released old segment are discarded, opening the shared
+  // memory only once
+  a1 = nullptr;
+  shm = nullptr;
+  BOOST_CHECK(!cache.attach(name, old_uuid));
+  BOOST_CHECK(!cache.attach(name, old_uuid));
+  BOOST_CHECK_EQUAL(cache.open_count(), 3);
+  BOOST_CHECK_EQUAL(cache.attach(name, second.uuid()), a2);
+}
+
+BOOST_AUTO_TEST_CASE(pool_test) {
+  const std::string name =
+      "test_ShmAttachmentCache_" + std::to_string(fles::system::current_pid());
+  fles::ShmAttachmentCache cache;
+
+  // two buffers referring to the segment of a pool
+  Segment pool(name + "_pool");
+  std::vector<std::unique_ptr<Segment>> buffers;
+  for (int i = 0; i < 2; ++i) {
+    const std::string buffer_name = name + "_" + std::to_string(i);
+    buffers.push_back(std::make_unique<Segment>(buffer_name, pool.uuid()));
+    bi::managed_shared_memory shm(bi::open_only, buffer_name.c_str());
+    const std::string pool_name = name + "_pool";
+    shm.construct_it<char>(fles::shm_pool_reference)[pool_name.size()](
+        pool_name.data());
+  }
+
+  auto a0 = cache.attach(name + "_0", pool.uuid());
+  BOOST_REQUIRE(a0);
+  BOOST_CHECK(a0->uuid() == pool.uuid());
+  // the pool is attached once for both buffers
+  BOOST_CHECK_EQUAL(cache.attach(name + "_1", pool.uuid()), a0);
+  BOOST_CHECK_EQUAL(cache.open_count(), 1);
+  auto shm = a0->shm(a0);
+  BOOST_CHECK(shm->find<char>(fles::shm_pool_reference).first == nullptr);
+}
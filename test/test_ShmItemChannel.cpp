@@ -0,0 +1,151 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_ShmItemChannel
+#include <boost/test/unit_test.hpp>
+
+#include "ShmItemChannel.hpp"
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+std::string channel_name() {
+  return "test_ShmItemChannel_" + std::to_string(::getpid());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(item_test) {
+  ShmItemChannel worker(channel_name(), 256);
+  ShmItemChannel distributor(channel_name());
+  BOOST_CHECK(!worker.has_items());
+
+  ItemID id{};
+  std::string payload;
+  BOOST_CHECK(!worker.pop_item(id, payload));
+
+  BOOST_CHECK(distributor.push_item(7, "payload"));
+  BOOST_CHECK(distributor.push_item(8, ""));
+  BOOST_CHECK(worker.has_items());
+  BOOST_REQUIRE(worker.pop_item(id, payload));
+  BOOST_CHECK_EQUAL(id, 7);
+  BOOST_CHECK_EQUAL(payload, "payload");
+  BOOST_REQUIRE(worker.pop_item(id, payload));
+  BOOST_CHECK_EQUAL(id, 8);
+  BOOST_CHECK(payload.empty());
+  BOOST_CHECK(!worker.pop_item(id, payload));
+
+  // records of 16 + 48 bytes, the ring wraps after four of them
+  const std::string large(40, 'x');
+  for (ItemID i = 0; i < 20; ++i) {
+    BOOST_REQUIRE(distributor.push_item(i, large + std::to_string(i)));
+    if (i % 3 == 2) {
+      // fill the ring up to the reader
+      ItemID n = i + 1;
+      while (distributor.push_item(n, large + std::to_string(n))) {
+        ++n;
+      }
+      BOOST_CHECK_GE(n, i + 2);
+      for (ItemID m = i; m < n; ++m) {
+        BOOST_REQUIRE(worker.pop_item(id, payload));
+        BOOST_CHECK_EQUAL(id, m);
+        BOOST_CHECK_EQUAL(payload, large + std::to_string(m));
+      }
+      i = n - 1;
+    } else {
+      BOOST_REQUIRE(worker.pop_item(id, payload));
+      BOOST_CHECK_EQUAL(id, i);
+    }
+  }
+  BOOST_CHECK(!worker.has_items());
+
+  // an item larger than the ring never fits
+  BOOST_CHECK(!distributor.push_item(1, std::string(300, 'y')));
+}
+
+BOOST_AUTO_TEST_CASE(completion_test) {
+  ShmItemChannel worker(channel_name(), 256);
+  ShmItemChannel distributor(channel_name());
+
+  // 256 / 16 completion slots
+  ItemID n = 0;
+  while (worker.push_completion(n)) {
+    ++n;
+  }
+  BOOST_CHECK_EQUAL(n, 16);
+  BOOST_CHECK(distributor.has_completions());
+  ItemID id{};
+  for (ItemID i = 0; i < n; ++i) {
+    BOOST_REQUIRE(distributor.pop_completion(id));
+    BOOST_CHECK_EQUAL(id, i);
+  }
+  BOOST_CHECK(!distributor.pop_completion(id));
+}
+
+BOOST_AUTO_TEST_CASE(accept_test) {
+  ShmItemChannel worker(channel_name(), 256);
+  BOOST_CHECK(!worker.accepted());
+  ShmItemChannel distributor(channel_name());
+  BOOST_CHECK(!worker.accepted());
+  distributor.accept();
+  BOOST_CHECK(worker.accepted());
+  BOOST_CHECK(distributor.accepted());
+}
+
+BOOST_AUTO_TEST_CASE(wait_test) {
+  ShmItemChannel worker(channel_name(), 256);
+  ShmItemChannel distributor(channel_name());
+
+  // no wakeup needed unless the other side is about to block
+  BOOST_CHECK(distributor.push_item(1, ""));
+  BOOST_CHECK(!distributor.wake_worker());
+  BOOST_CHECK(!worker.prepare_worker_wait());
+  ItemID id{};
+  std::string payload;
+  BOOST_CHECK(worker.pop_item(id, payload));
+
+  BOOST_CHECK(worker.prepare_worker_wait());
+  BOOST_CHECK(distributor.push_item(2, ""));
+  BOOST_CHECK(distributor.wake_worker());
+  BOOST_CHECK(!distributor.wake_worker());
+  worker.end_worker_wait();
+
+  BOOST_CHECK(distributor.prepare_distributor_wait());
+  distributor.end_distributor_wait();
+  BOOST_CHECK(!worker.wake_distributor());
+  BOOST_CHECK(distributor.prepare_distributor_wait());
+  BOOST_CHECK(worker.push_completion(2));
+  BOOST_CHECK(worker.wake_distributor());
+  BOOST_CHECK(!distributor.prepare_distributor_wait());
+}
+
+BOOST_AUTO_TEST_CASE(thread_test) {
+  ShmItemChannel worker(channel_name(), 1024);
+  ShmItemChannel distributor(channel_name());
+  constexpr ItemID count = 100000;
+
+  std::thread producer([&distributor] {
+    for (ItemID i = 0; i < count;) {
+      if (distributor.push_item(i, std::string(i % 50, 'a'))) {
+        ++i;
+      }
+    }
+  });
+  ItemID id{};
+  std::string payload;
+  bool ordered = true;
+  for (ItemID i = 0; i < count;) {
+    if (worker.pop_item(id, payload)) {
+      ordered = ordered && id == i && payload.size() == i % 50;
+      ++i;
+    }
+  }
+  producer.join();
+  BOOST_CHECK(ordered);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test) {
+  BOOST_CHECK_THROW(ShmItemChannel(channel_name(), 1000),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(ShmItemChannel{channel_name()}, std::exception);
+}
@@ -0,0 +1,53 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_SizeRecord
+#include <boost/test/unit_test.hpp>
+
+#include "SizeRecord.hpp"
+#include <sstream>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(series_test) {
+  std::istringstream is("# recorded microslices\n"
+                        "1000 100\n"
+                        "2000 200 # comment\n"
+                        "\n"
+                        "4000 300\n");
+  SizeRecord r = SizeRecord::parse(is);
+  BOOST_CHECK(r.series());
+  BOOST_CHECK_EQUAL(r.entries(), 3);
+  BOOST_CHECK_EQUAL(r.size(0, 0), 100);
+  BOOST_CHECK_EQUAL(r.size(2, 0), 300);
+  BOOST_CHECK_EQUAL(r.size(4, 0.9), 200);
+  BOOST_CHECK_EQUAL(r.time(0), 0);
+  BOOST_CHECK_EQUAL(r.time(2), 3000);
+  // period: index range plus mean step
+  BOOST_CHECK_EQUAL(r.time(3), 4500);
+  BOOST_CHECK_EQUAL(r.time(5), 7500);
+  BOOST_CHECK_CLOSE(r.mean_size(), 200, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_test) {
+  std::istringstream is("histogram 100 1\n"
+                        "histogram 1000 2\n"
+                        "histogram 100000 1\n");
+  SizeRecord r = SizeRecord::parse(is);
+  BOOST_CHECK(!r.series());
+  BOOST_CHECK_EQUAL(r.size(7, 0.0), 100);
+  BOOST_CHECK_EQUAL(r.size(7, 0.3), 1000);
+  BOOST_CHECK_EQUAL(r.size(7, 0.7), 1000);
+  BOOST_CHECK_EQUAL(r.size(7, 0.8), 100000);
+  BOOST_CHECK_EQUAL(r.size(7, 1.0), 100000);
+  BOOST_CHECK_EQUAL(r.time(7), 0);
+  BOOST_CHECK_CLOSE(r.mean_size(), 25525, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(parse_error_test) {
+  std::istringstream empty("# nothing\n");
+  BOOST_CHECK_THROW(SizeRecord::parse(empty), std::invalid_argument);
+  std::istringstream mixed("1000 100\nhistogram 100 1\n");
+  BOOST_CHECK_THROW(SizeRecord::parse(mixed), std::invalid_argument);
+  std::istringstream disorder("2000 100\n1000 100\n");
+  BOOST_CHECK_THROW(SizeRecord::parse(disorder), std::invalid_argument);
+  std::istringstream syntax("1000\n");
+  BOOST_CHECK_THROW(SizeRecord::parse(syntax), std::invalid_argument);
+}
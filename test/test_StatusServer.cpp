@@ -0,0 +1,123 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_StatusServer
+#include <boost/test/unit_test.hpp>
+
+#include "StatusServer.hpp"
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <string>
+#include <thread>
+
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+using namespace std::chrono_literals;
+
+static http::response<http::string_body>
+get(unsigned short port, const std::string& target,
+    http::verb method = http::verb::get) {
+  boost::asio::io_context ioc;
+  tcp::resolver resolver(ioc);
+  tcp::socket socket(ioc);
+  boost::asio::connect(socket, resolver.resolve("127.0.0.1",
+                                                std::to_string(port)));
+  http::request<http::empty_body> req{method, target, 11};
+  req.set(http::field::host, "localhost");
+  http::write(socket, req);
+  boost::beast::flat_buffer buffer;
+  http::response<http::string_body> res;
+  http::read(socket, buffer, res);
+  return res;
+}
+
+// Wait for the next rendering of the status.
+static std::string next_snapshot(StatusServer& server) {
+  auto previous = server.snapshot();
+  while (server.snapshot() == previous) {
+    std::this_thread::sleep_for(1ms);
+  }
+  return *server.snapshot();
+}
+
+BOOST_AUTO_TEST_CASE(instance_test) {
+  BOOST_CHECK(StatusServer::instance() == nullptr);
+  {
+    StatusServer server("127.0.0.1:0", 10ms);
+    BOOST_CHECK(StatusServer::instance() == &server);
+    BOOST_CHECK_THROW(StatusServer("127.0.0.1:0", 10ms), std::runtime_error);
+  }
+  BOOST_CHECK(StatusServer::instance() == nullptr);
+  BOOST_CHECK_THROW(StatusServer("no port", 10ms), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(status_test) {
+  StatusServer server("127.0.0.1:0", 5ms);
+  BOOST_REQUIRE_NE(server.port(), 0);
+
+  auto source = std::make_shared<BufferStatusSource>(1000, 100);
+  server.add_buffer("send_buffer", {{"input_index", "0"}}, source);
+  // desc: 10% freeing, 20% sending, 30% used, 40% free
+  source->desc.publish(1000, 1100, 1300, 1600);
+
+  auto connections = std::make_shared<ConnectionStatus>();
+  connections->phase.store("sending");
+  connections->connected.store(3);
+  connections->expected.store(4);
+  server.add_connections("sender", {{"host", "a\"b"}}, connections);
+
+  server.add_section("distributor_0", [](DumpBuffer& out) {
+    out.append("{\"held\":").dec(7).append('}');
+  });
+
+  std::string status = next_snapshot(server);
+  BOOST_CHECK(status.find("\"buffers\":[{\"name\":\"send_buffer\","
+                          "\"tags\":{\"input_index\":\"0\"},\"desc\":"
+                          "{\"size\":1000,\"written\":1600,\"sent\":1300,"
+                          "\"acked\":1100,\"cached_acked\":1000,"
+                          "\"used_pct\":30,\"sending_pct\":20,"
+                          "\"freeing_pct\":10,\"free_pct\":40,") !=
+              std::string::npos);
+  BOOST_CHECK(status.find("{\"name\":\"sender\",\"tags\":{\"host\":"
+                          "\"a\\\"b\"},\"phase\":\"sending\","
+                          "\"connected\":3,\"timewait\":0,\"expected\":4}") !=
+              std::string::npos);
+  BOOST_CHECK(status.find(",\"distributor_0\":{\"held\":7}}") !=
+              std::string::npos);
+
+  auto res = get(server.port(), "/status");
+  BOOST_CHECK_EQUAL(res.result_int(), 200);
+  BOOST_CHECK_EQUAL(res[http::field::content_type], "application/json");
+  BOOST_CHECK(res.body().find("\"distributor_0\"") != std::string::npos);
+  BOOST_CHECK_EQUAL(get(server.port(), "/metrics").result_int(), 404);
+
+  // removed once released
+  source.reset();
+  connections.reset();
+  next_snapshot(server);
+  status = next_snapshot(server);
+  BOOST_CHECK(status.find("\"buffers\":[],\"connections\":[]") !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(command_test) {
+  StatusServer server("127.0.0.1:0", 10ms);
+  server.add_command("resize", [](const StatusServer::CommandArguments& args) {
+    if (args.count("size") == 0u) {
+      throw std::invalid_argument("size required");
+    }
+    return "size " + args.at("size") + ", flag " +
+           std::to_string(args.count("flag"));
+  });
+
+  auto res = get(server.port(), "/resize?size=12&flag", http::verb::post);
+  BOOST_CHECK_EQUAL(res.result_int(), 200);
+  BOOST_CHECK_EQUAL(res[http::field::content_type], "text/plain");
+  BOOST_CHECK_EQUAL(res.body(), "size 12, flag 1\n");
+  res = get(server.port(), "/resize", http::verb::post);
+  BOOST_CHECK_EQUAL(res.result_int(), 400);
+  BOOST_CHECK_EQUAL(res.body(), "size required\n");
+  BOOST_CHECK_EQUAL(get(server.port(), "/other", http::verb::post).result_int(),
+                    404);
+  BOOST_CHECK_EQUAL(get(server.port(), "/resize?size=12").result_int(), 404);
+}
@@ -0,0 +1,62 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_StreamingQuantile
+#include <boost/test/unit_test.hpp>
+
+#include "StreamingQuantile.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(few_values_test) {
+  StreamingQuantile q(0.5);
+  BOOST_CHECK_EQUAL(q.value(), 0.0);
+  q.add(3.0);
+  BOOST_CHECK_EQUAL(q.value(), 3.0);
+  q.add(1.0);
+  q.add(2.0);
+  BOOST_CHECK_EQUAL(q.value(), 2.0);
+  BOOST_CHECK_EQUAL(q.count(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(uniform_test) {
+  std::vector<double> values(100000);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<double>(i);
+  }
+  std::mt19937 rng(42);
+  std::shuffle(values.begin(), values.end(), rng);
+
+  for (double p : {0.5, 0.9, 0.99}) {
+    StreamingQuantile q(p);
+    for (double v : values) {
+      q.add(v);
+    }
+    double expected = p * static_cast<double>(values.size());
+    BOOST_CHECK_CLOSE(q.value(), expected, 1.0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(exponential_test) {
+  std::mt19937 rng(7);
+  std::exponential_distribution<double> dist(1.0);
+  StreamingQuantile q(0.99);
+  for (int i = 0; i < 100000; ++i) {
+    q.add(dist(rng));
+  }
+  // P99 of the exponential distribution is ln(100)
+  BOOST_CHECK_CLOSE(q.value(), 4.605, 5.0);
+}
+
+BOOST_AUTO_TEST_CASE(reset_test) {
+  StreamingQuantile q(0.99);
+  for (int i = 0; i < 1000; ++i) {
+    q.add(1000.0);
+  }
+  q.reset();
+  BOOST_CHECK_EQUAL(q.count(), 0);
+  for (int i = 0; i < 1000; ++i) {
+    q.add(static_cast<double>(i % 10));
+  }
+  BOOST_CHECK_LE(q.value(), 9.0);
+  BOOST_CHECK_GE(q.value(), 8.0);
+}
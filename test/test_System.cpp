@@ -9,3 +9,11 @@ BOOST_AUTO_TEST_CASE(glob_test) {
   auto v = fles::system::glob(pattern);
   BOOST_CHECK_GE(v.size(), 1);
 }
+
+BOOST_AUTO_TEST_CASE(memory_of_numa_node_test) {
+  auto system = fles::system::memory_of_numa_node(-1);
+  BOOST_CHECK_GE(system.total, system.available);
+  auto unknown = fles::system::memory_of_numa_node(100000);
+  BOOST_CHECK_EQUAL(unknown.total, 0);
+  BOOST_CHECK_EQUAL(unknown.available, 0);
+}
@@ -2,17 +2,52 @@
 #define BOOST_TEST_MODULE test_Timeslice
 #include <boost/test/unit_test.hpp>
 
+#include "ComponentSelection.hpp"
 #include "MicrosliceView.hpp"
+#include "SelectedTimeslice.hpp"
 #include "StorableTimeslice.hpp"
 #include "System.hpp"
+#include "TimeOrderedMerge.hpp"
 #include "TimesliceInputArchive.hpp"
 #include "TimesliceOutputArchive.hpp"
+#include "UnpackerRegistry.hpp"
 #include <array>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <fstream>
 #include <string>
 
+namespace {
+
+// The member layout of StorableTimeslice as originally serialized
+struct LegacyTimeslice {
+  fles::TimesliceDescriptor timeslice_descriptor;
+  std::vector<std::vector<uint8_t>> data;
+  std::vector<fles::TimesliceComponentDescriptor> desc;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int /* version */) {
+    ar& timeslice_descriptor;
+    ar& data;
+    ar& desc;
+  }
+};
+
+// Sums the first content byte of all microslices of its components
+template <fles::Subsystem SysId, int SysVer = fles::any_sys_ver>
+struct SumUnpacker : fles::UnpackerFormat<SysId, SysVer> {
+  void unpack(uint64_t component, const fles::ComponentView& view) {
+    components.push_back(component);
+    for (auto [desc, content] : view) {
+      sum += content[0];
+    }
+  }
+  std::vector<uint64_t> components;
+  uint64_t sum = 0;
+};
+
+} // namespace
+
 struct F {
   F() {
     // initialize microslice descriptors (for individual meaning cf.
@@ -78,6 +113,169 @@ BOOST_FIXTURE_TEST_CASE(content_access_test, F) {
   BOOST_CHECK_EQUAL(*ts0.content(1, 0), 3);
 }
 
+BOOST_FIXTURE_TEST_CASE(component_view_test, F) {
+  fles::ComponentView view = ts0.component(0);
+  BOOST_CHECK_EQUAL(view.size(), 2);
+  BOOST_CHECK_EQUAL(view.descriptor(1).idx, 2);
+  BOOST_CHECK_EQUAL(view.content(1), ts0.content(0, 1));
+  BOOST_CHECK_EQUAL(view[0].content, ts0.content(0, 0));
+
+  std::vector<uint64_t> idx;
+  std::vector<const uint8_t*> content;
+  for (auto [desc, ptr] : view) {
+    idx.push_back(desc.idx);
+    content.push_back(ptr);
+  }
+  BOOST_CHECK_EQUAL(idx.size(), 2);
+  BOOST_CHECK_EQUAL(idx.at(0), 1);
+  BOOST_CHECK_EQUAL(idx.at(1), 2);
+  BOOST_CHECK_EQUAL(*content.at(0), 7);
+  BOOST_CHECK_EQUAL(*content.at(1), 11);
+
+  fles::StorableTimeslice empty{1};
+  empty.append_component(0);
+  BOOST_CHECK(empty.component(0).empty());
+  BOOST_CHECK(empty.component(0).begin() == empty.component(0).end());
+}
+
+BOOST_FIXTURE_TEST_CASE(window_test, F) {
+  std::vector<fles::ComponentView> views = ts0.window(2, 3);
+  BOOST_REQUIRE_EQUAL(views.size(), 2);
+  BOOST_REQUIRE_EQUAL(views[0].size(), 1);
+  BOOST_CHECK_EQUAL(views[0].descriptor(0).idx, 2);
+  BOOST_CHECK_EQUAL(views[0].content(0), ts0.content(0, 1));
+  BOOST_CHECK(views[1].empty());
+
+  BOOST_CHECK_EQUAL(ts0.window(0, 10)[0].size(), 2);
+  BOOST_CHECK(ts0.window(0, 1)[0].empty());
+  BOOST_CHECK(ts0.window(3, 10)[0].empty());
+  BOOST_CHECK_EQUAL(ts0.window(1, 2)[1][0].content, ts0.content(1, 0));
+  fles::ComponentView sub = ts0.component(0).subview(1, 1);
+  BOOST_CHECK_EQUAL(*sub.content(0), 11);
+}
+
+BOOST_FIXTURE_TEST_CASE(time_ordered_merge_test, F) {
+  std::vector<uint64_t> components;
+  std::vector<uint64_t> idx;
+  std::vector<uint8_t> first_byte;
+  for (auto [c, ms] : fles::TimeOrderedMerge(ts0.window(0, 10))) {
+    components.push_back(c);
+    idx.push_back(ms.desc.idx);
+    first_byte.push_back(*ms.content);
+  }
+  BOOST_CHECK(components == (std::vector<uint64_t>{0, 1, 0}));
+  BOOST_CHECK(idx == (std::vector<uint64_t>{1, 1, 2}));
+  BOOST_CHECK(first_byte == (std::vector<uint8_t>{7, 3, 11}));
+
+  fles::TimeOrderedMerge none(ts0.window(5, 10));
+  BOOST_CHECK(none.empty());
+  BOOST_CHECK(none.begin() == none.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(component_index_test, F) {
+  fles::MicrosliceDescriptor desc_d = desc_c;
+  desc_d.eq_id = 12;
+  desc_d.sys_id = static_cast<uint8_t>(fles::Subsystem::TOF);
+  uint32_t tof = ts0.append_component(1, 1);
+  const fles::ComponentIndex& before = ts0.component_index();
+  BOOST_CHECK(before.components(desc_d.sys_id).empty());
+  ts0.append_microslice(tof, 0, desc_d, data_c.data());
+  ts0.append_component(0, 1);
+
+  const fles::ComponentIndex& index = ts0.component_index();
+  BOOST_CHECK_EQUAL(&index, &ts0.component_index());
+  auto fles = index.components(desc_a.sys_id);
+  BOOST_REQUIRE_EQUAL(fles.size(), 2);
+  BOOST_CHECK_EQUAL(*fles.begin(), 0);
+  BOOST_CHECK_EQUAL(*(fles.begin() + 1), 1);
+  auto tofs = index.components(desc_d.sys_id);
+  BOOST_REQUIRE_EQUAL(tofs.size(), 1);
+  BOOST_CHECK_EQUAL(*tofs.begin(), tof);
+  BOOST_CHECK(index.components(0xff).empty());
+
+  BOOST_CHECK_EQUAL(index.component(11).value_or(99), 1);
+  BOOST_CHECK_EQUAL(index.component(12).value_or(99), tof);
+  BOOST_CHECK(!index.component(13));
+
+  fles::ComponentSelection selection;
+  selection.add_sys_id(desc_d.sys_id);
+  selection.add_sys_id(desc_a.sys_id);
+  std::vector<uint64_t> selected = selection.components(ts0);
+  std::vector<uint64_t> expected{0, 1, tof};
+  BOOST_CHECK_EQUAL_COLLECTIONS(selected.begin(), selected.end(),
+                                expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(component_index_serialization_test, F) {
+  fles::MicrosliceDescriptor desc_d = desc_c;
+  desc_d.eq_id = 12;
+  desc_d.sys_id = static_cast<uint8_t>(fles::Subsystem::TOF);
+  fles::StorableTimeslice ts1{1, 2};
+  ts1.append_component(1, 2);
+  ts1.append_microslice(0, 0, desc_d, data_c.data());
+  // the index cached before loading must not survive it
+  BOOST_CHECK_EQUAL(ts1.component_index().component(12).value_or(99), 0);
+
+  std::stringstream s;
+  boost::archive::binary_oarchive oa(s);
+  oa << ts0;
+  boost::archive::binary_iarchive ia(s);
+  ia >> ts1;
+
+  const fles::ComponentIndex& index = ts1.component_index();
+  BOOST_CHECK(!index.component(12));
+  BOOST_CHECK(index.components(desc_d.sys_id).empty());
+  BOOST_CHECK_EQUAL(index.components(desc_a.sys_id).size(), 2);
+  auto c = index.component(11);
+  BOOST_REQUIRE(c);
+  BOOST_CHECK_EQUAL(*ts1.content(*c, 0), 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(unpacker_registry_test, F) {
+  constexpr int uninitialized =
+      static_cast<int>(fles::SubsystemFormatFLES::Uninitialized);
+  using FlesUnpacker = SumUnpacker<fles::Subsystem::FLES, uninitialized>;
+  using AnyFlesUnpacker = SumUnpacker<fles::Subsystem::FLES>;
+  using TofUnpacker = SumUnpacker<fles::Subsystem::TOF>;
+  using Registry =
+      fles::UnpackerRegistry<FlesUnpacker, AnyFlesUnpacker, TofUnpacker>;
+
+  auto fles_id = static_cast<uint8_t>(fles::Subsystem::FLES);
+  BOOST_CHECK_EQUAL(Registry::find(fles_id, uninitialized), 0);
+  BOOST_CHECK_EQUAL(Registry::find(fles_id, 0x81), 1);
+  BOOST_CHECK_EQUAL(Registry::find(0xff, 0), Registry::npos);
+
+  // components: 0 (a, b), 1 (c), 2 (d, other version), 3 (TOF), 4 (STS)
+  fles::MicrosliceDescriptor desc_d = desc_c;
+  desc_d.sys_ver = 0x81;
+  ts0.append_component(1, 1);
+  ts0.append_microslice(2, 0, desc_d, data_c.data());
+  desc_d.sys_id = static_cast<uint8_t>(fles::Subsystem::TOF);
+  ts0.append_component(1, 1);
+  ts0.append_microslice(3, 0, desc_d, data_b.data());
+  desc_d.sys_id = static_cast<uint8_t>(fles::Subsystem::STS);
+  ts0.append_component(1, 1);
+  ts0.append_microslice(4, 0, desc_d, data_a.data());
+  ts0.append_component(0, 1);
+
+  Registry registry;
+  BOOST_CHECK_EQUAL(registry.unpack(ts0), 4);
+  BOOST_CHECK(registry.get<0>().components ==
+              (std::vector<uint64_t>{0, 1}));
+  BOOST_CHECK_EQUAL(registry.get<0>().sum, 7 + 11 + 3);
+  BOOST_CHECK(registry.get<1>().components == std::vector<uint64_t>{2});
+  BOOST_CHECK_EQUAL(registry.get<1>().sum, 3);
+  BOOST_CHECK(registry.get<2>().components == std::vector<uint64_t>{3});
+  BOOST_CHECK_EQUAL(registry.get<2>().sum, 11);
+
+  Registry single;
+  BOOST_CHECK(single.unpack(ts0, 3));
+  BOOST_CHECK(!single.unpack(ts0, 4));
+  BOOST_CHECK(!single.unpack(ts0, 5));
+  BOOST_CHECK(single.get<2>().components == std::vector<uint64_t>{3});
+  BOOST_CHECK(single.get<0>().components.empty());
+}
+
 BOOST_FIXTURE_TEST_CASE(start_time_test, F) {
   BOOST_CHECK_EQUAL(ts0.start_time(), 1);
 }
@@ -103,8 +301,125 @@ BOOST_FIXTURE_TEST_CASE(serialization_test, F) {
   BOOST_CHECK_EQUAL(*ts1.content(1, 0), 3);
 }
 
+BOOST_FIXTURE_TEST_CASE(serialization_format_test, F) {
+  // the serialized timeslice is readable with the original member layout
+  LegacyTimeslice legacy;
+  {
+    std::stringstream s;
+    boost::archive::binary_oarchive oa(s);
+    oa << ts0;
+    boost::archive::binary_iarchive ia(s);
+    ia >> legacy;
+  }
+  BOOST_CHECK_EQUAL(legacy.timeslice_descriptor.num_components, 2);
+  BOOST_REQUIRE_EQUAL(legacy.data.size(), 2);
+  BOOST_CHECK_EQUAL(legacy.data[1].size(), ts0.size_component(1));
+  BOOST_REQUIRE_EQUAL(legacy.desc.size(), 2);
+  BOOST_CHECK_EQUAL(legacy.desc[0].num_microslices, 2);
+  BOOST_CHECK_EQUAL(legacy.desc[1].size, ts0.size_component(1));
+
+  // twice, as class information is only written once per archive
+  std::stringstream expected;
+  boost::archive::binary_oarchive oa_expected(expected);
+  oa_expected << legacy << legacy;
+
+  const fles::Timeslice& source = ts0;
+  std::stringstream s;
+  boost::archive::binary_oarchive oa(s);
+  oa << ts0 << fles::serializable(source);
+
+  BOOST_CHECK(s.str() == expected.str());
+}
+
+BOOST_FIXTURE_TEST_CASE(component_selection_test, F) {
+  fles::ComponentSelection all;
+  BOOST_CHECK(all.selects_all());
+  BOOST_CHECK(all.selects(ts0, 1));
+
+  fles::ComponentSelection by_eq_id;
+  BOOST_CHECK(by_eq_id.parse("eq_id", "0xb,12"));
+  BOOST_CHECK(!by_eq_id.parse("hwm", "1"));
+  BOOST_CHECK(!by_eq_id.selects_all());
+  BOOST_CHECK(!by_eq_id.selects(ts0, 0));
+  BOOST_CHECK(by_eq_id.selects(ts0, 1));
+  BOOST_CHECK(!by_eq_id.selects(1, 0, nullptr));
+
+  fles::ComponentSelection by_index;
+  by_index.parse("component", "0");
+  by_index.add_sys_id(static_cast<uint8_t>(fles::Subsystem::FLES));
+  BOOST_CHECK(by_index.components(ts0) == std::vector<uint64_t>{0});
+
+  BOOST_CHECK_THROW(by_index.parse("sys_id", "0x100"), std::runtime_error);
+  BOOST_CHECK_THROW(by_index.parse("eq_id", "1,x"), std::runtime_error);
+  BOOST_CHECK_THROW(by_index.parse("component", ""), std::runtime_error);
+}
+
+BOOST_FIXTURE_TEST_CASE(selected_timeslice_test, F) {
+  auto source = std::make_shared<const fles::StorableTimeslice>(
+      static_cast<const fles::Timeslice&>(ts0));
+  fles::ComponentSelection selection;
+  selection.add_eq_id(11);
+  fles::SelectedTimeslice ts(source, selection);
+
+  BOOST_CHECK_EQUAL(ts.index(), 1);
+  BOOST_REQUIRE_EQUAL(ts.num_components(), 1);
+  BOOST_CHECK_EQUAL(ts.num_microslices(0), 1);
+  BOOST_CHECK_EQUAL(ts.descriptor(0, 0).eq_id, 11);
+  BOOST_CHECK_EQUAL(ts.content(0, 0), source->content(1, 0));
+
+  // only the selected component is serialized
+  std::stringstream s;
+  {
+    boost::archive::binary_oarchive oa(s);
+    oa << fles::serializable(ts);
+  }
+  fles::StorableTimeslice ts1{0};
+  boost::archive::binary_iarchive ia(s);
+  ia >> ts1;
+  BOOST_REQUIRE_EQUAL(ts1.num_components(), 1);
+  BOOST_CHECK_EQUAL(ts1.content(0, 0)[2], 5);
+}
+
+BOOST_FIXTURE_TEST_CASE(selected_window_test, F) {
+  auto source = std::make_shared<const fles::StorableTimeslice>(
+      static_cast<const fles::Timeslice&>(ts0));
+  auto window = std::make_shared<const fles::SelectedTimeslice>(source, 2, 3);
+
+  BOOST_REQUIRE_EQUAL(window->num_components(), 2);
+  BOOST_REQUIRE_EQUAL(window->num_microslices(0), 1);
+  BOOST_CHECK_EQUAL(window->descriptor(0, 0).idx, 2);
+  BOOST_CHECK_EQUAL(window->content(0, 0), source->content(0, 1));
+  BOOST_CHECK_EQUAL(window->get_microslice(0, 0).content()[0], 11);
+  BOOST_CHECK(window->missing_component(1));
+
+  // selecting components from the window refers to the same data
+  fles::ComponentSelection selection;
+  selection.add_eq_id(10);
+  fles::SelectedTimeslice ts(window, selection);
+  BOOST_REQUIRE_EQUAL(ts.num_components(), 1);
+  BOOST_CHECK_EQUAL(ts.content(0, 0), source->content(0, 1));
+
+  // only the selected microslices are copied and serialized
+  fles::StorableTimeslice copy(ts);
+  BOOST_REQUIRE_EQUAL(copy.num_microslices(0), 1);
+  BOOST_CHECK_EQUAL(copy.content(0, 0)[0], 11);
+  std::stringstream s;
+  {
+    boost::archive::binary_oarchive oa(s);
+    oa << fles::serializable(ts);
+  }
+  fles::StorableTimeslice ts1{0};
+  boost::archive::binary_iarchive ia(s);
+  ia >> ts1;
+  BOOST_REQUIRE_EQUAL(ts1.num_components(), 1);
+  BOOST_REQUIRE_EQUAL(ts1.num_microslices(0), 1);
+  BOOST_CHECK_EQUAL(ts1.descriptor(0, 0).idx, 2);
+  BOOST_CHECK_EQUAL(ts1.content(0, 0)[0], 11);
+}
+
 BOOST_FIXTURE_TEST_CASE(archive_test, F) {
-  auto ts0_ptr = std::make_shared<const fles::StorableTimeslice>(ts0);
+  auto ts0_ptr =
+      std::make_shared<const fles::StorableTimeslice>(std::move(ts0));
 
   std::string filename("test1.tsa");
   {
@@ -146,6 +461,38 @@ BOOST_FIXTURE_TEST_CASE(microslice_storage_test, F) {
   BOOST_CHECK_EQUAL(ts0.descriptor(c, 0).size, 1);
 }
 
+BOOST_FIXTURE_TEST_CASE(storage_pool_test, F) {
+  auto pool = std::make_shared<fles::TimesliceStoragePool>();
+  const fles::Timeslice& source = ts0;
+  const uint8_t* first_buffer = nullptr;
+  {
+    fles::StorableTimeslice copy(source, pool);
+    BOOST_CHECK_EQUAL(*copy.content(0, 1), 11);
+    first_buffer = copy.content(0, 0);
+    // moving keeps the buffers
+    fles::StorableTimeslice moved(std::move(copy));
+    BOOST_CHECK_EQUAL(moved.content(0, 0), first_buffer);
+  }
+  BOOST_CHECK_EQUAL(pool->statistics().buffers, 2);
+
+  // a timeslice of the same size reuses the buffers
+  fles::StorableTimeslice ts{1, 2, UINT64_MAX, pool};
+  ts.reserve(2);
+  ts.append_component(2, 0, data_a.size() + data_b.size());
+  ts.append_microslice(0, 0, desc_a, data_a.data());
+  ts.append_microslice(0, 1, desc_b, data_b.data());
+  ts.append_component(1, 0, data_c.size());
+  ts.append_microslice(1, 0, desc_c, data_c.data());
+  BOOST_CHECK_EQUAL(*ts.content(0, 1), 11);
+  BOOST_CHECK_EQUAL(*ts.content(1, 0), 3);
+  BOOST_CHECK_EQUAL(ts.descriptor(0, 1).offset, data_a.size());
+
+  auto s = pool->statistics();
+  BOOST_CHECK_EQUAL(s.allocated, 2);
+  BOOST_CHECK_EQUAL(s.reused, 2);
+  BOOST_CHECK_EQUAL(s.buffers, 0);
+}
+
 BOOST_AUTO_TEST_CASE(reference_file_existence_test) {
   std::string filename("example1.tsa");
   BOOST_CHECK_NO_THROW(fles::TimesliceInputArchive source(filename));
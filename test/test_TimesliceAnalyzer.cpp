@@ -0,0 +1,138 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimesliceAnalyzer
+#include <boost/test/unit_test.hpp>
+
+#include "RampPattern.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceAnalyzer.hpp"
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t num_components = 16;
+constexpr size_t num_microslices = 4;
+constexpr size_t words = 64;
+
+// Timeslice with valid ramp pattern content, except for the given
+// (component, microslice) pairs, and with the FLIM overflow flag set in
+// the truncated ones
+std::shared_ptr<fles::StorableTimeslice>
+make_timeslice(uint64_t index,
+               const std::vector<std::pair<size_t, size_t>>& errors,
+               const std::vector<std::pair<size_t, size_t>>& truncated = {}) {
+  auto ts = std::make_shared<fles::StorableTimeslice>(num_microslices, index);
+  std::vector<uint64_t> content(words);
+  for (size_t c = 0; c < num_components; ++c) {
+    ts->append_component(num_microslices, index);
+    for (size_t m = 0; m < num_microslices; ++m) {
+      uint64_t x =
+          ramp_pattern::fill(content.data(), content.size(), uint64_t(c) << 48);
+      for (const auto& e : errors) {
+        if (e == std::make_pair(c, m)) {
+          content[7] = 0;
+        }
+      }
+      fles::MicrosliceDescriptor desc{};
+      desc.hdr_id = 0xdd;
+      desc.hdr_ver = 0x01;
+      desc.eq_id = static_cast<uint16_t>(c);
+      desc.sys_id = static_cast<uint8_t>(fles::Subsystem::FLES);
+      desc.sys_ver =
+          static_cast<uint8_t>(fles::SubsystemFormatFLES::BasicRampPattern);
+      desc.idx = (index * num_microslices + m) * 1000;
+      desc.crc = ramp_pattern::crc(x);
+      desc.size = static_cast<uint32_t>(words * sizeof(uint64_t));
+      for (const auto& t : truncated) {
+        if (t == std::make_pair(c, m)) {
+          desc.flags =
+              static_cast<uint16_t>(fles::MicrosliceFlags::OverflowFlim);
+        }
+      }
+      ts->append_microslice(c, m, desc,
+                            reinterpret_cast<uint8_t*>(content.data()));
+    }
+  }
+  return ts;
+}
+
+std::string analyze(unsigned num_threads, std::string& hist) {
+  std::ostringstream out;
+  std::ostringstream hist_out;
+  {
+    TimesliceAnalyzer analyzer(1, out, "", &hist_out, nullptr, num_threads);
+    analyzer.put(make_timeslice(0, {}));
+    analyzer.put(make_timeslice(1, {{3, 1}, {11, 2}, {11, 3}}));
+    analyzer.put(make_timeslice(2, {}));
+  }
+  hist = hist_out.str();
+  return out.str();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(parallel_test) {
+  std::string hist_sequential;
+  std::string out_sequential = analyze(1, hist_sequential);
+  BOOST_CHECK_NE(out_sequential.find("ts1/c3/m1: pattern error"),
+                 std::string::npos);
+  BOOST_CHECK_NE(out_sequential.find("[with errors: 1ts/2c/3m]"),
+                 std::string::npos);
+
+  // identical output, in identical order
+  std::string hist_parallel;
+  std::string out_parallel = analyze(4, hist_parallel);
+  BOOST_CHECK_EQUAL(out_parallel, out_sequential);
+  BOOST_CHECK_EQUAL(hist_parallel, hist_sequential);
+}
+
+BOOST_AUTO_TEST_CASE(descriptors_only_test) {
+  std::ostringstream out;
+  {
+    TimesliceAnalyzer analyzer(1, out, "", nullptr, nullptr, 1, true);
+    // content errors are not detected without content access
+    analyzer.put(make_timeslice(0, {{3, 1}}));
+    analyzer.put(make_timeslice(1, {}, {{5, 2}}));
+    analyzer.put(make_timeslice(2, {}));
+  }
+  std::string s = out.str();
+  BOOST_CHECK_EQUAL(s.find("pattern error"), std::string::npos);
+  BOOST_CHECK_NE(s.find("ts1/c5/m2: microslice truncated by FLIM"),
+                 std::string::npos);
+  BOOST_CHECK_NE(s.find("[with errors: 1ts/1c/1m]"), std::string::npos);
+  BOOST_CHECK_NE(s.find("c5: eq_id=0x5 sys_id=0xf0 sys_ver=0x81: 12 "
+                        "microslices"),
+                 std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(crc_checked_test) {
+  constexpr auto crc_valid =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+  constexpr auto crc_checked =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked);
+  constexpr auto crc_error =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcError);
+
+  // the results of a CRC validation upstream are used as they are
+  auto ts = make_timeslice(0, {});
+  auto set = [&ts](size_t c, size_t m, uint16_t flags, uint32_t crc_xor) {
+    auto& desc = const_cast<fles::MicrosliceDescriptor&>(ts->descriptor(c, m));
+    desc.flags = flags;
+    desc.crc ^= crc_xor;
+  };
+  set(2, 1, crc_valid | crc_checked | crc_error, 0);
+  set(4, 0, crc_valid | crc_checked, 1);
+  set(6, 3, crc_valid, 1);
+
+  std::ostringstream out;
+  {
+    TimesliceAnalyzer analyzer(1, out, "", nullptr, nullptr);
+    analyzer.put(ts);
+  }
+  std::string s = out.str();
+  BOOST_CHECK_NE(s.find("ts0/c2/m1: crc failure"), std::string::npos);
+  BOOST_CHECK_EQUAL(s.find("ts0/c4/m0: crc failure"), std::string::npos);
+  BOOST_CHECK_NE(s.find("ts0/c6/m3: crc failure"), std::string::npos);
+}
@@ -41,8 +41,35 @@ BOOST_AUTO_TEST_CASE(merging_input_archive_test) {
   BOOST_CHECK_EQUAL(count, 8);
 }
 
+BOOST_AUTO_TEST_CASE(merging_prefetch_test) {
+  fles::TimesliceAutoSource source(
+      "test2_%n.tsa?merge=time&merge_prefetch=2;example1.tsa");
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 8);
+
+  BOOST_CHECK_THROW(
+      fles::TimesliceAutoSource("test2_%n.tsa?merge=none;example1.tsa"),
+      std::out_of_range);
+}
+
 BOOST_AUTO_TEST_CASE(invalid_input_archive_test) {
   std::string filename("./example1.msa");
   BOOST_CHECK_THROW(fles::TimesliceAutoSource source(filename),
                     std::runtime_error);
 }
+
+BOOST_AUTO_TEST_CASE(component_selection_test) {
+  fles::TimesliceAutoSource source("example1.tsa?component=1");
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    BOOST_CHECK_EQUAL(timeslice->num_components(), 1);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 2);
+
+  BOOST_CHECK_THROW(fles::TimesliceAutoSource("example1.tsa?sys_id=256"),
+                    std::runtime_error);
+}
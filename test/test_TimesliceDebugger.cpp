@@ -0,0 +1,104 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimesliceDebugger
+#include <boost/test/unit_test.hpp>
+
+#include "StorableTimeslice.hpp"
+#include "TimesliceDebugger.hpp"
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+std::shared_ptr<const fles::Timeslice> make_timeslice() {
+  fles::StorableTimeslice ts(1, 5);
+  for (uint16_t c = 0; c < 3; ++c) {
+    uint64_t component = ts.append_component(2);
+    for (uint64_t m = 0; m < 2; ++m) {
+      std::vector<uint8_t> content(3 + 35 * m + c);
+      for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<uint8_t>(i + c);
+      }
+      fles::MicrosliceDescriptor desc{
+          0xdd, 0x01, static_cast<uint16_t>(0x10 + c), 0, 0x40, 1, 100 + m, 0,
+          static_cast<uint32_t>(content.size()), 0};
+      ts.append_microslice(component, m, desc, content.data());
+    }
+  }
+  return std::make_shared<fles::StorableTimeslice>(std::move(ts));
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(descriptor_text_test) {
+  fles::MicrosliceDescriptor desc{0xdd,   0x01, 0x1234, 0x5, 0x40,
+                                  0x02,   0xab, 0xcd,   0x3, 0x10};
+  std::ostringstream s;
+  s << MicrosliceDescriptorDump(desc);
+  BOOST_CHECK_EQUAL(
+      s.str(),
+      "hi hv eqid flag si sv idx/start        crc      size     offset\n"
+      "dd 01 1234 0005 40 02 00000000000000ab 000000cd 00000003 "
+      "0000000000000010\n");
+}
+
+BOOST_AUTO_TEST_CASE(buffer_text_test) {
+  std::vector<uint8_t> content(33);
+  for (size_t i = 0; i < content.size(); ++i) {
+    content[i] = static_cast<uint8_t>(i);
+  }
+  std::ostringstream s;
+  s << BufferDump(content.data(), content.size());
+  BOOST_CHECK_EQUAL(s.str(),
+                    "1f1e1d1c1b1a1918  1716151413121110  0f0e0d0c0b0a0908  "
+                    "0706050403020100  :0000\n" +
+                        std::string(68, ' ') + "20  :0020\n");
+}
+
+BOOST_AUTO_TEST_CASE(parallel_text_test) {
+  auto ts = make_timeslice();
+  std::ostringstream expected;
+  expected << TimesliceDump(*ts, 2) << "\n";
+
+  std::ostringstream sequential;
+  TimesliceDumper(sequential, 2).put(ts);
+  BOOST_CHECK_EQUAL(sequential.str(), expected.str());
+
+  std::ostringstream parallel;
+  TimesliceDumper dumper(parallel, 2, DumpFormat::Text, 4);
+  dumper.put(ts);
+  dumper.put(ts);
+  BOOST_CHECK_EQUAL(parallel.str(), expected.str() + expected.str());
+}
+
+BOOST_AUTO_TEST_CASE(json_lines_test) {
+  auto ts = make_timeslice();
+  std::ostringstream s;
+  TimesliceDumper(s, 2, DumpFormat::JsonLines, 2).put(ts);
+
+  std::istringstream lines(s.str());
+  std::string line;
+  std::vector<std::string> result;
+  while (std::getline(lines, line)) {
+    result.push_back(line);
+  }
+  BOOST_REQUIRE_EQUAL(result.size(), 7);
+  BOOST_CHECK_EQUAL(result[0],
+                    "{\"timeslice\":5,\"components\":3,\"core_microslices\":1,"
+                    "\"microslices\":6,\"overlap_min\":1,\"overlap_max\":1,"
+                    "\"size_min\":3,\"size_avg\":21.5,\"size_max\":40}");
+  BOOST_CHECK_EQUAL(result[1],
+                    "{\"timeslice\":5,\"component\":0,\"microslice\":0,"
+                    "\"hdr_id\":221,\"hdr_ver\":1,\"eq_id\":16,\"flags\":0,"
+                    "\"sys_id\":64,\"sys_ver\":1,\"idx\":100,\"crc\":0,"
+                    "\"size\":3,\"offset\":0,\"content\":\"000102\"}");
+  BOOST_CHECK(result[6].find("\"component\":2,\"microslice\":1,") !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(parse_dump_format_test) {
+  BOOST_CHECK(parse_dump_format("text") == DumpFormat::Text);
+  BOOST_CHECK(parse_dump_format("json") == DumpFormat::JsonLines);
+  BOOST_CHECK_THROW(static_cast<void>(parse_dump_format("xml")),
+                    std::invalid_argument);
+}
@@ -26,8 +26,38 @@ BOOST_AUTO_TEST_CASE(reference_archive_test) {
   BOOST_CHECK_EQUAL(count, 4);
 }
 
+BOOST_AUTO_TEST_CASE(merge_order_test) {
+  std::string filename("./example1.tsa;./example1.tsa;./example1.tsa");
+  uint64_t count = 0;
+  uint64_t last_start_time = 0;
+  fles::TimesliceMultiInputArchive source(filename, "", 1);
+  while (auto timeslice = source.get()) {
+    BOOST_CHECK_GE(timeslice->start_time(), last_start_time);
+    last_start_time = timeslice->start_time();
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 6);
+  BOOST_CHECK(source.eos());
+}
+
 BOOST_AUTO_TEST_CASE(invalid_archive_test) {
   std::string filename("./example1.msa");
   BOOST_CHECK_THROW(fles::TimesliceMultiInputArchive source(filename),
                     std::runtime_error);
 }
+
+BOOST_AUTO_TEST_CASE(stream_error_test) {
+  // the second file of the stream is not a timeslice archive
+  boost::filesystem::remove_all("multi_error");
+  boost::filesystem::create_directory("multi_error");
+  boost::filesystem::copy_file("example1.tsa", "multi_error/a.tsa");
+  boost::filesystem::copy_file("example1.msa", "multi_error/b.tsa");
+
+  fles::TimesliceMultiInputArchive source("./multi_error/*.tsa", "", 1);
+  auto first = source.get();
+  BOOST_REQUIRE(first);
+  // the error in refilling from the stream is reported, and the pending
+  // timeslice is kept
+  BOOST_CHECK_THROW(source.get(), std::runtime_error);
+  BOOST_CHECK_THROW(source.get(), std::runtime_error);
+}
@@ -0,0 +1,108 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimeslicePlacement
+#include <boost/test/unit_test.hpp>
+
+#include "TimeslicePlacement.hpp"
+#include <algorithm>
+
+BOOST_AUTO_TEST_CASE(round_robin_test) {
+  TimeslicePlacement p(PlacementPolicy::RoundRobin, 0);
+  p.init({20, 20, 20});
+  for (uint64_t ts = 0; ts < 10; ++ts) {
+    BOOST_CHECK(p.ready(ts));
+    BOOST_CHECK_EQUAL(p.target(ts), ts % 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(weighted_test) {
+  TimeslicePlacement p(PlacementPolicy::Weighted, 0);
+  p.init({21, 20, 22});
+  std::vector<uint32_t> count(3, 0);
+  for (uint64_t ts = 0; ts < 70; ++ts) {
+    BOOST_CHECK(p.ready(ts));
+    ++count.at(p.target(ts));
+  }
+  BOOST_CHECK_EQUAL(count[0], 20);
+  BOOST_CHECK_EQUAL(count[1], 10);
+  BOOST_CHECK_EQUAL(count[2], 40);
+  // the largest node does not receive long runs of timeslices
+  BOOST_CHECK_NE(p.target(0), p.target(1));
+}
+
+BOOST_AUTO_TEST_CASE(apportion_test) {
+  auto c = TimeslicePlacement::apportion({1, 1, 16}, 21);
+  BOOST_CHECK_EQUAL(c.at(0), 2);
+  BOOST_CHECK_EQUAL(c.at(1), 2);
+  BOOST_CHECK_EQUAL(c.at(2), 17);
+
+  c = TimeslicePlacement::apportion({1, 1, 1}, 4);
+  BOOST_CHECK_EQUAL(c.at(0), 2);
+  BOOST_CHECK_EQUAL(c.at(1), 1);
+  BOOST_CHECK_EQUAL(c.at(2), 1);
+}
+
+BOOST_AUTO_TEST_CASE(credit_test) {
+  constexpr uint32_t epoch_length = 8;
+  TimeslicePlacement p(PlacementPolicy::Credit, epoch_length);
+  p.init({20, 20});
+
+  // initial epochs are usable without credits
+  BOOST_CHECK(p.ready(0));
+  BOOST_CHECK(p.ready(2 * epoch_length - 1));
+  BOOST_CHECK(!p.ready(2 * epoch_length));
+
+  p.set_credit(2, 0, TimeslicePlacement::credit_for(1.0));
+  BOOST_CHECK(!p.ready(2 * epoch_length));
+  p.set_credit(2, 1, TimeslicePlacement::credit_for(0.0));
+  BOOST_CHECK(p.ready(2 * epoch_length));
+  BOOST_CHECK(!p.ready(3 * epoch_length));
+
+  std::vector<uint32_t> count(2, 0);
+  for (uint64_t ts = 2 * epoch_length; ts < 3 * epoch_length; ++ts) {
+    ++count.at(p.target(ts));
+  }
+  BOOST_CHECK_EQUAL(count[0], epoch_length - 1);
+  BOOST_CHECK_EQUAL(count[1], 1);
+}
+
+BOOST_AUTO_TEST_CASE(credit_deterministic_test) {
+  // two inputs receiving the same credits in different order agree
+  TimeslicePlacement a(PlacementPolicy::Credit, 6);
+  TimeslicePlacement b(PlacementPolicy::Credit, 6);
+  a.init({20, 21, 20});
+  b.init({20, 21, 20});
+  for (uint64_t ts = 0; ts < 12; ++ts) {
+    BOOST_CHECK_EQUAL(a.target(ts), b.target(ts));
+  }
+  for (uint64_t e = 2; e < 6; ++e) {
+    for (uint32_t n = 0; n < 3; ++n) {
+      a.set_credit(e, n, 1 + (e * 7 + n * 3) % 16);
+      b.set_credit(e, 2 - n, 1 + (e * 7 + (2 - n) * 3) % 16);
+    }
+    for (uint64_t ts = e * 6; ts < (e + 1) * 6; ++ts) {
+      BOOST_REQUIRE(a.ready(ts) && b.ready(ts));
+      BOOST_CHECK_EQUAL(a.target(ts), b.target(ts));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(epoch_size_test) {
+  TimeslicePlacement p(PlacementPolicy::Credit, 4);
+  p.init({20, 20});
+  BOOST_CHECK_EQUAL(p.epoch_size(2), 0);
+
+  // the smallest proposed size is used, missing proposals are ignored
+  p.set_credit(2, 0, 4, 300);
+  p.set_credit(2, 1, 4, 200);
+  BOOST_CHECK_EQUAL(p.epoch_size(2), 200);
+  p.set_credit(3, 0, 4, 0);
+  p.set_credit(3, 1, 4, 500);
+  BOOST_CHECK_EQUAL(p.epoch_size(3), 500);
+  p.set_credit(4, 0, 4);
+  p.set_credit(4, 1, 4);
+  BOOST_CHECK_EQUAL(p.epoch_size(4), 0);
+
+  // proposals for decided epochs are ignored
+  p.set_credit(3, 1, 4, 100);
+  BOOST_CHECK_EQUAL(p.epoch_size(3), 500);
+}
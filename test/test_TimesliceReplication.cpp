@@ -0,0 +1,56 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimesliceReplication
+#include <boost/test/unit_test.hpp>
+
+#include "TimesliceReplication.hpp"
+#include <numeric>
+#include <vector>
+
+namespace tr = timeslice_replication;
+
+BOOST_AUTO_TEST_CASE(selected_test) {
+  BOOST_CHECK(!tr::selected(0, 0));
+  BOOST_CHECK(!tr::selected(7, 0));
+  BOOST_CHECK(tr::selected(0, 4));
+  BOOST_CHECK(!tr::selected(3, 4));
+  BOOST_CHECK(tr::selected(8, 4));
+  BOOST_CHECK(tr::selected(5, 1));
+}
+
+BOOST_AUTO_TEST_CASE(standby_test) {
+  BOOST_CHECK_EQUAL(tr::standby(0, 3), 1);
+  BOOST_CHECK_EQUAL(tr::standby(1, 3), 2);
+  BOOST_CHECK_EQUAL(tr::standby(2, 3), 0);
+}
+
+BOOST_AUTO_TEST_CASE(find_test) {
+  std::vector<ReplicaDescriptor> ring(4);
+  fles::TimesliceComponentDescriptor desc{42, 100, 64, 8};
+
+  // an empty slot holds no replica
+  BOOST_CHECK(tr::find(ring.data(), 2, 5, desc) == nullptr);
+
+  ring[5 & 3] = ReplicaDescriptor{5, desc};
+  const auto* replica = tr::find(ring.data(), 2, 5, desc);
+  BOOST_REQUIRE(replica != nullptr);
+  BOOST_CHECK_EQUAL(replica->offset, 100);
+
+  // a stale slot or a different component does not match
+  BOOST_CHECK(tr::find(ring.data(), 2, 9, desc) == nullptr);
+  fles::TimesliceComponentDescriptor other{43, 100, 64, 8};
+  BOOST_CHECK(tr::find(ring.data(), 2, 5, other) == nullptr);
+  fles::TimesliceComponentDescriptor shorter{42, 100, 32, 8};
+  BOOST_CHECK(tr::find(ring.data(), 2, 5, shorter) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(copy_test) {
+  std::vector<uint8_t> src(16);
+  std::iota(src.begin(), src.end(), 0);
+  std::vector<uint8_t> dst(8, 0xff);
+
+  // wraps around the end of both buffers
+  tr::copy(dst.data(), 3, 13, src.data(), 4, 30, 6);
+  std::vector<uint8_t> expected{1, 2, 3, 0xff, 0xff, 14, 15, 0};
+  BOOST_CHECK_EQUAL_COLLECTIONS(dst.begin(), dst.end(), expected.begin(),
+                                expected.end());
+}
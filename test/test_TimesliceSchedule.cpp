@@ -0,0 +1,70 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimesliceSchedule
+#include <boost/test/unit_test.hpp>
+
+#include "TimesliceSchedule.hpp"
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(constant_test) {
+  TimesliceSchedule s(100);
+  BOOST_CHECK(s.constant());
+  BOOST_CHECK_EQUAL(s.size(7), 100);
+  BOOST_CHECK_EQUAL(s.start(7), 700);
+  BOOST_CHECK_EQUAL(s.timeslice_at(799), 7);
+  BOOST_CHECK_EQUAL(s.timeslice_at(800), 8);
+  BOOST_CHECK_EQUAL(s.description(), "100");
+}
+
+BOOST_AUTO_TEST_CASE(change_test) {
+  auto s = TimesliceSchedule::parse(100, "10:50,20:200");
+  BOOST_CHECK(!s.constant());
+  BOOST_CHECK_EQUAL(s.min_size(), 50);
+  BOOST_CHECK_EQUAL(s.size(9), 100);
+  BOOST_CHECK_EQUAL(s.size(10), 50);
+  BOOST_CHECK_EQUAL(s.size(25), 200);
+  BOOST_CHECK_EQUAL(s.start(10), 1000);
+  BOOST_CHECK_EQUAL(s.start(12), 1100);
+  BOOST_CHECK_EQUAL(s.start(21), 1700);
+  // timeslice_at() is the inverse of start() at every boundary
+  for (uint64_t ts = 0; ts < 30; ++ts) {
+    BOOST_CHECK_EQUAL(s.timeslice_at(s.start(ts)), ts);
+    BOOST_CHECK_EQUAL(s.timeslice_at(s.start(ts + 1) - 1), ts);
+  }
+  BOOST_CHECK_EQUAL(s.description(), "100, 50 from 10, 200 from 20");
+}
+
+BOOST_AUTO_TEST_CASE(scaled_test) {
+  auto s = TimesliceSchedule::parse(100, "10:50").scaled(3);
+  BOOST_CHECK_EQUAL(s.size(9), 300);
+  BOOST_CHECK_EQUAL(s.size(10), 150);
+  BOOST_CHECK_EQUAL(s.start(10), 3000);
+  BOOST_CHECK_EQUAL(s.start(12), 3300);
+  BOOST_CHECK_EQUAL(s.timeslice_at(3299), 11);
+  BOOST_CHECK_THROW(s.scaled(0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(discard_test) {
+  auto s = TimesliceSchedule::parse(100, "10:50,20:200");
+  s.discard_before(15);
+  BOOST_CHECK_EQUAL(s.size(15), 50);
+  BOOST_CHECK_EQUAL(s.start(15), 1250);
+  BOOST_CHECK_EQUAL(s.timeslice_at(1250), 15);
+  s.discard_before(25);
+  BOOST_CHECK(s.constant());
+  BOOST_CHECK_EQUAL(s.start(25), 2500);
+  s.add_change(30, 10);
+  BOOST_CHECK_EQUAL(s.start(31), 3510);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test) {
+  BOOST_CHECK_THROW(TimesliceSchedule(0), std::invalid_argument);
+  BOOST_CHECK_THROW(TimesliceSchedule::parse(100, "10:0"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(TimesliceSchedule::parse(100, "20:50,10:20"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(TimesliceSchedule::parse(100, "10"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(TimesliceSchedule::parse(100, "x:10"),
+                    std::invalid_argument);
+  BOOST_CHECK_NO_THROW(TimesliceSchedule::parse(100, ""));
+}
@@ -0,0 +1,80 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimesliceShmWorkItem
+#include <boost/test/unit_test.hpp>
+
+#include "TimesliceShmWorkItem.hpp"
+#include <boost/uuid/uuid_generators.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace {
+fles::TimesliceShmWorkItem make_item() {
+  fles::TimesliceShmWorkItem item;
+  item.shm_uuid = boost::uuids::random_generator()();
+  item.ts_desc = {42, 4200, 100, 3};
+  item.data_base = 4096;
+  item.desc_base = 1 << 20;
+  item.data = {0, 1 << 16, 123};
+  item.desc = {7, 1031, 2055};
+  return item;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(roundtrip_test) {
+  auto item = make_item();
+  std::string buffer;
+  item.encode(buffer);
+  BOOST_CHECK_EQUAL(buffer.size(),
+                    sizeof(fles::TimesliceShmWorkItemHeader) +
+                        3 * sizeof(fles::TimesliceShmWorkItemComponent));
+
+  auto decoded = fles::TimesliceShmWorkItem::decode(buffer);
+  BOOST_CHECK(decoded.shm_uuid == item.shm_uuid);
+  BOOST_CHECK_EQUAL(decoded.ts_desc.index, item.ts_desc.index);
+  BOOST_CHECK_EQUAL(decoded.ts_desc.ts_pos, item.ts_desc.ts_pos);
+  BOOST_CHECK_EQUAL(decoded.ts_desc.num_core_microslices,
+                    item.ts_desc.num_core_microslices);
+  BOOST_CHECK_EQUAL(decoded.ts_desc.num_components,
+                    item.ts_desc.num_components);
+  BOOST_CHECK_EQUAL(decoded.data_base, item.data_base);
+  BOOST_CHECK_EQUAL(decoded.desc_base, item.desc_base);
+  BOOST_CHECK_EQUAL(decoded.data_device, -1);
+  BOOST_CHECK_EQUAL_COLLECTIONS(decoded.data.begin(), decoded.data.end(),
+                                item.data.begin(), item.data.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(decoded.desc.begin(), decoded.desc.end(),
+                                item.desc.begin(), item.desc.end());
+
+  // a buffer can be reused for a smaller item
+  item.ts_desc.num_components = 1;
+  item.encode(buffer);
+  BOOST_CHECK_EQUAL(fles::TimesliceShmWorkItem::decode(buffer).data.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(device_test) {
+  auto item = make_item();
+  item.data_device = 1;
+  for (size_t i = 0; i < item.data_device_handle.size(); ++i) {
+    item.data_device_handle[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::string buffer;
+  item.encode(buffer);
+
+  auto decoded = fles::TimesliceShmWorkItem::decode(buffer);
+  BOOST_CHECK_EQUAL(decoded.data_device, 1);
+  BOOST_CHECK(decoded.data_device_handle == item.data_device_handle);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test) {
+  std::string buffer;
+  make_item().encode(buffer);
+
+  BOOST_CHECK_THROW(fles::TimesliceShmWorkItem::decode(buffer.substr(0, 8)),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(fles::TimesliceShmWorkItem::decode(buffer + "x"),
+                    std::runtime_error);
+
+  std::string wrong_version = buffer;
+  wrong_version[0] = static_cast<char>(wrong_version[0] + 1);
+  BOOST_CHECK_THROW(fles::TimesliceShmWorkItem::decode(wrong_version),
+                    std::runtime_error);
+}
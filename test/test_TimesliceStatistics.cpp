@@ -0,0 +1,54 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimesliceStatistics
+#include <boost/test/unit_test.hpp>
+
+#include "TimesliceStatistics.hpp"
+#include <cmath>
+#include <sstream>
+#include <string>
+
+using clock_type = TimesliceStatistics::clock;
+using std::chrono::milliseconds;
+
+BOOST_AUTO_TEST_CASE(rate_test) {
+  TimesliceStatistics s;
+  auto start = clock_type::now();
+  // five timeslices of 1 MB, one every 100 ms
+  for (uint64_t i = 0; i < 5; ++i) {
+    s.add(i, 1000000, start + milliseconds(100 * i));
+  }
+  BOOST_CHECK_EQUAL(s.timeslice_count(), 5);
+  BOOST_CHECK_EQUAL(s.bytes(), 5000000);
+  BOOST_CHECK_CLOSE(s.seconds(), 0.4, 1e-6);
+  BOOST_CHECK_CLOSE(s.timeslice_rate(), 10.0, 1e-6);
+  BOOST_CHECK_CLOSE(s.data_rate(), 10e6, 1e-6);
+  BOOST_CHECK(std::isnan(s.latency_percentile(50)));
+
+  std::ostringstream out;
+  s.write_json(out, {{"transport", "test"}});
+  std::string json = out.str();
+  BOOST_CHECK_EQUAL(json.rfind("{\"transport\":\"test\",\"timeslices\":5,", 0),
+                    0);
+  BOOST_CHECK_NE(json.find("\"latency_us\":null}"), std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(latency_test) {
+  auto origin = clock_type::now();
+  TimesliceStatistics a;
+  TimesliceStatistics b;
+  // timeslice i is due at origin + i ms
+  auto schedule = [origin](uint64_t i) { return origin + milliseconds(i); };
+  a.set_schedule(schedule);
+  b.set_schedule(schedule);
+  // latencies of 1..100 ms, split between two buffers
+  for (uint64_t i = 0; i < 100; ++i) {
+    auto& s = (i % 2 == 0) ? a : b;
+    s.add(i, 1, origin + milliseconds(i) + milliseconds(100 - i));
+  }
+  a.merge(b);
+  BOOST_CHECK_EQUAL(a.timeslice_count(), 100);
+  BOOST_CHECK_CLOSE(a.latency_percentile(50), 0.050, 1e-6);
+  BOOST_CHECK_CLOSE(a.latency_percentile(99), 0.099, 1e-6);
+  BOOST_CHECK_CLOSE(a.latency_percentile(100), 0.100, 1e-6);
+  BOOST_CHECK_CLOSE(a.latency_percentile(0), 0.001, 1e-6);
+}
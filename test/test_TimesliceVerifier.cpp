@@ -0,0 +1,120 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TimesliceVerifier
+#include <boost/test/unit_test.hpp>
+
+#include "RampPattern.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceVerifier.hpp"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t num_microslices = 4;
+constexpr size_t words = 64;
+
+// CRC-32C of the content "123456789"
+constexpr uint32_t check_crc = 0xe3069283;
+constexpr uint32_t check_size = 9;
+
+// Timeslice with a ramp pattern component (pattern error in microslice
+// pattern_error_ms) and a CRC-protected component (CRC error in microslice
+// crc_error_ms, no valid CRC in the last microslice)
+std::shared_ptr<fles::StorableTimeslice>
+make_timeslice(uint64_t index, size_t pattern_error_ms, size_t crc_error_ms) {
+  auto ts = std::make_shared<fles::StorableTimeslice>(num_microslices, index);
+
+  ts->append_component(num_microslices, index);
+  std::vector<uint64_t> content(words);
+  for (size_t m = 0; m < num_microslices; ++m) {
+    uint64_t x = ramp_pattern::fill(content.data(), content.size(), 0);
+    if (m == pattern_error_ms) {
+      content[7] = 0;
+    }
+    fles::MicrosliceDescriptor desc{};
+    desc.sys_id = static_cast<uint8_t>(fles::Subsystem::FLES);
+    desc.sys_ver =
+        static_cast<uint8_t>(fles::SubsystemFormatFLES::BasicRampPattern);
+    desc.idx = index * num_microslices + m;
+    desc.crc = ramp_pattern::crc(x);
+    desc.size = static_cast<uint32_t>(words * sizeof(uint64_t));
+    ts->append_microslice(0, m, desc,
+                          reinterpret_cast<uint8_t*>(content.data()));
+  }
+
+  ts->append_component(num_microslices, index);
+  for (size_t m = 0; m < num_microslices; ++m) {
+    fles::MicrosliceDescriptor desc{};
+    desc.idx = index * num_microslices + m;
+    desc.crc = m == crc_error_ms ? check_crc ^ 1 : check_crc;
+    desc.size = check_size;
+    if (m + 1 < num_microslices) {
+      desc.flags = static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+    }
+    ts->append_microslice(1, m, desc,
+                          reinterpret_cast<const uint8_t*>("123456789"));
+  }
+  return ts;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(verification_test) {
+  std::vector<TimesliceVerifier::Result> results;
+  TimesliceVerifier verifier(
+      [&](const TimesliceVerifier::Result& r) { results.push_back(r); });
+  BOOST_CHECK_EQUAL(verifier.engine_name(), "cpu");
+
+  verifier.put(make_timeslice(5, 1, 2));
+  verifier.end_stream();
+
+  BOOST_REQUIRE_EQUAL(results.size(), 1);
+  const auto& r = results[0];
+  BOOST_CHECK_EQUAL(r.index, 5);
+  BOOST_CHECK_EQUAL(r.microslices, 2 * num_microslices);
+  BOOST_CHECK_EQUAL(r.crc_errors, 1);
+  BOOST_CHECK_EQUAL(r.pattern_errors, 1);
+  BOOST_REQUIRE_EQUAL(r.flags.size(), 2);
+
+  using namespace verification;
+  BOOST_CHECK_EQUAL(r.flags[0][0], pattern_checked);
+  BOOST_CHECK_EQUAL(r.flags[0][1], pattern_checked | pattern_error);
+  BOOST_CHECK_EQUAL(r.flags[1][0], crc_checked);
+  BOOST_CHECK_EQUAL(r.flags[1][2], crc_checked | crc_error);
+  BOOST_CHECK_EQUAL(r.flags[1][3], 0);
+}
+
+BOOST_AUTO_TEST_CASE(order_test) {
+  constexpr uint64_t count = 50;
+  std::vector<uint64_t> indices;
+  {
+    TimesliceVerifier verifier(
+        [&](const TimesliceVerifier::Result& r) {
+          indices.push_back(r.index);
+        },
+        -1, 4, 3);
+    for (uint64_t i = 0; i < count; ++i) {
+      verifier.put(make_timeslice(i, i % num_microslices, num_microslices));
+      BOOST_CHECK_GE(indices.size() + 3, i + 1);
+    }
+    verifier.end_stream();
+    BOOST_CHECK_EQUAL(verifier.pattern_errors(), count);
+    BOOST_CHECK_EQUAL(verifier.crc_errors(), 0);
+  }
+  BOOST_REQUIRE_EQUAL(indices.size(), count);
+  for (uint64_t i = 0; i < count; ++i) {
+    BOOST_CHECK_EQUAL(indices[i], i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(device_fallback_test) {
+  // without CUDA support or device, the CPU engine is used instead
+  TimesliceVerifier verifier(nullptr, 1000);
+  BOOST_CHECK_EQUAL(verifier.engine_name(), "cpu");
+  verifier.put(make_timeslice(0, num_microslices, num_microslices));
+  verifier.end_stream();
+  BOOST_CHECK_EQUAL(verifier.microslices(), 2 * num_microslices);
+  BOOST_CHECK_EQUAL(verifier.crc_errors(), 0);
+  BOOST_CHECK_EQUAL(verifier.pattern_errors(), 0);
+}
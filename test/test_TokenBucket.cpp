@@ -0,0 +1,57 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_TokenBucket
+#include <boost/test/unit_test.hpp>
+
+#include "TokenBucket.hpp"
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(burst_test) {
+  TokenBucket::clock::time_point t0;
+  TokenBucket b(1000.0, 100.0, t0);
+  // a full bucket admits a burst, which may overdraw it
+  BOOST_CHECK(b.admits(t0));
+  b.consume(60.0, t0);
+  BOOST_CHECK(b.admits(t0));
+  b.consume(60.0, t0);
+  BOOST_CHECK(!b.admits(t0));
+}
+
+BOOST_AUTO_TEST_CASE(rate_test) {
+  TokenBucket::clock::time_point t0;
+  TokenBucket b(1000.0, 100.0, t0);
+  b.consume(600.0, t0);
+  // the deficit of 500 bytes takes 0.5 s at 1000 bytes/s
+  BOOST_CHECK(!b.admits(t0 + 400ms));
+  BOOST_CHECK(b.admits(t0 + 510ms));
+  // the bucket does not fill beyond the burst size
+  b.consume(200.0, t0 + 10s);
+  BOOST_CHECK(!b.admits(t0 + 10s));
+}
+
+BOOST_AUTO_TEST_CASE(congestion_test) {
+  TokenBucket::clock::time_point t0;
+  TokenBucket b(1000.0, 100.0, t0);
+  b.congestion(t0);
+  BOOST_CHECK_CLOSE(b.rate(), 750.0, 1e-9);
+  b.congestion(t0);
+  BOOST_CHECK_CLOSE(b.rate(), 562.5, 1e-9);
+  // fast recovery halves the distance to the rate before the reduction
+  b.no_congestion(t0);
+  BOOST_CHECK_CLOSE(b.rate(), 656.25, 1e-9);
+  for (unsigned int i = 0; i < 100; ++i) {
+    b.no_congestion(t0);
+  }
+  // additive increase reaches the maximum rate, but does not exceed it
+  BOOST_CHECK_CLOSE(b.rate(), 1000.0, 1e-6);
+  BOOST_CHECK_LE(b.rate(), b.max_rate());
+}
+
+BOOST_AUTO_TEST_CASE(min_rate_test) {
+  TokenBucket::clock::time_point t0;
+  TokenBucket b(1000.0, 100.0, t0);
+  for (unsigned int i = 0; i < 100; ++i) {
+    b.congestion(t0);
+  }
+  BOOST_CHECK_CLOSE(b.rate(), 1000.0 * TokenBucket::min_rate, 1e-9);
+}
@@ -0,0 +1,49 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_WorkerGroup
+#include <boost/test/unit_test.hpp>
+
+#include "WorkerGroup.hpp"
+#include <string>
+#include <vector>
+
+namespace {
+
+// Worker recording its steps in a shared log
+class CountingWorker : public ConnectionGroupWorker {
+public:
+  CountingWorker(char id, int steps, std::string& log)
+      : id_(id), steps_(steps), log_(log) {}
+
+  void operator()() override {
+    while (step()) {
+    }
+  }
+
+  bool step() override {
+    log_ += id_;
+    return --steps_ > 0;
+  }
+
+  [[nodiscard]] bool cooperative() const override { return true; }
+
+private:
+  char id_;
+  int steps_;
+  std::string& log_;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(interleave_test) {
+  std::string log;
+  CountingWorker a('a', 2, log);
+  CountingWorker b('b', 4, log);
+  CountingWorker c('c', 1, log);
+  WorkerGroup group({&a, &b, &c}, "group");
+  BOOST_CHECK(group.cooperative());
+  BOOST_CHECK_EQUAL(group.thread_name(), "group");
+
+  group();
+  BOOST_CHECK_EQUAL(log, "abcabbb");
+  BOOST_CHECK(!group.step());
+}
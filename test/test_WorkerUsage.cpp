@@ -0,0 +1,74 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_WorkerUsage
+#include <boost/test/unit_test.hpp>
+
+#include "ItemWorkerProtocol.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(message_test) {
+  WorkerUsage usage;
+  usage.period = 1000000us;
+  usage.items = 4;
+  usage.wait = 2000us;
+  usage.hold = 600000us;
+  usage.idle = 250000us;
+  std::string message = usage.to_string();
+  BOOST_CHECK_EQUAL(message, "USAGE 1000000 4 2000 600000 250000");
+
+  WorkerUsage parsed = WorkerUsage::parse(message);
+  BOOST_CHECK(parsed.period == usage.period);
+  BOOST_CHECK_EQUAL(parsed.items, usage.items);
+  BOOST_CHECK(parsed.wait == usage.wait);
+  BOOST_CHECK(parsed.hold == usage.hold);
+  BOOST_CHECK(parsed.idle == usage.idle);
+  BOOST_CHECK_CLOSE(parsed.utilization(), 0.75, 1e-9);
+
+  BOOST_CHECK_THROW(WorkerUsage::parse("USAGE 1000 4"), std::invalid_argument);
+  BOOST_CHECK_THROW(WorkerUsage::parse("USAGE 1000 4 -1 0 0"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(WorkerUsage::parse("COMPLETE 1 2 3 4 5"),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(utilization_test) {
+  WorkerUsage usage;
+  BOOST_CHECK_EQUAL(usage.utilization(), 0);
+  usage.period = 1000us;
+  BOOST_CHECK_EQUAL(usage.utilization(), 1);
+  // idle time measured across the period boundary
+  usage.idle = 1200us;
+  BOOST_CHECK_EQUAL(usage.utilization(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(accounting_test) {
+  CompletionQueue queue;
+  auto arrival = std::chrono::steady_clock::now();
+  {
+    // released without retrieval: completed, but not accounted
+    Item item(&queue, 1, "");
+  }
+  {
+    Item item(&queue, 2, "");
+    item.set_retrieval(item.arrival() + 3ms);
+  }
+  BOOST_CHECK_EQUAL(queue.take().size(), 2);
+
+  WorkerUsage usage = queue.take_usage();
+  BOOST_CHECK_EQUAL(usage.items, 1);
+  BOOST_CHECK(usage.wait == 3000us);
+  BOOST_CHECK(usage.hold <= std::chrono::duration_cast<WorkerUsage::duration>(
+                                std::chrono::steady_clock::now() - arrival));
+  BOOST_CHECK_EQUAL(queue.take_usage().items, 0);
+
+  // discarded on reset like the completions
+  {
+    Item item(&queue, 3, "");
+    item.set_retrieval(std::chrono::steady_clock::now());
+  }
+  queue.reset();
+  BOOST_CHECK_EQUAL(queue.take_usage().items, 0);
+}
@@ -0,0 +1,97 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_logging_async
+#include <boost/test/unit_test.hpp>
+
+#include "log.hpp"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+boost::filesystem::path temp_log_path() {
+  return boost::filesystem::temp_directory_path() /
+         boost::filesystem::unique_path("test_logging_async_%%%%-%%%%.log");
+}
+
+std::vector<std::string> read_lines(const boost::filesystem::path& path) {
+  std::ifstream file(path.string());
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(async_block_test) {
+  constexpr int n_threads = 4;
+  constexpr int n_messages = 10000;
+  auto path = temp_log_path();
+
+  // a small queue forces the producers to block frequently
+  logging::set_async(16, logging::overflow_policy::block);
+  logging::add_file(path.string(), debug);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < n_messages; ++i) {
+        L_(debug) << "thread " << t << " message " << i;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  L_(trace) << "filtered by the sink";
+  logging::flush();
+
+  auto lines = read_lines(path);
+  boost::filesystem::remove(path);
+  BOOST_CHECK_EQUAL(lines.size(), n_threads * n_messages);
+  BOOST_CHECK_EQUAL(logging::dropped_messages(), 0);
+
+  // the messages of each thread are kept in order
+  std::map<int, int> next;
+  for (const auto& line : lines) {
+    std::istringstream s(line.substr(line.find("thread ")));
+    std::string word;
+    int t = 0;
+    int i = 0;
+    s >> word >> t >> word >> i;
+    BOOST_CHECK_EQUAL(i, next[t]++);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(async_drop_test) {
+  constexpr int n_messages = 100000;
+  auto path = temp_log_path();
+
+  logging::set_async(2, logging::overflow_policy::drop);
+  logging::add_file(path.string(), info);
+
+  uint64_t dropped_before = logging::dropped_messages();
+  for (int i = 0; i < n_messages; ++i) {
+    L_(info) << "message " << i;
+  }
+  logging::flush();
+
+  auto lines = read_lines(path);
+  boost::filesystem::remove(path);
+  uint64_t dropped = logging::dropped_messages() - dropped_before;
+
+  // every message is either written or counted as dropped, the overflow
+  // warnings come on top
+  size_t written = 0;
+  for (const auto& line : lines) {
+    if (line.find("messages dropped") == std::string::npos) {
+      ++written;
+    }
+  }
+  BOOST_CHECK_EQUAL(written + dropped, n_messages);
+}
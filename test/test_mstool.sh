@@ -14,17 +14,31 @@ sleep 0.5
 ./mstool -I test_mstool_2 -o test/example2.mstool.msa &
 inst3_pid=$!
 
+./mstool -i test/example2.msa -O test_mstool_3 &
+inst4_pid=$!
+sleep 0.5
+
+./mstool -I test_mstool_3 --channels all -o test/example2.mstool.%c.msa &
+inst5_pid=$!
+
 echo "waiting for instance 1..."
 wait $inst1_pid
 echo "waiting for instance 2..."
 wait $inst2_pid
 echo "waiting for instance 3..."
 wait $inst3_pid
+echo "waiting for instance 4..."
+wait $inst4_pid
+echo "waiting for instance 5..."
+wait $inst5_pid
 
 N=`./mstool -i test/example2.mstool.msa -a 2>&1 | grep total | sed -e 's/.* //'`
 echo "microslices in output file: $N"
 
-if [ "$N" -ne 4 ]; then
+M=`./mstool -i test/example2.mstool.0.msa -a 2>&1 | grep total | sed -e 's/.* //'`
+echo "microslices in multi-channel output file: $M"
+
+if [ "$N" -ne 4 ] || [ "$M" -ne 4 ]; then
 	echo "not ok"
 	exit 1
 else
@@ -0,0 +1,86 @@
+// Copyright 2026 Jan de Cuveland <cmail@cuveland.de>
+#define BOOST_TEST_MODULE test_tracing
+#include <boost/test/unit_test.hpp>
+
+#include "tracing.hpp"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+boost::filesystem::path temp_trace_path() {
+  return boost::filesystem::temp_directory_path() /
+         boost::filesystem::unique_path("test_tracing_%%%%-%%%%.json");
+}
+
+std::string read_file(const boost::filesystem::path& path) {
+  std::ifstream file(path.string());
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+size_t count(const std::string& s, const std::string& pattern) {
+  size_t n = 0;
+  for (auto pos = s.find(pattern); pos != std::string::npos;
+       pos = s.find(pattern, pos + 1)) {
+    ++n;
+  }
+  return n;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(disabled_test) {
+  BOOST_CHECK(!tracing::enabled());
+  { tracing::Scope scope("ignored"); }
+
+  auto path = temp_trace_path();
+  // nothing is written without a session
+  BOOST_CHECK_EQUAL(tracing::stop(path.string()), 0);
+  BOOST_CHECK(!boost::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(session_test) {
+  constexpr int n_threads = 3;
+  constexpr int n_events = 100;
+  auto path = temp_trace_path();
+
+  tracing::start();
+  BOOST_CHECK(tracing::enabled());
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < n_events; ++i) {
+        tracing::Scope outer("outer", i);
+        tracing::Scope inner("inner");
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(tracing::stop(path.string()), 2 * n_threads * n_events);
+  BOOST_CHECK(!tracing::enabled());
+
+  std::string trace = read_file(path);
+  boost::filesystem::remove(path);
+  BOOST_CHECK_EQUAL(trace.rfind("{\"displayTimeUnit\"", 0), 0);
+  BOOST_CHECK_EQUAL(count(trace, "\"name\":\"outer\",\"ph\":\"X\""),
+                    n_threads * n_events);
+  BOOST_CHECK_EQUAL(count(trace, "\"name\":\"inner\",\"ph\":\"X\""),
+                    n_threads * n_events);
+  BOOST_CHECK_EQUAL(count(trace, "\"ph\":\"M\""), n_threads);
+  BOOST_CHECK_EQUAL(trace.find("ignored"), std::string::npos);
+
+  // a new session starts over
+  tracing::start();
+  { tracing::Scope scope("again"); }
+  BOOST_CHECK_EQUAL(tracing::stop(path.string()), 1);
+  trace = read_file(path);
+  boost::filesystem::remove(path);
+  BOOST_CHECK_EQUAL(count(trace, "\"name\":\"again\""), 1);
+  BOOST_CHECK_EQUAL(count(trace, "\"name\":\"outer\""), 0);
+}